@@ -0,0 +1,129 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Compares file size against write throughput of the MAT-file formats on representative arrays.
+ *
+ * Usage: matWriteFormats(sizeInMB)
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <random>
+
+#include <matlabw/mat/mat.hpp>
+#include <matlabw/mex/mex.hpp>
+#include <matlabw/mex/Function.hpp>
+
+using namespace matlabw;
+
+namespace
+{
+  /// @brief Array written by the benchmark.
+  struct Workload
+  {
+    const char* name;  ///< The name of the workload.
+    mx::Array   array; ///< The array.
+  };
+
+  /**
+   * @brief Creates the workloads, random data do not compress while smooth data and counters do.
+   * @param size The number of elements of each array.
+   * @return The workloads.
+   */
+  std::vector<Workload> makeWorkloads(std::size_t size)
+  {
+    std::mt19937_64                        engine{42};
+    std::uniform_real_distribution<double> distribution{};
+
+    auto random = mx::makeUninitNumericArray<double>(size, 1);
+    auto smooth = mx::makeUninitNumericArray<double>(size, 1);
+    auto counts = mx::makeUninitNumericArray<std::int32_t>(size * 2, 1);
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+      random[i] = distribution(engine);
+      smooth[i] = std::sin(static_cast<double>(i) * 1e-3);
+    }
+
+    for (std::size_t i{}; i < size * 2; ++i)
+    {
+      counts[i] = static_cast<std::int32_t>(i / 64);
+    }
+
+    std::vector<Workload> workloads{};
+    workloads.push_back({"random", std::move(random)});
+    workloads.push_back({"smooth", std::move(smooth)});
+    workloads.push_back({"counter", std::move(counts)});
+
+    return workloads;
+  }
+} // namespace
+
+void mex::Function::operator()(mx::Span<mx::Array>, mx::View<mx::ArrayCref> rhs)
+{
+  const double sizeInMB = (rhs.size() > 0) ? mx::NumericArrayCref<double>{rhs[0]}[0] : 64.0;
+  const auto   size     = static_cast<std::size_t>(sizeInMB * (1 << 20) / sizeof(double));
+  const auto   path     = (std::filesystem::temp_directory_path() / "matlabw_matWriteFormats.mat").string();
+
+  const std::pair<const char*, mat::Format> formats[]
+  {
+    {"v6",   mat::Format::v6},
+    {"v7",   mat::Format::v7},
+    {"v7.3", mat::Format::v7_3},
+  };
+
+  const auto workloads = makeWorkloads(size);
+
+  mex::printf("%-8s %-8s %12s %12s %10s %12s\n", "format", "array", "data [MB]", "file [MB]", "time [s]", "rate [MB/s]");
+
+  for (const auto& workload : workloads)
+  {
+    const double dataMB = static_cast<double>(workload.array.getSize() * mxGetElementSize(workload.array.get()))
+                          / (1 << 20);
+
+    for (const auto& [formatName, format] : formats)
+    {
+      const std::pair<const char*, mx::ArrayCref> variables[]{{workload.name, workload.array}};
+
+      const auto start = std::chrono::steady_clock::now();
+
+      mat::save(path.c_str(), variables, {format});
+
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      const double fileMB = static_cast<double>(std::filesystem::file_size(path)) / (1 << 20);
+
+      mex::printf("%-8s %-8s %12.1f %12.1f %10.3f %12.1f\n",
+                  formatName,
+                  workload.name,
+                  dataMB,
+                  fileMB,
+                  elapsed.count(),
+                  dataMB / elapsed.count());
+    }
+  }
+
+  std::filesystem::remove(path);
+}
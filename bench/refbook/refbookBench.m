@@ -0,0 +1,205 @@
+%%
+% This file is part of matlab-cpp-wrapper library.
+%
+% Copyright (c) 2024 David Bayer
+%
+% Permission is hereby granted, free of charge, to any person obtaining a copy
+% of this software and associated documentation files (the "Software"), to deal
+% in the Software without restriction, including without limitation the rights
+% to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+% copies of the Software, and to permit persons to whom the Software is
+% furnished to do so, subject to the following conditions:
+%
+% The above copyright notice and this permission notice shall be included in all
+% copies or substantial portions of the Software.
+%
+% THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+% IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+% FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+% AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+% LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+% OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+% SOFTWARE.
+%%
+
+function results = refbookBench(jsonPath, minTime, sizes)
+%REFBOOKBENCH Compares the C and C++ builds of the MathWorks refbook examples.
+%   RESULTS = REFBOOKBENCH() runs every example built by the matlabw-refbook-bench target over scaled input sizes
+%   and prints the time per call of both builds, the overhead of the wrapper per call and the throughput. The C
+%   builds are the baseline, the overhead is the budget every wrapper change must stay within.
+%
+%   RESULTS = REFBOOKBENCH(JSONPATH) also saves the results in the Google Benchmark JSON format, so runs can be
+%   compared with its tools/compare.py. '' does not save the results.
+%
+%   RESULTS = REFBOOKBENCH(JSONPATH, MINTIME) measures every case for at least MINTIME seconds, 0.5 by default.
+%
+%   RESULTS = REFBOOKBENCH(JSONPATH, MINTIME, SIZES) runs the scalable examples on SIZES elements,
+%   [1 1e3 1e5 1e6] by default.
+%
+%   RESULTS is a struct array with fields name, size, bytes, timeC, timeCpp, overhead and rateCpp, the times are in
+%   nanoseconds per call and the rate in MB/s.
+%
+%   Build the MEX files first:
+%     cmake -S . -B build -DMATLABW_BUILD_BENCHMARKS=ON
+%     cmake --build build --target matlabw-refbook-bench
+
+  if nargin < 1
+    jsonPath = '';
+  end
+
+  if nargin < 2
+    minTime = 0.5;
+  end
+
+  if nargin < 3
+    sizes = [1 1e3 1e5 1e6];
+  end
+
+  % The MEX files are built next to this script
+  addpath(fileparts(mfilename('fullpath')));
+
+  results = struct('name', {}, 'size', {}, 'bytes', {}, 'timeC', {}, 'timeCpp', {}, 'overhead', {}, 'rateCpp', {});
+
+  fprintf('%-16s %10s %14s %14s %14s %10s %12s\n', ...
+          'example', 'size', 'C [ns]', 'C++ [ns]', 'overhead [ns]', 'ratio', 'rate [MB/s]');
+
+  for workload = makeWorkloads()
+    if workload.scalable
+      workloadSizes = sizes;
+    else
+      workloadSizes = 1;
+    end
+
+    for n = workloadSizes
+      [args, bytes] = workload.make(n);
+
+      timeC   = measure([workload.name '_c'], args, minTime);
+      timeCpp = measure([workload.name '_cpp'], args, minTime);
+
+      result.name     = workload.name;
+      result.size     = n;
+      result.bytes    = bytes;
+      result.timeC    = timeC;
+      result.timeCpp  = timeCpp;
+      result.overhead = timeCpp - timeC;
+      result.rateCpp  = bytes / timeCpp * 1e9 / 2^20;
+
+      results(end + 1) = result; %#ok<AGROW>
+
+      fprintf('%-16s %10d %14.1f %14.1f %14.1f %10.3f %12.1f\n', ...
+              result.name, n, timeC, timeCpp, result.overhead, timeCpp / timeC, result.rateCpp);
+    end
+  end
+
+  if ~isempty(jsonPath)
+    saveJson(jsonPath, results);
+  end
+end
+
+function workloads = makeWorkloads()
+%MAKEWORKLOADS Creates the examples and their input generators, the generators return the inputs and the number of
+%   bytes read and written by a call.
+
+  workloads = struct('name', {}, 'scalable', {}, 'make', {});
+
+  workloads(end + 1) = struct('name', 'arrayFillGetPr', 'scalable', false, 'make', @(n) deal({}, 4 * 8));
+  workloads(end + 1) = struct('name', 'doubleelement',  'scalable', false, 'make', @(n) deal({}, 4 * 2));
+  workloads(end + 1) = struct('name', 'xtimesy',        'scalable', true,  'make', @makeXtimesy);
+  workloads(end + 1) = struct('name', 'convec',         'scalable', true,  'make', @makeConvec);
+  workloads(end + 1) = struct('name', 'findnz',         'scalable', true,  'make', @makeFindnz);
+  workloads(end + 1) = struct('name', 'fulltosparse',   'scalable', true,  'make', @makeFulltosparse);
+  workloads(end + 1) = struct('name', 'phonebook',      'scalable', true,  'make', @makePhonebook);
+end
+
+function [args, bytes] = makeXtimesy(n)
+  args  = {2, rand(n, 1)};
+  bytes = 2 * 8 * n;
+end
+
+function [args, bytes] = makeConvec(n)
+  % The convolution is O(n * m), a short kernel keeps the time dominated by the data movement
+  x     = complex(rand(1, n), rand(1, n));
+  y     = complex(rand(1, 8), rand(1, 8));
+  args  = {x, y};
+  bytes = 16 * (2 * n + 7);
+end
+
+function [args, bytes] = makeFindnz(n)
+  x     = double(rand(n, 1) < 0.5);
+  args  = {x};
+  bytes = 8 * n + 8 * nnz(x);
+end
+
+function [args, bytes] = makeFulltosparse(n)
+  m     = max(1, round(sqrt(n)));
+  x     = double(rand(m, m) < 0.1);
+  args  = {x};
+  bytes = 8 * m * m + 16 * nnz(x);
+end
+
+function [args, bytes] = makePhonebook(n)
+  names  = arrayfun(@(i) sprintf('name%d', i), 1:n, 'UniformOutput', false);
+  phones = num2cell(1:n);
+  args   = {struct('name', names, 'phone', phones)};
+  bytes  = sum(cellfun(@numel, names)) * 2 + 8 * n;
+end
+
+function time = measure(name, args, minTime)
+%MEASURE Gets the time per call in nanoseconds, batches of calls run until the minimum time has elapsed.
+
+  fn = str2func(name);
+
+  % Warm up, also loads the MEX file
+  out = fn(args{:}); %#ok<NASGU>
+
+  iterations = 1;
+
+  while true
+    start = tic;
+
+    for i = 1:iterations
+      out = fn(args{:}); %#ok<NASGU>
+    end
+
+    elapsed = toc(start);
+
+    if elapsed >= minTime
+      break;
+    end
+
+    % Grows the batch like Google Benchmark, at most 10 times and aimed 40 % past the minimum time
+    iterations = ceil(iterations * min(10, max(2, 1.4 * minTime / max(elapsed, 1e-9))));
+  end
+
+  time = elapsed / iterations * 1e9;
+end
+
+function saveJson(path, results)
+%SAVEJSON Saves the results in the Google Benchmark JSON format, one benchmark per build and size.
+
+  benchmarks = struct('name', {}, 'run_type', {}, 'iterations', {}, 'real_time', {}, 'cpu_time', {}, ...
+                      'time_unit', {}, 'bytes_per_second', {});
+
+  for result = results
+    builds = {'c', result.timeC; 'cpp', result.timeCpp};
+
+    for i = 1:size(builds, 1)
+      time = builds{i, 2};
+
+      benchmarks(end + 1) = struct('name', sprintf('%s/%s/%d', result.name, builds{i, 1}, result.size), ...
+                                   'run_type', 'iteration', 'iterations', 1, 'real_time', time, ...
+                                   'cpu_time', time, 'time_unit', 'ns', ...
+                                   'bytes_per_second', result.bytes / time * 1e9); %#ok<AGROW>
+    end
+  end
+
+  file = fopen(path, 'w');
+
+  if file < 0
+    error('matlabw:bench:refbookBench', 'failed to open the JSON file');
+  end
+
+  cleanup = onCleanup(@() fclose(file));
+
+  fprintf(file, '%s\n', jsonencode(struct('context', struct('library', 'matlabw'), 'benchmarks', benchmarks)));
+end
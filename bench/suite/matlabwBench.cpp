@@ -0,0 +1,635 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Microbenchmarks of the wrapper hot paths in the style of Google Benchmark. Each benchmark runs batches of
+ * iterations until the minimum time has elapsed, the results are returned as a struct array and optionally saved in
+ * the Google Benchmark JSON format, so runs can be compared with its tools/compare.py.
+ *
+ * Usage: results = matlabwBench()
+ *        results = matlabwBench(filter)
+ *        results = matlabwBench(filter, jsonPath)
+ *        results = matlabwBench(filter, jsonPath, minTime)
+ *
+ * filter   - only benchmarks whose name contains the filter are run, '' runs all
+ * jsonPath - path of the JSON file, '' does not save the results
+ * minTime  - the minimum time per benchmark in seconds, 0.5 by default
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <matlabw/mat/mat.hpp>
+#include <matlabw/mex/mex.hpp>
+#include <matlabw/mex/Function.hpp>
+
+using namespace matlabw;
+
+namespace
+{
+  /// @brief Clock used to measure the benchmarks.
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Prevents the compiler from optimizing away a value.
+   * @tparam T The type of the value.
+   * @param value The value.
+   */
+  template<typename T>
+  void doNotOptimize(const T& value)
+  {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /// @brief State of a running benchmark, the benchmark body loops while keepRunning() returns true.
+  class State
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param iterations The number of iterations of the batch.
+       */
+      explicit State(std::size_t iterations)
+      : mIterations{iterations}
+      {}
+
+      /**
+       * @brief Starts the next iteration, the first call starts the timer and the last one stops it.
+       * @return True if the iteration should run, false when the batch is done.
+       */
+      [[nodiscard]] bool keepRunning()
+      {
+        if (mIteration == 0)
+        {
+          mStart = Clock::now();
+        }
+
+        if (mIteration++ < mIterations)
+        {
+          return true;
+        }
+
+        mElapsed = Clock::now() - mStart;
+
+        return false;
+      }
+
+      /**
+       * @brief Sets the number of bytes processed per iteration to report the throughput.
+       * @param bytes The number of bytes.
+       */
+      void setBytesPerIteration(std::size_t bytes) noexcept
+      {
+        mBytesPerIteration = bytes;
+      }
+
+      /**
+       * @brief Gets the number of iterations of the batch.
+       * @return The number of iterations.
+       */
+      [[nodiscard]] std::size_t getIterations() const noexcept
+      {
+        return mIterations;
+      }
+
+      /**
+       * @brief Gets the elapsed time of the batch.
+       * @return The elapsed time in seconds.
+       */
+      [[nodiscard]] double getElapsed() const noexcept
+      {
+        return mElapsed.count();
+      }
+
+      /**
+       * @brief Gets the number of bytes processed per iteration.
+       * @return The number of bytes, 0 if not set.
+       */
+      [[nodiscard]] std::size_t getBytesPerIteration() const noexcept
+      {
+        return mBytesPerIteration;
+      }
+
+    private:
+      std::size_t                   mIterations{};        ///< The number of iterations of the batch.
+      std::size_t                   mIteration{};         ///< The current iteration.
+      std::size_t                   mBytesPerIteration{}; ///< The number of bytes processed per iteration.
+      Clock::time_point             mStart{};             ///< The start of the batch.
+      std::chrono::duration<double> mElapsed{};           ///< The elapsed time of the batch.
+  };
+
+  /// @brief Registered benchmark.
+  struct Benchmark
+  {
+    std::string                 name; ///< The name of the benchmark.
+    std::function<void(State&)> body; ///< The benchmark body.
+  };
+
+  /// @brief Result of a benchmark.
+  struct Result
+  {
+    std::string name;           ///< The name of the benchmark.
+    std::size_t iterations;     ///< The number of iterations of the measured batch.
+    double      timePerIter;    ///< The time per iteration in nanoseconds.
+    double      bytesPerSecond; ///< The throughput in bytes per second, 0 if not reported.
+  };
+
+  /**
+   * @brief Runs a benchmark, the number of iterations grows until a batch takes at least the minimum time.
+   * @param benchmark The benchmark.
+   * @param minTime The minimum time in seconds.
+   * @return The result of the last batch.
+   */
+  Result run(const Benchmark& benchmark, double minTime)
+  {
+    std::size_t iterations{1};
+
+    while (true)
+    {
+      State state{iterations};
+
+      benchmark.body(state);
+
+      const double elapsed = state.getElapsed();
+
+      if (elapsed >= minTime || iterations >= std::size_t{1} << 30)
+      {
+        const double bytes = static_cast<double>(state.getBytesPerIteration() * iterations);
+
+        return Result{benchmark.name,
+                      iterations,
+                      elapsed * 1e9 / static_cast<double>(iterations),
+                      (elapsed > 0.0) ? bytes / elapsed : 0.0};
+      }
+
+      // Aims for 1.4 times the minimum time, but grows at most 10 times per batch like Google Benchmark.
+      const double factor = (elapsed > 0.0) ? std::min(10.0, minTime * 1.4 / elapsed) : 10.0;
+
+      iterations = std::max(iterations + 1, static_cast<std::size_t>(static_cast<double>(iterations) * factor));
+    }
+  }
+
+  /**
+   * @brief Registers the array creation and copy benchmarks.
+   * @param benchmarks The benchmarks.
+   */
+  void addArrayBenchmarks(std::vector<Benchmark>& benchmarks)
+  {
+    for (const std::size_t size : {std::size_t{64}, std::size_t{1} << 20})
+    {
+      const std::string suffix = "/" + std::to_string(size);
+      const std::size_t bytes  = size * sizeof(double);
+
+      benchmarks.push_back({"makeNumericArray" + suffix, [=](State& state)
+      {
+        state.setBytesPerIteration(bytes);
+
+        while (state.keepRunning())
+        {
+          auto array = mx::makeNumericArray<double>(size, 1);
+          doNotOptimize(array.getData());
+        }
+      }});
+
+      benchmarks.push_back({"makeUninitNumericArray" + suffix, [=](State& state)
+      {
+        state.setBytesPerIteration(bytes);
+
+        while (state.keepRunning())
+        {
+          auto array = mx::makeUninitNumericArray<double>(size, 1);
+          doNotOptimize(array.getData());
+        }
+      }});
+
+      benchmarks.push_back({"duplicateArray" + suffix, [=](State& state)
+      {
+        const auto source = mx::makeNumericArray<double>(size, 1);
+
+        state.setBytesPerIteration(bytes);
+
+        while (state.keepRunning())
+        {
+          mx::Array copy{source};
+          doNotOptimize(copy.get());
+        }
+      }});
+    }
+  }
+
+  /**
+   * @brief Registers the visit dispatch benchmarks.
+   * @param benchmarks The benchmarks.
+   */
+  void addVisitBenchmarks(std::vector<Benchmark>& benchmarks)
+  {
+    const std::pair<const char*, mx::ClassId> classes[]
+    {
+      {"double", mx::ClassId::_double},
+      {"int32",  mx::ClassId::int32},
+      {"uint8",  mx::ClassId::uint8},
+    };
+
+    for (const auto& [className, classId] : classes)
+    {
+      benchmarks.push_back({std::string{"visit/"} + className, [classId](State& state)
+      {
+        const mx::Array array = mx::makeNumericArray(1, 1, classId);
+
+        while (state.keepRunning())
+        {
+          const std::size_t size = mx::visit(mx::ArrayCref{array}, mx::Visitor
+          {
+            []<typename T>(mx::NumericArrayCref<T> numeric) { return numeric.getSize() * sizeof(T); },
+            [](auto&&) { return std::size_t{}; }
+          });
+
+          doNotOptimize(size);
+        }
+      }});
+    }
+  }
+
+  /**
+   * @brief Registers the struct field access benchmarks.
+   * @param benchmarks The benchmarks.
+   */
+  void addStructBenchmarks(std::vector<Benchmark>& benchmarks)
+  {
+    static constexpr const char* fieldNames[]{"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"};
+    static constexpr std::size_t structCount{1024};
+
+    const auto makeStruct = []
+    {
+      auto array = mx::makeStructArray(structCount, 1, fieldNames);
+
+      for (std::size_t i{}; i < structCount; ++i)
+      {
+        array.setField(i, "theta", mx::makeNumericScalar<double>(static_cast<double>(i)));
+      }
+
+      return array;
+    };
+
+    benchmarks.push_back({"getField/name", [=](State& state)
+    {
+      const auto array = makeStruct();
+
+      while (state.keepRunning())
+      {
+        for (std::size_t i{}; i < structCount; ++i)
+        {
+          doNotOptimize(array.getField(i, "theta"));
+        }
+      }
+    }});
+
+    benchmarks.push_back({"getField/FieldIndex", [=](State& state)
+    {
+      const auto           array      = makeStruct();
+      const mx::FieldIndex fieldIndex = array.getFieldIndex("theta");
+
+      while (state.keepRunning())
+      {
+        for (std::size_t i{}; i < structCount; ++i)
+        {
+          doNotOptimize(array.getField(i, fieldIndex));
+        }
+      }
+    }});
+  }
+
+  /**
+   * @brief Registers the string conversion benchmarks.
+   * @param benchmarks The benchmarks.
+   */
+  void addStringBenchmarks(std::vector<Benchmark>& benchmarks)
+  {
+    for (const std::size_t length : {std::size_t{16}, std::size_t{4096}})
+    {
+      benchmarks.push_back({"toAscii/" + std::to_string(length), [=](State& state)
+      {
+        const auto array = mx::makeCharArray(std::string(length, 'x'));
+
+        state.setBytesPerIteration(length);
+
+        while (state.keepRunning())
+        {
+          const std::string str = mx::toAscii(mx::ArrayCref{array});
+          doNotOptimize(str.data());
+        }
+      }});
+    }
+  }
+
+  /**
+   * @brief Command adding two double scalars, the body of a tiny MEX call.
+   * @param lhs Left-hand side arguments.
+   * @param rhs Right-hand side arguments.
+   */
+  void addCommand(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+  {
+    mex::setScalarOutput(lhs, 0, mex::getScalarArg(rhs, 0) + mex::getScalarArg(rhs, 1));
+  }
+
+  /// @brief Table of the dispatch benchmarks, the measured command is among typical neighbours.
+  constexpr auto benchCommands = mex::makeCommandTable({{"init", addCommand},
+                                                        {"reset", addCommand},
+                                                        {"quote", addCommand},
+                                                        {"order", addCommand},
+                                                        {"cancel", addCommand},
+                                                        {"status", addCommand},
+                                                        {"price", addCommand},
+                                                        {"add", addCommand, 2, 2},
+                                                        {"spread", addCommand},
+                                                        {"volume", addCommand},
+                                                        {"position", addCommand},
+                                                        {"pnl", addCommand},
+                                                        {"risk", addCommand},
+                                                        {"limits", addCommand},
+                                                        {"flush", addCommand},
+                                                        {"shutdown", addCommand}});
+
+  /**
+   * @brief Registers the per-call latency benchmarks of tiny calls. direct calls the command like a separate MEX file
+   *        would, the others select it by name first. Under MATLAB both pay the same entry into mexFunction, so the
+   *        difference is the cost of multiplexing the commands in a single MEX file.
+   * @param benchmarks The benchmarks.
+   */
+  void addDispatchBenchmarks(std::vector<Benchmark>& benchmarks)
+  {
+    const auto makeArgs = []
+    {
+      std::vector<mx::Array> args{};
+      args.emplace_back(mx::makeCharArray("add"));
+      args.emplace_back(mx::makeNumericScalar<double>(1.0));
+      args.emplace_back(mx::makeNumericScalar<double>(2.0));
+      return args;
+    };
+
+    benchmarks.push_back({"dispatch/direct", [=](State& state)
+    {
+      const std::vector<mx::Array> args = makeArgs();
+      const mx::ArrayCref          rhs[]{args[1], args[2]};
+
+      while (state.keepRunning())
+      {
+        mx::Array lhs[1];
+        addCommand(lhs, rhs);
+        doNotOptimize(lhs[0].get());
+      }
+    }});
+
+    benchmarks.push_back({"dispatch/CommandTable", [=](State& state)
+    {
+      const std::vector<mx::Array> args = makeArgs();
+      const mx::ArrayCref          rhs[]{args[0], args[1], args[2]};
+
+      while (state.keepRunning())
+      {
+        mx::Array lhs[1];
+        benchCommands(lhs, rhs);
+        doNotOptimize(lhs[0].get());
+      }
+    }});
+
+    benchmarks.push_back({"dispatch/map", [=](State& state)
+    {
+      const std::vector<mx::Array> args = makeArgs();
+      const mx::ArrayCref          rhs[]{args[0], args[1], args[2]};
+
+      std::map<std::string, mex::CommandHandler> handlers{};
+
+      for (std::string_view name : {"init", "reset", "quote", "order", "cancel", "status", "price", "add", "spread",
+                                    "volume", "position", "pnl", "risk", "limits", "flush", "shutdown"})
+      {
+        handlers.emplace(name, addCommand);
+      }
+
+      while (state.keepRunning())
+      {
+        mx::Array lhs[1];
+        handlers.at(mx::toAscii(rhs[0]))(mx::Span<mx::Array>{lhs}, mx::View<mx::ArrayCref>{rhs}.subspan(1));
+        doNotOptimize(lhs[0].get());
+      }
+    }});
+  }
+
+  /**
+   * @brief Registers the MAT-file throughput benchmarks.
+   * @param benchmarks The benchmarks.
+   * @param path The path of the temporary MAT-file.
+   */
+  void addMatBenchmarks(std::vector<Benchmark>& benchmarks, const std::string& path)
+  {
+    static constexpr std::size_t size{std::size_t{1} << 20};
+
+    benchmarks.push_back({"mat::File/write", [=](State& state)
+    {
+      const auto array = mx::makeNumericArray<double>(size, 1);
+
+      state.setBytesPerIteration(size * sizeof(double));
+
+      while (state.keepRunning())
+      {
+        mat::File file{path.c_str(), mat::Mode::w6};
+        file.putVariable("x", array);
+      }
+    }});
+
+    benchmarks.push_back({"mat::File/read", [=](State& state)
+    {
+      {
+        mat::File file{path.c_str(), mat::Mode::w6};
+        file.putVariable("x", mx::makeNumericArray<double>(size, 1));
+      }
+
+      state.setBytesPerIteration(size * sizeof(double));
+
+      while (state.keepRunning())
+      {
+        const mat::File file{path.c_str(), mat::Mode::r};
+        const mx::Array array = file.getVariable("x");
+        doNotOptimize(array.get());
+      }
+    }});
+  }
+
+#ifdef MATLABW_ENABLE_GPU
+  /**
+   * @brief Registers the GPU transfer benchmarks.
+   * @param benchmarks The benchmarks.
+   */
+  void addGpuBenchmarks(std::vector<Benchmark>& benchmarks)
+  {
+    static constexpr std::size_t size{std::size_t{1} << 22};
+
+    mx::gpu::init();
+
+    benchmarks.push_back({"gpu/upload", [=](State& state)
+    {
+      const auto host = mx::makeNumericArray<double>(size, 1);
+
+      state.setBytesPerIteration(size * sizeof(double));
+
+      while (state.keepRunning())
+      {
+        const mx::gpu::Array device{mx::ArrayCref{host}};
+        doNotOptimize(device.get());
+      }
+    }});
+
+    benchmarks.push_back({"gpu/download", [=](State& state)
+    {
+      const mx::gpu::Array device{mx::ArrayCref{mx::makeNumericArray<double>(size, 1)}};
+
+      state.setBytesPerIteration(size * sizeof(double));
+
+      while (state.keepRunning())
+      {
+        const mx::Array host{mxGPUCreateMxArrayOnCPU(device.get())};
+        doNotOptimize(host.get());
+      }
+    }});
+  }
+#endif
+
+  /**
+   * @brief Converts the results to a struct array with fields name, iterations, timePerIter [ns] and bytesPerSecond.
+   * @param results The results.
+   * @return The struct array.
+   */
+  mx::Array toStructArray(const std::vector<Result>& results)
+  {
+    static constexpr const char* fieldNames[]{"name", "iterations", "timePerIter", "bytesPerSecond"};
+
+    auto array = mx::makeStructArray(results.size(), 1, fieldNames);
+
+    for (std::size_t i{}; i < results.size(); ++i)
+    {
+      array.setField(i, "name", mx::makeCharArray(results[i].name));
+      array.setField(i, "iterations", mx::makeNumericScalar<double>(static_cast<double>(results[i].iterations)));
+      array.setField(i, "timePerIter", mx::makeNumericScalar<double>(results[i].timePerIter));
+      array.setField(i, "bytesPerSecond", mx::makeNumericScalar<double>(results[i].bytesPerSecond));
+    }
+
+    return array;
+  }
+
+  /**
+   * @brief Saves the results in the Google Benchmark JSON format. Benchmark names contain no characters that need
+   *        escaping.
+   * @param path The path of the JSON file.
+   * @param results The results.
+   */
+  void saveJson(const std::string& path, const std::vector<Result>& results)
+  {
+    static constexpr char id[]{"matlabw:bench:saveJson"};
+
+    std::FILE* file = std::fopen(path.c_str(), "w");
+
+    if (file == nullptr)
+    {
+      throw mx::Exception{id, "failed to open the JSON file"};
+    }
+
+    std::fprintf(file, "{\n  \"context\": {\"library\": \"matlabw\"},\n  \"benchmarks\": [\n");
+
+    for (std::size_t i{}; i < results.size(); ++i)
+    {
+      const Result& result = results[i];
+
+      std::fprintf(file,
+                   "    {\"name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %zu, \"real_time\": %.17g, "
+                   "\"cpu_time\": %.17g, \"time_unit\": \"ns\", \"bytes_per_second\": %.17g}%s\n",
+                   result.name.c_str(),
+                   result.iterations,
+                   result.timePerIter,
+                   result.timePerIter,
+                   result.bytesPerSecond,
+                   (i + 1 < results.size()) ? "," : "");
+    }
+
+    std::fprintf(file, "  ]\n}\n");
+
+    if (std::fclose(file) != 0)
+    {
+      throw mx::Exception{id, "failed to write the JSON file"};
+    }
+  }
+} // namespace
+
+void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+{
+  const std::string filter   = (rhs.size() > 0) ? mx::toUtf8(rhs[0]) : std::string{};
+  const std::string jsonPath = (rhs.size() > 1) ? mx::toUtf8(rhs[1]) : std::string{};
+  const double      minTime  = (rhs.size() > 2) ? mx::NumericArrayCref<double>{rhs[2]}[0] : 0.5;
+  const auto        matPath  = (std::filesystem::temp_directory_path() / "matlabw_bench.mat").string();
+
+  std::vector<Benchmark> benchmarks{};
+
+  addArrayBenchmarks(benchmarks);
+  addVisitBenchmarks(benchmarks);
+  addStructBenchmarks(benchmarks);
+  addStringBenchmarks(benchmarks);
+  addDispatchBenchmarks(benchmarks);
+  addMatBenchmarks(benchmarks, matPath);
+#ifdef MATLABW_ENABLE_GPU
+  addGpuBenchmarks(benchmarks);
+#endif
+
+  std::vector<Result> results{};
+
+  mex::printf("%-32s %14s %14s %14s\n", "benchmark", "iterations", "time [ns]", "rate [MB/s]");
+
+  for (const auto& benchmark : benchmarks)
+  {
+    if (benchmark.name.find(filter) == std::string::npos)
+    {
+      continue;
+    }
+
+    const Result& result = results.emplace_back(run(benchmark, minTime));
+
+    mex::printf("%-32s %14zu %14.1f %14.1f\n",
+                result.name.c_str(),
+                result.iterations,
+                result.timePerIter,
+                result.bytesPerSecond / (1 << 20));
+  }
+
+  std::filesystem::remove(matPath);
+
+  if (!jsonPath.empty())
+  {
+    saveJson(jsonPath, results);
+  }
+
+  lhs[0] = toStructArray(results);
+}
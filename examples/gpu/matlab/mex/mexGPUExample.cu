@@ -8,23 +8,21 @@
 
 #include <matlabw/mex/mex.hpp>
 #include <matlabw/mex/Function.hpp>
+#include <matlabw/mx/gpu/launch.hpp>
 
 using namespace matlabw;
 
 /*
  * Device code
  */
-__global__  void TimesTwo(const double* const A,
-                          double* const       B,
-                          const unsigned      N)
+__global__  void TimesTwo(const mx::gpu::DeviceView<const double> A,
+                          const mx::gpu::DeviceView<double>       B)
 {
-  /* Calculate the global linear index, assuming a 1-d grid. */
-  const unsigned i = blockDim.x * blockIdx.x + threadIdx.x;
-
-  if (i < N)
+  /* Each thread processes the elements of a grid-stride loop, so any size of the array is covered. */
+  mx::gpu::forEachIndex(A.size(), [&](std::size_t i)
   {
     B[i] = 2.0 * A[i];
-  }
+  });
 }
 
 /*
@@ -36,9 +34,6 @@ void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref>
   static constexpr char errId[]  = "parallel:gpu:mexGPUExample:InvalidInput";
   static constexpr char errMsg[] = "Invalid input to MEX file.";
 
-  /* Choose a reasonably sized number of threads for the block. */
-  static constexpr unsigned threadsPerBlock = 256;
-
   mx::gpu::init();
 
   /* Throw an error if the input is not a GPU array. */
@@ -47,35 +42,34 @@ void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref>
     throw mx::Exception{errId, errMsg};
   }
 
-  mx::gpu::Array A{rhs[0]};
+  /* Borrow the input without copying its device data. */
+  const auto A = mx::gpu::borrow(rhs[0]);
 
   /*
     * Verify that A really is a double array before extracting the pointer.
     */
-  if (A.getClassId() != mx::ClassId::_double)
+  if (A.getCref().getClassId() != mx::ClassId::_double)
   {
     throw mx::Exception{errId, errMsg};
   }
 
   /*
-    * Now that we have verified the data type, extract a pointer to the input
+    * Now that we have verified the data type, create a view of the input
     * data on the device.
     */
-  const double* d_A = mx::gpu::NumericArrayCref<double>{A}.getData();
+  const auto d_A = mx::gpu::makeDeviceView(A.getTypedCref<double>());
 
-  /* Create a GPUArray to hold the result and get its underlying pointer. */
-  auto B = mx::gpu::makeUninitNumericArray<double>(A.getDims());
+  /* Create a GPUArray to hold the result and get a view of its data. */
+  auto B = mx::gpu::makeUninitNumericArray<double>(A.getCref().getDims());
 
-  double* d_B = B.getData();
+  const auto d_B = mx::gpu::makeDeviceView(B);
 
   /*
-    * Call the kernel using the CUDA runtime API. We are using a 1-d grid here,
-    * and it would be possible for the number of elements to be too large for
-    * the grid. For this example we are not guarding against this possibility.
+    * Call the kernel using the CUDA runtime API. The launch configuration is
+    * chosen from the occupancy of the kernel and the grid-stride loop covers
+    * arrays larger than the grid.
     */
-  const unsigned N = static_cast<unsigned>(A.getSize());
-  const unsigned blocksPerGrid = (N + threadsPerBlock - 1) / threadsPerBlock;
-  TimesTwo<<<blocksPerGrid, threadsPerBlock>>>(d_A, d_B, N);
+  mx::gpu::launch(&TimesTwo, d_A.size(), nullptr, d_A, d_B);
 
   /* Wrap the result up as a MATLAB gpuArray for return. */
   lhs[0] = B.release();
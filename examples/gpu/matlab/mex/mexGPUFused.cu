@@ -0,0 +1,41 @@
+/*
+ * Example of fusing a chain of elementwise operations on a gpuArray into a
+ * single kernel. The MEX function takes a double gpuArray and returns
+ * B = sqrt(abs(A - offset) * scale) as a new gpuArray, e.g.
+ * B=mexGPUFused(A, offset, scale). Every element is read and written once.
+ */
+
+#include <matlabw/mex/mex.hpp>
+#include <matlabw/mex/Function.hpp>
+#include <matlabw/mx/gpu/expression.hpp>
+
+using namespace matlabw;
+
+void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+{
+  static constexpr char errId[]  = "parallel:gpu:mexGPUFused:InvalidInput";
+  static constexpr char errMsg[] = "Invalid input to MEX file.";
+
+  mx::gpu::init();
+
+  if (rhs.size() != 3 || !rhs[0].isGpuArray())
+  {
+    throw mx::Exception{errId, errMsg};
+  }
+
+  /* Borrow the input without copying its device data. */
+  const auto A = mx::gpu::borrow(rhs[0]);
+
+  if (A.getCref().getClassId() != mx::ClassId::_double || A.getCref().isComplex())
+  {
+    throw mx::Exception{errId, errMsg};
+  }
+
+  const double offset = rhs[1].getScalarAs<double>();
+  const double scale  = rhs[2].getScalarAs<double>();
+
+  /* The expression is only a description, evaluate() launches one kernel for the whole chain. */
+  const auto a = mx::gpu::expr(A.getTypedCref<double>());
+
+  lhs[0] = mx::gpu::evaluate(mx::gpu::sqrt(mx::gpu::abs(a - offset) * scale)).release();
+}
@@ -0,0 +1,110 @@
+/*
+ * Example of overlapping host-device copies with kernels. The MEX function takes
+ * a CPU double array and returns a CPU double array with every element doubled,
+ * e.g. B=mexGPUPipeline(A). The array is processed in chunks on two streams, each
+ * with its own staging slots, so the copies of one chunk run while the kernel of
+ * the other chunk computes.
+ */
+
+#include <cuda_runtime_api.h>
+
+#include <matlabw/mex/mex.hpp>
+#include <matlabw/mex/Function.hpp>
+#include <matlabw/mex/PinnedPool.hpp>
+#include <matlabw/mx/gpu/transfer.hpp>
+
+using namespace matlabw;
+
+/*
+ * Device code
+ */
+__global__ void TimesTwo(double* const A, const unsigned N)
+{
+  const unsigned i = blockDim.x * blockIdx.x + threadIdx.x;
+
+  if (i < N)
+  {
+    A[i] = 2.0 * A[i];
+  }
+}
+
+/*
+ * Host code
+ */
+void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+{
+  static constexpr char errId[]  = "parallel:gpu:mexGPUPipeline:InvalidInput";
+  static constexpr char errMsg[] = "Invalid input to MEX file.";
+
+  static constexpr unsigned    threadsPerBlock = 256;
+  static constexpr std::size_t chunkSize       = std::size_t{1} << 20;
+  static constexpr std::size_t streamCount     = 2;
+
+  mx::gpu::init();
+
+  if (rhs.size() != 1 || rhs[0].getClassId() != mx::ClassId::_double || rhs[0].isComplex())
+  {
+    throw mx::Exception{errId, errMsg};
+  }
+
+  const mx::NumericArrayCref<double> A{rhs[0]};
+
+  auto B = mx::makeUninitNumericArray<double>(A.getDims());
+
+  cudaStream_t                               streams[streamCount]{};
+  std::vector<mx::gpu::Transfer>             uploads{};
+  std::vector<mx::gpu::Transfer>             downloads{};
+  std::vector<mx::gpu::NumericArray<double>> buffers{};
+
+  /* Staging buffers come from the shared pinned pool, repeated calls do not pay for cudaHostAlloc. */
+  for (std::size_t s{}; s < streamCount; ++s)
+  {
+    cudaStreamCreate(&streams[s]);
+    uploads.emplace_back(chunkSize * sizeof(double), &mex::getPinnedPool());
+    downloads.emplace_back(chunkSize * sizeof(double), &mex::getPinnedPool());
+    buffers.push_back(mx::gpu::makeUninitNumericArray<double>(chunkSize, 1));
+  }
+
+  std::size_t pendingOffset[streamCount]{};
+  std::size_t pendingSize[streamCount]{};
+
+  /* Copies the finished download of a stream to the output. */
+  auto collect = [&](std::size_t s)
+  {
+    if (pendingSize[s] != 0)
+    {
+      downloads[s].copyTo(mx::Span<double>{B.getData() + pendingOffset[s], pendingSize[s]});
+      pendingSize[s] = 0;
+    }
+  };
+
+  for (std::size_t offset{}, chunk{}; offset < A.getSize(); offset += chunkSize, ++chunk)
+  {
+    const std::size_t s    = chunk % streamCount;
+    const std::size_t size = std::min(chunkSize, A.getSize() - offset);
+
+    /* The device buffer and the download slot of the stream are reused, collect the previous chunk first. */
+    collect(s);
+
+    double* const d_A = buffers[s].getData();
+
+    uploads[s].upload(mx::View<double>{A.getData() + offset, size}, d_A, streams[s]);
+
+    const unsigned N             = static_cast<unsigned>(size);
+    const unsigned blocksPerGrid = (N + threadsPerBlock - 1) / threadsPerBlock;
+    TimesTwo<<<blocksPerGrid, threadsPerBlock, 0, streams[s]>>>(d_A, N);
+
+    downloads[s].download(d_A, size * sizeof(double), streams[s]);
+
+    pendingOffset[s] = offset;
+    pendingSize[s]   = size;
+  }
+
+  for (std::size_t s{}; s < streamCount; ++s)
+  {
+    collect(s);
+    cudaStreamDestroy(streams[s]);
+  }
+
+  lhs[0] = std::move(B);
+}
@@ -7,6 +7,10 @@
  *
  *		[yp] = yprime(t, y)
  *
+ *  Y holds the 4 states of one or more orbits, e.g. a (4 * n) x k matrix
+ *  of n orbits when the solver evaluates the 'Vectorized' function. All
+ *  orbits are evaluated in one call, in parallel for many orbits.
+ *
  *  You may also want to look at the corresponding M-code, yprime.m.
  *
  * This is a MEX-file for MATLAB.
@@ -16,6 +20,7 @@
 
 #include <matlabw/mex/mex.hpp>
 #include <matlabw/mex/Function.hpp>
+#include <matlabw/mx/algorithm/ode.hpp>
 
 using namespace matlabw;
 
@@ -31,7 +36,8 @@ using namespace matlabw;
 static constexpr double mu  = 1.0 / 82.45;
 static constexpr double mus = 1.0 - 1.0 / 82.45;
 
-static void yprime(double yp[], const double[], const double y[])
+/* evaluated for a block of orbits at once, y and yp are the states and derivatives of one orbit */
+static constexpr auto yprime = [](double, auto y, auto yp) MATLABW_INLINE_LAMBDA
 {
   const double r1 = std::sqrt((y[0] + mu) * (y[0] + mu) + y[2] * y[2]);
   const double r2 = std::sqrt((y[0] - mus) * (y[0] - mus) + y[2] * y[2]);
@@ -46,7 +52,7 @@ static void yprime(double yp[], const double[], const double y[])
   yp[1] = 2 * y[3] + y[0] - mus * (y[0] + mu) / (r1 * r1 * r1) - mu * (y[0] - mus) / (r2 * r2 * r2);
   yp[2] = y[3];
   yp[3] = -2 * y[1] + y[2] - mus * y[2] / (r1 * r1 * r1) - mu * y[2] / (r2 * r2 * r2);
-}
+};
 
 void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
 {
@@ -73,19 +79,13 @@ void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref>
     throw mx::Exception{"MATLAB:yprime:invalidY", "Second input argument must be a real matrix."};
   }
 
-  /* Check the dimensions of Y.  Y can be 4 X 1 or 1 X 4. */
+  /* Check the dimensions of Y.  Y can be 4 X 1, 1 X 4 or hold 4 states per orbit. */
 
-  const std::size_t m = Y_IN.getDimM();
-  const std::size_t n = Y_IN.getDimN();
-
-  if (std::max(m, n) != 4 || std::min(m, n) != 1)
+  if (Y_IN.getSize() == 0 || Y_IN.getSize() % 4 != 0)
   {
-    throw mx::Exception{"MATLAB:yprime:invalidY", "YPRIME requires that Y be a 4 x 1 vector."};
+    throw mx::Exception{"MATLAB:yprime:invalidY", "YPRIME requires that Y hold 4 states per orbit."};
   }
 
-  /* Create a matrix for the return argument */
-  YP_OUT = mx::makeNumericArray<double>(m, n);
-
-  /* Do the actual computations in a subroutine */
-  yprime(YP_OUT.getDataAs<double>(), T_IN.getDataAs<double>(), Y_IN.getDataAs<double>());
+  /* Do the actual computations for all orbits and return a matrix of the size of Y */
+  YP_OUT = mx::algorithm::evaluateOde<4>(T_IN.getDataAs<double>()[0], mx::TypedArrayCref<double>{Y_IN}, yprime);
 }
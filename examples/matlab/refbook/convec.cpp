@@ -10,26 +10,10 @@
 
 #include <matlabw/mex/mex.hpp>
 #include <matlabw/mex/Function.hpp>
+#include <matlabw/mx/algorithm/convolution.hpp>
 
 using namespace matlabw;
 
-/* computational subroutine */
-void convec(const std::complex<double>* const x,
-            const std::complex<double>* const y,
-            std::complex<double>* const       z,
-            const std::size_t                 nx,
-            const std::size_t                 ny)
-{
-  /* perform the convolution of the complex vectors */
-  for (std::size_t i{}; i < nx; ++i)
-  {
-    for (std::size_t j{}; j < ny; ++j)
-    {
-      z[i + j] += x[i] * y[j];
-    }
-  }
-}
-
 /* The gateway routine. */
 void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
 {  
@@ -62,16 +46,12 @@ void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref>
   const std::size_t nx = rhs[0].getDimN();
   const std::size_t ny = rhs[1].getDimN();
 
-  /* create a new array and set the output pointer to it */
-  const std::size_t cols = nx + ny - 1;
-  auto output = mx::makeNumericArray<std::complex<double>>(rows, cols);
+  /* convolve with the direct kernel for short and FFT blocks for long vectors, in parallel for long signals */
+  auto output = mx::algorithm::conv(std::span{rhs[0].getDataAs<std::complex<double>>(), nx},
+                                    std::span{rhs[1].getDataAs<std::complex<double>>(), ny});
 
-  /* call the C subroutine */
-  convec(rhs[0].getDataAs<std::complex<double>>(),
-         rhs[1].getDataAs<std::complex<double>>(),
-         output.getData(),
-         nx,
-         ny);
+  /* the result of spans is a column vector */
+  output.resize(rows, output.getSize());
 
   lhs[0] = std::move(output);
 }
@@ -0,0 +1,61 @@
+/*=========================================================
+* dotProductComplex.c - Example to handle FORTRAN complex
+* return type for function called from a C MEX-file.
+*
+* X = dotProductComplex(A,B) computes the dot product of 
+* each element of two complex vectors A and B 
+* using BLAS routine ZDOTU: 
+* DOUBLE COMPLEX FUNCTION ZDOTU(N,ZX,INCX,ZY,INCY)
+*
+* where:
+* A and B are COMPLEX vectors of the same size  
+* X is COMPLEX scalar
+*
+* The C++ version works directly on the interleaved complex data
+* and needs neither BLAS nor the Fortran conversion helpers.
+*
+* This is a MEX file for MATLAB.
+* Copyright 2010-2021 The MathWorks, Inc.
+*=======================================================*/
+
+#include <matlabw/mex/mex.hpp>
+#include <matlabw/mex/Function.hpp>
+#include <matlabw/mx/algorithm/reduce.hpp>
+
+using namespace matlabw;
+
+/* the gateway function */
+void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+{
+  /* Check for proper number of arguments. */
+  if (rhs.size() != 2)
+  {
+    throw mx::Exception{"MATLAB:dotProductComplex:rhs", "This function requires 2 input matrices."};
+  }
+
+  /* Check for complex values */
+  if (!rhs[0].isDouble() || !rhs[0].isComplex() || !rhs[1].isDouble() || !rhs[1].isComplex())
+  {
+    throw mx::Exception{"MATLAB:dotProductComplex:real", "Input matrices must be complex."};
+  }
+
+  /* Validate input arguments */
+  if (std::min(rhs[0].getDimM(), rhs[0].getDimN()) > 1 || std::min(rhs[1].getDimM(), rhs[1].getDimN()) > 1)
+  {
+    throw mx::Exception{"MATLAB:dotProductComplex:matrix", "Input must be vectors."};
+  }
+
+  if (rhs[0].getSize() != rhs[1].getSize())
+  {
+    throw mx::Exception{"MATLAB:dotProductComplex:unequal", "Input vectors must be equal size."};
+  }
+
+  const mx::TypedArrayCref<std::complex<double>> a{rhs[0]};
+  const mx::TypedArrayCref<std::complex<double>> b{rhs[1]};
+
+  auto result = mx::makeNumericArray<std::complex<double>>(1, 1);
+
+  result[0] = mx::algorithm::dotUnconjugated(a, b);
+
+  lhs[0] = std::move(result);
+}
@@ -0,0 +1,127 @@
+/*=================================================================
+ * findnz.c 
+ * Example for illustrating how to handle N-dimensional arrays in a 
+ * MEX-file.  NOTE: MATLAB uses 1 based indexing, C uses 0 based indexing.
+ *
+ * Takes a N-dimensional array of doubles and returns the indices for
+ * the non-zero elements in the array. Findnz works differently than
+ * the FIND command in MATLAB in that it returns all the indices in
+ * one output variable, where the column element contains the index
+ * for that dimension.
+ *
+ * Sparse matrices are walked through their compressed columns without
+ * converting them to full storage.
+ *
+ * This is a MEX-file for MATLAB.  
+ * Copyright 1984-2017 The MathWorks, Inc.
+ *============================================================*/
+
+#include <matlabw/mex/mex.hpp>
+#include <matlabw/mex/Function.hpp>
+
+using namespace matlabw;
+
+/* return the 1 based indices of the non-zero elements of a full array */
+template<typename T>
+mx::NumericArray<double> findnz(mx::TypedArrayCref<T> array)
+{
+  const auto        dims = array.getDims();
+  const std::size_t nnz  = static_cast<std::size_t>(std::count_if(array.begin(), array.end(), [](const T& value)
+  {
+    return value != T{};
+  }));
+
+  auto        ind = mx::makeNumericArray<double>(nnz, dims.size());
+  std::size_t count{};
+
+  for (std::size_t j{}; j < array.getSize(); ++j)
+  {
+    if (array[j] != T{})
+    {
+      std::size_t temp = j;
+
+      for (std::size_t k{}; k < dims.size(); ++k)
+      {
+        ind[nnz * k + count] = static_cast<double>(temp % dims[k] + 1);
+        temp /= dims[k];
+      }
+
+      ++count;
+    }
+  }
+
+  return ind;
+}
+
+/* return the 1 based indices of the non-zero elements of a sparse matrix */
+template<typename T>
+mx::NumericArray<double> findnz(mx::SparseArrayCref<T> array)
+{
+  const auto csc = array.getCsc();
+
+  std::size_t nnz{};
+
+  for (const auto& value : csc.values)
+  {
+    nnz += (value != T{}) ? 1 : 0;
+  }
+
+  auto        ind = mx::makeNumericArray<double>(nnz, 2);
+  std::size_t count{};
+
+  for (std::size_t j{}; j < csc.cols; ++j)
+  {
+    for (std::size_t k = csc.colPtr[j]; k < csc.colPtr[j + 1]; ++k)
+    {
+      if (csc.values[k] != T{})
+      {
+        ind[count]       = static_cast<double>(csc.rowIdx[k] + 1);
+        ind[nnz + count] = static_cast<double>(j + 1);
+        ++count;
+      }
+    }
+  }
+
+  return ind;
+}
+
+/* the gateway function */
+void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+{
+  /* Check for proper number of input and output arguments */
+  if (rhs.size() != 1)
+  {
+    throw mx::Exception{"MATLAB:findnz:invalidNumInputs", "One input argument required."};
+  }
+
+  if (lhs.size() > 1)
+  {
+    throw mx::Exception{"MATLAB:findnz:maxlhs", "Too many output arguments."};
+  }
+
+  /* Check data type of input argument */
+  if (!rhs[0].isDouble())
+  {
+    throw mx::Exception{"MATLAB:findnz:invalidInputType", "Input array must be of type double."};
+  }
+
+  if (rhs[0].isSparse())
+  {
+    if (rhs[0].isComplex())
+    {
+      lhs[0] = findnz(mx::SparseArrayCref<std::complex<double>>{rhs[0]});
+    }
+    else
+    {
+      lhs[0] = findnz(mx::SparseArrayCref<double>{rhs[0]});
+    }
+  }
+  else if (rhs[0].isComplex())
+  {
+    lhs[0] = findnz(mx::TypedArrayCref<std::complex<double>>{rhs[0]});
+  }
+  else
+  {
+    lhs[0] = findnz(mx::TypedArrayCref<double>{rhs[0]});
+  }
+}
@@ -0,0 +1,96 @@
+/*=================================================================
+* fulltosparse.c
+* This example demonstrates how to populate a sparse
+* matrix.  For the purpose of this example, you must pass in a
+* non-sparse 2-dimensional argument of type double.
+*
+* This is a MEX-file for MATLAB.  
+* Copyright 1984-2017 The MathWorks, Inc.
+* All rights reserved.
+*=================================================================*/
+
+#include <cmath>
+
+#include <matlabw/mex/mex.hpp>
+#include <matlabw/mex/Function.hpp>
+
+using namespace matlabw;
+
+/* fill the sparse matrix column by column, growing its capacity when it runs out */
+template<typename T>
+mx::SparseArray<T> fulltosparse(mx::TypedArrayCref<T> full)
+{
+  const std::size_t m = full.getDimM();
+  const std::size_t n = full.getDimN();
+
+  double percent_sparse = 0.2;
+
+  auto sparse = mx::makeSparseArray<T>(m, n, static_cast<std::size_t>(std::ceil(double(m) * double(n) * percent_sparse)));
+
+  auto        storage = sparse.getStorage();
+  std::size_t k{};
+
+  for (std::size_t j{}; j < n; ++j)
+  {
+    storage.colPtr[j] = k;
+
+    for (std::size_t i{}; i < m; ++i)
+    {
+      const T value = full[i + j * m];
+
+      if (value != T{})
+      {
+        /* check to see if non-zero element will fit in the allocated output array */
+        if (k >= storage.values.size())
+        {
+          percent_sparse += 0.1;
+          sparse.setNzmax(static_cast<std::size_t>(std::ceil(double(m) * double(n) * percent_sparse)));
+          storage = sparse.getStorage();
+        }
+
+        storage.values[k] = value;
+        storage.rowIdx[k] = i;
+        ++k;
+      }
+    }
+  }
+
+  storage.colPtr[n] = k;
+
+  return sparse;
+}
+
+/* the gateway function */
+void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+{
+  /* Check for proper number of input and output arguments */
+  if (rhs.size() != 1)
+  {
+    throw mx::Exception{"MATLAB:fulltosparse:invalidNumInputs", "One input argument required."};
+  }
+
+  if (lhs.size() > 1)
+  {
+    throw mx::Exception{"MATLAB:fulltosparse:maxlhs", "Too many output arguments."};
+  }
+
+  /* Check data type of input argument */
+  if (!rhs[0].isDouble() || rhs[0].isSparse())
+  {
+    throw mx::Exception{"MATLAB:fulltosparse:inputNotDouble", "Input argument must be of type double."};
+  }
+
+  if (rhs[0].getRank() != 2)
+  {
+    throw mx::Exception{"MATLAB:fulltosparse:inputNot2D", "Input argument must be two dimensional\n"};
+  }
+
+  if (rhs[0].isComplex())
+  {
+    lhs[0] = fulltosparse(mx::TypedArrayCref<std::complex<double>>{rhs[0]});
+  }
+  else
+  {
+    lhs[0] = fulltosparse(mx::TypedArrayCref<double>{rhs[0]});
+  }
+}
@@ -0,0 +1,386 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MAT_APPENDER_HPP
+#define MATLABW_MAT_APPENDER_HPP
+
+#include <exception>
+#include <unordered_set>
+
+#include "detail/arrayBytes.hpp"
+#include "mat.hpp"
+
+namespace matlabw::mat
+{
+  /**
+   * @brief Growth strategy of an appended file. The MAT API decides the layout of each variable itself, so the file
+   *        grows by one write per flushed batch: the thresholds set how often it grows and grouping sets whether a
+   *        batch adds one variable per append or a single variable.
+   */
+  struct AppenderOptions
+  {
+    std::size_t maxBufferedBytes{std::size_t{64} << 20}; ///< Bytes of buffered arrays before the batch is written.
+    std::size_t maxBufferedCount{1024};                   ///< Number of buffered variables before the batch is written.
+    bool        group{};                                  ///< Write each batch as one scalar struct with a field per
+                                                          ///< variable, named groupPrefix and the batch number.
+    std::string groupPrefix{"batch"};                     ///< Prefix of the names of the grouped variables.
+  };
+
+namespace detail
+{
+  /**
+   * @brief Checks if a name is a valid MATLAB variable or field name.
+   * @param name The name.
+   * @return True if the name starts with a letter, continues with letters, digits or underscores and fits mxMAXNAM.
+   */
+  [[nodiscard]] inline bool isValidName(std::string_view name) noexcept
+  {
+    auto isAlpha = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+    auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+
+    if (name.empty() || name.size() >= mx::maxNameSize || !isAlpha(name.front()))
+    {
+      return false;
+    }
+
+    return std::all_of(name.begin() + 1, name.end(), [&](char c) { return isAlpha(c) || isDigit(c) || c == '_'; });
+  }
+} // namespace detail
+
+  /**
+   * @brief Append-only writer for logging many small variables into one MAT file. Arrays are moved in and buffered,
+   *        full batches are written with one check of the file. The names already in the file are read once on
+   *        construction and every appended name must be new, so a write never replaces a variable: replacing deletes
+   *        the old one, which rewrites the file. With grouping, a batch becomes a single variable, which avoids the
+   *        per-variable overhead of v7.3 files (one HDF5 dataset and its attributes each) and the directory searches
+   *        of matPutVariable. For telemetry, v6 files are the fastest to append to, since they need no compression.
+   *        The appender is not thread-safe.
+   */
+  class Appender
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param file The open file, owned by the appender.
+       * @param options The options.
+       */
+      explicit Appender(File&& file, const AppenderOptions& options = {})
+      : mFile{std::move(file)}, mOptions{options}
+      {
+        static constexpr char id[]{"matlabw:mat:Appender"};
+
+        if (!mFile.isOpen())
+        {
+          throw mx::Exception{id, "file is not open"};
+        }
+
+        if (mOptions.group && !detail::isValidName(mOptions.groupPrefix))
+        {
+          throw mx::Exception{id, "invalid group prefix"};
+        }
+
+        try
+        {
+          const auto [names, count] = mFile.getVariableNames();
+
+          for (std::size_t i{}; i < count; ++i)
+          {
+            mWrittenNames.emplace(names[i]);
+          }
+        }
+        catch (const mx::Exception&)
+        {
+          // The MAT API returns no directory for empty or write-only files.
+        }
+      }
+
+      /**
+       * @brief Constructor. Opens the file.
+       * @param filename The filename.
+       * @param mode The mode, Mode::u appends to an existing file.
+       * @param options The options.
+       */
+      Appender(const char* filename, Mode mode, const AppenderOptions& options = {})
+      : Appender{File{filename, mode}, options}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      Appender(const Appender&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      Appender(Appender&&) = delete;
+
+      /// @brief Destructor. Writes the buffered variables and closes the file, errors are discarded.
+      ~Appender() noexcept
+      {
+        try
+        {
+          close();
+        }
+        catch (...)
+        {
+          // Exceptions may not leave the destructor, call close() to observe them.
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Appender& operator=(const Appender&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      Appender& operator=(Appender&&) = delete;
+
+      /**
+       * @brief Appends a variable. Writes the batch once the buffered bytes or variables reach the thresholds.
+       * @param name The name of the variable, must not be in the file or the buffer. With grouping only the buffer
+       *             is checked, the name becomes a field of the batch variable.
+       * @param array The array, moved into the appender.
+       */
+      void append(std::string name, mx::Array&& array)
+      {
+        static constexpr char id[]{"matlabw:mat:Appender:append"};
+
+        if (!mFile.isOpen())
+        {
+          throw mx::Exception{id, "appender is closed"};
+        }
+
+        if (!array.isValid())
+        {
+          throw mx::Exception{id, "invalid array"};
+        }
+
+        if (!detail::isValidName(name))
+        {
+          throw mx::Exception{id, "invalid name '" + name + "'"};
+        }
+
+        // grouped names are fields of the batch variable, they only need to be unique within the batch
+        if ((!mOptions.group && mWrittenNames.contains(name)) || !mBufferedNames.insert(name).second)
+        {
+          throw mx::Exception{id, "variable '" + name + "' already exists"};
+        }
+
+        const std::size_t bytes = detail::getArrayBytes(array.get());
+
+        mBuffer.push_back(Pending{std::move(name), std::move(array)});
+        mBufferedBytes += bytes;
+
+        if (mBufferedBytes >= mOptions.maxBufferedBytes || mBuffer.size() >= mOptions.maxBufferedCount)
+        {
+          flush();
+        }
+      }
+
+      /**
+       * @brief Writes the buffered variables. The batch is cleared even if writing fails, the first error is rethrown.
+       */
+      void flush()
+      {
+        static constexpr char id[]{"matlabw:mat:Appender:flush"};
+        mx::ProfileZone       zone{id, "mat"};
+
+        if (mBuffer.empty())
+        {
+          return;
+        }
+
+        std::vector<Pending> batch = std::exchange(mBuffer, {});
+        mBufferedBytes = 0;
+        mBufferedNames.clear();
+
+        ++mBatchCount;
+
+        if (mOptions.group)
+        {
+          writeGroup(batch);
+        }
+        else
+        {
+          writeEach(batch);
+        }
+      }
+
+      /// @brief Writes the buffered variables and closes the file.
+      void close()
+      {
+        if (!mFile.isOpen())
+        {
+          return;
+        }
+
+        std::exception_ptr error{};
+
+        try
+        {
+          flush();
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+        }
+
+        mFile.close();
+
+        if (error != nullptr)
+        {
+          std::rethrow_exception(error);
+        }
+      }
+
+      /**
+       * @brief Gets the options.
+       * @return The options.
+       */
+      [[nodiscard]] const AppenderOptions& getOptions() const noexcept
+      {
+        return mOptions;
+      }
+
+      /**
+       * @brief Gets the number of buffered variables.
+       * @return The number of variables.
+       */
+      [[nodiscard]] std::size_t getBufferedCount() const noexcept
+      {
+        return mBuffer.size();
+      }
+
+      /**
+       * @brief Gets the estimated memory held by the buffered arrays.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBufferedBytes() const noexcept
+      {
+        return mBufferedBytes;
+      }
+
+      /**
+       * @brief Gets the number of written batches.
+       * @return The number of batches.
+       */
+      [[nodiscard]] std::size_t getBatchCount() const noexcept
+      {
+        return mBatchCount;
+      }
+    private:
+      /// @brief Buffered variable.
+      struct Pending
+      {
+        std::string name;  ///< The name of the variable.
+        mx::Array   array; ///< The array.
+      };
+
+      /**
+       * @brief Writes a batch as separate variables.
+       * @param batch The batch.
+       */
+      void writeEach(std::vector<Pending>& batch)
+      {
+        std::vector<std::pair<const char*, mx::ArrayCref>> variables{};
+        variables.reserve(batch.size());
+
+        for (const Pending& pending : batch)
+        {
+          variables.emplace_back(pending.name.c_str(), mx::ArrayCref{pending.array});
+        }
+
+        const std::vector<std::exception_ptr> errors = mFile.putVariables(variables);
+
+        std::exception_ptr error{};
+
+        for (std::size_t i{}; i < batch.size(); ++i)
+        {
+          if (errors[i] == nullptr)
+          {
+            mWrittenNames.insert(std::move(batch[i].name));
+          }
+          else if (error == nullptr)
+          {
+            error = errors[i];
+          }
+        }
+
+        if (error != nullptr)
+        {
+          std::rethrow_exception(error);
+        }
+      }
+
+      /**
+       * @brief Writes a batch as one scalar struct.
+       * @param batch The batch.
+       */
+      void writeGroup(std::vector<Pending>& batch)
+      {
+        static constexpr char id[]{"matlabw:mat:Appender:flush"};
+
+        std::string name{};
+
+        do
+        {
+          name = mOptions.groupPrefix + std::to_string(mGroupIndex++);
+        }
+        while (mWrittenNames.contains(name));
+
+        if (!detail::isValidName(name))
+        {
+          throw mx::Exception{id, "group name '" + name + "' is too long"};
+        }
+
+        std::vector<const char*> fieldNames(batch.size());
+
+        for (std::size_t i{}; i < batch.size(); ++i)
+        {
+          fieldNames[i] = batch[i].name.c_str();
+        }
+
+        const std::size_t dims[]{1, 1};
+
+        mx::Array group{mxCreateStructArray(2, dims, static_cast<int>(fieldNames.size()), fieldNames.data())};
+
+        if (!group.isValid())
+        {
+          throw mx::Exception{id, "failed to create group"};
+        }
+
+        for (std::size_t i{}; i < batch.size(); ++i)
+        {
+          mxSetFieldByNumber(group.get(), 0, static_cast<int>(i), batch[i].array.release());
+        }
+
+        mFile.putVariable(name.c_str(), group);
+        mWrittenNames.insert(std::move(name));
+      }
+
+      File                            mFile;            ///< The file.
+      AppenderOptions                 mOptions;         ///< The options.
+      std::vector<Pending>            mBuffer{};        ///< Buffered variables.
+      std::unordered_set<std::string> mBufferedNames{}; ///< Names of the buffered variables.
+      std::unordered_set<std::string> mWrittenNames{};  ///< Names of the variables in the file.
+      std::size_t                     mBufferedBytes{}; ///< Bytes of the buffered arrays.
+      std::size_t                     mBatchCount{};    ///< Number of written batches.
+      std::size_t                     mGroupIndex{};    ///< Number of the next group variable.
+  };
+} // namespace matlabw::mat
+
+#endif /* MATLABW_MAT_APPENDER_HPP */
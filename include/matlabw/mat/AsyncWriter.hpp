@@ -0,0 +1,293 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MAT_ASYNC_WRITER_HPP
+#define MATLABW_MAT_ASYNC_WRITER_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "detail/arrayBytes.hpp"
+#include "mat.hpp"
+
+namespace matlabw::mat
+{
+  /// @brief Options of the asynchronous writer.
+  struct AsyncWriterOptions
+  {
+    std::size_t maxPendingBytes{std::size_t{1} << 30}; ///< Bytes of queued arrays before put() blocks.
+  };
+
+  /**
+   * @brief Writes variables to a MAT file on a background thread. Arrays are moved in, not duplicated. The writer is
+   *        double-buffered: while the background thread writes one batch, put() fills the next one, so computation and
+   *        file I/O overlap. An error of the background thread is rethrown by the next call of put(), flush() or
+   *        close(), the variables queued until then are discarded. Like the parallel loader, the writer is
+   *        meant for standalone programs linked against the MAT library, not for MEX files.
+   */
+  class AsyncWriter
+  {
+    public:
+      /**
+       * @brief Constructor. Starts the background thread.
+       * @param file The open file, owned by the writer.
+       * @param options The options.
+       */
+      explicit AsyncWriter(File&& file, const AsyncWriterOptions& options = {})
+      : mFile{std::move(file)}, mMaxPendingBytes{options.maxPendingBytes}
+      {
+        if (!mFile.isOpen())
+        {
+          throw mx::Exception{"matlabw:mat:AsyncWriter", "file is not open"};
+        }
+
+        mThread = std::thread{[this]{ run(); }};
+      }
+
+      /**
+       * @brief Constructor. Opens the file and starts the background thread.
+       * @param filename The filename.
+       * @param mode The mode.
+       * @param options The options.
+       */
+      AsyncWriter(const char* filename, Mode mode, const AsyncWriterOptions& options = {})
+      : AsyncWriter{File{filename, mode}, options}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      AsyncWriter(const AsyncWriter&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      AsyncWriter(AsyncWriter&&) = delete;
+
+      /// @brief Destructor. Writes the queued variables and closes the file, errors are discarded.
+      ~AsyncWriter() noexcept
+      {
+        try
+        {
+          close();
+        }
+        catch (...)
+        {
+          // Exceptions may not leave the destructor, call close() to observe them.
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      AsyncWriter& operator=(AsyncWriter&&) = delete;
+
+      /**
+       * @brief Queues a variable for writing. Blocks while the queued arrays exceed the pending bytes limit.
+       * @param name The name of the variable.
+       * @param array The array, moved into the writer.
+       */
+      void put(std::string name, mx::Array&& array)
+      {
+        static constexpr char id[]{"matlabw:mat:AsyncWriter:put"};
+
+        if (!array.isValid())
+        {
+          throw mx::Exception{id, "invalid array"};
+        }
+
+        const std::size_t bytes = detail::getArrayBytes(array.get());
+
+        std::unique_lock lock{mMutex};
+
+        mDone.wait(lock, [&]
+        {
+          return mError != nullptr || mPendingBytes == 0 || mPendingBytes + bytes <= mMaxPendingBytes;
+        });
+
+        rethrowError();
+
+        if (mStopping)
+        {
+          throw mx::Exception{id, "writer is closed"};
+        }
+
+        mFront.push_back(Pending{std::move(name), std::move(array), bytes});
+        mPendingBytes += bytes;
+        ++mQueued;
+
+        lock.unlock();
+        mWork.notify_one();
+      }
+
+      /// @brief Waits until all queued variables are written (a fence), rethrows an error of the background thread.
+      void flush()
+      {
+        std::unique_lock lock{mMutex};
+
+        const std::size_t target = mQueued;
+
+        mDone.wait(lock, [&]{ return mError != nullptr || mWritten >= target; });
+
+        rethrowError();
+      }
+
+      /// @brief Writes the queued variables, stops the background thread and closes the file.
+      void close()
+      {
+        if (!mThread.joinable())
+        {
+          return;
+        }
+
+        {
+          std::lock_guard lock{mMutex};
+          mStopping = true;
+        }
+
+        mWork.notify_one();
+        mThread.join();
+
+        std::exception_ptr error = std::exchange(mError, nullptr);
+
+        mFile.close();
+
+        if (error != nullptr)
+        {
+          std::rethrow_exception(error);
+        }
+      }
+
+      /**
+       * @brief Gets the number of queued variables not written yet.
+       * @return The number of variables.
+       */
+      [[nodiscard]] std::size_t getPendingCount() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mQueued - mWritten;
+      }
+    private:
+      /// @brief Variable waiting to be written.
+      struct Pending
+      {
+        std::string name;  ///< The name of the variable.
+        mx::Array   array; ///< The array.
+        std::size_t bytes; ///< Estimated memory held by the array.
+      };
+
+      /// @brief Rethrows and clears the error of the background thread. The lock must be held.
+      void rethrowError()
+      {
+        if (mError != nullptr)
+        {
+          std::rethrow_exception(std::exchange(mError, nullptr));
+        }
+      }
+
+      /// @brief Background thread, swaps the buffers and writes the batch until stopped.
+      void run()
+      {
+        std::vector<Pending> batch{};
+        bool                 discard{};
+
+        for (;;)
+        {
+          {
+            std::unique_lock lock{mMutex};
+
+            mWork.wait(lock, [this]{ return mStopping || !mFront.empty(); });
+
+            if (mFront.empty())
+            {
+              return;
+            }
+
+            std::swap(batch, mFront);
+
+            discard = mError != nullptr;
+          }
+
+          std::exception_ptr error{};
+          std::size_t        written{};
+
+          for (Pending& pending : batch)
+          {
+            if (!discard && error == nullptr)
+            {
+              try
+              {
+                mFile.putVariable(pending.name.c_str(), pending.array);
+              }
+              catch (...)
+              {
+                error = std::current_exception();
+              }
+            }
+
+            ++written;
+          }
+
+          std::size_t bytes{};
+
+          for (const Pending& pending : batch)
+          {
+            bytes += pending.bytes;
+          }
+
+          // release the arrays outside of the lock
+          batch.clear();
+
+          {
+            std::lock_guard lock{mMutex};
+
+            mWritten      += written;
+            mPendingBytes -= bytes;
+
+            if (error != nullptr && mError == nullptr)
+            {
+              mError = error;
+            }
+          }
+
+          mDone.notify_all();
+        }
+      }
+
+      File                    mFile;            ///< The file, used by the background thread only.
+      std::size_t             mMaxPendingBytes; ///< Bytes of queued arrays before put() blocks.
+      mutable std::mutex      mMutex{};         ///< Protects the state below.
+      std::condition_variable mWork{};          ///< Signals queued variables or stopping.
+      std::condition_variable mDone{};          ///< Signals written variables.
+      std::vector<Pending>    mFront{};         ///< Batch filled by put().
+      std::size_t             mPendingBytes{};  ///< Bytes of the queued arrays.
+      std::size_t             mQueued{};        ///< Number of queued variables.
+      std::size_t             mWritten{};       ///< Number of written or discarded variables.
+      std::exception_ptr      mError{};         ///< First error of the background thread.
+      bool                    mStopping{};      ///< Whether close() was called.
+      std::thread             mThread{};        ///< The background thread.
+  };
+} // namespace matlabw::mat
+
+#endif /* MATLABW_MAT_ASYNC_WRITER_HPP */
@@ -0,0 +1,301 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MAT_CONCURRENT_READER_HPP
+#define MATLABW_MAT_CONCURRENT_READER_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <matlabw/mx/parallel/parallelFor.hpp>
+
+#include "mat.hpp"
+
+namespace matlabw::mat
+{
+  /**
+   * @brief Thread-safe random-access reader of one MAT file. A MATFile handle is not safe to share between threads, so
+   *        the reader keeps a pool of handles opened independently on the same file. Each read borrows a free handle,
+   *        opens a new one while fewer than the maximum are open, or waits for one to be returned. Reads of different
+   *        variables from different threads then proceed in parallel. Like the parallel loader, the reader is meant for
+   *        standalone programs linked against the MAT library, not for MEX files.
+   */
+  class ConcurrentReader
+  {
+    public:
+      /**
+       * @brief Constructor. Opens the first handle, so that a missing file is reported immediately.
+       * @param filename The filename.
+       * @param maxHandles The maximum number of open handles, 0 selects the number of hardware threads.
+       */
+      explicit ConcurrentReader(std::string filename, std::size_t maxHandles = 0)
+      : mFilename{std::move(filename)},
+        mMaxHandles{(maxHandles > 0) ? maxHandles
+                                     : std::max(std::size_t{1}, std::size_t{std::thread::hardware_concurrency()})}
+      {
+        mHandles.push_back(std::make_unique<File>(mFilename.c_str(), Mode::r));
+        mFree.push_back(mHandles.back().get());
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      ConcurrentReader(const ConcurrentReader&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ConcurrentReader(ConcurrentReader&&) = delete;
+
+      /// @brief Destructor. Closes the handles, no read may be in progress.
+      ~ConcurrentReader() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ConcurrentReader& operator=(const ConcurrentReader&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ConcurrentReader& operator=(ConcurrentReader&&) = delete;
+
+      /**
+       * @brief Reads a variable. Thread-safe.
+       * @param name The name of the variable.
+       * @return The array.
+       */
+      [[nodiscard]] mx::Array getVariable(const std::string& name)
+      {
+        Lease lease{*this};
+
+        return lease.get().getVariable(name.c_str());
+      }
+
+      /**
+       * @brief Reads the header of a variable, the array has the class and size of the variable but no data.
+       *        Thread-safe.
+       * @param name The name of the variable.
+       * @return The array.
+       */
+      [[nodiscard]] mx::Array getVariableInfo(const std::string& name)
+      {
+        Lease lease{*this};
+
+        return lease.get().getVariableInfo(name.c_str());
+      }
+
+      /**
+       * @brief Gets the names of the variables of the file. Thread-safe.
+       * @return The names.
+       */
+      [[nodiscard]] std::vector<std::string> getVariableNames()
+      {
+        Lease lease{*this};
+
+        const auto [names, count] = lease.get().getVariableNames();
+
+        return std::vector<std::string>(names.get(), names.get() + count);
+      }
+
+      /**
+       * @brief Reads several variables in parallel on a pool with one thread per handle. Errors are reported per
+       *        variable, a failed variable does not stop the others.
+       * @param names The names of the variables.
+       * @return The variables in the order of the names.
+       */
+      [[nodiscard]] std::vector<VariableResult> getVariables(mx::View<std::string> names)
+      {
+        std::vector<VariableResult> results(names.size());
+
+        auto read = [&](std::size_t i)
+        {
+          results[i].name = names[i];
+
+          try
+          {
+            results[i].array = getVariable(names[i]);
+          }
+          catch (...)
+          {
+            results[i].error = std::current_exception();
+          }
+        };
+
+        if (mMaxHandles == 1 || names.size() <= 1)
+        {
+          for (std::size_t i{}; i < names.size(); ++i)
+          {
+            read(i);
+          }
+
+          return results;
+        }
+
+        std::call_once(mPoolOnce, [this]
+        {
+          // the calling thread participates in the loop, it holds the last handle
+          mPool = std::make_unique<mx::parallel::ThreadPool>(mx::parallel::ThreadPoolOptions{mMaxHandles - 1});
+        });
+
+        mx::parallel::parallelFor(0, names.size(), 1, read, *mPool);
+
+        return results;
+      }
+
+      /**
+       * @brief Gets the filename.
+       * @return The filename.
+       */
+      [[nodiscard]] const std::string& getFilename() const noexcept
+      {
+        return mFilename;
+      }
+
+      /**
+       * @brief Gets the maximum number of open handles.
+       * @return The number of handles.
+       */
+      [[nodiscard]] std::size_t getMaxHandles() const noexcept
+      {
+        return mMaxHandles;
+      }
+
+      /**
+       * @brief Gets the number of open handles.
+       * @return The number of handles.
+       */
+      [[nodiscard]] std::size_t getOpenHandles() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mHandles.size();
+      }
+    private:
+      /// @brief Borrowed handle, returned to the pool on destruction.
+      class Lease
+      {
+        public:
+          /**
+           * @brief Constructor. Borrows a handle, waits if all are busy.
+           * @param reader The reader.
+           */
+          explicit Lease(ConcurrentReader& reader)
+          : mReader{reader}, mFile{reader.acquire()}
+          {}
+
+          /// @brief Explicitly deleted copy constructor.
+          Lease(const Lease&) = delete;
+
+          /// @brief Destructor. Returns the handle.
+          ~Lease() noexcept
+          {
+            mReader.release(mFile);
+          }
+
+          /// @brief Explicitly deleted copy assignment operator.
+          Lease& operator=(const Lease&) = delete;
+
+          /**
+           * @brief Gets the handle.
+           * @return The handle.
+           */
+          [[nodiscard]] File& get() const noexcept
+          {
+            return *mFile;
+          }
+        private:
+          ConcurrentReader& mReader; ///< The reader.
+          File*             mFile;   ///< The borrowed handle.
+      };
+
+      /**
+       * @brief Borrows a free handle, opens a new one if none is free and the maximum is not reached.
+       * @return The handle.
+       */
+      [[nodiscard]] File* acquire()
+      {
+        std::unique_lock lock{mMutex};
+
+        mReturned.wait(lock, [this]{ return !mFree.empty() || mHandles.size() + mOpening < mMaxHandles; });
+
+        if (!mFree.empty())
+        {
+          File* file = mFree.back();
+          mFree.pop_back();
+
+          return file;
+        }
+
+        // open outside of the lock, opening parses the file header
+        ++mOpening;
+        lock.unlock();
+
+        std::unique_ptr<File> file{};
+        std::exception_ptr    error{};
+
+        try
+        {
+          file = std::make_unique<File>(mFilename.c_str(), Mode::r);
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+        }
+
+        lock.lock();
+        --mOpening;
+
+        if (error != nullptr)
+        {
+          lock.unlock();
+          mReturned.notify_one();
+          std::rethrow_exception(error);
+        }
+
+        mHandles.push_back(std::move(file));
+
+        return mHandles.back().get();
+      }
+
+      /**
+       * @brief Returns a borrowed handle.
+       * @param file The handle.
+       */
+      void release(File* file) noexcept
+      {
+        {
+          std::lock_guard lock{mMutex};
+          mFree.push_back(file);
+        }
+
+        mReturned.notify_one();
+      }
+
+      std::string                               mFilename;   ///< The filename.
+      std::size_t                               mMaxHandles; ///< Maximum number of open handles.
+      mutable std::mutex                        mMutex{};    ///< Protects the handles.
+      std::condition_variable                   mReturned{}; ///< Signals a returned handle.
+      std::vector<std::unique_ptr<File>>        mHandles{};  ///< Open handles.
+      std::vector<File*>                        mFree{};     ///< Handles not borrowed.
+      std::size_t                               mOpening{};  ///< Handles being opened.
+      std::once_flag                            mPoolOnce{}; ///< Creates the pool on the first parallel read.
+      std::unique_ptr<mx::parallel::ThreadPool> mPool{};     ///< Threads of getVariables().
+  };
+} // namespace matlabw::mat
+
+#endif /* MATLABW_MAT_CONCURRENT_READER_HPP */
@@ -0,0 +1,511 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MAT_INDEX_HPP
+#define MATLABW_MAT_INDEX_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "detail/arrayBytes.hpp"
+#include "mat.hpp"
+
+namespace matlabw::mat
+{
+  /// @brief Metadata of a variable stored in a file, read from its header without the data.
+  struct VariableMeta
+  {
+    std::string              name{};                       ///< The name of the variable.
+    mx::ClassId              classId{mx::ClassId::unknown}; ///< The class ID.
+    std::vector<std::size_t> dims{};                       ///< The dimensions.
+    bool                     sparse{};                     ///< Is the variable sparse?
+    bool                     complex{};                    ///< Is the variable complex?
+    std::size_t              elementSize{};                ///< The size of an element in bytes.
+    std::size_t              bytes{};                      ///< The estimated size of the loaded array in bytes.
+
+    /**
+     * @brief Gets the number of elements.
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t getSize() const noexcept
+    {
+      return std::accumulate(dims.begin(), dims.end(), std::size_t{1}, std::multiplies<>{});
+    }
+  };
+
+namespace detail
+{
+  /// @brief Sidecar file format is native endian, the sidecar is a cache and is only reused on the same machine.
+  inline constexpr char indexMagic[8]{'M', 'W', 'I', 'D', 'X', '\0', '\0', '\1'};
+
+  /// @brief Size and modification time of a file, the sidecar is valid while both are unchanged.
+  struct FileStamp
+  {
+    std::uint64_t size{};  ///< The size of the file in bytes.
+    std::int64_t  mtime{}; ///< The modification time in ticks of the file clock.
+
+    /**
+     * @brief Equality operator.
+     * @return True if the stamps are equal.
+     */
+    [[nodiscard]] friend bool operator==(const FileStamp&, const FileStamp&) = default;
+  };
+
+  /**
+   * @brief Gets the stamp of a file.
+   * @param path The path of the file.
+   * @return The stamp, or std::nullopt if the file cannot be queried.
+   */
+  [[nodiscard]] inline std::optional<FileStamp> getFileStamp(const std::filesystem::path& path) noexcept
+  {
+    std::error_code ec{};
+
+    const auto size = std::filesystem::file_size(path, ec);
+
+    if (ec)
+    {
+      return std::nullopt;
+    }
+
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+
+    if (ec)
+    {
+      return std::nullopt;
+    }
+
+    return FileStamp{static_cast<std::uint64_t>(size), static_cast<std::int64_t>(mtime.time_since_epoch().count())};
+  }
+
+  /**
+   * @brief Writes a trivially copyable value to a stream.
+   * @tparam T The value type.
+   * @param os The stream.
+   * @param value The value.
+   */
+  template<typename T>
+  void writeRaw(std::ostream& os, const T& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  /**
+   * @brief Reads a trivially copyable value from a stream.
+   * @tparam T The value type.
+   * @param is The stream.
+   * @param value The value.
+   * @return True if the value was read.
+   */
+  template<typename T>
+  [[nodiscard]] bool readRaw(std::istream& is, T& value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+  }
+} // namespace detail
+
+  /**
+   * @brief Index of the variables of a file. The headers are scanned once and the index can be kept in a sidecar file
+   *        which is reused while the size and the modification time of the file are unchanged.
+   */
+  class Index
+  {
+    public:
+      /// @brief Default constructor.
+      Index() = default;
+
+      /**
+       * @brief Copy constructor.
+       * @param other The other index.
+       */
+      Index(const Index& other)
+      : mPath{other.mPath}, mStamp{other.mStamp}, mVariables{other.mVariables}
+      {
+        buildLookup();
+      }
+
+      /// @brief Default move constructor.
+      Index(Index&&) = default;
+
+      /// @brief Default destructor.
+      ~Index() = default;
+
+      /**
+       * @brief Copy assignment operator.
+       * @param other The other index.
+       * @return Reference to this index.
+       */
+      Index& operator=(const Index& other)
+      {
+        if (this != &other)
+        {
+          mPath      = other.mPath;
+          mStamp     = other.mStamp;
+          mVariables = other.mVariables;
+          buildLookup();
+        }
+
+        return *this;
+      }
+
+      /// @brief Default move assignment operator.
+      Index& operator=(Index&&) = default;
+
+      /**
+       * @brief Scans the headers of all variables of a file.
+       * @param path The path of the file.
+       * @return The index.
+       */
+      [[nodiscard]] static Index scan(const std::filesystem::path& path)
+      {
+        static constexpr char id[]{"matlabw:mat:Index:scan"};
+
+        const auto stamp = detail::getFileStamp(path);
+
+        if (!stamp)
+        {
+          throw mx::Exception{id, "failed to query file"};
+        }
+
+        File file{path.string().c_str(), Mode::r};
+
+        Index index{};
+        index.mPath  = path;
+        index.mStamp = *stamp;
+
+        while (auto info = file.getNextVariableInfo())
+        {
+          const mx::ArrayCref array{info->array};
+
+          VariableMeta meta{};
+          meta.name        = std::move(info->name);
+          meta.classId     = array.getClassId();
+          meta.dims.assign(array.getDims().begin(), array.getDims().end());
+          meta.sparse      = array.isSparse();
+          meta.complex     = array.isComplex();
+          meta.elementSize = mxGetElementSize(array.get());
+          meta.bytes       = detail::getArrayBytes(array.get());
+
+          index.mVariables.push_back(std::move(meta));
+        }
+
+        index.buildLookup();
+
+        return index;
+      }
+
+      /**
+       * @brief Loads the index of a file from its sidecar file. If the sidecar is missing or stale, the file is scanned
+       *        and the sidecar is rewritten. A sidecar that cannot be written is not an error.
+       * @param path The path of the file.
+       * @param sidecarPath The path of the sidecar file, empty selects getSidecarPath(path).
+       * @return The index.
+       */
+      [[nodiscard]] static Index open(const std::filesystem::path& path, const std::filesystem::path& sidecarPath = {})
+      {
+        const auto sidecar = (sidecarPath.empty()) ? getSidecarPath(path) : sidecarPath;
+
+        if (auto index = read(sidecar); index && index->isCurrent(path))
+        {
+          index->mPath = path;
+
+          return std::move(*index);
+        }
+
+        auto index = scan(path);
+
+        try
+        {
+          index.save(sidecar);
+        }
+        catch (const mx::Exception&)
+        {
+          // The index stays usable, the file is scanned again next time.
+        }
+
+        return index;
+      }
+
+      /**
+       * @brief Reads an index from a sidecar file.
+       * @param sidecarPath The path of the sidecar file.
+       * @return The index, or std::nullopt if the sidecar is missing or malformed.
+       */
+      [[nodiscard]] static std::optional<Index> read(const std::filesystem::path& sidecarPath)
+      {
+        std::ifstream is{sidecarPath, std::ios::binary};
+
+        char magic[sizeof(detail::indexMagic)]{};
+
+        if (!is.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), detail::indexMagic))
+        {
+          return std::nullopt;
+        }
+
+        Index         index{};
+        std::uint64_t count{};
+
+        if (!detail::readRaw(is, index.mStamp) || !detail::readRaw(is, count))
+        {
+          return std::nullopt;
+        }
+
+        for (std::uint64_t i{}; i < count; ++i)
+        {
+          VariableMeta  meta{};
+          std::uint64_t nameSize{};
+          std::uint64_t rank{};
+          std::uint32_t classId{};
+          std::uint8_t  flags{};
+          std::uint64_t elementSize{};
+          std::uint64_t bytes{};
+
+          if (!detail::readRaw(is, nameSize) || nameSize > maxNameSize)
+          {
+            return std::nullopt;
+          }
+
+          meta.name.resize(nameSize);
+
+          if (!is.read(meta.name.data(), static_cast<std::streamsize>(nameSize))
+              || !detail::readRaw(is, classId) || !detail::readRaw(is, flags) || !detail::readRaw(is, rank)
+              || rank > maxRank)
+          {
+            return std::nullopt;
+          }
+
+          meta.dims.resize(rank);
+
+          for (auto& dim : meta.dims)
+          {
+            std::uint64_t value{};
+
+            if (!detail::readRaw(is, value))
+            {
+              return std::nullopt;
+            }
+
+            dim = static_cast<std::size_t>(value);
+          }
+
+          if (!detail::readRaw(is, elementSize) || !detail::readRaw(is, bytes))
+          {
+            return std::nullopt;
+          }
+
+          meta.classId     = static_cast<mx::ClassId>(classId);
+          meta.sparse      = (flags & sparseFlag) != 0;
+          meta.complex     = (flags & complexFlag) != 0;
+          meta.elementSize = static_cast<std::size_t>(elementSize);
+          meta.bytes       = static_cast<std::size_t>(bytes);
+
+          index.mVariables.push_back(std::move(meta));
+        }
+
+        index.buildLookup();
+
+        return index;
+      }
+
+      /**
+       * @brief Writes the index to a sidecar file. The sidecar is written to a temporary file first and renamed, so a
+       *        reader never sees a partial sidecar.
+       * @param sidecarPath The path of the sidecar file.
+       */
+      void save(const std::filesystem::path& sidecarPath) const
+      {
+        static constexpr char id[]{"matlabw:mat:Index:save"};
+
+        auto tmpPath = sidecarPath;
+        tmpPath += ".tmp";
+
+        {
+          std::ofstream os{tmpPath, std::ios::binary | std::ios::trunc};
+
+          os.write(detail::indexMagic, sizeof(detail::indexMagic));
+          detail::writeRaw(os, mStamp);
+          detail::writeRaw(os, static_cast<std::uint64_t>(mVariables.size()));
+
+          for (const auto& meta : mVariables)
+          {
+            const std::uint8_t flags = (meta.sparse ? sparseFlag : 0) | (meta.complex ? complexFlag : 0);
+
+            detail::writeRaw(os, static_cast<std::uint64_t>(meta.name.size()));
+            os.write(meta.name.data(), static_cast<std::streamsize>(meta.name.size()));
+            detail::writeRaw(os, static_cast<std::uint32_t>(meta.classId));
+            detail::writeRaw(os, flags);
+            detail::writeRaw(os, static_cast<std::uint64_t>(meta.dims.size()));
+
+            for (const std::size_t dim : meta.dims)
+            {
+              detail::writeRaw(os, static_cast<std::uint64_t>(dim));
+            }
+
+            detail::writeRaw(os, static_cast<std::uint64_t>(meta.elementSize));
+            detail::writeRaw(os, static_cast<std::uint64_t>(meta.bytes));
+          }
+
+          if (!os.flush())
+          {
+            std::error_code ec{};
+            std::filesystem::remove(tmpPath, ec);
+
+            throw mx::Exception{id, "failed to write sidecar file"};
+          }
+        }
+
+        std::error_code ec{};
+        std::filesystem::rename(tmpPath, sidecarPath, ec);
+
+        if (ec)
+        {
+          std::filesystem::remove(tmpPath, ec);
+
+          throw mx::Exception{id, "failed to replace sidecar file"};
+        }
+      }
+
+      /**
+       * @brief Gets the default path of the sidecar file of a file, the path with ".idx" appended.
+       * @param path The path of the file.
+       * @return The path of the sidecar file.
+       */
+      [[nodiscard]] static std::filesystem::path getSidecarPath(const std::filesystem::path& path)
+      {
+        auto sidecarPath = path;
+        sidecarPath += ".idx";
+
+        return sidecarPath;
+      }
+
+      /**
+       * @brief Checks if the index still describes a file, its size and modification time are unchanged.
+       * @param path The path of the file, empty selects the path the index was created for.
+       * @return True if the index is current, false otherwise.
+       */
+      [[nodiscard]] bool isCurrent(const std::filesystem::path& path = {}) const noexcept
+      {
+        const auto stamp = detail::getFileStamp((path.empty()) ? mPath : path);
+
+        return stamp && *stamp == mStamp;
+      }
+
+      /**
+       * @brief Gets the path of the file, empty if the index was read from a sidecar directly.
+       * @return The path of the file.
+       */
+      [[nodiscard]] const std::filesystem::path& getPath() const noexcept
+      {
+        return mPath;
+      }
+
+      /**
+       * @brief Gets the number of variables.
+       * @return The number of variables.
+       */
+      [[nodiscard]] std::size_t getVariableCount() const noexcept
+      {
+        return mVariables.size();
+      }
+
+      /**
+       * @brief Gets the metadata of a variable, variables are in the order they are stored in the file.
+       * @param i The index of the variable.
+       * @return The metadata.
+       */
+      [[nodiscard]] const VariableMeta& operator[](std::size_t i) const
+      {
+        return mVariables[i];
+      }
+
+      /**
+       * @brief Finds the metadata of a variable by name.
+       * @param name The name of the variable.
+       * @return Pointer to the metadata, or nullptr if there is no such variable.
+       */
+      [[nodiscard]] const VariableMeta* find(std::string_view name) const
+      {
+        const auto it = mLookup.find(name);
+
+        return (it != mLookup.end()) ? &mVariables[it->second] : nullptr;
+      }
+
+      /**
+       * @brief Checks if a variable exists.
+       * @param name The name of the variable.
+       * @return True if the variable exists, false otherwise.
+       */
+      [[nodiscard]] bool contains(std::string_view name) const
+      {
+        return find(name) != nullptr;
+      }
+
+      /**
+       * @brief Gets an iterator to the first variable.
+       * @return The iterator.
+       */
+      [[nodiscard]] auto begin() const noexcept
+      {
+        return mVariables.cbegin();
+      }
+
+      /**
+       * @brief Gets an iterator past the last variable.
+       * @return The iterator.
+       */
+      [[nodiscard]] auto end() const noexcept
+      {
+        return mVariables.cend();
+      }
+    private:
+      static constexpr std::uint8_t  sparseFlag{0x1};      ///< Flag of sparse variables in the sidecar.
+      static constexpr std::uint8_t  complexFlag{0x2};     ///< Flag of complex variables in the sidecar.
+      static constexpr std::uint64_t maxNameSize{1 << 16}; ///< Longest name accepted from a sidecar.
+      static constexpr std::uint64_t maxRank{1 << 16};     ///< Largest rank accepted from a sidecar.
+
+      /// @brief Builds the name lookup, the keys view the names stored in mVariables.
+      void buildLookup()
+      {
+        mLookup.clear();
+        mLookup.reserve(mVariables.size());
+
+        for (std::size_t i{}; i < mVariables.size(); ++i)
+        {
+          mLookup.emplace(mVariables[i].name, i);
+        }
+      }
+
+      std::filesystem::path                             mPath{};      ///< The path of the file.
+      detail::FileStamp                                 mStamp{};     ///< The stamp of the file when it was scanned.
+      std::vector<VariableMeta>                         mVariables{}; ///< The variables in file order.
+      std::unordered_map<std::string_view, std::size_t> mLookup{};    ///< Name to position in mVariables.
+  };
+} // namespace matlabw::mat
+
+#endif /* MATLABW_MAT_INDEX_HPP */
@@ -0,0 +1,599 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MAT_MAPPED_FILE_HPP
+#define MATLABW_MAT_MAPPED_FILE_HPP
+
+#if defined(__unix__) || defined(__APPLE__)
+# define MATLABW_MAPPED_FILE_POSIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <cstring>
+#include <unordered_map>
+
+#include "mat.hpp"
+
+namespace matlabw::mat
+{
+  /// @brief Access pattern advice for mapped data.
+  enum class Advice
+  {
+    normal,     ///< No special treatment.
+    sequential, ///< Data are read sequentially, read ahead aggressively.
+    random,     ///< Data are read randomly, do not read ahead.
+    willNeed,   ///< Data will be needed soon, start reading them now.
+  };
+
+  /// @brief Variable of a mapped file.
+  struct MappedVariable
+  {
+    std::string              name{};                       ///< The name of the variable.
+    mx::ClassId              classId{mx::ClassId::unknown}; ///< The class ID, unknown until the variable is loaded.
+    std::vector<std::size_t> dims{};                       ///< The dimensions, empty until the variable is loaded.
+    const std::byte*         data{};                       ///< The mapped data, null if the variable is loaded.
+    std::size_t              bytes{};                      ///< The size of the mapped data in bytes.
+    mx::Array                array{};                      ///< The loaded array of a variable that is not mapped.
+
+    /**
+     * @brief Is the variable mapped?
+     * @return True if the data are mapped from the file, false if they are loaded.
+     */
+    [[nodiscard]] bool isMapped() const noexcept
+    {
+      return data != nullptr;
+    }
+  };
+
+namespace detail
+{
+  /// @brief Data types of MAT-file level 5 data elements.
+  enum class MiType : std::uint32_t
+  {
+    int8       = 1,  ///< 8-bit signed integer.
+    uint8      = 2,  ///< 8-bit unsigned integer.
+    int16      = 3,  ///< 16-bit signed integer.
+    uint16     = 4,  ///< 16-bit unsigned integer.
+    int32      = 5,  ///< 32-bit signed integer.
+    uint32     = 6,  ///< 32-bit unsigned integer.
+    single     = 7,  ///< IEEE 754 single precision.
+    double_    = 9,  ///< IEEE 754 double precision.
+    int64      = 12, ///< 64-bit signed integer.
+    uint64     = 13, ///< 64-bit unsigned integer.
+    matrix     = 14, ///< MATLAB array.
+    compressed = 15, ///< Compressed data.
+  };
+
+  /// @brief Data element of a MAT-file level 5 file.
+  struct MiElement
+  {
+    MiType           type{};  ///< The data type.
+    const std::byte* data{};  ///< The data.
+    std::size_t      bytes{}; ///< The size of the data in bytes.
+    std::size_t      next{};  ///< The offset of the next element, elements are 8-byte aligned.
+  };
+
+  /**
+   * @brief Reads a MAT-file level 5 data element tag in the native byte order.
+   * @param base The beginning of the file.
+   * @param offset The offset of the tag.
+   * @param end The end offset of the enclosing element or file.
+   * @return The element, or std::nullopt if it extends past the end.
+   */
+  [[nodiscard]] inline std::optional<MiElement> readMiElement(const std::byte* base,
+                                                              std::size_t      offset,
+                                                              std::size_t      end) noexcept
+  {
+    if (offset > end || end - offset < 8)
+    {
+      return std::nullopt;
+    }
+
+    std::uint32_t word[2]{};
+    std::memcpy(word, base + offset, sizeof(word));
+
+    // Small data element, up to 4 bytes are packed into the tag.
+    if ((word[0] >> 16) != 0)
+    {
+      const std::size_t bytes = word[0] >> 16;
+
+      if (bytes > 4)
+      {
+        return std::nullopt;
+      }
+
+      return MiElement{static_cast<MiType>(word[0] & 0xffff), base + offset + 4, bytes, offset + 8};
+    }
+
+    const std::size_t bytes  = word[1];
+    const std::size_t padded = (bytes + 7) & ~std::size_t{7}; // The padding of the last element may be missing.
+
+    if (end - offset - 8 < bytes)
+    {
+      return std::nullopt;
+    }
+
+    return MiElement{static_cast<MiType>(word[0]), base + offset + 8, bytes, std::min(offset + 8 + padded, end)};
+  }
+
+  /**
+   * @brief Gets the data type that stores a numeric class without conversion.
+   * @param classId The class ID.
+   * @return The data type, or std::nullopt if the class is not numeric.
+   */
+  [[nodiscard]] constexpr std::optional<MiType> getMiType(mx::ClassId classId) noexcept
+  {
+    switch (classId)
+    {
+    case mx::ClassId::_double: return MiType::double_;
+    case mx::ClassId::single:  return MiType::single;
+    case mx::ClassId::int8:    return MiType::int8;
+    case mx::ClassId::uint8:   return MiType::uint8;
+    case mx::ClassId::int16:   return MiType::int16;
+    case mx::ClassId::uint16:  return MiType::uint16;
+    case mx::ClassId::int32:   return MiType::int32;
+    case mx::ClassId::uint32:  return MiType::uint32;
+    case mx::ClassId::int64:   return MiType::int64;
+    case mx::ClassId::uint64:  return MiType::uint64;
+    default:                   return std::nullopt;
+    }
+  }
+
+  /**
+   * @brief Gets the size of a numeric data type.
+   * @param type The data type.
+   * @return The size in bytes.
+   */
+  [[nodiscard]] constexpr std::size_t getMiTypeSize(MiType type) noexcept
+  {
+    switch (type)
+    {
+    case MiType::int8:
+    case MiType::uint8:
+      return 1;
+    case MiType::int16:
+    case MiType::uint16:
+      return 2;
+    case MiType::int32:
+    case MiType::uint32:
+    case MiType::single:
+      return 4;
+    default:
+      return 8;
+    }
+  }
+
+  /**
+   * @brief Parses a top-level matrix element and records it if its data can be mapped. Only real numeric and logical
+   *        arrays stored in their own class type can be mapped, MATLAB may store e.g. doubles as smaller integers.
+   * @param base The beginning of the file.
+   * @param element The matrix element.
+   * @return The variable, or std::nullopt if it cannot be mapped.
+   */
+  [[nodiscard]] inline std::optional<MappedVariable> parseMiMatrix(const std::byte* base, const MiElement& element)
+  {
+    static constexpr std::uint32_t complexFlag{0x0800};
+    static constexpr std::uint32_t logicalFlag{0x0200};
+
+    const std::size_t begin = static_cast<std::size_t>(element.data - base);
+    const std::size_t end   = begin + element.bytes;
+
+    auto flags = readMiElement(base, begin, end);
+
+    if (!flags || flags->type != MiType::uint32 || flags->bytes < 4)
+    {
+      return std::nullopt;
+    }
+
+    std::uint32_t flagWord{};
+    std::memcpy(&flagWord, flags->data, sizeof(flagWord));
+
+    auto dims = readMiElement(base, flags->next, end);
+    auto name = (dims) ? readMiElement(base, dims->next, end) : std::nullopt;
+    auto real = (name) ? readMiElement(base, name->next, end) : std::nullopt;
+
+    if (!real || dims->type != MiType::int32 || name->type != MiType::int8 || (flagWord & complexFlag) != 0)
+    {
+      return std::nullopt;
+    }
+
+    MappedVariable variable{};
+    variable.name.assign(reinterpret_cast<const char*>(name->data), name->bytes);
+    variable.classId = static_cast<mx::ClassId>(flagWord & 0xff);
+
+    const auto miType = getMiType(variable.classId);
+
+    if (!miType || real->type != *miType)
+    {
+      return std::nullopt;
+    }
+
+    if ((flagWord & logicalFlag) != 0)
+    {
+      if (variable.classId != mx::ClassId::uint8)
+      {
+        return std::nullopt;
+      }
+
+      variable.classId = mx::ClassId::logical;
+    }
+
+    std::size_t size{1};
+
+    for (std::size_t i{}; i + 4 <= dims->bytes; i += 4)
+    {
+      std::int32_t dim{};
+      std::memcpy(&dim, dims->data + i, sizeof(dim));
+
+      if (dim < 0)
+      {
+        return std::nullopt;
+      }
+
+      variable.dims.push_back(static_cast<std::size_t>(dim));
+      size *= static_cast<std::size_t>(dim);
+    }
+
+    if (variable.dims.size() < 2 || real->bytes != size * getMiTypeSize(*miType))
+    {
+      return std::nullopt;
+    }
+
+    variable.data  = real->data;
+    variable.bytes = real->bytes;
+
+    return variable;
+  }
+} // namespace detail
+
+  /**
+   * @brief Read-only memory-mapped MAT-file. Real numeric and logical variables of uncompressed level 5 files (saved
+   *        with -v6 or -v7 without compression) are exposed directly over the mapping, nothing is copied or read
+   *        before the pages are touched. Compressed, complex, sparse, char, cell and struct variables, v7.3 files and
+   *        files in a foreign byte order fall back to a normal load on first access.
+   */
+  class MappedFile
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param filename The filename.
+       */
+      explicit MappedFile(const char* filename)
+      : mFile{filename, Mode::r}
+      {
+        map(filename);
+
+        auto [names, count] = mFile.getVariableNames();
+
+        // The lookup views the names, no reallocation may happen once it is filled.
+        mMapped.reserve(mMapped.size() + count);
+
+        for (std::size_t i{}; i < mMapped.size(); ++i)
+        {
+          mLookup.emplace(mMapped[i].name, i);
+        }
+
+        for (std::size_t i{}; i < count; ++i)
+        {
+          if (mLookup.find(names[i]) == mLookup.end())
+          {
+            mMapped.push_back(MappedVariable{names[i]});
+            mLookup.emplace(mMapped.back().name, mMapped.size() - 1);
+          }
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      MappedFile(const MappedFile&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      MappedFile(MappedFile&&) = delete;
+
+      /// @brief Destructor.
+      ~MappedFile()
+      {
+#     ifdef MATLABW_MAPPED_FILE_POSIX
+        if (mBase != nullptr)
+        {
+          munmap(const_cast<std::byte*>(mBase), mSize);
+        }
+#     endif
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      MappedFile& operator=(MappedFile&&) = delete;
+
+      /**
+       * @brief Gets the number of variables.
+       * @return The number of variables.
+       */
+      [[nodiscard]] std::size_t getVariableCount() const noexcept
+      {
+        return mMapped.size();
+      }
+
+      /**
+       * @brief Checks if a variable exists.
+       * @param name The name of the variable.
+       * @return True if the variable exists, false otherwise.
+       */
+      [[nodiscard]] bool contains(std::string_view name) const
+      {
+        return mLookup.find(name) != mLookup.end();
+      }
+
+      /**
+       * @brief Checks if a variable is mapped.
+       * @param name The name of the variable.
+       * @return True if the variable is mapped, false if it is loaded on access.
+       */
+      [[nodiscard]] bool isMapped(std::string_view name) const
+      {
+        return findVariable("matlabw:mat:MappedFile:isMapped", name).isMapped();
+      }
+
+      /**
+       * @brief Gets a variable, loading it if it is not mapped.
+       * @param name The name of the variable.
+       * @return The variable, valid as long as the file.
+       */
+      [[nodiscard]] const MappedVariable& getVariable(std::string_view name)
+      {
+        static constexpr char id[]{"matlabw:mat:MappedFile:getVariable"};
+
+        auto& variable = findVariable(id, name);
+
+        if (!variable.isMapped() && !variable.array.isValid())
+        {
+          variable.array   = mFile.getVariable(variable.name.c_str());
+          variable.classId = variable.array.getClassId();
+          variable.dims.assign(variable.array.getDims().begin(), variable.array.getDims().end());
+        }
+
+        return variable;
+      }
+
+      /**
+       * @brief Gets the dimensions of a variable.
+       * @param name The name of the variable.
+       * @return The dimensions.
+       */
+      [[nodiscard]] mx::View<std::size_t> getDims(std::string_view name)
+      {
+        return getVariable(name).dims;
+      }
+
+      /**
+       * @brief Gets the data of a variable in column-major order. The element type must match the variable class.
+       * @tparam T The element type.
+       * @param name The name of the variable.
+       * @return The data, valid as long as the file.
+       */
+      template<typename T>
+      [[nodiscard]] mx::View<T> getView(std::string_view name)
+      {
+        static constexpr char id[]{"matlabw:mat:MappedFile:getView"};
+
+        const auto& variable = getVariable(name);
+
+        if (variable.isMapped())
+        {
+          if (variable.classId != mx::TypeProperties<T>::classId || mx::isComplexNumeric<T>)
+          {
+            throw mx::Exception{id, "element type must match the variable class"};
+          }
+
+          return mx::View<T>{reinterpret_cast<const T*>(variable.data), variable.bytes / sizeof(T)};
+        }
+
+        const mx::TypedArrayCref<T> array{mx::ArrayCref{variable.array}};
+
+        return mx::View<T>{array.getData(), array.getSize()};
+      }
+
+      /**
+       * @brief Advises the operating system how the whole mapping is accessed.
+       * @param advice The advice.
+       */
+      void advise(Advice advice) const noexcept
+      {
+        adviseRange(mBase, mSize, advice);
+      }
+
+      /**
+       * @brief Advises the operating system how a mapped variable is accessed, e.g. Advice::willNeed starts reading
+       *        it ahead of use. Does nothing for variables that are not mapped.
+       * @param name The name of the variable.
+       * @param advice The advice.
+       */
+      void advise(std::string_view name, Advice advice) const
+      {
+        const auto& variable = findVariable("matlabw:mat:MappedFile:advise", name);
+
+        if (variable.isMapped())
+        {
+          adviseRange(variable.data, variable.bytes, advice);
+        }
+      }
+    private:
+      /**
+       * @brief Finds a variable.
+       * @param id The error identifier.
+       * @param name The name of the variable.
+       * @return The variable.
+       */
+      [[nodiscard]] MappedVariable& findVariable(const char* id, std::string_view name)
+      {
+        return const_cast<MappedVariable&>(std::as_const(*this).findVariable(id, name));
+      }
+
+      /**
+       * @brief Finds a variable.
+       * @param id The error identifier.
+       * @param name The name of the variable.
+       * @return The variable.
+       */
+      [[nodiscard]] const MappedVariable& findVariable(const char* id, std::string_view name) const
+      {
+        const auto it = mLookup.find(name);
+
+        if (it == mLookup.end())
+        {
+          throw mx::Exception{id, "variable does not exist"};
+        }
+
+        return mMapped[it->second];
+      }
+
+      /**
+       * @brief Maps the file and records the variables that can be mapped. Files that cannot be mapped are left to the
+       *        fallback path.
+       * @param filename The filename.
+       */
+      void map([[maybe_unused]] const char* filename)
+      {
+#     ifdef MATLABW_MAPPED_FILE_POSIX
+        static constexpr std::size_t   headerSize{128};
+        static constexpr std::uint16_t version5{0x0100};
+        static constexpr std::uint16_t nativeEndian{('M' << 8) | 'I'};
+
+        const int fd = ::open(filename, O_RDONLY);
+
+        if (fd < 0)
+        {
+          return;
+        }
+
+        struct stat st{};
+
+        if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) > headerSize)
+        {
+          void* base = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+          if (base != MAP_FAILED)
+          {
+            mBase = static_cast<const std::byte*>(base);
+            mSize = static_cast<std::size_t>(st.st_size);
+          }
+        }
+
+        ::close(fd);
+
+        if (mBase == nullptr)
+        {
+          return;
+        }
+
+        std::uint16_t version{};
+        std::uint16_t endian{};
+        std::memcpy(&version, mBase + 124, sizeof(version));
+        std::memcpy(&endian, mBase + 126, sizeof(endian));
+
+        // Level 5 files in the native byte order only, v7.3 files are HDF5 and have version 0x0200.
+        if (version != version5 || endian != nativeEndian)
+        {
+          return;
+        }
+
+        for (std::size_t offset{headerSize}; offset < mSize;)
+        {
+          const auto element = detail::readMiElement(mBase, offset, mSize);
+
+          if (!element)
+          {
+            break;
+          }
+
+          if (element->type == detail::MiType::matrix)
+          {
+            if (auto variable = detail::parseMiMatrix(mBase, *element))
+            {
+              mMapped.push_back(std::move(*variable));
+            }
+          }
+
+          offset = element->next;
+        }
+#     endif
+      }
+
+      /**
+       * @brief Advises the operating system how a range of the mapping is accessed.
+       * @param ptr The beginning of the range.
+       * @param bytes The size of the range in bytes.
+       * @param advice The advice.
+       */
+      static void adviseRange([[maybe_unused]] const std::byte* ptr,
+                              [[maybe_unused]] std::size_t      bytes,
+                              [[maybe_unused]] Advice           advice) noexcept
+      {
+#     ifdef MATLABW_MAPPED_FILE_POSIX
+        if (ptr == nullptr || bytes == 0)
+        {
+          return;
+        }
+
+        const auto pageSize = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+        const auto begin    = reinterpret_cast<std::uintptr_t>(ptr) & ~(pageSize - 1);
+        const auto end      = reinterpret_cast<std::uintptr_t>(ptr) + bytes;
+
+        int flag{};
+
+        switch (advice)
+        {
+        case Advice::sequential:
+          flag = MADV_SEQUENTIAL;
+          break;
+        case Advice::random:
+          flag = MADV_RANDOM;
+          break;
+        case Advice::willNeed:
+          flag = MADV_WILLNEED;
+          break;
+        default:
+          flag = MADV_NORMAL;
+          break;
+        }
+
+        // The advice is only a hint, failure is not an error.
+        static_cast<void>(madvise(reinterpret_cast<void*>(begin), end - begin, flag));
+#     endif
+      }
+
+      File                                              mFile;        ///< The file of the fallback path.
+      const std::byte*                                  mBase{};      ///< The beginning of the mapping.
+      std::size_t                                       mSize{};      ///< The size of the mapping in bytes.
+      std::vector<MappedVariable>                       mMapped{};    ///< The variables, mapped ones first.
+      std::unordered_map<std::string_view, std::size_t> mLookup{};    ///< Name to position in mMapped.
+  };
+} // namespace matlabw::mat
+
+#endif /* MATLABW_MAT_MAPPED_FILE_HPP */
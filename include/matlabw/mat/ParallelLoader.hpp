@@ -0,0 +1,285 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MAT_PARALLEL_LOADER_HPP
+#define MATLABW_MAT_PARALLEL_LOADER_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+
+#include <matlabw/mx/parallel/ThreadPool.hpp>
+
+#include "detail/arrayBytes.hpp"
+#include "mat.hpp"
+
+namespace matlabw::mat
+{
+  /// @brief Order in which the loader delivers the files.
+  enum class LoadOrder
+  {
+    input,      ///< Order of the input paths.
+    completion, ///< Order in which the files finish loading.
+  };
+
+  /// @brief Options of the parallel loader.
+  struct LoaderOptions
+  {
+    std::size_t threadCount{4};                     ///< Number of I/O threads.
+    std::size_t prefetchDepth{};                    ///< Files loading or loaded but not taken, 0 selects 2 per thread.
+    std::size_t memoryBudget{std::size_t{1} << 30}; ///< Bytes of loaded but not taken arrays before loading pauses.
+    LoadOrder   order{LoadOrder::input};            ///< Delivery order.
+  };
+
+  /// @brief File loaded by the parallel loader.
+  struct LoadResult
+  {
+    std::size_t           index{};     ///< Index of the file in the input paths.
+    std::string           path{};      ///< Path of the file.
+    std::vector<Variable> variables{}; ///< The variables, in the order of the requested names or of the file.
+    std::exception_ptr    error{};     ///< Error that occurred while loading the file, the variables are then empty.
+  };
+
+  /**
+   * @brief Loads many MAT files on a pool of I/O threads and delivers them one at a time. Loading is throttled by
+   *        back-pressure: no more than the prefetch depth files are loading or waiting to be taken, and no new file is
+   *        started while the waiting arrays exceed the memory budget. Errors are reported per file. Intended for
+   *        standalone programs linked against the MAT library, which may use distinct files on distinct threads; the
+   *        loader must not be used in MEX files, where the MATLAB API is restricted to the MATLAB thread.
+   */
+  class ParallelLoader
+  {
+    public:
+      /**
+       * @brief Constructor. Starts loading.
+       * @param paths The paths of the files.
+       * @param variableNames The variables to read from each file, all variables if empty.
+       * @param options The options.
+       */
+      explicit ParallelLoader(std::vector<std::string> paths,
+                              std::vector<std::string> variableNames = {},
+                              const LoaderOptions&     options       = {})
+      : mPaths{std::move(paths)},
+        mVariableNames{std::move(variableNames)},
+        mPrefetchDepth{(options.prefetchDepth > 0) ? options.prefetchDepth : 2 * std::max(options.threadCount,
+                                                                                          std::size_t{1})},
+        mMemoryBudget{options.memoryBudget},
+        mOrder{options.order},
+        mPool{mx::parallel::ThreadPoolOptions{std::max(options.threadCount, std::size_t{1})}}
+      {
+        for (std::size_t i{}; i < mPool.getThreadCount(); ++i)
+        {
+          mPool.post([this]{ run(); });
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      ParallelLoader(const ParallelLoader&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ParallelLoader(ParallelLoader&&) = delete;
+
+      /// @brief Destructor. Cancels loading and waits for the files being loaded.
+      ~ParallelLoader() noexcept
+      {
+        cancel();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ParallelLoader& operator=(const ParallelLoader&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ParallelLoader& operator=(ParallelLoader&&) = delete;
+
+      /**
+       * @brief Takes the next loaded file, waiting until it is available.
+       * @return The file or std::nullopt when all files were taken or loading was cancelled.
+       */
+      [[nodiscard]] std::optional<LoadResult> next()
+      {
+        std::unique_lock lock{mMutex};
+
+        mResultReady.wait(lock, [this]
+        {
+          return mCancelled || mTaken == mPaths.size() || (!mReady.empty() && mReady.begin()->first == mTaken);
+        });
+
+        if (mCancelled || mTaken == mPaths.size())
+        {
+          return std::nullopt;
+        }
+
+        auto node = mReady.extract(mReady.begin());
+
+        mBytesHeld -= node.mapped().bytes;
+        ++mTaken;
+
+        lock.unlock();
+        mWorkReady.notify_all();
+
+        return std::move(node.mapped().result);
+      }
+
+      /// @brief Cancels loading, files being loaded are finished and discarded.
+      void cancel() noexcept
+      {
+        {
+          std::lock_guard lock{mMutex};
+          mCancelled = true;
+        }
+
+        mWorkReady.notify_all();
+        mResultReady.notify_all();
+      }
+
+      /**
+       * @brief Gets the number of files.
+       * @return The number of files.
+       */
+      [[nodiscard]] std::size_t getFileCount() const noexcept
+      {
+        return mPaths.size();
+      }
+    private:
+      /// @brief Loaded file waiting to be taken.
+      struct Entry
+      {
+        LoadResult  result; ///< The file.
+        std::size_t bytes;  ///< Estimated memory held by the arrays.
+      };
+
+      /**
+       * @brief Checks if a new file may be started. The lock must be held.
+       * @return True if the prefetch depth and the memory budget allow it.
+       */
+      [[nodiscard]] bool canStart() const noexcept
+      {
+        const std::size_t pending = mLoading + mReady.size();
+
+        return pending < mPrefetchDepth && (mBytesHeld < mMemoryBudget || pending == 0);
+      }
+
+      /// @brief Worker loop, loads files until all are started or loading is cancelled.
+      void run()
+      {
+        for (;;)
+        {
+          std::size_t index{};
+
+          {
+            std::unique_lock lock{mMutex};
+
+            mWorkReady.wait(lock, [this]{ return mCancelled || mStarted == mPaths.size() || canStart(); });
+
+            if (mCancelled || mStarted == mPaths.size())
+            {
+              return;
+            }
+
+            index = mStarted++;
+            ++mLoading;
+          }
+
+          Entry entry{load(index), 0};
+
+          for (const Variable& variable : entry.result.variables)
+          {
+            entry.bytes += detail::getArrayBytes(variable.array.get());
+          }
+
+          {
+            std::lock_guard lock{mMutex};
+
+            --mLoading;
+            mBytesHeld += entry.bytes;
+
+            // the key is the position in the delivery order
+            mReady.emplace((mOrder == LoadOrder::input) ? index : mCompleted, std::move(entry));
+            ++mCompleted;
+          }
+
+          mResultReady.notify_all();
+        }
+      }
+
+      /**
+       * @brief Loads a file.
+       * @param index The index of the file.
+       * @return The file, or the error that occurred.
+       */
+      [[nodiscard]] LoadResult load(std::size_t index) const
+      {
+        LoadResult result{index, mPaths[index]};
+
+        try
+        {
+          File file{mPaths[index].c_str(), Mode::r};
+
+          if (mVariableNames.empty())
+          {
+            while (auto variable = file.getNextVariable())
+            {
+              result.variables.push_back(std::move(*variable));
+            }
+          }
+          else
+          {
+            result.variables.reserve(mVariableNames.size());
+
+            for (const std::string& name : mVariableNames)
+            {
+              result.variables.push_back(Variable{name, file.getVariable(name.c_str())});
+            }
+          }
+        }
+        catch (...)
+        {
+          result.variables.clear();
+          result.error = std::current_exception();
+        }
+
+        return result;
+      }
+
+      std::vector<std::string>      mPaths;          ///< Paths of the files.
+      std::vector<std::string>      mVariableNames;  ///< Variables to read, all if empty.
+      std::size_t                   mPrefetchDepth;  ///< Maximum number of loading and waiting files.
+      std::size_t                   mMemoryBudget;   ///< Bytes of waiting arrays before loading pauses.
+      LoadOrder                     mOrder;          ///< Delivery order.
+      std::mutex                    mMutex{};        ///< Protects the state below.
+      std::condition_variable       mWorkReady{};    ///< Signals that a file may be started.
+      std::condition_variable       mResultReady{};  ///< Signals that a file was loaded.
+      std::map<std::size_t, Entry>  mReady{};        ///< Loaded files by delivery position.
+      std::size_t                   mStarted{};      ///< Number of started files.
+      std::size_t                   mLoading{};      ///< Number of files being loaded.
+      std::size_t                   mCompleted{};    ///< Number of loaded files.
+      std::size_t                   mTaken{};        ///< Number of taken files.
+      std::size_t                   mBytesHeld{};    ///< Bytes of the waiting arrays.
+      bool                          mCancelled{};    ///< Whether loading was cancelled.
+      mx::parallel::ThreadPool      mPool;           ///< The I/O threads, last so that they are joined first.
+  };
+} // namespace matlabw::mat
+
+#endif /* MATLABW_MAT_PARALLEL_LOADER_HPP */
@@ -0,0 +1,756 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MAT_PARTIAL_READER_HPP
+#define MATLABW_MAT_PARTIAL_READER_HPP
+
+#ifdef MATLABW_ENABLE_HDF5
+# include <hdf5.h>
+#endif
+
+#include "mat.hpp"
+
+namespace matlabw::mat
+{
+  /// @brief Rectangular region of a variable, all vectors have one entry per dimension of the variable.
+  struct Hyperslab
+  {
+    std::vector<std::size_t> offset{}; ///< The first element along each dimension.
+    std::vector<std::size_t> count{};  ///< The number of elements along each dimension.
+    std::vector<std::size_t> stride{}; ///< The step between elements along each dimension, empty selects 1.
+
+    /**
+     * @brief Gets the number of elements of the region.
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t getSize() const noexcept
+    {
+      return std::accumulate(count.begin(), count.end(), std::size_t{1}, std::multiplies<>{});
+    }
+  };
+
+  /**
+   * @brief Chunk of a variable read by ChunkReader.
+   * @tparam T The element type.
+   */
+  template<typename T>
+  struct Chunk
+  {
+    Hyperslab    slab{}; ///< The region of the chunk.
+    std::span<T> data{}; ///< The elements in column-major order, valid until the next chunk is read.
+  };
+
+namespace detail
+{
+  /**
+   * @brief Checks a hyperslab against the dimensions of a variable.
+   * @param id The error identifier.
+   * @param dims The dimensions of the variable.
+   * @param slab The hyperslab.
+   */
+  inline void checkHyperslab(const char* id, mx::View<std::size_t> dims, const Hyperslab& slab)
+  {
+    if (slab.offset.size() != dims.size() || slab.count.size() != dims.size()
+        || (!slab.stride.empty() && slab.stride.size() != dims.size()))
+    {
+      throw mx::Exception{id, "hyperslab rank must match the variable rank"};
+    }
+
+    for (std::size_t i{}; i < dims.size(); ++i)
+    {
+      const std::size_t stride = (slab.stride.empty()) ? 1 : slab.stride[i];
+
+      if (stride == 0)
+      {
+        throw mx::Exception{id, "hyperslab stride must be positive"};
+      }
+
+      if (slab.count[i] != 0
+          && (slab.offset[i] >= dims[i] || (slab.count[i] - 1) > (dims[i] - 1 - slab.offset[i]) / stride))
+      {
+        throw mx::Exception{id, "hyperslab exceeds the variable dimensions"};
+      }
+    }
+  }
+
+  /**
+   * @brief Copies a hyperslab of a column-major array.
+   * @tparam T The element type.
+   * @param src The source data.
+   * @param dims The dimensions of the source.
+   * @param slab The hyperslab, already checked.
+   * @param dst The destination, holds slab.getSize() elements.
+   */
+  template<typename T>
+  void copyHyperslab(const T* src, mx::View<std::size_t> dims, const Hyperslab& slab, T* dst)
+  {
+    const std::size_t rank = dims.size();
+
+    if (slab.getSize() == 0)
+    {
+      return;
+    }
+
+    std::vector<std::size_t> srcStrides(rank);
+    std::vector<std::size_t> index(rank);
+
+    for (std::size_t i{}, step{1}; i < rank; step *= dims[i++])
+    {
+      srcStrides[i] = step * ((slab.stride.empty()) ? 1 : slab.stride[i]);
+    }
+
+    const std::size_t innerCount  = slab.count[0];
+    const std::size_t innerStride = srcStrides[0];
+
+    std::size_t base{};
+
+    for (std::size_t i{}, step{1}; i < rank; step *= dims[i++])
+    {
+      base += slab.offset[i] * step;
+    }
+
+    while (true)
+    {
+      for (std::size_t j{}; j < innerCount; ++j)
+      {
+        *dst++ = src[base + j * innerStride];
+      }
+
+      std::size_t d{1};
+
+      for (; d < rank; ++d)
+      {
+        base += srcStrides[d];
+
+        if (++index[d] < slab.count[d])
+        {
+          break;
+        }
+
+        base     -= srcStrides[d] * index[d];
+        index[d]  = 0;
+      }
+
+      if (d >= rank)
+      {
+        return;
+      }
+    }
+  }
+
+#ifdef MATLABW_ENABLE_HDF5
+  /// @brief Owner of an HDF5 identifier.
+  class Hdf5Id
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param id The identifier, negative values are invalid.
+       * @param close The function that closes the identifier.
+       */
+      Hdf5Id(hid_t id, herr_t (*close)(hid_t)) noexcept
+      : mId{id}, mClose{close}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      Hdf5Id(const Hdf5Id&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other identifier, left invalid.
+       */
+      Hdf5Id(Hdf5Id&& other) noexcept
+      : mId{std::exchange(other.mId, H5I_INVALID_HID)}, mClose{other.mClose}
+      {}
+
+      /// @brief Destructor.
+      ~Hdf5Id()
+      {
+        if (mId >= 0)
+        {
+          mClose(mId);
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Hdf5Id& operator=(const Hdf5Id&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      Hdf5Id& operator=(Hdf5Id&&) = delete;
+
+      /**
+       * @brief Checks if the identifier is valid.
+       * @return True if the identifier is valid, false otherwise.
+       */
+      [[nodiscard]] bool isValid() const noexcept
+      {
+        return mId >= 0;
+      }
+
+      /**
+       * @brief Gets the identifier.
+       * @return The identifier.
+       */
+      [[nodiscard]] hid_t get() const noexcept
+      {
+        return mId;
+      }
+    private:
+      hid_t  mId{H5I_INVALID_HID}; ///< The identifier.
+      herr_t (*mClose)(hid_t){};   ///< The function that closes the identifier.
+  };
+
+  /**
+   * @brief Gets the HDF5 memory type of a real element type.
+   * @tparam T The element type.
+   * @return The HDF5 type, owned by the library.
+   */
+  template<typename T>
+  [[nodiscard]] hid_t getHdf5NativeType()
+  {
+    if constexpr (std::is_same_v<T, double>)             return H5T_NATIVE_DOUBLE;
+    else if constexpr (std::is_same_v<T, float>)         return H5T_NATIVE_FLOAT;
+    else if constexpr (std::is_same_v<T, std::int8_t>)   return H5T_NATIVE_INT8;
+    else if constexpr (std::is_same_v<T, std::uint8_t>)  return H5T_NATIVE_UINT8;
+    else if constexpr (std::is_same_v<T, std::int16_t>)  return H5T_NATIVE_INT16;
+    else if constexpr (std::is_same_v<T, std::uint16_t>) return H5T_NATIVE_UINT16;
+    else if constexpr (std::is_same_v<T, std::int32_t>)  return H5T_NATIVE_INT32;
+    else if constexpr (std::is_same_v<T, std::uint32_t>) return H5T_NATIVE_UINT32;
+    else if constexpr (std::is_same_v<T, std::int64_t>)  return H5T_NATIVE_INT64;
+    else if constexpr (std::is_same_v<T, std::uint64_t>) return H5T_NATIVE_UINT64;
+    else if constexpr (std::is_same_v<T, bool>)          return H5T_NATIVE_UINT8;
+    else if constexpr (std::is_same_v<T, char16_t>)      return H5T_NATIVE_UINT16;
+    else static_assert(sizeof(T) == 0, "unsupported element type");
+  }
+
+  /**
+   * @brief Gets the HDF5 memory type of an element type, complex types are compounds of real and imag members as
+   *        written by MATLAB.
+   * @tparam T The element type.
+   * @return The HDF5 type.
+   */
+  template<typename T>
+  [[nodiscard]] Hdf5Id makeHdf5MemoryType()
+  {
+    if constexpr (mx::isComplexNumeric<T>)
+    {
+      using R = typename T::value_type;
+
+      Hdf5Id type{H5Tcreate(H5T_COMPOUND, sizeof(T)), H5Tclose};
+
+      if (!type.isValid() || H5Tinsert(type.get(), "real", 0, getHdf5NativeType<R>()) < 0
+          || H5Tinsert(type.get(), "imag", sizeof(R), getHdf5NativeType<R>()) < 0)
+      {
+        throw mx::Exception{"matlabw:mat:PartialReader:type", "failed to create complex type"};
+      }
+
+      return type;
+    }
+    else
+    {
+      return Hdf5Id{H5Tcopy(getHdf5NativeType<T>()), H5Tclose};
+    }
+  }
+
+  /**
+   * @brief Real type of an element type.
+   * @tparam T The element type.
+   */
+  template<typename T>
+  struct RealTypeOf
+  {
+    using type = T; ///< The real type.
+  };
+
+  /**
+   * @brief Real type of a complex element type.
+   * @tparam T The real type.
+   */
+  template<typename T>
+  struct RealTypeOf<std::complex<T>>
+  {
+    using type = T; ///< The real type.
+  };
+
+  /**
+   * @brief Gets the MATLAB class name of an element type, as stored in the MATLAB_class attribute.
+   * @tparam T The element type.
+   * @return The class name.
+   */
+  template<typename T>
+  [[nodiscard]] constexpr std::string_view getMatlabClassName()
+  {
+    using R = typename RealTypeOf<T>::type;
+
+    if constexpr (std::is_same_v<R, double>)             return "double";
+    else if constexpr (std::is_same_v<R, float>)         return "single";
+    else if constexpr (std::is_same_v<R, std::int8_t>)   return "int8";
+    else if constexpr (std::is_same_v<R, std::uint8_t>)  return "uint8";
+    else if constexpr (std::is_same_v<R, std::int16_t>)  return "int16";
+    else if constexpr (std::is_same_v<R, std::uint16_t>) return "uint16";
+    else if constexpr (std::is_same_v<R, std::int32_t>)  return "int32";
+    else if constexpr (std::is_same_v<R, std::uint32_t>) return "uint32";
+    else if constexpr (std::is_same_v<R, std::int64_t>)  return "int64";
+    else if constexpr (std::is_same_v<R, std::uint64_t>) return "uint64";
+    else if constexpr (std::is_same_v<R, bool>)          return "logical";
+    else if constexpr (std::is_same_v<R, char16_t>)      return "char";
+    else static_assert(sizeof(T) == 0, "unsupported element type");
+  }
+
+  /**
+   * @brief Reads the MATLAB_class attribute of a dataset.
+   * @param dataset The dataset.
+   * @return The class name, empty if the attribute is missing.
+   */
+  [[nodiscard]] inline std::string getMatlabClassAttribute(hid_t dataset)
+  {
+    if (H5Aexists(dataset, "MATLAB_class") <= 0)
+    {
+      return {};
+    }
+
+    Hdf5Id attr{H5Aopen(dataset, "MATLAB_class", H5P_DEFAULT), H5Aclose};
+    Hdf5Id type{(attr.isValid()) ? H5Aget_type(attr.get()) : H5I_INVALID_HID, H5Tclose};
+
+    if (!type.isValid())
+    {
+      return {};
+    }
+
+    std::string name(H5Tget_size(type.get()), '\0');
+
+    if (H5Aread(attr.get(), type.get(), name.data()) < 0)
+    {
+      return {};
+    }
+
+    name.resize(std::char_traits<char>::length(name.c_str()));
+
+    return name;
+  }
+#endif /* MATLABW_ENABLE_HDF5 */
+} // namespace detail
+
+  /**
+   * @brief Reader of regions of variables. When the library is configured with MATLABW_ENABLE_HDF5 and the file is
+   *        a v7.3 file, only the requested region is read from disk. Otherwise the MAT API offers no partial reads, so
+   *        the whole variable is loaded and the region is copied out of it.
+   */
+  class PartialReader
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param filename The filename.
+       */
+      explicit PartialReader(const char* filename)
+      {
+        static constexpr char id[]{"matlabw:mat:PartialReader:PartialReader"};
+
+        if (filename == nullptr)
+        {
+          throw mx::Exception{id, "invalid filename"};
+        }
+
+#     ifdef MATLABW_ENABLE_HDF5
+        if (H5Fis_hdf5(filename) > 0)
+        {
+          mHdf5File = H5Fopen(filename, H5F_ACC_RDONLY, H5P_DEFAULT);
+
+          if (mHdf5File < 0)
+          {
+            throw mx::Exception{id, "failed to open HDF5 file"};
+          }
+
+          return;
+        }
+#     endif
+
+        mFile.open(filename, Mode::r);
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      PartialReader(const PartialReader&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      PartialReader(PartialReader&&) = delete;
+
+      /// @brief Destructor.
+      ~PartialReader()
+      {
+#     ifdef MATLABW_ENABLE_HDF5
+        if (mHdf5File >= 0)
+        {
+          H5Fclose(mHdf5File);
+        }
+#     endif
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      PartialReader& operator=(const PartialReader&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      PartialReader& operator=(PartialReader&&) = delete;
+
+      /**
+       * @brief Checks if regions are read directly from disk without loading the whole variable.
+       * @return True if partial reads are native, false otherwise.
+       */
+      [[nodiscard]] bool isNative() const noexcept
+      {
+#     ifdef MATLABW_ENABLE_HDF5
+        return mHdf5File >= 0;
+#     else
+        return false;
+#     endif
+      }
+
+      /**
+       * @brief Gets the dimensions of a variable.
+       * @param name The name of the variable.
+       * @return The dimensions.
+       */
+      [[nodiscard]] std::vector<std::size_t> getDims(const char* name)
+      {
+        static constexpr char id[]{"matlabw:mat:PartialReader:getDims"};
+
+        if (name == nullptr)
+        {
+          throw mx::Exception{id, "invalid name"};
+        }
+
+#     ifdef MATLABW_ENABLE_HDF5
+        if (isNative())
+        {
+          auto dataset = openDataset(id, name);
+
+          return getDatasetDims(id, dataset.get());
+        }
+#     endif
+
+        if (name != mCachedName)
+        {
+          // Only the header is needed, do not replace a loaded variable by it.
+          auto info = mFile.getVariableInfo(name);
+
+          return std::vector<std::size_t>(info.getDims().begin(), info.getDims().end());
+        }
+
+        return std::vector<std::size_t>(mCached.getDims().begin(), mCached.getDims().end());
+      }
+
+      /**
+       * @brief Reads a region of a variable. The element type must match the class and complexity of the variable.
+       * @tparam T The element type.
+       * @param name The name of the variable.
+       * @param slab The region.
+       * @param out The output, holds slab.getSize() elements in column-major order of the region.
+       */
+      template<typename T>
+      void read(const char* name, const Hyperslab& slab, std::span<T> out)
+      {
+        static constexpr char id[]{"matlabw:mat:PartialReader:read"};
+
+        if (out.size() != slab.getSize())
+        {
+          throw mx::Exception{id, "output size must match the hyperslab size"};
+        }
+
+        if (name == nullptr)
+        {
+          throw mx::Exception{id, "invalid name"};
+        }
+
+#     ifdef MATLABW_ENABLE_HDF5
+        if (isNative())
+        {
+          readNative(id, name, slab, out.data());
+          return;
+        }
+#     endif
+
+        if (name != mCachedName)
+        {
+          mCached     = mFile.getVariable(name);
+          mCachedName = name;
+        }
+
+        const mx::TypedArrayCref<T> array{mx::ArrayCref{mCached}};
+
+        detail::checkHyperslab(id, array.getDims(), slab);
+        detail::copyHyperslab(array.getData(), array.getDims(), slab, out.data());
+      }
+
+      /**
+       * @brief Reads a region of a variable into a pre-allocated array.
+       * @tparam T The element type.
+       * @param name The name of the variable.
+       * @param slab The region.
+       * @param out The output array, its size must equal slab.getSize().
+       */
+      template<typename T>
+      void read(const char* name, const Hyperslab& slab, mx::TypedArrayRef<T> out)
+      {
+        read(name, slab, std::span<T>{out.getData(), out.getSize()});
+      }
+
+      /// @brief Releases the variable kept by the fallback path for repeated reads of the same variable.
+      void releaseCache()
+      {
+        mCached = mx::Array{};
+        mCachedName.clear();
+      }
+    private:
+#   ifdef MATLABW_ENABLE_HDF5
+      /**
+       * @brief Opens the dataset of a variable.
+       * @param id The error identifier.
+       * @param name The name of the variable.
+       * @return The dataset.
+       */
+      [[nodiscard]] detail::Hdf5Id openDataset(const char* id, const char* name) const
+      {
+        // Sparse, cell and struct variables are stored as groups and cannot be opened as datasets.
+        if (H5Lexists(mHdf5File, name, H5P_DEFAULT) <= 0)
+        {
+          throw mx::Exception{id, "variable does not exist"};
+        }
+
+        detail::Hdf5Id dataset{H5Dopen2(mHdf5File, name, H5P_DEFAULT), H5Dclose};
+
+        if (!dataset.isValid())
+        {
+          throw mx::Exception{id, "variable is not a dense numeric, logical or char array"};
+        }
+
+        return dataset;
+      }
+
+      /**
+       * @brief Gets the MATLAB dimensions of a dataset. HDF5 dimensions are row-major, so they are reversed.
+       * @param id The error identifier.
+       * @param dataset The dataset.
+       * @return The dimensions.
+       */
+      [[nodiscard]] static std::vector<std::size_t> getDatasetDims(const char* id, hid_t dataset)
+      {
+        detail::Hdf5Id space{H5Dget_space(dataset), H5Sclose};
+
+        const int rank = (space.isValid()) ? H5Sget_simple_extent_ndims(space.get()) : -1;
+
+        if (rank < 0)
+        {
+          throw mx::Exception{id, "failed to get variable dimensions"};
+        }
+
+        std::vector<hsize_t> h5Dims(static_cast<std::size_t>(rank));
+
+        H5Sget_simple_extent_dims(space.get(), h5Dims.data(), nullptr);
+
+        return std::vector<std::size_t>(h5Dims.rbegin(), h5Dims.rend());
+      }
+
+      /**
+       * @brief Reads a region of a dataset.
+       * @tparam T The element type.
+       * @param id The error identifier.
+       * @param name The name of the variable.
+       * @param slab The region.
+       * @param out The output.
+       */
+      template<typename T>
+      void readNative(const char* id, const char* name, const Hyperslab& slab, T* out) const
+      {
+        auto dataset = openDataset(id, name);
+
+        if (detail::getMatlabClassAttribute(dataset.get()) != detail::getMatlabClassName<T>())
+        {
+          throw mx::Exception{id, "element type must match the variable class"};
+        }
+
+        detail::Hdf5Id fileType{H5Dget_type(dataset.get()), H5Tclose};
+
+        if ((H5Tget_class(fileType.get()) == H5T_COMPOUND) != mx::isComplexNumeric<T>)
+        {
+          throw mx::Exception{id, "element type must match the variable complexity"};
+        }
+
+        const auto dims = getDatasetDims(id, dataset.get());
+
+        detail::checkHyperslab(id, dims, slab);
+
+        if (slab.getSize() == 0)
+        {
+          return;
+        }
+
+        const std::size_t rank = dims.size();
+
+        std::vector<hsize_t> start(rank);
+        std::vector<hsize_t> count(rank);
+        std::vector<hsize_t> stride(rank);
+
+        for (std::size_t i{}; i < rank; ++i)
+        {
+          start[rank - 1 - i]  = slab.offset[i];
+          count[rank - 1 - i]  = slab.count[i];
+          stride[rank - 1 - i] = (slab.stride.empty()) ? 1 : slab.stride[i];
+        }
+
+        detail::Hdf5Id fileSpace{H5Dget_space(dataset.get()), H5Sclose};
+
+        if (H5Sselect_hyperslab(fileSpace.get(), H5S_SELECT_SET, start.data(), stride.data(), count.data(), nullptr)
+            < 0)
+        {
+          throw mx::Exception{id, "failed to select hyperslab"};
+        }
+
+        const hsize_t  size = slab.getSize();
+        detail::Hdf5Id memSpace{H5Screate_simple(1, &size, nullptr), H5Sclose};
+        auto           memType = detail::makeHdf5MemoryType<T>();
+
+        if (H5Dread(dataset.get(), memType.get(), memSpace.get(), fileSpace.get(), H5P_DEFAULT, out) < 0)
+        {
+          throw mx::Exception{id, "failed to read hyperslab"};
+        }
+      }
+
+      hid_t       mHdf5File{H5I_INVALID_HID}; ///< The HDF5 file of a v7.3 file.
+#   endif
+      File        mFile{};                    ///< The file of the fallback path.
+      mx::Array   mCached{};                  ///< The last variable loaded by the fallback path.
+      std::string mCachedName{};              ///< The name of the cached variable.
+  };
+
+  /**
+   * @brief Streams a variable through a fixed-size buffer. The variable is split into the largest regions that fit
+   *        the buffer: full leading dimensions and a block of the next dimension.
+   * @tparam T The element type.
+   */
+  template<typename T>
+  class ChunkReader
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param reader The reader, must outlive the chunk reader.
+       * @param name The name of the variable.
+       * @param maxElements The size of the buffer in elements.
+       */
+      ChunkReader(PartialReader& reader, std::string name, std::size_t maxElements)
+      : mReader{&reader}, mName{std::move(name)}, mBuffer{std::make_unique<T[]>(maxElements)}
+      {
+        static constexpr char id[]{"matlabw:mat:ChunkReader:ChunkReader"};
+
+        if (maxElements == 0)
+        {
+          throw mx::Exception{id, "buffer size must be positive"};
+        }
+
+        mDims = mReader->getDims(mName.c_str());
+
+        const std::size_t rank = mDims.size();
+
+        mSlab.offset.assign(rank, 0);
+        mSlab.count.assign(rank, 1);
+
+        // Split dimension: the leading dimensions before it are read whole.
+        std::size_t inner{1};
+
+        for (; mSplit < rank && inner * mDims[mSplit] <= maxElements; ++mSplit)
+        {
+          mSlab.count[mSplit]  = mDims[mSplit];
+          inner               *= mDims[mSplit];
+        }
+
+        if (mSplit < rank)
+        {
+          mBlock              = std::min(mDims[mSplit], maxElements / inner);
+          mSlab.count[mSplit] = mBlock;
+        }
+
+        mDone = std::find(mDims.begin(), mDims.end(), std::size_t{}) != mDims.end();
+      }
+
+      /**
+       * @brief Reads the next chunk.
+       * @return The chunk, or std::nullopt after the last chunk.
+       */
+      [[nodiscard]] std::optional<Chunk<T>> next()
+      {
+        if (mDone)
+        {
+          return std::nullopt;
+        }
+
+        const std::size_t rank = mDims.size();
+
+        if (mSplit < rank)
+        {
+          mSlab.count[mSplit] = std::min(mBlock, mDims[mSplit] - mSlab.offset[mSplit]);
+        }
+
+        const std::span<T> data{mBuffer.get(), mSlab.getSize()};
+
+        mReader->read(mName.c_str(), mSlab, data);
+
+        Chunk<T> chunk{mSlab, data};
+
+        advance();
+
+        return chunk;
+      }
+    private:
+      /// @brief Moves the region to the next chunk.
+      void advance()
+      {
+        const std::size_t rank = mDims.size();
+
+        for (std::size_t d{mSplit}; d < rank; ++d)
+        {
+          const std::size_t step = (d == mSplit) ? mBlock : 1;
+
+          if ((mSlab.offset[d] += step) < mDims[d])
+          {
+            return;
+          }
+
+          mSlab.offset[d] = 0;
+        }
+
+        mDone = true;
+      }
+
+      PartialReader*           mReader{};  ///< The reader.
+      std::string              mName{};    ///< The name of the variable.
+      std::unique_ptr<T[]>     mBuffer{};  ///< The buffer.
+      std::vector<std::size_t> mDims{};    ///< The dimensions of the variable.
+      Hyperslab                mSlab{};    ///< The region of the next chunk.
+      std::size_t              mSplit{};   ///< The first dimension that is not read whole.
+      std::size_t              mBlock{};   ///< The block size along the split dimension.
+      bool                     mDone{};    ///< Were all chunks read?
+  };
+} // namespace matlabw::mat
+
+#endif /* MATLABW_MAT_PARTIAL_READER_HPP */
@@ -0,0 +1,85 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MAT_DETAIL_ARRAY_BYTES_HPP
+#define MATLABW_MAT_DETAIL_ARRAY_BYTES_HPP
+
+#include <matlabw/mx/mx.hpp>
+
+namespace matlabw::mat::detail
+{
+  /**
+   * @brief Estimates the memory held by an array, including the contents of cells and struct fields.
+   * @param array The array.
+   * @return The number of bytes.
+   */
+  [[nodiscard]] inline std::size_t getArrayBytes(const mxArray* array) noexcept
+  {
+    if (array == nullptr)
+    {
+      return 0;
+    }
+
+    const std::size_t size = mxGetNumberOfElements(array);
+
+    if (mxIsCell(array))
+    {
+      std::size_t bytes{size * sizeof(mxArray*)};
+
+      for (std::size_t i{}; i < size; ++i)
+      {
+        bytes += getArrayBytes(mxGetCell(array, i));
+      }
+
+      return bytes;
+    }
+
+    if (mxIsStruct(array))
+    {
+      const int   fieldCount = mxGetNumberOfFields(array);
+      std::size_t bytes{size * static_cast<std::size_t>(fieldCount) * sizeof(mxArray*)};
+
+      for (std::size_t i{}; i < size; ++i)
+      {
+        for (int k{}; k < fieldCount; ++k)
+        {
+          bytes += getArrayBytes(mxGetFieldByNumber(array, i, k));
+        }
+      }
+
+      return bytes;
+    }
+
+    if (mxIsSparse(array))
+    {
+      const std::size_t nzmax = mxGetNzmax(array);
+
+      return nzmax * (mxGetElementSize(array) + sizeof(mwIndex)) + (mxGetN(array) + 1) * sizeof(mwIndex);
+    }
+
+    return size * mxGetElementSize(array);
+  }
+} // namespace matlabw::mat::detail
+
+#endif /* MATLABW_MAT_DETAIL_ARRAY_BYTES_HPP */
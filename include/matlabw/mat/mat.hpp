@@ -27,7 +27,13 @@
 
 #include <mat.h>
 
+#include <exception>
+#include <unordered_map>
+
 #include <matlabw/mx/mx.hpp>
+#include <matlabw/mx/algorithm/convert.hpp>
+
+#include "detail/arrayBytes.hpp"
 
 namespace matlabw::mat
 {
@@ -45,6 +51,73 @@ namespace matlabw::mat
     w7_3, ///< Write only. Deletes existing contents. Uses HDF5 format for large data.
   };
 
+  /// @brief File format version for writing.
+  enum class Format
+  {
+    automatic, ///< Selected from the compression choice and the size of the variables, see getWriteMode().
+    v4,        ///< MATLAB 4 format.
+    v6,        ///< Uncompressed, fastest to write. Variables must be smaller than 2 GB.
+    v7,        ///< Compressed. Variables must be smaller than 2 GB.
+    v7_3,      ///< HDF5 based, required for variables of 2 GB or more.
+  };
+
+  /// @brief Options for writing a file.
+  struct WriteOptions
+  {
+    Format format{Format::automatic}; ///< The format.
+    bool   compress{true};            ///< Used with Format::automatic, compression selects v7 instead of v6.
+  };
+
+  /// @brief Size of the largest variable that v6 and v7 formats can hold.
+  inline constexpr std::size_t maxV7VariableBytes{(std::size_t{1} << 31) - 1};
+
+  /**
+   * @brief Gets the mode that writes a file with the options. The MAT API compresses whole files, so the compression
+   *        choice applies to all variables of a file.
+   * @param options The options.
+   * @param largestVariableBytes The size of the largest variable to be written, Format::automatic selects v7.3 when
+   *                             it does not fit v6 or v7.
+   * @return The mode.
+   */
+  [[nodiscard]] constexpr Mode getWriteMode(const WriteOptions& options, std::size_t largestVariableBytes = 0)
+  {
+    switch (options.format)
+    {
+    case Format::v4:
+      return Mode::w4;
+    case Format::v6:
+      return Mode::w6;
+    case Format::v7:
+      return Mode::w7;
+    case Format::v7_3:
+      return Mode::w7_3;
+    default:
+      if (largestVariableBytes > maxV7VariableBytes)
+      {
+        return Mode::w7_3;
+      }
+
+      return (options.compress) ? Mode::w7 : Mode::w6;
+    }
+  }
+
+  /// @brief Variable read from a file.
+  struct Variable
+  {
+    std::string name;  ///< The name of the variable.
+    mx::Array   array; ///< The array, or only its header when read as variable info.
+  };
+
+  /// @brief Result of reading one of several variables.
+  struct VariableResult
+  {
+    std::string        name{};  ///< The name of the variable.
+    mx::Array          array{}; ///< The array, invalid if an error occurred.
+    std::exception_ptr error{}; ///< The error that occurred, null on success.
+  };
+
+  class VariableRange;
+
   /// @brief File class. Wraps MATFile.
   class File
   {
@@ -72,11 +145,26 @@ namespace matlabw::mat
         open(filename, mode);
       }
 
+      /**
+       * @brief Constructor, opens a file for writing.
+       * @param filename The filename.
+       * @param options The write options, Format::automatic assumes variables smaller than 2 GB.
+       */
+      File(const char* filename, const WriteOptions& options)
+      {
+        open(filename, options);
+      }
+
       /// @brief Copy constructor is deleted.
       File(const File&) = delete;
 
-      /// @brief Move constructor.
-      File(File&&) = default;
+      /**
+       * @brief Move constructor.
+       * @param other The other file, left closed.
+       */
+      File(File&& other) noexcept
+      : mFile{std::exchange(other.mFile, nullptr)}
+      {}
 
       /// @brief Destructor.
       ~File()
@@ -87,8 +175,21 @@ namespace matlabw::mat
       /// @brief Copy assignment operator is deleted.
       File& operator=(const File&) = delete;
 
-      /// @brief Move assignment operator.
-      File& operator=(File&&) = default;
+      /**
+       * @brief Move assignment operator. Closes the file before taking over the other one.
+       * @param other The other file, left closed.
+       * @return Reference to this file.
+       */
+      File& operator=(File&& other)
+      {
+        if (this != &other)
+        {
+          close();
+          mFile = std::exchange(other.mFile, nullptr);
+        }
+
+        return *this;
+      }
 
       /**
        * @brief Open a file.
@@ -149,6 +250,16 @@ namespace matlabw::mat
         open(filename.data(), mode);
       }
 
+      /**
+       * @brief Open a file for writing.
+       * @param filename The filename.
+       * @param options The write options, Format::automatic assumes variables smaller than 2 GB.
+       */
+      void open(const char* filename, const WriteOptions& options)
+      {
+        open(filename, getWriteMode(options));
+      }
+
       /**
        * @brief Check if the file is open.
        * @return True if the file is open, false otherwise.
@@ -177,7 +288,7 @@ namespace matlabw::mat
       {
         static constexpr char id[]{"matlabw:mat:File:getFilePointer"};
 
-        if (isOpen())
+        if (!isOpen())
         {
           throw mx::Exception{id, "file is not open"};
         }
@@ -200,6 +311,7 @@ namespace matlabw::mat
       void putVariable(const char* name, mx::ArrayCref array)
       {
         static constexpr char id[]{"matlabw:mat:File:putVariable"};
+        mx::ProfileZone       zone{id, "mat"};
 
         if (!isOpen())
         {
@@ -232,6 +344,7 @@ namespace matlabw::mat
       void putVariableAsGlobal(const char* name, mx::ArrayCref array)
       {
         static constexpr char id[]{"matlabw:mat:File:putVariableAsGlobal"};
+        mx::ProfileZone       zone{id, "mat"};
 
         if (!isOpen())
         {
@@ -264,6 +377,7 @@ namespace matlabw::mat
       [[nodiscard]] mx::Array getVariable(const char* name) const
       {
         static constexpr char id[]{"matlabw:mat:File:getVariable"};
+        mx::ProfileZone       zone{id, "mat"};
 
         if (!isOpen())
         {
@@ -295,55 +409,146 @@ namespace matlabw::mat
         return getVariable(name.data());
       }
 
-      // /**
-      //  * @brief Get the next variable in the file.
-      //  * @return The array and the name of the variable.
-      //  */
-      // [[nodiscard]] std::tuple<mx::Array, const char*> getNextVariable() const
-      // {
-      //   static constexpr char id[]{"matlabw:mat:File:getNextVariable"};
+      /**
+       * @brief Reads several variables with one check of the file and one directory read. The variables are read in
+       *        the order they are stored in the file and errors are reported per variable.
+       * @param names The names of the variables.
+       * @return The results in the order of the names.
+       */
+      [[nodiscard]] std::vector<VariableResult> getVariables(mx::View<const char*> names) const
+      {
+        static constexpr char id[]{"matlabw:mat:File:getVariables"};
+        mx::ProfileZone       zone{id, "mat"};
+
+        if (!isOpen())
+        {
+          throw mx::Exception{id, "file is not open"};
+        }
+
+        auto [dir, dirSize] = getVariableNames();
+
+        std::unordered_map<std::string_view, std::size_t> positions{};
+        positions.reserve(dirSize);
+
+        for (std::size_t i{}; i < dirSize; ++i)
+        {
+          positions.emplace(dir[i], i);
+        }
+
+        std::vector<VariableResult> results(names.size());
+        std::vector<std::size_t>    order{};
+        std::vector<std::size_t>    filePositions(names.size());
 
-      //   if (!isOpen())
-      //   {
-      //     throw mx::Exception{id, "file is not open"};
-      //   }
+        for (std::size_t i{}; i < names.size(); ++i)
+        {
+          if (names[i] == nullptr)
+          {
+            results[i].error = std::make_exception_ptr(mx::Exception{id, "invalid name"});
+            continue;
+          }
 
-      //   std::tuple<mx::Array, const char*> result{};
+          results[i].name = names[i];
 
-      //   std::get<0>(result) = mx::Array{matGetNextVariable(const_cast<MATFile*>(mFile), &std::get<1>(result))};
+          if (auto it = positions.find(names[i]); it != positions.end())
+          {
+            filePositions[i] = it->second;
+            order.push_back(i);
+          }
+          else
+          {
+            results[i].error = std::make_exception_ptr(mx::Exception{id, "variable '" + results[i].name
+                                                                         + "' does not exist"});
+          }
+        }
 
-      //   if (!std::get<0>(result).isValid())
-      //   {
-      //     throw mx::Exception{id, "failed to get next variable"};
-      //   }
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+        {
+          return filePositions[a] < filePositions[b];
+        });
 
-      //   return result;
-      // }
+        for (const std::size_t i : order)
+        {
+          results[i].array = mx::Array{matGetVariable(const_cast<MATFile*>(mFile), names[i])};
 
-      // /**
-      //  * @brief Gets the next variable info in the file.
-      //  * @return The array and the name of the variable.
-      //  */
-      // [[nodiscard]] std::tuple<mx::Array, const char*> getNextVariableInfo() const
-      // {
-      //   static constexpr char id[]{"matlabw:mat:File:getNextVariableInfo"};
+          if (!results[i].array.isValid())
+          {
+            results[i].error = std::make_exception_ptr(mx::Exception{id, "failed to get variable '" + results[i].name
+                                                                         + "'"});
+          }
+        }
 
-      //   if (!isOpen())
-      //   {
-      //     throw mx::Exception{id, "file is not open"};
-      //   }
+        return results;
+      }
 
-      //   std::tuple<mx::Array, const char*> result{};
+      /**
+       * @brief Writes several variables with one check of the file, in the given order. Errors are reported per
+       *        variable, a failed variable does not stop the others.
+       * @param variables The names and arrays of the variables.
+       * @return The errors in the order of the variables, null for the variables written successfully.
+       */
+      std::vector<std::exception_ptr> putVariables(mx::View<std::pair<const char*, mx::ArrayCref>> variables)
+      {
+        static constexpr char id[]{"matlabw:mat:File:putVariables"};
+        mx::ProfileZone       zone{id, "mat"};
+
+        if (!isOpen())
+        {
+          throw mx::Exception{id, "file is not open"};
+        }
 
-      //   std::get<0>(result) = mx::Array{matGetNextVariableInfo(const_cast<MATFile*>(mFile), &std::get<1>(result))};
+        std::vector<std::exception_ptr> errors(variables.size());
 
-      //   if (!std::get<0>(result).isValid())
-      //   {
-      //     throw mx::Exception{id, "failed to get next variable info"};
-      //   }
+        for (std::size_t i{}; i < variables.size(); ++i)
+        {
+          try
+          {
+            if (variables[i].first == nullptr)
+            {
+              throw mx::Exception{id, "invalid name"};
+            }
 
-      //   return result;
-      // }
+            checkError(matPutVariable(mFile, variables[i].first, variables[i].second.get()), id);
+          }
+          catch (...)
+          {
+            errors[i] = std::current_exception();
+          }
+        }
+
+        return errors;
+      }
+
+      /**
+       * @brief Reads the next variable of the file, the file is read sequentially without seeking. After opening the
+       *        file, the first call reads the first variable.
+       * @return The variable or std::nullopt at the end of the file.
+       */
+      [[nodiscard]] std::optional<Variable> getNextVariable()
+      {
+        return readNext(matGetNextVariable, "matlabw:mat:File:getNextVariable");
+      }
+
+      /**
+       * @brief Reads the header of the next variable of the file, see getNextVariable(). The array has the class and
+       *        dimensions of the variable but no data.
+       * @return The variable info or std::nullopt at the end of the file.
+       */
+      [[nodiscard]] std::optional<Variable> getNextVariableInfo()
+      {
+        return readNext(matGetNextVariableInfo, "matlabw:mat:File:getNextVariableInfo");
+      }
+
+      /**
+       * @brief Gets a single-pass range over the remaining variables of the file, see getNextVariable().
+       * @return The range.
+       */
+      [[nodiscard]] VariableRange variables();
+
+      /**
+       * @brief Gets a single-pass range over the headers of the remaining variables, see getNextVariableInfo().
+       * @return The range.
+       */
+      [[nodiscard]] VariableRange variableInfos();
 
       /**
        * @brief Gets the variable info in the file.
@@ -353,6 +558,7 @@ namespace matlabw::mat
       [[nodiscard]] mx::Array getVariableInfo(const char* name) const
       {
         static constexpr char id[]{"matlabw:mat:File:getVariableInfo"};
+        mx::ProfileZone       zone{id, "mat"};
 
         if (!isOpen())
         {
@@ -384,6 +590,74 @@ namespace matlabw::mat
         return getVariableInfo(name.data());
       }
 
+      /**
+       * @brief Reads a numeric, logical or char variable into caller-provided memory, converting the class on the fly
+       *        with MATLAB cast semantics. The class and size are validated from the variable info before the data are
+       *        read, the MAT API then loads the variable once and it is converted straight into the output.
+       * @tparam T Element type
+       * @param name The name of the variable.
+       * @param out The output, must have as many elements as the variable.
+       * @param dims The expected dimensions, not checked if empty.
+       */
+      template<typename T>
+      void readInto(const char* name, std::span<T> out, mx::View<std::size_t> dims = {}) const
+      {
+        static constexpr char id[]{"matlabw:mat:File:readInto"};
+        mx::ProfileZone       zone{id, "mat"};
+
+        checkReadable(id, getVariableInfo(name), out.size(), dims, mx::isComplexNumeric<T>);
+
+        mx::algorithm::convertInto(out, getVariable(name));
+      }
+
+      /**
+       * @brief Reads a numeric, logical or char variable into caller-provided memory, see readInto().
+       * @tparam T Element type
+       * @param name The name of the variable. Must be null-terminated.
+       * @param out The output, must have as many elements as the variable.
+       * @param dims The expected dimensions, not checked if empty.
+       */
+      template<typename T>
+      void readInto(std::string_view name, std::span<T> out, mx::View<std::size_t> dims = {}) const
+      {
+        readInto(name.data(), out, dims);
+      }
+
+      /**
+       * @brief Reads a numeric, logical or char variable as a vector of the element type, see readInto().
+       * @tparam T Element type
+       * @param name The name of the variable.
+       * @return The elements in column-major order.
+       */
+      template<typename T>
+      [[nodiscard]] std::vector<T> readAs(const char* name) const
+      {
+        static constexpr char id[]{"matlabw:mat:File:readAs"};
+        mx::ProfileZone       zone{id, "mat"};
+
+        const mx::Array info = getVariableInfo(name);
+
+        checkReadable(id, info, info.getSize(), {}, mx::isComplexNumeric<T>);
+
+        std::vector<T> out(info.getSize());
+
+        mx::algorithm::convertInto(std::span<T>{out}, getVariable(name));
+
+        return out;
+      }
+
+      /**
+       * @brief Reads a numeric, logical or char variable as a vector of the element type, see readInto().
+       * @tparam T Element type
+       * @param name The name of the variable. Must be null-terminated.
+       * @return The elements in column-major order.
+       */
+      template<typename T>
+      [[nodiscard]] std::vector<T> readAs(std::string_view name) const
+      {
+        return readAs<T>(name.data());
+      }
+
       /**
        * @brief Removes a variable from the file.
        * @param name The name of the variable.
@@ -391,6 +665,7 @@ namespace matlabw::mat
       void removeVariable(const char* name)
       {
         static constexpr char id[]{"matlabw:mat:File:removeVariable"};
+        mx::ProfileZone       zone{id, "mat"};
 
         if (!isOpen())
         {
@@ -436,7 +711,8 @@ namespace matlabw::mat
           throw mx::Exception{id, "failed to get directory"};
         }
 
-        return {std::unique_ptr<const char*[], mx::Deleter>{names}, static_cast<std::size_t>(num)};
+        return {std::unique_ptr<const char*[], mx::Deleter>{const_cast<const char**>(names)},
+                static_cast<std::size_t>(num)};
       }
 
       /**
@@ -457,6 +733,70 @@ namespace matlabw::mat
         return mFile;
       }
     private:
+      /**
+       * @brief Reads the next variable or variable info.
+       * @param read The MAT function.
+       * @param id The message identifier.
+       * @return The variable or std::nullopt at the end of the file.
+       */
+      std::optional<Variable> readNext(mxArray* (*read)(MATFile*, const char**), const char* id)
+      {
+        mx::ProfileZone zone{id, "mat"};
+
+        if (!isOpen())
+        {
+          throw mx::Exception{id, "file is not open"};
+        }
+
+        const char* name{};
+
+        mx::Array array{read(mFile, &name)};
+
+        if (!array.isValid())
+        {
+          return std::nullopt;
+        }
+
+        return Variable{std::string{(name != nullptr) ? name : ""}, std::move(array)};
+      }
+
+      /**
+       * @brief Checks that a variable can be read into a typed output.
+       * @param id The message identifier.
+       * @param info The variable info.
+       * @param size The number of elements of the output.
+       * @param dims The expected dimensions, not checked if empty.
+       * @param complex Whether the output is complex.
+       */
+      static void checkReadable(const char*           id,
+                                const mx::Array&      info,
+                                std::size_t           size,
+                                mx::View<std::size_t> dims,
+                                bool                  complex)
+      {
+        if (!(info.isNumeric() || info.isLogical() || info.isChar()) || info.isSparse())
+        {
+          throw mx::Exception{id, "variable must be a dense numeric, logical or char array"};
+        }
+
+        if (info.isComplex() && !complex)
+        {
+          throw mx::Exception{id, "complex variable requires a complex element type"};
+        }
+
+        const mx::View<std::size_t> infoDims = info.getDims();
+
+        if (!dims.empty() && !std::equal(dims.begin(), dims.end(), infoDims.begin(), infoDims.end()))
+        {
+          throw mx::Exception{id, "variable dimensions do not match"};
+        }
+
+        if (info.getSize() != size)
+        {
+          throw mx::Exception{id, "output size does not match the number of elements of the variable"};
+        }
+      }
+
       /**
        * @brief Check the error.
        * @param err The error.
@@ -552,6 +892,145 @@ namespace matlabw::mat
 
       MATFile* mFile{};
   };
+
+  /// @brief Single-pass, move-only input iterator over the variables of a file, reads one variable per increment.
+  class VariableIterator
+  {
+    public:
+      using iterator_concept = std::input_iterator_tag; ///< Iterator concept
+      using value_type       = Variable;                ///< Value type
+      using difference_type  = std::ptrdiff_t;          ///< Difference type
+
+      /**
+       * @brief Constructor. Reads the first variable.
+       * @param file The file.
+       * @param info Whether only the variable headers are read.
+       */
+      VariableIterator(File& file, bool info)
+      : mFile{&file}, mInfo{info}
+      {
+        ++*this;
+      }
+
+      /**
+       * @brief Gets the current variable.
+       * @return The variable.
+       */
+      [[nodiscard]] Variable& operator*() const
+      {
+        return *mCurrent;
+      }
+
+      /**
+       * @brief Gets the current variable.
+       * @return Pointer to the variable.
+       */
+      [[nodiscard]] Variable* operator->() const
+      {
+        return &*mCurrent;
+      }
+
+      /// @brief Reads the next variable.
+      VariableIterator& operator++()
+      {
+        // release the previous array before the next one is read
+        mCurrent.reset();
+        mCurrent = (mInfo) ? mFile->getNextVariableInfo() : mFile->getNextVariable();
+        return *this;
+      }
+
+      /// @brief Reads the next variable.
+      void operator++(int)
+      {
+        ++*this;
+      }
+
+      /// @brief Checks for the end of the file.
+      [[nodiscard]] friend bool operator==(const VariableIterator& it, std::default_sentinel_t) noexcept
+      {
+        return !it.mCurrent.has_value();
+      }
+    private:
+      File*                           mFile;      ///< The file.
+      bool                            mInfo;      ///< Read headers only.
+      mutable std::optional<Variable> mCurrent{}; ///< Current variable, empty at the end of the file.
+  };
+
+  /// @brief Single-pass range over the variables of a file.
+  class VariableRange
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param file The file.
+       * @param info Whether only the variable headers are read.
+       */
+      VariableRange(File& file, bool info) noexcept
+      : mFile{&file}, mInfo{info}
+      {}
+
+      /**
+       * @brief Gets the iterator to the next variable of the file.
+       * @return The iterator.
+       */
+      [[nodiscard]] VariableIterator begin() const
+      {
+        return VariableIterator{*mFile, mInfo};
+      }
+
+      /**
+       * @brief Gets the end sentinel.
+       * @return The sentinel.
+       */
+      [[nodiscard]] std::default_sentinel_t end() const noexcept
+      {
+        return std::default_sentinel;
+      }
+    private:
+      File* mFile; ///< The file.
+      bool  mInfo; ///< Read headers only.
+  };
+
+  inline VariableRange File::variables()
+  {
+    return VariableRange{*this, false};
+  }
+
+  inline VariableRange File::variableInfos()
+  {
+    return VariableRange{*this, true};
+  }
+
+  /**
+   * @brief Writes variables to a new file. With Format::automatic the format is selected from the largest variable,
+   *        so files with variables of 2 GB or more are written as v7.3.
+   * @param filename The filename.
+   * @param variables The names and arrays of the variables.
+   * @param options The write options.
+   */
+  inline void save(const char* filename,
+                   mx::View<std::pair<const char*, mx::ArrayCref>> variables,
+                   const WriteOptions& options = {})
+  {
+    std::size_t largestBytes{};
+
+    if (options.format == Format::automatic)
+    {
+      for (const auto& [name, array] : variables)
+      {
+        largestBytes = std::max(largestBytes, detail::getArrayBytes(array.get()));
+      }
+    }
+
+    File file{filename, getWriteMode(options, largestBytes)};
+
+    for (const auto& [name, array] : variables)
+    {
+      file.putVariable(name, array);
+    }
+
+    file.close();
+  }
 } // namespace matlabw::mat
 
 #endif /* MATLABW_MAT_MAT_HPP */
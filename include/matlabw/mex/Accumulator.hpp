@@ -0,0 +1,574 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_ACCUMULATOR_HPP
+#define MATLABW_MEX_ACCUMULATOR_HPP
+
+#include "detail/include.hpp"
+
+#include <cmath>
+
+#include <matlabw/mat/AsyncWriter.hpp>
+#include <matlabw/mat/mat.hpp>
+#include <matlabw/mx/algorithm/detail/parallel.hpp>
+#include <matlabw/mx/algorithm/histogram.hpp>
+#include <matlabw/mx/parallel/parallelFor.hpp>
+
+#include "State.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Options of an accumulator.
+  struct AccumulatorOptions
+  {
+    bool        keepHistory{}; ///< Whether to keep the appended rows resident.
+    std::size_t binCount{};    ///< Number of histogram bins, 0 disables the histogram.
+    double      binLower{};    ///< Lower edge of the first bin.
+    double      binUpper{1.0}; ///< Upper edge of the last bin, which includes it.
+  };
+
+  /**
+   * @brief Running per-column aggregates of a stream of row chunks, so that a MEX function called with every new chunk
+   *        does O(chunk) work instead of recomputing over the whole history. Each chunk is a real numeric k x n matrix
+   *        of k observations of n variables, n is fixed by the first chunk. Kept across calls by a mex::State, e.g.
+   *
+   *          auto& acc = mex::getAccumulator(mex::AccumulatorOptions{.binCount = 64});
+   *          acc.append(rhs[0]);
+   *          lhs[0] = acc.getMean();
+   *
+   *        Sums and means propagate NaN like sum and mean, minima and maxima omit NaN like min and max, the histogram
+   *        counts like histcounts and ignores NaN and values outside of its edges. The state can be saved to and
+   *        restored from a struct, so that a computation can resume from a MAT-file checkpoint.
+   */
+  class Accumulator
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param options The options.
+       */
+      explicit Accumulator(const AccumulatorOptions& options = {})
+      : mOptions{options}
+      {
+        if (options.binCount > 0 && !(options.binLower < options.binUpper))
+        {
+          throw mx::Exception{"matlabw:mex:Accumulator", "lower bin edge must be less than the upper one"};
+        }
+      }
+
+      /**
+       * @brief Appends a chunk of observations and updates the aggregates. Wide chunks are processed in parallel
+       *        column by column.
+       * @param chunk The chunk, a real numeric k x n matrix.
+       */
+      void append(mx::ArrayCref chunk)
+      {
+        static constexpr char id[]{"matlabw:mex:Accumulator:append"};
+
+        if (chunk.getRank() != 2)
+        {
+          throw mx::Exception{id, "chunk must be a matrix"};
+        }
+
+        const std::size_t rowCount    = chunk.getDimM();
+        const std::size_t columnCount = chunk.getDimN();
+
+        if (mColumns.empty())
+        {
+          mColumns.resize(columnCount);
+
+          for (Column& column : mColumns)
+          {
+            column.histogram.resize(mOptions.binCount);
+          }
+        }
+        else if (columnCount != mColumns.size())
+        {
+          throw mx::Exception{id, "chunk must have " + std::to_string(mColumns.size()) + " columns"};
+        }
+
+        if (rowCount == 0)
+        {
+          return;
+        }
+
+        mx::visit<mx::RealNumericTypes>(chunk, [&](auto typed)
+        {
+          const auto* data = typed.getData();
+
+          auto update = [&](std::size_t j)
+          {
+            updateColumn(mColumns[j], std::span{data + j * rowCount, rowCount});
+          };
+
+          if (rowCount * columnCount >= mx::algorithm::detail::parallelMinSize && columnCount > 1)
+          {
+            mx::parallel::parallelFor(0, columnCount, 1, update);
+          }
+          else
+          {
+            for (std::size_t j{}; j < columnCount; ++j)
+            {
+              update(j);
+            }
+          }
+        }, [](mx::ArrayCref)
+        {
+          throw mx::Exception{id, "chunk must be a real numeric matrix"};
+        });
+
+        mCount += rowCount;
+      }
+
+      /// @brief Clears the aggregates and the history, the next chunk fixes the number of columns again.
+      void clear() noexcept
+      {
+        mColumns.clear();
+        mCount = 0;
+      }
+
+      /**
+       * @brief Gets the number of observations.
+       * @return The number of observations.
+       */
+      [[nodiscard]] std::size_t getCount() const noexcept
+      {
+        return mCount;
+      }
+
+      /**
+       * @brief Gets the number of variables.
+       * @return The number of columns, 0 before the first chunk.
+       */
+      [[nodiscard]] std::size_t getColumnCount() const noexcept
+      {
+        return mColumns.size();
+      }
+
+      /**
+       * @brief Gets the sums of the columns.
+       * @return 1 x n double row vector.
+       */
+      [[nodiscard]] mx::Array getSum() const
+      {
+        return makeRow([](const Column& column) { return column.sum; });
+      }
+
+      /**
+       * @brief Gets the means of the columns.
+       * @return 1 x n double row vector, NaN before the first observation.
+       */
+      [[nodiscard]] mx::Array getMean() const
+      {
+        return makeRow([this](const Column& column) { return (mCount > 0) ? column.mean : nan; });
+      }
+
+      /**
+       * @brief Gets the variances of the columns, normalized like var.
+       * @param population Whether to normalize by n instead of n - 1.
+       * @return 1 x n double row vector, NaN before the first observation.
+       */
+      [[nodiscard]] mx::Array getVariance(bool population = false) const
+      {
+        return makeRow([this, population](const Column& column)
+        {
+          if (mCount == 0)
+          {
+            return nan;
+          }
+
+          const double norm = (population || mCount == 1) ? static_cast<double>(mCount)
+                                                          : static_cast<double>(mCount - 1);
+
+          return column.m2 / norm;
+        });
+      }
+
+      /**
+       * @brief Gets the minima of the columns.
+       * @return 1 x n double row vector, NaN for columns without non-NaN values.
+       */
+      [[nodiscard]] mx::Array getMin() const
+      {
+        return makeRow([](const Column& column) { return column.min; });
+      }
+
+      /**
+       * @brief Gets the maxima of the columns.
+       * @return 1 x n double row vector, NaN for columns without non-NaN values.
+       */
+      [[nodiscard]] mx::Array getMax() const
+      {
+        return makeRow([](const Column& column) { return column.max; });
+      }
+
+      /**
+       * @brief Gets the histograms of the columns.
+       * @return binCount x n double matrix of counts.
+       */
+      [[nodiscard]] mx::Array getHistogram() const
+      {
+        auto array = mx::makeUninitNumericArray<double>(mOptions.binCount, mColumns.size());
+
+        for (std::size_t j{}; j < mColumns.size(); ++j)
+        {
+          std::copy(mColumns[j].histogram.begin(), mColumns[j].histogram.end(), array.begin() + j * mOptions.binCount);
+        }
+
+        return array;
+      }
+
+      /**
+       * @brief Gets the bin edges of the histograms.
+       * @return 1 x (binCount + 1) double row vector, empty if the histogram is disabled.
+       */
+      [[nodiscard]] mx::Array getBinEdges() const
+      {
+        const std::size_t edgeCount = (mOptions.binCount > 0) ? mOptions.binCount + 1 : 0;
+
+        auto array = mx::makeUninitNumericArray<double>(1, edgeCount);
+
+        for (std::size_t i{}; i < edgeCount; ++i)
+        {
+          array[i] = getBinEdge(i);
+        }
+
+        return array;
+      }
+
+      /**
+       * @brief Gets the appended observations, requires AccumulatorOptions::keepHistory.
+       * @return count x n double matrix.
+       */
+      [[nodiscard]] mx::Array getHistory() const
+      {
+        checkHistory("matlabw:mex:Accumulator:getHistory");
+
+        auto array = mx::makeUninitNumericArray<double>(mCount, mColumns.size());
+
+        for (std::size_t j{}; j < mColumns.size(); ++j)
+        {
+          std::copy(mColumns[j].history.begin(), mColumns[j].history.end(), array.begin() + j * mCount);
+        }
+
+        return array;
+      }
+
+      /**
+       * @brief Saves the state to a scalar struct with the fields count, sum, mean, variance, m2, min, max, binEdges,
+       *        histogram and history (empty unless kept).
+       * @return The struct.
+       */
+      [[nodiscard]] mx::StructArray toStruct() const
+      {
+        auto array = mx::makeStructArray(1, 1, fieldNames);
+
+        auto m2 = makeRow([](const Column& column) { return column.m2; });
+
+        array.setField("count", mx::makeNumericScalar<double>(static_cast<double>(mCount)));
+        array.setField("sum", getSum());
+        array.setField("mean", getMean());
+        array.setField("variance", getVariance());
+        array.setField("m2", std::move(m2));
+        array.setField("min", getMin());
+        array.setField("max", getMax());
+        array.setField("binEdges", getBinEdges());
+        array.setField("histogram", getHistogram());
+        array.setField("history", (mOptions.keepHistory) ? getHistory() : mx::makeNumericArray<double>(0, 0));
+
+        return array;
+      }
+
+      /**
+       * @brief Restores the state saved by toStruct(), the options are taken from the struct except keepHistory.
+       * @param snapshot The struct.
+       */
+      void restore(mx::ArrayCref snapshot)
+      {
+        static constexpr char id[]{"matlabw:mex:Accumulator:restore"};
+
+        if (!snapshot.isStruct() || snapshot.getSize() != 1)
+        {
+          throw mx::Exception{id, "snapshot must be a scalar struct"};
+        }
+
+        const mx::StructArrayCref fields{snapshot};
+
+        auto getField = [&](const char* name) -> std::span<const double>
+        {
+          const auto field = fields.getField(name);
+
+          if (!field.has_value() || !field->isDouble() || field->isComplex())
+          {
+            throw mx::Exception{id, "snapshot field " + std::string{name} + " must be a real double array"};
+          }
+
+          return {static_cast<const double*>(field->getData()), field->getSize()};
+        };
+
+        const auto count    = getField("count");
+        const auto sum      = getField("sum");
+        const auto mean     = getField("mean");
+        const auto m2       = getField("m2");
+        const auto min      = getField("min");
+        const auto max      = getField("max");
+        const auto edges    = getField("binEdges");
+        const auto counts   = getField("histogram");
+        const auto history  = getField("history");
+
+        if (count.size() != 1 || !(count[0] >= 0.0))
+        {
+          throw mx::Exception{id, "invalid snapshot count"};
+        }
+
+        const auto        newCount    = static_cast<std::size_t>(count[0]);
+        const std::size_t columnCount = sum.size();
+        const std::size_t binCount    = (edges.empty()) ? 0 : edges.size() - 1;
+
+        if (mean.size() != columnCount || m2.size() != columnCount || min.size() != columnCount
+            || max.size() != columnCount || counts.size() != binCount * columnCount
+            || (mOptions.keepHistory && history.size() != newCount * columnCount))
+        {
+          throw mx::Exception{id, "inconsistent snapshot sizes"};
+        }
+
+        AccumulatorOptions options{mOptions};
+
+        options.binCount = binCount;
+
+        if (binCount > 0)
+        {
+          options.binLower = edges.front();
+          options.binUpper = edges.back();
+        }
+
+        Accumulator restored{options};
+
+        restored.mCount = newCount;
+        restored.mColumns.resize(columnCount);
+
+        for (std::size_t j{}; j < columnCount; ++j)
+        {
+          Column& column = restored.mColumns[j];
+
+          column.sum  = sum[j];
+          column.mean = (newCount > 0) ? mean[j] : 0.0;
+          column.m2   = m2[j];
+          column.min  = min[j];
+          column.max  = max[j];
+
+          column.histogram.assign(counts.begin() + j * binCount, counts.begin() + (j + 1) * binCount);
+
+          if (options.keepHistory)
+          {
+            column.history.assign(history.begin() + j * newCount, history.begin() + (j + 1) * newCount);
+          }
+        }
+
+        *this = std::move(restored);
+      }
+
+      /**
+       * @brief Writes the state as a variable of a MAT-file.
+       * @param file The file.
+       * @param name The name of the variable.
+       */
+      void snapshot(mat::File& file, const char* name) const
+      {
+        file.putVariable(name, toStruct());
+      }
+
+      /**
+       * @brief Queues the state as a variable to an asynchronous writer, so that the checkpoint is written while the
+       *        computation goes on. Like the writer, meant for standalone programs, MEX files write with a file.
+       * @param writer The writer.
+       * @param name The name of the variable.
+       */
+      void snapshot(mat::AsyncWriter& writer, std::string name) const
+      {
+        writer.put(std::move(name), toStruct());
+      }
+    private:
+      /// @brief Field names of the snapshot struct.
+      static constexpr const char* fieldNames[]{"count", "sum", "mean", "variance", "m2", "min", "max", "binEdges",
+                                                "histogram", "history"};
+
+      static constexpr double nan = std::numeric_limits<double>::quiet_NaN(); ///< NaN.
+
+      /// @brief Aggregates of a column.
+      struct Column
+      {
+        double              sum{};     ///< Sum of the values.
+        double              mean{};    ///< Mean of the values.
+        double              m2{};      ///< Sum of the squared deviations from the mean.
+        double              min{nan};  ///< Minimum of the non-NaN values.
+        double              max{nan};  ///< Maximum of the non-NaN values.
+        std::vector<double> histogram; ///< Counts of the bins.
+        std::vector<double> history;   ///< The values, if kept.
+      };
+
+      /**
+       * @brief Gets a bin edge.
+       * @param i The index of the edge.
+       * @return The edge.
+       */
+      [[nodiscard]] double getBinEdge(std::size_t i) const noexcept
+      {
+        const double width = (mOptions.binUpper - mOptions.binLower) / static_cast<double>(mOptions.binCount);
+
+        return (i == mOptions.binCount) ? mOptions.binUpper : mOptions.binLower + static_cast<double>(i) * width;
+      }
+
+      /**
+       * @brief Updates the aggregates of a column with new values. The chunk mean and deviations are computed first
+       *        and merged into the running ones, which keeps the variance accurate for long streams.
+       * @tparam T The element type.
+       * @param column The column.
+       * @param values The new values.
+       */
+      template<typename T>
+      void updateColumn(Column& column, std::span<const T> values) const
+      {
+        const std::size_t count = values.size();
+
+        double sum{};
+        double min{nan};
+        double max{nan};
+
+        for (const T value : values)
+        {
+          const auto x = static_cast<double>(value);
+
+          sum += x;
+          min  = (x < min || std::isnan(min)) ? x : min;
+          max  = (x > max || std::isnan(max)) ? x : max;
+        }
+
+        const double mean = sum / static_cast<double>(count);
+
+        double m2{};
+
+        for (const T value : values)
+        {
+          const double d = static_cast<double>(value) - mean;
+
+          m2 += d * d;
+        }
+
+        const auto   n     = static_cast<double>(mCount);
+        const auto   k     = static_cast<double>(count);
+        const double delta = mean - column.mean;
+
+        column.sum  += sum;
+        column.mean += delta * k / (n + k);
+        column.m2   += m2 + delta * delta * n * k / (n + k);
+        column.min   = (std::isnan(column.min) || min < column.min) ? min : column.min;
+        column.max   = (std::isnan(column.max) || max > column.max) ? max : column.max;
+
+        if (mOptions.binCount > 0)
+        {
+          const double scale = static_cast<double>(mOptions.binCount) / (mOptions.binUpper - mOptions.binLower);
+
+          for (const T value : values)
+          {
+            const auto x = static_cast<double>(value);
+
+            if (x >= mOptions.binLower && x <= mOptions.binUpper)
+            {
+              const auto bin = static_cast<std::size_t>((x - mOptions.binLower) * scale);
+
+              ++column.histogram[std::min(bin, mOptions.binCount - 1)];
+            }
+          }
+        }
+
+        if (mOptions.keepHistory)
+        {
+          column.history.insert(column.history.end(), values.begin(), values.end());
+        }
+      }
+
+      /**
+       * @brief Makes a row vector of a property of the columns.
+       * @tparam Fn Function type.
+       * @param fn Gets the property of a column.
+       * @return 1 x n double row vector.
+       */
+      template<typename Fn>
+      [[nodiscard]] mx::NumericArray<double> makeRow(Fn fn) const
+      {
+        auto array = mx::makeUninitNumericArray<double>(1, mColumns.size());
+
+        for (std::size_t j{}; j < mColumns.size(); ++j)
+        {
+          array[j] = fn(mColumns[j]);
+        }
+
+        return array;
+      }
+
+      /**
+       * @brief Checks that the history is kept.
+       * @param id The error identifier.
+       */
+      void checkHistory(const char* id) const
+      {
+        if (!mOptions.keepHistory)
+        {
+          throw mx::Exception{id, "history is not kept"};
+        }
+      }
+
+      AccumulatorOptions  mOptions{}; ///< The options.
+      std::vector<Column> mColumns{}; ///< Aggregates of the columns.
+      std::size_t         mCount{};   ///< Number of observations.
+  };
+
+  /**
+   * @brief Gets an accumulator kept across MEX function calls by a mex::State.
+   * @tparam Tag Tag distinguishing several accumulators.
+   * @param options The options, used only when the accumulator is constructed.
+   * @return The accumulator.
+   */
+  template<typename Tag = void>
+  [[nodiscard]] Accumulator& getAccumulator(const AccumulatorOptions& options = {})
+  {
+    return State<Accumulator, Tag>::get(options);
+  }
+
+  /**
+   * @brief Gets a quantile sketch kept across MEX function calls by a mex::State, so that quantiles of a stream of
+   *        frames are updated incrementally.
+   * @tparam Tag Tag distinguishing several sketches.
+   * @param accuracy Capacity of the largest compactor, used only when the sketch is constructed.
+   * @return The sketch.
+   */
+  template<typename Tag = void>
+  [[nodiscard]] auto& getQuantileSketch(std::size_t accuracy = mx::algorithm::QuantileSketch::defaultAccuracy)
+  {
+    return State<mx::algorithm::QuantileSketch, Tag>::get(accuracy);
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_ACCUMULATOR_HPP */
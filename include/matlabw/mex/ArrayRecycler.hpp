@@ -0,0 +1,381 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_ARRAY_RECYCLER_HPP
+#define MATLABW_MEX_ARRAY_RECYCLER_HPP
+
+#include "detail/include.hpp"
+
+#include <list>
+
+#include "atExit.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Pool of persistent uninitialized arrays keyed by class and dimensions, for buffers needed by every call of
+   *        a MEX function, e.g. in real-time loops calling it with identical shapes. A leased array returns to the pool
+   *        when the lease is destroyed, the most recently returned arrays are kept up to the byte capacity.
+   *
+   *        Outputs can not be recycled: once an array is assigned to plhs MATLAB owns and frees it, and persistent
+   *        arrays must not be returned. Allocate outputs which are written completely uninitialized instead, with
+   *        mx::makeUninitArray() or Outputs::allocate(), which saves the zero-fill.
+   *
+   *        The recycler is not thread-safe and must be used from the MATLAB thread only.
+   */
+  class ArrayRecycler
+  {
+    public:
+      class Lease;
+
+      /// @brief Default capacity in bytes.
+      static constexpr std::size_t defaultCapacity{std::size_t{1} << 30};
+
+      /**
+       * @brief Constructor.
+       * @param capacity Maximum number of bytes kept in the pool.
+       */
+      explicit ArrayRecycler(std::size_t capacity = defaultCapacity) noexcept
+      : mCapacity{capacity}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      ArrayRecycler(const ArrayRecycler&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ArrayRecycler(ArrayRecycler&&) = delete;
+
+      /// @brief Destructor. Destroys the pooled arrays, all leases must have ended.
+      ~ArrayRecycler() noexcept
+      {
+        clear();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ArrayRecycler& operator=(const ArrayRecycler&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ArrayRecycler& operator=(ArrayRecycler&&) = delete;
+
+      /**
+       * @brief Leases an array. A pooled array of the same class and dimensions is reused, otherwise an uninitialized
+       *        array is allocated. The contents are undefined.
+       * @param desc The descriptor of the array.
+       * @return The lease.
+       */
+      [[nodiscard]] Lease acquire(const mx::ArrayDesc& desc);
+
+      /**
+       * @brief Leases a numeric array.
+       * @tparam T The element type.
+       * @param m The number of rows.
+       * @param n The number of columns.
+       * @return The lease.
+       */
+      template<typename T>
+      [[nodiscard]] Lease acquire(std::size_t m, std::size_t n);
+
+      /// @brief Destroys the pooled arrays.
+      void clear() noexcept
+      {
+        for (Entry& entry : mEntries)
+        {
+          mxDestroyArray(entry.array);
+        }
+
+        mEntries.clear();
+        mBytesCached = 0;
+      }
+
+      /**
+       * @brief Sets the capacity, evicts the least recently returned arrays above it.
+       * @param capacity Maximum number of bytes kept in the pool.
+       */
+      void setCapacity(std::size_t capacity) noexcept
+      {
+        mCapacity = capacity;
+
+        trim();
+      }
+
+      /**
+       * @brief Gets the capacity.
+       * @return Maximum number of bytes kept in the pool.
+       */
+      [[nodiscard]] std::size_t getCapacity() const noexcept
+      {
+        return mCapacity;
+      }
+
+      /**
+       * @brief Gets the number of bytes kept in the pool.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBytesCached() const noexcept
+      {
+        return mBytesCached;
+      }
+
+      /**
+       * @brief Gets the number of leases served from the pool.
+       * @return The number of hits.
+       */
+      [[nodiscard]] std::size_t getHitCount() const noexcept
+      {
+        return mHitCount;
+      }
+
+      /**
+       * @brief Gets the number of leases which allocated a new array.
+       * @return The number of misses.
+       */
+      [[nodiscard]] std::size_t getMissCount() const noexcept
+      {
+        return mMissCount;
+      }
+
+    private:
+      /// @brief Pooled array.
+      struct Entry
+      {
+        mx::ArrayDesc desc;    ///< The descriptor
+        mxArray*      array{}; ///< The persistent array
+      };
+
+      /**
+       * @brief Returns an array to the pool.
+       * @param desc The descriptor of the array.
+       * @param array The persistent array.
+       */
+      void recycle(mx::ArrayDesc&& desc, mxArray* array) noexcept
+      {
+        const std::size_t size = desc.getSizeInBytes();
+
+        if (size > mCapacity)
+        {
+          mxDestroyArray(array);
+          return;
+        }
+
+        try
+        {
+          mEntries.push_front(Entry{std::move(desc), array});
+        }
+        catch (...)
+        {
+          mxDestroyArray(array);
+          return;
+        }
+
+        mBytesCached += size;
+
+        trim();
+      }
+
+      /// @brief Evicts the least recently returned arrays above the capacity.
+      void trim() noexcept
+      {
+        while (mBytesCached > mCapacity && !mEntries.empty())
+        {
+          mBytesCached -= mEntries.back().desc.getSizeInBytes();
+          mxDestroyArray(mEntries.back().array);
+          mEntries.pop_back();
+        }
+      }
+
+      std::list<Entry> mEntries{};     ///< The pooled arrays, most recently returned first
+      std::size_t      mCapacity{};    ///< Maximum number of bytes kept in the pool
+      std::size_t      mBytesCached{}; ///< Number of bytes kept in the pool
+      std::size_t      mHitCount{};    ///< Number of leases served from the pool
+      std::size_t      mMissCount{};   ///< Number of leases which allocated
+  };
+
+  /// @brief Array leased from an ArrayRecycler, returned to the pool on destruction.
+  class ArrayRecycler::Lease
+  {
+    public:
+      /// @brief Default constructor. Creates an empty lease.
+      Lease() noexcept = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      Lease(const Lease&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other lease.
+       */
+      Lease(Lease&& other) noexcept
+      : mRecycler{std::exchange(other.mRecycler, nullptr)},
+        mDesc{std::move(other.mDesc)},
+        mArray{std::exchange(other.mArray, nullptr)}
+      {}
+
+      /// @brief Destructor. Returns the array to the pool.
+      ~Lease() noexcept
+      {
+        reset();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Lease& operator=(const Lease&) = delete;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other lease.
+       * @return Reference to this.
+       */
+      Lease& operator=(Lease&& other) noexcept
+      {
+        if (this != &other)
+        {
+          reset();
+
+          mRecycler = std::exchange(other.mRecycler, nullptr);
+          mDesc     = std::move(other.mDesc);
+          mArray    = std::exchange(other.mArray, nullptr);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Gets a reference to the leased array.
+       * @return The reference.
+       */
+      [[nodiscard]] mx::ArrayRef getRef() const noexcept
+      {
+        return mx::ArrayRef{mArray};
+      }
+
+      /**
+       * @brief Gets a pointer to the data of the leased array.
+       * @tparam T The element type, must match the class of the array.
+       * @return The pointer.
+       */
+      template<typename T>
+      [[nodiscard]] T* getData() const
+      {
+        if (!mDesc.is<T>())
+        {
+          throw mx::Exception{"matlabw:mex:ArrayRecycler:Lease:getData", "type must match the array class"};
+        }
+
+        return static_cast<T*>(mxGetData(mArray));
+      }
+
+      /**
+       * @brief Gets the descriptor of the leased array.
+       * @return The descriptor.
+       */
+      [[nodiscard]] const mx::ArrayDesc& getDesc() const noexcept
+      {
+        return mDesc;
+      }
+
+      /**
+       * @brief Checks if the lease holds an array.
+       * @return True if the lease holds an array.
+       */
+      [[nodiscard]] explicit operator bool() const noexcept
+      {
+        return mArray != nullptr;
+      }
+
+      /// @brief Returns the array to the pool early.
+      void reset() noexcept
+      {
+        if (mArray != nullptr)
+        {
+          mRecycler->recycle(std::move(mDesc), std::exchange(mArray, nullptr));
+          mRecycler = nullptr;
+        }
+      }
+
+    private:
+      friend class ArrayRecycler;
+
+      /**
+       * @brief Constructor.
+       * @param recycler The recycler owning the array.
+       * @param desc The descriptor of the array.
+       * @param array The persistent array.
+       */
+      Lease(ArrayRecycler& recycler, mx::ArrayDesc desc, mxArray* array) noexcept
+      : mRecycler{&recycler}, mDesc{std::move(desc)}, mArray{array}
+      {}
+
+      ArrayRecycler* mRecycler{}; ///< The recycler owning the array
+      mx::ArrayDesc  mDesc{};     ///< The descriptor of the array
+      mxArray*       mArray{};    ///< The persistent array
+  };
+
+  inline ArrayRecycler::Lease ArrayRecycler::acquire(const mx::ArrayDesc& desc)
+  {
+    const auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](const Entry& entry)
+    {
+      return entry.desc == desc;
+    });
+
+    if (it != mEntries.end())
+    {
+      Lease lease{*this, std::move(it->desc), it->array};
+
+      mBytesCached -= lease.getDesc().getSizeInBytes();
+      mEntries.erase(it);
+      ++mHitCount;
+
+      return lease;
+    }
+
+    mxArray* array = mx::makeUninitArray(desc).release();
+
+    mexMakeArrayPersistent(array);
+    ++mMissCount;
+
+    return Lease{*this, desc, array};
+  }
+
+  template<typename T>
+  inline ArrayRecycler::Lease ArrayRecycler::acquire(std::size_t m, std::size_t n)
+  {
+    return acquire(mx::ArrayDesc::of<T>(m, n));
+  }
+
+  /**
+   * @brief Gets the array recycler shared by the whole MEX file. Its arrays are destroyed when the MEX file is cleared
+   *        or MATLAB exits.
+   * @return The recycler.
+   */
+  [[nodiscard]] inline ArrayRecycler& getArrayRecycler()
+  {
+    static ArrayRecycler recycler{};
+    static const bool    registered = (atExit([]{ recycler.clear(); }), true);
+
+    static_cast<void>(registered);
+
+    return recycler;
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_ARRAY_RECYCLER_HPP */
@@ -0,0 +1,755 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_ASYNC_JOB_HPP
+#define MATLABW_MEX_ASYNC_JOB_HPP
+
+#include "detail/include.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <mutex>
+#include <thread>
+
+#include <matlabw/mx/parallel/cancellation.hpp>
+#include <matlabw/mx/parallel/ThreadPool.hpp>
+
+#include "ObjectRegistry.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Status of an asynchronous job.
+  enum class JobStatus
+  {
+    running,   ///< The job is running.
+    completed, ///< The job finished and its outputs can be fetched.
+    failed,    ///< The job threw an exception.
+    cancelled, ///< The job was cancelled.
+  };
+
+  /**
+   * @brief Gets the name of a job status.
+   * @param status The status.
+   * @return The name.
+   */
+  [[nodiscard]] constexpr std::string_view toString(JobStatus status) noexcept
+  {
+    switch (status)
+    {
+    case JobStatus::running:
+      return "running";
+    case JobStatus::completed:
+      return "completed";
+    case JobStatus::failed:
+      return "failed";
+    case JobStatus::cancelled:
+      return "cancelled";
+    }
+
+    return "unknown";
+  }
+
+  /**
+   * @brief Writes the outputs of a job to the left-hand side arguments. Jobs must not call the MATLAB API, so they
+   *        compute into C++ containers and return a writer that creates the arrays on the MATLAB thread when the
+   *        outputs are fetched, typically moving the containers into the arrays.
+   */
+  using JobOutputs = std::function<void(mx::Span<mx::Array> lhs)>;
+
+  /// @brief Thrown to cancel a job from its body, and by fetching the outputs of a cancelled job.
+  class JobCancelled : public mx::Exception
+  {
+    public:
+      /// @brief Default constructor.
+      JobCancelled()
+      : mx::Exception{"matlabw:mex:AsyncJob:cancelled", "job was cancelled"}
+      {}
+  };
+
+  /// @brief Awaited by job coroutines to offer a cancellation point, see AsyncTask.
+  struct JobCheckpoint {};
+
+  /// @brief Cancellation point of job coroutines, co_await jobCheckpoint.
+  inline constexpr JobCheckpoint jobCheckpoint{};
+
+  /**
+   * @brief Coroutine type of asynchronous jobs. The coroutine runs on the thread of its job, suspends at cancellation
+   *        points by co_await jobCheckpoint and finishes by co_return outputs. A cancelled job is not resumed, its
+   *        coroutine frame is destroyed at the cancellation point, so its locals are released as if by an exception.
+   *        Other awaitables are rejected, the coroutine would be resumed elsewhere. Partial outputs are published by
+   *        JobContext::publish().
+   */
+  class AsyncTask
+  {
+    public:
+      /// @brief Promise of the coroutine.
+      class promise_type
+      {
+        public:
+          /**
+           * @brief Creates the task.
+           * @return The task.
+           */
+          [[nodiscard]] AsyncTask get_return_object() noexcept
+          {
+            return AsyncTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+          }
+
+          /**
+           * @brief The coroutine is started by its job.
+           * @return Always suspends.
+           */
+          [[nodiscard]] std::suspend_always initial_suspend() const noexcept
+          {
+            return {};
+          }
+
+          /**
+           * @brief The finished coroutine is destroyed by its task.
+           * @return Always suspends.
+           */
+          [[nodiscard]] std::suspend_always final_suspend() const noexcept
+          {
+            return {};
+          }
+
+          /**
+           * @brief Accepts only cancellation points.
+           * @return Always suspends.
+           */
+          [[nodiscard]] std::suspend_always await_transform(JobCheckpoint) const noexcept
+          {
+            return {};
+          }
+
+          /**
+           * @brief Stores the outputs of co_return.
+           * @param outputs The outputs.
+           */
+          void return_value(JobOutputs outputs) noexcept
+          {
+            mOutputs = std::move(outputs);
+          }
+
+          /// @brief Stores the exception escaping the coroutine.
+          void unhandled_exception() noexcept
+          {
+            mError = std::current_exception();
+          }
+        private:
+          friend class AsyncJob;
+
+          JobOutputs         mOutputs{}; ///< Outputs of co_return.
+          std::exception_ptr mError{};   ///< Exception escaping the coroutine.
+      };
+
+      /// @brief Explicitly deleted copy constructor.
+      AsyncTask(const AsyncTask&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other task.
+       */
+      AsyncTask(AsyncTask&& other) noexcept
+      : mHandle{std::exchange(other.mHandle, nullptr)}
+      {}
+
+      /// @brief Destructor. Destroys the coroutine frame.
+      ~AsyncTask() noexcept
+      {
+        if (mHandle)
+        {
+          mHandle.destroy();
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      AsyncTask& operator=(const AsyncTask&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      AsyncTask& operator=(AsyncTask&&) = delete;
+    private:
+      friend class AsyncJob;
+
+      /**
+       * @brief Constructor.
+       * @param handle The coroutine handle.
+       */
+      explicit AsyncTask(std::coroutine_handle<promise_type> handle) noexcept
+      : mHandle{handle}
+      {}
+
+      std::coroutine_handle<promise_type> mHandle{}; ///< The coroutine handle.
+  };
+
+  /**
+   * @brief Context of a running job, passed to its body. Thread-safe.
+   */
+  class JobContext
+  {
+    public:
+      /// @brief Default constructor.
+      JobContext() = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      JobContext(const JobContext&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      JobContext(JobContext&&) = delete;
+
+      /// @brief Destructor.
+      ~JobContext() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      JobContext& operator=(const JobContext&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      JobContext& operator=(JobContext&&) = delete;
+
+      /**
+       * @brief Checks if the job was asked to cancel. Long loops of plain jobs should poll it.
+       * @return True if the cancellation was requested.
+       */
+      [[nodiscard]] bool isCancelRequested() const noexcept
+      {
+        return mCancelRequested.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Gets the cancellation token of the job, which is also the token of the parallel loops of the job thread.
+       * @return The token.
+       */
+      [[nodiscard]] mx::parallel::CancellationToken getCancellationToken() const noexcept
+      {
+        return mx::parallel::CancellationToken{mCancelRequested};
+      }
+
+      /// @brief Throws JobCancelled if the job was asked to cancel.
+      void throwIfCancelRequested() const
+      {
+        if (isCancelRequested())
+        {
+          throw JobCancelled{};
+        }
+      }
+
+      /**
+       * @brief Sets the progress reported by the status command.
+       * @param progress The progress, clamped to [0, 1].
+       */
+      void setProgress(double progress) noexcept
+      {
+        mProgress.store(std::clamp(progress, 0.0, 1.0), std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Gets the progress.
+       * @return The progress in [0, 1].
+       */
+      [[nodiscard]] double getProgress() const noexcept
+      {
+        return mProgress.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Publishes partial outputs, replacing the previous ones. The writer may run several times, once per fetch,
+       *        so it must copy the data it owns instead of moving it.
+       * @param outputs The partial outputs.
+       */
+      void publish(JobOutputs outputs)
+      {
+        auto partial = std::make_shared<const JobOutputs>(std::move(outputs));
+
+        std::lock_guard lock{mMutex};
+
+        mPartial.swap(partial);
+      }
+    private:
+      friend class AsyncJob;
+
+      /**
+       * @brief Gets the last published partial outputs.
+       * @return The partial outputs, null if none were published.
+       */
+      [[nodiscard]] std::shared_ptr<const JobOutputs> getPartial() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mPartial;
+      }
+
+      std::atomic<bool>                 mCancelRequested{}; ///< Set when the cancellation is requested.
+      std::atomic<double>               mProgress{};        ///< Progress of the job.
+      mutable std::mutex                mMutex{};           ///< Mutex guarding the partial outputs.
+      std::shared_ptr<const JobOutputs> mPartial{};         ///< Last published partial outputs.
+  };
+
+  /**
+   * @brief Stream of chunks a job passes to MATLAB while it runs, see StreamChannel. The chunks are produced on the job
+   *        thread and popped on the MATLAB thread.
+   */
+  class JobStream
+  {
+    public:
+      /// @brief Default constructor.
+      JobStream() = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      JobStream(const JobStream&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      JobStream(JobStream&&) = delete;
+
+      /// @brief Default destructor.
+      virtual ~JobStream() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      JobStream& operator=(const JobStream&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      JobStream& operator=(JobStream&&) = delete;
+
+      /**
+       * @brief Writes the next ready chunk to the first output. Must be called from the MATLAB thread.
+       * @param lhs Left-hand side arguments.
+       * @return True if a chunk was ready, false otherwise.
+       */
+      virtual bool pop(mx::Span<mx::Array> lhs) = 0;
+
+      /**
+       * @brief Checks if the producer closed the stream and all chunks were popped.
+       * @return True if no more chunks will be ready.
+       */
+      [[nodiscard]] virtual bool isDrained() const noexcept = 0;
+
+      /// @brief Marks the end of the stream, called when the job finishes.
+      virtual void close() noexcept = 0;
+
+      /// @brief Wakes and cancels a producer waiting for a free slot, called when the job is cancelled.
+      virtual void cancel() noexcept = 0;
+  };
+
+  /**
+   * @brief Job running in the background while MATLAB stays responsive, typically registered in the job registry and
+   *        driven by JobDispatcher. The body is either a coroutine returning AsyncTask or a plain callable returning
+   *        JobOutputs, both called with the JobContext of the job.
+   *
+   *        Each job runs on a thread of its own instead of a thread pool worker: a job occupying a worker would run its
+   *        parallel loops serially and keep the pool from shutting down, while the job thread spreads them over the
+   *        pool. The body must not call the MATLAB API. The job is controlled from the MATLAB thread.
+   */
+  class AsyncJob
+  {
+    public:
+      /**
+       * @brief Constructor. Starts the job.
+       * @tparam Fn Body type, invocable with JobContext& and returning AsyncTask or JobOutputs.
+       * @param fn The body, it is moved to the job thread.
+       */
+      template<typename Fn>
+        requires std::is_same_v<std::invoke_result_t<Fn&, JobContext&>, AsyncTask>
+              || std::is_convertible_v<std::invoke_result_t<Fn&, JobContext&>, JobOutputs>
+      explicit AsyncJob(Fn fn)
+      : mThread{[this, fn = std::move(fn)]() mutable { run(fn); }}
+      {}
+
+      /**
+       * @brief Constructor. Starts a job streaming chunks to MATLAB, the body typically captures the stream too.
+       * @tparam Fn Body type, invocable with JobContext& and returning AsyncTask or JobOutputs.
+       * @param fn The body, it is moved to the job thread.
+       * @param stream The stream, closed when the job finishes.
+       */
+      template<typename Fn>
+        requires std::is_same_v<std::invoke_result_t<Fn&, JobContext&>, AsyncTask>
+              || std::is_convertible_v<std::invoke_result_t<Fn&, JobContext&>, JobOutputs>
+      AsyncJob(Fn fn, std::shared_ptr<JobStream> stream)
+      : mStream{std::move(stream)},
+        mThread{[this, fn = std::move(fn)]() mutable { run(fn); }}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      AsyncJob(const AsyncJob&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      AsyncJob(AsyncJob&&) = delete;
+
+      /// @brief Destructor. Cancels the job and waits until its body returns or reaches a cancellation point.
+      ~AsyncJob() noexcept
+      {
+        cancel();
+        mThread.join();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      AsyncJob& operator=(const AsyncJob&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      AsyncJob& operator=(AsyncJob&&) = delete;
+
+      /**
+       * @brief Gets the status of the job.
+       * @return The status.
+       */
+      [[nodiscard]] JobStatus getStatus() const noexcept
+      {
+        return mStatus.load(std::memory_order_acquire);
+      }
+
+      /**
+       * @brief Gets the progress set by the job.
+       * @return The progress in [0, 1].
+       */
+      [[nodiscard]] double getProgress() const noexcept
+      {
+        return mContext.getProgress();
+      }
+
+      /// @brief Asks the job to cancel, does not wait for it.
+      void cancel() noexcept
+      {
+        mContext.mCancelRequested.store(true, std::memory_order_relaxed);
+
+        if (mStream != nullptr)
+        {
+          mStream->cancel();
+        }
+      }
+
+      /**
+       * @brief Gets the stream of the job.
+       * @return The stream, null if the job does not stream chunks.
+       */
+      [[nodiscard]] JobStream* getStream() const noexcept
+      {
+        return mStream.get();
+      }
+
+      /**
+       * @brief Blocks until the job finishes. Ctrl-C on the MATLAB thread cancels the job and interrupts the wait.
+       * @throws mx::parallel::CancelledException if the calling thread was interrupted.
+       */
+      void wait()
+      {
+        const auto token = mx::parallel::getCancellationToken();
+
+        while (getStatus() == JobStatus::running)
+        {
+          if (token.isCancelled())
+          {
+            cancel();
+            throw mx::parallel::CancelledException{};
+          }
+
+          std::this_thread::sleep_for(mx::parallel::detail::interruptPollInterval);
+        }
+      }
+
+      /**
+       * @brief Writes the last published partial outputs. Must be called from the MATLAB thread.
+       * @param lhs Left-hand side arguments.
+       * @return True if partial outputs were published, false otherwise.
+       */
+      bool fetchPartial(mx::Span<mx::Array> lhs) const
+      {
+        const auto partial = mContext.getPartial();
+
+        if (partial == nullptr)
+        {
+          return false;
+        }
+
+        (*partial)(lhs);
+
+        return true;
+      }
+
+      /**
+       * @brief Writes the outputs of a finished job. Must be called from the MATLAB thread, at most once.
+       * @param lhs Left-hand side arguments.
+       * @throws The exception of a failed job, JobCancelled for a cancelled job.
+       */
+      void fetch(mx::Span<mx::Array> lhs)
+      {
+        switch (getStatus())
+        {
+        case JobStatus::running:
+          throw mx::Exception{"matlabw:mex:AsyncJob:running", "job is still running"};
+        case JobStatus::completed:
+          if (mOutputs)
+          {
+            std::exchange(mOutputs, nullptr)(lhs);
+          }
+          break;
+        case JobStatus::failed:
+          std::rethrow_exception(mError);
+        case JobStatus::cancelled:
+          throw JobCancelled{};
+        }
+      }
+    private:
+      /**
+       * @brief Runs the body of the job on the job thread.
+       * @tparam Fn Body type.
+       * @param fn The body.
+       */
+      template<typename Fn>
+      void run(Fn& fn) noexcept
+      {
+        JobStatus status{JobStatus::failed};
+
+        // Parallel loops of the job stop when it is cancelled.
+        const mx::parallel::CancellationScope scope{mContext.getCancellationToken()};
+
+        try
+        {
+          if constexpr (std::is_same_v<std::invoke_result_t<Fn&, JobContext&>, AsyncTask>)
+          {
+            status = drive(fn(mContext));
+          }
+          else
+          {
+            mContext.throwIfCancelRequested();
+            mOutputs = fn(mContext);
+            status   = JobStatus::completed;
+          }
+        }
+        catch (const JobCancelled&)
+        {
+          status = JobStatus::cancelled;
+        }
+        catch (const mx::parallel::CancelledException&)
+        {
+          status = JobStatus::cancelled;
+        }
+        catch (...)
+        {
+          mError = std::current_exception();
+        }
+
+        // The end of the stream is visible before the status, a finished job never streams more chunks.
+        if (mStream != nullptr)
+        {
+          mStream->close();
+        }
+
+        mStatus.store(status, std::memory_order_release);
+      }
+
+      /**
+       * @brief Resumes a coroutine until it finishes or the job is cancelled at a cancellation point.
+       * @param task The task of the coroutine.
+       * @return The status of the job.
+       */
+      JobStatus drive(AsyncTask task)
+      {
+        auto& promise = task.mHandle.promise();
+
+        while (true)
+        {
+          if (mContext.isCancelRequested())
+          {
+            // The frame is destroyed with the task.
+            return JobStatus::cancelled;
+          }
+
+          task.mHandle.resume();
+
+          if (task.mHandle.done())
+          {
+            if (promise.mError != nullptr)
+            {
+              std::rethrow_exception(promise.mError);
+            }
+
+            mOutputs = std::move(promise.mOutputs);
+
+            return JobStatus::completed;
+          }
+        }
+      }
+
+      JobContext                 mContext{};                  ///< Context of the job.
+      std::atomic<JobStatus>     mStatus{JobStatus::running}; ///< Status of the job, written by the job thread.
+      JobOutputs                 mOutputs{};                  ///< Outputs, valid once completed.
+      std::exception_ptr         mError{};                    ///< Exception, valid once failed.
+      std::shared_ptr<JobStream> mStream{};                   ///< The stream of chunks, null if not streaming.
+      std::thread                mThread;                     ///< The job thread, started last.
+  };
+
+  /**
+   * @brief Gets the registry of the jobs of the MEX file. The thread pool is created first, so that the exit handler
+   *        cancels the jobs before it shuts down the pool their parallel loops run on.
+   * @return The registry.
+   */
+  [[nodiscard]] inline ObjectRegistry<AsyncJob>& getJobRegistry()
+  {
+    static_cast<void>(mx::parallel::getThreadPool());
+
+    return getObjectRegistry<AsyncJob>();
+  }
+
+  /**
+   * @brief Dispatches the calls of a MEX function running jobs in the background. The first argument is the command:
+   *
+   *          h = myfunc('start', args...)         starts a job and returns its handle
+   *          [status, progress] = myfunc('status', h)
+   *          [out...] = myfunc('fetch', h)        the outputs of a finished job, which is then destroyed, or
+   *                                               the partial outputs of a running job
+   *          [chunk, done] = myfunc('pop', h)     the next chunk streamed by the job, [] if none is ready, done
+   *                                               once the job finished and no more chunks follow
+   *          myfunc('cancel', h)                  asks the job to cancel, fetch then reports the cancellation
+   *          myfunc('delete', h)                  cancels and destroys the job
+   *
+   *        The status is 'running', 'completed', 'failed' or 'cancelled', fetching a failed job rethrows its error.
+   */
+  class JobDispatcher
+  {
+    public:
+      /**
+       * @brief Starts a job from the arguments following 'start'. The arguments are freed when the call returns, so
+       *        the job must copy the data it needs.
+       */
+      using Launcher = std::function<std::unique_ptr<AsyncJob>(mx::View<mx::ArrayCref> rhs)>;
+
+      /**
+       * @brief Constructor.
+       * @param launcher Starts the jobs.
+       * @param registry The registry holding the jobs.
+       */
+      explicit JobDispatcher(Launcher launcher, ObjectRegistry<AsyncJob>& registry = getJobRegistry())
+      : mLauncher{std::move(launcher)}, mRegistry{&registry}
+      {}
+
+      /**
+       * @brief Dispatches a call.
+       * @param lhs Left-hand side arguments.
+       * @param rhs Right-hand side arguments, the command followed by the handle.
+       */
+      void operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs) const
+      {
+        static constexpr char id[]{"matlabw:mex:JobDispatcher"};
+
+        if (rhs.empty() || !rhs[0].isChar())
+        {
+          throw mx::Exception{id, "first argument must be a command string"};
+        }
+
+        const std::string command = mx::toAscii(rhs[0]);
+
+        if (command == "start")
+        {
+          if (lhs.empty())
+          {
+            throw mx::Exception{id, "'start' requires an output for the handle"};
+          }
+
+          lhs[0] = toHandleArray(mRegistry->add(mLauncher(rhs.subspan(1))));
+          return;
+        }
+
+        if (rhs.size() != 2)
+        {
+          throw mx::Exception{id, "command '" + command + "' requires a job handle"};
+        }
+
+        const ObjectHandle handle = toHandle(rhs[1]);
+        AsyncJob&          job    = mRegistry->get(handle);
+
+        if (command == "status")
+        {
+          if (!lhs.empty())
+          {
+            lhs[0] = mx::makeCharArray(toString(job.getStatus()));
+          }
+
+          if (lhs.size() > 1)
+          {
+            lhs[1] = mx::makeNumericScalar<double>(job.getProgress());
+          }
+        }
+        else if (command == "fetch")
+        {
+          if (job.getStatus() == JobStatus::running)
+          {
+            if (!job.fetchPartial(lhs))
+            {
+              throw mx::Exception{id, "job is running and has not published partial outputs"};
+            }
+
+            return;
+          }
+
+          // A finished job is consumed, even if its outputs can not be written.
+          try
+          {
+            job.fetch(lhs);
+          }
+          catch (...)
+          {
+            mRegistry->remove(handle);
+            throw;
+          }
+
+          mRegistry->remove(handle);
+        }
+        else if (command == "pop")
+        {
+          JobStream* stream = job.getStream();
+
+          if (stream == nullptr)
+          {
+            throw mx::Exception{id, "job does not stream chunks"};
+          }
+
+          if (!stream->pop(lhs))
+          {
+            lhs.data()[0] = mx::makeNumericArray<double>(0, 0);
+          }
+
+          // Checked after the pop, done is also reported with the last chunk.
+          if (lhs.size() > 1)
+          {
+            lhs[1] = mx::makeLogicalScalar(stream->isDrained());
+          }
+        }
+        else if (command == "cancel")
+        {
+          job.cancel();
+        }
+        else if (command == "delete")
+        {
+          mRegistry->remove(handle);
+        }
+        else
+        {
+          throw mx::Exception{id, "unknown command '" + command + "'"};
+        }
+      }
+    private:
+      Launcher                  mLauncher{}; ///< Starts the jobs.
+      ObjectRegistry<AsyncJob>* mRegistry{}; ///< The registry holding the jobs.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_ASYNC_JOB_HPP */
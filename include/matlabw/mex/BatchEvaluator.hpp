@@ -0,0 +1,276 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_BATCH_EVALUATOR_HPP
+#define MATLABW_MEX_BATCH_EVALUATOR_HPP
+
+#include "detail/include.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+
+#include "eval.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Evaluates a vectorized MATLAB function on many points with one call per batch. The function receives a
+   *        pointDim x k double matrix with one point per column and must return a resultDim x k real double matrix.
+   *
+   *        Points are either evaluated synchronously by evaluate(), or submitted from worker threads by submit() and
+   *        evaluated by serve() running on the MATLAB thread. Must not outlive the MEX function call.
+   */
+  class BatchEvaluator
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param function The function handle, must stay valid while the evaluator is used.
+       * @param pointDim The number of elements of a point.
+       * @param resultDim The number of elements of a result.
+       * @param batchSize The maximum number of points per call.
+       */
+      BatchEvaluator(mx::ArrayCref function, std::size_t pointDim, std::size_t resultDim, std::size_t batchSize = 1024)
+      : mCallable{function, 1}, mPointDim{pointDim}, mResultDim{resultDim}, mBatchSize{batchSize}
+      {
+        static constexpr char id[]{"matlabw:mex:BatchEvaluator:invalidSize"};
+
+        if (pointDim == 0 || batchSize == 0)
+        {
+          throw mx::Exception{id, "point dimension and batch size must be positive"};
+        }
+
+        mCallable.setInput(0, mx::makeUninitNumericArray<double>(pointDim, batchSize));
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      BatchEvaluator(const BatchEvaluator&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      BatchEvaluator(BatchEvaluator&&) = delete;
+
+      /// @brief Destructor.
+      ~BatchEvaluator() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      BatchEvaluator& operator=(const BatchEvaluator&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      BatchEvaluator& operator=(BatchEvaluator&&) = delete;
+
+      /**
+       * @brief Gets the maximum number of points per call.
+       * @return The batch size.
+       */
+      [[nodiscard]] std::size_t getBatchSize() const noexcept
+      {
+        return mBatchSize;
+      }
+
+      /**
+       * @brief Evaluates the function on the points. Must be called from the MATLAB thread.
+       * @param points The points stored column by column, pointDim elements each.
+       * @param results The results stored column by column, resultDim elements each.
+       */
+      void evaluate(mx::View<double> points, mx::Span<double> results)
+      {
+        static constexpr char id[]{"matlabw:mex:BatchEvaluator:evaluate"};
+
+        const std::size_t count = points.size() / mPointDim;
+
+        if (points.size() != count * mPointDim || results.size() != count * mResultDim)
+        {
+          throw mx::Exception{id, "points and results sizes do not match"};
+        }
+
+        for (std::size_t first{}; first < count; first += mBatchSize)
+        {
+          const std::size_t batchCount = std::min(mBatchSize, count - first);
+
+          evaluateBatch(points.data() + first * mPointDim, batchCount, results.data() + first * mResultDim);
+        }
+      }
+
+      /**
+       * @brief Submits a point for evaluation by serve(). Thread-safe.
+       * @param point The point, pointDim elements.
+       * @return The future result, resultDim elements.
+       */
+      [[nodiscard]] std::future<std::vector<double>> submit(mx::View<double> point)
+      {
+        static constexpr char id[]{"matlabw:mex:BatchEvaluator:submit"};
+
+        if (point.size() != mPointDim)
+        {
+          throw mx::Exception{id, "point size does not match"};
+        }
+
+        std::promise<std::vector<double>> promise{};
+        auto                              future = promise.get_future();
+
+        {
+          std::lock_guard lock{mMutex};
+
+          if (mError != nullptr)
+          {
+            promise.set_exception(mError);
+
+            return future;
+          }
+
+          mQueuedPoints.insert(mQueuedPoints.end(), point.begin(), point.end());
+          mQueuedPromises.push_back(std::move(promise));
+        }
+
+        mQueueCondition.notify_one();
+
+        return future;
+      }
+
+      /**
+       * @brief Evaluates submitted points until the given number of points has been evaluated. A batch is evaluated as
+       *        soon as it is full, or when no more points arrived within the maximum delay. Must be called from the
+       *        MATLAB thread. If the function fails, all pending and later submitted points fail with the same error
+       *        and the error is rethrown.
+       * @param pointCount The number of points to evaluate.
+       * @param maxDelay The maximum time to wait for a batch to fill.
+       */
+      void serve(std::size_t pointCount, std::chrono::microseconds maxDelay = std::chrono::microseconds{1000})
+      {
+        std::vector<double>                            points{};
+        std::vector<std::promise<std::vector<double>>> promises{};
+        std::vector<double>                            results{};
+
+        for (std::size_t evaluated{}; evaluated < pointCount; evaluated += promises.size())
+        {
+          const std::size_t wanted = std::min(mBatchSize, pointCount - evaluated);
+
+          {
+            std::unique_lock lock{mMutex};
+
+            mQueueCondition.wait(lock, [&]{ return !mQueuedPromises.empty(); });
+            mQueueCondition.wait_for(lock, maxDelay, [&]{ return mQueuedPromises.size() >= wanted; });
+
+            const std::size_t count = std::min(wanted, mQueuedPromises.size());
+
+            points.assign(mQueuedPoints.begin(), mQueuedPoints.begin() + count * mPointDim);
+            mQueuedPoints.erase(mQueuedPoints.begin(), mQueuedPoints.begin() + count * mPointDim);
+
+            promises.assign(std::make_move_iterator(mQueuedPromises.begin()),
+                            std::make_move_iterator(mQueuedPromises.begin() + count));
+            mQueuedPromises.erase(mQueuedPromises.begin(), mQueuedPromises.begin() + count);
+          }
+
+          results.resize(promises.size() * mResultDim);
+
+          try
+          {
+            evaluateBatch(points.data(), promises.size(), results.data());
+          }
+          catch (...)
+          {
+            fail(promises, std::current_exception());
+            throw;
+          }
+
+          for (std::size_t i{}; i < promises.size(); ++i)
+          {
+            promises[i].set_value(std::vector<double>(results.begin() + i * mResultDim,
+                                                      results.begin() + (i + 1) * mResultDim));
+          }
+        }
+      }
+    private:
+      /**
+       * @brief Evaluates one batch of points.
+       * @param points The points.
+       * @param count The number of points, at most the batch size.
+       * @param results The results.
+       */
+      void evaluateBatch(const double* points, std::size_t count, double* results)
+      {
+        static constexpr char id[]{"matlabw:mex:BatchEvaluator:invalidResult"};
+
+        mx::TypedArrayRef<double> input{mCallable.getInput(0)};
+
+        if (input.getDimN() != count)
+        {
+          input.resize(mPointDim, count);
+        }
+
+        std::copy_n(points, count * mPointDim, input.getData());
+
+        mx::ArrayCref output = mCallable()[0];
+
+        if (output.getClassId() != mx::ClassId::_double || output.isComplex() || output.isSparse() ||
+            output.getSize() != count * mResultDim)
+        {
+          throw mx::Exception{id, "function must return a real double matrix with one result per column"};
+        }
+
+        const mx::TypedArrayCref<double> typedOutput{output, mx::detail::ClassCheckedTag{}};
+
+        std::copy_n(typedOutput.getData(), count * mResultDim, results);
+      }
+
+      /**
+       * @brief Fails the batch and all queued points with the error.
+       * @param promises The promises of the batch.
+       * @param error The error.
+       */
+      void fail(std::vector<std::promise<std::vector<double>>>& promises, std::exception_ptr error)
+      {
+        std::lock_guard lock{mMutex};
+
+        mError = error;
+
+        for (auto& promise : promises)
+        {
+          promise.set_exception(error);
+        }
+
+        for (auto& promise : mQueuedPromises)
+        {
+          promise.set_exception(error);
+        }
+
+        mQueuedPoints.clear();
+        mQueuedPromises.clear();
+      }
+
+      Callable                                       mCallable;          ///< The function.
+      std::size_t                                    mPointDim{};        ///< The number of elements of a point.
+      std::size_t                                    mResultDim{};       ///< The number of elements of a result.
+      std::size_t                                    mBatchSize{};       ///< The maximum number of points per call.
+      std::mutex                                     mMutex{};           ///< Mutex guarding the queue.
+      std::condition_variable                        mQueueCondition{};  ///< Signals submitted points.
+      std::vector<double>                            mQueuedPoints{};    ///< The submitted points.
+      std::vector<std::promise<std::vector<double>>> mQueuedPromises{};  ///< The promises of the submitted points.
+      std::exception_ptr                             mError{};           ///< The error of a failed batch.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_BATCH_EVALUATOR_HPP */
@@ -0,0 +1,319 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MEX_COMMAND_TABLE_HPP
+#define MATLABW_MEX_COMMAND_TABLE_HPP
+
+#include "detail/include.hpp"
+
+#include <array>
+#include <bit>
+#include <limits>
+#include <string_view>
+
+namespace matlabw::mex
+{
+  /// @brief Handler of a command, called with the arguments following the command name.
+  using CommandHandler = void (*)(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs);
+
+  /// @brief Command of a CommandTable.
+  struct Command
+  {
+    std::string_view name{};                                          ///< The name of the command.
+    CommandHandler   handler{};                                       ///< The handler.
+    std::uint16_t    minRhs{};                                        ///< Minimum number of arguments.
+    std::uint16_t    maxRhs{std::numeric_limits<std::uint16_t>::max()}; ///< Maximum number of arguments.
+    std::uint16_t    maxLhs{1};                                       ///< Maximum number of outputs.
+  };
+
+namespace detail
+{
+  /// @brief Maximum length of a command name.
+  inline constexpr std::size_t commandMaxLength{63};
+
+  /**
+   * @brief Hashes a command name, FNV-1a with a seed and a final mix.
+   * @tparam C The character type.
+   * @param seed The seed.
+   * @param str The characters.
+   * @param size The number of characters.
+   * @return The hash.
+   */
+  template<typename C>
+  [[nodiscard]] constexpr std::uint32_t hashCommand(std::uint32_t seed, const C* str, std::size_t size) noexcept
+  {
+    std::uint32_t hash = 2166136261u ^ seed;
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+      hash ^= static_cast<std::uint32_t>(str[i]);
+      hash *= 16777619u;
+    }
+
+    return hash ^ (hash >> 15);
+  }
+} // namespace detail
+
+  /**
+   * @brief Multiplexes the subcommands of a MEX function selected by the name in the first argument, for MEX files
+   *        called very often with little work per call. The names are hashed by a perfect hash found at compile time,
+   *        so dispatching reads the characters of the name in place, hashes them and compares them with a single
+   *        candidate, without allocating or decoding a string. The argument counts are checked before the handler is
+   *        called, error messages are only built on failure:
+   *
+   *          constexpr auto commands = mex::makeCommandTable({{"add", add, 2, 2}, {"reset", reset, 0, 0, 0}});
+   *
+   *          void mex::Function::operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)
+   *          {
+   *            commands(lhs, rhs);
+   *          }
+   *
+   * Handlers taking and returning double scalars should use getScalarArg() and setScalarOutput().
+   *
+   * @tparam N The number of commands.
+   */
+  template<std::size_t N>
+  class CommandTable
+  {
+    static_assert(N > 0 && N < 0x8000, "a command table must have between 1 and 32767 commands");
+
+    public:
+      /// @brief The number of hash slots, a power of two with at most half of them used.
+      static constexpr std::size_t slotCount{std::bit_ceil(2 * N)};
+
+      /**
+       * @brief Constructor, evaluated at compile time. Invalid, reserved or duplicate names fail the compilation.
+       * @param commands The commands.
+       */
+      consteval explicit CommandTable(const Command (&commands)[N])
+      {
+        for (std::size_t k{}; k < N; ++k)
+        {
+          const std::string_view name = commands[k].name;
+
+          if (name.empty() || name.size() > detail::commandMaxLength || name.starts_with("matlabw:"))
+          {
+            throw "command names must be 1 to 63 characters long and must not start with 'matlabw:'";
+          }
+
+          if (commands[k].handler == nullptr || commands[k].minRhs > commands[k].maxRhs)
+          {
+            throw "commands must have a handler and a valid range of arguments";
+          }
+
+          for (std::size_t j{}; j < k; ++j)
+          {
+            if (commands[j].name == name)
+            {
+              throw "command names must be unique";
+            }
+          }
+
+          mCommands[k] = commands[k];
+          mMaxLength   = std::max(mMaxLength, name.size());
+        }
+
+        findSeed();
+      }
+
+      /**
+       * @brief Gets the number of commands.
+       * @return The number of commands.
+       */
+      [[nodiscard]] static constexpr std::size_t getCommandCount() noexcept
+      {
+        return N;
+      }
+
+      /**
+       * @brief Finds a command by name.
+       * @param name The name.
+       * @return The command, null if there is no command of that name.
+       */
+      [[nodiscard]] constexpr const Command* find(std::string_view name) const noexcept
+      {
+        return find(name.data(), name.size());
+      }
+
+      /**
+       * @brief Dispatches a call to the command named by the first argument.
+       * @param lhs Left-hand side arguments.
+       * @param rhs Right-hand side arguments, the command name followed by the arguments of the command.
+       */
+      void operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs) const
+      {
+        static constexpr char id[]{"matlabw:mex:CommandTable"};
+
+        if (rhs.empty() || !mxIsChar(rhs[0].get()))
+        {
+          throw mx::Exception{id, "first argument must be a command name"};
+        }
+
+        const std::size_t size    = mxGetNumberOfElements(rhs[0].get());
+        const Command*    command = find(static_cast<const char16_t*>(mxGetData(rhs[0].get())), size);
+
+        if (command == nullptr)
+        {
+          throw mx::Exception{id, "unknown command '" + mx::toAscii(mx::TypedArrayCref<char16_t>{rhs[0]}) + "'"};
+        }
+
+        const std::size_t argCount = rhs.size() - 1;
+
+        if (argCount < command->minRhs || argCount > command->maxRhs)
+        {
+          throw mx::Exception{id, "invalid number of arguments of command '" + std::string{command->name} + "'"};
+        }
+
+        if (lhs.size() > command->maxLhs)
+        {
+          throw mx::Exception{id, "too many outputs of command '" + std::string{command->name} + "'"};
+        }
+
+        command->handler(lhs, rhs.subspan(1));
+      }
+    private:
+      /// @brief Marks an empty slot.
+      static constexpr std::uint16_t emptySlot{0xffff};
+
+      /**
+       * @brief Finds a command by name.
+       * @tparam C The character type.
+       * @param str The characters of the name.
+       * @param size The number of characters.
+       * @return The command, null if there is no command of that name.
+       */
+      template<typename C>
+      [[nodiscard]] constexpr const Command* find(const C* str, std::size_t size) const noexcept
+      {
+        if (size == 0 || size > mMaxLength)
+        {
+          return nullptr;
+        }
+
+        const std::uint16_t index = mSlots[detail::hashCommand(mSeed, str, size) & (slotCount - 1)];
+
+        if (index == emptySlot)
+        {
+          return nullptr;
+        }
+
+        const Command& command = mCommands[index];
+
+        if (command.name.size() != size)
+        {
+          return nullptr;
+        }
+
+        for (std::size_t i{}; i < size; ++i)
+        {
+          if (static_cast<char16_t>(static_cast<unsigned char>(command.name[i])) != static_cast<char16_t>(str[i]))
+          {
+            return nullptr;
+          }
+        }
+
+        return &command;
+      }
+
+      /// @brief Finds a seed for which the names hash to distinct slots.
+      consteval void findSeed()
+      {
+        for (std::uint32_t seed{}; seed < 1u << 20; ++seed)
+        {
+          mSlots.fill(emptySlot);
+
+          bool collision{};
+
+          for (std::size_t k{}; k < N && !collision; ++k)
+          {
+            const std::string_view name = mCommands[k].name;
+            std::uint16_t&         slot = mSlots[detail::hashCommand(seed, name.data(), name.size()) & (slotCount - 1)];
+
+            collision = (slot != emptySlot);
+            slot      = static_cast<std::uint16_t>(k);
+          }
+
+          if (!collision)
+          {
+            mSeed = seed;
+            return;
+          }
+        }
+
+        throw "no perfect hash of the command names found";
+      }
+
+      std::array<Command, N>                 mCommands{};  ///< The commands.
+      std::array<std::uint16_t, slotCount>   mSlots{};     ///< Index of the command of each hash slot.
+      std::uint32_t                          mSeed{};      ///< The seed of the hash.
+      std::size_t                            mMaxLength{}; ///< Length of the longest name.
+  };
+
+  /**
+   * @brief Makes a command table at compile time, see CommandTable.
+   * @tparam N The number of commands.
+   * @param commands The commands.
+   * @return The command table.
+   */
+  template<std::size_t N>
+  [[nodiscard]] consteval CommandTable<N> makeCommandTable(const Command (&commands)[N])
+  {
+    return CommandTable<N>{commands};
+  }
+
+  /**
+   * @brief Gets a real double scalar argument with a minimal check.
+   * @param rhs The arguments.
+   * @param i The index of the argument.
+   * @return The value.
+   */
+  [[nodiscard]] inline double getScalarArg(mx::View<mx::ArrayCref> rhs, std::size_t i)
+  {
+    const mxArray* array = (i < rhs.size()) ? rhs[i].get() : nullptr;
+
+    if (array == nullptr || !mxIsDouble(array) || mxIsComplex(array) || mxIsSparse(array) ||
+        mxGetNumberOfElements(array) != 1)
+    {
+      throw mx::Exception{"matlabw:mex:getScalarArg", "argument must be a real double scalar"};
+    }
+
+    return *static_cast<const double*>(mxGetData(array));
+  }
+
+  /**
+   * @brief Sets a double scalar output, created by the cheapest allocation MATLAB offers.
+   * @param lhs The outputs.
+   * @param i The index of the output, nothing is set if it was not requested. The first output is always set.
+   * @param value The value.
+   */
+  inline void setScalarOutput(mx::Span<mx::Array> lhs, std::size_t i, double value)
+  {
+    // MATLAB passes one output slot for ans even if no output is requested.
+    if (i < std::max<std::size_t>(lhs.size(), 1))
+    {
+      lhs.data()[i] = mx::Array{mxCreateDoubleScalar(value)};
+    }
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_COMMAND_TABLE_HPP */
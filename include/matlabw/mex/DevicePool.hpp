@@ -0,0 +1,69 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_DEVICE_POOL_HPP
+#define MATLABW_MEX_DEVICE_POOL_HPP
+
+#include "detail/include.hpp"
+
+#include <matlabw/mx/gpu/DevicePool.hpp>
+#include <matlabw/mx/StructBinding.hpp>
+
+#include "atExit.hpp"
+
+/// @brief Binds the device pool statistics, so that mx::toArray() converts them to a MATLAB struct.
+MATLABW_STRUCT(matlabw::mx::gpu::DevicePoolStats,
+               bytesInUse, bytesCached, peakBytesInUse, allocationCount, cacheHitCount, deviceAllocCount);
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Gets the device pool shared by the whole MEX file. Its memory survives between MEX function calls and is
+   *        released when the MEX file is cleared or MATLAB exits. Requires GPU support and linking the CUDA runtime.
+   * @return The device pool.
+   */
+  [[nodiscard]] inline mx::gpu::DevicePool& getDevicePool()
+  {
+    static mx::gpu::DevicePool pool{};
+    static const bool          registered = (atExit([]{ pool.release(); }), true);
+
+    static_cast<void>(registered);
+
+    return pool;
+  }
+
+  /**
+   * @brief Frees the cached memory of the shared device pool and returns its statistics, e.g. for a 'trim' command of
+   *        a MEX function, so that MATLAB code can give the memory back to gpuDevice before a large allocation.
+   * @return The statistics after trimming as a MATLAB struct.
+   */
+  [[nodiscard]] inline mx::Array trimDevicePool()
+  {
+    getDevicePool().trim();
+
+    return mx::toArray(getDevicePool().getStats());
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_DEVICE_POOL_HPP */
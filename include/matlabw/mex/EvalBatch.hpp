@@ -0,0 +1,359 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_EVAL_BATCH_HPP
+#define MATLABW_MEX_EVAL_BATCH_HPP
+
+#include "detail/include.hpp"
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "eval.hpp"
+#include "variable.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Collects MATLAB statements and evaluates them with a single mexEvalString call, so a sequence of small
+   *        evaluations enters the interpreter once. Each statement is preceded by an assignment of its index to a
+   *        temporary variable of the caller workspace, a failed batch reports the statement which raised the error.
+   *        Statements after the failed one are not evaluated. Pending statements are discarded by the destructor,
+   *        call flush() to evaluate them.
+   */
+  class EvalBatch
+  {
+    public:
+      /// @brief Name of the temporary caller workspace variable holding the index of the evaluated statement.
+      static constexpr char indexVariable[]{"matlabw_eval_statement__"};
+
+      /**
+       * @brief Constructor.
+       * @param maxStatements The number of statements which triggers flush() from add(), 0 for no limit.
+       */
+      explicit EvalBatch(std::size_t maxStatements = 0)
+      : mMaxStatements{maxStatements}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      EvalBatch(const EvalBatch&) = delete;
+
+      /// @brief Move constructor.
+      EvalBatch(EvalBatch&&) noexcept = default;
+
+      /// @brief Destructor.
+      ~EvalBatch() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      EvalBatch& operator=(const EvalBatch&) = delete;
+
+      /// @brief Move assignment operator.
+      EvalBatch& operator=(EvalBatch&&) noexcept = default;
+
+      /**
+       * @brief Adds a statement, evaluates the batch if it reached the maximum number of statements.
+       * @param statement A complete MATLAB statement, may span multiple lines.
+       */
+      void add(std::string_view statement)
+      {
+        static constexpr char id[]{"matlabw:mex:EvalBatch:add"};
+
+        if (statement.find_first_not_of(" \t\r\n;") == std::string_view::npos)
+        {
+          throw mx::Exception{id, "statement must not be empty"};
+        }
+
+        mScript += indexVariable;
+        mScript += '=';
+        mScript += std::to_string(mStatements.size() + 1);
+        mScript += ";\n";
+
+        mStatements.push_back({mScript.size(), statement.size()});
+
+        mScript += statement;
+        mScript += '\n';
+
+        if (mMaxStatements != 0 && mStatements.size() >= mMaxStatements)
+        {
+          flush();
+        }
+      }
+
+      /**
+       * @brief Gets the number of pending statements.
+       * @return The number of pending statements.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mStatements.size();
+      }
+
+      /**
+       * @brief Checks if there are no pending statements.
+       * @return True if there are no pending statements.
+       */
+      [[nodiscard]] bool isEmpty() const noexcept
+      {
+        return mStatements.empty();
+      }
+
+      /**
+       * @brief Gets a pending statement.
+       * @param i The index of the statement.
+       * @return The statement, valid until the next modification of the batch.
+       */
+      [[nodiscard]] std::string_view getStatement(std::size_t i) const
+      {
+        const auto [offset, size] = mStatements.at(i);
+
+        return std::string_view{mScript}.substr(offset, size);
+      }
+
+      /// @brief Discards the pending statements.
+      void clear() noexcept
+      {
+        mScript.clear();
+        mStatements.clear();
+      }
+
+      /**
+       * @brief Evaluates the pending statements with a single mexEvalString call. The batch is empty afterwards, also
+       *        if the evaluation failed.
+       * @throw mx::Exception with the identifier of the MATLAB error and the message prefixed with the index and the
+       *        text of the failed statement.
+       */
+      void flush()
+      {
+        if (isEmpty())
+        {
+          return;
+        }
+
+        if (mStatements.size() == 1)
+        {
+          const std::string statement{getStatement(0)};
+
+          clear();
+          eval(statement.c_str());
+          return;
+        }
+
+        mScript += "clear ";
+        mScript += indexVariable;
+
+        CallStatus status{};
+
+        {
+          mx::ProfileZone zone{"mexEvalString", "matlab"};
+
+          status = CallStatus{mexEvalStringWithTrap(mScript.c_str())};
+        }
+
+        if (status.isOk())
+        {
+          clear();
+          return;
+        }
+
+        const std::size_t failed = getFailedIndex();
+
+        std::string message{"statement "};
+        message += std::to_string(failed + 1);
+
+        if (failed < mStatements.size())
+        {
+          message += " (";
+          message += getStatement(failed);
+          message += ')';
+        }
+
+        message += " failed: ";
+        message += status.getMessage();
+
+        clear();
+
+        throw mx::Exception{status.getIdentifier(), message};
+      }
+    private:
+      /**
+       * @brief Gets the index of the failed statement and removes the index variable from the caller workspace.
+       * @return The index of the failed statement, the number of statements if it is unknown.
+       */
+      [[nodiscard]] std::size_t getFailedIndex() const
+      {
+        std::size_t index{mStatements.size()};
+
+        if (const auto variable = getVariableCref(Workspace::caller, indexVariable))
+        {
+          if (variable->isNumeric() && variable->getSize() == 1)
+          {
+            index = variable->getScalarAs<std::size_t>() - 1;
+          }
+
+          static const std::string clearCommand{std::string{"clear "} + indexVariable};
+
+          CallStatus{mexEvalStringWithTrap(clearCommand.c_str())};
+        }
+
+        return index;
+      }
+
+      /// @brief Position of a statement in the script.
+      struct Statement
+      {
+        std::size_t offset; ///< Offset of the statement text.
+        std::size_t size;   ///< Size of the statement text.
+      };
+
+      std::size_t            mMaxStatements{}; ///< The number of statements triggering flush(), 0 for no limit.
+      std::string            mScript{};        ///< The joined statements.
+      std::vector<Statement> mStatements{};    ///< The pending statements.
+  };
+
+  /**
+   * @brief Repeated MATLAB statement template compiled once into an anonymous function and called with arguments
+   *        through a Callable, instead of formatting and parsing a new eval string for each call. The body sees only
+   *        its parameters, variables of the caller workspace are not captured. Must not outlive the MEX function call.
+   */
+  class EvalTemplate
+  {
+    public:
+      /**
+       * @brief Constructor, creates the anonymous function with str2func.
+       * @param parameters The parameter names.
+       * @param body The expression of the anonymous function, e.g. set(h, 'YData', y).
+       * @param outputCount The number of outputs, 0 for statements without a result.
+       */
+      EvalTemplate(std::initializer_list<std::string_view> parameters, std::string_view body,
+                   std::size_t outputCount = 0)
+      : mFunction{makeFunction(parameters, body)}, mCallable{mFunction, parameters.size(), outputCount}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      EvalTemplate(const EvalTemplate&) = delete;
+
+      /// @brief Explicitly deleted move constructor, the callable refers to the owned function handle.
+      EvalTemplate(EvalTemplate&&) = delete;
+
+      /// @brief Destructor.
+      ~EvalTemplate() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      EvalTemplate& operator=(const EvalTemplate&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      EvalTemplate& operator=(EvalTemplate&&) = delete;
+
+      /**
+       * @brief Gets the anonymous function handle.
+       * @return The function handle.
+       */
+      [[nodiscard]] mx::ArrayCref getFunction() const noexcept
+      {
+        return mFunction;
+      }
+
+      /**
+       * @brief Gets the callable, its inputs may be updated in place between calls.
+       * @return The callable.
+       */
+      [[nodiscard]] Callable& getCallable() noexcept
+      {
+        return mCallable;
+      }
+
+      /**
+       * @brief Calls the function with the inputs kept from the previous calls, see Callable::operator()().
+       * @return The outputs, they may be moved out.
+       */
+      mx::Span<mx::Array> operator()()
+      {
+        return mCallable();
+      }
+
+      /**
+       * @brief Sets all inputs and calls the function.
+       * @param inputs The inputs, one per parameter.
+       * @return The outputs, they may be moved out.
+       */
+      template<typename... Inputs>
+        requires (std::same_as<Inputs, mx::Array> && ...)
+      mx::Span<mx::Array> operator()(Inputs&&... inputs)
+      {
+        static constexpr char id[]{"matlabw:mex:EvalTemplate:invalidInputCount"};
+
+        if (sizeof...(Inputs) != mCallable.getInputCount())
+        {
+          throw mx::Exception{id, "number of inputs does not match the number of parameters"};
+        }
+
+        std::size_t i{};
+
+        (mCallable.setInput(i++, std::move(inputs)), ...);
+
+        return mCallable();
+      }
+    private:
+      /**
+       * @brief Creates the anonymous function.
+       * @param parameters The parameter names.
+       * @param body The expression of the anonymous function.
+       * @return The function handle.
+       */
+      [[nodiscard]] static mx::Array makeFunction(std::initializer_list<std::string_view> parameters,
+                                                  std::string_view                        body)
+      {
+        std::string source{"@("};
+
+        for (auto it = parameters.begin(); it != parameters.end(); ++it)
+        {
+          if (it != parameters.begin())
+          {
+            source += ',';
+          }
+
+          source += *it;
+        }
+
+        source += ") ";
+        source += body;
+
+        mx::Array function{};
+        mx::Array text = mx::makeCharArray(std::string_view{source});
+
+        const mx::ArrayCref rhs[]{text};
+
+        call({&function, 1}, rhs, "str2func");
+
+        return function;
+      }
+
+      mx::Array mFunction; ///< The anonymous function handle.
+      Callable  mCallable; ///< The callable of the function.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_EVAL_BATCH_HPP */
@@ -27,6 +27,10 @@
 
 #include "detail/include.hpp"
 
+#include "detail/CallScope.hpp"
+#include "profile.hpp"
+#include "State.hpp"
+
 namespace matlabw::mex
 {
   /// @brief Function object that wraps the user-defined function.
@@ -98,15 +102,20 @@ mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
   using namespace matlabw;
   
+  // Static buffers for the error id and message, they outlive the exception object without allocating.
+  static char errorIdBuffer[mx::StaticException::idCapacity]{};
+  static char errorMsgBuffer[mx::StaticException::messageCapacity]{};
+
   const char* errorId{};  // Error ID string
   const char* errorMsg{}; // Error message string
 
-  // Helper function to assign error id and message. Pointer needn't be freed.
-  auto assignErrorStr = [](const char*& dst, const char* src)
+  // Helper function to assign error id and message. Strings that do not fit the static buffer are copied to memory
+  // allocated by MATLAB. Pointer needn't be freed.
+  auto assignErrorStr = [](const char*& dst, const char* src, mx::Span<char> buffer)
   {
     const std::size_t size = std::char_traits<char>::length(src);
 
-    auto dstPtr = static_cast<char*>(mx::malloc(size + 1));
+    auto dstPtr = (size < buffer.size()) ? buffer.data() : static_cast<char*>(mx::malloc(size + 1));
 
     if (dstPtr != nullptr)
     {
@@ -122,6 +131,26 @@ mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     static_assert(sizeof(mxArray*) == sizeof(mx::Array));
     static_assert(sizeof(const mxArray*) == sizeof(mx::ArrayCref));
 
+    // Measures the whole call including the release of per-call resources, nothing when profiling is disabled.
+    mx::ProfileZone callZone{"mexFunction", "mex"};
+
+    // Releases per-call resources when the call ends or an exception is thrown.
+    mex::detail::CallScope callScope{};
+
+    // The reserved command resets the states instead of calling the function.
+    if (mex::detail::isResetStateCommand(nlhs, nrhs, prhs))
+    {
+      mex::detail::resetStates();
+      return;
+    }
+
+    // The reserved command writes the profile instead of calling the function.
+    if (mex::detail::isWriteProfileCommand(nlhs, nrhs, prhs))
+    {
+      mex::writeProfile(mx::toUtf8(mx::ArrayCref{prhs[1]}).c_str());
+      return;
+    }
+
     // Call the user-defined function.
     mex::Function{}(mx::Span<mx::Array>(reinterpret_cast<mx::Array*>(plhs), static_cast<std::size_t>(nlhs)),
                     mx::View<mx::ArrayCref>(reinterpret_cast<mx::ArrayCref*>(prhs), static_cast<std::size_t>(nrhs)));
@@ -133,15 +162,15 @@ mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   {
     if (e.hasId())
     {
-      assignErrorStr(errorId, e.id());
+      assignErrorStr(errorId, e.id(), errorIdBuffer);
     }
     
-    assignErrorStr(errorMsg, e.what());
+    assignErrorStr(errorMsg, e.what(), errorMsgBuffer);
   }
   catch (const std::exception& e)
   {
     errorId = "mex:std";
-    assignErrorStr(errorMsg, e.what());
+    assignErrorStr(errorMsg, e.what(), errorMsgBuffer);
   }
   catch (...)
   {
@@ -161,7 +190,7 @@ mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   }
   else
   {
-    mexErrMsgIdAndTxt(errorId, errorMsg);
+    mexErrMsgIdAndTxt(errorId, "%s", errorMsg);
   }
 }
 
@@ -0,0 +1,49 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_GRAPH_CACHE_HPP
+#define MATLABW_MEX_GRAPH_CACHE_HPP
+
+#include "detail/include.hpp"
+
+#include <matlabw/mx/gpu/GraphCache.hpp>
+
+#include "State.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Gets the CUDA graph cache shared by the whole MEX file. It is a State, so the graphs survive between MEX
+   *        function calls and are destroyed by the reset command, when the MEX file is cleared or when MATLAB exits.
+   *        Requires GPU support and linking the CUDA runtime. Must be used from the MATLAB thread only.
+   * @param maxGraphs Maximum number of cached graphs, used only when the cache is constructed.
+   * @return The graph cache.
+   */
+  [[nodiscard]] inline mx::gpu::GraphCache& getGraphCache(std::size_t maxGraphs = 64)
+  {
+    return State<mx::gpu::GraphCache>::get(maxGraphs);
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_GRAPH_CACHE_HPP */
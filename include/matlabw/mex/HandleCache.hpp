@@ -0,0 +1,53 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_HANDLE_CACHE_HPP
+#define MATLABW_MEX_HANDLE_CACHE_HPP
+
+#include "detail/include.hpp"
+
+#include <matlabw/mx/gpu/HandleCache.hpp>
+
+#include "atExit.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Gets the cuBLAS and cuFFT handle cache shared by the whole MEX file. Handles and plans survive between MEX
+   *        function calls and are destroyed when the MEX file is cleared or MATLAB exits. Requires GPU support and
+   *        linking cuBLAS and cuFFT, see the matlabw::matlabw-gpu-math target.
+   * @return The handle cache.
+   */
+  [[nodiscard]] inline mx::gpu::HandleCache& getHandleCache()
+  {
+    static mx::gpu::HandleCache cache{};
+    static const bool           registered = (atExit([]{ cache.release(); }), true);
+
+    static_cast<void>(registered);
+
+    return cache;
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_HANDLE_CACHE_HPP */
@@ -0,0 +1,297 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_IN_PLACE_HPP
+#define MATLABW_MEX_IN_PLACE_HPP
+
+#include "detail/include.hpp"
+
+#include <memory>
+
+#include "ObjectRegistry.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Array owned by the MEX file which survives between MEX function calls. Registered in the buffer registry,
+   *        it is referenced from MATLAB by a handle and serves as a donated input or a reusable output, so large
+   *        results can be produced without a fresh allocation per call. Must be used from the MATLAB thread only.
+   */
+  class PersistentArray
+  {
+    public:
+      /**
+       * @brief Constructor. Takes the ownership of an array and makes it persistent.
+       * @param array The array.
+       * @throws mx::Exception if the array is not valid.
+       */
+      explicit PersistentArray(mx::Array&& array)
+      {
+        reset(std::move(array));
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      PersistentArray(const PersistentArray&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      PersistentArray(PersistentArray&&) = delete;
+
+      /// @brief Destructor. Destroys the array.
+      ~PersistentArray() noexcept
+      {
+        mxDestroyArray(mArray);
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      PersistentArray& operator=(const PersistentArray&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      PersistentArray& operator=(PersistentArray&&) = delete;
+
+      /**
+       * @brief Gets a reference to the array.
+       * @return The reference.
+       */
+      [[nodiscard]] mx::ArrayRef getRef() noexcept
+      {
+        return mx::ArrayRef{mArray};
+      }
+
+      /**
+       * @brief Gets a reference to the array.
+       * @return The reference.
+       */
+      [[nodiscard]] mx::ArrayCref getCref() const noexcept
+      {
+        return mx::ArrayCref{mArray};
+      }
+
+      /**
+       * @brief Replaces the array.
+       * @param array The new array.
+       * @throws mx::Exception if the array is not valid.
+       */
+      void reset(mx::Array&& array)
+      {
+        if (!array.isValid())
+        {
+          throw mx::Exception{"matlabw:mex:PersistentArray:reset", "array must be valid"};
+        }
+
+        mxArray* ptr = array.release();
+
+        mexMakeArrayPersistent(ptr);
+
+        mxDestroyArray(std::exchange(mArray, ptr));
+      }
+
+      /**
+       * @brief Gets the array as an output buffer of a class and shape. The storage is reused if the class and the
+       *        number of elements match, the array is only reshaped then. Otherwise it is replaced by an uninitialized
+       *        array. The contents are undefined in both cases.
+       * @param desc The descriptor of the output.
+       * @return The reference to the buffer.
+       */
+      mx::ArrayRef ensure(const mx::ArrayDesc& desc)
+      {
+        if (canHold(desc))
+        {
+          getRef().resize(desc.getDims());
+        }
+        else
+        {
+          reset(mx::makeUninitArray(desc));
+        }
+
+        return getRef();
+      }
+
+      /**
+       * @brief Checks if the storage of the array can hold an output without reallocation.
+       * @param desc The descriptor of the output.
+       * @return True if the class and the number of elements match and the array is not sparse.
+       */
+      [[nodiscard]] bool canHold(const mx::ArrayDesc& desc) const
+      {
+        const mx::ArrayDesc current{getCref()};
+
+        return current.hasSameType(desc) && current.getSize() == desc.getSize() && !mxIsSparse(mArray);
+      }
+
+      /**
+       * @brief Makes a copy of the array which can be returned to MATLAB.
+       * @return The copy.
+       */
+      [[nodiscard]] mx::Array duplicate() const
+      {
+        return mx::Array{getCref()};
+      }
+
+    private:
+      mxArray* mArray{}; ///< The persistent array
+  };
+
+  /// @brief Registry of the persistent arrays of the MEX file.
+  using BufferRegistry = ObjectRegistry<PersistentArray>;
+
+  /**
+   * @brief Gets the buffer registry shared by the whole MEX file.
+   * @return The registry.
+   */
+  [[nodiscard]] inline BufferRegistry& getBufferRegistry()
+  {
+    return getObjectRegistry<PersistentArray>();
+  }
+
+  /**
+   * @brief Makes a dispatcher managing the buffers from MATLAB:
+   *
+   *          h = myfunc('new', x)     copies x into a new buffer and returns its handle
+   *          x = myfunc('get', h)     returns a copy of the buffer
+   *          myfunc('delete', h)      destroys the buffer
+   *
+   *        More commands operating on the buffers may be added to the returned dispatcher.
+   * @param registry The buffer registry.
+   * @return The dispatcher.
+   */
+  [[nodiscard]] inline MethodDispatcher<PersistentArray> makeBufferDispatcher(BufferRegistry& registry
+                                                                                = getBufferRegistry())
+  {
+    MethodDispatcher<PersistentArray> dispatcher{[](mx::View<mx::ArrayCref> rhs)
+    {
+      if (rhs.size() != 1)
+      {
+        throw mx::Exception{"matlabw:mex:BufferDispatcher", "'new' requires exactly one array"};
+      }
+
+      return std::make_unique<PersistentArray>(mx::Array{rhs[0]});
+    }, registry};
+
+    dispatcher.add("get", [](PersistentArray& buffer, mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref>)
+    {
+      if (!lhs.empty())
+      {
+        lhs[0] = buffer.duplicate();
+      }
+    });
+
+    return dispatcher;
+  }
+
+  /**
+   * @brief Argument of an operation which may run in place. MATLAB semantics forbid modifying the inputs, so in place
+   *        operation is opt-in: the caller donates a buffer by passing its handle instead of an array. Then the input
+   *        is the buffer, the output is written into the same buffer and the handle is returned, with no allocation.
+   *        A plain array argument is read as input and a fresh output is allocated. The kernel must therefore allow
+   *        the output to alias the input. If the donated buffer does not match the output class and number of
+   *        elements, the output is allocated and replaces the buffer in finish().
+   *
+   *          mex::InPlaceArgument arg{rhs[0]};
+   *          auto in  = arg.getInput();
+   *          auto out = arg.getOutput(mx::ArrayDesc{in});
+   *          kernel(in, out);
+   *          lhs[0] = arg.finish();
+   */
+  class InPlaceArgument
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param arg The argument, a buffer handle (a uint64 scalar) or an array.
+       * @param registry The buffer registry.
+       */
+      explicit InPlaceArgument(mx::ArrayCref arg, BufferRegistry& registry = getBufferRegistry())
+      : mArg{arg}
+      {
+        if (arg.isUint64() && !arg.isComplex() && arg.getSize() == 1)
+        {
+          mHandle = toHandle(arg);
+          mBuffer = &registry.get(mHandle);
+        }
+      }
+
+      /**
+       * @brief Checks if the argument is a donated buffer.
+       * @return True if the operation runs in place.
+       */
+      [[nodiscard]] bool isDonated() const noexcept
+      {
+        return mBuffer != nullptr;
+      }
+
+      /**
+       * @brief Gets the input array, the donated buffer or the argument.
+       * @return The input.
+       */
+      [[nodiscard]] mx::ArrayCref getInput() const noexcept
+      {
+        return (mBuffer != nullptr) ? mBuffer->getCref() : mArg;
+      }
+
+      /**
+       * @brief Gets the output array. A compatible donated buffer is reshaped and returned, so the output aliases the
+       *        input. Otherwise an uninitialized array is allocated.
+       * @param desc The descriptor of the output.
+       * @return The output.
+       */
+      [[nodiscard]] mx::ArrayRef getOutput(const mx::ArrayDesc& desc)
+      {
+        if (mBuffer != nullptr && mBuffer->canHold(desc))
+        {
+          return mBuffer->ensure(desc);
+        }
+
+        mOutput = mx::makeUninitArray(desc);
+
+        return mx::ArrayRef{mOutput.get()};
+      }
+
+      /**
+       * @brief Finishes the operation.
+       * @return The handle of the donated buffer or the fresh output.
+       */
+      [[nodiscard]] mx::Array finish()
+      {
+        if (mBuffer == nullptr)
+        {
+          return std::move(mOutput);
+        }
+
+        if (mOutput.isValid())
+        {
+          mBuffer->reset(std::move(mOutput));
+        }
+
+        return toHandleArray(mHandle);
+      }
+
+    private:
+      mx::ArrayCref    mArg;       ///< The argument
+      PersistentArray* mBuffer{};  ///< The donated buffer, null for array arguments
+      ObjectHandle     mHandle{};  ///< The handle of the donated buffer
+      mx::Array        mOutput{};  ///< The fresh output
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_IN_PLACE_HPP */
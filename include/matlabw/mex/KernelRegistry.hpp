@@ -0,0 +1,689 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MEX_KERNEL_REGISTRY_HPP
+#define MATLABW_MEX_KERNEL_REGISTRY_HPP
+
+#include "detail/include.hpp"
+
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+#include <matlabw/mx/algorithm/elementwise.hpp>
+#include <matlabw/mx/algorithm/reduce.hpp>
+
+#include "State.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Key of a tuned choice, the operation and the class and size bucket of its array.
+  struct TuningKey
+  {
+    std::string    operation{};  ///< Name of the operation.
+    mx::ClassId    classId{};    ///< Class of the array.
+    mx::Complexity complexity{}; ///< Complexity of the array.
+    std::uint32_t  sizeBucket{}; ///< Bucket of the number of elements, the bit width of the number.
+
+    /// @brief Compares keys, ordered by operation first.
+    auto operator<=>(const TuningKey&) const = default;
+  };
+
+  /**
+   * @brief Table of the fastest candidate of every tuned operation and size bucket. The table can be saved to a text
+   *        file and loaded by a later session, the file is ignored if it was written on a machine with a different
+   *        instruction set or number of hardware threads.
+   */
+  class TuningTable
+  {
+    public:
+      /**
+       * @brief Finds the tuned candidate of a key.
+       * @param key The key.
+       * @return The name of the candidate, nullptr if the key is not tuned.
+       */
+      [[nodiscard]] const std::string* find(const TuningKey& key) const
+      {
+        const auto it = mEntries.find(key);
+
+        return (it != mEntries.end()) ? &it->second : nullptr;
+      }
+
+      /**
+       * @brief Sets the tuned candidate of a key.
+       * @param key The key.
+       * @param candidate The name of the candidate.
+       */
+      void set(const TuningKey& key, std::string_view candidate)
+      {
+        mEntries.insert_or_assign(key, std::string{candidate});
+        mModified = true;
+      }
+
+      /// @brief Removes all entries, the next calls tune again.
+      void clear() noexcept
+      {
+        mModified = mModified || !mEntries.empty();
+        mEntries.clear();
+      }
+
+      /**
+       * @brief Gets the number of tuned keys.
+       * @return The number of keys.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mEntries.size();
+      }
+
+      /**
+       * @brief Checks if entries were set since the table was loaded or saved.
+       * @return True if modified.
+       */
+      [[nodiscard]] bool isModified() const noexcept
+      {
+        return mModified;
+      }
+
+      /**
+       * @brief Loads the entries of a file, keeping entries not in the file.
+       * @param path The path of the file.
+       * @return True if the file was loaded, false if it does not exist or was written on another machine.
+       */
+      bool load(const std::string& path)
+      {
+        std::ifstream file{path};
+        std::string   line{};
+
+        if (!file || !std::getline(file, line) || line != getHeader())
+        {
+          return false;
+        }
+
+        while (std::getline(file, line))
+        {
+          std::istringstream fields{line};
+          TuningKey          key{};
+          int                classId{};
+          int                complexity{};
+          std::string        candidate{};
+
+          // Malformed lines are skipped, their keys are tuned again.
+          if (fields >> key.operation >> classId >> complexity >> key.sizeBucket >> candidate)
+          {
+            key.classId    = static_cast<mx::ClassId>(classId);
+            key.complexity = static_cast<mx::Complexity>(complexity);
+
+            mEntries.insert_or_assign(std::move(key), std::move(candidate));
+          }
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Saves the entries to a file. The file is written next to the target and renamed over it, so a
+       *        concurrent session never reads a partial table.
+       * @param path The path of the file.
+       */
+      void save(const std::string& path)
+      {
+        static constexpr char id[]{"matlabw:mex:TuningTable:save"};
+
+        const std::string temp = path + ".tmp";
+
+        {
+          std::ofstream file{temp, std::ios::trunc};
+
+          file << getHeader() << '\n';
+
+          for (const auto& [key, candidate] : mEntries)
+          {
+            file << key.operation << ' ' << static_cast<int>(key.classId) << ' ' << static_cast<int>(key.complexity)
+                 << ' ' << key.sizeBucket << ' ' << candidate << '\n';
+          }
+
+          if (!file.flush())
+          {
+            throw mx::Exception{id, "failed to write tuning file"};
+          }
+        }
+
+        if (std::rename(temp.c_str(), path.c_str()) != 0)
+        {
+          std::remove(temp.c_str());
+          throw mx::Exception{id, "failed to replace tuning file"};
+        }
+
+        mModified = false;
+      }
+    private:
+      /**
+       * @brief Gets the first line of a tuning file, identifies the format and the machine.
+       * @return The header.
+       */
+      [[nodiscard]] static std::string getHeader()
+      {
+        return "matlabw-tuning 1 " + std::to_string(static_cast<int>(mx::getSimdLevel())) + ' '
+               + std::to_string(std::thread::hardware_concurrency());
+      }
+
+      std::map<TuningKey, std::string> mEntries{};  ///< Tuned candidates by key.
+      bool                             mModified{}; ///< Whether entries were set since the last load or save.
+  };
+
+namespace detail
+{
+  /// @brief Type-erased base of the operations of a KernelRegistry.
+  class KernelOperationBase
+  {
+    public:
+      /// @brief Default constructor.
+      KernelOperationBase() = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      KernelOperationBase(const KernelOperationBase&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      KernelOperationBase(KernelOperationBase&&) = delete;
+
+      /// @brief Virtual destructor.
+      virtual ~KernelOperationBase() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      KernelOperationBase& operator=(const KernelOperationBase&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      KernelOperationBase& operator=(KernelOperationBase&&) = delete;
+  };
+
+  /**
+   * @brief Checks a name of an operation or a candidate, stored as a word of the tuning file.
+   * @param name The name.
+   */
+  inline void checkKernelName(std::string_view name)
+  {
+    if (name.empty() || name.find_first_of(" \t\r\n") != std::string_view::npos)
+    {
+      throw mx::Exception{"matlabw:mex:KernelRegistry", "kernel names must be non-empty and without whitespace"};
+    }
+  }
+} // namespace detail
+
+  /// @brief Default number of timed runs of every candidate, the fastest run counts.
+  inline constexpr std::size_t defaultTuningRuns{3};
+
+  /// @brief Checks if a candidate supports an array, e.g. a GPU kernel only gpuArray inputs.
+  using KernelPredicate = bool (*)(const mx::ArrayDesc& desc);
+
+  /**
+   * @brief Operation with several implementations, e.g. scalar, SIMD, threaded and GPU kernels. See KernelRegistry.
+   * @tparam Signature Function type of the candidates.
+   */
+  template<typename Signature>
+  class KernelOperation;
+
+  /**
+   * @brief Operation with several implementations. The first call for a class and size bucket runs every supporting
+   *        candidate with the arguments of the call, keeps the fastest one in the tuning table and calls it from then
+   *        on. The candidates must compute the same result and may be called several times with the same arguments,
+   *        so outputs must be overwritten, not accumulated. Must be used from the MATLAB thread only.
+   * @tparam R Result type.
+   * @tparam Args Argument types, not rvalue references.
+   */
+  template<typename R, typename... Args>
+  class KernelOperation<R(Args...)> final : public detail::KernelOperationBase
+  {
+    static_assert(!(std::is_rvalue_reference_v<Args> || ...), "candidates must not consume their arguments");
+
+    public:
+      using Function = std::function<R(Args...)>; ///< Type of the candidates.
+
+      /**
+       * @brief Constructor.
+       * @param name The name of the operation.
+       * @param table The tuning table.
+       * @param tuningRuns Number of timed runs of every candidate.
+       */
+      KernelOperation(std::string_view name, TuningTable& table, std::size_t tuningRuns)
+      : mName{name}, mTable{&table}, mTuningRuns{std::max<std::size_t>(tuningRuns, 1)}
+      {}
+
+      /**
+       * @brief Gets the name.
+       * @return The name.
+       */
+      [[nodiscard]] const std::string& getName() const noexcept
+      {
+        return mName;
+      }
+
+      /**
+       * @brief Gets the number of candidates.
+       * @return The number of candidates.
+       */
+      [[nodiscard]] std::size_t getCandidateCount() const noexcept
+      {
+        return mCandidates.size();
+      }
+
+      /**
+       * @brief Adds a candidate, replacing the one of the same name.
+       * @param name The name of the candidate, stored in the tuning table.
+       * @param fn The implementation.
+       * @param supports The predicate of the supported arrays, nullptr for all arrays.
+       */
+      void add(std::string_view name, Function fn, KernelPredicate supports = nullptr)
+      {
+        detail::checkKernelName(name);
+
+        if (!fn)
+        {
+          throw mx::Exception{"matlabw:mex:KernelOperation:add", "candidate must not be empty"};
+        }
+
+        for (Candidate& candidate : mCandidates)
+        {
+          if (candidate.name == name)
+          {
+            candidate.fn       = std::move(fn);
+            candidate.supports = supports;
+            return;
+          }
+        }
+
+        mCandidates.push_back(Candidate{std::string{name}, std::move(fn), supports});
+      }
+
+      /**
+       * @brief Gets the candidate chosen for an array, tuning it with the arguments if the bucket is not tuned yet.
+       * @param desc The descriptor of the array selecting the bucket.
+       * @param args The arguments of the timed runs.
+       * @return The name of the candidate.
+       */
+      [[nodiscard]] const std::string& select(const mx::ArrayDesc& desc, Args... args)
+      {
+        return choose(desc, args...).name;
+      }
+
+      /**
+       * @brief Calls the fastest candidate for an array.
+       * @param desc The descriptor of the array selecting the bucket, usually the largest argument.
+       * @param args The arguments.
+       * @return The result of the candidate.
+       */
+      R operator()(const mx::ArrayDesc& desc, Args... args)
+      {
+        return std::invoke(choose(desc, args...).fn, std::forward<Args>(args)...);
+      }
+    private:
+      /// @brief Implementation of the operation.
+      struct Candidate
+      {
+        std::string     name{};     ///< The name.
+        Function        fn{};       ///< The implementation.
+        KernelPredicate supports{}; ///< Predicate of the supported arrays, nullptr for all arrays.
+      };
+
+      /**
+       * @brief Makes the tuning key of an array.
+       * @param desc The descriptor of the array.
+       * @return The key.
+       */
+      [[nodiscard]] TuningKey makeKey(const mx::ArrayDesc& desc) const
+      {
+        return TuningKey{mName, desc.getClassId(), desc.getComplexity(),
+                         static_cast<std::uint32_t>(std::bit_width(desc.getSize()))};
+      }
+
+      /**
+       * @brief Checks if a candidate supports an array.
+       * @param candidate The candidate.
+       * @param desc The descriptor of the array.
+       * @return True if supported.
+       */
+      [[nodiscard]] static bool isSupported(const Candidate& candidate, const mx::ArrayDesc& desc)
+      {
+        return candidate.supports == nullptr || candidate.supports(desc);
+      }
+
+      /**
+       * @brief Chooses the candidate for an array, tunes the bucket on its first use.
+       * @param desc The descriptor of the array.
+       * @param args The arguments of the timed runs.
+       * @return The candidate.
+       */
+      [[nodiscard]] const Candidate& choose(const mx::ArrayDesc& desc, Args&... args)
+      {
+        const TuningKey key = makeKey(desc);
+
+        // A tuned name of a candidate which is gone or does not support the array is tuned again.
+        if (const std::string* tuned = mTable->find(key))
+        {
+          for (const Candidate& candidate : mCandidates)
+          {
+            if (candidate.name == *tuned && isSupported(candidate, desc))
+            {
+              return candidate;
+            }
+          }
+        }
+
+        return tune(key, desc, args...);
+      }
+
+      /**
+       * @brief Times the supporting candidates and stores the fastest one.
+       * @param key The tuning key.
+       * @param desc The descriptor of the array.
+       * @param args The arguments of the timed runs.
+       * @return The fastest candidate.
+       */
+      [[nodiscard]] const Candidate& tune(const TuningKey& key, const mx::ArrayDesc& desc, Args&... args)
+      {
+        std::vector<const Candidate*> supported{};
+
+        for (const Candidate& candidate : mCandidates)
+        {
+          if (isSupported(candidate, desc))
+          {
+            supported.push_back(&candidate);
+          }
+        }
+
+        if (supported.empty())
+        {
+          throw mx::Exception{"matlabw:mex:KernelOperation", "no candidate supports the array"};
+        }
+
+        const Candidate* best = supported.front();
+
+        if (supported.size() > 1)
+        {
+          auto bestTime = std::chrono::steady_clock::duration::max();
+
+          for (const Candidate* candidate : supported)
+          {
+            for (std::size_t run{}; run < mTuningRuns; ++run)
+            {
+              const auto start = std::chrono::steady_clock::now();
+
+              static_cast<void>(std::invoke(candidate->fn, args...));
+
+              const auto time = std::chrono::steady_clock::now() - start;
+
+              if (time < bestTime)
+              {
+                bestTime = time;
+                best     = candidate;
+              }
+            }
+          }
+        }
+
+        mTable->set(key, best->name);
+
+        return *best;
+      }
+
+      std::string            mName{};       ///< The name of the operation.
+      TuningTable*           mTable{};      ///< The tuning table.
+      std::size_t            mTuningRuns{}; ///< Number of timed runs of every candidate.
+      std::vector<Candidate> mCandidates{}; ///< The candidates.
+  };
+
+  /**
+   * @brief Registry of operations with several implementations, each chosen per class and size bucket by timing the
+   *        candidates on the first call instead of hardcoded thresholds. The buckets are powers of two of the number
+   *        of elements. Operations are identified by name and signature, so the same name can be registered for
+   *        several element types. Keep the registry in a mex::State, see getKernelRegistry(), so the tuning survives
+   *        between calls, and give it a tuning file so later sessions start tuned:
+   *
+   *          auto& registry = mex::getKernelRegistry("/tmp/myfunc.tuning");
+   *          mex::registerAlgorithmKernels<double>(registry);
+   *
+   *          auto& add = registry.getOperation<mex::BinaryKernel<double>>("add");
+   *          add(mx::ArrayDesc{rhs[0]}, out, a, b);
+   *
+   *        Must be used from the MATLAB thread only.
+   */
+  class KernelRegistry
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param tuningFile The path of the tuning file loaded now and saved on destruction, empty to not persist.
+       * @param tuningRuns Number of timed runs of every candidate.
+       */
+      explicit KernelRegistry(std::string tuningFile = {}, std::size_t tuningRuns = defaultTuningRuns)
+      : mTuningFile{std::move(tuningFile)}, mTuningRuns{tuningRuns}
+      {
+        if (!mTuningFile.empty())
+        {
+          mTable.load(mTuningFile);
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      KernelRegistry(const KernelRegistry&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      KernelRegistry(KernelRegistry&&) = delete;
+
+      /// @brief Destructor. Saves the tuning table if it was modified, errors are ignored.
+      ~KernelRegistry() noexcept
+      {
+        if (!mTuningFile.empty() && mTable.isModified())
+        {
+          try
+          {
+            mTable.save(mTuningFile);
+          }
+          catch (...)
+          {}
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      KernelRegistry& operator=(const KernelRegistry&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      KernelRegistry& operator=(KernelRegistry&&) = delete;
+
+      /**
+       * @brief Gets an operation, creates it without candidates on the first call. The reference stays valid for the
+       *        lifetime of the registry, so hot paths should keep it instead of looking the operation up per call.
+       * @tparam Signature Function type of the candidates.
+       * @param name The name of the operation.
+       * @return The operation.
+       */
+      template<typename Signature>
+      [[nodiscard]] KernelOperation<Signature>& getOperation(std::string_view name)
+      {
+        OperationKey key{std::string{name}, std::type_index{typeid(Signature)}};
+
+        auto it = mOperations.find(key);
+
+        if (it == mOperations.end())
+        {
+          detail::checkKernelName(name);
+
+          it = mOperations.emplace(std::move(key),
+                                   std::make_unique<KernelOperation<Signature>>(name, mTable, mTuningRuns)).first;
+        }
+
+        return static_cast<KernelOperation<Signature>&>(*it->second);
+      }
+
+      /**
+       * @brief Adds a candidate to an operation.
+       * @tparam Signature Function type of the candidates.
+       * @param operation The name of the operation.
+       * @param candidate The name of the candidate.
+       * @param fn The implementation.
+       * @param supports The predicate of the supported arrays, nullptr for all arrays.
+       * @return The operation.
+       */
+      template<typename Signature>
+      KernelOperation<Signature>& add(std::string_view                              operation,
+                                      std::string_view                              candidate,
+                                      typename KernelOperation<Signature>::Function fn,
+                                      KernelPredicate                               supports = nullptr)
+      {
+        KernelOperation<Signature>& op = getOperation<Signature>(operation);
+
+        op.add(candidate, std::move(fn), supports);
+
+        return op;
+      }
+
+      /**
+       * @brief Gets the tuning table.
+       * @return The tuning table.
+       */
+      [[nodiscard]] TuningTable& getTuningTable() noexcept
+      {
+        return mTable;
+      }
+
+      /**
+       * @brief Gets the path of the tuning file.
+       * @return The path, empty if the table is not persisted.
+       */
+      [[nodiscard]] const std::string& getTuningFile() const noexcept
+      {
+        return mTuningFile;
+      }
+
+      /// @brief Saves the tuning table to the tuning file now.
+      void save()
+      {
+        if (mTuningFile.empty())
+        {
+          throw mx::Exception{"matlabw:mex:KernelRegistry:save", "registry has no tuning file"};
+        }
+
+        mTable.save(mTuningFile);
+      }
+    private:
+      using OperationKey = std::pair<std::string, std::type_index>; ///< Name and signature of an operation.
+
+      std::string                                                           mTuningFile{}; ///< Path of the file.
+      std::size_t                                                           mTuningRuns{}; ///< Timed runs.
+      TuningTable                                                           mTable{};      ///< Tuned candidates.
+      std::map<OperationKey, std::unique_ptr<detail::KernelOperationBase>> mOperations{}; ///< Operations.
+  };
+
+  /**
+   * @brief Gets a kernel registry living across MEX function calls as a mex::State. The tuning table is saved when the
+   *        state is reset or the MEX file is cleared. The arguments are used only on the first call.
+   * @tparam Tag Tag distinguishing several registries.
+   * @param tuningFile The path of the tuning file, empty to not persist.
+   * @param tuningRuns Number of timed runs of every candidate.
+   * @return The registry.
+   */
+  template<typename Tag = void>
+  [[nodiscard]] KernelRegistry& getKernelRegistry(std::string tuningFile = {},
+                                                  std::size_t tuningRuns = defaultTuningRuns)
+  {
+    return State<KernelRegistry, Tag>::get(std::move(tuningFile), tuningRuns);
+  }
+
+  /**
+   * @brief Signature of the elementwise binary kernels, out = op(a, b) of spans of the same size.
+   * @tparam T Element type.
+   */
+  template<typename T>
+  using BinaryKernel = void(mx::Span<T> out, mx::View<T> a, mx::View<T> b);
+
+  /**
+   * @brief Signature of the sum kernels.
+   * @tparam T Element type.
+   */
+  template<typename T>
+  using SumKernel = mx::algorithm::SumType<T>(mx::View<T> in);
+
+  /**
+   * @brief Registers the kernels of the elementwise and reduction modules: "add" and "multiply" of BinaryKernel and
+   *        "sum" of SumKernel, each with a single-threaded SIMD candidate "simd" and a threaded one "threaded", in
+   *        place of the fixed detail::parallelMinSize threshold.
+   * @tparam T Element type.
+   * @param registry The registry.
+   */
+  template<typename T>
+  void registerAlgorithmKernels(KernelRegistry& registry)
+  {
+    namespace ad = mx::algorithm::detail;
+
+    using Acc = mx::algorithm::SumType<T>;
+
+    auto binary = [&registry]<typename Op>(std::string_view name, Op op)
+    {
+      const std::string id = "matlabw:mex:" + std::string{name};
+
+      registry.add<BinaryKernel<T>>(name, "simd", [op, id](mx::Span<T> out, mx::View<T> a, mx::View<T> b)
+      {
+        ad::checkSizes(id.c_str(), out.size(), a.size(), b.size());
+        ad::transformSimd(op, out.size(), out.data(), a.data(), b.data());
+      });
+
+      registry.add<BinaryKernel<T>>(name, "threaded", [op, id](mx::Span<T> out, mx::View<T> a, mx::View<T> b)
+      {
+        ad::checkSizes(id.c_str(), out.size(), a.size(), b.size());
+        ad::transformParallel(op, out.size(), out.data(), a.data(), b.data());
+      });
+    };
+
+    binary("add", ad::AddOp{});
+    binary("multiply", ad::MultiplyOp{});
+
+    registry.add<SumKernel<T>>("sum", "simd", [](mx::View<T> in)
+    {
+      const T* data = in.data();
+
+      return ad::sumSerial<Acc>([data](std::size_t i) MATLABW_INLINE_LAMBDA { return static_cast<Acc>(data[i]); },
+                                in.size(), mx::algorithm::Summation::pairwise);
+    });
+
+    registry.add<SumKernel<T>>("sum", "threaded", [](mx::View<T> in)
+    {
+      const T* data = in.data();
+
+      return ad::sumParallel<Acc>([data](std::size_t i) MATLABW_INLINE_LAMBDA { return static_cast<Acc>(data[i]); },
+                                  in.size(), mx::algorithm::Summation::pairwise);
+    });
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_KERNEL_REGISTRY_HPP */
@@ -0,0 +1,569 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_LOGGER_HPP
+#define MATLABW_MEX_LOGGER_HPP
+
+#include "detail/include.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <matlabw/mx/parallel/mainThread.hpp>
+#include <matlabw/mx/parallel/RingQueue.hpp>
+
+#include "detail/format.hpp"
+#include "io.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Severity of a log record.
+  enum class LogSeverity : std::uint8_t
+  {
+    debug,   ///< Debugging details.
+    info,    ///< Informational messages.
+    warning, ///< Warnings, optionally forwarded to MATLAB.
+    error,   ///< Errors, optionally forwarded to MATLAB as warnings.
+  };
+
+  /**
+   * @brief Gets the name of a severity.
+   * @param severity The severity.
+   * @return The name.
+   */
+  [[nodiscard]] constexpr const char* getLogSeverityName(LogSeverity severity) noexcept
+  {
+    switch (severity)
+    {
+    case LogSeverity::debug:   return "debug";
+    case LogSeverity::info:    return "info";
+    case LogSeverity::warning: return "warning";
+    case LogSeverity::error:   return "error";
+    default:                   return "unknown";
+    }
+  }
+
+  /// @brief Destination of formatted log lines. Called from the logger thread only.
+  class LogSink
+  {
+    public:
+      /// @brief Virtual destructor.
+      virtual ~LogSink() = default;
+
+      /**
+       * @brief Writes formatted log lines.
+       * @param text The lines, each terminated by a newline.
+       */
+      virtual void write(std::string_view text) = 0;
+
+      /// @brief Flushes the written lines, called when the logger thread runs out of records.
+      virtual void flush() {}
+  };
+
+  /// @brief Log sink appending to a file.
+  class FileLogSink : public LogSink
+  {
+    public:
+      /**
+       * @brief Constructor. Opens the file for appending.
+       * @param path The path of the file.
+       */
+      explicit FileLogSink(const char* path)
+      : mFile{std::fopen(path, "a")}
+      {
+        if (mFile == nullptr)
+        {
+          throw mx::Exception{"matlabw:mex:FileLogSink:open", "failed to open log file"};
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      FileLogSink(const FileLogSink&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      FileLogSink(FileLogSink&&) = delete;
+
+      /// @brief Destructor. Closes the file.
+      ~FileLogSink() override
+      {
+        std::fclose(mFile);
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      FileLogSink& operator=(const FileLogSink&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      FileLogSink& operator=(FileLogSink&&) = delete;
+
+      /**
+       * @brief Writes formatted log lines.
+       * @param text The lines.
+       */
+      void write(std::string_view text) override
+      {
+        std::fwrite(text.data(), 1, text.size(), mFile);
+      }
+
+      /// @brief Flushes the file.
+      void flush() override
+      {
+        std::fflush(mFile);
+      }
+    private:
+      std::FILE* mFile; ///< The file.
+  };
+
+  /// @brief Options of the logger.
+  struct LoggerOptions
+  {
+    std::size_t               capacity{8192};                        ///< Number of records the ring buffer holds.
+    LogSeverity               minSeverity{LogSeverity::info};        ///< Records below are discarded by the producer.
+    LogSeverity               forwardSeverity{LogSeverity::warning}; ///< Records at or above go to mex::warn too.
+    bool                      forwardToMatlab{true};                 ///< Whether records are forwarded to mex::warn.
+    std::chrono::milliseconds pollInterval{10};                      ///< Sleep of the logger thread when idle.
+  };
+
+namespace detail
+{
+  /// @brief Maximum number of arguments of a log record.
+  inline constexpr std::size_t maxLogArgs{6};
+
+  /// @brief Size of the inline storage of the string arguments of a log record.
+  inline constexpr std::size_t logTextCapacity{160};
+
+  /// @brief Binary log record argument.
+  struct LogArg
+  {
+    /// @brief Type of the argument.
+    enum class Type : std::uint8_t
+    {
+      signedInt,   ///< Signed integer.
+      unsignedInt, ///< Unsigned integer.
+      floating,    ///< Floating-point value.
+      boolean,     ///< Boolean.
+      character,   ///< Character.
+      string,      ///< String copied to the record text.
+    };
+
+    Type type{}; ///< The type.
+
+    union
+    {
+      std::int64_t  i; ///< Signed integer.
+      std::uint64_t u; ///< Unsigned integer.
+      double        d; ///< Floating-point value.
+      bool          b; ///< Boolean.
+      char          c; ///< Character.
+      struct
+      {
+        std::uint16_t offset; ///< Offset in the record text.
+        std::uint16_t length; ///< Length.
+      } s;             ///< String.
+    };
+  };
+
+  /// @brief Binary log record, trivially copyable so it can be stored in the ring buffer.
+  struct LogRecord
+  {
+    std::int64_t  time{};                ///< Nanoseconds since the epoch of the system clock.
+    const char*   tag{};                 ///< Module tag, static storage.
+    const char*   format{};              ///< Format string, static storage.
+    LogSeverity   severity{};            ///< The severity.
+    std::uint8_t  argCount{};            ///< Number of arguments.
+    std::uint16_t textSize{};            ///< Used size of the text.
+    LogArg        args[maxLogArgs]{};    ///< The arguments.
+    char          text[logTextCapacity]; ///< Storage of the string arguments.
+  };
+
+  /**
+   * @brief Stores an argument in a log record.
+   * @tparam T Argument type
+   * @param record The record.
+   * @param value The argument.
+   */
+  template<typename T>
+  void encodeLogArg(LogRecord& record, const T& value) noexcept
+  {
+    LogArg& arg = record.args[record.argCount++];
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      arg.type = LogArg::Type::boolean;
+      arg.b    = value;
+    }
+    else if constexpr (std::is_same_v<T, char>)
+    {
+      arg.type = LogArg::Type::character;
+      arg.c    = value;
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+    {
+      arg.type = LogArg::Type::signedInt;
+      arg.i    = value;
+    }
+    else if constexpr (std::is_integral_v<T>)
+    {
+      arg.type = LogArg::Type::unsignedInt;
+      arg.u    = value;
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+      arg.type = LogArg::Type::floating;
+      arg.d    = static_cast<double>(value);
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+    {
+      const std::string_view str{value};
+      const std::size_t      length = std::min(str.size(), logTextCapacity - record.textSize);
+
+      std::char_traits<char>::copy(record.text + record.textSize, str.data(), length);
+
+      arg.type     = LogArg::Type::string;
+      arg.s.offset = record.textSize;
+      arg.s.length = static_cast<std::uint16_t>(length);
+
+      record.textSize = static_cast<std::uint16_t>(record.textSize + length);
+    }
+    else
+    {
+      static_assert(std::is_integral_v<T>, "unsupported log argument type");
+    }
+  }
+
+  /**
+   * @brief Formats a log record argument, the appender of formatErased().
+   * @param out The output string.
+   * @param value Pointer to the argument, the record text follows the record arguments.
+   * @param spec The format specification.
+   */
+  inline void appendLogArg(std::string& out, const void* value, std::string_view spec)
+  {
+    const auto& [arg, text] = *static_cast<const std::pair<const LogArg*, const char*>*>(value);
+
+    switch (arg->type)
+    {
+    case LogArg::Type::signedInt:   appendFormatArg(out, arg->i, spec); break;
+    case LogArg::Type::unsignedInt: appendFormatArg(out, arg->u, spec); break;
+    case LogArg::Type::floating:    appendFormatArg(out, arg->d, spec); break;
+    case LogArg::Type::boolean:     appendFormatArg(out, arg->b, spec); break;
+    case LogArg::Type::character:   appendFormatArg(out, arg->c, spec); break;
+    case LogArg::Type::string:
+      appendFormatArg(out, std::string_view{text + arg->s.offset, arg->s.length}, spec);
+      break;
+    }
+  }
+
+  /**
+   * @brief Appends the ISO 8601 UTC time of a log record.
+   * @param out The output string.
+   * @param time Nanoseconds since the epoch of the system clock.
+   */
+  inline void appendLogTime(std::string& out, std::int64_t time)
+  {
+    using namespace std::chrono;
+
+    const sys_time<nanoseconds>  timePoint{nanoseconds{time}};
+    const sys_days               day = floor<days>(timePoint);
+    const year_month_day         date{day};
+    const hh_mm_ss<microseconds> clock{floor<microseconds>(timePoint - day)};
+
+    char buffer[40];
+
+    const int size = std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02uT%02d:%02d:%02d.%06dZ",
+                                   static_cast<int>(date.year()),
+                                   static_cast<unsigned>(date.month()),
+                                   static_cast<unsigned>(date.day()),
+                                   static_cast<int>(clock.hours().count()),
+                                   static_cast<int>(clock.minutes().count()),
+                                   static_cast<int>(clock.seconds().count()),
+                                   static_cast<int>(clock.subseconds().count()));
+
+    out.append(buffer, static_cast<std::size_t>(std::max(size, 0)));
+  }
+} // namespace detail
+
+  /**
+   * @brief Asynchronous logger writing to a sink independent of the MATLAB console. Any thread may log: the record is
+   *        stored in binary form in a lock-free ring buffer without formatting or allocating, and a background thread
+   *        formats the records and writes them to the sink. Records are dropped when the ring buffer is full.
+   *        Warnings and errors are optionally forwarded to mex::warn through the main thread queue. The logger thread
+   *        must be stopped before the MEX file is unloaded, e.g. by keeping the logger in a mex::State.
+   */
+  class Logger
+  {
+    public:
+      /**
+       * @brief Constructor. Starts the logger thread.
+       * @param sink The sink.
+       * @param options The options.
+       */
+      explicit Logger(std::unique_ptr<LogSink> sink, const LoggerOptions& options = {})
+      : mOptions{options},
+        mMinSeverity{options.minSeverity},
+        mQueue{options.capacity},
+        mSink{std::move(sink)},
+        mThread{[this]{ run(); }}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      Logger(const Logger&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      Logger(Logger&&) = delete;
+
+      /// @brief Destructor. Writes the remaining records and stops the logger thread.
+      ~Logger() noexcept
+      {
+        mStop.store(true, std::memory_order_release);
+        mThread.join();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Logger& operator=(const Logger&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      Logger& operator=(Logger&&) = delete;
+
+      /**
+       * @brief Logs a record, e.g. log(LogSeverity::info, "solver", "iteration {} residual {:.3e}", i, r).
+       * @tparam Args Argument types, arithmetic types or strings. At most 6 arguments, strings are truncated to the
+       *              inline storage of the record.
+       * @param severity The severity.
+       * @param tag The module tag, must have static storage duration. Forms the warning identifier matlabw:log:<tag>.
+       * @param format The format string, must have static storage duration.
+       * @param args The arguments.
+       * @return True if the record was stored, false if it was filtered out or dropped.
+       */
+      template<typename... Args>
+      bool log(LogSeverity severity, const char* tag, const char* format, const Args&... args) noexcept
+      {
+        static_assert(sizeof...(Args) <= detail::maxLogArgs, "too many log arguments");
+
+        if (severity < mMinSeverity.load(std::memory_order_relaxed))
+        {
+          return false;
+        }
+
+        detail::LogRecord record;
+
+        record.time     = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now().time_since_epoch()).count();
+        record.tag      = tag;
+        record.format   = format;
+        record.severity = severity;
+
+        (detail::encodeLogArg(record, args), ...);
+
+        if (!mQueue.tryPush(record))
+        {
+          mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Logs a debug record.
+       * @tparam Args Argument types.
+       * @param tag The module tag, must have static storage duration.
+       * @param format The format string, must have static storage duration.
+       * @param args The arguments.
+       * @return True if the record was stored.
+       */
+      template<typename... Args>
+      bool debug(const char* tag, const char* format, const Args&... args) noexcept
+      {
+        return log(LogSeverity::debug, tag, format, args...);
+      }
+
+      /**
+       * @brief Logs an info record.
+       * @tparam Args Argument types.
+       * @param tag The module tag, must have static storage duration.
+       * @param format The format string, must have static storage duration.
+       * @param args The arguments.
+       * @return True if the record was stored.
+       */
+      template<typename... Args>
+      bool info(const char* tag, const char* format, const Args&... args) noexcept
+      {
+        return log(LogSeverity::info, tag, format, args...);
+      }
+
+      /**
+       * @brief Logs a warning record.
+       * @tparam Args Argument types.
+       * @param tag The module tag, must have static storage duration.
+       * @param format The format string, must have static storage duration.
+       * @param args The arguments.
+       * @return True if the record was stored.
+       */
+      template<typename... Args>
+      bool warning(const char* tag, const char* format, const Args&... args) noexcept
+      {
+        return log(LogSeverity::warning, tag, format, args...);
+      }
+
+      /**
+       * @brief Logs an error record.
+       * @tparam Args Argument types.
+       * @param tag The module tag, must have static storage duration.
+       * @param format The format string, must have static storage duration.
+       * @param args The arguments.
+       * @return True if the record was stored.
+       */
+      template<typename... Args>
+      bool error(const char* tag, const char* format, const Args&... args) noexcept
+      {
+        return log(LogSeverity::error, tag, format, args...);
+      }
+
+      /**
+       * @brief Sets the minimum severity of stored records.
+       * @param severity The minimum severity.
+       */
+      void setMinSeverity(LogSeverity severity) noexcept
+      {
+        mMinSeverity.store(severity, std::memory_order_relaxed);
+      }
+
+      /**
+       * @brief Gets the number of records dropped because the ring buffer was full.
+       * @return The number of dropped records.
+       */
+      [[nodiscard]] std::size_t getDroppedCount() const noexcept
+      {
+        return mDroppedCount.load(std::memory_order_relaxed);
+      }
+    private:
+      /// @brief Body of the logger thread.
+      void run() noexcept
+      {
+        std::string       text{};
+        std::string       message{};
+        detail::LogRecord record;
+
+        for (;;)
+        {
+          const bool stop = mStop.load(std::memory_order_acquire);
+
+          while (mQueue.tryPop(record))
+          {
+            try
+            {
+              writeRecord(record, text, message);
+            }
+            catch (...)
+            {
+              // Formatting or writing failed, the record is dropped.
+            }
+          }
+
+          try
+          {
+            if (!text.empty())
+            {
+              mSink->write(text);
+              mSink->flush();
+              text.clear();
+            }
+          }
+          catch (...)
+          {
+            text.clear();
+          }
+
+          if (stop)
+          {
+            break;
+          }
+
+          std::this_thread::sleep_for(mOptions.pollInterval);
+        }
+      }
+
+      /**
+       * @brief Formats a record into the pending text and forwards it to MATLAB if requested.
+       * @param record The record.
+       * @param text The pending text.
+       * @param message Scratch string of the message.
+       */
+      void writeRecord(const detail::LogRecord& record, std::string& text, std::string& message)
+      {
+        std::pair<const detail::LogArg*, const char*> args[detail::maxLogArgs]{};
+        const void*                                   values[detail::maxLogArgs]{};
+        detail::FormatAppender                        appenders[detail::maxLogArgs]{};
+
+        for (std::size_t i{}; i < record.argCount; ++i)
+        {
+          args[i]      = {&record.args[i], record.text};
+          values[i]    = &args[i];
+          appenders[i] = detail::appendLogArg;
+        }
+
+        message.clear();
+
+        try
+        {
+          detail::formatErased(message, record.format, values, appenders, record.argCount);
+        }
+        catch (const std::exception& e)
+        {
+          message.assign("invalid log format: ").append(e.what());
+        }
+
+        detail::appendLogTime(text, record.time);
+        text.append(" [").append(getLogSeverityName(record.severity)).append("] [").append(record.tag).append("] ");
+        text.append(message).append("\n");
+
+        if (text.size() >= 65536)
+        {
+          mSink->write(text);
+          text.clear();
+        }
+
+        if (mOptions.forwardToMatlab && record.severity >= mOptions.forwardSeverity &&
+            mx::parallel::detail::getMainThreadId().load(std::memory_order_relaxed) != std::thread::id{})
+        {
+          mx::parallel::postToMainThread([id = std::string{"matlabw:log:"} + record.tag, message]
+          {
+            warn(id.c_str(), message.c_str());
+          });
+        }
+      }
+
+      LoggerOptions                              mOptions;        ///< The options.
+      std::atomic<LogSeverity>                   mMinSeverity;    ///< Minimum severity of stored records.
+      std::atomic<std::size_t>                   mDroppedCount{}; ///< Number of dropped records.
+      std::atomic<bool>                          mStop{};         ///< Stops the logger thread.
+      mx::parallel::RingQueue<detail::LogRecord> mQueue;          ///< The ring buffer.
+      std::unique_ptr<LogSink>                   mSink;           ///< The sink.
+      std::thread                                mThread;         ///< The logger thread.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_LOGGER_HPP */
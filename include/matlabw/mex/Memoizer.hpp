@@ -0,0 +1,284 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_MEMOIZER_HPP
+#define MATLABW_MEX_MEMOIZER_HPP
+
+#include "detail/include.hpp"
+
+#include <list>
+#include <unordered_map>
+
+#include <matlabw/mx/hash.hpp>
+
+#include "memory.hpp"
+#include "State.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief How the memoizer identifies repeated inputs.
+  enum class MemoKey
+  {
+    content,     ///< Hash class, dimensions and contents of the inputs, reads all input data once per call.
+    fingerprint, ///< Hash class, dimensions and data address only. Cheap, but misses in-place modifications in MATLAB.
+  };
+
+  /**
+   * @brief Cache of the results of a pure MEX function. The key of a call is a 128-bit hash of the number of outputs
+   *        and of the inputs, and the outputs of the most recently used keys are kept as persistent duplicates. On a
+   *        hit the outputs are duplicated without calling the function. Calls with inputs that cannot be hashed
+   *        (objects, function handles) are not cached. The memoizer is not thread-safe and must be used from the
+   *        MATLAB thread only.
+   */
+  class Memoizer
+  {
+    public:
+      /// @brief Default number of cached calls.
+      static constexpr std::size_t defaultCapacity{64};
+
+      /**
+       * @brief Constructor.
+       * @param capacity The maximum number of cached calls, the least recently used one is evicted first.
+       * @param key How repeated inputs are identified.
+       */
+      explicit Memoizer(std::size_t capacity = defaultCapacity, MemoKey key = MemoKey::content)
+      : mCapacity{std::max<std::size_t>(capacity, 1)}, mKey{key}
+      {
+        mIndex.reserve(mCapacity + 1);
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      Memoizer(const Memoizer&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      Memoizer(Memoizer&&) = delete;
+
+      /// @brief Destructor. Destroys the cached outputs.
+      ~Memoizer() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Memoizer& operator=(const Memoizer&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      Memoizer& operator=(Memoizer&&) = delete;
+
+      /**
+       * @brief Calls a function through the cache. The outputs are cached only if the function assigns all of them.
+       * @tparam Fn The function type, invocable with (mx::Span<mx::Array>, mx::View<mx::ArrayCref>).
+       * @param lhs Left-hand side arguments.
+       * @param rhs Right-hand side arguments.
+       * @param fn The function, called on a miss.
+       */
+      template<typename Fn>
+      void call(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs, Fn&& fn)
+      {
+        const auto key = makeKey(lhs.size(), rhs);
+
+        if (!key.has_value() || lhs.empty())
+        {
+          std::invoke(std::forward<Fn>(fn), lhs, rhs);
+          return;
+        }
+
+        if (auto it = mIndex.find(*key); it != mIndex.end())
+        {
+          ++mHitCount;
+
+          mEntries.splice(mEntries.begin(), mEntries, it->second);
+
+          std::transform(it->second->outputs.begin(), it->second->outputs.end(), lhs.begin(), [](const mx::Array& out)
+          {
+            return mx::Array{out};
+          });
+
+          return;
+        }
+
+        ++mMissCount;
+
+        std::invoke(std::forward<Fn>(fn), lhs, rhs);
+
+        if (!std::all_of(lhs.begin(), lhs.end(), [](const mx::Array& out) { return out.isValid(); }))
+        {
+          return;
+        }
+
+        std::vector<mx::Array> outputs{};
+        outputs.reserve(lhs.size());
+
+        for (const mx::Array& out : lhs)
+        {
+          makePersistent(outputs.emplace_back(out));
+        }
+
+        mEntries.push_front(Entry{*key, std::move(outputs)});
+        mIndex.emplace(*key, mEntries.begin());
+
+        if (mEntries.size() > mCapacity)
+        {
+          mIndex.erase(mEntries.back().key);
+          mEntries.pop_back();
+        }
+      }
+
+      /// @brief Destroys all cached outputs.
+      void clear() noexcept
+      {
+        mIndex.clear();
+        mEntries.clear();
+      }
+
+      /**
+       * @brief Gets the maximum number of cached calls.
+       * @return The capacity.
+       */
+      [[nodiscard]] std::size_t getCapacity() const noexcept
+      {
+        return mCapacity;
+      }
+
+      /**
+       * @brief Gets the number of cached calls.
+       * @return The number of cached calls.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mEntries.size();
+      }
+
+      /**
+       * @brief Gets the number of calls served from the cache.
+       * @return The number of hits.
+       */
+      [[nodiscard]] std::size_t getHitCount() const noexcept
+      {
+        return mHitCount;
+      }
+
+      /**
+       * @brief Gets the number of cacheable calls that called the function.
+       * @return The number of misses.
+       */
+      [[nodiscard]] std::size_t getMissCount() const noexcept
+      {
+        return mMissCount;
+      }
+    private:
+      /// @brief Cached outputs of a call.
+      struct Entry
+      {
+        mx::Hash128            key{};     ///< The key of the call.
+        std::vector<mx::Array> outputs{}; ///< The persistent duplicates of the outputs.
+      };
+
+      /// @brief Hash of a key for the index, the key is already uniformly distributed.
+      struct KeyHash
+      {
+        [[nodiscard]] std::size_t operator()(const mx::Hash128& key) const noexcept
+        {
+          return static_cast<std::size_t>(key.low);
+        }
+      };
+
+      /**
+       * @brief Makes the key of a call.
+       * @param nlhs The number of outputs.
+       * @param rhs The inputs.
+       * @return The key, std::nullopt if the call cannot be cached.
+       */
+      [[nodiscard]] std::optional<mx::Hash128> makeKey(std::size_t nlhs, mx::View<mx::ArrayCref> rhs) const
+      {
+        using mx::detail::hashBytes128;
+        using mx::detail::hashValue128;
+
+        mx::Hash128 key = hashValue128(std::uint64_t{nlhs}, mx::Hash128{rhs.size(), 0});
+
+        for (const mx::ArrayCref& arg : rhs)
+        {
+          if (mKey == MemoKey::content)
+          {
+            const auto hash = mx::detail::hashArray(arg.get(), key);
+
+            if (!hash.has_value())
+            {
+              return std::nullopt;
+            }
+
+            key = *hash;
+          }
+          else
+          {
+            const mx::View<std::size_t> dims = arg.getDims();
+            const void*                 data = mxGetData(arg.get());
+
+            key = hashValue128(static_cast<std::uint64_t>(arg.getClassId()), key);
+            key = hashBytes128(dims.data(), dims.size_bytes(), key);
+            key = hashValue128(data, key);
+          }
+        }
+
+        return key;
+      }
+
+      using Entries = std::list<Entry>;                                                    ///< Most recent first.
+      using Index   = std::unordered_map<mx::Hash128, Entries::iterator, KeyHash>; ///< Entries by key.
+
+      std::size_t mCapacity;    ///< Maximum number of entries.
+      MemoKey     mKey;         ///< How inputs are identified.
+      Entries     mEntries{};   ///< The cached calls.
+      Index       mIndex{};     ///< The index of the cached calls.
+      std::size_t mHitCount{};  ///< Number of hits.
+      std::size_t mMissCount{}; ///< Number of misses.
+  };
+
+  /**
+   * @brief Gets a memoizer living across MEX function calls as a mex::State, so it is cleared by the reset command
+   *        and when the MEX file is cleared. The arguments are used only on the first call.
+   * @tparam Tag Tag distinguishing several memoizers.
+   * @param capacity The maximum number of cached calls.
+   * @param key How repeated inputs are identified.
+   * @return The memoizer.
+   */
+  template<typename Tag = void>
+  [[nodiscard]] Memoizer& getMemoizer(std::size_t capacity = Memoizer::defaultCapacity, MemoKey key = MemoKey::content)
+  {
+    return State<Memoizer, Tag>::get(capacity, key);
+  }
+
+  /**
+   * @brief Calls a pure function through the memoizer of the tag, e.g. from mex::Function::operator().
+   * @tparam Tag Tag distinguishing several memoizers.
+   * @tparam Fn The function type, invocable with (mx::Span<mx::Array>, mx::View<mx::ArrayCref>).
+   * @param lhs Left-hand side arguments.
+   * @param rhs Right-hand side arguments.
+   * @param fn The function, called on a miss.
+   */
+  template<typename Tag = void, typename Fn>
+  void memoize(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs, Fn&& fn)
+  {
+    getMemoizer<Tag>().call(lhs, rhs, std::forward<Fn>(fn));
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_MEMOIZER_HPP */
@@ -0,0 +1,768 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MEX_NODE_CACHE_HPP
+#define MATLABW_MEX_NODE_CACHE_HPP
+
+#include "detail/include.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+# define MATLABW_NODE_CACHE_POSIX
+# include <cerrno>
+# include <fcntl.h>
+# include <signal.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#elif defined(_WIN32)
+# define MATLABW_NODE_CACHE_WIN32
+# ifndef NOMINMAX
+#   define NOMINMAX
+# endif
+# include <windows.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <matlabw/mx/serialize.hpp>
+#include <matlabw/mx/SharedMemoryArray.hpp>
+
+#include "State.hpp"
+
+namespace matlabw::mex
+{
+namespace detail
+{
+  /// @brief Identifies a node cache segment.
+  inline constexpr std::uint32_t nodeCacheMagic{0x434e574d};
+
+  /// @brief Version of the segment layout.
+  inline constexpr std::uint32_t nodeCacheLayout{1};
+
+  /// @brief Offset of the serialized tree in a segment, the header is mapped separately and writable.
+  inline constexpr std::size_t nodeCacheDataOffset{64};
+
+  /// @brief Status of a node cache segment.
+  enum NodeCacheStatus : std::uint32_t
+  {
+    nodeCacheCreating  = 0, ///< The publisher builds the tree, zero so a fresh segment is in this state.
+    nodeCacheReady     = 1, ///< The tree is published.
+    nodeCacheFailed    = 2, ///< The publisher failed, the name is being removed.
+    nodeCacheAbandoned = 3, ///< The publisher crashed, the name is being removed.
+  };
+
+  /// @brief Header of a node cache segment.
+  struct NodeCacheHeader
+  {
+    std::atomic<std::uint32_t> status;     ///< The NodeCacheStatus.
+    std::uint32_t              magic;      ///< nodeCacheMagic once published.
+    std::uint32_t              layout;     ///< nodeCacheLayout once published.
+    std::uint32_t              version;    ///< Version of the cached data.
+    std::atomic<std::uint64_t> references; ///< Number of processes mapping the tree, 0 before publishing and after.
+    std::atomic<std::uint64_t> publisher;  ///< Process id of the publisher.
+    std::uint64_t              size;       ///< Size of the serialized tree in bytes.
+  };
+
+  static_assert(sizeof(NodeCacheHeader) <= nodeCacheDataOffset, "node cache header must fit before the data");
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "reference counter must be lock-free");
+
+  /// @brief Outcome of an attempt to create or open a segment.
+  enum class NodeCacheAttempt
+  {
+    mapped, ///< The segment is mapped.
+    absent, ///< There is no segment of the name.
+    retry,  ///< The segment is being created or removed by another process.
+    local,  ///< The segment can not be used, the tree is built locally.
+  };
+
+  /**
+   * @brief Gets the id of the calling process.
+   * @return The process id.
+   */
+  [[nodiscard]] inline std::uint64_t getNodeCacheProcessId() noexcept
+  {
+#if defined(MATLABW_NODE_CACHE_POSIX)
+    return static_cast<std::uint64_t>(::getpid());
+#elif defined(MATLABW_NODE_CACHE_WIN32)
+    return static_cast<std::uint64_t>(GetCurrentProcessId());
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * @brief Checks if a process is running, so a crashed publisher does not keep the others waiting.
+   * @param pid The process id, 0 if not known yet.
+   * @return True if the process runs or is not known.
+   */
+  [[nodiscard]] inline bool isNodeCacheProcessAlive(std::uint64_t pid) noexcept
+  {
+    if (pid == 0)
+    {
+      return true;
+    }
+
+#if defined(MATLABW_NODE_CACHE_POSIX)
+    return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#elif defined(MATLABW_NODE_CACHE_WIN32)
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+
+    if (process == nullptr)
+    {
+      return GetLastError() == ERROR_ACCESS_DENIED;
+    }
+
+    const bool alive = (WaitForSingleObject(process, 0) == WAIT_TIMEOUT);
+
+    CloseHandle(process);
+
+    return alive;
+#else
+    return false;
+#endif
+  }
+} // namespace detail
+
+  /**
+   * @brief Read-only array tree shared by all MATLAB processes of a node, e.g. the workers of a local parallel pool
+   *        which would otherwise each build and hold a copy of the same large lookup tables. The first process
+   *        claims a named shared memory segment, builds the tree and publishes it serialized, the others wait for
+   *        it and map it read-only. The segment is reference counted and removed when the last process releases it,
+   *        typically when the MEX file is cleared, see getNodeCache(). If the segment can not be used, e.g. it was
+   *        published in another version or the platform has no named shared memory, the tree is built locally, so
+   *        the cache is always usable.
+   *
+   *        On POSIX, the process which crashes between claiming and publishing is detected by its process id. A
+   *        crashed process holding a reference leaves the segment in /dev/shm until remove() or a reboot. On Windows
+   *        the segment is freed by the system with the last handle, the tree may be built concurrently by the
+   *        first processes and only one of them is published.
+   */
+  class NodeCache
+  {
+    public:
+      /// @brief Default time to wait for another process publishing the tree before it is built locally.
+      static constexpr std::chrono::milliseconds defaultTimeout{std::chrono::minutes{10}};
+
+      /**
+       * @brief Constructor, maps the published tree or publishes it.
+       * @tparam Fn The build function type, returning the array tree.
+       * @param name The name of the segment, unique on the node, without slashes.
+       * @param version Version of the data, bumped whenever the build changes.
+       * @param build The build function, called only by the publishing process or if the tree is built locally.
+       * @param timeout Time to wait for another process publishing the tree.
+       */
+      template<typename Fn>
+        requires std::convertible_to<std::invoke_result_t<Fn&>, mx::Array>
+      NodeCache(std::string_view          name,
+                std::uint32_t             version,
+                Fn&&                      build,
+                std::chrono::milliseconds timeout = defaultTimeout)
+      : mName{getSystemName(name)}, mVersion{version}
+      {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while (true)
+        {
+          detail::NodeCacheAttempt attempt = tryOpen();
+
+          if (attempt == detail::NodeCacheAttempt::absent)
+          {
+            attempt = tryPublish(build);
+          }
+
+          if (attempt == detail::NodeCacheAttempt::mapped)
+          {
+            return;
+          }
+
+          if (attempt == detail::NodeCacheAttempt::local || std::chrono::steady_clock::now() >= deadline)
+          {
+            mLocal = mx::serialize(build());
+            return;
+          }
+
+          std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      NodeCache(const NodeCache&) = delete;
+
+      /// @brief Explicitly deleted move constructor, the object lives in a mex::State.
+      NodeCache(NodeCache&&) = delete;
+
+      /// @brief Destructor, releases the reference, the last process removes the segment.
+      ~NodeCache() noexcept
+      {
+        unmap(true);
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      NodeCache& operator=(const NodeCache&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      NodeCache& operator=(NodeCache&&) = delete;
+
+      /**
+       * @brief Checks if the tree is shared with other processes.
+       * @return True if the segment is mapped, false if the tree was built locally.
+       */
+      [[nodiscard]] bool isShared() const noexcept
+      {
+        return mHeader != nullptr;
+      }
+
+      /**
+       * @brief Checks if this process published the tree.
+       * @return True if this process built and published the tree.
+       */
+      [[nodiscard]] bool isPublisher() const noexcept
+      {
+        return mPublisher;
+      }
+
+      /**
+       * @brief Gets the number of processes mapping the tree.
+       * @return The number of references, 1 if the tree was built locally.
+       */
+      [[nodiscard]] std::size_t getReferenceCount() const noexcept
+      {
+        return isShared() ? static_cast<std::size_t>(mHeader->references.load(std::memory_order_relaxed)) : 1;
+      }
+
+      /**
+       * @brief Gets the serialized tree.
+       * @return The serialized tree, see mx::SerializedArray.
+       */
+      [[nodiscard]] mx::View<std::byte> getBytes() const noexcept
+      {
+        if (isShared())
+        {
+          return mx::View<std::byte>{mData + detail::nodeCacheDataOffset, mHeader->size};
+        }
+
+        return mx::View<std::byte>{mLocal};
+      }
+
+      /**
+       * @brief Copies the tree to MATLAB arrays, e.g. to return it. Each array is allocated once.
+       * @return The array tree.
+       */
+      [[nodiscard]] mx::Array materialize() const
+      {
+        return mx::deserialize(getBytes());
+      }
+
+      /**
+       * @brief Gets a zero-copy view of the tree if it is a single dense numeric, logical or char array.
+       * @tparam T The element type, must match the class and complexity of the array.
+       * @return The view, valid as long as this object. The data never change, the sequence is 0.
+       */
+      template<typename T>
+      [[nodiscard]] mx::SharedMemoryView<T> getView() const
+      {
+        static constexpr char id[]{"matlabw:mex:NodeCache:getView"};
+
+        const mx::View<std::byte> bytes = getBytes();
+
+        // magic, version and byte order mark precede the root node
+        std::size_t offset{8};
+
+        mx::detail::SerialNodeHeader node{};
+
+        if (bytes.size() < offset + sizeof(node))
+        {
+          throw mx::Exception{id, "cached data are truncated"};
+        }
+
+        std::memcpy(&node, bytes.data() + offset, sizeof(node));
+        offset += sizeof(node);
+
+        if ((node.flags & (mx::detail::serialSparse | mx::detail::serialNull)) != 0
+            || !mx::detail::isSerialLeaf(static_cast<mx::ClassId>(node.classId)))
+        {
+          throw mx::Exception{id, "cached tree is not a dense array, use materialize()"};
+        }
+
+        if (static_cast<mx::ClassId>(node.classId) != mx::TypeProperties<T>::classId
+            || ((node.flags & mx::detail::serialComplex) != 0) != mx::isComplexNumeric<T>)
+        {
+          throw mx::Exception{id, "element type must match the class of the array"};
+        }
+
+        if (node.codec != 0)
+        {
+          throw mx::Exception{id, "cached array is encoded, use materialize()"};
+        }
+
+        if (node.rank < 2 || node.rank > 64 || bytes.size() < offset + node.rank * sizeof(std::size_t))
+        {
+          throw mx::Exception{id, "cached data are truncated"};
+        }
+
+        std::vector<std::size_t> dims(node.rank);
+
+        std::memcpy(dims.data(), bytes.data() + offset, node.rank * sizeof(std::size_t));
+        offset += node.rank * sizeof(std::size_t);
+        offset += mx::detail::getSerialPadding(offset, mx::detail::serialPayloadAlignment);
+
+        std::size_t count{1};
+
+        for (const std::size_t dim : dims)
+        {
+          count = mx::detail::multiplySerialSizes(count, dim);
+        }
+
+        if (offset > bytes.size() || count > (bytes.size() - offset) / sizeof(T))
+        {
+          throw mx::Exception{id, "cached data are truncated"};
+        }
+
+        return mx::SharedMemoryView<T>{mx::View<T>{reinterpret_cast<const T*>(bytes.data() + offset), count},
+                                       std::move(dims),
+                                       0};
+      }
+
+      /**
+       * @brief Removes the name of a segment left behind by a crashed process. Processes mapping it keep their
+       *        mapping, the next process publishes a new segment.
+       * @param name The name of the segment.
+       */
+      static void remove(std::string_view name)
+      {
+#     if defined(MATLABW_NODE_CACHE_POSIX)
+        shm_unlink(getSystemName(name).c_str());
+#     else
+        static_cast<void>(name);
+#     endif
+      }
+    private:
+      /**
+       * @brief Gets the name used by the system.
+       * @param name The name.
+       * @return The system name.
+       */
+      [[nodiscard]] static std::string getSystemName(std::string_view name)
+      {
+        if (name.empty() || name.find_first_of("/\\") != std::string_view::npos)
+        {
+          throw mx::Exception{"matlabw:mex:NodeCache:invalidName", "name must be nonempty and without slashes"};
+        }
+
+#     if defined(MATLABW_NODE_CACHE_WIN32)
+        return "Local\\matlabw.node." + std::string{name};
+#     else
+        return "/matlabw.node." + std::string{name};
+#     endif
+      }
+
+      /**
+       * @brief Tries to open and map the published segment.
+       * @return mapped, absent if there is no segment, retry if it is not published yet, local if it can not be used.
+       */
+      [[nodiscard]] detail::NodeCacheAttempt tryOpen()
+      {
+#     if defined(MATLABW_NODE_CACHE_POSIX)
+        const int fd = shm_open(mName.c_str(), O_RDWR, 0600);
+
+        if (fd < 0)
+        {
+          return (errno == ENOENT) ? detail::NodeCacheAttempt::absent : detail::NodeCacheAttempt::local;
+        }
+
+        struct stat info{};
+
+        // the publisher has not sized the segment yet
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(detail::nodeCacheDataOffset))
+        {
+          ::close(fd);
+          return detail::NodeCacheAttempt::retry;
+        }
+
+        void* header = mmap(nullptr, detail::nodeCacheDataOffset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (header == MAP_FAILED)
+        {
+          ::close(fd);
+          return detail::NodeCacheAttempt::local;
+        }
+
+        mHeader = static_cast<detail::NodeCacheHeader*>(header);
+
+        const detail::NodeCacheAttempt attempt = acquire();
+
+        if (attempt == detail::NodeCacheAttempt::mapped)
+        {
+          const std::size_t size = detail::nodeCacheDataOffset + mHeader->size;
+          void*             data = (static_cast<std::size_t>(info.st_size) >= size)
+                                   ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)
+                                   : MAP_FAILED;
+
+          ::close(fd);
+
+          if (data == MAP_FAILED)
+          {
+            unmap(true);
+            return detail::NodeCacheAttempt::local;
+          }
+
+          mData     = static_cast<const std::byte*>(data);
+          mDataSize = size;
+
+          return attempt;
+        }
+
+        ::close(fd);
+        unmap(false);
+
+        return attempt;
+#     elif defined(MATLABW_NODE_CACHE_WIN32)
+        mHandle = OpenFileMappingA(FILE_MAP_WRITE | FILE_MAP_READ, FALSE, mName.c_str());
+
+        if (mHandle == nullptr)
+        {
+          return (GetLastError() == ERROR_FILE_NOT_FOUND) ? detail::NodeCacheAttempt::absent
+                                                          : detail::NodeCacheAttempt::local;
+        }
+
+        mHeader = static_cast<detail::NodeCacheHeader*>(MapViewOfFile(mHandle, FILE_MAP_WRITE, 0, 0,
+                                                                      detail::nodeCacheDataOffset));
+
+        if (mHeader == nullptr)
+        {
+          unmap(false);
+          return detail::NodeCacheAttempt::local;
+        }
+
+        const detail::NodeCacheAttempt attempt = acquire();
+
+        if (attempt == detail::NodeCacheAttempt::mapped)
+        {
+          mData = static_cast<const std::byte*>(MapViewOfFile(mHandle, FILE_MAP_READ, 0, 0, 0));
+
+          if (mData == nullptr)
+          {
+            unmap(true);
+            return detail::NodeCacheAttempt::local;
+          }
+
+          mDataSize = detail::nodeCacheDataOffset + mHeader->size;
+
+          return attempt;
+        }
+
+        unmap(false);
+
+        return attempt;
+#     else
+        return detail::NodeCacheAttempt::local;
+#     endif
+      }
+
+      /**
+       * @brief Takes a reference of the segment whose header is mapped.
+       * @return mapped if the reference was taken, retry while the segment is created or removed, local if it can
+       *         not be used.
+       */
+      [[nodiscard]] detail::NodeCacheAttempt acquire() noexcept
+      {
+        std::uint32_t status = mHeader->status.load(std::memory_order_acquire);
+
+        if (status == detail::nodeCacheCreating)
+        {
+          if (detail::isNodeCacheProcessAlive(mHeader->publisher.load(std::memory_order_relaxed)))
+          {
+            return detail::NodeCacheAttempt::retry;
+          }
+
+          // the publisher crashed, only the process marking the segment removes the name, so a segment published
+          // meanwhile under the same name is not removed
+          if (mHeader->status.compare_exchange_strong(status, detail::nodeCacheAbandoned, std::memory_order_acq_rel))
+          {
+#         if defined(MATLABW_NODE_CACHE_POSIX)
+            shm_unlink(mName.c_str());
+#         endif
+          }
+
+          return detail::NodeCacheAttempt::retry;
+        }
+
+        if (status == detail::nodeCacheAbandoned)
+        {
+          return detail::NodeCacheAttempt::retry;
+        }
+
+        if (status != detail::nodeCacheReady || mHeader->magic != detail::nodeCacheMagic
+            || mHeader->layout != detail::nodeCacheLayout || mHeader->version != mVersion)
+        {
+          return detail::NodeCacheAttempt::local;
+        }
+
+        std::uint64_t references = mHeader->references.load(std::memory_order_relaxed);
+
+        do
+        {
+          // the last process released the segment and is removing its name
+          if (references == 0)
+          {
+            return detail::NodeCacheAttempt::retry;
+          }
+        }
+        while (!mHeader->references.compare_exchange_weak(references, references + 1, std::memory_order_acquire,
+                                                          std::memory_order_relaxed));
+
+        return detail::NodeCacheAttempt::mapped;
+      }
+
+      /**
+       * @brief Tries to claim the name, build the tree and publish it.
+       * @tparam Fn The build function type.
+       * @param build The build function.
+       * @return mapped if published, retry if another process claimed the name first, local if shared memory is not
+       *         available.
+       * @throws Any exception of the build function, the claim is withdrawn and the waiting processes build locally.
+       */
+      template<typename Fn>
+      [[nodiscard]] detail::NodeCacheAttempt tryPublish(Fn& build)
+      {
+#     if defined(MATLABW_NODE_CACHE_POSIX)
+        const int fd = shm_open(mName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+        if (fd < 0)
+        {
+          return (errno == EEXIST) ? detail::NodeCacheAttempt::retry : detail::NodeCacheAttempt::local;
+        }
+
+        void* header = (ftruncate(fd, static_cast<off_t>(detail::nodeCacheDataOffset)) == 0)
+                       ? mmap(nullptr, detail::nodeCacheDataOffset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+
+        if (header == MAP_FAILED)
+        {
+          ::close(fd);
+          shm_unlink(mName.c_str());
+          return detail::NodeCacheAttempt::local;
+        }
+
+        // processes opening the segment meanwhile wait for the status, the claim is visible to them by the id
+        mHeader = new (header) detail::NodeCacheHeader{};
+        mHeader->publisher.store(detail::getNodeCacheProcessId(), std::memory_order_relaxed);
+
+        try
+        {
+          const mx::Array           array = build();
+          const mx::SerializedArray serialized{array};
+          const std::size_t         size  = detail::nodeCacheDataOffset + serialized.getSize();
+
+          void* data = (ftruncate(fd, static_cast<off_t>(size)) == 0)
+                       ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+
+          if (data == MAP_FAILED)
+          {
+            throw mx::Exception{"matlabw:mex:NodeCache:publish", "failed to map shared memory segment"};
+          }
+
+          ::close(fd);
+
+          std::byte* out = static_cast<std::byte*>(data) + detail::nodeCacheDataOffset;
+
+          for (const mx::View<std::byte> segment : serialized.getSegments())
+          {
+            out = std::copy(segment.begin(), segment.end(), out);
+          }
+
+          // the published data are mapped read-only like in the other processes
+          mprotect(data, size, PROT_READ);
+
+          mData     = static_cast<const std::byte*>(data);
+          mDataSize = size;
+        }
+        catch (...)
+        {
+          ::close(fd);
+          mHeader->status.store(detail::nodeCacheFailed, std::memory_order_release);
+          shm_unlink(mName.c_str());
+          unmap(false);
+          throw;
+        }
+
+        publish();
+
+        return detail::NodeCacheAttempt::mapped;
+#     elif defined(MATLABW_NODE_CACHE_WIN32)
+        // a file mapping can not be resized, the tree is built before the name is claimed
+        const mx::Array           array = build();
+        const mx::SerializedArray serialized{array};
+        const std::size_t         size  = detail::nodeCacheDataOffset + serialized.getSize();
+
+        mHandle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                     static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+                                     static_cast<DWORD>(size & 0xffffffff), mName.c_str());
+
+        if (mHandle == nullptr)
+        {
+          return detail::NodeCacheAttempt::local;
+        }
+
+        if (GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+          unmap(false);
+          return detail::NodeCacheAttempt::retry;
+        }
+
+        auto* data = static_cast<std::byte*>(MapViewOfFile(mHandle, FILE_MAP_WRITE, 0, 0, 0));
+
+        if (data == nullptr)
+        {
+          unmap(false);
+          return detail::NodeCacheAttempt::local;
+        }
+
+        mHeader = new (data) detail::NodeCacheHeader{};
+        mHeader->publisher.store(detail::getNodeCacheProcessId(), std::memory_order_relaxed);
+
+        std::byte* out = data + detail::nodeCacheDataOffset;
+
+        for (const mx::View<std::byte> segment : serialized.getSegments())
+        {
+          out = std::copy(segment.begin(), segment.end(), out);
+        }
+
+        // the same view serves as the header and the data, it is unmapped once
+        mData     = data;
+        mDataSize = size;
+
+        publish();
+
+        return detail::NodeCacheAttempt::mapped;
+#     else
+        static_cast<void>(build);
+        return detail::NodeCacheAttempt::local;
+#     endif
+      }
+
+      /// @brief Publishes the mapped data, this process holds the first reference.
+      void publish() noexcept
+      {
+        mHeader->magic   = detail::nodeCacheMagic;
+        mHeader->layout  = detail::nodeCacheLayout;
+        mHeader->version = mVersion;
+        mHeader->size    = mDataSize - detail::nodeCacheDataOffset;
+        mHeader->references.store(1, std::memory_order_relaxed);
+        mHeader->status.store(detail::nodeCacheReady, std::memory_order_release);
+
+        mPublisher = true;
+      }
+
+      /**
+       * @brief Unmaps the segment.
+       * @param release True to release the reference, the last reference removes the name.
+       */
+      void unmap(bool release) noexcept
+      {
+        if (mHeader != nullptr && release
+            && mHeader->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+#       if defined(MATLABW_NODE_CACHE_POSIX)
+          // no process can take a reference from 0, so the name is not reused before it is removed
+          shm_unlink(mName.c_str());
+#       endif
+        }
+
+#     if defined(MATLABW_NODE_CACHE_POSIX)
+        if (mData != nullptr)
+        {
+          munmap(const_cast<std::byte*>(mData), mDataSize);
+        }
+
+        if (mHeader != nullptr)
+        {
+          munmap(mHeader, detail::nodeCacheDataOffset);
+        }
+#     elif defined(MATLABW_NODE_CACHE_WIN32)
+        if (mData != nullptr && static_cast<const void*>(mData) != mHeader)
+        {
+          UnmapViewOfFile(mData);
+        }
+
+        if (mHeader != nullptr)
+        {
+          UnmapViewOfFile(mHeader);
+        }
+
+        if (mHandle != nullptr)
+        {
+          CloseHandle(std::exchange(mHandle, nullptr));
+        }
+#     endif
+        mHeader   = nullptr;
+        mData     = nullptr;
+        mDataSize = 0;
+      }
+
+      std::string              mName{};      ///< The system name of the segment.
+      std::uint32_t            mVersion{};   ///< Version of the data.
+      detail::NodeCacheHeader* mHeader{};    ///< The writable mapping of the header, null if built locally.
+      const std::byte*         mData{};      ///< The read-only mapping of the segment.
+      std::size_t              mDataSize{};  ///< Size of the data mapping in bytes.
+      bool                     mPublisher{}; ///< True if this process published the tree.
+      std::vector<std::byte>   mLocal{};     ///< The serialized tree if built locally.
+#   if defined(MATLABW_NODE_CACHE_WIN32)
+      HANDLE                   mHandle{};    ///< The file mapping handle.
+#   endif
+  };
+
+  /**
+   * @brief Gets a node cache living across MEX function calls as a mex::State, so its reference is released by the
+   *        reset command and when the MEX file is cleared. The arguments are used only on the first call.
+   *
+   *          const auto& tables = mex::getNodeCache("mylib.tables", 1, [] { return buildTables(); });
+   *          const auto  view   = tables.getView<double>();
+   *
+   * @tparam Tag Tag distinguishing several node caches.
+   * @tparam Fn The build function type, returning the array tree.
+   * @param name The name of the segment, unique on the node.
+   * @param version Version of the data.
+   * @param build The build function.
+   * @param timeout Time to wait for another process publishing the tree.
+   * @return The node cache.
+   */
+  template<typename Tag = void, typename Fn>
+  [[nodiscard]] const NodeCache& getNodeCache(std::string_view          name,
+                                              std::uint32_t             version,
+                                              Fn&&                      build,
+                                              std::chrono::milliseconds timeout = NodeCache::defaultTimeout)
+  {
+    return State<NodeCache, Tag>::get(name, version, std::forward<Fn>(build), timeout);
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_NODE_CACHE_HPP */
@@ -0,0 +1,515 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_OBJECT_REGISTRY_HPP
+#define MATLABW_MEX_OBJECT_REGISTRY_HPP
+
+#include "detail/include.hpp"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "atExit.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Opaque handle of a registered object, 0 is never a valid handle.
+  using ObjectHandle = std::uint64_t;
+
+  /**
+   * @brief Table of objects owned by the MEX file and referenced from MATLAB by opaque handles. The table is split
+   *        into shards with their own mutex, so objects can be looked up from worker threads without contention.
+   *        Each slot carries a generation counter which is part of the handle, so handles of destroyed objects are
+   *        detected instead of reaching a recycled slot. While any object is registered the MEX file is locked.
+   *        Objects are added and removed on the MATLAB thread, lookups are thread-safe.
+   * @tparam T The type of the objects.
+   */
+  template<typename T>
+  class ObjectRegistry
+  {
+    public:
+      /// @brief Number of shards.
+      static constexpr std::size_t shardCount{16};
+
+      /// @brief Default constructor.
+      ObjectRegistry() = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      ObjectRegistry(const ObjectRegistry&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ObjectRegistry(ObjectRegistry&&) = delete;
+
+      /// @brief Destructor. Destroys all objects.
+      ~ObjectRegistry() noexcept
+      {
+        clear();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ObjectRegistry& operator=(const ObjectRegistry&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ObjectRegistry& operator=(ObjectRegistry&&) = delete;
+
+      /**
+       * @brief Registers an object.
+       * @param object The object, must not be null.
+       * @return The handle of the object.
+       */
+      [[nodiscard]] ObjectHandle add(std::unique_ptr<T> object)
+      {
+        if (object == nullptr)
+        {
+          throw mx::Exception{"matlabw:mex:ObjectRegistry:add", "object must not be null"};
+        }
+
+        const std::size_t shardIndex = mNextShard.fetch_add(1, std::memory_order_relaxed) % shardCount;
+        Shard&            shard      = mShards[shardIndex];
+
+        ObjectHandle handle{};
+
+        {
+          std::lock_guard lock{shard.mutex};
+
+          std::size_t slotIndex{};
+
+          if (!shard.freeSlots.empty())
+          {
+            slotIndex = shard.freeSlots.back();
+            shard.freeSlots.pop_back();
+          }
+          else
+          {
+            slotIndex = shard.slots.size();
+
+            if ((slotIndex + 1) * shardCount > std::numeric_limits<std::uint32_t>::max())
+            {
+              throw mx::Exception{"matlabw:mex:ObjectRegistry:add", "too many objects"};
+            }
+
+            shard.slots.emplace_back();
+          }
+
+          Slot& slot = shard.slots[slotIndex];
+
+          slot.object = std::move(object);
+          handle      = makeHandle(shardIndex, slotIndex, slot.generation);
+        }
+
+        if (mCount.fetch_add(1, std::memory_order_relaxed) == 0)
+        {
+          activate();
+        }
+
+        return handle;
+      }
+
+      /**
+       * @brief Constructs and registers an object.
+       * @tparam Args Constructor argument types.
+       * @param args Constructor arguments.
+       * @return The handle of the object.
+       */
+      template<typename... Args>
+      [[nodiscard]] ObjectHandle emplace(Args&&... args)
+      {
+        return add(std::make_unique<T>(std::forward<Args>(args)...));
+      }
+
+      /**
+       * @brief Finds an object. The object must not be destroyed while it is used.
+       * @param handle The handle of the object.
+       * @return Pointer to the object, nullptr if the handle is invalid or stale.
+       */
+      [[nodiscard]] T* find(ObjectHandle handle) const noexcept
+      {
+        const auto [shardIndex, slotIndex, generation] = splitHandle(handle);
+
+        if (shardIndex >= shardCount)
+        {
+          return nullptr;
+        }
+
+        const Shard&    shard = mShards[shardIndex];
+        std::lock_guard lock{shard.mutex};
+
+        if (slotIndex >= shard.slots.size() || shard.slots[slotIndex].generation != generation)
+        {
+          return nullptr;
+        }
+
+        return shard.slots[slotIndex].object.get();
+      }
+
+      /**
+       * @brief Gets an object. The object must not be destroyed while it is used.
+       * @param handle The handle of the object.
+       * @return Reference to the object.
+       */
+      [[nodiscard]] T& get(ObjectHandle handle) const
+      {
+        T* object = find(handle);
+
+        if (object == nullptr)
+        {
+          throw mx::Exception{"matlabw:mex:ObjectRegistry:invalidHandle", "invalid or deleted object handle"};
+        }
+
+        return *object;
+      }
+
+      /**
+       * @brief Destroys an object, its handle becomes stale.
+       * @param handle The handle of the object.
+       * @return True if the object was destroyed, false if the handle is invalid or stale.
+       */
+      bool remove(ObjectHandle handle) noexcept
+      {
+        const auto [shardIndex, slotIndex, generation] = splitHandle(handle);
+
+        if (shardIndex >= shardCount)
+        {
+          return false;
+        }
+
+        std::unique_ptr<T> object{};
+
+        {
+          Shard&          shard = mShards[shardIndex];
+          std::lock_guard lock{shard.mutex};
+
+          if (slotIndex >= shard.slots.size() || shard.slots[slotIndex].generation != generation ||
+              shard.slots[slotIndex].object == nullptr)
+          {
+            return false;
+          }
+
+          Slot& slot = shard.slots[slotIndex];
+
+          object = std::move(slot.object);
+          ++slot.generation;
+          shard.freeSlots.push_back(slotIndex);
+        }
+
+        // The object is destroyed outside of the lock, its destructor may use the registry.
+        object.reset();
+
+        if (mCount.fetch_sub(1, std::memory_order_relaxed) == 1)
+        {
+          deactivate();
+        }
+
+        return true;
+      }
+
+      /// @brief Destroys all objects, all handles become stale.
+      void clear() noexcept
+      {
+        for (std::size_t shardIndex{}; shardIndex < shardCount; ++shardIndex)
+        {
+          std::vector<std::unique_ptr<T>> objects{};
+
+          {
+            Shard&          shard = mShards[shardIndex];
+            std::lock_guard lock{shard.mutex};
+
+            for (std::size_t slotIndex{}; slotIndex < shard.slots.size(); ++slotIndex)
+            {
+              Slot& slot = shard.slots[slotIndex];
+
+              if (slot.object != nullptr)
+              {
+                objects.push_back(std::move(slot.object));
+                ++slot.generation;
+                shard.freeSlots.push_back(slotIndex);
+              }
+            }
+          }
+
+          mCount.fetch_sub(objects.size(), std::memory_order_relaxed);
+        }
+
+        deactivate();
+      }
+
+      /**
+       * @brief Gets the number of registered objects.
+       * @return The number of objects.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mCount.load(std::memory_order_relaxed);
+      }
+    private:
+      /// @brief Slot of an object.
+      struct Slot
+      {
+        std::unique_ptr<T> object{};     ///< The object, null if the slot is free.
+        std::uint32_t      generation{1}; ///< Generation of the slot, incremented when the object is destroyed.
+      };
+
+      /// @brief Shard of the table, aligned to a cache line to avoid false sharing.
+      struct alignas(64) Shard
+      {
+        mutable std::mutex       mutex{};     ///< Mutex guarding the shard.
+        std::vector<Slot>        slots{};     ///< The slots.
+        std::vector<std::size_t> freeSlots{}; ///< Indices of the free slots.
+      };
+
+      /// @brief Parts of a handle.
+      struct HandleParts
+      {
+        std::size_t   shardIndex; ///< Index of the shard.
+        std::size_t   slotIndex;  ///< Index of the slot in the shard.
+        std::uint32_t generation; ///< Generation of the slot.
+      };
+
+      /**
+       * @brief Makes a handle, the generation is stored in the high 32 bits and the slot and shard in the low 32 bits.
+       * @param shardIndex Index of the shard.
+       * @param slotIndex Index of the slot in the shard.
+       * @param generation Generation of the slot.
+       * @return The handle.
+       */
+      [[nodiscard]] static ObjectHandle makeHandle(std::size_t   shardIndex,
+                                                   std::size_t   slotIndex,
+                                                   std::uint32_t generation) noexcept
+      {
+        return (ObjectHandle{generation} << 32) | ObjectHandle{slotIndex * shardCount + shardIndex};
+      }
+
+      /**
+       * @brief Splits a handle into its parts.
+       * @param handle The handle.
+       * @return The parts, the shard index is out of range for handle 0.
+       */
+      [[nodiscard]] static HandleParts splitHandle(ObjectHandle handle) noexcept
+      {
+        const auto generation = static_cast<std::uint32_t>(handle >> 32);
+        const auto index      = static_cast<std::size_t>(handle & 0xffffffffu);
+
+        // Generations start at 1, so handle 0 never matches a slot.
+        return HandleParts{(generation == 0) ? shardCount : index % shardCount, index / shardCount, generation};
+      }
+
+      /// @brief Locks the MEX file while objects are registered.
+      void activate()
+      {
+        std::lock_guard lock{mActiveMutex};
+
+        if (!mActive)
+        {
+          mexLock();
+          mActive = true;
+        }
+      }
+
+      /// @brief Unlocks the MEX file when no object is registered.
+      void deactivate() noexcept
+      {
+        std::lock_guard lock{mActiveMutex};
+
+        if (mActive && mCount.load(std::memory_order_relaxed) == 0)
+        {
+          mexUnlock();
+          mActive = false;
+        }
+      }
+
+      std::array<Shard, shardCount> mShards{};      ///< The shards.
+      std::atomic<std::size_t>      mNextShard{};   ///< Round-robin shard counter.
+      std::atomic<std::size_t>      mCount{};       ///< Number of registered objects.
+      std::mutex                    mActiveMutex{}; ///< Mutex guarding the lock state.
+      bool                          mActive{};      ///< Whether the registry locks the MEX file.
+  };
+
+  /**
+   * @brief Gets the object registry of a type shared by the whole MEX file. Its objects are destroyed when the MEX file
+   *        is cleared or MATLAB exits.
+   * @tparam T The type of the objects.
+   * @return The registry.
+   */
+  template<typename T>
+  [[nodiscard]] ObjectRegistry<T>& getObjectRegistry()
+  {
+    static ObjectRegistry<T> registry{};
+    static const bool        registered = (atExit([]{ registry.clear(); }), true);
+
+    static_cast<void>(registered);
+
+    return registry;
+  }
+
+  /**
+   * @brief Converts a handle to a MATLAB uint64 scalar.
+   * @param handle The handle.
+   * @return The scalar.
+   */
+  [[nodiscard]] inline mx::Array toHandleArray(ObjectHandle handle)
+  {
+    return mx::makeNumericScalar<std::uint64_t>(handle);
+  }
+
+  /**
+   * @brief Gets a handle from a MATLAB uint64 scalar or from the property of a class instance storing it.
+   * @param array The scalar or the object.
+   * @param propName Name of the property storing the handle in class instances.
+   * @return The handle.
+   */
+  [[nodiscard]] inline ObjectHandle toHandle(mx::ArrayCref array, const char* propName = "ObjectHandle")
+  {
+    static constexpr char id[]{"matlabw:mex:toHandle"};
+
+    if (array.isUint64() && !array.isComplex() && array.getSize() == 1)
+    {
+      return mx::TypedArrayCref<std::uint64_t>{array}[0];
+    }
+
+    if (array.isNumeric() || array.isChar() || array.isCell() || array.isStruct())
+    {
+      throw mx::Exception{id, "handle must be a uint64 scalar or an object with the property " + std::string{propName}};
+    }
+
+    mx::Array prop{mxGetProperty(array.get(), 0, propName)};
+
+    if (!prop.isValid())
+    {
+      throw mx::Exception{id, "object has no property " + std::string{propName}};
+    }
+
+    return toHandle(prop);
+  }
+
+  /**
+   * @brief Dispatches the calls of a MEX function to the methods of registered objects, the MATLAB side is typically a
+   *        handle class wrapping the handle. The first argument is the command:
+   *
+   *          h = myfunc('new', args...)        constructs an object and returns its handle
+   *          myfunc('delete', h)               destroys the object
+   *          [out...] = myfunc('cmd', h, in...)  calls the method registered as 'cmd' with in...
+   *
+   * @tparam T The type of the objects.
+   */
+  template<typename T>
+  class MethodDispatcher
+  {
+    public:
+      /// @brief Constructs an object from the arguments following 'new'.
+      using Constructor = std::function<std::unique_ptr<T>(mx::View<mx::ArrayCref> rhs)>;
+
+      /// @brief Method of an object, called with the arguments following the handle.
+      using Method = std::function<void(T& object, mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs)>;
+
+      /**
+       * @brief Constructor.
+       * @param constructor Constructs the objects.
+       * @param registry The registry holding the objects.
+       */
+      explicit MethodDispatcher(Constructor constructor, ObjectRegistry<T>& registry = getObjectRegistry<T>())
+      : mConstructor{std::move(constructor)}, mRegistry{&registry}
+      {}
+
+      /**
+       * @brief Registers a method.
+       * @param name The command of the method, must not be 'new' or 'delete'.
+       * @param method The method.
+       * @return Reference to this dispatcher.
+       */
+      MethodDispatcher& add(std::string name, Method method)
+      {
+        if (name == "new" || name == "delete")
+        {
+          throw mx::Exception{"matlabw:mex:MethodDispatcher:add", "'" + name + "' is a reserved command"};
+        }
+
+        mMethods.insert_or_assign(std::move(name), std::move(method));
+
+        return *this;
+      }
+
+      /**
+       * @brief Dispatches a call.
+       * @param lhs Left-hand side arguments.
+       * @param rhs Right-hand side arguments, the command followed by the handle and the method arguments.
+       */
+      void operator()(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs) const
+      {
+        static constexpr char id[]{"matlabw:mex:MethodDispatcher"};
+
+        if (rhs.empty() || !rhs[0].isChar())
+        {
+          throw mx::Exception{id, "first argument must be a command string"};
+        }
+
+        const std::string command = mx::toAscii(rhs[0]);
+
+        if (command == "new")
+        {
+          if (lhs.empty())
+          {
+            throw mx::Exception{id, "'new' requires an output for the handle"};
+          }
+
+          lhs[0] = toHandleArray(mRegistry->add(mConstructor(rhs.subspan(1))));
+          return;
+        }
+
+        if (rhs.size() < 2)
+        {
+          throw mx::Exception{id, "command '" + command + "' requires an object handle"};
+        }
+
+        const ObjectHandle handle = toHandle(rhs[1]);
+
+        if (command == "delete")
+        {
+          if (!mRegistry->remove(handle))
+          {
+            throw mx::Exception{"matlabw:mex:ObjectRegistry:invalidHandle", "invalid or deleted object handle"};
+          }
+
+          return;
+        }
+
+        const auto it = mMethods.find(command);
+
+        if (it == mMethods.end())
+        {
+          throw mx::Exception{id, "unknown command '" + command + "'"};
+        }
+
+        it->second(mRegistry->get(handle), lhs, rhs.subspan(2));
+      }
+    private:
+      Constructor                   mConstructor{}; ///< Constructs the objects.
+      ObjectRegistry<T>*            mRegistry{};    ///< The registry holding the objects.
+      std::map<std::string, Method> mMethods{};     ///< The methods by command.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_OBJECT_REGISTRY_HPP */
@@ -0,0 +1,166 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_OUTPUTS_HPP
+#define MATLABW_MEX_OUTPUTS_HPP
+
+#include "detail/include.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <type_traits>
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Helper for the left-hand side arguments which lets the function skip outputs the caller did not request.
+   *        At least one output is always requested, MATLAB stores it in ans when nlhs is 0.
+   */
+  class Outputs
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param lhs Left-hand side arguments passed to mex::Function.
+       */
+      explicit Outputs(mx::Span<mx::Array> lhs) noexcept
+      : mLhs{lhs.data(), std::max<std::size_t>(lhs.size(), 1)}
+      {}
+
+      /**
+       * @brief Constructor which checks the number of requested outputs.
+       * @param lhs Left-hand side arguments passed to mex::Function.
+       * @param maxCount Maximum number of outputs the function provides.
+       */
+      Outputs(mx::Span<mx::Array> lhs, std::size_t maxCount)
+      : Outputs{lhs}
+      {
+        if (lhs.size() > maxCount)
+        {
+          throw mx::StaticException{"MATLAB:nargoutchk:tooManyOutputs", "Too many output arguments."};
+        }
+      }
+
+      /// @brief Copy constructor.
+      Outputs(const Outputs&) noexcept = default;
+
+      /// @brief Destructor.
+      ~Outputs() noexcept = default;
+
+      /// @brief Copy assignment operator.
+      Outputs& operator=(const Outputs&) noexcept = default;
+
+      /**
+       * @brief Gets the number of requested outputs.
+       * @return The number of requested outputs, at least 1.
+       */
+      [[nodiscard]] std::size_t getCount() const noexcept
+      {
+        return mLhs.size();
+      }
+
+      /**
+       * @brief Checks if the output was requested by the caller.
+       * @param i Index of the output.
+       * @return True if the output was requested, false otherwise.
+       */
+      [[nodiscard]] bool wanted(std::size_t i) const noexcept
+      {
+        return i < mLhs.size();
+      }
+
+      /**
+       * @brief Sets the output if it was requested, otherwise the array is discarded.
+       * @param i Index of the output.
+       * @param array The array.
+       */
+      void set(std::size_t i, mx::Array&& array)
+      {
+        if (wanted(i))
+        {
+          mLhs[i] = std::move(array);
+        }
+      }
+
+      /**
+       * @brief Sets the output to the result of the producer. The producer runs only if the output was requested.
+       * @tparam Producer Type of the producer, callable without arguments and returning an array.
+       * @param i Index of the output.
+       * @param producer The producer.
+       * @return True if the producer was called, false otherwise.
+       */
+      template<typename Producer>
+        requires std::is_invocable_v<Producer&>
+      bool set(std::size_t i, Producer&& producer)
+      {
+        if (!wanted(i))
+        {
+          return false;
+        }
+
+        mLhs[i] = std::invoke(producer);
+
+        return true;
+      }
+
+      /**
+       * @brief Allocates an uninitialized numeric output if it was requested. The caller must fill every element.
+       * @tparam T Element type.
+       * @param i Index of the output.
+       * @param dims Dimensions of the output.
+       * @return Reference to the output, or std::nullopt if the output was not requested.
+       */
+      template<typename T>
+      [[nodiscard]] std::optional<mx::TypedArrayRef<T>> allocate(std::size_t i, mx::View<std::size_t> dims)
+      {
+        if (!wanted(i))
+        {
+          return std::nullopt;
+        }
+
+        mLhs[i] = mx::makeUninitNumericArray<T>(dims);
+
+        return mx::TypedArrayRef<T>{mx::ArrayRef{mLhs[i]}};
+      }
+
+      /**
+       * @brief Allocates an uninitialized 2-D numeric output if it was requested. The caller must fill every element.
+       * @tparam T Element type.
+       * @param i Index of the output.
+       * @param m Number of rows.
+       * @param n Number of columns.
+       * @return Reference to the output, or std::nullopt if the output was not requested.
+       */
+      template<typename T>
+      [[nodiscard]] std::optional<mx::TypedArrayRef<T>> allocate(std::size_t i, std::size_t m, std::size_t n)
+      {
+        return allocate<T>(i, {{m, n}});
+      }
+    private:
+      mx::Span<mx::Array> mLhs; ///< The requested outputs.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_OUTPUTS_HPP */
@@ -0,0 +1,371 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_PERSISTENT_POOL_HPP
+#define MATLABW_MEX_PERSISTENT_POOL_HPP
+
+#include "detail/include.hpp"
+
+#include "atExit.hpp"
+#include "memory.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Memory pool whose blocks survive between MEX function calls. Blocks are allocated with mxMalloc, marked
+   *        persistent and kept in power-of-two size-class freelists when deallocated. While the pool holds any memory
+   *        the MEX file is locked, so it cannot be cleared. All memory is released by release() or when MATLAB
+   *        exits. The pool is not thread-safe and must be used from the MATLAB thread only.
+   */
+  class PersistentPool
+  {
+    public:
+      /// @brief Size of the smallest size class in bytes.
+      static constexpr std::size_t minBlockSize{64};
+
+      /// @brief Number of size classes.
+      static constexpr std::size_t sizeClassCount{std::numeric_limits<std::size_t>::digits};
+
+      /// @brief Default constructor.
+      PersistentPool() noexcept = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      PersistentPool(const PersistentPool&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      PersistentPool(PersistentPool&&) = delete;
+
+      /// @brief Destructor. Releases all memory.
+      ~PersistentPool() noexcept
+      {
+        release();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      PersistentPool& operator=(const PersistentPool&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      PersistentPool& operator=(PersistentPool&&) = delete;
+
+      /**
+       * @brief Allocates persistent memory.
+       * @param size The size of the memory in bytes.
+       * @return A pointer to the memory aligned to alignof(std::max_align_t). Never returns nullptr.
+       * @throws std::bad_alloc if the memory cannot be allocated or the size exceeds half of the address space.
+       */
+      [[nodiscard]] void* allocate(std::size_t size)
+      {
+        // The class size of larger sizes does not fit, minBlockSize << sizeClass would wrap to zero.
+        if (size > (std::numeric_limits<std::size_t>::max() >> 1))
+        {
+          throw std::bad_alloc();
+        }
+
+        const std::size_t sizeClass = getSizeClass(size);
+
+        if (Header* header = mFreeLists[sizeClass])
+        {
+          mFreeLists[sizeClass] = header->nextFree;
+          header->nextFree      = nullptr;
+          mBytesCached         -= getClassSize(sizeClass);
+          mBytesInUse          += getClassSize(sizeClass);
+
+          return header + 1;
+        }
+
+        const std::size_t classSize = getClassSize(sizeClass);
+
+        if (classSize > std::numeric_limits<std::size_t>::max() - sizeof(Header))
+        {
+          throw std::bad_alloc();
+        }
+
+        auto header = static_cast<Header*>(mx::malloc(sizeof(Header) + classSize));
+
+        if (header == nullptr)
+        {
+          throw std::bad_alloc();
+        }
+
+        makePersistent(header);
+
+        header->prev      = nullptr;
+        header->next      = mBlocks;
+        header->nextFree  = nullptr;
+        header->sizeClass = sizeClass;
+
+        if (mBlocks != nullptr)
+        {
+          mBlocks->prev = header;
+        }
+
+        mBlocks      = header;
+        mBytesInUse += classSize;
+
+        activate();
+
+        return header + 1;
+      }
+
+      /**
+       * @brief Returns memory to the pool. The memory is kept for later allocations of the same size class.
+       * @param ptr A pointer to the memory returned by allocate(). May be nullptr.
+       */
+      void deallocate(void* ptr) noexcept
+      {
+        if (ptr != nullptr)
+        {
+          Header* header = static_cast<Header*>(ptr) - 1;
+
+          header->nextFree             = mFreeLists[header->sizeClass];
+          mFreeLists[header->sizeClass] = header;
+          mBytesInUse                 -= getClassSize(header->sizeClass);
+          mBytesCached                += getClassSize(header->sizeClass);
+        }
+      }
+
+      /// @brief Frees all cached blocks which are not in use. Unlocks the MEX file if no memory is in use.
+      void trim() noexcept
+      {
+        for (Header*& freeList : mFreeLists)
+        {
+          while (freeList != nullptr)
+          {
+            Header* header = std::exchange(freeList, freeList->nextFree);
+
+            unlink(header);
+            mx::free(header);
+          }
+        }
+
+        mBytesCached = 0;
+
+        if (mBlocks == nullptr)
+        {
+          deactivate();
+        }
+      }
+
+      /// @brief Frees all blocks including the ones in use and unlocks the MEX file.
+      void release() noexcept
+      {
+        while (mBlocks != nullptr)
+        {
+          mx::free(std::exchange(mBlocks, mBlocks->next));
+        }
+
+        mFreeLists.fill(nullptr);
+        mBytesInUse  = 0;
+        mBytesCached = 0;
+
+        deactivate();
+      }
+
+      /**
+       * @brief Gets the number of bytes handed out by the pool.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBytesInUse() const noexcept
+      {
+        return mBytesInUse;
+      }
+
+      /**
+       * @brief Gets the number of bytes kept in the freelists.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBytesCached() const noexcept
+      {
+        return mBytesCached;
+      }
+
+      /**
+       * @brief Checks if the pool holds any memory and so keeps the MEX file locked.
+       * @return True if the pool is active, false otherwise.
+       */
+      [[nodiscard]] bool isActive() const noexcept
+      {
+        return mActive;
+      }
+    private:
+      /// @brief Header stored in front of each block.
+      struct alignas(std::max_align_t) Header
+      {
+        Header*     prev;      ///< Previous block in the list of all blocks.
+        Header*     next;      ///< Next block in the list of all blocks.
+        Header*     nextFree;  ///< Next block in the freelist.
+        std::size_t sizeClass; ///< Size class of the block.
+      };
+
+      /**
+       * @brief Gets the size class for a size.
+       * @param size The size in bytes.
+       * @return The size class.
+       */
+      [[nodiscard]] static std::size_t getSizeClass(std::size_t size) noexcept
+      {
+        constexpr std::size_t minClassBits = std::bit_width(minBlockSize - 1);
+
+        return static_cast<std::size_t>(std::bit_width(std::max(size, minBlockSize) - 1)) - minClassBits;
+      }
+
+      /**
+       * @brief Gets the size of the blocks of a size class.
+       * @param sizeClass The size class.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] static std::size_t getClassSize(std::size_t sizeClass) noexcept
+      {
+        return minBlockSize << sizeClass;
+      }
+
+      /**
+       * @brief Removes a block from the list of all blocks.
+       * @param header The block.
+       */
+      void unlink(Header* header) noexcept
+      {
+        if (header->prev != nullptr)
+        {
+          header->prev->next = header->next;
+        }
+        else
+        {
+          mBlocks = header->next;
+        }
+
+        if (header->next != nullptr)
+        {
+          header->next->prev = header->prev;
+        }
+      }
+
+      /// @brief Locks the MEX file and registers the exit handler when the first block is allocated.
+      void activate()
+      {
+        if (!mActive)
+        {
+          if (!mExitHandlerRegistered)
+          {
+            atExit([this]{ release(); });
+            mExitHandlerRegistered = true;
+          }
+
+          mexLock();
+          mActive = true;
+        }
+      }
+
+      /// @brief Unlocks the MEX file when the pool does not hold any memory.
+      void deactivate() noexcept
+      {
+        if (mActive)
+        {
+          mexUnlock();
+          mActive = false;
+        }
+      }
+
+      std::array<Header*, sizeClassCount> mFreeLists{};              ///< Freelists of the size classes.
+      Header*                             mBlocks{};                 ///< List of all blocks.
+      std::size_t                         mBytesInUse{};             ///< Number of bytes in use.
+      std::size_t                         mBytesCached{};            ///< Number of bytes in the freelists.
+      bool                                mActive{};                 ///< Whether the pool locks the MEX file.
+      bool                                mExitHandlerRegistered{};  ///< Whether the exit handler is registered.
+  };
+
+  /**
+   * @brief Gets the persistent pool shared by the whole MEX file.
+   * @return The persistent pool.
+   */
+  [[nodiscard]] inline PersistentPool& getPersistentPool() noexcept
+  {
+    static PersistentPool pool{};
+
+    return pool;
+  }
+
+  /**
+   * @brief Allocator for use with std containers which allocates from the persistent pool. Containers using this
+   *        allocator keep their memory between MEX function calls.
+   * @tparam T The type of the allocated memory.
+   */
+  template<typename T>
+  class PersistentAllocator
+  {
+    public:
+      using value_type = T; ///< The type of the allocated memory.
+
+      /// @brief Default constructor.
+      PersistentAllocator() noexcept = default;
+
+      /**
+       * @brief Copy constructor.
+       * @tparam U The type of the allocated memory.
+       * @param other The allocator to copy.
+       */
+      template<typename U>
+      PersistentAllocator(const PersistentAllocator<U>&) noexcept {}
+
+      /**
+       * @brief Allocates memory.
+       * @param n The number of elements to allocate.
+       * @return A pointer to the allocated memory.
+       */
+      [[nodiscard]] T* allocate(std::size_t n)
+      {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+          throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(getPersistentPool().allocate(n * sizeof(T)));
+      }
+
+      /**
+       * @brief Deallocates memory.
+       * @param ptr A pointer to the allocated memory.
+       * @param n The number of elements to deallocate.
+       */
+      void deallocate(T* ptr, std::size_t) noexcept
+      {
+        getPersistentPool().deallocate(ptr);
+      }
+
+      /**
+       * @brief Compares two allocators. All persistent allocators are equal.
+       * @tparam U The type of the other allocator.
+       * @return Always true.
+       */
+      template<typename U>
+      [[nodiscard]] bool operator==(const PersistentAllocator<U>&) const noexcept
+      {
+        return true;
+      }
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_PERSISTENT_POOL_HPP */
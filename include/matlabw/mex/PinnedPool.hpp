@@ -0,0 +1,78 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_PINNED_POOL_HPP
+#define MATLABW_MEX_PINNED_POOL_HPP
+
+#include "detail/include.hpp"
+
+#include <matlabw/mx/gpu/PinnedPool.hpp>
+
+#include "atExit.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Gets the pinned pool shared by the whole MEX file. Its memory survives between MEX function calls and is
+   *        released when the MEX file is cleared or MATLAB exits. Requires GPU support and linking the CUDA runtime.
+   * @return The pinned pool.
+   */
+  [[nodiscard]] inline mx::gpu::PinnedPool& getPinnedPool()
+  {
+    static mx::gpu::PinnedPool pool{};
+    static const bool          registered = (atExit([]{ pool.release(); }), true);
+
+    static_cast<void>(registered);
+
+    return pool;
+  }
+
+  /**
+   * @brief Allocator for use with std containers which allocates from the shared pinned pool, e.g. host staging
+   *        buffers kept between calls.
+   * @tparam T The type of the allocated memory.
+   */
+  template<typename T>
+  class PinnedAllocator : public mx::gpu::PinnedAllocator<T>
+  {
+    public:
+      /// @brief Default constructor.
+      PinnedAllocator()
+      : mx::gpu::PinnedAllocator<T>{getPinnedPool()}
+      {}
+
+      /**
+       * @brief Copy constructor.
+       * @tparam U The type of the allocated memory.
+       * @param other The allocator to copy.
+       */
+      template<typename U>
+      PinnedAllocator(const PinnedAllocator<U>& other) noexcept
+      : mx::gpu::PinnedAllocator<T>{other}
+      {}
+
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_PINNED_POOL_HPP */
@@ -0,0 +1,228 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_PRINTER_HPP
+#define MATLABW_MEX_PRINTER_HPP
+
+#include "detail/include.hpp"
+
+#include <chrono>
+
+#include "detail/format.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Options of the buffered printer.
+  struct PrinterOptions
+  {
+    std::size_t               capacity{4096};     ///< Size of the buffer in bytes.
+    std::size_t               maxLines{64};       ///< Number of buffered lines that triggers a flush.
+    std::chrono::milliseconds flushInterval{100}; ///< Time since the last flush that triggers a flush.
+  };
+
+  /**
+   * @brief Buffered printer to the MATLAB command window. Output is collected in a fixed-size buffer and passed to
+   *        mexPrintf when the buffer fills, after a number of lines, after a time interval, on flush() and on
+   *        destruction; the printer shared by the MEX file is also flushed when the MEX function call ends. Formatting
+   *        is type-safe and uses a subset of the std::format syntax. Must be used from the MATLAB thread only.
+   */
+  class Printer
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param options The options.
+       */
+      explicit Printer(const PrinterOptions& options = {})
+      : mOptions{options}
+      {
+        mOptions.capacity = std::max(mOptions.capacity, std::size_t{1});
+        mBuffer.reserve(mOptions.capacity);
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      Printer(const Printer&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      Printer(Printer&&) = delete;
+
+      /// @brief Destructor. Flushes the buffer.
+      ~Printer() noexcept
+      {
+        flush();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Printer& operator=(const Printer&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      Printer& operator=(Printer&&) = delete;
+
+      /**
+       * @brief Prints formatted output, e.g. print("iteration {}: residual {:.3e}\n", i, r).
+       * @tparam Args Argument types.
+       * @param format Format string with "{}" or "{:[.precision][type]}" replacement fields.
+       * @param args Arguments.
+       */
+      template<typename... Args>
+      void print(std::string_view format, const Args&... args)
+      {
+        const std::size_t oldSize = mBuffer.size();
+
+        try
+        {
+          detail::formatTo(mBuffer, format, args...);
+        }
+        catch (...)
+        {
+          mBuffer.resize(oldSize);
+          throw;
+        }
+
+        mLineCount += static_cast<std::size_t>(std::count(mBuffer.begin() + static_cast<std::ptrdiff_t>(oldSize),
+                                                          mBuffer.end(),
+                                                          '\n'));
+
+        if (mBuffer.size() >= mOptions.capacity || mLineCount >= mOptions.maxLines ||
+            Clock::now() - mLastFlush >= mOptions.flushInterval)
+        {
+          flush();
+        }
+      }
+
+      /// @brief Passes the buffered output to MATLAB.
+      void flush() noexcept
+      {
+        if (!mBuffer.empty())
+        {
+          mexPrintf("%s", mBuffer.c_str());
+          mBuffer.clear();
+
+          if (mBuffer.capacity() > mOptions.capacity)
+          {
+            mBuffer.shrink_to_fit();
+            mBuffer.reserve(mOptions.capacity);
+          }
+        }
+
+        mLineCount = 0;
+        mLastFlush = Clock::now();
+      }
+    private:
+      using Clock = std::chrono::steady_clock; ///< Clock of the flush interval.
+
+      PrinterOptions    mOptions;                 ///< The options.
+      std::string       mBuffer{};                ///< The buffered output.
+      std::size_t       mLineCount{};             ///< Number of buffered lines.
+      Clock::time_point mLastFlush{Clock::now()}; ///< Time of the last flush.
+  };
+
+  /**
+   * @brief Gets the printer shared by the whole MEX file, flushed when each MEX function call ends.
+   * @return The printer.
+   */
+  [[nodiscard]] inline Printer& getPrinter()
+  {
+    static Printer printer{};
+
+    return printer;
+  }
+
+  /**
+   * @brief Prints formatted output through the shared buffered printer.
+   * @tparam Args Argument types.
+   * @param format Format string with "{}" or "{:[.precision][type]}" replacement fields.
+   * @param args Arguments.
+   */
+  template<typename... Args>
+  void print(std::string_view format, const Args&... args)
+  {
+    getPrinter().print(format, args...);
+  }
+
+  /**
+   * @brief Rate-limited progress reporter. Reports arriving faster than the maximum rate are dropped before they are
+   *        formatted, so calling it from inner loops costs one clock read. Printed reports are flushed immediately.
+   */
+  class ProgressReporter
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param maxRate The maximum number of reports per second.
+       * @param printer The printer, must outlive the reporter.
+       */
+      explicit ProgressReporter(double maxRate = 10.0, Printer& printer = getPrinter())
+      : mPrinter{printer},
+        mMinInterval{std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>{1.0 / maxRate})}
+      {}
+
+      /**
+       * @brief Reports the progress unless the previous report was less than 1 / maxRate seconds ago.
+       * @tparam Args Argument types.
+       * @param format Format string with "{}" or "{:[.precision][type]}" replacement fields.
+       * @param args Arguments.
+       * @return True if the report was printed, false if it was dropped.
+       */
+      template<typename... Args>
+      bool report(std::string_view format, const Args&... args)
+      {
+        const Clock::time_point now = Clock::now();
+
+        if (mHasReported && now - mLastReport < mMinInterval)
+        {
+          return false;
+        }
+
+        mHasReported = true;
+        mLastReport  = now;
+
+        reportAlways(format, args...);
+
+        return true;
+      }
+
+      /**
+       * @brief Reports the progress regardless of the rate, e.g. the final state.
+       * @tparam Args Argument types.
+       * @param format Format string with "{}" or "{:[.precision][type]}" replacement fields.
+       * @param args Arguments.
+       */
+      template<typename... Args>
+      void reportAlways(std::string_view format, const Args&... args)
+      {
+        mPrinter.print(format, args...);
+        mPrinter.flush();
+      }
+    private:
+      using Clock = std::chrono::steady_clock; ///< Clock of the rate limit.
+
+      Printer&          mPrinter;       ///< The printer.
+      Clock::duration   mMinInterval;   ///< The minimum interval between reports.
+      Clock::time_point mLastReport{};  ///< Time of the last report.
+      bool              mHasReported{}; ///< Whether any report was printed.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_PRINTER_HPP */
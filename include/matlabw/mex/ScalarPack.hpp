@@ -0,0 +1,269 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MEX_SCALAR_PACK_HPP
+#define MATLABW_MEX_SCALAR_PACK_HPP
+
+#include "detail/include.hpp"
+
+#include "memory.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Representation of packed scalar results.
+  enum class ScalarPackLayout
+  {
+    vector,    ///< One n-by-1 double vector, the names are returned by ScalarPack::buildNames()
+    structure, ///< One scalar struct with a 1-by-1 double field per name
+  };
+
+  /**
+   * @brief Named double scalars returned as a single output. The field names are fixed on construction and the values
+   *        set by position or name on every call. The vector layout returns two arrays in total and the names are
+   *        decoded once into a persistent cell array, later calls get a duplicate of it. The structure layout creates
+   *        the struct from the precomputed name pointers and sets the fields by number without name lookups. Must be
+   *        used from the MATLAB thread only.
+   */
+  class ScalarPack
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param names The names of the scalars, must be non-empty and unique.
+       */
+      explicit ScalarPack(std::vector<std::string> names)
+      : mNames{std::move(names)}, mNamePtrs(mNames.size()), mValues(mNames.size())
+      {
+        for (std::size_t k{}; k < mNames.size(); ++k)
+        {
+          if (mNames[k].empty())
+          {
+            throw mx::Exception{"matlabw:mex:ScalarPack", "names must not be empty"};
+          }
+
+          for (std::size_t j{}; j < k; ++j)
+          {
+            if (mNames[j] == mNames[k])
+            {
+              throw mx::Exception{"matlabw:mex:ScalarPack", "duplicate name '" + mNames[k] + "'"};
+            }
+          }
+
+          mNamePtrs[k] = mNames[k].c_str();
+        }
+      }
+
+      /**
+       * @brief Constructor.
+       * @param names The names of the scalars, must be non-empty and unique.
+       */
+      ScalarPack(std::initializer_list<std::string_view> names)
+      : ScalarPack{std::vector<std::string>(names.begin(), names.end())}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      ScalarPack(const ScalarPack&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ScalarPack(ScalarPack&&) = delete;
+
+      /// @brief Destructor. Destroys the cached names.
+      ~ScalarPack() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ScalarPack& operator=(const ScalarPack&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ScalarPack& operator=(ScalarPack&&) = delete;
+
+      /**
+       * @brief Gets the number of scalars.
+       * @return The number of scalars.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mNames.size();
+      }
+
+      /**
+       * @brief Gets the name of a scalar.
+       * @param k The position of the scalar.
+       * @return The name.
+       */
+      [[nodiscard]] const std::string& getName(std::size_t k) const
+      {
+        return mNames.at(k);
+      }
+
+      /**
+       * @brief Gets the position of a scalar.
+       * @param name The name of the scalar.
+       * @return The position.
+       */
+      [[nodiscard]] std::size_t getIndex(std::string_view name) const
+      {
+        for (std::size_t k{}; k < mNames.size(); ++k)
+        {
+          if (mNames[k] == name)
+          {
+            return k;
+          }
+        }
+
+        throw mx::Exception{"matlabw:mex:ScalarPack:getIndex", "unknown name '" + std::string{name} + "'"};
+      }
+
+      /**
+       * @brief Gets the values of the scalars.
+       * @return The values in the order of the names.
+       */
+      [[nodiscard]] std::span<double> getValues() noexcept
+      {
+        return mValues;
+      }
+
+      /// @copydoc getValues
+      [[nodiscard]] std::span<const double> getValues() const noexcept
+      {
+        return mValues;
+      }
+
+      /**
+       * @brief Sets a value by position.
+       * @param k The position of the scalar.
+       * @param value The value.
+       */
+      void set(std::size_t k, double value)
+      {
+        mValues.at(k) = value;
+      }
+
+      /**
+       * @brief Sets a value by name.
+       * @param name The name of the scalar.
+       * @param value The value.
+       */
+      void set(std::string_view name, double value)
+      {
+        mValues[getIndex(name)] = value;
+      }
+
+      /// @brief Sets all values to zero.
+      void clear() noexcept
+      {
+        std::fill(mValues.begin(), mValues.end(), 0.0);
+      }
+
+      /**
+       * @brief Builds the output array.
+       * @param layout The representation of the scalars.
+       * @return A new array owned by the caller.
+       */
+      [[nodiscard]] mx::Array build(ScalarPackLayout layout) const
+      {
+        return (layout == ScalarPackLayout::structure) ? buildStruct() : buildVector();
+      }
+
+      /**
+       * @brief Builds the n-by-1 vector of the values.
+       * @return A new double array owned by the caller.
+       */
+      [[nodiscard]] mx::Array buildVector() const
+      {
+        auto array = mx::makeUninitNumericArray<double>(mValues.size(), 1);
+
+        std::copy(mValues.begin(), mValues.end(), array.getData());
+
+        return mx::Array{std::move(array)};
+      }
+
+      /**
+       * @brief Builds the scalar struct of the values.
+       * @return A new struct array owned by the caller.
+       */
+      [[nodiscard]] mx::Array buildStruct() const
+      {
+        static constexpr char id[]{"matlabw:mex:ScalarPack:buildStruct"};
+
+        const std::size_t dims[]{1, 1};
+
+        mxArray* ptr = mxCreateStructArray(2,
+                                           dims,
+                                           static_cast<int>(mNamePtrs.size()),
+                                           const_cast<const char**>(mNamePtrs.data()));
+
+        if (ptr == nullptr)
+        {
+          throw mx::Exception{id, "failed to create struct array"};
+        }
+
+        mx::Array array{std::move(ptr)};
+
+        for (std::size_t k{}; k < mValues.size(); ++k)
+        {
+          mxArray* leaf = mxCreateDoubleScalar(mValues[k]);
+
+          if (leaf == nullptr)
+          {
+            throw mx::Exception{id, "failed to create scalar"};
+          }
+
+          mxSetFieldByNumber(array.get(), 0, static_cast<int>(k), leaf);
+        }
+
+        return array;
+      }
+
+      /**
+       * @brief Builds the n-by-1 cell array of the names matching buildVector().
+       * @return A new cell array owned by the caller.
+       */
+      [[nodiscard]] mx::Array buildNames()
+      {
+        if (!mNameCell.isValid())
+        {
+          auto cell = mx::makeCellArray(mNames.size(), 1);
+
+          for (std::size_t k{}; k < mNames.size(); ++k)
+          {
+            mxSetCell(cell.get(), k, mx::fromUtf8(mNames[k]).release());
+          }
+
+          mx::Array array{std::move(cell)};
+
+          makePersistent(array);
+
+          mNameCell = std::move(array);
+        }
+
+        return mx::Array{mx::ArrayCref{mNameCell}};
+      }
+    private:
+      std::vector<std::string> mNames;    ///< Names of the scalars
+      std::vector<const char*> mNamePtrs; ///< Names of the scalars as passed to mxCreateStructArray
+      std::vector<double>      mValues;   ///< Values of the scalars
+      mx::Array                mNameCell; ///< Persistent cell array of the names, created on first use
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_SCALAR_PACK_HPP */
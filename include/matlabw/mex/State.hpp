@@ -0,0 +1,179 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_STATE_HPP
+#define MATLABW_MEX_STATE_HPP
+
+#include "detail/include.hpp"
+
+#include "atExit.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Command which resets all states when passed as the only argument, e.g. myfunc('matlabw:resetState').
+  inline constexpr char resetStateCommand[]{"matlabw:resetState"};
+
+namespace detail
+{
+  /**
+   * @brief Gets the reset functions of the states used by the MEX file.
+   * @return The reset functions.
+   */
+  [[nodiscard]] inline std::vector<void(*)() noexcept>& getStateResetters() noexcept
+  {
+    static std::vector<void(*)() noexcept> resetters{};
+
+    return resetters;
+  }
+
+  /// @brief Resets all states in the reverse order of their first construction.
+  inline void resetStates() noexcept
+  {
+    auto& resetters = getStateResetters();
+
+    for (auto it = resetters.rbegin(); it != resetters.rend(); ++it)
+    {
+      (*it)();
+    }
+  }
+
+  /**
+   * @brief Checks if an argument is the char array of a reserved command.
+   * @param array The argument.
+   * @param command The command.
+   * @return True if the argument is the command.
+   */
+  [[nodiscard]] inline bool isCommandArg(const mxArray* array, std::string_view command) noexcept
+  {
+    if (!mxIsChar(array) || mxGetNumberOfElements(array) != command.size())
+    {
+      return false;
+    }
+
+    const auto* chars = static_cast<const char16_t*>(mxGetData(array));
+
+    return std::equal(command.begin(), command.end(), chars, [](char a, char16_t b)
+    {
+      return static_cast<char16_t>(a) == b;
+    });
+  }
+
+  /**
+   * @brief Checks if the call is the reset command. Only checked once a state has been constructed, so MEX files
+   *        without states see all arguments.
+   * @param nlhs Number of left-hand side arguments.
+   * @param nrhs Number of right-hand side arguments.
+   * @param prhs Right-hand side arguments.
+   * @return True if the call is the reset command.
+   */
+  [[nodiscard]] inline bool isResetStateCommand(int nlhs, int nrhs, const mxArray* const prhs[]) noexcept
+  {
+    return !getStateResetters().empty() && nlhs == 0 && nrhs == 1 && isCommandArg(prhs[0], resetStateCommand);
+  }
+} // namespace detail
+
+  /**
+   * @brief Object which lives across MEX function calls, e.g. lookup tables, thread pools or GPU handles which are
+   *        expensive to build. It is constructed on the first get() and the MEX file is locked while it is alive. It is
+   *        destroyed by reset(), by calling the MEX function with resetStateCommand as the only argument, or by the
+   *        MEX exit handler, whichever comes first. Must be used from the MATLAB thread only.
+   * @tparam T The type of the object.
+   * @tparam Tag Tag distinguishing several states of the same type.
+   */
+  template<typename T, typename Tag = void>
+  class State
+  {
+    public:
+      /// @brief Explicitly deleted default constructor, the class only has static members.
+      State() = delete;
+
+      /**
+       * @brief Gets the object, constructs it on the first call.
+       * @tparam Args Constructor argument types.
+       * @param args Constructor arguments, used only if the object is constructed.
+       * @return The object.
+       */
+      template<typename... Args>
+      [[nodiscard]] static T& get(Args&&... args)
+      {
+        Storage& storage = getStorage();
+
+        if (!storage.value.has_value())
+        {
+          if (!storage.registered)
+          {
+            atExit(reset);
+            detail::getStateResetters().push_back(reset);
+            storage.registered = true;
+          }
+
+          storage.value.emplace(std::forward<Args>(args)...);
+          mexLock();
+        }
+
+        return *storage.value;
+      }
+
+      /**
+       * @brief Checks if the object is alive.
+       * @return True if the object is alive.
+       */
+      [[nodiscard]] static bool isAlive() noexcept
+      {
+        return getStorage().value.has_value();
+      }
+
+      /// @brief Destroys the object and unlocks the MEX file. The next get() constructs a new object.
+      static void reset() noexcept
+      {
+        Storage& storage = getStorage();
+
+        if (storage.value.has_value())
+        {
+          storage.value.reset();
+          mexUnlock();
+        }
+      }
+    private:
+      /// @brief Storage of the object.
+      struct Storage
+      {
+        std::optional<T> value{};      ///< The object.
+        bool             registered{}; ///< Whether the reset function is registered.
+      };
+
+      /**
+       * @brief Gets the storage of the object.
+       * @return The storage.
+       */
+      [[nodiscard]] static Storage& getStorage() noexcept
+      {
+        static Storage storage{};
+
+        return storage;
+      }
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_STATE_HPP */
@@ -0,0 +1,299 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MEX_STREAM_CHANNEL_HPP
+#define MATLABW_MEX_STREAM_CHANNEL_HPP
+
+#include "detail/include.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "AsyncJob.hpp"
+#include "memory.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Bounded ring of chunks streamed from a job to MATLAB, so MATLAB can process partial results while the job
+   *        runs instead of receiving everything on return. Every slot owns a persistent buffer allocated on the MATLAB
+   *        thread. The job acquires the next free slot, writes a chunk into it in place and commits it, waiting while
+   *        all slots are full. Popping a chunk hands its buffer over to the returned array without copying and
+   *        allocates a fresh buffer for the slot. Typically created by the launcher of a JobDispatcher:
+   *
+   *          auto stream = std::make_shared<mex::StreamChannel<double>>(4, 65536);
+   *          return std::make_unique<mex::AsyncJob>([stream](mex::JobContext&) -> mex::JobOutputs
+   *          {
+   *            mx::Span<double> chunk = stream->acquire();
+   *            ...
+   *            stream->commit(chunk.size());
+   *            return {};
+   *          }, stream);
+   *
+   * @tparam T Element type of the chunks.
+   */
+  template<typename T>
+  class StreamChannel final : public JobStream
+  {
+    static_assert(mx::isNumeric<T>, "stream chunks must be numeric");
+
+    public:
+      /**
+       * @brief Constructor, must be called from the MATLAB thread.
+       * @param slotCount Number of slots, the job waits once that many chunks are not popped.
+       * @param chunkCapacity Maximum number of elements of a chunk.
+       */
+      StreamChannel(std::size_t slotCount, std::size_t chunkCapacity)
+      : mChunkCapacity{chunkCapacity},
+        mSlots(slotCount)
+      {
+        if (slotCount == 0 || chunkCapacity == 0)
+        {
+          throw mx::Exception{"matlabw:mex:StreamChannel", "slot count and chunk capacity must be positive"};
+        }
+
+        for (Slot& slot : mSlots)
+        {
+          slot.data = allocate();
+        }
+      }
+
+      /// @brief Destructor, frees the buffers of the chunks not popped. Must run on the MATLAB thread.
+      ~StreamChannel() override = default;
+
+      /**
+       * @brief Gets the maximum number of elements of a chunk.
+       * @return The chunk capacity.
+       */
+      [[nodiscard]] std::size_t getChunkCapacity() const noexcept
+      {
+        return mChunkCapacity;
+      }
+
+      /**
+       * @brief Gets the number of slots.
+       * @return The number of slots.
+       */
+      [[nodiscard]] std::size_t getSlotCount() const noexcept
+      {
+        return mSlots.size();
+      }
+
+      /**
+       * @brief Gets the number of committed chunks not popped yet.
+       * @return The number of ready chunks.
+       */
+      [[nodiscard]] std::size_t getReadyCount() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mReadyCount;
+      }
+
+      /**
+       * @brief Acquires the buffer of the next chunk, waiting until a slot is free. Called by the producer.
+       * @return The buffer of getChunkCapacity() elements, valid until commit().
+       * @throws JobCancelled if the stream was cancelled.
+       */
+      [[nodiscard]] mx::Span<T> acquire()
+      {
+        std::unique_lock lock{mMutex};
+
+        mNotFull.wait(lock, [this] { return mCancelled || mReadyCount < mSlots.size(); });
+
+        if (mCancelled)
+        {
+          throw JobCancelled{};
+        }
+
+        if (mClosed)
+        {
+          throw mx::Exception{"matlabw:mex:StreamChannel:acquire", "stream is closed"};
+        }
+
+        // The consumer only touches ready slots, the buffer is written without holding the lock.
+        return mx::Span<T>{mSlots[mTail].data.get(), mChunkCapacity};
+      }
+
+      /**
+       * @brief Commits the acquired chunk, making it ready to pop. Called by the producer.
+       * @param count Number of elements written to the buffer, at most the chunk capacity.
+       */
+      void commit(std::size_t count)
+      {
+        if (count > mChunkCapacity)
+        {
+          throw mx::Exception{"matlabw:mex:StreamChannel:commit", "chunk exceeds the chunk capacity"};
+        }
+
+        std::lock_guard lock{mMutex};
+
+        mSlots[mTail].count = count;
+        mTail               = (mTail + 1) % mSlots.size();
+        ++mReadyCount;
+      }
+
+      /**
+       * @brief Copies data into chunks, split at the chunk capacity. Called by the producer.
+       * @param data The data.
+       */
+      void push(mx::View<T> data)
+      {
+        do
+        {
+          const std::size_t count = std::min(data.size(), mChunkCapacity);
+          const mx::Span<T> chunk = acquire();
+
+          std::copy_n(data.begin(), count, chunk.begin());
+          commit(count);
+
+          data = data.subspan(count);
+        }
+        while (!data.empty());
+      }
+
+      /**
+       * @brief Pops the next ready chunk as a column vector. Must be called from the MATLAB thread.
+       * @return The chunk, empty if no chunk is ready.
+       */
+      [[nodiscard]] std::optional<mx::NumericArray<T>> tryPop()
+      {
+        // Allocated before the slot is taken, so a failed allocation loses no chunk.
+        std::unique_ptr<T[], mx::Deleter> fresh = allocate();
+
+        std::unique_ptr<T[], mx::Deleter> data{};
+        std::size_t                       count{};
+
+        {
+          std::lock_guard lock{mMutex};
+
+          if (mReadyCount == 0)
+          {
+            return std::nullopt;
+          }
+
+          Slot& slot = mSlots[mHead];
+
+          data  = std::exchange(slot.data, std::move(fresh));
+          count = slot.count;
+          mHead = (mHead + 1) % mSlots.size();
+          --mReadyCount;
+        }
+
+        mNotFull.notify_one();
+
+        // MATLAB frees the buffer with the array, the persistence only kept it alive between the calls.
+        return mx::adoptNumericArray<T>(std::move(data), count, 1);
+      }
+
+      /**
+       * @brief Writes the next ready chunk to the first output. Must be called from the MATLAB thread.
+       * @param lhs Left-hand side arguments.
+       * @return True if a chunk was ready, false otherwise.
+       */
+      bool pop(mx::Span<mx::Array> lhs) override
+      {
+        std::optional<mx::NumericArray<T>> chunk = tryPop();
+
+        if (!chunk)
+        {
+          return false;
+        }
+
+        // MATLAB passes one output slot for ans even if no output is requested.
+        lhs.data()[0] = std::move(*chunk);
+
+        return true;
+      }
+
+      /**
+       * @brief Checks if the producer closed the stream and all chunks were popped.
+       * @return True if no more chunks will be ready.
+       */
+      [[nodiscard]] bool isDrained() const noexcept override
+      {
+        std::lock_guard lock{mMutex};
+
+        return mClosed && mReadyCount == 0;
+      }
+
+      /// @brief Marks the end of the stream, the ready chunks can still be popped.
+      void close() noexcept override
+      {
+        std::lock_guard lock{mMutex};
+
+        mClosed = true;
+      }
+
+      /// @brief Cancels the stream, a waiting or later acquire() throws JobCancelled.
+      void cancel() noexcept override
+      {
+        {
+          std::lock_guard lock{mMutex};
+
+          mCancelled = true;
+        }
+
+        mNotFull.notify_all();
+      }
+    private:
+      /// @brief Slot of the ring.
+      struct Slot
+      {
+        std::unique_ptr<T[], mx::Deleter> data{};  ///< The persistent buffer.
+        std::size_t                       count{}; ///< Number of elements of a committed chunk.
+      };
+
+      /**
+       * @brief Allocates a persistent buffer of a chunk.
+       * @return The buffer.
+       */
+      [[nodiscard]] std::unique_ptr<T[], mx::Deleter> allocate() const
+      {
+        std::unique_ptr<T[], mx::Deleter> data{static_cast<T*>(mx::malloc(mChunkCapacity * sizeof(T)))};
+
+        if (data == nullptr)
+        {
+          throw std::bad_alloc();
+        }
+
+        makePersistent(data.get());
+
+        return data;
+      }
+
+      std::size_t             mChunkCapacity{}; ///< Maximum number of elements of a chunk.
+      std::vector<Slot>       mSlots{};         ///< The ring of slots.
+      std::size_t             mHead{};          ///< Slot of the next chunk to pop.
+      std::size_t             mTail{};          ///< Slot of the next chunk to produce.
+      std::size_t             mReadyCount{};    ///< Number of committed chunks not popped yet.
+      bool                    mClosed{};        ///< Set when the producer finished.
+      bool                    mCancelled{};     ///< Set when the job was cancelled.
+      mutable std::mutex      mMutex{};         ///< Mutex guarding the ring.
+      std::condition_variable mNotFull{};       ///< Signalled when a slot becomes free or the stream is cancelled.
+  };
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_STREAM_CHANNEL_HPP */
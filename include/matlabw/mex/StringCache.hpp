@@ -0,0 +1,191 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_STRING_CACHE_HPP
+#define MATLABW_MEX_STRING_CACHE_HPP
+
+#include "detail/include.hpp"
+
+#include <unordered_map>
+
+#include "atExit.hpp"
+#include "memory.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Interning cache of char arrays for strings that are returned repeatedly. Each distinct string is decoded
+   *        from UTF-8 once into a persistent char array, later requests get a duplicate of it. Duplicates are needed
+   *        because MATLAB takes ownership of returned arrays and the documented API has no shared copies. When the
+   *        capacity is reached the cache is cleared before a new string is added. The cache is not thread-safe and
+   *        must be used from the MATLAB thread only.
+   */
+  class StringCache
+  {
+    public:
+      /// @brief Default maximum number of cached strings.
+      static constexpr std::size_t defaultCapacity{4096};
+
+      /**
+       * @brief Constructor.
+       * @param capacity The maximum number of cached strings.
+       */
+      explicit StringCache(std::size_t capacity = defaultCapacity) noexcept
+      : mCapacity{std::max(capacity, std::size_t{1})}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      StringCache(const StringCache&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      StringCache(StringCache&&) = delete;
+
+      /// @brief Destructor. Destroys the cached arrays.
+      ~StringCache() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      StringCache& operator=(const StringCache&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      StringCache& operator=(StringCache&&) = delete;
+
+      /**
+       * @brief Gets a char array holding a string.
+       * @param str The UTF-8 string.
+       * @return A new 1-by-n char array owned by the caller.
+       */
+      [[nodiscard]] mx::Array get(std::string_view str)
+      {
+        if (auto it = mEntries.find(str); it != mEntries.end())
+        {
+          ++mHitCount;
+
+          return mx::Array{mx::ArrayCref{it->second}};
+        }
+
+        ++mMissCount;
+
+        if (mEntries.size() >= mCapacity)
+        {
+          clear();
+        }
+
+        mx::Array array = mx::fromUtf8(str);
+
+        makePersistent(array);
+
+        const auto& cached = mEntries.emplace(std::string{str}, std::move(array)).first->second;
+
+        return mx::Array{mx::ArrayCref{cached}};
+      }
+
+      /// @brief Destroys all cached arrays.
+      void clear() noexcept
+      {
+        mEntries.clear();
+      }
+
+      /**
+       * @brief Gets the number of cached strings.
+       * @return The number of cached strings.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mEntries.size();
+      }
+
+      /**
+       * @brief Gets the maximum number of cached strings.
+       * @return The capacity.
+       */
+      [[nodiscard]] std::size_t getCapacity() const noexcept
+      {
+        return mCapacity;
+      }
+
+      /**
+       * @brief Gets the number of requests served from the cache.
+       * @return The number of hits.
+       */
+      [[nodiscard]] std::size_t getHitCount() const noexcept
+      {
+        return mHitCount;
+      }
+
+      /**
+       * @brief Gets the number of requests that created a new cached array.
+       * @return The number of misses.
+       */
+      [[nodiscard]] std::size_t getMissCount() const noexcept
+      {
+        return mMissCount;
+      }
+    private:
+      /// @brief Transparent string hash, looks up std::string_view keys without creating a std::string.
+      struct Hash
+      {
+        using is_transparent = void; ///< Enables heterogeneous lookup.
+
+        [[nodiscard]] std::size_t operator()(std::string_view str) const noexcept
+        {
+          return std::hash<std::string_view>{}(str);
+        }
+      };
+
+      std::unordered_map<std::string, mx::Array, Hash, std::equal_to<>> mEntries{};   ///< Cached arrays.
+      std::size_t                                                        mCapacity;    ///< Maximum number of entries.
+      std::size_t                                                        mHitCount{};  ///< Number of hits.
+      std::size_t                                                        mMissCount{}; ///< Number of misses.
+  };
+
+  /**
+   * @brief Gets the string cache shared by the whole MEX file, cleared when the MEX file is cleared.
+   * @return The string cache.
+   */
+  [[nodiscard]] inline StringCache& getStringCache()
+  {
+    static StringCache& cache = []() -> StringCache&
+    {
+      static StringCache instance{};
+
+      atExit([]{ instance.clear(); });
+
+      return instance;
+    }();
+
+    return cache;
+  }
+
+  /**
+   * @brief Makes a char array from a UTF-8 string through the shared string cache.
+   * @param str The UTF-8 string.
+   * @return The char array.
+   */
+  [[nodiscard]] inline mx::Array makeInternedCharArray(std::string_view str)
+  {
+    return getStringCache().get(str);
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_STRING_CACHE_HPP */
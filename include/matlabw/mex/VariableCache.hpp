@@ -0,0 +1,279 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_VARIABLE_CACHE_HPP
+#define MATLABW_MEX_VARIABLE_CACHE_HPP
+
+#include "detail/include.hpp"
+
+#include <unordered_map>
+
+#include <matlabw/mx/hash.hpp>
+
+#include "atExit.hpp"
+#include "memory.hpp"
+#include "variable.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief How the variable cache detects that a workspace variable has changed.
+  enum class ChangeDetection
+  {
+    pointer, ///< Compare class, dimensions and data address only. Misses in-place modifications in MATLAB.
+    content, ///< Additionally compare a hash of the contents, which reads the variable but does not copy it.
+  };
+
+  /// @brief A variable served from the variable cache.
+  struct CachedVariable
+  {
+    mx::ArrayCref value;   ///< The persistent copy of the variable, valid until it changes or the cache is cleared.
+    bool          changed; ///< Whether the variable was (re)copied by this lookup.
+  };
+
+  /**
+   * @brief Cache of persistent copies of workspace variables. Each lookup borrows the variable with mexGetVariablePtr
+   *        and compares its fingerprint with the cached copy, the variable is copied again only if it changed. The
+   *        cache is not thread-safe and must be used from the MATLAB thread only.
+   */
+  class VariableCache
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param detection How changes are detected.
+       */
+      explicit VariableCache(ChangeDetection detection = ChangeDetection::content) noexcept
+      : mDetection{detection}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      VariableCache(const VariableCache&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      VariableCache(VariableCache&&) = delete;
+
+      /// @brief Destructor. Destroys the cached copies.
+      ~VariableCache() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      VariableCache& operator=(const VariableCache&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      VariableCache& operator=(VariableCache&&) = delete;
+
+      /**
+       * @brief Gets a variable from the specified workspace.
+       * @param workspace The workspace from which to get the variable.
+       * @param name The name of the variable to get.
+       * @return The cached variable, std::nullopt if the variable does not exist.
+       */
+      [[nodiscard]] std::optional<CachedVariable> get(Workspace workspace, const char* name)
+      {
+        auto& entries = mEntries[static_cast<std::size_t>(workspace)];
+        auto  borrowed = getVariableCref(workspace, name);
+        auto  it       = entries.find(std::string_view{name});
+
+        if (!borrowed.has_value())
+        {
+          if (it != entries.end())
+          {
+            entries.erase(it);
+          }
+
+          return std::nullopt;
+        }
+
+        const Fingerprint fingerprint = makeFingerprint(*borrowed);
+
+        if (it != entries.end() && it->second.fingerprint == fingerprint)
+        {
+          ++mHitCount;
+
+          return CachedVariable{mx::ArrayCref{it->second.copy}, false};
+        }
+
+        ++mMissCount;
+
+        mx::Array copy{*borrowed};
+
+        makePersistent(copy);
+
+        if (it == entries.end())
+        {
+          it = entries.emplace(std::string{name}, Entry{fingerprint, std::move(copy)}).first;
+        }
+        else
+        {
+          it->second = Entry{fingerprint, std::move(copy)};
+        }
+
+        return CachedVariable{mx::ArrayCref{it->second.copy}, true};
+      }
+
+      /**
+       * @brief Gets a variable from the specified workspace.
+       * @param workspace The workspace from which to get the variable.
+       * @param name The name of the variable to get. Must be null-terminated.
+       * @return The cached variable, std::nullopt if the variable does not exist.
+       */
+      [[nodiscard]] std::optional<CachedVariable> get(Workspace workspace, std::string_view name)
+      {
+        return get(workspace, name.data());
+      }
+
+      /// @brief Destroys all cached copies.
+      void clear() noexcept
+      {
+        for (auto& entries : mEntries)
+        {
+          entries.clear();
+        }
+      }
+
+      /**
+       * @brief Gets the number of lookups served from the cache.
+       * @return The number of hits.
+       */
+      [[nodiscard]] std::size_t getHitCount() const noexcept
+      {
+        return mHitCount;
+      }
+
+      /**
+       * @brief Gets the number of lookups that copied the variable.
+       * @return The number of misses.
+       */
+      [[nodiscard]] std::size_t getMissCount() const noexcept
+      {
+        return mMissCount;
+      }
+    private:
+      /// @brief Fingerprint of a variable.
+      struct Fingerprint
+      {
+        mx::ClassId              classId{}; ///< The class.
+        bool                     complex{}; ///< Whether the variable is complex.
+        bool                     sparse{};  ///< Whether the variable is sparse.
+        std::vector<std::size_t> dims{};    ///< The dimensions.
+        const void*              data{};    ///< The data address, nullptr for content detection.
+        mx::Hash128              hash{};    ///< The content hash, zero for pointer detection.
+
+        /**
+         * @brief Equality operator.
+         * @return True if the fingerprints are equal.
+         */
+        [[nodiscard]] bool operator==(const Fingerprint&) const = default;
+      };
+
+      /// @brief Cached copy of a variable.
+      struct Entry
+      {
+        Fingerprint fingerprint{}; ///< The fingerprint of the copied variable.
+        mx::Array   copy{};        ///< The persistent copy.
+      };
+
+      /// @brief Transparent string hash, looks up std::string_view keys without creating a std::string.
+      struct Hash
+      {
+        using is_transparent = void; ///< Enables heterogeneous lookup.
+
+        [[nodiscard]] std::size_t operator()(std::string_view str) const noexcept
+        {
+          return std::hash<std::string_view>{}(str);
+        }
+      };
+
+      /**
+       * @brief Makes the fingerprint of a variable.
+       * @param array The variable.
+       * @return The fingerprint.
+       */
+      [[nodiscard]] Fingerprint makeFingerprint(mx::ArrayCref array) const
+      {
+        const mx::View<std::size_t> dims = array.getDims();
+
+        Fingerprint fingerprint{array.getClassId(),
+                                array.isComplex(),
+                                array.isSparse(),
+                                std::vector<std::size_t>(dims.begin(), dims.end()),
+                                mxGetData(array.get()),
+                                0};
+
+        if (mDetection == ChangeDetection::content)
+        {
+          fingerprint.data = nullptr;
+          // Objects and function handles have no hashable contents, they are compared by address.
+          fingerprint.hash = mx::detail::hashArray(array.get(), mx::Hash128{})
+                               .value_or(mx::detail::hashValue128(array.get(), mx::Hash128{}));
+        }
+
+        return fingerprint;
+      }
+
+      using Entries = std::unordered_map<std::string, Entry, Hash, std::equal_to<>>; ///< Entries of a workspace.
+
+      ChangeDetection        mDetection;   ///< How changes are detected.
+      std::array<Entries, 3> mEntries{};   ///< Cached copies for each workspace.
+      std::size_t            mHitCount{};  ///< Number of hits.
+      std::size_t            mMissCount{}; ///< Number of misses.
+  };
+
+  /**
+   * @brief Gets the variable cache shared by the whole MEX file, cleared when the MEX file is cleared.
+   * @return The variable cache.
+   */
+  [[nodiscard]] inline VariableCache& getVariableCache()
+  {
+    static VariableCache& cache = []() -> VariableCache&
+    {
+      static VariableCache instance{};
+
+      atExit([]{ instance.clear(); });
+
+      return instance;
+    }();
+
+    return cache;
+  }
+
+  /**
+   * @brief Gets a variable from the specified workspace through the shared variable cache.
+   * @param workspace The workspace from which to get the variable.
+   * @param name The name of the variable to get. Must be null-terminated.
+   * @return The persistent copy of the variable, std::nullopt if the variable does not exist.
+   */
+  [[nodiscard]] inline std::optional<mx::ArrayCref> getCachedVariable(Workspace workspace, std::string_view name)
+  {
+    auto variable = getVariableCache().get(workspace, name);
+
+    if (!variable.has_value())
+    {
+      return std::nullopt;
+    }
+
+    return variable->value;
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_VARIABLE_CACHE_HPP */
@@ -0,0 +1,805 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MEX_WARM_START_HPP
+#define MATLABW_MEX_WARM_START_HPP
+
+#include "detail/include.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+# define MATLABW_WARM_START_POSIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#elif defined(_WIN32)
+# define MATLABW_WARM_START_WIN32
+# ifndef NOMINMAX
+#   define NOMINMAX
+# endif
+# include <windows.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <matlabw/mx/cpu.hpp>
+#include <matlabw/mx/detail/hash.hpp>
+
+#include "State.hpp"
+
+namespace matlabw::mex
+{
+  /// @brief Environment variable overriding the warm-start cache directory, an empty value disables the cache.
+  inline constexpr char warmStartDirectoryEnv[]{"MATLABW_CACHE_DIR"};
+
+namespace detail
+{
+  /// @brief Magic bytes at the start of a warm-start file.
+  inline constexpr char warmStartMagic[8]{'M', 'L', 'W', 'W', 'A', 'R', 'M', '\0'};
+
+  /// @brief Version of the warm-start file format.
+  inline constexpr std::uint32_t warmStartFormat{1};
+
+  /// @brief Offset of the payload in a warm-start file, a cache line so mapped payloads are aligned for any type.
+  inline constexpr std::size_t warmStartDataOffset{64};
+
+  /// @brief Header of a warm-start file.
+  struct WarmStartHeader
+  {
+    char                magic[8]{};    ///< The magic bytes.
+    std::uint32_t       format{};      ///< Version of the file format.
+    std::uint32_t       version{};     ///< Version of the component.
+    mx::detail::Hash128 fingerprint{}; ///< Fingerprint of the machine and the build.
+    std::uint64_t       size{};        ///< Size of the payload in bytes.
+    mx::detail::Hash128 checksum{};    ///< Hash of the payload.
+  };
+
+  static_assert(sizeof(WarmStartHeader) <= warmStartDataOffset, "warm-start header must fit before the payload");
+
+  /**
+   * @brief Gets the id of the calling process, makes the names of temporary files unique between MATLAB workers.
+   * @return The process id.
+   */
+  [[nodiscard]] inline unsigned long getProcessId() noexcept
+  {
+#if defined(MATLABW_WARM_START_POSIX)
+    return static_cast<unsigned long>(::getpid());
+#elif defined(MATLABW_WARM_START_WIN32)
+    return static_cast<unsigned long>(GetCurrentProcessId());
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * @brief Rounds a size up to the alignment of a type.
+   * @tparam T The type.
+   * @param size The size.
+   * @return The aligned size.
+   */
+  template<typename T>
+  [[nodiscard]] constexpr std::size_t alignWarmStart(std::size_t size) noexcept
+  {
+    return (size + alignof(T) - 1) / alignof(T) * alignof(T);
+  }
+} // namespace detail
+
+  /**
+   * @brief Gets the per-user warm-start cache directory: MATLABW_CACHE_DIR if set, otherwise matlabw in the user cache
+   *        directory (%LOCALAPPDATA% on Windows, $XDG_CACHE_HOME or ~/.cache elsewhere).
+   * @return The directory, empty if the cache is disabled or no cache directory is known.
+   */
+  [[nodiscard]] inline std::filesystem::path getWarmStartDirectory()
+  {
+    if (const char* env = std::getenv(warmStartDirectoryEnv); env != nullptr)
+    {
+      return std::filesystem::path{env};
+    }
+
+#if defined(_WIN32)
+    if (const char* local = std::getenv("LOCALAPPDATA"); local != nullptr && *local != '\0')
+    {
+      return std::filesystem::path{local} / "matlabw";
+    }
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0')
+    {
+      return std::filesystem::path{xdg} / "matlabw";
+    }
+
+    if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0')
+    {
+      return std::filesystem::path{home} / ".cache" / "matlabw";
+    }
+#endif
+
+    return {};
+  }
+
+  /**
+   * @brief Gets the fingerprint of the machine and the build stored in warm-start files. It covers the CPU features
+   *        and the pointer size, so data laid out for another instruction set is not loaded, and the build time of
+   *        the MEX file, so a rebuilt MEX file never loads data of its previous version.
+   * @return The fingerprint.
+   */
+  [[nodiscard]] inline mx::detail::Hash128 getWarmStartFingerprint() noexcept
+  {
+    const mx::CpuFeatures& cpu = mx::getCpuFeatures();
+
+    const bool features[]{cpu.sse42, cpu.popcnt, cpu.avx, cpu.avx2, cpu.fma, cpu.bmi2, cpu.f16c,
+                          cpu.avx512f, cpu.avx512bw, cpu.avx512dq, cpu.avx512vl, cpu.neon};
+
+    static constexpr char build[]{__DATE__ " " __TIME__};
+
+    mx::detail::Hash128 hash = mx::detail::hashBytes128(features, sizeof(features));
+
+    hash = mx::detail::hashValue128(sizeof(void*), hash);
+
+    return mx::detail::hashBytes128(build, sizeof(build) - 1, hash);
+  }
+
+  /**
+   * @brief Sequential writer of the payload of a warm-start file. Values are trivially copyable and aligned to their
+   *        type, so a WarmStartReader returns views into the mapped file without copying.
+   */
+  class WarmStartWriter
+  {
+    public:
+      /**
+       * @brief Writes a value.
+       * @tparam T The value type, trivially copyable.
+       * @param value The value.
+       */
+      template<typename T>
+      void write(const T& value)
+      {
+        static_assert(std::is_trivially_copyable_v<T>, "warm-start values must be trivially copyable");
+
+        append(&value, sizeof(T), alignof(T));
+      }
+
+      /**
+       * @brief Writes the number of values followed by the values.
+       * @tparam T The value type, trivially copyable.
+       * @param values The values.
+       */
+      template<typename T>
+      void writeSpan(mx::View<T> values)
+      {
+        static_assert(std::is_trivially_copyable_v<T>, "warm-start values must be trivially copyable");
+
+        write(static_cast<std::uint64_t>(values.size()));
+        append(values.data(), values.size_bytes(), alignof(T));
+      }
+
+      /**
+       * @brief Writes a string.
+       * @param value The string.
+       */
+      void writeString(std::string_view value)
+      {
+        writeSpan(mx::View<char>{value.data(), value.size()});
+      }
+
+      /**
+       * @brief Gets the payload.
+       * @return The bytes written.
+       */
+      [[nodiscard]] mx::View<std::byte> getData() const noexcept
+      {
+        return mx::View<std::byte>{mData};
+      }
+    private:
+      /**
+       * @brief Appends bytes at an aligned offset of the payload.
+       * @param data The bytes.
+       * @param size The number of bytes.
+       * @param alignment The alignment of the offset.
+       */
+      void append(const void* data, std::size_t size, std::size_t alignment)
+      {
+        const std::size_t offset = (mData.size() + alignment - 1) / alignment * alignment;
+
+        mData.resize(offset + size);
+
+        if (size > 0)
+        {
+          std::memcpy(mData.data() + offset, data, size);
+        }
+      }
+
+      std::vector<std::byte> mData{}; ///< The payload.
+  };
+
+  /// @brief Sequential reader of the payload of a warm-start file, mirrors WarmStartWriter.
+  class WarmStartReader
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param data The payload, aligned to warmStartDataOffset.
+       */
+      explicit WarmStartReader(mx::View<std::byte> data) noexcept
+      : mData{data}
+      {}
+
+      /**
+       * @brief Reads a value.
+       * @tparam T The value type.
+       * @return The value.
+       * @throws mx::Exception if the payload ends.
+       */
+      template<typename T>
+      [[nodiscard]] T read()
+      {
+        static_assert(std::is_trivially_copyable_v<T>, "warm-start values must be trivially copyable");
+
+        T value{};
+
+        std::memcpy(&value, take(sizeof(T), alignof(T)), sizeof(T));
+
+        return value;
+      }
+
+      /**
+       * @brief Reads values written by WarmStartWriter::writeSpan() without copying.
+       * @tparam T The value type.
+       * @return The view of the values, valid as long as the payload is mapped.
+       * @throws mx::Exception if the payload ends.
+       */
+      template<typename T>
+      [[nodiscard]] mx::View<T> readSpan()
+      {
+        static_assert(std::is_trivially_copyable_v<T>, "warm-start values must be trivially copyable");
+
+        const auto count = read<std::uint64_t>();
+
+        if (count > mData.size() / std::max<std::size_t>(sizeof(T), 1))
+        {
+          throw mx::Exception{"matlabw:mex:WarmStartReader", "warm-start payload is truncated"};
+        }
+
+        const auto* data = reinterpret_cast<const T*>(take(static_cast<std::size_t>(count) * sizeof(T), alignof(T)));
+
+        return mx::View<T>{data, static_cast<std::size_t>(count)};
+      }
+
+      /**
+       * @brief Reads a string.
+       * @return The view of the string, valid as long as the payload is mapped.
+       */
+      [[nodiscard]] std::string_view readString()
+      {
+        const mx::View<char> chars = readSpan<char>();
+
+        return std::string_view{chars.data(), chars.size()};
+      }
+
+      /**
+       * @brief Checks if the whole payload was read.
+       * @return True if no bytes are left.
+       */
+      [[nodiscard]] bool isAtEnd() const noexcept
+      {
+        return mOffset == mData.size();
+      }
+    private:
+      /**
+       * @brief Takes bytes at an aligned offset of the payload.
+       * @param size The number of bytes.
+       * @param alignment The alignment of the offset.
+       * @return Pointer to the bytes.
+       */
+      [[nodiscard]] const std::byte* take(std::size_t size, std::size_t alignment)
+      {
+        const std::size_t offset = (mOffset + alignment - 1) / alignment * alignment;
+
+        if (offset > mData.size() || size > mData.size() - offset)
+        {
+          throw mx::Exception{"matlabw:mex:WarmStartReader", "warm-start payload is truncated"};
+        }
+
+        mOffset = offset + size;
+
+        return mData.data() + offset;
+      }
+
+      mx::View<std::byte> mData{};   ///< The payload.
+      std::size_t         mOffset{}; ///< Offset of the next value.
+  };
+
+  /// @brief Read-only mapping of a validated warm-start file, keeps views returned by its reader valid.
+  class WarmStartBlob
+  {
+    public:
+      /// @brief Default constructor, an empty blob.
+      WarmStartBlob() noexcept = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      WarmStartBlob(const WarmStartBlob&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other blob, empty afterwards.
+       */
+      WarmStartBlob(WarmStartBlob&& other) noexcept
+      : mBase{std::exchange(other.mBase, nullptr)},
+        mFileSize{std::exchange(other.mFileSize, 0)},
+        mVersion{other.mVersion}
+#     if defined(MATLABW_WARM_START_WIN32)
+        , mFile{std::exchange(other.mFile, INVALID_HANDLE_VALUE)},
+        mMapping{std::exchange(other.mMapping, nullptr)}
+#     endif
+      {}
+
+      /// @brief Destructor, unmaps the file.
+      ~WarmStartBlob() noexcept
+      {
+        unmap();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      WarmStartBlob& operator=(const WarmStartBlob&) = delete;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other blob, empty afterwards.
+       * @return This blob.
+       */
+      WarmStartBlob& operator=(WarmStartBlob&& other) noexcept
+      {
+        if (this != &other)
+        {
+          unmap();
+
+          mBase     = std::exchange(other.mBase, nullptr);
+          mFileSize = std::exchange(other.mFileSize, 0);
+          mVersion  = other.mVersion;
+#       if defined(MATLABW_WARM_START_WIN32)
+          mFile     = std::exchange(other.mFile, INVALID_HANDLE_VALUE);
+          mMapping  = std::exchange(other.mMapping, nullptr);
+#       endif
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Maps a file and validates its header and checksum.
+       * @param path The path of the file.
+       * @param version The expected version of the component.
+       * @return The blob, std::nullopt if the file is missing, stale or corrupt.
+       */
+      [[nodiscard]] static std::optional<WarmStartBlob> open(const std::filesystem::path& path, std::uint32_t version)
+      {
+        WarmStartBlob blob{};
+
+        if (!blob.map(path) || !blob.isValid(version))
+        {
+          return std::nullopt;
+        }
+
+        blob.mVersion = version;
+
+        return blob;
+      }
+
+      /**
+       * @brief Gets the payload.
+       * @return The payload, aligned to a cache line.
+       */
+      [[nodiscard]] mx::View<std::byte> getData() const noexcept
+      {
+        if (mBase == nullptr)
+        {
+          return {};
+        }
+
+        return mx::View<std::byte>{mBase + detail::warmStartDataOffset, getHeader().size};
+      }
+
+      /**
+       * @brief Gets a reader of the payload.
+       * @return The reader, valid as long as the blob.
+       */
+      [[nodiscard]] WarmStartReader getReader() const noexcept
+      {
+        return WarmStartReader{getData()};
+      }
+
+      /**
+       * @brief Gets the version of the component.
+       * @return The version.
+       */
+      [[nodiscard]] std::uint32_t getVersion() const noexcept
+      {
+        return mVersion;
+      }
+    private:
+      /**
+       * @brief Gets the header of the mapped file.
+       * @return The header.
+       */
+      [[nodiscard]] detail::WarmStartHeader getHeader() const noexcept
+      {
+        detail::WarmStartHeader header{};
+
+        std::memcpy(&header, mBase, sizeof(header));
+
+        return header;
+      }
+
+      /**
+       * @brief Validates the mapped file.
+       * @param version The expected version of the component.
+       * @return True if the file can be loaded.
+       */
+      [[nodiscard]] bool isValid(std::uint32_t version) const noexcept
+      {
+        if (mFileSize < detail::warmStartDataOffset)
+        {
+          return false;
+        }
+
+        const detail::WarmStartHeader header = getHeader();
+
+        return std::memcmp(header.magic, detail::warmStartMagic, sizeof(header.magic)) == 0
+               && header.format == detail::warmStartFormat
+               && header.version == version
+               && header.fingerprint == getWarmStartFingerprint()
+               && header.size == mFileSize - detail::warmStartDataOffset
+               && header.checksum == mx::detail::hashBytes128(mBase + detail::warmStartDataOffset, header.size);
+      }
+
+      /**
+       * @brief Maps a file read-only.
+       * @param path The path of the file.
+       * @return True if mapped.
+       */
+      [[nodiscard]] bool map(const std::filesystem::path& path) noexcept
+      {
+#     if defined(MATLABW_WARM_START_POSIX)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+          return false;
+        }
+
+        struct stat info{};
+
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(detail::warmStartDataOffset))
+        {
+          ::close(fd);
+          return false;
+        }
+
+        void* base = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // the mapping keeps the file referenced, a replaced file stays mapped until unmap
+        ::close(fd);
+
+        if (base == MAP_FAILED)
+        {
+          return false;
+        }
+
+        mBase     = static_cast<const std::byte*>(base);
+        mFileSize = static_cast<std::size_t>(info.st_size);
+
+        return true;
+#     elif defined(MATLABW_WARM_START_WIN32)
+        mFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        LARGE_INTEGER size{};
+
+        if (mFile == INVALID_HANDLE_VALUE || !GetFileSizeEx(mFile, &size)
+            || size.QuadPart < static_cast<LONGLONG>(detail::warmStartDataOffset))
+        {
+          unmap();
+          return false;
+        }
+
+        mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        mBase    = (mMapping != nullptr)
+                   ? static_cast<const std::byte*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0))
+                   : nullptr;
+
+        if (mBase == nullptr)
+        {
+          unmap();
+          return false;
+        }
+
+        mFileSize = static_cast<std::size_t>(size.QuadPart);
+
+        return true;
+#     else
+        static_cast<void>(path);
+        return false;
+#     endif
+      }
+
+      /// @brief Unmaps the file.
+      void unmap() noexcept
+      {
+#     if defined(MATLABW_WARM_START_POSIX)
+        if (mBase != nullptr)
+        {
+          munmap(const_cast<std::byte*>(mBase), mFileSize);
+        }
+#     elif defined(MATLABW_WARM_START_WIN32)
+        if (mBase != nullptr)
+        {
+          UnmapViewOfFile(mBase);
+        }
+
+        if (mMapping != nullptr)
+        {
+          CloseHandle(std::exchange(mMapping, nullptr));
+        }
+
+        if (mFile != INVALID_HANDLE_VALUE)
+        {
+          CloseHandle(std::exchange(mFile, INVALID_HANDLE_VALUE));
+        }
+#     endif
+        mBase     = nullptr;
+        mFileSize = 0;
+      }
+
+      const std::byte* mBase{};     ///< The mapped file.
+      std::size_t      mFileSize{}; ///< The size of the file and the mapping.
+      std::uint32_t    mVersion{};  ///< Version of the component.
+#   if defined(MATLABW_WARM_START_WIN32)
+      HANDLE           mFile{INVALID_HANDLE_VALUE}; ///< The file.
+      HANDLE           mMapping{};                  ///< The file mapping.
+#   endif
+  };
+
+  /**
+   * @brief Directory of warm-start files of a MEX file, one file per component named <mex>.<component>.warm. Files
+   *        are written to a temporary name and renamed, so concurrent MATLAB workers, e.g. of a parallel pool, never
+   *        load a partial file and the last writer wins.
+   */
+  class WarmStartCache
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param directory The cache directory, empty disables the cache.
+       * @param module The name of the module, defaults to the name of the MEX function.
+       */
+      explicit WarmStartCache(std::filesystem::path directory = getWarmStartDirectory(),
+                              std::string           module    = mexFunctionName())
+      : mDirectory{std::move(directory)}, mModule{std::move(module)}
+      {}
+
+      /**
+       * @brief Checks if the cache is enabled.
+       * @return True if there is a cache directory.
+       */
+      [[nodiscard]] bool isEnabled() const noexcept
+      {
+        return !mDirectory.empty();
+      }
+
+      /**
+       * @brief Gets the path of the file of a component.
+       * @param name The name of the component.
+       * @return The path.
+       */
+      [[nodiscard]] std::filesystem::path getPath(std::string_view name) const
+      {
+        std::string file{mModule};
+
+        file += '.';
+        file += name;
+        file += ".warm";
+
+        return mDirectory / file;
+      }
+
+      /**
+       * @brief Loads a component.
+       * @param name The name of the component.
+       * @param version The expected version of the component.
+       * @return The blob, std::nullopt if the cache is disabled or the file is missing, stale or corrupt.
+       */
+      [[nodiscard]] std::optional<WarmStartBlob> load(std::string_view name, std::uint32_t version) const
+      {
+        if (!isEnabled())
+        {
+          return std::nullopt;
+        }
+
+        return WarmStartBlob::open(getPath(name), version);
+      }
+
+      /**
+       * @brief Stores a component, creating the cache directory.
+       * @param name The name of the component.
+       * @param version The version of the component.
+       * @param data The payload.
+       * @throws mx::Exception if the file cannot be written.
+       */
+      void store(std::string_view name, std::uint32_t version, mx::View<std::byte> data) const
+      {
+        static constexpr char id[]{"matlabw:mex:WarmStartCache:store"};
+
+        if (!isEnabled())
+        {
+          return;
+        }
+
+        std::error_code ec{};
+
+        std::filesystem::create_directories(mDirectory, ec);
+
+        const std::filesystem::path path = getPath(name);
+        std::filesystem::path       temp = path;
+
+        temp += '.' + std::to_string(detail::getProcessId()) + ".tmp";
+
+        detail::WarmStartHeader header{};
+
+        std::memcpy(header.magic, detail::warmStartMagic, sizeof(header.magic));
+        header.format      = detail::warmStartFormat;
+        header.version     = version;
+        header.fingerprint = getWarmStartFingerprint();
+        header.size        = data.size();
+        header.checksum    = mx::detail::hashBytes128(data.data(), data.size());
+
+        {
+          std::ofstream file{temp, std::ios::binary | std::ios::trunc};
+
+          char prefix[detail::warmStartDataOffset]{};
+
+          std::memcpy(prefix, &header, sizeof(header));
+
+          file.write(prefix, sizeof(prefix));
+          file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+          if (!file.flush())
+          {
+            file.close();
+            std::filesystem::remove(temp, ec);
+            throw mx::Exception{id, "failed to write warm-start file"};
+          }
+        }
+
+        std::filesystem::rename(temp, path, ec);
+
+        if (ec)
+        {
+          std::filesystem::remove(temp, ec);
+          throw mx::Exception{id, "failed to replace warm-start file"};
+        }
+      }
+
+      /**
+       * @brief Removes the file of a component.
+       * @param name The name of the component.
+       */
+      void remove(std::string_view name) const
+      {
+        if (isEnabled())
+        {
+          std::error_code ec{};
+
+          std::filesystem::remove(getPath(name), ec);
+        }
+      }
+    private:
+      std::filesystem::path mDirectory{}; ///< The cache directory.
+      std::string           mModule{};    ///< The name of the module.
+  };
+
+  /**
+   * @brief State type which can be saved to and loaded from the warm-start cache. It declares a component name and a
+   *        version, bumped whenever the payload layout changes, is constructible from a WarmStartBlob and writes its
+   *        payload to a WarmStartWriter.
+   * @tparam T The state type.
+   */
+  template<typename T>
+  concept WarmStartable = requires(const T& state, WarmStartWriter& writer)
+  {
+    { T::warmStartName } -> std::convertible_to<std::string_view>;
+    { T::warmStartVersion } -> std::convertible_to<std::uint32_t>;
+    state.saveWarmStart(writer);
+  } && std::constructible_from<T, WarmStartBlob&&>;
+
+  /**
+   * @brief Gets a mex::State which is loaded from the warm-start cache on the first call of the session. If no valid
+   *        cache file exists, or the state rejects it by throwing mx::Exception, the state is built from the
+   *        arguments and saved for later sessions and workers. Failures to save are ignored, the cache only speeds
+   *        up the next start.
+   *
+   *          struct Tables
+   *          {
+   *            static constexpr std::string_view warmStartName{"tables"};
+   *            static constexpr std::uint32_t    warmStartVersion{1};
+   *
+   *            explicit Tables(std::size_t n);                            // slow build
+   *            explicit Tables(mex::WarmStartBlob blob);                  // keeps the blob, reads views of it
+   *            void saveWarmStart(mex::WarmStartWriter& writer) const;
+   *          };
+   *
+   *          auto& tables = mex::getWarmState<Tables>(4096);
+   *
+   * @tparam T The state type.
+   * @tparam Tag Tag distinguishing several states of the same type.
+   * @tparam Args Constructor argument types of the build.
+   * @param args Constructor arguments of the build, used only if the state is built.
+   * @return The state.
+   */
+  template<WarmStartable T, typename Tag = void, typename... Args>
+  [[nodiscard]] T& getWarmState(Args&&... args)
+  {
+    using StateType = State<T, Tag>;
+
+    if (StateType::isAlive())
+    {
+      return StateType::get(std::forward<Args>(args)...);
+    }
+
+    const WarmStartCache cache{};
+
+    if (std::optional<WarmStartBlob> blob = cache.load(T::warmStartName, T::warmStartVersion))
+    {
+      try
+      {
+        return StateType::get(std::move(*blob));
+      }
+      catch (const mx::Exception&)
+      {
+        // rejected by the state, rebuilt below
+      }
+    }
+
+    T& state = StateType::get(std::forward<Args>(args)...);
+
+    try
+    {
+      WarmStartWriter writer{};
+
+      state.saveWarmStart(writer);
+      cache.store(T::warmStartName, T::warmStartVersion, writer.getData());
+    }
+    catch (const std::exception&)
+    {}
+
+    return state;
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_WARM_START_HPP */
@@ -0,0 +1,313 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_ARGS_HPP
+#define MATLABW_MEX_ARGS_HPP
+
+#include "detail/include.hpp"
+
+#include <cstdio>
+#include <tuple>
+
+namespace matlabw::mex
+{
+  /// @brief Argument constraint, the array must be real. Implied by real element types.
+  struct Real {};
+
+  /// @brief Argument constraint, the array must be complex. Selects std::complex<T> for real element types.
+  struct Complex {};
+
+  /// @brief Argument constraint, the array must have exactly one element.
+  struct Scalar {};
+
+  /// @brief Argument constraint, the array must be a row or column vector.
+  struct Vector {};
+
+  /// @brief Argument constraint, the array must be a row vector.
+  struct RowVector {};
+
+  /// @brief Argument constraint, the array must be a column vector.
+  struct ColumnVector {};
+
+  /// @brief Argument constraint, the array must be 2-D.
+  struct Matrix {};
+
+  /// @brief Argument constraint, the array must not be empty.
+  struct NonEmpty {};
+
+  /**
+   * @brief Signature of one input argument for parseArgs().
+   * @tparam T Element type of the argument, mx::ArrayCref accepts any class
+   * @tparam Constraints Constraints of the argument (Real, Complex, Scalar, Vector, RowVector, ColumnVector, Matrix,
+   *                     NonEmpty)
+   */
+  template<typename T, typename... Constraints>
+  struct In {};
+
+namespace detail
+{
+  /**
+   * @brief Is the type one of the argument constraints?
+   * @tparam C Type
+   */
+  template<typename C>
+  inline constexpr bool isConstraint = std::is_same_v<C, Real>      || std::is_same_v<C, Complex>      ||
+                                       std::is_same_v<C, Scalar>    || std::is_same_v<C, Vector>       ||
+                                       std::is_same_v<C, RowVector> || std::is_same_v<C, ColumnVector> ||
+                                       std::is_same_v<C, Matrix>    || std::is_same_v<C, NonEmpty>;
+
+  /**
+   * @brief Properties of an input argument signature, everything is resolved at compile time.
+   * @tparam Spec Signature type
+   */
+  template<typename Spec>
+  struct InTraits;
+
+  /**
+   * @brief Properties of an input argument signature.
+   * @tparam T Element type
+   * @tparam Constraints Constraints of the argument
+   */
+  template<typename T, typename... Constraints>
+  struct InTraits<In<T, Constraints...>>
+  {
+    static_assert((isConstraint<Constraints> && ...), "unknown argument constraint");
+
+    template<typename C>
+    static constexpr bool has = (std::is_same_v<C, Constraints> || ...);
+
+    static constexpr bool any     = std::is_same_v<T, mx::ArrayCref>;
+    static constexpr bool complex = mx::isComplexNumeric<T> || has<Complex>;
+
+    static_assert(!(has<Real> && complex), "an argument cannot be both real and complex");
+    static_assert(any || !has<Complex> || mx::isNumeric<T>, "only numeric arguments can be complex");
+
+    using Value  = std::conditional_t<has<Complex> && !mx::isComplexNumeric<T>, std::complex<T>, T>;
+    using Result = std::conditional_t<any, mx::ArrayCref, mx::TypedArrayCref<Value>>;
+
+    static constexpr bool checkComplexity = !any && (mx::isNumeric<Value> || has<Real> || has<Complex>);
+    static constexpr bool checkSparse     = !any && (std::is_same_v<Value, double> ||
+                                                     std::is_same_v<Value, std::complex<double>> ||
+                                                     std::is_same_v<Value, bool>);
+    static constexpr bool checkDims       = has<Vector> || has<RowVector> || has<ColumnVector> || has<Matrix>;
+    static constexpr bool checkSize       = has<Scalar> || has<NonEmpty>;
+
+    static_assert(any || mx::isNumeric<Value> || std::is_same_v<Value, bool> || std::is_same_v<Value, char16_t>,
+                  "element type must be numeric, bool, char16_t or mx::ArrayCref");
+  };
+
+  /**
+   * @brief Gets the MATLAB name of a class.
+   * @param classId The class ID
+   * @return The name
+   */
+  [[nodiscard]] constexpr const char* getClassName(mx::ClassId classId) noexcept
+  {
+    switch (classId)
+    {
+    case mx::ClassId::cell:    return "cell";
+    case mx::ClassId::_struct: return "struct";
+    case mx::ClassId::logical: return "logical";
+    case mx::ClassId::_char:   return "char";
+    case mx::ClassId::_double: return "double";
+    case mx::ClassId::single:  return "single";
+    case mx::ClassId::int8:    return "int8";
+    case mx::ClassId::uint8:   return "uint8";
+    case mx::ClassId::int16:   return "int16";
+    case mx::ClassId::uint16:  return "uint16";
+    case mx::ClassId::int32:   return "int32";
+    case mx::ClassId::uint32:  return "uint32";
+    case mx::ClassId::int64:   return "int64";
+    case mx::ClassId::uint64:  return "uint64";
+    default:                   return "unknown";
+    }
+  }
+
+  /**
+   * @brief Throws an argument validation error with the identifiers of validateattributes.
+   * @param index Zero-based index of the argument
+   * @param id Last part of the error identifier, e.g. "expectedScalar"
+   * @param what Expected property, e.g. "scalar"
+   */
+  [[noreturn]] inline void throwArgError(std::size_t index, const char* id, const char* what)
+  {
+    char errorId[mx::StaticException::idCapacity]{};
+
+    std::snprintf(errorId, sizeof(errorId), "MATLAB:%s:%s", mexFunctionName(), id);
+
+    throw mx::StaticException{errorId, "Expected input number %zu to be %s.", index + 1, what};
+  }
+
+  /**
+   * @brief Checks one input argument against its signature and gets its typed reference. Only the queries required
+   *        by the signature are made.
+   * @tparam Spec Signature type
+   * @param index Zero-based index of the argument
+   * @param arg The argument
+   * @return The typed reference
+   */
+  template<typename Spec>
+  [[nodiscard]] typename InTraits<Spec>::Result parseArg(std::size_t index, mx::ArrayCref arg)
+  {
+    using Traits = InTraits<Spec>;
+
+    if constexpr (!Traits::any)
+    {
+      constexpr mx::ClassId classId = mx::TypeProperties<typename Traits::Value>::classId;
+
+      if (arg.getClassId() != classId)
+      {
+        char errorId[mx::StaticException::idCapacity]{};
+
+        std::snprintf(errorId, sizeof(errorId), "MATLAB:%s:invalidType", mexFunctionName());
+
+        throw mx::StaticException{errorId,
+                                  "Expected input number %zu to be one of these types:\n\n%s\n\n"
+                                  "Instead its type was %s.",
+                                  index + 1,
+                                  getClassName(classId),
+                                  arg.getClassName()};
+      }
+    }
+
+    if constexpr (Traits::checkComplexity)
+    {
+      if (arg.isComplex() != Traits::complex)
+      {
+        if constexpr (Traits::complex)
+        {
+          throwArgError(index, "expectedComplex", "complex");
+        }
+        else
+        {
+          throwArgError(index, "expectedReal", "real");
+        }
+      }
+    }
+
+    if constexpr (Traits::checkSparse)
+    {
+      if (arg.isSparse())
+      {
+        throwArgError(index, "expectedNonsparse", "nonsparse");
+      }
+    }
+
+    if constexpr (Traits::checkSize)
+    {
+      const std::size_t size = arg.getSize();
+
+      if (Traits::template has<Scalar> && size != 1)
+      {
+        throwArgError(index, "expectedScalar", "a scalar");
+      }
+
+      if (Traits::template has<NonEmpty> && size == 0)
+      {
+        throwArgError(index, "expectedNonempty", "nonempty");
+      }
+    }
+
+    if constexpr (Traits::checkDims)
+    {
+      const mx::View<std::size_t> dims = arg.getDims();
+
+      if (dims.size() != 2)
+      {
+        throwArgError(index, "expected2D", "two-dimensional");
+      }
+
+      if (Traits::template has<Vector> && dims[0] != 1 && dims[1] != 1)
+      {
+        throwArgError(index, "expectedVector", "a vector");
+      }
+
+      if (Traits::template has<RowVector> && dims[0] != 1)
+      {
+        throwArgError(index, "expectedRow", "a row vector");
+      }
+
+      if (Traits::template has<ColumnVector> && dims[1] != 1)
+      {
+        throwArgError(index, "expectedColumn", "a column vector");
+      }
+    }
+
+    if constexpr (Traits::any)
+    {
+      return arg;
+    }
+    else
+    {
+      return typename Traits::Result{arg, mx::detail::ClassCheckedTag{}};
+    }
+  }
+
+  /**
+   * @brief Checks all input arguments against their signatures.
+   * @tparam Specs Signature types
+   * @tparam Is Indices of the arguments
+   * @param rhs Right-hand side arguments
+   * @return The typed references
+   */
+  template<typename... Specs, std::size_t... Is>
+  [[nodiscard]] std::tuple<typename InTraits<Specs>::Result...> parseArgs(mx::View<mx::ArrayCref> rhs,
+                                                                         std::index_sequence<Is...>)
+  {
+    // Braced initialization evaluates the arguments in order, so the first invalid argument is reported.
+    return std::tuple<typename InTraits<Specs>::Result...>{parseArg<Specs>(Is, rhs[Is])...};
+  }
+} // namespace detail
+
+  /**
+   * @brief Checks the number, classes, complexity and shapes of the input arguments in one pass and gets them as
+   *        typed references. The checks are selected at compile time, so only the libmx queries required by the
+   *        signatures are made. Errors use the identifiers of narginchk and validateattributes,
+   *        e.g. MATLAB:myfunc:expectedScalar. Numeric arguments must match the complexity of their element type and
+   *        double and logical arguments must not be sparse.
+   *
+   *        auto [x, n] = mex::parseArgs<mex::In<double, mex::Vector>, mex::In<std::int32_t, mex::Scalar>>(rhs);
+   *
+   * @tparam Specs Signatures of the arguments, In<T, Constraints...>
+   * @param rhs Right-hand side arguments
+   * @return Tuple of mx::TypedArrayCref, or mx::ArrayCref for In<mx::ArrayCref>
+   */
+  template<typename... Specs>
+  [[nodiscard]] std::tuple<typename detail::InTraits<Specs>::Result...> parseArgs(mx::View<mx::ArrayCref> rhs)
+  {
+    if (rhs.size() < sizeof...(Specs))
+    {
+      throw mx::StaticException{"MATLAB:narginchk:notEnoughInputs", "Not enough input arguments."};
+    }
+
+    if (rhs.size() > sizeof...(Specs))
+    {
+      throw mx::StaticException{"MATLAB:narginchk:tooManyInputs", "Too many input arguments."};
+    }
+
+    return detail::parseArgs<Specs...>(rhs, std::index_sequence_for<Specs...>{});
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_ARGS_HPP */
@@ -0,0 +1,86 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_AT_EXIT_HPP
+#define MATLABW_MEX_AT_EXIT_HPP
+
+#include "detail/include.hpp"
+
+namespace matlabw::mex
+{
+namespace detail
+{
+  /**
+   * @brief Gets the registered exit handlers.
+   * @return The exit handlers.
+   */
+  [[nodiscard]] inline std::vector<std::function<void()>>& getAtExitHandlers() noexcept
+  {
+    static std::vector<std::function<void()>> handlers{};
+
+    return handlers;
+  }
+
+  /// @brief Runs the registered exit handlers in the reverse order of registration.
+  inline void runAtExitHandlers() noexcept
+  {
+    auto& handlers = getAtExitHandlers();
+
+    while (!handlers.empty())
+    {
+      auto handler = std::move(handlers.back());
+      handlers.pop_back();
+
+      try
+      {
+        handler();
+      }
+      catch (...)
+      {
+        // Exceptions may not propagate to MATLAB from the exit handler.
+      }
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Registers a handler that is run when the MEX file is cleared or MATLAB exits. MATLAB accepts only one exit
+   *        function per MEX file, so all library components register their handlers here. Handlers run in the reverse
+   *        order of registration. Do not call mexAtExit directly when using this function.
+   * @param handler The handler.
+   */
+  inline void atExit(std::function<void()> handler)
+  {
+    auto& handlers = detail::getAtExitHandlers();
+
+    if (handlers.empty())
+    {
+      mexAtExit(detail::runAtExitHandlers);
+    }
+
+    handlers.push_back(std::move(handler));
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_AT_EXIT_HPP */
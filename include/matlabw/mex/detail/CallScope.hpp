@@ -0,0 +1,96 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_DETAIL_CALL_SCOPE_HPP
+#define MATLABW_MEX_DETAIL_CALL_SCOPE_HPP
+
+#include "include.hpp"
+
+#include <matlabw/mx/parallel/mainThread.hpp>
+
+#include "../atExit.hpp"
+#include "../memory.hpp"
+#include "../Printer.hpp"
+#include "../threads.hpp"
+
+namespace matlabw::mex::detail
+{
+  /**
+   * @brief Scope of a single MEX function call. Constructed when MATLAB enters mexFunction and destroyed before
+   *        the control is returned to MATLAB (both on success and on error), releases per-call resources.
+   */
+  class CallScope
+  {
+    public:
+      /**
+       * @brief Default constructor. Resets the allocation statistics, marks the calling thread as the main thread,
+       *        routes the cleanup of library-wide resources (such as the thread pool) to the MEX exit handler,
+       *        sizes the thread pool after maxNumCompThreads and lets Ctrl-C cancel the parallel loops of the call.
+       */
+      CallScope() noexcept
+      {
+        mx::resetAllocStats();
+        mx::parallel::setMainThread();
+        mx::setCleanupRegistrar(atExit);
+        mx::parallel::setThreadCountProvider(getPoolThreadCount);
+        mx::parallel::resetInterrupt();
+        mx::parallel::setInterruptPoller(isInterruptPending);
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      CallScope(const CallScope&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      CallScope(CallScope&&) = delete;
+
+      /**
+       * @brief Destructor. Runs the closures still posted to the main thread, flushes the shared printer, releases the
+       *        scratch arena and stores the allocation statistics of the call.
+       */
+      ~CallScope() noexcept
+      {
+        try
+        {
+          while (mx::parallel::drainMainThreadQueue() > 0) {}
+        }
+        catch (...)
+        {
+          // The call already finished, errors of late closures are dropped.
+        }
+
+        getPrinter().flush();
+        getScratchArena().release();
+
+        detail::getLastCallAllocStats() = mx::getAllocStats();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      CallScope& operator=(const CallScope&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      CallScope& operator=(CallScope&&) = delete;
+  };
+} // namespace matlabw::mex::detail
+
+#endif /* MATLABW_MEX_DETAIL_CALL_SCOPE_HPP */
@@ -29,6 +29,24 @@
 
 namespace matlabw::mex::detail
 {
+  /**
+   * @brief Gets a char property of a MATLAB exception
+   * @param me The MException object
+   * @param name The name of the property
+   * @return The property, empty if it is missing or not a char array
+   */
+  [[nodiscard]] inline std::string getMExceptionProperty(mx::ArrayRef me, const char* name)
+  {
+    auto property = mx::getProperty(me, name);
+
+    if (property.has_value() && property->isChar())
+    {
+      return mx::toAscii(*property);
+    }
+
+    return {};
+  }
+
   /**
    * @brief Handle a MATLAB exception
    * @param me The MException object
@@ -48,24 +66,7 @@ namespace matlabw::mex::detail
       throw mx::Exception{"failed to get MException object"};
     }
 
-    std::string id{};
-    std::string message{};
-
-    auto idArray = mx::getProperty(meObj, "identifier");
-
-    if (idArray.has_value() && idArray->isChar())
-    {
-      id = mx::toAscii(*idArray);
-    }
-
-    auto messageArray = mx::getProperty(meObj, "message");
-
-    if (messageArray.has_value() && messageArray->isChar())
-    {
-      message = mx::toAscii(*messageArray);
-    }
-
-    throw mx::Exception{std::move(id), std::move(message)};
+    throw mx::Exception{getMExceptionProperty(meObj, "identifier"), getMExceptionProperty(meObj, "message")};
   }
 } // namespace matlabw::mex::detail
 
@@ -0,0 +1,234 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_DETAIL_FORMAT_HPP
+#define MATLABW_MEX_DETAIL_FORMAT_HPP
+
+#include "include.hpp"
+
+#include <charconv>
+
+namespace matlabw::mex::detail
+{
+  /**
+   * @brief Parses the precision and the presentation type of a format specification, e.g. ".3f".
+   * @param spec The format specification without the leading colon.
+   * @param precision The precision, -1 if not given.
+   * @param type The presentation type, '\0' if not given.
+   */
+  inline void parseFormatSpec(std::string_view spec, int& precision, char& type)
+  {
+    static constexpr char id[]{"matlabw:mex:format:invalidSpec"};
+
+    precision = -1;
+    type      = '\0';
+
+    if (!spec.empty() && spec.front() == '.')
+    {
+      const char* first = spec.data() + 1;
+      const char* last  = spec.data() + spec.size();
+
+      auto [ptr, ec] = std::from_chars(first, last, precision);
+
+      if (ec != std::errc{} || ptr == first)
+      {
+        throw mx::Exception{id, "invalid precision in format specification"};
+      }
+
+      spec.remove_prefix(static_cast<std::size_t>(ptr - spec.data()));
+    }
+
+    if (spec.size() == 1)
+    {
+      type = spec.front();
+    }
+    else if (!spec.empty())
+    {
+      throw mx::Exception{id, "unsupported format specification"};
+    }
+  }
+
+  /**
+   * @brief Appends a formatted argument.
+   * @tparam T Argument type
+   * @param out The output string.
+   * @param value The argument.
+   * @param spec The format specification, "[.precision][type]", type is one of f, e, g for floating-point values and
+   *             x for integers.
+   */
+  template<typename T>
+  void appendFormatArg(std::string& out, const T& value, std::string_view spec)
+  {
+    int  precision{};
+    char type{};
+
+    parseFormatSpec(spec, precision, type);
+
+    constexpr std::string_view types = (std::is_floating_point_v<T>)                       ? "feg"
+                                     : (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                        !std::is_same_v<T, char>)                          ? "dx"
+                                                                                           : "";
+
+    if (type != '\0' && types.find(type) == std::string_view::npos)
+    {
+      throw mx::Exception{"matlabw:mex:format:invalidSpec", "format type does not match the argument"};
+    }
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      out += (value) ? "true" : "false";
+    }
+    else if constexpr (std::is_same_v<T, char>)
+    {
+      out += value;
+    }
+    else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>)
+    {
+      char                 buffer[128];
+      std::to_chars_result result{};
+
+      if constexpr (std::is_integral_v<T>)
+      {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), value, (type == 'x') ? 16 : 10);
+      }
+      else
+      {
+        const std::chars_format format = (type == 'f') ? std::chars_format::fixed
+                                       : (type == 'e') ? std::chars_format::scientific
+                                                       : std::chars_format::general;
+
+        result = (precision < 0 && type == '\0')
+               ? std::to_chars(buffer, buffer + sizeof(buffer), value)
+               : std::to_chars(buffer, buffer + sizeof(buffer), value, format, (precision < 0) ? 6 : precision);
+      }
+
+      if (result.ec != std::errc{})
+      {
+        throw mx::Exception{"matlabw:mex:format:valueTooLong", "formatted value does not fit the buffer"};
+      }
+
+      out.append(buffer, result.ptr);
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+    {
+      out += std::string_view{value};
+    }
+    else
+    {
+      static_assert(std::is_integral_v<T>, "unsupported format argument type");
+    }
+  }
+
+  /// @brief Appends one type-erased formatted argument.
+  using FormatAppender = void(*)(std::string& out, const void* value, std::string_view spec);
+
+  /**
+   * @brief Appends a formatted string with type-erased arguments.
+   * @param out The output string.
+   * @param format The format string.
+   * @param values The arguments.
+   * @param appenders The appenders of the arguments.
+   * @param count The number of arguments.
+   */
+  inline void formatErased(std::string&          out,
+                           std::string_view      format,
+                           const void* const*    values,
+                           const FormatAppender* appenders,
+                           std::size_t           count)
+  {
+    static constexpr char id[]{"matlabw:mex:format:invalidFormat"};
+
+    std::size_t argIndex{};
+
+    while (!format.empty())
+    {
+      const std::size_t pos = format.find_first_of("{}");
+
+      out.append(format.substr(0, pos));
+
+      if (pos == std::string_view::npos)
+      {
+        break;
+      }
+
+      if (pos + 1 < format.size() && format[pos + 1] == format[pos])
+      {
+        out += format[pos];
+        format.remove_prefix(pos + 2);
+        continue;
+      }
+
+      if (format[pos] == '}')
+      {
+        throw mx::Exception{id, "unmatched '}' in format string"};
+      }
+
+      const std::size_t end = format.find('}', pos);
+
+      if (end == std::string_view::npos)
+      {
+        throw mx::Exception{id, "unmatched '{' in format string"};
+      }
+
+      std::string_view field = format.substr(pos + 1, end - pos - 1);
+
+      if (!field.empty() && field.front() != ':')
+      {
+        throw mx::Exception{id, "only automatic argument indexing is supported"};
+      }
+
+      if (argIndex >= count)
+      {
+        throw mx::Exception{id, "not enough format arguments"};
+      }
+
+      appenders[argIndex](out, values[argIndex], field.substr(std::min<std::size_t>(field.size(), 1)));
+      ++argIndex;
+
+      format.remove_prefix(end + 1);
+    }
+  }
+
+  /**
+   * @brief Appends a formatted string. Supports a subset of the std::format syntax: "{}" and "{:spec}" replacement
+   *        fields with automatic indexing, "{{" and "}}" escapes.
+   * @tparam Args Argument types
+   * @param out The output string.
+   * @param format The format string.
+   * @param args The arguments.
+   */
+  template<typename... Args>
+  void formatTo(std::string& out, std::string_view format, const Args&... args)
+  {
+    const void*          values[sizeof...(Args) + 1]{static_cast<const void*>(&args)...};
+    const FormatAppender appenders[sizeof...(Args) + 1]{[](std::string& str, const void* value, std::string_view spec)
+    {
+      appendFormatArg(str, *static_cast<const Args*>(value), spec);
+    }...};
+
+    formatErased(out, format, values, appenders, sizeof...(Args));
+  }
+} // namespace matlabw::mex::detail
+
+#endif /* MATLABW_MEX_DETAIL_FORMAT_HPP */
@@ -31,12 +31,119 @@
 namespace matlabw::mex
 {
   /**
-   * @brief Calls a MATLAB function.
+   * @brief Status of a MATLAB function call which does not throw. The MException object of a failed call is kept
+   *        undecoded until its details are requested.
+   */
+  class CallStatus
+  {
+    public:
+      /// @brief Default constructor, a successful call.
+      CallStatus() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param me The MException object returned by MATLAB, nullptr if the call succeeded.
+       */
+      explicit CallStatus(mxArray* me) noexcept
+      : mMException{std::move(me)}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      CallStatus(const CallStatus&) = delete;
+
+      /// @brief Move constructor.
+      CallStatus(CallStatus&&) noexcept = default;
+
+      /// @brief Destructor.
+      ~CallStatus() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      CallStatus& operator=(const CallStatus&) = delete;
+
+      /// @brief Move assignment operator.
+      CallStatus& operator=(CallStatus&&) noexcept = default;
+
+      /**
+       * @brief Checks if the call succeeded.
+       * @return True if the call succeeded, false otherwise.
+       */
+      [[nodiscard]] bool isOk() const noexcept
+      {
+        return mMException.get() == nullptr;
+      }
+
+      /**
+       * @brief Checks if the call succeeded.
+       * @return True if the call succeeded, false otherwise.
+       */
+      [[nodiscard]] explicit operator bool() const noexcept
+      {
+        return isOk();
+      }
+
+      /**
+       * @brief Gets the MException object.
+       * @return The MException object, std::nullopt if the call succeeded.
+       */
+      [[nodiscard]] std::optional<mx::ArrayCref> getMException() const noexcept
+      {
+        if (isOk())
+        {
+          return std::nullopt;
+        }
+
+        return mx::ArrayCref{mMException.get()};
+      }
+
+      /**
+       * @brief Decodes the error identifier.
+       * @return The error identifier, empty if the call succeeded.
+       */
+      [[nodiscard]] std::string getIdentifier() const
+      {
+        return (isOk()) ? std::string{} : detail::getMExceptionProperty(getRef(), "identifier");
+      }
+
+      /**
+       * @brief Decodes the error message.
+       * @return The error message, empty if the call succeeded.
+       */
+      [[nodiscard]] std::string getMessage() const
+      {
+        return (isOk()) ? std::string{} : detail::getMExceptionProperty(getRef(), "message");
+      }
+
+      /// @brief Throws the decoded error as mx::Exception if the call failed.
+      void throwIfError() const
+      {
+        if (!isOk())
+        {
+          detail::handleMException(getRef().get());
+        }
+      }
+    private:
+      /**
+       * @brief Gets a reference to the MException object, the property queries require a mutable reference.
+       * @return The reference.
+       */
+      [[nodiscard]] mx::ArrayRef getRef() const
+      {
+        return mx::ArrayRef{const_cast<mxArray*>(mMException.get())};
+      }
+
+      mx::Array mMException{}; ///< The MException object.
+  };
+
+  /**
+   * @brief Calls a MATLAB function without throwing on MATLAB errors.
    * @param lhs The left-hand side arguments.
    * @param rhs The right-hand side arguments.
    * @param functionName The name of the function to call. Must be null-terminated.
+   * @return The status of the call.
    */
-  inline void call(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs, const char* functionName)
+  [[nodiscard]] inline CallStatus tryCall(mx::Span<mx::Array>      lhs,
+                                          mx::View<mx::ArrayCref> rhs,
+                                          const char*             functionName)
   {
     if (!std::empty(lhs) && std::data(lhs) == nullptr)
     {
@@ -66,7 +173,34 @@ namespace matlabw::mex
     mxArray** prhs = reinterpret_cast<mxArray**>(const_cast<mx::ArrayCref*>(std::data(rhs)));
 
     // Call the function
-    detail::handleMException(mexCallMATLABWithTrap(nlhs, plhs, nrhs, prhs, functionName));
+    mx::ProfileZone zone{"mexCallMATLAB", "matlab"};
+
+    return CallStatus{mexCallMATLABWithTrap(nlhs, plhs, nrhs, prhs, functionName)};
+  }
+
+  /**
+   * @brief Calls a MATLAB function without throwing on MATLAB errors.
+   * @param lhs The left-hand side arguments.
+   * @param rhs The right-hand side arguments.
+   * @param functionName The name of the function to call. Must be null-terminated.
+   * @return The status of the call.
+   */
+  [[nodiscard]] inline CallStatus tryCall(mx::Span<mx::Array>      lhs,
+                                          mx::View<mx::ArrayCref> rhs,
+                                          std::string_view        functionName)
+  {
+    return tryCall(lhs, rhs, functionName.data());
+  }
+
+  /**
+   * @brief Calls a MATLAB function.
+   * @param lhs The left-hand side arguments.
+   * @param rhs The right-hand side arguments.
+   * @param functionName The name of the function to call. Must be null-terminated.
+   */
+  inline void call(mx::Span<mx::Array> lhs, mx::View<mx::ArrayCref> rhs, const char* functionName)
+  {
+    tryCall(lhs, rhs, functionName).throwIfError();
   }
 
   /**
@@ -100,6 +234,142 @@ namespace matlabw::mex
     call(rhs, functionName.data());
   }
 
+  /**
+   * @brief Repeatedly callable MATLAB function handle. The handle is captured once and the input arrays are kept
+   *        between calls, so the caller updates their data in place instead of creating new arrays, and the output
+   *        slots are reused. Must not outlive the MEX function call and the called function must not keep references
+   *        to its inputs.
+   */
+  class Callable
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param function The function handle, must stay valid while the callable is used.
+       * @param inputCount The number of input arguments.
+       * @param outputCount The number of output arguments.
+       */
+      Callable(mx::ArrayCref function, std::size_t inputCount, std::size_t outputCount = 1)
+      : mRhs(inputCount + 1), mInputs(inputCount), mOutputs(outputCount)
+      {
+        static constexpr char id[]{"matlabw:mex:Callable:invalidFunction"};
+
+        if (function.getClassId() != mx::ClassId::function)
+        {
+          throw mx::Exception{id, "function must be a function handle"};
+        }
+
+        mRhs[0] = const_cast<mxArray*>(function.get());
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      Callable(const Callable&) = delete;
+
+      /// @brief Move constructor.
+      Callable(Callable&&) noexcept = default;
+
+      /// @brief Destructor.
+      ~Callable() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Callable& operator=(const Callable&) = delete;
+
+      /// @brief Move assignment operator.
+      Callable& operator=(Callable&&) noexcept = default;
+
+      /**
+       * @brief Gets the number of input arguments.
+       * @return The number of input arguments.
+       */
+      [[nodiscard]] std::size_t getInputCount() const noexcept
+      {
+        return mInputs.size();
+      }
+
+      /**
+       * @brief Gets the number of output arguments.
+       * @return The number of output arguments.
+       */
+      [[nodiscard]] std::size_t getOutputCount() const noexcept
+      {
+        return mOutputs.size();
+      }
+
+      /**
+       * @brief Sets an input argument. It is kept for all following calls.
+       * @param i The index of the input argument.
+       * @param array The array.
+       */
+      void setInput(std::size_t i, mx::Array&& array)
+      {
+        mInputs.at(i) = std::move(array);
+        mRhs[i + 1]   = mInputs[i].get();
+      }
+
+      /**
+       * @brief Gets an input argument to update its data in place.
+       * @param i The index of the input argument.
+       * @return The input argument.
+       */
+      [[nodiscard]] mx::ArrayRef getInput(std::size_t i)
+      {
+        return mInputs.at(i);
+      }
+
+      /**
+       * @brief Calls the function. The outputs of the previous call are destroyed.
+       * @return The outputs, they may be moved out.
+       */
+      mx::Span<mx::Array> operator()()
+      {
+        tryCall().throwIfError();
+
+        return mOutputs;
+      }
+
+      /**
+       * @brief Calls the function without throwing on MATLAB errors. The outputs of the previous call are destroyed.
+       * @return The status of the call, the outputs are available through getOutputs() if it succeeded.
+       */
+      [[nodiscard]] CallStatus tryCall()
+      {
+        static constexpr char id[]{"matlabw:mex:Callable:missingInput"};
+
+        if (std::find(mRhs.begin(), mRhs.end(), nullptr) != mRhs.end())
+        {
+          throw mx::Exception{id, "all inputs must be set before calling the function"};
+        }
+
+        for (auto& output : mOutputs)
+        {
+          output = mx::Array{};
+        }
+
+        static_assert(sizeof(mxArray*) == sizeof(mx::Array));
+
+        mx::ProfileZone zone{"feval", "matlab"};
+
+        return CallStatus{mexCallMATLABWithTrap(static_cast<int>(mOutputs.size()),
+                                                reinterpret_cast<mxArray**>(mOutputs.data()),
+                                                static_cast<int>(mRhs.size()),
+                                                mRhs.data(),
+                                                "feval")};
+      }
+
+      /**
+       * @brief Gets the outputs of the last call.
+       * @return The outputs, they may be moved out.
+       */
+      [[nodiscard]] mx::Span<mx::Array> getOutputs() noexcept
+      {
+        return mOutputs;
+      }
+    private:
+      std::vector<mxArray*>  mRhs{};     ///< The function handle followed by the inputs.
+      std::vector<mx::Array> mInputs{};  ///< The owned inputs.
+      std::vector<mx::Array> mOutputs{}; ///< The output slots.
+  };
+
   /**
    * @brief Evaluates a MATLAB expression.
    * @param expr The expression to evaluate. Must be null-terminated.
@@ -111,6 +381,8 @@ namespace matlabw::mex
       throw mx::Exception{"invalid expression"};
     }
 
+    mx::ProfileZone zone{"mexEvalString", "matlab"};
+
     detail::handleMException(mexEvalStringWithTrap(expr));
   }
 
@@ -27,13 +27,15 @@
 
 #include "detail/include.hpp"
 
+#include "io.hpp"
+
 namespace matlabw::mex
 {
   /**
    * @brief Makes the specified memory persistent between MEX function calls.
    * @param ptr A pointer to the memory to make persistent.
    */
-  void makePersistent(const void* ptr)
+  inline void makePersistent(const void* ptr)
   {
     mexMakeMemoryPersistent(const_cast<void*>(ptr));
   }
@@ -42,13 +44,78 @@ namespace matlabw::mex
    * @brief Makes the specified memory persistent between MEX function calls.
    * @param array An array whose memory to make persistent.
    */
-  void makePersistent(const mx::Array& array)
+  inline void makePersistent(const mx::Array& array)
   {
     if (array.isValid())
     {
       mexMakeArrayPersistent(const_cast<mxArray*>(array.get()));
     }
   }
+
+  /**
+   * @brief Gets the scratch arena of the current MEX function call. All memory allocated from the arena is released
+   *        when the call of mex::Function::operator() ends, so it must not be returned to MATLAB or kept across calls.
+   * @return The scratch arena.
+   */
+  [[nodiscard]] inline mx::Arena& getScratchArena() noexcept
+  {
+    static mx::Arena arena{};
+
+    return arena;
+  }
+
+namespace detail
+{
+  /**
+   * @brief Gets the allocation statistics of the last finished MEX function call.
+   * @return The allocation statistics.
+   */
+  [[nodiscard]] inline mx::AllocStats& getLastCallAllocStats() noexcept
+  {
+    static mx::AllocStats stats{};
+
+    return stats;
+  }
+} // namespace detail
+
+  /**
+   * @brief Gets the allocation statistics of the last finished MEX function call. Statistics of the current call are
+   *        available through mx::getAllocStats().
+   * @return The allocation statistics.
+   */
+  [[nodiscard]] inline const mx::AllocStats& getLastCallAllocStats() noexcept
+  {
+    return detail::getLastCallAllocStats();
+  }
+
+  /**
+   * @brief Prints the allocation statistics to MATLAB command window.
+   * @param stats The allocation statistics.
+   */
+  inline void printAllocStats(const mx::AllocStats& stats = mx::getAllocStats())
+  {
+    if constexpr (!mx::AllocStats::enabled)
+    {
+      printf("Allocation statistics are disabled, configure with MATLABW_ENABLE_ALLOC_STATS=ON.\n");
+    }
+    else
+    {
+      printf("allocations: %zu, frees: %zu\n", stats.allocationCount, stats.freeCount);
+      printf("bytes allocated: %zu, bytes freed: %zu\n", stats.bytesAllocated, stats.bytesFreed);
+      printf("current bytes: %zu, peak bytes: %zu\n", stats.currentBytes, stats.peakBytes);
+      printf("size histogram:\n");
+
+      for (std::size_t i{}; i < stats.histogram.size(); ++i)
+      {
+        if (stats.histogram[i] != 0)
+        {
+          const std::size_t lower = (i == 0) ? 0 : std::size_t{1} << (i - 1);
+
+          printf("  >= %zu B: %zu\n", lower, stats.histogram[i]);
+        }
+      }
+    }
+  }
 } // namespace matlabw::mex
 
 #endif /* MATLABW_MEX_MEMORY_HPP */
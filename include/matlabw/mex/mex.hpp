@@ -25,9 +25,34 @@
 #ifndef MATLABW_MEX_MEX_HPP
 #define MATLABW_MEX_MEX_HPP
 
+#include "args.hpp"
+#include "ArrayRecycler.hpp"
+#include "AsyncJob.hpp"
+#include "atExit.hpp"
+#include "BatchEvaluator.hpp"
+#include "CommandTable.hpp"
 #include "eval.hpp"
+#include "EvalBatch.hpp"
+#include "InPlace.hpp"
 #include "io.hpp"
+#include "KernelRegistry.hpp"
+#include "Logger.hpp"
+#include "Memoizer.hpp"
 #include "memory.hpp"
+#include "NodeCache.hpp"
+#include "ObjectRegistry.hpp"
+#include "Outputs.hpp"
+#include "PersistentPool.hpp"
+#include "Printer.hpp"
+#include "profile.hpp"
+#include "ScalarPack.hpp"
+#include "State.hpp"
+#include "StringCache.hpp"
+#include "StreamChannel.hpp"
+#include "strings.hpp"
+#include "threads.hpp"
 #include "variable.hpp"
+#include "VariableCache.hpp"
+#include "WarmStart.hpp"
 
 #endif /* MATLABW_MEX_MEX_HPP */
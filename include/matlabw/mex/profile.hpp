@@ -0,0 +1,87 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_PROFILE_HPP
+#define MATLABW_MEX_PROFILE_HPP
+
+#include "detail/include.hpp"
+
+#include "State.hpp"
+
+namespace matlabw::mex
+{
+  /**
+   * @brief Command which writes the recorded profile as a Chrome trace and clears it, e.g.
+   *        myfunc('matlabw:writeProfile', 'trace.json'). Only recognized when profiling is enabled.
+   */
+  inline constexpr char writeProfileCommand[]{"matlabw:writeProfile"};
+
+  /**
+   * @brief Writes the recorded profiling zones of all calls as a Chrome trace and clears them.
+   * @param path The path of the trace file.
+   */
+  inline void writeProfile(const char* path)
+  {
+    mx::writeChromeTrace(path);
+    mx::clearProfile();
+  }
+
+  /// @brief Prints the recorded profiling zones aggregated by name, longest total duration first.
+  inline void printProfileSummary()
+  {
+    for (const mx::ProfileSummary& summary : mx::getProfileSummary())
+    {
+      mexPrintf("%-40s %-8s %10zu calls %14.3f ms total %12.3f ms max\n",
+                summary.name,
+                summary.category,
+                summary.count,
+                static_cast<double>(summary.totalDuration) / 1e6,
+                static_cast<double>(summary.maxDuration) / 1e6);
+    }
+  }
+
+namespace detail
+{
+  /**
+   * @brief Checks if the call is the write profile command.
+   * @param nlhs Number of left-hand side arguments.
+   * @param nrhs Number of right-hand side arguments.
+   * @param prhs Right-hand side arguments.
+   * @return True if the call is the write profile command.
+   */
+  [[nodiscard]] inline bool isWriteProfileCommand(int nlhs, int nrhs, const mxArray* const prhs[]) noexcept
+  {
+    if constexpr (mx::profilingEnabled)
+    {
+      return nlhs == 0 && nrhs == 2 && isCommandArg(prhs[0], writeProfileCommand) && mxIsChar(prhs[1]);
+    }
+    else
+    {
+      return false;
+    }
+  }
+} // namespace detail
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_PROFILE_HPP */
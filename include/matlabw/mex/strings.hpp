@@ -0,0 +1,104 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_STRINGS_HPP
+#define MATLABW_MEX_STRINGS_HPP
+
+#include "detail/include.hpp"
+
+#include <matlabw/mx/algorithm/cells.hpp>
+
+#include "eval.hpp"
+
+namespace matlabw::mex
+{
+namespace detail
+{
+  /**
+   * @brief Converts a string array to a cellstr by calling cellstr, other arrays are returned unchanged.
+   * @param array The array.
+   * @param cellStr Storage for the converted array.
+   * @return The cellstr or the array.
+   */
+  [[nodiscard]] inline mx::ArrayCref toCellStr(mx::ArrayCref array, mx::Array& cellStr)
+  {
+    if (!array.isClass("string"))
+    {
+      return array;
+    }
+
+    call(mx::Span<mx::Array>{&cellStr, 1}, mx::View<mx::ArrayCref>{&array, 1}, "cellstr");
+
+    return cellStr;
+  }
+} // namespace detail
+
+  /**
+   * @brief Converts a string array or a cellstr to a list of UTF-8 strings in one buffer, see
+   *        mx::algorithm::toStringList(). String arrays are converted by MATLAB's cellstr first, since the C API gives
+   *        no access to their contents.
+   * @param array The string array or cellstr.
+   * @return The strings.
+   */
+  [[nodiscard]] inline mx::algorithm::StringList toStringList(mx::ArrayCref array)
+  {
+    mx::Array cellStr{};
+
+    return mx::algorithm::toStringList(detail::toCellStr(array, cellStr));
+  }
+
+  /**
+   * @brief Converts a string array or a cellstr to UTF-8 strings, see mx::algorithm::toStrings().
+   * @param array The string array or cellstr.
+   * @return The strings.
+   */
+  [[nodiscard]] inline std::vector<std::string> toStrings(mx::ArrayCref array)
+  {
+    mx::Array cellStr{};
+
+    return mx::algorithm::toStrings(detail::toCellStr(array, cellStr));
+  }
+
+  /**
+   * @brief Builds an n-by-1 string array from UTF-8 strings. The strings are transcoded into a cellstr, which is
+   *        converted by a single call of MATLAB's string.
+   * @tparam S Array-like of strings or string views, or mx::algorithm::StringList
+   * @param strings The strings.
+   * @return The string array.
+   */
+  template<typename S>
+  [[nodiscard]] mx::Array makeStringArray(const S& strings)
+  {
+    const mx::CellArray cellStr = mx::algorithm::fromStrings(strings);
+    const mx::ArrayCref input   = cellStr;
+
+    mx::Array stringArray{};
+
+    call(mx::Span<mx::Array>{&stringArray, 1}, mx::View<mx::ArrayCref>{&input, 1}, "string");
+
+    return stringArray;
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_STRINGS_HPP */
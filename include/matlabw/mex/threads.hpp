@@ -0,0 +1,160 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MEX_THREADS_HPP
+#define MATLABW_MEX_THREADS_HPP
+
+#include "detail/include.hpp"
+
+#include <matlabw/mx/parallel/cancellation.hpp>
+#include <matlabw/mx/parallel/mainThread.hpp>
+#include <matlabw/mx/parallel/ThreadPool.hpp>
+
+#include "eval.hpp"
+
+namespace matlabw::mex
+{
+namespace detail
+{
+  /**
+   * @brief Gets the cached computational thread count of MATLAB.
+   * @return The cached count, 0 until queried.
+   */
+  [[nodiscard]] inline std::size_t& getCachedCompThreadCount() noexcept
+  {
+    static std::size_t count{};
+
+    return count;
+  }
+} // namespace detail
+
+  /**
+   * @brief Gets MATLAB's computational thread count, maxNumCompThreads, which is also the thread count of its BLAS.
+   *        The value is queried once and cached, must be called from the MATLAB thread.
+   * @param refresh Whether to query the value again, e.g. after maxNumCompThreads was changed.
+   * @return The computational thread count, 0 if it could not be queried.
+   */
+  [[nodiscard]] inline std::size_t getCompThreadCount(bool refresh = false)
+  {
+    std::size_t& count = detail::getCachedCompThreadCount();
+
+    if (count == 0 || refresh)
+    {
+      mx::Array lhs[1]{};
+
+      if (tryCall(lhs, {}, "maxNumCompThreads").isOk() && lhs[0].getClassId() == mx::ClassId::_double
+          && !lhs[0].isComplex() && lhs[0].getSize() == 1)
+      {
+        const double value = *static_cast<const double*>(lhs[0].getData());
+
+        count = (value >= 1.0) ? static_cast<std::size_t>(value) : 0;
+      }
+    }
+
+    return count;
+  }
+
+namespace detail
+{
+  /**
+   * @brief Provides the default thread pool size, one less than maxNumCompThreads because the calling thread
+   *        participates in parallel loops. Installed by every MEX function call.
+   * @return The number of worker threads, 0 if not called from the MATLAB thread or the count is unknown.
+   */
+  [[nodiscard]] inline std::size_t getPoolThreadCount() noexcept
+  {
+    if (!mx::parallel::isMainThread())
+    {
+      return 0;
+    }
+
+    try
+    {
+      const std::size_t count = getCompThreadCount();
+
+      return (count > 0) ? std::max(count - 1, std::size_t{1}) : 0;
+    }
+    catch (...)
+    {
+      return 0;
+    }
+  }
+
+  /**
+   * @brief Checks if Ctrl-C was pressed, by libut's undocumented utIsInterruptPending resolved at run time. Installed
+   *        by every MEX function call as the interrupt poller of the main thread.
+   * @return True if an interrupt is pending, false if not or if libut is not loaded.
+   */
+  [[nodiscard]] inline bool isInterruptPending() noexcept
+  {
+    using Poller = bool (*)();
+
+    static const Poller poller = []() noexcept -> Poller
+    {
+#if defined(_WIN32)
+      if (HMODULE handle = GetModuleHandleA("libut.dll"); handle != nullptr)
+      {
+        return reinterpret_cast<Poller>(GetProcAddress(handle, "utIsInterruptPending"));
+      }
+
+      return nullptr;
+#else
+      return mx::parallel::detail::findSymbol<Poller>("utIsInterruptPending");
+#endif
+    }();
+
+    return poller != nullptr && poller();
+  }
+} // namespace detail
+
+  /**
+   * @brief Throws mx::parallel::CancelledException if Ctrl-C was pressed during the MEX function call. Polls at most
+   *        every few milliseconds, so long serial loops on the MATLAB thread may call it on every iteration. Parallel
+   *        loops started from the MATLAB thread check it by themselves.
+   */
+  inline void checkInterrupt()
+  {
+    if (mx::parallel::pollInterrupt())
+    {
+      throw mx::parallel::CancelledException{};
+    }
+  }
+
+  /**
+   * @brief Queries maxNumCompThreads again and resizes the library-managed thread pool if it changed. Pools sized by
+   *        the MATLABW_NUM_THREADS environment variable or by explicit options are left intact. Must be called from
+   *        the MATLAB thread, not from a worker.
+   */
+  inline void syncThreadPool()
+  {
+    const std::size_t previous = detail::getCachedCompThreadCount();
+
+    if (getCompThreadCount(true) != previous && mx::parallel::getThreadPoolOptions().threadCount == 0)
+    {
+      mx::parallel::configureThreadPool(mx::parallel::getThreadPoolOptions());
+    }
+  }
+} // namespace matlabw::mex
+
+#endif /* MATLABW_MEX_THREADS_HPP */
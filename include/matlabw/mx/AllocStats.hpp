@@ -0,0 +1,167 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALLOC_STATS_HPP
+#define MATLABW_MX_ALLOC_STATS_HPP
+
+#include "detail/include.hpp"
+
+#ifdef MATLABW_ENABLE_ALLOC_STATS
+# include <unordered_map>
+#endif
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Statistics of the memory allocated through mx::malloc, mx::calloc and mx::free. The statistics are only
+   *        collected when the library is configured with MATLABW_ENABLE_ALLOC_STATS, otherwise they stay zero.
+   */
+  struct AllocStats
+  {
+    /// @brief Number of histogram buckets.
+    static constexpr std::size_t histogramSize{std::numeric_limits<std::size_t>::digits + 1};
+
+    /// @brief True if the statistics are collected.
+#ifdef MATLABW_ENABLE_ALLOC_STATS
+    static constexpr bool enabled{true};
+#else
+    static constexpr bool enabled{false};
+#endif
+
+    std::size_t                            allocationCount{}; ///< Number of allocations.
+    std::size_t                            freeCount{};       ///< Number of frees.
+    std::size_t                            bytesAllocated{};  ///< Total number of bytes allocated.
+    std::size_t                            bytesFreed{};      ///< Total number of bytes freed.
+    std::size_t                            currentBytes{};    ///< Number of bytes currently allocated.
+    std::size_t                            peakBytes{};       ///< Maximum number of bytes allocated at once.
+    std::array<std::size_t, histogramSize> histogram{};       ///< Allocation counts, bucket k holds sizes in [2^(k-1), 2^k).
+  };
+
+namespace detail
+{
+  /**
+   * @brief Gets the global allocation statistics.
+   * @return The allocation statistics.
+   */
+  [[nodiscard]] inline AllocStats& getAllocStats() noexcept
+  {
+    static AllocStats stats{};
+
+    return stats;
+  }
+
+#ifdef MATLABW_ENABLE_ALLOC_STATS
+  /**
+   * @brief Gets the sizes of the live allocations. mxFree does not report the size of the freed memory.
+   * @return The map of pointers to sizes.
+   */
+  [[nodiscard]] inline std::unordered_map<const void*, std::size_t>& getAllocSizes() noexcept
+  {
+    static std::unordered_map<const void*, std::size_t> sizes{};
+
+    return sizes;
+  }
+#endif
+
+  /**
+   * @brief Records an allocation.
+   * @param ptr The allocated memory.
+   * @param size The size of the allocation in bytes.
+   */
+  inline void recordAllocation([[maybe_unused]] const void* ptr, [[maybe_unused]] std::size_t size) noexcept
+  {
+#ifdef MATLABW_ENABLE_ALLOC_STATS
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+    auto& stats = getAllocStats();
+
+    ++stats.allocationCount;
+    stats.bytesAllocated += size;
+    stats.currentBytes   += size;
+    stats.peakBytes       = std::max(stats.peakBytes, stats.currentBytes);
+    ++stats.histogram[static_cast<std::size_t>(std::bit_width(size))];
+
+    try
+    {
+      getAllocSizes()[ptr] = size;
+    }
+    catch (...)
+    {
+      // Failing to track the size only makes the statistics inaccurate.
+    }
+#endif
+  }
+
+  /**
+   * @brief Records a free.
+   * @param ptr The freed memory.
+   */
+  inline void recordFree([[maybe_unused]] const void* ptr) noexcept
+  {
+#ifdef MATLABW_ENABLE_ALLOC_STATS
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+    auto& stats = getAllocStats();
+    auto& sizes = getAllocSizes();
+
+    ++stats.freeCount;
+
+    // Memory allocated before the statistics were reset has unknown size.
+    if (auto it = sizes.find(ptr); it != sizes.end())
+    {
+      stats.bytesFreed   += it->second;
+      stats.currentBytes -= it->second;
+      sizes.erase(it);
+    }
+#endif
+  }
+} // namespace detail
+
+  /**
+   * @brief Gets the allocation statistics collected since the last reset.
+   * @return The allocation statistics.
+   */
+  [[nodiscard]] inline const AllocStats& getAllocStats() noexcept
+  {
+    return detail::getAllocStats();
+  }
+
+  /// @brief Resets the allocation statistics. Allocations made before the reset are not tracked any more.
+  inline void resetAllocStats() noexcept
+  {
+    detail::getAllocStats() = AllocStats{};
+
+#ifdef MATLABW_ENABLE_ALLOC_STATS
+    detail::getAllocSizes().clear();
+#endif
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_ALLOC_STATS_HPP */
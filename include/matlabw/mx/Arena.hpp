@@ -0,0 +1,415 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ARENA_HPP
+#define MATLABW_MX_ARENA_HPP
+
+#include "detail/include.hpp"
+
+#include <memory_resource>
+
+#include "memory.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Bump-pointer arena for short-lived scratch allocations. Memory is obtained from mxMalloc in large blocks,
+   *        individual allocations are never freed, everything is released at once by reset() or release().
+   */
+  class Arena
+  {
+    public:
+      /// @brief Default size of a block in bytes.
+      static constexpr std::size_t defaultBlockSize{64 * 1024};
+
+      /**
+       * @brief Constructor.
+       * @param blockSize The size of the blocks obtained from mxMalloc in bytes.
+       */
+      explicit Arena(std::size_t blockSize = defaultBlockSize) noexcept
+      : mBlockSize{std::max(blockSize, sizeof(Block) + 64 * alignof(std::max_align_t))}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      Arena(const Arena&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other arena.
+       */
+      Arena(Arena&& other) noexcept
+      : mBlockSize{other.mBlockSize},
+        mHead{std::exchange(other.mHead, nullptr)},
+        mCurrent{std::exchange(other.mCurrent, nullptr)},
+        mEnd{std::exchange(other.mEnd, nullptr)},
+        mBytesUsed{std::exchange(other.mBytesUsed, 0)},
+        mBytesReserved{std::exchange(other.mBytesReserved, 0)}
+      {}
+
+      /// @brief Destructor. Releases all blocks.
+      ~Arena() noexcept
+      {
+        release();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Arena& operator=(const Arena&) = delete;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other arena.
+       * @return Reference to this arena.
+       */
+      Arena& operator=(Arena&& other) noexcept
+      {
+        if (this != &other)
+        {
+          release();
+
+          mBlockSize     = other.mBlockSize;
+          mHead          = std::exchange(other.mHead, nullptr);
+          mCurrent       = std::exchange(other.mCurrent, nullptr);
+          mEnd           = std::exchange(other.mEnd, nullptr);
+          mBytesUsed     = std::exchange(other.mBytesUsed, 0);
+          mBytesReserved = std::exchange(other.mBytesReserved, 0);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Allocates memory from the arena.
+       * @param size The size of the memory in bytes.
+       * @param alignment The alignment of the memory, must be a power of two.
+       * @return A pointer to the allocated memory. Never returns nullptr.
+       */
+      [[nodiscard]] void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+      {
+        if (void* ptr = tryBump(size, alignment))
+        {
+          return ptr;
+        }
+
+        if (size > std::numeric_limits<std::size_t>::max() - alignment)
+        {
+          throw std::bad_alloc();
+        }
+
+        // Large requests get a dedicated block so that the current block is not wasted.
+        if (size + alignment > (mBlockSize - sizeof(Block)) / 4)
+        {
+          std::byte* data = allocateBlock(size + alignment, (mHead != nullptr));
+
+          return bump(data, size, alignment);
+        }
+
+        mCurrent = allocateBlock(mBlockSize - sizeof(Block), false);
+        mEnd     = reinterpret_cast<std::byte*>(mHead) + mBlockSize;
+
+        return bump(mCurrent, size, alignment);
+      }
+
+      /**
+       * @brief Allocates an uninitialized array of objects from the arena.
+       * @tparam T The type of the objects.
+       * @param n The number of objects.
+       * @return A pointer to the allocated memory.
+       */
+      template<typename T>
+      [[nodiscard]] T* allocate(std::size_t n)
+      {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+          throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+      }
+
+      /// @brief Releases all blocks except the most recently allocated one which is reused for further allocations.
+      void reset() noexcept
+      {
+        if (mHead != nullptr)
+        {
+          freeBlocks(mHead->prev);
+          mHead->prev    = nullptr;
+          mCurrent       = reinterpret_cast<std::byte*>(mHead + 1);
+          mEnd           = reinterpret_cast<std::byte*>(mHead) + mHead->size;
+          mBytesUsed     = 0;
+          mBytesReserved = mHead->size;
+        }
+      }
+
+      /// @brief Releases all blocks.
+      void release() noexcept
+      {
+        freeBlocks(mHead);
+        mHead          = nullptr;
+        mCurrent       = nullptr;
+        mEnd           = nullptr;
+        mBytesUsed     = 0;
+        mBytesReserved = 0;
+      }
+
+      /**
+       * @brief Gets the number of bytes handed out since the last reset or release.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBytesUsed() const noexcept
+      {
+        return mBytesUsed;
+      }
+
+      /**
+       * @brief Gets the number of bytes obtained from mxMalloc.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBytesReserved() const noexcept
+      {
+        return mBytesReserved;
+      }
+
+      /**
+       * @brief Gets the block size.
+       * @return The block size in bytes.
+       */
+      [[nodiscard]] std::size_t getBlockSize() const noexcept
+      {
+        return mBlockSize;
+      }
+    private:
+      /// @brief Header stored at the beginning of each block.
+      struct alignas(std::max_align_t) Block
+      {
+        Block*      prev; ///< Previously allocated block.
+        std::size_t size; ///< Size of the block including the header.
+      };
+
+      /**
+       * @brief Tries to allocate from the current block.
+       * @param size The size of the memory in bytes.
+       * @param alignment The alignment of the memory.
+       * @return A pointer to the allocated memory or nullptr if the current block is exhausted.
+       */
+      [[nodiscard]] void* tryBump(std::size_t size, std::size_t alignment) noexcept
+      {
+        if (mCurrent == nullptr)
+        {
+          return nullptr;
+        }
+
+        const auto addr    = reinterpret_cast<std::uintptr_t>(mCurrent);
+        const auto aligned = (addr + (alignment - 1)) & ~(std::uintptr_t{alignment} - 1);
+        const auto end     = reinterpret_cast<std::uintptr_t>(mEnd);
+
+        if (aligned > end || size > end - aligned)
+        {
+          return nullptr;
+        }
+
+        mCurrent    = reinterpret_cast<std::byte*>(aligned + size);
+        mBytesUsed += size;
+
+        return reinterpret_cast<void*>(aligned);
+      }
+
+      /**
+       * @brief Aligns the pointer and accounts the allocation.
+       * @param data The pointer to the beginning of the free memory.
+       * @param size The size of the memory in bytes.
+       * @param alignment The alignment of the memory.
+       * @return A pointer to the allocated memory.
+       */
+      [[nodiscard]] void* bump(std::byte*& data, std::size_t size, std::size_t alignment) noexcept
+      {
+        const auto addr    = reinterpret_cast<std::uintptr_t>(data);
+        const auto aligned = (addr + (alignment - 1)) & ~(std::uintptr_t{alignment} - 1);
+
+        data        = reinterpret_cast<std::byte*>(aligned + size);
+        mBytesUsed += size;
+
+        return reinterpret_cast<void*>(aligned);
+      }
+
+      /**
+       * @brief Allocates a new block.
+       * @param size The usable size of the block in bytes.
+       * @param behindHead If true, the block is linked behind the head so the current block stays active.
+       * @return A pointer to the usable memory of the block.
+       */
+      [[nodiscard]] std::byte* allocateBlock(std::size_t size, bool behindHead)
+      {
+        if (size > std::numeric_limits<std::size_t>::max() - sizeof(Block))
+        {
+          throw std::bad_alloc();
+        }
+
+        const std::size_t blockSize = size + sizeof(Block);
+
+        auto block = static_cast<Block*>(malloc(blockSize));
+
+        if (block == nullptr)
+        {
+          throw std::bad_alloc();
+        }
+
+        block->size     = blockSize;
+        mBytesReserved += blockSize;
+
+        if (behindHead)
+        {
+          block->prev = mHead->prev;
+          mHead->prev = block;
+        }
+        else
+        {
+          block->prev = mHead;
+          mHead       = block;
+        }
+
+        return reinterpret_cast<std::byte*>(block + 1);
+      }
+
+      /**
+       * @brief Frees a chain of blocks.
+       * @param block The first block of the chain.
+       */
+      static void freeBlocks(Block* block) noexcept
+      {
+        while (block != nullptr)
+        {
+          free(std::exchange(block, block->prev));
+        }
+      }
+
+      std::size_t mBlockSize{};     ///< Size of regular blocks.
+      Block*      mHead{};          ///< Most recently allocated regular block.
+      std::byte*  mCurrent{};       ///< Current position in the head block.
+      std::byte*  mEnd{};           ///< End of the head block.
+      std::size_t mBytesUsed{};     ///< Number of bytes handed out.
+      std::size_t mBytesReserved{}; ///< Number of bytes obtained from mxMalloc.
+  };
+
+  /**
+   * @brief Allocator for use with std containers which allocates from an arena. Deallocation is a no-op.
+   * @tparam T The type of the allocated memory.
+   */
+  template<typename T>
+  class ArenaAllocator
+  {
+    template<typename U>
+    friend class ArenaAllocator;
+
+    public:
+      using value_type = T; ///< The type of the allocated memory.
+
+      /**
+       * @brief Constructor.
+       * @param arena The arena to allocate from.
+       */
+      ArenaAllocator(Arena& arena) noexcept
+      : mArena{&arena}
+      {}
+
+      /**
+       * @brief Copy constructor.
+       * @tparam U The type of the allocated memory.
+       * @param other The allocator to copy.
+       */
+      template<typename U>
+      ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : mArena{other.mArena}
+      {}
+
+      /**
+       * @brief Allocates memory.
+       * @param n The number of elements to allocate.
+       * @return A pointer to the allocated memory.
+       */
+      [[nodiscard]] T* allocate(std::size_t n)
+      {
+        return mArena->allocate<T>(n);
+      }
+
+      /// @brief Deallocates memory. Does nothing, the memory is released together with the arena.
+      void deallocate(T*, std::size_t) noexcept {}
+
+      /**
+       * @brief Compares two allocators.
+       * @tparam U The type of the other allocator.
+       * @param other The other allocator.
+       * @return True if both allocators use the same arena.
+       */
+      template<typename U>
+      [[nodiscard]] bool operator==(const ArenaAllocator<U>& other) const noexcept
+      {
+        return mArena == other.mArena;
+      }
+    private:
+      Arena* mArena; ///< The arena to allocate from.
+  };
+
+  /// @brief Polymorphic memory resource adapter over an arena. Allows using std::pmr containers with an arena.
+  class ArenaResource : public std::pmr::memory_resource
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param arena The arena to allocate from.
+       */
+      explicit ArenaResource(Arena& arena) noexcept
+      : mArena{&arena}
+      {}
+
+      /**
+       * @brief Gets the underlying arena.
+       * @return The arena.
+       */
+      [[nodiscard]] Arena& getArena() const noexcept
+      {
+        return *mArena;
+      }
+    private:
+      /// @copydoc std::pmr::memory_resource::do_allocate
+      void* do_allocate(std::size_t bytes, std::size_t alignment) override
+      {
+        return mArena->allocate(bytes, alignment);
+      }
+
+      /// @copydoc std::pmr::memory_resource::do_deallocate
+      void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+      /// @copydoc std::pmr::memory_resource::do_is_equal
+      [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+      {
+        auto otherArena = dynamic_cast<const ArenaResource*>(&other);
+
+        return otherArena != nullptr && otherArena->mArena == mArena;
+      }
+
+      Arena* mArena; ///< The arena to allocate from.
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_ARENA_HPP */
@@ -29,6 +29,7 @@
 
 #include "ArrayRef.hpp"
 #include "common.hpp"
+#include "Dims.hpp"
 #include "Exception.hpp"
 #include "typeTraits.hpp"
 
@@ -222,6 +223,8 @@ namespace matlabw::mx
       {
         checkValid("matlabw:mx:Array:resize");
 
+        static_cast<void>(checkDims("matlabw:mx:Array:resize", dims));
+
         if (mxSetDimensions(mArray, dims.data(), dims.size()))
         {
           throw Exception{"failed to resize array"};
@@ -569,14 +572,15 @@ namespace matlabw::mx
       }
 
       /**
-       * @brief Get the array data as a specific type
-       * @tparam T Type
-       * @return Reference to the array data
+       * @brief Gets the first element converted to a specific type from any numeric, logical or char class
+       * @tparam T Numeric or logical type
+       * @return The converted value
        */
       template<typename T>
       [[nodiscard]] T getScalarAs() const
       {
-        return *getDataAs<T>();
+        checkValid("matlabw:mx:Array:getScalarAs");
+        return detail::getScalarAs<T>(mArray);
       }
 
       /**
@@ -627,15 +631,17 @@ namespace matlabw::mx
       }
     protected:
       /**
-       * @brief Check if the array is valid
+       * @brief Check if the array is valid. The check is compiled out if MATLABW_DISABLE_VALIDITY_CHECKS is defined.
        * @param id Function ID
        */
-      void checkValid(const char* id) const
+      void checkValid([[maybe_unused]] const char* id) const
       {
+#     ifndef MATLABW_DISABLE_VALIDITY_CHECKS
         if (!isValid())
         {
           throw Exception{id, "accessing invalid array"};
         }
+#     endif
       }
     private:
       /**
@@ -0,0 +1,553 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ARRAY_DESC_HPP
+#define MATLABW_MX_ARRAY_DESC_HPP
+
+#include "detail/include.hpp"
+
+#include "detail/hash.hpp"
+#include "Array.hpp"
+#include "ArrayRef.hpp"
+#include "common.hpp"
+#include "Exception.hpp"
+#include "NumericArray.hpp"
+#include "typeTraits.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Class, complexity and dimensions of an array captured in a single pass. Unlike ArraySnapshot the descriptor
+   *        owns its dimensions, so it stays valid after the array changes and can be compared, hashed and used to
+   *        create arrays. Dimensions up to the inline rank are stored without allocation. Trailing singleton
+   *        dimensions are dropped, so equal shapes compare equal regardless of how they were specified.
+   */
+  class ArrayDesc
+  {
+    public:
+      /// @brief Maximum rank stored without allocation.
+      static constexpr std::size_t inlineRank{4};
+
+      /// @brief Default constructor. Describes a 0-by-0 real double array.
+      ArrayDesc() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param classId The class ID.
+       * @param complexity The complexity.
+       * @param dims The dimensions.
+       */
+      ArrayDesc(ClassId classId, Complexity complexity, View<std::size_t> dims)
+      : mClassId{classId}, mComplexity{complexity}, mElementSize{getClassElementSize(classId, complexity)}
+      {
+        setDims(dims);
+      }
+
+      /**
+       * @brief Constructor. Captures the descriptor of an array.
+       * @param array The array.
+       */
+      explicit ArrayDesc(ArrayCref array)
+      : mClassId{static_cast<ClassId>(mxGetClassID(array.get()))},
+        mComplexity{mxIsComplex(array.get()) ? Complexity::complex : Complexity::real},
+        mElementSize{mxGetElementSize(array.get())}
+      {
+        setDims(View<std::size_t>{mxGetDimensions(array.get()), mxGetNumberOfDimensions(array.get())});
+      }
+
+      /**
+       * @brief Constructor. Captures the descriptor of an array.
+       * @param array The array.
+       * @throws Exception if the array is not valid.
+       */
+      explicit ArrayDesc(const Array& array)
+      : ArrayDesc{checkValid(array)}
+      {}
+
+      /**
+       * @brief Makes a descriptor of a type.
+       * @tparam T The element type.
+       * @param dims The dimensions.
+       * @return The descriptor.
+       */
+      template<typename T>
+      [[nodiscard]] static ArrayDesc of(View<std::size_t> dims)
+      {
+        return ArrayDesc{TypeProperties<T>::classId, getComplexity<T>(), dims};
+      }
+
+      /**
+       * @brief Makes a descriptor of a type.
+       * @tparam T The element type.
+       * @param m The number of rows.
+       * @param n The number of columns.
+       * @return The descriptor.
+       */
+      template<typename T>
+      [[nodiscard]] static ArrayDesc of(std::size_t m, std::size_t n)
+      {
+        return of<T>({{m, n}});
+      }
+
+      /**
+       * @brief Makes a descriptor of the same dimensions and another class, e.g. for an output like an input.
+       * @param classId The class ID.
+       * @param complexity The complexity.
+       * @return The descriptor.
+       */
+      [[nodiscard]] ArrayDesc withClass(ClassId classId, Complexity complexity = Complexity::real) const
+      {
+        return ArrayDesc{classId, complexity, getDims()};
+      }
+
+      /**
+       * @brief Makes a descriptor of the same dimensions and another type.
+       * @tparam T The element type.
+       * @return The descriptor.
+       */
+      template<typename T>
+      [[nodiscard]] ArrayDesc withType() const
+      {
+        return withClass(TypeProperties<T>::classId, getComplexity<T>());
+      }
+
+      /**
+       * @brief Makes a descriptor of the same class and other dimensions.
+       * @param dims The dimensions.
+       * @return The descriptor.
+       */
+      [[nodiscard]] ArrayDesc withDims(View<std::size_t> dims) const
+      {
+        return ArrayDesc{mClassId, mComplexity, dims};
+      }
+
+      /**
+       * @brief Gets the class ID.
+       * @return The class ID.
+       */
+      [[nodiscard]] ClassId getClassId() const noexcept
+      {
+        return mClassId;
+      }
+
+      /**
+       * @brief Gets the complexity.
+       * @return The complexity.
+       */
+      [[nodiscard]] Complexity getComplexity() const noexcept
+      {
+        return mComplexity;
+      }
+
+      /**
+       * @brief Is the element class complex?
+       * @return True if complex.
+       */
+      [[nodiscard]] bool isComplex() const noexcept
+      {
+        return mComplexity == Complexity::complex;
+      }
+
+      /**
+       * @brief Checks if the elements are of a type.
+       * @tparam T The element type.
+       * @return True if the class ID and the complexity match the type.
+       */
+      template<typename T>
+      [[nodiscard]] bool is() const noexcept
+      {
+        return mClassId == TypeProperties<T>::classId && mComplexity == getComplexity<T>();
+      }
+
+      /**
+       * @brief Gets the rank, at least 2.
+       * @return The rank.
+       */
+      [[nodiscard]] std::size_t getRank() const noexcept
+      {
+        return mRank;
+      }
+
+      /**
+       * @brief Gets the dimensions.
+       * @return The dimensions.
+       */
+      [[nodiscard]] View<std::size_t> getDims() const noexcept
+      {
+        return View<std::size_t>{(mRank <= inlineRank) ? mInlineDims.data() : mHeapDims.data(), mRank};
+      }
+
+      /**
+       * @brief Gets a dimension, dimensions beyond the rank are 1.
+       * @param k The dimension index.
+       * @return The dimension.
+       */
+      [[nodiscard]] std::size_t getDim(std::size_t k) const noexcept
+      {
+        return (k < mRank) ? getDims()[k] : 1;
+      }
+
+      /**
+       * @brief Gets the number of rows.
+       * @return The number of rows.
+       */
+      [[nodiscard]] std::size_t getDimM() const noexcept
+      {
+        return mInlineDims[0];
+      }
+
+      /**
+       * @brief Gets the number of columns, all trailing dimensions are folded into the columns.
+       * @return The number of columns.
+       */
+      [[nodiscard]] std::size_t getDimN() const noexcept
+      {
+        return (mInlineDims[0] != 0) ? mSize / mInlineDims[0] : 0;
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Gets the size of an element in bytes.
+       * @return The size of an element, 0 for classes without a fixed element size.
+       */
+      [[nodiscard]] std::size_t getElementSize() const noexcept
+      {
+        return mElementSize;
+      }
+
+      /**
+       * @brief Gets the size of the data in bytes.
+       * @return The size of the data.
+       */
+      [[nodiscard]] std::size_t getSizeInBytes() const noexcept
+      {
+        return mSize * mElementSize;
+      }
+
+      /**
+       * @brief Is the array empty?
+       * @return True if empty.
+       */
+      [[nodiscard]] bool isEmpty() const noexcept
+      {
+        return mSize == 0;
+      }
+
+      /**
+       * @brief Is the array a scalar?
+       * @return True if scalar.
+       */
+      [[nodiscard]] bool isScalar() const noexcept
+      {
+        return mSize == 1;
+      }
+
+      /**
+       * @brief Is the array a vector, 1-by-n or n-by-1?
+       * @return True if vector.
+       */
+      [[nodiscard]] bool isVector() const noexcept
+      {
+        return mRank == 2 && (mInlineDims[0] == 1 || mInlineDims[1] == 1);
+      }
+
+      /**
+       * @brief Checks if the dimensions are equal to the dimensions of another descriptor.
+       * @param other The other descriptor.
+       * @return True if the dimensions are equal.
+       */
+      [[nodiscard]] bool hasSameDims(const ArrayDesc& other) const noexcept
+      {
+        return std::ranges::equal(getDims(), other.getDims());
+      }
+
+      /**
+       * @brief Checks if the class and the complexity are equal to those of another descriptor.
+       * @param other The other descriptor.
+       * @return True if the types are equal.
+       */
+      [[nodiscard]] bool hasSameType(const ArrayDesc& other) const noexcept
+      {
+        return mClassId == other.mClassId && mComplexity == other.mComplexity;
+      }
+
+      /**
+       * @brief Compares the descriptors.
+       * @param other The other descriptor.
+       * @return True if the class, complexity and dimensions are equal.
+       */
+      [[nodiscard]] bool operator==(const ArrayDesc& other) const noexcept
+      {
+        return hasSameType(other) && hasSameDims(other);
+      }
+
+      /**
+       * @brief Hashes the descriptor.
+       * @return The hash.
+       */
+      [[nodiscard]] std::size_t hash() const noexcept
+      {
+        std::uint64_t value = detail::hashAvalanche((static_cast<std::uint64_t>(mClassId) << 1)
+                                                    | static_cast<std::uint64_t>(isComplex()));
+
+        for (const std::size_t dim : getDims())
+        {
+          value = detail::hashAvalanche(value ^ (dim * detail::hashPrimes[0]));
+        }
+
+        return static_cast<std::size_t>(value);
+      }
+
+    private:
+      /**
+       * @brief Gets the complexity of a type.
+       * @tparam T The element type.
+       * @return The complexity, real for types without complexity.
+       */
+      template<typename T>
+      [[nodiscard]] static constexpr Complexity getComplexity() noexcept
+      {
+        if constexpr (requires { TypeProperties<T>::complexity; })
+        {
+          return TypeProperties<T>::complexity;
+        }
+        else
+        {
+          return Complexity::real;
+        }
+      }
+
+      /**
+       * @brief Gets the size of an element of a class.
+       * @param classId The class ID.
+       * @param complexity The complexity.
+       * @return The size, 0 for classes without a fixed element size.
+       */
+      [[nodiscard]] static constexpr std::size_t getClassElementSize(ClassId classId, Complexity complexity) noexcept
+      {
+        std::size_t size{};
+
+        switch (classId)
+        {
+        case ClassId::cell:
+        case ClassId::_struct:
+          return sizeof(mxArray*);
+        case ClassId::logical:
+          return sizeof(mxLogical);
+        case ClassId::_char:
+          return sizeof(mxChar);
+        case ClassId::_double:
+        case ClassId::int64:
+        case ClassId::uint64:
+          size = 8;
+          break;
+        case ClassId::single:
+        case ClassId::int32:
+        case ClassId::uint32:
+          size = 4;
+          break;
+        case ClassId::int16:
+        case ClassId::uint16:
+          size = 2;
+          break;
+        case ClassId::int8:
+        case ClassId::uint8:
+          size = 1;
+          break;
+        default:
+          return 0;
+        }
+
+        return (complexity == Complexity::complex) ? 2 * size : size;
+      }
+
+      /**
+       * @brief Checks that an array is valid.
+       * @param array The array.
+       * @return The reference to the array.
+       */
+      [[nodiscard]] static ArrayCref checkValid(const Array& array)
+      {
+        if (!array.isValid())
+        {
+          throw Exception{"matlabw:mx:ArrayDesc", "describing invalid array"};
+        }
+
+        return array;
+      }
+
+      /**
+       * @brief Sets the dimensions, drops trailing singletons beyond the second dimension.
+       * @param dims The dimensions.
+       */
+      void setDims(View<std::size_t> dims)
+      {
+        std::size_t rank = dims.size();
+
+        while (rank > 2 && dims[rank - 1] == 1)
+        {
+          --rank;
+        }
+
+        mRank       = std::max(rank, std::size_t{2});
+        mInlineDims = {};
+        mHeapDims.clear();
+
+        std::size_t* out = mInlineDims.data();
+
+        if (mRank > inlineRank)
+        {
+          mHeapDims.resize(mRank);
+          out = mHeapDims.data();
+        }
+
+        // missing dimensions of rank 0 or 1 inputs are 1
+        std::fill_n(out, mRank, std::size_t{1});
+        std::copy_n(dims.begin(), std::min(rank, dims.size()), out);
+
+        mSize = 1;
+
+        for (std::size_t k{}; k < mRank; ++k)
+        {
+          mSize *= out[k];
+        }
+      }
+
+      ClassId                             mClassId{ClassId::_double};   ///< The class ID
+      Complexity                          mComplexity{Complexity::real}; ///< The complexity
+      std::size_t                         mRank{2};                      ///< The rank
+      std::array<std::size_t, inlineRank> mInlineDims{};                 ///< The dimensions up to the inline rank
+      std::vector<std::size_t>            mHeapDims{};                   ///< The dimensions above the inline rank
+      std::size_t                         mSize{};                       ///< The number of elements
+      std::size_t                         mElementSize{sizeof(double)};  ///< The element size in bytes
+  };
+
+namespace detail
+{
+  /**
+   * @brief Checks if a class is numeric.
+   * @param classId The class ID.
+   * @return True for the floating point and integer classes.
+   */
+  [[nodiscard]] constexpr bool isNumericClass(ClassId classId) noexcept
+  {
+    switch (classId)
+    {
+    case ClassId::_double:
+    case ClassId::single:
+    case ClassId::int8:
+    case ClassId::uint8:
+    case ClassId::int16:
+    case ClassId::uint16:
+    case ClassId::int32:
+    case ClassId::uint32:
+    case ClassId::int64:
+    case ClassId::uint64:
+      return true;
+    default:
+      return false;
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Creates a zeroed array described by a descriptor. Cell arrays are created with empty cells.
+   * @param desc The descriptor.
+   * @return The array.
+   * @throws Exception if the class can not be created from a descriptor.
+   */
+  [[nodiscard]] inline Array makeArray(const ArrayDesc& desc)
+  {
+    static constexpr char id[]{"matlabw:mx:makeArray"};
+
+    const View<std::size_t> dims = desc.getDims();
+
+    if (detail::isNumericClass(desc.getClassId()))
+    {
+      return makeNumericArray(dims, desc.getClassId(), desc.getComplexity());
+    }
+
+    static_cast<void>(checkDims(id, dims));
+
+    mxArray* array{};
+
+    switch (desc.getClassId())
+    {
+    case ClassId::cell:
+      array = mxCreateCellArray(dims.size(), dims.data());
+      break;
+    case ClassId::logical:
+      array = mxCreateLogicalArray(dims.size(), dims.data());
+      break;
+    case ClassId::_char:
+      array = mxCreateCharArray(dims.size(), dims.data());
+      break;
+    default:
+      throw Exception{id, "class can not be created from a descriptor"};
+    }
+
+    if (array == nullptr)
+    {
+      throw Exception{id, "failed to create array"};
+    }
+
+    return Array{std::move(array)};
+  }
+
+  /**
+   * @brief Creates an array described by a descriptor, numeric arrays are uninitialized, other arrays are zeroed.
+   * @param desc The descriptor.
+   * @return The array.
+   * @throws Exception if the class can not be created from a descriptor.
+   */
+  [[nodiscard]] inline Array makeUninitArray(const ArrayDesc& desc)
+  {
+    if (detail::isNumericClass(desc.getClassId()))
+    {
+      return makeUninitNumericArray(desc.getDims(), desc.getClassId(), desc.getComplexity());
+    }
+
+    return makeArray(desc);
+  }
+} // namespace matlabw::mx
+
+/// @brief Hash of an array descriptor.
+template<>
+struct std::hash<matlabw::mx::ArrayDesc>
+{
+  [[nodiscard]] std::size_t operator()(const matlabw::mx::ArrayDesc& desc) const noexcept
+  {
+    return desc.hash();
+  }
+};
+
+#endif /* MATLABW_MX_ARRAY_DESC_HPP */
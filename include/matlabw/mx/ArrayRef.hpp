@@ -27,12 +27,105 @@
 
 #include "detail/include.hpp"
 
+#include "detail/saturate.hpp"
 #include "common.hpp"
+#include "Dims.hpp"
 #include "Exception.hpp"
 #include "typeTraits.hpp"
 
 namespace matlabw::mx
 {
+namespace detail
+{
+  /**
+   * @brief Converts the first element of array data with MATLAB cast semantics, so integers round, saturate and map
+   *        NaN to zero instead of invoking undefined behaviour on out of range values.
+   * @tparam T Target type
+   * @tparam U Element type of the data
+   * @param data Array data
+   * @param complex Whether the data are complex, i.e. data[1] is the imaginary part
+   * @return Converted value
+   */
+  template<typename T, typename U>
+  [[nodiscard]] T castScalar(const U* data, const bool complex) noexcept
+  {
+    if constexpr (std::is_same_v<U, mxChar>)
+    {
+      // Chars convert by their code unit.
+      const auto code = static_cast<std::uint16_t>(data[0]);
+
+      return castScalar<T>(&code, false);
+    }
+    else if constexpr (isComplexNumeric<T>)
+    {
+      using Real = typename T::value_type;
+
+      return T{saturateCast<Real>(data[0]), (complex) ? saturateCast<Real>(data[1]) : Real{}};
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+      return data[0] != U{};
+    }
+    else
+    {
+      return saturateCast<T>(data[0]);
+    }
+  }
+
+  /**
+   * @brief Gets the first element of a numeric, logical or char array converted to T with MATLAB cast semantics, in one
+   *        switch over the class.
+   * @tparam T Target type
+   * @param array Valid mxArray pointer
+   * @return Converted value, the real part if T is real and the array is complex
+   */
+  template<typename T>
+  [[nodiscard]] T getScalarAs(const mxArray* array)
+  {
+    static_assert(isNumeric<T> || std::is_same_v<T, bool>, "T must be a numeric or logical type");
+
+    static constexpr char id[]{"matlabw:mx:getScalarAs"};
+
+    if (mxIsSparse(array) || mxGetNumberOfElements(array) == 0)
+    {
+      throw Exception{id, "array must be non-empty and dense"};
+    }
+
+    const void* data    = mxGetData(array);
+    const bool  complex = mxIsComplex(array);
+
+    switch (static_cast<ClassId>(mxGetClassID(array)))
+    {
+    case ClassId::_double:
+      return castScalar<T>(static_cast<const double*>(data), complex);
+    case ClassId::single:
+      return castScalar<T>(static_cast<const float*>(data), complex);
+    case ClassId::int8:
+      return castScalar<T>(static_cast<const std::int8_t*>(data), complex);
+    case ClassId::uint8:
+      return castScalar<T>(static_cast<const std::uint8_t*>(data), complex);
+    case ClassId::int16:
+      return castScalar<T>(static_cast<const std::int16_t*>(data), complex);
+    case ClassId::uint16:
+      return castScalar<T>(static_cast<const std::uint16_t*>(data), complex);
+    case ClassId::int32:
+      return castScalar<T>(static_cast<const std::int32_t*>(data), complex);
+    case ClassId::uint32:
+      return castScalar<T>(static_cast<const std::uint32_t*>(data), complex);
+    case ClassId::int64:
+      return castScalar<T>(static_cast<const std::int64_t*>(data), complex);
+    case ClassId::uint64:
+      return castScalar<T>(static_cast<const std::uint64_t*>(data), complex);
+    case ClassId::logical:
+      return castScalar<T>(static_cast<const mxLogical*>(data), false);
+    case ClassId::_char:
+      return castScalar<T>(static_cast<const mxChar*>(data), false);
+    default:
+      throw Exception{id, "array must be numeric, logical or char"};
+    }
+  }
+} // namespace detail
+
   /**
    * @brief Implements a reference to an array.
    * @tparam T The const or non-const type of the array.
@@ -130,6 +223,8 @@ namespace matlabw::mx
        */
       void resize(View<std::size_t> dims) const
       {
+        static_cast<void>(checkDims("matlabw:mx:ArrayRef:resize", dims));
+
         if (mxSetDimensions(mArray, dims.data(), dims.size()))
         {
           throw Exception{"failed to resize array"};
@@ -415,14 +510,14 @@ namespace matlabw::mx
       }
 
       /**
-       * @brief Get the array data as a specific type
-       * @tparam T Type
-       * @return Reference to the array data
+       * @brief Gets the first element converted to a specific type from any numeric, logical or char class
+       * @tparam T Numeric or logical type
+       * @return The converted value
        */
       template<typename T>
       [[nodiscard]] T getScalarAs() const
       {
-        return *getDataAs<T>();
+        return detail::getScalarAs<T>(mArray);
       }
 
       /**
@@ -816,14 +911,14 @@ namespace matlabw::mx
       }
 
       /**
-       * @brief Get the array data as a specific type
-       * @tparam T Type
-       * @return Reference to the array data
+       * @brief Gets the first element converted to a specific type from any numeric, logical or char class
+       * @tparam T Numeric or logical type
+       * @return The converted value
        */
       template<typename T>
       [[nodiscard]] T getScalarAs() const
       {
-        return *getDataAs<T>();
+        return detail::getScalarAs<T>(mArray);
       }
 
       /**
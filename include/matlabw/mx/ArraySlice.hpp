@@ -0,0 +1,718 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ARRAY_SLICE_HPP
+#define MATLABW_MX_ARRAY_SLICE_HPP
+
+#include "detail/include.hpp"
+
+#include <complex>
+#include <cstring>
+#include <iterator>
+
+#include "common.hpp"
+#include "Dims.hpp"
+#include "Exception.hpp"
+#include "MdSpan.hpp"
+#include "NumericArray.hpp"
+#include "TypedArrayRef.hpp"
+#include "typeTraits.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief Half-open range of zero based indices with a step used to select a part of a dimension.
+  struct Range
+  {
+    std::size_t begin{};                                      ///< First index
+    std::size_t end{std::numeric_limits<std::size_t>::max()}; ///< One past the last index, clamped to the extent
+    std::size_t step{1};                                      ///< Step, must be at least 1
+
+    /**
+     * @brief Creates a range selecting the whole dimension.
+     * @return The range
+     */
+    [[nodiscard]] static constexpr Range all() noexcept
+    {
+      return Range{};
+    }
+
+    /**
+     * @brief Creates a range selecting a single index, unlike wider ranges it is not clamped to the extent.
+     * @param i The index, must be less than the extent
+     * @return The range
+     */
+    [[nodiscard]] static constexpr Range single(std::size_t i) noexcept
+    {
+      return Range{i, i + 1};
+    }
+  };
+
+  /**
+   * @brief Non-owning strided view of a part of an array. Each dimension has its own extent and stride, so column
+   *        blocks, pages or every n-th element can be passed to kernels without copying.
+   * @tparam T Element type, const-qualified for read-only slices
+   */
+  template<typename T>
+  class ArraySlice
+  {
+    template<typename U>
+    friend class ArraySlice;
+
+    public:
+      using value_type = std::remove_const_t<T>; ///< Value type
+      using reference  = T&;                     ///< Reference type
+      using pointer    = T*;                     ///< Pointer type
+
+      /// @brief Maximum supported rank.
+      static constexpr std::size_t maxRank{32};
+
+      /// @brief Forward iterator visiting the elements in column-major order.
+      class Iterator
+      {
+        public:
+          using iterator_category = std::forward_iterator_tag; ///< Iterator category
+          using value_type        = std::remove_const_t<T>;    ///< Value type
+          using difference_type   = std::ptrdiff_t;            ///< Difference type
+          using pointer           = T*;                        ///< Pointer type
+          using reference         = T&;                        ///< Reference type
+
+          /// @brief Default constructor.
+          Iterator() noexcept = default;
+
+          /**
+           * @brief Constructor.
+           * @param slice The slice
+           * @param position Linear position
+           */
+          Iterator(const ArraySlice* slice, std::size_t position) noexcept
+          : mSlice{slice}, mPtr{slice->mData}, mPosition{position}
+          {}
+
+          /**
+           * @brief Dereferences the iterator.
+           * @return Reference to the element
+           */
+          [[nodiscard]] reference operator*() const noexcept
+          {
+            return *mPtr;
+          }
+
+          /**
+           * @brief Accesses the element.
+           * @return Pointer to the element
+           */
+          [[nodiscard]] pointer operator->() const noexcept
+          {
+            return mPtr;
+          }
+
+          /**
+           * @brief Advances the iterator.
+           * @return Reference to this iterator
+           */
+          Iterator& operator++() noexcept
+          {
+            ++mPosition;
+
+            for (std::size_t r{}; r < mSlice->mRank; ++r)
+            {
+              mPtr += mSlice->mStrides[r];
+
+              if (++mIndex[r] < mSlice->mExtents[r])
+              {
+                break;
+              }
+
+              mPtr      -= mSlice->mStrides[r] * mSlice->mExtents[r];
+              mIndex[r]  = 0;
+            }
+
+            return *this;
+          }
+
+          /**
+           * @brief Advances the iterator.
+           * @return Copy of the iterator before advancing
+           */
+          Iterator operator++(int) noexcept
+          {
+            Iterator tmp{*this};
+            ++*this;
+            return tmp;
+          }
+
+          /**
+           * @brief Compares iterators.
+           * @param other Other iterator
+           * @return True if both iterators point to the same position
+           */
+          [[nodiscard]] bool operator==(const Iterator& other) const noexcept
+          {
+            return mPosition == other.mPosition;
+          }
+        private:
+          const ArraySlice*                 mSlice{};    ///< The slice
+          pointer                           mPtr{};      ///< Current element
+          std::size_t                       mPosition{}; ///< Linear position
+          std::array<std::size_t, maxRank>  mIndex{};    ///< Current multidimensional index
+      };
+
+      using iterator = Iterator; ///< Iterator type
+
+      /// @brief Default constructor. Creates an empty slice.
+      ArraySlice() noexcept = default;
+
+      /**
+       * @brief Constructor from raw data.
+       * @param data Pointer to the first element of the slice
+       * @param extents Extents of the slice
+       * @param strides Strides of the slice in elements
+       */
+      ArraySlice(pointer data, View<std::size_t> extents, View<std::size_t> strides)
+      : mData{data}, mRank{extents.size()}
+      {
+        if (extents.size() != strides.size() || extents.size() > maxRank || extents.empty())
+        {
+          throw Exception{"matlabw:mx:ArraySlice", "invalid slice rank"};
+        }
+
+        static_cast<void>(checkDims("matlabw:mx:ArraySlice", extents));
+
+        std::copy(extents.begin(), extents.end(), mExtents.begin());
+        std::copy(strides.begin(), strides.end(), mStrides.begin());
+      }
+
+      /**
+       * @brief Constructor from a mutable typed array reference.
+       * @param array The array
+       * @param ranges Ranges per dimension, missing trailing ranges select the whole dimension
+       */
+      ArraySlice(TypedArrayRef<value_type> array, View<Range> ranges = {}) requires (!std::is_const_v<T>)
+      : ArraySlice{array.getData(), array.getDims(), ranges}
+      {}
+
+      /**
+       * @brief Constructor from a typed array const reference.
+       * @param array The array
+       * @param ranges Ranges per dimension, missing trailing ranges select the whole dimension
+       */
+      ArraySlice(TypedArrayCref<value_type> array, View<Range> ranges = {}) requires std::is_const_v<T>
+      : ArraySlice{array.getData(), array.getDims(), ranges}
+      {}
+
+      /**
+       * @brief Converting constructor from a mutable slice.
+       * @tparam U Element type of the mutable slice
+       * @param other The mutable slice
+       */
+      template<typename U>
+        requires (std::is_const_v<T> && std::is_same_v<U, value_type>)
+      ArraySlice(const ArraySlice<U>& other) noexcept
+      : mData{other.mData}, mRank{other.mRank}, mExtents{other.mExtents}, mStrides{other.mStrides}
+      {}
+
+      /**
+       * @brief Gets the rank of the slice.
+       * @return The rank
+       */
+      [[nodiscard]] std::size_t getRank() const noexcept
+      {
+        return mRank;
+      }
+
+      /**
+       * @brief Gets the dimensions of the slice.
+       * @return View of the dimensions
+       */
+      [[nodiscard]] View<std::size_t> getDims() const noexcept
+      {
+        return View<std::size_t>{mExtents.data(), mRank};
+      }
+
+      /**
+       * @brief Gets the strides of the slice.
+       * @return View of the strides in elements
+       */
+      [[nodiscard]] View<std::size_t> getStrides() const noexcept
+      {
+        return View<std::size_t>{mStrides.data(), mRank};
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        std::size_t size{mRank != 0};
+
+        for (std::size_t r{}; r < mRank; ++r)
+        {
+          size *= mExtents[r];
+        }
+
+        return size;
+      }
+
+      /**
+       * @brief Is the slice empty?
+       * @return True if the slice has no elements
+       */
+      [[nodiscard]] bool isEmpty() const noexcept
+      {
+        return getSize() == 0;
+      }
+
+      /**
+       * @brief Gets the pointer to the first element.
+       * @return Pointer to the first element
+       */
+      [[nodiscard]] pointer getData() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Are the elements contiguous in column-major order?
+       * @return True if the slice is contiguous
+       */
+      [[nodiscard]] bool isContiguous() const noexcept
+      {
+        std::size_t expected{1};
+
+        for (std::size_t r{}; r < mRank; ++r)
+        {
+          if (mExtents[r] != 1 && mStrides[r] != expected)
+          {
+            return false;
+          }
+
+          expected *= mExtents[r];
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Accesses an element without bounds checking.
+       * @param indices Zero based indices, missing trailing indices are zero
+       * @return Reference to the element
+       */
+      [[nodiscard]] reference operator()(std::initializer_list<std::size_t> indices) const noexcept
+      {
+        std::size_t offset{};
+        std::size_t r{};
+
+        for (std::size_t i : indices)
+        {
+          offset += i * mStrides[r++];
+        }
+
+        return mData[offset];
+      }
+
+      /**
+       * @brief Accesses an element without bounds checking.
+       * @tparam Indices Index types
+       * @param indices Zero based indices, missing trailing indices are zero
+       * @return Reference to the element
+       */
+      template<typename... Indices>
+        requires (std::is_convertible_v<Indices, std::size_t> && ...)
+      [[nodiscard]] reference operator()(Indices... indices) const noexcept
+      {
+        return (*this)({static_cast<std::size_t>(indices)...});
+      }
+
+      /**
+       * @brief Creates a sub-slice.
+       * @param ranges Ranges per dimension relative to this slice
+       * @return The sub-slice
+       */
+      [[nodiscard]] ArraySlice slice(View<Range> ranges) const
+      {
+        ArraySlice result{};
+        result.mData    = mData;
+        result.mRank    = mRank;
+        result.mExtents = mExtents;
+        result.mStrides = mStrides;
+        result.applyRanges(ranges);
+
+        return result;
+      }
+
+      /**
+       * @brief Gets an iterator to the first element.
+       * @return Iterator
+       */
+      [[nodiscard]] iterator begin() const noexcept
+      {
+        return iterator{this, 0};
+      }
+
+      /**
+       * @brief Gets an iterator past the last element.
+       * @return Iterator
+       */
+      [[nodiscard]] iterator end() const noexcept
+      {
+        return iterator{this, getSize()};
+      }
+
+      /**
+       * @brief Calls the function for every contiguous run along the first dimension. This is the fastest way to
+       *        traverse the slice, the inner loop over a run can be vectorized.
+       * @tparam Fn Function type, called as fn(pointer first, std::size_t count, std::size_t stride)
+       * @param fn The function
+       */
+      template<typename Fn>
+      void forEachRun(Fn&& fn) const
+      {
+        if (isEmpty())
+        {
+          return;
+        }
+
+        std::array<std::size_t, maxRank> index{};
+        const std::size_t runs = getSize() / mExtents[0];
+        pointer           ptr  = mData;
+
+        for (std::size_t run{}; run < runs; ++run)
+        {
+          fn(ptr, mExtents[0], mStrides[0]);
+
+          for (std::size_t r{1}; r < mRank; ++r)
+          {
+            ptr += mStrides[r];
+
+            if (++index[r] < mExtents[r])
+            {
+              break;
+            }
+
+            ptr      -= mStrides[r] * mExtents[r];
+            index[r]  = 0;
+          }
+        }
+      }
+
+      /**
+       * @brief Gets a strided multidimensional view of the slice. Trailing dimensions beyond the rank must be 1.
+       * @tparam Rank The rank of the view
+       * @return The view
+       */
+      template<std::size_t Rank>
+      [[nodiscard]] MdSpan<T, DExtents<Rank>, LayoutStride> toMdspan() const
+      {
+        std::array<std::size_t, Rank> exts{};
+        std::array<std::size_t, Rank> strides{};
+
+        for (std::size_t r{}; r < Rank; ++r)
+        {
+          exts[r]    = (r < mRank) ? mExtents[r] : 1;
+          strides[r] = (r < mRank) ? mStrides[r] : 0;
+        }
+
+        for (std::size_t r{Rank}; r < mRank; ++r)
+        {
+          if (mExtents[r] != 1)
+          {
+            throw Exception{"matlabw:mx:ArraySlice:toMdspan", "slice rank exceeds the view rank"};
+          }
+        }
+
+        return MdSpan<T, DExtents<Rank>, LayoutStride>{mData, DExtents<Rank>{exts}, strides};
+      }
+
+      /**
+       * @brief Copies the slice into a new numeric array.
+       * @return The new array
+       */
+      [[nodiscard]] NumericArray<value_type> materialize() const requires isNumeric<value_type>
+      {
+        auto array = makeUninitNumericArray<value_type>(getDims());
+
+        value_type* dst = array.getData();
+
+        forEachRun([&dst](pointer src, std::size_t count, std::size_t stride)
+        {
+          if (stride == 1)
+          {
+            std::memcpy(dst, src, count * sizeof(value_type));
+          }
+          else
+          {
+            for (std::size_t i{}; i < count; ++i)
+            {
+              dst[i] = src[i * stride];
+            }
+          }
+
+          dst += count;
+        });
+
+        return array;
+      }
+    private:
+      /**
+       * @brief Constructor from array data.
+       * @param data Pointer to the array data
+       * @param dims Array dimensions
+       * @param ranges Ranges per dimension
+       */
+      ArraySlice(pointer data, View<std::size_t> dims, View<Range> ranges)
+      : mData{data}, mRank{std::max(dims.size(), ranges.size())}
+      {
+        if (mRank > maxRank)
+        {
+          throw Exception{"matlabw:mx:ArraySlice", "array rank exceeds the maximum slice rank"};
+        }
+
+        std::size_t stride{1};
+
+        for (std::size_t r{}; r < mRank; ++r)
+        {
+          mExtents[r]  = (r < dims.size()) ? dims[r] : 1;
+          mStrides[r]  = stride;
+          stride      *= mExtents[r];
+        }
+
+        applyRanges(ranges);
+      }
+
+      /**
+       * @brief Restricts the slice to the ranges.
+       * @param ranges Ranges per dimension
+       */
+      void applyRanges(View<Range> ranges)
+      {
+        if (ranges.size() > mRank)
+        {
+          throw Exception{"matlabw:mx:ArraySlice", "too many ranges"};
+        }
+
+        for (std::size_t r{}; r < ranges.size(); ++r)
+        {
+          const Range&      range = ranges[r];
+          const std::size_t end   = std::min(range.end, mExtents[r]);
+
+          // A single index must exist, clamping it would silently select nothing.
+          const bool missingIndex = (range.end == range.begin + 1) && range.begin >= mExtents[r];
+
+          if (range.step == 0 || range.begin > end || missingIndex)
+          {
+            throw Exception{"matlabw:mx:ArraySlice", "invalid range"};
+          }
+
+          if (range.begin < end)
+          {
+            mData += range.begin * mStrides[r];
+          }
+
+          // Rounds up without forming end - begin + step - 1, which wraps for large steps.
+          mExtents[r] = (end > range.begin) ? (end - range.begin - 1) / range.step + 1 : 0;
+
+          // A step past the extent selects at most one element, its stride is never applied and must not wrap.
+          mStrides[r] = (mExtents[r] > 1) ? checkedMultiply(mStrides[r], range.step) : mStrides[r];
+        }
+      }
+
+      pointer                          mData{};    ///< Pointer to the first element
+      std::size_t                      mRank{};    ///< Rank
+      std::array<std::size_t, maxRank> mExtents{}; ///< Extents
+      std::array<std::size_t, maxRank> mStrides{}; ///< Strides in elements
+  };
+
+  /**
+   * @brief Creates a mutable slice of an array.
+   * @tparam T Element type
+   * @param array The array
+   * @param ranges Ranges per dimension, missing trailing ranges select the whole dimension
+   * @return The slice
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<T> makeSlice(TypedArrayRef<T> array, View<Range> ranges)
+  {
+    return ArraySlice<T>{array, ranges};
+  }
+
+  /**
+   * @brief Creates a read-only slice of an array.
+   * @tparam T Element type
+   * @param array The array
+   * @param ranges Ranges per dimension, missing trailing ranges select the whole dimension
+   * @return The slice
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<const T> makeSlice(TypedArrayCref<T> array, View<Range> ranges)
+  {
+    return ArraySlice<const T>{array, ranges};
+  }
+
+  /**
+   * @brief Creates a mutable slice of a page (index into the third dimension) of an array.
+   * @tparam T Element type
+   * @param array The array
+   * @param page Zero based page index
+   * @return The slice
+   * @throws Exception if the page does not exist
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<T> makePageSlice(TypedArrayRef<T> array, std::size_t page)
+  {
+    const Range ranges[]{Range::all(), Range::all(), Range::single(page)};
+
+    return ArraySlice<T>{array, ranges};
+  }
+
+  /**
+   * @brief Creates a read-only slice of a page (index into the third dimension) of an array.
+   * @tparam T Element type
+   * @param array The array
+   * @param page Zero based page index
+   * @return The slice
+   * @throws Exception if the page does not exist
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<const T> makePageSlice(TypedArrayCref<T> array, std::size_t page)
+  {
+    const Range ranges[]{Range::all(), Range::all(), Range::single(page)};
+
+    return ArraySlice<const T>{array, ranges};
+  }
+
+namespace detail
+{
+  /// @brief Component type of a complex element type, const-qualified for const elements.
+  template<typename T>
+  using ComplexComponent = std::conditional_t<std::is_const_v<T>, const typename std::remove_const_t<T>::value_type,
+                                              typename std::remove_const_t<T>::value_type>;
+
+  /**
+   * @brief Creates a slice of one component of complex elements. Interleaved complex values are layout compatible
+   *        with pairs of reals, the component slice has the same extents and twice the strides.
+   * @tparam T Complex element type
+   * @param slice The complex slice
+   * @param component 0 for the real part, 1 for the imaginary part
+   * @return The component slice
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<ComplexComponent<T>> makeComponentSlice(const ArraySlice<T>& slice, std::size_t component)
+  {
+    using R = ComplexComponent<T>;
+
+    if (slice.getRank() == 0)
+    {
+      return ArraySlice<R>{};
+    }
+
+    std::array<std::size_t, ArraySlice<T>::maxRank> strides{};
+
+    for (std::size_t r{}; r < slice.getRank(); ++r)
+    {
+      strides[r] = checkedMultiply(slice.getStrides()[r], 2);
+    }
+
+    return ArraySlice<R>{reinterpret_cast<R*>(slice.getData()) + component, slice.getDims(),
+                         View<std::size_t>{strides.data(), slice.getRank()}};
+  }
+} // namespace detail
+
+  /**
+   * @brief Creates a strided slice of the real parts of complex elements without copying. A vector slice can be
+   *        passed to BLAS-style routines as getData() with increment getStrides()[0], i.e. 2 for a whole array.
+   * @tparam T Complex element type, const-qualified for read-only slices
+   * @param slice The complex slice
+   * @return The slice of the real parts
+   */
+  template<typename T>
+    requires isComplexNumeric<T>
+  [[nodiscard]] ArraySlice<detail::ComplexComponent<T>> makeRealSlice(const ArraySlice<T>& slice)
+  {
+    return detail::makeComponentSlice(slice, 0);
+  }
+
+  /**
+   * @brief Creates a strided slice of the imaginary parts of complex elements without copying.
+   * @tparam T Complex element type, const-qualified for read-only slices
+   * @param slice The complex slice
+   * @return The slice of the imaginary parts
+   */
+  template<typename T>
+    requires isComplexNumeric<T>
+  [[nodiscard]] ArraySlice<detail::ComplexComponent<T>> makeImagSlice(const ArraySlice<T>& slice)
+  {
+    return detail::makeComponentSlice(slice, 1);
+  }
+
+  /**
+   * @brief Creates a mutable strided slice of the real parts of a complex array.
+   * @tparam T Real type
+   * @param array The array
+   * @return The slice of the real parts
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<T> makeRealSlice(TypedArrayRef<std::complex<T>> array)
+  {
+    return makeRealSlice(ArraySlice<std::complex<T>>{array});
+  }
+
+  /**
+   * @brief Creates a read-only strided slice of the real parts of a complex array.
+   * @tparam T Real type
+   * @param array The array
+   * @return The slice of the real parts
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<const T> makeRealSlice(TypedArrayCref<std::complex<T>> array)
+  {
+    return makeRealSlice(ArraySlice<const std::complex<T>>{array});
+  }
+
+  /**
+   * @brief Creates a mutable strided slice of the imaginary parts of a complex array.
+   * @tparam T Real type
+   * @param array The array
+   * @return The slice of the imaginary parts
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<T> makeImagSlice(TypedArrayRef<std::complex<T>> array)
+  {
+    return makeImagSlice(ArraySlice<std::complex<T>>{array});
+  }
+
+  /**
+   * @brief Creates a read-only strided slice of the imaginary parts of a complex array.
+   * @tparam T Real type
+   * @param array The array
+   * @return The slice of the imaginary parts
+   */
+  template<typename T>
+  [[nodiscard]] ArraySlice<const T> makeImagSlice(TypedArrayCref<std::complex<T>> array)
+  {
+    return makeImagSlice(ArraySlice<const std::complex<T>>{array});
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_ARRAY_SLICE_HPP */
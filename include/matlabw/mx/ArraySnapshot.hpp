@@ -0,0 +1,327 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ARRAY_SNAPSHOT_HPP
+#define MATLABW_MX_ARRAY_SNAPSHOT_HPP
+
+#include "detail/include.hpp"
+
+#include "Array.hpp"
+#include "ArrayRef.hpp"
+#include "common.hpp"
+#include "Exception.hpp"
+#include "TypedArrayRef.hpp"
+#include "typeTraits.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Snapshot of the array properties captured once. Accessing the snapshot does not call into libmx, so it can
+   *        be used in inner loops at raw pointer speed. The snapshot is invalidated by any operation that changes the
+   *        array (resize, destruction, ...).
+   * @tparam V Pointee type of the data, const void for read-only snapshots
+   */
+  template<typename V>
+  struct BasicArraySnapshot
+  {
+    static_assert(std::is_void_v<V>, "V must be void or const void");
+
+    const mxArray*     array{};       ///< The mxArray pointer
+    ClassId            classId{};     ///< Class ID
+    Complexity         complexity{};  ///< Complexity
+    std::size_t        rank{};        ///< Rank
+    const std::size_t* dims{};        ///< Dimensions
+    std::size_t        size{};        ///< Number of elements
+    std::size_t        elementSize{}; ///< Size of the element in bytes
+    V*                 data{};        ///< Pointer to the data
+
+    /**
+     * @brief Get the dimensions of the array
+     * @return View of the dimensions
+     */
+    [[nodiscard]] View<std::size_t> getDims() const noexcept
+    {
+      return View<std::size_t>{dims, rank};
+    }
+
+    /**
+     * @brief Get the number of rows
+     * @return Number of rows
+     */
+    [[nodiscard]] std::size_t getDimM() const noexcept
+    {
+      return dims[0];
+    }
+
+    /**
+     * @brief Get the number of columns, all trailing dimensions are folded into the columns.
+     * @return Number of columns
+     */
+    [[nodiscard]] std::size_t getDimN() const noexcept
+    {
+      return (dims[0] != 0) ? size / dims[0] : 0;
+    }
+
+    /**
+     * @brief Is the array empty?
+     * @return True if the array is empty, false otherwise
+     */
+    [[nodiscard]] bool isEmpty() const noexcept
+    {
+      return size == 0;
+    }
+
+    /**
+     * @brief Is the array a scalar?
+     * @return True if the array is a scalar, false otherwise
+     */
+    [[nodiscard]] bool isScalar() const noexcept
+    {
+      return size == 1;
+    }
+
+    /**
+     * @brief Is the array element class complex?
+     * @return True if the array element class is complex, false otherwise
+     */
+    [[nodiscard]] bool isComplex() const noexcept
+    {
+      return complexity == Complexity::complex;
+    }
+
+    /**
+     * @brief Get the array data as a specific type, the type is checked against the captured class ID and complexity.
+     * @tparam T Type, may be const-qualified
+     * @return Pointer to the array data, const for read-only snapshots
+     */
+    template<typename T>
+    [[nodiscard]] std::conditional_t<std::is_const_v<V>, const T, T>* getDataAs() const
+    {
+      using Props = TypeProperties<std::remove_const_t<T>>;
+
+      if (classId != Props::classId || complexity != Props::complexity)
+      {
+        throw Exception{"matlabw:mx:ArraySnapshot:getDataAs", "type must match the array class ID and complexity"};
+      }
+
+      return static_cast<std::conditional_t<std::is_const_v<V>, const T, T>*>(data);
+    }
+  };
+
+  /// @brief Snapshot of a mutable array.
+  using ArraySnapshot = BasicArraySnapshot<void>;
+
+  /// @brief Read-only snapshot of an array, e.g. of a right-hand side argument.
+  using ConstArraySnapshot = BasicArraySnapshot<const void>;
+
+  static_assert(std::is_trivially_copyable_v<ArraySnapshot>);
+  static_assert(std::is_trivially_copyable_v<ConstArraySnapshot>);
+
+  /**
+   * @brief Snapshot of a typed array. Provides unchecked element access and iteration over raw pointers.
+   * @tparam T Element type, const-qualified for read-only snapshots
+   */
+  template<typename T>
+  struct TypedArraySnapshot
+  {
+    using value_type = std::remove_const_t<T>; ///< Value type
+    using reference  = T&;                     ///< Reference type
+    using pointer    = T*;                     ///< Pointer type
+    using iterator   = pointer;                ///< Iterator type
+
+    const mxArray*     array{}; ///< The mxArray pointer
+    std::size_t        rank{};  ///< Rank
+    const std::size_t* dims{};  ///< Dimensions
+    std::size_t        size{};  ///< Number of elements
+    pointer            data{};  ///< Pointer to the data
+
+    /**
+     * @brief Get the dimensions of the array
+     * @return View of the dimensions
+     */
+    [[nodiscard]] View<std::size_t> getDims() const noexcept
+    {
+      return View<std::size_t>{dims, rank};
+    }
+
+    /**
+     * @brief Accesses an element without bounds checking.
+     * @param i Index
+     * @return Reference to the element
+     */
+    [[nodiscard]] reference operator[](std::size_t i) const noexcept
+    {
+      return data[i];
+    }
+
+    /**
+     * @brief Gets an iterator to the first element.
+     * @return Iterator
+     */
+    [[nodiscard]] iterator begin() const noexcept
+    {
+      return data;
+    }
+
+    /**
+     * @brief Gets an iterator past the last element.
+     * @return Iterator
+     */
+    [[nodiscard]] iterator end() const noexcept
+    {
+      return data + size;
+    }
+
+    /**
+     * @brief Converts to a span over the data.
+     * @return Span
+     */
+    [[nodiscard]] operator Span<T>() const noexcept
+    {
+      return Span<T>{data, size};
+    }
+  };
+
+namespace detail
+{
+  /**
+   * @brief Captures the snapshot of an array.
+   * @tparam V Pointee type of the data, const void for read-only snapshots
+   * @param array mxArray pointer, must not be null
+   * @return Snapshot
+   */
+  template<typename V = const void>
+  [[nodiscard]] BasicArraySnapshot<V> makeSnapshot(const mxArray* array) noexcept
+  {
+    BasicArraySnapshot<V> snapshot{};
+
+    snapshot.array       = array;
+    snapshot.classId     = static_cast<ClassId>(mxGetClassID(array));
+    snapshot.complexity  = mxIsComplex(array) ? Complexity::complex : Complexity::real;
+    snapshot.rank        = mxGetNumberOfDimensions(array);
+    snapshot.dims        = mxGetDimensions(array);
+    snapshot.size        = mxGetNumberOfElements(array);
+    snapshot.elementSize = mxGetElementSize(array);
+    snapshot.data        = static_cast<V*>(mxGetData(array));
+
+    return snapshot;
+  }
+
+  /**
+   * @brief Captures the snapshot of a typed array.
+   * @tparam T Element type, const-qualified for read-only snapshots
+   * @param array mxArray pointer, must not be null
+   * @return Snapshot
+   */
+  template<typename T>
+  [[nodiscard]] TypedArraySnapshot<T> makeTypedSnapshot(const mxArray* array) noexcept
+  {
+    TypedArraySnapshot<T> snapshot{};
+
+    snapshot.array = array;
+    snapshot.rank  = mxGetNumberOfDimensions(array);
+    snapshot.dims  = mxGetDimensions(array);
+    snapshot.size  = mxGetNumberOfElements(array);
+    snapshot.data  = static_cast<T*>(mxGetData(array));
+
+    return snapshot;
+  }
+} // namespace detail
+
+  /**
+   * @brief Captures the snapshot of an array.
+   * @param array The array
+   * @return Mutable snapshot
+   */
+  [[nodiscard]] inline ArraySnapshot makeSnapshot(Array& array)
+  {
+    if (!array.isValid())
+    {
+      throw Exception{"matlabw:mx:makeSnapshot", "accessing invalid array"};
+    }
+
+    return detail::makeSnapshot<void>(array.get());
+  }
+
+  /**
+   * @brief Captures the snapshot of an array.
+   * @param array The array
+   * @return Read-only snapshot
+   */
+  [[nodiscard]] inline ConstArraySnapshot makeSnapshot(const Array& array)
+  {
+    if (!array.isValid())
+    {
+      throw Exception{"matlabw:mx:makeSnapshot", "accessing invalid array"};
+    }
+
+    return detail::makeSnapshot<const void>(array.get());
+  }
+
+  /**
+   * @brief Captures the snapshot of an array.
+   * @param array Reference to the array
+   * @return Mutable snapshot
+   */
+  [[nodiscard]] inline ArraySnapshot makeSnapshot(ArrayRef array) noexcept
+  {
+    return detail::makeSnapshot<void>(array.get());
+  }
+
+  /**
+   * @brief Captures the snapshot of an array.
+   * @param array Const reference to the array
+   * @return Read-only snapshot
+   */
+  [[nodiscard]] inline ConstArraySnapshot makeSnapshot(ArrayCref array) noexcept
+  {
+    return detail::makeSnapshot<const void>(array.get());
+  }
+
+  /**
+   * @brief Captures the snapshot of a typed array.
+   * @tparam T Element type
+   * @param array Reference to the array
+   * @return Mutable snapshot
+   */
+  template<typename T>
+  [[nodiscard]] TypedArraySnapshot<T> makeSnapshot(TypedArrayRef<T> array) noexcept
+  {
+    return detail::makeTypedSnapshot<T>(array.get());
+  }
+
+  /**
+   * @brief Captures the snapshot of a typed array.
+   * @tparam T Element type
+   * @param array Const reference to the array
+   * @return Read-only snapshot
+   */
+  template<typename T>
+  [[nodiscard]] TypedArraySnapshot<const T> makeSnapshot(TypedArrayCref<T> array) noexcept
+  {
+    return detail::makeTypedSnapshot<const T>(array.get());
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_ARRAY_SNAPSHOT_HPP */
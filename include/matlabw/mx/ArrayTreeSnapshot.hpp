@@ -0,0 +1,509 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ARRAY_TREE_SNAPSHOT_HPP
+#define MATLABW_MX_ARRAY_TREE_SNAPSHOT_HPP
+
+#include "detail/include.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArrayRef.hpp"
+#include "ArraySnapshot.hpp"
+#include "common.hpp"
+#include "Exception.hpp"
+#include "typeTraits.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Node of an ArrayTreeSnapshot. The children of a cell are its elements, the children of a struct are the
+   *        fields of the first element followed by those of the next ones.
+   */
+  struct ArrayTreeSnapshotNode
+  {
+    ConstArraySnapshot snapshot{};   ///< Snapshot of the array, the array is null for unset elements and fields.
+    const mwIndex*     ir{};         ///< Row indices of a sparse array, null otherwise.
+    const mwIndex*     jc{};         ///< Column starts of a sparse array, null otherwise.
+    std::size_t        firstChild{}; ///< Index of the first child node.
+    std::size_t        childCount{}; ///< Number of child nodes.
+    std::size_t        firstField{}; ///< Index of the first field name of a struct.
+    std::size_t        fieldCount{}; ///< Number of fields of a struct.
+  };
+
+  static_assert(std::is_trivially_copyable_v<ArrayTreeSnapshotNode>);
+
+  /**
+   * @brief Read-only handle of a node of an ArrayTreeSnapshot. Copyable and valid as long as the snapshot, all of its
+   *        operations only read the snapshot and can be called from any thread.
+   */
+  class ArrayTreeNode
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param nodes The nodes of the snapshot.
+       * @param fieldNames The field names of the snapshot.
+       * @param index The index of the node.
+       */
+      ArrayTreeNode(const ArrayTreeSnapshotNode* nodes, const std::string* fieldNames, std::size_t index) noexcept
+      : mNodes{nodes}, mFieldNames{fieldNames}, mIndex{index}
+      {}
+
+      /**
+       * @brief Is the node an array? Unset elements of cells and fields of structs are not.
+       * @return True if the node is an array, false otherwise.
+       */
+      [[nodiscard]] bool isValid() const noexcept
+      {
+        return getNode().snapshot.array != nullptr;
+      }
+
+      /**
+       * @brief Gets the snapshot of the array.
+       * @return The snapshot.
+       */
+      [[nodiscard]] const ConstArraySnapshot& getSnapshot() const noexcept
+      {
+        return getNode().snapshot;
+      }
+
+      /**
+       * @brief Gets the class ID.
+       * @return The class ID, unknown for unset elements.
+       */
+      [[nodiscard]] ClassId getClassId() const noexcept
+      {
+        return isValid() ? getNode().snapshot.classId : ClassId::unknown;
+      }
+
+      /**
+       * @brief Gets the dimensions.
+       * @return The dimensions, empty for unset elements.
+       */
+      [[nodiscard]] View<std::size_t> getDims() const noexcept
+      {
+        return isValid() ? getNode().snapshot.getDims() : View<std::size_t>{};
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return getNode().snapshot.size;
+      }
+
+      /**
+       * @brief Is the array a cell array?
+       * @return True if the array is a cell array, false otherwise.
+       */
+      [[nodiscard]] bool isCell() const noexcept
+      {
+        return getClassId() == ClassId::cell;
+      }
+
+      /**
+       * @brief Is the array a struct array?
+       * @return True if the array is a struct array, false otherwise.
+       */
+      [[nodiscard]] bool isStruct() const noexcept
+      {
+        return getClassId() == ClassId::_struct;
+      }
+
+      /**
+       * @brief Is the array sparse?
+       * @return True if the array is sparse, false otherwise.
+       */
+      [[nodiscard]] bool isSparse() const noexcept
+      {
+        return getNode().jc != nullptr;
+      }
+
+      /**
+       * @brief Gets the row indices of a sparse array.
+       * @return The row indices, one per nonzero.
+       */
+      [[nodiscard]] View<mwIndex> getIr() const
+      {
+        const ArrayTreeSnapshotNode& node = getSparseNode();
+
+        return View<mwIndex>{node.ir, node.jc[node.snapshot.getDimN()]};
+      }
+
+      /**
+       * @brief Gets the column starts of a sparse array.
+       * @return The column starts, one per column and one past the last column.
+       */
+      [[nodiscard]] View<mwIndex> getJc() const
+      {
+        const ArrayTreeSnapshotNode& node = getSparseNode();
+
+        return View<mwIndex>{node.jc, node.snapshot.getDimN() + 1};
+      }
+
+      /**
+       * @brief Gets the data of a dense numeric, logical or char array, the type is checked.
+       * @tparam T Element type.
+       * @return Read-only snapshot of the data.
+       */
+      template<typename T>
+      [[nodiscard]] TypedArraySnapshot<const T> getAs() const
+      {
+        const ConstArraySnapshot& snapshot = getSnapshot();
+
+        if (!isValid() || isSparse() || !isCompatible<T>())
+        {
+          throw Exception{"matlabw:mx:ArrayTreeNode:getAs", "type must match the array class ID and complexity"};
+        }
+
+        return TypedArraySnapshot<const T>{snapshot.array,
+                                           snapshot.rank,
+                                           snapshot.dims,
+                                           snapshot.size,
+                                           static_cast<const T*>(snapshot.data)};
+      }
+
+      /**
+       * @brief Checks if the elements are of a type.
+       * @tparam T Element type.
+       * @return True if the class ID and the complexity match the type.
+       */
+      template<typename T>
+      [[nodiscard]] bool isCompatible() const noexcept
+      {
+        const ConstArraySnapshot& snapshot = getSnapshot();
+
+        return isValid() &&
+               snapshot.classId == TypeProperties<T>::classId &&
+               snapshot.complexity == TypeProperties<T>::complexity;
+      }
+
+      /**
+       * @brief Gets an element of a cell array.
+       * @param i The linear index of the element.
+       * @return The node of the element.
+       */
+      [[nodiscard]] ArrayTreeNode getCell(std::size_t i) const
+      {
+        if (!isCell() || i >= getNode().childCount)
+        {
+          throw Exception{"matlabw:mx:ArrayTreeNode:getCell", "node is not a cell array or index out of range"};
+        }
+
+        return ArrayTreeNode{mNodes, mFieldNames, getNode().firstChild + i};
+      }
+
+      /**
+       * @brief Gets the number of fields of a struct array.
+       * @return The number of fields, 0 for other arrays.
+       */
+      [[nodiscard]] std::size_t getFieldCount() const noexcept
+      {
+        return getNode().fieldCount;
+      }
+
+      /**
+       * @brief Gets the name of a field of a struct array.
+       * @param k The index of the field.
+       * @return The name.
+       */
+      [[nodiscard]] std::string_view getFieldName(std::size_t k) const
+      {
+        const ArrayTreeSnapshotNode& node = getNode();
+
+        if (k >= node.fieldCount)
+        {
+          throw Exception{"matlabw:mx:ArrayTreeNode:getFieldName", "index out of range"};
+        }
+
+        return mFieldNames[node.firstField + k];
+      }
+
+      /**
+       * @brief Gets the index of a field of a struct array.
+       * @param fieldName The name of the field.
+       * @return The index of the field, FieldIndex::invalid if the array has no such field.
+       */
+      [[nodiscard]] FieldIndex getFieldIndex(std::string_view fieldName) const noexcept
+      {
+        const ArrayTreeSnapshotNode& node = getNode();
+
+        for (std::size_t k{}; k < node.fieldCount; ++k)
+        {
+          if (mFieldNames[node.firstField + k] == fieldName)
+          {
+            return static_cast<FieldIndex>(k);
+          }
+        }
+
+        return FieldIndex::invalid;
+      }
+
+      /**
+       * @brief Gets a field of an element of a struct array.
+       * @param i The linear index of the element.
+       * @param fieldIndex The index of the field.
+       * @return The node of the field.
+       */
+      [[nodiscard]] ArrayTreeNode getField(std::size_t i, FieldIndex fieldIndex) const
+      {
+        const ArrayTreeSnapshotNode& node = getNode();
+        const auto                   k    = static_cast<std::size_t>(fieldIndex);
+
+        if (!isStruct() || i >= node.snapshot.size || k >= node.fieldCount)
+        {
+          throw Exception{"matlabw:mx:ArrayTreeNode:getField", "node is not a struct array or index out of range"};
+        }
+
+        return ArrayTreeNode{mNodes, mFieldNames, node.firstChild + i * node.fieldCount + k};
+      }
+
+      /**
+       * @brief Gets a field of an element of a struct array.
+       * @param i The linear index of the element.
+       * @param fieldName The name of the field.
+       * @return The node of the field.
+       */
+      [[nodiscard]] ArrayTreeNode getField(std::size_t i, std::string_view fieldName) const
+      {
+        const FieldIndex fieldIndex = getFieldIndex(fieldName);
+
+        if (fieldIndex == FieldIndex::invalid)
+        {
+          throw Exception{"matlabw:mx:ArrayTreeNode:getField", "no field '" + std::string{fieldName} + "'"};
+        }
+
+        return getField(i, fieldIndex);
+      }
+
+      /**
+       * @brief Gets a field of the first element of a struct array.
+       * @param fieldName The name of the field.
+       * @return The node of the field.
+       */
+      [[nodiscard]] ArrayTreeNode getField(std::string_view fieldName) const
+      {
+        return getField(0, fieldName);
+      }
+    private:
+      /**
+       * @brief Gets the node.
+       * @return The node.
+       */
+      [[nodiscard]] const ArrayTreeSnapshotNode& getNode() const noexcept
+      {
+        return mNodes[mIndex];
+      }
+
+      /**
+       * @brief Gets the node of a sparse array.
+       * @return The node.
+       */
+      [[nodiscard]] const ArrayTreeSnapshotNode& getSparseNode() const
+      {
+        if (!isSparse())
+        {
+          throw Exception{"matlabw:mx:ArrayTreeNode", "node is not a sparse array"};
+        }
+
+        return getNode();
+      }
+
+      const ArrayTreeSnapshotNode* mNodes{};      ///< The nodes of the snapshot.
+      const std::string*           mFieldNames{}; ///< The field names of the snapshot.
+      std::size_t                  mIndex{};      ///< The index of the node.
+  };
+
+  /**
+   * @brief Snapshot of whole argument trees, nested cells and structs included, captured on the MATLAB thread into
+   *        plain C++ structures. The snapshot references the data of the arrays without copying them and never calls
+   *        into libmx after construction, so worker threads can traverse it and read the data concurrently. The
+   *        arrays must not be modified or destroyed while the snapshot is used, which holds for the inputs of a MEX
+   *        function during the call.
+   */
+  class ArrayTreeSnapshot
+  {
+    public:
+      /**
+       * @brief Constructor, must be called on the MATLAB thread.
+       * @param array The root array.
+       */
+      explicit ArrayTreeSnapshot(ArrayCref array)
+      : ArrayTreeSnapshot{View<ArrayCref>{&array, 1}}
+      {}
+
+      /**
+       * @brief Constructor, must be called on the MATLAB thread.
+       * @param arrays The root arrays, e.g. the right-hand side arguments of a MEX function.
+       */
+      explicit ArrayTreeSnapshot(View<ArrayCref> arrays)
+      : mRootCount{arrays.size()}
+      {
+        mNodes.reserve(arrays.size());
+
+        for (const ArrayCref array : arrays)
+        {
+          mNodes.push_back(makeNode(array.get()));
+        }
+
+        // Breadth-first, the node vector is the queue, so the children of a node are contiguous.
+        for (std::size_t k{}; k < mNodes.size(); ++k)
+        {
+          const mxArray* array = mNodes[k].snapshot.array;
+
+          if (array == nullptr)
+          {
+            continue;
+          }
+
+          if (mxIsCell(array))
+          {
+            const std::size_t size = mNodes[k].snapshot.size;
+
+            mNodes[k].firstChild = mNodes.size();
+            mNodes[k].childCount = size;
+
+            for (std::size_t i{}; i < size; ++i)
+            {
+              mNodes.push_back(makeNode(mxGetCell(array, i)));
+            }
+          }
+          else if (mxIsStruct(array))
+          {
+            const std::size_t size       = mNodes[k].snapshot.size;
+            const auto        fieldCount = static_cast<std::size_t>(mxGetNumberOfFields(array));
+
+            mNodes[k].firstField = mFieldNames.size();
+            mNodes[k].fieldCount = fieldCount;
+
+            for (std::size_t f{}; f < fieldCount; ++f)
+            {
+              mFieldNames.emplace_back(mxGetFieldNameByNumber(array, static_cast<int>(f)));
+            }
+
+            mNodes[k].firstChild = mNodes.size();
+            mNodes[k].childCount = size * fieldCount;
+
+            for (std::size_t i{}; i < size; ++i)
+            {
+              for (std::size_t f{}; f < fieldCount; ++f)
+              {
+                mNodes.push_back(makeNode(mxGetFieldByNumber(array, i, static_cast<int>(f))));
+              }
+            }
+          }
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor, nodes reference the snapshot.
+      ArrayTreeSnapshot(const ArrayTreeSnapshot&) = delete;
+
+      /// @brief Explicitly deleted move constructor, nodes reference the snapshot.
+      ArrayTreeSnapshot(ArrayTreeSnapshot&&) = delete;
+
+      /// @brief Default destructor.
+      ~ArrayTreeSnapshot() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ArrayTreeSnapshot& operator=(const ArrayTreeSnapshot&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ArrayTreeSnapshot& operator=(ArrayTreeSnapshot&&) = delete;
+
+      /**
+       * @brief Gets the number of root arrays.
+       * @return The number of root arrays.
+       */
+      [[nodiscard]] std::size_t getRootCount() const noexcept
+      {
+        return mRootCount;
+      }
+
+      /**
+       * @brief Gets a root array.
+       * @param i The index of the root array.
+       * @return The node of the root array.
+       */
+      [[nodiscard]] ArrayTreeNode getRoot(std::size_t i = 0) const
+      {
+        if (i >= mRootCount)
+        {
+          throw Exception{"matlabw:mx:ArrayTreeSnapshot:getRoot", "index out of range"};
+        }
+
+        return ArrayTreeNode{mNodes.data(), mFieldNames.data(), i};
+      }
+
+      /**
+       * @brief Gets the number of nodes of all trees.
+       * @return The number of nodes.
+       */
+      [[nodiscard]] std::size_t getNodeCount() const noexcept
+      {
+        return mNodes.size();
+      }
+
+      /**
+       * @brief Gets the nodes in breadth-first order, the roots first.
+       * @return The nodes.
+       */
+      [[nodiscard]] View<ArrayTreeSnapshotNode> getNodes() const noexcept
+      {
+        return mNodes;
+      }
+    private:
+      /**
+       * @brief Captures a node without its children.
+       * @param array The array, null for unset elements.
+       * @return The node.
+       */
+      [[nodiscard]] static ArrayTreeSnapshotNode makeNode(const mxArray* array) noexcept
+      {
+        ArrayTreeSnapshotNode node{};
+
+        if (array != nullptr)
+        {
+          node.snapshot = detail::makeSnapshot(array);
+
+          if (mxIsSparse(array))
+          {
+            node.ir = mxGetIr(array);
+            node.jc = mxGetJc(array);
+          }
+        }
+
+        return node;
+      }
+
+      std::size_t                        mRootCount{};  ///< Number of root arrays, the first nodes.
+      std::vector<ArrayTreeSnapshotNode> mNodes{};      ///< The nodes in breadth-first order.
+      std::vector<std::string>           mFieldNames{}; ///< Field names of the structs.
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_ARRAY_TREE_SNAPSHOT_HPP */
@@ -27,6 +27,8 @@
 
 #include "detail/include.hpp"
 
+#include <optional>
+
 #include "CellArrayRef.hpp"
 #include "TypedArray.hpp"
 
@@ -42,6 +44,8 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline CellArray makeCellArray(View<std::size_t> dims)
   {
+    static_cast<void>(checkDims("matlabw:mx:makeCellArray", dims));
+
     mxArray* array = mxCreateCellArray(dims.size(), dims.data());
 
     if (array == nullptr)
@@ -62,6 +66,50 @@ namespace matlabw::mx
   {
     return makeCellArray({{m, n}});
   }
+
+  /**
+   * @brief Detaches a cell without copying it, the cell becomes empty. Together with setCell and
+   *        StructArray::setField(..., Array&&) this moves subtrees between cell and structure arrays in O(1).
+   * @param cells The cell array
+   * @param i The index of the cell
+   * @return The cell, empty if the cell is empty
+   */
+  [[nodiscard]] inline std::optional<Array> takeCell(CellArrayRef cells, std::size_t i)
+  {
+    if (i >= cells.getSize())
+    {
+      throw Exception{"matlabw:mx:takeCell", "cell index out of range"};
+    }
+
+    mxArray* cell = mxGetCell(cells.get(), i);
+
+    if (cell == nullptr)
+    {
+      return std::nullopt;
+    }
+
+    mxSetCell(cells.get(), i, nullptr);
+
+    return Array{std::move(cell)};
+  }
+
+  /**
+   * @brief Attaches an array to a cell without copying it, the previous cell is destroyed.
+   * @param cells The cell array
+   * @param i The index of the cell
+   * @param value The value, owned by the cell array afterwards
+   */
+  inline void setCell(CellArrayRef cells, std::size_t i, Array&& value)
+  {
+    if (i >= cells.getSize())
+    {
+      throw Exception{"matlabw:mx:setCell", "cell index out of range"};
+    }
+
+    // MATLAB does not free the previous cell when a cell is set.
+    mxDestroyArray(mxGetCell(cells.get(), i));
+    mxSetCell(cells.get(), i, value.release());
+  }
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_CELL_ARRAY_HPP */
@@ -75,6 +75,15 @@ namespace matlabw::mx
         return mx::toAscii(TypedArrayCref<char16_t>{*this});
       }
 
+      /**
+       * @brief Convert to std::string (UTF-8)
+       * @return std::string
+       */
+      [[nodiscard]] std::string toUtf8() const
+      {
+        return mx::toUtf8(TypedArrayCref<char16_t>{*this});
+      }
+
       /**
        * @brief Convert to std::u16string_view
        * @return std::u16string_view
@@ -131,6 +140,8 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline CharArray makeCharArray(View<std::size_t> dims)
   {
+    static_cast<void>(checkDims("matlabw:mx:makeCharArray", dims));
+
     mxArray* array = mxCreateCharArray(dims.size(), dims.data());
 
     if (array == nullptr)
@@ -165,13 +176,63 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline CharArray makeCharArray(std::u16string_view str)
   {
-    CharArray array = makeCharArray({{str.size() + 1}});
+    CharArray array = makeCharArray({{1, str.size()}});
 
     std::copy(str.begin(), str.end(), array.begin());
 
     return array;
   }
 
+  /**
+   * @brief Make a CharArray from a UTF-8 encoded string. The UTF-16 length is counted exactly before decoding and runs
+   *        of ASCII characters are copied 16 at a time. Ill-formed bytes decode as U+FFFD.
+   * @param str The UTF-8 string.
+   * @return The 1-by-n CharArray.
+   */
+  [[nodiscard]] inline CharArray fromUtf8(std::string_view str)
+  {
+    CharArray array = makeCharArray({{1, detail::decodeUtf8(str.data(), str.size(), nullptr)}});
+
+    detail::decodeUtf8(str.data(), str.size(), array.getData());
+
+    return array;
+  }
+
+  /**
+   * @brief Make a char matrix from UTF-8 encoded rows, shorter rows are padded with spaces like MATLAB's char().
+   * @param rows The UTF-8 strings, one per row.
+   * @return The CharArray.
+   */
+  [[nodiscard]] inline CharArray fromUtf8Rows(View<std::string_view> rows)
+  {
+    const std::size_t m = rows.size();
+
+    std::vector<std::u16string> decoded(m);
+    std::size_t                 n{};
+
+    for (std::size_t i{}; i < m; ++i)
+    {
+      decoded[i].resize(detail::decodeUtf8(rows[i].data(), rows[i].size(), nullptr));
+      detail::decodeUtf8(rows[i].data(), rows[i].size(), decoded[i].data());
+
+      n = std::max(n, decoded[i].size());
+    }
+
+    CharArray array = makeCharArray({{m, n}});
+
+    char16_t* data = array.getData();
+
+    for (std::size_t i{}; i < m; ++i)
+    {
+      for (std::size_t j{}; j < n; ++j)
+      {
+        data[i + j * m] = (j < decoded[i].size()) ? decoded[i][j] : u' ';
+      }
+    }
+
+    return array;
+  }
+
   /**
    * @brief Construct from a std::string_view
    * @param str The string view
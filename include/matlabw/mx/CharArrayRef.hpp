@@ -27,16 +27,103 @@
 
 #include "detail/include.hpp"
 
+#include "detail/utf8.hpp"
 #include "TypedArrayRef.hpp"
 
 namespace matlabw::mx
+{
+namespace detail
 {
   /**
-   * @brief Convert a char16_t array to a std::string
-   * @param array TypedArrayCref<char16_t>
+   * @brief Checks that a char array is a single string, a row or column vector or empty.
+   * @param id The error identifier.
+   * @param array The char array.
+   */
+  inline void checkCharVector(const char* id, TypedArrayCref<char16_t> array)
+  {
+    if (array.getSize() != 0 && (array.getRank() > 2 || (array.getDimM() != 1 && array.getDimN() != 1)))
+    {
+      throw Exception{id, "array must be a single string"};
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Convert a char16_t array to a std::string, each character is narrowed to its low byte.
+   * @param array TypedArrayCref<char16_t>, a single string
    * @return std::string
    */
-  [[nodiscard]] std::string toAscii(TypedArrayCref<char16_t> array);
+  [[nodiscard]] inline std::string toAscii(TypedArrayCref<char16_t> array)
+  {
+    detail::checkCharVector("matlabw:mx:toAscii", array);
+
+    std::string str(array.getSize(), '\0');
+
+    std::transform(array.begin(), array.end(), str.begin(), [](char16_t c) { return static_cast<char>(c); });
+
+    return str;
+  }
+
+  /**
+   * @brief Convert a char16_t array to a UTF-8 encoded std::string. The output is sized exactly before encoding and
+   *        runs of ASCII characters are copied 16 at a time. Unpaired surrogates encode as U+FFFD.
+   * @param array TypedArrayCref<char16_t>, a single string
+   * @return std::string
+   */
+  [[nodiscard]] inline std::string toUtf8(TypedArrayCref<char16_t> array)
+  {
+    detail::checkCharVector("matlabw:mx:toUtf8", array);
+
+    std::string str(detail::getUtf8Length(array.getData(), array.getSize()), '\0');
+
+    detail::encodeUtf8(array.getData(), array.getSize(), str.data());
+
+    return str;
+  }
+
+  /**
+   * @brief Convert each row of a char matrix to a UTF-8 encoded std::string, trailing padding is kept.
+   * @param array TypedArrayCref<char16_t>, a 2-D char array
+   * @return std::vector<std::string>, one string per row
+   */
+  [[nodiscard]] inline std::vector<std::string> toUtf8Rows(TypedArrayCref<char16_t> array)
+  {
+    if (array.getRank() > 2)
+    {
+      throw Exception{"matlabw:mx:toUtf8Rows", "array must be 2-D"};
+    }
+
+    const std::size_t m = array.getDimM();
+    const std::size_t n = array.getDimN();
+
+    std::vector<std::string> rows(m);
+    std::u16string           row(n, u'\0');
+
+    for (std::size_t i{}; i < m; ++i)
+    {
+      for (std::size_t j{}; j < n; ++j)
+      {
+        row[j] = array.getData()[i + j * m];
+      }
+
+      rows[i].resize(detail::getUtf8Length(row.data(), n));
+      detail::encodeUtf8(row.data(), n, rows[i].data());
+    }
+
+    return rows;
+  }
+
+  /**
+   * @brief Get a zero-copy std::u16string_view of a char array, valid as long as the array.
+   * @param array TypedArrayCref<char16_t>, a single string
+   * @return std::u16string_view
+   */
+  [[nodiscard]] inline std::u16string_view toU16StringView(TypedArrayCref<char16_t> array)
+  {
+    detail::checkCharVector("matlabw:mx:toU16StringView", array);
+
+    return std::u16string_view{array.getData(), array.getSize()};
+  }
 
   /**
    * @brief Convert a char array to a std::string
@@ -53,6 +140,21 @@ namespace matlabw::mx
     return toAscii(TypedArrayCref<char16_t>{array});
   }
 
+  /**
+   * @brief Convert a char array to a UTF-8 encoded std::string
+   * @param array ArrayCref
+   * @return std::string
+   */
+  [[nodiscard]] inline std::string toUtf8(ArrayCref array)
+  {
+    if (array.getClassId() != ClassId::_char)
+    {
+      throw Exception{"matlabw:mx:toUtf8", "array must be a char array"};
+    }
+
+    return toUtf8(TypedArrayCref<char16_t>{array});
+  }
+
   /// @brief CharArrayRef class
   class CharArrayRef : public TypedArrayRef<char16_t>
   {
@@ -83,6 +185,15 @@ namespace matlabw::mx
       {
         return mx::toAscii(*this);
       }
+
+      /**
+       * @brief Convert to std::string (UTF-8)
+       * @return std::string
+       */
+      [[nodiscard]] std::string toUtf8() const
+      {
+        return mx::toUtf8(TypedArrayCref<char16_t>{*this});
+      }
       
       /**
        * @brief Convert to std::u16string_view
@@ -131,6 +242,15 @@ namespace matlabw::mx
       {
         return mx::toAscii(*this);
       }
+
+      /**
+       * @brief Convert to std::string (UTF-8)
+       * @return std::string
+       */
+      [[nodiscard]] std::string toUtf8() const
+      {
+        return mx::toUtf8(TypedArrayCref<char16_t>{*this});
+      }
       
       /**
        * @brief Convert to std::u16string_view
@@ -156,23 +276,7 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline std::string toAscii(CharArrayCref array)
   {
-    static constexpr char id[]{"matlabw:mx:toAscii"};
-
-    if (array.isSingleString())
-    {
-      throw Exception{id, "Input must be a single string.\n"};
-    }
-
-    const std::size_t size = std::char_traits<char16_t>::length(array.getData());
-
-    std::string str(size, '\0');
-
-    if (mxGetString(array.get(), str.data(), size + 1))
-    {
-      throw Exception{id, "Failed to convert char16_t array to string.\n"};
-    }
-
-    return str;
+    return toAscii(TypedArrayCref<char16_t>{array});
   }
 } // namespace matlabw::mx
 
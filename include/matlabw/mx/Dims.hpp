@@ -0,0 +1,433 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_DIMS_HPP
+#define MATLABW_MX_DIMS_HPP
+
+#include "detail/include.hpp"
+
+#include <limits>
+#include <ranges>
+
+#include "common.hpp"
+#include "Exception.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief Maximum number of elements of an array, MATLAB limits arrays to 2^48 - 1 elements on 64-bit platforms.
+  inline constexpr std::size_t maxNumel{static_cast<std::size_t>((std::uint64_t{1} << 48) - 1)};
+
+  /**
+   * @brief Multiplies sizes, throwing on overflow. The check folds away when the operands are constants, in a
+   *        constant expression an overflow fails to compile.
+   * @param a The first size.
+   * @param b The second size.
+   * @return The product.
+   * @throws Exception if the product overflows std::size_t.
+   */
+  [[nodiscard]] constexpr std::size_t checkedMultiply(std::size_t a, std::size_t b)
+  {
+    std::size_t result{};
+
+#if defined(__GNUC__)
+    const bool overflow = __builtin_mul_overflow(a, b, &result);
+#else
+    const bool overflow = (b != 0 && a > std::numeric_limits<std::size_t>::max() / b);
+
+    result = a * b;
+#endif
+
+    if (overflow)
+    {
+      throw Exception{"matlabw:mx:checkedMultiply", "size overflows std::size_t"};
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Adds sizes, throwing on overflow.
+   * @param a The first size.
+   * @param b The second size.
+   * @return The sum.
+   * @throws Exception if the sum overflows std::size_t.
+   */
+  [[nodiscard]] constexpr std::size_t checkedAdd(std::size_t a, std::size_t b)
+  {
+    if (a > std::numeric_limits<std::size_t>::max() - b)
+    {
+      throw Exception{"matlabw:mx:checkedAdd", "size overflows std::size_t"};
+    }
+
+    return a + b;
+  }
+
+  /**
+   * @brief Checks that dimensions describe an array MATLAB can create and gets its number of elements. Called by the
+   *        creation, resize and slicing functions, so the element count of an existing array never wraps and
+   *        products of its dimensions can be computed unchecked.
+   * @param id The error identifier.
+   * @param dims The dimensions.
+   * @return The number of elements.
+   * @throws Exception if the number of elements overflows or exceeds maxNumel.
+   */
+  [[nodiscard]] constexpr std::size_t checkDims(const char* id, View<std::size_t> dims)
+  {
+    std::size_t numel{1};
+    bool        empty{};
+    bool        overflow{};
+
+    for (const std::size_t dim : dims)
+    {
+      // A zero dimension makes the array empty whatever the other dimensions are, MATLAB still limits each of them.
+      overflow |= (dim > maxNumel);
+      empty    |= (dim == 0);
+
+      if (!overflow && !empty)
+      {
+        overflow |= (numel > maxNumel / dim);
+        numel    *= dim;
+      }
+    }
+
+    if (overflow)
+    {
+      throw Exception{id, "array exceeds the maximum number of elements"};
+    }
+
+    return empty ? 0 : numel;
+  }
+
+  /**
+   * @brief Gets the range of indices [0, n) as std::size_t, so loops over array elements never narrow to 32 bits,
+   *        e.g. for (const std::size_t i : indexRange(array.getSize())).
+   * @param n The number of indices.
+   * @return The range.
+   */
+  [[nodiscard]] constexpr auto indexRange(std::size_t n) noexcept
+  {
+    return std::views::iota(std::size_t{}, n);
+  }
+
+  /**
+   * @brief Gets the range of indices [first, last) as std::size_t.
+   * @param first The first index.
+   * @param last One past the last index.
+   * @return The range, empty if last is not greater than first.
+   */
+  [[nodiscard]] constexpr auto indexRange(std::size_t first, std::size_t last) noexcept
+  {
+    return std::views::iota(first, std::max(first, last));
+  }
+
+  /**
+   * @brief Array dimensions with inline storage, a value type replacing View<std::size_t> over caller-owned storage.
+   *        The rank is at least 2, missing dimensions of rank 0 or 1 inputs are 1. Dims is a contiguous range, so it
+   *        converts to View<std::size_t> and can be passed to every function taking dimensions, e.g.
+   *        makeNumericArray<double>(Dims{3, 4}) or array.resize(dims). Copying the result of mxGetDimensions into
+   *        Dims keeps the dimensions valid after the array is resized or destroyed. The constructors and setDim()
+   *        check the dimensions with checkDims(), so getProduct() and getStride() cannot wrap unless the dimensions
+   *        are written through operator[].
+   */
+  class Dims
+  {
+    public:
+      using value_type     = std::size_t;        ///< Value type
+      using iterator       = std::size_t*;       ///< Iterator type
+      using const_iterator = const std::size_t*; ///< Const iterator type
+
+      /// @brief Maximum number of dimensions.
+      static constexpr std::size_t maxRank{8};
+
+      /// @brief Default constructor. Creates 0-by-0 dimensions.
+      constexpr Dims() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param dims The dimensions.
+       * @throws Exception if there are more than maxRank dimensions or they exceed maxNumel elements.
+       */
+      constexpr Dims(std::initializer_list<std::size_t> dims)
+      : Dims{View<std::size_t>{dims.begin(), dims.size()}}
+      {}
+
+      /**
+       * @brief Constructor. Copies the dimensions, e.g. those returned by mxGetDimensions.
+       * @param dims The dimensions.
+       * @throws Exception if there are more than maxRank dimensions or they exceed maxNumel elements.
+       */
+      constexpr explicit Dims(View<std::size_t> dims)
+      {
+        if (dims.size() > maxRank)
+        {
+          throw Exception{"matlabw:mx:Dims", "too many dimensions"};
+        }
+
+        static_cast<void>(checkDims("matlabw:mx:Dims", dims));
+
+        mRank = std::max(dims.size(), std::size_t{2});
+
+        for (std::size_t k{}; k < mRank; ++k)
+        {
+          mDims[k] = (k < dims.size()) ? dims[k] : 1;
+        }
+      }
+
+      /**
+       * @brief Gets the number of dimensions.
+       * @return The rank.
+       */
+      [[nodiscard]] constexpr std::size_t getRank() const noexcept
+      {
+        return mRank;
+      }
+
+      /**
+       * @brief Gets the number of dimensions, range interface.
+       * @return The rank.
+       */
+      [[nodiscard]] constexpr std::size_t size() const noexcept
+      {
+        return mRank;
+      }
+
+      /**
+       * @brief Gets a pointer to the dimensions.
+       * @return The pointer.
+       */
+      [[nodiscard]] constexpr std::size_t* data() noexcept
+      {
+        return mDims.data();
+      }
+
+      /**
+       * @brief Gets a pointer to the dimensions.
+       * @return The pointer.
+       */
+      [[nodiscard]] constexpr const std::size_t* data() const noexcept
+      {
+        return mDims.data();
+      }
+
+      /**
+       * @brief Gets an iterator to the first dimension.
+       * @return The iterator.
+       */
+      [[nodiscard]] constexpr iterator begin() noexcept
+      {
+        return data();
+      }
+
+      /**
+       * @brief Gets an iterator to the first dimension.
+       * @return The iterator.
+       */
+      [[nodiscard]] constexpr const_iterator begin() const noexcept
+      {
+        return data();
+      }
+
+      /**
+       * @brief Gets an iterator past the last dimension.
+       * @return The iterator.
+       */
+      [[nodiscard]] constexpr iterator end() noexcept
+      {
+        return data() + mRank;
+      }
+
+      /**
+       * @brief Gets an iterator past the last dimension.
+       * @return The iterator.
+       */
+      [[nodiscard]] constexpr const_iterator end() const noexcept
+      {
+        return data() + mRank;
+      }
+
+      /**
+       * @brief Accesses a dimension without bounds checking.
+       * @param k The dimension index.
+       * @return The dimension.
+       */
+      [[nodiscard]] constexpr std::size_t& operator[](std::size_t k) noexcept
+      {
+        return mDims[k];
+      }
+
+      /**
+       * @brief Accesses a dimension without bounds checking.
+       * @param k The dimension index.
+       * @return The dimension.
+       */
+      [[nodiscard]] constexpr std::size_t operator[](std::size_t k) const noexcept
+      {
+        return mDims[k];
+      }
+
+      /**
+       * @brief Gets a dimension, dimensions beyond the rank are 1.
+       * @param k The dimension index.
+       * @return The dimension.
+       */
+      [[nodiscard]] constexpr std::size_t getDim(std::size_t k) const noexcept
+      {
+        return (k < mRank) ? mDims[k] : 1;
+      }
+
+      /**
+       * @brief Gets the number of rows.
+       * @return The number of rows.
+       */
+      [[nodiscard]] constexpr std::size_t getDimM() const noexcept
+      {
+        return mDims[0];
+      }
+
+      /**
+       * @brief Gets the number of columns, all trailing dimensions are folded into the columns.
+       * @return The number of columns.
+       */
+      [[nodiscard]] constexpr std::size_t getDimN() const noexcept
+      {
+        std::size_t n{1};
+
+        for (std::size_t k{1}; k < mRank; ++k)
+        {
+          n *= mDims[k];
+        }
+
+        return n;
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The product of the dimensions.
+       */
+      [[nodiscard]] constexpr std::size_t getProduct() const noexcept
+      {
+        return mDims[0] * getDimN();
+      }
+
+      /**
+       * @brief Gets the stride of a dimension in elements, the product of the preceding dimensions.
+       * @param k The dimension index, at most the rank.
+       * @return The stride.
+       */
+      [[nodiscard]] constexpr std::size_t getStride(std::size_t k) const noexcept
+      {
+        std::size_t stride{1};
+
+        for (std::size_t r{}; r < k && r < mRank; ++r)
+        {
+          stride *= mDims[r];
+        }
+
+        return stride;
+      }
+
+      /**
+       * @brief Sets a dimension, the rank grows if the index is beyond it and the new dimensions are 1.
+       * @param k The dimension index.
+       * @param dim The dimension.
+       * @throws Exception if the index is not less than maxRank or the dimensions would exceed maxNumel elements.
+       */
+      constexpr void setDim(std::size_t k, std::size_t dim)
+      {
+        if (k >= maxRank)
+        {
+          throw Exception{"matlabw:mx:Dims:setDim", "too many dimensions"};
+        }
+
+        Dims dims{*this};
+
+        for (; dims.mRank <= k; ++dims.mRank)
+        {
+          dims.mDims[dims.mRank] = 1;
+        }
+
+        dims.mDims[k] = dim;
+
+        static_cast<void>(checkDims("matlabw:mx:Dims:setDim", dims));
+
+        *this = dims;
+      }
+
+      /**
+       * @brief Drops the trailing singleton dimensions beyond the second one, as MATLAB does.
+       * @return Reference to this.
+       */
+      constexpr Dims& normalize() noexcept
+      {
+        while (mRank > 2 && mDims[mRank - 1] == 1)
+        {
+          mDims[--mRank] = 0;
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Gets the dimensions without the trailing singleton dimensions beyond the second one.
+       * @return The normalized dimensions.
+       */
+      [[nodiscard]] constexpr Dims normalized() const noexcept
+      {
+        Dims dims{*this};
+
+        return dims.normalize();
+      }
+
+      /**
+       * @brief Compares the dimensions, trailing singleton dimensions are ignored.
+       * @param other The other dimensions.
+       * @return True if the dimensions describe the same shape.
+       */
+      [[nodiscard]] constexpr bool operator==(const Dims& other) const noexcept
+      {
+        const std::size_t rank = std::max(mRank, other.mRank);
+
+        for (std::size_t k{}; k < rank; ++k)
+        {
+          if (getDim(k) != other.getDim(k))
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+    private:
+      std::array<std::size_t, maxRank> mDims{}; ///< The dimensions, unused entries are 0
+      std::size_t                      mRank{2}; ///< The number of dimensions
+  };
+
+  static_assert(std::ranges::contiguous_range<Dims> && std::ranges::sized_range<Dims>);
+  static_assert(std::is_convertible_v<const Dims&, View<std::size_t>>);
+  static_assert(Dims{2, 3, 4, 1}.normalized().getRank() == 3 && Dims{2, 3, 4}.getProduct() == 24);
+  static_assert(Dims{2, 3, 4}.getStride(2) == 6 && checkDims("", Dims{maxNumel, 1, 0}) == 0);
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_DIMS_HPP */
@@ -27,6 +27,8 @@
 
 #include "detail/include.hpp"
 
+#include <cstdio>
+
 #include "memory.hpp"
 
 namespace matlabw::mx
@@ -67,7 +69,7 @@ namespace matlabw::mx
        * @brief Check if error has an ID
        * @return True if error has an ID
        */
-      [[nodiscard]] bool hasId() const noexcept
+      [[nodiscard]] virtual bool hasId() const noexcept
       {
         return !mId.empty();
       }
@@ -76,7 +78,7 @@ namespace matlabw::mx
        * @brief Get error ID
        * @return Error ID
        */
-      [[nodiscard]] const char* id() const noexcept
+      [[nodiscard]] virtual const char* id() const noexcept
       {
         return mId.c_str();
       }
@@ -85,6 +87,85 @@ namespace matlabw::mx
       std::string mId{};      ///< Error ID
       std::string mMessage{}; ///< Error message
   };
+
+  /**
+   * @brief Exception class which stores the ID and the message inline, so constructing it never allocates. Meant for
+   *        errors thrown on hot paths such as argument validation. Longer IDs and messages are truncated.
+   */
+  class StaticException final : public Exception
+  {
+    public:
+      /// @brief Capacity of the error ID including the terminating null character.
+      static constexpr std::size_t idCapacity{128};
+
+      /// @brief Capacity of the error message including the terminating null character.
+      static constexpr std::size_t messageCapacity{1024};
+
+      /**
+       * @brief Constructor
+       * @tparam Args Types of the format arguments, arithmetic types or pointers
+       * @param id Error ID
+       * @param format Error message, printf-style format if any arguments are given
+       * @param args Format arguments
+       */
+      template<typename... Args>
+        requires ((std::is_arithmetic_v<Args> || std::is_pointer_v<Args>) && ...)
+      StaticException(std::string_view id, const char* format, Args... args) noexcept
+      {
+        const std::size_t idSize = std::min(id.size(), idCapacity - 1);
+
+        std::char_traits<char>::copy(mId, id.data(), idSize);
+        mId[idSize] = '\0';
+
+        if constexpr (sizeof...(Args) == 0)
+        {
+          const std::size_t messageSize = std::min(std::char_traits<char>::length(format), messageCapacity - 1);
+
+          std::char_traits<char>::copy(mMessage, format, messageSize);
+          mMessage[messageSize] = '\0';
+        }
+        else
+        {
+          std::snprintf(mMessage, messageCapacity, format, args...);
+        }
+
+        if (mMessage[0] == '\0')
+        {
+          std::char_traits<char>::copy(mMessage, "Unknown error", sizeof("Unknown error"));
+        }
+      }
+
+      /**
+       * @brief Get error message
+       * @return Error message
+       */
+      [[nodiscard]] const char* what() const noexcept override
+      {
+        return mMessage;
+      }
+
+      /**
+       * @brief Check if error has an ID
+       * @return True if error has an ID
+       */
+      [[nodiscard]] bool hasId() const noexcept override
+      {
+        return mId[0] != '\0';
+      }
+
+      /**
+       * @brief Get error ID
+       * @return Error ID
+       */
+      [[nodiscard]] const char* id() const noexcept override
+      {
+        return mId;
+      }
+
+    private:
+      char mId[idCapacity]{};           ///< Error ID
+      char mMessage[messageCapacity]{}; ///< Error message
+  };
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_EXCEPTION_HPP */
@@ -0,0 +1,432 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_FIELD_SCHEMA_HPP
+#define MATLABW_MX_FIELD_SCHEMA_HPP
+
+#include "detail/include.hpp"
+
+#include <cstring>
+#include <iterator>
+
+#include "ArrayRef.hpp"
+#include "common.hpp"
+#include "Exception.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief List of field names resolved to field indices once per struct layout. Field access through the schema
+   *        avoids the name lookup of mxGetFieldNumber. A struct array with the same layout (the same fields in the same
+   *        order) reuses the resolved indices, a different layout is resolved again on bind().
+   */
+  class FieldSchema
+  {
+    public:
+      class Record;
+      class RecordIterator;
+      class RecordRange;
+
+      /**
+       * @brief Constructor.
+       * @param fieldNames The field names.
+       */
+      explicit FieldSchema(std::vector<std::string> fieldNames)
+      : mFieldNames{std::move(fieldNames)}
+      {
+        for (std::size_t k{}; k < mFieldNames.size(); ++k)
+        {
+          if (mFieldNames[k].empty())
+          {
+            throw Exception{"matlabw:mx:FieldSchema", "field names must not be empty"};
+          }
+
+          for (std::size_t j{}; j < k; ++j)
+          {
+            if (mFieldNames[j] == mFieldNames[k])
+            {
+              throw Exception{"matlabw:mx:FieldSchema", "duplicate field name '" + mFieldNames[k] + "'"};
+            }
+          }
+        }
+      }
+
+      /**
+       * @brief Constructor.
+       * @param fieldNames The field names.
+       */
+      FieldSchema(std::initializer_list<std::string_view> fieldNames)
+      : FieldSchema{std::vector<std::string>(fieldNames.begin(), fieldNames.end())}
+      {}
+
+      /**
+       * @brief Gets the number of fields of the schema.
+       * @return The number of fields.
+       */
+      [[nodiscard]] std::size_t getFieldCount() const noexcept
+      {
+        return mFieldNames.size();
+      }
+
+      /**
+       * @brief Gets the name of a field of the schema.
+       * @param k The position of the field in the schema.
+       * @return The field name.
+       */
+      [[nodiscard]] const std::string& getFieldName(std::size_t k) const
+      {
+        return mFieldNames.at(k);
+      }
+
+      /**
+       * @brief Gets the resolved index of a field of the schema.
+       * @param k The position of the field in the schema.
+       * @return The field index, FieldIndex::invalid if the schema is not resolved.
+       */
+      [[nodiscard]] FieldIndex getFieldIndex(std::size_t k) const
+      {
+        if (k >= mFieldNames.size())
+        {
+          throw Exception{"matlabw:mx:FieldSchema:getFieldIndex", "field position out of range"};
+        }
+
+        return (mFieldIndices.empty()) ? FieldIndex::invalid : mFieldIndices[k];
+      }
+
+      /**
+       * @brief Checks if the schema is resolved.
+       * @return True if the field indices are resolved.
+       */
+      [[nodiscard]] bool isResolved() const noexcept
+      {
+        return !mFieldIndices.empty() || mFieldNames.empty();
+      }
+
+      /**
+       * @brief Resolves the field indices for the layout of a struct array.
+       * @param array The struct array.
+       * @throws Exception if the array is not a struct or a field is missing.
+       */
+      void resolve(ArrayCref array)
+      {
+        const mxArray* ptr = checkStruct(array);
+
+        std::vector<FieldIndex> indices(mFieldNames.size());
+
+        for (std::size_t k{}; k < mFieldNames.size(); ++k)
+        {
+          const int index = mxGetFieldNumber(ptr, mFieldNames[k].c_str());
+
+          if (index < 0)
+          {
+            throw Exception{"matlabw:mx:FieldSchema:missingField", "missing field '" + mFieldNames[k] + "'"};
+          }
+
+          indices[k] = static_cast<FieldIndex>(index);
+        }
+
+        mFieldIndices     = std::move(indices);
+        mLayoutFieldCount = static_cast<std::size_t>(mxGetNumberOfFields(ptr));
+      }
+
+      /**
+       * @brief Checks if a struct array has the layout the schema is resolved for, without name lookups.
+       * @param array The struct array.
+       * @return True if the resolved indices are valid for the array.
+       */
+      [[nodiscard]] bool matches(ArrayCref array) const
+      {
+        if (!isResolved() || !array.isStruct())
+        {
+          return false;
+        }
+
+        const mxArray* ptr = array.get();
+
+        if (static_cast<std::size_t>(mxGetNumberOfFields(ptr)) != mLayoutFieldCount)
+        {
+          return false;
+        }
+
+        for (std::size_t k{}; k < mFieldNames.size(); ++k)
+        {
+          const char* name = mxGetFieldNameByNumber(ptr, static_cast<int>(mFieldIndices[k]));
+
+          if (name == nullptr || std::strcmp(name, mFieldNames[k].c_str()) != 0)
+          {
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Prepares the schema for a struct array, resolving the field indices only if the layout differs.
+       * @param array The struct array.
+       */
+      void bind(ArrayCref array)
+      {
+        if (!matches(array))
+        {
+          resolve(array);
+        }
+      }
+
+      /**
+       * @brief Gets a field of an element. The schema must be bound to the array's layout.
+       * @param array The struct array.
+       * @param i The index of the element.
+       * @param k The position of the field in the schema.
+       * @return The field or std::nullopt if it is unset.
+       */
+      [[nodiscard]] std::optional<ArrayCref> getField(ArrayCref array, std::size_t i, std::size_t k) const
+      {
+        const mxArray* field = mxGetFieldByNumber(array.get(), i, static_cast<int>(getResolvedIndex(k)));
+
+        return (field != nullptr) ? std::optional<ArrayCref>{ArrayCref{field}} : std::nullopt;
+      }
+
+      /**
+       * @brief Gets a field of an element. The schema must be bound to the array's layout.
+       * @param array The struct array.
+       * @param i The index of the element.
+       * @param k The position of the field in the schema.
+       * @return The field or std::nullopt if it is unset.
+       */
+      [[nodiscard]] std::optional<ArrayRef> getField(ArrayRef array, std::size_t i, std::size_t k) const
+      {
+        mxArray* field = mxGetFieldByNumber(array.get(), i, static_cast<int>(getResolvedIndex(k)));
+
+        return (field != nullptr) ? std::optional<ArrayRef>{ArrayRef{field}} : std::nullopt;
+      }
+
+      /**
+       * @brief Binds the schema to a struct array and gets a range over its elements for range-based for loops.
+       * @param array The struct array.
+       * @return The range of records, each giving the schema's fields of one element.
+       */
+      [[nodiscard]] RecordRange records(ArrayCref array);
+    private:
+      /**
+       * @brief Checks that the array is a struct array.
+       * @param array The array.
+       * @return The mxArray pointer.
+       */
+      static const mxArray* checkStruct(ArrayCref array)
+      {
+        if (!array.isStruct())
+        {
+          throw Exception{"matlabw:mx:FieldSchema", "array must be a struct array"};
+        }
+
+        return array.get();
+      }
+
+      /**
+       * @brief Gets the resolved index of a field.
+       * @param k The position of the field in the schema.
+       * @return The field index.
+       */
+      [[nodiscard]] FieldIndex getResolvedIndex(std::size_t k) const
+      {
+        if (k >= mFieldIndices.size())
+        {
+          throw Exception{"matlabw:mx:FieldSchema:getField", "schema is not resolved or field position out of range"};
+        }
+
+        return mFieldIndices[k];
+      }
+
+      std::vector<std::string> mFieldNames{};       ///< Field names.
+      std::vector<FieldIndex>  mFieldIndices{};     ///< Resolved field indices, empty if not resolved.
+      std::size_t              mLayoutFieldCount{}; ///< Number of fields of the resolved layout.
+  };
+
+  /// @brief Fields of one struct element selected by a schema.
+  class FieldSchema::Record
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param schema The bound schema.
+       * @param array The struct array.
+       * @param index The index of the element.
+       */
+      Record(const FieldSchema& schema, ArrayCref array, std::size_t index) noexcept
+      : mSchema{&schema}, mArray{array.get()}, mIndex{index}
+      {}
+
+      /**
+       * @brief Gets the index of the element.
+       * @return The index of the element.
+       */
+      [[nodiscard]] std::size_t getIndex() const noexcept
+      {
+        return mIndex;
+      }
+
+      /**
+       * @brief Gets a field of the element.
+       * @param k The position of the field in the schema.
+       * @return The field or std::nullopt if it is unset.
+       */
+      [[nodiscard]] std::optional<ArrayCref> operator[](std::size_t k) const
+      {
+        return mSchema->getField(ArrayCref{mArray}, mIndex, k);
+      }
+
+      /**
+       * @brief Gets a field of the element.
+       * @param k The position of the field in the schema.
+       * @return The field.
+       * @throws Exception if the field is unset.
+       */
+      [[nodiscard]] ArrayCref at(std::size_t k) const
+      {
+        auto field = (*this)[k];
+
+        if (!field.has_value())
+        {
+          throw Exception{"matlabw:mx:FieldSchema:Record:at", "field '" + mSchema->getFieldName(k) + "' is unset"};
+        }
+
+        return *field;
+      }
+    private:
+      const FieldSchema* mSchema; ///< The schema.
+      const mxArray*     mArray;  ///< The struct array.
+      std::size_t        mIndex;  ///< The index of the element.
+  };
+
+  /// @brief Forward iterator over the records of a struct array.
+  class FieldSchema::RecordIterator
+  {
+    public:
+      using iterator_category = std::forward_iterator_tag; ///< Iterator category
+      using value_type        = Record;                    ///< Value type
+      using difference_type   = std::ptrdiff_t;            ///< Difference type
+
+      /// @brief Default constructor.
+      RecordIterator() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param schema The bound schema.
+       * @param array The struct array.
+       * @param index The index of the element.
+       */
+      RecordIterator(const FieldSchema& schema, const mxArray* array, std::size_t index) noexcept
+      : mSchema{&schema}, mArray{array}, mIndex{index}
+      {}
+
+      /**
+       * @brief Gets the record.
+       * @return The record.
+       */
+      [[nodiscard]] Record operator*() const noexcept
+      {
+        return Record{*mSchema, ArrayCref{mArray}, mIndex};
+      }
+
+      /// @brief Pre-increment.
+      RecordIterator& operator++() noexcept
+      {
+        ++mIndex;
+        return *this;
+      }
+
+      /// @brief Post-increment.
+      RecordIterator operator++(int) noexcept
+      {
+        RecordIterator copy{*this};
+        ++mIndex;
+        return copy;
+      }
+
+      /// @brief Equality comparison.
+      [[nodiscard]] bool operator==(const RecordIterator& other) const noexcept
+      {
+        return mIndex == other.mIndex;
+      }
+    private:
+      const FieldSchema* mSchema{}; ///< The schema.
+      const mxArray*     mArray{};  ///< The struct array.
+      std::size_t        mIndex{};  ///< The index of the element.
+  };
+
+  /// @brief Range of the records of a struct array.
+  class FieldSchema::RecordRange
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param schema The bound schema.
+       * @param array The struct array.
+       */
+      RecordRange(const FieldSchema& schema, ArrayCref array)
+      : mSchema{&schema}, mArray{array.get()}, mSize{array.getSize()}
+      {}
+
+      /**
+       * @brief Gets the iterator to the first record.
+       * @return The iterator.
+       */
+      [[nodiscard]] RecordIterator begin() const noexcept
+      {
+        return RecordIterator{*mSchema, mArray, 0};
+      }
+
+      /**
+       * @brief Gets the iterator past the last record.
+       * @return The iterator.
+       */
+      [[nodiscard]] RecordIterator end() const noexcept
+      {
+        return RecordIterator{*mSchema, mArray, mSize};
+      }
+
+      /**
+       * @brief Gets the number of records.
+       * @return The number of records.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mSize;
+      }
+    private:
+      const FieldSchema* mSchema; ///< The schema.
+      const mxArray*     mArray;  ///< The struct array.
+      std::size_t        mSize;   ///< The number of elements.
+  };
+
+  inline FieldSchema::RecordRange FieldSchema::records(ArrayCref array)
+  {
+    bind(array);
+
+    return RecordRange{*this, array};
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_FIELD_SCHEMA_HPP */
@@ -0,0 +1,771 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_FILE_BACKED_ARRAY_HPP
+#define MATLABW_MX_FILE_BACKED_ARRAY_HPP
+
+#include "detail/include.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+# define MATLABW_FILE_BACKED_ARRAY_POSIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#elif defined(_WIN32)
+# define MATLABW_FILE_BACKED_ARRAY_WIN32
+# ifndef NOMINMAX
+#   define NOMINMAX
+# endif
+# include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "CellArray.hpp"
+#include "CharArray.hpp"
+#include "MdSpan.hpp"
+#include "NumericArray.hpp"
+#include "serialize.hpp"
+#include "StructArray.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief Layout of the file of a FileBackedArray.
+  enum class FileLayout
+  {
+    raw,        ///< The data only, in column-major order.
+    serialized, ///< A serialized array stream, readable by loadSerialized().
+    mat,        ///< An uncompressed MAT-file level 5 with a single variable, readable by load in MATLAB.
+  };
+
+namespace detail
+{
+  /// @brief MAT-file level 5 data types written by FileBackedArray.
+  enum FileBackedMiType : std::uint32_t
+  {
+    fileBackedMiInt8   = 1,  ///< miINT8.
+    fileBackedMiInt32  = 5,  ///< miINT32.
+    fileBackedMiUint32 = 6,  ///< miUINT32.
+    fileBackedMiMatrix = 14, ///< miMATRIX.
+  };
+
+  /**
+   * @brief Gets the MAT-file level 5 data type of a class.
+   * @param classId The class ID of a real numeric or logical array.
+   * @return The data type.
+   */
+  [[nodiscard]] constexpr std::uint32_t getFileBackedMiType(ClassId classId) noexcept
+  {
+    switch (classId)
+    {
+    case ClassId::int8:    return 1;
+    case ClassId::logical:
+    case ClassId::uint8:   return 2;
+    case ClassId::int16:   return 3;
+    case ClassId::uint16:  return 4;
+    case ClassId::int32:   return 5;
+    case ClassId::uint32:  return 6;
+    case ClassId::single:  return 7;
+    case ClassId::_double: return 9;
+    case ClassId::int64:   return 12;
+    case ClassId::uint64:  return 13;
+    default:               return 0;
+    }
+  }
+
+  /**
+   * @brief Gets the memmapfile class name of a class.
+   * @param classId The class ID.
+   * @return The class name, logical data are mapped as uint8, null if the class can not be mapped.
+   */
+  [[nodiscard]] constexpr const char* getFileBackedClassName(ClassId classId) noexcept
+  {
+    switch (classId)
+    {
+    case ClassId::_double: return "double";
+    case ClassId::single:  return "single";
+    case ClassId::int8:    return "int8";
+    case ClassId::logical:
+    case ClassId::uint8:   return "uint8";
+    case ClassId::int16:   return "int16";
+    case ClassId::_char:
+    case ClassId::uint16:  return "uint16";
+    case ClassId::int32:   return "int32";
+    case ClassId::uint32:  return "uint32";
+    case ClassId::int64:   return "int64";
+    case ClassId::uint64:  return "uint64";
+    default:               return nullptr;
+    }
+  }
+
+  /**
+   * @brief Checks a MATLAB variable name.
+   * @param name The name.
+   * @return True if the name is a valid MATLAB identifier.
+   */
+  [[nodiscard]] inline bool isFileBackedVariableName(std::string_view name) noexcept
+  {
+    const auto isAlpha = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+    const auto isAlnum = [&](char c) { return isAlpha(c) || (c >= '0' && c <= '9') || c == '_'; };
+
+    return !name.empty() && name.size() <= 63 && isAlpha(name.front()) &&
+           std::all_of(name.begin(), name.end(), isAlnum);
+  }
+
+  /// @brief Builder of the header of a FileBackedArray file.
+  class FileBackedHeader
+  {
+    public:
+      /**
+       * @brief Appends a value.
+       * @tparam U The value type.
+       * @param value The value.
+       */
+      template<typename U>
+      void put(const U& value)
+      {
+        const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+
+        mBytes.insert(mBytes.end(), bytes, bytes + sizeof(U));
+      }
+
+      /**
+       * @brief Appends bytes.
+       * @param data The bytes.
+       * @param size The number of bytes.
+       */
+      void put(const void* data, std::size_t size)
+      {
+        const auto* bytes = static_cast<const std::byte*>(data);
+
+        mBytes.insert(mBytes.end(), bytes, bytes + size);
+      }
+
+      /**
+       * @brief Appends zero padding to an alignment.
+       * @param alignment The alignment.
+       */
+      void pad(std::size_t alignment)
+      {
+        mBytes.resize((mBytes.size() + alignment - 1) / alignment * alignment);
+      }
+
+      /**
+       * @brief Gets the header bytes.
+       * @return The bytes.
+       */
+      [[nodiscard]] const std::vector<std::byte>& getBytes() const noexcept
+      {
+        return mBytes;
+      }
+    private:
+      std::vector<std::byte> mBytes{}; ///< The header bytes.
+  };
+
+  /**
+   * @brief Builds the header of a serialized array stream of a dense array, the payload follows it.
+   * @param classId The class ID.
+   * @param complex True if the array is complex.
+   * @param dims The dimensions, the rank is at least 2.
+   * @param bytes The size of the payload in bytes.
+   * @return The header, a multiple of the payload alignment.
+   */
+  [[nodiscard]] inline FileBackedHeader makeSerializedFileHeader(ClassId            classId,
+                                                                 bool               complex,
+                                                                 View<std::size_t>  dims,
+                                                                 std::size_t        bytes)
+  {
+    FileBackedHeader header{};
+
+    header.put(serialMagic);
+    header.put(serialVersion);
+    header.put(serialByteOrderMark);
+    header.put(SerialNodeHeader{static_cast<std::uint8_t>(classId),
+                                static_cast<std::uint8_t>(complex ? serialComplex : 0),
+                                0,
+                                static_cast<std::uint32_t>(dims.size())});
+    header.put(dims.data(), dims.size() * sizeof(std::size_t));
+    header.put(static_cast<std::uint64_t>(bytes));
+    header.pad(serialPayloadAlignment);
+
+    return header;
+  }
+
+  /**
+   * @brief Builds the header of an uncompressed MAT-file level 5 with a single real variable, the data follow it.
+   * @param classId The class ID of a real numeric or logical array.
+   * @param dims The dimensions, the rank is at least 2.
+   * @param bytes The size of the data in bytes.
+   * @param name The name of the variable.
+   * @return The header, a multiple of 8 bytes.
+   */
+  [[nodiscard]] inline FileBackedHeader makeMatFileHeader(ClassId           classId,
+                                                          View<std::size_t> dims,
+                                                          std::size_t       bytes,
+                                                          std::string_view  name)
+  {
+    static constexpr char        id[]{"matlabw:mx:FileBackedArray:create"};
+    static constexpr std::size_t limit{std::numeric_limits<std::uint32_t>::max() - 4096};
+
+    if (bytes > limit)
+    {
+      throw Exception{id, "data of a MAT-file level 5 variable must be smaller than 4 GB, use another layout"};
+    }
+
+    for (const std::size_t dim : dims)
+    {
+      if (dim > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+      {
+        throw Exception{id, "dimensions of a MAT-file level 5 variable must fit int32"};
+      }
+    }
+
+    const auto pad8 = [](std::size_t size) { return (size + 7) & ~std::size_t{7}; };
+
+    const std::size_t dimsBytes   = dims.size() * sizeof(std::int32_t);
+    const std::size_t matrixBytes = 16 + 8 + pad8(dimsBytes) + 8 + pad8(name.size()) + 8 + pad8(bytes);
+
+    FileBackedHeader header{};
+
+    char text[116];
+    std::memset(text, ' ', sizeof(text));
+    std::memcpy(text, "MATLAB 5.0 MAT-file, written by matlabw", 39);
+
+    header.put(text, sizeof(text));
+    header.put(std::uint64_t{});
+    header.put(std::uint16_t{0x0100});
+    header.put(static_cast<std::uint16_t>(('M' << 8) | 'I'));
+
+    header.put(std::uint32_t{fileBackedMiMatrix});
+    header.put(static_cast<std::uint32_t>(matrixBytes));
+
+    header.put(std::uint32_t{fileBackedMiUint32});
+    header.put(std::uint32_t{8});
+    header.put(static_cast<std::uint32_t>(static_cast<std::uint32_t>(classId) |
+                                          ((classId == ClassId::logical) ? 0x0200 : 0)));
+    header.put(std::uint32_t{});
+
+    header.put(std::uint32_t{fileBackedMiInt32});
+    header.put(static_cast<std::uint32_t>(dimsBytes));
+
+    for (const std::size_t dim : dims)
+    {
+      header.put(static_cast<std::int32_t>(dim));
+    }
+
+    header.pad(8);
+
+    header.put(std::uint32_t{fileBackedMiInt8});
+    header.put(static_cast<std::uint32_t>(name.size()));
+    header.put(name.data(), name.size());
+    header.pad(8);
+
+    header.put(getFileBackedMiType(classId));
+    header.put(static_cast<std::uint32_t>(bytes));
+
+    return header;
+  }
+} // namespace detail
+
+  /**
+   * @brief Numeric, logical or char array backed by a memory-mapped file, for results that do not fit in memory.
+   *        Kernels write the data in place, the kernel pages them out to the file on demand. The file is kept when
+   *        the array is closed and is passed to MATLAB by its path, see makeDescriptor(), or loaded according to
+   *        its layout.
+   *
+   * The file is created sparse and is preallocated where supported, so that running out of disk space is reported
+   * on creation instead of by a SIGBUS on a write.
+   *
+   * @tparam T The element type.
+   */
+  template<typename T>
+  class FileBackedArray
+  {
+    static_assert(isNumeric<T> || std::is_same_v<T, bool> || std::is_same_v<T, char16_t>,
+                  "FileBackedArray supports only numeric, logical and char elements");
+
+    public:
+      /// @brief The value type.
+      using ValueType = T;
+
+      /**
+       * @brief Constructor, creates or truncates the file and maps it.
+       * @param path The path of the file.
+       * @param dims The dimensions, missing trailing dimensions are one.
+       * @param layout The layout of the file.
+       * @param variableName The name of the variable of the mat layout.
+       */
+      FileBackedArray(const char*       path,
+                      View<std::size_t> dims,
+                      FileLayout        layout       = FileLayout::raw,
+                      std::string_view  variableName = "x")
+      : mPath{path},
+        mDims(dims.begin(), dims.end()),
+        mLayout{layout}
+      {
+        static constexpr char id[]{"matlabw:mx:FileBackedArray:create"};
+
+        while (mDims.size() < 2)
+        {
+          mDims.push_back(1);
+        }
+
+        mSize = checkDims(id, mDims);
+
+        const std::size_t bytes = checkedMultiply(mSize, sizeof(T));
+
+        detail::FileBackedHeader header{};
+
+        switch (layout)
+        {
+        case FileLayout::raw:
+          break;
+        case FileLayout::serialized:
+          if (mDims.size() > 64)
+          {
+            throw Exception{id, "rank of a serialized array must not exceed 64"};
+          }
+
+          header = detail::makeSerializedFileHeader(TypeProperties<T>::classId,
+                                                    TypeProperties<T>::complexity == Complexity::complex,
+                                                    mDims,
+                                                    bytes);
+          break;
+        case FileLayout::mat:
+          if constexpr (TypeProperties<T>::complexity == Complexity::complex || std::is_same_v<T, char16_t>)
+          {
+            throw Exception{id, "mat layout supports only real numeric and logical arrays"};
+          }
+
+          if (!detail::isFileBackedVariableName(variableName))
+          {
+            throw Exception{id, "invalid variable name"};
+          }
+
+          header = detail::makeMatFileHeader(TypeProperties<T>::classId, mDims, bytes, variableName);
+          break;
+        default:
+          throw Exception{id, "invalid layout"};
+        }
+
+        mOffset = header.getBytes().size();
+
+        // serialized and MAT-file records are padded to 8 bytes
+        mFileSize = mOffset + ((layout == FileLayout::raw) ? bytes : ((bytes + 7) & ~std::size_t{7}));
+
+        open(id);
+
+        if (mOffset > 0)
+        {
+          std::memcpy(mBase, header.getBytes().data(), mOffset);
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      FileBackedArray(const FileBackedArray&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other array.
+       */
+      FileBackedArray(FileBackedArray&& other) noexcept
+      : mPath{std::move(other.mPath)},
+        mDims{std::move(other.mDims)},
+        mLayout{other.mLayout},
+        mSize{std::exchange(other.mSize, 0)},
+        mOffset{std::exchange(other.mOffset, 0)},
+        mFileSize{std::exchange(other.mFileSize, 0)},
+        mBase{std::exchange(other.mBase, nullptr)}
+#     if defined(MATLABW_FILE_BACKED_ARRAY_WIN32)
+        , mFile{std::exchange(other.mFile, INVALID_HANDLE_VALUE)},
+        mMapping{std::exchange(other.mMapping, nullptr)}
+#     endif
+      {}
+
+      /// @brief Destructor, unmaps the file and keeps it.
+      ~FileBackedArray()
+      {
+        unmap();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      FileBackedArray& operator=(const FileBackedArray&) = delete;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other array.
+       * @return Reference to this array.
+       */
+      FileBackedArray& operator=(FileBackedArray&& other) noexcept
+      {
+        if (this != &other)
+        {
+          unmap();
+          mPath     = std::move(other.mPath);
+          mDims     = std::move(other.mDims);
+          mLayout   = other.mLayout;
+          mSize     = std::exchange(other.mSize, 0);
+          mOffset   = std::exchange(other.mOffset, 0);
+          mFileSize = std::exchange(other.mFileSize, 0);
+          mBase     = std::exchange(other.mBase, nullptr);
+#       if defined(MATLABW_FILE_BACKED_ARRAY_WIN32)
+          mFile     = std::exchange(other.mFile, INVALID_HANDLE_VALUE);
+          mMapping  = std::exchange(other.mMapping, nullptr);
+#       endif
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Is the file mapped?
+       * @return True until the array is closed.
+       */
+      [[nodiscard]] bool isOpen() const noexcept
+      {
+        return mBase != nullptr || (mFileSize == 0 && !mPath.empty());
+      }
+
+      /**
+       * @brief Gets the data.
+       * @return The mapped data, null once the array is closed.
+       */
+      [[nodiscard]] T* getData() noexcept
+      {
+        return (mBase != nullptr) ? reinterpret_cast<T*>(mBase + mOffset) : nullptr;
+      }
+
+      /// @copydoc getData()
+      [[nodiscard]] const T* getData() const noexcept
+      {
+        return (mBase != nullptr) ? reinterpret_cast<const T*>(mBase + mOffset) : nullptr;
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Gets the dimensions.
+       * @return The dimensions.
+       */
+      [[nodiscard]] View<std::size_t> getDims() const noexcept
+      {
+        return mDims;
+      }
+
+      /**
+       * @brief Gets the number of dimensions.
+       * @return The rank.
+       */
+      [[nodiscard]] std::size_t getRank() const noexcept
+      {
+        return mDims.size();
+      }
+
+      /**
+       * @brief Gets the data as a span.
+       * @return The span, empty once the array is closed.
+       */
+      [[nodiscard]] Span<T> getSpan() noexcept
+      {
+        return {getData(), (mBase != nullptr) ? mSize : 0};
+      }
+
+      /// @copydoc getSpan()
+      [[nodiscard]] View<T> getSpan() const noexcept
+      {
+        return {getData(), (mBase != nullptr) ? mSize : 0};
+      }
+
+      /**
+       * @brief Accesses an element.
+       * @param i The linear index.
+       * @return Reference to the element.
+       */
+      [[nodiscard]] T& operator[](std::size_t i) noexcept
+      {
+        return getData()[i];
+      }
+
+      /// @copydoc operator[](std::size_t)
+      [[nodiscard]] const T& operator[](std::size_t i) const noexcept
+      {
+        return getData()[i];
+      }
+
+      /**
+       * @brief Creates a multidimensional view of the data.
+       * @tparam rank The rank of the view, trailing dimensions are folded into the last one.
+       * @return The view.
+       */
+      template<std::size_t rank = 2>
+      [[nodiscard]] MdSpan<T, DExtents<rank>> toMdspan()
+      {
+        return detail::makeMdspan<T, DExtents<rank>>(getData(), mDims);
+      }
+
+      /// @copydoc toMdspan()
+      template<std::size_t rank = 2>
+      [[nodiscard]] MdSpan<const T, DExtents<rank>> toMdspan() const
+      {
+        return detail::makeMdspan<const T, DExtents<rank>>(getData(), mDims);
+      }
+
+      /**
+       * @brief Gets the path of the file.
+       * @return The path.
+       */
+      [[nodiscard]] const std::string& getPath() const noexcept
+      {
+        return mPath;
+      }
+
+      /**
+       * @brief Gets the offset of the data in the file.
+       * @return The offset in bytes.
+       */
+      [[nodiscard]] std::size_t getOffset() const noexcept
+      {
+        return mOffset;
+      }
+
+      /**
+       * @brief Gets the layout of the file.
+       * @return The layout.
+       */
+      [[nodiscard]] FileLayout getLayout() const noexcept
+      {
+        return mLayout;
+      }
+
+      /// @brief Writes the modified pages to the file and waits for completion.
+      void flush()
+      {
+        static constexpr char id[]{"matlabw:mx:FileBackedArray:flush"};
+
+        if (mBase == nullptr)
+        {
+          return;
+        }
+
+#     if defined(MATLABW_FILE_BACKED_ARRAY_POSIX)
+        if (msync(mBase, mFileSize, MS_SYNC) != 0)
+        {
+          throw Exception{id, "failed to write the mapped file"};
+        }
+#     elif defined(MATLABW_FILE_BACKED_ARRAY_WIN32)
+        if (!FlushViewOfFile(mBase, 0) || !FlushFileBuffers(mFile))
+        {
+          throw Exception{id, "failed to write the mapped file"};
+        }
+#     endif
+      }
+
+      /// @brief Flushes and unmaps the file, the file is kept and the data are no longer accessible.
+      void close()
+      {
+        flush();
+        unmap();
+        mPath.clear();
+      }
+
+      /**
+       * @brief Creates a descriptor of the data for memmapfile in MATLAB, a struct with fields path, offset, class,
+       *        dims and format, so that m = memmapfile(d.path, 'Offset', d.offset, 'Format', d.format) maps the data
+       *        as m.Data.x. Logical data are described as uint8 and char data as uint16.
+       * @return The descriptor.
+       */
+      [[nodiscard]] StructArray makeDescriptor() const
+      {
+        if constexpr (TypeProperties<T>::complexity == Complexity::complex)
+        {
+          throw Exception{"matlabw:mx:FileBackedArray:makeDescriptor", "memmapfile does not support complex data"};
+        }
+        else
+        {
+          const char* className = detail::getFileBackedClassName(TypeProperties<T>::classId);
+
+          auto dims = makeUninitNumericArray<double>(1, mDims.size());
+          std::transform(mDims.begin(), mDims.end(), dims.getData(), [](std::size_t n)
+          {
+            return static_cast<double>(n);
+          });
+
+          CellArray format = makeCellArray(1, 3);
+          mxSetCell(format.get(), 0, makeCharArray(className).release());
+          mxSetCell(format.get(), 1, Array{dims}.release());
+          mxSetCell(format.get(), 2, makeCharArray("x").release());
+
+          static constexpr const char* fieldNames[]{"path", "offset", "class", "dims", "format"};
+
+          auto descriptor = makeStructArray(1, 1, fieldNames);
+          descriptor.setField("path", fromUtf8(mPath));
+          descriptor.setField("offset", makeNumericScalar<double>(static_cast<double>(mOffset)));
+          descriptor.setField("class", makeCharArray(className));
+          descriptor.setField("dims", std::move(dims));
+          descriptor.setField("format", std::move(format));
+
+          return descriptor;
+        }
+      }
+    private:
+      /**
+       * @brief Creates, sizes and maps the file.
+       * @param id The error identifier.
+       */
+      void open(const char* id)
+      {
+#     if defined(MATLABW_FILE_BACKED_ARRAY_POSIX)
+        const int fd = ::open(mPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if (fd < 0)
+        {
+          throw Exception{id, "failed to create the file"};
+        }
+
+        if (ftruncate(fd, static_cast<off_t>(mFileSize)) != 0)
+        {
+          ::close(fd);
+          throw Exception{id, "failed to resize the file"};
+        }
+
+#     if defined(__linux__)
+        // reserve the blocks, file systems without support keep the sparse file
+        if (mFileSize > 0 && fallocate(fd, 0, 0, static_cast<off_t>(mFileSize)) != 0 && errno == ENOSPC)
+        {
+          ::close(fd);
+          throw Exception{id, "not enough disk space for the file"};
+        }
+#     endif
+
+        if (mFileSize > 0)
+        {
+          void* base = mmap(nullptr, mFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+          if (base == MAP_FAILED)
+          {
+            ::close(fd);
+            throw Exception{id, "failed to map the file"};
+          }
+
+          mBase = static_cast<std::byte*>(base);
+        }
+
+        // the mapping keeps the file referenced
+        ::close(fd);
+#     elif defined(MATLABW_FILE_BACKED_ARRAY_WIN32)
+        mFile = CreateFileA(mPath.c_str(),
+                            GENERIC_READ | GENERIC_WRITE,
+                            0,
+                            nullptr,
+                            CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+
+        if (mFile == INVALID_HANDLE_VALUE)
+        {
+          throw Exception{id, "failed to create the file"};
+        }
+
+        if (mFileSize > 0)
+        {
+          // the mapping extends the file to its size
+          mMapping = CreateFileMappingA(mFile,
+                                        nullptr,
+                                        PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<std::uint64_t>(mFileSize) >> 32),
+                                        static_cast<DWORD>(mFileSize & 0xffffffff),
+                                        nullptr);
+
+          if (mMapping == nullptr)
+          {
+            unmap();
+            throw Exception{id, "failed to resize the file"};
+          }
+
+          mBase = static_cast<std::byte*>(MapViewOfFile(mMapping, FILE_MAP_ALL_ACCESS, 0, 0, mFileSize));
+
+          if (mBase == nullptr)
+          {
+            unmap();
+            throw Exception{id, "failed to map the file"};
+          }
+        }
+#     else
+        throw Exception{id, "memory-mapped files are not supported on this platform"};
+#     endif
+      }
+
+      /// @brief Unmaps the file.
+      void unmap() noexcept
+      {
+#     if defined(MATLABW_FILE_BACKED_ARRAY_POSIX)
+        if (mBase != nullptr)
+        {
+          munmap(mBase, mFileSize);
+        }
+#     elif defined(MATLABW_FILE_BACKED_ARRAY_WIN32)
+        if (mBase != nullptr)
+        {
+          UnmapViewOfFile(mBase);
+        }
+
+        if (mMapping != nullptr)
+        {
+          CloseHandle(std::exchange(mMapping, nullptr));
+        }
+
+        if (mFile != INVALID_HANDLE_VALUE)
+        {
+          CloseHandle(std::exchange(mFile, INVALID_HANDLE_VALUE));
+        }
+#     endif
+        mBase = nullptr;
+      }
+
+      std::string              mPath{};                  ///< The path of the file, empty once closed.
+      std::vector<std::size_t> mDims{};                  ///< The dimensions.
+      FileLayout               mLayout{FileLayout::raw}; ///< The layout of the file.
+      std::size_t              mSize{};                  ///< The number of elements.
+      std::size_t              mOffset{};                ///< The offset of the data in the file.
+      std::size_t              mFileSize{};              ///< The size of the file and the mapping.
+      std::byte*               mBase{};                  ///< The mapped file.
+#   if defined(MATLABW_FILE_BACKED_ARRAY_WIN32)
+      HANDLE                   mFile{INVALID_HANDLE_VALUE}; ///< The file.
+      HANDLE                   mMapping{};                  ///< The file mapping.
+#   endif
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_FILE_BACKED_ARRAY_HPP */
@@ -0,0 +1,487 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_LAZY_STRUCT_HPP
+#define MATLABW_MX_LAZY_STRUCT_HPP
+
+#include "detail/include.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CellArrayRef.hpp"
+#include "StructArrayRef.hpp"
+#include "StructBinding.hpp"
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /**
+   * @brief Key identifying a memoized type, the address of the variable is unique per type.
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr char lazyTypeKey{};
+
+  /**
+   * @brief Memoized conversions of the fields or cells of a lazy proxy. The values are heap allocated, so they keep
+   *        their addresses when the cache grows or is moved. A call reads only a few values, they are searched
+   *        linearly.
+   * @tparam Key Key type, the field name or the cell index
+   */
+  template<typename Key>
+  class LazyCache
+  {
+    public:
+      /**
+       * @brief Gets a memoized value, creates it on first access. Nothing is memoized if the factory throws.
+       * @tparam T Value type
+       * @tparam K Lookup key type, comparable with Key
+       * @tparam Fn Factory type, called as fn() returning T
+       * @param key The field name or the cell index.
+       * @param element The element index of a nested struct array, 0 otherwise.
+       * @param fn The factory.
+       * @return The value, valid for the lifetime of the cache.
+       */
+      template<typename T, typename K, typename Fn>
+      [[nodiscard]] T& get(const K& key, std::size_t element, Fn&& fn)
+      {
+        const void* type = &lazyTypeKey<T>;
+
+        for (auto& entry : mEntries)
+        {
+          if (entry.type == type && entry.element == element && entry.key == key)
+          {
+            return *static_cast<T*>(entry.value.get());
+          }
+        }
+
+        std::unique_ptr<T> value = std::make_unique<T>(fn());
+
+        T& result = *value;
+
+        mEntries.push_back(Entry{Key{key}, element, type, Value{value.release(), &destroy<T>}});
+
+        return result;
+      }
+    private:
+      /**
+       * @brief Destroys a type-erased value.
+       * @tparam T Value type
+       * @param value The value.
+       */
+      template<typename T>
+      static void destroy(void* value) noexcept
+      {
+        delete static_cast<T*>(value);
+      }
+
+      /// @brief Owning type-erased pointer.
+      using Value = std::unique_ptr<void, void(*)(void*) noexcept>;
+
+      /// @brief Memoized value.
+      struct Entry
+      {
+        Key         key;     ///< The field name or the cell index.
+        std::size_t element; ///< The element index of a nested struct array.
+        const void* type;    ///< The type key.
+        Value       value;   ///< The value.
+      };
+
+      std::vector<Entry> mEntries{}; ///< The memoized values.
+  };
+} // namespace detail
+
+  class LazyCell;
+
+  /**
+   * @brief Lazily decoded proxy of one element of a struct array. Fields are looked up and converted by fromArray()
+   *        on first access and the result is memoized for the lifetime of the proxy, so a call reading two fields of
+   *        a large options struct pays only for those two. Nested structs and cells are returned as memoized proxies.
+   *        Must not outlive the array.
+   */
+  class LazyStruct
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param array The struct array.
+       * @param index The element index.
+       */
+      explicit LazyStruct(ArrayCref array, std::size_t index = 0)
+      : mArray{array}, mIndex{index}
+      {
+        if (index >= mArray.getSize())
+        {
+          throw Exception{"matlabw:mx:LazyStruct:outOfRange", "element index out of range"};
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      LazyStruct(const LazyStruct&) = delete;
+
+      /// @brief Move constructor, the memoized values keep their addresses.
+      LazyStruct(LazyStruct&&) noexcept = default;
+
+      /// @brief Destructor.
+      ~LazyStruct() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      LazyStruct& operator=(const LazyStruct&) = delete;
+
+      /// @brief Move assignment operator.
+      LazyStruct& operator=(LazyStruct&&) noexcept = default;
+
+      /**
+       * @brief Gets the struct array.
+       * @return The struct array.
+       */
+      [[nodiscard]] StructArrayCref getArray() const noexcept
+      {
+        return mArray;
+      }
+
+      /**
+       * @brief Gets the element index.
+       * @return The element index.
+       */
+      [[nodiscard]] std::size_t getIndex() const noexcept
+      {
+        return mIndex;
+      }
+
+      /**
+       * @brief Checks if a field exists and is set.
+       * @param name The field name.
+       * @return True if the field exists and is set.
+       */
+      [[nodiscard]] bool has(std::string_view name) const
+      {
+        return getField(name).has_value();
+      }
+
+      /**
+       * @brief Gets a field without conversion.
+       * @param name The field name. Must be null-terminated.
+       * @return The field value, std::nullopt if the field does not exist or is unset.
+       */
+      [[nodiscard]] std::optional<ArrayCref> getField(std::string_view name) const
+      {
+        return mArray.getField(mIndex, name);
+      }
+
+      /**
+       * @brief Gets a field converted by fromArray() on first access.
+       * @tparam T Value type, see fromArray()
+       * @param name The field name. Must be null-terminated.
+       * @return The value, valid for the lifetime of the proxy.
+       * @throws Exception if the field is missing or does not convert to T.
+       */
+      template<typename T>
+      [[nodiscard]] const T& get(std::string_view name)
+      {
+        return getValue<T>(name, 0, [&]() -> T { throwMissing(name); });
+      }
+
+      /**
+       * @brief Gets a field converted by fromArray() on first access, or a default if the field does not exist or is
+       *        unset. The first result is memoized, also if it is the default.
+       * @tparam T Value type, see fromArray()
+       * @param name The field name. Must be null-terminated.
+       * @param defaultValue The value of a missing field.
+       * @return The value, valid for the lifetime of the proxy.
+       * @throws Exception if the field exists and does not convert to T.
+       */
+      template<typename T>
+      [[nodiscard]] const T& get(std::string_view name, const T& defaultValue)
+      {
+        return getValue<T>(name, 0, [&]() -> T { return defaultValue; });
+      }
+
+      /**
+       * @brief Gets a nested struct as a memoized lazy proxy.
+       * @param name The field name. Must be null-terminated.
+       * @param index The element index of the nested struct array.
+       * @return The proxy, valid for the lifetime of this proxy.
+       */
+      [[nodiscard]] LazyStruct& getStruct(std::string_view name, std::size_t index = 0)
+      {
+        return getValue<LazyStruct>(name, index, [&]() -> LazyStruct { throwMissing(name); });
+      }
+
+      /**
+       * @brief Gets a nested cell array as a memoized lazy proxy.
+       * @param name The field name. Must be null-terminated.
+       * @return The proxy, valid for the lifetime of this proxy.
+       */
+      [[nodiscard]] LazyCell& getCell(std::string_view name);
+    private:
+      /**
+       * @brief Throws the missing field error.
+       * @param name The field name.
+       */
+      [[noreturn]] static void throwMissing(std::string_view name)
+      {
+        throw Exception{"matlabw:mx:LazyStruct:missingField", "field '" + std::string{name} + "' is missing"};
+      }
+
+      /**
+       * @brief Gets a memoized field value.
+       * @tparam T Value type
+       * @tparam Missing Factory type of the value of a missing field
+       * @param name The field name.
+       * @param element The element index of a nested struct array.
+       * @param missing The factory of the value of a missing field.
+       * @return The value.
+       */
+      template<typename T, typename Missing>
+      [[nodiscard]] T& getValue(std::string_view name, std::size_t element, Missing&& missing);
+
+      StructArrayCref                mArray; ///< The struct array.
+      std::size_t                    mIndex; ///< The element index.
+      detail::LazyCache<std::string> mCache; ///< The memoized field values.
+  };
+
+  /**
+   * @brief Lazily decoded proxy of a cell array. Cells are converted by fromArray() on first access and the result is
+   *        memoized for the lifetime of the proxy. Nested structs and cells are returned as memoized proxies. Must not
+   *        outlive the array.
+   */
+  class LazyCell
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param array The cell array.
+       */
+      explicit LazyCell(ArrayCref array)
+      : mArray{array}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      LazyCell(const LazyCell&) = delete;
+
+      /// @brief Move constructor, the memoized values keep their addresses.
+      LazyCell(LazyCell&&) noexcept = default;
+
+      /// @brief Destructor.
+      ~LazyCell() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      LazyCell& operator=(const LazyCell&) = delete;
+
+      /// @brief Move assignment operator.
+      LazyCell& operator=(LazyCell&&) noexcept = default;
+
+      /**
+       * @brief Gets the cell array.
+       * @return The cell array.
+       */
+      [[nodiscard]] CellArrayCref getArray() const noexcept
+      {
+        return mArray;
+      }
+
+      /**
+       * @brief Gets the number of cells.
+       * @return The number of cells.
+       */
+      [[nodiscard]] std::size_t size() const
+      {
+        return mArray.getSize();
+      }
+
+      /**
+       * @brief Gets a cell without conversion.
+       * @param i The cell index.
+       * @return The cell value, std::nullopt if the cell is unset or past the end.
+       */
+      [[nodiscard]] std::optional<ArrayCref> getElement(std::size_t i) const
+      {
+        const mxArray* cell = (i < size()) ? mxGetCell(mArray.get(), i) : nullptr;
+
+        if (cell == nullptr)
+        {
+          return std::nullopt;
+        }
+
+        return ArrayCref{cell};
+      }
+
+      /**
+       * @brief Gets a cell converted by fromArray() on first access.
+       * @tparam T Value type, see fromArray()
+       * @param i The cell index.
+       * @return The value, valid for the lifetime of the proxy.
+       * @throws Exception if the cell is unset, past the end or does not convert to T.
+       */
+      template<typename T>
+      [[nodiscard]] const T& get(std::size_t i)
+      {
+        return getValue<T>(i, 0, [&]() -> T { throwMissing(i); });
+      }
+
+      /**
+       * @brief Gets a cell converted by fromArray() on first access, or a default if the cell is unset or past the
+       *        end. The first result is memoized, also if it is the default.
+       * @tparam T Value type, see fromArray()
+       * @param i The cell index.
+       * @param defaultValue The value of a missing cell.
+       * @return The value, valid for the lifetime of the proxy.
+       * @throws Exception if the cell exists and does not convert to T.
+       */
+      template<typename T>
+      [[nodiscard]] const T& get(std::size_t i, const T& defaultValue)
+      {
+        return getValue<T>(i, 0, [&]() -> T { return defaultValue; });
+      }
+
+      /**
+       * @brief Gets a nested struct as a memoized lazy proxy.
+       * @param i The cell index.
+       * @param index The element index of the nested struct array.
+       * @return The proxy, valid for the lifetime of this proxy.
+       */
+      [[nodiscard]] LazyStruct& getStruct(std::size_t i, std::size_t index = 0)
+      {
+        return getValue<LazyStruct>(i, index, [&]() -> LazyStruct { throwMissing(i); });
+      }
+
+      /**
+       * @brief Gets a nested cell array as a memoized lazy proxy.
+       * @param i The cell index.
+       * @return The proxy, valid for the lifetime of this proxy.
+       */
+      [[nodiscard]] LazyCell& getCell(std::size_t i)
+      {
+        return getValue<LazyCell>(i, 0, [&]() -> LazyCell { throwMissing(i); });
+      }
+    private:
+      /**
+       * @brief Throws the missing cell error.
+       * @param i The cell index.
+       */
+      [[noreturn]] static void throwMissing(std::size_t i)
+      {
+        throw Exception{"matlabw:mx:LazyCell:missingCell", "cell " + std::to_string(i) + " is unset"};
+      }
+
+      /**
+       * @brief Gets a memoized cell value.
+       * @tparam T Value type
+       * @tparam Missing Factory type of the value of a missing cell
+       * @param i The cell index.
+       * @param element The element index of a nested struct array.
+       * @param missing The factory of the value of a missing cell.
+       * @return The value.
+       */
+      template<typename T, typename Missing>
+      [[nodiscard]] T& getValue(std::size_t i, std::size_t element, Missing&& missing);
+
+      CellArrayCref                  mArray; ///< The cell array.
+      detail::LazyCache<std::size_t> mCache; ///< The memoized cell values.
+  };
+
+namespace detail
+{
+  /**
+   * @brief Converts a field or cell value, lazy proxies are constructed instead of converted.
+   * @tparam T Value type
+   * @param array The array.
+   * @param element The element index of a nested struct array.
+   * @return The value.
+   */
+  template<typename T>
+  [[nodiscard]] T makeLazyValue(ArrayCref array, std::size_t element)
+  {
+    if constexpr (std::is_same_v<T, LazyStruct>)
+    {
+      return LazyStruct{array, element};
+    }
+    else if constexpr (std::is_same_v<T, LazyCell>)
+    {
+      return LazyCell{array};
+    }
+    else
+    {
+      return fromArray<T>(array);
+    }
+  }
+} // namespace detail
+
+  inline LazyCell& LazyStruct::getCell(std::string_view name)
+  {
+    return getValue<LazyCell>(name, 0, [&]() -> LazyCell { throwMissing(name); });
+  }
+
+  template<typename T, typename Missing>
+  T& LazyStruct::getValue(std::string_view name, std::size_t element, Missing&& missing)
+  {
+    return mCache.get<T>(name, element, [&]() -> T
+    {
+      const std::optional<ArrayCref> field = getField(name);
+
+      if (!field)
+      {
+        return missing();
+      }
+
+      try
+      {
+        return detail::makeLazyValue<T>(*field, element);
+      }
+      catch (const Exception& e)
+      {
+        detail::rethrowInField(std::string{name}.c_str(), e);
+      }
+    });
+  }
+
+  template<typename T, typename Missing>
+  T& LazyCell::getValue(std::size_t i, std::size_t element, Missing&& missing)
+  {
+    return mCache.get<T>(i, element, [&]() -> T
+    {
+      const std::optional<ArrayCref> cell = getElement(i);
+
+      if (!cell)
+      {
+        return missing();
+      }
+
+      try
+      {
+        return detail::makeLazyValue<T>(*cell, element);
+      }
+      catch (const Exception& e)
+      {
+        throw Exception{e.id(), "cell " + std::to_string(i) + ": " + e.what()};
+      }
+    });
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_LAZY_STRUCT_HPP */
@@ -47,6 +47,8 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline LogicalArray makeLogicalArray(View<std::size_t> dims)
   {
+    static_cast<void>(checkDims("matlabw:mx:makeLogicalArray", dims));
+
     mxArray* array = mxCreateLogicalArray(dims.size(), dims.data());
 
     if (array == nullptr)
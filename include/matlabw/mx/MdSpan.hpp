@@ -0,0 +1,465 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_MD_SPAN_HPP
+#define MATLABW_MX_MD_SPAN_HPP
+
+#include "detail/include.hpp"
+
+#if __has_include(<mdspan>)
+# include <mdspan>
+#endif
+
+#include "common.hpp"
+#include "Exception.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief Marks a dynamic extent.
+  inline constexpr std::size_t dynamicExtent{std::dynamic_extent};
+
+  /**
+   * @brief Extents of a multidimensional view, mirrors std::extents.
+   * @tparam Exts Static extents, dynamicExtent marks an extent known only at runtime.
+   */
+  template<std::size_t... Exts>
+  class Extents
+  {
+    public:
+      using index_type = std::size_t; ///< Index type
+
+      /**
+       * @brief Gets the rank.
+       * @return The rank
+       */
+      [[nodiscard]] static constexpr std::size_t rank() noexcept
+      {
+        return sizeof...(Exts);
+      }
+
+      /**
+       * @brief Gets the number of dynamic extents.
+       * @return The number of dynamic extents
+       */
+      [[nodiscard]] static constexpr std::size_t rankDynamic() noexcept
+      {
+        return ((Exts == dynamicExtent) + ... + 0);
+      }
+
+      /**
+       * @brief Gets the static extent.
+       * @param r The dimension
+       * @return The static extent or dynamicExtent
+       */
+      [[nodiscard]] static constexpr std::size_t staticExtent(std::size_t r) noexcept
+      {
+        return staticExtents[r];
+      }
+
+      /// @brief Default constructor. Dynamic extents are zero.
+      constexpr Extents() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param exts All extents, the static ones must match.
+       */
+      constexpr explicit Extents(const std::array<std::size_t, rank()>& exts) noexcept
+      : mExtents{exts}
+      {}
+
+      /**
+       * @brief Gets the extent.
+       * @param r The dimension
+       * @return The extent
+       */
+      [[nodiscard]] constexpr std::size_t extent(std::size_t r) const noexcept
+      {
+        return (staticExtents[r] != dynamicExtent) ? staticExtents[r] : mExtents[r];
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The product of the extents
+       */
+      [[nodiscard]] constexpr std::size_t size() const noexcept
+      {
+        std::size_t result{1};
+
+        for (std::size_t r{}; r < rank(); ++r)
+        {
+          result *= extent(r);
+        }
+
+        return result;
+      }
+
+      /**
+       * @brief Compares the extents.
+       * @param other The other extents
+       * @return True if the extents are equal
+       */
+      [[nodiscard]] constexpr bool operator==(const Extents& other) const noexcept = default;
+    private:
+      static constexpr std::array<std::size_t, sizeof...(Exts)> staticExtents{Exts...}; ///< Static extents
+
+      std::array<std::size_t, sizeof...(Exts)> mExtents{((Exts == dynamicExtent) ? 0 : Exts)...}; ///< Extents
+  };
+
+namespace detail
+{
+  template<std::size_t Rank, typename = std::make_index_sequence<Rank>>
+  struct DExtentsHelper;
+
+  template<std::size_t Rank, std::size_t... Is>
+  struct DExtentsHelper<Rank, std::index_sequence<Is...>>
+  {
+    using Type = Extents<((void)Is, dynamicExtent)...>;
+  };
+} // namespace detail
+
+  /**
+   * @brief Extents with all extents dynamic.
+   * @tparam Rank The rank
+   */
+  template<std::size_t Rank>
+  using DExtents = typename detail::DExtentsHelper<Rank>::Type;
+
+  /// @brief Column-major layout, the first index is contiguous (MATLAB layout).
+  struct LayoutLeft {};
+
+  /// @brief Layout with an arbitrary stride in every dimension.
+  struct LayoutStride {};
+
+  /**
+   * @brief Non-owning multidimensional view, mirrors std::mdspan. Indexing is done by plain index arithmetic, so
+   *        loops over the view can be vectorized by the compiler.
+   * @tparam T Element type, const-qualified for read-only views
+   * @tparam Ext Extents type
+   * @tparam Layout LayoutLeft or LayoutStride
+   */
+  template<typename T, typename Ext, typename Layout = LayoutLeft>
+  class MdSpan
+  {
+    static_assert(std::is_same_v<Layout, LayoutLeft> || std::is_same_v<Layout, LayoutStride>, "unsupported layout");
+    static_assert(Ext::rank() > 0, "rank must be at least 1");
+
+    template<typename U, typename E, typename L>
+    friend class MdSpan;
+
+    public:
+      using element_type = T;                     ///< Element type
+      using value_type   = std::remove_cv_t<T>;   ///< Value type
+      using extents_type = Ext;                   ///< Extents type
+      using layout_type  = Layout;                ///< Layout type
+      using index_type   = std::size_t;           ///< Index type
+      using pointer      = T*;                    ///< Pointer type
+      using reference    = T&;                    ///< Reference type
+
+      /**
+       * @brief Gets the rank.
+       * @return The rank
+       */
+      [[nodiscard]] static constexpr std::size_t rank() noexcept
+      {
+        return Ext::rank();
+      }
+
+      /// @brief Default constructor.
+      constexpr MdSpan() noexcept = default;
+
+      /**
+       * @brief Constructor of a column-major view.
+       * @param data Pointer to the data
+       * @param exts Extents
+       */
+      constexpr MdSpan(pointer data, const Ext& exts) noexcept requires std::is_same_v<Layout, LayoutLeft>
+      : mData{data}, mExtents{exts}
+      {
+        std::size_t stride{1};
+
+        for (std::size_t r{}; r < rank(); ++r)
+        {
+          mStrides[r]  = stride;
+          stride      *= mExtents.extent(r);
+        }
+      }
+
+      /**
+       * @brief Constructor of a strided view.
+       * @param data Pointer to the data
+       * @param exts Extents
+       * @param strides Strides in elements
+       */
+      constexpr MdSpan(pointer data, const Ext& exts, const std::array<std::size_t, Ext::rank()>& strides) noexcept
+        requires std::is_same_v<Layout, LayoutStride>
+      : mData{data}, mExtents{exts}, mStrides{strides}
+      {}
+
+      /**
+       * @brief Converting constructor, adds const or converts a column-major view to a strided one.
+       * @tparam U Other element type
+       * @tparam L Other layout
+       * @param other Other view
+       */
+      template<typename U, typename L>
+        requires (std::is_convertible_v<U(*)[], T(*)[]> &&
+                  (std::is_same_v<L, Layout> || std::is_same_v<Layout, LayoutStride>))
+      constexpr MdSpan(const MdSpan<U, Ext, L>& other) noexcept
+      : mData{other.mData}, mExtents{other.mExtents}, mStrides{other.mStrides}
+      {}
+
+      /**
+       * @brief Gets the extents.
+       * @return The extents
+       */
+      [[nodiscard]] constexpr const extents_type& extents() const noexcept
+      {
+        return mExtents;
+      }
+
+      /**
+       * @brief Gets the extent.
+       * @param r The dimension
+       * @return The extent
+       */
+      [[nodiscard]] constexpr std::size_t extent(std::size_t r) const noexcept
+      {
+        return mExtents.extent(r);
+      }
+
+      /**
+       * @brief Gets the stride.
+       * @param r The dimension
+       * @return The stride in elements
+       */
+      [[nodiscard]] constexpr std::size_t stride(std::size_t r) const noexcept
+      {
+        if constexpr (std::is_same_v<Layout, LayoutLeft>)
+        {
+          if (r == 0)
+          {
+            return 1;
+          }
+        }
+
+        return mStrides[r];
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements
+       */
+      [[nodiscard]] constexpr std::size_t size() const noexcept
+      {
+        return mExtents.size();
+      }
+
+      /**
+       * @brief Is the view empty?
+       * @return True if the view has no elements
+       */
+      [[nodiscard]] constexpr bool empty() const noexcept
+      {
+        return size() == 0;
+      }
+
+      /**
+       * @brief Gets the pointer to the data.
+       * @return Pointer to the first element
+       */
+      [[nodiscard]] constexpr pointer data_handle() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Are the elements contiguous in column-major order?
+       * @return True if the view is contiguous
+       */
+      [[nodiscard]] constexpr bool isContiguous() const noexcept
+      {
+        if constexpr (std::is_same_v<Layout, LayoutLeft>)
+        {
+          return true;
+        }
+        else
+        {
+          std::size_t expected{1};
+
+          for (std::size_t r{}; r < rank(); ++r)
+          {
+            if (extent(r) != 1 && mStrides[r] != expected)
+            {
+              return false;
+            }
+
+            expected *= extent(r);
+          }
+
+          return true;
+        }
+      }
+
+      /**
+       * @brief Computes the offset of the element.
+       * @tparam Indices Index types
+       * @param indices Indices, one per dimension
+       * @return Offset in elements
+       */
+      template<typename... Indices>
+        requires (sizeof...(Indices) == Ext::rank() && (std::is_convertible_v<Indices, std::size_t> && ...))
+      [[nodiscard]] constexpr std::size_t getOffset(Indices... indices) const noexcept
+      {
+        const std::array<std::size_t, rank()> idx{static_cast<std::size_t>(indices)...};
+
+        std::size_t offset{};
+
+        if constexpr (std::is_same_v<Layout, LayoutLeft>)
+        {
+          // Horner scheme over the extents, static extents fold into constant offsets.
+          offset = idx[rank() - 1];
+
+          for (std::size_t r{rank() - 1}; r > 0; --r)
+          {
+            offset = offset * mExtents.extent(r - 1) + idx[r - 1];
+          }
+        }
+        else
+        {
+          for (std::size_t r{}; r < rank(); ++r)
+          {
+            offset += idx[r] * stride(r);
+          }
+        }
+
+        return offset;
+      }
+
+      /**
+       * @brief Accesses an element without bounds checking.
+       * @tparam Indices Index types
+       * @param indices Zero based indices, one per dimension
+       * @return Reference to the element
+       */
+      template<typename... Indices>
+        requires (sizeof...(Indices) == Ext::rank() && (std::is_convertible_v<Indices, std::size_t> && ...))
+      [[nodiscard]] constexpr reference operator()(Indices... indices) const noexcept
+      {
+        return mData[getOffset(indices...)];
+      }
+
+#   if defined(__cpp_multidimensional_subscript)
+      /**
+       * @brief Accesses an element without bounds checking.
+       * @tparam Indices Index types
+       * @param indices Zero based indices, one per dimension
+       * @return Reference to the element
+       */
+      template<typename... Indices>
+        requires (sizeof...(Indices) == Ext::rank() && (std::is_convertible_v<Indices, std::size_t> && ...))
+      [[nodiscard]] constexpr reference operator[](Indices... indices) const noexcept
+      {
+        return mData[getOffset(indices...)];
+      }
+#   endif
+
+#   if defined(__cpp_lib_mdspan)
+      /**
+       * @brief Converts the view to std::mdspan.
+       * @return The std::mdspan view
+       */
+      [[nodiscard]] auto toStd() const noexcept
+      {
+        using StdExtents = std::dextents<std::size_t, rank()>;
+
+        std::array<std::size_t, rank()> exts{};
+
+        for (std::size_t r{}; r < rank(); ++r)
+        {
+          exts[r] = extent(r);
+        }
+
+        if constexpr (std::is_same_v<Layout, LayoutLeft>)
+        {
+          return std::mdspan<T, StdExtents, std::layout_left>{mData, StdExtents{exts}};
+        }
+        else
+        {
+          using Mapping = typename std::layout_stride::template mapping<StdExtents>;
+
+          return std::mdspan<T, StdExtents, std::layout_stride>{mData, Mapping{StdExtents{exts}, mStrides}};
+        }
+      }
+#   endif
+    private:
+      pointer                          mData{};    ///< Pointer to the data
+      extents_type                     mExtents{}; ///< Extents
+      std::array<std::size_t, rank()>  mStrides{}; ///< Strides in elements
+  };
+
+namespace detail
+{
+  /**
+   * @brief Creates a column-major view over array data. Missing trailing dimensions are treated as 1, excess trailing
+   *        dimensions are folded into the last extent.
+   * @tparam T Element type
+   * @tparam Ext Extents type
+   * @param data Pointer to the data
+   * @param dims Array dimensions
+   * @return The view
+   */
+  template<typename T, typename Ext>
+  [[nodiscard]] MdSpan<T, Ext> makeMdspan(T* data, View<std::size_t> dims)
+  {
+    // Trailing dimensions are folded into exts[rank - 1], which does not exist for rank 0.
+    static_assert(Ext::rank() >= 1, "rank must be at least 1");
+
+    constexpr std::size_t rank = Ext::rank();
+
+    std::array<std::size_t, rank> exts{};
+
+    for (std::size_t r{}; r < rank; ++r)
+    {
+      exts[r] = (r < dims.size()) ? dims[r] : 1;
+    }
+
+    for (std::size_t r{rank}; r < dims.size(); ++r)
+    {
+      exts[rank - 1] *= dims[r];
+    }
+
+    for (std::size_t r{}; r < rank; ++r)
+    {
+      if (Ext::staticExtent(r) != dynamicExtent && Ext::staticExtent(r) != exts[r])
+      {
+        throw Exception{"matlabw:mx:toMdspan", "array dimensions do not match the static extents"};
+      }
+    }
+
+    return MdSpan<T, Ext>{data, Ext{exts}};
+  }
+} // namespace detail
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_MD_SPAN_HPP */
@@ -27,7 +27,9 @@
 
 #include "detail/include.hpp"
 
+#include "Dims.hpp"
 #include "Exception.hpp"
+#include "memory.hpp"
 #include "NumericArrayRef.hpp"
 #include "TypedArray.hpp"
 #include "typeTraits.hpp"
@@ -52,6 +54,8 @@ namespace matlabw::mx
                                               const ClassId     classId,
                                               const Complexity  complexity = Complexity::real)
   {
+    static_cast<void>(checkDims("matlabw:mx:makeNumericArray", dims));
+
     mxArray* array = mxCreateNumericArray(dims.size(),
                                           const_cast<std::size_t*>(dims.data()),
                                           static_cast<mxClassID>(classId),
@@ -119,6 +123,8 @@ namespace matlabw::mx
                                                     const ClassId     classId,
                                                     const Complexity  complexity = Complexity::real)
   {
+    static_cast<void>(checkDims("matlabw:mx:makeUninitNumericArray", dims));
+
     mxArray* array = mxCreateUninitNumericArray(dims.size(),
                                                 const_cast<std::size_t*>(dims.data()),
                                                 static_cast<mxClassID>(classId),
@@ -175,6 +181,110 @@ namespace matlabw::mx
     return makeUninitNumericArray<T>({{m, n}});
   }
 
+  /**
+   * @brief Creates a numeric array which takes ownership of an existing buffer. No data are copied.
+   * @tparam T Element type
+   * @param data Buffer allocated with mx::malloc or mx::calloc that is not persistent. Its size must be equal to the
+   *             product of the dimensions. On success the buffer is owned by the returned array.
+   * @param dims Dimensions
+   * @return Numeric array
+   */
+  template<typename T, std::enable_if_t<isNumeric<T>, int> = 0>
+  [[nodiscard]] NumericArray<T> adoptNumericArray(std::unique_ptr<T[], Deleter>&& data, View<std::size_t> dims)
+  {
+    static constexpr char id[]{"matlabw:mx:adoptNumericArray"};
+
+    if (data == nullptr)
+    {
+      throw Exception{id, "data must not be null"};
+    }
+
+    static_cast<void>(checkDims(id, dims));
+
+    // Create an empty array first, the empty array has no data to be freed when the buffer is attached.
+    mxArray* array = mxCreateNumericMatrix(0,
+                                           0,
+                                           static_cast<mxClassID>(TypeProperties<T>::classId),
+                                           static_cast<mxComplexity>(TypeProperties<T>::complexity));
+
+    if (array == nullptr)
+    {
+      throw Exception{id, "failed to create numeric array"};
+    }
+
+    NumericArray<T> result{std::move(array)};
+
+    if (mxSetDimensions(result.get(), dims.data(), dims.size()) != 0)
+    {
+      throw Exception{id, "failed to set dimensions"};
+    }
+
+    T* buffer = data.release();
+
+    // MATLAB frees the buffer with the array without going through mx::free, so it leaves the statistics here.
+    detail::recordFree(buffer);
+    mxSetData(result.get(), buffer);
+
+    return result;
+  }
+
+  /**
+   * @brief Creates a numeric matrix which takes ownership of an existing buffer. No data are copied.
+   * @tparam T Element type
+   * @param data Buffer allocated with mx::malloc or mx::calloc that is not persistent. Its size must be m * n.
+   * @param m Number of rows
+   * @param n Number of columns
+   * @return Numeric array
+   */
+  template<typename T, std::enable_if_t<isNumeric<T>, int> = 0>
+  [[nodiscard]] NumericArray<T> adoptNumericArray(std::unique_ptr<T[], Deleter>&& data, std::size_t m, std::size_t n)
+  {
+    return adoptNumericArray<T>(std::move(data), {{m, n}});
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric array whose data are aligned if the allocator allows it. MATLAB can only
+   *        attach memory returned directly by mxMalloc, so the data cannot be realigned by an offset. mxMalloc only
+   *        guarantees 16-byte alignment and large blocks are usually mapped 16 bytes past a page boundary, so the data
+   *        are not guaranteed to be aligned. Kernels requiring the alignment must check isAligned(array.getData(),
+   *        Align) and take a peeled or unaligned path otherwise. Data of at least a huge page are advised to be backed
+   *        by huge pages.
+   * @tparam T Element type
+   * @tparam Align Alignment in bytes, must be a power of two.
+   * @param dims Dimensions
+   * @return Uninitialized numeric array, its data are aligned at least to 16 bytes
+   */
+  template<typename T, std::size_t Align = 64, std::enable_if_t<isNumeric<T>, int> = 0>
+  [[nodiscard]] NumericArray<T> makeAlignedUninitNumericArray(View<std::size_t> dims)
+  {
+    static_assert(std::has_single_bit(Align), "Align must be a power of two");
+
+    auto array = makeUninitNumericArray<T>(dims);
+
+    const std::size_t sizeInBytes = array.getSize() * sizeof(T);
+
+    if (sizeInBytes >= hugePageSize)
+    {
+      adviseHugePages(array.getData(), sizeInBytes);
+    }
+
+    return array;
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric matrix whose data are aligned if the allocator allows it.
+   * @tparam T Element type
+   * @tparam Align Alignment in bytes, must be a power of two.
+   * @param m Number of rows
+   * @param n Number of columns
+   * @return Uninitialized numeric array, its data are aligned at least to 16 bytes
+   */
+  template<typename T, std::size_t Align = 64, std::enable_if_t<isNumeric<T>, int> = 0>
+  [[nodiscard]] NumericArray<T> makeAlignedUninitNumericArray(std::size_t m, std::size_t n)
+  {
+    return makeAlignedUninitNumericArray<T, Align>({{m, n}});
+  }
+
   /**
    * @brief Creates a numeric array of size 1 with the specified value
    * @tparam T Element type
@@ -184,11 +294,31 @@ namespace matlabw::mx
   template<typename T, std::enable_if_t<isNumeric<T>, int> = 0>
   [[nodiscard]] NumericArray<T> makeNumericScalar(const T& value = {})
   {
-    auto array = makeUninitNumericArray<T>({{1, 1}});
+    mxArray* array{};
+
+    if constexpr (std::is_same_v<T, double>)
+    {
+      array = mxCreateDoubleScalar(value);
+    }
+    else
+    {
+      array = mxCreateNumericMatrix(1,
+                                    1,
+                                    static_cast<mxClassID>(TypeProperties<T>::classId),
+                                    static_cast<mxComplexity>(TypeProperties<T>::complexity));
+    }
 
-    array[0] = value;
+    if (array == nullptr)
+    {
+      throw Exception{"matlabw:mx:makeNumericScalar", "failed to create numeric scalar"};
+    }
 
-    return array;
+    if constexpr (!std::is_same_v<T, double>)
+    {
+      *static_cast<T*>(mxGetData(array)) = value;
+    }
+
+    return NumericArray<T>{std::move(array)};
   }
 
   /**
@@ -199,9 +329,17 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline Array makeNumericScalar(const ClassId classId, const Complexity complexity = Complexity::real)
   {
-    auto array = makeNumericArray({{1, 1}}, classId, complexity);
+    mxArray* array = mxCreateNumericMatrix(1,
+                                           1,
+                                           static_cast<mxClassID>(classId),
+                                           static_cast<mxComplexity>(complexity));
 
-    return array;
+    if (array == nullptr)
+    {
+      throw Exception{"matlabw:mx:makeNumericScalar", "failed to create numeric scalar"};
+    }
+
+    return Array{std::move(array)};
   }
 } // namespace matlabw::mx
 
@@ -49,12 +49,15 @@ namespace matlabw::mx
       throw Exception{"invalid class name"};
     }
 
-    if (mxSetClassName(srcArray.release(), className))
+    mxArray* array = srcArray.release();
+
+    if (mxSetClassName(array, className))
     {
+      mxDestroyArray(array);
       throw Exception{"failed to set class name"};
     }
 
-    return Array{std::move(srcArray)};
+    return Array{std::move(array)};
   }
 
   /**
@@ -0,0 +1,341 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PERF_COUNTERS_HPP
+#define MATLABW_MX_PERF_COUNTERS_HPP
+
+#include "detail/include.hpp"
+
+#ifdef __linux__
+# define MATLABW_PERF_COUNTERS_LINUX
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+#include <array>
+
+#include "NumericArray.hpp"
+#include "StructArray.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief Hardware events counted by PerfCounters.
+  enum class PerfEvent : std::size_t
+  {
+    cycles,          ///< CPU cycles.
+    instructions,    ///< Retired instructions.
+    cacheReferences, ///< Last level cache references.
+    cacheMisses,     ///< Last level cache misses.
+    branchMisses,    ///< Mispredicted branches.
+  };
+
+  /// @brief Number of hardware events.
+  inline constexpr std::size_t perfEventCount{5};
+
+  /// @brief Assumed size of a cache line used to estimate the bytes moved from memory.
+  inline constexpr std::size_t perfCacheLineSize{64};
+
+  /// @brief Counted values of the hardware events.
+  struct PerfCounterValues
+  {
+    std::array<std::uint64_t, perfEventCount> counts{};    ///< The counts, scaled when the events were multiplexed.
+    std::array<bool, perfEventCount>          available{}; ///< True if the event could be counted.
+
+    /**
+     * @brief Gets the count of an event.
+     * @param event The event.
+     * @return The count, 0 if the event is not available.
+     */
+    [[nodiscard]] std::uint64_t get(PerfEvent event) const noexcept
+    {
+      return counts[static_cast<std::size_t>(event)];
+    }
+
+    /**
+     * @brief Checks if an event was counted.
+     * @param event The event.
+     * @return True if the event was counted.
+     */
+    [[nodiscard]] bool isAvailable(PerfEvent event) const noexcept
+    {
+      return available[static_cast<std::size_t>(event)];
+    }
+
+    /**
+     * @brief Gets the instructions per cycle, low values of memory-bound code indicate stalls.
+     * @return The instructions per cycle, 0 if not available.
+     */
+    [[nodiscard]] double getInstructionsPerCycle() const noexcept
+    {
+      const std::uint64_t cycles = get(PerfEvent::cycles);
+
+      return (cycles != 0) ? static_cast<double>(get(PerfEvent::instructions)) / static_cast<double>(cycles) : 0.0;
+    }
+
+    /**
+     * @brief Estimates the bytes moved from memory as last level cache misses times the cache line size. Prefetched
+     *        lines and write-backs are not included.
+     * @return The estimated number of bytes.
+     */
+    [[nodiscard]] std::uint64_t getBytesMoved() const noexcept
+    {
+      return get(PerfEvent::cacheMisses) * perfCacheLineSize;
+    }
+
+    /**
+     * @brief Adds the counts of other values, an event stays available if it was in either.
+     * @param other The other values.
+     * @return Reference to this.
+     */
+    PerfCounterValues& operator+=(const PerfCounterValues& other) noexcept
+    {
+      for (std::size_t i{}; i < perfEventCount; ++i)
+      {
+        counts[i]    += other.counts[i];
+        available[i]  = available[i] || other.available[i];
+      }
+
+      return *this;
+    }
+  };
+
+  /**
+   * @brief Gets the name of an event.
+   * @param event The event.
+   * @return The name.
+   */
+  [[nodiscard]] constexpr const char* getPerfEventName(PerfEvent event) noexcept
+  {
+    constexpr const char* names[perfEventCount]{"cycles", "instructions", "cacheReferences", "cacheMisses",
+                                                "branchMisses"};
+
+    return names[static_cast<std::size_t>(event)];
+  }
+
+  /**
+   * @brief Hardware performance counters of the calling thread, counting user space only. Uses perf_event_open on
+   *        Linux; on other platforms or when the kernel denies access, e.g. because of perf_event_paranoid on shared
+   *        nodes, the events are unavailable and count 0. Threads other than the creating one are not counted.
+   */
+  class PerfCounters
+  {
+    public:
+      /// @brief Constructor, opens the counters in the disabled state.
+      PerfCounters() noexcept
+      {
+#ifdef MATLABW_PERF_COUNTERS_LINUX
+        static constexpr std::pair<std::uint32_t, std::uint64_t> configs[perfEventCount]
+        {
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+
+        for (std::size_t i{}; i < perfEventCount; ++i)
+        {
+          perf_event_attr attr{};
+          attr.type           = configs[i].first;
+          attr.size           = sizeof(perf_event_attr);
+          attr.config         = configs[i].second;
+          attr.disabled       = 1;
+          attr.exclude_kernel = 1;
+          attr.exclude_hv     = 1;
+          attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+          mFds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      PerfCounters(const PerfCounters&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      PerfCounters(PerfCounters&&) = delete;
+
+      /// @brief Destructor, closes the counters.
+      ~PerfCounters()
+      {
+#ifdef MATLABW_PERF_COUNTERS_LINUX
+        for (const int fd : mFds)
+        {
+          if (fd >= 0)
+          {
+            close(fd);
+          }
+        }
+#endif
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      PerfCounters& operator=(const PerfCounters&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      PerfCounters& operator=(PerfCounters&&) = delete;
+
+      /**
+       * @brief Checks if any event can be counted.
+       * @return True if at least one counter is open.
+       */
+      [[nodiscard]] bool isAvailable() const noexcept
+      {
+        return std::any_of(mFds.begin(), mFds.end(), [](int fd) { return fd >= 0; });
+      }
+
+      /// @brief Resets and starts the counters.
+      void start() noexcept
+      {
+#ifdef MATLABW_PERF_COUNTERS_LINUX
+        for (const int fd : mFds)
+        {
+          if (fd >= 0)
+          {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+          }
+        }
+#endif
+      }
+
+      /**
+       * @brief Stops the counters and reads them.
+       * @return The values counted since start().
+       */
+      PerfCounterValues stop() noexcept
+      {
+        PerfCounterValues values{};
+
+#ifdef MATLABW_PERF_COUNTERS_LINUX
+        for (std::size_t i{}; i < perfEventCount; ++i)
+        {
+          if (mFds[i] < 0)
+          {
+            continue;
+          }
+
+          ioctl(mFds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+          // The value, the time enabled and the time running, which is shorter when the events were multiplexed.
+          std::uint64_t data[3]{};
+
+          if (read(mFds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+          {
+            continue;
+          }
+
+          values.counts[i]    = (data[1] == data[2])
+                                  ? data[0]
+                                  : static_cast<std::uint64_t>(static_cast<double>(data[0])
+                                                               * static_cast<double>(data[1])
+                                                               / static_cast<double>(data[2]));
+          values.available[i] = true;
+        }
+#endif
+
+        return values;
+      }
+
+    private:
+      std::array<int, perfEventCount> mFds{-1, -1, -1, -1, -1}; ///< File descriptors of the counters, -1 if closed.
+  };
+
+  /**
+   * @brief Counts the hardware events of the calling thread during its lifetime and adds them to the values, e.g.
+   *        around a mex::Function body or a kernel. Each scope opens its own counters.
+   */
+  class PerfCounterScope
+  {
+    public:
+      /**
+       * @brief Constructor, starts counting.
+       * @param values The values to which the counts are added.
+       */
+      explicit PerfCounterScope(PerfCounterValues& values) noexcept
+      : mValues{values}
+      {
+        mCounters.start();
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      PerfCounterScope(const PerfCounterScope&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      PerfCounterScope(PerfCounterScope&&) = delete;
+
+      /// @brief Destructor, stops counting and adds the counts to the values.
+      ~PerfCounterScope()
+      {
+        mValues += mCounters.stop();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      PerfCounterScope& operator=(const PerfCounterScope&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      PerfCounterScope& operator=(PerfCounterScope&&) = delete;
+
+    private:
+      PerfCounterValues& mValues;   ///< The values to which the counts are added.
+      PerfCounters       mCounters; ///< The counters.
+  };
+
+  /**
+   * @brief Converts counter values to a scalar struct with a field per event plus instructionsPerCycle and
+   *        bytesMoved. Unavailable events are NaN.
+   * @param values The values.
+   * @return The struct.
+   */
+  [[nodiscard]] inline StructArray makePerfCounterStruct(const PerfCounterValues& values)
+  {
+    static constexpr const char* fieldNames[]{"cycles", "instructions", "cacheReferences", "cacheMisses",
+                                              "branchMisses", "instructionsPerCycle", "bytesMoved"};
+
+    static constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+    auto array = makeStructArray(1, 1, fieldNames);
+
+    for (std::size_t i{}; i < perfEventCount; ++i)
+    {
+      const double count = (values.available[i]) ? static_cast<double>(values.counts[i]) : nan;
+
+      array.setField(fieldNames[i], makeNumericScalar<double>(count));
+    }
+
+    const bool ipcAvailable   = values.isAvailable(PerfEvent::cycles) && values.isAvailable(PerfEvent::instructions);
+    const bool bytesAvailable = values.isAvailable(PerfEvent::cacheMisses);
+
+    array.setField("instructionsPerCycle",
+                   makeNumericScalar<double>((ipcAvailable) ? values.getInstructionsPerCycle() : nan));
+    array.setField("bytesMoved",
+                   makeNumericScalar<double>((bytesAvailable) ? static_cast<double>(values.getBytesMoved()) : nan));
+
+    return array;
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_PERF_COUNTERS_HPP */
@@ -0,0 +1,340 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PROFILER_HPP
+#define MATLABW_MX_PROFILER_HPP
+
+#include "detail/include.hpp"
+
+#ifdef MATLABW_ENABLE_PROFILING
+# include <atomic>
+# include <chrono>
+# include <cstdio>
+# include <map>
+# include <mutex>
+#endif
+
+#include "Exception.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief True if the profiling zones are recorded, configure with MATLABW_ENABLE_PROFILING.
+#ifdef MATLABW_ENABLE_PROFILING
+  inline constexpr bool profilingEnabled{true};
+#else
+  inline constexpr bool profilingEnabled{false};
+#endif
+
+  /// @brief A finished profiling zone.
+  struct ProfileEvent
+  {
+    const char*   name{};     ///< The name of the zone, static storage.
+    const char*   category{}; ///< The category of the zone, static storage.
+    std::int64_t  start{};    ///< Start in nanoseconds since the first recorded zone.
+    std::int64_t  duration{}; ///< Duration in nanoseconds.
+    std::uint32_t threadId{}; ///< Index of the thread that recorded the zone.
+  };
+
+  /// @brief Aggregated statistics of the zones with the same name and category.
+  struct ProfileSummary
+  {
+    const char*  name{};          ///< The name of the zones.
+    const char*  category{};      ///< The category of the zones.
+    std::size_t  count{};         ///< Number of zones.
+    std::int64_t totalDuration{}; ///< Total duration in nanoseconds.
+    std::int64_t maxDuration{};   ///< Maximum duration in nanoseconds.
+  };
+
+#ifdef MATLABW_ENABLE_PROFILING
+namespace detail
+{
+  /// @brief Maximum number of recorded events, later zones are dropped until the profile is cleared.
+  inline constexpr std::size_t maxProfileEvents{std::size_t{1} << 20};
+
+  /// @brief Recorded events.
+  struct ProfileState
+  {
+    std::mutex                                  mutex{};                                ///< Guards the events.
+    std::vector<ProfileEvent>                   events{};                               ///< The events.
+    std::size_t                                 dropped{};                              ///< Number of dropped events.
+    const std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()}; ///< Time origin.
+  };
+
+  /**
+   * @brief Gets the recorded events.
+   * @return The profile state.
+   */
+  [[nodiscard]] inline ProfileState& getProfileState()
+  {
+    static ProfileState state{};
+
+    return state;
+  }
+
+  /**
+   * @brief Gets the index of the calling thread.
+   * @return The thread index.
+   */
+  [[nodiscard]] inline std::uint32_t getProfileThreadId() noexcept
+  {
+    static std::atomic<std::uint32_t> nextId{};
+    thread_local const std::uint32_t  id = nextId.fetch_add(1, std::memory_order_relaxed);
+
+    return id;
+  }
+
+  /**
+   * @brief Writes a JSON string literal.
+   * @param file The file.
+   * @param str The string.
+   */
+  inline void writeJsonString(std::FILE* file, const char* str)
+  {
+    std::fputc('"', file);
+
+    for (; *str != '\0'; ++str)
+    {
+      const unsigned char c = static_cast<unsigned char>(*str);
+
+      if (c == '"' || c == '\\')
+      {
+        std::fputc('\\', file);
+        std::fputc(c, file);
+      }
+      else if (c < 0x20)
+      {
+        std::fprintf(file, "\\u%04x", c);
+      }
+      else
+      {
+        std::fputc(c, file);
+      }
+    }
+
+    std::fputc('"', file);
+  }
+} // namespace detail
+#endif
+
+  /**
+   * @brief Scoped profiling zone, records its wall time when destroyed. Compiles to nothing unless the library is
+   *        configured with MATLABW_ENABLE_PROFILING.
+   */
+  class ProfileZone
+  {
+    public:
+      /**
+       * @brief Constructor. Starts the zone.
+       * @param name The name of the zone, must have static storage duration.
+       * @param category The category of the zone, must have static storage duration.
+       */
+      explicit ProfileZone([[maybe_unused]] const char* name, [[maybe_unused]] const char* category = "user") noexcept
+#ifdef MATLABW_ENABLE_PROFILING
+      : mName{name}, mCategory{category}, mStart{std::chrono::steady_clock::now()}
+#endif
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      ProfileZone(const ProfileZone&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ProfileZone(ProfileZone&&) = delete;
+
+      /// @brief Destructor. Records the zone.
+      ~ProfileZone() noexcept
+      {
+#ifdef MATLABW_ENABLE_PROFILING
+        const auto end = std::chrono::steady_clock::now();
+
+        auto& state = detail::getProfileState();
+
+        const ProfileEvent event{mName,
+                                 mCategory,
+                                 std::chrono::duration_cast<std::chrono::nanoseconds>(mStart - state.epoch).count(),
+                                 std::chrono::duration_cast<std::chrono::nanoseconds>(end - mStart).count(),
+                                 detail::getProfileThreadId()};
+
+        std::lock_guard lock{state.mutex};
+
+        if (state.events.size() >= detail::maxProfileEvents)
+        {
+          ++state.dropped;
+          return;
+        }
+
+        try
+        {
+          state.events.push_back(event);
+        }
+        catch (...)
+        {
+          ++state.dropped;
+        }
+#endif
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ProfileZone& operator=(const ProfileZone&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ProfileZone& operator=(ProfileZone&&) = delete;
+#ifdef MATLABW_ENABLE_PROFILING
+    private:
+      const char*                           mName;     ///< The name of the zone.
+      const char*                           mCategory; ///< The category of the zone.
+      std::chrono::steady_clock::time_point mStart;    ///< Start of the zone.
+#endif
+  };
+
+  /**
+   * @brief Gets a copy of the recorded events.
+   * @return The events, empty if profiling is disabled.
+   */
+  [[nodiscard]] inline std::vector<ProfileEvent> getProfileEvents()
+  {
+#ifdef MATLABW_ENABLE_PROFILING
+    auto& state = detail::getProfileState();
+
+    std::lock_guard lock{state.mutex};
+
+    return state.events;
+#else
+    return {};
+#endif
+  }
+
+  /**
+   * @brief Aggregates the recorded events by name and category.
+   * @return The summaries sorted by total duration, longest first.
+   */
+  [[nodiscard]] inline std::vector<ProfileSummary> getProfileSummary()
+  {
+    std::vector<ProfileSummary> summaries{};
+
+#ifdef MATLABW_ENABLE_PROFILING
+    std::map<std::pair<std::string_view, std::string_view>, ProfileSummary> byName{};
+
+    for (const ProfileEvent& event : getProfileEvents())
+    {
+      ProfileSummary& summary = byName[{event.name, event.category}];
+
+      summary.name           = event.name;
+      summary.category       = event.category;
+      summary.count         += 1;
+      summary.totalDuration += event.duration;
+      summary.maxDuration    = std::max(summary.maxDuration, event.duration);
+    }
+
+    for (const auto& [key, summary] : byName)
+    {
+      summaries.push_back(summary);
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](const ProfileSummary& a, const ProfileSummary& b)
+    {
+      return a.totalDuration > b.totalDuration;
+    });
+#endif
+
+    return summaries;
+  }
+
+  /**
+   * @brief Gets the number of zones dropped because the maximum number of events was reached.
+   * @return The number of dropped zones.
+   */
+  [[nodiscard]] inline std::size_t getDroppedProfileEventCount()
+  {
+#ifdef MATLABW_ENABLE_PROFILING
+    auto& state = detail::getProfileState();
+
+    std::lock_guard lock{state.mutex};
+
+    return state.dropped;
+#else
+    return 0;
+#endif
+  }
+
+  /// @brief Discards the recorded events.
+  inline void clearProfile() noexcept
+  {
+#ifdef MATLABW_ENABLE_PROFILING
+    auto& state = detail::getProfileState();
+
+    std::lock_guard lock{state.mutex};
+
+    state.events.clear();
+    state.dropped = 0;
+#endif
+  }
+
+  /**
+   * @brief Writes the recorded events as a Chrome trace (JSON trace event format), viewable in Perfetto or
+   *        chrome://tracing.
+   * @param path The path of the file.
+   */
+  inline void writeChromeTrace([[maybe_unused]] const char* path)
+  {
+    static constexpr char id[]{"matlabw:mx:writeChromeTrace"};
+
+#ifdef MATLABW_ENABLE_PROFILING
+    const std::vector<ProfileEvent> events = getProfileEvents();
+
+    std::FILE* file = std::fopen(path, "w");
+
+    if (file == nullptr)
+    {
+      throw Exception{id, "failed to open trace file"};
+    }
+
+    std::fputs("{\"traceEvents\":[", file);
+
+    for (std::size_t i{}; i < events.size(); ++i)
+    {
+      const ProfileEvent& event = events[i];
+
+      std::fputs((i == 0) ? "\n{\"name\":" : ",\n{\"name\":", file);
+      detail::writeJsonString(file, event.name);
+      std::fputs(",\"cat\":", file);
+      detail::writeJsonString(file, event.category);
+      std::fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                   static_cast<double>(event.start) / 1e3,
+                   static_cast<double>(event.duration) / 1e3,
+                   static_cast<unsigned>(event.threadId));
+    }
+
+    std::fputs("\n],\"displayTimeUnit\":\"ms\"}\n", file);
+
+    if (std::fclose(file) != 0)
+    {
+      throw Exception{id, "failed to write trace file"};
+    }
+#else
+    throw Exception{id, "profiling is disabled, configure with MATLABW_ENABLE_PROFILING=ON"};
+#endif
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_PROFILER_HPP */
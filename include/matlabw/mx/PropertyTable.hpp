@@ -0,0 +1,246 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_PROPERTY_TABLE_HPP
+#define MATLABW_MX_PROPERTY_TABLE_HPP
+
+#include "detail/include.hpp"
+
+#include "Array.hpp"
+#include "ArrayRef.hpp"
+#include "Exception.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Properties of the elements of an object array stored as one column per property. mxGetProperty returns a
+   *        deep copy on every call, so each property of each element is read at most once and the table hands out
+   *        borrowed references to the copies, valid while the table is alive. Columns are read either up front or on
+   *        the first access.
+   */
+  class PropertyTable
+  {
+    public:
+      /**
+       * @brief Constructor. Properties are read on the first access.
+       * @param objects Object array, must outlive the table
+       */
+      explicit PropertyTable(const ArrayCref objects)
+      : mObjects{objects}, mSize{objects.getSize()}
+      {}
+
+      /**
+       * @brief Constructor. Reads the given properties of all elements.
+       * @param objects Object array, must outlive the table
+       * @param names Property names, duplicates are read once
+       */
+      PropertyTable(const ArrayCref objects, std::initializer_list<std::string_view> names)
+      : PropertyTable{objects}
+      {
+        for (const std::string_view name : names)
+        {
+          load(name);
+        }
+      }
+
+      /**
+       * @brief Constructor. Reads the given properties of all elements.
+       * @param objects Object array, must outlive the table
+       * @param names Property names, duplicates are read once
+       */
+      PropertyTable(const ArrayCref objects, std::span<const std::string> names)
+      : PropertyTable{objects}
+      {
+        for (const std::string& name : names)
+        {
+          load(name);
+        }
+      }
+
+      /**
+       * @brief Gets the number of elements of the object array.
+       * @return Number of elements
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Gets the number of properties with at least one element read.
+       * @return Number of properties
+       */
+      [[nodiscard]] std::size_t getPropertyCount() const noexcept
+      {
+        return mColumns.size();
+      }
+
+      /**
+       * @brief Reads a property of all elements which have not been read yet.
+       * @param name Property name
+       * @return Column of the property, an element is invalid if the object has no such property
+       */
+      std::span<const Array> load(const std::string_view name)
+      {
+        Column& column = findColumn(name);
+
+        for (std::size_t i{}; i < mSize; ++i)
+        {
+          read(column, i);
+        }
+
+        return column.values;
+      }
+
+      /**
+       * @brief Gets a property of all elements, reads the missing ones.
+       * @param name Property name
+       * @return Column of the property, an element is invalid if the object has no such property
+       */
+      [[nodiscard]] std::span<const Array> getColumn(const std::string_view name)
+      {
+        return load(name);
+      }
+
+      /**
+       * @brief Checks if an element has a property, reads it if necessary.
+       * @param index Element index
+       * @param name Property name
+       * @return True if the element has the property
+       */
+      [[nodiscard]] bool has(const std::size_t index, const std::string_view name)
+      {
+        checkIndex(index, "matlabw:mx:PropertyTable:has");
+
+        return read(findColumn(name), index).isValid();
+      }
+
+      /**
+       * @brief Gets a property of an element, reads it on the first access.
+       * @param index Element index
+       * @param name Property name
+       * @return Borrowed reference to the property value, valid while the table is alive
+       */
+      [[nodiscard]] ArrayCref get(const std::size_t index, const std::string_view name)
+      {
+        static constexpr char id[]{"matlabw:mx:PropertyTable:get"};
+
+        checkIndex(index, id);
+
+        const Array& value = read(findColumn(name), index);
+
+        if (!value.isValid())
+        {
+          throw Exception{id, "object has no property '" + std::string{name} + "'"};
+        }
+
+        return ArrayCref{value};
+      }
+
+      /**
+       * @brief Gets a property of the first element.
+       * @param name Property name
+       * @return Borrowed reference to the property value, valid while the table is alive
+       */
+      [[nodiscard]] ArrayCref get(const std::string_view name)
+      {
+        return get(0, name);
+      }
+
+      /**
+       * @brief Releases the copies of a property, e.g. a large one which is no longer needed.
+       * @param name Property name
+       */
+      void release(const std::string_view name)
+      {
+        std::erase_if(mColumns, [name](const Column& column) { return column.name == name; });
+      }
+    private:
+      /// @brief Column of one property.
+      struct Column
+      {
+        std::string        name{};   ///< Property name, null-terminated for mxGetProperty
+        std::vector<Array> values{}; ///< Property values, invalid if not read or missing
+        std::vector<bool>  loaded{}; ///< Whether the value has been read
+      };
+
+      /**
+       * @brief Gets the column of a property, creates it if it does not exist.
+       * @param name Property name
+       * @return The column
+       */
+      [[nodiscard]] Column& findColumn(const std::string_view name)
+      {
+        for (Column& column : mColumns)
+        {
+          if (column.name == name)
+          {
+            return column;
+          }
+        }
+
+        Column& column = mColumns.emplace_back();
+        column.name = name;
+        column.values.resize(mSize);
+        column.loaded.resize(mSize);
+
+        return column;
+      }
+
+      /**
+       * @brief Reads a property value of an element if it has not been read yet.
+       * @param column Column of the property
+       * @param index Element index
+       * @return The property value
+       */
+      const Array& read(Column& column, const std::size_t index)
+      {
+        if (!column.loaded[index])
+        {
+          column.values[index] = Array{mxGetProperty(mObjects.get(), index, column.name.c_str())};
+          column.loaded[index] = true;
+        }
+
+        return column.values[index];
+      }
+
+      /**
+       * @brief Checks the element index.
+       * @param index Element index
+       * @param id Exception identifier
+       */
+      void checkIndex(const std::size_t index, const char* id) const
+      {
+        if (index >= mSize)
+        {
+          throw Exception{id, "index out of range"};
+        }
+      }
+
+      ArrayCref           mObjects; ///< Object array
+      std::size_t         mSize{};  ///< Number of elements
+      std::vector<Column> mColumns; ///< Columns of the read properties
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_PROPERTY_TABLE_HPP */
@@ -0,0 +1,315 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_SHARED_ARRAY_HPP
+#define MATLABW_MX_SHARED_ARRAY_HPP
+
+#include "detail/include.hpp"
+
+#include "Array.hpp"
+#include "ArrayRef.hpp"
+#include "common.hpp"
+#include "Exception.hpp"
+#include "typeTraits.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Reference-counted copy-on-write array handle. Copies of the handle share the same mxArray, the payload is
+   *        duplicated by mxDuplicateArray only when mutable access is requested while the array is shared or borrowed.
+   *        Read-only access through the const member functions never duplicates the array.
+   */
+  class SharedArray
+  {
+    public:
+      /// @brief Default constructor. Creates an invalid handle.
+      SharedArray() noexcept = default;
+
+      /**
+       * @brief Constructor. Takes ownership of the array.
+       * @param array The array.
+       */
+      explicit SharedArray(Array&& array)
+      : mOwned{array.isValid() ? std::make_shared<Array>(std::move(array)) : nullptr}
+      {}
+
+      /**
+       * @brief Constructor. Borrows the array, e.g. a MEX function input. The array is duplicated on first mutable
+       *        access, so it must outlive the handle only as long as it is accessed read-only.
+       * @param array The array.
+       */
+      explicit SharedArray(ArrayCref array) noexcept
+      : mBorrowed{array.get()}
+      {}
+
+      /**
+       * @brief Copy constructor. Shares the array.
+       * @param other The other handle.
+       */
+      SharedArray(const SharedArray& other) = default;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other handle.
+       */
+      SharedArray(SharedArray&& other) noexcept
+      : mOwned{std::move(other.mOwned)},
+        mBorrowed{std::exchange(other.mBorrowed, nullptr)}
+      {}
+
+      /// @brief Destructor.
+      ~SharedArray() noexcept = default;
+
+      /**
+       * @brief Copy assignment operator. Shares the array.
+       * @param other The other handle.
+       * @return Reference to this handle.
+       */
+      SharedArray& operator=(const SharedArray& other) = default;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other handle.
+       * @return Reference to this handle.
+       */
+      SharedArray& operator=(SharedArray&& other) noexcept
+      {
+        if (this != std::addressof(other))
+        {
+          mOwned    = std::move(other.mOwned);
+          mBorrowed = std::exchange(other.mBorrowed, nullptr);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Is the handle valid?
+       * @return True if the handle refers to an array, false otherwise.
+       */
+      [[nodiscard]] bool isValid() const noexcept
+      {
+        return get() != nullptr;
+      }
+
+      /**
+       * @brief Is the array borrowed?
+       * @return True if the array is borrowed, false otherwise.
+       */
+      [[nodiscard]] bool isBorrowed() const noexcept
+      {
+        return mBorrowed != nullptr;
+      }
+
+      /**
+       * @brief Is the array owned exclusively by this handle? Mutable access to a unique array does not duplicate it.
+       * @return True if the array is unique, false otherwise.
+       */
+      [[nodiscard]] bool isUnique() const noexcept
+      {
+        return mOwned != nullptr && mOwned.use_count() == 1;
+      }
+
+      /**
+       * @brief Gets the number of handles sharing the array.
+       * @return The number of handles, zero for borrowed or invalid handles.
+       */
+      [[nodiscard]] std::size_t getUseCount() const noexcept
+      {
+        return static_cast<std::size_t>(mOwned.use_count());
+      }
+
+      /**
+       * @brief Gets read-only access to the array. Never duplicates the array.
+       * @return Const reference to the array.
+       */
+      [[nodiscard]] ArrayCref cref() const
+      {
+        checkValid("matlabw:mx:SharedArray:cref");
+        return ArrayCref{get()};
+      }
+
+      /**
+       * @brief Gets mutable access to the array. Duplicates the array if it is shared or borrowed.
+       * @return Reference to the array.
+       */
+      [[nodiscard]] ArrayRef ref()
+      {
+        makeUnique();
+        return ArrayRef{mOwned->get()};
+      }
+
+      /**
+       * @brief Get the rank of the array
+       * @return Rank of the array
+       */
+      [[nodiscard]] std::size_t getRank() const
+      {
+        return cref().getRank();
+      }
+
+      /**
+       * @brief Get the dimensions of the array
+       * @return View of the dimensions
+       */
+      [[nodiscard]] View<std::size_t> getDims() const
+      {
+        return cref().getDims();
+      }
+
+      /**
+       * @brief Get the number of elements in the array
+       * @return Number of elements
+       */
+      [[nodiscard]] std::size_t getSize() const
+      {
+        return cref().getSize();
+      }
+
+      /**
+       * @brief Get the class ID of the array
+       * @return Class ID of the array
+       */
+      [[nodiscard]] ClassId getClassId() const
+      {
+        return cref().getClassId();
+      }
+
+      /**
+       * @brief Is the array element class complex?
+       * @return True if the array element class is complex, false otherwise
+       */
+      [[nodiscard]] bool isComplex() const
+      {
+        return cref().isComplex();
+      }
+
+      /**
+       * @brief Get the array data for reading. Never duplicates the array.
+       * @return Pointer to the array data
+       */
+      [[nodiscard]] const void* getData() const
+      {
+        return cref().getData();
+      }
+
+      /**
+       * @brief Get the array data for writing. Duplicates the array if it is shared or borrowed.
+       * @return Pointer to the array data
+       */
+      [[nodiscard]] void* getData()
+      {
+        return ref().getData();
+      }
+
+      /**
+       * @brief Get the array data as a specific type for reading. Never duplicates the array.
+       * @tparam T Type
+       * @return Pointer to the array data
+       */
+      template<typename T>
+      [[nodiscard]] const T* getDataAs() const
+      {
+        return cref().getDataAs<T>();
+      }
+
+      /**
+       * @brief Get the array data as a specific type for writing. Duplicates the array if it is shared or borrowed.
+       * @tparam T Type
+       * @return Pointer to the array data
+       */
+      template<typename T>
+      [[nodiscard]] T* getDataAs()
+      {
+        return ref().getDataAs<T>();
+      }
+
+      /// @brief Makes the array unique by duplicating it if it is shared or borrowed.
+      void makeUnique()
+      {
+        checkValid("matlabw:mx:SharedArray:makeUnique");
+
+        if (!isUnique())
+        {
+          mOwned    = std::make_shared<Array>(ArrayCref{get()});
+          mBorrowed = nullptr;
+        }
+      }
+
+      /**
+       * @brief Releases the handle and returns an owning array, e.g. to be returned from a MEX function. If the array is
+       *        unique, it is moved without a copy, otherwise it is duplicated.
+       * @return The array.
+       */
+      [[nodiscard]] Array release()
+      {
+        if (!isValid())
+        {
+          return Array{};
+        }
+
+        makeUnique();
+
+        Array array{std::move(*mOwned)};
+        mOwned.reset();
+
+        return array;
+      }
+
+      /**
+       * @brief Get the mxArray pointer
+       * @return mxArray pointer
+       */
+      [[nodiscard]] const mxArray* get() const noexcept
+      {
+        return (mOwned != nullptr) ? mOwned->get() : mBorrowed;
+      }
+
+      /**
+       * @brief Convert to ArrayCref
+       * @return ArrayCref
+       */
+      [[nodiscard]] operator ArrayCref() const
+      {
+        return cref();
+      }
+    private:
+      /**
+       * @brief Check if the handle is valid
+       * @param id Function ID
+       */
+      void checkValid(const char* id) const
+      {
+        if (!isValid())
+        {
+          throw Exception{id, "accessing invalid array"};
+        }
+      }
+
+      std::shared_ptr<Array> mOwned{};    ///< Shared owned array
+      const mxArray*         mBorrowed{}; ///< Borrowed array
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_SHARED_ARRAY_HPP */
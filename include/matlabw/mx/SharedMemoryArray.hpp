@@ -0,0 +1,684 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_SHARED_MEMORY_ARRAY_HPP
+#define MATLABW_MX_SHARED_MEMORY_ARRAY_HPP
+
+#include "detail/include.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+# define MATLABW_SHARED_MEMORY_POSIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#elif defined(_WIN32)
+# define MATLABW_SHARED_MEMORY_WIN32
+# ifndef NOMINMAX
+#   define NOMINMAX
+# endif
+# include <windows.h>
+#endif
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "CharArray.hpp"
+#include "codec.hpp"
+#include "LogicalArray.hpp"
+#include "MdSpan.hpp"
+#include "NumericArray.hpp"
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /// @brief Identifies a shared memory array segment.
+  inline constexpr std::uint32_t sharedMemoryMagic{0x4d57534d};
+
+  /// @brief Version of the segment layout.
+  inline constexpr std::uint32_t sharedMemoryVersion{2};
+
+  /// @brief Maximum rank of a shared memory array.
+  inline constexpr std::size_t sharedMemoryMaxRank{32};
+
+  /// @brief Header of a shared memory array segment, the payload follows at payloadOffset.
+  struct SharedMemoryHeader
+  {
+    std::uint32_t              magic;                     ///< sharedMemoryMagic once initialized.
+    std::uint32_t              version;                   ///< sharedMemoryVersion.
+    std::uint64_t              capacity;                  ///< Capacity of the payload in bytes.
+    std::atomic<std::uint64_t> sequence;                  ///< Odd while an array is published, 0 before the first.
+    std::uint32_t              classId;                   ///< The class ID of the array.
+    std::uint32_t              complex;                   ///< 1 if the array is complex, 0 otherwise.
+    std::uint64_t              rank;                      ///< The number of dimensions.
+    std::uint64_t              dims[sharedMemoryMaxRank]; ///< The dimensions.
+    std::uint64_t              bytes;                     ///< The size of the array data in bytes.
+    std::uint32_t              codec;                     ///< The Codec of the payload.
+    std::uint32_t              reserved;                  ///< Zero.
+    std::uint64_t              payloadBytes;              ///< The size of the payload in bytes.
+  };
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "sequence counter must be lock-free");
+
+  /// @brief Offset of the payload, aligned to a cache line.
+  inline constexpr std::size_t sharedMemoryPayloadOffset{(sizeof(SharedMemoryHeader) + 63) & ~std::size_t{63}};
+
+  /// @brief Named shared memory mapping, POSIX shared memory or a Windows file mapping.
+  class SharedMemoryMapping
+  {
+    public:
+      /// @brief Default constructor, nothing is mapped.
+      SharedMemoryMapping() = default;
+
+      /**
+       * @brief Creates and maps a segment, an existing segment of the same name is resized and reused.
+       * @param name The name of the segment. On POSIX a leading slash is added if missing.
+       * @param size The size in bytes.
+       */
+      SharedMemoryMapping(const char* name, std::size_t size)
+      : mName{getSystemName(name)},
+        mSize{size},
+        mOwner{true}
+      {
+        static constexpr char id[]{"matlabw:mx:SharedMemoryArray:create"};
+
+#     if defined(MATLABW_SHARED_MEMORY_POSIX)
+        const int fd = shm_open(mName.c_str(), O_CREAT | O_RDWR, 0600);
+
+        if (fd < 0)
+        {
+          throw Exception{id, "failed to create shared memory segment"};
+        }
+
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+          close(fd);
+          shm_unlink(mName.c_str());
+          throw Exception{id, "failed to resize shared memory segment"};
+        }
+
+        map(id, fd);
+#     elif defined(MATLABW_SHARED_MEMORY_WIN32)
+        mHandle = CreateFileMappingA(INVALID_HANDLE_VALUE,
+                                     nullptr,
+                                     PAGE_READWRITE,
+                                     static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+                                     static_cast<DWORD>(size & 0xffffffff),
+                                     mName.c_str());
+
+        if (mHandle == nullptr)
+        {
+          throw Exception{id, "failed to create shared memory segment"};
+        }
+
+        map(id);
+#     else
+        throw Exception{id, "shared memory is not supported on this platform"};
+#     endif
+      }
+
+      /**
+       * @brief Maps an existing segment.
+       * @param name The name of the segment. On POSIX a leading slash is added if missing.
+       */
+      explicit SharedMemoryMapping(const char* name)
+      : mName{getSystemName(name)}
+      {
+        static constexpr char id[]{"matlabw:mx:SharedMemoryArray:open"};
+
+#     if defined(MATLABW_SHARED_MEMORY_POSIX)
+        const int fd = shm_open(mName.c_str(), O_RDWR, 0600);
+
+        if (fd < 0)
+        {
+          throw Exception{id, "failed to open shared memory segment"};
+        }
+
+        struct stat st{};
+
+        if (fstat(fd, &st) != 0)
+        {
+          close(fd);
+          throw Exception{id, "failed to get the size of shared memory segment"};
+        }
+
+        mSize = static_cast<std::size_t>(st.st_size);
+
+        map(id, fd);
+#     elif defined(MATLABW_SHARED_MEMORY_WIN32)
+        mHandle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mName.c_str());
+
+        if (mHandle == nullptr)
+        {
+          throw Exception{id, "failed to open shared memory segment"};
+        }
+
+        map(id);
+
+        MEMORY_BASIC_INFORMATION info{};
+
+        VirtualQuery(mData, &info, sizeof(info));
+
+        mSize = static_cast<std::size_t>(info.RegionSize);
+#     else
+        throw Exception{id, "shared memory is not supported on this platform"};
+#     endif
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      SharedMemoryMapping(const SharedMemoryMapping&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other mapping.
+       */
+      SharedMemoryMapping(SharedMemoryMapping&& other) noexcept
+      : mName{std::move(other.mName)},
+        mData{std::exchange(other.mData, nullptr)},
+        mSize{std::exchange(other.mSize, 0)},
+        mOwner{std::exchange(other.mOwner, false)}
+#     ifdef MATLABW_SHARED_MEMORY_WIN32
+        , mHandle{std::exchange(other.mHandle, nullptr)}
+#     endif
+      {}
+
+      /// @brief Destructor, unmaps the segment. The creator also removes its name.
+      ~SharedMemoryMapping()
+      {
+#     if defined(MATLABW_SHARED_MEMORY_POSIX)
+        if (mData != nullptr)
+        {
+          munmap(mData, mSize);
+
+          if (mOwner)
+          {
+            shm_unlink(mName.c_str());
+          }
+        }
+#     elif defined(MATLABW_SHARED_MEMORY_WIN32)
+        if (mData != nullptr)
+        {
+          UnmapViewOfFile(mData);
+        }
+
+        if (mHandle != nullptr)
+        {
+          CloseHandle(mHandle);
+        }
+#     endif
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      SharedMemoryMapping& operator=(const SharedMemoryMapping&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      SharedMemoryMapping& operator=(SharedMemoryMapping&&) = delete;
+
+      /**
+       * @brief Gets the mapped memory.
+       * @return The mapped memory.
+       */
+      [[nodiscard]] void* getData() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Gets the size of the mapping.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+    private:
+      /**
+       * @brief Gets the name used by the system, POSIX names must start with a slash.
+       * @param name The name.
+       * @return The system name.
+       */
+      [[nodiscard]] static std::string getSystemName(const char* name)
+      {
+        if (name == nullptr || *name == '\0')
+        {
+          throw Exception{"matlabw:mx:SharedMemoryArray:invalidName", "shared memory name must not be empty"};
+        }
+
+#     ifdef MATLABW_SHARED_MEMORY_POSIX
+        return (*name == '/') ? std::string{name} : '/' + std::string{name};
+#     else
+        return std::string{name};
+#     endif
+      }
+
+#   if defined(MATLABW_SHARED_MEMORY_POSIX)
+      /**
+       * @brief Maps the segment and closes its descriptor.
+       * @param id The error identifier.
+       * @param fd The descriptor of the segment.
+       */
+      void map(const char* id, int fd)
+      {
+        void* data = mmap(nullptr, mSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+          if (mOwner)
+          {
+            shm_unlink(mName.c_str());
+          }
+
+          throw Exception{id, "failed to map shared memory segment"};
+        }
+
+        mData = data;
+      }
+#   elif defined(MATLABW_SHARED_MEMORY_WIN32)
+      /**
+       * @brief Maps the whole segment.
+       * @param id The error identifier.
+       */
+      void map(const char* id)
+      {
+        mData = MapViewOfFile(mHandle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+
+        if (mData == nullptr)
+        {
+          CloseHandle(std::exchange(mHandle, nullptr));
+          throw Exception{id, "failed to map shared memory segment"};
+        }
+      }
+#   endif
+
+      std::string mName{};         ///< The system name of the segment.
+      void*       mData{};         ///< The mapped memory.
+      std::size_t mSize{};         ///< The size of the mapping in bytes.
+      bool        mOwner{};        ///< True if the mapping created the segment.
+#   ifdef MATLABW_SHARED_MEMORY_WIN32
+      HANDLE      mHandle{};       ///< The file mapping handle.
+#   endif
+  };
+} // namespace detail
+
+  /**
+   * @brief Zero-copy view of a shared memory array. The publisher may overwrite the data at any time, check
+   *        SharedMemoryArray::isCurrent() with the sequence after reading to detect that.
+   * @tparam T The element type.
+   */
+  template<typename T>
+  struct SharedMemoryView
+  {
+    View<T>                  data;     ///< The elements in column-major order.
+    std::vector<std::size_t> dims;     ///< The dimensions.
+    std::uint64_t            sequence; ///< The sequence of the viewed array.
+
+    /**
+     * @brief Gets a multidimensional view of the data.
+     * @tparam Rank The rank, missing dimensions are 1 and excess ones are folded into the last extent.
+     * @return The view.
+     */
+    template<std::size_t Rank>
+    [[nodiscard]] MdSpan<const T, DExtents<Rank>> toMdspan() const
+    {
+      return detail::makeMdspan<const T, DExtents<Rank>>(data.data(), dims);
+    }
+  };
+
+  /**
+   * @brief Dense numeric, logical or char array exchanged through named shared memory, e.g. between a MEX file and an
+   *        external process. One side publishes arrays and any number of readers map or copy them. A sequence counter,
+   *        odd while an array is being published, lets readers detect torn reads without locks. A single publisher
+   *        at a time is supported.
+   */
+  class SharedMemoryArray
+  {
+    public:
+      /**
+       * @brief Creates the segment, its name is removed when this object is destroyed.
+       * @param name The name of the segment.
+       * @param capacity The capacity of the payload in bytes.
+       */
+      SharedMemoryArray(const char* name, std::size_t capacity)
+      : mMapping{name, detail::sharedMemoryPayloadOffset + capacity}
+      {
+        auto* header = new (mMapping.getData()) detail::SharedMemoryHeader{};
+
+        header->capacity = capacity;
+        header->version  = detail::sharedMemoryVersion;
+        header->sequence.store(0, std::memory_order_relaxed);
+
+        std::atomic_ref<std::uint32_t>{header->magic}.store(detail::sharedMemoryMagic, std::memory_order_release);
+      }
+
+      /**
+       * @brief Opens a segment created by another process or object.
+       * @param name The name of the segment.
+       */
+      explicit SharedMemoryArray(const char* name)
+      : mMapping{name}
+      {
+        static constexpr char id[]{"matlabw:mx:SharedMemoryArray:open"};
+
+        if (mMapping.getSize() < detail::sharedMemoryPayloadOffset)
+        {
+          throw Exception{id, "shared memory segment is too small"};
+        }
+
+        const auto* header = getHeader();
+
+        if (std::atomic_ref<const std::uint32_t>{header->magic}.load(std::memory_order_acquire)
+              != detail::sharedMemoryMagic || header->version != detail::sharedMemoryVersion)
+        {
+          throw Exception{id, "shared memory segment is not a shared memory array"};
+        }
+
+        if (mMapping.getSize() < detail::sharedMemoryPayloadOffset + header->capacity)
+        {
+          throw Exception{id, "shared memory segment is truncated"};
+        }
+      }
+
+      /**
+       * @brief Gets the capacity of the payload.
+       * @return The capacity in bytes.
+       */
+      [[nodiscard]] std::size_t getCapacity() const noexcept
+      {
+        return static_cast<std::size_t>(getHeader()->capacity);
+      }
+
+      /**
+       * @brief Gets the sequence of the last published array.
+       * @return The sequence, even, 0 if nothing was published yet.
+       */
+      [[nodiscard]] std::uint64_t getSequence() const noexcept
+      {
+        return getHeader()->sequence.load(std::memory_order_acquire) & ~std::uint64_t{1};
+      }
+
+      /**
+       * @brief Checks if the array of a sequence is still published and was not modified, e.g. after reading a view.
+       * @param sequence The sequence.
+       * @return True if no other array was published since.
+       */
+      [[nodiscard]] bool isCurrent(std::uint64_t sequence) const noexcept
+      {
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return getHeader()->sequence.load(std::memory_order_relaxed) == sequence;
+      }
+
+      /**
+       * @brief Publishes an array, readers see either the previous or the new array.
+       * @param array The dense numeric, logical or char array.
+       */
+      void publish(ArrayCref array)
+      {
+        publish(array, EncodedPayload{});
+      }
+
+      /**
+       * @brief Publishes an array with its payload encoded if it is compressible, see compress(). Readers decode it in
+       *        materialize(), zero-copy views of an encoded array are not available.
+       * @param array The dense numeric, logical or char array.
+       * @param options The codec options.
+       */
+      void publish(ArrayCref array, const CodecOptions& options)
+      {
+        publish(array, compress(array, options));
+      }
+
+      /**
+       * @brief Copies the published array with one memcpy of the payload, retried if an array is published meanwhile.
+       *        An encoded payload is copied out first and decoded once the copy is known to be consistent.
+       * @return The array.
+       */
+      [[nodiscard]] Array materialize() const
+      {
+        static constexpr char id[]{"matlabw:mx:SharedMemoryArray:materialize"};
+
+        const auto* header = getHeader();
+
+        while (true)
+        {
+          const std::uint64_t sequence = header->sequence.load(std::memory_order_acquire);
+
+          if (sequence == 0)
+          {
+            throw Exception{id, "no array was published"};
+          }
+
+          if (sequence & 1)
+          {
+            std::this_thread::yield();
+            continue;
+          }
+
+          const auto        classId = static_cast<ClassId>(header->classId);
+          const bool        complex = (header->complex != 0);
+          const std::size_t rank    = std::min<std::size_t>(header->rank, detail::sharedMemoryMaxRank);
+          const std::size_t bytes   = header->bytes;
+          const auto        codec   = static_cast<Codec>(header->codec);
+          const std::size_t payload = std::min<std::size_t>(header->payloadBytes, getCapacity());
+
+          std::size_t dims[detail::sharedMemoryMaxRank]{};
+          std::copy_n(header->dims, rank, dims);
+
+          if (!isCurrent(sequence))
+          {
+            continue;
+          }
+
+          Array array = makeArray(classId, complex, View<std::size_t>{dims, rank});
+
+          if (bytes != array.getSize() * array.getSizeOfElement() || (codec == Codec::raw && payload != bytes))
+          {
+            throw Exception{id, "shared memory segment is corrupted"};
+          }
+
+          if (codec != Codec::raw)
+          {
+            std::vector<std::byte> encoded(payload);
+
+            std::memcpy(encoded.data(), getPayload(), payload);
+
+            if (isCurrent(sequence))
+            {
+              decode(View<std::byte>{encoded.data(), encoded.size()}, codec, array);
+
+              return array;
+            }
+
+            continue;
+          }
+
+          if (bytes > 0)
+          {
+            std::memcpy(array.getData(), getPayload(), bytes);
+          }
+
+          if (isCurrent(sequence))
+          {
+            return array;
+          }
+        }
+      }
+
+      /**
+       * @brief Gets a zero-copy view of the published array, waiting for a publish in progress to finish.
+       * @tparam T The element type, must match the class and complexity of the array.
+       * @return The view, valid as long as this object. Check isCurrent() with its sequence after reading.
+       */
+      template<typename T>
+      [[nodiscard]] SharedMemoryView<T> getView() const
+      {
+        static constexpr char id[]{"matlabw:mx:SharedMemoryArray:getView"};
+
+        const auto* header = getHeader();
+
+        while (true)
+        {
+          const std::uint64_t sequence = header->sequence.load(std::memory_order_acquire);
+
+          if (sequence == 0)
+          {
+            throw Exception{id, "no array was published"};
+          }
+
+          if (sequence & 1)
+          {
+            std::this_thread::yield();
+            continue;
+          }
+
+          const auto        classId = static_cast<ClassId>(header->classId);
+          const bool        complex = (header->complex != 0);
+          const std::size_t rank    = std::min<std::size_t>(header->rank, detail::sharedMemoryMaxRank);
+          const std::size_t bytes   = std::min<std::size_t>(header->bytes, getCapacity());
+          const auto        codec   = static_cast<Codec>(header->codec);
+
+          std::vector<std::size_t> dims(header->dims, header->dims + rank);
+
+          if (!isCurrent(sequence))
+          {
+            continue;
+          }
+
+          if (classId != TypeProperties<T>::classId || complex != isComplexNumeric<T>)
+          {
+            throw Exception{id, "element type must match the class of the array"};
+          }
+
+          if (codec != Codec::raw)
+          {
+            throw Exception{id, "array is encoded, use materialize()"};
+          }
+
+          return SharedMemoryView<T>{View<T>{static_cast<const T*>(getPayload()), bytes / sizeof(T)},
+                                     std::move(dims),
+                                     sequence};
+        }
+      }
+
+    private:
+      /**
+       * @brief Publishes an array with a prepared payload.
+       * @param array The dense numeric, logical or char array.
+       * @param payload The encoded payload, raw for the array data.
+       */
+      void publish(ArrayCref array, const EncodedPayload& payload)
+      {
+        static constexpr char id[]{"matlabw:mx:SharedMemoryArray:publish"};
+
+        if (array.isSparse() || (!array.isNumeric() && array.getClassId() != ClassId::logical &&
+                                 array.getClassId() != ClassId::_char))
+        {
+          throw Exception{id, "array must be a dense numeric, logical or char array"};
+        }
+
+        if (array.getRank() > detail::sharedMemoryMaxRank)
+        {
+          throw Exception{id, "array rank exceeds the maximum of the segment"};
+        }
+
+        const std::size_t bytes        = array.getSize() * array.getSizeOfElement();
+        const bool        encoded      = (payload.codec != Codec::raw);
+        const std::size_t payloadBytes = (encoded) ? payload.bytes.size() : bytes;
+
+        if (payloadBytes > getCapacity())
+        {
+          throw Exception{id, "array exceeds the capacity of the segment"};
+        }
+
+        auto*               header   = getHeader();
+        const std::uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+
+        header->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        header->classId = static_cast<std::uint32_t>(array.getClassId());
+        header->complex = array.isComplex() ? 1 : 0;
+        header->rank    = array.getRank();
+        header->bytes   = bytes;
+        header->codec   = static_cast<std::uint32_t>(payload.codec);
+        std::copy(array.getDims().begin(), array.getDims().end(), header->dims);
+
+        header->payloadBytes = payloadBytes;
+
+        if (payloadBytes > 0)
+        {
+          std::memcpy(getPayload(), (encoded) ? payload.bytes.data() : array.getData(), payloadBytes);
+        }
+
+        header->sequence.store(sequence + 2, std::memory_order_release);
+      }
+
+      /**
+       * @brief Creates an uninitialized array of the published class.
+       * @param classId The class ID.
+       * @param complex True if complex.
+       * @param dims The dimensions.
+       * @return The array.
+       */
+      [[nodiscard]] static Array makeArray(ClassId classId, bool complex, View<std::size_t> dims)
+      {
+        switch (classId)
+        {
+          case ClassId::logical:
+            return makeLogicalArray(dims);
+          case ClassId::_char:
+            return makeCharArray(dims);
+          default:
+            return makeUninitNumericArray(dims, classId, (complex) ? Complexity::complex : Complexity::real);
+        }
+      }
+
+      /**
+       * @brief Gets the header of the segment.
+       * @return The header.
+       */
+      [[nodiscard]] detail::SharedMemoryHeader* getHeader() const noexcept
+      {
+        return static_cast<detail::SharedMemoryHeader*>(mMapping.getData());
+      }
+
+      /**
+       * @brief Gets the payload of the segment.
+       * @return The payload.
+       */
+      [[nodiscard]] void* getPayload() const noexcept
+      {
+        return static_cast<std::byte*>(mMapping.getData()) + detail::sharedMemoryPayloadOffset;
+      }
+
+      detail::SharedMemoryMapping mMapping; ///< The mapping of the segment.
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_SHARED_MEMORY_ARRAY_HPP */
@@ -0,0 +1,761 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_SPARSE_ARRAY_HPP
+#define MATLABW_MX_SPARSE_ARRAY_HPP
+
+#include "detail/include.hpp"
+
+#include "Array.hpp"
+#include "ArrayRef.hpp"
+#include "common.hpp"
+#include "Exception.hpp"
+#include "LogicalArray.hpp"
+#include "NumericArray.hpp"
+#include "TypedArrayRef.hpp"
+#include "typeTraits.hpp"
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /// @brief Checks if a type is an element type of MATLAB sparse arrays.
+  template<typename T>
+  inline constexpr bool isSparseType = std::is_same_v<T, double>
+                                       || std::is_same_v<T, std::complex<double>>
+                                       || std::is_same_v<T, bool>;
+
+  /**
+   * @brief Checks if the array is a sparse array of the element type.
+   * @tparam T Element type
+   * @param array mxArray pointer
+   */
+  template<typename T>
+  void checkSparseArray(const mxArray* array)
+  {
+    checkArrayClass<TypeProperties<T>::classId>(array);
+
+    if (!mxIsSparse(array))
+    {
+      throw Exception{"array is not sparse"};
+    }
+
+    if (mxIsComplex(array) != isComplexNumeric<T>)
+    {
+      throw Exception{"invalid array complexity"};
+    }
+  }
+
+  /**
+   * @brief Gets the number of nonzeros of a sparse array.
+   * @param array mxArray pointer
+   * @return The number of nonzeros
+   */
+  [[nodiscard]] inline std::size_t getSparseNnz(const mxArray* array)
+  {
+    return static_cast<std::size_t>(mxGetJc(array)[mxGetN(array)]);
+  }
+
+  /**
+   * @brief Changes the capacity of a sparse array, the stored nonzeros are kept.
+   * @tparam T Element type
+   * @param array mxArray pointer
+   * @param nzmax The new capacity, at least the number of nonzeros
+   */
+  template<typename T>
+  void setSparseNzmax(mxArray* array, std::size_t nzmax)
+  {
+    static constexpr char id[]{"matlabw:mx:SparseArray:setNzmax"};
+
+    if (nzmax < getSparseNnz(array))
+    {
+      throw Exception{id, "capacity must not be smaller than the number of nonzeros"};
+    }
+
+    // MATLAB requires room for at least one element.
+    nzmax = std::max<std::size_t>(nzmax, 1);
+
+    if (nzmax == static_cast<std::size_t>(mxGetNzmax(array)))
+    {
+      return;
+    }
+
+    if (nzmax > std::numeric_limits<std::size_t>::max() / std::max(sizeof(T), sizeof(mwIndex)))
+    {
+      throw std::bad_alloc();
+    }
+
+    void* ir = mxRealloc(mxGetIr(array), nzmax * sizeof(mwIndex));
+
+    if (ir == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+
+    mxSetIr(array, static_cast<mwIndex*>(ir));
+
+    void* data = mxRealloc(mxGetData(array), nzmax * sizeof(T));
+
+    if (data == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+
+    mxSetData(array, data);
+    mxSetNzmax(array, nzmax);
+  }
+} // namespace detail
+
+  /**
+   * @brief Zero-copy view of a sparse matrix in compressed sparse column format. The row indices of column j are
+   *        rowIdx[colPtr[j]] to rowIdx[colPtr[j + 1] - 1], sorted ascending, values are stored alongside.
+   * @tparam T Element type, const-qualified for read-only views
+   */
+  template<typename T>
+  struct CscView
+  {
+    using value_type = T;                                                               ///< Element type
+    using index_type = std::conditional_t<std::is_const_v<T>, const mwIndex, mwIndex>; ///< Index type
+
+    std::size_t            rows{};   ///< Number of rows
+    std::size_t            cols{};   ///< Number of columns
+    std::span<index_type>  colPtr{}; ///< Column start offsets, cols + 1 entries
+    std::span<index_type>  rowIdx{}; ///< Row indices, one per nonzero
+    std::span<T>           values{}; ///< Values, one per nonzero
+
+    /**
+     * @brief Gets the number of nonzeros.
+     * @return The number of nonzeros
+     */
+    [[nodiscard]] std::size_t getNnz() const noexcept
+    {
+      return values.size();
+    }
+  };
+
+namespace detail
+{
+  /**
+   * @brief Creates a CSC view of a sparse array.
+   * @tparam T Element type, const-qualified for read-only views
+   * @param array mxArray pointer
+   * @return The view
+   */
+  template<typename T>
+  [[nodiscard]] CscView<T> makeCscView(const mxArray* array)
+  {
+    using Index = typename CscView<T>::index_type;
+
+    const std::size_t cols = mxGetN(array);
+    const std::size_t nnz  = getSparseNnz(array);
+
+    return CscView<T>{mxGetM(array),
+                      cols,
+                      std::span<Index>{mxGetJc(array), cols + 1},
+                      std::span<Index>{mxGetIr(array), nnz},
+                      std::span<T>{static_cast<T*>(mxGetData(array)), nnz}};
+  }
+} // namespace detail
+
+  /**
+   * @brief Sparse array const reference class.
+   * @tparam T Element type, double, std::complex<double> or bool
+   */
+  template<typename T>
+  class SparseArrayCref : public ArrayCref
+  {
+    static_assert(detail::isSparseType<T>, "T must be double, std::complex<double> or bool");
+
+    public:
+      using value_type = T; ///< Element type
+
+      /// @brief Class ID
+      static constexpr ClassId classId = TypeProperties<T>::classId;
+
+      /// @brief Explicitly deleted default constructor.
+      SparseArrayCref() = delete;
+
+      /**
+       * @brief Constructor from a mxArray pointer.
+       * @param array mxArray pointer
+       */
+      explicit SparseArrayCref(const mxArray* array)
+      : ArrayCref{(detail::checkSparseArray<T>(array), array)}
+      {}
+
+      /**
+       * @brief Constructor from an ArrayCref.
+       * @param other ArrayCref
+       */
+      explicit SparseArrayCref(const ArrayCref& other)
+      : SparseArrayCref{other.get()}
+      {}
+
+      /**
+       * @brief Constructor from an ArrayRef.
+       * @param other ArrayRef
+       */
+      explicit SparseArrayCref(const ArrayRef& other)
+      : SparseArrayCref{other.get()}
+      {}
+
+      /**
+       * @brief Gets the number of nonzeros.
+       * @return The number of nonzeros
+       */
+      [[nodiscard]] std::size_t getNnz() const
+      {
+        return detail::getSparseNnz(get());
+      }
+
+      /**
+       * @brief Gets the capacity for nonzeros.
+       * @return The capacity
+       */
+      [[nodiscard]] std::size_t getNzmax() const
+      {
+        return mxGetNzmax(get());
+      }
+
+      /**
+       * @brief Gets the column start offsets.
+       * @return The offsets, getDimN() + 1 entries
+       */
+      [[nodiscard]] View<mwIndex> getColPtr() const
+      {
+        return getCsc().colPtr;
+      }
+
+      /**
+       * @brief Gets the row indices of the nonzeros.
+       * @return The row indices
+       */
+      [[nodiscard]] View<mwIndex> getRowIdx() const
+      {
+        return getCsc().rowIdx;
+      }
+
+      /**
+       * @brief Gets the values of the nonzeros.
+       * @return The values
+       */
+      [[nodiscard]] View<T> getValues() const
+      {
+        return getCsc().values;
+      }
+
+      /**
+       * @brief Gets the CSC view.
+       * @return The view
+       */
+      [[nodiscard]] CscView<const T> getCsc() const
+      {
+        return detail::makeCscView<const T>(get());
+      }
+  };
+
+  /**
+   * @brief Sparse array reference class.
+   * @tparam T Element type, double, std::complex<double> or bool
+   */
+  template<typename T>
+  class SparseArrayRef : public ArrayRef
+  {
+    static_assert(detail::isSparseType<T>, "T must be double, std::complex<double> or bool");
+
+    public:
+      using value_type = T; ///< Element type
+
+      /// @brief Class ID
+      static constexpr ClassId classId = TypeProperties<T>::classId;
+
+      /// @brief Explicitly deleted default constructor.
+      SparseArrayRef() = delete;
+
+      /**
+       * @brief Constructor from a mxArray pointer.
+       * @param array mxArray pointer
+       */
+      explicit SparseArrayRef(mxArray* array)
+      : ArrayRef{(detail::checkSparseArray<T>(array), array)}
+      {}
+
+      /**
+       * @brief Constructor from an ArrayRef.
+       * @param other ArrayRef
+       */
+      explicit SparseArrayRef(const ArrayRef& other)
+      : SparseArrayRef{other.get()}
+      {}
+
+      /**
+       * @brief Gets the number of nonzeros.
+       * @return The number of nonzeros
+       */
+      [[nodiscard]] std::size_t getNnz() const
+      {
+        return detail::getSparseNnz(get());
+      }
+
+      /**
+       * @brief Gets the capacity for nonzeros.
+       * @return The capacity
+       */
+      [[nodiscard]] std::size_t getNzmax() const
+      {
+        return mxGetNzmax(get());
+      }
+
+      /**
+       * @brief Changes the capacity for nonzeros, the stored nonzeros are kept. Set the column offsets after adding
+       *        nonzeros to the grown storage.
+       * @param nzmax The new capacity, at least the number of nonzeros
+       */
+      void setNzmax(std::size_t nzmax) const
+      {
+        detail::setSparseNzmax<T>(get(), nzmax);
+      }
+
+      /// @brief Shrinks the capacity to the number of nonzeros.
+      void shrinkToFit() const
+      {
+        setNzmax(getNnz());
+      }
+
+      /**
+       * @brief Gets the column start offsets.
+       * @return The offsets, getDimN() + 1 entries
+       */
+      [[nodiscard]] Span<mwIndex> getColPtr() const
+      {
+        return getCsc().colPtr;
+      }
+
+      /**
+       * @brief Gets the row indices of the nonzeros.
+       * @return The row indices
+       */
+      [[nodiscard]] Span<mwIndex> getRowIdx() const
+      {
+        return getCsc().rowIdx;
+      }
+
+      /**
+       * @brief Gets the values of the nonzeros.
+       * @return The values
+       */
+      [[nodiscard]] Span<T> getValues() const
+      {
+        return getCsc().values;
+      }
+
+      /**
+       * @brief Gets the CSC view.
+       * @return The view
+       */
+      [[nodiscard]] CscView<T> getCsc() const
+      {
+        return detail::makeCscView<T>(get());
+      }
+
+      /**
+       * @brief Gets the storage for nonzeros, all getNzmax() entries, e.g. to fill the matrix column by column.
+       * @return The view, values and row indices span the whole capacity
+       */
+      [[nodiscard]] CscView<T> getStorage() const
+      {
+        CscView<T> view = getCsc();
+
+        view.rowIdx = Span<mwIndex>{mxGetIr(get()), getNzmax()};
+        view.values = Span<T>{static_cast<T*>(mxGetData(get())), getNzmax()};
+
+        return view;
+      }
+
+      /**
+       * @brief Conversion operator to SparseArrayCref.
+       * @return Const reference to the array
+       */
+      [[nodiscard]] operator SparseArrayCref<T>() const
+      {
+        return SparseArrayCref<T>{get()};
+      }
+  };
+
+  /**
+   * @brief Sparse array class.
+   * @tparam T Element type, double, std::complex<double> or bool
+   */
+  template<typename T>
+  class SparseArray : public Array
+  {
+    static_assert(detail::isSparseType<T>, "T must be double, std::complex<double> or bool");
+
+    public:
+      using value_type = T; ///< Element type
+
+      /// @brief Class ID
+      static constexpr ClassId classId = TypeProperties<T>::classId;
+
+      /// @brief Default constructor
+      SparseArray() noexcept = default;
+
+      /// @brief Explicitly deleted constructor from nullptr.
+      SparseArray(std::nullptr_t) = delete;
+
+      /**
+       * @brief Constructor
+       * @param array mxArray pointer (rvalue reference)
+       */
+      explicit SparseArray(mxArray*&& array)
+      : Array{(detail::checkSparseArray<T>(array), std::move(array))}
+      {}
+
+      /**
+       * @brief Copy constructor from const reference
+       * @param other Const reference to other array
+       */
+      explicit SparseArray(const ArrayCref& other)
+      : Array{(detail::checkSparseArray<T>(other.get()), other)}
+      {}
+
+      /**
+       * @brief Copy constructor
+       * @param other Other array
+       */
+      explicit SparseArray(const SparseArray& other) = default;
+
+      /**
+       * @brief Move constructor
+       * @param other Other array
+       */
+      SparseArray(SparseArray&& other) noexcept = default;
+
+      /// @brief Destructor
+      ~SparseArray() noexcept = default;
+
+      /**
+       * @brief Copy assignment operator
+       * @param other Other array
+       * @return Reference to this array
+       */
+      SparseArray& operator=(const SparseArray& other) = default;
+
+      /**
+       * @brief Move assignment operator
+       * @param other Other array
+       * @return Reference to this array
+       */
+      SparseArray& operator=(SparseArray&& other) noexcept = default;
+
+      /**
+       * @brief Gets the number of nonzeros.
+       * @return The number of nonzeros
+       */
+      [[nodiscard]] std::size_t getNnz() const
+      {
+        return SparseArrayCref<T>{get()}.getNnz();
+      }
+
+      /**
+       * @brief Gets the capacity for nonzeros.
+       * @return The capacity
+       */
+      [[nodiscard]] std::size_t getNzmax() const
+      {
+        return SparseArrayCref<T>{get()}.getNzmax();
+      }
+
+      /**
+       * @brief Changes the capacity for nonzeros, the stored nonzeros are kept.
+       * @param nzmax The new capacity, at least the number of nonzeros
+       */
+      void setNzmax(std::size_t nzmax)
+      {
+        SparseArrayRef<T>{get()}.setNzmax(nzmax);
+      }
+
+      /// @brief Shrinks the capacity to the number of nonzeros.
+      void shrinkToFit()
+      {
+        SparseArrayRef<T>{get()}.shrinkToFit();
+      }
+
+      /**
+       * @brief Gets the CSC view.
+       * @return The view
+       */
+      [[nodiscard]] CscView<T> getCsc()
+      {
+        return SparseArrayRef<T>{get()}.getCsc();
+      }
+
+      /**
+       * @brief Gets the CSC view.
+       * @return The read-only view
+       */
+      [[nodiscard]] CscView<const T> getCsc() const
+      {
+        return SparseArrayCref<T>{get()}.getCsc();
+      }
+
+      /**
+       * @brief Gets the storage for nonzeros, see SparseArrayRef::getStorage().
+       * @return The view, values and row indices span the whole capacity
+       */
+      [[nodiscard]] CscView<T> getStorage()
+      {
+        return SparseArrayRef<T>{get()}.getStorage();
+      }
+
+      /// @brief Use the Array::operator ArrayRef
+      using Array::operator ArrayRef;
+
+      /// @brief Use the Array::operator ArrayCref
+      using Array::operator ArrayCref;
+
+      /**
+       * @brief Conversion operator to SparseArrayRef
+       * @return Reference to the array
+       */
+      [[nodiscard]] operator SparseArrayRef<T>()
+      {
+        checkValid("matlabw:mx:SparseArray:operatorSparseArrayRef");
+        return SparseArrayRef<T>{get()};
+      }
+
+      /**
+       * @brief Conversion operator to SparseArrayCref
+       * @return Const reference to the array
+       */
+      [[nodiscard]] operator SparseArrayCref<T>() const
+      {
+        checkValid("matlabw:mx:SparseArray:operatorSparseArrayCref");
+        return SparseArrayCref<T>{get()};
+      }
+  };
+
+  /**
+   * @brief Creates an empty sparse matrix.
+   * @tparam T Element type, double, std::complex<double> or bool
+   * @param m Number of rows
+   * @param n Number of columns
+   * @param nzmax Capacity for nonzeros
+   * @return SparseArray
+   */
+  template<typename T>
+  [[nodiscard]] SparseArray<T> makeSparseArray(std::size_t m, std::size_t n, std::size_t nzmax)
+  {
+    static_assert(detail::isSparseType<T>, "T must be double, std::complex<double> or bool");
+
+    mxArray* array{};
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      array = mxCreateSparseLogicalMatrix(m, n, std::max<std::size_t>(nzmax, 1));
+    }
+    else
+    {
+      array = mxCreateSparse(m, n, std::max<std::size_t>(nzmax, 1), isComplexNumeric<T> ? mxCOMPLEX : mxREAL);
+    }
+
+    if (array == nullptr)
+    {
+      throw Exception{"failed to create sparse array"};
+    }
+
+    return SparseArray<T>{std::move(array)};
+  }
+
+  /**
+   * @brief Creates a sparse matrix from triplets like sparse(i, j, v) in MATLAB. Values of duplicate indices are
+   *        summed, logical values are or-ed.
+   * @tparam T Element type, double, std::complex<double> or bool
+   * @param m Number of rows
+   * @param n Number of columns
+   * @param rows Zero-based row indices
+   * @param cols Zero-based column indices
+   * @param values Values
+   * @return SparseArray
+   */
+  template<typename T>
+  [[nodiscard]] SparseArray<T> makeSparseArray(std::size_t       m,
+                                               std::size_t       n,
+                                               View<std::size_t> rows,
+                                               View<std::size_t> cols,
+                                               View<T>           values)
+  {
+    static constexpr char id[]{"matlabw:mx:makeSparseArray"};
+
+    if (rows.size() != values.size() || cols.size() != values.size())
+    {
+      throw Exception{id, "row indices, column indices and values must have the same length"};
+    }
+
+    // Counting sort of the triplets by column.
+    std::vector<std::size_t> colStart(n + 1);
+
+    for (std::size_t k{}; k < values.size(); ++k)
+    {
+      if (rows[k] >= m || cols[k] >= n)
+      {
+        throw Exception{id, "index out of range"};
+      }
+
+      ++colStart[cols[k] + 1];
+    }
+
+    std::partial_sum(colStart.begin(), colStart.end(), colStart.begin());
+
+    std::vector<std::size_t> order(values.size());
+    std::vector<std::size_t> next(colStart.begin(), colStart.end() - 1);
+
+    for (std::size_t k{}; k < values.size(); ++k)
+    {
+      order[next[cols[k]]++] = k;
+    }
+
+    SparseArray<T> array = makeSparseArray<T>(m, n, values.size());
+    CscView<T>     csc   = array.getStorage();
+
+    std::size_t nnz{};
+
+    for (std::size_t j{}; j < n; ++j)
+    {
+      const auto first = order.begin() + static_cast<std::ptrdiff_t>(colStart[j]);
+      const auto last  = order.begin() + static_cast<std::ptrdiff_t>(colStart[j + 1]);
+
+      std::sort(first, last, [&](std::size_t a, std::size_t b) { return rows[a] < rows[b]; });
+
+      csc.colPtr[j] = nnz;
+
+      for (auto it = first; it != last; ++it)
+      {
+        if (nnz > csc.colPtr[j] && csc.rowIdx[nnz - 1] == rows[*it])
+        {
+          if constexpr (std::is_same_v<T, bool>)
+          {
+            csc.values[nnz - 1] = csc.values[nnz - 1] || values[*it];
+          }
+          else
+          {
+            csc.values[nnz - 1] += values[*it];
+          }
+        }
+        else
+        {
+          csc.rowIdx[nnz] = rows[*it];
+          csc.values[nnz] = values[*it];
+          ++nnz;
+        }
+      }
+    }
+
+    csc.colPtr[n] = nnz;
+
+    return array;
+  }
+
+  /**
+   * @brief Converts a full matrix to a sparse matrix like sparse(A) in MATLAB, zeros are not stored.
+   * @tparam T Element type, double, std::complex<double> or bool
+   * @param full The full matrix
+   * @return SparseArray
+   */
+  template<typename T>
+  [[nodiscard]] SparseArray<T> toSparse(TypedArrayCref<T> full)
+  {
+    if (full.getRank() > 2)
+    {
+      throw Exception{"matlabw:mx:toSparse", "array must be 2-D"};
+    }
+
+    const std::size_t m    = full.getDimM();
+    const std::size_t n    = full.getDimN();
+    const T*          data = full.getData();
+    const std::size_t nnz  = static_cast<std::size_t>(std::count_if(data, data + m * n, [](const T& v)
+    {
+      return v != T{};
+    }));
+
+    SparseArray<T> array = makeSparseArray<T>(m, n, nnz);
+    CscView<T>     csc   = array.getStorage();
+
+    std::size_t k{};
+
+    for (std::size_t j{}; j < n; ++j)
+    {
+      csc.colPtr[j] = k;
+
+      for (std::size_t i{}; i < m; ++i)
+      {
+        if (data[i + j * m] != T{})
+        {
+          csc.rowIdx[k] = i;
+          csc.values[k] = data[i + j * m];
+          ++k;
+        }
+      }
+    }
+
+    csc.colPtr[n] = k;
+
+    return array;
+  }
+
+  /**
+   * @brief Converts a sparse matrix to a full matrix like full(S) in MATLAB.
+   * @tparam T Element type, double, std::complex<double> or bool
+   * @param sparse The sparse matrix
+   * @return The full matrix
+   */
+  template<typename T>
+  [[nodiscard]] TypedArray<T> toFull(SparseArrayCref<T> sparse)
+  {
+    const CscView<const T> csc = sparse.getCsc();
+
+    TypedArray<T> full{};
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      full = makeLogicalArray(csc.rows, csc.cols);
+    }
+    else
+    {
+      full = makeNumericArray<T>(csc.rows, csc.cols);
+    }
+
+    for (std::size_t j{}; j < csc.cols; ++j)
+    {
+      for (std::size_t k = csc.colPtr[j]; k < csc.colPtr[j + 1]; ++k)
+      {
+        full[csc.rowIdx[k] + j * csc.rows] = csc.values[k];
+      }
+    }
+
+    return full;
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_SPARSE_ARRAY_HPP */
@@ -0,0 +1,572 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_STATIC_SHAPE_HPP
+#define MATLABW_MX_STATIC_SHAPE_HPP
+
+#include "detail/include.hpp"
+
+#include <iterator>
+
+#include "Exception.hpp"
+#include "MdSpan.hpp"
+#include "TypedArrayRef.hpp"
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Shape known at compile time, e.g. StaticShape<3, 3> for rotation matrices or StaticShape<6> for 6-vectors.
+   * @tparam Dims The dimensions, all non-zero.
+   */
+  template<std::size_t... Dims>
+  struct StaticShape
+  {
+    static_assert(sizeof...(Dims) > 0, "shape must have at least one dimension");
+    static_assert(((Dims > 0) && ...), "dimensions must be non-zero");
+
+    using ExtentsType = Extents<Dims...>; ///< Extents of a single block
+
+    static constexpr std::size_t                   rank{sizeof...(Dims)};  ///< Number of dimensions
+    static constexpr std::size_t                   size{(Dims * ... * 1)}; ///< Number of elements
+    static constexpr std::array<std::size_t, rank> dims{Dims...};          ///< The dimensions
+
+    /**
+     * @brief Computes the column-major offset of an element.
+     * @tparam Indices Index types
+     * @param indices Zero based indices, one per dimension
+     * @return Offset in elements
+     */
+    template<typename... Indices>
+      requires (sizeof...(Indices) == rank && (std::is_convertible_v<Indices, std::size_t> && ...))
+    [[nodiscard]] static constexpr std::size_t getOffset(Indices... indices) noexcept
+    {
+      const std::array<std::size_t, rank> idx{static_cast<std::size_t>(indices)...};
+
+      std::size_t offset{};
+      std::size_t stride{1};
+
+      for (std::size_t r{}; r < rank; ++r)
+      {
+        offset += idx[r] * stride;
+        stride *= dims[r];
+      }
+
+      return offset;
+    }
+  };
+
+namespace detail
+{
+  /// @brief Checks if a type is a StaticShape.
+  template<typename T>
+  inline constexpr bool isStaticShape = false;
+
+  /// @brief Checks if a type is a StaticShape.
+  template<std::size_t... Dims>
+  inline constexpr bool isStaticShape<StaticShape<Dims...>> = true;
+
+  /**
+   * @brief Checks that the leading array dimensions match a static shape and gets the number of blocks of the shape
+   *        in the trailing dimensions. Missing dimensions are treated as 1.
+   * @tparam Shape The static shape
+   * @param id The error identifier
+   * @param dims The array dimensions
+   * @return The number of blocks
+   */
+  template<typename Shape>
+  [[nodiscard]] std::size_t getStaticPageCount(const char* id, View<std::size_t> dims)
+  {
+    for (std::size_t r{}; r < Shape::rank; ++r)
+    {
+      if (((r < dims.size()) ? dims[r] : 1) != Shape::dims[r])
+      {
+        throw Exception{id, "array dimensions do not match the static shape"};
+      }
+    }
+
+    std::size_t count{1};
+
+    for (std::size_t r{Shape::rank}; r < dims.size(); ++r)
+    {
+      count *= dims[r];
+    }
+
+    return count;
+  }
+} // namespace detail
+
+  /**
+   * @brief Non-owning view of a single block of a static shape, the extents and all offsets are compile-time
+   *        constants so loops over the block unroll and vectorize.
+   * @tparam T Element type, const-qualified for read-only views
+   * @tparam Shape The StaticShape
+   */
+  template<typename T, typename Shape>
+  class StaticView
+  {
+    static_assert(detail::isStaticShape<Shape>, "Shape must be a StaticShape");
+
+    public:
+      using element_type = T;                   ///< Element type
+      using value_type   = std::remove_cv_t<T>; ///< Value type
+      using shape_type   = Shape;               ///< Shape type
+      using pointer      = T*;                  ///< Pointer type
+      using reference    = T&;                  ///< Reference type
+      using iterator     = T*;                  ///< Iterator type
+
+      /**
+       * @brief Gets the rank.
+       * @return The rank
+       */
+      [[nodiscard]] static constexpr std::size_t rank() noexcept
+      {
+        return Shape::rank;
+      }
+
+      /**
+       * @brief Gets the extent.
+       * @param r The dimension
+       * @return The extent
+       */
+      [[nodiscard]] static constexpr std::size_t extent(std::size_t r) noexcept
+      {
+        return Shape::dims[r];
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements
+       */
+      [[nodiscard]] static constexpr std::size_t size() noexcept
+      {
+        return Shape::size;
+      }
+
+      /// @brief Default constructor.
+      constexpr StaticView() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param data Pointer to Shape::size contiguous elements
+       */
+      constexpr explicit StaticView(pointer data) noexcept
+      : mData{data}
+      {}
+
+      /**
+       * @brief Converting constructor, adds const.
+       * @tparam U Other element type
+       * @param other Other view
+       */
+      template<typename U>
+        requires std::is_convertible_v<U(*)[], T(*)[]>
+      constexpr StaticView(const StaticView<U, Shape>& other) noexcept
+      : mData{other.data()}
+      {}
+
+      /**
+       * @brief Gets the pointer to the data.
+       * @return Pointer to the first element
+       */
+      [[nodiscard]] constexpr pointer data() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Gets an iterator to the first element.
+       * @return The iterator
+       */
+      [[nodiscard]] constexpr iterator begin() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Gets an iterator past the last element.
+       * @return The iterator
+       */
+      [[nodiscard]] constexpr iterator end() const noexcept
+      {
+        return mData + Shape::size;
+      }
+
+      /**
+       * @brief Accesses an element by its linear index without bounds checking.
+       * @param i Zero based linear index
+       * @return Reference to the element
+       */
+      [[nodiscard]] constexpr reference operator[](std::size_t i) const noexcept
+      {
+        return mData[i];
+      }
+
+      /**
+       * @brief Accesses an element without bounds checking.
+       * @tparam Indices Index types
+       * @param indices Zero based indices, one per dimension
+       * @return Reference to the element
+       */
+      template<typename... Indices>
+        requires (sizeof...(Indices) == Shape::rank && (std::is_convertible_v<Indices, std::size_t> && ...))
+      [[nodiscard]] constexpr reference operator()(Indices... indices) const noexcept
+      {
+        return mData[Shape::getOffset(indices...)];
+      }
+
+      /**
+       * @brief Gets a multidimensional view with static extents.
+       * @return The view
+       */
+      [[nodiscard]] constexpr MdSpan<T, typename Shape::ExtentsType> toMdspan() const noexcept
+      {
+        return MdSpan<T, typename Shape::ExtentsType>{mData, typename Shape::ExtentsType{}};
+      }
+    private:
+      pointer mData{}; ///< Pointer to the data
+  };
+
+  /**
+   * @brief Non-owning view of an array made of consecutive blocks of a static shape, e.g. the pages of a 3x3xN array
+   *        of rotations. The array dimensions are validated once on construction, the blocks are accessed by constant
+   *        offsets.
+   * @tparam T Element type, const-qualified for read-only views
+   * @tparam Shape The StaticShape of a block
+   */
+  template<typename T, typename Shape>
+  class StaticPages
+  {
+    static_assert(detail::isStaticShape<Shape>, "Shape must be a StaticShape");
+
+    public:
+      using element_type = T;                     ///< Element type
+      using value_type   = StaticView<T, Shape>;  ///< Block view type
+      using shape_type   = Shape;                 ///< Shape type
+      using pointer      = T*;                    ///< Pointer type
+
+      /// @brief Random access iterator over the blocks, dereferences to a StaticView.
+      class Iterator
+      {
+        public:
+          using iterator_category = std::random_access_iterator_tag; ///< Iterator category
+          using value_type        = StaticView<T, Shape>;            ///< Value type
+          using difference_type   = std::ptrdiff_t;                  ///< Difference type
+          using pointer           = void;                            ///< Pointer type
+          using reference         = StaticView<T, Shape>;            ///< Reference type
+
+          /// @brief Default constructor.
+          constexpr Iterator() noexcept = default;
+
+          /**
+           * @brief Constructor.
+           * @param data Pointer to the first element of the block
+           */
+          constexpr explicit Iterator(T* data) noexcept
+          : mData{data}
+          {}
+
+          /**
+           * @brief Dereferences the iterator.
+           * @return The block view
+           */
+          [[nodiscard]] constexpr reference operator*() const noexcept
+          {
+            return reference{mData};
+          }
+
+          /**
+           * @brief Accesses a block relative to the iterator.
+           * @param n The offset in blocks
+           * @return The block view
+           */
+          [[nodiscard]] constexpr reference operator[](difference_type n) const noexcept
+          {
+            return reference{mData + n * static_cast<difference_type>(Shape::size)};
+          }
+
+          /// @brief Pre-increment operator.
+          constexpr Iterator& operator++() noexcept
+          {
+            mData += Shape::size;
+            return *this;
+          }
+
+          /// @brief Post-increment operator.
+          constexpr Iterator operator++(int) noexcept
+          {
+            Iterator tmp{*this};
+            ++*this;
+            return tmp;
+          }
+
+          /// @brief Pre-decrement operator.
+          constexpr Iterator& operator--() noexcept
+          {
+            mData -= Shape::size;
+            return *this;
+          }
+
+          /// @brief Post-decrement operator.
+          constexpr Iterator operator--(int) noexcept
+          {
+            Iterator tmp{*this};
+            --*this;
+            return tmp;
+          }
+
+          /// @brief Advances the iterator by n blocks.
+          constexpr Iterator& operator+=(difference_type n) noexcept
+          {
+            mData += n * static_cast<difference_type>(Shape::size);
+            return *this;
+          }
+
+          /// @brief Moves the iterator back by n blocks.
+          constexpr Iterator& operator-=(difference_type n) noexcept
+          {
+            return *this += -n;
+          }
+
+          /// @brief Gets an iterator advanced by n blocks.
+          [[nodiscard]] friend constexpr Iterator operator+(Iterator it, difference_type n) noexcept
+          {
+            return it += n;
+          }
+
+          /// @brief Gets an iterator advanced by n blocks.
+          [[nodiscard]] friend constexpr Iterator operator+(difference_type n, Iterator it) noexcept
+          {
+            return it += n;
+          }
+
+          /// @brief Gets an iterator moved back by n blocks.
+          [[nodiscard]] friend constexpr Iterator operator-(Iterator it, difference_type n) noexcept
+          {
+            return it -= n;
+          }
+
+          /// @brief Gets the distance in blocks.
+          [[nodiscard]] friend constexpr difference_type operator-(Iterator lhs, Iterator rhs) noexcept
+          {
+            return (lhs.mData - rhs.mData) / static_cast<difference_type>(Shape::size);
+          }
+
+          /// @brief Compares the iterators.
+          [[nodiscard]] friend constexpr auto operator<=>(Iterator lhs, Iterator rhs) noexcept = default;
+        private:
+          T* mData{}; ///< Pointer to the first element of the block
+      };
+
+      /// @brief Default constructor.
+      constexpr StaticPages() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param data Pointer to pageCount * Shape::size contiguous elements
+       * @param pageCount Number of blocks
+       */
+      constexpr StaticPages(pointer data, std::size_t pageCount) noexcept
+      : mData{data}, mPageCount{pageCount}
+      {}
+
+      /**
+       * @brief Converting constructor, adds const.
+       * @tparam U Other element type
+       * @param other Other view
+       */
+      template<typename U>
+        requires std::is_convertible_v<U(*)[], T(*)[]>
+      constexpr StaticPages(const StaticPages<U, Shape>& other) noexcept
+      : mData{other.data()}, mPageCount{other.size()}
+      {}
+
+      /**
+       * @brief Gets the number of blocks.
+       * @return The number of blocks
+       */
+      [[nodiscard]] constexpr std::size_t size() const noexcept
+      {
+        return mPageCount;
+      }
+
+      /**
+       * @brief Is the view empty?
+       * @return True if the view has no blocks
+       */
+      [[nodiscard]] constexpr bool empty() const noexcept
+      {
+        return mPageCount == 0;
+      }
+
+      /**
+       * @brief Gets the pointer to the data.
+       * @return Pointer to the first element
+       */
+      [[nodiscard]] constexpr pointer data() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Gets an iterator to the first block.
+       * @return The iterator
+       */
+      [[nodiscard]] constexpr Iterator begin() const noexcept
+      {
+        return Iterator{mData};
+      }
+
+      /**
+       * @brief Gets an iterator past the last block.
+       * @return The iterator
+       */
+      [[nodiscard]] constexpr Iterator end() const noexcept
+      {
+        return Iterator{mData + mPageCount * Shape::size};
+      }
+
+      /**
+       * @brief Accesses a block without bounds checking.
+       * @param page Zero based block index
+       * @return The block view
+       */
+      [[nodiscard]] constexpr StaticView<T, Shape> operator[](std::size_t page) const noexcept
+      {
+        return StaticView<T, Shape>{mData + page * Shape::size};
+      }
+
+      /**
+       * @brief Accesses a block with bounds checking.
+       * @param page Zero based block index
+       * @return The block view
+       */
+      [[nodiscard]] StaticView<T, Shape> at(std::size_t page) const
+      {
+        if (page >= mPageCount)
+        {
+          throw Exception{"matlabw:mx:StaticPages:at", "page index out of range"};
+        }
+
+        return (*this)[page];
+      }
+
+      /**
+       * @brief Accesses an element without bounds checking.
+       * @tparam Indices Index types
+       * @param indices Zero based indices, one per block dimension followed by the block index
+       * @return Reference to the element
+       */
+      template<typename... Indices>
+        requires (sizeof...(Indices) == Shape::rank + 1 && (std::is_convertible_v<Indices, std::size_t> && ...))
+      [[nodiscard]] constexpr T& operator()(Indices... indices) const noexcept
+      {
+        const std::array<std::size_t, Shape::rank + 1> idx{static_cast<std::size_t>(indices)...};
+
+        std::size_t offset{idx[Shape::rank] * Shape::size};
+        std::size_t stride{1};
+
+        for (std::size_t r{}; r < Shape::rank; ++r)
+        {
+          offset += idx[r] * stride;
+          stride *= Shape::dims[r];
+        }
+
+        return mData[offset];
+      }
+    private:
+      pointer     mData{};      ///< Pointer to the data
+      std::size_t mPageCount{}; ///< Number of blocks
+  };
+
+  /**
+   * @brief Gets a view of an array holding a single block of a static shape.
+   * @tparam Shape The StaticShape, must match the array dimensions
+   * @tparam T Element type
+   * @param array The array
+   * @return The view
+   */
+  template<typename Shape, typename T>
+  [[nodiscard]] StaticView<T, Shape> toStaticView(const TypedArrayRef<T>& array)
+  {
+    static constexpr char id[]{"matlabw:mx:toStaticView"};
+
+    if (detail::getStaticPageCount<Shape>(id, array.getDims()) != 1)
+    {
+      throw Exception{id, "array dimensions do not match the static shape"};
+    }
+
+    return StaticView<T, Shape>{array.getData()};
+  }
+
+  /**
+   * @brief Gets a read-only view of an array holding a single block of a static shape.
+   * @tparam Shape The StaticShape, must match the array dimensions
+   * @tparam T Element type
+   * @param array The array
+   * @return The view
+   */
+  template<typename Shape, typename T>
+  [[nodiscard]] StaticView<const T, Shape> toStaticView(const TypedArrayCref<T>& array)
+  {
+    static constexpr char id[]{"matlabw:mx:toStaticView"};
+
+    if (detail::getStaticPageCount<Shape>(id, array.getDims()) != 1)
+    {
+      throw Exception{id, "array dimensions do not match the static shape"};
+    }
+
+    return StaticView<const T, Shape>{array.getData()};
+  }
+
+  /**
+   * @brief Gets a view of an array as blocks of a static shape, the leading dimensions must match the shape and the
+   *        trailing ones enumerate the blocks, e.g. a 3x3xN array as N StaticShape<3, 3> pages.
+   * @tparam Shape The StaticShape of a block
+   * @tparam T Element type
+   * @param array The array
+   * @return The view
+   */
+  template<typename Shape, typename T>
+  [[nodiscard]] StaticPages<T, Shape> toStaticPages(const TypedArrayRef<T>& array)
+  {
+    return StaticPages<T, Shape>{array.getData(),
+                                 detail::getStaticPageCount<Shape>("matlabw:mx:toStaticPages", array.getDims())};
+  }
+
+  /**
+   * @brief Gets a read-only view of an array as blocks of a static shape, see toStaticPages().
+   * @tparam Shape The StaticShape of a block
+   * @tparam T Element type
+   * @param array The array
+   * @return The view
+   */
+  template<typename Shape, typename T>
+  [[nodiscard]] StaticPages<const T, Shape> toStaticPages(const TypedArrayCref<T>& array)
+  {
+    return StaticPages<const T, Shape>{array.getData(),
+                                       detail::getStaticPageCount<Shape>("matlabw:mx:toStaticPages", array.getDims())};
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_STATIC_SHAPE_HPP */
@@ -28,6 +28,7 @@
 #include "detail/include.hpp"
 
 #include "common.hpp"
+#include "Dims.hpp"
 #include "Exception.hpp"
 #include "TypedArray.hpp"
 #include "StructArrayRef.hpp"
@@ -351,6 +352,92 @@ namespace matlabw::mx
         setField(0, fieldIndex, std::move(value));
       }
 
+      /**
+       * @brief Detaches the field of the structure array without copying it, the field becomes empty. Together with
+       *        setField(..., Array&&) this moves subtrees between arrays in O(1).
+       * @param i The index of the structure.
+       * @param fieldName The name of the field.
+       * @return The field, empty if the field does not exist or is empty.
+       */
+      [[nodiscard]] std::optional<Array> takeField(std::size_t i, const char* fieldName)
+      {
+        return takeField(i, getFieldIndex(fieldName));
+      }
+
+      /**
+       * @brief Detaches the field of the structure array without copying it, the field becomes empty.
+       * @param i The index of the structure.
+       * @param fieldName The name of the field. Must be null-terminated.
+       * @return The field, empty if the field does not exist or is empty.
+       */
+      [[nodiscard]] std::optional<Array> takeField(std::size_t i, std::string_view fieldName)
+      {
+        return takeField(i, fieldName.data());
+      }
+
+      /**
+       * @brief Detaches the field of the structure array at index 0 without copying it, the field becomes empty.
+       * @param fieldName The name of the field.
+       * @return The field, empty if the field does not exist or is empty.
+       */
+      [[nodiscard]] std::optional<Array> takeField(const char* fieldName)
+      {
+        return takeField(0, fieldName);
+      }
+
+      /**
+       * @brief Detaches the field of the structure array at index 0 without copying it, the field becomes empty.
+       * @param fieldName The name of the field. Must be null-terminated.
+       * @return The field, empty if the field does not exist or is empty.
+       */
+      [[nodiscard]] std::optional<Array> takeField(std::string_view fieldName)
+      {
+        return takeField(fieldName.data());
+      }
+
+      /**
+       * @brief Detaches the field of the structure array without copying it, the field becomes empty.
+       * @param i The index of the structure.
+       * @param fieldIndex The index of the field.
+       * @return The field, empty if the field does not exist or is empty.
+       */
+      [[nodiscard]] std::optional<Array> takeField(std::size_t i, FieldIndex fieldIndex)
+      {
+        checkValid("matlabw::mx::StructArray::takeField");
+
+        if (fieldIndex == FieldIndex::invalid)
+        {
+          return std::nullopt;
+        }
+
+        if (static_cast<std::size_t>(fieldIndex) >= getFieldCount())
+        {
+          throw Exception("field index out of range");
+        }
+
+        mxArray* field = mxGetFieldByNumber(get(), i, static_cast<int>(fieldIndex));
+
+        if (field == nullptr)
+        {
+          return std::nullopt;
+        }
+
+        // MATLAB does not free the previous value when a field is set, the detached field is owned by the caller.
+        mxSetFieldByNumber(get(), i, static_cast<int>(fieldIndex), nullptr);
+
+        return Array{std::move(field)};
+      }
+
+      /**
+       * @brief Detaches the field of the structure array at index 0 without copying it, the field becomes empty.
+       * @param fieldIndex The index of the field.
+       * @return The field, empty if the field does not exist or is empty.
+       */
+      [[nodiscard]] std::optional<Array> takeField(FieldIndex fieldIndex)
+      {
+        return takeField(0, fieldIndex);
+      }
+
       /**
        * @brief Gets the number of fields.
        * @return The number of fields.
@@ -515,6 +602,8 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline StructArray makeStructArray(View<std::size_t> dims, View<const char*> fieldNames)
   {
+    static_cast<void>(checkDims("matlabw:mx:makeStructArray", dims));
+
     mxArray* array = mxCreateStructArray(dims.size(),
                                          dims.data(),
                                          static_cast<int>(fieldNames.size()),
@@ -0,0 +1,612 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_STRUCT_BINDING_HPP
+#define MATLABW_MX_STRUCT_BINDING_HPP
+
+#include "detail/include.hpp"
+
+#include <tuple>
+
+#include "algorithm/convert.hpp"
+#include "CellArray.hpp"
+#include "CharArray.hpp"
+#include "FieldSchema.hpp"
+#include "LogicalArray.hpp"
+#include "NumericArray.hpp"
+#include "StructArray.hpp"
+
+/// @brief Expands the arguments through 256 rescans, see MATLABW_DETAIL_FOR_EACH.
+#define MATLABW_DETAIL_EXPAND(...) \
+  MATLABW_DETAIL_EXPAND4(MATLABW_DETAIL_EXPAND4(MATLABW_DETAIL_EXPAND4(MATLABW_DETAIL_EXPAND4(__VA_ARGS__))))
+#define MATLABW_DETAIL_EXPAND4(...) \
+  MATLABW_DETAIL_EXPAND3(MATLABW_DETAIL_EXPAND3(MATLABW_DETAIL_EXPAND3(MATLABW_DETAIL_EXPAND3(__VA_ARGS__))))
+#define MATLABW_DETAIL_EXPAND3(...) \
+  MATLABW_DETAIL_EXPAND2(MATLABW_DETAIL_EXPAND2(MATLABW_DETAIL_EXPAND2(MATLABW_DETAIL_EXPAND2(__VA_ARGS__))))
+#define MATLABW_DETAIL_EXPAND2(...) \
+  MATLABW_DETAIL_EXPAND1(MATLABW_DETAIL_EXPAND1(MATLABW_DETAIL_EXPAND1(MATLABW_DETAIL_EXPAND1(__VA_ARGS__))))
+#define MATLABW_DETAIL_EXPAND1(...) __VA_ARGS__
+
+/// @brief Applies macro(context, argument) to each of the arguments.
+#define MATLABW_DETAIL_FOR_EACH(macro, context, ...) \
+  __VA_OPT__(MATLABW_DETAIL_EXPAND(MATLABW_DETAIL_FOR_EACH_HELPER(macro, context, __VA_ARGS__)))
+#define MATLABW_DETAIL_FOR_EACH_HELPER(macro, context, argument, ...) \
+  macro(context, argument) __VA_OPT__(MATLABW_DETAIL_FOR_EACH_AGAIN MATLABW_DETAIL_PARENS (macro, context, __VA_ARGS__))
+#define MATLABW_DETAIL_FOR_EACH_AGAIN() MATLABW_DETAIL_FOR_EACH_HELPER
+#define MATLABW_DETAIL_PARENS ()
+
+/// @brief Describes one member of a bound struct, see MATLABW_STRUCT.
+#define MATLABW_DETAIL_STRUCT_MEMBER(type, member) \
+  ::matlabw::mx::detail::makeStructMember(#member, &type::member),
+
+/**
+ * @brief Binds the members of an aggregate to the fields of a MATLAB struct with the same names, so that toArray() and
+ *        fromArray() convert it. Must be used at global namespace scope, with the fully qualified type name.
+ * @param type The type.
+ * @param ... The members, in the order of the struct fields.
+ */
+#define MATLABW_STRUCT(type, ...) \
+  template<> \
+  struct matlabw::mx::StructBinding<type> \
+  { \
+    static constexpr auto members \
+      = std::tuple{MATLABW_DETAIL_FOR_EACH(MATLABW_DETAIL_STRUCT_MEMBER, type, __VA_ARGS__)}; \
+  }
+
+namespace matlabw::mx
+{
+  /**
+   * @brief Binding of a C++ type to a MATLAB struct. Specialized by MATLABW_STRUCT, a specialization provides a
+   *        constexpr tuple of members created by detail::makeStructMember().
+   * @tparam T Type
+   */
+  template<typename T>
+  struct StructBinding;
+
+namespace detail
+{
+  /**
+   * @brief Member of a bound struct.
+   * @tparam C Class type
+   * @tparam M Member type
+   */
+  template<typename C, typename M>
+  struct StructMember
+  {
+    const char* name;    ///< The field name.
+    M C::*      pointer; ///< The member pointer.
+  };
+
+  /**
+   * @brief Makes a member of a bound struct.
+   * @tparam C Class type
+   * @tparam M Member type
+   * @param name The field name.
+   * @param pointer The member pointer.
+   * @return The member.
+   */
+  template<typename C, typename M>
+  [[nodiscard]] constexpr StructMember<C, M> makeStructMember(const char* name, M C::* pointer) noexcept
+  {
+    return StructMember<C, M>{name, pointer};
+  }
+
+  /**
+   * @brief Is the type bound to a MATLAB struct?
+   * @tparam T Type
+   */
+  template<typename T>
+  concept BoundStruct = requires { StructBinding<T>::members; };
+
+  /**
+   * @brief Number of fields of a bound struct.
+   * @tparam T Type
+   */
+  template<BoundStruct T>
+  inline constexpr std::size_t structFieldCount
+    = std::tuple_size_v<std::remove_const_t<decltype(StructBinding<T>::members)>>;
+
+  /**
+   * @brief Field names of a bound struct.
+   * @tparam T Type
+   */
+  template<BoundStruct T>
+  inline constexpr std::array<const char*, structFieldCount<T>> structFieldNames
+    = std::apply([](const auto&... members)
+    {
+      return std::array<const char*, structFieldCount<T>>{members.name...};
+    }, StructBinding<T>::members);
+
+  /**
+   * @brief Calls a function for each member of a bound struct.
+   * @tparam T Type
+   * @tparam Fn Function type, called as fn(k, member)
+   * @param fn The function
+   */
+  template<BoundStruct T, typename Fn>
+  void forEachStructMember(Fn&& fn)
+  {
+    [&]<std::size_t... ks>(std::index_sequence<ks...>)
+    {
+      (fn(ks, std::get<ks>(StructBinding<T>::members)), ...);
+    }(std::make_index_sequence<structFieldCount<T>>{});
+  }
+
+  /**
+   * @brief Is the type a std::vector?
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isVector = false;
+
+  /**
+   * @brief Is the type a std::vector? Specialization for std::vector.
+   * @tparam T Element type
+   * @tparam Alloc Allocator type
+   */
+  template<typename T, typename Alloc>
+  inline constexpr bool isVector<std::vector<T, Alloc>> = true;
+
+  /**
+   * @brief Is the type a typed MATLAB array?
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isTypedArray = false;
+
+  /**
+   * @brief Is the type a typed MATLAB array? Specialization for TypedArray.
+   * @tparam T Element type
+   */
+  template<typename T>
+  inline constexpr bool isTypedArray<TypedArray<T>> = true;
+
+  /**
+   * @brief Converts the values of a numeric, logical or char array.
+   * @tparam T Target type
+   * @param id The error identifier.
+   * @param array The array.
+   * @param out Output pointer, one element per array element.
+   */
+  template<typename T>
+  void convertBound(const char* id, ArrayCref array, T* out)
+  {
+    visit(array, [&](auto src)
+    {
+      using U = std::remove_cv_t<std::remove_pointer_t<decltype(src.getData())>>;
+
+      if constexpr (!requires { src.getData(); } || !algorithm::detail::isConvertSource<U>)
+      {
+        throw Exception{id, "value must be numeric, logical or char"};
+      }
+      else if constexpr (isComplexNumeric<U> && !isComplexNumeric<T>)
+      {
+        throw Exception{id, "value must be real"};
+      }
+      else if constexpr (std::is_same_v<T, bool>)
+      {
+        std::transform(src.begin(), src.end(), out, [](U x) { return x != U{}; });
+      }
+      else
+      {
+        algorithm::detail::convert(out, src.getData(), src.getSize());
+      }
+    });
+  }
+
+  /**
+   * @brief Checks that an array is a vector or empty.
+   * @param id The error identifier.
+   * @param array The array.
+   */
+  inline void checkBoundVector(const char* id, ArrayCref array)
+  {
+    if (array.getSize() != 0 && (array.getRank() > 2 || (array.getDimM() != 1 && array.getDimN() != 1)))
+    {
+      throw Exception{id, "value must be a vector"};
+    }
+  }
+
+  /**
+   * @brief Rethrows an exception with the name of the field it occurred in.
+   * @param name The field name.
+   * @param e The exception.
+   */
+  [[noreturn]] inline void rethrowInField(const char* name, const Exception& e)
+  {
+    throw Exception{e.id(), "field '" + std::string{name} + "': " + e.what()};
+  }
+
+  /**
+   * @brief Gets the schema of a bound struct, one per thread so that it can be re-bound without locking.
+   * @tparam T Type
+   * @return The schema.
+   */
+  template<BoundStruct T>
+  [[nodiscard]] FieldSchema& getBoundSchema()
+  {
+    thread_local FieldSchema schema{std::vector<std::string>(structFieldNames<T>.begin(),
+                                                             structFieldNames<T>.end())};
+
+    return schema;
+  }
+
+  /**
+   * @brief Converts a C++ value to a MATLAB array and back. Specialized for the supported types.
+   * @tparam T Type
+   */
+  template<typename T>
+  struct Marshaller;
+
+  /**
+   * @brief Converts a value to a MATLAB array.
+   * @tparam T Type
+   * @param value The value.
+   * @return The array.
+   */
+  template<typename T>
+  [[nodiscard]] Array marshal(const T& value)
+  {
+    return Marshaller<T>::toArray(value);
+  }
+
+  /**
+   * @brief Converts a MATLAB array to a value.
+   * @tparam T Type
+   * @param array The array.
+   * @param value The value.
+   */
+  template<typename T>
+  void unmarshal(ArrayCref array, T& value)
+  {
+    Marshaller<T>::fromArray(array, value);
+  }
+
+  /**
+   * @brief Marshaller of numeric scalars.
+   * @tparam T Type
+   */
+  template<typename T>
+    requires algorithm::detail::isConvertTarget<T>
+  struct Marshaller<T>
+  {
+    static Array toArray(const T& value)
+    {
+      return makeNumericScalar<T>(value);
+    }
+
+    static void fromArray(ArrayCref array, T& value)
+    {
+      static constexpr char id[]{"matlabw:mx:StructBinding:scalar"};
+
+      if (array.getSize() != 1)
+      {
+        throw Exception{id, "value must be a scalar"};
+      }
+
+      convertBound(id, array, &value);
+    }
+  };
+
+  /// @brief Marshaller of logical scalars.
+  template<>
+  struct Marshaller<bool>
+  {
+    static Array toArray(bool value)
+    {
+      return makeLogicalScalar(value);
+    }
+
+    static void fromArray(ArrayCref array, bool& value)
+    {
+      static constexpr char id[]{"matlabw:mx:StructBinding:logical"};
+
+      if (array.getSize() != 1)
+      {
+        throw Exception{id, "value must be a scalar"};
+      }
+
+      convertBound(id, array, &value);
+    }
+  };
+
+  /// @brief Marshaller of UTF-8 strings, converted to char row vectors.
+  template<>
+  struct Marshaller<std::string>
+  {
+    static Array toArray(const std::string& value)
+    {
+      return fromUtf8(value);
+    }
+
+    static void fromArray(ArrayCref array, std::string& value)
+    {
+      static constexpr char id[]{"matlabw:mx:StructBinding:string"};
+
+      if (array.getClassId() != ClassId::_char)
+      {
+        throw Exception{id, "value must be a char array"};
+      }
+
+      checkBoundVector(id, array);
+
+      value = toUtf8(array);
+    }
+  };
+
+  /**
+   * @brief Marshaller of typed arrays, copied.
+   * @tparam T Element type
+   */
+  template<typename T>
+  struct Marshaller<TypedArray<T>>
+  {
+    static Array toArray(const TypedArray<T>& value)
+    {
+      return Array{ArrayCref{value}};
+    }
+
+    static void fromArray(ArrayCref array, TypedArray<T>& value)
+    {
+      value = TypedArray<T>{array};
+    }
+  };
+
+  /**
+   * @brief Marshaller of vectors. Numeric and bool elements convert to a numeric or logical row vector, bound struct
+   *        elements to a struct row vector and anything else to a cell row vector.
+   * @tparam T Element type
+   * @tparam Alloc Allocator type
+   */
+  template<typename T, typename Alloc>
+  struct Marshaller<std::vector<T, Alloc>>
+  {
+    static Array toArray(const std::vector<T, Alloc>& value)
+    {
+      const std::size_t n = value.size();
+
+      if constexpr (algorithm::detail::isConvertTarget<T>)
+      {
+        NumericArray<T> array = makeUninitNumericArray<T>(1, n);
+
+        std::copy(value.begin(), value.end(), array.getData());
+
+        return array;
+      }
+      else if constexpr (std::is_same_v<T, bool>)
+      {
+        LogicalArray array = makeLogicalArray(1, n);
+
+        std::copy(value.begin(), value.end(), array.getData());
+
+        return array;
+      }
+      else if constexpr (BoundStruct<T>)
+      {
+        StructArray array = makeStructArray(1, n, structFieldNames<T>);
+
+        for (std::size_t i{}; i < n; ++i)
+        {
+          forEachStructMember<T>([&](std::size_t k, const auto& member)
+          {
+            mxSetFieldByNumber(array.get(), i, static_cast<int>(k), marshal(value[i].*member.pointer).release());
+          });
+        }
+
+        return array;
+      }
+      else
+      {
+        CellArray array = makeCellArray(1, n);
+
+        for (std::size_t i{}; i < n; ++i)
+        {
+          mxSetCell(array.get(), i, marshal(value[i]).release());
+        }
+
+        return array;
+      }
+    }
+
+    static void fromArray(ArrayCref array, std::vector<T, Alloc>& value)
+    {
+      static constexpr char id[]{"matlabw:mx:StructBinding:vector"};
+
+      checkBoundVector(id, array);
+
+      const std::size_t n = array.getSize();
+
+      if constexpr (algorithm::detail::isConvertTarget<T>)
+      {
+        value.resize(n);
+        convertBound(id, array, value.data());
+      }
+      else if constexpr (std::is_same_v<T, bool>)
+      {
+        std::unique_ptr<bool[]> buffer{new bool[n]};
+
+        convertBound(id, array, buffer.get());
+        value.assign(buffer.get(), buffer.get() + n);
+      }
+      else if constexpr (BoundStruct<T>)
+      {
+        value.resize(n);
+        Marshaller<T>::fromStructArray(array, value.data());
+      }
+      else
+      {
+        if (!array.isCell())
+        {
+          throw Exception{id, "value must be a cell array"};
+        }
+
+        value.resize(n);
+
+        for (std::size_t i{}; i < n; ++i)
+        {
+          const mxArray* cell = mxGetCell(array.get(), i);
+
+          if (cell == nullptr)
+          {
+            throw Exception{id, "cell " + std::to_string(i) + " is unset"};
+          }
+
+          unmarshal(ArrayCref{cell}, value[i]);
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief Marshaller of bound structs, converted to scalar structs.
+   * @tparam T Type
+   */
+  template<BoundStruct T>
+  struct Marshaller<T>
+  {
+    static Array toArray(const T& value)
+    {
+      StructArray array = makeStructArray(1, 1, structFieldNames<T>);
+
+      forEachStructMember<T>([&](std::size_t k, const auto& member)
+      {
+        mxSetFieldByNumber(array.get(), 0, static_cast<int>(k), marshal(value.*member.pointer).release());
+      });
+
+      return array;
+    }
+
+    static void fromArray(ArrayCref array, T& value)
+    {
+      if (array.getSize() != 1)
+      {
+        throw Exception{"matlabw:mx:StructBinding:struct", "value must be a scalar struct"};
+      }
+
+      fromStructArray(array, &value);
+    }
+
+    /**
+     * @brief Converts all elements of a struct array, the field indices are resolved once for the whole array.
+     * @param array The struct array.
+     * @param out Output pointer, one value per element.
+     */
+    static void fromStructArray(ArrayCref array, T* out)
+    {
+      if (!array.isStruct())
+      {
+        throw Exception{"matlabw:mx:StructBinding:struct", "value must be a struct"};
+      }
+
+      FieldSchema& schema = getBoundSchema<T>();
+
+      schema.bind(array);
+
+      const std::size_t n = array.getSize();
+
+      forEachStructMember<T>([&](std::size_t k, const auto& member)
+      {
+        const int field = static_cast<int>(schema.getFieldIndex(k));
+
+        try
+        {
+          for (std::size_t i{}; i < n; ++i)
+          {
+            const mxArray* value = mxGetFieldByNumber(array.get(), i, field);
+
+            if (value == nullptr)
+            {
+              throw Exception{"matlabw:mx:StructBinding:struct", "field is unset"};
+            }
+
+            unmarshal(ArrayCref{value}, out[i].*member.pointer);
+          }
+        }
+        catch (const Exception& e)
+        {
+          rethrowInField(member.name, e);
+        }
+      });
+    }
+  };
+} // namespace detail
+
+  /**
+   * @brief Converts a C++ value to a MATLAB array. Supports numeric and bool scalars, std::string, typed arrays,
+   *        std::vector of any of these and types bound by MATLABW_STRUCT, nested to any depth.
+   * @tparam T Type
+   * @param value The value.
+   * @return The array.
+   */
+  template<typename T>
+  [[nodiscard]] Array toArray(const T& value)
+  {
+    return detail::marshal(value);
+  }
+
+  /**
+   * @brief Converts a MATLAB array to a C++ value, see toArray(). Numeric values convert with MATLAB cast semantics,
+   *        struct fields are looked up by name once per struct layout.
+   * @tparam T Type
+   * @param array The array.
+   * @param value The value.
+   * @throws Exception naming the offending field if the array does not match the type.
+   */
+  template<typename T>
+  void fromArray(ArrayCref array, T& value)
+  {
+    detail::unmarshal(array, value);
+  }
+
+  /**
+   * @brief Converts a MATLAB array to a C++ value, see toArray().
+   * @tparam T Type, must be default constructible.
+   * @param array The array.
+   * @return The value.
+   */
+  template<typename T>
+  [[nodiscard]] T fromArray(ArrayCref array)
+  {
+    T value{};
+
+    detail::unmarshal(array, value);
+
+    return value;
+  }
+
+  /**
+   * @brief Makes the field schema of a type bound by MATLABW_STRUCT.
+   * @tparam T Type
+   * @return The schema.
+   */
+  template<detail::BoundStruct T>
+  [[nodiscard]] FieldSchema makeFieldSchema()
+  {
+    const auto& names = detail::structFieldNames<T>;
+
+    return FieldSchema{std::vector<std::string>(names.begin(), names.end())};
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_STRUCT_BINDING_HPP */
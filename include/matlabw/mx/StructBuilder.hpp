@@ -0,0 +1,552 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_STRUCT_BUILDER_HPP
+#define MATLABW_MX_STRUCT_BUILDER_HPP
+
+#include "detail/include.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Array.hpp"
+#include "CharArray.hpp"
+#include "common.hpp"
+#include "Exception.hpp"
+#include "LogicalArray.hpp"
+#include "NumericArray.hpp"
+#include "StructArray.hpp"
+#include "typeTraits.hpp"
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /// @brief Storage of the values of one field of a StructBuilder.
+  class StructBuilderColumn
+  {
+    public:
+      /// @brief Virtual destructor.
+      virtual ~StructBuilderColumn() = default;
+
+      /**
+       * @brief Resizes the column.
+       * @param size The new number of records.
+       */
+      virtual void resize(std::size_t size) = 0;
+
+      /**
+       * @brief Reserves space for the records.
+       * @param capacity The number of records.
+       */
+      virtual void reserve(std::size_t capacity) = 0;
+
+      /**
+       * @brief Creates the leaf arrays of a block of records and links them to a field of a new struct array.
+       * @param array The struct array, its fields must be empty.
+       * @param fieldIndex The index of the field.
+       * @param begin The first record.
+       * @param end The end of the records.
+       */
+      virtual void link(mxArray* array, int fieldIndex, std::size_t begin, std::size_t end) = 0;
+  };
+
+  /**
+   * @brief Column of scalar values, bool values make logical scalars. The values are kept in a plain array so that
+   *        std::span<bool> can be handed out.
+   * @tparam T The value type.
+   */
+  template<typename T>
+  class StructBuilderScalarColumn final : public StructBuilderColumn
+  {
+    public:
+      void resize(std::size_t size) override
+      {
+        reserve(size);
+
+        std::fill(mData.get() + std::min(mSize, size), mData.get() + size, T{});
+
+        mSize = size;
+      }
+
+      void reserve(std::size_t capacity) override
+      {
+        if (capacity > mCapacity)
+        {
+          capacity = std::max(capacity, 2 * mCapacity);
+
+          auto data = std::make_unique_for_overwrite<T[]>(capacity);
+
+          std::copy_n(mData.get(), mSize, data.get());
+
+          mData     = std::move(data);
+          mCapacity = capacity;
+        }
+      }
+
+      void link(mxArray* array, int fieldIndex, std::size_t begin, std::size_t end) override
+      {
+        for (std::size_t i{begin}; i < end; ++i)
+        {
+          mxArray* leaf{};
+
+          if constexpr (std::is_same_v<T, bool>)
+          {
+            leaf = mxCreateLogicalScalar(mData[i]);
+          }
+          else if constexpr (std::is_same_v<T, double>)
+          {
+            leaf = mxCreateDoubleScalar(mData[i]);
+          }
+          else
+          {
+            leaf = makeNumericScalar<T>(mData[i]).release();
+          }
+
+          if (leaf == nullptr)
+          {
+            throw Exception{"matlabw:mx:StructBuilder:build", "failed to create field value"};
+          }
+
+          mxSetFieldByNumber(array, i, fieldIndex, leaf);
+        }
+      }
+
+      /**
+       * @brief Gets the values.
+       * @return The values.
+       */
+      [[nodiscard]] std::span<T> getValues() noexcept
+      {
+        return {mData.get(), mSize};
+      }
+
+    private:
+      std::unique_ptr<T[]> mData{};     ///< The values
+      std::size_t          mSize{};     ///< The number of records
+      std::size_t          mCapacity{}; ///< The number of allocated values
+  };
+
+  /**
+   * @brief Makes a char row vector leaf.
+   * @param value The string.
+   * @return The leaf.
+   */
+  [[nodiscard]] inline mxArray* makeStructBuilderLeaf(const std::string& value)
+  {
+    return makeCharArray(std::string_view{value}).release();
+  }
+
+  /**
+   * @brief Makes a numeric row vector leaf.
+   * @tparam T The element type.
+   * @param value The elements.
+   * @return The leaf.
+   */
+  template<typename T>
+  [[nodiscard]] mxArray* makeStructBuilderLeaf(const std::vector<T>& value)
+  {
+    auto leaf = makeUninitNumericArray<T>({{1, value.size()}});
+
+    std::copy(value.begin(), value.end(), leaf.getData());
+
+    return leaf.release();
+  }
+
+  /**
+   * @brief Passes the ownership of an array leaf, an invalid array leaves the field empty.
+   * @param value The array.
+   * @return The leaf or nullptr.
+   */
+  [[nodiscard]] inline mxArray* makeStructBuilderLeaf(Array& value) noexcept
+  {
+    return value.release();
+  }
+
+  /**
+   * @brief Column of values held in a std::vector, the leaf of each record is made by makeStructBuilderLeaf().
+   * @tparam T The value type.
+   */
+  template<typename T>
+  class StructBuilderVectorColumn final : public StructBuilderColumn
+  {
+    public:
+      void resize(std::size_t size) override
+      {
+        mValues.resize(size);
+      }
+
+      void reserve(std::size_t capacity) override
+      {
+        mValues.reserve(capacity);
+      }
+
+      void link(mxArray* array, int fieldIndex, std::size_t begin, std::size_t end) override
+      {
+        for (std::size_t i{begin}; i < end; ++i)
+        {
+          mxArray* leaf = makeStructBuilderLeaf(mValues[i]);
+
+          if (leaf != nullptr)
+          {
+            mxSetFieldByNumber(array, i, fieldIndex, leaf);
+          }
+        }
+      }
+
+      /**
+       * @brief Gets the values.
+       * @return The values.
+       */
+      [[nodiscard]] std::span<T> getValues() noexcept
+      {
+        return mValues;
+      }
+
+    private:
+      std::vector<T> mValues{}; ///< The values
+  };
+
+} // namespace detail
+
+  /**
+   * @brief Builder of struct arrays with a fixed list of fields. Field values are stored in typed columns addressed by
+   *        field index, so filling the records involves neither name lookups nor MATLAB API calls and may run on
+   *        worker threads (each thread writing its own records). build() then creates the struct array once and makes
+   *        and links the leaf arrays field by field with mxSetFieldByNumber, which must happen on the MATLAB thread.
+   *        The spans returned by the column accessors are invalidated by append(), resize() and build().
+   */
+  class StructBuilder
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param fieldNames The field names.
+       * @param size The initial number of records.
+       */
+      explicit StructBuilder(std::vector<std::string> fieldNames, std::size_t size = 0)
+      : mFieldNames{std::move(fieldNames)}, mColumns(mFieldNames.size()), mSize{size}
+      {
+        for (std::size_t k{}; k < mFieldNames.size(); ++k)
+        {
+          if (mFieldNames[k].empty())
+          {
+            throw Exception{"matlabw:mx:StructBuilder", "field names must not be empty"};
+          }
+
+          for (std::size_t j{}; j < k; ++j)
+          {
+            if (mFieldNames[j] == mFieldNames[k])
+            {
+              throw Exception{"matlabw:mx:StructBuilder", "duplicate field name '" + mFieldNames[k] + "'"};
+            }
+          }
+        }
+      }
+
+      /**
+       * @brief Constructor.
+       * @param fieldNames The field names.
+       * @param size The initial number of records.
+       */
+      StructBuilder(std::initializer_list<std::string_view> fieldNames, std::size_t size = 0)
+      : StructBuilder{std::vector<std::string>(fieldNames.begin(), fieldNames.end()), size}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      StructBuilder(const StructBuilder&) = delete;
+
+      /// @brief Default move constructor.
+      StructBuilder(StructBuilder&&) = default;
+
+      /// @brief Default destructor.
+      ~StructBuilder() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      StructBuilder& operator=(const StructBuilder&) = delete;
+
+      /// @brief Default move assignment operator.
+      StructBuilder& operator=(StructBuilder&&) = default;
+
+      /**
+       * @brief Gets the number of fields.
+       * @return The number of fields.
+       */
+      [[nodiscard]] std::size_t getFieldCount() const noexcept
+      {
+        return mFieldNames.size();
+      }
+
+      /**
+       * @brief Gets the name of a field.
+       * @param field The field index.
+       * @return The field name.
+       */
+      [[nodiscard]] const std::string& getFieldName(std::size_t field) const
+      {
+        return mFieldNames.at(field);
+      }
+
+      /**
+       * @brief Gets the index of a field. Resolve the indices once and address the columns by index in hot loops.
+       * @param name The field name.
+       * @return The field index.
+       * @throws Exception if there is no such field.
+       */
+      [[nodiscard]] std::size_t getFieldIndex(std::string_view name) const
+      {
+        for (std::size_t k{}; k < mFieldNames.size(); ++k)
+        {
+          if (mFieldNames[k] == name)
+          {
+            return k;
+          }
+        }
+
+        throw Exception{"matlabw:mx:StructBuilder:getFieldIndex", "no field '" + std::string{name} + "'"};
+      }
+
+      /**
+       * @brief Gets the number of records.
+       * @return The number of records.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Reserves space for records.
+       * @param capacity The number of records.
+       */
+      void reserve(std::size_t capacity)
+      {
+        for (auto& column : mColumns)
+        {
+          if (column != nullptr)
+          {
+            column->reserve(capacity);
+          }
+        }
+
+        mCapacity = std::max(mCapacity, capacity);
+      }
+
+      /**
+       * @brief Resizes the builder, new records have zero, empty or unset values.
+       * @param size The new number of records.
+       */
+      void resize(std::size_t size)
+      {
+        for (auto& column : mColumns)
+        {
+          if (column != nullptr)
+          {
+            column->resize(size);
+          }
+        }
+
+        mSize = size;
+      }
+
+      /**
+       * @brief Appends a record.
+       * @return The index of the new record.
+       */
+      std::size_t append()
+      {
+        const std::size_t index = mSize;
+
+        resize(mSize + 1);
+
+        return index;
+      }
+
+      /**
+       * @brief Gets the column of a field holding real numeric or logical scalars. The first access fixes the type of
+       *        the column.
+       * @tparam T The value type.
+       * @param field The field index.
+       * @return The values of the records.
+       * @throws Exception if the column holds values of another kind.
+       */
+      template<typename T>
+        requires (isRealNumeric<T> || std::is_same_v<T, bool>)
+      [[nodiscard]] std::span<T> scalars(std::size_t field)
+      {
+        return getColumn<detail::StructBuilderScalarColumn<T>>(field).getValues();
+      }
+
+      /**
+       * @brief Gets the column of a field holding strings, they are stored as char row vectors.
+       * @param field The field index.
+       * @return The values of the records.
+       * @throws Exception if the column holds values of another kind.
+       */
+      [[nodiscard]] std::span<std::string> strings(std::size_t field)
+      {
+        return getColumn<StringColumn>(field).getValues();
+      }
+
+      /**
+       * @brief Gets the column of a field holding real numeric vectors, they are stored as row vectors.
+       * @tparam T The element type.
+       * @param field The field index.
+       * @return The values of the records.
+       * @throws Exception if the column holds values of another kind.
+       */
+      template<typename T>
+        requires isRealNumeric<T>
+      [[nodiscard]] std::span<std::vector<T>> vectors(std::size_t field)
+      {
+        return getColumn<VectorColumn<T>>(field).getValues();
+      }
+
+      /**
+       * @brief Gets the column of a field holding arbitrary arrays, unset values leave the field empty. The arrays must
+       *        be created on the MATLAB thread.
+       * @param field The field index.
+       * @return The values of the records.
+       * @throws Exception if the column holds values of another kind.
+       */
+      [[nodiscard]] std::span<Array> arrays(std::size_t field)
+      {
+        return getColumn<ArrayColumn>(field).getValues();
+      }
+
+      /**
+       * @brief Builds the n-by-1 struct array and clears the records, the fields and column kinds stay.
+       * @return The struct array.
+       */
+      [[nodiscard]] StructArray build()
+      {
+        return build({{mSize, 1}});
+      }
+
+      /**
+       * @brief Builds the struct array and clears the records, the fields and column kinds stay.
+       * @param dims The dimensions, their product must be equal to the number of records.
+       * @return The struct array.
+       * @throws Exception if the dimensions do not match the number of records.
+       */
+      [[nodiscard]] StructArray build(View<std::size_t> dims)
+      {
+        static constexpr char id[]{"matlabw:mx:StructBuilder:build"};
+
+        std::size_t count{1};
+
+        for (const std::size_t dim : dims)
+        {
+          count *= dim;
+        }
+
+        if (count != mSize)
+        {
+          throw Exception{id, "dimensions do not match the number of records"};
+        }
+
+        std::vector<const char*> names(mFieldNames.size());
+
+        std::transform(mFieldNames.begin(), mFieldNames.end(), names.begin(), [](const auto& n){ return n.c_str(); });
+
+        StructArray array = makeStructArray(dims, names);
+
+        // link in blocks of records, a struct array stores the fields of a record next to each other
+        for (std::size_t begin{}; begin < mSize; begin += linkBlockSize)
+        {
+          const std::size_t end = std::min(begin + linkBlockSize, mSize);
+
+          for (std::size_t k{}; k < mColumns.size(); ++k)
+          {
+            if (mColumns[k] != nullptr)
+            {
+              mColumns[k]->link(array.get(), static_cast<int>(k), begin, end);
+            }
+          }
+        }
+
+        resize(0);
+
+        return array;
+      }
+
+    private:
+      /// @brief Number of records linked field by field before moving to the next block.
+      static constexpr std::size_t linkBlockSize{256};
+
+      using StringColumn = detail::StructBuilderVectorColumn<std::string>;
+
+      template<typename T>
+      using VectorColumn = detail::StructBuilderVectorColumn<std::vector<T>>;
+
+      using ArrayColumn = detail::StructBuilderVectorColumn<Array>;
+
+      /**
+       * @brief Gets the column of a field, creates it on the first access.
+       * @tparam Column The column type.
+       * @param field The field index.
+       * @return The column.
+       */
+      template<typename Column>
+      [[nodiscard]] Column& getColumn(std::size_t field)
+      {
+        if (field >= mColumns.size())
+        {
+          throw Exception{"matlabw:mx:StructBuilder:getColumn", "field index out of range"};
+        }
+
+        auto& column = mColumns[field];
+
+        if (column == nullptr)
+        {
+          auto created = std::make_unique<Column>();
+
+          created->reserve(mCapacity);
+          created->resize(mSize);
+
+          column = std::move(created);
+        }
+
+        auto* typed = dynamic_cast<Column*>(column.get());
+
+        if (typed == nullptr)
+        {
+          throw Exception{"matlabw:mx:StructBuilder:getColumn",
+                          "field '" + mFieldNames[field] + "' holds values of another kind"};
+        }
+
+        return *typed;
+      }
+
+      std::vector<std::string>                                  mFieldNames{}; ///< The field names
+      std::vector<std::unique_ptr<detail::StructBuilderColumn>> mColumns{};    ///< The columns, null if unset
+      std::size_t                                               mSize{};       ///< The number of records
+      std::size_t                                               mCapacity{};   ///< The reserved number of records
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_STRUCT_BUILDER_HPP */
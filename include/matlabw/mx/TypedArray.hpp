@@ -30,6 +30,7 @@
 #include "Array.hpp"
 #include "common.hpp"
 #include "TypedArrayRef.hpp"
+#include "detail/instantiate.hpp"
 
 namespace matlabw::mx
 {
@@ -120,7 +121,9 @@ namespace matlabw::mx
       {
         checkArrayClass(other.get());
 
-        return Array::operator=(other);
+        Array::operator=(other);
+
+        return *this;
       }
 
       /**
@@ -132,7 +135,9 @@ namespace matlabw::mx
       {
         checkArrayClass(other.get());
 
-        return Array::operator=(other);
+        Array::operator=(other);
+
+        return *this;
       }
 
       /**
@@ -325,6 +330,50 @@ namespace matlabw::mx
         return const_reverse_iterator{begin()};
       }
 
+      /**
+       * @brief Gets a column-major multidimensional view with dynamic extents.
+       * @tparam Rank The rank of the view
+       * @return The view
+       */
+      template<std::size_t Rank>
+      [[nodiscard]] MdSpan<T, DExtents<Rank>> toMdspan()
+      {
+        return detail::makeMdspan<T, DExtents<Rank>>(getData(), getDims());
+      }
+
+      /**
+       * @brief Gets a column-major multidimensional view.
+       * @tparam Ext The extents type, static extents must match the array dimensions
+       * @return The view
+       */
+      template<typename Ext>
+      [[nodiscard]] MdSpan<T, Ext> toMdspan()
+      {
+        return detail::makeMdspan<T, Ext>(getData(), getDims());
+      }
+
+      /**
+       * @brief Gets a column-major multidimensional view with dynamic extents.
+       * @tparam Rank The rank of the view
+       * @return The view
+       */
+      template<std::size_t Rank>
+      [[nodiscard]] MdSpan<const T, DExtents<Rank>> toMdspan() const
+      {
+        return detail::makeMdspan<const T, DExtents<Rank>>(getData(), getDims());
+      }
+
+      /**
+       * @brief Gets a column-major multidimensional view.
+       * @tparam Ext The extents type, static extents must match the array dimensions
+       * @return The view
+       */
+      template<typename Ext>
+      [[nodiscard]] MdSpan<const T, Ext> toMdspan() const
+      {
+        return detail::makeMdspan<const T, Ext>(getData(), getDims());
+      }
+
       /// @brief Use the Array::operator ArrayRef
       using Array::operator ArrayRef;
 
@@ -360,6 +409,13 @@ namespace matlabw::mx
         return detail::checkArrayClass<classId>(array);
       }
   };
+
+#if MATLABW_MX_DETAIL_EXTERN_CORE
+  // Instantiated in the matlabw-core library
+# define MATLABW_MX_DETAIL_EXTERN_TYPED_ARRAY(T) extern template class TypedArray<T>;
+  MATLABW_MX_DETAIL_FOR_EACH_CORE_TYPE(MATLABW_MX_DETAIL_EXTERN_TYPED_ARRAY)
+# undef MATLABW_MX_DETAIL_EXTERN_TYPED_ARRAY
+#endif
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_TYPED_ARRAY_HPP */
@@ -29,11 +29,16 @@
 
 #include "ArrayRef.hpp"
 #include "common.hpp"
+#include "MdSpan.hpp"
+#include "detail/instantiate.hpp"
 
 namespace matlabw::mx
 {
 namespace detail
 {
+  /// @brief Tag selecting the constructors which skip the class check, the caller has already checked the class.
+  struct ClassCheckedTag {};
+
   /**
    * @brief Checks if the array is of the correct class.
    * @tparam classId Class ID
@@ -108,7 +113,8 @@ namespace detail
       TypedArrayRef& operator=(const ArrayRef& other)
       {
         checkArrayClass(other.get());
-        return ArrayRef::operator=(other);
+        ArrayRef::operator=(other);
+        return *this;
       }
 
       /**
@@ -216,6 +222,28 @@ namespace detail
       {
         return const_reverse_iterator{begin()};
       }
+
+      /**
+       * @brief Gets a column-major multidimensional view with dynamic extents.
+       * @tparam Rank The rank of the view
+       * @return The view
+       */
+      template<std::size_t Rank>
+      [[nodiscard]] MdSpan<T, DExtents<Rank>> toMdspan() const
+      {
+        return detail::makeMdspan<T, DExtents<Rank>>(getData(), getDims());
+      }
+
+      /**
+       * @brief Gets a column-major multidimensional view.
+       * @tparam Ext The extents type, static extents must match the array dimensions
+       * @return The view
+       */
+      template<typename Ext>
+      [[nodiscard]] MdSpan<T, Ext> toMdspan() const
+      {
+        return detail::makeMdspan<T, Ext>(getData(), getDims());
+      }
     private:
       /// @brief Checks if the array is of the correct class
       void checkArrayClass(const mxArray* array) const
@@ -275,6 +303,14 @@ namespace detail
       : ArrayCref{(checkArrayClass(other.get()), other)}
       {}
 
+      /**
+       * @brief Constructor from an ArrayCref whose class has already been checked.
+       * @param other ArrayCref of the class classId
+       */
+      TypedArrayCref(const ArrayCref& other, detail::ClassCheckedTag) noexcept
+      : ArrayCref{other}
+      {}
+
       /**
        * @brief Constructor from a ArrayCref.
        * @param other ArrayCref
@@ -282,7 +318,8 @@ namespace detail
       TypedArrayCref& operator=(const ArrayCref& other)
       {
         checkArrayClass(other.get());
-        return ArrayCref::operator=(other);
+        ArrayCref::operator=(other);
+        return *this;
       }
 
       /**
@@ -292,7 +329,8 @@ namespace detail
       TypedArrayCref& operator=(const ArrayRef& other)
       {
         checkArrayClass(other.get());
-        return ArrayCref::operator=(other);
+        ArrayCref::operator=(other);
+        return *this;
       }
 
       /**
@@ -400,6 +438,28 @@ namespace detail
       {
         return rend();
       }
+
+      /**
+       * @brief Gets a column-major multidimensional view with dynamic extents.
+       * @tparam Rank The rank of the view
+       * @return The view
+       */
+      template<std::size_t Rank>
+      [[nodiscard]] MdSpan<const T, DExtents<Rank>> toMdspan() const
+      {
+        return detail::makeMdspan<const T, DExtents<Rank>>(getData(), getDims());
+      }
+
+      /**
+       * @brief Gets a column-major multidimensional view.
+       * @tparam Ext The extents type, static extents must match the array dimensions
+       * @return The view
+       */
+      template<typename Ext>
+      [[nodiscard]] MdSpan<const T, Ext> toMdspan() const
+      {
+        return detail::makeMdspan<const T, Ext>(getData(), getDims());
+      }
     private:
       /// @brief Checks if the array is of the correct class
       void checkArrayClass(const mxArray* array) const
@@ -407,6 +467,15 @@ namespace detail
         return detail::checkArrayClass<classId>(array);
       }
   };
+
+#if MATLABW_MX_DETAIL_EXTERN_CORE
+  // Instantiated in the matlabw-core library
+# define MATLABW_MX_DETAIL_EXTERN_TYPED_ARRAY_REF(T) \
+  extern template class TypedArrayRef<T>;            \
+  extern template class TypedArrayCref<T>;
+  MATLABW_MX_DETAIL_FOR_EACH_CORE_TYPE(MATLABW_MX_DETAIL_EXTERN_TYPED_ARRAY_REF)
+# undef MATLABW_MX_DETAIL_EXTERN_TYPED_ARRAY_REF
+#endif
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_TYPED_ARRAY_REF_HPP */
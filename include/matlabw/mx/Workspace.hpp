@@ -0,0 +1,425 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_WORKSPACE_HPP
+#define MATLABW_MX_WORKSPACE_HPP
+
+#include "detail/include.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AllocStats.hpp"
+#include "Array.hpp"
+#include "ArrayRef.hpp"
+#include "Exception.hpp"
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /**
+   * @brief Gets the number of bytes of the data of an array.
+   * @param array The array, may be nullptr.
+   * @return The number of bytes.
+   */
+  [[nodiscard]] inline std::size_t getDataBytes(const mxArray* array) noexcept
+  {
+    if (array == nullptr)
+    {
+      return 0;
+    }
+
+    const std::size_t count = mxGetNumberOfElements(array);
+
+    if (mxIsSparse(array))
+    {
+      return mxGetNzmax(array) * (mxGetElementSize(array) + sizeof(mwIndex)) + (mxGetN(array) + 1) * sizeof(mwIndex);
+    }
+
+    if (mxIsCell(array))
+    {
+      std::size_t bytes = count * sizeof(mxArray*);
+
+      for (std::size_t i{}; i < count; ++i)
+      {
+        bytes += getDataBytes(mxGetCell(array, i));
+      }
+
+      return bytes;
+    }
+
+    if (mxIsStruct(array))
+    {
+      const auto  fieldCount = static_cast<std::size_t>(mxGetNumberOfFields(array));
+      std::size_t bytes      = count * fieldCount * sizeof(mxArray*);
+
+      for (std::size_t i{}; i < count; ++i)
+      {
+        for (std::size_t k{}; k < fieldCount; ++k)
+        {
+          bytes += getDataBytes(mxGetFieldByNumber(array, i, static_cast<int>(k)));
+        }
+      }
+
+      return bytes;
+    }
+
+    return count * mxGetElementSize(array);
+  }
+
+  /// @brief Temporary array owned by a workspace.
+  struct WorkspaceEntry
+  {
+    /// @brief Destructor.
+    virtual ~WorkspaceEntry() = default;
+
+    /**
+     * @brief Gets the owned array.
+     * @return The array.
+     */
+    [[nodiscard]] virtual Array& getArray() noexcept = 0;
+
+    const void* address{}; ///< Address of the mxArray when it was tracked, recorded in the allocation statistics.
+    std::size_t bytes{};   ///< Number of bytes of the data when the array was tracked.
+    std::size_t stage{};   ///< Identifier of the innermost stage the array was tracked in, 0 outside of stages.
+  };
+
+  /**
+   * @brief Temporary array of a concrete type owned by a workspace.
+   * @tparam A Array type.
+   */
+  template<typename A>
+  struct WorkspaceEntryOf final : WorkspaceEntry
+  {
+    /**
+     * @brief Constructor.
+     * @param array The array.
+     */
+    explicit WorkspaceEntryOf(A&& array) noexcept
+    : array{std::move(array)}
+    {}
+
+    /// @copydoc WorkspaceEntry::getArray
+    [[nodiscard]] Array& getArray() noexcept override
+    {
+      return array;
+    }
+
+    A array; ///< The array.
+  };
+} // namespace detail
+
+  /**
+   * @brief Gets the number of bytes of the data of an array, including the elements of cells and the fields of
+   *        structs. The mxArray headers are not included.
+   * @param array The array.
+   * @return The number of bytes.
+   */
+  [[nodiscard]] inline std::size_t getDataBytes(ArrayCref array) noexcept
+  {
+    return detail::getDataBytes(array.get());
+  }
+
+  /// @brief Statistics of a workspace.
+  struct WorkspaceStats
+  {
+    std::size_t currentBytes{};   ///< Number of bytes of the live temporaries.
+    std::size_t peakBytes{};      ///< Maximum number of bytes of live temporaries at once.
+    std::size_t trackedBytes{};   ///< Total number of bytes tracked, the peak if nothing was destroyed early.
+    std::size_t destroyedBytes{}; ///< Number of bytes destroyed by the workspace.
+    std::size_t trackedCount{};   ///< Number of arrays tracked.
+    std::size_t destroyedCount{}; ///< Number of arrays destroyed by the workspace.
+  };
+
+  /**
+   * @brief Owner of the temporary arrays of a multi-stage computation, e.g. the intermediates of a MEX function. Each
+   *        temporary is moved into the workspace when it is created and destroyed when the stage it was tracked in
+   *        ends, instead of living until the end of its C++ scope, so the peak memory stays close to the largest
+   *        stage rather than the sum of all stages:
+   *
+   *          mx::Workspace ws{};
+   *          {
+   *            auto stage = ws.beginStage();
+   *            auto& a    = ws.track(mx::makeNumericArray<double>(m, n));
+   *            ...
+   *          } // a is destroyed here
+   *
+   *        Results which outlive their stage are moved out with keep(). The bytes of the tracked arrays are also
+   *        recorded in the allocation statistics, so mx::getAllocStats().peakBytes covers both mx::malloc memory and
+   *        the temporaries. The workspace is not thread-safe and must be used from the MATLAB thread only.
+   */
+  class Workspace
+  {
+    public:
+      /// @brief Scope of a stage, the arrays tracked during the stage are destroyed when it ends.
+      class Stage
+      {
+        public:
+          /// @brief Explicitly deleted copy constructor.
+          Stage(const Stage&) = delete;
+
+          /**
+           * @brief Move constructor.
+           * @param other The other stage.
+           */
+          Stage(Stage&& other) noexcept
+          : mWorkspace{std::exchange(other.mWorkspace, nullptr)},
+            mId{other.mId}
+          {}
+
+          /// @brief Destructor. Ends the stage.
+          ~Stage() noexcept
+          {
+            end();
+          }
+
+          /// @brief Explicitly deleted copy assignment operator.
+          Stage& operator=(const Stage&) = delete;
+
+          /// @brief Explicitly deleted move assignment operator.
+          Stage& operator=(Stage&&) = delete;
+
+          /// @brief Ends the stage early, destroying the arrays tracked since it began, including nested stages.
+          void end() noexcept
+          {
+            if (mWorkspace != nullptr)
+            {
+              std::exchange(mWorkspace, nullptr)->endStage(mId);
+            }
+          }
+        private:
+          friend class Workspace;
+
+          /**
+           * @brief Constructor.
+           * @param workspace The workspace.
+           * @param id Identifier of the stage.
+           */
+          Stage(Workspace& workspace, std::size_t id) noexcept
+          : mWorkspace{&workspace},
+            mId{id}
+          {}
+
+          Workspace*  mWorkspace; ///< The workspace, nullptr once the stage ended.
+          std::size_t mId;        ///< Identifier of the stage.
+      };
+
+      /// @brief Default constructor.
+      Workspace() noexcept = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      Workspace(const Workspace&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      Workspace(Workspace&&) = delete;
+
+      /// @brief Destructor. Destroys all tracked arrays.
+      ~Workspace() noexcept
+      {
+        clear();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Workspace& operator=(const Workspace&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      Workspace& operator=(Workspace&&) = delete;
+
+      /**
+       * @brief Begins a stage. Stages nest, an outer stage ending destroys the arrays of its inner stages too.
+       * @return The scope of the stage.
+       */
+      [[nodiscard]] Stage beginStage()
+      {
+        mStages.push_back(++mLastStage);
+
+        return Stage{*this, mLastStage};
+      }
+
+      /**
+       * @brief Moves a temporary array into the workspace.
+       * @tparam A Array type (Array, NumericArray, CellArray, ...).
+       * @param array The array.
+       * @return Reference to the tracked array, valid until the current stage ends or the array is kept or
+       *         destroyed.
+       */
+      template<typename A>
+        requires (std::is_base_of_v<Array, A> && !std::is_lvalue_reference_v<A>)
+      A& track(A&& array)
+      {
+        auto entry = std::make_unique<detail::WorkspaceEntryOf<A>>(std::move(array));
+        A&   ref   = entry->array;
+
+        entry->address = ref.get();
+        entry->bytes   = detail::getDataBytes(ref.get());
+        entry->stage   = mStages.empty() ? 0 : mStages.back();
+
+        const std::size_t bytes = entry->bytes;
+
+        mEntries.push_back(std::move(entry));
+
+        detail::recordAllocation(mEntries.back()->address, bytes);
+
+        mStats.currentBytes += bytes;
+        mStats.trackedBytes += bytes;
+        mStats.peakBytes     = std::max(mStats.peakBytes, mStats.currentBytes);
+        ++mStats.trackedCount;
+
+        return ref;
+      }
+
+      /**
+       * @brief Moves a tracked array out of the workspace, e.g. an output or a result passed to a later stage.
+       * @tparam A Array type.
+       * @param array The tracked array.
+       * @return The array, owned by the caller.
+       */
+      template<typename A>
+        requires std::is_base_of_v<Array, A>
+      [[nodiscard]] A keep(A& array)
+      {
+        const std::size_t index = find("matlabw:mx:Workspace:keep", array);
+
+        A result{std::move(array)};
+
+        untrack(index);
+
+        return result;
+      }
+
+      /**
+       * @brief Destroys a tracked array before its stage ends.
+       * @param array The tracked array.
+       */
+      void destroy(const Array& array)
+      {
+        const std::size_t index = find("matlabw:mx:Workspace:destroy", array);
+
+        mStats.destroyedBytes += mEntries[index]->bytes;
+        ++mStats.destroyedCount;
+
+        untrack(index);
+      }
+
+      /// @brief Destroys all tracked arrays.
+      void clear() noexcept
+      {
+        destroyFrom(0);
+      }
+
+      /**
+       * @brief Gets the number of tracked arrays.
+       * @return The number of tracked arrays.
+       */
+      [[nodiscard]] std::size_t getCount() const noexcept
+      {
+        return mEntries.size();
+      }
+
+      /**
+       * @brief Gets the statistics of the workspace.
+       * @return The statistics.
+       */
+      [[nodiscard]] const WorkspaceStats& getStats() const noexcept
+      {
+        return mStats;
+      }
+    private:
+      /**
+       * @brief Finds a tracked array.
+       * @param id Error identifier.
+       * @param array The array.
+       * @return Index of the entry.
+       */
+      [[nodiscard]] std::size_t find(const char* id, const Array& array) const
+      {
+        // Recent arrays are the most likely to be kept or destroyed.
+        for (std::size_t i{mEntries.size()}; i > 0; --i)
+        {
+          if (&mEntries[i - 1]->getArray() == &array)
+          {
+            return i - 1;
+          }
+        }
+
+        throw Exception{id, "array is not tracked by the workspace"};
+      }
+
+      /**
+       * @brief Removes an entry, destroying its array unless it was moved out.
+       * @param index Index of the entry.
+       */
+      void untrack(std::size_t index) noexcept
+      {
+        // Recorded before the array is destroyed, mxDestroyArray may hand the address to the next allocation.
+        detail::recordFree(mEntries[index]->address);
+
+        mStats.currentBytes -= mEntries[index]->bytes;
+
+        mEntries.erase(mEntries.begin() + static_cast<std::ptrdiff_t>(index));
+      }
+
+      /**
+       * @brief Ends a stage and its inner stages. Does nothing if the stage already ended with an outer stage.
+       * @param id Identifier of the stage.
+       */
+      void endStage(std::size_t id) noexcept
+      {
+        const auto it = std::find(mStages.begin(), mStages.end(), id);
+
+        if (it != mStages.end())
+        {
+          mStages.erase(it, mStages.end());
+          destroyFrom(id);
+        }
+      }
+
+      /**
+       * @brief Destroys the arrays tracked in a stage or later stages, the most recent first. The identifiers of the
+       *        active stages increase, so these arrays are always at the end even after keep() or destroy() removed
+       *        arrays of earlier stages from the middle.
+       * @param stage Identifier of the stage, 0 destroys all arrays.
+       */
+      void destroyFrom(std::size_t stage) noexcept
+      {
+        while (!mEntries.empty() && mEntries.back()->stage >= stage)
+        {
+          mStats.destroyedBytes += mEntries.back()->bytes;
+          ++mStats.destroyedCount;
+
+          untrack(mEntries.size() - 1);
+        }
+      }
+
+      std::vector<std::unique_ptr<detail::WorkspaceEntry>> mEntries{};   ///< The tracked arrays in tracking order.
+      std::vector<std::size_t>                             mStages{};    ///< Identifiers of the active stages.
+      std::size_t                                          mLastStage{}; ///< Identifier of the last begun stage.
+      WorkspaceStats                                       mStats{};     ///< The statistics.
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_WORKSPACE_HPP */
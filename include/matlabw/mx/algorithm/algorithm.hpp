@@ -0,0 +1,56 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_ALGORITHM_HPP
+#define MATLABW_MX_ALGORITHM_ALGORITHM_HPP
+
+#include "cells.hpp"
+#include "classify.hpp"
+#include "columns.hpp"
+#include "complex.hpp"
+#include "construct.hpp"
+#include "convert.hpp"
+#include "copy.hpp"
+#include "convolution.hpp"
+#include "elementwise.hpp"
+#include "expression.hpp"
+#include "forEachColumn.hpp"
+#include "gather.hpp"
+#include "group.hpp"
+#include "half.hpp"
+#include "histogram.hpp"
+#include "mask.hpp"
+#include "ode.hpp"
+#include "permute.hpp"
+#include "pipeline.hpp"
+#include "random.hpp"
+#include "reduce.hpp"
+#include "scan.hpp"
+#include "sort.hpp"
+#include "sparse.hpp"
+#include "stencil.hpp"
+#include "text.hpp"
+#include "visitMany.hpp"
+
+#endif /* MATLABW_MX_ALGORITHM_ALGORITHM_HPP */
@@ -0,0 +1,744 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_CELLS_HPP
+#define MATLABW_MX_ALGORITHM_CELLS_HPP
+
+#include "../detail/include.hpp"
+
+#include <iterator>
+
+#include "convert.hpp"
+#include "detail/parallel.hpp"
+#include "detail/span.hpp"
+#include "../CellArray.hpp"
+#include "../CharArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Random access iterator over the cells of a cell array, yields references to the cell contents.
+  class CellIterator
+  {
+    public:
+      using iterator_category = std::random_access_iterator_tag; ///< Iterator category
+      using value_type        = ArrayCref;                       ///< Value type
+      using difference_type   = std::ptrdiff_t;                  ///< Difference type
+
+      /// @brief Default constructor.
+      CellIterator() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param cell Pointer to the cell.
+       */
+      explicit CellIterator(const mxArray* const* cell) noexcept
+      : mCell{cell}
+      {}
+
+      /**
+       * @brief Gets the referenced cell contents.
+       * @return The cell contents.
+       */
+      [[nodiscard]] ArrayCref operator*() const noexcept
+      {
+        return ArrayCref{*mCell};
+      }
+
+      /**
+       * @brief Gets the cell contents at an offset.
+       * @param n The offset.
+       * @return The cell contents.
+       */
+      [[nodiscard]] ArrayCref operator[](difference_type n) const noexcept
+      {
+        return ArrayCref{mCell[n]};
+      }
+
+      /// @brief Pre-increment.
+      CellIterator& operator++() noexcept
+      {
+        ++mCell;
+        return *this;
+      }
+
+      /// @brief Post-increment.
+      CellIterator operator++(int) noexcept
+      {
+        return CellIterator{mCell++};
+      }
+
+      /// @brief Pre-decrement.
+      CellIterator& operator--() noexcept
+      {
+        --mCell;
+        return *this;
+      }
+
+      /// @brief Post-decrement.
+      CellIterator operator--(int) noexcept
+      {
+        return CellIterator{mCell--};
+      }
+
+      /// @brief Advances the iterator.
+      CellIterator& operator+=(difference_type n) noexcept
+      {
+        mCell += n;
+        return *this;
+      }
+
+      /// @brief Moves the iterator back.
+      CellIterator& operator-=(difference_type n) noexcept
+      {
+        mCell -= n;
+        return *this;
+      }
+
+      /// @brief Advanced iterator.
+      [[nodiscard]] friend CellIterator operator+(CellIterator it, difference_type n) noexcept
+      {
+        return it += n;
+      }
+
+      /// @brief Advanced iterator.
+      [[nodiscard]] friend CellIterator operator+(difference_type n, CellIterator it) noexcept
+      {
+        return it += n;
+      }
+
+      /// @brief Moved back iterator.
+      [[nodiscard]] friend CellIterator operator-(CellIterator it, difference_type n) noexcept
+      {
+        return it -= n;
+      }
+
+      /// @brief Distance between iterators.
+      [[nodiscard]] friend difference_type operator-(CellIterator a, CellIterator b) noexcept
+      {
+        return a.mCell - b.mCell;
+      }
+
+      /// @brief Three-way comparison.
+      [[nodiscard]] auto operator<=>(const CellIterator&) const noexcept = default;
+    private:
+      const mxArray* const* mCell{}; ///< Pointer to the cell.
+  };
+
+  /// @brief Range of the cells of a cell array.
+  class CellRange
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param array The cell array.
+       * @throws Exception if the array is not a cell array.
+       */
+      explicit CellRange(ArrayCref array)
+      : mData{static_cast<const mxArray* const*>(checkCell(array).getData())}, mSize{array.getSize()}
+      {}
+
+      /**
+       * @brief Gets the iterator to the first cell.
+       * @return The iterator.
+       */
+      [[nodiscard]] CellIterator begin() const noexcept
+      {
+        return CellIterator{mData};
+      }
+
+      /**
+       * @brief Gets the iterator past the last cell.
+       * @return The iterator.
+       */
+      [[nodiscard]] CellIterator end() const noexcept
+      {
+        return CellIterator{mData + mSize};
+      }
+
+      /**
+       * @brief Gets the number of cells.
+       * @return The number of cells.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Gets the contents of a cell.
+       * @param i The index of the cell.
+       * @return The cell contents.
+       */
+      [[nodiscard]] ArrayCref operator[](std::size_t i) const noexcept
+      {
+        return ArrayCref{mData[i]};
+      }
+    private:
+      /**
+       * @brief Checks that the array is a cell array.
+       * @param array The array.
+       * @return The array.
+       */
+      static ArrayCref checkCell(ArrayCref array)
+      {
+        if (!array.isCell())
+        {
+          throw Exception{"matlabw:mx:algorithm:cells", "input must be a cell array"};
+        }
+
+        return array;
+      }
+
+      const mxArray* const* mData; ///< The cells.
+      std::size_t           mSize; ///< The number of cells.
+  };
+
+  /**
+   * @brief Gets a range over the cells of a cell array. The validity of the array is checked once, the iterators
+   *        yield references to the cell contents without further checks. Cells of arrays passed from MATLAB are always
+   *        set, cell arrays created in MEX files must not have unset cells.
+   * @param array The cell array.
+   * @return The range.
+   */
+  [[nodiscard]] inline CellRange cells(ArrayCref array)
+  {
+    return CellRange{array};
+  }
+
+  /**
+   * @brief Ragged array in CSR layout: the rows are stored back to back in one contiguous buffer, row i spans the
+   *        elements offsets[i] to offsets[i + 1].
+   * @tparam T Element type
+   */
+  template<typename T>
+  class RaggedArray
+  {
+    public:
+      /// @brief Default constructor, creates an array without rows.
+      RaggedArray()
+      : mOffsets{0}
+      {}
+
+      /**
+       * @brief Constructor.
+       * @param offsets The row offsets, non-decreasing, starting with 0 and ending with the number of elements.
+       * @param data The elements.
+       */
+      RaggedArray(std::vector<std::size_t> offsets, std::vector<T> data)
+      : mOffsets{std::move(offsets)}, mData{std::move(data)}
+      {
+        if (mOffsets.empty() || mOffsets.front() != 0 || mOffsets.back() != mData.size()
+            || !std::is_sorted(mOffsets.begin(), mOffsets.end()))
+        {
+          throw Exception{"matlabw:mx:algorithm:RaggedArray", "invalid row offsets"};
+        }
+      }
+
+      /**
+       * @brief Gets the number of rows.
+       * @return The number of rows.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mOffsets.size() - 1;
+      }
+
+      /**
+       * @brief Gets a row.
+       * @param i The index of the row.
+       * @return The elements of the row.
+       */
+      [[nodiscard]] std::span<const T> operator[](std::size_t i) const noexcept
+      {
+        return std::span<const T>{mData.data() + mOffsets[i], mOffsets[i + 1] - mOffsets[i]};
+      }
+
+      /**
+       * @brief Gets a row.
+       * @param i The index of the row.
+       * @return The elements of the row.
+       */
+      [[nodiscard]] std::span<T> operator[](std::size_t i) noexcept
+      {
+        return std::span<T>{mData.data() + mOffsets[i], mOffsets[i + 1] - mOffsets[i]};
+      }
+
+      /**
+       * @brief Gets the row offsets.
+       * @return The row offsets, one more than rows.
+       */
+      [[nodiscard]] std::span<const std::size_t> getOffsets() const noexcept
+      {
+        return mOffsets;
+      }
+
+      /**
+       * @brief Gets the elements of all rows.
+       * @return The elements.
+       */
+      [[nodiscard]] std::span<const T> getData() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Gets the elements of all rows.
+       * @return The elements.
+       */
+      [[nodiscard]] std::span<T> getData() noexcept
+      {
+        return mData;
+      }
+    private:
+      std::vector<std::size_t> mOffsets; ///< Row offsets.
+      std::vector<T>           mData{};  ///< Elements.
+  };
+
+namespace detail
+{
+  /// @brief Minimum number of elements of a ragged array converted in parallel.
+  inline constexpr std::size_t raggedParallelMinSize{std::size_t{1} << 16};
+
+  /// @brief Number of cells per parallel chunk of a ragged conversion.
+  inline constexpr std::size_t raggedChunkSize{64};
+
+  /**
+   * @brief Checks that a cell is set and holds a vector or an empty array.
+   * @param id The error identifier.
+   * @param cell The cell contents.
+   * @param i The index of the cell.
+   */
+  inline void checkVectorCell(const char* id, const mxArray* cell, std::size_t i)
+  {
+    if (cell == nullptr)
+    {
+      throw Exception{id, "cell " + std::to_string(i) + " is unset"};
+    }
+
+    if (mxGetNumberOfElements(cell) != 0
+        && (mxGetNumberOfDimensions(cell) > 2 || (mxGetM(cell) != 1 && mxGetN(cell) != 1)))
+    {
+      throw Exception{id, "cell " + std::to_string(i) + " must hold a vector"};
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Converts a cell array of numeric, logical or char vectors to a ragged array with one row per cell, in one
+   *        allocation. All non-empty cells must have the class of the first non-empty cell, empty cells of any class
+   *        give empty rows. The values convert with MATLAB cast semantics, large inputs in parallel.
+   * @tparam T Element type
+   * @param array The cell array.
+   * @return The ragged array.
+   */
+  template<typename T>
+  [[nodiscard]] RaggedArray<T> toRagged(ArrayCref array)
+  {
+    static_assert(detail::isConvertTarget<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:algorithm:toRagged"};
+
+    const CellRange   range{array};
+    const auto        cells = static_cast<const mxArray* const*>(array.getData());
+    const std::size_t n     = range.size();
+
+    std::vector<std::size_t> offsets(n + 1);
+    const mxArray*           first{};
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      detail::checkVectorCell(id, cells[i], i);
+
+      const std::size_t size = mxGetNumberOfElements(cells[i]);
+
+      if (size != 0)
+      {
+        if (first == nullptr)
+        {
+          first = cells[i];
+        }
+        else if (mxGetClassID(cells[i]) != mxGetClassID(first) || mxIsComplex(cells[i]) != mxIsComplex(first))
+        {
+          throw Exception{id, "cell " + std::to_string(i) + " must have the same class as the other cells"};
+        }
+      }
+
+      offsets[i + 1] = offsets[i] + size;
+    }
+
+    std::vector<T> data(offsets[n]);
+
+    if (first != nullptr)
+    {
+      visit(ArrayCref{first}, [&](auto src)
+      {
+        using U = std::remove_cv_t<std::remove_pointer_t<decltype(src.getData())>>;
+
+        if constexpr (!requires { src.getData(); } || !detail::isConvertSource<U>)
+        {
+          throw Exception{id, "cells must hold numeric, logical or char vectors"};
+        }
+        else if constexpr (isComplexNumeric<U> && !isComplexNumeric<T>)
+        {
+          throw Exception{id, "complex cells require a complex element type"};
+        }
+        else
+        {
+          auto convert = [&](std::size_t begin, std::size_t end)
+          {
+            for (std::size_t i{begin}; i < end; ++i)
+            {
+              const std::size_t size = offsets[i + 1] - offsets[i];
+
+              if (size != 0)
+              {
+                detail::convert(data.data() + offsets[i], static_cast<const U*>(mxGetData(cells[i])), size);
+              }
+            }
+          };
+
+          if (offsets[n] < detail::raggedParallelMinSize)
+          {
+            convert(0, n);
+          }
+          else
+          {
+            parallel::parallelFor(0, n, detail::raggedChunkSize, convert);
+          }
+        }
+      });
+    }
+
+    return RaggedArray<T>{std::move(offsets), std::move(data)};
+  }
+
+  /**
+   * @brief Builds an n-by-1 cell array of column vectors from a ragged array, the reverse of toRagged().
+   * @tparam T Element type
+   * @param ragged The ragged array.
+   * @return The cell array.
+   */
+  template<typename T>
+  [[nodiscard]] CellArray fromRagged(const RaggedArray<T>& ragged)
+  {
+    static_assert(detail::isConvertTarget<T>, "unsupported element type");
+
+    const std::size_t n = ragged.size();
+
+    CellArray array = makeCellArray(n, 1);
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      const auto row = ragged[i];
+
+      NumericArray<T> cell = makeUninitNumericArray<T>(row.size(), 1);
+
+      std::copy(row.begin(), row.end(), cell.getData());
+
+      mxSetCell(array.get(), i, cell.release());
+    }
+
+    return array;
+  }
+
+  /// @brief List of strings stored back to back in one buffer, string i spans offsets[i] to offsets[i + 1].
+  class StringList
+  {
+    public:
+      /// @brief Default constructor, creates an empty list.
+      StringList()
+      : mOffsets{0}
+      {}
+
+      /**
+       * @brief Constructor.
+       * @param offsets The string offsets, non-decreasing, starting with 0 and ending with the size of the data.
+       * @param data The characters of all strings.
+       */
+      StringList(std::vector<std::size_t> offsets, std::string data)
+      : mOffsets{std::move(offsets)}, mData{std::move(data)}
+      {
+        if (mOffsets.empty() || mOffsets.front() != 0 || mOffsets.back() != mData.size()
+            || !std::is_sorted(mOffsets.begin(), mOffsets.end()))
+        {
+          throw Exception{"matlabw:mx:algorithm:StringList", "invalid string offsets"};
+        }
+      }
+
+      /**
+       * @brief Gets the number of strings.
+       * @return The number of strings.
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mOffsets.size() - 1;
+      }
+
+      /**
+       * @brief Gets a string.
+       * @param i The index of the string.
+       * @return The string.
+       */
+      [[nodiscard]] std::string_view operator[](std::size_t i) const noexcept
+      {
+        return std::string_view{mData.data() + mOffsets[i], mOffsets[i + 1] - mOffsets[i]};
+      }
+
+      /**
+       * @brief Gets the string offsets.
+       * @return The string offsets, one more than strings.
+       */
+      [[nodiscard]] std::span<const std::size_t> getOffsets() const noexcept
+      {
+        return mOffsets;
+      }
+
+      /**
+       * @brief Gets the characters of all strings.
+       * @return The characters.
+       */
+      [[nodiscard]] std::string_view getData() const noexcept
+      {
+        return mData;
+      }
+    private:
+      std::vector<std::size_t> mOffsets; ///< String offsets.
+      std::string              mData{};  ///< Characters of all strings.
+  };
+
+namespace detail
+{
+  /// @brief Minimum number of strings transcoded in parallel.
+  inline constexpr std::size_t stringParallelMinSize{std::size_t{1} << 12};
+
+  /// @brief Number of strings per parallel chunk.
+  inline constexpr std::size_t stringChunkSize{256};
+
+  /**
+   * @brief Calls a function for chunks of strings, in parallel for many strings.
+   * @tparam Fn Function type, called as fn(begin, end)
+   * @param n The number of strings.
+   * @param fn The function.
+   */
+  template<typename Fn>
+  void forEachStringChunk(std::size_t n, Fn&& fn)
+  {
+    if (n < stringParallelMinSize)
+    {
+      fn(std::size_t{}, n);
+    }
+    else
+    {
+      parallel::parallelFor(0, n, stringChunkSize, fn);
+    }
+  }
+
+  /**
+   * @brief Gets the cells of a cellstr.
+   * @param id The error identifier.
+   * @param array The cell array.
+   * @return The cells.
+   */
+  inline const mxArray* const* getCellStr(const char* id, ArrayCref array)
+  {
+    if (array.isClass("string"))
+    {
+      throw Exception{id, "string arrays must be converted with cellstr, see mex::toStringList()"};
+    }
+
+    if (!array.isCell())
+    {
+      throw Exception{id, "input must be a cell array of char vectors"};
+    }
+
+    return static_cast<const mxArray* const*>(array.getData());
+  }
+
+  /**
+   * @brief Checks that a cell holds a char vector.
+   * @param id The error identifier.
+   * @param cell The cell contents.
+   * @param i The index of the cell.
+   */
+  inline void checkCharCell(const char* id, const mxArray* cell, std::size_t i)
+  {
+    checkVectorCell(id, cell, i);
+
+    if (!mxIsChar(cell))
+    {
+      throw Exception{id, "cell " + std::to_string(i) + " must hold a char vector"};
+    }
+  }
+
+  /**
+   * @brief Builds an n-by-1 cellstr. The char arrays are created serially, since MATLAB array creation is not
+   *        thread-safe, and filled in parallel.
+   * @tparam Get Function type, called as get(i) for the i-th UTF-8 string.
+   * @param n The number of strings.
+   * @param get The function.
+   * @return The cell array.
+   */
+  template<typename Get>
+  [[nodiscard]] CellArray makeCellStr(std::size_t n, Get&& get)
+  {
+    std::vector<std::size_t> lengths(n);
+
+    forEachStringChunk(n, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        const std::string_view str = get(i);
+
+        lengths[i] = mx::detail::decodeUtf8(str.data(), str.size(), nullptr);
+      }
+    });
+
+    CellArray              array = makeCellArray(n, 1);
+    std::vector<char16_t*> data(n);
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      CharArray cell = makeCharArray({{1, lengths[i]}});
+
+      data[i] = cell.getData();
+
+      mxSetCell(array.get(), i, cell.release());
+    }
+
+    forEachStringChunk(n, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        const std::string_view str = get(i);
+
+        mx::detail::decodeUtf8(str.data(), str.size(), data[i]);
+      }
+    });
+
+    return array;
+  }
+} // namespace detail
+
+  /**
+   * @brief Converts a cellstr to a list of UTF-8 strings in one buffer. A first pass validates the cells and computes
+   *        the exact UTF-8 lengths, the buffer is allocated once and the strings are transcoded into it, both passes in
+   *        parallel for many strings.
+   * @param array The cell array of char vectors.
+   * @return The strings, one per cell.
+   */
+  [[nodiscard]] inline StringList toStringList(ArrayCref array)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:toStringList"};
+
+    const mxArray* const* cells = detail::getCellStr(id, array);
+    const std::size_t     n     = array.getSize();
+
+    std::vector<std::size_t> offsets(n + 1);
+
+    detail::forEachStringChunk(n, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        detail::checkCharCell(id, cells[i], i);
+
+        offsets[i + 1] = mx::detail::getUtf8Length(static_cast<const char16_t*>(mxGetData(cells[i])),
+                                                   mxGetNumberOfElements(cells[i]));
+      }
+    });
+
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::string data(offsets[n], '\0');
+
+    detail::forEachStringChunk(n, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        mx::detail::encodeUtf8(static_cast<const char16_t*>(mxGetData(cells[i])),
+                               mxGetNumberOfElements(cells[i]),
+                               data.data() + offsets[i]);
+      }
+    });
+
+    return StringList{std::move(offsets), std::move(data)};
+  }
+
+  /**
+   * @brief Converts a cellstr to UTF-8 strings. The exact length of each string is known before it is transcoded, so
+   *        each string is allocated once, many strings are converted in parallel.
+   * @param array The cell array of char vectors.
+   * @return The strings, one per cell.
+   */
+  [[nodiscard]] inline std::vector<std::string> toStrings(ArrayCref array)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:toStrings"};
+
+    const mxArray* const* cells = detail::getCellStr(id, array);
+    const std::size_t     n     = array.getSize();
+
+    std::vector<std::string> strings(n);
+
+    detail::forEachStringChunk(n, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        detail::checkCharCell(id, cells[i], i);
+
+        const auto*       chars = static_cast<const char16_t*>(mxGetData(cells[i]));
+        const std::size_t size  = mxGetNumberOfElements(cells[i]);
+
+        strings[i].resize(mx::detail::getUtf8Length(chars, size));
+        mx::detail::encodeUtf8(chars, size, strings[i].data());
+      }
+    });
+
+    return strings;
+  }
+
+  /**
+   * @brief Builds an n-by-1 cellstr from UTF-8 strings, the reverse of toStrings().
+   * @tparam A Array-like of strings or string views
+   * @param strings The strings.
+   * @return The cell array.
+   */
+  template<typename A>
+  [[nodiscard]] CellArray fromStrings(const A& strings)
+  {
+    const auto span = detail::toSpan(strings);
+
+    return detail::makeCellStr(span.size(), [&](std::size_t i) { return std::string_view{span[i]}; });
+  }
+
+  /**
+   * @brief Builds an n-by-1 cellstr from a string list, the reverse of toStringList().
+   * @param strings The strings.
+   * @return The cell array.
+   */
+  [[nodiscard]] inline CellArray fromStrings(const StringList& strings)
+  {
+    return detail::makeCellStr(strings.size(), [&](std::size_t i) { return strings[i]; });
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_CELLS_HPP */
@@ -0,0 +1,328 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_CLASSIFY_HPP
+#define MATLABW_MX_ALGORITHM_CLASSIFY_HPP
+
+#include "../detail/include.hpp"
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../LogicalArray.hpp"
+#include "reduce.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /// @brief Floating point classes tested by the kernels.
+  enum class FloatClass
+  {
+    finite, ///< Neither Inf nor NaN
+    nan,    ///< NaN
+    inf,    ///< Positive or negative Inf
+  };
+
+  /// @brief Block size of the early exit scans.
+  inline constexpr std::size_t scanBlockSize{4096};
+
+  /**
+   * @brief Tests the floating point class of a value by its exponent bits.
+   * @tparam fpClass The class
+   * @tparam T Element type
+   * @param x The value
+   * @return True if the value is of the class. Integers are always finite, complex values are NaN or Inf if either
+   *         part is, as in MATLAB.
+   */
+  template<FloatClass fpClass, typename T>
+  MATLABW_ALWAYS_INLINE constexpr bool isClass(T x) noexcept
+  {
+    if constexpr (isInteger<T>)
+    {
+      return fpClass == FloatClass::finite;
+    }
+    else if constexpr (isComplex<T>)
+    {
+      if constexpr (fpClass == FloatClass::finite)
+      {
+        return isClass<fpClass>(x.real()) && isClass<fpClass>(x.imag());
+      }
+      else
+      {
+        return isClass<fpClass>(x.real()) || isClass<fpClass>(x.imag());
+      }
+    }
+    else
+    {
+      using Bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+      constexpr Bits absMask = std::numeric_limits<Bits>::max() >> 1;
+      constexpr Bits expMask = std::bit_cast<Bits>(std::numeric_limits<T>::infinity());
+
+      const Bits bits = std::bit_cast<Bits>(x);
+
+      switch (fpClass)
+      {
+      case FloatClass::finite:
+        return (bits & expMask) != expMask;
+      case FloatClass::nan:
+        return (bits & absMask) > expMask;
+      default:
+        return (bits & absMask) == expMask;
+      }
+    }
+  }
+
+  /**
+   * @brief Writes the class test of each element.
+   * @tparam fpClass The class
+   * @param id Error identifier
+   * @param out Output
+   * @param in Input
+   */
+  template<FloatClass fpClass, typename Out, typename In>
+  void classify(const char* id, Out&& out, const In& in)
+  {
+    auto dst = toSpan(out);
+    auto src = toSpan(in);
+
+    using T = ElementType<decltype(src)>;
+
+    static_assert(Numeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<ElementType<decltype(dst)>, bool>, "output element type must be bool");
+
+    checkSizes(id, dst.size(), src.size());
+    transform([](T x) MATLABW_INLINE_LAMBDA { return isClass<fpClass>(x); }, dst.size(), dst.data(), src.data());
+  }
+
+  /**
+   * @brief Creates a logical array of the class test of each element.
+   * @tparam fpClass The class
+   * @param id Error identifier
+   * @param in Input, an array with dimensions
+   * @return The logical array of the input's dimensions
+   */
+  template<FloatClass fpClass, typename In>
+  [[nodiscard]] LogicalArray classify(const char* id, const In& in)
+  {
+    LogicalArray out = makeLogicalArray(in.getDims());
+
+    classify<fpClass>(id, out, in);
+
+    return out;
+  }
+
+  /**
+   * @brief Counts the elements of the class.
+   * @tparam fpClass The class
+   * @param in Input
+   * @return The count
+   */
+  template<FloatClass fpClass, typename In>
+  [[nodiscard]] std::size_t count(const In& in)
+  {
+    const auto src  = toInputSpan(in);
+    const auto data = src.data();
+
+    auto map = [data](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      return static_cast<std::size_t>(isClass<fpClass>(data[i]));
+    };
+
+    return sum<std::size_t>(map, src.size(), Summation::naive);
+  }
+
+  /**
+   * @brief Checks if any element is of the class (or of any other class if negated), stops after the first block
+   *        with a match.
+   * @tparam fpClass The class
+   * @tparam negate Test for elements not of the class?
+   * @param in Input
+   * @return True if found
+   */
+  template<FloatClass fpClass, bool negate, typename In>
+  [[nodiscard]] bool any(const In& in)
+  {
+    const auto src  = toInputSpan(in);
+    const auto data = src.data();
+    const auto n    = src.size();
+
+    auto map = [data](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      return static_cast<unsigned>(isClass<fpClass>(data[i]) != negate);
+    };
+
+    auto op = [](unsigned a, unsigned b) MATLABW_INLINE_LAMBDA { return a | b; };
+
+    return dispatch([&]() MATLABW_INLINE_LAMBDA
+    {
+      for (std::size_t first{}; first < n; first += scanBlockSize)
+      {
+        if (reduceBlock<unsigned>(map, first, std::min(first + scanBlockSize, n), 0u, op) != 0)
+        {
+          return true;
+        }
+      }
+
+      return false;
+    });
+  }
+} // namespace detail
+
+  /**
+   * @brief Tests each element for being finite.
+   * @param out Output of bool elements (LogicalArrayRef, LogicalArray, span, ...)
+   * @param in Input
+   */
+  template<typename Out, typename In>
+  void isFinite(Out&& out, const In& in)
+  {
+    detail::classify<detail::FloatClass::finite>("matlabw:mx:algorithm:isFinite", out, in);
+  }
+
+  /**
+   * @brief Tests each element for being finite.
+   * @param in Input array
+   * @return The logical array, the same size as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] LogicalArray isFinite(const In& in)
+  {
+    return detail::classify<detail::FloatClass::finite>("matlabw:mx:algorithm:isFinite", in);
+  }
+
+  /**
+   * @brief Tests each element for being NaN.
+   * @param out Output of bool elements (LogicalArrayRef, LogicalArray, span, ...)
+   * @param in Input
+   */
+  template<typename Out, typename In>
+  void isNaN(Out&& out, const In& in)
+  {
+    detail::classify<detail::FloatClass::nan>("matlabw:mx:algorithm:isNaN", out, in);
+  }
+
+  /**
+   * @brief Tests each element for being NaN.
+   * @param in Input array
+   * @return The logical array, the same size as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] LogicalArray isNaN(const In& in)
+  {
+    return detail::classify<detail::FloatClass::nan>("matlabw:mx:algorithm:isNaN", in);
+  }
+
+  /**
+   * @brief Tests each element for being Inf.
+   * @param out Output of bool elements (LogicalArrayRef, LogicalArray, span, ...)
+   * @param in Input
+   */
+  template<typename Out, typename In>
+  void isInf(Out&& out, const In& in)
+  {
+    detail::classify<detail::FloatClass::inf>("matlabw:mx:algorithm:isInf", out, in);
+  }
+
+  /**
+   * @brief Tests each element for being Inf.
+   * @param in Input array
+   * @return The logical array, the same size as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] LogicalArray isInf(const In& in)
+  {
+    return detail::classify<detail::FloatClass::inf>("matlabw:mx:algorithm:isInf", in);
+  }
+
+  /**
+   * @brief Counts the finite elements.
+   * @param in Input
+   * @return The count
+   */
+  template<typename In>
+  [[nodiscard]] std::size_t countFinite(const In& in)
+  {
+    return detail::count<detail::FloatClass::finite>(in);
+  }
+
+  /**
+   * @brief Counts the NaN elements.
+   * @param in Input
+   * @return The count
+   */
+  template<typename In>
+  [[nodiscard]] std::size_t countNaN(const In& in)
+  {
+    return detail::count<detail::FloatClass::nan>(in);
+  }
+
+  /**
+   * @brief Counts the Inf elements.
+   * @param in Input
+   * @return The count
+   */
+  template<typename In>
+  [[nodiscard]] std::size_t countInf(const In& in)
+  {
+    return detail::count<detail::FloatClass::inf>(in);
+  }
+
+  /**
+   * @brief Checks if any element is NaN or Inf, returns early after the first non-finite block.
+   * @param in Input
+   * @return True if any element is not finite
+   */
+  template<typename In>
+  [[nodiscard]] bool anyNonFinite(const In& in)
+  {
+    return detail::any<detail::FloatClass::finite, true>(in);
+  }
+
+  /**
+   * @brief Checks if any element is NaN, returns early after the first block with a NaN.
+   * @param in Input
+   * @return True if any element is NaN
+   */
+  template<typename In>
+  [[nodiscard]] bool anyNaN(const In& in)
+  {
+    return detail::any<detail::FloatClass::nan, false>(in);
+  }
+
+  /**
+   * @brief Checks if any element is Inf, returns early after the first block with an Inf.
+   * @param in Input
+   * @return True if any element is Inf
+   */
+  template<typename In>
+  [[nodiscard]] bool anyInf(const In& in)
+  {
+    return detail::any<detail::FloatClass::inf, false>(in);
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_CLASSIFY_HPP */
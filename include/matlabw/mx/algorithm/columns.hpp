@@ -0,0 +1,315 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_COLUMNS_HPP
+#define MATLABW_MX_ALGORITHM_COLUMNS_HPP
+
+#include "../detail/include.hpp"
+
+#include <tuple>
+
+#include "convert.hpp"
+#include "detail/parallel.hpp"
+#include "detail/span.hpp"
+#include "../FieldSchema.hpp"
+#include "../LogicalArray.hpp"
+#include "../StructArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /**
+   * @brief Minimum number of records gathered in parallel. Each record costs a field lookup and a cache miss, so the
+   *        threshold is far lower than for contiguous data.
+   */
+  inline constexpr std::size_t columnParallelMinSize{std::size_t{1} << 14};
+
+  /// @brief Number of records per parallel chunk.
+  inline constexpr std::size_t columnChunkSize{std::size_t{1} << 12};
+
+  /**
+   * @brief Checks that the schema selects one field per column.
+   * @param id The error identifier.
+   * @param schema The schema.
+   * @param columnCount The number of columns.
+   */
+  inline void checkColumnCount(const char* id, const FieldSchema& schema, std::size_t columnCount)
+  {
+    if (schema.getFieldCount() != columnCount)
+    {
+      throw Exception{id, "number of columns must match the number of schema fields"};
+    }
+  }
+
+  /**
+   * @brief Gathers one field of every element of a struct array into a column. The class of the first element's field
+   *        fixes the source type, every other element is checked against it while it is copied.
+   * @tparam T Column element type
+   * @param array The struct array, the schema must be bound to it.
+   * @param schema The schema.
+   * @param k The position of the field in the schema.
+   * @param out Output pointer
+   */
+  template<typename T>
+  void gatherColumn(ArrayCref array, const FieldSchema& schema, std::size_t k, T* out)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:toColumns"};
+
+    const std::size_t n = array.getSize();
+
+    if (n == 0)
+    {
+      return;
+    }
+
+    const mxArray* ptr   = array.get();
+    const int      field = static_cast<int>(schema.getFieldIndex(k));
+
+    auto fail = [&](std::size_t i, std::string_view reason)
+    {
+      throw Exception{id, "field '" + schema.getFieldName(k) + "' of element " + std::to_string(i) + ' '
+                          + std::string{reason}};
+    };
+
+    const mxArray* first = mxGetFieldByNumber(ptr, 0, field);
+
+    if (first == nullptr || mxGetNumberOfElements(first) != 1)
+    {
+      fail(0, "must be a scalar");
+    }
+
+    visit(ArrayCref{first}, [&](auto src)
+    {
+      using U = std::remove_cv_t<std::remove_pointer_t<decltype(src.getData())>>;
+
+      if constexpr (!requires { src.getData(); } || !isConvertSource<U>)
+      {
+        fail(0, "must be numeric, logical or char");
+      }
+      else if constexpr (isComplexNumeric<U> && !isComplexNumeric<T>)
+      {
+        fail(0, "is complex, the column requires a complex type");
+      }
+      else
+      {
+        const std::size_t key = mx::detail::getVisitKey<U>();
+
+        auto gather = [&](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t i{begin}; i < end; ++i)
+          {
+            const mxArray* value = mxGetFieldByNumber(ptr, i, field);
+
+            if (value == nullptr || mxGetNumberOfElements(value) != 1
+                || mx::detail::getVisitKey(ArrayCref{value}) != key)
+            {
+              fail(i, "must be a scalar of the same class as in element 0");
+            }
+
+            out[i] = convertValue<T>(*static_cast<const U*>(mxGetData(value)));
+          }
+        };
+
+        if (n < columnParallelMinSize)
+        {
+          gather(0, n);
+        }
+        else
+        {
+          parallel::parallelFor(0, n, columnChunkSize, gather);
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Gathers the fields selected by the schema into columns.
+   * @tparam Columns Tuple of columns
+   * @param array The struct array, the schema must be bound to it.
+   * @param schema The schema.
+   * @param columns The columns, each with one element per struct element.
+   */
+  template<typename Columns>
+  void gatherColumns(ArrayCref array, const FieldSchema& schema, Columns& columns)
+  {
+    [&]<std::size_t... ks>(std::index_sequence<ks...>)
+    {
+      (gatherColumn(array, schema, ks, toSpan(std::get<ks>(columns)).data()), ...);
+    }(std::make_index_sequence<std::tuple_size_v<Columns>>{});
+  }
+
+  /**
+   * @brief Checks a struct array for the conversion to columns and binds the schema to it.
+   * @param id The error identifier.
+   * @param array The struct array.
+   * @param schema The schema.
+   * @param columnCount The number of columns.
+   */
+  inline void prepareColumns(const char* id, ArrayCref array, FieldSchema& schema, std::size_t columnCount)
+  {
+    if (!array.isStruct())
+    {
+      throw Exception{id, "input must be a struct array"};
+    }
+
+    checkColumnCount(id, schema, columnCount);
+
+    schema.bind(array);
+  }
+
+  /**
+   * @brief Creates a scalar array holding a column element.
+   * @tparam T Element type
+   * @param value The value
+   * @return The scalar array
+   */
+  template<typename T>
+  [[nodiscard]] Array makeColumnScalar(const T& value)
+  {
+    if constexpr (std::is_same_v<T, bool>)
+    {
+      return makeLogicalScalar(value);
+    }
+    else
+    {
+      return makeNumericScalar<T>(value);
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Converts a struct array of scalar fields to structure-of-arrays columns, one std::vector per field selected
+   *        by the schema. Each field must hold numeric, logical or char scalars of one class in all elements, the
+   *        values are converted to the column type with MATLAB cast semantics. The class check is fused with the copy
+   *        and large arrays are gathered in parallel.
+   * @tparam Ts Column element types, one per schema field
+   * @param array The struct array.
+   * @param schema The schema, bound to the array's layout if it is not already.
+   * @return The columns, in the order of the schema fields.
+   */
+  template<typename... Ts>
+  [[nodiscard]] std::tuple<std::vector<Ts>...> toColumns(ArrayCref array, FieldSchema& schema)
+  {
+    static_assert((detail::isConvertTarget<Ts> && ...), "unsupported column type");
+
+    detail::prepareColumns("matlabw:mx:algorithm:toColumns", array, schema, sizeof...(Ts));
+
+    std::tuple<std::vector<Ts>...> columns{std::vector<Ts>(array.getSize())...};
+
+    detail::gatherColumns(array, schema, columns);
+
+    return columns;
+  }
+
+  /**
+   * @brief Converts a struct array of scalar fields to structure-of-arrays columns, one numeric column vector per
+   *        field selected by the schema, see toColumns().
+   * @tparam Ts Column element types, one per schema field
+   * @param array The struct array.
+   * @param schema The schema, bound to the array's layout if it is not already.
+   * @return The columns, in the order of the schema fields.
+   */
+  template<typename... Ts>
+  [[nodiscard]] std::tuple<NumericArray<Ts>...> toColumnArrays(ArrayCref array, FieldSchema& schema)
+  {
+    static_assert((detail::isConvertTarget<Ts> && ...), "unsupported column type");
+
+    detail::prepareColumns("matlabw:mx:algorithm:toColumnArrays", array, schema, sizeof...(Ts));
+
+    const std::size_t n = array.getSize();
+
+    std::tuple<NumericArray<Ts>...> columns{makeUninitNumericArray<Ts>(n, 1)...};
+
+    detail::gatherColumns(array, schema, columns);
+
+    return columns;
+  }
+
+  /**
+   * @brief Builds a struct array from structure-of-arrays columns, the reverse of toColumns(). Element i gets the
+   *        scalar column[i] in each field. Array creation is not thread-safe in MATLAB, the build is serial.
+   * @tparam Cs Column types, array-likes of numeric or bool elements
+   * @param dims The dimensions of the struct array.
+   * @param schema The schema naming the fields, one per column.
+   * @param columns The columns, each with one element per struct element.
+   * @return The struct array.
+   */
+  template<typename... Cs>
+  [[nodiscard]] StructArray fromColumns(View<std::size_t> dims, const FieldSchema& schema, const Cs&... columns)
+  {
+    static_assert(((isNumeric<detail::ElementOf<Cs>> || std::is_same_v<detail::ElementOf<Cs>, bool>) && ...),
+                  "unsupported column type");
+
+    static constexpr char id[]{"matlabw:mx:algorithm:fromColumns"};
+
+    detail::checkColumnCount(id, schema, sizeof...(Cs));
+
+    const std::size_t n = std::accumulate(dims.begin(), dims.end(), std::size_t{1}, std::multiplies<>{});
+
+    detail::checkSizes(id, n, detail::toSpan(columns).size()...);
+
+    std::vector<const char*> fieldNames(schema.getFieldCount());
+
+    for (std::size_t k{}; k < fieldNames.size(); ++k)
+    {
+      fieldNames[k] = schema.getFieldName(k).c_str();
+    }
+
+    StructArray array = makeStructArray(dims, fieldNames);
+
+    [&]<std::size_t... ks>(std::index_sequence<ks...>)
+    {
+      ([&](const auto& column)
+      {
+        const auto span = detail::toSpan(column);
+
+        for (std::size_t i{}; i < n; ++i)
+        {
+          mxSetFieldByNumber(array.get(), i, static_cast<int>(ks), detail::makeColumnScalar(span[i]).release());
+        }
+      }(columns), ...);
+    }(std::index_sequence_for<Cs...>{});
+
+    return array;
+  }
+
+  /**
+   * @brief Builds an n-by-1 struct array from structure-of-arrays columns, see fromColumns().
+   * @tparam Cs Column types, array-likes of numeric or bool elements
+   * @param schema The schema naming the fields, one per column.
+   * @param first The first column, fixes the number of elements.
+   * @param columns The other columns.
+   * @return The struct array.
+   */
+  template<typename C, typename... Cs>
+  [[nodiscard]] StructArray fromColumns(const FieldSchema& schema, const C& first, const Cs&... columns)
+  {
+    const std::size_t dims[]{detail::toSpan(first).size(), 1};
+
+    return fromColumns(View<std::size_t>{dims}, schema, first, columns...);
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_COLUMNS_HPP */
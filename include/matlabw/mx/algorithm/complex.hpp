@@ -0,0 +1,474 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_COMPLEX_HPP
+#define MATLABW_MX_ALGORITHM_COMPLEX_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+#include <limits>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define MATLABW_COMPLEX_SSE2
+#endif
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../Arena.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /// @brief Complex conjugate operation.
+  struct ConjOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return T{x.real(), -x.imag()}; }
+  };
+
+  /// @brief Phase angle operation.
+  struct ArgOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE auto operator()(T x) const noexcept { return std::atan2(x.imag(), x.real()); }
+  };
+
+  /// @brief Conjugate multiply-add operation, conj(a) * b + c.
+  struct ConjMultiplyAddOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T a, T b, T c) const noexcept
+    {
+      return multiplyAdd(ConjOp{}(a), b, c);
+    }
+  };
+
+#ifdef MATLABW_COMPLEX_SSE2
+  /**
+   * @brief Splits interleaved doubles with shuffles, the default -O2 of MEX builds does not vectorize the scalar loop.
+   * @param src Interleaved input pointer
+   * @param re Real part output pointer
+   * @param im Imaginary part output pointer
+   * @param n Number of complex elements
+   * @return Number of elements processed, the remainder is left to the caller
+   */
+  MATLABW_ALWAYS_INLINE std::size_t splitSse2(const double* src, double* re, double* im, std::size_t n) noexcept
+  {
+    std::size_t i{};
+
+    for (; i + 2 <= n; i += 2)
+    {
+      const __m128d a = _mm_loadu_pd(src + 2 * i);
+      const __m128d b = _mm_loadu_pd(src + 2 * i + 2);
+
+      _mm_storeu_pd(re + i, _mm_unpacklo_pd(a, b));
+      _mm_storeu_pd(im + i, _mm_unpackhi_pd(a, b));
+    }
+
+    return i;
+  }
+
+  /// @copydoc splitSse2
+  MATLABW_ALWAYS_INLINE std::size_t splitSse2(const float* src, float* re, float* im, std::size_t n) noexcept
+  {
+    std::size_t i{};
+
+    for (; i + 4 <= n; i += 4)
+    {
+      const __m128 a = _mm_loadu_ps(src + 2 * i);
+      const __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+
+      _mm_storeu_ps(re + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(im + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    return i;
+  }
+
+  /**
+   * @brief Interleaves doubles with shuffles.
+   * @param re Real part input pointer
+   * @param im Imaginary part input pointer
+   * @param dst Interleaved output pointer
+   * @param n Number of complex elements
+   * @return Number of elements processed, the remainder is left to the caller
+   */
+  MATLABW_ALWAYS_INLINE std::size_t mergeSse2(const double* re, const double* im, double* dst, std::size_t n) noexcept
+  {
+    std::size_t i{};
+
+    for (; i + 2 <= n; i += 2)
+    {
+      const __m128d a = _mm_loadu_pd(re + i);
+      const __m128d b = (im != nullptr) ? _mm_loadu_pd(im + i) : _mm_setzero_pd();
+
+      _mm_storeu_pd(dst + 2 * i,     _mm_unpacklo_pd(a, b));
+      _mm_storeu_pd(dst + 2 * i + 2, _mm_unpackhi_pd(a, b));
+    }
+
+    return i;
+  }
+
+  /// @copydoc mergeSse2
+  MATLABW_ALWAYS_INLINE std::size_t mergeSse2(const float* re, const float* im, float* dst, std::size_t n) noexcept
+  {
+    std::size_t i{};
+
+    for (; i + 4 <= n; i += 4)
+    {
+      const __m128 a = _mm_loadu_ps(re + i);
+      const __m128 b = (im != nullptr) ? _mm_loadu_ps(im + i) : _mm_setzero_ps();
+
+      _mm_storeu_ps(dst + 2 * i,     _mm_unpacklo_ps(a, b));
+      _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(a, b));
+    }
+
+    return i;
+  }
+#endif
+
+  /**
+   * @brief Splits interleaved complex values into real and imaginary planes.
+   * @tparam R Real type
+   * @param in Interleaved input pointer
+   * @param re Real part output pointer
+   * @param im Imaginary part output pointer
+   * @param n Number of elements
+   */
+  template<typename R>
+  MATLABW_ALWAYS_INLINE void splitLoop(const std::complex<R>* in, R* re, R* im, std::size_t n) noexcept
+  {
+    // std::complex is layout compatible with R[2], plain loads let the compiler use vector shuffles.
+    const R* src = reinterpret_cast<const R*>(in);
+
+    std::size_t i{};
+
+#ifdef MATLABW_COMPLEX_SSE2
+    i = splitSse2(src, re, im, n);
+#endif
+
+    for (; i < n; ++i)
+    {
+      re[i] = src[2 * i];
+      im[i] = src[2 * i + 1];
+    }
+  }
+
+  /**
+   * @brief Interleaves real and imaginary planes into complex values.
+   * @tparam R Real type
+   * @param re Real part input pointer
+   * @param im Imaginary part input pointer, nullptr for a zero imaginary part
+   * @param out Interleaved output pointer
+   * @param n Number of elements
+   */
+  template<typename R>
+  MATLABW_ALWAYS_INLINE void mergeLoop(const R* re, const R* im, std::complex<R>* out, std::size_t n) noexcept
+  {
+    R* dst = reinterpret_cast<R*>(out);
+
+    std::size_t i{};
+
+#ifdef MATLABW_COMPLEX_SSE2
+    i = mergeSse2(re, im, dst, n);
+#endif
+
+    if (im == nullptr)
+    {
+      for (; i < n; ++i)
+      {
+        dst[2 * i]     = re[i];
+        dst[2 * i + 1] = R{};
+      }
+    }
+    else
+    {
+      for (; i < n; ++i)
+      {
+        dst[2 * i]     = re[i];
+        dst[2 * i + 1] = im[i];
+      }
+    }
+  }
+  /// @brief Alignment of planar buffers allocated from an arena, a cache line.
+  inline constexpr std::size_t planarAlignment{64};
+
+  /**
+   * @brief Allocates an uninitialized plane from an arena.
+   * @tparam R Real type
+   * @param arena The arena
+   * @param n Number of elements
+   * @return The plane
+   */
+  template<typename R>
+  [[nodiscard]] Span<R> allocatePlane(Arena& arena, std::size_t n)
+  {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(R))
+    {
+      throw std::bad_alloc();
+    }
+
+    return Span<R>{static_cast<R*>(arena.allocate(n * sizeof(R), planarAlignment)), n};
+  }
+} // namespace detail
+
+  /**
+   * @brief Separate real and imaginary planes of complex values, the split layout of legacy C and Fortran libraries
+   *        and of pre-R2018a MEX files. The planes are not owned, typically they live in a scratch arena.
+   * @tparam R Real type
+   */
+  template<typename R>
+  struct PlanarComplex
+  {
+    Span<R> re{}; ///< Real parts
+    Span<R> im{}; ///< Imaginary parts
+
+    /**
+     * @brief Gets the number of elements.
+     * @return The number of elements
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return re.size();
+    }
+  };
+
+  /**
+   * @brief Computes out = conj(in).
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...)
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param out Output, may be the same as the input
+   * @param in Complex input
+   */
+  template<typename Out, typename In>
+  void conj(Out&& out, const In& in)
+  {
+    auto dst = detail::toSpan(out);
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(src)>;
+
+    static_assert(detail::isComplex<T>, "input must be complex");
+    static_assert(std::is_same_v<T, detail::ElementType<decltype(dst)>>, "element types must match");
+
+    detail::checkSizes("matlabw:mx:algorithm:conj", dst.size(), src.size());
+    detail::transform(detail::ConjOp{}, dst.size(), dst.data(), src.data());
+  }
+
+  /**
+   * @brief Computes out = angle(in), the phase angle in [-pi, pi].
+   * @param out Real output
+   * @param in Complex input
+   */
+  template<typename Out, typename In>
+  void arg(Out&& out, const In& in)
+  {
+    auto dst = detail::toSpan(out);
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(src)>;
+
+    static_assert(detail::isComplex<T>, "input must be complex");
+    static_assert(std::is_same_v<detail::RealType<T>, detail::ElementType<decltype(dst)>>,
+                  "output element type must be the real type of the input");
+
+    detail::checkSizes("matlabw:mx:algorithm:arg", dst.size(), src.size());
+    detail::transform(detail::ArgOp{}, dst.size(), dst.data(), src.data());
+  }
+
+  /**
+   * @brief Computes out = conj(a) * b + c, e.g. for cross-spectra. Real and imaginary parts are fused with a single
+   *        rounding each.
+   * @param out Output, may be the same as an input
+   * @param a First factor, conjugated
+   * @param b Second factor
+   * @param c Addend
+   */
+  template<typename Out, typename InA, typename InB, typename InC>
+  void conjMultiplyAdd(Out&& out, const InA& a, const InB& b, const InC& c)
+  {
+    auto dst  = detail::toSpan(out);
+    auto srcA = detail::toSpan(a);
+    auto srcB = detail::toSpan(b);
+    auto srcC = detail::toSpan(c);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(detail::isComplex<T>, "elements must be complex");
+    static_assert(std::is_same_v<T, detail::ElementType<decltype(srcA)>> &&
+                  std::is_same_v<T, detail::ElementType<decltype(srcB)>> &&
+                  std::is_same_v<T, detail::ElementType<decltype(srcC)>>, "element types must match");
+
+    detail::checkSizes("matlabw:mx:algorithm:conjMultiplyAdd", dst.size(), srcA.size(), srcB.size(), srcC.size());
+    detail::transform(detail::ConjMultiplyAddOp{}, dst.size(), dst.data(), srcA.data(), srcB.data(), srcC.data());
+  }
+
+  /**
+   * @brief Splits interleaved complex values into separate real and imaginary arrays, as real(in) and imag(in).
+   * @tparam OutRe Real part output array type
+   * @tparam OutIm Imaginary part output array type
+   * @tparam In Complex input array type
+   * @param re Real part output
+   * @param im Imaginary part output
+   * @param in Complex input
+   */
+  template<typename OutRe, typename OutIm, typename In>
+  void toPlanar(OutRe&& re, OutIm&& im, const In& in)
+  {
+    auto dstRe = detail::toSpan(re);
+    auto dstIm = detail::toSpan(im);
+    auto src   = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(src)>;
+    using R = detail::RealType<T>;
+
+    static_assert(detail::isComplex<T>, "input must be complex");
+    static_assert(std::is_same_v<R, detail::ElementType<decltype(dstRe)>> &&
+                  std::is_same_v<R, detail::ElementType<decltype(dstIm)>>,
+                  "output element types must be the real type of the input");
+
+    detail::checkSizes("matlabw:mx:algorithm:toPlanar", src.size(), dstRe.size(), dstIm.size());
+
+    const T* pIn = src.data();
+    R*       pRe = dstRe.data();
+    R*       pIm = dstIm.data();
+
+    detail::forChunks(src.size(), [=](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+    {
+      detail::splitLoop(pIn + first, pRe + first, pIm + first, last - first);
+    });
+  }
+
+  /**
+   * @brief Splits interleaved complex values into planes allocated from an arena, e.g. mex::getScratchArena(), so
+   *        legacy split-complex routines can be called without per-call heap allocations. The planes are aligned to
+   *        a cache line and stay valid until the arena is reset.
+   * @tparam In Complex input array type
+   * @param arena The arena
+   * @param in Complex input
+   * @return The planes
+   */
+  template<typename In>
+  [[nodiscard]] auto toPlanar(Arena& arena, const In& in)
+  {
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(src)>;
+    using R = detail::RealType<T>;
+
+    static_assert(detail::isComplex<T>, "input must be complex");
+
+    PlanarComplex<R> planar{detail::allocatePlane<R>(arena, src.size()), detail::allocatePlane<R>(arena, src.size())};
+
+    toPlanar(planar.re, planar.im, src);
+
+    return planar;
+  }
+
+  /**
+   * @brief Combines separate real and imaginary arrays into interleaved complex values, as complex(re, im).
+   * @tparam Out Complex output array type
+   * @tparam InRe Real part input array type
+   * @tparam InIm Imaginary part input array type
+   * @param out Complex output
+   * @param re Real part input
+   * @param im Imaginary part input
+   */
+  template<typename Out, typename InRe, typename InIm>
+  void toInterleaved(Out&& out, const InRe& re, const InIm& im)
+  {
+    auto dst   = detail::toSpan(out);
+    auto srcRe = detail::toSpan(re);
+    auto srcIm = detail::toSpan(im);
+
+    using T = detail::ElementType<decltype(dst)>;
+    using R = detail::RealType<T>;
+
+    static_assert(detail::isComplex<T>, "output must be complex");
+    static_assert(std::is_same_v<R, detail::ElementType<decltype(srcRe)>> &&
+                  std::is_same_v<R, detail::ElementType<decltype(srcIm)>>,
+                  "input element types must be the real type of the output");
+
+    detail::checkSizes("matlabw:mx:algorithm:toInterleaved", dst.size(), srcRe.size(), srcIm.size());
+
+    const R* pRe  = srcRe.data();
+    const R* pIm  = srcIm.data();
+    T*       pOut = dst.data();
+
+    detail::forChunks(dst.size(), [=](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+    {
+      detail::mergeLoop(pRe + first, pIm + first, pOut + first, last - first);
+    });
+  }
+
+  /**
+   * @brief Converts real values to interleaved complex values with zero imaginary part, as complex(re).
+   * @param out Complex output
+   * @param re Real input
+   */
+  template<typename Out, typename InRe>
+  void toInterleaved(Out&& out, const InRe& re)
+  {
+    auto dst   = detail::toSpan(out);
+    auto srcRe = detail::toSpan(re);
+
+    using T = detail::ElementType<decltype(dst)>;
+    using R = detail::RealType<T>;
+
+    static_assert(detail::isComplex<T>, "output must be complex");
+    static_assert(std::is_same_v<R, detail::ElementType<decltype(srcRe)>>,
+                  "input element type must be the real type of the output");
+
+    detail::checkSizes("matlabw:mx:algorithm:toInterleaved", dst.size(), srcRe.size());
+
+    const R* pRe  = srcRe.data();
+    T*       pOut = dst.data();
+
+    detail::forChunks(dst.size(), [=](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+    {
+      detail::mergeLoop<R>(pRe + first, nullptr, pOut + first, last - first);
+    });
+  }
+
+  /**
+   * @brief Combines planes into interleaved complex values, e.g. the results of a split-complex routine.
+   * @tparam Out Complex output array type
+   * @tparam R Real type
+   * @param out Complex output
+   * @param planar The planes
+   */
+  template<typename Out, typename R>
+  void toInterleaved(Out&& out, const PlanarComplex<R>& planar)
+  {
+    toInterleaved(out, View<R>{planar.re}, View<R>{planar.im});
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_COMPLEX_HPP */
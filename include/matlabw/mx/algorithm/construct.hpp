@@ -0,0 +1,322 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_CONSTRUCT_HPP
+#define MATLABW_MX_ALGORITHM_CONSTRUCT_HPP
+
+#include "../detail/include.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <ranges>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define MATLABW_CONSTRUCT_SSE2
+#endif
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /**
+   * @brief Minimum number of bytes filled with non-temporal stores. Smaller outputs likely fit in the cache and are
+   *        read back soon, bypassing the cache would slow the reader down.
+   */
+  inline constexpr std::size_t streamMinBytes{std::size_t{1} << 23};
+
+  /**
+   * @brief Fills memory with non-temporal stores, which bypass the cache and skip reading the destination lines.
+   * @tparam T Element type, its size must divide 16.
+   * @param out Output pointer
+   * @param n Number of elements
+   * @param value The value
+   */
+  template<typename T>
+  void fillStream(T* out, std::size_t n, const T& value) noexcept
+  {
+    std::size_t i{};
+
+#ifdef MATLABW_CONSTRUCT_SSE2
+    static_assert(16 % sizeof(T) == 0, "element size must divide 16");
+
+    alignas(16) T pattern[16 / sizeof(T)];
+    std::fill(std::begin(pattern), std::end(pattern), value);
+
+    const __m128i vector = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern));
+
+    for (; i < n && !isAligned(out + i, 16); ++i)
+    {
+      out[i] = value;
+    }
+
+    for (; i + std::size(pattern) <= n; i += std::size(pattern))
+    {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(out + i), vector);
+    }
+
+    // Non-temporal stores are weakly ordered, the fence orders them before the stores of the caller.
+    _mm_sfence();
+#endif
+
+    std::fill(out + i, out + n, value);
+  }
+
+  /**
+   * @brief Copies memory with non-temporal stores, which bypass the cache and skip reading the destination lines.
+   * @tparam T Element type, its size must divide 16.
+   * @param out Output pointer, must not overlap the input
+   * @param in Input pointer
+   * @param n Number of elements
+   */
+  template<typename T>
+  void copyStream(T* out, const T* in, std::size_t n) noexcept
+  {
+    std::size_t i{};
+
+#ifdef MATLABW_CONSTRUCT_SSE2
+    static_assert(16 % sizeof(T) == 0, "element size must divide 16");
+
+    constexpr std::size_t width = 16 / sizeof(T);
+
+    for (; i < n && !isAligned(out + i, 16); ++i)
+    {
+      out[i] = in[i];
+    }
+
+    for (; i + width <= n; i += width)
+    {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(out + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+    }
+
+    // Non-temporal stores are weakly ordered, the fence orders them before the stores of the caller.
+    _mm_sfence();
+#endif
+
+    std::copy(in + i, in + n, out + i);
+  }
+
+  /**
+   * @brief Checks that the number of elements of a range matches the dimensions.
+   * @param id Error identifier
+   * @param expected Product of the dimensions
+   * @param actual Number of elements of the range
+   */
+  inline void checkRangeSize(const char* id, std::size_t expected, std::size_t actual)
+  {
+    if (expected != actual)
+    {
+      throw Exception{id, "number of range elements must match the dimensions"};
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Creates a numeric array from the elements of a range. Contiguous ranges of the element type are copied
+   *        with memcpy and random access ranges are converted element by element, both in parallel for large arrays.
+   *        Other ranges are read sequentially. The array is created uninitialized, so its pages are first touched by,
+   *        and placed on the NUMA node of, the thread filling them.
+   * @tparam T Element type
+   * @tparam R Range type
+   * @param dims Dimensions, their product must equal the number of elements of the range.
+   * @param range The range
+   * @return Numeric array
+   */
+  template<typename T, std::ranges::input_range R>
+  [[nodiscard]] NumericArray<T> makeNumericArray(View<std::size_t> dims, R&& range)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:makeNumericArray"};
+
+    static_assert(std::is_convertible_v<std::ranges::range_reference_t<R>, T>, "range elements must convert to T");
+
+    NumericArray<T> array = makeUninitNumericArray<T>(dims);
+    T*              out   = array.getData();
+
+    const std::size_t n = array.getSize();
+
+    if constexpr (std::ranges::sized_range<R>)
+    {
+      detail::checkRangeSize(id, n, static_cast<std::size_t>(std::ranges::size(range)));
+    }
+
+    if constexpr (std::ranges::contiguous_range<R> && std::is_same_v<std::ranges::range_value_t<R>, T>)
+    {
+      const T* in = std::ranges::data(range);
+
+      detail::forChunks(n, [&](std::size_t first, std::size_t last)
+      {
+        std::memcpy(out + first, in + first, (last - first) * sizeof(T));
+      });
+    }
+    else if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>)
+    {
+      auto in = std::ranges::begin(range);
+
+      detail::forChunks(n, [&](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+      {
+        for (std::size_t i{first}; i < last; ++i)
+        {
+          out[i] = static_cast<T>(in[static_cast<std::ranges::range_difference_t<R>>(i)]);
+        }
+      });
+    }
+    else
+    {
+      std::size_t i{};
+
+      for (auto&& element : range)
+      {
+        if (i == n)
+        {
+          detail::checkRangeSize(id, n, n + 1);
+        }
+
+        out[i++] = static_cast<T>(element);
+      }
+
+      detail::checkRangeSize(id, n, i);
+    }
+
+    return array;
+  }
+
+  /**
+   * @brief Creates a zeroed numeric array whose pages are first touched by the threads of the library-managed thread
+   *        pool, instead of being zeroed on the MATLAB thread by makeNumericArray(). With
+   *        parallel::ThreadPoolOptions::numaPinning each block of the array is placed on the NUMA node of the worker
+   *        which processes it in later parallel kernels.
+   * @tparam T Element type
+   * @param dims Dimensions
+   * @return Zeroed numeric array
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> makeFirstTouchNumericArray(View<std::size_t> dims)
+  {
+    NumericArray<T> array = makeUninitNumericArray<T>(dims);
+    T*              out   = array.getData();
+
+    detail::forChunks(array.getSize(), [&](std::size_t first, std::size_t last)
+    {
+      std::memset(static_cast<void*>(out + first), 0, (last - first) * sizeof(T));
+    });
+
+    return array;
+  }
+
+  /**
+   * @brief Creates a numeric array whose elements are computed from their linear index, in parallel for large arrays.
+   *        The function must not call the MATLAB API.
+   * @tparam T Element type
+   * @tparam Fn Function type, called as fn(i) and returning a value convertible to T.
+   * @param dims Dimensions
+   * @param fn The function
+   * @return Numeric array
+   */
+  template<typename T, typename Fn>
+  [[nodiscard]] NumericArray<T> generate(View<std::size_t> dims, Fn&& fn)
+  {
+    NumericArray<T> array = makeUninitNumericArray<T>(dims);
+    T*              out   = array.getData();
+
+    detail::forChunks(array.getSize(), [&](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+    {
+      for (std::size_t i{first}; i < last; ++i)
+      {
+        out[i] = static_cast<T>(fn(i));
+      }
+    });
+
+    return array;
+  }
+
+  /**
+   * @brief Sets all elements to a value, in parallel for large arrays. Outputs above 8 MiB are written with
+   *        non-temporal stores, which run at the write bandwidth of the memory.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...)
+   * @param out Output
+   * @param value The value
+   */
+  template<typename Out>
+  void fill(Out&& out, detail::ElementOf<Out> value)
+  {
+    auto dst = detail::toSpan(out);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(detail::Numeric<T>, "unsupported element type");
+
+    if (dst.size_bytes() < detail::streamMinBytes)
+    {
+      std::fill(dst.begin(), dst.end(), value);
+      return;
+    }
+
+    detail::forChunks(dst.size(), [&](std::size_t first, std::size_t last)
+    {
+      detail::fillStream(dst.data() + first, last - first, value);
+    });
+  }
+
+  /**
+   * @brief Copies the elements of an input to an output of the same element type, in parallel for large arrays.
+   *        Outputs above 8 MiB are written with non-temporal stores, so a big copy does not evict the working set of
+   *        the caller from the cache.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...)
+   * @tparam In Input array type
+   * @param out Output, must not overlap the input
+   * @param in Input of the same size
+   */
+  template<typename Out, typename In>
+  void copy(Out&& out, const In& in)
+  {
+    auto dst = detail::toSpan(out);
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(detail::Numeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<detail::ElementType<decltype(src)>, T>, "element types must match");
+
+    detail::checkSizes("matlabw:mx:algorithm:copy", dst.size(), src.size());
+
+    if (dst.size_bytes() < detail::streamMinBytes)
+    {
+      std::copy(src.begin(), src.end(), dst.begin());
+      return;
+    }
+
+    detail::forChunks(dst.size(), [&](std::size_t first, std::size_t last)
+    {
+      detail::copyStream(dst.data() + first, src.data() + first, last - first);
+    });
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_CONSTRUCT_HPP */
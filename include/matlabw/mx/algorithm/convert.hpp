@@ -0,0 +1,193 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_CONVERT_HPP
+#define MATLABW_MX_ALGORITHM_CONVERT_HPP
+
+#include "../detail/include.hpp"
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "../NumericArray.hpp"
+#include "../visit.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /**
+   * @brief Is the type a target of the conversions? Any MATLAB numeric class, real or complex.
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isConvertTarget = isReal<T> || (isComplexNumeric<T> && isReal<RealType<T>>);
+
+  /**
+   * @brief Is the type a source of the conversions? Any numeric class, logical or char.
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isConvertSource = isConvertTarget<T> || std::is_same_v<T, bool> || std::is_same_v<T, char16_t>;
+
+  /**
+   * @brief Converts a real value with MATLAB cast semantics, chars convert by their code unit.
+   * @tparam T Real target type
+   * @tparam U Real source type
+   * @param x The value
+   * @return The converted value
+   */
+  template<typename T, typename U>
+  MATLABW_ALWAYS_INLINE constexpr T convertReal(U x) noexcept
+  {
+    if constexpr (std::is_same_v<U, char16_t>)
+    {
+      return saturateCast<T>(static_cast<std::uint16_t>(x));
+    }
+    else
+    {
+      return saturateCast<T>(x);
+    }
+  }
+
+  /**
+   * @brief Converts a value with MATLAB cast semantics, real values convert to complex with zero imaginary part.
+   * @tparam T Target type
+   * @tparam U Source type, must not be complex for real targets
+   * @param x The value
+   * @return The converted value
+   */
+  template<typename T, typename U>
+  MATLABW_ALWAYS_INLINE constexpr T convertValue(U x) noexcept
+  {
+    if constexpr (isComplexNumeric<T> && isComplexNumeric<U>)
+    {
+      return T{convertReal<RealType<T>>(x.real()), convertReal<RealType<T>>(x.imag())};
+    }
+    else if constexpr (isComplexNumeric<T>)
+    {
+      return T{convertReal<RealType<T>>(x), RealType<T>{}};
+    }
+    else
+    {
+      return convertReal<T>(x);
+    }
+  }
+
+  /**
+   * @brief Converts elements.
+   * @tparam T Target type
+   * @tparam U Source type
+   * @param out Output pointer
+   * @param in Input pointer
+   * @param n Number of elements
+   */
+  template<typename T, typename U>
+  void convert(T* out, const U* in, std::size_t n)
+  {
+    if constexpr (std::is_same_v<T, U>)
+    {
+      std::copy_n(in, n, out);
+    }
+    else
+    {
+      transform([](U x) MATLABW_INLINE_LAMBDA { return convertValue<T>(x); }, n, out, in);
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Converts any numeric, logical or char array into caller-provided memory, with the saturating and rounding
+   *        semantics of MATLAB's casts such as double() and int32(). NaN converts to zero for integers.
+   * @tparam T Target element type
+   * @param out Output, must have the same number of elements as the input
+   * @param in Input, complex inputs require a complex output
+   */
+  template<typename T>
+  void convertInto(std::span<T> out, ArrayCref in)
+  {
+    static_assert(detail::isConvertTarget<T>, "unsupported target type");
+
+    static constexpr char id[]{"matlabw:mx:algorithm:convertInto"};
+
+    detail::checkSizes(id, out.size(), in.getSize());
+
+    visit(in, [&](auto src)
+    {
+      using U = std::remove_cv_t<std::remove_pointer_t<decltype(src.getData())>>;
+
+      if constexpr (!requires { src.getData(); } || !detail::isConvertSource<U>)
+      {
+        throw Exception{id, "input must be numeric, logical or char"};
+      }
+      else if constexpr (isComplexNumeric<U> && !isComplexNumeric<T>)
+      {
+        throw Exception{id, "complex input requires a complex output"};
+      }
+      else
+      {
+        detail::convert(out.data(), src.getData(), src.getSize());
+      }
+    });
+  }
+
+  /**
+   * @brief Converts any numeric, logical or char array into an existing typed array, with the saturating and
+   *        rounding semantics of MATLAB's casts such as double() and int32(). NaN converts to zero for integers.
+   * @tparam T Target element type
+   * @param out Output, must have the same number of elements as the input
+   * @param in Input, complex inputs require a complex output
+   */
+  template<typename T>
+  void convertInto(TypedArrayRef<T> out, ArrayCref in)
+  {
+    convertInto(std::span<T>{out.getData(), out.getSize()}, in);
+  }
+
+  /**
+   * @brief Converts any numeric, logical or char array to a new numeric array of the same dimensions, with the
+   *        saturating and rounding semantics of MATLAB's casts such as double() and int32().
+   * @tparam T Target element type
+   * @param in Input, complex inputs require a complex target type
+   * @return The converted array
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> convertTo(ArrayCref in)
+  {
+    static_assert(detail::isConvertTarget<T>, "unsupported target type");
+
+    if (in.isComplex() && !isComplexNumeric<T>)
+    {
+      throw Exception{"matlabw:mx:algorithm:convertTo", "complex input requires a complex target type"};
+    }
+
+    NumericArray<T> out = makeUninitNumericArray<T>(in.getDims());
+
+    convertInto<T>(out, in);
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_CONVERT_HPP */
@@ -0,0 +1,745 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_CONVOLUTION_HPP
+#define MATLABW_MX_ALGORITHM_CONVOLUTION_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <unordered_map>
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "mask.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Part of the convolution returned, as the shape argument of conv and conv2.
+  enum class ConvShape
+  {
+    full,  ///< The full convolution
+    same,  ///< The central part of the size of the first input
+    valid, ///< The part computed without the zero-padded edges
+  };
+
+namespace detail
+{
+  /// @brief Number of outputs of a block of the direct kernel, the block stays in the L1 cache for all filter taps.
+  inline constexpr std::size_t convDirectBlockSize{1024};
+
+  /// @brief Number of outputs updated together by the direct kernel.
+  inline constexpr std::size_t convDirectGroupSize{8};
+
+  /// @brief Minimum number of multiply-adds of a convolution computed in parallel.
+  inline constexpr std::size_t convParallelMinWork{std::size_t{1} << 22};
+
+  /// @brief Cost of one complex FFT butterfly relative to one real multiply-add of the direct kernel, measured.
+  inline constexpr double fftButterflyCost{40.0};
+
+  /// @brief Minimum FFT size of the overlap-save blocks.
+  inline constexpr std::size_t fftMinSize{64};
+
+  /**
+   * @brief Result element type of a convolution, complex if any input is complex.
+   * @tparam A First element type
+   * @tparam B Second element type
+   */
+  template<typename A, typename B>
+  using ConvType = std::conditional_t<isComplex<A> || isComplex<B>, std::complex<RealType<A>>, A>;
+
+  /**
+   * @brief Checks the element types of a convolution.
+   * @tparam A First element type
+   * @tparam B Second element type
+   */
+  template<typename A, typename B>
+  inline constexpr bool isConvolvable = (RealFloat<A> || isComplex<A>) && (RealFloat<B> || isComplex<B>)
+                                        && std::is_same_v<RealType<A>, RealType<B>>;
+
+  /**
+   * @brief Number of real multiply-adds of one multiply-add of the direct kernel.
+   * @tparam A First factor type
+   * @tparam B Second factor type
+   */
+  template<typename A, typename B>
+  inline constexpr double convMultiplyAddCost = (isComplex<A> ? 2.0 : 1.0) * (isComplex<B> ? 2.0 : 1.0);
+
+  /**
+   * @brief Computes a * b + c for real and complex factors, a real factor scales both parts.
+   * @tparam Out Result type
+   * @tparam A First factor type
+   * @tparam B Second factor type
+   * @param a First factor
+   * @param b Second factor
+   * @param c Addend
+   * @return The result
+   */
+  template<typename Out, typename A, typename B>
+  MATLABW_ALWAYS_INLINE Out convMultiplyAdd(A a, B b, Out c) noexcept
+  {
+    if constexpr (isComplex<A> == isComplex<B>)
+    {
+      return multiplyAdd<Out>(a, b, c);
+    }
+    else if constexpr (isComplex<A>)
+    {
+      return Out{multiplyAdd(b, a.real(), c.real()), multiplyAdd(b, a.imag(), c.imag())};
+    }
+    else
+    {
+      return Out{multiplyAdd(a, b.real(), c.real()), multiplyAdd(a, b.imag(), c.imag())};
+    }
+  }
+
+  /// @brief Range of the full convolution returned for a shape.
+  struct ConvRange
+  {
+    std::size_t offset; ///< Index of the first output in the full convolution
+    std::size_t size;   ///< Number of outputs
+  };
+
+  /**
+   * @brief Gets the range of the full convolution returned for a shape, along one dimension.
+   * @param n Size of the first input
+   * @param m Size of the second input
+   * @param shape The shape
+   * @return The range
+   */
+  [[nodiscard]] constexpr ConvRange getConvRange(std::size_t n, std::size_t m, ConvShape shape) noexcept
+  {
+    switch (shape)
+    {
+    case ConvShape::same:
+      return ConvRange{m / 2, n};
+    case ConvShape::valid:
+      return ConvRange{(m == 0) ? 0 : m - 1, (n >= m) ? n - m + 1 : 0};
+    default:
+      return ConvRange{0, (n == 0 || m == 0) ? 0 : n + m - 1};
+    }
+  }
+
+  /**
+   * @brief Radix-2 complex FFT of a power of two size with precomputed twiddles, unscaled in both directions.
+   * @tparam R Real type
+   */
+  template<typename R>
+  class Fft
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param size The size, a power of two
+       */
+      explicit Fft(std::size_t size)
+      : mSize{size}, mTwiddles(size / 2), mReversed(size)
+      {
+        for (std::size_t k{}; k < size / 2; ++k)
+        {
+          const double angle = -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(size);
+
+          mTwiddles[k] = std::complex<R>{static_cast<R>(std::cos(angle)), static_cast<R>(std::sin(angle))};
+        }
+
+        const int bits = std::countr_zero(size);
+
+        for (std::size_t i{1}; i < size; ++i)
+        {
+          mReversed[i] = (mReversed[i >> 1] >> 1) | ((i & 1) << (bits - 1));
+        }
+      }
+
+      /**
+       * @brief Gets the size.
+       * @return The size
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Transforms data in place.
+       * @param data The data of size() values
+       * @param inverse Compute the inverse transform, scaled by size()
+       */
+      void transform(std::complex<R>* data, bool inverse) const noexcept
+      {
+        for (std::size_t i{}; i < mSize; ++i)
+        {
+          if (i < mReversed[i])
+          {
+            std::swap(data[i], data[mReversed[i]]);
+          }
+        }
+
+        const R sign = inverse ? R{-1} : R{1};
+
+        for (std::size_t half{1}; half < mSize; half *= 2)
+        {
+          const std::size_t step = mSize / (2 * half);
+
+          for (std::size_t start{}; start < mSize; start += 2 * half)
+          {
+            std::complex<R>* lo = data + start;
+            std::complex<R>* hi = lo + half;
+
+            for (std::size_t k{}; k < half; ++k)
+            {
+              const R wr = mTwiddles[k * step].real();
+              const R wi = mTwiddles[k * step].imag() * sign;
+              const R tr = wr * hi[k].real() - wi * hi[k].imag();
+              const R ti = wr * hi[k].imag() + wi * hi[k].real();
+
+              hi[k] = std::complex<R>{lo[k].real() - tr, lo[k].imag() - ti};
+              lo[k] = std::complex<R>{lo[k].real() + tr, lo[k].imag() + ti};
+            }
+          }
+        }
+      }
+    private:
+      std::size_t                  mSize;     ///< The size
+      std::vector<std::complex<R>> mTwiddles; ///< exp(-2 pi i k / size) for k < size / 2
+      std::vector<std::size_t>     mReversed; ///< Bit-reversed indices
+  };
+
+  /**
+   * @brief Gets a cached FFT of a size, the cache is per thread.
+   * @tparam R Real type
+   * @param size The size, a power of two
+   * @return The FFT
+   */
+  template<typename R>
+  [[nodiscard]] const Fft<R>& getFft(std::size_t size)
+  {
+    thread_local std::unordered_map<std::size_t, std::unique_ptr<Fft<R>>> cache{};
+
+    auto& fft = cache[size];
+
+    if (fft == nullptr)
+    {
+      fft = std::make_unique<Fft<R>>(size);
+    }
+
+    return *fft;
+  }
+
+  /**
+   * @brief Accumulates the direct convolution of a signal with a filter into a range of the full convolution. The
+   *        range is processed in blocks, each block accumulates all filter taps with contiguous loops.
+   * @tparam Out Output element type
+   * @tparam X Signal element type
+   * @tparam H Filter element type
+   * @param x The signal
+   * @param n Signal size
+   * @param h The filter
+   * @param m Filter size
+   * @param out The outputs, element k is the full convolution at first + k
+   * @param first Index of the first output
+   * @param last Index past the last output
+   */
+  template<typename Out, typename X, typename H>
+  MATLABW_ALWAYS_INLINE void convolveDirectKernel(const X*    x,
+                                                  std::size_t n,
+                                                  const H*    h,
+                                                  std::size_t m,
+                                                  Out*        out,
+                                                  std::size_t first,
+                                                  std::size_t last) noexcept
+  {
+    for (std::size_t j{}; j < m; ++j)
+    {
+      const std::size_t begin = std::max(first, j);
+      const std::size_t end   = std::min(last, j + n);
+
+      if (begin >= end)
+      {
+        continue;
+      }
+
+      const std::size_t count = end - begin;
+      const H           tap   = h[j];
+      const X*          src   = x + (begin - j);
+      Out*              dst   = out + (begin - first);
+
+      std::size_t k{};
+
+      // Groups of loads followed by stores are vectorized as straight-line code, also without loop vectorization.
+      for (; k + convDirectGroupSize <= count; k += convDirectGroupSize)
+      {
+        X   in[convDirectGroupSize];
+        Out acc[convDirectGroupSize];
+
+        for (std::size_t l{}; l < convDirectGroupSize; ++l)
+        {
+          in[l]  = src[k + l];
+          acc[l] = dst[k + l];
+        }
+
+        for (std::size_t l{}; l < convDirectGroupSize; ++l)
+        {
+          dst[k + l] = convMultiplyAdd<Out>(tap, in[l], acc[l]);
+        }
+      }
+
+      for (; k < count; ++k)
+      {
+        dst[k] = convMultiplyAdd<Out>(tap, src[k], dst[k]);
+      }
+    }
+  }
+
+  /**
+   * @brief Accumulates the direct convolution into a range of the full convolution, blocks run in parallel.
+   * @param parallel Use the library-managed thread pool for large ranges?
+   * @see convolveDirectKernel()
+   */
+  template<typename Out, typename X, typename H>
+  void convolveDirect(const X*    x,
+                      std::size_t n,
+                      const H*    h,
+                      std::size_t m,
+                      Out*        out,
+                      std::size_t first,
+                      std::size_t last,
+                      bool        parallel)
+  {
+    const std::size_t blockCount = (last - first + convDirectBlockSize - 1) / convDirectBlockSize;
+
+    auto block = [&](std::size_t b)
+    {
+      const std::size_t begin = first + b * convDirectBlockSize;
+      const std::size_t end   = std::min(begin + convDirectBlockSize, last);
+
+      dispatch([&]() MATLABW_INLINE_LAMBDA { convolveDirectKernel(x, n, h, m, out + begin - first, begin, end); });
+    };
+
+    if (parallel && (last - first) * m >= convParallelMinWork && blockCount > 1)
+    {
+      parallel::parallelFor(0, blockCount, 1, block);
+    }
+    else
+    {
+      for (std::size_t b{}; b < blockCount; ++b)
+      {
+        block(b);
+      }
+    }
+  }
+
+  /**
+   * @brief Gets the FFT size of the overlap-save blocks minimizing the cost per output.
+   * @param n Signal size
+   * @param m Filter size
+   * @return The size and the cost per output in real multiply-adds
+   */
+  [[nodiscard]] inline std::pair<std::size_t, double> getFftBlockSize(std::size_t n, std::size_t m) noexcept
+  {
+    const std::size_t maxSize = std::max(std::bit_ceil(n + m), fftMinSize);
+
+    std::size_t best{};
+    double      bestCost{std::numeric_limits<double>::infinity()};
+
+    for (std::size_t size = std::max(std::bit_ceil(2 * m), fftMinSize); size <= maxSize; size *= 2)
+    {
+      // Forward and inverse transforms of size / 2 * log2(size) butterflies and the spectrum product per block.
+      const double butterflies = static_cast<double>(size) * (static_cast<double>(std::countr_zero(size)) + 0.5);
+      const double cost        = butterflies * fftButterflyCost / static_cast<double>(size - m + 1);
+
+      if (cost < bestCost)
+      {
+        best     = size;
+        bestCost = cost;
+      }
+    }
+
+    return {best, bestCost};
+  }
+
+  /**
+   * @brief Accumulates the convolution computed by overlap-save FFT blocks into a range of the full convolution. Each
+   *        block computes its outputs from a window of the signal without overlapping writes, so blocks run in
+   *        parallel. Two blocks of a real convolution share one complex transform as its real and imaginary parts.
+   * @param size The FFT size, at least 2 * m
+   * @param parallel Use the library-managed thread pool for large ranges?
+   * @see convolveDirectKernel()
+   */
+  template<typename Out, typename X, typename H>
+  void convolveFft(const X*    x,
+                   std::size_t n,
+                   const H*    h,
+                   std::size_t m,
+                   Out*        out,
+                   std::size_t first,
+                   std::size_t last,
+                   std::size_t size,
+                   bool        parallel)
+  {
+    using R = RealType<Out>;
+    using C = std::complex<R>;
+
+    constexpr bool        paired     = !isComplex<Out>;
+    constexpr std::size_t blocksPer  = paired ? 2 : 1;
+
+    const Fft<R>&     fft        = getFft<R>(size);
+    const std::size_t blockSize  = size - m + 1;
+    const std::size_t blockCount = (last - first + blockSize - 1) / blockSize;
+    const std::size_t taskCount  = (blockCount + blocksPer - 1) / blocksPer;
+    const R           scale      = R{1} / static_cast<R>(size);
+
+    std::vector<C> spectrum(size);
+
+    for (std::size_t j{}; j < m; ++j)
+    {
+      spectrum[j] = C{h[j]} * scale;
+    }
+
+    fft.transform(spectrum.data(), false);
+
+    // The window of block b ends at its last output, the first m - 1 results wrap around and are discarded.
+    auto load = [&](std::size_t b, std::size_t j) -> X
+    {
+      const std::size_t k = first + b * blockSize + j;
+
+      return (k + 1 >= m && k + 1 - m < n) ? x[k + 1 - m] : X{};
+    };
+
+    auto task = [&](std::size_t t, std::vector<C>& buffer)
+    {
+      const std::size_t b = t * blocksPer;
+
+      buffer.resize(size);
+
+      for (std::size_t j{}; j < size; ++j)
+      {
+        if constexpr (paired)
+        {
+          buffer[j] = C{load(b, j), (b + 1 < blockCount) ? load(b + 1, j) : X{}};
+        }
+        else
+        {
+          buffer[j] = C{load(b, j)};
+        }
+      }
+
+      fft.transform(buffer.data(), false);
+
+      for (std::size_t j{}; j < size; ++j)
+      {
+        const C s = spectrum[j];
+        const C v = buffer[j];
+
+        buffer[j] = C{s.real() * v.real() - s.imag() * v.imag(), s.real() * v.imag() + s.imag() * v.real()};
+      }
+
+      fft.transform(buffer.data(), true);
+
+      for (std::size_t i{}; i < blocksPer && b + i < blockCount; ++i)
+      {
+        const std::size_t begin = first + (b + i) * blockSize;
+        const std::size_t count = std::min(blockSize, last - begin);
+
+        Out* dst = out + (begin - first);
+
+        for (std::size_t j{}; j < count; ++j)
+        {
+          const C y = buffer[m - 1 + j];
+
+          if constexpr (paired)
+          {
+            dst[j] += (i == 0) ? y.real() : y.imag();
+          }
+          else
+          {
+            dst[j] += y;
+          }
+        }
+      }
+    };
+
+    if (parallel && (last - first) * m >= convParallelMinWork && taskCount > 1)
+    {
+      parallel::parallelFor(0, taskCount, 1, [&](std::size_t t)
+      {
+        thread_local std::vector<C> buffer{};
+
+        task(t, buffer);
+      });
+    }
+    else
+    {
+      std::vector<C> buffer{};
+
+      for (std::size_t t{}; t < taskCount; ++t)
+      {
+        task(t, buffer);
+      }
+    }
+  }
+
+  /**
+   * @brief Accumulates a range of the full convolution of two sequences, selecting the direct kernel for short and
+   *        overlap-save FFT blocks for long filters by their estimated cost. The shorter sequence is the filter.
+   * @tparam Out Output element type
+   * @tparam A First element type
+   * @tparam B Second element type
+   * @param a First sequence
+   * @param n First size
+   * @param b Second sequence
+   * @param m Second size
+   * @param out The outputs, element k is the full convolution at first + k
+   * @param first Index of the first output
+   * @param last Index past the last output
+   * @param parallel Use the library-managed thread pool for large ranges?
+   */
+  template<typename Out, typename A, typename B>
+  void convolveRange(const A*    a,
+                     std::size_t n,
+                     const B*    b,
+                     std::size_t m,
+                     Out*        out,
+                     std::size_t first,
+                     std::size_t last,
+                     bool        parallel)
+  {
+    if (n == 0 || m == 0 || first >= last)
+    {
+      return;
+    }
+
+    if (n < m)
+    {
+      convolveRange(b, m, a, n, out, first, last, parallel);
+      return;
+    }
+
+    // Real convolutions pair two blocks per transform, which halves the cost per output.
+    auto [size, cost] = getFftBlockSize(n, m);
+
+    if (!isComplex<Out>)
+    {
+      cost /= 2;
+    }
+
+    if (size != 0 && cost < static_cast<double>(m) * convMultiplyAddCost<A, B>)
+    {
+      convolveFft(a, n, b, m, out, first, last, size, parallel);
+    }
+    else
+    {
+      convolveDirect(a, n, b, m, out, first, last, parallel);
+    }
+  }
+
+  /**
+   * @brief Gets the number of rows and columns of a matrix input.
+   * @tparam A Array type with dimensions
+   * @param a The array
+   * @return The rows and the product of the trailing dimensions
+   */
+  template<typename A>
+  [[nodiscard]] std::pair<std::size_t, std::size_t> getMatrixDims(const A& a)
+  {
+    const auto dims = a.getDims();
+
+    const std::size_t m = dims.empty() ? 0 : dims[0];
+
+    return {m, (m == 0) ? 0 : a.getSize() / m};
+  }
+} // namespace detail
+
+  /**
+   * @brief Convolves two vectors, as conv(u, v, shape). Short filters use a blocked direct kernel compiled for the
+   *        best instruction set, long filters overlap-save FFT blocks, selected by the estimated cost. Large
+   *        convolutions run in parallel.
+   * @tparam U First array type (TypedArrayCref, TypedArray, span, ...) of a real or complex floating point type
+   * @tparam V Second array type of the same real type
+   * @param u First input
+   * @param v Second input
+   * @param shape The part of the convolution returned
+   * @return The convolution, a row vector for a row vector u, a column vector otherwise
+   */
+  template<typename U, typename V>
+  [[nodiscard]] NumericArray<detail::ConvType<detail::ElementOf<U>, detail::ElementOf<V>>>
+  conv(const U& u, const V& v, ConvShape shape = ConvShape::full)
+  {
+    using Out = detail::ConvType<detail::ElementOf<U>, detail::ElementOf<V>>;
+
+    static_assert(detail::isConvolvable<detail::ElementOf<U>, detail::ElementOf<V>>,
+                  "inputs must be single or double of the same precision");
+
+    const auto a     = detail::toSpan(u);
+    const auto b     = detail::toSpan(v);
+    const auto range = detail::getConvRange(a.size(), b.size(), shape);
+
+    NumericArray<Out> out = detail::makeVectorResult<Out>(u, range.size);
+
+    std::fill_n(out.getData(), range.size, Out{});
+
+    detail::convolveRange(a.data(), a.size(), b.data(), b.size(), out.getData(),
+                          range.offset, range.offset + range.size, true);
+
+    return out;
+  }
+
+  /**
+   * @brief Correlates two vectors, the convolution of u with the reversed conjugate of v. The full correlation holds
+   *        the lags -(numel(v) - 1) to numel(u) - 1 as xcorr for vectors of the same size.
+   * @see conv()
+   */
+  template<typename U, typename V>
+  [[nodiscard]] NumericArray<detail::ConvType<detail::ElementOf<U>, detail::ElementOf<V>>>
+  correlate(const U& u, const V& v, ConvShape shape = ConvShape::full)
+  {
+    using T = detail::ElementOf<V>;
+
+    const auto b = detail::toSpan(v);
+
+    std::vector<T> reversed(b.rbegin(), b.rend());
+
+    if constexpr (detail::isComplex<T>)
+    {
+      for (T& value : reversed)
+      {
+        value = std::conj(value);
+      }
+    }
+
+    return conv(u, std::span<const T>{reversed}, shape);
+  }
+
+  /**
+   * @brief Convolves every column of a matrix with a vector, as conv2(a, h(:), shape). Columns run in parallel.
+   * @tparam A Matrix array type with dimensions (TypedArrayCref, TypedArray, ...) of a floating point type
+   * @tparam H Filter array type of the same real type
+   * @param a The matrix, trailing dimensions are flattened into columns
+   * @param h The filter
+   * @param shape The part of the convolution returned
+   * @return The convolved columns
+   */
+  template<typename A, typename H>
+    requires requires(const A& matrix) { matrix.getDims(); }
+  [[nodiscard]] NumericArray<detail::ConvType<detail::ElementOf<A>, detail::ElementOf<H>>>
+  convColumns(const A& a, const H& h, ConvShape shape = ConvShape::full)
+  {
+    using Out = detail::ConvType<detail::ElementOf<A>, detail::ElementOf<H>>;
+
+    static_assert(detail::isConvolvable<detail::ElementOf<A>, detail::ElementOf<H>>,
+                  "inputs must be single or double of the same precision");
+
+    const auto src           = detail::toSpan(a);
+    const auto filter        = detail::toSpan(h);
+    const auto [rows, cols]  = detail::getMatrixDims(a);
+    const auto range         = detail::getConvRange(rows, filter.size(), shape);
+    const auto colRange      = detail::getConvRange(cols, 1, shape);
+
+    NumericArray<Out> out = mx::makeNumericArray<Out>(range.size, colRange.size);
+
+    auto column = [&](std::size_t j, bool parallel)
+    {
+      detail::convolveRange(src.data() + j * rows, rows, filter.data(), filter.size(), out.getData() + j * range.size,
+                            range.offset, range.offset + range.size, parallel);
+    };
+
+    if (colRange.size > 1 && range.size * filter.size() * colRange.size >= detail::convParallelMinWork)
+    {
+      parallel::parallelFor(0, colRange.size, 1, [&](std::size_t j) { column(j, false); });
+    }
+    else
+    {
+      for (std::size_t j{}; j < colRange.size; ++j)
+      {
+        column(j, true);
+      }
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief Two-dimensional convolution of matrices, as conv2(a, b, shape). Every output column sums the 1-D
+   *        convolutions of the overlapping column pairs, each selecting the direct or the FFT kernel. Output columns
+   *        run in parallel.
+   * @tparam A First matrix array type with dimensions (TypedArrayCref, TypedArray, ...) of a floating point type
+   * @tparam B Second matrix array type with dimensions of the same real type
+   * @param a First matrix
+   * @param b Second matrix
+   * @param shape The part of the convolution returned, same and valid refer to the size of a
+   * @return The convolution
+   */
+  template<typename A, typename B>
+    requires requires(const A& x, const B& y) { x.getDims(); y.getDims(); }
+  [[nodiscard]] NumericArray<detail::ConvType<detail::ElementOf<A>, detail::ElementOf<B>>>
+  conv2(const A& a, const B& b, ConvShape shape = ConvShape::full)
+  {
+    using Out = detail::ConvType<detail::ElementOf<A>, detail::ElementOf<B>>;
+
+    static_assert(detail::isConvolvable<detail::ElementOf<A>, detail::ElementOf<B>>,
+                  "inputs must be single or double of the same precision");
+
+    const auto srcA       = detail::toSpan(a);
+    const auto srcB       = detail::toSpan(b);
+    const auto [ma, na]   = detail::getMatrixDims(a);
+    const auto [mb, nb]   = detail::getMatrixDims(b);
+    const auto rowRange   = detail::getConvRange(ma, mb, shape);
+    const auto colRange   = detail::getConvRange(na, nb, shape);
+
+    NumericArray<Out> out = mx::makeNumericArray<Out>(rowRange.size, colRange.size);
+
+    auto column = [&](std::size_t j, bool parallel)
+    {
+      const std::size_t c     = colRange.offset + j;
+      const std::size_t first = (c + 1 > na) ? c + 1 - na : 0;
+      const std::size_t last  = std::min(c + 1, nb);
+
+      for (std::size_t q{first}; q < last; ++q)
+      {
+        detail::convolveRange(srcA.data() + (c - q) * ma, ma, srcB.data() + q * mb, mb,
+                              out.getData() + j * rowRange.size, rowRange.offset, rowRange.offset + rowRange.size,
+                              parallel);
+      }
+    };
+
+    if (colRange.size > 1 && rowRange.size * colRange.size * mb * nb >= detail::convParallelMinWork)
+    {
+      parallel::parallelFor(0, colRange.size, 1, [&](std::size_t j) { column(j, false); });
+    }
+    else
+    {
+      for (std::size_t j{}; j < colRange.size; ++j)
+      {
+        column(j, true);
+      }
+    }
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_CONVOLUTION_HPP */
@@ -0,0 +1,374 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_COPY_HPP
+#define MATLABW_MX_ALGORITHM_COPY_HPP
+
+#include "../detail/include.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "detail/parallel.hpp"
+#include "../Array.hpp"
+#include "../ArrayRef.hpp"
+#include "../Exception.hpp"
+#include "../memory.hpp"
+#include "../StructArray.hpp"
+#include "../visit.hpp"
+#include "../parallel/ThreadBudget.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Modes of deepCopy().
+  enum class DeepCopyMode
+  {
+    full,      ///< Copies the whole tree.
+    selective, ///< Copies the selected struct fields, the other fields share the data of the source.
+    structure, ///< Copies the containers, the leaves are zeroed arrays of the same class and size.
+  };
+
+  /// @brief Options of deepCopy().
+  struct DeepCopyOptions
+  {
+    DeepCopyMode             mode{DeepCopyMode::full}; ///< The copy mode
+    std::vector<std::string> fields{};                 ///< Names of the fields copied in the selective mode
+  };
+
+namespace detail
+{
+  /// @brief Number of bytes copied at once by the parallel payload copy.
+  inline constexpr std::size_t copyChunkSize{std::size_t{1} << 20};
+
+  /// @brief Payload of an array copied after the tree has been created.
+  struct CopyJob
+  {
+    const void* src{};  ///< The source data
+    void*       dst{};  ///< The destination data
+    std::size_t size{}; ///< The size in bytes
+  };
+
+  /**
+   * @brief Takes the ownership of a new array.
+   * @param array The array returned by mxCreate* or mxDuplicateArray.
+   * @return The array.
+   * @throws Exception if the array is null.
+   */
+  [[nodiscard]] inline Array adoptCopy(mxArray* array)
+  {
+    if (array == nullptr)
+    {
+      throw Exception{"matlabw:mx:algorithm:deepCopy", "failed to create array"};
+    }
+
+    return Array{std::move(array)};
+  }
+
+  /**
+   * @brief Makes a copy sharing the data of an array. Uses the undocumented mxCreateSharedDataCopy of libmx, which
+   *        makes a lazy copy duplicated by MATLAB on write, and falls back to mxDuplicateArray if it is not exported.
+   * @param array The array.
+   * @return The copy.
+   */
+  [[nodiscard]] inline Array shareCopy(const mxArray* array)
+  {
+    using Share = mxArray* (*)(const mxArray*);
+
+    static const Share share = []() noexcept -> Share
+    {
+#if defined(_WIN32)
+      if (HMODULE handle = GetModuleHandleA("libmx.dll"); handle != nullptr)
+      {
+        return reinterpret_cast<Share>(GetProcAddress(handle, "mxCreateSharedDataCopy"));
+      }
+
+      return nullptr;
+#else
+      return parallel::detail::findSymbol<Share>("mxCreateSharedDataCopy");
+#endif
+    }();
+
+    return adoptCopy((share != nullptr) ? share(array) : mxDuplicateArray(array));
+  }
+
+  /// @brief Creates the tree of a deep copy on the calling thread and copies the payloads in parallel afterwards.
+  class DeepCopier
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param options The copy options.
+       */
+      explicit DeepCopier(const DeepCopyOptions& options) noexcept
+      : mOptions{options}
+      {}
+
+      /**
+       * @brief Creates the copy of an array, its payloads are copied by copyPayloads().
+       * @param array The array.
+       * @param selective True if the fields of structs are copied only when selected.
+       * @return The copy.
+       */
+      [[nodiscard]] Array copy(ArrayCref array, bool selective)
+      {
+        const mxArray* src = array.get();
+
+        switch (array.getClassId())
+        {
+        case ClassId::cell:
+        case ClassId::_struct:
+        case ClassId::logical:
+        case ClassId::_char:
+        case ClassId::_double:
+        case ClassId::single:
+        case ClassId::int8:
+        case ClassId::uint8:
+        case ClassId::int16:
+        case ClassId::uint16:
+        case ClassId::int32:
+        case ClassId::uint32:
+        case ClassId::int64:
+        case ClassId::uint64:
+          if (!mxIsSparse(src))
+          {
+            break;
+          }
+
+          if (mOptions.mode == DeepCopyMode::structure)
+          {
+            return adoptCopy(mxIsLogical(src) ? mxCreateSparseLogicalMatrix(mxGetM(src), mxGetN(src), 0)
+                                              : mxCreateSparse(mxGetM(src), mxGetN(src), 0,
+                                                               mxIsComplex(src) ? mxCOMPLEX : mxREAL));
+          }
+          [[fallthrough]];
+        default:
+          // sparse matrices, objects and function handles are copied by MATLAB
+          return adoptCopy(mxDuplicateArray(src));
+        }
+
+        return visit(array, [&](auto ref) -> Array
+        {
+          using Ref = decltype(ref);
+
+          if constexpr (std::is_same_v<Ref, CellArrayCref>)
+          {
+            return copyCell(ref.get(), selective);
+          }
+          else if constexpr (std::is_same_v<Ref, StructArrayCref>)
+          {
+            return copyStruct(ref.get(), selective);
+          }
+          else
+          {
+            return copyLeaf(ref.get());
+          }
+        });
+      }
+
+      /// @brief Copies the payloads collected by copy(), large trees are copied in parallel in fixed-size chunks.
+      void copyPayloads()
+      {
+        if (mPayloadSize < parallelMinSize * sizeof(double))
+        {
+          for (const CopyJob& job : mJobs)
+          {
+            std::memcpy(job.dst, job.src, job.size);
+          }
+
+          return;
+        }
+
+        std::vector<std::size_t> firstChunk(mJobs.size() + 1);
+
+        for (std::size_t k{}; k < mJobs.size(); ++k)
+        {
+          firstChunk[k + 1] = firstChunk[k] + (mJobs[k].size + copyChunkSize - 1) / copyChunkSize;
+        }
+
+        parallel::parallelFor(0, firstChunk.back(), 0, [&](std::size_t chunk)
+        {
+          const auto k = static_cast<std::size_t>(std::upper_bound(firstChunk.begin(), firstChunk.end(), chunk)
+                                                  - firstChunk.begin() - 1);
+
+          const CopyJob&    job    = mJobs[k];
+          const std::size_t offset = (chunk - firstChunk[k]) * copyChunkSize;
+
+          std::memcpy(static_cast<std::byte*>(job.dst) + offset,
+                      static_cast<const std::byte*>(job.src) + offset,
+                      std::min(copyChunkSize, job.size - offset));
+        });
+      }
+
+    private:
+      /**
+       * @brief Copies a cell array.
+       * @param src The cell array.
+       * @param selective True if the fields of nested structs are copied only when selected.
+       * @return The copy.
+       */
+      [[nodiscard]] Array copyCell(const mxArray* src, bool selective)
+      {
+        Array dst = adoptCopy(mxCreateCellArray(mxGetNumberOfDimensions(src), mxGetDimensions(src)));
+
+        const std::size_t size = mxGetNumberOfElements(src);
+
+        for (std::size_t i{}; i < size; ++i)
+        {
+          if (const mxArray* cell = mxGetCell(src, i); cell != nullptr)
+          {
+            mxSetCell(dst.get(), i, copy(ArrayCref{cell}, selective).release());
+          }
+        }
+
+        return dst;
+      }
+
+      /**
+       * @brief Copies a struct array.
+       * @param src The struct array.
+       * @param selective True if the fields are copied only when selected, the other fields are shared.
+       * @return The copy.
+       */
+      [[nodiscard]] Array copyStruct(const mxArray* src, bool selective)
+      {
+        const int fieldCount = mxGetNumberOfFields(src);
+
+        std::vector<const char*> names(static_cast<std::size_t>(fieldCount));
+
+        for (int k{}; k < fieldCount; ++k)
+        {
+          names[static_cast<std::size_t>(k)] = mxGetFieldNameByNumber(src, k);
+        }
+
+        Array dst = makeStructArray(View<std::size_t>{mxGetDimensions(src), mxGetNumberOfDimensions(src)}, names);
+
+        const std::size_t size = mxGetNumberOfElements(src);
+
+        for (int k{}; k < fieldCount; ++k)
+        {
+          const bool shared = selective && !isSelected(names[static_cast<std::size_t>(k)]);
+
+          for (std::size_t i{}; i < size; ++i)
+          {
+            if (const mxArray* field = mxGetFieldByNumber(src, i, k); field != nullptr)
+            {
+              Array value = (shared) ? shareCopy(field) : copy(ArrayCref{field}, false);
+
+              mxSetFieldByNumber(dst.get(), i, k, value.release());
+            }
+          }
+        }
+
+        return dst;
+      }
+
+      /**
+       * @brief Creates the copy of a dense numeric, logical or char array and queues the copy of its payload.
+       * @param src The array.
+       * @return The copy, uninitialized unless copying the structure only.
+       */
+      [[nodiscard]] Array copyLeaf(const mxArray* src)
+      {
+        const std::size_t  rank      = mxGetNumberOfDimensions(src);
+        const std::size_t* dims      = mxGetDimensions(src);
+        const mxClassID    classId   = mxGetClassID(src);
+        const bool         structure = (mOptions.mode == DeepCopyMode::structure);
+
+        Array dst{};
+
+        if (classId == mxLOGICAL_CLASS)
+        {
+          dst = adoptCopy(mxCreateLogicalArray(rank, dims));
+        }
+        else if (classId == mxCHAR_CLASS)
+        {
+          dst = adoptCopy(mxCreateCharArray(rank, dims));
+        }
+        else
+        {
+          const mxComplexity complexity = mxIsComplex(src) ? mxCOMPLEX : mxREAL;
+
+          dst = adoptCopy(structure ? mxCreateNumericArray(rank, dims, classId, complexity)
+                                    : mxCreateUninitNumericArray(rank, const_cast<std::size_t*>(dims), classId,
+                                                                 complexity));
+        }
+
+        const std::size_t size = mxGetNumberOfElements(src) * mxGetElementSize(src);
+
+        if (!structure && size > 0)
+        {
+          if (size >= hugePageSize)
+          {
+            adviseHugePages(mxGetData(dst.get()), size);
+          }
+
+          mJobs.push_back(CopyJob{mxGetData(src), mxGetData(dst.get()), size});
+          mPayloadSize += size;
+        }
+
+        return dst;
+      }
+
+      /**
+       * @brief Checks if a field is selected for copying.
+       * @param name The field name.
+       * @return True if selected.
+       */
+      [[nodiscard]] bool isSelected(const char* name) const noexcept
+      {
+        return std::find(mOptions.fields.begin(), mOptions.fields.end(), name) != mOptions.fields.end();
+      }
+
+      const DeepCopyOptions& mOptions;       ///< The copy options
+      std::vector<CopyJob>   mJobs{};        ///< The queued payload copies
+      std::size_t            mPayloadSize{}; ///< The total size of the queued payloads in bytes
+  };
+} // namespace detail
+
+  /**
+   * @brief Deep copies an array tree. The containers and uninitialized leaves are created by walking the tree on the
+   *        calling thread, which must be the MATLAB thread, then the numeric payloads are copied in parallel. Huge
+   *        leaves are advised to be backed by huge pages before they are first touched. In the selective mode the
+   *        fields whose names are listed in the options are copied completely, the other fields share the data of the
+   *        source where libmx supports it and are duplicated by MATLAB otherwise. The selection applies to the top
+   *        level struct and to the structs nested in cells. Sparse matrices, objects and function handles are always
+   *        duplicated by MATLAB.
+   * @param array The array.
+   * @param options The copy options.
+   * @return The copy.
+   */
+  [[nodiscard]] inline Array deepCopy(ArrayCref array, const DeepCopyOptions& options = {})
+  {
+    detail::DeepCopier copier{options};
+
+    Array copy = copier.copy(array, options.mode == DeepCopyMode::selective);
+
+    copier.copyPayloads();
+
+    return copy;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_COPY_HPP */
@@ -0,0 +1,440 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_DETAIL_ARITHMETIC_HPP
+#define MATLABW_MX_ALGORITHM_DETAIL_ARITHMETIC_HPP
+
+#include "../../detail/include.hpp"
+
+#include <cmath>
+
+#include "../../Exception.hpp"
+#include "../../detail/saturate.hpp"
+#include "../../typeTraits.hpp"
+#include "simd.hpp"
+
+namespace matlabw::mx::algorithm::detail
+{
+  /**
+   * @brief Is the type one of the MATLAB integer classes?
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isInteger = std::is_same_v<T, std::int8_t>  || std::is_same_v<T, std::uint8_t>  ||
+                                    std::is_same_v<T, std::int16_t> || std::is_same_v<T, std::uint16_t> ||
+                                    std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::uint32_t> ||
+                                    std::is_same_v<T, std::int64_t> || std::is_same_v<T, std::uint64_t>;
+
+  /**
+   * @brief Is the type one of the MATLAB real numeric classes?
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isReal = isInteger<T> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+  /**
+   * @brief Is the type a complex floating point MATLAB numeric class? Complex integers are not supported by the
+   *        algorithms as std::complex is specified for floating point types only.
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isComplex = std::is_same_v<T, std::complex<float>> || std::is_same_v<T, std::complex<double>>;
+
+  /// @brief MATLAB real numeric element type.
+  template<typename T>
+  concept RealNumeric = isReal<T>;
+
+  /// @brief MATLAB real floating point element type.
+  template<typename T>
+  concept RealFloat = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+  /// @brief MATLAB numeric element type.
+  template<typename T>
+  concept Numeric = isReal<T> || isComplex<T>;
+
+  /**
+   * @brief Scalar type used for scaling an array, MATLAB scales integer arrays by doubles.
+   * @tparam T Element type
+   */
+  template<typename T>
+  using ScalarType = std::conditional_t<isInteger<T>, double, T>;
+
+  /// @brief Real type of an element type.
+  template<typename T>
+  struct RealTypeOf
+  {
+    using Type = T; ///< The real type
+  };
+
+  /// @brief Real type of a complex element type.
+  template<typename T>
+  struct RealTypeOf<std::complex<T>>
+  {
+    using Type = T; ///< The real type
+  };
+
+  /**
+   * @brief Real type of an element type.
+   * @tparam T Element type
+   */
+  template<typename T>
+  using RealType = typename RealTypeOf<T>::Type;
+
+  /**
+   * @brief Checks if a value is NaN, complex values are NaN if either part is NaN. Integers are never NaN.
+   * @tparam T Element type
+   * @param x The value
+   * @return True if the value is NaN
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE constexpr bool isNan(T x) noexcept
+  {
+    if constexpr (isComplex<T>)
+    {
+      return x.real() != x.real() || x.imag() != x.imag();
+    }
+    else
+    {
+      return x != x;
+    }
+  }
+
+  using mx::detail::saturateCast;
+
+  /**
+   * @brief Wide type for exact integer arithmetic of narrow integers.
+   * @tparam T Integer type
+   */
+  template<typename T>
+  using WideType = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+
+  /**
+   * @brief Adds two values, integers saturate.
+   * @tparam T Element type
+   * @param a First value
+   * @param b Second value
+   * @return The sum
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE constexpr T add(T a, T b) noexcept
+  {
+    if constexpr (isInteger<T> && sizeof(T) < 8)
+    {
+      return saturateCast<T>(static_cast<std::int64_t>(a) + static_cast<std::int64_t>(b));
+    }
+    else if constexpr (std::is_same_v<T, std::uint64_t>)
+    {
+      const T sum = a + b;
+      return (sum < a) ? std::numeric_limits<T>::max() : sum;
+    }
+    else if constexpr (std::is_same_v<T, std::int64_t>)
+    {
+      const auto sum = static_cast<T>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+
+      // Overflow if both operands have the same sign which differs from the sign of the result.
+      if (((a ^ sum) & (b ^ sum)) < 0)
+      {
+        return (a < 0) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+      }
+
+      return sum;
+    }
+    else
+    {
+      return a + b;
+    }
+  }
+
+  /**
+   * @brief Subtracts two values, integers saturate.
+   * @tparam T Element type
+   * @param a First value
+   * @param b Second value
+   * @return The difference
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE constexpr T subtract(T a, T b) noexcept
+  {
+    if constexpr (isInteger<T> && sizeof(T) < 8)
+    {
+      return saturateCast<T>(static_cast<std::int64_t>(a) - static_cast<std::int64_t>(b));
+    }
+    else if constexpr (std::is_same_v<T, std::uint64_t>)
+    {
+      return (a < b) ? T{} : a - b;
+    }
+    else if constexpr (std::is_same_v<T, std::int64_t>)
+    {
+      const auto diff = static_cast<T>(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+
+      // Overflow if the operands have different signs and the sign of the result differs from the first operand.
+      if (((a ^ b) & (a ^ diff)) < 0)
+      {
+        return (a < 0) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+      }
+
+      return diff;
+    }
+    else
+    {
+      return a - b;
+    }
+  }
+
+  /**
+   * @brief Multiplies two values, integers saturate.
+   * @tparam T Element type
+   * @param a First value
+   * @param b Second value
+   * @return The product
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE constexpr T multiply(T a, T b) noexcept
+  {
+    if constexpr (isInteger<T> && sizeof(T) < 4)
+    {
+      return saturateCast<T>(static_cast<std::int32_t>(a) * static_cast<std::int32_t>(b));
+    }
+    else if constexpr (isInteger<T> && sizeof(T) == 4)
+    {
+      return saturateCast<T>(static_cast<std::int64_t>(a) * static_cast<std::int64_t>(b));
+    }
+    else if constexpr (isInteger<T>)
+    {
+      T result{};
+
+#   if defined(__GNUC__)
+      if (__builtin_mul_overflow(a, b, &result))
+      {
+        if constexpr (std::is_signed_v<T>)
+        {
+          return ((a < 0) != (b < 0)) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+        else
+        {
+          return std::numeric_limits<T>::max();
+        }
+      }
+#   else
+      result = saturateCast<T>(static_cast<long double>(a) * static_cast<long double>(b));
+#   endif
+
+      return result;
+    }
+    else if constexpr (isComplex<T>)
+    {
+      // Plain formula without the NaN recovery of std::complex, so the loop can be vectorized.
+      return T{a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+    }
+    else
+    {
+      return a * b;
+    }
+  }
+
+  /**
+   * @brief Divides two values. Integer division rounds to nearest with ties away from zero and saturates, division
+   *        by zero yields the saturated value and 0 / 0 yields 0, as in MATLAB.
+   * @tparam T Element type
+   * @param a Dividend
+   * @param b Divisor
+   * @return The quotient
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE constexpr T divide(T a, T b) noexcept
+  {
+    if constexpr (isInteger<T> && sizeof(T) < 8)
+    {
+      return saturateCast<T>(static_cast<double>(a) / static_cast<double>(b));
+    }
+    else if constexpr (isInteger<T>)
+    {
+      if (b == 0)
+      {
+        if (a == 0)
+        {
+          return T{};
+        }
+
+        if constexpr (std::is_signed_v<T>)
+        {
+          return (a < 0) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        }
+        else
+        {
+          return std::numeric_limits<T>::max();
+        }
+      }
+
+      if constexpr (std::is_signed_v<T>)
+      {
+        if (a == std::numeric_limits<T>::min() && b == -1)
+        {
+          return std::numeric_limits<T>::max();
+        }
+      }
+
+      T q = a / b;
+      T r = a % b;
+
+      // Round half away from zero, compare |r| >= |b| - |r| to avoid overflow.
+      using U = std::make_unsigned_t<T>;
+
+      const U absR = (r < 0) ? U(0) - static_cast<U>(r) : static_cast<U>(r);
+      const U absB = (b < 0) ? U(0) - static_cast<U>(b) : static_cast<U>(b);
+
+      if (absR >= absB - absR)
+      {
+        if constexpr (std::is_signed_v<T>)
+        {
+          q += ((a < 0) != (b < 0)) ? T{-1} : T{1};
+        }
+        else
+        {
+          ++q;
+        }
+      }
+
+      return q;
+    }
+    else
+    {
+      return a / b;
+    }
+  }
+
+  /**
+   * @brief Scales a value by a scalar, integers are scaled in double precision and rounded.
+   * @tparam T Element type
+   * @param x The value
+   * @param alpha The scalar
+   * @return The scaled value
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE constexpr T scale(T x, ScalarType<T> alpha) noexcept
+  {
+    if constexpr (isInteger<T>)
+    {
+      return saturateCast<T>(static_cast<double>(x) * alpha);
+    }
+    else
+    {
+      return multiply(x, alpha);
+    }
+  }
+
+  /**
+   * @brief Computes a * b + c, floating point values are fused with a single rounding.
+   * @tparam T Element type
+   * @param a First factor
+   * @param b Second factor
+   * @param c Addend
+   * @return The result
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE constexpr T multiplyAdd(T a, T b, T c) noexcept
+  {
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      return std::fma(a, b, c);
+    }
+    else if constexpr (isComplex<T>)
+    {
+      using R = typename T::value_type;
+
+      const R re = std::fma(a.real(), b.real(), std::fma(-a.imag(), b.imag(), c.real()));
+      const R im = std::fma(a.real(), b.imag(), std::fma(a.imag(), b.real(), c.imag()));
+
+      return T{re, im};
+    }
+    else
+    {
+      return add(multiply(a, b), c);
+    }
+  }
+
+  /**
+   * @brief Computes the absolute value, integers saturate (abs of the minimum is the maximum).
+   * @tparam T Real element type
+   * @param x The value
+   * @return The absolute value
+   */
+  template<RealNumeric T>
+  MATLABW_ALWAYS_INLINE constexpr T abs(T x) noexcept
+  {
+    if constexpr (std::is_unsigned_v<T>)
+    {
+      return x;
+    }
+    else if constexpr (isInteger<T>)
+    {
+      return (x == std::numeric_limits<T>::min()) ? std::numeric_limits<T>::max() : static_cast<T>((x < 0) ? -x : x);
+    }
+    else
+    {
+      return std::abs(x);
+    }
+  }
+
+  /**
+   * @brief Computes the magnitude of a complex value without overflow and with the hypot semantics for Inf and NaN.
+   * @tparam R Real type
+   * @param x The value
+   * @return The magnitude
+   */
+  template<typename R>
+  MATLABW_ALWAYS_INLINE R abs(std::complex<R> x) noexcept
+  {
+    const R a  = std::abs(x.real());
+    const R b  = std::abs(x.imag());
+    const R hi = (a > b) ? a : b;
+    const R lo = (a > b) ? b : a;
+    const R q  = (hi > R{0}) ? lo / hi : R{0};
+    const R r  = hi * std::sqrt(R{1} + q * q);
+
+    if (a == std::numeric_limits<R>::infinity() || b == std::numeric_limits<R>::infinity())
+    {
+      return std::numeric_limits<R>::infinity();
+    }
+
+    return (a != a || b != b) ? std::numeric_limits<R>::quiet_NaN() : r;
+  }
+
+  /**
+   * @brief Checks that all sizes are equal.
+   * @param id Error identifier
+   * @param size The reference size
+   * @param sizes Other sizes
+   */
+  template<typename... Sizes>
+  void checkSizes(const char* id, std::size_t size, Sizes... sizes)
+  {
+    if (((sizes != size) || ...))
+    {
+      throw Exception{id, "array sizes must match"};
+    }
+  }
+} // namespace matlabw::mx::algorithm::detail
+
+#endif /* MATLABW_MX_ALGORITHM_DETAIL_ARITHMETIC_HPP */
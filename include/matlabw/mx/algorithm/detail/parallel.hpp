@@ -0,0 +1,133 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_DETAIL_PARALLEL_HPP
+#define MATLABW_MX_ALGORITHM_DETAIL_PARALLEL_HPP
+
+#include "../../detail/include.hpp"
+
+#include "../../parallel/parallelFor.hpp"
+#include "simd.hpp"
+
+namespace matlabw::mx::algorithm::detail
+{
+  /// @brief Minimum number of elements processed in parallel, smaller inputs do not amortize the synchronization.
+  inline constexpr std::size_t parallelMinSize{std::size_t{1} << 18};
+
+  /**
+   * @brief Number of elements per parallel chunk. Fixed, so that parallel reductions give the same result for any
+   *        number of threads. A multiple of the pairwise block size.
+   */
+  inline constexpr std::size_t parallelChunkSize{std::size_t{1} << 16};
+
+  /**
+   * @brief Runs a chunked loop on the library-managed thread pool. If the workers are pinned to NUMA nodes the loop
+   *        uses the static partition, so that kernels over the same array process each block on the node which first
+   *        touched it. Otherwise chunks are balanced by work stealing.
+   * @tparam Fn Loop body type, called as fn(first, last)
+   * @param n Number of elements
+   * @param fn The loop body
+   */
+  template<typename Fn>
+  void parallelChunks(std::size_t n, Fn&& fn)
+  {
+    auto& pool = parallel::getThreadPool();
+
+    if (pool.isNumaPinned())
+    {
+      parallel::parallelForStatic(0, n, parallelChunkSize, fn, pool);
+    }
+    else
+    {
+      parallel::parallelFor(0, n, parallelChunkSize, fn, pool);
+    }
+  }
+
+  /**
+   * @brief Elementwise transform dispatched to the best instruction set and split between the threads of the
+   *        library-managed thread pool regardless of the size.
+   * @tparam Op Operation type, called as out[i] = op(in[i]...)
+   * @tparam Out Output element type
+   * @tparam In Input element types
+   * @param op The operation
+   * @param n Number of elements
+   * @param out Output pointer, may alias the inputs
+   * @param in Input pointers
+   */
+  template<typename Op, typename Out, typename... In>
+  void transformParallel(Op op, std::size_t n, Out* out, const In*... in)
+  {
+    parallelChunks(n, [&](std::size_t first, std::size_t last)
+    {
+      transformSimd(op, last - first, out + first, (in + first)...);
+    });
+  }
+
+  /**
+   * @brief Elementwise transform dispatched to the best instruction set, large inputs are split between the threads of
+   *        the library-managed thread pool.
+   * @tparam Op Operation type, called as out[i] = op(in[i]...)
+   * @tparam Out Output element type
+   * @tparam In Input element types
+   * @param op The operation
+   * @param n Number of elements
+   * @param out Output pointer, may alias the inputs
+   * @param in Input pointers
+   */
+  template<typename Op, typename Out, typename... In>
+  void transform(Op op, std::size_t n, Out* out, const In*... in)
+  {
+    if (n < parallelMinSize)
+    {
+      transformSimd(op, n, out, in...);
+      return;
+    }
+
+    transformParallel(op, n, out, in...);
+  }
+
+  /**
+   * @brief Runs a chunked kernel dispatched to the best instruction set, large inputs are split between the threads
+   *        of the library-managed thread pool.
+   * @tparam Kernel Kernel type, called as kernel(first, last), should be marked with MATLABW_INLINE_LAMBDA
+   * @param n Number of elements
+   * @param kernel The kernel
+   */
+  template<typename Kernel>
+  void forChunks(std::size_t n, Kernel kernel)
+  {
+    if (n < parallelMinSize)
+    {
+      dispatch([&]() MATLABW_INLINE_LAMBDA { kernel(std::size_t{}, n); });
+      return;
+    }
+
+    parallelChunks(n, [&](std::size_t first, std::size_t last)
+    {
+      dispatch([&]() MATLABW_INLINE_LAMBDA { kernel(first, last); });
+    });
+  }
+} // namespace matlabw::mx::algorithm::detail
+
+#endif /* MATLABW_MX_ALGORITHM_DETAIL_PARALLEL_HPP */
@@ -0,0 +1,165 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_DETAIL_SIMD_HPP
+#define MATLABW_MX_ALGORITHM_DETAIL_SIMD_HPP
+
+#include "../../detail/include.hpp"
+
+#include "../../cpu.hpp"
+
+#if defined(__GNUC__)
+# define MATLABW_INLINE_LAMBDA __attribute__((always_inline))
+#else
+# define MATLABW_INLINE_LAMBDA
+#endif
+
+namespace matlabw::mx::algorithm::detail
+{
+  using mx::SimdLevel;
+  using mx::getSimdLevel;
+
+  /**
+   * @brief Elementwise loop, written so that the compiler vectorizes it for the instruction set of the caller.
+   * @tparam Op Operation type, called as out[i] = op(in[i]...)
+   * @tparam Out Output element type
+   * @tparam In Input element types
+   * @param op The operation
+   * @param n Number of elements
+   * @param out Output pointer
+   * @param in Input pointers
+   */
+  template<typename Op, typename Out, typename... In>
+  MATLABW_ALWAYS_INLINE void transformLoop(Op op, std::size_t n, Out* out, const In*... in)
+  {
+    for (std::size_t i{}; i < n; ++i)
+    {
+      out[i] = op(in[i]...);
+    }
+  }
+
+  /// @copydoc transformLoop
+  template<typename Op, typename Out, typename... In>
+  void transformGeneric(Op op, std::size_t n, Out* out, const In*... in)
+  {
+    transformLoop(op, n, out, in...);
+  }
+
+#ifdef MATLABW_SIMD_X86_DISPATCH
+  /// @copydoc transformLoop
+  template<typename Op, typename Out, typename... In>
+  [[gnu::target("avx2,fma")]] void transformAvx2(Op op, std::size_t n, Out* out, const In*... in)
+  {
+    transformLoop(op, n, out, in...);
+  }
+
+  /// @copydoc transformLoop
+  template<typename Op, typename Out, typename... In>
+  [[gnu::target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma")]] void transformAvx512(Op op, std::size_t n, Out* out, const In*... in)
+  {
+    transformLoop(op, n, out, in...);
+  }
+#endif
+
+  /**
+   * @brief Single-threaded elementwise transform dispatched at runtime to the best instruction set supported by the CPU.
+   * @tparam Op Operation type, called as out[i] = op(in[i]...)
+   * @tparam Out Output element type
+   * @tparam In Input element types
+   * @param op The operation
+   * @param n Number of elements
+   * @param out Output pointer, may alias the inputs
+   * @param in Input pointers
+   */
+  template<typename Op, typename Out, typename... In>
+  void transformSimd(Op op, std::size_t n, Out* out, const In*... in)
+  {
+#ifdef MATLABW_SIMD_X86_DISPATCH
+    switch (getSimdLevel())
+    {
+    case SimdLevel::avx512:
+      transformAvx512(op, n, out, in...);
+      return;
+    case SimdLevel::avx2:
+      transformAvx2(op, n, out, in...);
+      return;
+    default:
+      break;
+    }
+#endif
+
+    transformGeneric(op, n, out, in...);
+  }
+
+  /// @brief Invokes a kernel compiled for the baseline instruction set.
+  template<typename Kernel>
+  auto invokeGeneric(Kernel kernel)
+  {
+    return kernel();
+  }
+
+#ifdef MATLABW_SIMD_X86_DISPATCH
+  /// @brief Invokes a kernel compiled for AVX2.
+  template<typename Kernel>
+  [[gnu::target("avx2,fma")]] auto invokeAvx2(Kernel kernel)
+  {
+    return kernel();
+  }
+
+  /// @brief Invokes a kernel compiled for AVX-512.
+  template<typename Kernel>
+  [[gnu::target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma")]] auto invokeAvx512(Kernel kernel)
+  {
+    return kernel();
+  }
+#endif
+
+  /**
+   * @brief Invokes a kernel compiled for the best instruction set supported by the CPU. The kernel must be inlined
+   *        into the dispatch target, so lambdas should be marked with MATLABW_INLINE_LAMBDA and functors with
+   *        MATLABW_ALWAYS_INLINE.
+   * @tparam Kernel Kernel type, callable without arguments
+   * @param kernel The kernel
+   * @return The result of the kernel
+   */
+  template<typename Kernel>
+  auto dispatch(Kernel kernel)
+  {
+#ifdef MATLABW_SIMD_X86_DISPATCH
+    switch (getSimdLevel())
+    {
+    case SimdLevel::avx512:
+      return invokeAvx512(kernel);
+    case SimdLevel::avx2:
+      return invokeAvx2(kernel);
+    default:
+      break;
+    }
+#endif
+
+    return invokeGeneric(kernel);
+  }
+} // namespace matlabw::mx::algorithm::detail
+
+#endif /* MATLABW_MX_ALGORITHM_DETAIL_SIMD_HPP */
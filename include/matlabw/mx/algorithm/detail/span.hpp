@@ -0,0 +1,71 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_DETAIL_SPAN_HPP
+#define MATLABW_MX_ALGORITHM_DETAIL_SPAN_HPP
+
+#include "../../detail/include.hpp"
+
+namespace matlabw::mx::algorithm::detail
+{
+  /**
+   * @brief Gets a span over the elements of an array-like argument. Accepts typed arrays and references (anything
+   *        with getData() and getSize()) and contiguous ranges such as std::span or std::vector.
+   * @tparam A Argument type
+   * @param a The argument
+   * @return The span
+   */
+  template<typename A>
+  [[nodiscard]] auto toSpan(A&& a) noexcept
+  {
+    if constexpr (requires { a.getData(); a.getSize(); })
+    {
+      return std::span{a.getData(), a.getSize()};
+    }
+    else
+    {
+      return std::span{a};
+    }
+  }
+
+  /**
+   * @brief Element type of a span without const.
+   * @tparam S Span type
+   */
+  template<typename S>
+  using ElementType = std::remove_const_t<typename S::element_type>;
+
+  /**
+   * @brief Element type of an array-like argument without const.
+   * @tparam A Argument type
+   */
+  template<typename A>
+  using ElementOf = ElementType<decltype(toSpan(std::declval<const A&>()))>;
+
+  /// @brief Array with dimensions.
+  template<typename A>
+  concept DimensionedArray = requires(const A& a) { a.getDims(); };
+} // namespace matlabw::mx::algorithm::detail
+
+#endif /* MATLABW_MX_ALGORITHM_DETAIL_SPAN_HPP */
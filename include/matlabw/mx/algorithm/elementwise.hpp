@@ -0,0 +1,308 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_ELEMENTWISE_HPP
+#define MATLABW_MX_ALGORITHM_ELEMENTWISE_HPP
+
+#include "../detail/include.hpp"
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /// @brief Scale operation.
+  template<typename T>
+  struct ScaleOp
+  {
+    ScalarType<T> alpha; ///< The scalar
+
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return scale(x, alpha); }
+  };
+
+  /// @brief Axpy operation.
+  template<typename T>
+  struct AxpyOp
+  {
+    ScalarType<T> alpha; ///< The scalar
+
+    MATLABW_ALWAYS_INLINE T operator()(T y, T x) const noexcept { return add(y, scale(x, alpha)); }
+  };
+
+  /// @brief Addition operation.
+  struct AddOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T a, T b) const noexcept { return add(a, b); }
+  };
+
+  /// @brief Subtraction operation.
+  struct SubtractOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T a, T b) const noexcept { return subtract(a, b); }
+  };
+
+  /// @brief Multiplication operation.
+  struct MultiplyOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T a, T b) const noexcept { return multiply(a, b); }
+  };
+
+  /// @brief Division operation.
+  struct DivideOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T a, T b) const noexcept { return divide(a, b); }
+  };
+
+  /// @brief Multiply-add operation.
+  struct MultiplyAddOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T a, T b, T c) const noexcept { return multiplyAdd(a, b, c); }
+  };
+
+  /// @brief Clamp operation, NaN stays NaN.
+  template<typename T>
+  struct ClampOp
+  {
+    T lo; ///< Lower bound
+    T hi; ///< Upper bound
+
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return (x < lo) ? lo : ((x > hi) ? hi : x); }
+  };
+
+  /// @brief Absolute value operation.
+  struct AbsOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE auto operator()(T x) const noexcept { return detail::abs(x); }
+  };
+
+  /**
+   * @brief Runs a binary operation on array-like arguments.
+   * @tparam Op Operation type
+   * @param id Error identifier
+   * @param op The operation
+   * @param out Output
+   * @param a First input
+   * @param b Second input
+   */
+  template<typename Op, typename Out, typename InA, typename InB>
+  void binary(const char* id, Op op, Out&& out, const InA& a, const InB& b)
+  {
+    auto dst  = toSpan(out);
+    auto srcA = toSpan(a);
+    auto srcB = toSpan(b);
+
+    using T = ElementType<decltype(dst)>;
+
+    static_assert(Numeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<T, ElementType<decltype(srcA)>> && std::is_same_v<T, ElementType<decltype(srcB)>>,
+                  "element types must match");
+
+    checkSizes(id, dst.size(), srcA.size(), srcB.size());
+    transform(op, dst.size(), dst.data(), srcA.data(), srcB.data());
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes out = alpha * in. Integers are scaled in double precision, rounded and saturated.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...)
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param out Output, may be the same as the input
+   * @param in Input
+   * @param alpha The scalar
+   */
+  template<typename Out, typename In>
+  void scale(Out&& out, const In& in, detail::ScalarType<detail::ElementOf<In>> alpha)
+  {
+    auto dst = detail::toSpan(out);
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(detail::Numeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<T, detail::ElementType<decltype(src)>>, "element types must match");
+
+    detail::checkSizes("matlabw:mx:algorithm:scale", dst.size(), src.size());
+    detail::transform(detail::ScaleOp<T>{alpha}, dst.size(), dst.data(), src.data());
+  }
+
+  /**
+   * @brief Computes y = y + alpha * x.
+   * @tparam InOut Input/output array type
+   * @tparam In Input array type
+   * @param y Input and output
+   * @param alpha The scalar
+   * @param x Input
+   */
+  template<typename InOut, typename In>
+  void axpy(InOut&& y, detail::ScalarType<detail::ElementOf<In>> alpha, const In& x)
+  {
+    auto dst = detail::toSpan(y);
+    auto src = detail::toSpan(x);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(detail::Numeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<T, detail::ElementType<decltype(src)>>, "element types must match");
+
+    detail::checkSizes("matlabw:mx:algorithm:axpy", dst.size(), src.size());
+
+    const T* yIn = dst.data();
+
+    detail::transform(detail::AxpyOp<T>{alpha}, dst.size(), dst.data(), yIn, src.data());
+  }
+
+  /**
+   * @brief Computes out = a + b. Integers saturate.
+   * @param out Output, may be the same as an input
+   * @param a First input
+   * @param b Second input
+   */
+  template<typename Out, typename InA, typename InB>
+  void add(Out&& out, const InA& a, const InB& b)
+  {
+    detail::binary("matlabw:mx:algorithm:add", detail::AddOp{}, out, a, b);
+  }
+
+  /**
+   * @brief Computes out = a - b. Integers saturate.
+   * @param out Output, may be the same as an input
+   * @param a First input
+   * @param b Second input
+   */
+  template<typename Out, typename InA, typename InB>
+  void subtract(Out&& out, const InA& a, const InB& b)
+  {
+    detail::binary("matlabw:mx:algorithm:subtract", detail::SubtractOp{}, out, a, b);
+  }
+
+  /**
+   * @brief Computes out = a .* b. Integers saturate.
+   * @param out Output, may be the same as an input
+   * @param a First input
+   * @param b Second input
+   */
+  template<typename Out, typename InA, typename InB>
+  void multiply(Out&& out, const InA& a, const InB& b)
+  {
+    detail::binary("matlabw:mx:algorithm:multiply", detail::MultiplyOp{}, out, a, b);
+  }
+
+  /**
+   * @brief Computes out = a ./ b. Integers are rounded and saturated as in MATLAB.
+   * @param out Output, may be the same as an input
+   * @param a First input
+   * @param b Second input
+   */
+  template<typename Out, typename InA, typename InB>
+  void divide(Out&& out, const InA& a, const InB& b)
+  {
+    detail::binary("matlabw:mx:algorithm:divide", detail::DivideOp{}, out, a, b);
+  }
+
+  /**
+   * @brief Computes out = a .* b + c. Floating point values are fused with a single rounding.
+   * @param out Output, may be the same as an input
+   * @param a First factor
+   * @param b Second factor
+   * @param c Addend
+   */
+  template<typename Out, typename InA, typename InB, typename InC>
+  void multiplyAdd(Out&& out, const InA& a, const InB& b, const InC& c)
+  {
+    auto dst  = detail::toSpan(out);
+    auto srcA = detail::toSpan(a);
+    auto srcB = detail::toSpan(b);
+    auto srcC = detail::toSpan(c);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(detail::Numeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<T, detail::ElementType<decltype(srcA)>> &&
+                  std::is_same_v<T, detail::ElementType<decltype(srcB)>> &&
+                  std::is_same_v<T, detail::ElementType<decltype(srcC)>>, "element types must match");
+
+    detail::checkSizes("matlabw:mx:algorithm:multiplyAdd", dst.size(), srcA.size(), srcB.size(), srcC.size());
+    detail::transform(detail::MultiplyAddOp{}, dst.size(), dst.data(), srcA.data(), srcB.data(), srcC.data());
+  }
+
+  /**
+   * @brief Computes out = min(max(in, lo), hi). NaN values are preserved.
+   * @param out Output, may be the same as the input
+   * @param in Input
+   * @param lo Lower bound
+   * @param hi Upper bound
+   */
+  template<typename Out, typename In>
+  void clamp(Out&& out, const In& in, detail::ElementOf<In> lo, detail::ElementOf<In> hi)
+  {
+    auto dst = detail::toSpan(out);
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(detail::RealNumeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<T, detail::ElementType<decltype(src)>>, "element types must match");
+
+    if (hi < lo)
+    {
+      throw Exception{"matlabw:mx:algorithm:clamp", "upper bound must not be less than lower bound"};
+    }
+
+    detail::checkSizes("matlabw:mx:algorithm:clamp", dst.size(), src.size());
+    detail::transform(detail::ClampOp<T>{lo, hi}, dst.size(), dst.data(), src.data());
+  }
+
+  /**
+   * @brief Computes out = abs(in). For complex inputs the output is real. Integers saturate.
+   * @param out Output, may be the same as a real input
+   * @param in Input
+   */
+  template<typename Out, typename In>
+  void abs(Out&& out, const In& in)
+  {
+    auto dst = detail::toSpan(out);
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(src)>;
+
+    static_assert(detail::Numeric<T>, "unsupported element type");
+    static_assert(std::is_same_v<decltype(detail::abs(std::declval<T>())), detail::ElementType<decltype(dst)>>,
+                  "output element type must be the real type of the input");
+
+    detail::checkSizes("matlabw:mx:algorithm:abs", dst.size(), src.size());
+    detail::transform(detail::AbsOp{}, dst.size(), dst.data(), src.data());
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_ELEMENTWISE_HPP */
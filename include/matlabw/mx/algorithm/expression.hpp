@@ -0,0 +1,488 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_EXPRESSION_HPP
+#define MATLABW_MX_ALGORITHM_EXPRESSION_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "elementwise.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Base of the expression nodes, marks a type as an expression.
+  struct ExpressionBase {};
+
+  /**
+   * @brief Is the type an elementwise expression?
+   * @tparam E Type
+   */
+  template<typename E>
+  concept Expression = std::is_base_of_v<ExpressionBase, std::remove_cvref_t<E>>;
+
+  /**
+   * @brief Leaf expression referring to the elements of an array, which must outlive the expression.
+   * @tparam T Element type
+   */
+  template<typename T>
+  struct ArrayExpr : ExpressionBase
+  {
+    using value_type = T; ///< Element type
+
+    static constexpr bool isScalar{false}; ///< The expression has elements of its own.
+
+    const T*          data; ///< The elements
+    std::size_t       size; ///< Number of elements
+    View<std::size_t> dims; ///< Dimensions, empty for arrays without dimensions
+
+    /// @brief Gets the element at a linear index.
+    MATLABW_ALWAYS_INLINE T operator[](std::size_t i) const noexcept { return data[i]; }
+  };
+
+  /**
+   * @brief Leaf expression of a scalar broadcast to all elements.
+   * @tparam T Element type
+   */
+  template<typename T>
+  struct ScalarExpr : ExpressionBase
+  {
+    using value_type = T; ///< Element type
+
+    static constexpr bool isScalar{true}; ///< The expression is broadcast.
+
+    T                 value; ///< The scalar
+    std::size_t       size;  ///< Always 1
+    View<std::size_t> dims;  ///< Always empty
+
+    /// @brief Gets the scalar.
+    MATLABW_ALWAYS_INLINE T operator[](std::size_t) const noexcept { return value; }
+  };
+
+  /**
+   * @brief Expression applying an operation to the elements of another expression.
+   * @tparam Op Operation type
+   * @tparam E Operand type
+   */
+  template<typename Op, typename E>
+  struct UnaryExpr : ExpressionBase
+  {
+    using value_type = std::remove_cvref_t<std::invoke_result_t<const Op&, typename E::value_type>>; ///< Element type
+
+    static constexpr bool isScalar{E::isScalar}; ///< Whether the expression is broadcast.
+
+    Op                op;      ///< The operation
+    E                 operand; ///< The operand
+    std::size_t       size;    ///< Number of elements
+    View<std::size_t> dims;    ///< Dimensions
+
+    /**
+     * @brief Constructor.
+     * @param op The operation
+     * @param operand The operand
+     */
+    UnaryExpr(Op op, const E& operand) noexcept
+    : op{op}, operand{operand}, size{operand.size}, dims{operand.dims}
+    {}
+
+    /// @brief Gets the element at a linear index.
+    MATLABW_ALWAYS_INLINE value_type operator[](std::size_t i) const { return op(operand[i]); }
+  };
+
+  /**
+   * @brief Expression applying an operation to the elements of two other expressions, scalars are broadcast.
+   * @tparam Op Operation type
+   * @tparam L Left operand type
+   * @tparam R Right operand type
+   */
+  template<typename Op, typename L, typename R>
+  struct BinaryExpr : ExpressionBase
+  {
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>, "element types must match");
+
+    using value_type = typename L::value_type; ///< Element type
+
+    static constexpr bool isScalar{L::isScalar && R::isScalar}; ///< Whether the expression is broadcast.
+
+    Op                op;    ///< The operation
+    L                 left;  ///< The left operand
+    R                 right; ///< The right operand
+    std::size_t       size;  ///< Number of elements
+    View<std::size_t> dims;  ///< Dimensions, of the first operand which has any
+
+    /**
+     * @brief Constructor. Checks that the sizes of non-scalar operands match.
+     * @param op The operation
+     * @param left The left operand
+     * @param right The right operand
+     */
+    BinaryExpr(Op op, const L& left, const R& right)
+    : op{op}, left{left}, right{right}, size{L::isScalar ? right.size : left.size},
+      dims{left.dims.empty() ? right.dims : left.dims}
+    {
+      if constexpr (!L::isScalar && !R::isScalar)
+      {
+        detail::checkSizes("matlabw:mx:algorithm:Expression", left.size, right.size);
+      }
+    }
+
+    /// @brief Gets the element at a linear index.
+    MATLABW_ALWAYS_INLINE value_type operator[](std::size_t i) const { return op(left[i], right[i]); }
+  };
+
+  /**
+   * @brief Starts an expression from an array. Arrays combined with an expression are wrapped automatically.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input, must outlive the expression
+   * @return The expression
+   */
+  template<typename In>
+  [[nodiscard]] auto expr(const In& in) noexcept
+  {
+    if constexpr (Expression<In>)
+    {
+      return in;
+    }
+    else
+    {
+      auto src = detail::toSpan(in);
+
+      using T = detail::ElementType<decltype(src)>;
+
+      static_assert(detail::Numeric<T>, "unsupported element type");
+
+      View<std::size_t> dims{};
+
+      if constexpr (requires { in.getDims(); })
+      {
+        dims = in.getDims();
+      }
+
+      return ArrayExpr<T>{{}, src.data(), src.size(), dims};
+    }
+  }
+
+namespace detail
+{
+  /**
+   * @brief Is the type a scalar operand of an expression?
+   * @tparam T Type
+   */
+  template<typename T>
+  concept ExpressionScalar = std::is_arithmetic_v<std::remove_cvref_t<T>> || isComplex<std::remove_cvref_t<T>>;
+
+  /**
+   * @brief Converts an operand to an expression, scalars are cast to the element type of the other operand.
+   * @tparam T Element type of the other operand
+   * @tparam A Operand type
+   * @param a The operand
+   * @return The expression
+   */
+  template<typename T, typename A>
+  [[nodiscard]] auto toOperand(const A& a) noexcept
+  {
+    if constexpr (ExpressionScalar<A>)
+    {
+      return ScalarExpr<T>{{}, static_cast<T>(a), 1, {}};
+    }
+    else
+    {
+      return expr(a);
+    }
+  }
+
+  /**
+   * @brief Gets the element type of an expression operand.
+   * @tparam A Operand type, an expression or an array
+   */
+  template<typename A>
+  using OperandType = typename decltype(expr(std::declval<const A&>()))::value_type;
+
+  /**
+   * @brief Makes a binary expression, one operand is an expression and the other an expression, array or scalar.
+   * @tparam Op Operation type
+   * @tparam L Left operand type
+   * @tparam R Right operand type
+   * @param op The operation
+   * @param l The left operand
+   * @param r The right operand
+   * @return The expression
+   */
+  template<typename Op, typename L, typename R>
+  [[nodiscard]] auto makeBinary(Op op, const L& l, const R& r)
+  {
+    if constexpr (ExpressionScalar<L>)
+    {
+      using T = OperandType<R>;
+
+      return BinaryExpr<Op, ScalarExpr<T>, decltype(expr(r))>{op, toOperand<T>(l), expr(r)};
+    }
+    else
+    {
+      using T = OperandType<L>;
+
+      return BinaryExpr<Op, decltype(expr(l)), decltype(toOperand<T>(r))>{op, expr(l), toOperand<T>(r)};
+    }
+  }
+
+  /// @brief Negation operation.
+  struct NegateOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return subtract(T{}, x); }
+  };
+
+  /// @brief Square root operation.
+  struct SqrtOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return std::sqrt(x); }
+  };
+
+  /// @brief Exponential operation.
+  struct ExpOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return std::exp(x); }
+  };
+
+  /// @brief Natural logarithm operation.
+  struct LogOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return std::log(x); }
+  };
+
+  /// @brief Sine operation.
+  struct SinOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return std::sin(x); }
+  };
+
+  /// @brief Cosine operation.
+  struct CosOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return std::cos(x); }
+  };
+
+  /**
+   * @brief Makes a unary expression of a floating point expression.
+   * @tparam Op Operation type
+   * @tparam E Expression type
+   * @param e The expression
+   * @return The expression
+   */
+  template<typename Op, typename E>
+  [[nodiscard]] auto makeFloatUnary(const E& e) noexcept
+  {
+    static_assert(RealFloat<RealType<typename E::value_type>>, "function requires a floating point element type");
+
+    return UnaryExpr<Op, E>{Op{}, e};
+  }
+} // namespace detail
+
+  /**
+   * @brief Is the pair of operand types valid for a binary expression operator? At least one operand must be an
+   *        expression, the other may be an expression, an array or a scalar.
+   * @tparam L Left operand type
+   * @tparam R Right operand type
+   */
+  template<typename L, typename R>
+  concept ExpressionOperands = (Expression<L> || Expression<R>) &&
+                               !(detail::ExpressionScalar<L> && detail::ExpressionScalar<R>);
+
+  /**
+   * @brief Elementwise addition, integers saturate.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator+(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::AddOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise subtraction, integers saturate.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator-(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::SubtractOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise multiplication, integers are rounded and saturate.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator*(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::MultiplyOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise division, integers are rounded and saturate.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator/(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::DivideOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise negation, integers saturate.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto operator-(const E& e) noexcept
+  {
+    return UnaryExpr<detail::NegateOp, E>{detail::NegateOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise absolute value, real for complex elements. Integers saturate.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto abs(const E& e) noexcept
+  {
+    return UnaryExpr<detail::AbsOp, E>{detail::AbsOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise square root of floating point elements.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto sqrt(const E& e) noexcept
+  {
+    return detail::makeFloatUnary<detail::SqrtOp>(e);
+  }
+
+  /**
+   * @brief Elementwise exponential of floating point elements.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto exp(const E& e) noexcept
+  {
+    return detail::makeFloatUnary<detail::ExpOp>(e);
+  }
+
+  /**
+   * @brief Elementwise natural logarithm of floating point elements.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto log(const E& e) noexcept
+  {
+    return detail::makeFloatUnary<detail::LogOp>(e);
+  }
+
+  /**
+   * @brief Elementwise sine of floating point elements.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto sin(const E& e) noexcept
+  {
+    return detail::makeFloatUnary<detail::SinOp>(e);
+  }
+
+  /**
+   * @brief Elementwise cosine of floating point elements.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto cos(const E& e) noexcept
+  {
+    return detail::makeFloatUnary<detail::CosOp>(e);
+  }
+
+  /**
+   * @brief Evaluates an expression into an existing output in a single vectorized sweep without temporaries, large
+   *        outputs are split between the threads of the library-managed thread pool.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...), its element type must match the expression.
+   * @tparam E Expression type
+   * @param out Output, may be one of the operands
+   * @param e The expression
+   */
+  template<typename Out, Expression E>
+  void assign(Out&& out, const E& e)
+  {
+    auto dst = detail::toSpan(out);
+
+    using T = typename E::value_type;
+
+    static_assert(std::is_same_v<detail::ElementType<decltype(dst)>, T>, "output element type must match");
+
+    T* data = dst.data();
+
+    if constexpr (E::isScalar)
+    {
+      std::fill(dst.begin(), dst.end(), e[0]);
+    }
+    else
+    {
+      detail::checkSizes("matlabw:mx:algorithm:assign", dst.size(), e.size);
+      detail::forChunks(e.size, [=](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+      {
+        for (std::size_t i{first}; i < last; ++i)
+        {
+          data[i] = e[i];
+        }
+      });
+    }
+  }
+
+  /**
+   * @brief Evaluates an expression into a new uninitialized numeric array, see assign().
+   * @tparam E Expression type
+   * @param e The expression
+   * @return The numeric array, of the dimensions of the first operand with dimensions or a column vector
+   */
+  template<Expression E>
+  [[nodiscard]] NumericArray<typename E::value_type> evaluate(const E& e)
+  {
+    using T = typename E::value_type;
+
+    NumericArray<T> out = e.dims.empty() ? makeUninitNumericArray<T>(e.size, 1) : makeUninitNumericArray<T>(e.dims);
+
+    assign(out, e);
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_EXPRESSION_HPP */
@@ -0,0 +1,218 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ALGORITHM_FOR_EACH_COLUMN_HPP
+#define MATLABW_MX_ALGORITHM_FOR_EACH_COLUMN_HPP
+
+#include "../detail/include.hpp"
+
+#include "detail/parallel.hpp"
+#include "../Exception.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /**
+   * @brief Minimum number of elements per parallel task of a column loop. Narrow columns are grouped into blocks of at
+   *        least this size, so that each task amortizes its scheduling.
+   */
+  inline constexpr std::size_t columnBlockMinSize{std::size_t{1} << 14};
+
+  /**
+   * @brief Number of elements of the chunks tall columns are split into by reduceColumns(). Fixed, so that the result
+   *        does not depend on the number of threads.
+   */
+  inline constexpr std::size_t columnReduceChunkSize{parallelChunkSize};
+
+  /**
+   * @brief Checks that an argument is a matrix-like array: getData(), getDimM() and getDimN().
+   * @tparam A Argument type
+   */
+  template<typename A>
+  concept ColumnArray = requires(A& a)
+  {
+    a.getData();
+    a.getDimM();
+    a.getDimN();
+  };
+
+  /**
+   * @brief Runs a loop over the columns of an m-by-n matrix. Inputs below parallelMinSize elements run on the calling
+   *        thread, larger ones are split between the threads of the library-managed thread pool in blocks of whole
+   *        columns holding at least columnBlockMinSize elements.
+   * @tparam Fn Loop body type, called as fn(j) for each column
+   * @param m Number of rows
+   * @param n Number of columns
+   * @param fn The loop body
+   */
+  template<typename Fn>
+  void forColumns(std::size_t m, std::size_t n, Fn&& fn)
+  {
+    if (m * n < parallelMinSize)
+    {
+      for (std::size_t j{}; j < n; ++j)
+      {
+        fn(j);
+      }
+
+      return;
+    }
+
+    const std::size_t grain = std::max(std::size_t{1}, columnBlockMinSize / std::max(m, std::size_t{1}));
+
+    parallel::parallelFor(0, n, grain, [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t j{first}; j < last; ++j)
+      {
+        fn(j);
+      }
+    });
+  }
+} // namespace detail
+
+  /**
+   * @brief Calls a function for each column of a matrix, columns are distributed between the threads of the
+   *        library-managed thread pool. Dimensions beyond the second are treated as further columns. The body runs
+   *        outside of the MATLAB thread for large inputs, so it must not call the MATLAB API.
+   * @tparam A Array type, e.g. TypedArrayRef<T>, TypedArrayCref<T> or TypedArray<T>
+   * @tparam Fn Function type, called as fn(std::span<T> column, std::size_t j), T is const for const arrays
+   * @param array The matrix
+   * @param fn The function
+   */
+  template<detail::ColumnArray A, typename Fn>
+  void forEachColumn(A&& array, Fn&& fn)
+  {
+    const std::size_t m    = array.getDimM();
+    const std::size_t n    = array.getDimN();
+    auto* const       data = array.getData();
+
+    detail::forColumns(m, n, [&](std::size_t j)
+    {
+      fn(std::span{data + j * m, m}, j);
+    });
+  }
+
+  /**
+   * @brief Calls a function for each pair of corresponding columns of an input and an output matrix of the same size,
+   *        columns are distributed between the threads of the library-managed thread pool. The body runs outside of
+   *        the MATLAB thread for large inputs, so it must not call the MATLAB API.
+   * @tparam In Input array type
+   * @tparam Out Output array type
+   * @tparam Fn Function type, called as fn(std::span<const T> in, std::span<U> out, std::size_t j)
+   * @param in The input matrix
+   * @param out The output matrix, must not overlap the input unless it is the same array
+   * @param fn The function
+   */
+  template<detail::ColumnArray In, detail::ColumnArray Out, typename Fn>
+  void forEachColumn(const In& in, Out&& out, Fn&& fn)
+  {
+    const std::size_t m = in.getDimM();
+    const std::size_t n = in.getDimN();
+
+    if (out.getDimM() != m || out.getDimN() != n)
+    {
+      throw Exception{"matlabw:mx:algorithm:forEachColumn", "input and output must have the same size"};
+    }
+
+    const auto* const src = in.getData();
+    auto* const       dst = out.getData();
+
+    detail::forColumns(m, n, [&](std::size_t j)
+    {
+      fn(std::span<const std::remove_pointer_t<decltype(src)>>{src + j * m, m}, std::span{dst + j * m, m}, j);
+    });
+  }
+
+  /**
+   * @brief Reduces each column of a matrix. Columns longer than detail::columnReduceChunkSize are split into chunks
+   *        of that size which are reduced separately and combined in order, so tall matrices with few columns are
+   *        parallelized too and the result does not depend on the number of threads. The functions run outside of the
+   *        MATLAB thread for large inputs, so they must not call the MATLAB API.
+   * @tparam A Array type
+   * @tparam R Result type
+   * @tparam Reduce Function type, called as reduce(R acc, std::span<const T> chunk) -> R
+   * @tparam Combine Function type, called as combine(R a, R b) -> R
+   * @param array The matrix
+   * @param init Identity of the reduction, passed as the accumulator of every chunk
+   * @param reduce The chunk reduction
+   * @param combine Combines the results of two consecutive chunks
+   * @return The result of each column
+   */
+  template<detail::ColumnArray A, typename R, typename Reduce, typename Combine>
+  [[nodiscard]] std::vector<R> reduceColumns(const A& array, const R& init, Reduce&& reduce, Combine&& combine)
+  {
+    const std::size_t m          = array.getDimM();
+    const std::size_t n          = array.getDimN();
+    const auto* const data       = array.getData();
+    const std::size_t chunkCount = std::max(std::size_t{1}, (m + detail::columnReduceChunkSize - 1)
+                                                            / detail::columnReduceChunkSize);
+
+    using T = std::remove_cv_t<std::remove_pointer_t<decltype(data)>>;
+
+    std::vector<R> partials(n * chunkCount, init);
+
+    auto body = [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t t{first}; t < last; ++t)
+      {
+        const std::size_t j     = t / chunkCount;
+        const std::size_t begin = (t % chunkCount) * detail::columnReduceChunkSize;
+        const std::size_t end   = std::min(m, begin + detail::columnReduceChunkSize);
+
+        partials[t] = reduce(init, std::span<const T>{data + j * m + begin, end - begin});
+      }
+    };
+
+    if (m * n < detail::parallelMinSize)
+    {
+      body(0, partials.size());
+    }
+    else
+    {
+      const std::size_t taskSize = std::max(std::size_t{1}, std::min(m, detail::columnReduceChunkSize));
+      const std::size_t grain    = std::max(std::size_t{1}, detail::columnBlockMinSize / taskSize);
+
+      parallel::parallelFor(0, partials.size(), grain, body);
+    }
+
+    std::vector<R> results{};
+    results.reserve(n);
+
+    for (std::size_t j{}; j < n; ++j)
+    {
+      R result = std::move(partials[j * chunkCount]);
+
+      for (std::size_t c{1}; c < chunkCount; ++c)
+      {
+        result = combine(std::move(result), std::move(partials[j * chunkCount + c]));
+      }
+
+      results.push_back(std::move(result));
+    }
+
+    return results;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_FOR_EACH_COLUMN_HPP */
@@ -0,0 +1,423 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ALGORITHM_GATHER_HPP
+#define MATLABW_MX_ALGORITHM_GATHER_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <xmmintrin.h>
+#endif
+
+#include "construct.hpp"
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Options of a gather.
+  struct GatherOptions
+  {
+    std::optional<std::size_t> prefetchDistance{}; ///< Elements prefetched ahead, 0 disables, tuned if not set
+  };
+
+namespace detail
+{
+  /// @brief Prefetch distances tried by the tuning, in elements.
+  inline constexpr std::size_t gatherPrefetchCandidates[]{0, 8, 16, 32, 64};
+
+  /// @brief Number of elements gathered per tried distance, the tuning blocks are part of the real gather.
+  inline constexpr std::size_t gatherTuneBlockSize{8192};
+
+  /// @brief Minimum size of gathered data in bytes to prefetch, smaller data likely stay in the cache.
+  inline constexpr std::size_t gatherPrefetchMinBytes{std::size_t{1} << 23};
+
+  /// @brief Number of elements gathered to the stack before they are written with non-temporal stores.
+  inline constexpr std::size_t gatherStreamBlockSize{512};
+
+  /// @brief Marks the prefetch distance as not tuned yet.
+  inline constexpr std::size_t gatherUntuned{std::numeric_limits<std::size_t>::max()};
+
+  /**
+   * @brief Gets the prefetch distance tuned by the first large gather of the process.
+   * @return The distance, gatherUntuned before the tuning
+   */
+  [[nodiscard]] inline std::atomic<std::size_t>& getTunedPrefetchDistance() noexcept
+  {
+    static std::atomic<std::size_t> distance{gatherUntuned};
+
+    return distance;
+  }
+
+  /**
+   * @brief Prefetches a cache line for reading.
+   * @param address The address
+   */
+  MATLABW_ALWAYS_INLINE void prefetchRead(const void* address) noexcept
+  {
+#if defined(__GNUC__)
+    __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    static_cast<void>(address);
+#endif
+  }
+
+  /**
+   * @brief Converts a validated one-based index to an offset.
+   * @tparam Index Index type
+   * @param index The index
+   * @return The zero-based offset
+   */
+  template<typename Index>
+  MATLABW_ALWAYS_INLINE std::size_t toGatherOffset(Index index) noexcept
+  {
+    return static_cast<std::size_t>(index) - 1;
+  }
+
+  /**
+   * @brief Checks that indices are integers in [1, size], branchless within blocks so that the compiler vectorizes
+   *        it, in parallel for large index arrays.
+   * @tparam Index Index type
+   * @param id Error identifier
+   * @param indices The indices
+   * @param size Number of elements of the data
+   */
+  template<typename Index>
+  void checkGatherIndices(const char* id, View<Index> indices, std::size_t size)
+  {
+    std::atomic<bool> invalid{};
+
+    const auto checkRange = [&](std::size_t first, std::size_t last)
+    {
+      bool bad{};
+
+      for (std::size_t i{first}; i < last; ++i)
+      {
+        const Index x = indices[i];
+
+        if constexpr (std::is_floating_point_v<Index>)
+        {
+          bad |= !((x >= 1) & (x <= static_cast<Index>(size)) & (x == std::trunc(x)));
+        }
+        else
+        {
+          bad |= (x < 1) | (static_cast<std::make_unsigned_t<Index>>(x) > size);
+        }
+      }
+
+      if (bad)
+      {
+        invalid.store(true, std::memory_order_relaxed);
+      }
+    };
+
+    if (indices.size() < parallelMinSize)
+    {
+      checkRange(0, indices.size());
+    }
+    else
+    {
+      parallelChunks(indices.size(), checkRange);
+    }
+
+    if (invalid.load(std::memory_order_relaxed))
+    {
+      throw Exception{id, "indices must be positive integers not exceeding the number of elements"};
+    }
+  }
+
+  /**
+   * @brief Gathers a range of validated indices, prefetching the element a distance ahead.
+   * @tparam T Element type
+   * @tparam Index Index type
+   * @param out Output pointer of the range
+   * @param data The data
+   * @param indices Index pointer of the range
+   * @param n Number of elements
+   * @param distance The prefetch distance, 0 disables prefetching
+   */
+  template<typename T, typename Index>
+  MATLABW_ALWAYS_INLINE void gatherRange(T*           out,
+                                         const T*     data,
+                                         const Index* indices,
+                                         std::size_t  n,
+                                         std::size_t  distance) noexcept
+  {
+    std::size_t i{};
+
+    if (distance > 0 && n > distance)
+    {
+      for (; i < n - distance; ++i)
+      {
+        prefetchRead(data + toGatherOffset(indices[i + distance]));
+        out[i] = data[toGatherOffset(indices[i])];
+      }
+    }
+
+    for (; i < n; ++i)
+    {
+      out[i] = data[toGatherOffset(indices[i])];
+    }
+  }
+
+  /**
+   * @brief Gathers a range, large outputs are staged on the stack and written with non-temporal stores.
+   * @tparam T Element type
+   * @tparam Index Index type
+   * @param out Output pointer of the range
+   * @param data The data
+   * @param indices Index pointer of the range
+   * @param n Number of elements
+   * @param distance The prefetch distance
+   * @param stream True to write with non-temporal stores
+   */
+  template<typename T, typename Index>
+  void gatherBlock(T*           out,
+                   const T*     data,
+                   const Index* indices,
+                   std::size_t  n,
+                   std::size_t  distance,
+                   bool         stream) noexcept
+  {
+    if (!stream)
+    {
+      gatherRange(out, data, indices, n, distance);
+      return;
+    }
+
+    alignas(64) T buffer[gatherStreamBlockSize];
+
+    for (std::size_t first{}; first < n; first += gatherStreamBlockSize)
+    {
+      const std::size_t count = std::min(gatherStreamBlockSize, n - first);
+
+      // The prefetches run ahead into the next block, the last ones of the block are not issued.
+      gatherRange(buffer, data, indices + first, count, distance);
+      copyStream(out + first, buffer, count);
+    }
+  }
+
+  /**
+   * @brief Gathers validated indices, the first call of the process on large data tunes the prefetch distance on
+   *        consecutive blocks of its own output, the rest is split between the threads of the library-managed pool.
+   * @tparam T Element type
+   * @tparam Index Index type
+   * @param out Output
+   * @param data The data
+   * @param indices The indices, the same size as the output
+   * @param options The options
+   */
+  template<typename T, typename Index>
+  void gather(Span<T> out, View<T> data, View<Index> indices, const GatherOptions& options)
+  {
+    const std::size_t n      = indices.size();
+    const bool        stream = out.size_bytes() >= streamMinBytes;
+
+    std::size_t first{};
+    std::size_t distance{};
+
+    if (options.prefetchDistance.has_value())
+    {
+      distance = *options.prefetchDistance;
+    }
+    else if (data.size_bytes() >= gatherPrefetchMinBytes)
+    {
+      distance = getTunedPrefetchDistance().load(std::memory_order_relaxed);
+
+      if (distance == gatherUntuned && n >= std::size(gatherPrefetchCandidates) * gatherTuneBlockSize * 4)
+      {
+        double best{std::numeric_limits<double>::infinity()};
+
+        for (const std::size_t candidate : gatherPrefetchCandidates)
+        {
+          const auto start = std::chrono::steady_clock::now();
+
+          gatherBlock(out.data() + first, data.data(), indices.data() + first, gatherTuneBlockSize, candidate, stream);
+
+          const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+          if (time < best)
+          {
+            best     = time;
+            distance = candidate;
+          }
+
+          first += gatherTuneBlockSize;
+        }
+
+        getTunedPrefetchDistance().store(distance, std::memory_order_relaxed);
+      }
+      else if (distance == gatherUntuned)
+      {
+        distance = gatherPrefetchCandidates[2];
+      }
+    }
+
+    const std::size_t rest = n - first;
+
+    const auto gatherChunk = [&](std::size_t begin, std::size_t end)
+    {
+      gatherBlock(out.data() + first + begin, data.data(), indices.data() + first + begin, end - begin, distance,
+                  stream);
+    };
+
+    if (rest < parallelMinSize)
+    {
+      gatherChunk(0, rest);
+    }
+    else
+    {
+      parallelChunks(rest, gatherChunk);
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Elements of data selected by one-based MATLAB indices, like data(indices). The indices are validated once
+   *        on construction, so the elements are accessed without checks. Random gathers from large data are
+   *        bound by the memory latency, gather() hides it with software prefetches of the elements a tuned distance
+   *        ahead and writes large outputs with non-temporal stores. The data and indices must outlive the view.
+   * @tparam T Element type
+   * @tparam Index Index type, double for MATLAB indices or an integer type
+   */
+  template<typename T, typename Index = double>
+  class IndexedView
+  {
+    static_assert(detail::Numeric<T>, "unsupported element type");
+    static_assert(detail::RealNumeric<Index>, "indices must be real numeric");
+
+    public:
+      /**
+       * @brief Constructor, validates the indices.
+       * @param data The data
+       * @param indices One-based indices into the data
+       * @throws Exception if an index is not an integer in [1, data.size()]
+       */
+      IndexedView(View<T> data, View<Index> indices)
+      : mData{data}, mIndices{indices}
+      {
+        detail::checkGatherIndices("matlabw:mx:algorithm:IndexedView", indices, data.size());
+      }
+
+      /**
+       * @brief Gets the number of selected elements.
+       * @return The number of indices
+       */
+      [[nodiscard]] std::size_t size() const noexcept
+      {
+        return mIndices.size();
+      }
+
+      /**
+       * @brief Gets a selected element.
+       * @param i Zero-based position in the indices
+       * @return The element
+       */
+      [[nodiscard]] const T& operator[](std::size_t i) const noexcept
+      {
+        return mData[detail::toGatherOffset(mIndices[i])];
+      }
+
+      /**
+       * @brief Gets the zero-based offset into the data of a selected element.
+       * @param i Zero-based position in the indices
+       * @return The offset
+       */
+      [[nodiscard]] std::size_t getOffset(std::size_t i) const noexcept
+      {
+        return detail::toGatherOffset(mIndices[i]);
+      }
+
+      /**
+       * @brief Writes the selected elements, in parallel for large outputs.
+       * @param out Output of the size of the view
+       * @param options The options
+       */
+      template<typename Out>
+      void gather(Out&& out, const GatherOptions& options = {}) const
+      {
+        auto dst = detail::toSpan(out);
+
+        static_assert(std::is_same_v<detail::ElementType<decltype(dst)>, T>, "output element type must match");
+
+        detail::checkSizes("matlabw:mx:algorithm:IndexedView:gather", dst.size(), mIndices.size());
+        detail::gather(Span<T>{dst.data(), dst.size()}, mData, mIndices, options);
+      }
+    private:
+      View<T>     mData;    ///< The data
+      View<Index> mIndices; ///< The one-based indices
+  };
+
+  /**
+   * @brief Creates an indexed view, validating the indices.
+   * @param data The data (TypedArrayCref, TypedArray, span, ...)
+   * @param indices One-based indices, double or integer
+   * @return The view
+   */
+  template<typename Data, typename Indices>
+  [[nodiscard]] auto makeIndexedView(const Data& data, const Indices& indices)
+  {
+    using T     = detail::ElementOf<Data>;
+    using Index = detail::ElementOf<Indices>;
+
+    const auto values   = detail::toSpan(data);
+    const auto selected = detail::toSpan(indices);
+
+    return IndexedView<T, Index>{View<T>{values.data(), values.size()}, View<Index>{selected.data(), selected.size()}};
+  }
+
+  /**
+   * @brief Gathers the elements selected by one-based MATLAB indices, like data(indices).
+   * @param data The data
+   * @param indices Array of one-based indices, double or integer
+   * @param options The options
+   * @return Numeric array of the elements, of the dimensions of the indices
+   */
+  template<typename Data, detail::DimensionedArray Indices>
+  [[nodiscard]] auto gather(const Data& data, const Indices& indices, const GatherOptions& options = {})
+  {
+    using T = detail::ElementOf<Data>;
+
+    const auto view = makeIndexedView(data, indices);
+
+    NumericArray<T> out = makeUninitNumericArray<T>(indices.getDims());
+
+    view.gather(out, options);
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_GATHER_HPP */
@@ -0,0 +1,966 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_GROUP_HPP
+#define MATLABW_MX_ALGORITHM_GROUP_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+
+#include "cells.hpp"
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/span.hpp"
+#include "mask.hpp"
+#include "sort.hpp"
+#include "../detail/hash.hpp"
+#include "../LogicalArray.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Order of the values returned by unique.
+  enum class UniqueOrder
+  {
+    sorted, ///< Ascending order, as unique(a)
+    stable, ///< Order of the first occurrences, as unique(a, 'stable')
+  };
+
+  /**
+   * @brief Result of unique, values = a(first) and a = values(groups) as [c, ia, ic] = unique(a).
+   * @tparam Values Values type
+   * @tparam Index Index type
+   */
+  template<typename Values, typename Index>
+  struct Unique
+  {
+    Values              values; ///< The unique values
+    NumericArray<Index> first;  ///< One-based index of the first occurrence of each unique value, a column vector
+    NumericArray<Index> groups; ///< One-based index of the unique value of each element, a column vector
+  };
+
+  /**
+   * @brief Result of ismember, as [found, locations] = ismember(a, s).
+   * @tparam Index Index type
+   */
+  template<typename Index>
+  struct Membership
+  {
+    LogicalArray        found;     ///< True for the elements of a found in s
+    NumericArray<Index> locations; ///< One-based lowest index in s of each element of a, 0 if not found
+  };
+
+namespace detail
+{
+  /// @brief Number of bits of the hash selecting the partition of a parallel hash index.
+  inline constexpr std::size_t hashPartitionBits{6};
+
+  /// @brief Marker of an empty hash slot.
+  inline constexpr std::size_t emptySlot{std::numeric_limits<std::size_t>::max()};
+
+  /**
+   * @brief Calls a function for ranges of indices, in parallel on the library-managed thread pool from a size.
+   * @tparam Fn Function type, called as fn(first, last)
+   * @param n Number of indices
+   * @param minSize Minimum number of indices processed in parallel
+   * @param fn The function
+   */
+  template<typename Fn>
+  void forRanges(std::size_t n, std::size_t minSize, Fn&& fn)
+  {
+    if (n < minSize)
+    {
+      fn(std::size_t{}, n);
+    }
+    else
+    {
+      parallel::parallelFor(0, n, parallelChunkSize, fn);
+    }
+  }
+
+  /**
+   * @brief Checks if an input is partitioned for parallel processing. Partitioned and serial processing give the same
+   *        result, partitions only pay off if the library-managed thread pool can run them in parallel.
+   * @param n Number of elements
+   * @param minSize Minimum number of elements processed in parallel
+   * @return True if the input should be partitioned
+   */
+  [[nodiscard]] inline bool usePartitions(std::size_t n, std::size_t minSize)
+  {
+    const auto& pool = parallel::getThreadPool();
+
+    return n >= minSize && pool.getThreadCount() != 0 && !pool.isWorkerThread();
+  }
+
+  /// @brief Indices stably partitioned into buckets, bucket p spans offsets[p] to offsets[p + 1].
+  struct Partitions
+  {
+    std::vector<std::size_t> offsets; ///< Bucket offsets, one more than buckets
+    std::vector<std::size_t> indices; ///< Indices ordered by bucket, ascending within a bucket
+  };
+
+  /**
+   * @brief Stably partitions the indices 0 to n - 1 into buckets. Fixed-size chunks are counted and scattered in
+   *        parallel, the chunk offsets of every bucket follow the chunk order.
+   * @tparam BucketOf Function type, called as bucketOf(i) for the bucket of index i
+   * @param n Number of indices
+   * @param bucketCount Number of buckets
+   * @param bucketOf The function
+   * @return The partitions
+   */
+  template<typename BucketOf>
+  [[nodiscard]] Partitions partitionIndices(std::size_t n, std::size_t bucketCount, BucketOf bucketOf)
+  {
+    const std::size_t chunkCount = (n + parallelChunkSize - 1) / parallelChunkSize;
+
+    std::vector<std::size_t> counts(chunkCount * bucketCount);
+
+    auto forEachChunk = [&](auto&& fn)
+    {
+      parallel::parallelFor(0, chunkCount, 1, [&](std::size_t chunk)
+      {
+        fn(counts.data() + chunk * bucketCount, chunk * parallelChunkSize,
+           std::min(chunk * parallelChunkSize + parallelChunkSize, n));
+      });
+    };
+
+    forEachChunk([&](std::size_t* count, std::size_t first, std::size_t last)
+    {
+      for (std::size_t i{first}; i < last; ++i)
+      {
+        ++count[bucketOf(i)];
+      }
+    });
+
+    Partitions partitions{std::vector<std::size_t>(bucketCount + 1), std::vector<std::size_t>(n)};
+
+    std::size_t offset{};
+
+    for (std::size_t bucket{}; bucket < bucketCount; ++bucket)
+    {
+      partitions.offsets[bucket] = offset;
+
+      for (std::size_t chunk{}; chunk < chunkCount; ++chunk)
+      {
+        offset += std::exchange(counts[chunk * bucketCount + bucket], offset);
+      }
+    }
+
+    partitions.offsets[bucketCount] = offset;
+
+    forEachChunk([&](std::size_t* next, std::size_t first, std::size_t last)
+    {
+      for (std::size_t i{first}; i < last; ++i)
+      {
+        partitions.indices[next[bucketOf(i)]++] = i;
+      }
+    });
+
+    return partitions;
+  }
+
+  /**
+   * @brief Hashes a numeric key.
+   * @tparam U Unsigned key type
+   * @param key The key
+   * @return The hash
+   */
+  template<typename U>
+    requires std::is_unsigned_v<U>
+  [[nodiscard]] MATLABW_ALWAYS_INLINE std::uint64_t hashKey(U key) noexcept
+  {
+    return mx::detail::hashAvalanche(mx::detail::hashMultiplyFold(std::uint64_t{key} ^ mx::detail::hashKeys[0],
+                                                                  mx::detail::hashPrimes[0]));
+  }
+
+  /**
+   * @brief Hashes a string key.
+   * @param key The key
+   * @return The hash
+   */
+  [[nodiscard]] inline std::uint64_t hashKey(std::string_view key) noexcept
+  {
+    return mx::detail::hashBytes128(key.data(), key.size()).low;
+  }
+
+  /**
+   * @brief Keys of a numeric array. Both zeros are equal and NaN values are missing, they equal no value as in unique
+   *        and ismember.
+   * @tparam T Element type
+   */
+  template<typename T>
+  struct NumericKeys
+  {
+    /// @brief Minimum number of keys hashed in parallel.
+    static constexpr std::size_t minParallelSize{parallelMinSize};
+
+    const T*    data; ///< The elements
+    std::size_t n;    ///< Number of elements
+
+    /**
+     * @brief Gets the number of keys.
+     * @return The number of keys
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return n;
+    }
+
+    /**
+     * @brief Checks if a key is missing.
+     * @param i Index of the key
+     * @return True for NaN values
+     */
+    [[nodiscard]] bool isMissing(std::size_t i) const noexcept
+    {
+      return data[i] != data[i];
+    }
+
+    /**
+     * @brief Gets a key.
+     * @param i Index of the key
+     * @return The key, equal for equal values
+     */
+    [[nodiscard]] SortKey<T> operator[](std::size_t i) const noexcept
+    {
+      return toSortKey<true>(data[i], SortKey<T>{});
+    }
+  };
+
+  /// @brief Keys of a string list, no string is missing.
+  struct StringKeys
+  {
+    /// @brief Minimum number of keys hashed in parallel.
+    static constexpr std::size_t minParallelSize{stringParallelMinSize};
+
+    const StringList* strings; ///< The strings
+
+    /**
+     * @brief Gets the number of keys.
+     * @return The number of keys
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return strings->size();
+    }
+
+    /**
+     * @brief Checks if a key is missing.
+     * @return Always false
+     */
+    [[nodiscard]] bool isMissing(std::size_t) const noexcept
+    {
+      return false;
+    }
+
+    /**
+     * @brief Gets a key.
+     * @param i Index of the key
+     * @return The string
+     */
+    [[nodiscard]] std::string_view operator[](std::size_t i) const noexcept
+    {
+      return (*strings)[i];
+    }
+  };
+
+  /**
+   * @brief Open-addressing hash index over keys with linear probing, maps every present key to the lowest index at
+   *        which it occurs. Large inputs are split by the high bits of the hash into partitions with their own table,
+   *        which are built in parallel without synchronization.
+   */
+  class HashIndex
+  {
+    public:
+      /**
+       * @brief Builds the index.
+       * @tparam Keys Keys type
+       * @param keys The keys
+       * @param first Receives the lowest index of every key equal to key i, i for missing keys, may be nullptr
+       */
+      template<typename Keys>
+      HashIndex(const Keys& keys, std::size_t* first)
+      : mHashes(keys.size())
+      {
+        const std::size_t n = keys.size();
+
+        forRanges(n, Keys::minParallelSize, [&](std::size_t begin, std::size_t end)
+        {
+          for (std::size_t i{begin}; i < end; ++i)
+          {
+            mHashes[i] = hashKey(keys[i]);
+          }
+        });
+
+        if (!usePartitions(n, Keys::minParallelSize))
+        {
+          mTables.resize(1);
+          build(keys, 0, n, [](std::size_t i) { return i; }, first);
+          return;
+        }
+
+        mBits = hashPartitionBits;
+
+        const std::size_t partitionCount = std::size_t{1} << mBits;
+
+        const Partitions partitions = partitionIndices(n, partitionCount, [this](std::size_t i)
+        {
+          return getPartition(mHashes[i]);
+        });
+
+        mTables.resize(partitionCount);
+
+        parallel::parallelFor(0, partitionCount, 1, [&](std::size_t partition)
+        {
+          const std::size_t* indices = partitions.indices.data() + partitions.offsets[partition];
+
+          build(keys, partition, partitions.offsets[partition + 1] - partitions.offsets[partition],
+                [indices](std::size_t i) { return indices[i]; }, first);
+        });
+      }
+
+      /**
+       * @brief Finds a key.
+       * @tparam Keys Keys type of the index
+       * @tparam Key Key type
+       * @param keys The keys of the index
+       * @param key The key
+       * @return The lowest index of the key, emptySlot if not present
+       */
+      template<typename Keys, typename Key>
+      [[nodiscard]] std::size_t find(const Keys& keys, const Key& key) const noexcept
+      {
+        const std::uint64_t hash  = hashKey(key);
+        const Table&        table = mTables[getPartition(hash)];
+
+        if (table.slots.empty())
+        {
+          return emptySlot;
+        }
+
+        for (std::size_t pos = hash & table.mask;; pos = (pos + 1) & table.mask)
+        {
+          const Slot& slot = table.slots[pos];
+
+          if (slot.index == emptySlot || (slot.hash == hash && keys[slot.index] == key))
+          {
+            return slot.index;
+          }
+        }
+      }
+    private:
+      /// @brief Slot of a hash table.
+      struct Slot
+      {
+        std::uint64_t hash{};           ///< Hash of the key
+        std::size_t   index{emptySlot}; ///< Lowest index of the key, emptySlot if the slot is empty
+      };
+
+      /// @brief Hash table of a partition.
+      struct Table
+      {
+        std::vector<Slot> slots{}; ///< The slots, a power of two
+        std::size_t       mask{};  ///< Number of slots minus one
+      };
+
+      /**
+       * @brief Gets the partition of a hash.
+       * @param hash The hash
+       * @return The partition
+       */
+      [[nodiscard]] std::size_t getPartition(std::uint64_t hash) const noexcept
+      {
+        return (mBits == 0) ? 0 : static_cast<std::size_t>(hash >> (64 - mBits));
+      }
+
+      /**
+       * @brief Doubles the slots of a table and reinserts the keys.
+       * @param table The table
+       */
+      static void grow(Table& table)
+      {
+        std::vector<Slot> slots(std::max(table.slots.size() * 2, std::size_t{16}));
+
+        const std::size_t mask = slots.size() - 1;
+
+        for (const Slot& slot : table.slots)
+        {
+          if (slot.index != emptySlot)
+          {
+            std::size_t pos = slot.hash & mask;
+
+            while (slots[pos].index != emptySlot)
+            {
+              pos = (pos + 1) & mask;
+            }
+
+            slots[pos] = slot;
+          }
+        }
+
+        table.slots = std::move(slots);
+        table.mask  = mask;
+      }
+
+      /**
+       * @brief Builds the table of a partition, the table grows so that at most half of the slots are used.
+       * @tparam Keys Keys type
+       * @tparam IndexOf Function type, called as indexOf(j) for the j-th index of the partition in ascending order
+       * @param keys The keys
+       * @param partition The partition
+       * @param count Number of indices of the partition
+       * @param indexOf The function
+       * @param first Receives the lowest index of every key, may be nullptr
+       */
+      template<typename Keys, typename IndexOf>
+      void build(const Keys& keys, std::size_t partition, std::size_t count, IndexOf indexOf, std::size_t* first)
+      {
+        Table& table = mTables[partition];
+
+        std::size_t used{};
+
+        for (std::size_t j{}; j < count; ++j)
+        {
+          const std::size_t   i    = indexOf(j);
+          const std::uint64_t hash = mHashes[i];
+
+          std::size_t lowest = i;
+
+          if (!keys.isMissing(i))
+          {
+            if ((used + 1) * 2 > table.slots.size())
+            {
+              grow(table);
+            }
+
+            std::size_t pos = hash & table.mask;
+
+            while (table.slots[pos].index != emptySlot
+                   && (table.slots[pos].hash != hash || !(keys[table.slots[pos].index] == keys[i])))
+            {
+              pos = (pos + 1) & table.mask;
+            }
+
+            if (table.slots[pos].index == emptySlot)
+            {
+              table.slots[pos] = Slot{hash, i};
+              ++used;
+            }
+
+            lowest = table.slots[pos].index;
+          }
+
+          if (first != nullptr)
+          {
+            first[i] = lowest;
+          }
+        }
+      }
+
+      std::vector<std::uint64_t> mHashes;   ///< Hashes of the keys
+      std::vector<Table>         mTables{}; ///< Tables of the partitions
+      std::size_t                mBits{};   ///< Number of partition bits, 0 for a single table
+  };
+
+  /// @brief Unique keys in the order of their first occurrences.
+  struct UniqueGroups
+  {
+    std::vector<std::size_t> first;  ///< Index of the first occurrence of each unique key
+    std::vector<std::size_t> groups; ///< Zero-based group of each key
+  };
+
+  /**
+   * @brief Groups keys by a hash index, groups are numbered in the order of their first occurrences.
+   * @tparam Keys Keys type
+   * @param keys The keys
+   * @return The groups
+   */
+  template<typename Keys>
+  [[nodiscard]] UniqueGroups groupKeys(const Keys& keys)
+  {
+    const std::size_t n = keys.size();
+
+    UniqueGroups result{{}, std::vector<std::size_t>(n)};
+
+    std::vector<std::size_t> lowest(n);
+
+    {
+      const HashIndex index{keys, lowest.data()};
+    }
+
+    auto isFirst = std::make_unique_for_overwrite<bool[]>(n);
+
+    forRanges(n, parallelMinSize, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        isFirst[i] = (lowest[i] == i);
+      }
+    });
+
+    const MaskPlan plan = planMask(isFirst.get(), n);
+
+    result.first.resize(plan.count);
+
+    forEachTrue(isFirst.get(), n, plan, [&](std::size_t i, std::size_t position) MATLABW_INLINE_LAMBDA
+    {
+      result.first[position] = i;
+      result.groups[i]       = position;
+    });
+
+    forRanges(n, parallelMinSize, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        result.groups[i] = result.groups[lowest[i]];
+      }
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Reorders unique groups by a permutation of the unique keys.
+   * @param groups The groups
+   * @param order The permutation, order[k] is the group placed at position k
+   */
+  inline void reorderGroups(UniqueGroups& groups, const std::vector<std::size_t>& order)
+  {
+    std::vector<std::size_t> rank(order.size());
+    std::vector<std::size_t> first(order.size());
+
+    for (std::size_t k{}; k < order.size(); ++k)
+    {
+      rank[order[k]] = k;
+      first[k]       = groups.first[order[k]];
+    }
+
+    groups.first = std::move(first);
+
+    forRanges(groups.groups.size(), parallelMinSize, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        groups.groups[i] = rank[groups.groups[i]];
+      }
+    });
+  }
+
+  /**
+   * @brief Creates the index outputs of unique.
+   * @tparam Values Values type
+   * @tparam Index Index type
+   * @param groups The groups
+   * @param values The unique values
+   * @return The result
+   */
+  template<typename Index, typename Values>
+  [[nodiscard]] Unique<Values, Index> makeUnique(const UniqueGroups& groups, Values values)
+  {
+    Unique<Values, Index> result{std::move(values),
+                                 makeUninitNumericArray<Index>(groups.first.size(), 1),
+                                 makeUninitNumericArray<Index>(groups.groups.size(), 1)};
+
+    Index* first = result.first.getData();
+
+    for (std::size_t k{}; k < groups.first.size(); ++k)
+    {
+      first[k] = static_cast<Index>(groups.first[k] + 1);
+    }
+
+    Index* group = result.groups.getData();
+
+    forRanges(groups.groups.size(), parallelMinSize, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        group[i] = static_cast<Index>(groups.groups[i] + 1);
+      }
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Groups strings, sorted groups follow the order of the UTF-8 bytes, which is the code point order.
+   * @param strings The strings
+   * @param order The order
+   * @return The groups
+   */
+  [[nodiscard]] inline UniqueGroups groupStrings(const StringList& strings, UniqueOrder order)
+  {
+    UniqueGroups groups = groupKeys(StringKeys{&strings});
+
+    if (order == UniqueOrder::sorted)
+    {
+      std::vector<std::size_t> permutation(groups.first.size());
+
+      std::iota(permutation.begin(), permutation.end(), std::size_t{});
+
+      std::sort(permutation.begin(), permutation.end(), [&](std::size_t a, std::size_t b)
+      {
+        return strings[groups.first[a]] < strings[groups.first[b]];
+      });
+
+      reorderGroups(groups, permutation);
+    }
+
+    return groups;
+  }
+
+  /**
+   * @brief Tests membership of keys in a hash index.
+   * @tparam Index Index type
+   * @tparam Keys Keys type
+   * @param keys The keys tested
+   * @param set The keys of the set
+   * @param found Receives true for the keys found
+   * @param locations Receives the one-based lowest index in the set, 0 if not found
+   */
+  template<typename Index, typename Keys>
+  void findKeys(const Keys& keys, const Keys& set, bool* found, Index* locations)
+  {
+    const HashIndex index{set, nullptr};
+
+    forRanges(keys.size(), Keys::minParallelSize, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        const std::size_t location = keys.isMissing(i) ? emptySlot : index.find(set, keys[i]);
+
+        found[i]     = (location != emptySlot);
+        locations[i] = found[i] ? static_cast<Index>(location + 1) : Index{};
+      }
+    });
+  }
+
+  /**
+   * @brief Converts a subscript of accumarray to a zero-based index.
+   * @tparam T Subscript type
+   * @param id The error identifier
+   * @param sub The one-based subscript
+   * @return The index
+   */
+  template<typename T>
+  [[nodiscard]] std::size_t toGroupIndex(const char* id, T sub)
+  {
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      if (!(sub >= T{1} && sub == std::floor(sub) && sub < static_cast<T>(std::numeric_limits<std::size_t>::max())))
+      {
+        throw Exception{id, "subscripts must be positive integers"};
+      }
+    }
+    else if (sub < T{1})
+    {
+      throw Exception{id, "subscripts must be positive integers"};
+    }
+
+    return static_cast<std::size_t>(sub) - 1;
+  }
+} // namespace detail
+
+  /**
+   * @brief Finds the unique values of an array by hashing, as unique. Zeros of both signs are equal, every NaN value
+   *        is unique. Large arrays are hashed into partitions built in parallel.
+   * @tparam Index Index type, double or std::uint64_t
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...) of a real numeric element type
+   * @param in Input
+   * @param order The order of the unique values
+   * @return The unique values, a row vector for a row vector input, a column vector otherwise, and the index maps
+   */
+  template<typename Index = double, typename In>
+    requires (!std::is_same_v<In, StringList>)
+  [[nodiscard]] Unique<NumericArray<detail::ElementOf<In>>, Index> unique(const In&   in,
+                                                                         UniqueOrder order = UniqueOrder::sorted)
+  {
+    static_assert(detail::isSortIndex<Index>, "index type must be double or std::uint64_t");
+
+    using T = detail::ElementOf<In>;
+
+    const auto span = detail::toSortSpan(in);
+    const T*   src  = span.data();
+
+    detail::UniqueGroups groups = detail::groupKeys(detail::NumericKeys<T>{src, span.size()});
+
+    const std::size_t count = groups.first.size();
+
+    if (order == UniqueOrder::sorted)
+    {
+      std::vector<T> values(count);
+
+      for (std::size_t k{}; k < count; ++k)
+      {
+        values[k] = src[groups.first[k]];
+      }
+
+      detail::reorderGroups(groups, detail::sortPermutation(values.data(), count, SortDirection::ascend));
+    }
+
+    NumericArray<T> values = detail::makeVectorResult<T>(in, count);
+
+    for (std::size_t k{}; k < count; ++k)
+    {
+      values.getData()[k] = src[groups.first[k]];
+    }
+
+    return detail::makeUnique<Index>(groups, std::move(values));
+  }
+
+  /**
+   * @brief Finds the unique strings of a list by hashing, as unique of a cellstr.
+   * @tparam Index Index type, double or std::uint64_t
+   * @param strings The strings
+   * @param order The order of the unique strings, sorted by code points
+   * @return The unique strings and the index maps
+   */
+  template<typename Index = double>
+  [[nodiscard]] Unique<StringList, Index> unique(const StringList& strings, UniqueOrder order = UniqueOrder::sorted)
+  {
+    static_assert(detail::isSortIndex<Index>, "index type must be double or std::uint64_t");
+
+    const detail::UniqueGroups groups = detail::groupStrings(strings, order);
+
+    std::vector<std::size_t> offsets(groups.first.size() + 1);
+
+    for (std::size_t k{}; k < groups.first.size(); ++k)
+    {
+      offsets[k + 1] = offsets[k] + strings[groups.first[k]].size();
+    }
+
+    std::string data(offsets.back(), '\0');
+
+    for (std::size_t k{}; k < groups.first.size(); ++k)
+    {
+      strings[groups.first[k]].copy(data.data() + offsets[k], offsets[k + 1] - offsets[k]);
+    }
+
+    return detail::makeUnique<Index>(groups, StringList{std::move(offsets), std::move(data)});
+  }
+
+  /**
+   * @brief Finds the unique strings of a cellstr by hashing, as unique.
+   * @tparam Index Index type, double or std::uint64_t
+   * @param array The cell array of char vectors
+   * @param order The order of the unique strings, sorted by code points
+   * @return The unique strings, a row cell for a row vector input, a column cell otherwise, and the index maps
+   */
+  template<typename Index = double>
+  [[nodiscard]] Unique<CellArray, Index> uniqueCellStr(ArrayCref array, UniqueOrder order = UniqueOrder::sorted)
+  {
+    static_assert(detail::isSortIndex<Index>, "index type must be double or std::uint64_t");
+
+    const StringList           strings = toStringList(array);
+    const detail::UniqueGroups groups  = detail::groupStrings(strings, order);
+
+    CellArray values = detail::makeCellStr(groups.first.size(), [&](std::size_t k)
+    {
+      return strings[groups.first[k]];
+    });
+
+    if (const auto dims = array.getDims(); dims.size() == 2 && dims[0] == 1)
+    {
+      values.resize(1, groups.first.size());
+    }
+
+    return detail::makeUnique<Index>(groups, std::move(values));
+  }
+
+  /**
+   * @brief Tests which elements of an array are elements of a set by hashing, as ismember. Zeros of both signs are
+   *        equal, NaN values are never members. Large sets are hashed into partitions built in parallel and large
+   *        arrays are tested in parallel.
+   * @tparam Index Index type, double or std::uint64_t
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...) of a real numeric element type
+   * @tparam Set Set array type of the same element type
+   * @param in Input
+   * @param set The set
+   * @return The membership of the input's dimensions if it has any, a column vector otherwise
+   */
+  template<typename Index = double, typename In, typename Set>
+    requires (!std::is_same_v<In, StringList>)
+  [[nodiscard]] Membership<Index> ismember(const In& in, const Set& set)
+  {
+    static_assert(detail::isSortIndex<Index>, "index type must be double or std::uint64_t");
+    static_assert(std::is_same_v<detail::ElementOf<In>, detail::ElementOf<Set>>, "element types must match");
+
+    using T = detail::ElementOf<In>;
+
+    const auto span    = detail::toSortSpan(in);
+    const auto setSpan = detail::toSortSpan(set);
+
+    auto makeResult = [&]
+    {
+      if constexpr (requires { in.getDims(); })
+      {
+        return Membership<Index>{makeLogicalArray(in.getDims()), makeUninitNumericArray<Index>(in.getDims())};
+      }
+      else
+      {
+        return Membership<Index>{makeLogicalArray(span.size(), 1), makeUninitNumericArray<Index>(span.size(), 1)};
+      }
+    };
+
+    Membership<Index> result = makeResult();
+
+    detail::findKeys(detail::NumericKeys<T>{span.data(), span.size()},
+                     detail::NumericKeys<T>{setSpan.data(), setSpan.size()},
+                     result.found.getData(),
+                     result.locations.getData());
+
+    return result;
+  }
+
+  /**
+   * @brief Tests which strings of a list are in a set by hashing, as ismember of cellstrs.
+   * @tparam Index Index type, double or std::uint64_t
+   * @param strings The strings
+   * @param set The set
+   * @return The membership as column vectors
+   */
+  template<typename Index = double>
+  [[nodiscard]] Membership<Index> ismember(const StringList& strings, const StringList& set)
+  {
+    static_assert(detail::isSortIndex<Index>, "index type must be double or std::uint64_t");
+
+    Membership<Index> result{makeLogicalArray(strings.size(), 1), makeUninitNumericArray<Index>(strings.size(), 1)};
+
+    detail::findKeys(detail::StringKeys{&strings}, detail::StringKeys{&set},
+                     result.found.getData(), result.locations.getData());
+
+    return result;
+  }
+
+  /**
+   * @brief Tests which strings of a cellstr are in a cellstr set by hashing, as ismember.
+   * @tparam Index Index type, double or std::uint64_t
+   * @param array The cell array of char vectors
+   * @param set The cell array of char vectors of the set
+   * @return The membership of the input's dimensions
+   */
+  template<typename Index = double>
+  [[nodiscard]] Membership<Index> ismemberCellStr(ArrayCref array, ArrayCref set)
+  {
+    Membership<Index> result = ismember<Index>(toStringList(array), toStringList(set));
+
+    result.found.resize(array.getDims());
+    result.locations.resize(array.getDims());
+
+    return result;
+  }
+
+  /**
+   * @brief Sums values by subscript, as accumarray(subs, values, [size 1]). Large inputs are partitioned by ranges of
+   *        subscripts summed in parallel, each output element is summed in the order of the input on one thread so
+   *        the result does not depend on the thread count.
+   * @tparam Subs Subscript array type (TypedArrayCref, TypedArray, span, ...) of a real numeric element type
+   * @tparam In Value array type (TypedArrayCref, TypedArray, span, ...) of a numeric element type
+   * @param subs The one-based subscripts, e.g. the groups of unique
+   * @param values The values, one per subscript or a scalar
+   * @param size The size of the output, 0 for the largest subscript
+   * @return The sums as a column vector, zero for subscripts not present. Integer sums saturate at every step as in
+   *         MATLAB.
+   */
+  template<typename Subs, typename In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> accumarray(const Subs& subs, const In& values, std::size_t size = 0)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:accumarray"};
+
+    using T = detail::ElementOf<In>;
+
+    const auto sub = detail::toSortSpan(subs);
+    const auto src = detail::toSpan(values);
+
+    const std::size_t n = sub.size();
+
+    if (src.size() != n && src.size() != 1)
+    {
+      throw Exception{id, "number of values must match the number of subscripts"};
+    }
+
+    std::vector<std::size_t> index(n);
+
+    detail::forRanges(n, detail::parallelMinSize, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t i{begin}; i < end; ++i)
+      {
+        index[i] = detail::toGroupIndex(id, sub[i]);
+      }
+    });
+
+    const std::size_t maxIndex = n ? *std::max_element(index.begin(), index.end()) : 0;
+
+    if (size == 0)
+    {
+      size = n ? maxIndex + 1 : 0;
+    }
+    else if (n != 0 && maxIndex >= size)
+    {
+      throw Exception{id, "subscripts exceed the output size"};
+    }
+
+    NumericArray<T> out = mx::makeNumericArray<T>(size, 1);
+
+    T* dst = out.getData();
+
+    const bool scalar = (src.size() == 1);
+
+    auto accumulate = [&](std::size_t i)
+    {
+      // Integer sums saturate at every step as in MATLAB, detail::add is a plain sum for other types.
+      dst[index[i]] = detail::add(dst[index[i]], src[scalar ? 0 : i]);
+    };
+
+    if (!detail::usePartitions(n, detail::parallelMinSize))
+    {
+      for (std::size_t i{}; i < n; ++i)
+      {
+        accumulate(i);
+      }
+
+      return out;
+    }
+
+    const std::size_t bucketCount = std::size_t{1} << detail::hashPartitionBits;
+    const std::size_t bucketSize  = (size + bucketCount - 1) / bucketCount;
+
+    const detail::Partitions partitions = detail::partitionIndices(n, bucketCount, [&](std::size_t i)
+    {
+      return index[i] / bucketSize;
+    });
+
+    parallel::parallelFor(0, bucketCount, 1, [&](std::size_t bucket)
+    {
+      for (std::size_t k{partitions.offsets[bucket]}; k < partitions.offsets[bucket + 1]; ++k)
+      {
+        accumulate(partitions.indices[k]);
+      }
+    });
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_GROUP_HPP */
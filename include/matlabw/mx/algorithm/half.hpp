@@ -0,0 +1,266 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_HALF_HPP
+#define MATLABW_MX_ALGORITHM_HALF_HPP
+
+#include "../detail/include.hpp"
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../half.hpp"
+#include "../NumericArray.hpp"
+
+#ifdef MATLABW_SIMD_X86_DISPATCH
+# include <immintrin.h>
+#endif
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /**
+   * @brief Conversion of a half precision value to single.
+   * @tparam H Half precision type
+   */
+  template<typename H>
+  struct HalfToSingleOp
+  {
+    /// @brief Converts the value.
+    MATLABW_ALWAYS_INLINE float operator()(H x) const noexcept { return static_cast<float>(x); }
+  };
+
+  /**
+   * @brief Conversion of a single to half precision, rounding to nearest even.
+   * @tparam H Half precision type
+   */
+  template<typename H>
+  struct SingleToHalfOp
+  {
+    /// @brief Converts the value.
+    MATLABW_ALWAYS_INLINE H operator()(float x) const noexcept { return H{x}; }
+  };
+
+  /**
+   * @brief Runs a chunked loop, large inputs are split between the threads of the library-managed thread pool.
+   * @tparam Fn Loop body type, called as fn(first, last)
+   * @param n Number of elements
+   * @param fn The loop body
+   */
+  template<typename Fn>
+  void forHalfChunks(std::size_t n, Fn&& fn)
+  {
+    if (n < parallelMinSize)
+    {
+      fn(std::size_t{}, n);
+    }
+    else
+    {
+      parallelChunks(n, fn);
+    }
+  }
+
+#ifdef MATLABW_SIMD_X86_DISPATCH
+  /**
+   * @brief Can the F16C conversions be used? Requires the CPU feature and a SIMD level above generic, so that
+   *        MATLABW_SIMD_LEVEL=generic also disables them.
+   * @return True if F16C is used.
+   */
+  [[nodiscard]] inline bool useF16c() noexcept
+  {
+    return getSimdLevel() != SimdLevel::generic && getCpuFeatures().f16c;
+  }
+
+  /**
+   * @brief Converts float16 to single with F16C, eight elements per instruction.
+   * @param out Output pointer
+   * @param in Input pointer
+   * @param n Number of elements
+   */
+  [[gnu::target("avx,f16c")]] inline void float16ToSingleF16c(float* out, const float16* in, std::size_t n) noexcept
+  {
+    std::size_t i{};
+
+    for (; i + 8 <= n; i += 8)
+    {
+      _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+    }
+
+    for (; i < n; ++i)
+    {
+      out[i] = static_cast<float>(in[i]);
+    }
+  }
+
+  /**
+   * @brief Converts single to float16 with F16C rounding to nearest even, eight elements per instruction.
+   * @param out Output pointer
+   * @param in Input pointer
+   * @param n Number of elements
+   */
+  [[gnu::target("avx,f16c")]] inline void singleToFloat16F16c(float16* out, const float* in, std::size_t n) noexcept
+  {
+    std::size_t i{};
+
+    for (; i + 8 <= n; i += 8)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                       _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    for (; i < n; ++i)
+    {
+      out[i] = float16{in[i]};
+    }
+  }
+#endif
+
+  /**
+   * @brief Converts half precision values to single.
+   * @tparam H Half precision type
+   * @param out Output pointer
+   * @param in Input pointer
+   * @param n Number of elements
+   */
+  template<typename H>
+  void halfToSingle(float* out, const H* in, std::size_t n)
+  {
+#ifdef MATLABW_SIMD_X86_DISPATCH
+    if constexpr (std::is_same_v<H, float16>)
+    {
+      if (useF16c())
+      {
+        forHalfChunks(n, [&](std::size_t first, std::size_t last)
+        {
+          float16ToSingleF16c(out + first, in + first, last - first);
+        });
+        return;
+      }
+    }
+#endif
+
+    transform(HalfToSingleOp<H>{}, n, out, in);
+  }
+
+  /**
+   * @brief Converts singles to half precision, rounding to nearest even.
+   * @tparam H Half precision type
+   * @param out Output pointer
+   * @param in Input pointer
+   * @param n Number of elements
+   */
+  template<typename H>
+  void singleToHalf(H* out, const float* in, std::size_t n)
+  {
+#ifdef MATLABW_SIMD_X86_DISPATCH
+    if constexpr (std::is_same_v<H, float16>)
+    {
+      if (useF16c())
+      {
+        forHalfChunks(n, [&](std::size_t first, std::size_t last)
+        {
+          singleToFloat16F16c(out + first, in + first, last - first);
+        });
+        return;
+      }
+    }
+#endif
+
+    transform(SingleToHalfOp<H>{}, n, out, in);
+  }
+} // namespace detail
+
+  /**
+   * @brief Converts half precision elements to single, exactly. float16 uses the F16C instructions when the CPU has
+   *        them, bfloat16 is a vectorized shift. Large inputs are split between the threads of the thread pool.
+   * @tparam H Half precision type, float16 or bfloat16
+   * @param out Output, of as many elements as the input
+   * @param in Input
+   */
+  template<typename H>
+  void halfToSingle(std::span<float> out, std::span<const H> in)
+  {
+    static_assert(isHalf<H>, "H must be float16 or bfloat16");
+
+    detail::checkSizes("matlabw:mx:algorithm:halfToSingle", out.size(), in.size());
+    detail::halfToSingle(out.data(), in.data(), in.size());
+  }
+
+  /**
+   * @brief Converts singles to half precision elements, rounding to nearest even. Values above the range of float16
+   *        become infinity. Uses F16C for float16 when the CPU has it, NaN payloads may then differ from the portable
+   *        conversion.
+   * @tparam H Half precision type, float16 or bfloat16
+   * @param out Output, of as many elements as the input
+   * @param in Input
+   */
+  template<typename H>
+  void singleToHalf(std::span<H> out, std::span<const float> in)
+  {
+    static_assert(isHalf<H>, "H must be float16 or bfloat16");
+
+    detail::checkSizes("matlabw:mx:algorithm:singleToHalf", out.size(), in.size());
+    detail::singleToHalf(out.data(), in.data(), in.size());
+  }
+
+  /**
+   * @brief Converts a half precision array to a new single array of the same dimensions, see halfToSingle().
+   * @tparam H Half precision type, float16 or bfloat16
+   * @param in Input, a uint16 array holding the bits
+   * @return The single array
+   */
+  template<typename H>
+  [[nodiscard]] NumericArray<float> toSingle(const TypedArrayCref<H>& in)
+  {
+    static_assert(isHalf<H>, "H must be float16 or bfloat16");
+
+    NumericArray<float> out = makeUninitNumericArray<float>(in.getDims());
+
+    detail::halfToSingle(out.getData(), in.getData(), in.getSize());
+
+    return out;
+  }
+
+  /**
+   * @brief Converts a single array to a new half precision array of the same dimensions, see singleToHalf().
+   * @tparam H Half precision type, float16 or bfloat16
+   * @param in Input
+   * @return The half precision array, a uint16 array holding the bits
+   */
+  template<typename H>
+  [[nodiscard]] NumericArray<H> toHalf(const TypedArrayCref<float>& in)
+  {
+    static_assert(isHalf<H>, "H must be float16 or bfloat16");
+
+    NumericArray<H> out = makeUninitNumericArray<H>(in.getDims());
+
+    detail::singleToHalf(out.getData(), in.getData(), in.getSize());
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_HALF_HPP */
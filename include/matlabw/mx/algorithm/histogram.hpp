@@ -0,0 +1,780 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ALGORITHM_HISTOGRAM_HPP
+#define MATLABW_MX_ALGORITHM_HISTOGRAM_HPP
+
+#include "../detail/include.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../NumericArray.hpp"
+#include "../parallel/Accumulator.hpp"
+#include "../random.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /// @brief Bins of equal width between two edges, the last bin includes the upper edge as in histcounts.
+  struct UniformBins
+  {
+    double      lower{}; ///< Lower edge of the first bin
+    double      upper{}; ///< Upper edge of the last bin
+    double      scale{}; ///< Number of bins per unit
+    std::size_t count{}; ///< Number of bins
+
+    /**
+     * @brief Gets the bin of a value, branchless so that the compiler vectorizes it.
+     * @param x The value
+     * @return Zero-based bin, count if the value is NaN or outside of the edges
+     */
+    [[nodiscard]] MATLABW_ALWAYS_INLINE std::size_t getBin(double x) const noexcept
+    {
+      const bool   inside = (x >= lower) & (x <= upper);
+      const double t      = inside ? (x - lower) * scale : 0.0;
+
+      return inside ? std::min(static_cast<std::size_t>(t), count - 1) : count;
+    }
+  };
+
+  /// @brief Bins between sorted edges, the last bin includes the last edge as in histcounts.
+  struct EdgeBins
+  {
+    const double* edges{}; ///< The edges, strictly increasing
+    std::size_t   count{}; ///< Number of bins, one less than the number of edges
+
+    /**
+     * @brief Gets the bin of a value by a branchless binary search of a fixed number of steps.
+     * @param x The value
+     * @return Zero-based bin, count if the value is NaN or outside of the edges
+     */
+    [[nodiscard]] MATLABW_ALWAYS_INLINE std::size_t getBin(double x) const noexcept
+    {
+      const double* base = edges;
+      std::size_t   size = count + 1;
+
+      while (size > 1)
+      {
+        const std::size_t half = size / 2;
+
+        base  = (base[half] <= x) ? base + half : base;
+        size -= half;
+      }
+
+      const bool inside = (x >= edges[0]) & (x <= edges[count]);
+
+      return inside ? std::min(static_cast<std::size_t>(base - edges), count - 1) : count;
+    }
+  };
+
+  /**
+   * @brief Creates uniform bins and checks them.
+   * @param id Error identifier
+   * @param lower Lower edge of the first bin
+   * @param upper Upper edge of the last bin
+   * @param count Number of bins
+   * @return The bins
+   */
+  [[nodiscard]] inline UniformBins makeUniformBins(const char* id, double lower, double upper, std::size_t count)
+  {
+    if (count == 0 || !(lower < upper) || !std::isfinite(lower) || !std::isfinite(upper))
+    {
+      throw Exception{id, "bins must be a positive count between finite increasing edges"};
+    }
+
+    return UniformBins{lower, upper, static_cast<double>(count) / (upper - lower), count};
+  }
+
+  /**
+   * @brief Creates bins between edges and checks them.
+   * @param id Error identifier
+   * @param edges The edges
+   * @return The bins
+   */
+  template<typename Edges>
+  [[nodiscard]] EdgeBins makeEdgeBins(const char* id, const Edges& edges)
+  {
+    auto span = toSpan(edges);
+
+    static_assert(std::is_same_v<ElementType<decltype(span)>, double>, "edges element type must be double");
+
+    if (span.size() < 2)
+    {
+      throw Exception{id, "there must be at least two edges"};
+    }
+
+    for (std::size_t i{1}; i < span.size(); ++i)
+    {
+      if (!(span[i - 1] < span[i]))
+      {
+        throw Exception{id, "edges must be strictly increasing"};
+      }
+    }
+
+    return EdgeBins{span.data(), span.size() - 1};
+  }
+
+  /**
+   * @brief Writes the one-based bin of each element as discretize does.
+   * @tparam Bins Bins type
+   * @param id Error identifier
+   * @param bins The bins
+   * @param out Output, NaN outside of the edges for floating point outputs, 0 for integer outputs
+   * @param in Input
+   */
+  template<typename Bins, typename Out, typename In>
+  void discretize(const char* id, const Bins& bins, Out&& out, const In& in)
+  {
+    auto dst = toSpan(out);
+    auto src = toSpan(in);
+
+    using T = ElementType<decltype(src)>;
+    using U = ElementType<decltype(dst)>;
+
+    static_assert(RealNumeric<T>, "input must be real numeric");
+    static_assert(RealNumeric<U>, "output must be real numeric");
+
+    constexpr U none = std::numeric_limits<U>::has_quiet_NaN ? std::numeric_limits<U>::quiet_NaN() : U{};
+
+    checkSizes(id, dst.size(), src.size());
+    transform([bins](T x) MATLABW_INLINE_LAMBDA
+    {
+      const std::size_t bin = bins.getBin(static_cast<double>(x));
+
+      return (bin < bins.count) ? static_cast<U>(bin + 1) : none;
+    }, dst.size(), dst.data(), src.data());
+  }
+
+  /**
+   * @brief Counts the elements of a range per bin, the last counter collects the elements outside of the bins.
+   * @tparam Bins Bins type
+   * @tparam T Element type
+   * @param bins The bins
+   * @param in Input pointer
+   * @param n Number of elements
+   * @param counts Output, count + 1 counters
+   */
+  template<typename Bins, typename T>
+  void countBins(const Bins& bins, const T* in, std::size_t n, std::uint64_t* counts) noexcept
+  {
+    for (std::size_t i{}; i < n; ++i)
+    {
+      ++counts[bins.getBin(static_cast<double>(in[i]))];
+    }
+  }
+
+  /**
+   * @brief Counts the elements per bin as histcounts does. Large inputs are counted in parallel, each chunk into
+   *        local counters which a privatized ConcurrentAccumulator merges.
+   * @tparam Bins Bins type
+   * @param id Error identifier
+   * @param bins The bins
+   * @param out Output, one element per bin, overwritten
+   * @param in Input
+   */
+  template<typename Bins, typename Out, typename In>
+  void histcounts(const char* id, const Bins& bins, Out&& out, const In& in)
+  {
+    auto dst = toSpan(out);
+    auto src = toSpan(in);
+
+    using T = ElementType<decltype(src)>;
+    using U = ElementType<decltype(dst)>;
+
+    static_assert(RealNumeric<T>, "input must be real numeric");
+    static_assert(RealNumeric<U>, "output must be real numeric");
+
+    checkSizes(id, dst.size(), bins.count);
+
+    std::fill(dst.begin(), dst.end(), U{});
+
+    if (src.size() < parallelMinSize)
+    {
+      std::vector<std::uint64_t> counts(bins.count + 1);
+
+      countBins(bins, src.data(), src.size(), counts.data());
+      std::transform(counts.begin(), counts.end() - 1, dst.begin(), [](std::uint64_t c) { return static_cast<U>(c); });
+
+      return;
+    }
+
+    auto accumulator = parallel::makeConcurrentAccumulator(dst, {.mode = parallel::AccumulatorMode::privatized});
+
+    parallelChunks(src.size(), [&](std::size_t first, std::size_t last)
+    {
+      std::vector<std::uint64_t> counts(bins.count + 1);
+
+      countBins(bins, src.data() + first, last - first, counts.data());
+
+      for (std::size_t b{}; b < bins.count; ++b)
+      {
+        if (counts[b] != 0)
+        {
+          accumulator.add(b, static_cast<U>(counts[b]));
+        }
+      }
+    });
+
+    accumulator.merge();
+  }
+} // namespace detail
+
+  /**
+   * @brief Writes the one-based bin of each element in bins of equal width as discretize does, the last bin includes
+   *        the upper edge.
+   * @param out Output, NaN for NaN and elements outside of the edges, 0 for integer outputs
+   * @param in Input
+   * @param lower Lower edge of the first bin
+   * @param upper Upper edge of the last bin
+   * @param binCount Number of bins
+   */
+  template<typename Out, typename In>
+  void discretize(Out&& out, const In& in, double lower, double upper, std::size_t binCount)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:discretize"};
+
+    detail::discretize(id, detail::makeUniformBins(id, lower, upper, binCount), out, in);
+  }
+
+  /**
+   * @brief Gets the one-based bin of each element in bins of equal width as discretize does.
+   * @param in Input array
+   * @param lower Lower edge of the first bin
+   * @param upper Upper edge of the last bin
+   * @param binCount Number of bins
+   * @return Double array of the bins, the same size as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] NumericArray<double> discretize(const In& in, double lower, double upper, std::size_t binCount)
+  {
+    NumericArray<double> out = makeUninitNumericArray<double>(in.getDims());
+
+    discretize(out, in, lower, upper, binCount);
+
+    return out;
+  }
+
+  /**
+   * @brief Writes the one-based bin of each element between edges as discretize does, bin k holds the elements in
+   *        [edges[k - 1], edges[k]) and the last bin includes the last edge.
+   * @param out Output, NaN for NaN and elements outside of the edges, 0 for integer outputs
+   * @param in Input
+   * @param edges Strictly increasing double edges
+   */
+  template<typename Out, typename In, typename Edges>
+  void discretize(Out&& out, const In& in, const Edges& edges)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:discretize"};
+
+    detail::discretize(id, detail::makeEdgeBins(id, edges), out, in);
+  }
+
+  /**
+   * @brief Gets the one-based bin of each element between edges as discretize does.
+   * @param in Input array
+   * @param edges Strictly increasing double edges
+   * @return Double array of the bins, the same size as the input
+   */
+  template<detail::DimensionedArray In, typename Edges>
+  [[nodiscard]] NumericArray<double> discretize(const In& in, const Edges& edges)
+  {
+    NumericArray<double> out = makeUninitNumericArray<double>(in.getDims());
+
+    discretize(out, in, edges);
+
+    return out;
+  }
+
+  /**
+   * @brief Counts the elements in bins of equal width as histcounts does, NaN and elements outside of the edges are
+   *        not counted. Large inputs are counted in parallel.
+   * @param out Output, one element per bin, overwritten
+   * @param in Input
+   * @param lower Lower edge of the first bin
+   * @param upper Upper edge of the last bin, included in the last bin
+   */
+  template<typename Out, typename In>
+    requires (!std::is_arithmetic_v<In>)
+  void histcounts(Out&& out, const In& in, double lower, double upper)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:histcounts"};
+
+    detail::histcounts(id, detail::makeUniformBins(id, lower, upper, detail::toSpan(out).size()), out, in);
+  }
+
+  /**
+   * @brief Counts the elements in bins of equal width as histcounts does.
+   * @param in Input array
+   * @param lower Lower edge of the first bin
+   * @param upper Upper edge of the last bin
+   * @param binCount Number of bins
+   * @return 1 x binCount double row vector of the counts
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] NumericArray<double> histcounts(const In& in, double lower, double upper, std::size_t binCount)
+  {
+    NumericArray<double> out = makeUninitNumericArray<double>({{1, binCount}});
+
+    histcounts(out, in, lower, upper);
+
+    return out;
+  }
+
+  /**
+   * @brief Counts the elements between edges as histcounts does, NaN and elements outside of the edges are not
+   *        counted. Large inputs are counted in parallel.
+   * @param out Output, one element per bin, overwritten
+   * @param in Input
+   * @param edges Strictly increasing double edges, one more than the bins
+   */
+  template<typename Out, typename In, typename Edges>
+  void histcounts(Out&& out, const In& in, const Edges& edges)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:histcounts"};
+
+    detail::histcounts(id, detail::makeEdgeBins(id, edges), out, in);
+  }
+
+  /**
+   * @brief Counts the elements between edges as histcounts does.
+   * @param in Input array
+   * @param edges Strictly increasing double edges
+   * @return 1 x (edges - 1) double row vector of the counts
+   */
+  template<detail::DimensionedArray In, typename Edges>
+  [[nodiscard]] NumericArray<double> histcounts(const In& in, const Edges& edges)
+  {
+    const std::size_t    binCount = std::max<std::size_t>(detail::toSpan(edges).size(), 1) - 1;
+    NumericArray<double> out      = makeUninitNumericArray<double>({{1, binCount}});
+
+    histcounts(out, in, edges);
+
+    return out;
+  }
+
+  /**
+   * @brief Approximate quantiles of a stream of values in bounded memory, a KLL sketch. Values are kept in compactors
+   *        of increasing weight, a full compactor is sorted and every other value, starting at a random parity, is
+   *        promoted with double the weight. The rank error is about 1.7 / accuracy of the count with high
+   *        probability, regardless of the order of the values, and the memory is about 3 accuracy values. Sketches
+   *        of several threads or calls can be merged. Kept across calls by a mex::State, e.g.
+   *
+   *          auto& sketch = mex::getQuantileSketch();
+   *          sketch.append(frame);
+   *          lhs[0] = sketch.getQuantiles(probabilities);
+   */
+  class QuantileSketch
+  {
+    public:
+      /// @brief Default accuracy, a rank error of about one percent.
+      static constexpr std::size_t defaultAccuracy{200};
+
+      /**
+       * @brief Constructor.
+       * @param accuracy Capacity of the largest compactor, at least 8
+       * @param seed Seed of the random parities
+       */
+      explicit QuantileSketch(std::size_t accuracy = defaultAccuracy, std::uint64_t seed = 0)
+      : mAccuracy{accuracy}, mRng{seed}
+      {
+        if (accuracy < 8)
+        {
+          throw Exception{"matlabw:mx:algorithm:QuantileSketch", "accuracy must be at least 8"};
+        }
+
+        grow();
+      }
+
+      /**
+       * @brief Adds a value, NaN is ignored as in quantile.
+       * @param x The value
+       */
+      void add(double x)
+      {
+        if (std::isnan(x))
+        {
+          return;
+        }
+
+        mMin = std::min(mMin, x);
+        mMax = std::max(mMax, x);
+        ++mCount;
+
+        mLevels.front().push_back(x);
+
+        if (++mSize >= mMaxSize)
+        {
+          compress();
+        }
+      }
+
+      /**
+       * @brief Adds the elements of an array, NaN is ignored.
+       * @param in Real numeric input
+       */
+      template<typename In>
+      void append(const In& in)
+      {
+        auto src = detail::toSpan(in);
+
+        static_assert(detail::RealNumeric<detail::ElementType<decltype(src)>>, "input must be real numeric");
+
+        for (const auto x : src)
+        {
+          add(static_cast<double>(x));
+        }
+      }
+
+      /**
+       * @brief Adds the values of another sketch of the same accuracy.
+       * @param other The other sketch
+       */
+      void merge(const QuantileSketch& other)
+      {
+        if (other.mAccuracy != mAccuracy)
+        {
+          throw Exception{"matlabw:mx:algorithm:QuantileSketch:merge", "sketches must have the same accuracy"};
+        }
+
+        while (mLevels.size() < other.mLevels.size())
+        {
+          grow();
+        }
+
+        for (std::size_t h{}; h < other.mLevels.size(); ++h)
+        {
+          mLevels[h].insert(mLevels[h].end(), other.mLevels[h].begin(), other.mLevels[h].end());
+        }
+
+        mSize  += other.mSize;
+        mCount += other.mCount;
+        mMin    = std::min(mMin, other.mMin);
+        mMax    = std::max(mMax, other.mMax);
+
+        while (mSize >= mMaxSize)
+        {
+          compress();
+        }
+      }
+
+      /// @brief Removes all values.
+      void clear()
+      {
+        mLevels.clear();
+        mSize    = 0;
+        mMaxSize = 0;
+        mCount   = 0;
+        mMin     = std::numeric_limits<double>::infinity();
+        mMax     = -std::numeric_limits<double>::infinity();
+
+        grow();
+      }
+
+      /**
+       * @brief Gets the number of values added.
+       * @return The count
+       */
+      [[nodiscard]] std::uint64_t getCount() const noexcept
+      {
+        return mCount;
+      }
+
+      /**
+       * @brief Gets the number of values kept.
+       * @return The number of values in the compactors
+       */
+      [[nodiscard]] std::size_t getRetainedCount() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Gets the exact minimum.
+       * @return The minimum, NaN if empty
+       */
+      [[nodiscard]] double getMin() const noexcept
+      {
+        return (mCount > 0) ? mMin : std::numeric_limits<double>::quiet_NaN();
+      }
+
+      /**
+       * @brief Gets the exact maximum.
+       * @return The maximum, NaN if empty
+       */
+      [[nodiscard]] double getMax() const noexcept
+      {
+        return (mCount > 0) ? mMax : std::numeric_limits<double>::quiet_NaN();
+      }
+
+      /**
+       * @brief Gets an approximate quantile, the smallest kept value whose rank reaches the probability. Exact while
+       *        no values were compacted, 0 and 1 give the exact minimum and maximum.
+       * @param p The probability in [0, 1]
+       * @return The quantile, NaN if empty
+       */
+      [[nodiscard]] double getQuantile(double p) const
+      {
+        double q{};
+
+        getQuantiles(Span<double>{&q, 1}, View<double>{&p, 1});
+
+        return q;
+      }
+
+      /**
+       * @brief Gets approximate quantiles, see getQuantile().
+       * @param out Output, one element per probability
+       * @param probabilities The probabilities in [0, 1]
+       */
+      template<typename Out, typename Probabilities>
+      void getQuantiles(Out&& out, const Probabilities& probabilities) const
+      {
+        static constexpr char id[]{"matlabw:mx:algorithm:QuantileSketch:getQuantiles"};
+
+        auto dst = detail::toSpan(out);
+        auto src = detail::toSpan(probabilities);
+
+        static_assert(std::is_same_v<detail::ElementType<decltype(dst)>, double>, "output element type must be double");
+        static_assert(std::is_same_v<detail::ElementType<decltype(src)>, double>, "probabilities must be double");
+
+        detail::checkSizes(id, dst.size(), src.size());
+
+        const std::vector<std::pair<double, std::uint64_t>> ranks = getRanks();
+
+        for (std::size_t i{}; i < src.size(); ++i)
+        {
+          const double p = src[i];
+
+          if (!(p >= 0.0 && p <= 1.0))
+          {
+            throw Exception{id, "probabilities must be in [0, 1]"};
+          }
+
+          if (mCount == 0)
+          {
+            dst[i] = std::numeric_limits<double>::quiet_NaN();
+          }
+          else if (p == 0.0 || p == 1.0)
+          {
+            dst[i] = (p == 0.0) ? mMin : mMax;
+          }
+          else
+          {
+            const double target = p * static_cast<double>(ranks.back().second);
+            const auto   it     = std::lower_bound(ranks.begin(), ranks.end(), target, [](const auto& r, double t)
+            {
+              return static_cast<double>(r.second) < t;
+            });
+
+            dst[i] = (it == ranks.end()) ? mMax : it->first;
+          }
+        }
+      }
+
+      /**
+       * @brief Gets approximate quantiles, see getQuantile().
+       * @param probabilities Array of the probabilities
+       * @return Double array of the quantiles, the same size as the probabilities
+       */
+      template<detail::DimensionedArray Probabilities>
+      [[nodiscard]] NumericArray<double> getQuantiles(const Probabilities& probabilities) const
+      {
+        NumericArray<double> out = makeUninitNumericArray<double>(probabilities.getDims());
+
+        getQuantiles(out, probabilities);
+
+        return out;
+      }
+
+      /**
+       * @brief Gets the approximate fraction of the values less than or equal to a value, the empirical CDF.
+       * @param x The value
+       * @return The fraction, NaN if empty
+       */
+      [[nodiscard]] double getRank(double x) const noexcept
+      {
+        if (mCount == 0)
+        {
+          return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        std::uint64_t rank{};
+        std::uint64_t total{};
+
+        for (std::size_t h{}; h < mLevels.size(); ++h)
+        {
+          for (const double v : mLevels[h])
+          {
+            rank += (v <= x) ? std::uint64_t{1} << h : 0;
+          }
+
+          total += mLevels[h].size() << h;
+        }
+
+        return static_cast<double>(rank) / static_cast<double>(total);
+      }
+    private:
+      /**
+       * @brief Gets the capacity of a compactor, the accuracy for the top one and decreasing by 2/3 per level below.
+       * @param h The level
+       * @return The capacity
+       */
+      [[nodiscard]] std::size_t getCapacity(std::size_t h) const noexcept
+      {
+        const double depth = static_cast<double>(mLevels.size() - 1 - h);
+
+        return std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(static_cast<double>(mAccuracy)
+                                                                            * std::pow(2.0 / 3.0, depth))));
+      }
+
+      /// @brief Adds a compactor on top, the capacities of the others shrink.
+      void grow()
+      {
+        mLevels.emplace_back();
+        mMaxSize = 0;
+
+        for (std::size_t h{}; h < mLevels.size(); ++h)
+        {
+          mMaxSize += getCapacity(h);
+        }
+      }
+
+      /// @brief Compacts the lowest full compactor.
+      void compress()
+      {
+        for (std::size_t h{}; h < mLevels.size(); ++h)
+        {
+          if (mLevels[h].size() < getCapacity(h))
+          {
+            continue;
+          }
+
+          if (h + 1 == mLevels.size())
+          {
+            grow();
+          }
+
+          std::vector<double>& level = mLevels[h];
+          std::vector<double>& above = mLevels[h + 1];
+
+          std::sort(level.begin(), level.end());
+
+          // An odd value count keeps the largest value in the level.
+          const std::size_t pairCount = level.size() / 2;
+          const std::size_t parity    = nextBit();
+
+          for (std::size_t i{}; i < pairCount; ++i)
+          {
+            above.push_back(level[2 * i + parity]);
+          }
+
+          if (level.size() % 2 != 0)
+          {
+            level.front() = level.back();
+            level.resize(1);
+          }
+          else
+          {
+            level.clear();
+          }
+
+          mSize -= pairCount;
+
+          return;
+        }
+      }
+
+      /**
+       * @brief Gets a random bit.
+       * @return 0 or 1
+       */
+      [[nodiscard]] std::size_t nextBit() noexcept
+      {
+        if (mBitCount == 0)
+        {
+          mBits     = mRng();
+          mBitCount = 32;
+        }
+
+        const std::size_t bit = mBits & 1;
+
+        mBits >>= 1;
+        --mBitCount;
+
+        return bit;
+      }
+
+      /**
+       * @brief Gets the kept values sorted with their cumulative weights.
+       * @return The values with the total weight of the values up to them
+       */
+      [[nodiscard]] std::vector<std::pair<double, std::uint64_t>> getRanks() const
+      {
+        std::vector<std::pair<double, std::uint64_t>> ranks{};
+
+        ranks.reserve(mSize);
+
+        for (std::size_t h{}; h < mLevels.size(); ++h)
+        {
+          for (const double v : mLevels[h])
+          {
+            ranks.emplace_back(v, std::uint64_t{1} << h);
+          }
+        }
+
+        std::sort(ranks.begin(), ranks.end());
+
+        std::uint64_t total{};
+
+        for (auto& [value, weight] : ranks)
+        {
+          total  += weight;
+          weight  = total;
+        }
+
+        return ranks;
+      }
+
+      std::size_t                      mAccuracy{};                                    ///< Capacity of the top level
+      Philox                           mRng;                                           ///< Random parities
+      std::vector<std::vector<double>> mLevels{};                                      ///< Compactors, weight 2^h
+      std::size_t                      mSize{};                                        ///< Number of values kept
+      std::size_t                      mMaxSize{};                                     ///< Size of a compaction
+      std::uint64_t                    mCount{};                                       ///< Number of values added
+      double                           mMin{std::numeric_limits<double>::infinity()};  ///< Exact minimum
+      double                           mMax{-std::numeric_limits<double>::infinity()}; ///< Exact maximum
+      std::uint32_t                    mBits{};                                        ///< Unused random bits
+      std::size_t                      mBitCount{};                                    ///< Number of unused bits
+  };
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_HISTOGRAM_HPP */
@@ -0,0 +1,599 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_MASK_HPP
+#define MATLABW_MX_ALGORITHM_MASK_HPP
+
+#include "../detail/include.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /// @brief Number of mask elements packed into a word.
+  inline constexpr std::size_t maskWordSize{64};
+
+  /// @brief Number of words OR-ed or AND-ed together before the early exit test of any/all.
+  inline constexpr std::size_t maskScanWords{512};
+
+  /// @brief Eight true bytes, mask elements are stored as bytes of value 0 or 1.
+  inline constexpr std::uint64_t allTrueBytes{0x0101010101010101};
+
+  /**
+   * @brief Gets a span over a mask and checks its element type.
+   * @tparam Mask Mask type
+   * @param mask The mask
+   * @return The span
+   */
+  template<typename Mask>
+  [[nodiscard]] auto toMaskSpan(const Mask& mask) noexcept
+  {
+    auto span = toSpan(mask);
+
+    static_assert(std::is_same_v<ElementType<decltype(span)>, bool>, "mask element type must be bool");
+
+    return span;
+  }
+
+  /**
+   * @brief Loads eight mask elements as a word of bytes.
+   * @param mask Pointer to the elements
+   * @return The word
+   */
+  MATLABW_ALWAYS_INLINE std::uint64_t loadMaskBytes(const bool* mask) noexcept
+  {
+    std::uint64_t word{};
+
+    std::memcpy(&word, mask, sizeof(word));
+
+    return word;
+  }
+
+  /**
+   * @brief Packs 64 mask elements into the bits of a word, element i into bit i.
+   * @param mask Pointer to the elements
+   * @return The word
+   */
+  MATLABW_ALWAYS_INLINE std::uint64_t loadMaskWord(const bool* mask) noexcept
+  {
+#if defined(__SSE2__)
+    std::uint64_t word{};
+
+    for (std::size_t k{}; k < 4; ++k)
+    {
+      // Moves the low bit of each byte to its sign bit, which movemask gathers.
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + 16 * k));
+      const auto    bits  = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_slli_epi16(bytes, 7)));
+
+      word |= std::uint64_t{bits} << (16 * k);
+    }
+
+    return word;
+#else
+    std::uint64_t word{};
+
+    for (std::size_t k{}; k < 8; ++k)
+    {
+      // Multiplication gathers the low bits of the bytes in the top byte, byte i into bit i.
+      word |= ((loadMaskBytes(mask + 8 * k) * 0x0102040810204080) >> 56) << (8 * k);
+    }
+
+    return word;
+#endif
+  }
+
+  /**
+   * @brief Packs up to 64 mask elements into the bits of a word, the remaining bits are zero.
+   * @param mask Pointer to the elements
+   * @param n Number of elements
+   * @return The word
+   */
+  MATLABW_ALWAYS_INLINE std::uint64_t loadMaskTail(const bool* mask, std::size_t n) noexcept
+  {
+    std::uint64_t word{};
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      word |= std::uint64_t{mask[i]} << i;
+    }
+
+    return word;
+  }
+
+  /**
+   * @brief Counts the true elements of a range. Bytes are summed in 8-bit lanes of words, 255 words at a time so
+   *        that the lanes cannot overflow, which the compiler vectorizes.
+   * @param mask Pointer to the elements
+   * @param n Number of elements
+   * @return The count
+   */
+  MATLABW_ALWAYS_INLINE std::size_t countMaskRange(const bool* mask, std::size_t n) noexcept
+  {
+    constexpr std::uint64_t lowBytes{0x00ff00ff00ff00ff};
+
+    std::size_t count{};
+    std::size_t i{};
+
+    while (i + 8 <= n)
+    {
+      const std::size_t words = std::min<std::size_t>((n - i) / 8, 255);
+
+      std::uint64_t lanes{};
+
+      for (std::size_t k{}; k < words; ++k)
+      {
+        lanes += loadMaskBytes(mask + i + 8 * k);
+      }
+
+      // Pairs of 8-bit lanes into 16-bit lanes, then the four 16-bit lanes are summed into the top one.
+      const std::uint64_t pairs = (lanes & lowBytes) + ((lanes >> 8) & lowBytes);
+
+      count += static_cast<std::size_t>((pairs * 0x0001000100010001) >> 48);
+      i     += 8 * words;
+    }
+
+    for (; i < n; ++i)
+    {
+      count += mask[i];
+    }
+
+    return count;
+  }
+
+  /**
+   * @brief Calls a function with the index of every true element of a range in ascending order. Words of 64 false
+   *        elements are skipped at once.
+   * @tparam Fn Function type, called as fn(i)
+   * @param mask Pointer to the elements
+   * @param first First index
+   * @param last Past the end index
+   * @param fn The function
+   */
+  template<typename Fn>
+  MATLABW_ALWAYS_INLINE void forEachTrue(const bool* mask, std::size_t first, std::size_t last, Fn&& fn)
+  {
+    std::size_t i{first};
+
+    for (; i + maskWordSize <= last; i += maskWordSize)
+    {
+      for (std::uint64_t word = loadMaskWord(mask + i); word != 0; word &= word - 1)
+      {
+        fn(i + static_cast<std::size_t>(std::countr_zero(word)));
+      }
+    }
+
+    for (std::uint64_t word = loadMaskTail(mask + i, last - i); word != 0; word &= word - 1)
+    {
+      fn(i + static_cast<std::size_t>(std::countr_zero(word)));
+    }
+  }
+
+  /// @brief Positions of the true elements of a mask, split into the fixed-size chunks of the parallel kernels.
+  struct MaskPlan
+  {
+    std::size_t              count{};   ///< Number of true elements.
+    std::vector<std::size_t> offsets{}; ///< Number of true elements before each chunk, empty for serial kernels.
+  };
+
+  /**
+   * @brief Counts the true elements of a mask, for large masks per parallel chunk.
+   * @param mask Pointer to the elements
+   * @param n Number of elements
+   * @return The plan
+   */
+  [[nodiscard]] inline MaskPlan planMask(const bool* mask, std::size_t n)
+  {
+    MaskPlan plan{};
+
+    if (n < parallelMinSize)
+    {
+      plan.count = dispatch([&]() MATLABW_INLINE_LAMBDA { return countMaskRange(mask, n); });
+
+      return plan;
+    }
+
+    plan.offsets.resize((n + parallelChunkSize - 1) / parallelChunkSize);
+
+    parallel::parallelFor(0, plan.offsets.size(), 1, [&](std::size_t chunk)
+    {
+      const std::size_t first = chunk * parallelChunkSize;
+      const std::size_t size  = std::min(parallelChunkSize, n - first);
+
+      plan.offsets[chunk] = dispatch([&]() MATLABW_INLINE_LAMBDA { return countMaskRange(mask + first, size); });
+    });
+
+    for (std::size_t& offset : plan.offsets)
+    {
+      plan.count += std::exchange(offset, plan.count);
+    }
+
+    return plan;
+  }
+
+  /**
+   * @brief Calls a function for every true element of a mask with its index and its position among the true
+   *        elements. Chunks of a parallel plan run on the library-managed thread pool.
+   * @tparam Fn Function type, called as fn(i, position), should be marked with MATLABW_INLINE_LAMBDA
+   * @param mask Pointer to the elements
+   * @param n Number of elements
+   * @param plan The plan of the mask
+   * @param fn The function
+   */
+  template<typename Fn>
+  void forEachTrue(const bool* mask, std::size_t n, const MaskPlan& plan, Fn fn)
+  {
+    auto run = [mask, &fn](std::size_t first, std::size_t last, std::size_t position)
+    {
+      dispatch([&]() MATLABW_INLINE_LAMBDA
+      {
+        forEachTrue(mask, first, last, [&](std::size_t i) MATLABW_INLINE_LAMBDA { fn(i, position++); });
+      });
+    };
+
+    if (plan.offsets.empty())
+    {
+      run(0, n, 0);
+      return;
+    }
+
+    parallel::parallelFor(0, plan.offsets.size(), 1, [&](std::size_t chunk)
+    {
+      const std::size_t first = chunk * parallelChunkSize;
+
+      run(first, std::min(first + parallelChunkSize, n), plan.offsets[chunk]);
+    });
+  }
+
+  /**
+   * @brief Creates the vector result of an operation over an array, a row if the array is a row vector, a column
+   *        otherwise, as find and logical indexing in MATLAB.
+   * @tparam T Element type
+   * @tparam A Array type
+   * @param array The array
+   * @param n Number of elements
+   * @return The uninitialized vector
+   */
+  template<typename T, typename A>
+  [[nodiscard]] NumericArray<T> makeVectorResult(const A& array, std::size_t n)
+  {
+    if constexpr (requires { array.getDims(); })
+    {
+      const auto dims = array.getDims();
+
+      if (dims.size() == 2 && dims[0] == 1)
+      {
+        return makeUninitNumericArray<T>(1, n);
+      }
+    }
+
+    return makeUninitNumericArray<T>(n, 1);
+  }
+} // namespace detail
+
+  /**
+   * @brief Counts the true elements of a mask, as nnz.
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param mask The mask
+   * @return The count
+   */
+  template<typename Mask>
+  [[nodiscard]] std::size_t countTrue(const Mask& mask)
+  {
+    const auto src = detail::toMaskSpan(mask);
+
+    return detail::planMask(src.data(), src.size()).count;
+  }
+
+  /**
+   * @brief Checks if any element of a mask is true, stops after the first block with a true element.
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param mask The mask
+   * @return True if any element is true, false for an empty mask
+   */
+  template<typename Mask>
+  [[nodiscard]] bool anyTrue(const Mask& mask)
+  {
+    const auto  src  = detail::toMaskSpan(mask);
+    const bool* data = src.data();
+    const auto  n    = src.size();
+
+    return detail::dispatch([&]() MATLABW_INLINE_LAMBDA
+    {
+      constexpr std::size_t blockSize = 8 * detail::maskScanWords;
+
+      std::size_t i{};
+
+      for (; i + blockSize <= n; i += blockSize)
+      {
+        std::uint64_t any{};
+
+        for (std::size_t k{}; k < detail::maskScanWords; ++k)
+        {
+          any |= detail::loadMaskBytes(data + i + 8 * k);
+        }
+
+        if (any != 0)
+        {
+          return true;
+        }
+      }
+
+      return std::find(data + i, data + n, true) != data + n;
+    });
+  }
+
+  /**
+   * @brief Checks if all elements of a mask are true, stops after the first block with a false element.
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param mask The mask
+   * @return True if all elements are true, true for an empty mask
+   */
+  template<typename Mask>
+  [[nodiscard]] bool allTrue(const Mask& mask)
+  {
+    const auto  src  = detail::toMaskSpan(mask);
+    const bool* data = src.data();
+    const auto  n    = src.size();
+
+    return detail::dispatch([&]() MATLABW_INLINE_LAMBDA
+    {
+      constexpr std::size_t blockSize = 8 * detail::maskScanWords;
+
+      std::size_t i{};
+
+      for (; i + blockSize <= n; i += blockSize)
+      {
+        std::uint64_t all{detail::allTrueBytes};
+
+        for (std::size_t k{}; k < detail::maskScanWords; ++k)
+        {
+          all &= detail::loadMaskBytes(data + i + 8 * k);
+        }
+
+        if (all != detail::allTrueBytes)
+        {
+          return false;
+        }
+      }
+
+      return std::find(data + i, data + n, false) == data + n;
+    });
+  }
+
+  /**
+   * @brief Gets the one-based indices of the true elements of a mask, as find. Large masks are processed in parallel.
+   * @tparam Index Index type, double or std::uint64_t
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param mask The mask
+   * @return The indices in ascending order, a row vector for a row vector mask, a column vector otherwise
+   */
+  template<typename Index = double, typename Mask>
+  [[nodiscard]] NumericArray<Index> find(const Mask& mask)
+  {
+    static_assert(std::is_same_v<Index, double> || std::is_same_v<Index, std::uint64_t>,
+                  "index type must be double or std::uint64_t");
+
+    const auto src  = detail::toMaskSpan(mask);
+    const auto plan = detail::planMask(src.data(), src.size());
+
+    NumericArray<Index> out = detail::makeVectorResult<Index>(mask, plan.count);
+
+    Index* dst = out.getData();
+
+    detail::forEachTrue(src.data(), src.size(), plan, [dst](std::size_t i, std::size_t position) MATLABW_INLINE_LAMBDA
+    {
+      dst[position] = static_cast<Index>(i + 1);
+    });
+
+    return out;
+  }
+
+  /**
+   * @brief Selects the elements of an array where a mask is true, as in(mask). Large masks are processed in parallel.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...) of a numeric element type
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param in Input
+   * @param mask The mask, of the input's size
+   * @return The selected elements in order, a row vector for a row vector mask, a column vector otherwise
+   */
+  template<typename In, typename Mask>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> compress(const In& in, const Mask& mask)
+  {
+    using T = detail::ElementOf<In>;
+
+    static_assert(detail::Numeric<T>, "unsupported element type");
+
+    const auto src = detail::toSpan(in);
+    const auto msk = detail::toMaskSpan(mask);
+
+    detail::checkSizes("matlabw:mx:algorithm:compress", src.size(), msk.size());
+
+    const auto plan = detail::planMask(msk.data(), msk.size());
+
+    NumericArray<T> out = detail::makeVectorResult<T>(mask, plan.count);
+
+    const T* data = src.data();
+    T*       dst  = out.getData();
+
+    detail::forEachTrue(msk.data(), msk.size(), plan, [data, dst](std::size_t i, std::size_t position)
+      MATLABW_INLINE_LAMBDA
+    {
+      dst[position] = data[i];
+    });
+
+    return out;
+  }
+
+  /**
+   * @brief Writes values to the elements of an array where a mask is true, as out(mask) = values. Large masks are
+   *        processed in parallel.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...)
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @tparam In Values type (TypedArrayCref, TypedArray, span, ...) of the output's element type
+   * @param out The output, elements where the mask is false are left intact
+   * @param mask The mask, of the output's size
+   * @param values The values in order, one per true element of the mask or a single value written to all of them
+   */
+  template<typename Out, typename Mask, typename In>
+  void scatter(Out&& out, const Mask& mask, const In& values)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:scatter"};
+
+    auto       dst = detail::toSpan(out);
+    const auto src = detail::toSpan(values);
+    const auto msk = detail::toMaskSpan(mask);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    static_assert(std::is_same_v<detail::ElementType<decltype(src)>, T>, "value type must match the output type");
+
+    detail::checkSizes(id, dst.size(), msk.size());
+
+    const auto plan = detail::planMask(msk.data(), msk.size());
+
+    T* data = dst.data();
+
+    if (src.size() == 1)
+    {
+      const T value = src[0];
+
+      detail::forEachTrue(msk.data(), msk.size(), plan, [data, value](std::size_t i, std::size_t)
+        MATLABW_INLINE_LAMBDA
+      {
+        data[i] = value;
+      });
+
+      return;
+    }
+
+    if (src.size() != plan.count)
+    {
+      throw Exception{id, "number of values must match the number of true mask elements"};
+    }
+
+    const T* from = src.data();
+
+    detail::forEachTrue(msk.data(), msk.size(), plan, [data, from](std::size_t i, std::size_t position)
+      MATLABW_INLINE_LAMBDA
+    {
+      data[i] = from[position];
+    });
+  }
+
+  /**
+   * @brief Packs a mask into a bitset, element i into bit i % 64 of word i / 64.
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param bits The bitset, of (size + 63) / 64 words, unused bits of the last word are zero
+   * @param mask The mask
+   */
+  template<typename Mask>
+  void packBits(Span<std::uint64_t> bits, const Mask& mask)
+  {
+    const auto  src  = detail::toMaskSpan(mask);
+    const bool* data = src.data();
+    const auto  n    = src.size();
+
+    const std::size_t words = (n + detail::maskWordSize - 1) / detail::maskWordSize;
+
+    detail::checkSizes("matlabw:mx:algorithm:packBits", bits.size(), words);
+
+    std::uint64_t* dst = bits.data();
+
+    detail::forChunks(n / detail::maskWordSize, [data, dst](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+    {
+      for (std::size_t w{first}; w < last; ++w)
+      {
+        dst[w] = detail::loadMaskWord(data + w * detail::maskWordSize);
+      }
+    });
+
+    if (const std::size_t tail = n % detail::maskWordSize; tail != 0)
+    {
+      dst[n / detail::maskWordSize] = detail::loadMaskTail(data + n - tail, tail);
+    }
+  }
+
+  /**
+   * @brief Packs a mask into a bitset, element i into bit i % 64 of word i / 64.
+   * @tparam Mask Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param mask The mask
+   * @return The bitset, unused bits of the last word are zero
+   */
+  template<typename Mask>
+  [[nodiscard]] std::vector<std::uint64_t> packBits(const Mask& mask)
+  {
+    const std::size_t n = detail::toMaskSpan(mask).size();
+
+    std::vector<std::uint64_t> bits((n + detail::maskWordSize - 1) / detail::maskWordSize);
+
+    packBits(bits, mask);
+
+    return bits;
+  }
+
+  /**
+   * @brief Unpacks a bitset into a mask, bit i % 64 of word i / 64 into element i.
+   * @tparam Out Mask type (LogicalArrayRef, LogicalArray, span of bool, ...)
+   * @param mask The mask
+   * @param bits The bitset, of (size + 63) / 64 words
+   */
+  template<typename Out>
+  void unpackBits(Out&& mask, View<std::uint64_t> bits)
+  {
+    auto dst = detail::toSpan(mask);
+
+    static_assert(std::is_same_v<detail::ElementType<decltype(dst)>, bool>, "mask element type must be bool");
+
+    const std::size_t n = dst.size();
+
+    const std::size_t words = (n + detail::maskWordSize - 1) / detail::maskWordSize;
+
+    detail::checkSizes("matlabw:mx:algorithm:unpackBits", bits.size(), words);
+
+    bool*                data = dst.data();
+    const std::uint64_t* src  = bits.data();
+
+    detail::forChunks(n, [data, src](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+    {
+      for (std::size_t i{first}; i < last; ++i)
+      {
+        data[i] = ((src[i / detail::maskWordSize] >> (i % detail::maskWordSize)) & 1) != 0;
+      }
+    });
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_MASK_HPP */
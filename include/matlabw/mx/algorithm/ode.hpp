@@ -0,0 +1,461 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_ODE_HPP
+#define MATLABW_MX_ALGORITHM_ODE_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../NumericArray.hpp"
+#include "../SparseArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /// @brief Number of trajectories of a block, the lanes of the structure of arrays passed to the kernels.
+  inline constexpr std::size_t odeBlockSize{64};
+
+  /// @brief Minimum number of trajectories evaluated in parallel.
+  inline constexpr std::size_t odeParallelMinSize{1024};
+} // namespace detail
+
+  /**
+   * @brief Values of one trajectory in a block stored as a structure of arrays, value i of all lanes is contiguous.
+   *        Loops over the lanes of a block therefore vectorize.
+   * @tparam T Value type, const double for inputs
+   * @tparam Size Number of values
+   */
+  template<typename T, std::size_t Size>
+  class OdeLane
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param data The block, Size arrays of odeBlockSize values
+       * @param lane The lane
+       */
+      MATLABW_ALWAYS_INLINE constexpr OdeLane(T* data, std::size_t lane) noexcept
+      : mData{data + lane}
+      {}
+
+      /**
+       * @brief Gets the number of values.
+       * @return The number of values
+       */
+      [[nodiscard]] static constexpr std::size_t size() noexcept
+      {
+        return Size;
+      }
+
+      /**
+       * @brief Gets a value.
+       * @param i Index of the value
+       * @return The value
+       */
+      [[nodiscard]] MATLABW_ALWAYS_INLINE constexpr T& operator[](std::size_t i) const noexcept
+      {
+        return mData[i * detail::odeBlockSize];
+      }
+    private:
+      T* mData; ///< The value 0 of the lane
+  };
+
+  /**
+   * @brief Jacobian of one trajectory in a block, stored as a structure of arrays like OdeLane.
+   * @tparam Dim Dimension of the state
+   */
+  template<std::size_t Dim>
+  class OdeJacobianLane
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param data The block, Dim * Dim arrays of odeBlockSize values
+       * @param lane The lane
+       */
+      MATLABW_ALWAYS_INLINE constexpr OdeJacobianLane(double* data, std::size_t lane) noexcept
+      : mData{data + lane}
+      {}
+
+      /**
+       * @brief Gets a partial derivative.
+       * @param i Index of the derivative
+       * @param j Index of the state
+       * @return The partial derivative of derivative i by state j
+       */
+      [[nodiscard]] MATLABW_ALWAYS_INLINE constexpr double& operator()(std::size_t i, std::size_t j) const noexcept
+      {
+        return mData[(i + j * Dim) * detail::odeBlockSize];
+      }
+    private:
+      double* mData; ///< The partial derivative (0, 0) of the lane
+  };
+
+namespace detail
+{
+  /**
+   * @brief Gets the states of an ODE evaluation.
+   * @tparam Dim Dimension of the state
+   * @tparam ParamDim Number of parameters of a trajectory
+   * @tparam Y State array type
+   * @param id The error identifier
+   * @param y The states
+   * @param params The parameters
+   * @return The states and the number of parameter sets
+   */
+  template<std::size_t Dim, std::size_t ParamDim, typename Y>
+  [[nodiscard]] auto getOdeStates(const char* id, const Y& y, std::span<const double> params)
+  {
+    static_assert(Dim > 0, "state dimension must be positive");
+
+    const auto states = toSpan(y);
+
+    static_assert(std::is_same_v<ElementType<decltype(states)>, double>, "states must be double");
+
+    if (states.size() % Dim != 0)
+    {
+      throw Exception{id, "number of states must be a multiple of the state dimension"};
+    }
+
+    std::size_t paramCount{};
+
+    if constexpr (ParamDim > 0)
+    {
+      paramCount = params.size() / ParamDim;
+
+      if (paramCount == 0 || params.size() % ParamDim != 0 || (states.size() / Dim) % paramCount != 0)
+      {
+        throw Exception{id, "number of trajectories must be a multiple of the number of parameter sets"};
+      }
+    }
+
+    return std::pair{states, paramCount};
+  }
+
+  /**
+   * @brief Runs a function for the blocks of trajectories, in parallel for many trajectories. Each block gathers the
+   *        states and parameters into structures of arrays, lanes past the last trajectory repeat the first one.
+   * @tparam Dim Dimension of the state
+   * @tparam ParamDim Number of parameters of a trajectory
+   * @tparam Fn Function type, called as fn(first, count, states, params) for count trajectories from first
+   * @param states The states, Dim values per trajectory
+   * @param params The parameters, ParamDim values per parameter set
+   * @param paramCount Number of parameter sets, trajectory k uses set k modulo paramCount
+   * @param fn The function
+   */
+  template<std::size_t Dim, std::size_t ParamDim, typename Fn>
+  void forEachOdeBlock(std::span<const double> states, std::span<const double> params, std::size_t paramCount, Fn&& fn)
+  {
+    const std::size_t trajectoryCount = states.size() / Dim;
+    const std::size_t blockCount      = (trajectoryCount + odeBlockSize - 1) / odeBlockSize;
+
+    auto block = [&](std::size_t b)
+    {
+      alignas(64) double y[Dim * odeBlockSize];
+      alignas(64) double p[std::max(ParamDim, std::size_t{1}) * odeBlockSize];
+
+      const std::size_t first = b * odeBlockSize;
+      const std::size_t count = std::min(odeBlockSize, trajectoryCount - first);
+
+      for (std::size_t lane{}; lane < odeBlockSize; ++lane)
+      {
+        const std::size_t k = first + ((lane < count) ? lane : 0);
+
+        for (std::size_t i{}; i < Dim; ++i)
+        {
+          y[i * odeBlockSize + lane] = states[k * Dim + i];
+        }
+
+        if constexpr (ParamDim > 0)
+        {
+          for (std::size_t i{}; i < ParamDim; ++i)
+          {
+            p[i * odeBlockSize + lane] = params[(k % paramCount) * ParamDim + i];
+          }
+        }
+      }
+
+      fn(first, count, static_cast<const double*>(y), static_cast<const double*>(p));
+    };
+
+    if (trajectoryCount >= odeParallelMinSize)
+    {
+      parallel::parallelFor(0, blockCount, 1, block);
+    }
+    else
+    {
+      for (std::size_t b{}; b < blockCount; ++b)
+      {
+        block(b);
+      }
+    }
+  }
+
+  /**
+   * @brief Calls a kernel for all lanes of a block, dispatched to the best instruction set.
+   * @tparam Dim Dimension of the state
+   * @tparam ParamDim Number of parameters of a trajectory
+   * @tparam Out Output lane type
+   * @tparam Kernel Kernel type, called as kernel(t, y, out) or kernel(t, y, p, out)
+   * @param t The time
+   * @param y The states of the block
+   * @param p The parameters of the block
+   * @param out The outputs of the block
+   * @param kernel The kernel
+   */
+  template<std::size_t Dim, std::size_t ParamDim, typename Out, typename Kernel>
+  MATLABW_ALWAYS_INLINE void runOdeLanes(double t, const double* y, const double* p, double* out, Kernel& kernel)
+  {
+    dispatch([&]() MATLABW_INLINE_LAMBDA
+    {
+      for (std::size_t lane{}; lane < odeBlockSize; ++lane)
+      {
+        if constexpr (ParamDim > 0)
+        {
+          kernel(t, OdeLane<const double, Dim>{y, lane}, OdeLane<const double, ParamDim>{p, lane}, Out{out, lane});
+        }
+        else
+        {
+          kernel(t, OdeLane<const double, Dim>{y, lane}, Out{out, lane});
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Creates the block diagonal pattern of the Jacobian of independent trajectories.
+   * @tparam Dim Dimension of the state
+   * @param n Number of states
+   * @return The sparse matrix with uninitialized values
+   */
+  template<std::size_t Dim>
+  [[nodiscard]] SparseArray<double> makeOdeJacobian(std::size_t n)
+  {
+    SparseArray<double> jacobian = makeSparseArray<double>(n, n, n * Dim);
+
+    const auto storage = jacobian.getStorage();
+    const auto colPtr  = storage.colPtr;
+    const auto rowIdx  = storage.rowIdx;
+
+    for (std::size_t col{}; col <= n; ++col)
+    {
+      colPtr[col] = static_cast<mwIndex>(col * Dim);
+    }
+
+    for (std::size_t col{}; col < n; ++col)
+    {
+      const std::size_t base = col - col % Dim;
+
+      for (std::size_t i{}; i < Dim; ++i)
+      {
+        rowIdx[col * Dim + i] = static_cast<mwIndex>(base + i);
+      }
+    }
+
+    return jacobian;
+  }
+
+  /**
+   * @brief Gets the step of a forward difference, as numjac for a state without a threshold.
+   * @param y The state
+   * @return The step
+   */
+  [[nodiscard]] MATLABW_ALWAYS_INLINE double getOdeStep(double y) noexcept
+  {
+    const double step = std::sqrt(std::numeric_limits<double>::epsilon()) * std::max(std::abs(y), 1.0);
+
+    // Rounded so that the difference of the states is exactly the step.
+    return (y + step) - y;
+  }
+} // namespace detail
+
+  /**
+   * @brief Evaluates the right-hand side of an ODE system of many independent trajectories in one call, as a
+   *        vectorized ODE function f(t, y) does for MATLAB's solvers. The states hold Dim values per trajectory, e.g.
+   *        a (Dim * n) x 1 state of n trajectories or a (Dim * n) x k matrix of a vectorized call. Blocks of
+   *        trajectories are transposed into structures of arrays and the kernel runs for all lanes of a block in a
+   *        loop compiled for the best instruction set, many trajectories run in parallel.
+   * @tparam Dim Dimension of the state of a trajectory
+   * @tparam ParamDim Number of parameters of a trajectory, 0 for none
+   * @tparam Y State array type with dimensions (TypedArrayCref, TypedArray, ...) of double
+   * @tparam Rhs Kernel type, called as rhs(t, y, yp) or rhs(t, y, p, yp) with OdeLane arguments. Should be marked
+   *         with MATLABW_INLINE_LAMBDA and free of branches to vectorize, exceptions are propagated.
+   * @param t The time
+   * @param y The states
+   * @param rhs The kernel
+   * @param params The parameters, ParamDim values per parameter set, trajectory k uses set k modulo the number of sets
+   * @return The derivatives with the dimensions of the states
+   */
+  template<std::size_t Dim, std::size_t ParamDim = 0, typename Y, typename Rhs>
+    requires requires(const Y& states) { states.getDims(); }
+  [[nodiscard]] NumericArray<double> evaluateOde(double t, const Y& y, Rhs rhs, std::span<const double> params = {})
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:evaluateOde"};
+
+    const auto [states, paramCount] = detail::getOdeStates<Dim, ParamDim>(id, y, params);
+
+    NumericArray<double> yp = makeUninitNumericArray<double>(y.getDims());
+
+    double* dst = yp.getData();
+
+    detail::forEachOdeBlock<Dim, ParamDim>(states, params, paramCount,
+                                           [&](std::size_t first, std::size_t count, const double* ys, const double* ps)
+    {
+      alignas(64) double out[Dim * detail::odeBlockSize];
+
+      detail::runOdeLanes<Dim, ParamDim, OdeLane<double, Dim>>(t, ys, ps, out, rhs);
+
+      for (std::size_t lane{}; lane < count; ++lane)
+      {
+        for (std::size_t i{}; i < Dim; ++i)
+        {
+          dst[(first + lane) * Dim + i] = out[i * detail::odeBlockSize + lane];
+        }
+      }
+    });
+
+    return yp;
+  }
+
+  /**
+   * @brief Evaluates the Jacobian of an ODE system of many independent trajectories, as the Jacobian function of
+   *        odeset. The Jacobian is block diagonal with one Dim x Dim block per trajectory.
+   * @tparam Dim Dimension of the state of a trajectory
+   * @tparam ParamDim Number of parameters of a trajectory, 0 for none
+   * @tparam Y State array type (TypedArrayCref, TypedArray, span, ...) of double
+   * @tparam Jac Kernel type, called as jac(t, y, J) or jac(t, y, p, J) with OdeLane and OdeJacobianLane arguments,
+   *         J(i, j) is the partial derivative of derivative i by state j
+   * @param t The time
+   * @param y The states, Dim values per trajectory
+   * @param jac The kernel
+   * @param params The parameters, see evaluateOde()
+   * @return The sparse Jacobian
+   */
+  template<std::size_t Dim, std::size_t ParamDim = 0, typename Y, typename Jac>
+  [[nodiscard]] SparseArray<double> evaluateOdeJacobian(double                  t,
+                                                        const Y&                y,
+                                                        Jac                     jac,
+                                                        std::span<const double> params = {})
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:evaluateOdeJacobian"};
+
+    const auto [states, paramCount] = detail::getOdeStates<Dim, ParamDim>(id, y, params);
+
+    SparseArray<double> jacobian = detail::makeOdeJacobian<Dim>(states.size());
+
+    double* values = jacobian.getStorage().values.data();
+
+    detail::forEachOdeBlock<Dim, ParamDim>(states, params, paramCount,
+                                           [&](std::size_t first, std::size_t count, const double* ys, const double* ps)
+    {
+      // Allocated, since the blocks of large systems do not fit on the stack.
+      std::vector<double> out(Dim * Dim * detail::odeBlockSize);
+
+      detail::runOdeLanes<Dim, ParamDim, OdeJacobianLane<Dim>>(t, ys, ps, out.data(), jac);
+
+      for (std::size_t lane{}; lane < count; ++lane)
+      {
+        for (std::size_t e{}; e < Dim * Dim; ++e)
+        {
+          values[(first + lane) * Dim * Dim + e] = out[e * detail::odeBlockSize + lane];
+        }
+      }
+    });
+
+    return jacobian;
+  }
+
+  /**
+   * @brief Approximates the Jacobian of an ODE system of many independent trajectories by forward differences of the
+   *        right-hand side, with Dim extra evaluations of each block instead of one per state of the whole system.
+   * @tparam Dim Dimension of the state of a trajectory
+   * @tparam ParamDim Number of parameters of a trajectory, 0 for none
+   * @tparam Y State array type (TypedArrayCref, TypedArray, span, ...) of double
+   * @tparam Rhs Kernel type, see evaluateOde()
+   * @param t The time
+   * @param y The states, Dim values per trajectory
+   * @param rhs The kernel
+   * @param params The parameters, see evaluateOde()
+   * @return The sparse Jacobian
+   */
+  template<std::size_t Dim, std::size_t ParamDim = 0, typename Y, typename Rhs>
+  [[nodiscard]] SparseArray<double> approximateOdeJacobian(double                  t,
+                                                           const Y&                y,
+                                                           Rhs                     rhs,
+                                                           std::span<const double> params = {})
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:approximateOdeJacobian"};
+
+    const auto [states, paramCount] = detail::getOdeStates<Dim, ParamDim>(id, y, params);
+
+    SparseArray<double> jacobian = detail::makeOdeJacobian<Dim>(states.size());
+
+    double* values = jacobian.getStorage().values.data();
+
+    detail::forEachOdeBlock<Dim, ParamDim>(states, params, paramCount,
+                                           [&](std::size_t first, std::size_t count, const double* ys, const double* ps)
+    {
+      alignas(64) double base[Dim * detail::odeBlockSize];
+      alignas(64) double shifted[Dim * detail::odeBlockSize];
+      alignas(64) double out[Dim * detail::odeBlockSize];
+
+      detail::runOdeLanes<Dim, ParamDim, OdeLane<double, Dim>>(t, ys, ps, base, rhs);
+
+      for (std::size_t j{}; j < Dim; ++j)
+      {
+        std::copy_n(ys, Dim * detail::odeBlockSize, shifted);
+
+        double* state = shifted + j * detail::odeBlockSize;
+
+        for (std::size_t lane{}; lane < detail::odeBlockSize; ++lane)
+        {
+          state[lane] += detail::getOdeStep(state[lane]);
+        }
+
+        detail::runOdeLanes<Dim, ParamDim, OdeLane<double, Dim>>(t, shifted, ps, out, rhs);
+
+        for (std::size_t lane{}; lane < count; ++lane)
+        {
+          const double step = state[lane] - ys[j * detail::odeBlockSize + lane];
+
+          for (std::size_t i{}; i < Dim; ++i)
+          {
+            values[(first + lane) * Dim * Dim + j * Dim + i] = (out[i * detail::odeBlockSize + lane]
+                                                                - base[i * detail::odeBlockSize + lane]) / step;
+          }
+        }
+      }
+    });
+
+    return jacobian;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_ODE_HPP */
@@ -0,0 +1,640 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_PERMUTE_HPP
+#define MATLABW_MX_ALGORITHM_PERMUTE_HPP
+
+#include "../detail/include.hpp"
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# include <xmmintrin.h>
+# define MATLABW_PERMUTE_SSE2
+#endif
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../NumericArray.hpp"
+#include "../typeTraits.hpp"
+
+#ifdef MATLABW_SIMD_X86_DISPATCH
+# include <immintrin.h>
+#endif
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /**
+   * @brief Number of rows and columns of the tiles a transpose is blocked into. A tile of the source and of the
+   *        destination fit in the L1 cache together for elements of up to 16 bytes.
+   */
+  inline constexpr std::size_t transposeTileSize{32};
+
+  /**
+   * @brief Transposes a block element by element, dst[c + r * ldDst] = src[r + c * ldSrc].
+   * @tparam T Element type
+   * @param src Source, column-major with leading dimension ldSrc
+   * @param ldSrc Leading dimension of the source
+   * @param dst Destination, column-major with leading dimension ldDst
+   * @param ldDst Leading dimension of the destination
+   * @param rowBegin First row of the block
+   * @param rowEnd Past the end row of the block
+   * @param colBegin First column of the block
+   * @param colEnd Past the end column of the block
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE void transposeScalar(const T*    src,
+                                             std::size_t ldSrc,
+                                             T*          dst,
+                                             std::size_t ldDst,
+                                             std::size_t rowBegin,
+                                             std::size_t rowEnd,
+                                             std::size_t colBegin,
+                                             std::size_t colEnd) noexcept
+  {
+    for (std::size_t r{rowBegin}; r < rowEnd; ++r)
+    {
+      for (std::size_t c{colBegin}; c < colEnd; ++c)
+      {
+        dst[c + r * ldDst] = src[r + c * ldSrc];
+      }
+    }
+  }
+
+  /**
+   * @brief Transposes a block of rows x cols with square micro kernels of size V, the edges left over element by
+   *        element.
+   * @tparam V Size of the micro kernel
+   * @tparam T Element type
+   * @tparam Micro Micro kernel type, called as micro(src, ldSrc, dst, ldDst)
+   */
+  template<std::size_t V, typename T, typename Micro>
+  MATLABW_ALWAYS_INLINE void transposeTiled(Micro       micro,
+                                            const T*    src,
+                                            std::size_t ldSrc,
+                                            T*          dst,
+                                            std::size_t ldDst,
+                                            std::size_t rows,
+                                            std::size_t cols) noexcept
+  {
+    const std::size_t rowsV = rows - rows % V;
+    const std::size_t colsV = cols - cols % V;
+
+    for (std::size_t c{}; c < colsV; c += V)
+    {
+      for (std::size_t r{}; r < rowsV; r += V)
+      {
+        micro(src + r + c * ldSrc, ldSrc, dst + c + r * ldDst, ldDst);
+      }
+    }
+
+    transposeScalar(src, ldSrc, dst, ldDst, rowsV, rows, 0, cols);
+    transposeScalar(src, ldSrc, dst, ldDst, 0, rowsV, colsV, cols);
+  }
+
+#ifdef MATLABW_PERMUTE_SSE2
+  /// @brief Transposes a 4x4 block of 4-byte elements in SSE registers.
+  MATLABW_ALWAYS_INLINE void transpose4x4Sse(const void* src, std::size_t ldSrc, void* dst, std::size_t ldDst) noexcept
+  {
+    const float* in  = static_cast<const float*>(src);
+    float*       out = static_cast<float*>(dst);
+
+    __m128 c0 = _mm_loadu_ps(in);
+    __m128 c1 = _mm_loadu_ps(in + ldSrc);
+    __m128 c2 = _mm_loadu_ps(in + 2 * ldSrc);
+    __m128 c3 = _mm_loadu_ps(in + 3 * ldSrc);
+
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+    _mm_storeu_ps(out, c0);
+    _mm_storeu_ps(out + ldDst, c1);
+    _mm_storeu_ps(out + 2 * ldDst, c2);
+    _mm_storeu_ps(out + 3 * ldDst, c3);
+  }
+
+  /// @brief Transposes a 2x2 block of 8-byte elements in SSE registers.
+  MATLABW_ALWAYS_INLINE void transpose2x2Sse(const void* src, std::size_t ldSrc, void* dst, std::size_t ldDst) noexcept
+  {
+    const double* in  = static_cast<const double*>(src);
+    double*       out = static_cast<double*>(dst);
+
+    const __m128d c0 = _mm_loadu_pd(in);
+    const __m128d c1 = _mm_loadu_pd(in + ldSrc);
+
+    _mm_storeu_pd(out, _mm_unpacklo_pd(c0, c1));
+    _mm_storeu_pd(out + ldDst, _mm_unpackhi_pd(c0, c1));
+  }
+#endif
+
+  /**
+   * @brief Transposes a block with the baseline instruction set, dst[c + r * ldDst] = src[r + c * ldSrc].
+   * @tparam T Element type
+   * @param src Source, column-major with leading dimension ldSrc
+   * @param ldSrc Leading dimension of the source
+   * @param dst Destination, column-major with leading dimension ldDst
+   * @param ldDst Leading dimension of the destination
+   * @param rows Number of rows of the source
+   * @param cols Number of columns of the source
+   */
+  template<typename T>
+  void transposeBlockGeneric(const T*    src,
+                             std::size_t ldSrc,
+                             T*          dst,
+                             std::size_t ldDst,
+                             std::size_t rows,
+                             std::size_t cols)
+  {
+#ifdef MATLABW_PERMUTE_SSE2
+    if constexpr (sizeof(T) == 4)
+    {
+      transposeTiled<4>([](const T* s, std::size_t ls, T* d, std::size_t ld) MATLABW_INLINE_LAMBDA
+      {
+        transpose4x4Sse(s, ls, d, ld);
+      }, src, ldSrc, dst, ldDst, rows, cols);
+      return;
+    }
+    else if constexpr (sizeof(T) == 8)
+    {
+      transposeTiled<2>([](const T* s, std::size_t ls, T* d, std::size_t ld) MATLABW_INLINE_LAMBDA
+      {
+        transpose2x2Sse(s, ls, d, ld);
+      }, src, ldSrc, dst, ldDst, rows, cols);
+      return;
+    }
+#endif
+
+    transposeScalar(src, ldSrc, dst, ldDst, 0, rows, 0, cols);
+  }
+
+#ifdef MATLABW_SIMD_X86_DISPATCH
+  /// @brief Transposes an 8x8 block of 4-byte elements in AVX registers.
+  [[gnu::target("avx2,fma"), gnu::always_inline]]
+  inline void transpose8x8Avx(const void* src, std::size_t ldSrc, void* dst, std::size_t ldDst) noexcept
+  {
+    const float* in  = static_cast<const float*>(src);
+    float*       out = static_cast<float*>(dst);
+
+    __m256 c[8];
+
+    for (std::size_t k{}; k < 8; ++k)
+    {
+      c[k] = _mm256_loadu_ps(in + k * ldSrc);
+    }
+
+    const __m256 t0 = _mm256_unpacklo_ps(c[0], c[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(c[0], c[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(c[2], c[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(c[2], c[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(c[4], c[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(c[4], c[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(c[6], c[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(c[6], c[7]);
+
+    const __m256 u0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    const __m256 u1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    const __m256 u2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    const __m256 u3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    const __m256 u4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    const __m256 u5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    const __m256 u6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    const __m256 u7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+    _mm256_storeu_ps(out,             _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_storeu_ps(out + ldDst,     _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_storeu_ps(out + 2 * ldDst, _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_storeu_ps(out + 3 * ldDst, _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_storeu_ps(out + 4 * ldDst, _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_storeu_ps(out + 5 * ldDst, _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_storeu_ps(out + 6 * ldDst, _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_storeu_ps(out + 7 * ldDst, _mm256_permute2f128_ps(u3, u7, 0x31));
+  }
+
+  /// @brief Transposes a 4x4 block of 8-byte elements in AVX registers.
+  [[gnu::target("avx2,fma"), gnu::always_inline]]
+  inline void transpose4x4Avx(const void* src, std::size_t ldSrc, void* dst, std::size_t ldDst) noexcept
+  {
+    const double* in  = static_cast<const double*>(src);
+    double*       out = static_cast<double*>(dst);
+
+    const __m256d c0 = _mm256_loadu_pd(in);
+    const __m256d c1 = _mm256_loadu_pd(in + ldSrc);
+    const __m256d c2 = _mm256_loadu_pd(in + 2 * ldSrc);
+    const __m256d c3 = _mm256_loadu_pd(in + 3 * ldSrc);
+
+    const __m256d t0 = _mm256_unpacklo_pd(c0, c1);
+    const __m256d t1 = _mm256_unpackhi_pd(c0, c1);
+    const __m256d t2 = _mm256_unpacklo_pd(c2, c3);
+    const __m256d t3 = _mm256_unpackhi_pd(c2, c3);
+
+    _mm256_storeu_pd(out,             _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(out + ldDst,     _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(out + 2 * ldDst, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(out + 3 * ldDst, _mm256_permute2f128_pd(t1, t3, 0x31));
+  }
+
+  /// @copydoc transposeBlockGeneric
+  template<typename T>
+  [[gnu::target("avx2,fma")]]
+  void transposeBlockAvx2(const T*    src,
+                          std::size_t ldSrc,
+                          T*          dst,
+                          std::size_t ldDst,
+                          std::size_t rows,
+                          std::size_t cols)
+  {
+    const std::size_t rowsV = rows - rows % (32 / sizeof(T));
+    const std::size_t colsV = cols - cols % (32 / sizeof(T));
+
+    if constexpr (sizeof(T) == 4 || sizeof(T) == 8)
+    {
+      for (std::size_t c{}; c < colsV; c += 32 / sizeof(T))
+      {
+        for (std::size_t r{}; r < rowsV; r += 32 / sizeof(T))
+        {
+          if constexpr (sizeof(T) == 4)
+          {
+            transpose8x8Avx(src + r + c * ldSrc, ldSrc, dst + c + r * ldDst, ldDst);
+          }
+          else
+          {
+            transpose4x4Avx(src + r + c * ldSrc, ldSrc, dst + c + r * ldDst, ldDst);
+          }
+        }
+      }
+
+      transposeScalar(src, ldSrc, dst, ldDst, rowsV, rows, 0, cols);
+      transposeScalar(src, ldSrc, dst, ldDst, 0, rowsV, colsV, cols);
+    }
+    else
+    {
+      transposeScalar(src, ldSrc, dst, ldDst, 0, rows, 0, cols);
+    }
+  }
+#endif
+
+  /**
+   * @brief Transposes a block with the best instruction set supported by the CPU, in tiles which fit in the L1 cache.
+   *        dst[c + r * ldDst] = src[r + c * ldSrc].
+   * @tparam T Element type
+   * @param src Source, column-major with leading dimension ldSrc
+   * @param ldSrc Leading dimension of the source
+   * @param dst Destination, column-major with leading dimension ldDst
+   * @param ldDst Leading dimension of the destination
+   * @param rows Number of rows of the source
+   * @param cols Number of columns of the source
+   */
+  template<typename T>
+  void transposeBlock(const T*    src,
+                      std::size_t ldSrc,
+                      T*          dst,
+                      std::size_t ldDst,
+                      std::size_t rows,
+                      std::size_t cols)
+  {
+#ifdef MATLABW_SIMD_X86_DISPATCH
+    const bool avx2 = (getSimdLevel() != SimdLevel::generic);
+#else
+    const bool avx2 = false;
+#endif
+
+    for (std::size_t r{}; r < rows; r += transposeTileSize)
+    {
+      const std::size_t tileRows = std::min(transposeTileSize, rows - r);
+
+      if (avx2)
+      {
+#ifdef MATLABW_SIMD_X86_DISPATCH
+        transposeBlockAvx2(src + r, ldSrc, dst + r * ldDst, ldDst, tileRows, cols);
+#endif
+      }
+      else
+      {
+        transposeBlockGeneric(src + r, ldSrc, dst + r * ldDst, ldDst, tileRows, cols);
+      }
+    }
+  }
+
+  /// @brief Axis of a permutation, after singleton axes are dropped and contiguous axes merged.
+  struct PermuteAxis
+  {
+    std::size_t extent;    ///< Number of elements along the axis
+    std::size_t inStride;  ///< Stride of the axis in the input
+    std::size_t outStride; ///< Stride of the axis in the output
+  };
+
+  /**
+   * @brief Computes the dimensions of a permuted array and checks the order.
+   * @param id Error identifier
+   * @param dims Input dimensions
+   * @param order Zero-based order of the dimensions, covers at least all input dimensions
+   * @return The output dimensions
+   */
+  [[nodiscard]] inline std::vector<std::size_t> getPermutedDims(const char*       id,
+                                                                View<std::size_t> dims,
+                                                                View<std::size_t> order)
+  {
+    if (order.size() < dims.size())
+    {
+      throw Exception{id, "order must contain every dimension of the array"};
+    }
+
+    std::vector<std::size_t> outDims(order.size());
+    std::vector<bool>        used(order.size());
+
+    for (std::size_t k{}; k < order.size(); ++k)
+    {
+      if (order[k] >= order.size() || used[order[k]])
+      {
+        throw Exception{id, "order must be a permutation of the dimension indices"};
+      }
+
+      used[order[k]] = true;
+      outDims[k]     = (order[k] < dims.size()) ? dims[order[k]] : 1;
+    }
+
+    return outDims;
+  }
+
+  /**
+   * @brief Plans a permutation: drops singleton axes and merges axes which stay adjacent, so that e.g. permuting
+   *        [m n p] by [0 2 1] becomes a batch of plain transposes. Axes are in output order.
+   * @param dims Input dimensions
+   * @param order Zero-based order of the dimensions, checked by getPermutedDims()
+   * @return The axes
+   */
+  [[nodiscard]] inline std::vector<PermuteAxis> planPermute(View<std::size_t> dims, View<std::size_t> order)
+  {
+    std::vector<std::size_t> inStrides(order.size());
+
+    for (std::size_t a{}, stride{1}; a < order.size(); ++a)
+    {
+      inStrides[a] = stride;
+      stride      *= (a < dims.size()) ? dims[a] : 1;
+    }
+
+    std::vector<PermuteAxis> axes{};
+
+    for (std::size_t k{}, outStride{1}; k < order.size(); ++k)
+    {
+      const std::size_t extent = (order[k] < dims.size()) ? dims[order[k]] : 1;
+
+      if (extent == 1)
+      {
+        continue;
+      }
+
+      if (!axes.empty() && axes.back().inStride * axes.back().extent == inStrides[order[k]])
+      {
+        axes.back().extent *= extent;
+      }
+      else
+      {
+        axes.push_back({extent, inStrides[order[k]], outStride});
+      }
+
+      outStride *= extent;
+    }
+
+    return axes;
+  }
+
+  /**
+   * @brief Permutes the elements of an array. The planned axes are split into the output contiguous axis 0, the input
+   *        contiguous axis p and the outer axes. Unless p is 0 each outer index is a transpose of a matrix, processed
+   *        in strips of tile columns, in parallel for large arrays.
+   * @tparam T Element type
+   * @param in Input elements
+   * @param out Output elements, must not alias the input
+   * @param size Number of elements
+   * @param axes Planned axes
+   */
+  template<typename T>
+  void permuteElements(const T* in, T* out, std::size_t size, const std::vector<PermuteAxis>& axes)
+  {
+    if (size == 0)
+    {
+      return;
+    }
+
+    if (axes.size() <= 1)
+    {
+      std::memcpy(static_cast<void*>(out), in, size * sizeof(T));
+      return;
+    }
+
+    std::size_t p{};
+
+    while (axes[p].inStride != 1)
+    {
+      ++p;
+    }
+
+    std::vector<PermuteAxis> outer{};
+
+    for (std::size_t k{1}; k < axes.size(); ++k)
+    {
+      if (k != p)
+      {
+        outer.push_back(axes[k]);
+      }
+    }
+
+    // For p == 0 an item is a contiguous run, otherwise a strip of tile columns of a matrix.
+    const std::size_t cols      = axes[0].extent;
+    const std::size_t rows      = (p == 0) ? 1 : axes[p].extent;
+    const std::size_t strips    = (p == 0) ? 1 : (cols + transposeTileSize - 1) / transposeTileSize;
+    const std::size_t itemSize  = (p == 0) ? cols : rows * std::min(cols, transposeTileSize);
+    const std::size_t itemCount = (size / (cols * rows)) * strips;
+
+    auto body = [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t item{first}; item < last; ++item)
+      {
+        std::size_t index     = item / strips;
+        std::size_t inOffset  = 0;
+        std::size_t outOffset = 0;
+
+        for (const PermuteAxis& axis : outer)
+        {
+          inOffset  += (index % axis.extent) * axis.inStride;
+          outOffset += (index % axis.extent) * axis.outStride;
+          index     /= axis.extent;
+        }
+
+        if (p == 0)
+        {
+          std::memcpy(static_cast<void*>(out + outOffset), in + inOffset, cols * sizeof(T));
+        }
+        else
+        {
+          const std::size_t c = (item % strips) * transposeTileSize;
+
+          transposeBlock(in + inOffset + c * axes[0].inStride,
+                         axes[0].inStride,
+                         out + outOffset + c,
+                         axes[p].outStride,
+                         rows,
+                         std::min(transposeTileSize, cols - c));
+        }
+      }
+    };
+
+    if (size < parallelMinSize)
+    {
+      body(0, itemCount);
+      return;
+    }
+
+    parallel::parallelFor(0, itemCount, std::max<std::size_t>(1, parallelChunkSize / itemSize), body);
+  }
+
+  /**
+   * @brief Checks that an output matches the permuted dimensions, trailing singleton dimensions are ignored.
+   * @param id Error identifier
+   * @param expected Expected dimensions
+   * @param actual Dimensions of the output
+   */
+  inline void checkPermutedDims(const char* id, View<std::size_t> expected, View<std::size_t> actual)
+  {
+    const std::size_t rank = std::max(expected.size(), actual.size());
+
+    for (std::size_t k{}; k < rank; ++k)
+    {
+      const std::size_t e = (k < expected.size()) ? expected[k] : 1;
+      const std::size_t a = (k < actual.size()) ? actual[k] : 1;
+
+      if (e != a)
+      {
+        throw Exception{id, "output dimensions must match the permuted dimensions"};
+      }
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Rearranges the dimensions of an array into an existing output, like permute(in, order + 1) in MATLAB.
+   *        Elements are moved in cache-blocked tiles transposed in SIMD registers, in parallel for large arrays.
+   *        Works for every numeric type, complex elements are moved as a whole.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...), dimensions are checked if it has them
+   * @tparam In Input array type (TypedArrayCref, TypedArray, ...)
+   * @param out Output, must not alias the input
+   * @param in Input
+   * @param order Zero-based order of the dimensions, a permutation covering at least all input dimensions
+   */
+  template<typename Out, typename In>
+  void permute(Out&& out, const In& in, View<std::size_t> order)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:permute"};
+
+    auto dst = detail::toSpan(out);
+    auto src = detail::toSpan(in);
+
+    using T = detail::ElementType<decltype(src)>;
+
+    static_assert(std::is_same_v<detail::ElementType<decltype(dst)>, T>, "output element type must match");
+    static_assert(isNumeric<T>, "unsupported element type");
+
+    const std::vector<std::size_t> dims = detail::getPermutedDims(id, in.getDims(), order);
+
+    if constexpr (requires { out.getDims(); })
+    {
+      detail::checkPermutedDims(id, dims, out.getDims());
+    }
+    else
+    {
+      detail::checkSizes(id, src.size(), dst.size());
+    }
+
+    detail::permuteElements(src.data(), dst.data(), src.size(), detail::planPermute(in.getDims(), order));
+  }
+
+  /**
+   * @brief Rearranges the dimensions of an array into a new array, see permute(out, in, order).
+   * @tparam In Input array type (TypedArrayCref, TypedArray, ...)
+   * @param in Input
+   * @param order Zero-based order of the dimensions, a permutation covering at least all input dimensions
+   * @return The permuted numeric array
+   */
+  template<typename In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> permute(const In& in, View<std::size_t> order)
+  {
+    using T = detail::ElementOf<In>;
+
+    NumericArray<T> out = makeUninitNumericArray<T>(detail::getPermutedDims("matlabw:mx:algorithm:permute",
+                                                                            in.getDims(),
+                                                                            order));
+
+    permute(out, in, order);
+
+    return out;
+  }
+
+  /**
+   * @brief Transposes a matrix into an existing output, like in.' in MATLAB (complex elements are not conjugated).
+   *        Converts between column-major and row-major layouts, see permute(out, in, order).
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...)
+   * @tparam In Input array type (TypedArrayCref, TypedArray, ...), must be 2-D
+   * @param out Output, must not alias the input
+   * @param in Input
+   */
+  template<typename Out, typename In>
+  void transpose(Out&& out, const In& in)
+  {
+    if (in.getDims().size() > 2)
+    {
+      throw Exception{"matlabw:mx:algorithm:transpose", "array must be 2-D"};
+    }
+
+    static constexpr std::size_t order[]{1, 0};
+
+    permute(std::forward<Out>(out), in, order);
+  }
+
+  /**
+   * @brief Transposes a matrix into a new array, see transpose(out, in).
+   * @tparam In Input array type (TypedArrayCref, TypedArray, ...), must be 2-D
+   * @param in Input
+   * @return The transposed numeric array
+   */
+  template<typename In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> transpose(const In& in)
+  {
+    if (in.getDims().size() > 2)
+    {
+      throw Exception{"matlabw:mx:algorithm:transpose", "array must be 2-D"};
+    }
+
+    static constexpr std::size_t order[]{1, 0};
+
+    return permute(in, order);
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_PERMUTE_HPP */
@@ -0,0 +1,308 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_PIPELINE_HPP
+#define MATLABW_MX_ALGORITHM_PIPELINE_HPP
+
+#include "../detail/include.hpp"
+
+#include "convert.hpp"
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "elementwise.hpp"
+#include "reduce.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /// @brief Identity operation, the first stage of a pipeline.
+  struct IdentityOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T x) const noexcept { return x; }
+  };
+
+  /// @brief Conversion operation with MATLAB cast semantics.
+  template<typename T>
+  struct ConvertOp
+  {
+    template<typename U>
+    MATLABW_ALWAYS_INLINE T operator()(U x) const noexcept { return convertValue<T>(x); }
+  };
+
+  /// @brief Composition of two operations, the inner one is applied first.
+  template<typename Outer, typename Inner>
+  struct ComposeOp
+  {
+    Outer outer; ///< Operation applied second
+    Inner inner; ///< Operation applied first
+
+    template<typename T>
+    MATLABW_ALWAYS_INLINE auto operator()(T x) const { return outer(inner(x)); }
+  };
+} // namespace detail
+
+  /**
+   * @brief Lazy chain of elementwise stages over an input array. The stages are composed when the pipeline is built
+   *        and run fused in a single sweep over the input when it is written to an output or reduced, each element
+   *        passes all stages in registers. Large inputs are processed in fixed-size chunks on the library-managed
+   *        thread pool. The pipeline refers to the input data, which must outlive it.
+   * @tparam S Input element type
+   * @tparam T Output element type of the last stage
+   * @tparam Op Composed operation type, called as op(S) and returning T
+   */
+  template<typename S, typename T, typename Op>
+  class Pipeline
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param data Input data
+       * @param size Number of elements
+       * @param dims Dimensions of the input, empty for inputs without dimensions
+       * @param op The composed operation
+       */
+      Pipeline(const S* data, std::size_t size, View<std::size_t> dims, Op op) noexcept
+      : mData{data}, mSize{size}, mDims{dims}, mOp{op}
+      {}
+
+      /**
+       * @brief Appends a conversion with MATLAB cast semantics (rounding and saturation of integers).
+       * @tparam U Target type
+       * @return The extended pipeline
+       */
+      template<typename U>
+      [[nodiscard]] auto convert() const noexcept
+      {
+        static_assert(detail::Numeric<U>, "unsupported element type");
+
+        return extend<U>(detail::ConvertOp<U>{});
+      }
+
+      /**
+       * @brief Appends a scaling by a scalar. Integers are scaled in double precision, rounded and saturated.
+       * @param alpha The scalar
+       * @return The extended pipeline
+       */
+      [[nodiscard]] auto scale(detail::ScalarType<T> alpha) const noexcept
+      {
+        return extend<T>(detail::ScaleOp<T>{alpha});
+      }
+
+      /**
+       * @brief Appends clamping to [lo, hi], NaN stays NaN.
+       * @param lo Lower bound
+       * @param hi Upper bound
+       * @return The extended pipeline
+       */
+      [[nodiscard]] auto clamp(T lo, T hi) const noexcept
+      {
+        static_assert(detail::RealNumeric<T>, "clamp requires a real element type");
+
+        return extend<T>(detail::ClampOp<T>{lo, hi});
+      }
+
+      /**
+       * @brief Appends a user-defined elementwise stage. It must not call the MATLAB API, it may be run in parallel.
+       * @tparam Fn Function type, called as fn(T)
+       * @param fn The function
+       * @return The extended pipeline
+       */
+      template<typename Fn>
+      [[nodiscard]] auto map(Fn fn) const
+      {
+        using U = std::remove_cvref_t<std::invoke_result_t<const Fn&, T>>;
+
+        static_assert(detail::Numeric<U>, "stage must return a numeric type");
+
+        return extend<U>(fn);
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Runs the pipeline into an existing output.
+       * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...), its element type must be T.
+       * @param out Output, may be the input if the element types match
+       */
+      template<typename Out>
+      void writeTo(Out&& out) const
+      {
+        auto dst = detail::toSpan(out);
+
+        static_assert(std::is_same_v<detail::ElementType<decltype(dst)>, T>, "output element type must match");
+
+        detail::checkSizes("matlabw:mx:algorithm:Pipeline:writeTo", dst.size(), mSize);
+        detail::transform(mOp, mSize, dst.data(), mData);
+      }
+
+      /**
+       * @brief Runs the pipeline into a new numeric array.
+       * @return The numeric array, of the input dimensions or a column vector for inputs without dimensions
+       */
+      [[nodiscard]] NumericArray<T> evaluate() const
+      {
+        NumericArray<T> out = mDims.empty() ? makeUninitNumericArray<T>(mSize, 1) : makeUninitNumericArray<T>(mDims);
+
+        writeTo(out);
+
+        return out;
+      }
+
+      /**
+       * @brief Runs the pipeline into a sum, without storing the intermediate values.
+       * @param options Reduction options, NanPolicy::abort throws without the index of the NaN value
+       * @return The sum, zero for empty input
+       */
+      [[nodiscard]] SumType<T> sum(const ReduceOptions& options = {}) const
+      {
+        using Acc = SumType<T>;
+
+        const S*   data    = mData;
+        const Op   op      = mOp;
+        const bool omitNan = (options.nanPolicy == NanPolicy::omit);
+
+        auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA
+        {
+          return detail::mapElement<Acc>(op(data[i]), omitNan, Acc{});
+        };
+
+        const Acc result = detail::sum<Acc>(map, mSize, options.summation);
+
+        if (options.nanPolicy == NanPolicy::abort && detail::isNan(result))
+        {
+          throw Exception{"matlabw:mx:algorithm:Pipeline:sum", "input contains NaN"};
+        }
+
+        return result;
+      }
+
+      /**
+       * @brief Runs the pipeline into a reduction with an associative operation. Large inputs are reduced in
+       *        fixed-size chunks in parallel and the chunk results are combined in order, so the result does not
+       *        depend on the number of threads.
+       * @tparam Acc Accumulator type
+       * @tparam Reduce Reduction type, called as reduce(Acc, Acc) and reduce(Acc, T) returning Acc
+       * @param init Initial value, the identity of the operation
+       * @param reduce The reduction
+       * @return The reduced value
+       */
+      template<typename Acc, typename Reduce>
+      [[nodiscard]] Acc reduce(Acc init, Reduce reduce) const
+      {
+        const S* data = mData;
+        const Op op   = mOp;
+
+        auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA { return op(data[i]); };
+
+        auto reduceRange = [&](std::size_t first, std::size_t last)
+        {
+          return detail::dispatch([&]() MATLABW_INLINE_LAMBDA
+          {
+            return detail::reduceBlock<Acc>(map, first, last, init, reduce);
+          });
+        };
+
+        if (mSize < detail::parallelMinSize)
+        {
+          return reduceRange(0, mSize);
+        }
+
+        std::vector<Acc> partials((mSize + detail::parallelChunkSize - 1) / detail::parallelChunkSize, init);
+
+        parallel::parallelFor(0, partials.size(), 1, [&](std::size_t chunk)
+        {
+          const std::size_t first = chunk * detail::parallelChunkSize;
+
+          partials[chunk] = reduceRange(first, std::min(first + detail::parallelChunkSize, mSize));
+        });
+
+        Acc result = init;
+
+        for (const Acc& partial : partials)
+        {
+          result = reduce(result, partial);
+        }
+
+        return result;
+      }
+    private:
+      /**
+       * @brief Appends a stage.
+       * @tparam U Output element type of the stage
+       * @tparam Stage Stage type
+       * @param stage The stage
+       * @return The extended pipeline
+       */
+      template<typename U, typename Stage>
+      [[nodiscard]] Pipeline<S, U, detail::ComposeOp<Stage, Op>> extend(Stage stage) const
+      {
+        return {mData, mSize, mDims, detail::ComposeOp<Stage, Op>{stage, mOp}};
+      }
+
+      const S*          mData; ///< Input data
+      std::size_t       mSize; ///< Number of elements
+      View<std::size_t> mDims; ///< Input dimensions
+      Op                mOp;   ///< Composed operation
+  };
+
+  /**
+   * @brief Starts a pipeline over an input array, e.g.
+   *        pipeline(in).convert<float>().scale(0.5f).clamp(0.f, 1.f).writeTo(out).
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input, must outlive the pipeline
+   * @return The pipeline
+   */
+  template<typename In>
+  [[nodiscard]] auto pipeline(const In& in) noexcept
+  {
+    auto src = detail::toSpan(in);
+
+    using S = detail::ElementType<decltype(src)>;
+
+    static_assert(detail::Numeric<S>, "unsupported element type");
+
+    View<std::size_t> dims{};
+
+    if constexpr (requires { in.getDims(); })
+    {
+      dims = in.getDims();
+    }
+
+    return Pipeline<S, S, detail::IdentityOp>{src.data(), src.size(), dims, detail::IdentityOp{}};
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_PIPELINE_HPP */
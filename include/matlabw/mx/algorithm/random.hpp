@@ -0,0 +1,132 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ALGORITHM_RANDOM_HPP
+#define MATLABW_MX_ALGORITHM_RANDOM_HPP
+
+#include "../detail/include.hpp"
+
+#include <algorithm>
+
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../random.hpp"
+
+namespace matlabw::mx::algorithm
+{
+namespace detail
+{
+  /**
+   * @brief Fills a span with values of a distribution. Value i is computed from block i / Dist::count of a range
+   *        reserved from the generator, so the values do not depend on the number of threads. The blocks are split
+   *        between the threads of the library-managed thread pool for large spans and the loop over the blocks is
+   *        compiled for the best instruction set.
+   * @tparam T Value type
+   * @tparam Dist Distribution type
+   * @param out The output
+   * @param rng The generator, continues after the reserved blocks
+   * @param dist The distribution
+   */
+  template<typename T, typename Dist>
+  void generateBlocks(std::span<T> out, Philox& rng, const Dist& dist)
+  {
+    constexpr std::size_t count = Dist::count;
+
+    const std::size_t blocks = out.size() / count;
+    const std::size_t tail   = out.size() % count;
+    const auto        range  = rng.reserve(blocks + (tail != 0 ? 1 : 0));
+    T* const          data   = out.data();
+
+    forChunks(blocks, [=](std::size_t first, std::size_t last) MATLABW_INLINE_LAMBDA
+    {
+      for (std::size_t b{first}; b < last; ++b)
+      {
+        dist(range(b), data + b * count);
+      }
+    });
+
+    if (tail != 0)
+    {
+      T values[count]{};
+
+      dist(range(blocks), values);
+      std::copy_n(values, tail, data + blocks * count);
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Fills an array with uniform values in the open interval (0, 1), as MATLAB rand.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...) of float or double
+   * @param out The output
+   * @param rng The generator
+   */
+  template<typename Out>
+  void fillUniform(Out&& out, Philox& rng)
+  {
+    auto dst = detail::toSpan(out);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    detail::generateBlocks(dst, rng, mx::detail::UniformDistribution<T>{});
+  }
+
+  /**
+   * @brief Fills an array with normal values, as MATLAB randn for the default mean and standard deviation.
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...) of float or double
+   * @param out The output
+   * @param rng The generator
+   * @param mean The mean
+   * @param sigma The standard deviation
+   */
+  template<typename Out>
+  void fillNormal(Out&& out, Philox& rng, detail::ElementOf<Out> mean = 0, detail::ElementOf<Out> sigma = 1)
+  {
+    auto dst = detail::toSpan(out);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    detail::generateBlocks(dst, rng, mx::detail::NormalDistribution<T>{mean, sigma});
+  }
+
+  /**
+   * @brief Fills an array with uniform integers from lo to hi, as MATLAB randi([lo, hi], ...).
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...) of an integer or floating point type
+   * @param out The output
+   * @param rng The generator
+   * @param lo The smallest value
+   * @param hi The largest value, at most 2^32 values in total
+   */
+  template<typename Out>
+  void fillIntegers(Out&& out, Philox& rng, std::int64_t lo, std::int64_t hi)
+  {
+    auto dst = detail::toSpan(out);
+
+    using T = detail::ElementType<decltype(dst)>;
+
+    detail::generateBlocks(dst, rng, mx::detail::makeIntegerDistribution<T>(lo, hi));
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_RANDOM_HPP */
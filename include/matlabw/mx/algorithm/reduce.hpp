@@ -0,0 +1,935 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_REDUCE_HPP
+#define MATLABW_MX_ALGORITHM_REDUCE_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Handling of NaN values by reductions.
+  enum class NanPolicy
+  {
+    propagate, ///< NaN values propagate to the result
+    omit,      ///< NaN values are skipped, as MATLAB's 'omitnan'
+    abort,     ///< An exception with the index of the first NaN value is thrown
+  };
+
+  /// @brief Summation algorithm.
+  enum class Summation
+  {
+    naive,    ///< Single pass with multiple accumulators, the fastest
+    pairwise, ///< Pairwise summation of blocks, the error grows with log(n)
+    kahan,    ///< Compensated summation, the error does not grow with n (defeated by -ffast-math)
+  };
+
+  /// @brief Options of a reduction.
+  struct ReduceOptions
+  {
+    NanPolicy nanPolicy{NanPolicy::propagate}; ///< Handling of NaN values
+    Summation summation{Summation::pairwise};  ///< Summation algorithm
+  };
+
+  /**
+   * @brief Result of min and max.
+   * @tparam T Element type
+   */
+  template<typename T>
+  struct Extremum
+  {
+    T           value{}; ///< The value
+    std::size_t index{}; ///< The zero-based linear index of the value
+  };
+
+  /**
+   * @brief Result type of sums, products and means. Integers are accumulated in double.
+   * @tparam T Element type
+   */
+  template<typename T>
+  using SumType = detail::ScalarType<T>;
+
+  /**
+   * @brief Result type of norms and variances.
+   * @tparam T Element type
+   */
+  template<typename T>
+  using NormType = detail::RealType<SumType<T>>;
+
+namespace detail
+{
+  /// @brief Number of independent accumulators, hides the latency of the vector units.
+  inline constexpr std::size_t accumulatorCount{8};
+
+  /// @brief Block size of pairwise summation.
+  inline constexpr std::size_t pairwiseBlockSize{1024};
+
+  /// @brief Maximum depth of pairwise summation.
+  inline constexpr std::size_t pairwiseMaxDepth{64};
+
+  /**
+   * @brief Reduces a range with multiple accumulators.
+   * @tparam Acc Accumulator type
+   * @tparam Map Element access, called as map(i)
+   * @tparam Op Reduction operation, called as op(acc, value)
+   * @param map The element access
+   * @param first First index
+   * @param last Past the end index
+   * @param init Initial value of the accumulators
+   * @param op The reduction operation
+   * @return The reduced value
+   */
+  template<typename Acc, typename Map, typename Op>
+  MATLABW_ALWAYS_INLINE Acc reduceBlock(Map& map, std::size_t first, std::size_t last, Acc init, Op op)
+  {
+    Acc acc[accumulatorCount];
+
+    for (std::size_t k{}; k < accumulatorCount; ++k)
+    {
+      acc[k] = init;
+    }
+
+    std::size_t i{first};
+
+    for (; i + accumulatorCount <= last; i += accumulatorCount)
+    {
+      for (std::size_t k{}; k < accumulatorCount; ++k)
+      {
+        acc[k] = op(acc[k], map(i + k));
+      }
+    }
+
+    for (; i < last; ++i)
+    {
+      acc[0] = op(acc[0], map(i));
+    }
+
+    for (std::size_t width{accumulatorCount / 2}; width > 0; width /= 2)
+    {
+      for (std::size_t k{}; k < width; ++k)
+      {
+        acc[k] = op(acc[k], acc[k + width]);
+      }
+    }
+
+    return acc[0];
+  }
+
+  /// @brief Addition used by the summation kernels.
+  struct PlusOp
+  {
+    template<typename T>
+    MATLABW_ALWAYS_INLINE T operator()(T a, T b) const noexcept { return a + b; }
+  };
+
+  /**
+   * @brief Pairwise summation, blocks are summed with multiple accumulators and the block sums are combined as
+   *        a binary tree.
+   * @tparam Acc Accumulator type
+   * @tparam Map Element access, called as map(i)
+   * @param map The element access
+   * @param n Number of elements
+   * @return The sum
+   */
+  template<typename Acc, typename Map>
+  MATLABW_ALWAYS_INLINE Acc sumPairwise(Map& map, std::size_t n)
+  {
+    Acc         stack[pairwiseMaxDepth];
+    std::size_t depth{};
+    std::size_t blocks{};
+
+    for (std::size_t first{}; first < n; first += pairwiseBlockSize)
+    {
+      Acc sum = reduceBlock<Acc>(map, first, std::min(first + pairwiseBlockSize, n), Acc{}, PlusOp{});
+
+      // Merge one pair for every trailing zero bit of the block count.
+      for (std::size_t b{++blocks}; (b & 1) == 0; b >>= 1)
+      {
+        sum = stack[--depth] + sum;
+      }
+
+      stack[depth++] = sum;
+    }
+
+    Acc total{};
+
+    while (depth > 0)
+    {
+      total = stack[--depth] + total;
+    }
+
+    return total;
+  }
+
+  /**
+   * @brief Kahan summation with multiple compensated accumulators.
+   * @tparam Acc Accumulator type
+   * @tparam Map Element access, called as map(i)
+   * @param map The element access
+   * @param n Number of elements
+   * @return The sum
+   */
+  template<typename Acc, typename Map>
+  MATLABW_ALWAYS_INLINE Acc sumKahan(Map& map, std::size_t n)
+  {
+    Acc sum[accumulatorCount]{};
+    Acc comp[accumulatorCount]{};
+
+    auto step = [&](std::size_t k, Acc value) MATLABW_INLINE_LAMBDA
+    {
+      const Acc y = value - comp[k];
+      const Acc t = sum[k] + y;
+
+      comp[k] = (t - sum[k]) - y;
+      sum[k]  = t;
+    };
+
+    std::size_t i{};
+
+    for (; i + accumulatorCount <= n; i += accumulatorCount)
+    {
+      for (std::size_t k{}; k < accumulatorCount; ++k)
+      {
+        step(k, map(i + k));
+      }
+    }
+
+    for (; i < n; ++i)
+    {
+      step(0, map(i));
+    }
+
+    for (std::size_t k{1}; k < accumulatorCount; ++k)
+    {
+      step(0, sum[k]);
+      step(0, -comp[k]);
+    }
+
+    return sum[0];
+  }
+
+  /**
+   * @brief Sums mapped elements with the selected algorithm on the calling thread, dispatched to the best instruction
+   *        set.
+   * @tparam Acc Accumulator type
+   * @tparam Map Element access, called as map(i), should be marked with MATLABW_INLINE_LAMBDA
+   * @param map The element access
+   * @param n Number of elements
+   * @param summation The summation algorithm
+   * @return The sum
+   */
+  template<typename Acc, typename Map>
+  [[nodiscard]] Acc sumSerial(Map map, std::size_t n, Summation summation)
+  {
+    switch (summation)
+    {
+    case Summation::naive:
+      return dispatch([&]() MATLABW_INLINE_LAMBDA { return reduceBlock<Acc>(map, 0, n, Acc{}, PlusOp{}); });
+    case Summation::kahan:
+      return dispatch([&]() MATLABW_INLINE_LAMBDA { return sumKahan<Acc>(map, n); });
+    default:
+      return dispatch([&]() MATLABW_INLINE_LAMBDA { return sumPairwise<Acc>(map, n); });
+    }
+  }
+
+  /**
+   * @brief Sums mapped elements with the selected algorithm in parallel. The input is split into fixed-size chunks
+   *        summed by the threads of the library-managed thread pool, the chunk sums are combined with the same
+   *        algorithm.
+   * @tparam Acc Accumulator type
+   * @tparam Map Element access, called as map(i), should be marked with MATLABW_INLINE_LAMBDA
+   * @param map The element access
+   * @param n Number of elements
+   * @param summation The summation algorithm
+   * @return The sum
+   */
+  template<typename Acc, typename Map>
+  [[nodiscard]] Acc sumParallel(Map map, std::size_t n, Summation summation)
+  {
+    std::vector<Acc> partials((n + parallelChunkSize - 1) / parallelChunkSize);
+
+    parallel::parallelFor(0, partials.size(), 1, [&](std::size_t chunk)
+    {
+      const std::size_t first = chunk * parallelChunkSize;
+
+      auto chunkMap = [&map, first](std::size_t i) MATLABW_INLINE_LAMBDA { return map(first + i); };
+
+      partials[chunk] = sumSerial<Acc>(chunkMap, std::min(parallelChunkSize, n - first), summation);
+    });
+
+    const Acc* data = partials.data();
+
+    return sumSerial<Acc>([data](std::size_t i) MATLABW_INLINE_LAMBDA { return data[i]; }, partials.size(), summation);
+  }
+
+  /**
+   * @brief Sums mapped elements with the selected algorithm, inputs of at least parallelMinSize elements in parallel.
+   * @tparam Acc Accumulator type
+   * @tparam Map Element access, called as map(i), should be marked with MATLABW_INLINE_LAMBDA
+   * @param map The element access
+   * @param n Number of elements
+   * @param summation The summation algorithm
+   * @return The sum
+   */
+  template<typename Acc, typename Map>
+  [[nodiscard]] Acc sum(Map map, std::size_t n, Summation summation)
+  {
+    if (n < parallelMinSize)
+    {
+      return sumSerial<Acc>(map, n, summation);
+    }
+
+    return sumParallel<Acc>(map, n, summation);
+  }
+
+  /**
+   * @brief Counts the NaN values.
+   * @tparam T Element type
+   * @param data Data pointer
+   * @param n Number of elements
+   * @return The number of NaN values
+   */
+  template<typename T>
+  [[nodiscard]] std::size_t countNan(const T* data, std::size_t n)
+  {
+    if constexpr (isInteger<T>)
+    {
+      return 0;
+    }
+    else
+    {
+      auto map = [data](std::size_t i) MATLABW_INLINE_LAMBDA { return static_cast<std::size_t>(isNan(data[i])); };
+
+      return sum<std::size_t>(map, n, Summation::naive);
+    }
+  }
+
+  /**
+   * @brief Throws an exception if any of the arrays contains a NaN value.
+   * @tparam T Element types
+   * @param id Error identifier
+   * @param n Number of elements
+   * @param data Data pointers
+   */
+  template<typename... T>
+  void throwOnNan(const char* id, std::size_t n, const T*... data)
+  {
+    for (std::size_t i{}; i < n; ++i)
+    {
+      if ((isNan(data[i]) || ...))
+      {
+        throw Exception{id, "NaN value at index " + std::to_string(i)};
+      }
+    }
+  }
+
+  /**
+   * @brief Maps an element to the accumulator type, NaN values are optionally replaced.
+   * @tparam Acc Accumulator type
+   * @tparam T Element type
+   * @param x The element
+   * @param omitNan Replace NaN values?
+   * @param replacement The replacement of NaN values
+   * @return The mapped value
+   */
+  template<typename Acc, typename T>
+  MATLABW_ALWAYS_INLINE Acc mapElement(T x, bool omitNan, Acc replacement) noexcept
+  {
+    if constexpr (isInteger<T>)
+    {
+      return static_cast<Acc>(x);
+    }
+    else
+    {
+      return (omitNan && isNan(x)) ? replacement : static_cast<Acc>(x);
+    }
+  }
+
+  /**
+   * @brief Squared magnitude of a value.
+   * @tparam R Real result type
+   * @tparam T Element type
+   * @param x The value
+   * @return The squared magnitude
+   */
+  template<typename R, typename T>
+  MATLABW_ALWAYS_INLINE R squaredMagnitude(T x) noexcept
+  {
+    if constexpr (isComplex<T>)
+    {
+      return static_cast<R>(x.real()) * static_cast<R>(x.real()) + static_cast<R>(x.imag()) * static_cast<R>(x.imag());
+    }
+    else
+    {
+      return static_cast<R>(x) * static_cast<R>(x);
+    }
+  }
+
+  /**
+   * @brief Product of the conjugate of a and b, written out to avoid the library call of std::complex.
+   * @tparam Acc Accumulator type
+   * @tparam T Element type
+   * @param a First value
+   * @param b Second value
+   * @return The product
+   */
+  template<typename Acc, typename T>
+  MATLABW_ALWAYS_INLINE Acc conjugateProduct(T a, T b) noexcept
+  {
+    if constexpr (isComplex<T>)
+    {
+      return Acc{a.real() * b.real() + a.imag() * b.imag(), a.real() * b.imag() - a.imag() * b.real()};
+    }
+    else
+    {
+      return static_cast<Acc>(a) * static_cast<Acc>(b);
+    }
+  }
+
+  /**
+   * @brief Compares complex values as MATLAB does, by magnitude and then by phase angle.
+   * @tparam T Complex type
+   * @param a First value
+   * @param b Second value
+   * @return True if a is less than b
+   */
+  template<typename T>
+  [[nodiscard]] bool complexLess(T a, T b) noexcept
+  {
+    const auto absA = algorithm::detail::abs(a);
+    const auto absB = algorithm::detail::abs(b);
+
+    return (absA < absB) || (absA == absB && std::arg(a) < std::arg(b));
+  }
+
+  /**
+   * @brief Finds the minimum or maximum.
+   * @tparam greater Find the maximum?
+   * @tparam T Element type
+   * @param id Error identifier
+   * @param data Data pointer
+   * @param n Number of elements
+   * @param nanPolicy Handling of NaN values
+   * @return The extremum
+   */
+  template<bool greater, typename T>
+  [[nodiscard]] Extremum<T> extremum(const char* id, const T* data, std::size_t n, NanPolicy nanPolicy)
+  {
+    if (n == 0)
+    {
+      throw Exception{id, "input must not be empty"};
+    }
+
+    if constexpr (isComplex<T>)
+    {
+      std::size_t best{n};
+      std::size_t firstNan{n};
+
+      for (std::size_t i{}; i < n; ++i)
+      {
+        if (isNan(data[i]))
+        {
+          firstNan = std::min(firstNan, i);
+        }
+        else if (best == n || (greater ? complexLess(data[best], data[i]) : complexLess(data[i], data[best])))
+        {
+          best = i;
+        }
+      }
+
+      if (firstNan != n && nanPolicy != NanPolicy::omit)
+      {
+        if (nanPolicy == NanPolicy::abort)
+        {
+          throw Exception{id, "NaN value at index " + std::to_string(firstNan)};
+        }
+
+        return Extremum<T>{data[firstNan], firstNan};
+      }
+
+      return (best == n) ? Extremum<T>{data[0], 0} : Extremum<T>{data[best], best};
+    }
+    else
+    {
+      struct Acc
+      {
+        T    value; ///< Current extremum
+        bool nan;   ///< NaN seen
+      };
+
+      constexpr T init = std::numeric_limits<T>::has_infinity
+                       ? (greater ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity())
+                       : (greater ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max());
+
+      // NaN never compares, so it never replaces the current extremum.
+      auto kernel = [&]() MATLABW_INLINE_LAMBDA
+      {
+        T    value[accumulatorCount];
+        bool nan[accumulatorCount]{};
+
+        for (std::size_t k{}; k < accumulatorCount; ++k)
+        {
+          value[k] = init;
+        }
+
+        auto step = [&](std::size_t k, T x) MATLABW_INLINE_LAMBDA
+        {
+          value[k] = (greater ? (x > value[k]) : (x < value[k])) ? x : value[k];
+          nan[k]   = nan[k] | isNan(x);
+        };
+
+        std::size_t i{};
+
+        for (; i + accumulatorCount <= n; i += accumulatorCount)
+        {
+          for (std::size_t k{}; k < accumulatorCount; ++k)
+          {
+            step(k, data[i + k]);
+          }
+        }
+
+        for (; i < n; ++i)
+        {
+          step(0, data[i]);
+        }
+
+        for (std::size_t k{1}; k < accumulatorCount; ++k)
+        {
+          step(0, value[k]);
+          nan[0] = nan[0] | nan[k];
+        }
+
+        return Acc{value[0], nan[0]};
+      };
+
+      const Acc acc = dispatch(kernel);
+
+      if (acc.nan && nanPolicy != NanPolicy::omit)
+      {
+        const auto firstNan = static_cast<std::size_t>(std::find_if(data, data + n, [](T x) { return isNan(x); }) - data);
+
+        if (nanPolicy == NanPolicy::abort)
+        {
+          throw Exception{id, "NaN value at index " + std::to_string(firstNan)};
+        }
+
+        return Extremum<T>{data[firstNan], firstNan};
+      }
+
+      const auto index = static_cast<std::size_t>(std::find(data, data + n, acc.value) - data);
+
+      // All values are NaN, MATLAB returns the first one.
+      if (index == n)
+      {
+        return Extremum<T>{data[0], 0};
+      }
+
+      return Extremum<T>{acc.value, index};
+    }
+  }
+
+  /**
+   * @brief Gets the span of an input of a reduction and checks its element type.
+   * @tparam In Input type
+   * @param in The input
+   * @return The span
+   */
+  template<typename In>
+  [[nodiscard]] auto toInputSpan(const In& in) noexcept
+  {
+    auto span = toSpan(in);
+
+    static_assert(Numeric<ElementType<decltype(span)>>, "unsupported element type");
+
+    return span;
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes the sum of all elements.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input
+   * @param options Reduction options
+   * @return The sum, zero for empty input
+   */
+  template<typename In>
+  [[nodiscard]] SumType<detail::ElementOf<In>> sum(const In& in, const ReduceOptions& options = {})
+  {
+    using T   = detail::ElementOf<In>;
+    using Acc = SumType<T>;
+
+    const auto src     = detail::toInputSpan(in);
+    const T*   data    = src.data();
+    const bool omitNan = (options.nanPolicy == NanPolicy::omit);
+
+    auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA { return detail::mapElement<Acc>(data[i], omitNan, Acc{}); };
+
+    const Acc result = detail::sum<Acc>(map, src.size(), options.summation);
+
+    if (options.nanPolicy == NanPolicy::abort && detail::isNan(result))
+    {
+      detail::throwOnNan("matlabw:mx:algorithm:sum", src.size(), data);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Computes the product of all elements.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input
+   * @param options Reduction options, the summation algorithm is ignored
+   * @return The product, one for empty input
+   */
+  template<typename In>
+  [[nodiscard]] SumType<detail::ElementOf<In>> prod(const In& in, const ReduceOptions& options = {})
+  {
+    using T   = detail::ElementOf<In>;
+    using Acc = SumType<T>;
+
+    const auto src     = detail::toInputSpan(in);
+    const T*   data    = src.data();
+    const bool omitNan = (options.nanPolicy == NanPolicy::omit);
+
+    auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA { return detail::mapElement<Acc>(data[i], omitNan, Acc{1}); };
+    auto op  = [](Acc a, Acc b) MATLABW_INLINE_LAMBDA
+    {
+      if constexpr (detail::isComplex<Acc>)
+      {
+        // Without the NaN recovery of std::complex so that the loop vectorizes.
+        return Acc{a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+      }
+      else
+      {
+        return a * b;
+      }
+    };
+
+    const Acc result = detail::dispatch([&]() MATLABW_INLINE_LAMBDA
+    {
+      return detail::reduceBlock<Acc>(map, 0, src.size(), Acc{1}, op);
+    });
+
+    if (options.nanPolicy == NanPolicy::abort && detail::isNan(result))
+    {
+      detail::throwOnNan("matlabw:mx:algorithm:prod", src.size(), data);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Finds the minimum. Complex values are compared by magnitude and then by phase angle.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input, must not be empty
+   * @param nanPolicy Handling of NaN values, if all values are NaN the first one is returned
+   * @return The minimum and the index of its first occurrence
+   */
+  template<typename In>
+  [[nodiscard]] Extremum<detail::ElementOf<In>> min(const In& in, NanPolicy nanPolicy = NanPolicy::omit)
+  {
+    const auto src = detail::toInputSpan(in);
+
+    return detail::extremum<false>("matlabw:mx:algorithm:min", src.data(), src.size(), nanPolicy);
+  }
+
+  /**
+   * @brief Finds the maximum. Complex values are compared by magnitude and then by phase angle.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input, must not be empty
+   * @param nanPolicy Handling of NaN values, if all values are NaN the first one is returned
+   * @return The maximum and the index of its first occurrence
+   */
+  template<typename In>
+  [[nodiscard]] Extremum<detail::ElementOf<In>> max(const In& in, NanPolicy nanPolicy = NanPolicy::omit)
+  {
+    const auto src = detail::toInputSpan(in);
+
+    return detail::extremum<true>("matlabw:mx:algorithm:max", src.data(), src.size(), nanPolicy);
+  }
+
+  /**
+   * @brief Computes the dot product, the first input is conjugated for complex values as in MATLAB.
+   * @tparam InA First input array type
+   * @tparam InB Second input array type
+   * @param a First input
+   * @param b Second input
+   * @param options Reduction options, omitting NaN values skips the pairs with a NaN
+   * @return The dot product
+   */
+  template<typename InA, typename InB>
+  [[nodiscard]] SumType<detail::ElementOf<InA>> dot(const InA& a, const InB& b, const ReduceOptions& options = {})
+  {
+    using T   = detail::ElementOf<InA>;
+    using Acc = SumType<T>;
+
+    static_assert(std::is_same_v<T, detail::ElementOf<InB>>, "element types must match");
+
+    const auto srcA    = detail::toInputSpan(a);
+    const auto srcB    = detail::toInputSpan(b);
+    const T*   dataA   = srcA.data();
+    const T*   dataB   = srcB.data();
+    const bool omitNan = (options.nanPolicy == NanPolicy::omit);
+
+    detail::checkSizes("matlabw:mx:algorithm:dot", srcA.size(), srcB.size());
+
+    auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      const Acc product = detail::conjugateProduct<Acc>(dataA[i], dataB[i]);
+
+      if constexpr (detail::isInteger<T>)
+      {
+        return product;
+      }
+      else
+      {
+        return (omitNan && (detail::isNan(dataA[i]) || detail::isNan(dataB[i]))) ? Acc{} : product;
+      }
+    };
+
+    const Acc result = detail::sum<Acc>(map, srcA.size(), options.summation);
+
+    if (options.nanPolicy == NanPolicy::abort && detail::isNan(result))
+    {
+      detail::throwOnNan("matlabw:mx:algorithm:dot", srcA.size(), dataA, dataB);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Computes the dot product without conjugation, sum(a .* b), as BLAS zdotu.
+   * @tparam InA First input array type
+   * @tparam InB Second input array type
+   * @param a First input
+   * @param b Second input
+   * @param options Reduction options, omitting NaN values skips the pairs with a NaN
+   * @return The dot product
+   */
+  template<typename InA, typename InB>
+  [[nodiscard]] SumType<detail::ElementOf<InA>> dotUnconjugated(const InA& a, const InB& b,
+                                                                const ReduceOptions& options = {})
+  {
+    using T   = detail::ElementOf<InA>;
+    using Acc = SumType<T>;
+
+    static_assert(std::is_same_v<T, detail::ElementOf<InB>>, "element types must match");
+
+    const auto srcA    = detail::toInputSpan(a);
+    const auto srcB    = detail::toInputSpan(b);
+    const T*   dataA   = srcA.data();
+    const T*   dataB   = srcB.data();
+    const bool omitNan = (options.nanPolicy == NanPolicy::omit);
+
+    detail::checkSizes("matlabw:mx:algorithm:dotUnconjugated", srcA.size(), srcB.size());
+
+    auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      const Acc product = detail::multiply(static_cast<Acc>(dataA[i]), static_cast<Acc>(dataB[i]));
+
+      if constexpr (detail::isInteger<T>)
+      {
+        return product;
+      }
+      else
+      {
+        return (omitNan && (detail::isNan(dataA[i]) || detail::isNan(dataB[i]))) ? Acc{} : product;
+      }
+    };
+
+    const Acc result = detail::sum<Acc>(map, srcA.size(), options.summation);
+
+    if (options.nanPolicy == NanPolicy::abort && detail::isNan(result))
+    {
+      detail::throwOnNan("matlabw:mx:algorithm:dotUnconjugated", srcA.size(), dataA, dataB);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Computes the Euclidean norm. Falls back to a scaled second pass if the sum of squares overflows or
+   *        underflows.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input
+   * @param options Reduction options
+   * @return The norm
+   */
+  template<typename In>
+  [[nodiscard]] NormType<detail::ElementOf<In>> norm2(const In& in, const ReduceOptions& options = {})
+  {
+    using T = detail::ElementOf<In>;
+    using R = NormType<T>;
+
+    const auto src     = detail::toInputSpan(in);
+    const T*   data    = src.data();
+    const bool omitNan = (options.nanPolicy == NanPolicy::omit);
+
+    auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      return (omitNan && detail::isNan(data[i])) ? R{} : detail::squaredMagnitude<R>(data[i]);
+    };
+
+    const R sumOfSquares = detail::sum<R>(map, src.size(), options.summation);
+
+    if (detail::isNan(sumOfSquares))
+    {
+      if (options.nanPolicy == NanPolicy::abort)
+      {
+        detail::throwOnNan("matlabw:mx:algorithm:norm2", src.size(), data);
+      }
+
+      return sumOfSquares;
+    }
+
+    if (sumOfSquares >= std::numeric_limits<R>::min() && sumOfSquares < std::numeric_limits<R>::infinity())
+    {
+      return std::sqrt(sumOfSquares);
+    }
+
+    // Scale by the largest magnitude, NaN values never compare greater.
+    auto magnitude = [=](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      if constexpr (detail::isComplex<T>)
+      {
+        return std::max(std::abs(data[i].real()), std::abs(data[i].imag()));
+      }
+      else
+      {
+        return std::abs(static_cast<R>(data[i]));
+      }
+    };
+
+    const R scale = detail::dispatch([&]() MATLABW_INLINE_LAMBDA
+    {
+      return detail::reduceBlock<R>(magnitude, 0, src.size(), R{}, [](R a, R b) MATLABW_INLINE_LAMBDA
+      {
+        return (b > a) ? b : a;
+      });
+    });
+
+    if (scale == R{} || scale == std::numeric_limits<R>::infinity())
+    {
+      return scale;
+    }
+
+    auto scaled = [=](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      if constexpr (detail::isComplex<T>)
+      {
+        return (omitNan && detail::isNan(data[i])) ? R{} : detail::squaredMagnitude<R>(data[i] / scale);
+      }
+      else
+      {
+        return (omitNan && detail::isNan(data[i])) ? R{} : detail::squaredMagnitude<R>(static_cast<R>(data[i]) / scale);
+      }
+    };
+
+    return scale * std::sqrt(detail::sum<R>(scaled, src.size(), options.summation));
+  }
+
+  /**
+   * @brief Computes the mean.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input
+   * @param options Reduction options, omitting NaN values excludes them from the count
+   * @return The mean, NaN for empty input
+   */
+  template<typename In>
+  [[nodiscard]] SumType<detail::ElementOf<In>> mean(const In& in, const ReduceOptions& options = {})
+  {
+    using T   = detail::ElementOf<In>;
+    using Acc = SumType<T>;
+    using R   = NormType<T>;
+
+    const auto src   = detail::toInputSpan(in);
+    const Acc  total = algorithm::sum(in, options);
+
+    std::size_t count{src.size()};
+
+    if (options.nanPolicy == NanPolicy::omit)
+    {
+      count -= detail::countNan(src.data(), src.size());
+    }
+
+    return (count == 0) ? Acc{std::numeric_limits<R>::quiet_NaN()} : total / static_cast<R>(count);
+  }
+
+  /**
+   * @brief Computes the variance with two passes.
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param in Input
+   * @param population Normalize by n instead of n - 1, as MATLAB's weight 1
+   * @param options Reduction options, omitting NaN values excludes them from the count
+   * @return The variance, zero for a single element and NaN for empty input
+   */
+  template<typename In>
+  [[nodiscard]] NormType<detail::ElementOf<In>>
+  variance(const In& in, bool population = false, const ReduceOptions& options = {})
+  {
+    using T   = detail::ElementOf<In>;
+    using Acc = SumType<T>;
+    using R   = NormType<T>;
+
+    const auto src     = detail::toInputSpan(in);
+    const T*   data    = src.data();
+    const bool omitNan = (options.nanPolicy == NanPolicy::omit);
+    const Acc  center  = algorithm::mean(in, options);
+
+    std::size_t count{src.size()};
+
+    if (omitNan)
+    {
+      count -= detail::countNan(data, src.size());
+    }
+
+    if (count == 0)
+    {
+      return std::numeric_limits<R>::quiet_NaN();
+    }
+
+    auto map = [=](std::size_t i) MATLABW_INLINE_LAMBDA
+    {
+      return (omitNan && detail::isNan(data[i])) ? R{} : detail::squaredMagnitude<R>(static_cast<Acc>(data[i]) - center);
+    };
+
+    const R sumOfSquares = detail::sum<R>(map, src.size(), options.summation);
+
+    if (count == 1)
+    {
+      return detail::isNan(sumOfSquares) ? sumOfSquares : R{};
+    }
+
+    return sumOfSquares / static_cast<R>(population ? count : count - 1);
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_REDUCE_HPP */
@@ -0,0 +1,804 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ALGORITHM_SCAN_HPP
+#define MATLABW_MX_ALGORITHM_SCAN_HPP
+
+#include "../detail/include.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define MATLABW_SCAN_SSE2
+#endif
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "elementwise.hpp"
+#include "forEachColumn.hpp"
+#include "reduce.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Options of a cumulative operation.
+  struct ScanOptions
+  {
+    std::optional<std::size_t> dim{};       ///< Zero-based dimension, the first non-singleton one if not set
+    std::optional<NanPolicy>   nanPolicy{}; ///< Handling of NaN values, MATLAB's default of the operation if not set
+  };
+
+namespace detail
+{
+  /// @brief Number of elements of a row block scanned by one task of a scan along a non-leading dimension.
+  inline constexpr std::size_t scanStridedBlockSize{1024};
+
+  /// @brief Layout of a scan, count blocks of length elements spaced by stride, each block holds stride scans.
+  struct ScanShape
+  {
+    std::size_t stride{}; ///< Distance of consecutive elements of a scan
+    std::size_t length{}; ///< Number of elements of a scan
+    std::size_t count{};  ///< Number of outer blocks
+  };
+
+  /**
+   * @brief Gets the dimension of a scan.
+   * @param dims The dimensions
+   * @param dim Zero-based dimension, the first non-singleton one if not set
+   * @return The dimension
+   */
+  [[nodiscard]] inline std::size_t getScanDim(View<std::size_t> dims, std::optional<std::size_t> dim) noexcept
+  {
+    if (dim.has_value())
+    {
+      return *dim;
+    }
+
+    std::size_t d{};
+
+    while (d + 1 < dims.size() && dims[d] == 1)
+    {
+      ++d;
+    }
+
+    return d;
+  }
+
+  /**
+   * @brief Gets the layout of a scan along a dimension, folds the dimensions below and above it, so any rank works.
+   * @param dims The dimensions
+   * @param dim Zero-based dimension, the first non-singleton one if not set
+   * @return The layout, a dimension beyond the rank scans each element alone
+   */
+  [[nodiscard]] inline ScanShape getScanShape(View<std::size_t> dims, std::optional<std::size_t> dim) noexcept
+  {
+    const std::size_t d     = getScanDim(dims, dim);
+    const std::size_t split = std::min(d, dims.size());
+
+    const std::size_t stride = std::accumulate(dims.begin(), dims.begin() + split, std::size_t{1}, std::multiplies{});
+    const std::size_t length = (d < dims.size()) ? dims[d] : 1;
+    const std::size_t outer  = (d < dims.size())
+                             ? std::accumulate(dims.begin() + d + 1, dims.end(), std::size_t{1}, std::multiplies{})
+                             : 1;
+
+    return ScanShape{stride, length, (stride * length != 0) ? outer : 0};
+  }
+
+  /**
+   * @brief Gets the layout of a scan of an operand, spans are column vectors.
+   * @param in The operand
+   * @param dim Zero-based dimension, the first non-singleton one if not set
+   * @return The layout
+   */
+  template<typename In>
+  [[nodiscard]] ScanShape getScanShape(const In& in, std::optional<std::size_t> dim)
+  {
+    if constexpr (DimensionedArray<In>)
+    {
+      return getScanShape(in.getDims(), dim);
+    }
+    else
+    {
+      const std::array<std::size_t, 2> dims{toSpan(in).size(), 1};
+
+      return getScanShape(View<std::size_t>{dims}, dim);
+    }
+  }
+
+  /**
+   * @brief Cumulative sum, integers saturate at every step as in MATLAB.
+   * @tparam T Element type
+   * @tparam omit True to treat NaN as zero
+   */
+  template<typename T, bool omit>
+  struct ScanSum
+  {
+    static constexpr bool isSum{true};                  ///< Enables the in-register scan
+    static constexpr bool omitNan{omit};                ///< NaN values are skipped
+    static constexpr bool associative{!isInteger<T>};   ///< Saturation makes integer sums order dependent
+
+    /// @brief Gets the identity, -0 keeps the sign of a leading -0 as the serial sum does.
+    [[nodiscard]] static constexpr T identity() noexcept
+    {
+      if constexpr (isInteger<T>)
+      {
+        return T{};
+      }
+      else
+      {
+        return T{} * RealType<T>{-1};
+      }
+    }
+
+    MATLABW_ALWAYS_INLINE static T map(T x) noexcept { return (omit && isNan(x)) ? T{} : x; }
+
+    MATLABW_ALWAYS_INLINE static T combine(T a, T b) noexcept { return add(a, b); }
+  };
+
+  /**
+   * @brief Cumulative product, integers saturate at every step as in MATLAB.
+   * @tparam T Element type
+   * @tparam omit True to treat NaN as one
+   */
+  template<typename T, bool omit>
+  struct ScanProduct
+  {
+    static constexpr bool isSum{false};                 ///< Enables the in-register scan
+    static constexpr bool omitNan{omit};                ///< NaN values are skipped
+    static constexpr bool associative{!isInteger<T>};   ///< Saturation makes integer products order dependent
+
+    [[nodiscard]] static constexpr T identity() noexcept { return T{1}; }
+
+    MATLABW_ALWAYS_INLINE static T map(T x) noexcept { return (omit && isNan(x)) ? T{1} : x; }
+
+    MATLABW_ALWAYS_INLINE static T combine(T a, T b) noexcept { return multiply(a, b); }
+  };
+
+  /**
+   * @brief Cumulative maximum or minimum. Omitted NaN values keep the previous extremum, leading NaN values stay NaN.
+   * @tparam T Element type
+   * @tparam greater True for the maximum
+   * @tparam omit True to skip NaN values
+   */
+  template<typename T, bool greater, bool omit>
+  struct ScanExtremum
+  {
+    static_assert(RealNumeric<T>, "cumulative extrema are defined for real values");
+
+    static constexpr bool isSum{false};   ///< Enables the in-register scan
+    static constexpr bool omitNan{omit};  ///< NaN values are skipped
+    static constexpr bool associative{true};
+
+    /// @brief Gets the identity, NaN for omitted NaN values, so that it is replaced by the first number.
+    [[nodiscard]] static constexpr T identity() noexcept
+    {
+      if constexpr (isInteger<T>)
+      {
+        return greater ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+      }
+      else if constexpr (omit)
+      {
+        return std::numeric_limits<T>::quiet_NaN();
+      }
+      else
+      {
+        return greater ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+      }
+    }
+
+    MATLABW_ALWAYS_INLINE static T map(T x) noexcept { return x; }
+
+    MATLABW_ALWAYS_INLINE static T combine(T a, T b) noexcept
+    {
+      const bool better = greater ? (b > a) : (b < a);
+
+      // Omitting replaces a NaN accumulator, propagating keeps a NaN accumulator and takes a NaN value.
+      return (better || (omit ? isNan(a) : isNan(b))) ? b : a;
+    }
+  };
+
+  /// @brief Cumulative maximum.
+  template<typename T, bool omit>
+  using ScanMax = ScanExtremum<T, true, omit>;
+
+  /// @brief Cumulative minimum.
+  template<typename T, bool omit>
+  using ScanMin = ScanExtremum<T, false, omit>;
+
+#ifdef MATLABW_SCAN_SSE2
+  /**
+   * @brief Cumulative sum of doubles with an in-register scan of pairs, halving the serial dependency chain.
+   * @tparam omit True to treat NaN as zero
+   * @param out Output pointer, may alias the input
+   * @param in Input pointer
+   * @param n Number of elements
+   * @param carry Sum preceding the range
+   * @return Sum of the range and the carry
+   */
+  template<bool omit>
+  [[nodiscard]] inline double scanSumSse2(double* out, const double* in, std::size_t n, double carry) noexcept
+  {
+    const __m128d negZero = _mm_set1_pd(-0.0);
+
+    __m128d acc = _mm_set1_pd(carry);
+
+    std::size_t i{};
+
+    for (; i + 2 <= n; i += 2)
+    {
+      __m128d x = _mm_loadu_pd(in + i);
+
+      if constexpr (omit)
+      {
+        x = _mm_and_pd(x, _mm_cmpord_pd(x, x));
+      }
+
+      x   = _mm_add_pd(x, _mm_unpacklo_pd(negZero, x));
+      x   = _mm_add_pd(x, acc);
+      acc = _mm_unpackhi_pd(x, x);
+
+      _mm_storeu_pd(out + i, x);
+    }
+
+    carry = _mm_cvtsd_f64(acc);
+
+    for (; i < n; ++i)
+    {
+      carry  += (omit && in[i] != in[i]) ? 0.0 : in[i];
+      out[i]  = carry;
+    }
+
+    return carry;
+  }
+
+  /**
+   * @brief Cumulative sum of floats with an in-register scan of quadruples.
+   * @tparam omit True to treat NaN as zero
+   * @param out Output pointer, may alias the input
+   * @param in Input pointer
+   * @param n Number of elements
+   * @param carry Sum preceding the range
+   * @return Sum of the range and the carry
+   */
+  template<bool omit>
+  [[nodiscard]] inline float scanSumSse2(float* out, const float* in, std::size_t n, float carry) noexcept
+  {
+    // The lanes shifted in are -0, the identity of the addition.
+    const __m128 negZero1 = _mm_castsi128_ps(_mm_set_epi32(0, 0, 0, std::numeric_limits<int>::min()));
+    const __m128 negZero2 = _mm_castsi128_ps(_mm_set_epi32(0, 0, std::numeric_limits<int>::min(),
+                                                           std::numeric_limits<int>::min()));
+
+    __m128 acc = _mm_set1_ps(carry);
+
+    std::size_t i{};
+
+    for (; i + 4 <= n; i += 4)
+    {
+      __m128 x = _mm_loadu_ps(in + i);
+
+      if constexpr (omit)
+      {
+        x = _mm_and_ps(x, _mm_cmpord_ps(x, x));
+      }
+
+      x   = _mm_add_ps(x, _mm_or_ps(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)), negZero1));
+      x   = _mm_add_ps(x, _mm_or_ps(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)), negZero2));
+      x   = _mm_add_ps(x, acc);
+      acc = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+
+      _mm_storeu_ps(out + i, x);
+    }
+
+    carry = _mm_cvtss_f32(acc);
+
+    for (; i < n; ++i)
+    {
+      carry  += (omit && in[i] != in[i]) ? 0.0f : in[i];
+      out[i]  = carry;
+    }
+
+    return carry;
+  }
+#endif
+
+  /**
+   * @brief Scans a contiguous range.
+   * @tparam Op Scan operation
+   * @tparam T Element type
+   * @param out Output pointer, may alias the input
+   * @param in Input pointer
+   * @param n Number of elements
+   * @param carry Result preceding the range
+   * @return Result of the whole range
+   */
+  template<typename Op, typename T>
+  MATLABW_ALWAYS_INLINE T scanRange(T* out, const T* in, std::size_t n, T carry) noexcept
+  {
+#ifdef MATLABW_SCAN_SSE2
+    if constexpr (Op::isSum && RealFloat<T>)
+    {
+      return scanSumSse2<Op::omitNan>(out, in, n, carry);
+    }
+    else
+#endif
+    {
+      for (std::size_t i{}; i < n; ++i)
+      {
+        carry  = Op::combine(carry, Op::map(in[i]));
+        out[i] = carry;
+      }
+
+      return carry;
+    }
+  }
+
+  /**
+   * @brief Reduces a contiguous range of an associative scan with independent accumulators.
+   * @tparam Op Scan operation
+   * @tparam T Element type
+   * @param in Input pointer
+   * @param n Number of elements
+   * @return Result of the range
+   */
+  template<typename Op, typename T>
+  [[nodiscard]] T reduceScanRange(const T* in, std::size_t n) noexcept
+  {
+    T acc[4]{Op::identity(), Op::identity(), Op::identity(), Op::identity()};
+
+    std::size_t i{};
+
+    for (; i + 4 <= n; i += 4)
+    {
+      for (std::size_t k{}; k < 4; ++k)
+      {
+        acc[k] = Op::combine(acc[k], Op::map(in[i + k]));
+      }
+    }
+
+    for (; i < n; ++i)
+    {
+      acc[0] = Op::combine(acc[0], Op::map(in[i]));
+    }
+
+    return Op::combine(Op::combine(acc[0], acc[1]), Op::combine(acc[2], acc[3]));
+  }
+
+  /**
+   * @brief Scans a long contiguous range with a parallel two-pass blocked scan. The first pass reduces fixed-size
+   *        chunks, the second scans each chunk from the combined results of the preceding ones. The chunks do not
+   *        depend on the number of threads, so neither does the result.
+   * @tparam Op Associative scan operation
+   * @tparam T Element type
+   * @param out Output pointer, may alias the input
+   * @param in Input pointer
+   * @param n Number of elements
+   */
+  template<typename Op, typename T>
+  void scanBlocked(T* out, const T* in, std::size_t n)
+  {
+    const std::size_t chunkCount = (n + parallelChunkSize - 1) / parallelChunkSize;
+
+    std::vector<T> carries(chunkCount);
+
+    parallel::parallelFor(0, chunkCount, 1, [&](std::size_t k)
+    {
+      const std::size_t first = k * parallelChunkSize;
+
+      carries[k] = reduceScanRange<Op>(in + first, std::min(parallelChunkSize, n - first));
+    });
+
+    T carry = Op::identity();
+
+    for (T& chunkCarry : carries)
+    {
+      carry = Op::combine(carry, std::exchange(chunkCarry, carry));
+    }
+
+    parallel::parallelFor(0, chunkCount, 1, [&](std::size_t k)
+    {
+      const std::size_t first = k * parallelChunkSize;
+
+      static_cast<void>(scanRange<Op>(out + first, in + first, std::min(parallelChunkSize, n - first), carries[k]));
+    });
+  }
+
+  /**
+   * @brief Scans consecutive contiguous segments, e.g. the columns of a matrix. Long segments of associative
+   *        operations are scanned with the blocked scan, otherwise whole segments are distributed between the threads.
+   * @tparam Op Scan operation
+   * @tparam T Element type
+   * @param out Output pointer, may alias the input
+   * @param in Input pointer
+   * @param length Number of elements of a segment
+   * @param count Number of segments
+   */
+  template<typename Op, typename T>
+  void scanSegments(T* out, const T* in, std::size_t length, std::size_t count)
+  {
+    const auto body = [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t c{first}; c < last; ++c)
+      {
+        static_cast<void>(scanRange<Op>(out + c * length, in + c * length, length, Op::identity()));
+      }
+    };
+
+    if (length * count < parallelMinSize)
+    {
+      body(0, count);
+    }
+    else if (Op::associative && length >= parallelMinSize)
+    {
+      for (std::size_t c{}; c < count; ++c)
+      {
+        scanBlocked<Op>(out + c * length, in + c * length, length);
+      }
+    }
+    else
+    {
+      parallel::parallelFor(0, count, std::max(std::size_t{1}, columnBlockMinSize / length), body);
+    }
+  }
+
+  /**
+   * @brief Scans along a non-leading dimension. Each task scans a block of up to scanStridedBlockSize neighbouring
+   *        scans row by row, the elementwise combination of consecutive rows vectorizes across the scans.
+   * @tparam Op Scan operation
+   * @tparam T Element type
+   * @param out Output pointer, may alias the input
+   * @param in Input pointer
+   * @param shape The layout
+   */
+  template<typename Op, typename T>
+  void scanStrided(T* out, const T* in, const ScanShape& shape)
+  {
+    const std::size_t stride      = shape.stride;
+    const std::size_t blockCount  = (stride + scanStridedBlockSize - 1) / scanStridedBlockSize;
+    const std::size_t blockLength = stride * shape.length;
+
+    const auto body = [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t t{first}; t < last; ++t)
+      {
+        const std::size_t offset = (t / blockCount) * blockLength + (t % blockCount) * scanStridedBlockSize;
+        const std::size_t width  = std::min(scanStridedBlockSize, stride - (t % blockCount) * scanStridedBlockSize);
+
+        T*       dst = out + offset;
+        const T* src = in + offset;
+
+        for (std::size_t s{}; s < width; ++s)
+        {
+          dst[s] = Op::combine(Op::identity(), Op::map(src[s]));
+        }
+
+        for (std::size_t k{1}; k < shape.length; ++k)
+        {
+          const T* prev = dst;
+
+          dst += stride;
+          src += stride;
+
+          for (std::size_t s{}; s < width; ++s)
+          {
+            dst[s] = Op::combine(prev[s], Op::map(src[s]));
+          }
+        }
+      }
+    };
+
+    const std::size_t taskCount = shape.count * blockCount;
+
+    if (blockLength * shape.count < parallelMinSize)
+    {
+      body(0, taskCount);
+    }
+    else
+    {
+      const std::size_t taskSize = std::min(stride, scanStridedBlockSize) * shape.length;
+
+      parallel::parallelFor(0, taskCount, std::max(std::size_t{1}, columnBlockMinSize / taskSize), body);
+    }
+  }
+
+  /**
+   * @brief Runs a cumulative operation.
+   * @tparam Op Scan operation template, instantiated as Op<T, omit>
+   * @param id Error identifier
+   * @param out Output of the size of the input, may be the input
+   * @param in Input
+   * @param options The options
+   * @param defaultPolicy MATLAB's default NaN handling of the operation
+   */
+  template<template<typename, bool> typename Op, typename Out, typename In>
+  void scan(const char* id, Out&& out, const In& in, const ScanOptions& options, NanPolicy defaultPolicy)
+  {
+    const auto src = toSpan(in);
+    auto       dst = toSpan(out);
+
+    using T = ElementType<decltype(src)>;
+
+    static_assert(std::is_same_v<ElementType<decltype(dst)>, T>, "output element type must match the input");
+
+    checkSizes(id, dst.size(), src.size());
+
+    const ScanShape shape  = getScanShape(in, options.dim);
+    const NanPolicy policy = options.nanPolicy.value_or(defaultPolicy);
+
+    if (policy == NanPolicy::abort)
+    {
+      throwOnNan(id, src.size(), src.data());
+    }
+
+    const auto run = [&]<typename ScanOp>()
+    {
+      if (shape.stride == 1)
+      {
+        scanSegments<ScanOp>(dst.data(), src.data(), shape.length, shape.count);
+      }
+      else
+      {
+        scanStrided<ScanOp>(dst.data(), src.data(), shape);
+      }
+    };
+
+    if (src.empty())
+    {
+      return;
+    }
+
+    if (policy == NanPolicy::omit)
+    {
+      run.template operator()<Op<T, true>>();
+    }
+    else
+    {
+      run.template operator()<Op<T, false>>();
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes the cumulative sum as cumsum does, along the first non-singleton dimension unless options.dim is
+   *        set. NaN values propagate by default, integers saturate at every step. Long vectors are scanned in
+   *        parallel and floating point sums in registers, so the rounding can differ from a serial loop in the last
+   *        bits.
+   * @param out Output of the size of the input, may be the input
+   * @param in Input array
+   * @param options The options
+   */
+  template<typename Out, typename In>
+    requires (!std::is_same_v<std::remove_cvref_t<In>, ScanOptions>)
+  void cumsum(Out&& out, const In& in, const ScanOptions& options = {})
+  {
+    detail::scan<detail::ScanSum>("matlabw:mx:algorithm:cumsum", out, in, options, NanPolicy::propagate);
+  }
+
+  /**
+   * @brief Computes the cumulative sum as cumsum does.
+   * @param in Input array
+   * @param options The options
+   * @return Array of the cumulative sums, the same size and type as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> cumsum(const In& in, const ScanOptions& options = {})
+  {
+    NumericArray<detail::ElementOf<In>> out = makeUninitNumericArray<detail::ElementOf<In>>(in.getDims());
+
+    cumsum(out, in, options);
+
+    return out;
+  }
+
+  /**
+   * @brief Computes the cumulative product as cumprod does, along the first non-singleton dimension unless
+   *        options.dim is set. NaN values propagate by default, integers saturate at every step.
+   * @param out Output of the size of the input, may be the input
+   * @param in Input array
+   * @param options The options
+   */
+  template<typename Out, typename In>
+    requires (!std::is_same_v<std::remove_cvref_t<In>, ScanOptions>)
+  void cumprod(Out&& out, const In& in, const ScanOptions& options = {})
+  {
+    detail::scan<detail::ScanProduct>("matlabw:mx:algorithm:cumprod", out, in, options, NanPolicy::propagate);
+  }
+
+  /**
+   * @brief Computes the cumulative product as cumprod does.
+   * @param in Input array
+   * @param options The options
+   * @return Array of the cumulative products, the same size and type as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> cumprod(const In& in, const ScanOptions& options = {})
+  {
+    NumericArray<detail::ElementOf<In>> out = makeUninitNumericArray<detail::ElementOf<In>>(in.getDims());
+
+    cumprod(out, in, options);
+
+    return out;
+  }
+
+  /**
+   * @brief Computes the cumulative maximum of real values as cummax does, along the first non-singleton dimension
+   *        unless options.dim is set. NaN values are omitted by default.
+   * @param out Output of the size of the input, may be the input
+   * @param in Input array
+   * @param options The options
+   */
+  template<typename Out, typename In>
+    requires (!std::is_same_v<std::remove_cvref_t<In>, ScanOptions>)
+  void cummax(Out&& out, const In& in, const ScanOptions& options = {})
+  {
+    detail::scan<detail::ScanMax>("matlabw:mx:algorithm:cummax", out, in, options, NanPolicy::omit);
+  }
+
+  /**
+   * @brief Computes the cumulative maximum as cummax does.
+   * @param in Input array
+   * @param options The options
+   * @return Array of the cumulative maxima, the same size and type as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> cummax(const In& in, const ScanOptions& options = {})
+  {
+    NumericArray<detail::ElementOf<In>> out = makeUninitNumericArray<detail::ElementOf<In>>(in.getDims());
+
+    cummax(out, in, options);
+
+    return out;
+  }
+
+  /**
+   * @brief Computes the cumulative minimum of real values as cummin does, along the first non-singleton dimension
+   *        unless options.dim is set. NaN values are omitted by default.
+   * @param out Output of the size of the input, may be the input
+   * @param in Input array
+   * @param options The options
+   */
+  template<typename Out, typename In>
+    requires (!std::is_same_v<std::remove_cvref_t<In>, ScanOptions>)
+  void cummin(Out&& out, const In& in, const ScanOptions& options = {})
+  {
+    detail::scan<detail::ScanMin>("matlabw:mx:algorithm:cummin", out, in, options, NanPolicy::omit);
+  }
+
+  /**
+   * @brief Computes the cumulative minimum as cummin does.
+   * @param in Input array
+   * @param options The options
+   * @return Array of the cumulative minima, the same size and type as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> cummin(const In& in, const ScanOptions& options = {})
+  {
+    NumericArray<detail::ElementOf<In>> out = makeUninitNumericArray<detail::ElementOf<In>>(in.getDims());
+
+    cummin(out, in, options);
+
+    return out;
+  }
+
+  /**
+   * @brief Computes the first differences as diff does, along the first non-singleton dimension unless dim is set.
+   *        Integers saturate. Each outer block is one elementwise subtraction of the block shifted by one row.
+   * @param out Output, the input size with the scanned dimension one shorter
+   * @param in Input array
+   * @param dim Zero-based dimension
+   */
+  template<typename Out, typename In>
+    requires (!std::is_convertible_v<const In&, std::optional<std::size_t>>)
+  void diff(Out&& out, const In& in, std::optional<std::size_t> dim = std::nullopt)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:diff"};
+
+    const auto src = detail::toSpan(in);
+    auto       dst = detail::toSpan(out);
+
+    using T = detail::ElementType<decltype(src)>;
+
+    static_assert(std::is_same_v<detail::ElementType<decltype(dst)>, T>, "output element type must match the input");
+
+    const detail::ScanShape shape   = detail::getScanShape(in, dim);
+    const std::size_t       segment = (shape.length > 0) ? shape.stride * (shape.length - 1) : 0;
+
+    detail::checkSizes(id, dst.size(), segment * shape.count);
+
+    const auto body = [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t c{first}; c < last; ++c)
+      {
+        const T* block = src.data() + c * (segment + shape.stride);
+
+        detail::transformSimd(detail::SubtractOp{}, segment, dst.data() + c * segment, block + shape.stride, block);
+      }
+    };
+
+    if (segment == 0)
+    {
+      return;
+    }
+
+    if (segment * shape.count < detail::parallelMinSize)
+    {
+      body(0, shape.count);
+    }
+    else if (segment >= detail::parallelMinSize)
+    {
+      // Long blocks go parallel within the subtraction.
+      for (std::size_t c{}; c < shape.count; ++c)
+      {
+        const T* block = src.data() + c * (segment + shape.stride);
+
+        detail::transform(detail::SubtractOp{}, segment, dst.data() + c * segment, block + shape.stride, block);
+      }
+    }
+    else
+    {
+      parallel::parallelFor(0, shape.count, std::max(std::size_t{1}, detail::columnBlockMinSize / segment), body);
+    }
+  }
+
+  /**
+   * @brief Computes the first differences as diff does.
+   * @param in Input array
+   * @param dim Zero-based dimension, the first non-singleton one if not set
+   * @return Array of the differences, the scanned dimension is one shorter
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] NumericArray<detail::ElementOf<In>> diff(const In& in, std::optional<std::size_t> dim = std::nullopt)
+  {
+    // Built from the view rather than Dims, which is limited to Dims::maxRank dimensions.
+    std::vector<std::size_t> dims(in.getDims().begin(), in.getDims().end());
+
+    const std::size_t d = detail::getScanDim(dims, dim);
+
+    if (d >= dims.size())
+    {
+      dims.resize(d + 1, 1);
+      dims[d] = 0;
+    }
+    else
+    {
+      dims[d] = (dims[d] > 0) ? dims[d] - 1 : 0;
+    }
+
+    NumericArray<detail::ElementOf<In>> out = makeUninitNumericArray<detail::ElementOf<In>>(dims);
+
+    diff(out, in, dim);
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_SCAN_HPP */
@@ -0,0 +1,557 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_SORT_HPP
+#define MATLABW_MX_ALGORITHM_SORT_HPP
+
+#include "../detail/include.hpp"
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../NumericArray.hpp"
+#include "mask.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Sort direction, NaN values are placed last in ascending and first in descending order as in MATLAB.
+  enum class SortDirection
+  {
+    ascend,  ///< Smallest first
+    descend, ///< Largest first
+  };
+
+  /**
+   * @brief Result of topK.
+   * @tparam T Element type
+   * @tparam Index Index type
+   */
+  template<typename T, typename Index>
+  struct TopK
+  {
+    NumericArray<T>     values;  ///< The selected values in sort order
+    NumericArray<Index> indices; ///< The one-based linear indices of the values
+  };
+
+namespace detail
+{
+  /// @brief Minimum number of elements sorted by radix sort, smaller inputs are sorted by comparison.
+  inline constexpr std::size_t radixMinSize{std::size_t{1} << 12};
+
+  /// @brief Number of buckets of a radix sort pass, one per byte value.
+  inline constexpr std::size_t radixBuckets{256};
+
+  /**
+   * @brief Unsigned key type of an element type, of the same size.
+   * @tparam T Element type
+   */
+  template<typename T>
+  using SortKey = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+                  std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                  std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+  /**
+   * @brief Maps a value to an unsigned key whose order is the sort order. Floating point values are ordered by their
+   *        sign-magnitude bits with all NaN values greater than Inf, the descending order inverts the keys.
+   * @tparam canonical Make all NaN values and both zeros equal, as needed for a stable order. Otherwise the mapping is
+   *         invertible up to the sign of NaN.
+   * @tparam T Element type
+   * @param x The value
+   * @param flip All ones for the descending order, zero otherwise
+   * @return The key
+   */
+  template<bool canonical, typename T>
+  MATLABW_ALWAYS_INLINE SortKey<T> toSortKey(T x, SortKey<T> flip) noexcept
+  {
+    using U = SortKey<T>;
+
+    constexpr U signBit = U{1} << (8 * sizeof(T) - 1);
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      U bits = std::bit_cast<U>(x);
+
+      if constexpr (canonical)
+      {
+        if (x != x)
+        {
+          return static_cast<U>(~U{} ^ flip);
+        }
+
+        if (x == T{})
+        {
+          bits = 0;
+        }
+      }
+      else if (x != x)
+      {
+        bits &= static_cast<U>(~signBit);
+      }
+
+      return static_cast<U>((((bits & signBit) != 0) ? ~bits : (bits | signBit)) ^ flip);
+    }
+    else if constexpr (std::is_signed_v<T>)
+    {
+      return static_cast<U>(static_cast<U>(x) ^ signBit ^ flip);
+    }
+    else
+    {
+      return static_cast<U>(x ^ flip);
+    }
+  }
+
+  /**
+   * @brief Maps a non-canonical key back to its value.
+   * @tparam T Element type
+   * @param key The key
+   * @param flip All ones for the descending order, zero otherwise
+   * @return The value
+   */
+  template<typename T>
+  MATLABW_ALWAYS_INLINE T fromSortKey(SortKey<T> key, SortKey<T> flip) noexcept
+  {
+    using U = SortKey<T>;
+
+    constexpr U signBit = U{1} << (8 * sizeof(T) - 1);
+
+    const U bits = static_cast<U>(key ^ flip);
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      return std::bit_cast<T>(static_cast<U>(((bits & signBit) != 0) ? (bits ^ signBit) : ~bits));
+    }
+    else
+    {
+      return static_cast<T>(std::is_signed_v<T> ? static_cast<U>(bits ^ signBit) : bits);
+    }
+  }
+
+  /**
+   * @brief Gets the flip mask of a sort direction.
+   * @tparam T Element type
+   * @param direction The direction
+   * @return All ones for the descending order, zero otherwise
+   */
+  template<typename T>
+  [[nodiscard]] constexpr SortKey<T> getSortFlip(SortDirection direction) noexcept
+  {
+    return (direction == SortDirection::descend) ? static_cast<SortKey<T>>(~SortKey<T>{}) : SortKey<T>{};
+  }
+
+  /**
+   * @brief Gets the byte of a key sorted by a radix pass.
+   * @tparam U Key type
+   * @param key The key
+   * @param pass The pass, 0 for the least significant byte
+   * @return The byte
+   */
+  template<typename U>
+  MATLABW_ALWAYS_INLINE std::size_t getRadixDigit(U key, std::size_t pass) noexcept
+  {
+    return static_cast<std::size_t>((key >> (8 * pass)) & 0xff);
+  }
+
+  /**
+   * @brief Stable least significant digit radix sort of keys, optionally carrying indices. Passes in which all keys
+   *        have the same byte are skipped. Large inputs count and scatter fixed-size chunks in parallel, the chunk
+   *        offsets of every bucket follow the chunk order so the result does not depend on the thread count.
+   * @tparam U Key type
+   * @param keys The keys, sorted on return
+   * @param indices The indices permuted with the keys, nullptr if none
+   * @param n Number of keys
+   * @param parallel Use the library-managed thread pool for large inputs?
+   */
+  template<typename U>
+  void radixSort(U* keys, std::size_t* indices, std::size_t n, bool parallel)
+  {
+    std::vector<U>           keyBuffer(n);
+    std::vector<std::size_t> indexBuffer((indices != nullptr) ? n : 0);
+
+    U*           src      = keys;
+    U*           dst      = keyBuffer.data();
+    std::size_t* srcIndex = indices;
+    std::size_t* dstIndex = indexBuffer.data();
+
+    const bool        chunked    = parallel && n >= parallelMinSize;
+    const std::size_t chunkCount = chunked ? (n + parallelChunkSize - 1) / parallelChunkSize : 1;
+    const std::size_t chunkSize  = chunked ? parallelChunkSize : n;
+
+    std::vector<std::array<std::size_t, radixBuckets>> counts(chunkCount);
+
+    auto forEachChunk = [&](auto&& fn)
+    {
+      if (chunked)
+      {
+        parallel::parallelFor(0, chunkCount, 1, [&](std::size_t chunk)
+        {
+          fn(chunk, chunk * chunkSize, std::min(chunk * chunkSize + chunkSize, n));
+        });
+      }
+      else
+      {
+        fn(std::size_t{}, std::size_t{}, n);
+      }
+    };
+
+    for (std::size_t pass{}; pass < sizeof(U); ++pass)
+    {
+      forEachChunk([&](std::size_t chunk, std::size_t first, std::size_t last)
+      {
+        auto& count = counts[chunk];
+
+        count.fill(0);
+
+        for (std::size_t i{first}; i < last; ++i)
+        {
+          ++count[getRadixDigit(src[i], pass)];
+        }
+      });
+
+      std::size_t offset{};
+      bool        trivial{};
+
+      for (std::size_t digit{}; digit < radixBuckets; ++digit)
+      {
+        const std::size_t start = offset;
+
+        for (auto& count : counts)
+        {
+          offset += std::exchange(count[digit], offset);
+        }
+
+        trivial = trivial || (offset - start == n);
+      }
+
+      if (trivial)
+      {
+        continue;
+      }
+
+      forEachChunk([&](std::size_t chunk, std::size_t first, std::size_t last)
+      {
+        auto& next = counts[chunk];
+
+        for (std::size_t i{first}; i < last; ++i)
+        {
+          const std::size_t position = next[getRadixDigit(src[i], pass)]++;
+
+          dst[position] = src[i];
+
+          if (srcIndex != nullptr)
+          {
+            dstIndex[position] = srcIndex[i];
+          }
+        }
+      });
+
+      std::swap(src, dst);
+      std::swap(srcIndex, dstIndex);
+    }
+
+    if (src != keys)
+    {
+      std::copy_n(src, n, keys);
+
+      if (indices != nullptr)
+      {
+        std::copy_n(srcIndex, n, indices);
+      }
+    }
+  }
+
+  /**
+   * @brief Sorts values in place.
+   * @tparam T Element type
+   * @param data The values
+   * @param n Number of values
+   * @param direction The sort direction
+   * @param parallel Use the library-managed thread pool for large inputs?
+   */
+  template<typename T>
+  void sortValues(T* data, std::size_t n, SortDirection direction, bool parallel)
+  {
+    using U = SortKey<T>;
+
+    const U flip = getSortFlip<T>(direction);
+
+    if (n < radixMinSize)
+    {
+      std::sort(data, data + n, [flip](T a, T b)
+      {
+        return toSortKey<true>(a, flip) < toSortKey<true>(b, flip);
+      });
+
+      return;
+    }
+
+    std::vector<U> keys(n);
+
+    U* key = keys.data();
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      key[i] = toSortKey<false>(data[i], flip);
+    }
+
+    radixSort(key, nullptr, n, parallel);
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      data[i] = fromSortKey<T>(key[i], flip);
+    }
+  }
+
+  /**
+   * @brief Computes the zero-based permutation which stably sorts values.
+   * @tparam T Element type
+   * @param data The values
+   * @param n Number of values
+   * @param direction The sort direction
+   * @return The permutation
+   */
+  template<typename T>
+  [[nodiscard]] std::vector<std::size_t> sortPermutation(const T* data, std::size_t n, SortDirection direction)
+  {
+    using U = SortKey<T>;
+
+    const U flip = getSortFlip<T>(direction);
+
+    std::vector<U>           keys(n);
+    std::vector<std::size_t> order(n);
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      keys[i]  = toSortKey<true>(data[i], flip);
+      order[i] = i;
+    }
+
+    if (n < radixMinSize)
+    {
+      std::stable_sort(order.begin(), order.end(), [&keys](std::size_t a, std::size_t b)
+      {
+        return keys[a] < keys[b];
+      });
+    }
+    else
+    {
+      radixSort(keys.data(), order.data(), n, true);
+    }
+
+    return order;
+  }
+
+  /**
+   * @brief Gets a span over the input of a sort and checks its element type.
+   * @tparam A Array type
+   * @param a The array
+   * @return The span
+   */
+  template<typename A>
+  [[nodiscard]] auto toSortSpan(A&& a) noexcept
+  {
+    auto span = toSpan(a);
+
+    static_assert(isReal<ElementType<decltype(span)>>, "unsupported element type, complex values are not supported");
+
+    return span;
+  }
+
+  /// @brief Checks if an index type is supported by the sort kernels.
+  template<typename Index>
+  inline constexpr bool isSortIndex = std::is_same_v<Index, double> || std::is_same_v<Index, std::uint64_t>;
+} // namespace detail
+
+  /**
+   * @brief Sorts an array in place. Large arrays are sorted by a parallel radix sort, small ones by comparison.
+   * @tparam InOut Array type (TypedArrayRef, TypedArray, span, ...) of a real numeric element type
+   * @param data The array
+   * @param direction The sort direction
+   */
+  template<typename InOut>
+  void sort(InOut&& data, SortDirection direction = SortDirection::ascend)
+  {
+    auto span = detail::toSortSpan(data);
+
+    detail::sortValues(span.data(), span.size(), direction, true);
+  }
+
+  /**
+   * @brief Computes the one-based indices which stably sort an array, as the second output of MATLAB's sort. Equal
+   *        values keep their order, NaN values are equal.
+   * @tparam Index Index type, double or std::uint64_t
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...) of a real numeric element type
+   * @param in Input
+   * @param direction The sort direction
+   * @return The indices, of the input's dimensions if it has any, a column vector otherwise
+   */
+  template<typename Index = double, typename In>
+  [[nodiscard]] NumericArray<Index> argsort(const In& in, SortDirection direction = SortDirection::ascend)
+  {
+    static_assert(detail::isSortIndex<Index>, "index type must be double or std::uint64_t");
+
+    const auto span  = detail::toSortSpan(in);
+    const auto order = detail::sortPermutation(span.data(), span.size(), direction);
+
+    NumericArray<Index> out = [&]
+    {
+      if constexpr (requires { in.getDims(); })
+      {
+        return makeUninitNumericArray<Index>(in.getDims());
+      }
+      else
+      {
+        return makeUninitNumericArray<Index>(span.size(), 1);
+      }
+    }();
+
+    Index* dst = out.getData();
+
+    for (std::size_t i{}; i < order.size(); ++i)
+    {
+      dst[i] = static_cast<Index>(order[i] + 1);
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief Partially sorts an array in place so that the element at the position is the one which would be there
+   *        if the array was sorted, no element before it is after it in the sort order and no element after it is
+   *        before it, as std::nth_element.
+   * @tparam InOut Array type (TypedArrayRef, TypedArray, span, ...) of a real numeric element type
+   * @param data The array
+   * @param position Zero-based position of the element
+   * @param direction The sort direction
+   */
+  template<typename InOut>
+  void nthElement(InOut&& data, std::size_t position, SortDirection direction = SortDirection::ascend)
+  {
+    auto span = detail::toSortSpan(data);
+
+    using T = detail::ElementType<decltype(span)>;
+
+    if (position >= span.size())
+    {
+      throw Exception{"matlabw:mx:algorithm:nthElement", "position out of range"};
+    }
+
+    const auto flip = detail::getSortFlip<T>(direction);
+
+    std::nth_element(span.begin(), span.begin() + static_cast<std::ptrdiff_t>(position), span.end(), [flip](T a, T b)
+    {
+      return detail::toSortKey<true>(a, flip) < detail::toSortKey<true>(b, flip);
+    });
+  }
+
+  /**
+   * @brief Selects the first elements of an array in the sort order with their indices, as maxk and mink. Runs in
+   *        O(n log k), ties are resolved by the index.
+   * @tparam Index Index type, double or std::uint64_t
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...) of a real numeric element type
+   * @param in Input
+   * @param k Number of elements, at most the input size is selected
+   * @param direction The sort direction, descend selects the largest elements
+   * @return The values and one-based indices, row vectors for a row vector input, column vectors otherwise
+   */
+  template<typename Index = double, typename In>
+  [[nodiscard]] TopK<detail::ElementOf<In>, Index> topK(const In&     in,
+                                                        std::size_t   k,
+                                                        SortDirection direction = SortDirection::descend)
+  {
+    static_assert(detail::isSortIndex<Index>, "index type must be double or std::uint64_t");
+
+    using T = detail::ElementOf<In>;
+
+    const auto span = detail::toSortSpan(in);
+    const T*   data = span.data();
+    const auto flip = detail::getSortFlip<T>(direction);
+
+    k = std::min(k, span.size());
+
+    std::vector<std::size_t> order(span.size());
+
+    std::iota(order.begin(), order.end(), std::size_t{});
+
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(),
+                      [data, flip](std::size_t a, std::size_t b)
+    {
+      const auto keyA = detail::toSortKey<true>(data[a], flip);
+      const auto keyB = detail::toSortKey<true>(data[b], flip);
+
+      return (keyA < keyB) || (keyA == keyB && a < b);
+    });
+
+    TopK<T, Index> result{detail::makeVectorResult<T>(in, k), detail::makeVectorResult<Index>(in, k)};
+
+    for (std::size_t i{}; i < k; ++i)
+    {
+      result.values.getData()[i]  = data[order[i]];
+      result.indices.getData()[i] = static_cast<Index>(order[i] + 1);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Sorts each column of an array in place, as sort along the first dimension. Columns are sorted in parallel.
+   * @tparam InOut Array type with dimensions (TypedArrayRef, TypedArray, ...) of a real numeric element type
+   * @param data The array
+   * @param direction The sort direction
+   */
+  template<typename InOut>
+    requires requires(const InOut& a) { a.getDims(); }
+  void sortColumns(InOut&& data, SortDirection direction = SortDirection::ascend)
+  {
+    auto span = detail::toSortSpan(data);
+
+    const std::size_t m = data.getDims()[0];
+
+    if (span.empty() || m < 2)
+    {
+      return;
+    }
+
+    const std::size_t columns = span.size() / m;
+
+    auto* ptr = span.data();
+
+    if (span.size() < detail::parallelMinSize || columns == 1)
+    {
+      for (std::size_t j{}; j < columns; ++j)
+      {
+        detail::sortValues(ptr + j * m, m, direction, columns == 1);
+      }
+
+      return;
+    }
+
+    parallel::parallelFor(0, columns, 0, [&](std::size_t j)
+    {
+      detail::sortValues(ptr + j * m, m, direction, false);
+    });
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_SORT_HPP */
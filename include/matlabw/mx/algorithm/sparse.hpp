@@ -0,0 +1,541 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_SPARSE_HPP
+#define MATLABW_MX_ALGORITHM_SPARSE_HPP
+
+#include "../detail/include.hpp"
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/span.hpp"
+#include "../SparseArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Operation applied to a sparse matrix by the products.
+  enum class Transpose
+  {
+    none,      ///< The matrix as is, A
+    transpose, ///< The transpose, A.'
+    conjugate, ///< The conjugate transpose, A'
+  };
+
+  /**
+   * @brief Sparse matrix in compressed sparse row format, the transpose of the CSC storage of MATLAB. Rows can be
+   *        processed independently, so products with it parallelize over the rows without private accumulators. Build
+   *        it once and reuse it when the same matrix is multiplied many times, e.g. in iterative solvers.
+   * @tparam S Element type, double or std::complex<double>
+   */
+  template<typename S>
+  class CsrMatrix
+  {
+    static_assert(std::is_same_v<S, double> || std::is_same_v<S, std::complex<double>>,
+                  "S must be double or std::complex<double>");
+
+    public:
+      /**
+       * @brief Constructor. Converts a CSC matrix to CSR storage.
+       * @param csc The CSC view of the matrix
+       */
+      explicit CsrMatrix(CscView<const S> csc)
+      : mDimM{csc.rows}, mDimN{csc.cols}, mRowPtr(csc.rows + 1), mColIdx(csc.getNnz()), mValues(csc.getNnz())
+      {
+        for (std::size_t k{}; k < csc.getNnz(); ++k)
+        {
+          ++mRowPtr[csc.rowIdx[k] + 1];
+        }
+
+        std::partial_sum(mRowPtr.begin(), mRowPtr.end(), mRowPtr.begin());
+
+        std::vector<mwIndex> next(mRowPtr.begin(), mRowPtr.end() - 1);
+
+        // Columns are visited in order, so the column indices of each row come out sorted.
+        for (std::size_t j{}; j < csc.cols; ++j)
+        {
+          for (std::size_t k = csc.colPtr[j]; k < csc.colPtr[j + 1]; ++k)
+          {
+            const mwIndex dst = next[csc.rowIdx[k]]++;
+
+            mColIdx[dst] = j;
+            mValues[dst] = csc.values[k];
+          }
+        }
+      }
+
+      /**
+       * @brief Constructor. Converts a sparse array to CSR storage.
+       * @param array The sparse array
+       */
+      explicit CsrMatrix(SparseArrayCref<S> array)
+      : CsrMatrix{array.getCsc()}
+      {}
+
+      /**
+       * @brief Gets the number of rows.
+       * @return The number of rows
+       */
+      [[nodiscard]] std::size_t getDimM() const noexcept
+      {
+        return mDimM;
+      }
+
+      /**
+       * @brief Gets the number of columns.
+       * @return The number of columns
+       */
+      [[nodiscard]] std::size_t getDimN() const noexcept
+      {
+        return mDimN;
+      }
+
+      /**
+       * @brief Gets the number of nonzeros.
+       * @return The number of nonzeros
+       */
+      [[nodiscard]] std::size_t getNnz() const noexcept
+      {
+        return mValues.size();
+      }
+
+      /**
+       * @brief Gets the row start offsets.
+       * @return getDimM() + 1 offsets
+       */
+      [[nodiscard]] View<mwIndex> getRowPtr() const noexcept
+      {
+        return mRowPtr;
+      }
+
+      /**
+       * @brief Gets the column indices.
+       * @return One column index per nonzero
+       */
+      [[nodiscard]] View<mwIndex> getColIdx() const noexcept
+      {
+        return mColIdx;
+      }
+
+      /**
+       * @brief Gets the values.
+       * @return One value per nonzero
+       */
+      [[nodiscard]] View<S> getValues() const noexcept
+      {
+        return mValues;
+      }
+    private:
+      std::size_t          mDimM{};   ///< Number of rows
+      std::size_t          mDimN{};   ///< Number of columns
+      std::vector<mwIndex> mRowPtr{}; ///< Row start offsets
+      std::vector<mwIndex> mColIdx{}; ///< Column indices
+      std::vector<S>       mValues{}; ///< Values
+  };
+
+namespace detail
+{
+  /**
+   * @brief Compressed storage independent of its orientation. For CSC the outer dimension are the columns, for CSR
+   *        the rows.
+   * @tparam S Element type
+   */
+  template<typename S>
+  struct Compressed
+  {
+    std::size_t    outerSize{}; ///< Number of compressed columns (CSC) or rows (CSR)
+    std::size_t    innerSize{}; ///< Number of rows (CSC) or columns (CSR)
+    const mwIndex* ptr{};       ///< Outer start offsets
+    const mwIndex* idx{};       ///< Inner indices
+    const S*       values{};    ///< Values
+    bool           rowMajor{};  ///< True for CSR
+
+    /**
+     * @brief Gets the number of nonzeros.
+     * @return The number of nonzeros
+     */
+    [[nodiscard]] std::size_t getNnz() const noexcept
+    {
+      return ptr[outerSize];
+    }
+  };
+
+  /**
+   * @brief Gets the compressed storage of a CSC view.
+   * @tparam S Element type
+   * @param csc The view
+   * @return The compressed storage
+   */
+  template<typename S>
+  [[nodiscard]] Compressed<S> toCompressed(CscView<const S> csc) noexcept
+  {
+    return Compressed<S>{csc.cols, csc.rows, csc.colPtr.data(), csc.rowIdx.data(), csc.values.data(), false};
+  }
+
+  /**
+   * @brief Gets the compressed storage of a sparse matrix argument. Accepts sparse arrays and references, CSC views
+   *        and CsrMatrix.
+   * @tparam A Argument type
+   * @param a The argument
+   * @return The compressed storage
+   */
+  template<typename A>
+  [[nodiscard]] auto toCompressed(const A& a)
+  {
+    if constexpr (requires { a.getRowPtr(); })
+    {
+      using S = std::remove_const_t<typename decltype(a.getValues())::element_type>;
+
+      return Compressed<S>{a.getDimM(), a.getDimN(), a.getRowPtr().data(), a.getColIdx().data(), a.getValues().data(),
+                           true};
+    }
+    else if constexpr (requires { a.getCsc(); })
+    {
+      using S = std::remove_const_t<typename decltype(a.getCsc())::value_type>;
+
+      return toCompressed(CscView<const S>{a.getCsc()});
+    }
+    else
+    {
+      using S = std::remove_const_t<typename A::value_type>;
+
+      return toCompressed(CscView<const S>{a.rows, a.cols, a.colPtr, a.rowIdx, a.values});
+    }
+  }
+
+  /**
+   * @brief Applies the conjugation of the operation to a value.
+   * @tparam conjugate Conjugate the value?
+   * @tparam S Element type
+   * @param x The value
+   * @return The value, conjugated if requested
+   */
+  template<bool conjugate, typename S>
+  MATLABW_ALWAYS_INLINE S conjugateIf(S x) noexcept
+  {
+    if constexpr (conjugate && isComplex<S>)
+    {
+      return std::conj(x);
+    }
+    else
+    {
+      return x;
+    }
+  }
+
+  /**
+   * @brief Computes y[o] = sum of a(o, i) * x[i] over the outer range [first, last), the outer dimension indexes y.
+   * @tparam conjugate Conjugate the matrix values?
+   * @param a The compressed storage
+   * @param x Input pointer
+   * @param y Output pointer
+   * @param first First outer index
+   * @param last Past the end outer index
+   */
+  template<bool conjugate, typename S, typename X, typename Y>
+  void gatherProduct(const Compressed<S>& a, const X* x, Y* y, std::size_t first, std::size_t last) noexcept
+  {
+    for (std::size_t o{first}; o < last; ++o)
+    {
+      Y acc{};
+
+      for (std::size_t k = a.ptr[o]; k < a.ptr[o + 1]; ++k)
+      {
+        acc += conjugateIf<conjugate>(a.values[k]) * x[a.idx[k]];
+      }
+
+      y[o] = acc;
+    }
+  }
+
+  /**
+   * @brief Computes y[i] += a(o, i) * x[o] over the outer range [first, last), the inner dimension indexes y.
+   * @tparam conjugate Conjugate the matrix values?
+   * @param a The compressed storage
+   * @param x Input pointer
+   * @param y Output pointer, accumulated into
+   * @param first First outer index
+   * @param last Past the end outer index
+   */
+  template<bool conjugate, typename S, typename X, typename Y>
+  void scatterProduct(const Compressed<S>& a, const X* x, Y* y, std::size_t first, std::size_t last) noexcept
+  {
+    for (std::size_t o{first}; o < last; ++o)
+    {
+      const X xo = x[o];
+
+      for (std::size_t k = a.ptr[o]; k < a.ptr[o + 1]; ++k)
+      {
+        y[a.idx[k]] += conjugateIf<conjugate>(a.values[k]) * xo;
+      }
+    }
+  }
+
+  /**
+   * @brief Computes the product of a compressed matrix and a vector, large matrices are split between the threads of
+   *        the library-managed thread pool. Gathers run in parallel over the outer dimension, scatters accumulate
+   *        disjoint outer ranges balanced by nonzeros into thread-private vectors which are summed at the end.
+   * @tparam conjugate Conjugate the matrix values?
+   * @param a The compressed storage
+   * @param gather Is the output indexed by the outer dimension?
+   * @param x Input pointer
+   * @param y Output pointer
+   */
+  template<bool conjugate, typename S, typename X, typename Y>
+  void sparseProduct(const Compressed<S>& a, bool gather, const X* x, Y* y)
+  {
+    const std::size_t nnz = a.getNnz();
+
+    if (gather)
+    {
+      if (nnz < parallelMinSize)
+      {
+        gatherProduct<conjugate>(a, x, y, 0, a.outerSize);
+        return;
+      }
+
+      const std::size_t grain = std::max<std::size_t>(1, a.outerSize / (nnz / parallelChunkSize));
+
+      parallel::parallelFor(0, a.outerSize, grain, [&](std::size_t first, std::size_t last)
+      {
+        gatherProduct<conjugate>(a, x, y, first, last);
+      });
+
+      return;
+    }
+
+    std::fill_n(y, a.innerSize, Y{});
+
+    const std::size_t partCount = std::min(parallel::getThreadPool().getThreadCount() + 1, nnz / parallelChunkSize);
+
+    if (nnz < parallelMinSize || partCount <= 1)
+    {
+      scatterProduct<conjugate>(a, x, y, 0, a.outerSize);
+      return;
+    }
+
+    // The first part accumulates into the output directly.
+    std::vector<Y> partials((partCount - 1) * a.innerSize);
+
+    parallel::parallelFor(0, partCount, 1, [&](std::size_t p)
+    {
+      const auto first = std::lower_bound(a.ptr, a.ptr + a.outerSize, nnz * p / partCount) - a.ptr;
+      const auto last  = std::lower_bound(a.ptr, a.ptr + a.outerSize, nnz * (p + 1) / partCount) - a.ptr;
+
+      Y* out = (p == 0) ? y : partials.data() + (p - 1) * a.innerSize;
+
+      scatterProduct<conjugate>(a, x, out, static_cast<std::size_t>(first), static_cast<std::size_t>(last));
+    });
+
+    parallel::parallelFor(0, a.innerSize, parallelChunkSize, [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t p{1}; p < partCount; ++p)
+      {
+        const Y* partial = partials.data() + (p - 1) * a.innerSize;
+
+        for (std::size_t i{first}; i < last; ++i)
+        {
+          y[i] += partial[i];
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Computes the product of a compressed matrix and the columns of a dense matrix. Gathers process all columns
+   *        per outer index, so the matrix is read once. Scatters run one column per thread if there are enough
+   *        columns, otherwise the columns are multiplied one after another by sparseProduct().
+   * @tparam conjugate Conjugate the matrix values?
+   * @param a The compressed storage
+   * @param gather Is the output indexed by the outer dimension?
+   * @param x Input pointer, column-major
+   * @param y Output pointer, column-major
+   * @param xDimM Number of rows of x
+   * @param yDimM Number of rows of y
+   * @param colCount Number of columns of x and y
+   */
+  template<bool conjugate, typename S, typename X, typename Y>
+  void sparseProduct(const Compressed<S>& a,
+                     bool                 gather,
+                     const X*             x,
+                     Y*                   y,
+                     std::size_t          xDimM,
+                     std::size_t          yDimM,
+                     std::size_t          colCount)
+  {
+    const std::size_t work = a.getNnz() * colCount;
+
+    if (gather)
+    {
+      auto body = [&](std::size_t first, std::size_t last)
+      {
+        for (std::size_t c{}; c < colCount; ++c)
+        {
+          gatherProduct<conjugate>(a, x + c * xDimM, y + c * yDimM, first, last);
+        }
+      };
+
+      if (work < parallelMinSize)
+      {
+        body(0, a.outerSize);
+        return;
+      }
+
+      parallel::parallelFor(0, a.outerSize, std::max<std::size_t>(1, a.outerSize / (work / parallelChunkSize)), body);
+
+      return;
+    }
+
+    if (work < parallelMinSize || colCount <= parallel::getThreadPool().getThreadCount())
+    {
+      for (std::size_t c{}; c < colCount; ++c)
+      {
+        sparseProduct<conjugate>(a, false, x + c * xDimM, y + c * yDimM);
+      }
+
+      return;
+    }
+
+    parallel::parallelFor(0, colCount, 1, [&](std::size_t c)
+    {
+      std::fill_n(y + c * yDimM, yDimM, Y{});
+      scatterProduct<conjugate>(a, x + c * xDimM, y + c * yDimM, 0, a.outerSize);
+    });
+  }
+
+  /**
+   * @brief Dispatches a product on the conjugation and orientation of the operation.
+   * @param a The compressed storage
+   * @param op The operation applied to the matrix
+   * @param args Arguments of sparseProduct() after the orientation
+   */
+  template<typename S, typename... Args>
+  void sparseProduct(const Compressed<S>& a, Transpose op, Args... args)
+  {
+    // CSC gathers when transposed, CSR when not.
+    const bool gather = (op == Transpose::none) == a.rowMajor;
+
+    if (op == Transpose::conjugate)
+    {
+      sparseProduct<true>(a, gather, args...);
+    }
+    else
+    {
+      sparseProduct<false>(a, gather, args...);
+    }
+  }
+
+  /**
+   * @brief Gets the dimensions of op(A).
+   * @param a The compressed storage
+   * @param op The operation applied to the matrix
+   * @return The number of rows and columns
+   */
+  template<typename S>
+  [[nodiscard]] std::pair<std::size_t, std::size_t> getProductDims(const Compressed<S>& a, Transpose op) noexcept
+  {
+    const std::size_t dimM = a.rowMajor ? a.outerSize : a.innerSize;
+    const std::size_t dimN = a.rowMajor ? a.innerSize : a.outerSize;
+
+    return (op == Transpose::none) ? std::pair{dimM, dimN} : std::pair{dimN, dimM};
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes y = op(A) * x for a sparse matrix A and a dense vector x. CSC matrices run transposed products
+   *        in parallel over the columns and plain products with thread-private accumulators, CsrMatrix the other way
+   *        around. Real matrices multiply complex vectors, complex matrices require complex vectors.
+   * @tparam A Sparse matrix type (SparseArrayCref, SparseArray, CscView, CsrMatrix)
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, span, ...)
+   * @tparam In Input array type (TypedArrayCref, TypedArray, span, ...)
+   * @param y Output, must not overlap the input
+   * @param a The sparse matrix
+   * @param x Input
+   * @param op The operation applied to the matrix
+   */
+  template<typename A, typename Out, typename In>
+  void spmv(Out&& y, const A& a, const In& x, Transpose op = Transpose::none)
+  {
+    auto dst = detail::toSpan(y);
+    auto src = detail::toSpan(x);
+    auto mat = detail::toCompressed(a);
+
+    using S = std::remove_const_t<std::remove_pointer_t<decltype(mat.values)>>;
+    using X = detail::ElementType<decltype(src)>;
+    using Y = detail::ElementType<decltype(dst)>;
+
+    static_assert(std::is_same_v<X, double> || std::is_same_v<X, std::complex<double>>,
+                  "input must be double or std::complex<double>");
+    static_assert(std::is_same_v<Y, decltype(S{} * X{})>, "output must be complex if the matrix or input is");
+
+    const auto [dimM, dimN] = detail::getProductDims(mat, op);
+
+    detail::checkSizes("matlabw:mx:algorithm:spmv", dimM, dst.size());
+    detail::checkSizes("matlabw:mx:algorithm:spmv", dimN, src.size());
+
+    detail::sparseProduct(mat, op, src.data(), dst.data());
+  }
+
+  /**
+   * @brief Computes Y = op(A) * X for a sparse matrix A and a dense matrix X, see spmv().
+   * @tparam A Sparse matrix type (SparseArrayCref, SparseArray, CscView, CsrMatrix)
+   * @tparam Out Output array type (TypedArrayRef, TypedArray, ...)
+   * @tparam In Input array type (TypedArrayCref, TypedArray, ...)
+   * @param y Output, must not overlap the input
+   * @param a The sparse matrix
+   * @param x Input, a 2-D array
+   * @param op The operation applied to the matrix
+   */
+  template<typename A, typename Out, typename In>
+  void spmm(Out&& y, const A& a, const In& x, Transpose op = Transpose::none)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:spmm"};
+
+    auto dst = detail::toSpan(y);
+    auto src = detail::toSpan(x);
+    auto mat = detail::toCompressed(a);
+
+    using S = std::remove_const_t<std::remove_pointer_t<decltype(mat.values)>>;
+    using X = detail::ElementType<decltype(src)>;
+    using Y = detail::ElementType<decltype(dst)>;
+
+    static_assert(std::is_same_v<X, double> || std::is_same_v<X, std::complex<double>>,
+                  "input must be double or std::complex<double>");
+    static_assert(std::is_same_v<Y, decltype(S{} * X{})>, "output must be complex if the matrix or input is");
+
+    if (x.getRank() > 2 || y.getRank() > 2)
+    {
+      throw Exception{id, "arrays must be 2-D"};
+    }
+
+    const auto [dimM, dimN] = detail::getProductDims(mat, op);
+
+    detail::checkSizes(id, dimN, x.getDimM());
+    detail::checkSizes(id, dimM, y.getDimM());
+    detail::checkSizes(id, x.getDimN(), y.getDimN());
+
+    detail::sparseProduct(mat, op, src.data(), dst.data(), dimN, dimM, x.getDimN());
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_SPARSE_HPP */
@@ -0,0 +1,406 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ALGORITHM_STENCIL_HPP
+#define MATLABW_MX_ALGORITHM_STENCIL_HPP
+
+#include "../detail/include.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "../Exception.hpp"
+#include "../MdSpan.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Values read outside of the array by a stencil, as the padding options of imfilter.
+  enum class StencilBoundary
+  {
+    replicate, ///< The nearest element of the array
+    zero,      ///< Zero
+    periodic,  ///< The element of the array repeated periodically
+  };
+
+  /**
+   * @brief Neighborhood of an element of the interior of the array, where the whole stencil lies inside the array.
+   *        Reads are plain loads at fixed offsets, so the loop over a row vectorizes.
+   * @tparam T Element type
+   * @tparam Rank Rank of the array
+   */
+  template<typename T, std::size_t Rank>
+  class StencilInterior
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param center Pointer to the center element
+       * @param strides Strides of the array in elements, the first one is 1
+       */
+      MATLABW_ALWAYS_INLINE StencilInterior(const T* center, const std::array<std::ptrdiff_t, Rank>& strides) noexcept
+      : mCenter{center}, mStrides{strides}
+      {}
+
+      /**
+       * @brief Reads a neighbor.
+       * @tparam Offsets Offset types, integral
+       * @param offsets Offsets from the center along each dimension, at most the radius of the stencil
+       * @return The neighbor
+       */
+      template<typename... Offsets>
+        requires (sizeof...(Offsets) == Rank && (std::is_integral_v<Offsets> && ...))
+      [[nodiscard]] MATLABW_ALWAYS_INLINE T operator()(Offsets... offsets) const noexcept
+      {
+        const std::array<std::ptrdiff_t, Rank> off{static_cast<std::ptrdiff_t>(offsets)...};
+
+        // The first stride is known to be 1, so neighbors along a row are adjacent loads.
+        std::ptrdiff_t k{off[0]};
+
+        for (std::size_t r{1}; r < Rank; ++r)
+        {
+          k += off[r] * mStrides[r];
+        }
+
+        return mCenter[k];
+      }
+    private:
+      const T*                         mCenter{};  ///< Pointer to the center element
+      std::array<std::ptrdiff_t, Rank> mStrides{}; ///< Strides of the array in elements
+  };
+
+  /**
+   * @brief Neighborhood of an element near the border of the array, reads outside of the array follow the boundary
+   *        mode.
+   * @tparam T Element type
+   * @tparam Rank Rank of the array
+   */
+  template<typename T, std::size_t Rank>
+  class StencilBorder
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param data Pointer to the data of the array
+       * @param extents Extents of the array
+       * @param strides Strides of the array in elements
+       * @param index Index of the center element
+       * @param boundary The boundary mode
+       */
+      MATLABW_ALWAYS_INLINE StencilBorder(const T*                                data,
+                                          const std::array<std::ptrdiff_t, Rank>& extents,
+                                          const std::array<std::ptrdiff_t, Rank>& strides,
+                                          const std::array<std::ptrdiff_t, Rank>& index,
+                                          StencilBoundary                         boundary) noexcept
+      : mData{data}, mExtents{extents}, mStrides{strides}, mIndex{index}, mBoundary{boundary}
+      {}
+
+      /**
+       * @brief Reads a neighbor.
+       * @tparam Offsets Offset types, integral
+       * @param offsets Offsets from the center along each dimension
+       * @return The neighbor, or the value given by the boundary mode outside of the array
+       */
+      template<typename... Offsets>
+        requires (sizeof...(Offsets) == Rank && (std::is_integral_v<Offsets> && ...))
+      [[nodiscard]] MATLABW_ALWAYS_INLINE T operator()(Offsets... offsets) const noexcept
+      {
+        const std::array<std::ptrdiff_t, Rank> off{static_cast<std::ptrdiff_t>(offsets)...};
+
+        std::ptrdiff_t k{};
+
+        for (std::size_t r{}; r < Rank; ++r)
+        {
+          const std::ptrdiff_t n = mExtents[r];
+          std::ptrdiff_t       q = mIndex[r] + off[r];
+
+          if (q < 0 || q >= n)
+          {
+            switch (mBoundary)
+            {
+            case StencilBoundary::zero:
+              return T{};
+            case StencilBoundary::periodic:
+              q = ((q % n) + n) % n;
+              break;
+            default:
+              q = std::clamp(q, std::ptrdiff_t{}, n - 1);
+              break;
+            }
+          }
+
+          k += q * mStrides[r];
+        }
+
+        return mData[k];
+      }
+    private:
+      const T*                         mData{};     ///< Pointer to the data of the array
+      std::array<std::ptrdiff_t, Rank> mExtents{};  ///< Extents of the array
+      std::array<std::ptrdiff_t, Rank> mStrides{};  ///< Strides of the array in elements
+      std::array<std::ptrdiff_t, Rank> mIndex{};    ///< Index of the center element
+      StencilBoundary                  mBoundary{}; ///< The boundary mode
+  };
+
+namespace detail
+{
+  /**
+   * @brief Extent of a tile along the first dimension. A tile row and its neighbor rows stay in the L1 cache while
+   *        the row is computed.
+   */
+  inline constexpr std::size_t stencilTileRows{512};
+
+  /**
+   * @brief Extent of a tile along the other dimensions. The neighbor rows of one slice of a tile are reused by the
+   *        next slices from the L2 cache.
+   */
+  inline constexpr std::size_t stencilTileCols{16};
+
+  /**
+   * @brief Gets the extent of a tile along a dimension.
+   * @param r The dimension
+   * @return The extent
+   */
+  [[nodiscard]] constexpr std::size_t getStencilTileExtent(std::size_t r) noexcept
+  {
+    return (r == 0) ? stencilTileRows : stencilTileCols;
+  }
+
+  /**
+   * @brief Computes the stencil over one tile, rows of the tile fully inside the interior take the unchecked path.
+   * @tparam T Input element type
+   * @tparam U Output element type
+   * @tparam Rank Rank of the arrays
+   * @tparam Fn Stencil function type
+   * @param in Input data
+   * @param out Output data, strides equal to the input
+   * @param extents Extents of the arrays
+   * @param strides Strides of the arrays in elements
+   * @param first First index of the tile
+   * @param last Past the end index of the tile
+   * @param radius Radius of the stencil
+   * @param boundary The boundary mode
+   * @param fn The stencil function
+   */
+  template<typename T, typename U, std::size_t Rank, typename Fn>
+  MATLABW_ALWAYS_INLINE void stencilTile(const T*                                in,
+                                         U*                                      out,
+                                         const std::array<std::ptrdiff_t, Rank>& extents,
+                                         const std::array<std::ptrdiff_t, Rank>& strides,
+                                         const std::array<std::ptrdiff_t, Rank>& first,
+                                         const std::array<std::ptrdiff_t, Rank>& last,
+                                         std::ptrdiff_t                          radius,
+                                         StencilBoundary                         boundary,
+                                         Fn&                                     fn)
+  {
+    const std::ptrdiff_t interiorFirst = std::clamp(radius, first[0], last[0]);
+    const std::ptrdiff_t interiorLast  = std::clamp(extents[0] - radius, interiorFirst, last[0]);
+
+    std::array<std::ptrdiff_t, Rank> index{first};
+
+    auto border = [&](std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t offset) MATLABW_INLINE_LAMBDA
+    {
+      for (std::ptrdiff_t i{begin}; i < end; ++i)
+      {
+        index[0]        = i;
+        out[offset + i] = fn(StencilBorder<T, Rank>{in, extents, strides, index, boundary});
+      }
+    };
+
+    while (true)
+    {
+      std::ptrdiff_t offset{};
+      bool           interior{true};
+
+      for (std::size_t r{1}; r < Rank; ++r)
+      {
+        offset   += index[r] * strides[r];
+        interior  = interior && index[r] >= radius && index[r] < extents[r] - radius;
+      }
+
+      if (interior)
+      {
+        border(first[0], interiorFirst, offset);
+
+        const T* const src = in + offset;
+        U* const       dst = out + offset;
+
+        for (std::ptrdiff_t i{interiorFirst}; i < interiorLast; ++i)
+        {
+          dst[i] = fn(StencilInterior<T, Rank>{src + i, strides});
+        }
+
+        border(interiorLast, last[0], offset);
+      }
+      else
+      {
+        border(first[0], last[0], offset);
+      }
+
+      // Advances the index over the other dimensions of the tile, the second dimension fastest.
+      std::size_t r{1};
+
+      for (; r < Rank; ++r)
+      {
+        if (++index[r] < last[r])
+        {
+          break;
+        }
+
+        index[r] = first[r];
+      }
+
+      if (r == Rank)
+      {
+        break;
+      }
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes a stencil, out(i) = fn(neighborhood of in(i)) for every element. The arrays are split into tiles
+   *        that fit in the cache, large arrays compute the tiles in parallel on the library-managed thread pool. Each
+   *        tile is compiled for the best instruction set and its interior rows are vectorized loops. The function is
+   *        called with a StencilInterior or a StencilBorder neighborhood, so it should be a generic lambda marked with
+   *        MATLABW_INLINE_LAMBDA, e.g. a 5-point Laplacian:
+   *
+   *          stencil(in, out, 1, StencilBoundary::replicate, [](const auto& x) MATLABW_INLINE_LAMBDA
+   *          {
+   *            return x(-1, 0) + x(1, 0) + x(0, -1) + x(0, 1) - 4.0 * x(0, 0);
+   *          });
+   *
+   *        The function may run outside of the MATLAB thread, so it must not call the MATLAB API.
+   * @tparam T Input element type
+   * @tparam U Output element type
+   * @tparam Ext Extents type
+   * @tparam Fn Stencil function type, called as fn(neighborhood), the neighborhood is called as x(offsets...)
+   * @param in The input view
+   * @param out The output view of the same extents, must not overlap the input
+   * @param radius Largest offset the function reads along any dimension
+   * @param boundary Values read outside of the input
+   * @param fn The stencil function
+   */
+  template<typename T, typename U, typename Ext, typename Fn>
+  void stencil(MdSpan<T, Ext> in, MdSpan<U, Ext> out, std::size_t radius, StencilBoundary boundary, Fn fn)
+  {
+    using Value = std::remove_cv_t<T>;
+
+    static_assert(!std::is_const_v<U>, "output must be writable");
+
+    constexpr std::size_t rank = Ext::rank();
+
+    std::array<std::ptrdiff_t, rank> extents{};
+    std::array<std::ptrdiff_t, rank> strides{};
+    std::array<std::size_t, rank>    tiles{};
+    std::size_t                      tileCount{1};
+
+    for (std::size_t r{}; r < rank; ++r)
+    {
+      if (out.extent(r) != in.extent(r))
+      {
+        throw Exception{"matlabw:mx:algorithm:stencil", "input and output must have the same size"};
+      }
+
+      extents[r]  = static_cast<std::ptrdiff_t>(in.extent(r));
+      strides[r]  = static_cast<std::ptrdiff_t>(in.stride(r));
+      tiles[r]    = (in.extent(r) + detail::getStencilTileExtent(r) - 1) / detail::getStencilTileExtent(r);
+      tileCount  *= tiles[r];
+    }
+
+    const Value* const src = in.data_handle();
+    U* const           dst = out.data_handle();
+
+    if (tileCount == 0)
+    {
+      return;
+    }
+
+    if (static_cast<const void*>(src) == static_cast<const void*>(dst))
+    {
+      throw Exception{"matlabw:mx:algorithm:stencil", "output must not be the input"};
+    }
+
+    auto tile = [&](std::size_t t)
+    {
+      std::array<std::ptrdiff_t, rank> first{};
+      std::array<std::ptrdiff_t, rank> last{};
+
+      for (std::size_t r{}; r < rank; ++r)
+      {
+        const auto extent = static_cast<std::ptrdiff_t>(detail::getStencilTileExtent(r));
+
+        first[r]  = static_cast<std::ptrdiff_t>(t % tiles[r]) * extent;
+        last[r]   = std::min(first[r] + extent, extents[r]);
+        t        /= tiles[r];
+      }
+
+      detail::dispatch([&]() MATLABW_INLINE_LAMBDA
+      {
+        detail::stencilTile(src, dst, extents, strides, first, last, static_cast<std::ptrdiff_t>(radius), boundary,
+                            fn);
+      });
+    };
+
+    if (tileCount > 1 && in.size() >= detail::parallelMinSize)
+    {
+      parallel::parallelFor(0, tileCount, 1, tile);
+    }
+    else
+    {
+      for (std::size_t t{}; t < tileCount; ++t)
+      {
+        tile(t);
+      }
+    }
+  }
+
+  /**
+   * @brief Computes a stencil over arrays, viewed with the given rank.
+   * @see stencil()
+   * @tparam Rank Rank of the views, trailing dimensions are folded into the last one
+   * @tparam In Input array type with dimensions (TypedArrayCref, TypedArray, ...)
+   * @tparam Out Output array type with dimensions (TypedArrayRef, TypedArray, ...)
+   * @tparam Fn Stencil function type
+   * @param in The input array
+   * @param out The output array of the same dimensions
+   * @param radius Largest offset the function reads along any dimension
+   * @param boundary Values read outside of the input
+   * @param fn The stencil function
+   */
+  template<std::size_t Rank, typename In, typename Out, typename Fn>
+    requires requires(const In& x, Out& y) { x.template toMdspan<Rank>(); y.template toMdspan<Rank>(); }
+  void stencil(const In& in, Out&& out, std::size_t radius, StencilBoundary boundary, Fn fn)
+  {
+    if (!std::ranges::equal(in.getDims(), out.getDims()))
+    {
+      throw Exception{"matlabw:mx:algorithm:stencil", "input and output must have the same size"};
+    }
+
+    stencil(in.template toMdspan<Rank>(), out.template toMdspan<Rank>(), radius, boundary, std::move(fn));
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_STENCIL_HPP */
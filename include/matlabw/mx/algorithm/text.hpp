@@ -0,0 +1,657 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_ALGORITHM_TEXT_HPP
+#define MATLABW_MX_ALGORITHM_TEXT_HPP
+
+#include "../detail/include.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+#include "detail/arithmetic.hpp"
+#include "detail/parallel.hpp"
+#include "detail/simd.hpp"
+#include "detail/span.hpp"
+#include "../CharArray.hpp"
+#include "../detail/utf8.hpp"
+#include "../NumericArray.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Range of code units of a text, [first, last).
+  struct TextRange
+  {
+    std::size_t first{}; ///< Index of the first code unit
+    std::size_t last{};  ///< Index past the last code unit
+
+    /**
+     * @brief Gets the number of code units.
+     * @return The size
+     */
+    [[nodiscard]] constexpr std::size_t size() const noexcept
+    {
+      return last - first;
+    }
+
+    /// @brief Compares two ranges.
+    [[nodiscard]] constexpr bool operator==(const TextRange&) const noexcept = default;
+  };
+
+namespace detail
+{
+  /// @brief Maximum number of delimiters compared in vector registers, larger sets are searched unit by unit.
+  inline constexpr std::size_t textVectorSetSize{4};
+
+  /// @brief Maximum length of a number copied to the stack for parsing, longer fields are copied to the heap.
+  inline constexpr std::size_t textNumberBufferSize{128};
+
+  /**
+   * @brief Gets a span over a text and checks its element type.
+   * @tparam Text Text type
+   * @param text The text
+   * @return The span
+   */
+  template<typename Text>
+  [[nodiscard]] auto toTextSpan(const Text& text) noexcept
+  {
+    auto span = toSpan(text);
+
+    static_assert(std::is_same_v<ElementType<decltype(span)>, char16_t>, "text element type must be char16_t");
+
+    return span;
+  }
+
+  /**
+   * @brief Calls a function with the index of each code unit in a set, 16 units are compared per step.
+   * @tparam Fn Function type, called as fn(i) in increasing order, returns false to stop
+   * @param text Pointer to the text
+   * @param n Number of code units
+   * @param set The set of code units
+   * @return True if stopped by the function
+   */
+  template<typename Fn>
+  MATLABW_ALWAYS_INLINE bool forEachMatch(const char16_t* text, std::size_t n, std::u16string_view set, Fn&& fn)
+  {
+    std::size_t i{};
+
+#if defined(__SSE2__)
+    if (!set.empty() && set.size() <= textVectorSetSize)
+    {
+      __m128i keys[textVectorSetSize]{};
+
+      for (std::size_t k{}; k < set.size(); ++k)
+      {
+        keys[k] = _mm_set1_epi16(static_cast<short>(set[k]));
+      }
+
+      for (; i + 16 <= n; i += 16)
+      {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + 8));
+
+        __m128i matchLo = _mm_cmpeq_epi16(lo, keys[0]);
+        __m128i matchHi = _mm_cmpeq_epi16(hi, keys[0]);
+
+        for (std::size_t k{1}; k < set.size(); ++k)
+        {
+          matchLo = _mm_or_si128(matchLo, _mm_cmpeq_epi16(lo, keys[k]));
+          matchHi = _mm_or_si128(matchHi, _mm_cmpeq_epi16(hi, keys[k]));
+        }
+
+        // Saturating packing keeps the all-ones and zero lanes, one mask bit per code unit.
+        auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(matchLo, matchHi)));
+
+        for (; bits != 0; bits &= bits - 1)
+        {
+          if (!fn(i + static_cast<std::size_t>(std::countr_zero(bits))))
+          {
+            return true;
+          }
+        }
+      }
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+      if (set.find(text[i]) != std::u16string_view::npos && !fn(i))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Splits a text at each delimiter, empty fields are kept.
+   * @param text Pointer to the text
+   * @param first Index of the first code unit
+   * @param last Index past the last code unit
+   * @param delimiters The delimiters
+   * @param ranges Output, the fields are appended
+   */
+  inline void splitText(const char16_t*         text,
+                        std::size_t             first,
+                        std::size_t             last,
+                        std::u16string_view     delimiters,
+                        std::vector<TextRange>& ranges)
+  {
+    std::size_t begin = first;
+
+    forEachMatch(text + first, last - first, delimiters, [&](std::size_t i)
+    {
+      ranges.push_back(TextRange{begin, first + i});
+      begin = first + i + 1;
+      return true;
+    });
+
+    ranges.push_back(TextRange{begin, last});
+  }
+
+  /**
+   * @brief Checks if a code unit is ASCII white space.
+   * @param c The code unit
+   * @return True for space, tab, line feed, vertical tab, form feed and carriage return
+   */
+  [[nodiscard]] constexpr bool isTextSpace(char16_t c) noexcept
+  {
+    return c == u' ' || (c >= u'\t' && c <= u'\r');
+  }
+
+  /**
+   * @brief Trims white space of a field.
+   * @param first Pointer to the first code unit
+   * @param last Pointer past the last code unit
+   * @return The trimmed field
+   */
+  [[nodiscard]] inline std::u16string_view trimText(const char16_t* first, const char16_t* last) noexcept
+  {
+    while (first != last && isTextSpace(*first))
+    {
+      ++first;
+    }
+
+    while (last != first && isTextSpace(last[-1]))
+    {
+      --last;
+    }
+
+    return std::u16string_view{first, static_cast<std::size_t>(last - first)};
+  }
+
+  /**
+   * @brief Parses a floating point field as str2double does, the field is narrowed to ASCII with SSE2 and parsed by
+   *        std::from_chars, which implements the Eisel-Lemire algorithm in the standard libraries. A leading plus
+   *        sign, Inf and NaN in any case are accepted, out of range values become Inf or zero.
+   * @tparam T Floating point type
+   * @param field The field, white space trimmed
+   * @return The value, NaN if the field is empty or not a number
+   */
+  template<typename T>
+  [[nodiscard]] T parseFloatField(std::u16string_view field)
+  {
+    constexpr T nan = std::numeric_limits<T>::quiet_NaN();
+
+    if (!field.empty() && field.front() == u'+')
+    {
+      field.remove_prefix(1);
+
+      if (!field.empty() && (field.front() == u'-' || field.front() == u'+'))
+      {
+        return nan;
+      }
+    }
+
+    if (field.empty())
+    {
+      return nan;
+    }
+
+    char              stack[textNumberBufferSize];
+    std::string       heap{};
+    char*             chars = stack;
+    const std::size_t n     = field.size();
+
+    if (n > textNumberBufferSize)
+    {
+      heap.resize(n);
+      chars = heap.data();
+    }
+
+    if (mx::detail::copyAscii(field.data(), n, chars) != n)
+    {
+      return nan;
+    }
+
+    T value{};
+
+#if defined(__cpp_lib_to_chars)
+    const auto [end, error] = std::from_chars(chars, chars + n, value, std::chars_format::general);
+
+    if (end != chars + n)
+    {
+      return nan;
+    }
+
+    if (error == std::errc{})
+    {
+      return value;
+    }
+#endif
+
+    // Out of range values, or no floating point std::from_chars, are parsed by strtod, which saturates them.
+    const std::string buffer{chars, n};
+    char*             parsedEnd{};
+    const double      parsed = std::strtod(buffer.c_str(), &parsedEnd);
+
+    return (parsedEnd == buffer.c_str() + n) ? static_cast<T>(parsed) : nan;
+  }
+
+  /**
+   * @brief Parses an integer field of decimal digits with an optional sign.
+   * @tparam T Integer type
+   * @param id Error identifier
+   * @param field The field, white space trimmed
+   * @return The value
+   * @throws Exception if the field is not an integer of the type
+   */
+  template<typename T>
+  [[nodiscard]] T parseIntegerField(const char* id, std::u16string_view field)
+  {
+    bool negative{};
+
+    if (!field.empty() && (field.front() == u'-' || field.front() == u'+'))
+    {
+      negative = (field.front() == u'-');
+      field.remove_prefix(1);
+    }
+
+    if (field.empty())
+    {
+      throw Exception{id, "field is not an integer"};
+    }
+
+    // The magnitude of the minimum of a signed type is one more than the maximum.
+    const std::uint64_t limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max())
+                                + ((negative && std::is_signed_v<T>) ? 1 : 0);
+
+    std::uint64_t magnitude{};
+
+    for (const char16_t c : field)
+    {
+      const auto digit = static_cast<std::uint64_t>(c - u'0');
+
+      if (digit > 9)
+      {
+        throw Exception{id, "field is not an integer"};
+      }
+
+      if (magnitude > (limit - digit) / 10)
+      {
+        throw Exception{id, "integer is out of range of the type"};
+      }
+
+      magnitude = magnitude * 10 + digit;
+    }
+
+    if constexpr (std::is_signed_v<T>)
+    {
+      return negative ? static_cast<T>(~magnitude + 1) : static_cast<T>(magnitude);
+    }
+    else
+    {
+      if (negative && magnitude != 0)
+      {
+        throw Exception{id, "integer is out of range of the type"};
+      }
+
+      return static_cast<T>(magnitude);
+    }
+  }
+
+  /**
+   * @brief Parses a number field.
+   * @tparam T Real numeric type
+   * @param id Error identifier
+   * @param first Pointer to the first code unit
+   * @param last Pointer past the last code unit
+   * @return The value
+   */
+  template<typename T>
+  [[nodiscard]] T parseField(const char* id, const char16_t* first, const char16_t* last)
+  {
+    const std::u16string_view field = trimText(first, last);
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+      static_cast<void>(id);
+      return parseFloatField<T>(field);
+    }
+    else
+    {
+      return parseIntegerField<T>(id, field);
+    }
+  }
+
+  /**
+   * @brief Runs a loop over fields or rows, in parallel for large texts.
+   * @tparam Fn Loop body type, called as fn(first, last)
+   * @param textSize Number of code units of the text
+   * @param n Number of fields or rows
+   * @param fn The loop body
+   */
+  template<typename Fn>
+  void forTextChunks(std::size_t textSize, std::size_t n, Fn&& fn)
+  {
+    if (textSize < parallelMinSize)
+    {
+      fn(std::size_t{}, n);
+      return;
+    }
+
+    parallelChunks(n, fn);
+  }
+
+  /**
+   * @brief Lower case mapping of ASCII and Latin-1 letters, branchless so that the compiler vectorizes it.
+   * @param c The code unit
+   * @return The lower case code unit
+   */
+  MATLABW_ALWAYS_INLINE char16_t toLowerUnit(char16_t c) noexcept
+  {
+    const bool ascii = static_cast<char16_t>(c - u'A') < 26;
+    const bool latin = static_cast<char16_t>(c - 0xC0) < 0x1F && c != 0xD7;
+
+    return static_cast<char16_t>(c + ((ascii | latin) << 5));
+  }
+
+  /**
+   * @brief Upper case mapping of ASCII and Latin-1 letters, branchless so that the compiler vectorizes it.
+   * @param c The code unit
+   * @return The upper case code unit
+   */
+  MATLABW_ALWAYS_INLINE char16_t toUpperUnit(char16_t c) noexcept
+  {
+    const bool ascii = static_cast<char16_t>(c - u'a') < 26;
+    const bool latin = static_cast<char16_t>(c - 0xE0) < 0x1F && c != 0xF7;
+
+    return static_cast<char16_t>(c - ((ascii | latin) << 5));
+  }
+
+  /**
+   * @brief Maps the case of each code unit.
+   * @tparam Op Mapping type
+   * @param id Error identifier
+   * @param op The mapping
+   * @param out Output
+   * @param in Input
+   */
+  template<typename Op, typename Out, typename In>
+  void mapCase(const char* id, Op op, Out&& out, const In& in)
+  {
+    auto dst = toSpan(out);
+    auto src = toTextSpan(in);
+
+    static_assert(std::is_same_v<ElementType<decltype(dst)>, char16_t>, "output element type must be char16_t");
+
+    checkSizes(id, dst.size(), src.size());
+    transform(op, dst.size(), dst.data(), src.data());
+  }
+} // namespace detail
+
+  /**
+   * @brief Finds the first code unit of a set, delimiters are compared 16 code units at a time.
+   * @param text Text of char16_t code units (CharArrayCref, std::u16string_view, span, ...)
+   * @param set The set of code units
+   * @param from Index to start at
+   * @return Index of the first code unit of the set, std::u16string_view::npos if there is none
+   */
+  template<typename Text>
+  [[nodiscard]] std::size_t findFirstOf(const Text& text, std::u16string_view set, std::size_t from = 0)
+  {
+    auto src = detail::toTextSpan(text);
+
+    if (from >= src.size())
+    {
+      return std::u16string_view::npos;
+    }
+
+    std::size_t index{std::u16string_view::npos};
+
+    detail::forEachMatch(src.data() + from, src.size() - from, set, [&](std::size_t i)
+    {
+      index = from + i;
+      return false;
+    });
+
+    return index;
+  }
+
+  /**
+   * @brief Counts the code units of a set.
+   * @param text Text of char16_t code units
+   * @param set The set of code units
+   * @return The count
+   */
+  template<typename Text>
+  [[nodiscard]] std::size_t countOf(const Text& text, std::u16string_view set)
+  {
+    auto src = detail::toTextSpan(text);
+
+    std::size_t count{};
+
+    detail::forEachMatch(src.data(), src.size(), set, [&](std::size_t)
+    {
+      ++count;
+      return true;
+    });
+
+    return count;
+  }
+
+  /**
+   * @brief Splits a text at each delimiter into ranges of code units, empty fields are kept as in strsplit with
+   *        CollapseDelimiters false.
+   * @param text Text of char16_t code units
+   * @param delimiters The delimiters
+   * @return The fields, one more than the number of delimiters
+   */
+  template<typename Text>
+  [[nodiscard]] std::vector<TextRange> split(const Text& text, std::u16string_view delimiters)
+  {
+    auto src = detail::toTextSpan(text);
+
+    std::vector<TextRange> ranges{};
+
+    detail::splitText(src.data(), 0, src.size(), delimiters, ranges);
+
+    return ranges;
+  }
+
+  /**
+   * @brief Converts ASCII and Latin-1 letters to lower case, other characters are unchanged.
+   * @param out Output of char16_t elements, may be the input
+   * @param in Input text
+   */
+  template<typename Out, typename In>
+  void toLower(Out&& out, const In& in)
+  {
+    detail::mapCase("matlabw:mx:algorithm:toLower",
+                    [](char16_t c) MATLABW_INLINE_LAMBDA { return detail::toLowerUnit(c); }, out, in);
+  }
+
+  /**
+   * @brief Converts ASCII and Latin-1 letters to lower case, other characters are unchanged.
+   * @param in Input char array
+   * @return The char array, the same size as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] CharArray toLower(const In& in)
+  {
+    CharArray out = makeCharArray(in.getDims());
+
+    toLower(out, in);
+
+    return out;
+  }
+
+  /**
+   * @brief Converts ASCII and Latin-1 letters to upper case, other characters are unchanged. The sharp s and the
+   *        letters whose upper case is outside of Latin-1 are kept.
+   * @param out Output of char16_t elements, may be the input
+   * @param in Input text
+   */
+  template<typename Out, typename In>
+  void toUpper(Out&& out, const In& in)
+  {
+    detail::mapCase("matlabw:mx:algorithm:toUpper",
+                    [](char16_t c) MATLABW_INLINE_LAMBDA { return detail::toUpperUnit(c); }, out, in);
+  }
+
+  /**
+   * @brief Converts ASCII and Latin-1 letters to upper case, other characters are unchanged.
+   * @param in Input char array
+   * @return The char array, the same size as the input
+   */
+  template<detail::DimensionedArray In>
+  [[nodiscard]] CharArray toUpper(const In& in)
+  {
+    CharArray out = makeCharArray(in.getDims());
+
+    toUpper(out, in);
+
+    return out;
+  }
+
+  /**
+   * @brief Parses delimited numbers of a text directly from its UTF-16 code units, without converting it first.
+   *        Fields are trimmed of white space, floating point fields which are empty or not a number are NaN as in
+   *        str2double, integer fields must be decimal integers in range of the type. Large texts are parsed in
+   *        parallel.
+   * @tparam T Real numeric output type
+   * @param text Text of char16_t code units
+   * @param delimiters The delimiters
+   * @return Column vector of the fields
+   * @throws Exception if an integer field is invalid
+   */
+  template<typename T = double, typename Text>
+  [[nodiscard]] NumericArray<T> parseNumbers(const Text& text, std::u16string_view delimiters = u",")
+  {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "output type must be real numeric");
+
+    static constexpr char id[]{"matlabw:mx:algorithm:parseNumbers"};
+
+    auto src = detail::toTextSpan(text);
+
+    const std::vector<TextRange> fields = split(src, delimiters);
+
+    NumericArray<T> out = makeUninitNumericArray<T>({{fields.size(), 1}});
+    T*              dst = out.getData();
+
+    detail::forTextChunks(src.size(), fields.size(), [&](std::size_t first, std::size_t last)
+    {
+      for (std::size_t i{first}; i < last; ++i)
+      {
+        dst[i] = detail::parseField<T>(id, src.data() + fields[i].first, src.data() + fields[i].last);
+      }
+    });
+
+    return out;
+  }
+
+  /**
+   * @brief Parses a CSV-like table of a text into a matrix with a row per line, see parseNumbers(). A trailing line
+   *        break is ignored and every row must have the same number of fields. Rows are parsed in parallel for large
+   *        texts.
+   * @tparam T Real numeric output type
+   * @param text Text of char16_t code units
+   * @param delimiters The field delimiters
+   * @param lineBreak The row delimiter, a carriage return before it is trimmed as white space
+   * @return The matrix
+   * @throws Exception if the rows differ in their number of fields or an integer field is invalid
+   */
+  template<typename T = double, typename Text>
+  [[nodiscard]] NumericArray<T> parseTable(const Text&         text,
+                                           std::u16string_view delimiters = u",",
+                                           char16_t            lineBreak  = u'\n')
+  {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "output type must be real numeric");
+
+    static constexpr char id[]{"matlabw:mx:algorithm:parseTable"};
+
+    auto src = detail::toTextSpan(text);
+
+    std::vector<TextRange> rows = split(src, std::u16string_view{&lineBreak, 1});
+
+    if (rows.size() > 1 && detail::trimText(src.data() + rows.back().first, src.data() + rows.back().last).empty())
+    {
+      rows.pop_back();
+    }
+
+    std::vector<TextRange> header{};
+
+    detail::splitText(src.data(), rows.front().first, rows.front().last, delimiters, header);
+
+    const std::size_t m = (src.empty()) ? 0 : rows.size();
+    const std::size_t n = (src.empty()) ? 0 : header.size();
+
+    NumericArray<T> out = makeUninitNumericArray<T>({{m, n}});
+    T*              dst = out.getData();
+
+    detail::forTextChunks(src.size(), m, [&](std::size_t first, std::size_t last)
+    {
+      std::vector<TextRange> fields{};
+
+      for (std::size_t i{first}; i < last; ++i)
+      {
+        fields.clear();
+        detail::splitText(src.data(), rows[i].first, rows[i].last, delimiters, fields);
+
+        if (fields.size() != n)
+        {
+          throw Exception{id, "rows must have the same number of fields"};
+        }
+
+        for (std::size_t j{}; j < n; ++j)
+        {
+          dst[i + j * m] = detail::parseField<T>(id, src.data() + fields[j].first, src.data() + fields[j].last);
+        }
+      }
+    });
+
+    return out;
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_TEXT_HPP */
@@ -0,0 +1,257 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_ALGORITHM_VISIT_MANY_HPP
+#define MATLABW_MX_ALGORITHM_VISIT_MANY_HPP
+
+#include "../detail/include.hpp"
+
+#include "convert.hpp"
+#include "../visit.hpp"
+
+namespace matlabw::mx::algorithm
+{
+  /// @brief Handling of arrays of different types by visitMany().
+  enum class MixedTypes
+  {
+    reject,  ///< Throw an exception
+    promote, ///< Convert all arrays to the class given by promoteClass()
+  };
+
+  /**
+   * @brief Gets the class of the result of a binary operation on two classes, following MATLAB: logical and char act
+   *        as double, double combined with single or an integer class gives that class, single combined with an integer
+   *        class gives the integer class. Two different integer classes cannot be combined.
+   * @param a First class ID
+   * @param b Second class ID
+   * @return The promoted class ID or std::nullopt if the classes cannot be combined
+   */
+  [[nodiscard]] constexpr std::optional<ClassId> promoteClass(ClassId a, ClassId b) noexcept
+  {
+    constexpr auto normalize = [](ClassId classId)
+    {
+      return (classId == ClassId::logical || classId == ClassId::_char) ? ClassId::_double : classId;
+    };
+
+    constexpr auto isInteger = [](ClassId classId)
+    {
+      switch (classId)
+      {
+      case ClassId::int8:
+      case ClassId::uint8:
+      case ClassId::int16:
+      case ClassId::uint16:
+      case ClassId::int32:
+      case ClassId::uint32:
+      case ClassId::int64:
+      case ClassId::uint64:
+        return true;
+      default:
+        return false;
+      }
+    };
+
+    constexpr auto isNumeric = [isInteger](ClassId classId)
+    {
+      return classId == ClassId::_double || classId == ClassId::single || isInteger(classId);
+    };
+
+    a = normalize(a);
+    b = normalize(b);
+
+    if (!isNumeric(a) || !isNumeric(b))
+    {
+      return std::nullopt;
+    }
+
+    if (a == b || b == ClassId::_double || (a != ClassId::_double && isInteger(a) && b == ClassId::single))
+    {
+      return a;
+    }
+
+    if (a == ClassId::_double || (a == ClassId::single && isInteger(b)))
+    {
+      return b;
+    }
+
+    return std::nullopt;
+  }
+
+namespace detail
+{
+  /**
+   * @brief Jump table calling a callable with the type tag of the type of a key.
+   * @tparam List Type list
+   * @tparam Fn The callable type, called with std::type_identity<T>
+   */
+  template<typename List, typename Fn>
+  struct TypeKeyTable;
+
+  /// @copydoc TypeKeyTable
+  template<typename... Ts, typename Fn>
+  struct TypeKeyTable<TypeList<Ts...>, Fn>
+  {
+    static_assert(sizeof...(Ts) > 0, "type list must not be empty");
+
+    /// @brief Result type, the same for all types.
+    using Result = std::invoke_result_t<Fn&, std::type_identity<std::tuple_element_t<0, std::tuple<Ts...>>>>;
+
+    static_assert((std::is_same_v<Result, std::invoke_result_t<Fn&, std::type_identity<Ts>>> && ...),
+                  "callable must return the same type for all visited types");
+
+    /// @brief Table entry.
+    using Entry = Result (*)(Fn&);
+
+    /// @brief Table size.
+    static constexpr std::size_t size = std::max({mx::detail::getVisitKey<Ts>()...}) + 1;
+
+    /// @brief The table, unlisted types have no entry.
+    static constexpr std::array<Entry, size> table = []
+    {
+      std::array<Entry, size> entries{};
+
+      ((entries[mx::detail::getVisitKey<Ts>()] = [](Fn& fn) -> Result { return fn(std::type_identity<Ts>{}); }), ...);
+
+      return entries;
+    }();
+  };
+
+  /**
+   * @brief Gets the jump table key of a class.
+   * @param classId The class ID
+   * @param complex Is complex?
+   * @return The key
+   */
+  [[nodiscard]] constexpr std::size_t getVisitKey(ClassId classId, bool complex) noexcept
+  {
+    return static_cast<std::size_t>(classId) * 2 + static_cast<std::size_t>(complex);
+  }
+} // namespace detail
+
+  /**
+   * @brief Visits several arrays at once with a single dispatch. The callable is instantiated once per type of the
+   *        list and called with a typed array cref of that type for every array, never with a mix of types. If the
+   *        arrays differ in class or complexity they are either rejected or converted to the promoted class (complex if
+   *        any array is complex) with MATLAB cast semantics. Note that the conversion rounds a double operand before an
+   *        integer operation, MATLAB computes mixed operations in double instead.
+   * @tparam List The type list of element types
+   * @tparam mixed Handling of arrays of different types
+   * @tparam Fn The callable type, called with one TypedArrayCref<T> (CharArrayCref for char16_t) per array
+   * @tparam Arrays The array types, convertible to ArrayCref
+   * @param fn The callable
+   * @param arrays The arrays
+   * @return The result of the callable
+   */
+  template<typename List = NumericTypes, MixedTypes mixed = MixedTypes::reject, typename Fn, typename... Arrays>
+    requires (sizeof...(Arrays) > 0 && (std::is_convertible_v<const Arrays&, ArrayCref> && ...))
+  decltype(auto) visitMany(Fn&& fn, const Arrays&... arrays)
+  {
+    static constexpr char id[]{"matlabw:mx:algorithm:visitMany"};
+
+    constexpr std::size_t count = sizeof...(Arrays);
+
+    const std::array<ArrayCref, count> refs{ArrayCref{arrays}...};
+
+    ClassId classId = refs[0].getClassId();
+    bool    complex = refs[0].isComplex();
+    bool    same    = true;
+
+    for (std::size_t i{1}; i < count; ++i)
+    {
+      const ClassId otherClassId = refs[i].getClassId();
+      const bool    otherComplex = refs[i].isComplex();
+
+      if (otherClassId == classId && otherComplex == complex)
+      {
+        continue;
+      }
+
+      same = false;
+
+      if constexpr (mixed == MixedTypes::reject)
+      {
+        throw Exception{id, "array types must match"};
+      }
+      else
+      {
+        const auto promoted = promoteClass(classId, otherClassId);
+
+        if (!promoted.has_value())
+        {
+          throw Exception{id, "array classes cannot be combined"};
+        }
+
+        classId = *promoted;
+        complex = complex || otherComplex;
+      }
+    }
+
+    auto call = [&]<typename T>(std::type_identity<T>) -> decltype(auto)
+    {
+      return [&]<std::size_t... is>(std::index_sequence<is...>) -> decltype(auto)
+      {
+        if constexpr (mixed == MixedTypes::promote && detail::isConvertTarget<T>)
+        {
+          // Converted copies of the arrays whose type differs, kept alive for the call.
+          std::array<std::optional<NumericArray<T>>, count> converted{};
+
+          if (!same)
+          {
+            for (std::size_t i{}; i < count; ++i)
+            {
+              if (mx::detail::getVisitKey(refs[i]) != mx::detail::getVisitKey<T>())
+              {
+                converted[i].emplace(convertTo<T>(refs[i]));
+              }
+            }
+          }
+
+          auto ref = [&](std::size_t i)
+          {
+            return converted[i].has_value() ? ArrayCref{*converted[i]} : refs[i];
+          };
+
+          return std::invoke(fn, mx::detail::TypedVisitRef<T, ArrayCref>{ref(is)}...);
+        }
+        else
+        {
+          return std::invoke(fn, mx::detail::TypedVisitRef<T, ArrayCref>{refs[is]}...);
+        }
+      }(std::make_index_sequence<count>{});
+    };
+
+    using Table = detail::TypeKeyTable<List, decltype(call)>;
+
+    const std::size_t key = detail::getVisitKey(classId, complex);
+
+    if (key >= Table::size || Table::table[key] == nullptr)
+    {
+      throw Exception{id, "unsupported array type"};
+    }
+
+    return Table::table[key](call);
+  }
+} // namespace matlabw::mx::algorithm
+
+#endif /* MATLABW_MX_ALGORITHM_VISIT_MANY_HPP */
@@ -0,0 +1,81 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_CLEANUP_HPP
+#define MATLABW_MX_CLEANUP_HPP
+
+#include "detail/include.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief Function that registers a cleanup handler with the host of the library, such as mex::atExit.
+  using CleanupRegistrar = void (*)(std::function<void()> handler);
+
+namespace detail
+{
+  /**
+   * @brief Gets the installed cleanup registrar.
+   * @return The cleanup registrar, nullptr if none is installed.
+   */
+  [[nodiscard]] inline CleanupRegistrar& getCleanupRegistrar() noexcept
+  {
+    static CleanupRegistrar registrar{};
+
+    return registrar;
+  }
+} // namespace detail
+
+  /**
+   * @brief Installs the registrar of cleanup handlers. MEX files install mex::atExit on every call, so library-wide
+   *        resources are released before the MEX file is unloaded.
+   * @param registrar The cleanup registrar, nullptr to uninstall.
+   */
+  inline void setCleanupRegistrar(CleanupRegistrar registrar) noexcept
+  {
+    detail::getCleanupRegistrar() = registrar;
+  }
+
+  /**
+   * @brief Registers a handler that releases a library-wide resource (e.g. joins threads) before the module is
+   *        unloaded. Without an installed registrar the handler is not stored and the resource must be released by its
+   *        static destructor.
+   * @param handler The handler.
+   * @return True if the handler was registered, false if no registrar is installed.
+   */
+  inline bool registerCleanup(std::function<void()> handler)
+  {
+    CleanupRegistrar registrar = detail::getCleanupRegistrar();
+
+    if (registrar == nullptr)
+    {
+      return false;
+    }
+
+    registrar(std::move(handler));
+
+    return true;
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_CLEANUP_HPP */
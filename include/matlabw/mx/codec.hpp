@@ -0,0 +1,772 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_CODEC_HPP
+#define MATLABW_MX_CODEC_HPP
+
+#include "detail/include.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "ArrayRef.hpp"
+#include "TypedArrayRef.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief Lightweight encoding of a dense payload, stored in serialized streams and shared memory segments.
+  enum class Codec : std::uint8_t
+  {
+    raw,     ///< The elements as they are.
+    rle,     ///< Run-length encoding, for masks and piecewise constant data.
+    delta,   ///< Bit-packed zigzag deltas of consecutive elements, for slowly varying counters.
+    bitPack, ///< Bit-packed offsets from the minimum of each block, for integers of a small range.
+  };
+
+  /// @brief Options of the codec selection.
+  struct CodecOptions
+  {
+    std::size_t minBytes{4096};      ///< Payloads smaller than this are stored raw.
+    std::size_t sampleSize{1 << 14}; ///< Number of leading elements the codec sizes are estimated from.
+    double      maxRatio{0.75};      ///< A codec is used only if it shrinks the payload below this ratio.
+  };
+
+  /// @brief Encoded payload, see compress().
+  struct EncodedPayload
+  {
+    Codec                  codec{}; ///< The codec, raw if the payload was not compressible.
+    std::vector<std::byte> bytes{}; ///< The encoded bytes, empty if raw.
+  };
+
+namespace detail
+{
+  /// @brief Number of elements of a bit-packed block, each block is packed to a whole number of 64-bit words.
+  inline constexpr std::size_t codecBlockSize{128};
+
+  /// @brief Dense payload seen by the codecs, complex payloads are encoded as interleaved real elements.
+  struct CodecInput
+  {
+    const std::byte* data;        ///< The elements.
+    std::size_t      elementSize; ///< Size of an element, 1, 2, 4 or 8 bytes.
+    std::size_t      count;       ///< Number of elements.
+    bool             isSigned;    ///< Are the elements signed integers?
+  };
+
+  /**
+   * @brief Describes the payload of an array for the codecs.
+   * @param id The error identifier.
+   * @param array The dense numeric, logical or char array.
+   * @return The codec input.
+   */
+  [[nodiscard]] inline CodecInput getCodecInput(const char* id, ArrayCref array)
+  {
+    const ClassId classId = array.getClassId();
+
+    if (array.isSparse() || (!array.isNumeric() && classId != ClassId::logical && classId != ClassId::_char))
+    {
+      throw Exception{id, "array must be a dense numeric, logical or char array"};
+    }
+
+    const std::size_t parts = (array.isComplex()) ? 2 : 1;
+
+    return CodecInput{static_cast<const std::byte*>(array.getData()),
+                      array.getSizeOfElement() / parts,
+                      array.getSize() * parts,
+                      classId == ClassId::int8 || classId == ClassId::int16 ||
+                      classId == ClassId::int32 || classId == ClassId::int64};
+  }
+
+  /**
+   * @brief Calls a function with a value of the unsigned word type of an element size.
+   * @tparam Fn Function type, called as fn(U{})
+   * @param elementSize The element size.
+   * @param fn The function.
+   * @return The result of the function.
+   */
+  template<typename Fn>
+  decltype(auto) visitCodecWord(std::size_t elementSize, Fn&& fn)
+  {
+    switch (elementSize)
+    {
+    case 1:
+      return fn(std::uint8_t{});
+    case 2:
+      return fn(std::uint16_t{});
+    case 4:
+      return fn(std::uint32_t{});
+    case 8:
+      return fn(std::uint64_t{});
+    default:
+      throw Exception{"matlabw:mx:codec", "unsupported element size"};
+    }
+  }
+
+  /**
+   * @brief Maps a word so that unsigned order matches the order of the element type.
+   * @tparam U Word type
+   * @param x The word.
+   * @param isSigned Is the element type signed?
+   * @return The mapped word, the mapping is its own inverse.
+   */
+  template<typename U>
+  [[nodiscard]] constexpr U mapCodecOrder(U x, bool isSigned) noexcept
+  {
+    return (isSigned) ? static_cast<U>(x ^ (U{1} << (std::numeric_limits<U>::digits - 1))) : x;
+  }
+
+  /**
+   * @brief Zigzag encodes a wrapping difference, so that small negative and positive deltas have few bits.
+   * @tparam U Word type
+   * @param d The difference.
+   * @return The encoded difference.
+   */
+  template<typename U>
+  [[nodiscard]] constexpr U zigzagEncode(U d) noexcept
+  {
+    return static_cast<U>(static_cast<U>(d << 1) ^ static_cast<U>(U{} - (d >> (std::numeric_limits<U>::digits - 1))));
+  }
+
+  /**
+   * @brief Decodes a zigzag encoded difference.
+   * @tparam U Word type
+   * @param z The encoded difference.
+   * @return The difference.
+   */
+  template<typename U>
+  [[nodiscard]] constexpr U zigzagDecode(U z) noexcept
+  {
+    return static_cast<U>((z >> 1) ^ static_cast<U>(U{} - (z & 1)));
+  }
+
+  /**
+   * @brief Appends bytes to an encoded payload.
+   * @param out The payload.
+   * @param data The bytes.
+   * @param size The number of bytes.
+   */
+  inline void appendCodecBytes(std::vector<std::byte>& out, const void* data, std::size_t size)
+  {
+    const auto* bytes = static_cast<const std::byte*>(data);
+
+    out.insert(out.end(), bytes, bytes + size);
+  }
+
+  /// @brief Reader of an encoded payload, checks that it is not truncated.
+  class CodecReader
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param bytes The encoded payload.
+       */
+      explicit CodecReader(View<std::byte> bytes) noexcept
+      : mBytes{bytes}
+      {}
+
+      /**
+       * @brief Reads bytes.
+       * @param data The destination.
+       * @param size The number of bytes.
+       */
+      void read(void* data, std::size_t size)
+      {
+        if (size > mBytes.size() - mOffset)
+        {
+          throw Exception{"matlabw:mx:decode", "encoded payload is truncated"};
+        }
+
+        if (size > 0)
+        {
+          std::memcpy(data, mBytes.data() + mOffset, size);
+        }
+
+        mOffset += size;
+      }
+
+      /**
+       * @brief Reads a value.
+       * @tparam T Value type
+       * @return The value.
+       */
+      template<typename T>
+      [[nodiscard]] T read()
+      {
+        T value{};
+        read(&value, sizeof(T));
+
+        return value;
+      }
+
+      /// @brief Checks that the whole payload was read.
+      void checkEnd() const
+      {
+        if (mOffset != mBytes.size())
+        {
+          throw Exception{"matlabw:mx:decode", "encoded payload has trailing bytes"};
+        }
+      }
+    private:
+      View<std::byte> mBytes;    ///< The encoded payload.
+      std::size_t     mOffset{}; ///< The offset of the next byte.
+  };
+
+  /**
+   * @brief Packs a block of offsets into 2 * width words, the loop has no data dependent branches.
+   * @tparam U Word type
+   * @param in The offsets, codecBlockSize of them, each fits in width bits.
+   * @param width The bit width.
+   * @param words The output words.
+   */
+  template<typename U>
+  void packCodecBlock(const U* in, unsigned width, std::uint64_t* words) noexcept
+  {
+    std::fill_n(words, 2 * width, std::uint64_t{});
+
+    for (std::size_t k{}; k < codecBlockSize && width > 0; ++k)
+    {
+      const std::uint64_t v      = in[k];
+      const std::size_t   bit    = k * width;
+      const std::size_t   word   = bit / 64;
+      const std::size_t   offset = bit % 64;
+
+      words[word] |= v << offset;
+
+      if (offset + width > 64)
+      {
+        words[word + 1] |= v >> (64 - offset);
+      }
+    }
+  }
+
+  /**
+   * @brief Unpacks a block of offsets packed by packCodecBlock().
+   * @tparam U Word type
+   * @param words The packed words.
+   * @param width The bit width.
+   * @param out The offsets, codecBlockSize of them.
+   */
+  template<typename U>
+  void unpackCodecBlock(const std::uint64_t* words, unsigned width, U* out) noexcept
+  {
+    if (width == 0)
+    {
+      std::fill_n(out, codecBlockSize, U{});
+      return;
+    }
+
+    const std::uint64_t mask = (width == 64) ? ~std::uint64_t{} : (std::uint64_t{1} << width) - 1;
+
+    for (std::size_t k{}; k < codecBlockSize; ++k)
+    {
+      const std::size_t bit    = k * width;
+      const std::size_t word   = bit / 64;
+      const std::size_t offset = bit % 64;
+
+      std::uint64_t v = words[word] >> offset;
+
+      if (offset + width > 64)
+      {
+        v |= words[word + 1] << (64 - offset);
+      }
+
+      out[k] = static_cast<U>(v & mask);
+    }
+  }
+
+  /**
+   * @brief Bit-packs words by blocks, each block stores its minimum, the bit width and the packed offsets.
+   * @tparam U Word type
+   * @param in The words.
+   * @param n The number of words.
+   * @param out The encoded payload, appended to.
+   */
+  template<typename U>
+  void encodeBitPack(const U* in, std::size_t n, std::vector<std::byte>& out)
+  {
+    U             block[codecBlockSize];
+    std::uint64_t words[2 * std::numeric_limits<U>::digits];
+
+    for (std::size_t first{}; first < n; first += codecBlockSize)
+    {
+      const std::size_t size = std::min(codecBlockSize, n - first);
+
+      const auto [minIt, maxIt] = std::minmax_element(in + first, in + first + size);
+
+      const U        reference = *minIt;
+      const unsigned width     = static_cast<unsigned>(std::bit_width(static_cast<U>(*maxIt - reference)));
+
+      for (std::size_t k{}; k < codecBlockSize; ++k)
+      {
+        block[k] = (k < size) ? static_cast<U>(in[first + k] - reference) : U{};
+      }
+
+      packCodecBlock(block, width, words);
+
+      const auto widthByte = static_cast<std::uint8_t>(width);
+
+      appendCodecBytes(out, &reference, sizeof(U));
+      appendCodecBytes(out, &widthByte, 1);
+      appendCodecBytes(out, words, 2 * width * sizeof(std::uint64_t));
+    }
+  }
+
+  /**
+   * @brief Decodes words bit-packed by encodeBitPack().
+   * @tparam U Word type
+   * @param reader The reader of the encoded payload.
+   * @param out The words.
+   * @param n The number of words.
+   */
+  template<typename U>
+  void decodeBitPack(CodecReader& reader, U* out, std::size_t n)
+  {
+    U             block[codecBlockSize];
+    std::uint64_t words[2 * std::numeric_limits<U>::digits];
+
+    for (std::size_t first{}; first < n; first += codecBlockSize)
+    {
+      const std::size_t size      = std::min(codecBlockSize, n - first);
+      const auto        reference = reader.read<U>();
+      const auto        width     = reader.read<std::uint8_t>();
+
+      if (width > std::numeric_limits<U>::digits)
+      {
+        throw Exception{"matlabw:mx:decode", "invalid bit width of encoded payload"};
+      }
+
+      reader.read(words, 2 * width * sizeof(std::uint64_t));
+      unpackCodecBlock(words, width, block);
+
+      for (std::size_t k{}; k < size; ++k)
+      {
+        out[first + k] = static_cast<U>(block[k] + reference);
+      }
+    }
+  }
+
+  /**
+   * @brief Checks if a word repeats in a range, compares whole blocks so that the loop vectorizes.
+   * @tparam U Word type
+   * @param in The words.
+   * @param first The first index.
+   * @param n The number of words.
+   * @param value The repeated word.
+   * @return The end of the run starting at first.
+   */
+  template<typename U>
+  [[nodiscard]] std::size_t findRunEnd(const U* in, std::size_t first, std::size_t n, U value) noexcept
+  {
+    static constexpr std::size_t block{64 / sizeof(U)};
+
+    std::size_t i = first;
+
+    while (i + block <= n)
+    {
+      bool same{true};
+
+      for (std::size_t k{}; k < block; ++k)
+      {
+        same &= (in[i + k] == value);
+      }
+
+      if (!same)
+      {
+        break;
+      }
+
+      i += block;
+    }
+
+    while (i < n && in[i] == value)
+    {
+      ++i;
+    }
+
+    return i;
+  }
+
+  /**
+   * @brief Run-length encodes words, stores the number of runs, the run values and the 32-bit run lengths.
+   * @tparam U Word type
+   * @param in The words.
+   * @param n The number of words.
+   * @param out The encoded payload, appended to.
+   */
+  template<typename U>
+  void encodeRle(const U* in, std::size_t n, std::vector<std::byte>& out)
+  {
+    static constexpr std::size_t maxRun{std::numeric_limits<std::uint32_t>::max()};
+
+    std::vector<U>             values{};
+    std::vector<std::uint32_t> lengths{};
+
+    for (std::size_t i{}; i < n;)
+    {
+      const std::size_t end = findRunEnd(in, i, n, in[i]);
+
+      for (; i < end; i += std::min(maxRun, end - i))
+      {
+        values.push_back(in[i]);
+        lengths.push_back(static_cast<std::uint32_t>(std::min(maxRun, end - i)));
+      }
+    }
+
+    const auto runCount = static_cast<std::uint64_t>(values.size());
+
+    appendCodecBytes(out, &runCount, sizeof(runCount));
+    appendCodecBytes(out, values.data(), values.size() * sizeof(U));
+    appendCodecBytes(out, lengths.data(), lengths.size() * sizeof(std::uint32_t));
+  }
+
+  /**
+   * @brief Decodes run-length encoded words.
+   * @tparam U Word type
+   * @param reader The reader of the encoded payload.
+   * @param out The words.
+   * @param n The number of words.
+   */
+  template<typename U>
+  void decodeRle(CodecReader& reader, U* out, std::size_t n)
+  {
+    static constexpr char id[]{"matlabw:mx:decode"};
+
+    const auto runCount = reader.read<std::uint64_t>();
+
+    if (runCount > n)
+    {
+      throw Exception{id, "invalid run count of encoded payload"};
+    }
+
+    std::vector<U>             values(runCount);
+    std::vector<std::uint32_t> lengths(runCount);
+
+    reader.read(values.data(), values.size() * sizeof(U));
+    reader.read(lengths.data(), lengths.size() * sizeof(std::uint32_t));
+
+    std::size_t i{};
+
+    for (std::size_t r{}; r < runCount; ++r)
+    {
+      if (lengths[r] > n - i)
+      {
+        throw Exception{id, "invalid run length of encoded payload"};
+      }
+
+      std::fill_n(out + i, lengths[r], values[r]);
+      i += lengths[r];
+    }
+
+    if (i != n)
+    {
+      throw Exception{id, "invalid run length of encoded payload"};
+    }
+  }
+
+  /**
+   * @brief Encodes a payload.
+   * @param codec The codec, not raw.
+   * @param input The payload.
+   * @return The encoded bytes.
+   */
+  [[nodiscard]] inline std::vector<std::byte> encodePayload(Codec codec, const CodecInput& input)
+  {
+    std::vector<std::byte> out{};
+
+    visitCodecWord(input.elementSize, [&]<typename U>(U)
+    {
+      std::vector<U> words(input.count);
+
+      if (input.count > 0)
+      {
+        std::memcpy(words.data(), input.data, input.count * sizeof(U));
+      }
+
+      switch (codec)
+      {
+      case Codec::rle:
+        encodeRle(words.data(), words.size(), out);
+        break;
+      case Codec::delta:
+        for (std::size_t i = words.size(); i-- > 1;)
+        {
+          words[i] = zigzagEncode(static_cast<U>(words[i] - words[i - 1]));
+        }
+
+        if (!words.empty())
+        {
+          words[0] = zigzagEncode(words[0]);
+        }
+
+        encodeBitPack(words.data(), words.size(), out);
+        break;
+      case Codec::bitPack:
+        for (auto& word : words)
+        {
+          word = mapCodecOrder(word, input.isSigned);
+        }
+
+        encodeBitPack(words.data(), words.size(), out);
+        break;
+      default:
+        throw Exception{"matlabw:mx:encode", "invalid codec"};
+      }
+    });
+
+    return out;
+  }
+
+  /**
+   * @brief Decodes a payload.
+   * @param codec The codec.
+   * @param bytes The encoded bytes.
+   * @param data The output elements.
+   * @param elementSize Size of an element, 1, 2, 4 or 8 bytes.
+   * @param count Number of elements.
+   * @param isSigned Are the elements signed integers?
+   */
+  inline void decodePayload(Codec           codec,
+                            View<std::byte> bytes,
+                            std::byte*      data,
+                            std::size_t     elementSize,
+                            std::size_t     count,
+                            bool            isSigned)
+  {
+    visitCodecWord(elementSize, [&]<typename U>(U)
+    {
+      CodecReader    reader{bytes};
+      std::vector<U> words(count);
+
+      switch (codec)
+      {
+      case Codec::raw:
+        reader.read(words.data(), count * sizeof(U));
+        break;
+      case Codec::rle:
+        decodeRle(reader, words.data(), count);
+        break;
+      case Codec::delta:
+        decodeBitPack(reader, words.data(), count);
+
+        for (std::size_t i{}; i < count; ++i)
+        {
+          words[i] = static_cast<U>(zigzagDecode(words[i]) + ((i > 0) ? words[i - 1] : U{}));
+        }
+        break;
+      case Codec::bitPack:
+        decodeBitPack(reader, words.data(), count);
+
+        for (auto& word : words)
+        {
+          word = mapCodecOrder(word, isSigned);
+        }
+        break;
+      default:
+        throw Exception{"matlabw:mx:decode", "invalid codec"};
+      }
+
+      reader.checkEnd();
+
+      if (count > 0)
+      {
+        std::memcpy(data, words.data(), count * sizeof(U));
+      }
+    });
+  }
+
+  /**
+   * @brief Estimates the encoded sizes from the leading elements in a single pass, and picks the smallest.
+   * @param input The payload.
+   * @param options The options.
+   * @return The codec, raw if no codec shrinks the payload below the ratio.
+   */
+  [[nodiscard]] inline Codec estimateCodec(const CodecInput& input, const CodecOptions& options)
+  {
+    const std::size_t rawBytes = input.count * input.elementSize;
+
+    if (rawBytes < options.minBytes || input.count == 0)
+    {
+      return Codec::raw;
+    }
+
+    return visitCodecWord(input.elementSize, [&]<typename U>(U)
+    {
+      const std::size_t n = std::min(input.count, std::max(options.sampleSize, codecBlockSize));
+
+      std::vector<U> words(n);
+      std::memcpy(words.data(), input.data, n * sizeof(U));
+
+      std::size_t runs{1};
+      std::size_t bitPackBytes{};
+      std::size_t deltaBytes{};
+
+      for (std::size_t first{}; first < n; first += codecBlockSize)
+      {
+        const std::size_t last = std::min(first + codecBlockSize, n);
+
+        U minWord = std::numeric_limits<U>::max();
+        U maxWord{};
+        U maxDelta{};
+
+        for (std::size_t i = first; i < last; ++i)
+        {
+          const U word = mapCodecOrder(words[i], input.isSigned);
+
+          minWord   = std::min(minWord, word);
+          maxWord   = std::max(maxWord, word);
+          maxDelta |= zigzagEncode(static_cast<U>(words[i] - ((i > 0) ? words[i - 1] : U{})));
+          runs     += (i > 0 && words[i] != words[i - 1]);
+        }
+
+        const std::size_t header = sizeof(U) + 1;
+
+        bitPackBytes += header + 16 * static_cast<std::size_t>(std::bit_width(static_cast<U>(maxWord - minWord)));
+        deltaBytes   += header + 16 * static_cast<std::size_t>(std::bit_width(maxDelta));
+      }
+
+      const std::size_t rleBytes = runs * (sizeof(U) + sizeof(std::uint32_t));
+
+      struct Candidate
+      {
+        Codec       codec;
+        std::size_t bytes;
+      };
+
+      const Candidate candidates[]{{Codec::rle, rleBytes}, {Codec::delta, deltaBytes}, {Codec::bitPack, bitPackBytes}};
+
+      const Candidate best = *std::min_element(std::begin(candidates), std::end(candidates),
+                                               [](const Candidate& a, const Candidate& b)
+      {
+        return a.bytes < b.bytes;
+      });
+
+      const double sampleBytes = static_cast<double>(n * sizeof(U));
+
+      return (static_cast<double>(best.bytes) < options.maxRatio * sampleBytes) ? best.codec : Codec::raw;
+    });
+  }
+} // namespace detail
+
+  /**
+   * @brief Picks the codec of a payload from the estimated sizes of its leading elements, a fast check which keeps
+   *        incompressible payloads raw without encoding them.
+   * @param array The dense numeric, logical or char array.
+   * @param options The options.
+   * @return The codec, raw if the payload is small or not compressible.
+   */
+  [[nodiscard]] inline Codec selectCodec(ArrayCref array, const CodecOptions& options = {})
+  {
+    return detail::estimateCodec(detail::getCodecInput("matlabw:mx:selectCodec", array), options);
+  }
+
+  /**
+   * @brief Encodes the payload of an array. Integer payloads compress best, floating point payloads only with run
+   *        lengths. Complex payloads are encoded as interleaved real elements.
+   * @param array The dense numeric, logical or char array.
+   * @param codec The codec.
+   * @return The encoded bytes, a copy of the payload for the raw codec.
+   */
+  [[nodiscard]] inline std::vector<std::byte> encode(ArrayCref array, Codec codec)
+  {
+    const detail::CodecInput input = detail::getCodecInput("matlabw:mx:encode", array);
+
+    if (codec == Codec::raw)
+    {
+      return std::vector<std::byte>(input.data, input.data + input.count * input.elementSize);
+    }
+
+    return detail::encodePayload(codec, input);
+  }
+
+  /**
+   * @brief Encodes the payload of a typed array, see encode().
+   * @tparam T Element type
+   * @param array The array.
+   * @param codec The codec.
+   * @return The encoded bytes.
+   */
+  template<typename T>
+  [[nodiscard]] std::vector<std::byte> encode(const TypedArrayCref<T>& array, Codec codec)
+  {
+    return encode(ArrayCref{array}, codec);
+  }
+
+  /**
+   * @brief Decodes a payload into an array of the class, complexity and dimensions of the encoded one.
+   * @param bytes The encoded bytes.
+   * @param codec The codec.
+   * @param array The output array.
+   */
+  inline void decode(View<std::byte> bytes, Codec codec, ArrayRef array)
+  {
+    const detail::CodecInput input = detail::getCodecInput("matlabw:mx:decode", array);
+
+    detail::decodePayload(codec, bytes, static_cast<std::byte*>(array.getData()), input.elementSize, input.count,
+                          input.isSigned);
+  }
+
+  /**
+   * @brief Decodes a payload into a typed array, see decode().
+   * @tparam T Element type
+   * @param bytes The encoded bytes.
+   * @param codec The codec.
+   * @param array The output array.
+   */
+  template<typename T>
+  void decode(View<std::byte> bytes, Codec codec, const TypedArrayRef<T>& array)
+  {
+    decode(bytes, codec, ArrayRef{array});
+  }
+
+  /**
+   * @brief Encodes the payload of an array with the codec picked by selectCodec(). Falls back to raw if the encoded
+   *        payload turns out not to be smaller than the ratio, so the caller stores the array data itself.
+   * @param array The dense numeric, logical or char array.
+   * @param options The options.
+   * @return The encoded payload, with no bytes if raw.
+   */
+  [[nodiscard]] inline EncodedPayload compress(ArrayCref array, const CodecOptions& options = {})
+  {
+    const detail::CodecInput input = detail::getCodecInput("matlabw:mx:compress", array);
+    const Codec              codec = detail::estimateCodec(input, options);
+
+    if (codec == Codec::raw)
+    {
+      return EncodedPayload{};
+    }
+
+    std::vector<std::byte> bytes = detail::encodePayload(codec, input);
+
+    if (static_cast<double>(bytes.size()) >= options.maxRatio * static_cast<double>(input.count * input.elementSize))
+    {
+      return EncodedPayload{};
+    }
+
+    return EncodedPayload{codec, std::move(bytes)};
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_CODEC_HPP */
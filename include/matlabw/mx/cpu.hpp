@@ -0,0 +1,194 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_CPU_HPP
+#define MATLABW_MX_CPU_HPP
+
+#include "detail/include.hpp"
+
+#include <cstdlib>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# define MATLABW_SIMD_X86_DISPATCH
+#endif
+
+namespace matlabw::mx
+{
+  /// @brief Instruction set level the library kernels are dispatched to.
+  enum class SimdLevel
+  {
+    generic, ///< Baseline of the target (SSE2 on x86-64, NEON on AArch64)
+    avx2,    ///< AVX2 with FMA
+    avx512,  ///< AVX-512 foundation, byte/word, doubleword/quadword and vector length extensions
+  };
+
+  /// @brief Instruction set extensions supported by the CPU.
+  struct CpuFeatures
+  {
+    bool sse42{};    ///< SSE4.2
+    bool popcnt{};   ///< POPCNT
+    bool avx{};      ///< AVX
+    bool avx2{};     ///< AVX2
+    bool fma{};      ///< FMA3
+    bool bmi2{};     ///< BMI2
+    bool f16c{};     ///< F16C half precision conversions
+    bool avx512f{};  ///< AVX-512 foundation
+    bool avx512bw{}; ///< AVX-512 byte and word instructions
+    bool avx512dq{}; ///< AVX-512 doubleword and quadword instructions
+    bool avx512vl{}; ///< AVX-512 vector length extensions
+    bool neon{};     ///< AArch64 Advanced SIMD
+
+    /**
+     * @brief Gets the best instruction set level the features allow.
+     * @return The instruction set level
+     */
+    [[nodiscard]] SimdLevel getSimdLevel() const noexcept
+    {
+      if (avx512f && avx512bw && avx512dq && avx512vl && avx2 && fma)
+      {
+        return SimdLevel::avx512;
+      }
+
+      if (avx2 && fma)
+      {
+        return SimdLevel::avx2;
+      }
+
+      return SimdLevel::generic;
+    }
+  };
+
+  /**
+   * @brief Detects the instruction set extensions supported by the CPU and the operating system.
+   * @return The features
+   */
+  [[nodiscard]] inline CpuFeatures detectCpuFeatures() noexcept
+  {
+    CpuFeatures features{};
+
+#if defined(MATLABW_SIMD_X86_DISPATCH)
+    __builtin_cpu_init();
+
+    features.sse42    = __builtin_cpu_supports("sse4.2");
+    features.popcnt   = __builtin_cpu_supports("popcnt");
+    features.avx      = __builtin_cpu_supports("avx");
+    features.avx2     = __builtin_cpu_supports("avx2");
+    features.fma      = __builtin_cpu_supports("fma");
+    features.bmi2     = __builtin_cpu_supports("bmi2");
+    features.f16c     = __builtin_cpu_supports("f16c");
+    features.avx512f  = __builtin_cpu_supports("avx512f");
+    features.avx512bw = __builtin_cpu_supports("avx512bw");
+    features.avx512dq = __builtin_cpu_supports("avx512dq");
+    features.avx512vl = __builtin_cpu_supports("avx512vl");
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    features.neon     = true;
+#endif
+
+    return features;
+  }
+
+  /**
+   * @brief Gets the instruction set extensions supported by the CPU. Detected once.
+   * @return The features
+   */
+  [[nodiscard]] inline const CpuFeatures& getCpuFeatures() noexcept
+  {
+    static const CpuFeatures features = detectCpuFeatures();
+
+    return features;
+  }
+
+  /**
+   * @brief Gets the name of an instruction set level, as accepted by the MATLABW_SIMD_LEVEL environment variable.
+   * @param level The instruction set level
+   * @return The name
+   */
+  [[nodiscard]] constexpr std::string_view toString(SimdLevel level) noexcept
+  {
+    switch (level)
+    {
+    case SimdLevel::avx2:
+      return "avx2";
+    case SimdLevel::avx512:
+      return "avx512";
+    default:
+      return "generic";
+    }
+  }
+
+namespace detail
+{
+  /**
+   * @brief Resolves the instruction set level of the kernels. The MATLABW_SIMD_LEVEL environment variable (generic,
+   *        avx2 or avx512) selects a lower level than the CPU supports, e.g. to benchmark a specific path.
+   * @return The instruction set level
+   */
+  [[nodiscard]] inline SimdLevel resolveSimdLevel() noexcept
+  {
+    const SimdLevel supported = getCpuFeatures().getSimdLevel();
+
+    if (const char* env = std::getenv("MATLABW_SIMD_LEVEL"); env != nullptr)
+    {
+      for (SimdLevel level : {SimdLevel::generic, SimdLevel::avx2, SimdLevel::avx512})
+      {
+        if (toString(level) == env)
+        {
+          return std::min(level, supported);
+        }
+      }
+    }
+
+    return supported;
+  }
+
+  /**
+   * @brief Instruction set level of the kernels, resolved when the MEX file is loaded so that dispatching is a plain
+   *        load. Kernels running during static initialization of other translation units see SimdLevel::generic.
+   */
+  inline SimdLevel simdLevel{resolveSimdLevel()};
+} // namespace detail
+
+  /**
+   * @brief Gets the instruction set level the library kernels are dispatched to.
+   * @return The instruction set level
+   */
+  [[nodiscard]] inline SimdLevel getSimdLevel() noexcept
+  {
+    return detail::simdLevel;
+  }
+
+  /**
+   * @brief Sets the instruction set level the library kernels are dispatched to, e.g. to benchmark a specific path.
+   *        Levels above the ones supported by the CPU are lowered. Must not be called while kernels are running.
+   * @param level The instruction set level
+   * @return The level actually set
+   */
+  inline SimdLevel setSimdLevel(SimdLevel level) noexcept
+  {
+    detail::simdLevel = std::min(level, getCpuFeatures().getSimdLevel());
+
+    return detail::simdLevel;
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_CPU_HPP */
@@ -0,0 +1,203 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_DETAIL_HASH_HPP
+#define MATLABW_MX_DETAIL_HASH_HPP
+
+#include "include.hpp"
+
+#include <cstring>
+
+namespace matlabw::mx::detail
+{
+  /// @brief 128-bit hash value.
+  struct Hash128
+  {
+    std::uint64_t low{};  ///< The low 64 bits.
+    std::uint64_t high{}; ///< The high 64 bits.
+
+    /**
+     * @brief Equality operator.
+     * @return True if the hashes are equal.
+     */
+    [[nodiscard]] bool operator==(const Hash128&) const = default;
+  };
+
+  /// @brief Size of a stripe processed by one accumulation step.
+  inline constexpr std::size_t hashStripeSize{64};
+
+  /// @brief Number of stripes between scrambles of the accumulators.
+  inline constexpr std::size_t hashStripesPerBlock{16};
+
+  /// @brief Keys mixed into the accumulator lanes.
+  inline constexpr std::uint64_t hashKeys[8]
+  {
+    0xBE4BA423396CFEB8, 0x1CAD21F72C81017C, 0xDB979083E96DD4DE, 0x1F67B3B7A4A44072,
+    0x78E5C0CC4EE679CB, 0x2172FFCC7DD05A82, 0x8E2443F7744608B8, 0x4C263A81E69035E0,
+  };
+
+  /// @brief Odd 64-bit constants of the final mix.
+  inline constexpr std::uint64_t hashPrimes[3]{0x9E3779B185EBCA87, 0xC2B2AE3D27D4EB4F, 0x165667B19E3779F9};
+
+  /// @brief Odd 32-bit constant of the scramble.
+  inline constexpr std::uint64_t hashScramblePrime{0x9E3779B1};
+
+  /**
+   * @brief Multiplies two 64-bit values and folds the 128-bit product to 64 bits.
+   * @param a The first value.
+   * @param b The second value.
+   * @return The low half xored with the high half of the product.
+   */
+  [[nodiscard]] constexpr std::uint64_t hashMultiplyFold(std::uint64_t a, std::uint64_t b) noexcept
+  {
+#ifdef __SIZEOF_INT128__
+    const auto product = static_cast<unsigned __int128>(a) * b;
+
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+    const std::uint64_t aLo = a & 0xFFFFFFFF;
+    const std::uint64_t aHi = a >> 32;
+    const std::uint64_t bLo = b & 0xFFFFFFFF;
+    const std::uint64_t bHi = b >> 32;
+    const std::uint64_t ll  = aLo * bLo;
+    const std::uint64_t lh  = aLo * bHi;
+    const std::uint64_t hl  = aHi * bLo;
+    const std::uint64_t hh  = aHi * bHi;
+    const std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+
+    return ((mid << 32) | (ll & 0xFFFFFFFF)) ^ (hh + (lh >> 32) + (hl >> 32) + (mid >> 32));
+#endif
+  }
+
+  /**
+   * @brief Final mix spreading every input bit over the whole value.
+   * @param value The value.
+   * @return The mixed value.
+   */
+  [[nodiscard]] constexpr std::uint64_t hashAvalanche(std::uint64_t value) noexcept
+  {
+    value ^= value >> 37;
+    value *= hashPrimes[2];
+    value ^= value >> 32;
+
+    return value;
+  }
+
+  /**
+   * @brief Accumulates one stripe. The lanes are independent 32x32-bit multiplies, which compilers vectorize.
+   * @param acc The accumulators.
+   * @param stripe The stripe of hashStripeSize bytes.
+   * @param seed The seed mixed into the keys.
+   */
+  inline void hashAccumulate(std::uint64_t (&acc)[8], const std::byte* stripe, std::uint64_t seed) noexcept
+  {
+    std::uint64_t words[8];
+    std::memcpy(words, stripe, sizeof(words));
+
+    for (std::size_t lane{}; lane < 8; ++lane)
+    {
+      const std::uint64_t keyed = words[lane] ^ (hashKeys[lane] + seed);
+
+      acc[lane ^ 1] += words[lane];
+      acc[lane]     += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+  }
+
+  /**
+   * @brief Scrambles the accumulators, so that long inputs cannot cancel out earlier stripes.
+   * @param acc The accumulators.
+   */
+  inline void hashScramble(std::uint64_t (&acc)[8]) noexcept
+  {
+    for (std::size_t lane{}; lane < 8; ++lane)
+    {
+      acc[lane] = (acc[lane] ^ (acc[lane] >> 47) ^ hashKeys[lane]) * hashScramblePrime;
+    }
+  }
+
+  /**
+   * @brief Hashes a block of memory 64 bytes at a time in eight lanes, in the style of XXH3. Not cryptographic.
+   * @param data The memory.
+   * @param size The size in bytes.
+   * @param seed The seed, e.g. the hash of preceding data.
+   * @return The hash.
+   */
+  [[nodiscard]] inline Hash128 hashBytes128(const void* data, std::size_t size, Hash128 seed = {}) noexcept
+  {
+    const std::byte* ptr = static_cast<const std::byte*>(data);
+
+    std::uint64_t acc[8]
+    {
+      seed.low,  seed.high ^ hashPrimes[0], seed.low + hashPrimes[1], seed.high,
+      ~seed.low, seed.high + hashPrimes[2], seed.low ^ hashPrimes[0], ~seed.high,
+    };
+
+    const std::size_t stripeCount = size / hashStripeSize;
+
+    for (std::size_t stripe{}; stripe < stripeCount; ++stripe)
+    {
+      hashAccumulate(acc, ptr + stripe * hashStripeSize, seed.high);
+
+      if ((stripe + 1) % hashStripesPerBlock == 0)
+      {
+        hashScramble(acc);
+      }
+    }
+
+    // The tail is zero-padded to a whole stripe, the size below tells apart inputs differing in trailing zeros.
+    if (const std::size_t tail = size % hashStripeSize; tail != 0)
+    {
+      std::byte last[hashStripeSize]{};
+      std::memcpy(last, ptr + stripeCount * hashStripeSize, tail);
+      hashAccumulate(acc, last, seed.high);
+    }
+
+    Hash128 hash{size * hashPrimes[0], ~size * hashPrimes[1]};
+
+    for (std::size_t lane{}; lane < 8; lane += 2)
+    {
+      hash.low  += hashMultiplyFold(acc[lane] ^ hashKeys[lane], acc[lane + 1] ^ hashKeys[lane + 1]);
+      hash.high += hashMultiplyFold(acc[lane] ^ hashKeys[7 - lane], acc[lane + 1] ^ hashKeys[6 - lane]);
+    }
+
+    return Hash128{hashAvalanche(hash.low), hashAvalanche(hash.high ^ (hash.low >> 29))};
+  }
+
+  /**
+   * @brief Hashes a value.
+   * @tparam T The type of the value, trivially copyable.
+   * @param value The value.
+   * @param seed The seed.
+   * @return The hash.
+   */
+  template<typename T>
+  [[nodiscard]] Hash128 hashValue128(const T& value, Hash128 seed) noexcept
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    return hashBytes128(&value, sizeof(T), seed);
+  }
+} // namespace matlabw::mx::detail
+
+#endif /* MATLABW_MX_DETAIL_HASH_HPP */
@@ -27,11 +27,13 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <complex>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -47,4 +49,12 @@
 # include <gpu/mxGPUArray.h>
 #endif
 
+#if defined(__GNUC__)
+# define MATLABW_ALWAYS_INLINE [[gnu::always_inline]] inline
+#elif defined(_MSC_VER)
+# define MATLABW_ALWAYS_INLINE __forceinline
+#else
+# define MATLABW_ALWAYS_INLINE inline
+#endif
+
 #endif /* MATLABW_MX_DETAIL_INCLUDE_HPP */
@@ -0,0 +1,67 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_DETAIL_INSTANTIATE_HPP
+#define MATLABW_MX_DETAIL_INSTANTIATE_HPP
+
+#include "include.hpp"
+
+#include <complex>
+#include <cstdint>
+
+/**
+ * @brief Expands @p X for every element type explicitly instantiated by the matlabw-core library.
+ * @param X Macro taking a single type argument
+ */
+#define MATLABW_MX_DETAIL_FOR_EACH_CORE_TYPE(X) \
+  X(double)                                     \
+  X(float)                                      \
+  X(std::int8_t)                                \
+  X(std::uint8_t)                               \
+  X(std::int16_t)                               \
+  X(std::uint16_t)                              \
+  X(std::int32_t)                               \
+  X(std::uint32_t)                              \
+  X(std::int64_t)                               \
+  X(std::uint64_t)                              \
+  X(std::complex<double>)                       \
+  X(std::complex<float>)                        \
+  X(std::complex<std::int8_t>)                  \
+  X(std::complex<std::uint8_t>)                 \
+  X(std::complex<std::int16_t>)                 \
+  X(std::complex<std::uint16_t>)                \
+  X(std::complex<std::int32_t>)                 \
+  X(std::complex<std::uint32_t>)                \
+  X(std::complex<std::int64_t>)                 \
+  X(std::complex<std::uint64_t>)                \
+  X(bool)                                       \
+  X(char16_t)
+
+/// @brief True if the templates are declared as instantiated in the matlabw-core library.
+#if defined(MATLABW_USE_CORE) && !defined(MATLABW_BUILDING_CORE)
+# define MATLABW_MX_DETAIL_EXTERN_CORE 1
+#else
+# define MATLABW_MX_DETAIL_EXTERN_CORE 0
+#endif
+
+#endif /* MATLABW_MX_DETAIL_INSTANTIATE_HPP */
@@ -0,0 +1,102 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_DETAIL_SATURATE_HPP
+#define MATLABW_MX_DETAIL_SATURATE_HPP
+
+#include "include.hpp"
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace matlabw::mx::detail
+{
+  /**
+   * @brief Is the type a standard integer type? Bool and character types are excluded.
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isStandardInteger = std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                            !std::is_same_v<T, char>     && !std::is_same_v<T, wchar_t>  &&
+                                            !std::is_same_v<T, char8_t>  && !std::is_same_v<T, char16_t> &&
+                                            !std::is_same_v<T, char32_t>;
+
+  /**
+   * @brief Converts a value with MATLAB semantics: conversion to integers rounds to nearest with ties away from zero,
+   *        saturates and maps NaN to zero.
+   * @tparam T Target type
+   * @tparam U Source type
+   * @param value The value
+   * @return The converted value
+   */
+  template<typename T, typename U>
+  MATLABW_ALWAYS_INLINE constexpr T saturateCast(U value) noexcept
+  {
+    if constexpr (!isStandardInteger<T>)
+    {
+      return static_cast<T>(value);
+    }
+    else if constexpr (std::is_floating_point_v<U>)
+    {
+      constexpr auto lo = static_cast<U>(std::numeric_limits<T>::min());
+      constexpr auto hi = static_cast<U>(std::numeric_limits<T>::max());
+
+      const U rounded = std::round(value);
+
+      // hi may be rounded up to a power of two for 32 and 64 bit types, so compare with >=.
+      if (rounded >= hi)
+      {
+        return std::numeric_limits<T>::max();
+      }
+
+      if (rounded <= lo)
+      {
+        return std::numeric_limits<T>::min();
+      }
+
+      return (value == value) ? static_cast<T>(rounded) : T{};
+    }
+    else if constexpr (std::is_same_v<U, bool>)
+    {
+      return static_cast<T>(value);
+    }
+    else
+    {
+      if (std::cmp_less(value, std::numeric_limits<T>::min()))
+      {
+        return std::numeric_limits<T>::min();
+      }
+
+      if (std::cmp_greater(value, std::numeric_limits<T>::max()))
+      {
+        return std::numeric_limits<T>::max();
+      }
+
+      return static_cast<T>(value);
+    }
+  }
+} // namespace matlabw::mx::detail
+
+#endif /* MATLABW_MX_DETAIL_SATURATE_HPP */
@@ -0,0 +1,330 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_DETAIL_UTF8_HPP
+#define MATLABW_MX_DETAIL_UTF8_HPP
+
+#include "include.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+# include <emmintrin.h>
+# define MATLABW_UTF8_SSE2
+#endif
+
+namespace matlabw::mx::detail
+{
+  /// @brief Replacement character emitted for ill-formed input.
+  inline constexpr char32_t replacementCharacter{0xFFFD};
+
+  /**
+   * @brief Copies the leading ASCII code units of UTF-16 input to UTF-8 output, 16 units per step.
+   * @param in Input pointer
+   * @param n Number of input code units
+   * @param out Output pointer, at least n bytes
+   * @return Number of copied code units, the following unit (if any) is not ASCII.
+   */
+  [[nodiscard]] inline std::size_t copyAscii(const char16_t* in, std::size_t n, char* out) noexcept
+  {
+    std::size_t i{};
+
+#ifdef MATLABW_UTF8_SSE2
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 16 <= n; i += 16)
+    {
+      const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(lo, hi), mask), zero)) != 0xFFFF)
+      {
+        break;
+      }
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+    }
+#else
+    for (; i + 4 <= n; i += 4)
+    {
+      std::uint64_t units;
+      std::memcpy(&units, in + i, sizeof(units));
+
+      if ((units & 0xFF80FF80FF80FF80) != 0)
+      {
+        break;
+      }
+
+      for (std::size_t k{}; k < 4; ++k)
+      {
+        out[i + k] = static_cast<char>(in[i + k]);
+      }
+    }
+#endif
+
+    for (; i < n && in[i] < 0x80; ++i)
+    {
+      out[i] = static_cast<char>(in[i]);
+    }
+
+    return i;
+  }
+
+  /**
+   * @brief Copies the leading ASCII bytes of UTF-8 input to UTF-16 output, 16 bytes per step.
+   * @param in Input pointer
+   * @param n Number of input bytes
+   * @param out Output pointer, at least n code units, may be null to only count.
+   * @return Number of copied bytes, the following byte (if any) is not ASCII.
+   */
+  [[nodiscard]] inline std::size_t copyAscii(const char* in, std::size_t n, char16_t* out) noexcept
+  {
+    std::size_t i{};
+
+#ifdef MATLABW_UTF8_SSE2
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 16 <= n; i += 16)
+    {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+      if (_mm_movemask_epi8(bytes) != 0)
+      {
+        break;
+      }
+
+      if (out != nullptr)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(bytes, zero));
+      }
+    }
+#else
+    for (; i + 8 <= n; i += 8)
+    {
+      std::uint64_t bytes;
+      std::memcpy(&bytes, in + i, sizeof(bytes));
+
+      if ((bytes & 0x8080808080808080) != 0)
+      {
+        break;
+      }
+
+      if (out != nullptr)
+      {
+        for (std::size_t k{}; k < 8; ++k)
+        {
+          out[i + k] = static_cast<char16_t>(in[i + k]);
+        }
+      }
+    }
+#endif
+
+    for (; i < n && static_cast<unsigned char>(in[i]) < 0x80; ++i)
+    {
+      if (out != nullptr)
+      {
+        out[i] = static_cast<char16_t>(in[i]);
+      }
+    }
+
+    return i;
+  }
+
+  /**
+   * @brief Gets the exact UTF-8 length of UTF-16 input. Unpaired surrogates count as the replacement character.
+   * @param in Input pointer
+   * @param n Number of input code units
+   * @return Number of UTF-8 bytes
+   */
+  [[nodiscard]] inline std::size_t getUtf8Length(const char16_t* in, std::size_t n) noexcept
+  {
+    std::size_t length{n};
+
+    for (std::size_t i{}; i < n; ++i)
+    {
+      const char16_t c = in[i];
+
+      length += static_cast<std::size_t>(c >= 0x80) + static_cast<std::size_t>(c >= 0x800);
+
+      // a valid surrogate pair encodes to 4 bytes, the low surrogate adds nothing to the 3 of the high one
+      if (c >= 0xD800 && c < 0xDC00 && i + 1 < n && in[i + 1] >= 0xDC00 && in[i + 1] < 0xE000)
+      {
+        ++i;
+      }
+    }
+
+    return length;
+  }
+
+  /**
+   * @brief Encodes UTF-16 input as UTF-8. Unpaired surrogates encode as the replacement character.
+   * @param in Input pointer
+   * @param n Number of input code units
+   * @param out Output pointer, getUtf8Length() bytes
+   * @return Number of written bytes
+   */
+  inline std::size_t encodeUtf8(const char16_t* in, std::size_t n, char* out) noexcept
+  {
+    char*       o = out;
+    std::size_t i{};
+
+    auto put = [&](char32_t c)
+    {
+      *o++ = static_cast<char>(c);
+    };
+
+    while (i < n)
+    {
+      const std::size_t ascii = copyAscii(in + i, n - i, o);
+
+      i += ascii;
+      o += ascii;
+
+      for (; i < n && in[i] >= 0x80; ++i)
+      {
+        char32_t c = in[i];
+
+        if (c < 0x800)
+        {
+          put(0xC0 | (c >> 6));
+          put(0x80 | (c & 0x3F));
+          continue;
+        }
+
+        if (c >= 0xD800 && c < 0xE000)
+        {
+          if (c < 0xDC00 && i + 1 < n && in[i + 1] >= 0xDC00 && in[i + 1] < 0xE000)
+          {
+            c = 0x10000 + ((c - 0xD800) << 10) + (in[++i] - 0xDC00);
+
+            put(0xF0 | (c >> 18));
+            put(0x80 | ((c >> 12) & 0x3F));
+            put(0x80 | ((c >> 6) & 0x3F));
+            put(0x80 | (c & 0x3F));
+            continue;
+          }
+
+          c = replacementCharacter;
+        }
+
+        put(0xE0 | (c >> 12));
+        put(0x80 | ((c >> 6) & 0x3F));
+        put(0x80 | (c & 0x3F));
+      }
+    }
+
+    return static_cast<std::size_t>(o - out);
+  }
+
+  /**
+   * @brief Decodes UTF-8 input as UTF-16. Each ill-formed byte decodes to the replacement character, overlong forms,
+   *        surrogates and code points above U+10FFFF are ill-formed.
+   * @param in Input pointer
+   * @param n Number of input bytes
+   * @param out Output pointer, at least the returned number of code units, null to only count them.
+   * @return Number of UTF-16 code units
+   */
+  inline std::size_t decodeUtf8(const char* in, std::size_t n, char16_t* out) noexcept
+  {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(in);
+
+    std::size_t i{};
+    std::size_t o{};
+
+    auto put = [&](char16_t c)
+    {
+      if (out != nullptr)
+      {
+        out[o] = c;
+      }
+
+      ++o;
+    };
+
+    auto continuation = [&](std::size_t k)
+    {
+      return i + k < n && (bytes[i + k] & 0xC0) == 0x80;
+    };
+
+    while (i < n)
+    {
+      const std::size_t ascii = copyAscii(in + i, n - i, (out != nullptr) ? out + o : nullptr);
+
+      i += ascii;
+      o += ascii;
+
+      while (i < n && bytes[i] >= 0x80)
+      {
+        const unsigned char b = bytes[i];
+        char32_t            c{replacementCharacter};
+        std::size_t         size{1};
+
+        if (b >= 0xC2 && b < 0xE0 && continuation(1))
+        {
+          c    = ((b & 0x1Fu) << 6) | (bytes[i + 1] & 0x3Fu);
+          size = 2;
+        }
+        else if (b >= 0xE0 && b < 0xF0 && continuation(1) && continuation(2))
+        {
+          const char32_t d = ((b & 0x0Fu) << 12) | ((bytes[i + 1] & 0x3Fu) << 6) | (bytes[i + 2] & 0x3Fu);
+
+          if (d >= 0x800 && (d < 0xD800 || d >= 0xE000))
+          {
+            c    = d;
+            size = 3;
+          }
+        }
+        else if (b >= 0xF0 && b < 0xF5 && continuation(1) && continuation(2) && continuation(3))
+        {
+          const char32_t d = ((b & 0x07u) << 18) | ((bytes[i + 1] & 0x3Fu) << 12) | ((bytes[i + 2] & 0x3Fu) << 6)
+                           | (bytes[i + 3] & 0x3Fu);
+
+          if (d >= 0x10000 && d < 0x110000)
+          {
+            c    = d;
+            size = 4;
+          }
+        }
+
+        if (c >= 0x10000)
+        {
+          put(static_cast<char16_t>(0xD800 + ((c - 0x10000) >> 10)));
+          put(static_cast<char16_t>(0xDC00 + ((c - 0x10000) & 0x3FF)));
+        }
+        else
+        {
+          put(static_cast<char16_t>(c));
+        }
+
+        i += size;
+      }
+    }
+
+    return o;
+  }
+} // namespace matlabw::mx::detail
+
+#endif /* MATLABW_MX_DETAIL_UTF8_HPP */
@@ -0,0 +1,276 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_ANY_TYPED_ARRAY_HPP
+#define MATLABW_MX_GPU_ANY_TYPED_ARRAY_HPP
+
+#include "../detail/include.hpp"
+
+#include "../Array.hpp"
+#include "../ArrayRef.hpp"
+#include "BorrowedArray.hpp"
+#include "DeviceView.hpp"
+#include "../Exception.hpp"
+#include "init.hpp"
+#include "../TypedArrayRef.hpp"
+#include "TypedArrayRef.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /// @brief Side of the memory an array lives in.
+  enum class Residency
+  {
+    host,   ///< Host memory, a MATLAB array.
+    device, ///< Device memory, a MATLAB gpuArray.
+  };
+
+  /**
+   * @brief Read-only typed array which is either a MATLAB array or a gpuArray. Both sides are available, the other
+   *        side than the original one is transferred on first access and cached, so repeated accesses do not transfer
+   *        again. The original array must outlive the object and references obtained from the object are valid as
+   *        long as it is not moved.
+   * @tparam T Element type
+   */
+  template<typename T>
+  class AnyTypedArray
+  {
+    public:
+      /// @brief Class ID
+      static constexpr ClassId classId = TypeProperties<T>::classId;
+
+      /**
+       * @brief Constructor.
+       * @param array A MATLAB array or gpuArray of class T.
+       */
+      explicit AnyTypedArray(mx::ArrayCref array)
+      : mHostArray{array.get()}, mResidency{array.isGpuArray() ? Residency::device : Residency::host}
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:AnyTypedArray:AnyTypedArray"};
+
+        if (mResidency == Residency::device)
+        {
+          init();
+
+          // The gpuArray is borrowed, no device data is copied.
+          const ArrayCref device = mDeviceArray.emplace(array).getCref();
+
+          mHostArray = nullptr;
+
+          if (device.getClassId() != classId || device.isComplex() != isComplexNumeric<T>)
+          {
+            throw Exception{id, "gpuArray class does not match the element type"};
+          }
+
+          mDims.assign(device.getDims().begin(), device.getDims().end());
+        }
+        else
+        {
+          if (array.getClassId() != classId || array.isComplex() != isComplexNumeric<T>)
+          {
+            throw Exception{id, "array class does not match the element type"};
+          }
+
+          mDims.assign(array.getDims().begin(), array.getDims().end());
+        }
+      }
+
+      /**
+       * @brief Gets the residency of the original array.
+       * @return The residency
+       */
+      [[nodiscard]] Residency getResidency() const noexcept
+      {
+        return mResidency;
+      }
+
+      /**
+       * @brief Checks if the data is available in host memory without a transfer.
+       * @return True if the data is on the host
+       */
+      [[nodiscard]] bool isOnHost() const noexcept
+      {
+        return mHostArray != nullptr || mHostCopy.isValid();
+      }
+
+      /**
+       * @brief Checks if the data is available in device memory without a transfer.
+       * @return True if the data is on the device
+       */
+      [[nodiscard]] bool isOnDevice() const noexcept
+      {
+        return mDeviceArray.has_value();
+      }
+
+      /**
+       * @brief Gets the dimensions.
+       * @return The dimensions
+       */
+      [[nodiscard]] View<std::size_t> getDims() const noexcept
+      {
+        return mDims;
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return std::accumulate(mDims.begin(), mDims.end(), std::size_t{1}, std::multiplies<>{});
+      }
+
+      /**
+       * @brief Gets the host side, downloads the gpuArray on first access.
+       * @return The host array
+       */
+      [[nodiscard]] mx::TypedArrayCref<T> getHost()
+      {
+        if (mHostArray == nullptr && !mHostCopy.isValid())
+        {
+          mxArray* array = mxGPUCreateMxArrayOnCPU(mDeviceArray->get());
+
+          if (array == nullptr)
+          {
+            throw Exception{"matlabw:mx:gpu:AnyTypedArray:getHost", "failed to download the gpuArray"};
+          }
+
+          mHostCopy = mx::Array{std::move(array)};
+        }
+
+        return mx::TypedArrayCref<T>{(mHostArray != nullptr) ? mHostArray : mHostCopy.get()};
+      }
+
+      /**
+       * @brief Gets the host data, downloads the gpuArray on first access.
+       * @return The host data
+       */
+      [[nodiscard]] View<T> getHostView()
+      {
+        const auto host = getHost();
+
+        return View<T>{host.getData(), host.getSize()};
+      }
+
+      /**
+       * @brief Gets the device side, uploads the array on first access.
+       * @return The gpu array
+       */
+      [[nodiscard]] TypedArrayCref<T> getDevice()
+      {
+        if (!mDeviceArray.has_value())
+        {
+          init();
+
+          mDeviceArray.emplace(mx::ArrayCref{mHostArray});
+        }
+
+        return mDeviceArray->template getTypedCref<T>();
+      }
+
+      /**
+       * @brief Gets a device view, uploads the array on first access.
+       * @tparam Rank The rank of the view
+       * @return The device view
+       */
+      template<std::size_t Rank = 1>
+      [[nodiscard]] DeviceView<const T, Rank> getDeviceView()
+      {
+        return makeDeviceView<Rank>(getDevice());
+      }
+
+      /// @brief Frees the cached copy of the side the original array is not on.
+      void releaseCopy() noexcept
+      {
+        if (mResidency == Residency::host)
+        {
+          mDeviceArray.reset();
+        }
+        else
+        {
+          mHostCopy = mx::Array{};
+        }
+      }
+    private:
+      const mxArray*               mHostArray{};   ///< The original host array, nullptr for a gpuArray
+      mx::Array                    mHostCopy{};    ///< The downloaded copy of a gpuArray
+      std::optional<BorrowedArray> mDeviceArray{}; ///< The borrowed gpuArray or the uploaded copy
+      Residency                    mResidency{};   ///< Residency of the original array
+      std::vector<std::size_t>     mDims{};        ///< The dimensions
+  };
+
+  /// @brief Policy choosing between the CPU and the GPU implementation.
+  struct DispatchPolicy
+  {
+    /// @brief Minimum number of elements of a host array for the GPU implementation, smaller arrays are not worth the
+    ///        upload.
+    std::size_t minHostElementsForGpu{std::size_t{1} << 20};
+
+    /// @brief Minimum number of elements of a gpuArray for the GPU implementation, smaller ones are downloaded and
+    ///        processed on the CPU. The default keeps all gpuArrays on the GPU.
+    std::size_t minDeviceElementsForGpu{0};
+  };
+
+  /**
+   * @brief Chooses the side an array is processed on.
+   * @tparam T Element type
+   * @param array The array
+   * @param policy The dispatch policy
+   * @return Residency::device for the GPU implementation
+   */
+  template<typename T>
+  [[nodiscard]] Residency selectResidency(const AnyTypedArray<T>& array, const DispatchPolicy& policy = {})
+  {
+    const std::size_t threshold = array.isOnDevice() ? policy.minDeviceElementsForGpu : policy.minHostElementsForGpu;
+
+    return (array.getSize() >= threshold) ? Residency::device : Residency::host;
+  }
+
+  /**
+   * @brief Calls the CPU or the GPU implementation, transferring the array to the chosen side if needed.
+   * @tparam T Element type
+   * @tparam CpuFn CPU implementation type, called with mx::TypedArrayCref<T>
+   * @tparam GpuFn GPU implementation type, called with gpu::TypedArrayCref<T>
+   * @param array The array
+   * @param cpu The CPU implementation
+   * @param gpu The GPU implementation, must return the same type as the CPU implementation
+   * @param policy The dispatch policy
+   * @return The result of the chosen implementation
+   */
+  template<typename T, typename CpuFn, typename GpuFn>
+  decltype(auto) dispatch(AnyTypedArray<T>& array, CpuFn&& cpu, GpuFn&& gpu, const DispatchPolicy& policy = {})
+  {
+    static_assert(std::is_same_v<std::invoke_result_t<CpuFn, mx::TypedArrayCref<T>>,
+                                 std::invoke_result_t<GpuFn, TypedArrayCref<T>>>,
+                  "CPU and GPU implementations must return the same type");
+
+    if (selectResidency(array, policy) == Residency::device)
+    {
+      return std::invoke(std::forward<GpuFn>(gpu), array.getDevice());
+    }
+
+    return std::invoke(std::forward<CpuFn>(cpu), array.getHost());
+  }
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_ANY_TYPED_ARRAY_HPP */
@@ -0,0 +1,155 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_BORROWED_ARRAY_HPP
+#define MATLABW_MX_GPU_BORROWED_ARRAY_HPP
+
+#include "../detail/include.hpp"
+
+#include "Array.hpp"
+#include "../ArrayRef.hpp"
+#include "../Exception.hpp"
+#include "TypedArrayRef.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /**
+   * @brief Move-only read-only handle of a gpuArray borrowed from a MATLAB array. It is created by
+   *        mxGPUCreateFromMxArray, so the device data of a gpuArray is never copied, unlike gpu::Array which copies
+   *        through mxGPUCopyFromMxArray. The borrowed data must not be modified and the MATLAB array must outlive the
+   *        handle. References obtained from the handle are valid as long as the handle is not moved or destroyed.
+   */
+  class BorrowedArray
+  {
+    public:
+      /**
+       * @brief Constructor. A host array is uploaded, a gpuArray is borrowed without a copy.
+       * @param array The MATLAB array.
+       */
+      explicit BorrowedArray(mx::ArrayCref array)
+      : mArray{borrow(array.get())}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      BorrowedArray(const BorrowedArray&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other handle, left empty.
+       */
+      BorrowedArray(BorrowedArray&& other) noexcept = default;
+
+      /// @brief Destructor. Destroys the handle, the device data stays owned by MATLAB.
+      ~BorrowedArray() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      BorrowedArray& operator=(const BorrowedArray&) = delete;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other handle, left empty.
+       * @return Reference to this handle.
+       */
+      BorrowedArray& operator=(BorrowedArray&& other) noexcept = default;
+
+      /**
+       * @brief Checks if the handle holds an array.
+       * @return True if the handle is valid, false otherwise.
+       */
+      [[nodiscard]] bool isValid() const
+      {
+        return mArray.isValid();
+      }
+
+      /**
+       * @brief Gets a read-only reference to the array.
+       * @return The reference.
+       */
+      [[nodiscard]] ArrayCref getCref() const
+      {
+        return ArrayCref{mArray};
+      }
+
+      /**
+       * @brief Gets a read-only typed reference to the array.
+       * @tparam T Element type
+       * @return The typed reference, throws if the class of the array does not match.
+       */
+      template<typename T>
+      [[nodiscard]] TypedArrayCref<T> getTypedCref() const
+      {
+        return TypedArrayCref<T>{mArray};
+      }
+
+      /**
+       * @brief Converts to a read-only reference to the array.
+       * @return The reference.
+       */
+      [[nodiscard]] operator ArrayCref() const
+      {
+        return getCref();
+      }
+
+      /**
+       * @brief Gets the mxGPUArray pointer.
+       * @return The mxGPUArray pointer.
+       */
+      [[nodiscard]] const mxGPUArray* get() const noexcept
+      {
+        return mArray.get();
+      }
+    private:
+      /**
+       * @brief Borrows a MATLAB array.
+       * @param array The MATLAB array.
+       * @return The array owning the read-only mxGPUArray handle.
+       */
+      [[nodiscard]] static Array borrow(const mxArray* array)
+      {
+        const mxGPUArray* gpuArray = mxGPUCreateFromMxArray(array);
+
+        if (gpuArray == nullptr)
+        {
+          throw Exception{"matlabw:mx:gpu:BorrowedArray:BorrowedArray", "failed to create gpuArray from mxArray"};
+        }
+
+        // The handle is only ever exposed as const, mxGPUDestroyGPUArray releases it without touching the data.
+        return Array{const_cast<mxGPUArray*>(gpuArray)};
+      }
+
+      Array mArray{}; ///< The array owning the read-only handle.
+  };
+
+  /**
+   * @brief Borrows a MATLAB array as a read-only gpuArray without copying device data.
+   * @param array The MATLAB array, a host array is uploaded.
+   * @return The move-only handle.
+   */
+  [[nodiscard]] inline BorrowedArray borrow(mx::ArrayCref array)
+  {
+    return BorrowedArray{array};
+  }
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_BORROWED_ARRAY_HPP */
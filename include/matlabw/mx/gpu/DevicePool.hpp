@@ -0,0 +1,489 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_DEVICE_POOL_HPP
+#define MATLABW_MX_GPU_DEVICE_POOL_HPP
+
+#include "../detail/include.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "detail/cuda.hpp"
+#include "detail/sizeClass.hpp"
+
+/// @brief Stream-ordered allocation (cudaMallocAsync) is available since CUDA 11.2.
+#if defined(CUDART_VERSION) && (CUDART_VERSION >= 11020)
+# define MATLABW_GPU_MALLOC_ASYNC
+#endif
+
+namespace matlabw::mx::gpu
+{
+  /// @brief Backend of the device pool.
+  enum class DeviceBackend
+  {
+    automatic, ///< Stream-ordered allocation if the device supports memory pools, the caching backend otherwise.
+    caching,   ///< Size-class bins of cudaMalloc blocks, reused in stream order.
+    async,     ///< cudaMallocAsync on the device default memory pool, which is kept from releasing memory.
+  };
+
+  /// @brief Usage statistics of the device pool.
+  struct DevicePoolStats
+  {
+    std::size_t bytesInUse{};      ///< Bytes handed out.
+    std::size_t bytesCached{};     ///< Bytes kept for reuse, 0 for the async backend which keeps its own cache.
+    std::size_t peakBytesInUse{};  ///< Largest number of bytes handed out at once.
+    std::size_t allocationCount{}; ///< Number of allocations.
+    std::size_t cacheHitCount{};   ///< Number of allocations served by the caching backend without cudaMalloc.
+    std::size_t deviceAllocCount{};///< Number of cudaMalloc or cudaMallocAsync calls.
+  };
+
+  /**
+   * @brief Caching allocator of temporary device memory. Memory is stream-ordered: a block deallocated on a stream may
+   *        be reused right away by the same stream and by other streams once the work queued before the
+   *        deallocation has finished, so neither allocation nor deallocation synchronizes the device. Memory stays
+   *        cached between MEX function calls until trim() or release(). The pool is thread-safe.
+   */
+  class DevicePool
+  {
+    public:
+      /// @brief Size of the smallest size class in bytes.
+      static constexpr std::size_t minBlockSize{512};
+
+      /**
+       * @brief Constructor.
+       * @param backend The backend.
+       */
+      explicit DevicePool(DeviceBackend backend = DeviceBackend::automatic)
+      : mBackend{selectBackend(backend)}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      DevicePool(const DevicePool&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      DevicePool(DevicePool&&) = delete;
+
+      /// @brief Destructor. Releases all memory.
+      ~DevicePool() noexcept
+      {
+        release();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      DevicePool& operator=(const DevicePool&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      DevicePool& operator=(DevicePool&&) = delete;
+
+      /**
+       * @brief Allocates device memory for use on a stream.
+       * @param size The size of the memory in bytes.
+       * @param stream The stream.
+       * @return A pointer to the memory. Never returns nullptr.
+       */
+      [[nodiscard]] void* allocate(std::size_t size, cudaStream_t stream)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:DevicePool:allocate"};
+
+        const std::size_t classSize = detail::roundToSizeClass(size, minBlockSize);
+
+        std::lock_guard lock{mMutex};
+
+        void* ptr{};
+
+#     ifdef MATLABW_GPU_MALLOC_ASYNC
+        if (mBackend == DeviceBackend::async)
+        {
+          detail::checkCuda(cudaMallocAsync(&ptr, classSize, stream), id);
+
+          ++mStats.deviceAllocCount;
+          recordAllocation(ptr, classSize, stream);
+
+          return ptr;
+        }
+#     endif
+
+        if (auto it = mFreeLists.find(classSize); it != mFreeLists.end())
+        {
+          auto& freeList = it->second;
+
+          // Prefer a block of the same stream, it is ready in stream order without waiting.
+          auto block = std::find_if(freeList.begin(), freeList.end(), [&](const FreeBlock& b)
+          {
+            return b.stream == stream;
+          });
+
+          if (block == freeList.end())
+          {
+            block = std::find_if(freeList.begin(), freeList.end(), [](const FreeBlock& b)
+            {
+              return cudaEventQuery(b.event) == cudaSuccess;
+            });
+          }
+
+          if (block != freeList.end())
+          {
+            ptr = block->ptr;
+            mEvents.push_back(block->event);
+            freeList.erase(block);
+
+            ++mStats.cacheHitCount;
+            mStats.bytesCached -= classSize;
+            recordAllocation(ptr, classSize, stream);
+
+            return ptr;
+          }
+        }
+
+        cudaError_t err = cudaMalloc(&ptr, classSize);
+
+        if (err == cudaErrorMemoryAllocation)
+        {
+          // Clear the sticky-free error, give the cached blocks back and retry once.
+          static_cast<void>(cudaGetLastError());
+          trimLocked();
+          err = cudaMalloc(&ptr, classSize);
+        }
+
+        detail::checkCuda(err, id);
+
+        ++mStats.deviceAllocCount;
+        recordAllocation(ptr, classSize, stream);
+
+        return ptr;
+      }
+
+      /**
+       * @brief Returns device memory to the pool. The memory may still be used by work queued on the stream.
+       * @param ptr A pointer to the memory returned by allocate(). May be nullptr.
+       * @param stream The stream the memory was last used on.
+       */
+      void deallocate(void* ptr, cudaStream_t stream) noexcept
+      {
+        if (ptr == nullptr)
+        {
+          return;
+        }
+
+        std::lock_guard lock{mMutex};
+
+        const auto it = mInUse.find(ptr);
+
+        if (it == mInUse.end())
+        {
+          return;
+        }
+
+        const std::size_t classSize = it->second;
+
+        mInUse.erase(it);
+        mStats.bytesInUse -= classSize;
+
+#     ifdef MATLABW_GPU_MALLOC_ASYNC
+        if (mBackend == DeviceBackend::async)
+        {
+          cudaFreeAsync(ptr, stream);
+          return;
+        }
+#     endif
+
+        cudaEvent_t event{};
+
+        if (!mEvents.empty())
+        {
+          event = mEvents.back();
+          mEvents.pop_back();
+        }
+        else if (cudaEventCreateWithFlags(&event, cudaEventDisableTiming) != cudaSuccess)
+        {
+          // Without an event the block cannot be reused safely, free it.
+          cudaFree(ptr);
+          return;
+        }
+
+        cudaEventRecord(event, stream);
+
+        mFreeLists[classSize].push_back(FreeBlock{ptr, stream, event});
+        mStats.bytesCached += classSize;
+      }
+
+      /// @brief Frees all cached memory which is not in use, e.g. when the device runs out of memory.
+      void trim() noexcept
+      {
+        std::lock_guard lock{mMutex};
+
+        trimLocked();
+      }
+
+      /// @brief Frees all cached memory and forgets the memory in use. Blocks in use must not be deallocated later.
+      void release() noexcept
+      {
+        std::lock_guard lock{mMutex};
+
+        trimLocked();
+
+        if (mBackend == DeviceBackend::caching)
+        {
+          for (const auto& [ptr, classSize] : mInUse)
+          {
+            cudaFree(ptr);
+          }
+        }
+
+        for (cudaEvent_t event : mEvents)
+        {
+          cudaEventDestroy(event);
+        }
+
+        mEvents.clear();
+        mInUse.clear();
+        mStats.bytesInUse = 0;
+      }
+
+      /**
+       * @brief Gets the usage statistics.
+       * @return The statistics.
+       */
+      [[nodiscard]] DevicePoolStats getStats() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mStats;
+      }
+
+      /// @brief Restarts the peak usage statistics from the bytes in use, e.g. to measure the peak of one MEX call.
+      void resetPeak() noexcept
+      {
+        std::lock_guard lock{mMutex};
+
+        mStats.peakBytesInUse = mStats.bytesInUse;
+      }
+
+      /**
+       * @brief Gets the backend in use.
+       * @return The backend, never DeviceBackend::automatic.
+       */
+      [[nodiscard]] DeviceBackend getBackend() const noexcept
+      {
+        return mBackend;
+      }
+    private:
+      /// @brief Cached block.
+      struct FreeBlock
+      {
+        void*        ptr;    ///< The memory.
+        cudaStream_t stream; ///< The stream the block was deallocated on.
+        cudaEvent_t  event;  ///< The event recorded on the stream at deallocation.
+      };
+
+      /**
+       * @brief Selects the backend.
+       * @param backend The requested backend.
+       * @return The backend.
+       */
+      [[nodiscard]] static DeviceBackend selectBackend(DeviceBackend backend)
+      {
+#     ifdef MATLABW_GPU_MALLOC_ASYNC
+        if (backend == DeviceBackend::caching)
+        {
+          return backend;
+        }
+
+        int device{};
+        int supported{};
+
+        if (cudaGetDevice(&device) == cudaSuccess
+            && cudaDeviceGetAttribute(&supported, cudaDevAttrMemoryPoolsSupported, device) == cudaSuccess
+            && supported != 0)
+        {
+          cudaMemPool_t pool{};
+
+          // Keep freed memory in the pool instead of returning it to the driver at each synchronization.
+          std::uint64_t threshold = std::numeric_limits<std::uint64_t>::max();
+
+          if (cudaDeviceGetDefaultMemPool(&pool, device) == cudaSuccess
+              && cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold) == cudaSuccess)
+          {
+            return DeviceBackend::async;
+          }
+        }
+
+        if (backend == DeviceBackend::async)
+        {
+          throw Exception{"matlabw:mx:gpu:DevicePool:DevicePool", "device does not support memory pools"};
+        }
+#     else
+        if (backend == DeviceBackend::async)
+        {
+          throw Exception{"matlabw:mx:gpu:DevicePool:DevicePool", "cudaMallocAsync requires CUDA 11.2 or newer"};
+        }
+#     endif
+
+        return DeviceBackend::caching;
+      }
+
+      /**
+       * @brief Records an allocation in the statistics.
+       * @param ptr The memory.
+       * @param classSize The size of the memory in bytes.
+       * @param stream The stream.
+       */
+      void recordAllocation(void* ptr, std::size_t classSize, [[maybe_unused]] cudaStream_t stream)
+      {
+        mInUse.emplace(ptr, classSize);
+
+        ++mStats.allocationCount;
+        mStats.bytesInUse     += classSize;
+        mStats.peakBytesInUse  = std::max(mStats.peakBytesInUse, mStats.bytesInUse);
+      }
+
+      /// @brief Frees all cached memory, the mutex must be held.
+      void trimLocked() noexcept
+      {
+#     ifdef MATLABW_GPU_MALLOC_ASYNC
+        if (mBackend == DeviceBackend::async)
+        {
+          int           device{};
+          cudaMemPool_t pool{};
+
+          if (cudaGetDevice(&device) == cudaSuccess && cudaDeviceGetDefaultMemPool(&pool, device) == cudaSuccess)
+          {
+            // Memory freed with cudaFreeAsync returns to the pool only once the stream reaches the free.
+            cudaDeviceSynchronize();
+            cudaMemPoolTrimTo(pool, 0);
+          }
+
+          return;
+        }
+#     endif
+
+        for (auto& [classSize, freeList] : mFreeLists)
+        {
+          for (const FreeBlock& block : freeList)
+          {
+            // cudaFree waits for the queued work which may still use the block.
+            cudaFree(block.ptr);
+            mEvents.push_back(block.event);
+          }
+        }
+
+        mFreeLists.clear();
+        mStats.bytesCached = 0;
+      }
+
+      mutable std::mutex                                      mMutex{};     ///< Protects the pool.
+      DeviceBackend                                           mBackend{};   ///< The backend.
+      std::unordered_map<std::size_t, std::vector<FreeBlock>> mFreeLists{}; ///< Cached blocks by size.
+      std::unordered_map<void*, std::size_t>                  mInUse{};     ///< Blocks in use and their sizes.
+      std::vector<cudaEvent_t>                                mEvents{};    ///< Unused events for recycling.
+      DevicePoolStats                                         mStats{};     ///< The usage statistics.
+  };
+
+  /**
+   * @brief Temporary device buffer allocated from a device pool, returned to the pool on its stream when destroyed.
+   * @tparam T The element type.
+   */
+  template<typename T>
+  class DeviceBuffer
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+    public:
+      /**
+       * @brief Constructor.
+       * @param pool The pool, must outlive the buffer.
+       * @param size The number of elements.
+       * @param stream The stream the buffer is used on.
+       */
+      DeviceBuffer(DevicePool& pool, std::size_t size, cudaStream_t stream)
+      : mPool{&pool}, mStream{stream}, mSize{size}
+      {
+        if (size > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+          throw std::bad_alloc();
+        }
+
+        mData = static_cast<T*>(mPool->allocate(size * sizeof(T), stream));
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      DeviceBuffer(const DeviceBuffer&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other buffer, left empty.
+       */
+      DeviceBuffer(DeviceBuffer&& other) noexcept
+      : mPool{other.mPool}, mStream{other.mStream}, mData{std::exchange(other.mData, nullptr)},
+        mSize{std::exchange(other.mSize, 0)}
+      {}
+
+      /// @brief Destructor.
+      ~DeviceBuffer()
+      {
+        mPool->deallocate(mData, mStream);
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      DeviceBuffer& operator=(DeviceBuffer&&) = delete;
+
+      /**
+       * @brief Gets the data.
+       * @return Pointer to the device data.
+       */
+      [[nodiscard]] T* getData() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Gets the stream the buffer is used on.
+       * @return The stream.
+       */
+      [[nodiscard]] cudaStream_t getStream() const noexcept
+      {
+        return mStream;
+      }
+    private:
+      DevicePool*  mPool{};   ///< The pool.
+      cudaStream_t mStream{}; ///< The stream.
+      T*           mData{};   ///< The device data.
+      std::size_t  mSize{};   ///< The number of elements.
+  };
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_DEVICE_POOL_HPP */
@@ -0,0 +1,238 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_DEVICE_VIEW_HPP
+#define MATLABW_MX_GPU_DEVICE_VIEW_HPP
+
+#include "../detail/include.hpp"
+
+#include "TypedArray.hpp"
+#include "TypedArrayRef.hpp"
+
+/// @brief Marks functions callable from both host and device code when compiled by nvcc.
+#ifdef __CUDACC__
+# define MATLABW_GPU_HOST_DEVICE __host__ __device__
+#else
+# define MATLABW_GPU_HOST_DEVICE
+#endif
+
+namespace matlabw::mx::gpu
+{
+  /**
+   * @brief Non-owning column-major view of device data, passed by value to __global__ functions. The view is
+   *        trivially copyable and uses only plain index arithmetic, so it works in device code without any flags.
+   *        Indices are std::size_t, so arrays with more than 2^32 elements are addressed correctly.
+   * @tparam T Element type, const-qualified for read-only views
+   * @tparam Rank The rank, excess array dimensions are folded into the last extent
+   */
+  template<typename T, std::size_t Rank = 1>
+  class DeviceView
+  {
+    static_assert(Rank > 0, "rank must be at least 1");
+    static_assert(std::is_trivially_copyable_v<std::remove_cv_t<T>>, "T must be trivially copyable");
+
+    public:
+      using element_type = T;                   ///< Element type
+      using value_type   = std::remove_cv_t<T>; ///< Value type
+      using index_type   = std::size_t;         ///< Index type
+      using pointer      = T*;                  ///< Pointer type
+      using reference    = T&;                  ///< Reference type
+
+      /**
+       * @brief Gets the rank.
+       * @return The rank
+       */
+      [[nodiscard]] static constexpr std::size_t rank() noexcept
+      {
+        return Rank;
+      }
+
+      /// @brief Default constructor.
+      DeviceView() = default;
+
+      /**
+       * @brief Constructor.
+       * @param data Pointer to the device data
+       * @param dims Array dimensions, missing trailing dimensions are treated as 1
+       */
+      DeviceView(pointer data, View<std::size_t> dims) noexcept
+      : mData{data}
+      {
+        for (std::size_t r{}; r < Rank; ++r)
+        {
+          mExtents[r] = (r < dims.size()) ? dims[r] : 1;
+        }
+
+        for (std::size_t r{Rank}; r < dims.size(); ++r)
+        {
+          mExtents[Rank - 1] *= dims[r];
+        }
+      }
+
+      /**
+       * @brief Conversion to a read-only view.
+       * @return The read-only view
+       */
+      MATLABW_GPU_HOST_DEVICE operator DeviceView<const T, Rank>() const noexcept
+      {
+        DeviceView<const T, Rank> view{};
+
+        view.mData = mData;
+
+        for (std::size_t r{}; r < Rank; ++r)
+        {
+          view.mExtents[r] = mExtents[r];
+        }
+
+        return view;
+      }
+
+      /**
+       * @brief Gets the extent.
+       * @param r The dimension
+       * @return The extent
+       */
+      [[nodiscard]] MATLABW_GPU_HOST_DEVICE std::size_t extent(std::size_t r) const noexcept
+      {
+        return mExtents[r];
+      }
+
+      /**
+       * @brief Gets the number of elements.
+       * @return The number of elements
+       */
+      [[nodiscard]] MATLABW_GPU_HOST_DEVICE std::size_t size() const noexcept
+      {
+        std::size_t result{1};
+
+        for (std::size_t r{}; r < Rank; ++r)
+        {
+          result *= mExtents[r];
+        }
+
+        return result;
+      }
+
+      /**
+       * @brief Gets a pointer to the data.
+       * @return Pointer to the device data
+       */
+      [[nodiscard]] MATLABW_GPU_HOST_DEVICE pointer data() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Accesses an element by its linear index.
+       * @param i The linear index
+       * @return Reference to the element
+       */
+      [[nodiscard]] MATLABW_GPU_HOST_DEVICE reference operator[](std::size_t i) const noexcept
+      {
+        return mData[i];
+      }
+
+      /**
+       * @brief Accesses an element by its column-major subscripts.
+       * @tparam Is Index types
+       * @param is The subscripts, one per dimension
+       * @return Reference to the element
+       */
+      template<typename... Is>
+        requires (sizeof...(Is) == Rank && (std::is_integral_v<Is> && ...))
+      [[nodiscard]] MATLABW_GPU_HOST_DEVICE reference operator()(Is... is) const noexcept
+      {
+        const std::size_t subs[]{static_cast<std::size_t>(is)...};
+
+        std::size_t offset{subs[Rank - 1]};
+
+        for (std::size_t r{Rank - 1}; r > 0; --r)
+        {
+          offset = offset * mExtents[r - 1] + subs[r - 1];
+        }
+
+        return mData[offset];
+      }
+    private:
+      template<typename U, std::size_t R>
+      friend class DeviceView;
+
+      pointer     mData{};          ///< Pointer to the device data
+      std::size_t mExtents[Rank]{}; ///< Extents
+  };
+
+  /**
+   * @brief Creates a device view of a gpu array.
+   * @tparam Rank The rank of the view
+   * @tparam T Element type
+   * @param array The array
+   * @return The view, valid as long as the array
+   */
+  template<std::size_t Rank = 1, typename T>
+  [[nodiscard]] DeviceView<T, Rank> makeDeviceView(const TypedArrayRef<T>& array)
+  {
+    return DeviceView<T, Rank>{array.getData(), array.getDims()};
+  }
+
+  /**
+   * @brief Creates a read-only device view of a gpu array.
+   * @tparam Rank The rank of the view
+   * @tparam T Element type
+   * @param array The array
+   * @return The view, valid as long as the array
+   */
+  template<std::size_t Rank = 1, typename T>
+  [[nodiscard]] DeviceView<const T, Rank> makeDeviceView(const TypedArrayCref<T>& array)
+  {
+    return DeviceView<const T, Rank>{array.getData(), array.getDims()};
+  }
+
+  /**
+   * @brief Creates a device view of a gpu array.
+   * @tparam Rank The rank of the view
+   * @tparam T Element type
+   * @param array The array
+   * @return The view, valid as long as the array
+   */
+  template<std::size_t Rank = 1, typename T>
+  [[nodiscard]] DeviceView<T, Rank> makeDeviceView(TypedArray<T>& array)
+  {
+    return DeviceView<T, Rank>{array.getData(), array.getDims()};
+  }
+
+  /**
+   * @brief Creates a read-only device view of a gpu array.
+   * @tparam Rank The rank of the view
+   * @tparam T Element type
+   * @param array The array
+   * @return The view, valid as long as the array
+   */
+  template<std::size_t Rank = 1, typename T>
+  [[nodiscard]] DeviceView<const T, Rank> makeDeviceView(const TypedArray<T>& array)
+  {
+    return DeviceView<const T, Rank>{array.getData(), array.getDims()};
+  }
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_DEVICE_VIEW_HPP */
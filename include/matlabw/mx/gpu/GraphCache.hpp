@@ -0,0 +1,429 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_GRAPH_CACHE_HPP
+#define MATLABW_MX_GPU_GRAPH_CACHE_HPP
+
+#include "../detail/include.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+#include <cuda_runtime_api.h>
+
+#include "detail/cuda.hpp"
+#include "../Exception.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /**
+   * @brief Key of a cached CUDA graph, everything the captured work sequence depends on except the device pointers.
+   *        Usually the class, complexity and dimensions of each input plus the scalar parameters baked into the
+   *        kernel arguments.
+   */
+  class GraphKey
+  {
+    public:
+      /// @brief Default constructor.
+      GraphKey() = default;
+
+      /**
+       * @brief Adds the class, complexity and dimensions of an array.
+       * @tparam A Array type (gpu::Array, gpu::ArrayCref, gpu::TypedArrayCref, ...)
+       * @param array The array.
+       * @return This key.
+       */
+      template<typename A>
+        requires requires(const A& a) { a.getClassId(); a.isComplex(); a.getDims(); }
+      GraphKey& add(const A& array)
+      {
+        const View<std::size_t> dims = array.getDims();
+
+        mValues.push_back(static_cast<std::size_t>(array.getClassId()));
+        mValues.push_back(static_cast<std::size_t>(array.isComplex()));
+        mValues.push_back(dims.size());
+        mValues.insert(mValues.end(), dims.begin(), dims.end());
+
+        return *this;
+      }
+
+      /**
+       * @brief Adds a scalar parameter.
+       * @param value The value.
+       * @return This key.
+       */
+      GraphKey& add(std::size_t value)
+      {
+        mValues.push_back(value);
+
+        return *this;
+      }
+
+      /**
+       * @brief Compares the keys.
+       * @param other The other key.
+       * @return The ordering.
+       */
+      [[nodiscard]] auto operator<=>(const GraphKey& other) const = default;
+    private:
+      std::vector<std::size_t> mValues{}; ///< The key values.
+  };
+
+  /// @brief Usage statistics of a graph cache.
+  struct GraphCacheStats
+  {
+    std::size_t graphCount{};       ///< Number of cached executable graphs.
+    std::size_t replayCount{};      ///< Launches of a cached graph without capturing.
+    std::size_t updateCount{};      ///< Launches after updating the parameters of a cached graph.
+    std::size_t instantiateCount{}; ///< Launches of a newly instantiated graph.
+  };
+
+  /**
+   * @brief Cache of executable CUDA graphs for work sequences which are repeated with the same shapes, e.g. the kernels
+   *        and copies of a MEX function, so that each call pays for one graph launch instead of a launch per kernel.
+   *
+   *        The first run() of a key captures the sequence and instantiates it. A later run() with the same device
+   *        pointers replays the graph right away. With other pointers the sequence is captured again and the
+   *        executable graph is updated in place by cudaGraphExecUpdate, which is much cheaper than instantiation.
+   *        When the update fails because the topology changed, the graph is instantiated again.
+   *
+   *        The sequence is captured on a private stream in thread-local mode, so its device memory must be allocated
+   *        before run(). The cache is thread-safe, run() calls are serialized. The least recently used graph is
+   *        destroyed when the cache is full.
+   */
+  class GraphCache
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param maxGraphs Maximum number of cached graphs, at least 1.
+       */
+      explicit GraphCache(std::size_t maxGraphs = 64)
+      : mMaxGraphs{std::max<std::size_t>(maxGraphs, 1)}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      GraphCache(const GraphCache&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      GraphCache(GraphCache&&) = delete;
+
+      /// @brief Destructor. Destroys all graphs.
+      ~GraphCache() noexcept
+      {
+        release();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      GraphCache& operator=(const GraphCache&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      GraphCache& operator=(GraphCache&&) = delete;
+
+      /**
+       * @brief Runs a work sequence as a cached graph on a stream of the current device.
+       * @tparam Fn The function type.
+       * @param key The key of the sequence.
+       * @param bindings The device pointers the sequence uses, e.g. from gpu::Array::getData().
+       * @param stream The stream the graph is launched on, may be the legacy default stream.
+       * @param record The function enqueuing the sequence on the cudaStream_t it is called with. It is called only
+       *               when the graph is captured and must depend on nothing but the key and the bindings.
+       */
+      template<typename Fn>
+      void run(const GraphKey& key, View<const void*> bindings, cudaStream_t stream, Fn&& record)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:GraphCache:run"};
+
+        const int device = getCurrentDevice();
+
+        std::lock_guard lock{mMutex};
+
+        const auto it = mEntries.find(std::pair{device, key});
+
+        if (it != mEntries.end() && std::ranges::equal(it->second.bindings, bindings))
+        {
+          it->second.lastUse = ++mClock;
+          detail::checkCuda(cudaGraphLaunch(it->second.exec, stream), id);
+          ++mStats.replayCount;
+          return;
+        }
+
+        cudaGraph_t graph = capture(device, record);
+
+        cudaGraphExec_t exec{};
+
+        if (it != mEntries.end() && update(it->second.exec, graph))
+        {
+          exec = it->second.exec;
+          ++mStats.updateCount;
+        }
+        else
+        {
+          const cudaError_t err = cudaGraphInstantiateWithFlags(&exec, graph, 0);
+
+          if (err != cudaSuccess)
+          {
+            cudaGraphDestroy(graph);
+            detail::checkCuda(err, id);
+          }
+
+          if (it != mEntries.end())
+          {
+            cudaGraphExecDestroy(it->second.exec);
+            it->second.exec = exec;
+          }
+
+          ++mStats.instantiateCount;
+        }
+
+        cudaGraphDestroy(graph);
+
+        Entry& entry = (it != mEntries.end()) ? it->second : insert(device, key, exec);
+
+        entry.bindings.assign(bindings.begin(), bindings.end());
+        entry.lastUse = ++mClock;
+
+        detail::checkCuda(cudaGraphLaunch(exec, stream), id);
+      }
+
+      /**
+       * @brief Runs a work sequence as a cached graph, see run(const GraphKey&, View<const void*>, cudaStream_t, Fn&&).
+       * @tparam Fn The function type.
+       * @param key The key of the sequence.
+       * @param bindings The device pointers the sequence uses.
+       * @param stream The stream the graph is launched on.
+       * @param record The function enqueuing the sequence on the cudaStream_t it is called with.
+       */
+      template<typename Fn>
+      void run(const GraphKey& key, std::initializer_list<const void*> bindings, cudaStream_t stream, Fn&& record)
+      {
+        run(key, View<const void*>{bindings.begin(), bindings.size()}, stream, std::forward<Fn>(record));
+      }
+
+      /**
+       * @brief Gets the maximum number of cached graphs.
+       * @return The maximum number of graphs.
+       */
+      [[nodiscard]] std::size_t getMaxGraphs() const noexcept
+      {
+        return mMaxGraphs;
+      }
+
+      /**
+       * @brief Gets the usage statistics.
+       * @return The statistics.
+       */
+      [[nodiscard]] GraphCacheStats getStats() const
+      {
+        std::lock_guard lock{mMutex};
+
+        GraphCacheStats stats{mStats};
+
+        stats.graphCount = mEntries.size();
+
+        return stats;
+      }
+
+      /// @brief Destroys all graphs and capture streams, each on its device.
+      void release() noexcept
+      {
+        std::lock_guard lock{mMutex};
+
+        int previous{};
+
+        if (cudaGetDevice(&previous) != cudaSuccess)
+        {
+          return;
+        }
+
+        for (const auto& [key, entry] : mEntries)
+        {
+          if (cudaSetDevice(key.first) == cudaSuccess)
+          {
+            cudaGraphExecDestroy(entry.exec);
+          }
+        }
+
+        for (const auto& [device, stream] : mCaptureStreams)
+        {
+          if (cudaSetDevice(device) == cudaSuccess)
+          {
+            cudaStreamDestroy(stream);
+          }
+        }
+
+        cudaSetDevice(previous);
+
+        mEntries.clear();
+        mCaptureStreams.clear();
+      }
+    private:
+      /// @brief Cached executable graph.
+      struct Entry
+      {
+        cudaGraphExec_t          exec{};     ///< The executable graph.
+        std::vector<const void*> bindings{}; ///< The device pointers of the last capture.
+        std::uint64_t            lastUse{};  ///< Use counter value of the last run.
+      };
+
+      /**
+       * @brief Gets the current device.
+       * @return The device ordinal.
+       */
+      [[nodiscard]] static int getCurrentDevice()
+      {
+        int device{};
+
+        detail::checkCuda(cudaGetDevice(&device), "matlabw:mx:gpu:GraphCache:getCurrentDevice");
+
+        return device;
+      }
+
+      /**
+       * @brief Captures a work sequence on the capture stream of a device.
+       * @tparam Fn The function type.
+       * @param device The device.
+       * @param record The function enqueuing the sequence.
+       * @return The captured graph, owned by the caller.
+       */
+      template<typename Fn>
+      [[nodiscard]] cudaGraph_t capture(int device, Fn& record)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:GraphCache:capture"};
+
+        cudaStream_t stream = getCaptureStream(device);
+
+        detail::checkCuda(cudaStreamBeginCapture(stream, cudaStreamCaptureModeThreadLocal), id);
+
+        cudaGraph_t graph{};
+
+        try
+        {
+          record(stream);
+        }
+        catch (...)
+        {
+          if (cudaStreamEndCapture(stream, &graph) == cudaSuccess && graph != nullptr)
+          {
+            cudaGraphDestroy(graph);
+          }
+
+          throw;
+        }
+
+        detail::checkCuda(cudaStreamEndCapture(stream, &graph), id);
+
+        return graph;
+      }
+
+      /**
+       * @brief Updates the parameters of an executable graph from a graph of the same topology.
+       * @param exec The executable graph.
+       * @param graph The graph.
+       * @return True if the graph was updated, false if it has to be instantiated again.
+       */
+      [[nodiscard]] static bool update(cudaGraphExec_t exec, cudaGraph_t graph) noexcept
+      {
+#if CUDART_VERSION >= 12000
+        cudaGraphExecUpdateResultInfo info{};
+
+        const cudaError_t err = cudaGraphExecUpdate(exec, graph, &info);
+#else
+        cudaGraphNode_t           errorNode{};
+        cudaGraphExecUpdateResult result{};
+
+        const cudaError_t err = cudaGraphExecUpdate(exec, graph, &errorNode, &result);
+#endif
+
+        if (err != cudaSuccess)
+        {
+          // Clears the error, the graph is instantiated again.
+          static_cast<void>(cudaGetLastError());
+          return false;
+        }
+
+        return true;
+      }
+
+      /**
+       * @brief Gets the capture stream of a device, creates it on first use.
+       * @param device The device, must be current.
+       * @return The stream.
+       */
+      [[nodiscard]] cudaStream_t getCaptureStream(int device)
+      {
+        if (const auto it = mCaptureStreams.find(device); it != mCaptureStreams.end())
+        {
+          return it->second;
+        }
+
+        cudaStream_t stream{};
+
+        detail::checkCuda(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking),
+                          "matlabw:mx:gpu:GraphCache:getCaptureStream");
+
+        mCaptureStreams.emplace(device, stream);
+
+        return stream;
+      }
+
+      /**
+       * @brief Inserts a graph, destroys the least recently used one if the cache is full.
+       * @param device The device.
+       * @param key The key.
+       * @param exec The executable graph, owned by the cache afterwards.
+       * @return The entry.
+       */
+      [[nodiscard]] Entry& insert(int device, const GraphKey& key, cudaGraphExec_t exec)
+      {
+        if (mEntries.size() >= mMaxGraphs)
+        {
+          const auto oldest = std::ranges::min_element(mEntries, {}, [](const auto& e) { return e.second.lastUse; });
+
+          cudaGraphExecDestroy(oldest->second.exec);
+          mEntries.erase(oldest);
+        }
+
+        try
+        {
+          return mEntries.emplace(std::pair{device, key}, Entry{exec, {}, {}}).first->second;
+        }
+        catch (...)
+        {
+          cudaGraphExecDestroy(exec);
+          throw;
+        }
+      }
+
+      mutable std::mutex                        mMutex{};          ///< Protects the cache.
+      std::size_t                               mMaxGraphs{};      ///< Maximum number of cached graphs.
+      std::uint64_t                             mClock{};          ///< Use counter.
+      GraphCacheStats                           mStats{};          ///< Usage statistics.
+      std::map<std::pair<int, GraphKey>, Entry> mEntries{};        ///< Graphs by device and key.
+      std::map<int, cudaStream_t>               mCaptureStreams{}; ///< Capture streams by device.
+  };
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_GRAPH_CACHE_HPP */
@@ -0,0 +1,281 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_HANDLE_CACHE_HPP
+#define MATLABW_MX_GPU_HANDLE_CACHE_HPP
+
+#include "../detail/include.hpp"
+
+#include <compare>
+#include <map>
+#include <mutex>
+
+#include <cublas_v2.h>
+#include <cufft.h>
+
+#include "detail/cuda.hpp"
+#include "../Exception.hpp"
+#include "MultiDevice.hpp"
+
+namespace matlabw::mx::gpu
+{
+namespace detail
+{
+  /**
+   * @brief Throws an exception if a cuBLAS call failed.
+   * @param status The status.
+   * @param id The error identifier.
+   */
+  inline void checkCublas(cublasStatus_t status, const char* id)
+  {
+    if (status != CUBLAS_STATUS_SUCCESS)
+    {
+      throw Exception{id, cublasGetStatusString(status)};
+    }
+  }
+
+  /**
+   * @brief Throws an exception if a cuFFT call failed.
+   * @param result The result.
+   * @param id The error identifier.
+   */
+  inline void checkCufft(cufftResult result, const char* id)
+  {
+    if (result != CUFFT_SUCCESS)
+    {
+      throw Exception{id, "cuFFT error " + std::to_string(static_cast<int>(result))};
+    }
+  }
+
+  /**
+   * @brief Converts a size to a cuBLAS or cuFFT int argument.
+   * @param size The size.
+   * @param id The error identifier.
+   * @return The size as int.
+   */
+  [[nodiscard]] inline int toLibraryInt(std::size_t size, const char* id)
+  {
+    if (size > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    {
+      throw Exception{id, "array dimension exceeds the range of the CUDA library"};
+    }
+
+    return static_cast<int>(size);
+  }
+} // namespace detail
+
+  /// @brief Key of a cached FFT plan.
+  struct FftPlanKey
+  {
+    int                device{}; ///< The device ordinal.
+    cudaStream_t       stream{}; ///< The stream the plan is bound to.
+    int                rank{};   ///< The transform rank, 1 to 3.
+    std::array<int, 3> n{};      ///< The transform sizes, unused ones are 0.
+    cufftType          type{};   ///< The transform type.
+    int                batch{};  ///< The number of transforms.
+
+    /**
+     * @brief Compares the keys.
+     * @param other The other key.
+     * @return The ordering.
+     */
+    [[nodiscard]] auto operator<=>(const FftPlanKey& other) const = default;
+  };
+
+  /**
+   * @brief Cache of cuBLAS handles and cuFFT plans. Creating them costs milliseconds, so they are created lazily on
+   *        first use and kept until release(). Handles are bound to the current device and a stream, plans also to
+   *        their sizes, type and batch. The cache is thread-safe, a handle or plan must be used by one thread at a
+   *        time.
+   */
+  class HandleCache
+  {
+    public:
+      /// @brief Default constructor.
+      HandleCache() = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      HandleCache(const HandleCache&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      HandleCache(HandleCache&&) = delete;
+
+      /// @brief Destructor. Destroys all handles and plans.
+      ~HandleCache() noexcept
+      {
+        release();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      HandleCache& operator=(const HandleCache&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      HandleCache& operator=(HandleCache&&) = delete;
+
+      /**
+       * @brief Gets the cuBLAS handle of the current device and a stream.
+       * @param stream The stream.
+       * @return The handle.
+       */
+      [[nodiscard]] cublasHandle_t getBlasHandle(cudaStream_t stream)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:HandleCache:getBlasHandle"};
+
+        const std::pair key{getCurrentDevice(), stream};
+
+        std::lock_guard lock{mMutex};
+
+        if (const auto it = mBlasHandles.find(key); it != mBlasHandles.end())
+        {
+          return it->second;
+        }
+
+        cublasHandle_t handle{};
+
+        detail::checkCublas(cublasCreate(&handle), id);
+
+        if (const cublasStatus_t status = cublasSetStream(handle, stream); status != CUBLAS_STATUS_SUCCESS)
+        {
+          cublasDestroy(handle);
+          detail::checkCublas(status, id);
+        }
+
+        mBlasHandles.emplace(key, handle);
+
+        return handle;
+      }
+
+      /**
+       * @brief Gets the cuFFT plan of the current device and a stream for a batch of transforms of contiguous data.
+       * @param n The transform sizes, fastest varying first as in MATLAB.
+       * @param type The transform type.
+       * @param batch The number of transforms.
+       * @param stream The stream.
+       * @return The plan.
+       */
+      [[nodiscard]] cufftHandle getFftPlan(View<std::size_t> n, cufftType type, std::size_t batch, cudaStream_t stream)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:HandleCache:getFftPlan"};
+
+        if (n.empty() || n.size() > 3)
+        {
+          throw Exception{id, "transform rank must be 1, 2 or 3"};
+        }
+
+        FftPlanKey key{getCurrentDevice(), stream, static_cast<int>(n.size()), {}, type,
+                       detail::toLibraryInt(batch, id)};
+
+        // cuFFT expects the slowest varying size first.
+        for (std::size_t i{}; i < n.size(); ++i)
+        {
+          key.n[i] = detail::toLibraryInt(n[n.size() - 1 - i], id);
+        }
+
+        std::lock_guard lock{mMutex};
+
+        if (const auto it = mFftPlans.find(key); it != mFftPlans.end())
+        {
+          return it->second;
+        }
+
+        cufftHandle plan{};
+
+        detail::checkCufft(cufftPlanMany(&plan, key.rank, key.n.data(), nullptr, 1, 0, nullptr, 1, 0, type,
+                                         key.batch),
+                           id);
+
+        if (const cufftResult result = cufftSetStream(plan, stream); result != CUFFT_SUCCESS)
+        {
+          cufftDestroy(plan);
+          detail::checkCufft(result, id);
+        }
+
+        mFftPlans.emplace(key, plan);
+
+        return plan;
+      }
+
+      /**
+       * @brief Gets the number of cached cuBLAS handles.
+       * @return The number of handles.
+       */
+      [[nodiscard]] std::size_t getBlasHandleCount() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mBlasHandles.size();
+      }
+
+      /**
+       * @brief Gets the number of cached cuFFT plans.
+       * @return The number of plans.
+       */
+      [[nodiscard]] std::size_t getFftPlanCount() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mFftPlans.size();
+      }
+
+      /// @brief Destroys all handles and plans, each on its device.
+      void release() noexcept
+      {
+        std::lock_guard lock{mMutex};
+
+        int previous{};
+
+        if (cudaGetDevice(&previous) != cudaSuccess)
+        {
+          return;
+        }
+
+        for (const auto& [key, handle] : mBlasHandles)
+        {
+          if (cudaSetDevice(key.first) == cudaSuccess)
+          {
+            cublasDestroy(handle);
+          }
+        }
+
+        for (const auto& [key, plan] : mFftPlans)
+        {
+          if (cudaSetDevice(key.device) == cudaSuccess)
+          {
+            cufftDestroy(plan);
+          }
+        }
+
+        cudaSetDevice(previous);
+
+        mBlasHandles.clear();
+        mFftPlans.clear();
+      }
+    private:
+      mutable std::mutex                                     mMutex{};       ///< Protects the cache.
+      std::map<std::pair<int, cudaStream_t>, cublasHandle_t> mBlasHandles{}; ///< cuBLAS handles by device and stream.
+      std::map<FftPlanKey, cufftHandle>                      mFftPlans{};    ///< cuFFT plans by key.
+  };
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_HANDLE_CACHE_HPP */
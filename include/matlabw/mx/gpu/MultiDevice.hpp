@@ -0,0 +1,604 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_MULTI_DEVICE_HPP
+#define MATLABW_MX_GPU_MULTI_DEVICE_HPP
+
+#include "../detail/include.hpp"
+
+#include "../common.hpp"
+#include "detail/cuda.hpp"
+#include "DeviceView.hpp"
+#include "NumericArray.hpp"
+#include "../TypedArrayRef.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /// @brief Properties of a CUDA device.
+  struct DeviceInfo
+  {
+    int         device{};          ///< The device ordinal.
+    std::string name{};            ///< The device name.
+    std::size_t totalMemory{};     ///< Total device memory in bytes.
+    int         multiProcessors{}; ///< Number of multiprocessors.
+    int         computeMajor{};    ///< Major compute capability.
+    int         computeMinor{};    ///< Minor compute capability.
+  };
+
+  /**
+   * @brief Gets the number of CUDA devices.
+   * @return The number of devices.
+   */
+  [[nodiscard]] inline int getDeviceCount()
+  {
+    int count{};
+
+    detail::checkCuda(cudaGetDeviceCount(&count), "matlabw:mx:gpu:getDeviceCount");
+
+    return count;
+  }
+
+  /**
+   * @brief Gets the current CUDA device, the one MATLAB gpuArrays live on.
+   * @return The device ordinal.
+   */
+  [[nodiscard]] inline int getCurrentDevice()
+  {
+    int device{};
+
+    detail::checkCuda(cudaGetDevice(&device), "matlabw:mx:gpu:getCurrentDevice");
+
+    return device;
+  }
+
+  /**
+   * @brief Gets the properties of all CUDA devices.
+   * @return The device properties ordered by device ordinal.
+   */
+  [[nodiscard]] inline std::vector<DeviceInfo> getDevices()
+  {
+    std::vector<DeviceInfo> devices(static_cast<std::size_t>(getDeviceCount()));
+
+    for (std::size_t i{}; i < devices.size(); ++i)
+    {
+      cudaDeviceProp prop{};
+
+      detail::checkCuda(cudaGetDeviceProperties(&prop, static_cast<int>(i)), "matlabw:mx:gpu:getDevices");
+
+      devices[i] = DeviceInfo{static_cast<int>(i), prop.name, prop.totalGlobalMem, prop.multiProcessorCount,
+                              prop.major, prop.minor};
+    }
+
+    return devices;
+  }
+
+  /// @brief Makes a device current for the lifetime of the guard and restores the previous device afterwards.
+  class DeviceGuard
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param device The device ordinal.
+       */
+      explicit DeviceGuard(int device)
+      : mPrevious{getCurrentDevice()}
+      {
+        if (device != mPrevious)
+        {
+          detail::checkCuda(cudaSetDevice(device), "matlabw:mx:gpu:DeviceGuard:DeviceGuard");
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      DeviceGuard(const DeviceGuard&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      DeviceGuard(DeviceGuard&&) = delete;
+
+      /// @brief Destructor. Restores the previous device.
+      ~DeviceGuard() noexcept
+      {
+        cudaSetDevice(mPrevious);
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      DeviceGuard& operator=(const DeviceGuard&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      DeviceGuard& operator=(DeviceGuard&&) = delete;
+    private:
+      int mPrevious{}; ///< The previously current device.
+  };
+
+  /**
+   * @brief Per-device execution context, owns a non-blocking stream of the device. Kernels for the device must be
+   *        launched with the device current, e.g. inside a DeviceGuard or the function passed to scatterGather().
+   */
+  class DeviceContext
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param device The device ordinal.
+       * @param homeDevice The device of the MATLAB gpuArrays, peer access to it is enabled where supported.
+       */
+      DeviceContext(int device, int homeDevice)
+      : mDevice{device}
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:DeviceContext:DeviceContext"};
+
+        DeviceGuard guard{device};
+
+        detail::checkCuda(cudaStreamCreateWithFlags(&mStream, cudaStreamNonBlocking), id);
+
+        if (device != homeDevice)
+        {
+          int canAccess{};
+
+          if (cudaDeviceCanAccessPeer(&canAccess, device, homeDevice) == cudaSuccess && canAccess != 0)
+          {
+            const cudaError_t err = cudaDeviceEnablePeerAccess(homeDevice, 0);
+
+            if (err == cudaSuccess || err == cudaErrorPeerAccessAlreadyEnabled)
+            {
+              mPeerAccess = true;
+            }
+
+            // Clear the error of an already enabled peer access so it is not reported by a later call.
+            static_cast<void>(cudaGetLastError());
+          }
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      DeviceContext(const DeviceContext&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other context, left without a stream.
+       */
+      DeviceContext(DeviceContext&& other) noexcept
+      : mDevice{other.mDevice}, mStream{std::exchange(other.mStream, nullptr)}, mPeerAccess{other.mPeerAccess}
+      {}
+
+      /// @brief Destructor. Destroys the stream.
+      ~DeviceContext() noexcept
+      {
+        if (mStream != nullptr)
+        {
+          int previous{};
+
+          if (cudaGetDevice(&previous) == cudaSuccess && cudaSetDevice(mDevice) == cudaSuccess)
+          {
+            cudaStreamDestroy(mStream);
+            cudaSetDevice(previous);
+          }
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      DeviceContext& operator=(const DeviceContext&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      DeviceContext& operator=(DeviceContext&&) = delete;
+
+      /**
+       * @brief Gets the device ordinal.
+       * @return The device ordinal.
+       */
+      [[nodiscard]] int getDevice() const noexcept
+      {
+        return mDevice;
+      }
+
+      /**
+       * @brief Gets the stream of the device.
+       * @return The stream.
+       */
+      [[nodiscard]] cudaStream_t getStream() const noexcept
+      {
+        return mStream;
+      }
+
+      /**
+       * @brief Checks if the device accesses the home device memory directly.
+       * @return True if peer access is enabled, false otherwise.
+       */
+      [[nodiscard]] bool hasPeerAccess() const noexcept
+      {
+        return mPeerAccess;
+      }
+
+      /// @brief Waits until all work queued on the stream has finished.
+      void synchronize() const
+      {
+        detail::checkCuda(cudaStreamSynchronize(mStream), "matlabw:mx:gpu:DeviceContext:synchronize");
+      }
+    private:
+      int          mDevice{};     ///< The device ordinal.
+      cudaStream_t mStream{};     ///< The stream.
+      bool         mPeerAccess{}; ///< Whether peer access to the home device is enabled.
+  };
+
+  /// @brief Part of a batch processed by one device.
+  struct Partition
+  {
+    std::size_t first{}; ///< Index of the first slice along the last dimension.
+    std::size_t count{}; ///< Number of slices.
+  };
+
+namespace detail
+{
+  /// @brief Device memory freed on destruction.
+  class DeviceMemory
+  {
+    public:
+      /// @brief Default constructor.
+      DeviceMemory() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param device The device ordinal.
+       * @param size The size in bytes.
+       */
+      DeviceMemory(int device, std::size_t size)
+      : mDevice{device}
+      {
+        if (size != 0)
+        {
+          DeviceGuard guard{device};
+
+          checkCuda(cudaMalloc(&mData, size), "matlabw:mx:gpu:scatterGather");
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      DeviceMemory(const DeviceMemory&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other memory, left empty.
+       */
+      DeviceMemory(DeviceMemory&& other) noexcept
+      : mDevice{other.mDevice}, mData{std::exchange(other.mData, nullptr)}
+      {}
+
+      /// @brief Destructor.
+      ~DeviceMemory() noexcept
+      {
+        if (mData != nullptr)
+        {
+          int previous{};
+
+          if (cudaGetDevice(&previous) == cudaSuccess && cudaSetDevice(mDevice) == cudaSuccess)
+          {
+            cudaFree(mData);
+            cudaSetDevice(previous);
+          }
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      DeviceMemory& operator=(const DeviceMemory&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      DeviceMemory& operator=(DeviceMemory&&) = delete;
+
+      /**
+       * @brief Gets the memory.
+       * @return Pointer to the memory.
+       */
+      [[nodiscard]] void* get() const noexcept
+      {
+        return mData;
+      }
+    private:
+      int   mDevice{}; ///< The device ordinal.
+      void* mData{};   ///< The memory.
+  };
+} // namespace detail
+
+  /**
+   * @brief Set of devices a batch is split across. The home device is the one current at construction, where MATLAB
+   *        keeps its gpuArrays.
+   */
+  class MultiDevice
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param devices The device ordinals, all devices if empty.
+       */
+      explicit MultiDevice(View<int> devices = {})
+      : mHomeDevice{getCurrentDevice()}
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:MultiDevice:MultiDevice"};
+
+        const int count = getDeviceCount();
+
+        std::vector<int> ordinals(devices.begin(), devices.end());
+
+        if (ordinals.empty())
+        {
+          for (int device{}; device < count; ++device)
+          {
+            ordinals.push_back(device);
+          }
+        }
+
+        mContexts.reserve(ordinals.size());
+
+        for (int device : ordinals)
+        {
+          if (device < 0 || device >= count)
+          {
+            throw Exception{id, "invalid device ordinal"};
+          }
+
+          mContexts.emplace_back(device, mHomeDevice);
+        }
+      }
+
+      /**
+       * @brief Gets the home device.
+       * @return The device ordinal.
+       */
+      [[nodiscard]] int getHomeDevice() const noexcept
+      {
+        return mHomeDevice;
+      }
+
+      /**
+       * @brief Gets the number of devices.
+       * @return The number of devices.
+       */
+      [[nodiscard]] std::size_t getDeviceCount() const noexcept
+      {
+        return mContexts.size();
+      }
+
+      /**
+       * @brief Gets the context of a device.
+       * @param i The index of the device in the set.
+       * @return The context.
+       */
+      [[nodiscard]] const DeviceContext& operator[](std::size_t i) const
+      {
+        return mContexts.at(i);
+      }
+
+      /**
+       * @brief Splits slices evenly across the devices.
+       * @param slices The number of slices.
+       * @return One partition per device, empty ones included.
+       */
+      [[nodiscard]] std::vector<Partition> partition(std::size_t slices) const
+      {
+        std::vector<Partition> parts(mContexts.size());
+
+        std::size_t first{};
+
+        for (std::size_t i{}; i < parts.size(); ++i)
+        {
+          const std::size_t count = slices / parts.size() + (i < slices % parts.size() ? 1 : 0);
+
+          parts[i] = Partition{first, count};
+          first   += count;
+        }
+
+        return parts;
+      }
+
+      /// @brief Waits until all work queued on the devices has finished.
+      void synchronize() const
+      {
+        for (const DeviceContext& context : mContexts)
+        {
+          context.synchronize();
+        }
+      }
+    private:
+      int                        mHomeDevice{}; ///< The home device.
+      std::vector<DeviceContext> mContexts{};   ///< The device contexts.
+  };
+
+namespace detail
+{
+  /**
+   * @brief Gets the dimensions of the result of scatterGather().
+   * @param dims The input dimensions.
+   * @param outLeadingDims The leading dimensions of the result, the input leading dimensions if empty.
+   * @return The result dimensions.
+   */
+  [[nodiscard]] inline std::vector<std::size_t> getGatherDims(View<std::size_t> dims, View<std::size_t> outLeadingDims)
+  {
+    std::vector<std::size_t> result{};
+
+    if (outLeadingDims.empty())
+    {
+      result.assign(dims.begin(), dims.end() - 1);
+    }
+    else
+    {
+      result.assign(outLeadingDims.begin(), outLeadingDims.end());
+    }
+
+    result.push_back(dims.back());
+
+    return result;
+  }
+
+  /**
+   * @brief Scatters the input across the devices, runs the function and gathers the result on the home device.
+   * @tparam T The input element type.
+   * @tparam U The result element type.
+   * @tparam Fn The function type.
+   * @param devices The devices.
+   * @param input Pointer to the input data.
+   * @param inputOnHost Whether the input is in host memory, otherwise it is on the home device.
+   * @param dims The input dimensions.
+   * @param outLeadingDims The leading dimensions of the result.
+   * @param fn The function.
+   * @return The result on the home device.
+   */
+  template<typename T, typename U, typename Fn>
+  [[nodiscard]] NumericArray<U> scatterGather(const MultiDevice&  devices,
+                                              const T*            input,
+                                              bool                inputOnHost,
+                                              View<std::size_t>   dims,
+                                              View<std::size_t>   outLeadingDims,
+                                              Fn&&                fn)
+  {
+    static constexpr char id[]{"matlabw:mx:gpu:scatterGather"};
+
+    if (dims.empty() || devices.getDeviceCount() == 0)
+    {
+      throw Exception{id, "input must not be empty and at least one device is required"};
+    }
+
+    const std::vector<std::size_t> outDims = getGatherDims(dims, outLeadingDims);
+
+    NumericArray<U> output = gpu::makeUninitNumericArray<U>(outDims);
+
+    const std::size_t inSliceSize  = std::accumulate(dims.begin(), dims.end() - 1, std::size_t{1},
+                                                     std::multiplies<>{});
+    const std::size_t outSliceSize = std::accumulate(outDims.begin(), outDims.end() - 1, std::size_t{1},
+                                                     std::multiplies<>{});
+    const int         home         = devices.getHomeDevice();
+
+    const std::vector<Partition> parts = devices.partition(dims.back());
+
+    std::vector<DeviceMemory> buffers{};
+
+    buffers.reserve(2 * parts.size());
+
+    for (std::size_t i{}; i < parts.size(); ++i)
+    {
+      const DeviceContext& context = devices[i];
+      const Partition&     part    = parts[i];
+
+      if (part.count == 0)
+      {
+        continue;
+      }
+
+      const std::size_t inBytes  = part.count * inSliceSize * sizeof(T);
+      const std::size_t outBytes = part.count * outSliceSize * sizeof(U);
+      const T*          inSrc    = input + part.first * inSliceSize;
+      U*                outDst   = output.getData() + part.first * outSliceSize;
+      const bool        local    = (context.getDevice() == home);
+
+      const T* in  = inSrc;
+      U*       out = outDst;
+
+      if (inputOnHost || !local)
+      {
+        buffers.emplace_back(context.getDevice(), inBytes);
+
+        T* buffer = static_cast<T*>(buffers.back().get());
+
+        DeviceGuard guard{context.getDevice()};
+
+        checkCuda(inputOnHost
+                  ? cudaMemcpyAsync(buffer, inSrc, inBytes, cudaMemcpyHostToDevice, context.getStream())
+                  : cudaMemcpyPeerAsync(buffer, context.getDevice(), inSrc, home, inBytes, context.getStream()),
+                  id);
+
+        in = buffer;
+      }
+
+      if (!local)
+      {
+        buffers.emplace_back(context.getDevice(), outBytes);
+        out = static_cast<U*>(buffers.back().get());
+      }
+
+      DeviceGuard guard{context.getDevice()};
+
+      const std::size_t inPartDims[]{inSliceSize, part.count};
+      const std::size_t outPartDims[]{outSliceSize, part.count};
+
+      fn(context, DeviceView<const T, 2>{in, inPartDims}, DeviceView<U, 2>{out, outPartDims}, part);
+
+      if (!local)
+      {
+        checkCuda(cudaMemcpyPeerAsync(outDst, home, out, context.getDevice(), outBytes, context.getStream()), id);
+      }
+    }
+
+    // The temporary buffers are freed only after all devices have finished.
+    devices.synchronize();
+
+    return output;
+  }
+} // namespace detail
+
+  /**
+   * @brief Splits a gpuArray along its last dimension across the devices, calls the function for every part with the
+   *        device current and gathers the results into a gpuArray on the home device. The part of the home device is
+   *        processed in place, the other parts are moved by peer copies, which go directly between the devices where
+   *        peer access is enabled. The function must queue its work on the stream of the context and not wait for it.
+   * @tparam U The result element type.
+   * @tparam T The input element type.
+   * @tparam Fn The function type, called as fn(const DeviceContext&, DeviceView<const T, 2> in, DeviceView<U, 2> out,
+   *            Partition), views hold the slices of the part as columns.
+   * @param devices The devices.
+   * @param input The input on the home device.
+   * @param fn The function.
+   * @param outLeadingDims The leading dimensions of the result, the input leading dimensions if empty.
+   * @return The result on the home device, its last dimension matches the input.
+   */
+  template<typename U, typename T, typename Fn>
+  [[nodiscard]] NumericArray<U> scatterGather(const MultiDevice&        devices,
+                                              const TypedArrayCref<T>&  input,
+                                              Fn&&                      fn,
+                                              View<std::size_t>         outLeadingDims = {})
+  {
+    return detail::scatterGather<T, U>(devices, input.getData(), false, input.getDims(), outLeadingDims,
+                                       std::forward<Fn>(fn));
+  }
+
+  /**
+   * @brief Splits a host array along its last dimension across the devices, see the gpuArray overload.
+   * @tparam U The result element type.
+   * @tparam T The input element type.
+   * @tparam Fn The function type.
+   * @param devices The devices.
+   * @param input The input in host memory.
+   * @param fn The function.
+   * @param outLeadingDims The leading dimensions of the result, the input leading dimensions if empty.
+   * @return The result on the home device, its last dimension matches the input.
+   */
+  template<typename U, typename T, typename Fn>
+  [[nodiscard]] NumericArray<U> scatterGather(const MultiDevice&            devices,
+                                              const mx::TypedArrayCref<T>&  input,
+                                              Fn&&                          fn,
+                                              View<std::size_t>             outLeadingDims = {})
+  {
+    return detail::scatterGather<T, U>(devices, input.getData(), true, input.getDims(), outLeadingDims,
+                                       std::forward<Fn>(fn));
+  }
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_MULTI_DEVICE_HPP */
@@ -0,0 +1,276 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_PINNED_POOL_HPP
+#define MATLABW_MX_GPU_PINNED_POOL_HPP
+
+#include "../detail/include.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "detail/cuda.hpp"
+#include "detail/sizeClass.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /**
+   * @brief Pool of page-locked host memory. Blocks are allocated with cudaHostAlloc, which takes milliseconds, and
+   *        kept in size-class freelists when deallocated, so repeated calls with the same shapes reuse them. The
+   *        memory is not managed by MATLAB and survives between MEX function calls until trim() or release(). The
+   *        pool is thread-safe.
+   */
+  class PinnedPool
+  {
+    public:
+      /// @brief Size of the smallest size class in bytes.
+      static constexpr std::size_t minBlockSize{4096};
+
+      /// @brief Default constructor.
+      PinnedPool() = default;
+
+      /// @brief Explicitly deleted copy constructor.
+      PinnedPool(const PinnedPool&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      PinnedPool(PinnedPool&&) = delete;
+
+      /// @brief Destructor. Releases all memory.
+      ~PinnedPool() noexcept
+      {
+        release();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      PinnedPool& operator=(const PinnedPool&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      PinnedPool& operator=(PinnedPool&&) = delete;
+
+      /**
+       * @brief Allocates page-locked memory.
+       * @param size The size of the memory in bytes.
+       * @return A pointer to the page-aligned memory. Never returns nullptr.
+       */
+      [[nodiscard]] void* allocate(std::size_t size)
+      {
+        const std::size_t classSize = getClassSize(size);
+
+        std::lock_guard lock{mMutex};
+
+        if (auto it = mFreeLists.find(classSize); it != mFreeLists.end() && !it->second.empty())
+        {
+          void* ptr = it->second.back();
+          it->second.pop_back();
+
+          mBytesCached -= classSize;
+          mBytesInUse  += classSize;
+
+          return ptr;
+        }
+
+        void* ptr{};
+
+        detail::checkCuda(cudaHostAlloc(&ptr, classSize, cudaHostAllocDefault), "matlabw:mx:gpu:PinnedPool:allocate");
+
+        mBlocks.emplace(ptr, classSize);
+        mBytesInUse += classSize;
+
+        return ptr;
+      }
+
+      /**
+       * @brief Returns memory to the pool. The memory is kept for later allocations of the same size class.
+       * @param ptr A pointer to the memory returned by allocate(). May be nullptr.
+       */
+      void deallocate(void* ptr) noexcept
+      {
+        if (ptr == nullptr)
+        {
+          return;
+        }
+
+        std::lock_guard lock{mMutex};
+
+        const auto it = mBlocks.find(ptr);
+
+        if (it == mBlocks.end())
+        {
+          return;
+        }
+
+        const std::size_t classSize = it->second;
+
+        mFreeLists[classSize].push_back(ptr);
+        mBytesInUse  -= classSize;
+        mBytesCached += classSize;
+      }
+
+      /// @brief Frees all cached blocks which are not in use.
+      void trim() noexcept
+      {
+        std::lock_guard lock{mMutex};
+
+        for (auto& [classSize, freeList] : mFreeLists)
+        {
+          for (void* ptr : freeList)
+          {
+            mBlocks.erase(ptr);
+            cudaFreeHost(ptr);
+          }
+
+          freeList.clear();
+        }
+
+        mBytesCached = 0;
+      }
+
+      /// @brief Frees all blocks including the ones in use.
+      void release() noexcept
+      {
+        std::lock_guard lock{mMutex};
+
+        for (const auto& [ptr, classSize] : mBlocks)
+        {
+          cudaFreeHost(ptr);
+        }
+
+        mBlocks.clear();
+        mFreeLists.clear();
+        mBytesInUse  = 0;
+        mBytesCached = 0;
+      }
+
+      /**
+       * @brief Gets the number of bytes handed out by the pool.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBytesInUse() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mBytesInUse;
+      }
+
+      /**
+       * @brief Gets the number of bytes kept in the freelists.
+       * @return The number of bytes.
+       */
+      [[nodiscard]] std::size_t getBytesCached() const
+      {
+        std::lock_guard lock{mMutex};
+
+        return mBytesCached;
+      }
+
+      /**
+       * @brief Gets the size of the blocks that serve a size, the size rounded up to its size class.
+       * @param size The size in bytes.
+       * @return The size of the blocks in bytes.
+       */
+      [[nodiscard]] static std::size_t getClassSize(std::size_t size)
+      {
+        return detail::roundToSizeClass(size, minBlockSize);
+      }
+    private:
+      mutable std::mutex                                  mMutex{};       ///< Protects the pool.
+      std::unordered_map<void*, std::size_t>              mBlocks{};      ///< All blocks and their sizes.
+      std::unordered_map<std::size_t, std::vector<void*>> mFreeLists{};   ///< Freelists of the size classes.
+      std::size_t                                         mBytesInUse{};  ///< Number of bytes in use.
+      std::size_t                                         mBytesCached{}; ///< Number of bytes in the freelists.
+  };
+
+  /**
+   * @brief Allocator for use with std containers which allocates from a pinned pool, e.g. for host staging buffers.
+   * @tparam T The type of the allocated memory.
+   */
+  template<typename T>
+  class PinnedAllocator
+  {
+    template<typename U>
+    friend class PinnedAllocator;
+
+    public:
+      using value_type = T; ///< The type of the allocated memory.
+
+      /**
+       * @brief Constructor.
+       * @param pool The pool, must outlive the allocator and all memory allocated by it.
+       */
+      explicit PinnedAllocator(PinnedPool& pool) noexcept
+      : mPool{&pool}
+      {}
+
+      /**
+       * @brief Copy constructor.
+       * @tparam U The type of the allocated memory.
+       * @param other The allocator to copy.
+       */
+      template<typename U>
+      PinnedAllocator(const PinnedAllocator<U>& other) noexcept
+      : mPool{other.mPool}
+      {}
+
+      /**
+       * @brief Allocates memory.
+       * @param n The number of elements to allocate.
+       * @return A pointer to the allocated memory.
+       */
+      [[nodiscard]] T* allocate(std::size_t n)
+      {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+          throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(mPool->allocate(n * sizeof(T)));
+      }
+
+      /**
+       * @brief Deallocates memory.
+       * @param ptr A pointer to the allocated memory.
+       * @param n The number of elements to deallocate.
+       */
+      void deallocate(T* ptr, std::size_t) noexcept
+      {
+        mPool->deallocate(ptr);
+      }
+
+      /**
+       * @brief Compares two allocators, allocators of the same pool are equal.
+       * @tparam U The type of the other allocator.
+       * @param other The other allocator.
+       * @return True if the allocators use the same pool.
+       */
+      template<typename U>
+      [[nodiscard]] bool operator==(const PinnedAllocator<U>& other) const noexcept
+      {
+        return mPool == other.mPool;
+      }
+    private:
+      PinnedPool* mPool; ///< The pool.
+  };
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_PINNED_POOL_HPP */
@@ -152,7 +152,7 @@ namespace matlabw::mx::gpu
       [[nodiscard]] operator TypedArrayRef<T>()
       {
         checkValid("matlabw:mx:gpu:TypedArray:operatorTypedArrayRef");
-        return TypedArrayRef<T>{get()};
+        return TypedArrayRef<T>{ArrayRef{*this}};
       }
 
       /**
@@ -162,7 +162,7 @@ namespace matlabw::mx::gpu
       [[nodiscard]] operator TypedArrayCref<T>() const
       {
         checkValid("matlabw:mx:gpu:TypedArray:operatorTypedArrayCref");
-        return TypedArrayCref<T>{get()};
+        return TypedArrayCref<T>{ArrayCref{*this}};
       }
     private:
       /**
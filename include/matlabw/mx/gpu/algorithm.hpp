@@ -0,0 +1,558 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_ALGORITHM_HPP
+#define MATLABW_MX_GPU_ALGORITHM_HPP
+
+#include "../detail/include.hpp"
+
+#include <cub/cub.cuh>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
+#include "detail/cuda.hpp"
+#include "DevicePool.hpp"
+#include "DeviceView.hpp"
+#include "NumericArray.hpp"
+#include "TypedArrayRef.hpp"
+#include "../Exception.hpp"
+
+namespace matlabw::mx::gpu::algorithm
+{
+namespace detail
+{
+  using gpu::detail::checkCuda;
+
+  /// @brief Checks if a type is supported by the CUB wrappers, the MATLAB numeric classes without logical and char.
+  template<typename T>
+  inline constexpr bool isCubType = std::is_floating_point_v<T>
+                                    || (std::is_integral_v<T> && !std::is_same_v<T, bool>
+                                                              && !std::is_same_v<T, char16_t>);
+
+  /**
+   * @brief Converts a number of elements to the int argument of CUB.
+   * @param size The size.
+   * @param id The error identifier.
+   * @return The size as int.
+   */
+  [[nodiscard]] inline int toCubInt(std::size_t size, const char* id)
+  {
+    if (size > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    {
+      throw Exception{id, "number of elements exceeds the range of CUB"};
+    }
+
+    return static_cast<int>(size);
+  }
+
+  /**
+   * @brief Runs a CUB device algorithm, its temporary storage is queried first and allocated from the pool.
+   * @tparam Fn The function type.
+   * @param pool The device pool.
+   * @param stream The stream.
+   * @param id The error identifier.
+   * @param fn The function called with (void* temp, std::size_t& bytes), returning the cudaError_t of the CUB call.
+   */
+  template<typename Fn>
+  void runCub(DevicePool& pool, cudaStream_t stream, const char* id, Fn&& fn)
+  {
+    std::size_t bytes{};
+
+    checkCuda(fn(nullptr, bytes), id);
+
+    DeviceBuffer<std::byte> temp{pool, std::max<std::size_t>(bytes, 1), stream};
+
+    checkCuda(fn(static_cast<void*>(temp.getData()), bytes), id);
+  }
+
+  /// @brief Maps a column index to the linear index of its first element.
+  struct ColumnOffset
+  {
+    int rows; ///< Number of rows.
+
+    /// @brief Gets the offset of a column.
+    MATLABW_GPU_HOST_DEVICE int operator()(int j) const noexcept { return j * rows; }
+  };
+
+  /// @brief Maps a linear index to the index of its column.
+  struct ColumnIndex
+  {
+    int rows; ///< Number of rows.
+
+    /// @brief Gets the column of an element.
+    MATLABW_GPU_HOST_DEVICE int operator()(int i) const noexcept { return i / rows; }
+  };
+
+  /// @brief Compares column indices.
+  struct SameColumn
+  {
+    /// @brief Tests if two elements are in the same column.
+    MATLABW_GPU_HOST_DEVICE bool operator()(int a, int b) const noexcept { return a == b; }
+  };
+
+  /**
+   * @brief Gets an iterator over the offsets of the columns, the end offsets start one column later.
+   * @param rows Number of rows.
+   * @return The iterator.
+   */
+  [[nodiscard]] inline auto makeColumnOffsets(int rows)
+  {
+    return thrust::make_transform_iterator(thrust::make_counting_iterator(0), ColumnOffset{rows});
+  }
+
+  /**
+   * @brief Gets the number of rows and columns of an array, trailing dimensions are folded into the columns.
+   * @param dims The dimensions.
+   * @param size The number of elements.
+   * @return The number of rows and columns.
+   */
+  [[nodiscard]] inline std::pair<std::size_t, std::size_t> getColumnShape(View<std::size_t> dims, std::size_t size)
+  {
+    const std::size_t rows = dims.empty() ? size : dims[0];
+
+    return {rows, (rows == 0) ? 0 : size / rows};
+  }
+
+  /**
+   * @brief Gets the dimensions of a column-wise reduction, the first dimension is 1.
+   * @param dims The dimensions of the input.
+   * @return The dimensions of the result.
+   */
+  [[nodiscard]] inline std::vector<std::size_t> getReducedDims(View<std::size_t> dims)
+  {
+    std::vector<std::size_t> result(dims.begin(), dims.end());
+
+    if (result.size() < 2)
+    {
+      result.resize(2, 1);
+    }
+
+    result[0] = 1;
+
+    return result;
+  }
+
+  /**
+   * @brief Reduces all elements to a 1x1 gpu array.
+   * @tparam T The element type.
+   * @tparam Reduce The CUB reduction type.
+   * @param pool The device pool.
+   * @param a The array.
+   * @param stream The stream.
+   * @param id The error identifier.
+   * @param reduce The function calling the CUB reduction with (temp, bytes, in, out, n).
+   * @return The result.
+   */
+  template<typename T, typename Reduce>
+  [[nodiscard]] NumericArray<T> reduce(DevicePool&              pool,
+                                       const TypedArrayCref<T>& a,
+                                       cudaStream_t             stream,
+                                       const char*              id,
+                                       Reduce&&                 reduce)
+  {
+    const int n = toCubInt(a.getSize(), id);
+
+    auto result = gpu::makeUninitNumericArray<T>(1, 1);
+
+    const T* in  = a.getData();
+    T*       out = result.getData();
+
+    runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+    {
+      return reduce(temp, bytes, in, out, n);
+    });
+
+    return result;
+  }
+} // namespace detail
+
+  /**
+   * @brief Sums all elements with cub::DeviceReduce, like sum(a(:)). Integers wrap on overflow.
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array.
+   * @param stream The stream.
+   * @return The 1x1 sum, 0 for an empty array.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> sum(DevicePool& pool, const TypedArrayCref<T>& a, cudaStream_t stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    return detail::reduce(pool, a, stream, "matlabw:mx:gpu:algorithm:sum",
+                          [&](void* temp, std::size_t& bytes, const T* in, T* out, int n)
+    {
+      return cub::DeviceReduce::Sum(temp, bytes, in, out, n, stream);
+    });
+  }
+
+  /**
+   * @brief Gets the smallest element with cub::DeviceReduce, like min(a(:)).
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array, must not be empty.
+   * @param stream The stream.
+   * @return The 1x1 minimum.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> min(DevicePool& pool, const TypedArrayCref<T>& a, cudaStream_t stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:min"};
+
+    if (a.getSize() == 0)
+    {
+      throw Exception{id, "array must not be empty"};
+    }
+
+    return detail::reduce(pool, a, stream, id, [&](void* temp, std::size_t& bytes, const T* in, T* out, int n)
+    {
+      return cub::DeviceReduce::Min(temp, bytes, in, out, n, stream);
+    });
+  }
+
+  /**
+   * @brief Gets the largest element with cub::DeviceReduce, like max(a(:)).
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array, must not be empty.
+   * @param stream The stream.
+   * @return The 1x1 maximum.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> max(DevicePool& pool, const TypedArrayCref<T>& a, cudaStream_t stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:max"};
+
+    if (a.getSize() == 0)
+    {
+      throw Exception{id, "array must not be empty"};
+    }
+
+    return detail::reduce(pool, a, stream, id, [&](void* temp, std::size_t& bytes, const T* in, T* out, int n)
+    {
+      return cub::DeviceReduce::Max(temp, bytes, in, out, n, stream);
+    });
+  }
+
+  /**
+   * @brief Sums each column with cub::DeviceSegmentedReduce in one launch, like sum(a, 1). Integers wrap on overflow.
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array, trailing dimensions are kept.
+   * @param stream The stream.
+   * @return The sums, of the dimensions of a with the first dimension 1.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> sumColumns(DevicePool&              pool,
+                                           const TypedArrayCref<T>& a,
+                                           cudaStream_t             stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:sumColumns"};
+
+    const std::size_t rows = detail::getColumnShape(a.getDims(), a.getSize()).first;
+
+    auto result = gpu::makeUninitNumericArray<T>(detail::getReducedDims(a.getDims()));
+
+    if (result.getSize() == 0)
+    {
+      return result;
+    }
+
+    if (rows == 0)
+    {
+      detail::checkCuda(cudaMemsetAsync(result.getData(), 0, result.getSize() * sizeof(T), stream), id);
+      return result;
+    }
+
+    const int  size    = detail::toCubInt(a.getSize(), id);
+    const auto offsets = detail::makeColumnOffsets(static_cast<int>(rows));
+    const T*   in      = a.getData();
+    T*         out     = result.getData();
+    const int  n       = size / static_cast<int>(rows);
+
+    detail::runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+    {
+      return cub::DeviceSegmentedReduce::Sum(temp, bytes, in, out, n, offsets, offsets + 1, stream);
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Computes the inclusive prefix sums of all elements in column-major order with cub::DeviceScan, like
+   *        reshape(cumsum(a(:)), size(a)). Integers wrap on overflow.
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array.
+   * @param stream The stream.
+   * @return The prefix sums, of the dimensions of a.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> cumsum(DevicePool& pool, const TypedArrayCref<T>& a, cudaStream_t stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:cumsum"};
+
+    const int n = detail::toCubInt(a.getSize(), id);
+
+    auto result = gpu::makeUninitNumericArray<T>(a.getDims());
+
+    if (n == 0)
+    {
+      return result;
+    }
+
+    const T* in  = a.getData();
+    T*       out = result.getData();
+
+    detail::runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+    {
+      return cub::DeviceScan::InclusiveSum(temp, bytes, in, out, n, stream);
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Computes the inclusive prefix sums of each column with cub::DeviceScan::InclusiveSumByKey in one launch,
+   *        like cumsum(a, 1). Integers wrap on overflow.
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array.
+   * @param stream The stream.
+   * @return The prefix sums, of the dimensions of a.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> cumsumColumns(DevicePool&              pool,
+                                              const TypedArrayCref<T>& a,
+                                              cudaStream_t             stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:cumsumColumns"};
+
+    const int n = detail::toCubInt(a.getSize(), id);
+
+    auto result = gpu::makeUninitNumericArray<T>(a.getDims());
+
+    if (n == 0)
+    {
+      return result;
+    }
+
+    const auto rows    = static_cast<int>(detail::getColumnShape(a.getDims(), a.getSize()).first);
+    const auto columns = thrust::make_transform_iterator(thrust::make_counting_iterator(0), detail::ColumnIndex{rows});
+    const T*   in      = a.getData();
+    T*         out     = result.getData();
+
+    detail::runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+    {
+      return cub::DeviceScan::InclusiveSumByKey(temp, bytes, columns, in, out, n, detail::SameColumn{}, stream);
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Counts the elements in equally spaced bins with cub::DeviceHistogram, like histcounts(a, bins,
+   *        'BinLimits', [lower, upper]) except that the upper limit is exclusive. Elements outside the limits and NaN
+   *        are not counted.
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array.
+   * @param bins The number of bins.
+   * @param lower The inclusive lower limit of the first bin.
+   * @param upper The exclusive upper limit of the last bin.
+   * @param stream The stream.
+   * @return The bins x 1 counts.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<std::uint32_t> histogram(DevicePool&              pool,
+                                                      const TypedArrayCref<T>& a,
+                                                      std::size_t              bins,
+                                                      T                        lower,
+                                                      T                        upper,
+                                                      cudaStream_t             stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:histogram"};
+
+    if (bins == 0 || !(lower < upper))
+    {
+      throw Exception{id, "histogram needs at least one bin and lower < upper"};
+    }
+
+    const int n      = detail::toCubInt(a.getSize(), id);
+    const int levels = detail::toCubInt(bins + 1, id);
+
+    auto result = gpu::makeUninitNumericArray<std::uint32_t>(bins, 1);
+
+    const T*       in  = a.getData();
+    std::uint32_t* out = result.getData();
+
+    detail::runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+    {
+      return cub::DeviceHistogram::HistogramEven(temp, bytes, in, out, levels, lower, upper, n, stream);
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Sorts all elements in ascending order with cub::DeviceRadixSort, like reshape(sort(a(:)), size(a)).
+   *        Floating point values are ordered by IEEE 754 total order, so positive NaN is last and -0 precedes 0.
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array.
+   * @param stream The stream.
+   * @return The sorted elements, of the dimensions of a.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> sort(DevicePool& pool, const TypedArrayCref<T>& a, cudaStream_t stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:sort"};
+
+    const int n = detail::toCubInt(a.getSize(), id);
+
+    auto result = gpu::makeUninitNumericArray<T>(a.getDims());
+
+    if (n == 0)
+    {
+      return result;
+    }
+
+    const T* in  = a.getData();
+    T*       out = result.getData();
+
+    detail::runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+    {
+      return cub::DeviceRadixSort::SortKeys(temp, bytes, in, out, n, 0, static_cast<int>(sizeof(T) * 8), stream);
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Sorts each column in ascending order with cub::DeviceSegmentedRadixSort in one launch, like sort(a, 1).
+   *        Floating point values are ordered as by sort().
+   * @tparam T The element type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param a The array.
+   * @param stream The stream.
+   * @return The sorted columns, of the dimensions of a.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> sortColumns(DevicePool&              pool,
+                                            const TypedArrayCref<T>& a,
+                                            cudaStream_t             stream = nullptr)
+  {
+    static_assert(detail::isCubType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:sortColumns"};
+
+    const int n = detail::toCubInt(a.getSize(), id);
+
+    auto result = gpu::makeUninitNumericArray<T>(a.getDims());
+
+    if (n == 0)
+    {
+      return result;
+    }
+
+    const auto [rows, cols] = detail::getColumnShape(a.getDims(), a.getSize());
+
+    const auto offsets = detail::makeColumnOffsets(static_cast<int>(rows));
+    const T*   in      = a.getData();
+    T*         out     = result.getData();
+    const int  segs    = static_cast<int>(cols);
+
+    detail::runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+    {
+      return cub::DeviceSegmentedRadixSort::SortKeys(temp, bytes, in, out, n, segs, offsets, offsets + 1,
+                                                     0, static_cast<int>(sizeof(T) * 8), stream);
+    });
+
+    return result;
+  }
+
+  /**
+   * @brief Sorts values by their keys in ascending order with cub::DeviceRadixSort. The sort is stable, values of
+   *        equal keys keep their order. Floating point keys are ordered as by sort().
+   * @tparam K The key type, a real numeric type.
+   * @tparam V The value type, a real numeric type.
+   * @param pool The device pool the temporary storage is allocated from.
+   * @param keys The keys.
+   * @param values The values, of as many elements as the keys.
+   * @param stream The stream.
+   * @return The sorted keys and the values in the same order, of the dimensions of the inputs.
+   */
+  template<typename K, typename V>
+  [[nodiscard]] std::pair<NumericArray<K>, NumericArray<V>> sortByKey(DevicePool&              pool,
+                                                                      const TypedArrayCref<K>& keys,
+                                                                      const TypedArrayCref<V>& values,
+                                                                      cudaStream_t             stream = nullptr)
+  {
+    static_assert(detail::isCubType<K> && detail::isCubType<V>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:algorithm:sortByKey"};
+
+    if (keys.getSize() != values.getSize())
+    {
+      throw Exception{id, "keys and values must have the same number of elements"};
+    }
+
+    const int n = detail::toCubInt(keys.getSize(), id);
+
+    auto sortedKeys   = gpu::makeUninitNumericArray<K>(keys.getDims());
+    auto sortedValues = gpu::makeUninitNumericArray<V>(values.getDims());
+
+    if (n != 0)
+    {
+      const K* keysIn    = keys.getData();
+      K*       keysOut   = sortedKeys.getData();
+      const V* valuesIn  = values.getData();
+      V*       valuesOut = sortedValues.getData();
+
+      detail::runCub(pool, stream, id, [&](void* temp, std::size_t& bytes)
+      {
+        return cub::DeviceRadixSort::SortPairs(temp, bytes, keysIn, keysOut, valuesIn, valuesOut, n,
+                                               0, static_cast<int>(sizeof(K) * 8), stream);
+      });
+    }
+
+    return {std::move(sortedKeys), std::move(sortedValues)};
+  }
+} // namespace matlabw::mx::gpu::algorithm
+
+#endif /* MATLABW_MX_GPU_ALGORITHM_HPP */
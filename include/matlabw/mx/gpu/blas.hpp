@@ -0,0 +1,331 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_BLAS_HPP
+#define MATLABW_MX_GPU_BLAS_HPP
+
+#include "../detail/include.hpp"
+
+#include "HandleCache.hpp"
+#include "NumericArray.hpp"
+#include "TypedArrayRef.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /// @brief Operation applied to a matrix argument.
+  enum class Transpose
+  {
+    none      = CUBLAS_OP_N, ///< The matrix as is.
+    transpose = CUBLAS_OP_T, ///< The transpose.
+    conjugate = CUBLAS_OP_C, ///< The conjugate transpose.
+  };
+
+namespace detail
+{
+  /**
+   * @brief Gets the cuBLAS type of an element type.
+   * @tparam T The element type.
+   */
+  template<typename T>
+  using BlasType = std::conditional_t<std::is_same_v<T, std::complex<float>>, cuComplex,
+                   std::conditional_t<std::is_same_v<T, std::complex<double>>, cuDoubleComplex, T>>;
+
+  /// @brief Checks if a type is supported by the cuBLAS wrappers.
+  template<typename T>
+  inline constexpr bool isBlasType = std::is_same_v<T, float> || std::is_same_v<T, double>
+                                     || std::is_same_v<T, std::complex<float>>
+                                     || std::is_same_v<T, std::complex<double>>;
+
+  /**
+   * @brief Reinterprets element data as cuBLAS data, std::complex has the layout of the cuBLAS complex types.
+   * @tparam T The element type.
+   * @param ptr The data.
+   * @return The cuBLAS data.
+   */
+  template<typename T>
+  [[nodiscard]] BlasType<std::remove_const_t<T>>* toBlas(T* ptr) noexcept
+  {
+    return reinterpret_cast<BlasType<std::remove_const_t<T>>*>(const_cast<std::remove_const_t<T>*>(ptr));
+  }
+
+  /// @brief Calls cublas<t>gemm for float.
+  inline cublasStatus_t gemm(cublasHandle_t h, cublasOperation_t ta, cublasOperation_t tb, int m, int n, int k,
+                             const float* alpha, const float* a, int lda, const float* b, int ldb, const float* beta,
+                             float* c, int ldc)
+  {
+    return cublasSgemm(h, ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+  }
+
+  /// @brief Calls cublas<t>gemm for double.
+  inline cublasStatus_t gemm(cublasHandle_t h, cublasOperation_t ta, cublasOperation_t tb, int m, int n, int k,
+                             const double* alpha, const double* a, int lda, const double* b, int ldb,
+                             const double* beta, double* c, int ldc)
+  {
+    return cublasDgemm(h, ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+  }
+
+  /// @brief Calls cublas<t>gemm for single complex.
+  inline cublasStatus_t gemm(cublasHandle_t h, cublasOperation_t ta, cublasOperation_t tb, int m, int n, int k,
+                             const cuComplex* alpha, const cuComplex* a, int lda, const cuComplex* b, int ldb,
+                             const cuComplex* beta, cuComplex* c, int ldc)
+  {
+    return cublasCgemm(h, ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+  }
+
+  /// @brief Calls cublas<t>gemm for double complex.
+  inline cublasStatus_t gemm(cublasHandle_t h, cublasOperation_t ta, cublasOperation_t tb, int m, int n, int k,
+                             const cuDoubleComplex* alpha, const cuDoubleComplex* a, int lda,
+                             const cuDoubleComplex* b, int ldb, const cuDoubleComplex* beta, cuDoubleComplex* c,
+                             int ldc)
+  {
+    return cublasZgemm(h, ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+  }
+
+  /// @brief Calls cublas<t>gemv for float.
+  inline cublasStatus_t gemv(cublasHandle_t h, cublasOperation_t ta, int m, int n, const float* alpha,
+                             const float* a, int lda, const float* x, int incx, const float* beta, float* y, int incy)
+  {
+    return cublasSgemv(h, ta, m, n, alpha, a, lda, x, incx, beta, y, incy);
+  }
+
+  /// @brief Calls cublas<t>gemv for double.
+  inline cublasStatus_t gemv(cublasHandle_t h, cublasOperation_t ta, int m, int n, const double* alpha,
+                             const double* a, int lda, const double* x, int incx, const double* beta, double* y,
+                             int incy)
+  {
+    return cublasDgemv(h, ta, m, n, alpha, a, lda, x, incx, beta, y, incy);
+  }
+
+  /// @brief Calls cublas<t>gemv for single complex.
+  inline cublasStatus_t gemv(cublasHandle_t h, cublasOperation_t ta, int m, int n, const cuComplex* alpha,
+                             const cuComplex* a, int lda, const cuComplex* x, int incx, const cuComplex* beta,
+                             cuComplex* y, int incy)
+  {
+    return cublasCgemv(h, ta, m, n, alpha, a, lda, x, incx, beta, y, incy);
+  }
+
+  /// @brief Calls cublas<t>gemv for double complex.
+  inline cublasStatus_t gemv(cublasHandle_t h, cublasOperation_t ta, int m, int n, const cuDoubleComplex* alpha,
+                             const cuDoubleComplex* a, int lda, const cuDoubleComplex* x, int incx,
+                             const cuDoubleComplex* beta, cuDoubleComplex* y, int incy)
+  {
+    return cublasZgemv(h, ta, m, n, alpha, a, lda, x, incx, beta, y, incy);
+  }
+
+  /**
+   * @brief Gets the rows and columns of a matrix argument after the operation.
+   * @param id The error identifier.
+   * @param dims The matrix dimensions.
+   * @param op The operation.
+   * @return The rows and columns.
+   */
+  [[nodiscard]] inline std::pair<std::size_t, std::size_t> getOpDims(const char*       id,
+                                                                     View<std::size_t> dims,
+                                                                     Transpose         op)
+  {
+    if (dims.size() > 2)
+    {
+      throw Exception{id, "matrix arguments must be 2-D"};
+    }
+
+    const std::size_t m = dims[0];
+    const std::size_t n = (dims.size() > 1) ? dims[1] : 1;
+
+    return (op == Transpose::none) ? std::pair{m, n} : std::pair{n, m};
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes C = alpha * op(A) * op(B) + beta * C with cuBLAS on a stream.
+   * @tparam T The element type, float, double or their complex types.
+   * @param cache The handle cache.
+   * @param a The matrix A.
+   * @param b The matrix B.
+   * @param c The matrix C, of size rows(op(A)) x columns(op(B)).
+   * @param stream The stream.
+   * @param opA The operation applied to A.
+   * @param opB The operation applied to B.
+   * @param alpha The scalar alpha.
+   * @param beta The scalar beta, C is not read if 0.
+   */
+  template<typename T>
+  void gemm(HandleCache&             cache,
+            const TypedArrayCref<T>& a,
+            const TypedArrayCref<T>& b,
+            const TypedArrayRef<T>&  c,
+            cudaStream_t             stream,
+            Transpose                opA   = Transpose::none,
+            Transpose                opB   = Transpose::none,
+            T                        alpha = T{1},
+            T                        beta  = T{})
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:gemm"};
+
+    const auto [m, k] = detail::getOpDims(id, a.getDims(), opA);
+    const auto [kb, n] = detail::getOpDims(id, b.getDims(), opB);
+    const auto [mc, nc] = detail::getOpDims(id, c.getDims(), Transpose::none);
+
+    if (k != kb || m != mc || n != nc)
+    {
+      throw Exception{id, "matrix dimensions do not agree"};
+    }
+
+    if (m == 0 || n == 0)
+    {
+      return;
+    }
+
+    const auto lda = std::max(detail::toLibraryInt(a.getDims()[0], id), 1);
+    const auto ldb = std::max(detail::toLibraryInt(b.getDims()[0], id), 1);
+
+    detail::checkCublas(detail::gemm(cache.getBlasHandle(stream),
+                                     static_cast<cublasOperation_t>(opA),
+                                     static_cast<cublasOperation_t>(opB),
+                                     detail::toLibraryInt(m, id),
+                                     detail::toLibraryInt(n, id),
+                                     detail::toLibraryInt(k, id),
+                                     detail::toBlas(&alpha),
+                                     detail::toBlas(a.getData()),
+                                     lda,
+                                     detail::toBlas(b.getData()),
+                                     ldb,
+                                     detail::toBlas(&beta),
+                                     detail::toBlas(c.getData()),
+                                     detail::toLibraryInt(m, id)),
+                        id);
+  }
+
+  /**
+   * @brief Computes op(A) * op(B) with cuBLAS on a stream.
+   * @tparam T The element type, float, double or their complex types.
+   * @param cache The handle cache.
+   * @param a The matrix A.
+   * @param b The matrix B.
+   * @param stream The stream.
+   * @param opA The operation applied to A.
+   * @param opB The operation applied to B.
+   * @return The product, of size rows(op(A)) x columns(op(B)).
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> gemm(HandleCache&             cache,
+                                     const TypedArrayCref<T>& a,
+                                     const TypedArrayCref<T>& b,
+                                     cudaStream_t             stream,
+                                     Transpose                opA = Transpose::none,
+                                     Transpose                opB = Transpose::none)
+  {
+    const std::size_t m = detail::getOpDims("matlabw:mx:gpu:gemm", a.getDims(), opA).first;
+    const std::size_t n = detail::getOpDims("matlabw:mx:gpu:gemm", b.getDims(), opB).second;
+
+    auto c = gpu::makeUninitNumericArray<T>(m, n);
+
+    gemm(cache, a, b, TypedArrayRef<T>{ArrayRef{c}}, stream, opA, opB);
+
+    return c;
+  }
+
+  /**
+   * @brief Computes y = alpha * op(A) * x + beta * y with cuBLAS on a stream.
+   * @tparam T The element type, float, double or their complex types.
+   * @param cache The handle cache.
+   * @param a The matrix A.
+   * @param x The vector x.
+   * @param y The vector y, of rows(op(A)) elements.
+   * @param stream The stream.
+   * @param opA The operation applied to A.
+   * @param alpha The scalar alpha.
+   * @param beta The scalar beta, y is not read if 0.
+   */
+  template<typename T>
+  void gemv(HandleCache&             cache,
+            const TypedArrayCref<T>& a,
+            const TypedArrayCref<T>& x,
+            const TypedArrayRef<T>&  y,
+            cudaStream_t             stream,
+            Transpose                opA   = Transpose::none,
+            T                        alpha = T{1},
+            T                        beta  = T{})
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:gpu:gemv"};
+
+    const auto [m, n] = detail::getOpDims(id, a.getDims(), Transpose::none);
+    const auto [rows, cols] = detail::getOpDims(id, a.getDims(), opA);
+
+    if (x.getSize() != cols || y.getSize() != rows)
+    {
+      throw Exception{id, "matrix and vector dimensions do not agree"};
+    }
+
+    if (rows == 0)
+    {
+      return;
+    }
+
+    detail::checkCublas(detail::gemv(cache.getBlasHandle(stream),
+                                     static_cast<cublasOperation_t>(opA),
+                                     detail::toLibraryInt(m, id),
+                                     detail::toLibraryInt(n, id),
+                                     detail::toBlas(&alpha),
+                                     detail::toBlas(a.getData()),
+                                     std::max(detail::toLibraryInt(m, id), 1),
+                                     detail::toBlas(x.getData()),
+                                     1,
+                                     detail::toBlas(&beta),
+                                     detail::toBlas(y.getData()),
+                                     1),
+                        id);
+  }
+
+  /**
+   * @brief Computes op(A) * x with cuBLAS on a stream.
+   * @tparam T The element type, float, double or their complex types.
+   * @param cache The handle cache.
+   * @param a The matrix A.
+   * @param x The vector x.
+   * @param stream The stream.
+   * @param opA The operation applied to A.
+   * @return The product, a column vector of rows(op(A)) elements.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> gemv(HandleCache&             cache,
+                                     const TypedArrayCref<T>& a,
+                                     const TypedArrayCref<T>& x,
+                                     cudaStream_t             stream,
+                                     Transpose                opA = Transpose::none)
+  {
+    const std::size_t rows = detail::getOpDims("matlabw:mx:gpu:gemv", a.getDims(), opA).first;
+
+    auto y = gpu::makeUninitNumericArray<T>(rows, 1);
+
+    gemv(cache, a, x, TypedArrayRef<T>{ArrayRef{y}}, stream, opA);
+
+    return y;
+  }
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_BLAS_HPP */
@@ -0,0 +1,50 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_DETAIL_CUDA_HPP
+#define MATLABW_MX_GPU_DETAIL_CUDA_HPP
+
+#include "../../detail/include.hpp"
+
+#include <cuda_runtime_api.h>
+
+#include "../../Exception.hpp"
+
+namespace matlabw::mx::gpu::detail
+{
+  /**
+   * @brief Throws an exception if a CUDA runtime call failed.
+   * @param err The error code.
+   * @param id The error identifier.
+   */
+  inline void checkCuda(cudaError_t err, const char* id)
+  {
+    if (err != cudaSuccess)
+    {
+      throw Exception{id, cudaGetErrorString(err)};
+    }
+  }
+} // namespace matlabw::mx::gpu::detail
+
+#endif /* MATLABW_MX_GPU_DETAIL_CUDA_HPP */
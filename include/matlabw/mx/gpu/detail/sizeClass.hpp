@@ -0,0 +1,57 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_DETAIL_SIZE_CLASS_HPP
+#define MATLABW_MX_GPU_DETAIL_SIZE_CLASS_HPP
+
+#include "../../detail/include.hpp"
+
+namespace matlabw::mx::gpu::detail
+{
+  /**
+   * @brief Rounds a size up to its size class. Each power of two is split into four size classes, which bounds the
+   *        waste of large blocks to 25 %.
+   * @param size The size in bytes.
+   * @param minSize The size of the smallest size class in bytes.
+   * @return The size of the blocks of the size class in bytes.
+   */
+  [[nodiscard]] inline std::size_t roundToSizeClass(std::size_t size, std::size_t minSize)
+  {
+    if (size <= minSize)
+    {
+      return minSize;
+    }
+
+    if (size > std::numeric_limits<std::size_t>::max() / 2)
+    {
+      throw std::bad_alloc();
+    }
+
+    const std::size_t quarter = std::bit_floor(size - 1) / 4;
+
+    return (size + quarter - 1) / quarter * quarter;
+  }
+} // namespace matlabw::mx::gpu::detail
+
+#endif /* MATLABW_MX_GPU_DETAIL_SIZE_CLASS_HPP */
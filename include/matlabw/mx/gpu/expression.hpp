@@ -0,0 +1,578 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_EXPRESSION_HPP
+#define MATLABW_MX_GPU_EXPRESSION_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+
+#include "DeviceView.hpp"
+#include "launch.hpp"
+#include "NumericArray.hpp"
+#include "TypedArray.hpp"
+#include "TypedArrayRef.hpp"
+#include "../Exception.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /// @brief Base of the gpu expression nodes, marks a type as an expression.
+  struct ExpressionBase {};
+
+  /**
+   * @brief Is the type a gpu elementwise expression?
+   * @tparam E Type
+   */
+  template<typename E>
+  concept Expression = std::is_base_of_v<ExpressionBase, std::remove_cvref_t<E>>;
+
+  /**
+   * @brief Is the type a typed gpu array (TypedArrayCref, TypedArrayRef, TypedArray, NumericArray, ...)?
+   * @tparam A Type
+   */
+  template<typename A>
+  concept ExpressionArray = requires(const A& a)
+  {
+    { a.getData() } -> std::convertible_to<const std::remove_cv_t<typename A::value_type>*>;
+    { a.getDims() } -> std::convertible_to<View<std::size_t>>;
+  };
+
+  /**
+   * @brief Leaf expression referring to the device elements of a gpu array, which must outlive the expression.
+   * @tparam T Element type
+   */
+  template<typename T>
+  struct ArrayExpr : ExpressionBase
+  {
+    using value_type = T; ///< Element type
+
+    static constexpr bool isScalar{false}; ///< The expression has elements of its own.
+
+    DeviceView<const T> view; ///< The device elements
+    std::size_t         size; ///< Number of elements
+    View<std::size_t>   dims; ///< Dimensions, read on the host only
+
+    /// @brief Gets the element at a linear index.
+    MATLABW_GPU_HOST_DEVICE T operator[](std::size_t i) const noexcept { return view[i]; }
+  };
+
+  /**
+   * @brief Leaf expression of a scalar broadcast to all elements.
+   * @tparam T Element type
+   */
+  template<typename T>
+  struct ScalarExpr : ExpressionBase
+  {
+    using value_type = T; ///< Element type
+
+    static constexpr bool isScalar{true}; ///< The expression is broadcast.
+
+    T                 value; ///< The scalar
+    std::size_t       size;  ///< Always 1
+    View<std::size_t> dims;  ///< Always empty
+
+    /// @brief Gets the scalar.
+    MATLABW_GPU_HOST_DEVICE T operator[](std::size_t) const noexcept { return value; }
+  };
+
+  /**
+   * @brief Expression applying an operation to the elements of another expression.
+   * @tparam Op Operation type
+   * @tparam E Operand type
+   */
+  template<typename Op, typename E>
+  struct UnaryExpr : ExpressionBase
+  {
+    using value_type = typename E::value_type; ///< Element type
+
+    static constexpr bool isScalar{E::isScalar}; ///< Whether the expression is broadcast.
+
+    Op                op;      ///< The operation
+    E                 operand; ///< The operand
+    std::size_t       size;    ///< Number of elements
+    View<std::size_t> dims;    ///< Dimensions
+
+    /**
+     * @brief Constructor.
+     * @param op The operation
+     * @param operand The operand
+     */
+    UnaryExpr(Op op, const E& operand) noexcept
+    : op{op}, operand{operand}, size{operand.size}, dims{operand.dims}
+    {}
+
+    /// @brief Gets the element at a linear index.
+    MATLABW_GPU_HOST_DEVICE value_type operator[](std::size_t i) const { return op(operand[i]); }
+  };
+
+  /**
+   * @brief Expression applying an operation to the elements of two other expressions, scalars are broadcast.
+   * @tparam Op Operation type
+   * @tparam L Left operand type
+   * @tparam R Right operand type
+   */
+  template<typename Op, typename L, typename R>
+  struct BinaryExpr : ExpressionBase
+  {
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>, "element types must match");
+
+    using value_type = typename L::value_type; ///< Element type
+
+    static constexpr bool isScalar{L::isScalar && R::isScalar}; ///< Whether the expression is broadcast.
+
+    Op                op;    ///< The operation
+    L                 left;  ///< The left operand
+    R                 right; ///< The right operand
+    std::size_t       size;  ///< Number of elements
+    View<std::size_t> dims;  ///< Dimensions, of the first operand which has any
+
+    /**
+     * @brief Constructor. Checks that the sizes of non-scalar operands match.
+     * @param op The operation
+     * @param left The left operand
+     * @param right The right operand
+     */
+    BinaryExpr(Op op, const L& left, const R& right)
+    : op{op}, left{left}, right{right}, size{L::isScalar ? right.size : left.size},
+      dims{left.dims.empty() ? right.dims : left.dims}
+    {
+      if constexpr (!L::isScalar && !R::isScalar)
+      {
+        if (left.size != right.size)
+        {
+          throw Exception{"matlabw:mx:gpu:Expression", "operand sizes do not match"};
+        }
+      }
+    }
+
+    /// @brief Gets the element at a linear index.
+    MATLABW_GPU_HOST_DEVICE value_type operator[](std::size_t i) const { return op(left[i], right[i]); }
+  };
+
+  /**
+   * @brief Starts an expression from a gpu array. Arrays combined with an expression are wrapped automatically.
+   * @tparam In Input type, a typed gpu array or an expression
+   * @param in Input, must outlive the expression
+   * @return The expression
+   */
+  template<typename In>
+    requires (Expression<In> || ExpressionArray<In>)
+  [[nodiscard]] auto expr(const In& in)
+  {
+    if constexpr (Expression<In>)
+    {
+      return in;
+    }
+    else
+    {
+      using T = std::remove_cv_t<typename In::value_type>;
+
+      static_assert(std::is_floating_point_v<T>, "gpu expressions support real float and double elements only");
+
+      const View<std::size_t> dims = in.getDims();
+
+      return ArrayExpr<T>{{}, DeviceView<const T>{in.getData(), dims}, in.getSize(), dims};
+    }
+  }
+
+namespace detail
+{
+  /**
+   * @brief Is the type a scalar operand of a gpu expression?
+   * @tparam T Type
+   */
+  template<typename T>
+  concept ExpressionScalar = std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
+  /**
+   * @brief Converts an operand to an expression, scalars are cast to the element type of the other operand.
+   * @tparam T Element type of the other operand
+   * @tparam A Operand type
+   * @param a The operand
+   * @return The expression
+   */
+  template<typename T, typename A>
+  [[nodiscard]] auto toOperand(const A& a)
+  {
+    if constexpr (ExpressionScalar<A>)
+    {
+      return ScalarExpr<T>{{}, static_cast<T>(a), 1, {}};
+    }
+    else
+    {
+      return expr(a);
+    }
+  }
+
+  /**
+   * @brief Gets the element type of an expression operand.
+   * @tparam A Operand type, an expression or a gpu array
+   */
+  template<typename A>
+  using OperandType = typename decltype(expr(std::declval<const A&>()))::value_type;
+
+  /**
+   * @brief Makes a binary expression, one operand is an expression and the other an expression, array or scalar.
+   * @tparam Op Operation type
+   * @tparam L Left operand type
+   * @tparam R Right operand type
+   * @param op The operation
+   * @param l The left operand
+   * @param r The right operand
+   * @return The expression
+   */
+  template<typename Op, typename L, typename R>
+  [[nodiscard]] auto makeBinary(Op op, const L& l, const R& r)
+  {
+    if constexpr (ExpressionScalar<L>)
+    {
+      using T = OperandType<R>;
+
+      return BinaryExpr<Op, ScalarExpr<T>, decltype(expr(r))>{op, toOperand<T>(l), expr(r)};
+    }
+    else
+    {
+      using T = OperandType<L>;
+
+      return BinaryExpr<Op, decltype(expr(l)), decltype(toOperand<T>(r))>{op, expr(l), toOperand<T>(r)};
+    }
+  }
+
+  /// @brief Addition operation.
+  struct AddOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x, T y) const noexcept { return x + y; }
+  };
+
+  /// @brief Subtraction operation.
+  struct SubtractOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x, T y) const noexcept { return x - y; }
+  };
+
+  /// @brief Multiplication operation.
+  struct MultiplyOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x, T y) const noexcept { return x * y; }
+  };
+
+  /// @brief Division operation.
+  struct DivideOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x, T y) const noexcept { return x / y; }
+  };
+
+  /// @brief Minimum operation, NaN is ignored like MATLAB's min.
+  struct MinOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x, T y) const noexcept { return std::fmin(x, y); }
+  };
+
+  /// @brief Maximum operation, NaN is ignored like MATLAB's max.
+  struct MaxOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x, T y) const noexcept { return std::fmax(x, y); }
+  };
+
+  /// @brief Negation operation.
+  struct NegateOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x) const noexcept { return -x; }
+  };
+
+  /// @brief Absolute value operation.
+  struct AbsOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x) const noexcept { return std::fabs(x); }
+  };
+
+  /// @brief Square root operation.
+  struct SqrtOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x) const noexcept { return std::sqrt(x); }
+  };
+
+  /// @brief Exponential operation.
+  struct ExpOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x) const noexcept { return std::exp(x); }
+  };
+
+  /// @brief Natural logarithm operation.
+  struct LogOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x) const noexcept { return std::log(x); }
+  };
+
+  /// @brief Sine operation.
+  struct SinOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x) const noexcept { return std::sin(x); }
+  };
+
+  /// @brief Cosine operation.
+  struct CosOp
+  {
+    template<typename T>
+    MATLABW_GPU_HOST_DEVICE T operator()(T x) const noexcept { return std::cos(x); }
+  };
+
+#ifdef __CUDACC__
+  /**
+   * @brief Kernel evaluating an expression into device memory, one instantiation per expression type, so the whole
+   *        chain of operations is fused into a single pass over the elements.
+   * @tparam T Element type
+   * @tparam E Expression type
+   * @param out The output
+   * @param e The expression
+   */
+  template<typename T, typename E>
+  __global__ void evaluateKernel(DeviceView<T> out, E e)
+  {
+    forEachIndex(out.size(), [&](std::size_t i)
+    {
+      out[i] = e[i];
+    });
+  }
+#endif /* __CUDACC__ */
+} // namespace detail
+
+  /**
+   * @brief Is the pair of operand types valid for a binary expression operator or function? At least one operand
+   *        must be an expression, the other may be an expression, a gpu array or a scalar.
+   * @tparam L Left operand type
+   * @tparam R Right operand type
+   */
+  template<typename L, typename R>
+  concept ExpressionOperands = (Expression<L> || Expression<R>) &&
+                               !(detail::ExpressionScalar<L> && detail::ExpressionScalar<R>);
+
+  /**
+   * @brief Elementwise addition.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator+(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::AddOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise subtraction.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator-(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::SubtractOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise multiplication.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator*(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::MultiplyOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise division.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto operator/(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::DivideOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise minimum, NaN is ignored.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto min(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::MinOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise maximum, NaN is ignored.
+   * @return The deferred expression
+   */
+  template<typename L, typename R> requires ExpressionOperands<L, R>
+  [[nodiscard]] auto max(const L& l, const R& r)
+  {
+    return detail::makeBinary(detail::MaxOp{}, l, r);
+  }
+
+  /**
+   * @brief Elementwise negation.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto operator-(const E& e) noexcept
+  {
+    return UnaryExpr<detail::NegateOp, E>{detail::NegateOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise absolute value.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto abs(const E& e) noexcept
+  {
+    return UnaryExpr<detail::AbsOp, E>{detail::AbsOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise square root.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto sqrt(const E& e) noexcept
+  {
+    return UnaryExpr<detail::SqrtOp, E>{detail::SqrtOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise exponential.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto exp(const E& e) noexcept
+  {
+    return UnaryExpr<detail::ExpOp, E>{detail::ExpOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise natural logarithm.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto log(const E& e) noexcept
+  {
+    return UnaryExpr<detail::LogOp, E>{detail::LogOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise sine.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto sin(const E& e) noexcept
+  {
+    return UnaryExpr<detail::SinOp, E>{detail::SinOp{}, e};
+  }
+
+  /**
+   * @brief Elementwise cosine.
+   * @return The deferred expression
+   */
+  template<Expression E>
+  [[nodiscard]] auto cos(const E& e) noexcept
+  {
+    return UnaryExpr<detail::CosOp, E>{detail::CosOp{}, e};
+  }
+
+#ifdef __CUDACC__
+  /**
+   * @brief Evaluates an expression into existing device memory with a single fused kernel, each element is read from
+   *        the operands and written once, no temporaries are created. The launch is asynchronous on the stream.
+   * @tparam T Element type
+   * @tparam E Expression type
+   * @param out Output, may alias one of the operands
+   * @param e The expression
+   * @param stream The stream
+   */
+  template<typename T, Expression E>
+  void assign(const DeviceView<T>& out, const E& e, cudaStream_t stream = nullptr)
+  {
+    static_assert(std::is_same_v<std::remove_cv_t<T>, typename E::value_type>, "output element type must match");
+    static_assert(!std::is_const_v<T>, "output must be writable");
+
+    if constexpr (!E::isScalar)
+    {
+      if (out.size() != e.size)
+      {
+        throw Exception{"matlabw:mx:gpu:assign", "output size does not match the expression"};
+      }
+    }
+
+    launch(&detail::evaluateKernel<T, E>, out.size(), stream, out, e);
+  }
+
+  /**
+   * @brief Evaluates an expression into an existing gpu array, see assign() of a DeviceView.
+   * @tparam T Element type
+   * @tparam E Expression type
+   * @param out Output, may be one of the operands
+   * @param e The expression
+   * @param stream The stream
+   */
+  template<typename T, Expression E>
+  void assign(const TypedArrayRef<T>& out, const E& e, cudaStream_t stream = nullptr)
+  {
+    assign(makeDeviceView(out), e, stream);
+  }
+
+  /**
+   * @brief Evaluates an expression into a new uninitialized gpu array with a single fused kernel.
+   * @tparam E Expression type
+   * @param e The expression
+   * @param stream The stream
+   * @return The gpu array, of the dimensions of the first operand with dimensions
+   */
+  template<Expression E>
+  [[nodiscard]] NumericArray<typename E::value_type> evaluate(const E& e, cudaStream_t stream = nullptr)
+  {
+    static_assert(!E::isScalar, "expression must refer to at least one gpu array");
+
+    using T = typename E::value_type;
+
+    NumericArray<T> out = makeUninitNumericArray<T>(e.dims);
+
+    assign(makeDeviceView(out), e, stream);
+
+    return out;
+  }
+#endif /* __CUDACC__ */
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_EXPRESSION_HPP */
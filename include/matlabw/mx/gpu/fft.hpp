@@ -0,0 +1,195 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_FFT_HPP
+#define MATLABW_MX_GPU_FFT_HPP
+
+#include "../detail/include.hpp"
+
+#include "blas.hpp"
+#include "HandleCache.hpp"
+#include "NumericArray.hpp"
+#include "TypedArrayRef.hpp"
+
+namespace matlabw::mx::gpu
+{
+namespace detail
+{
+  /**
+   * @brief Gets the length and the batch of transforms along the first dimension.
+   * @param id The error identifier.
+   * @param dims The array dimensions.
+   * @return The transform length and the number of transforms.
+   */
+  [[nodiscard]] inline std::pair<std::size_t, std::size_t> getFftShape(const char* id, View<std::size_t> dims)
+  {
+    const std::size_t n    = dims.empty() ? 0 : dims[0];
+    const std::size_t size = std::accumulate(dims.begin(), dims.end(), std::size_t{1}, std::multiplies<>{});
+
+    if (n == 0)
+    {
+      throw Exception{id, "array must not be empty"};
+    }
+
+    return {n, size / n};
+  }
+
+  /**
+   * @brief Runs a complex-to-complex transform of the columns.
+   * @tparam T The real type, float or double.
+   * @param cache The handle cache.
+   * @param input The input.
+   * @param stream The stream.
+   * @param direction CUFFT_FORWARD or CUFFT_INVERSE.
+   * @return The unscaled result and the transform length.
+   */
+  template<typename T>
+  [[nodiscard]] std::pair<NumericArray<std::complex<T>>, std::size_t>
+  execComplexFft(HandleCache& cache, const TypedArrayCref<std::complex<T>>& input, cudaStream_t stream, int direction)
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "T must be float or double");
+
+    static constexpr char id[]{"matlabw:mx:gpu:fft"};
+
+    const auto [n, batch] = getFftShape(id, input.getDims());
+
+    constexpr cufftType type = std::is_same_v<T, float> ? CUFFT_C2C : CUFFT_Z2Z;
+
+    const std::size_t length[]{n};
+
+    const cufftHandle plan = cache.getFftPlan(length, type, batch, stream);
+
+    auto output = gpu::makeUninitNumericArray<std::complex<T>>(input.getDims());
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+      checkCufft(cufftExecC2C(plan, toBlas(input.getData()), toBlas(output.getData()), direction), id);
+    }
+    else
+    {
+      checkCufft(cufftExecZ2Z(plan, toBlas(input.getData()), toBlas(output.getData()), direction), id);
+    }
+
+    return {std::move(output), n};
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes the discrete Fourier transform of each column with cuFFT on a stream, like fft(x) in MATLAB. The
+   *        plan is taken from the cache.
+   * @tparam T The real type, float or double.
+   * @param cache The handle cache.
+   * @param input The complex input.
+   * @param stream The stream.
+   * @return The transform, of the size of the input.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<std::complex<T>> fft(HandleCache&                           cache,
+                                                  const TypedArrayCref<std::complex<T>>& input,
+                                                  cudaStream_t                           stream)
+  {
+    return detail::execComplexFft<T>(cache, input, stream, CUFFT_FORWARD).first;
+  }
+
+  /**
+   * @brief Computes the inverse discrete Fourier transform of each column with cuFFT on a stream, scaled by 1/n like
+   *        ifft(x) in MATLAB.
+   * @tparam T The real type, float or double.
+   * @param cache The handle cache.
+   * @param input The complex input.
+   * @param stream The stream.
+   * @return The inverse transform, of the size of the input.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<std::complex<T>> ifft(HandleCache&                           cache,
+                                                   const TypedArrayCref<std::complex<T>>& input,
+                                                   cudaStream_t                           stream)
+  {
+    static constexpr char id[]{"matlabw:mx:gpu:ifft"};
+
+    auto [output, n] = detail::execComplexFft<T>(cache, input, stream, CUFFT_INVERSE);
+
+    const T   scale = T{1} / static_cast<T>(n);
+    const int size  = detail::toLibraryInt(output.getSize(), id);
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+      detail::checkCublas(cublasCsscal(cache.getBlasHandle(stream), size, &scale, detail::toBlas(output.getData()), 1),
+                          id);
+    }
+    else
+    {
+      detail::checkCublas(cublasZdscal(cache.getBlasHandle(stream), size, &scale, detail::toBlas(output.getData()), 1),
+                          id);
+    }
+
+    return std::move(output);
+  }
+
+  /**
+   * @brief Computes the discrete Fourier transform of each real column with cuFFT on a stream. Only the
+   *        non-redundant half of the spectrum is computed, the rest follows from conjugate symmetry.
+   * @tparam T The real type, float or double.
+   * @param cache The handle cache.
+   * @param input The real input with n rows.
+   * @param stream The stream.
+   * @return The transform, with n/2+1 rows and the other dimensions of the input.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<std::complex<T>> rfft(HandleCache&             cache,
+                                                   const TypedArrayCref<T>& input,
+                                                   cudaStream_t             stream)
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "T must be float or double");
+
+    static constexpr char id[]{"matlabw:mx:gpu:rfft"};
+
+    const auto [n, batch] = detail::getFftShape(id, input.getDims());
+
+    constexpr cufftType type = std::is_same_v<T, float> ? CUFFT_R2C : CUFFT_D2Z;
+
+    const std::size_t length[]{n};
+
+    const cufftHandle plan = cache.getFftPlan(length, type, batch, stream);
+
+    std::vector<std::size_t> dims(input.getDims().begin(), input.getDims().end());
+
+    dims[0] = n / 2 + 1;
+
+    auto output = gpu::makeUninitNumericArray<std::complex<T>>(dims);
+
+    if constexpr (std::is_same_v<T, float>)
+    {
+      detail::checkCufft(cufftExecR2C(plan, const_cast<T*>(input.getData()), detail::toBlas(output.getData())), id);
+    }
+    else
+    {
+      detail::checkCufft(cufftExecD2Z(plan, const_cast<T*>(input.getData()), detail::toBlas(output.getData())), id);
+    }
+
+    return output;
+  }
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_FFT_HPP */
@@ -0,0 +1,143 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_HALF_HPP
+#define MATLABW_MX_GPU_HALF_HPP
+
+#include "../detail/include.hpp"
+
+#include <cstdint>
+
+#ifdef __CUDACC__
+# include <cuda_bf16.h>
+# include <cuda_fp16.h>
+#endif
+
+#include "DeviceView.hpp"
+#include "launch.hpp"
+#include "NumericArray.hpp"
+#include "TypedArrayRef.hpp"
+#include "../half.hpp"
+
+namespace matlabw::mx::gpu
+{
+#ifdef __CUDACC__
+namespace detail
+{
+  /**
+   * @brief Device conversion of the half precision bits to single.
+   * @tparam H Half precision type
+   */
+  template<typename H>
+  struct HalfToSingleFn
+  {
+    DeviceView<float>               out; ///< Output
+    DeviceView<const std::uint16_t> in;  ///< Input bits
+
+    /// @brief Converts the element at index i.
+    __device__ void operator()(std::size_t i) const
+    {
+      if constexpr (std::is_same_v<H, float16>)
+      {
+        out[i] = __half2float(__ushort_as_half(in[i]));
+      }
+      else
+      {
+        out[i] = __bfloat162float(__ushort_as_bfloat16(in[i]));
+      }
+    }
+  };
+
+  /**
+   * @brief Device conversion of single to the half precision bits, rounding to nearest even.
+   * @tparam H Half precision type
+   */
+  template<typename H>
+  struct SingleToHalfFn
+  {
+    DeviceView<std::uint16_t> out; ///< Output bits
+    DeviceView<const float>   in;  ///< Input
+
+    /// @brief Converts the element at index i.
+    __device__ void operator()(std::size_t i) const
+    {
+      if constexpr (std::is_same_v<H, float16>)
+      {
+        out[i] = __half_as_ushort(__float2half_rn(in[i]));
+      }
+      else
+      {
+        out[i] = __bfloat16_as_ushort(__float2bfloat16_rn(in[i]));
+      }
+    }
+  };
+} // namespace detail
+
+  /**
+   * @brief Converts a half precision gpu array to a new single gpu array of the same dimensions with the CUDA
+   *        intrinsics. The launch is asynchronous on the stream.
+   * @tparam H Half precision type, float16 or bfloat16
+   * @param in Input, a uint16 gpu array holding the bits
+   * @param stream The stream
+   * @return The single gpu array
+   */
+  template<typename H>
+  [[nodiscard]] NumericArray<float> toSingle(const TypedArrayCref<H>& in, cudaStream_t stream = nullptr)
+  {
+    static_assert(isHalf<H>, "H must be float16 or bfloat16");
+
+    NumericArray<float> out = makeUninitNumericArray<float>(in.getDims());
+
+    const DeviceView<const std::uint16_t> bits{reinterpret_cast<const std::uint16_t*>(in.getData()), in.getDims()};
+
+    launchForEach(bits.size(), detail::HalfToSingleFn<H>{makeDeviceView(out), bits}, stream);
+
+    return out;
+  }
+
+  /**
+   * @brief Converts a single gpu array to a new half precision gpu array of the same dimensions with the CUDA
+   *        intrinsics, rounding to nearest even. The launch is asynchronous on the stream.
+   * @tparam H Half precision type, float16 or bfloat16
+   * @param in Input
+   * @param stream The stream
+   * @return The half precision gpu array, a uint16 gpu array holding the bits
+   */
+  template<typename H>
+  [[nodiscard]] NumericArray<H> toHalf(const TypedArrayCref<float>& in, cudaStream_t stream = nullptr)
+  {
+    static_assert(isHalf<H>, "H must be float16 or bfloat16");
+
+    NumericArray<H> out = makeUninitNumericArray<H>(in.getDims());
+
+    const DeviceView<std::uint16_t> bits{reinterpret_cast<std::uint16_t*>(out.getData()), out.getDims()};
+
+    launchForEach(bits.size(), detail::SingleToHalfFn<H>{bits, makeDeviceView(in)}, stream);
+
+    return out;
+  }
+#endif /* __CUDACC__ */
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_HALF_HPP */
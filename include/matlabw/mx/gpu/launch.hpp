@@ -0,0 +1,170 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_LAUNCH_HPP
+#define MATLABW_MX_GPU_LAUNCH_HPP
+
+#include "../detail/include.hpp"
+
+#include <cuda_runtime.h>
+
+#include "detail/cuda.hpp"
+#include "DeviceView.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /// @brief Launch configuration of a kernel with a 1-D grid.
+  struct LaunchConfig
+  {
+    unsigned    gridSize{};    ///< Number of blocks.
+    unsigned    blockSize{};   ///< Number of threads per block.
+    std::size_t sharedBytes{}; ///< Dynamic shared memory per block in bytes.
+  };
+
+  /**
+   * @brief Gets the launch configuration of a kernel which processes elements in a grid-stride loop. The block size
+   *        maximizes occupancy and the grid is limited to the blocks which can be resident on the device at once, the
+   *        loop covers the rest, so any number of elements can be processed.
+   * @tparam Kernel The kernel type.
+   * @param kernel The __global__ function.
+   * @param n The number of elements.
+   * @param sharedBytes Dynamic shared memory per block in bytes.
+   * @return The launch configuration.
+   */
+  template<typename Kernel>
+  [[nodiscard]] LaunchConfig getLaunchConfig(Kernel kernel, std::size_t n, std::size_t sharedBytes = 0)
+  {
+    static constexpr char id[]{"matlabw:mx:gpu:getLaunchConfig"};
+
+    int minGridSize{};
+    int blockSize{};
+    int device{};
+    int smCount{};
+
+    detail::checkCuda(cudaOccupancyMaxPotentialBlockSize(&minGridSize, &blockSize, kernel, sharedBytes), id);
+    detail::checkCuda(cudaGetDevice(&device), id);
+    detail::checkCuda(cudaDeviceGetAttribute(&smCount, cudaDevAttrMultiProcessorCount, device), id);
+
+    // minGridSize is the number of blocks filling all multiprocessors at the chosen block size.
+    const std::size_t residentBlocks = std::max<std::size_t>(static_cast<std::size_t>(minGridSize),
+                                                             static_cast<std::size_t>(smCount));
+    const std::size_t neededBlocks   = (n + static_cast<std::size_t>(blockSize) - 1)
+                                       / static_cast<std::size_t>(blockSize);
+
+    return LaunchConfig{static_cast<unsigned>(std::clamp<std::size_t>(neededBlocks, 1, residentBlocks)),
+                        static_cast<unsigned>(blockSize),
+                        sharedBytes};
+  }
+
+  /**
+   * @brief Launches a kernel with a launch configuration.
+   * @tparam Args The kernel parameter types.
+   * @param kernel The __global__ function.
+   * @param config The launch configuration.
+   * @param stream The stream.
+   * @param args The kernel arguments.
+   */
+  template<typename... Args>
+  void launch(void (*kernel)(Args...), const LaunchConfig& config, cudaStream_t stream,
+              std::type_identity_t<Args>... args)
+  {
+    void* argPtrs[sizeof...(Args) + 1]{&args...};
+
+    detail::checkCuda(cudaLaunchKernel(reinterpret_cast<const void*>(kernel),
+                                       dim3{config.gridSize},
+                                       dim3{config.blockSize},
+                                       argPtrs,
+                                       config.sharedBytes,
+                                       stream),
+                      "matlabw:mx:gpu:launch");
+  }
+
+  /**
+   * @brief Launches a kernel processing n elements in a grid-stride loop with the occupancy based configuration.
+   * @tparam Args The kernel parameter types.
+   * @param kernel The __global__ function.
+   * @param n The number of elements.
+   * @param stream The stream.
+   * @param args The kernel arguments.
+   */
+  template<typename... Args>
+  void launch(void (*kernel)(Args...), std::size_t n, cudaStream_t stream, std::type_identity_t<Args>... args)
+  {
+    if (n != 0)
+    {
+      launch(kernel, getLaunchConfig(kernel, n), stream, args...);
+    }
+  }
+
+#ifdef __CUDACC__
+  /**
+   * @brief Calls a function for each index of a grid-stride loop over n elements. Must be called by all threads of a
+   *        1-D grid, each thread visits the indices it owns.
+   * @tparam Fn The function type.
+   * @param n The number of elements.
+   * @param fn The function called with the std::size_t index.
+   */
+  template<typename Fn>
+  __device__ void forEachIndex(std::size_t n, Fn&& fn)
+  {
+    const std::size_t stride = static_cast<std::size_t>(blockDim.x) * gridDim.x;
+
+    for (std::size_t i = static_cast<std::size_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride)
+    {
+      fn(i);
+    }
+  }
+
+namespace detail
+{
+  /**
+   * @brief Kernel calling a function for each index, see launchForEach().
+   * @tparam Fn The function type.
+   * @param n The number of elements.
+   * @param fn The function.
+   */
+  template<typename Fn>
+  __global__ void forEachKernel(std::size_t n, Fn fn)
+  {
+    forEachIndex(n, fn);
+  }
+} // namespace detail
+
+  /**
+   * @brief Launches a grid-stride loop calling a device function object for each of n indices, e.g. a
+   *        __device__ lambda (requires nvcc --extended-lambda) capturing DeviceView objects by value.
+   * @tparam Fn The function type.
+   * @param n The number of elements.
+   * @param fn The function called with the std::size_t index.
+   * @param stream The stream.
+   */
+  template<typename Fn>
+  void launchForEach(std::size_t n, Fn fn, cudaStream_t stream = nullptr)
+  {
+    launch(&detail::forEachKernel<Fn>, n, stream, n, fn);
+  }
+#endif /* __CUDACC__ */
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_LAUNCH_HPP */
@@ -0,0 +1,250 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_MEMORY_HPP
+#define MATLABW_MX_GPU_MEMORY_HPP
+
+#include "../detail/include.hpp"
+
+#include <cuda_runtime_api.h>
+
+#include "detail/cuda.hpp"
+#include "DevicePool.hpp"
+#include "../Exception.hpp"
+
+namespace matlabw::mx::gpu
+{
+  /// @brief Memory usage of the current device.
+  struct DeviceMemoryInfo
+  {
+    std::size_t freeBytes{};       ///< Bytes free on the device, memory held by MATLAB's gpuArrays is not free.
+    std::size_t totalBytes{};      ///< Bytes of the device.
+    std::size_t poolBytesInUse{};  ///< Bytes handed out by the device pool.
+    std::size_t poolBytesCached{}; ///< Bytes cached by the device pool, reusable by it without cudaMalloc.
+
+    /**
+     * @brief Gets the bytes the device pool can hand out without failing, the free bytes and its cached bytes.
+     * @return The available bytes.
+     */
+    [[nodiscard]] std::size_t getAvailableBytes() const noexcept
+    {
+      return freeBytes + poolBytesCached;
+    }
+  };
+
+  /**
+   * @brief Gets the memory usage of the current device.
+   * @param pool The device pool whose usage is reported, may be nullptr.
+   * @return The memory usage.
+   */
+  [[nodiscard]] inline DeviceMemoryInfo getDeviceMemoryInfo(const DevicePool* pool = nullptr)
+  {
+    DeviceMemoryInfo info{};
+
+    detail::checkCuda(cudaMemGetInfo(&info.freeBytes, &info.totalBytes), "matlabw:mx:gpu:getDeviceMemoryInfo");
+
+    if (pool != nullptr)
+    {
+      const DevicePoolStats stats = pool->getStats();
+
+      info.poolBytesInUse  = stats.bytesInUse;
+      info.poolBytesCached = stats.bytesCached;
+    }
+
+    return info;
+  }
+
+  /// @brief Peak memory usage of a scope.
+  struct MemoryUsage
+  {
+    std::size_t peakPoolBytes{};   ///< Largest number of bytes handed out by the device pool at once.
+    std::size_t peakDeviceBytes{}; ///< Largest drop of the device free bytes seen by the samples, by any allocator.
+  };
+
+  /**
+   * @brief Measures the peak memory usage of a scope, e.g. of one MEX call. The device pool peak is exact, its peak
+   *        statistics restart at construction, so scopes of the same pool must not be nested. The device peak is
+   *        sampled by cudaMemGetInfo at construction, at each sample() and at getUsage(), so it also covers MATLAB
+   *        and library allocations but may miss short spikes between samples.
+   */
+  class MemoryUsageScope
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param pool The device pool, may be nullptr to measure the device only.
+       */
+      explicit MemoryUsageScope(DevicePool* pool = nullptr)
+      : mPool{pool}
+      {
+        if (mPool != nullptr)
+        {
+          mPool->resetPeak();
+          mPoolBytesAtStart = mPool->getStats().bytesInUse;
+        }
+
+        mFreeAtStart = getDeviceMemoryInfo().freeBytes;
+        mMinFree     = mFreeAtStart;
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      MemoryUsageScope(const MemoryUsageScope&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      MemoryUsageScope(MemoryUsageScope&&) = delete;
+
+      /// @brief Destructor.
+      ~MemoryUsageScope() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      MemoryUsageScope& operator=(const MemoryUsageScope&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      MemoryUsageScope& operator=(MemoryUsageScope&&) = delete;
+
+      /// @brief Samples the free bytes of the device, e.g. between the steps of a call.
+      void sample()
+      {
+        mMinFree = std::min(mMinFree, getDeviceMemoryInfo().freeBytes);
+      }
+
+      /**
+       * @brief Gets the peak usage since construction, takes a last sample.
+       * @return The peak usage.
+       */
+      [[nodiscard]] MemoryUsage getUsage()
+      {
+        sample();
+
+        MemoryUsage usage{};
+
+        usage.peakDeviceBytes = mFreeAtStart - mMinFree;
+
+        if (mPool != nullptr)
+        {
+          usage.peakPoolBytes = mPool->getStats().peakBytesInUse - mPoolBytesAtStart;
+        }
+
+        return usage;
+      }
+    private:
+      DevicePool* mPool{};             ///< The device pool.
+      std::size_t mPoolBytesAtStart{}; ///< Bytes in use by the pool at construction.
+      std::size_t mFreeAtStart{};      ///< Free device bytes at construction.
+      std::size_t mMinFree{};          ///< Smallest sampled free device bytes.
+  };
+
+  /// @brief Options of planChunks().
+  struct ChunkOptions
+  {
+    double      reserveFraction{0.05};                             ///< Part of the device memory left to others.
+    std::size_t reserveBytes{};                                    ///< Bytes left to others on top of the fraction.
+    std::size_t granularity{1};                                    ///< Chunk sizes are multiples of it.
+    std::size_t maxChunkSize{std::numeric_limits<std::size_t>::max()}; ///< Largest chunk size.
+  };
+
+  /// @brief Chunking of a job admitted by planChunks().
+  struct ChunkPlan
+  {
+    std::size_t chunkSize{};  ///< Number of items per chunk, the last chunk may be smaller.
+    std::size_t chunkCount{}; ///< Number of chunks.
+  };
+
+  /**
+   * @brief Sizes the chunks of a job from the memory available on the current device, so that a job larger than the
+   *        memory left by MATLAB's gpuArrays runs as several smaller batches instead of failing with out of memory.
+   * @param itemCount Number of items of the job, e.g. columns.
+   * @param bytesPerItem Device bytes needed per item, including outputs and temporaries.
+   * @param options The options.
+   * @param pool The device pool the job allocates from, its cached bytes count as available. May be nullptr.
+   * @return The plan, of no chunks for an empty job.
+   */
+  [[nodiscard]] inline ChunkPlan planChunks(std::size_t         itemCount,
+                                            std::size_t         bytesPerItem,
+                                            const ChunkOptions& options = {},
+                                            const DevicePool*   pool    = nullptr)
+  {
+    static constexpr char id[]{"matlabw:mx:gpu:planChunks"};
+
+    if (itemCount == 0)
+    {
+      return ChunkPlan{};
+    }
+
+    const std::size_t      granularity = std::max<std::size_t>(options.granularity, 1);
+    const DeviceMemoryInfo info        = getDeviceMemoryInfo(pool);
+
+    const std::size_t reserve   = static_cast<std::size_t>(options.reserveFraction
+                                                           * static_cast<double>(info.totalBytes))
+                                  + options.reserveBytes;
+    const std::size_t available = (info.getAvailableBytes() > reserve) ? info.getAvailableBytes() - reserve : 0;
+
+    std::size_t chunkSize = std::min({(bytesPerItem == 0) ? itemCount : available / bytesPerItem,
+                                      itemCount,
+                                      options.maxChunkSize});
+
+    if (chunkSize < itemCount)
+    {
+      chunkSize -= chunkSize % granularity;
+    }
+
+    if (chunkSize == 0)
+    {
+      throw Exception{id, "not enough device memory for the smallest chunk, free gpuArrays or reset the device"};
+    }
+
+    return ChunkPlan{chunkSize, (itemCount + chunkSize - 1) / chunkSize};
+  }
+
+  /**
+   * @brief Processes a job in chunks admitted by the available device memory. The memory is checked again before each
+   *        chunk, so the chunks shrink when other allocations appear during the job.
+   * @tparam Fn The function type.
+   * @param itemCount Number of items of the job.
+   * @param bytesPerItem Device bytes needed per item, including outputs and temporaries.
+   * @param fn The function called with the std::size_t items [first, last) of each chunk, in order.
+   * @param options The options.
+   * @param pool The device pool the job allocates from, may be nullptr.
+   */
+  template<typename Fn>
+  void forEachChunk(std::size_t         itemCount,
+                    std::size_t         bytesPerItem,
+                    Fn&&                fn,
+                    const ChunkOptions& options = {},
+                    const DevicePool*   pool    = nullptr)
+  {
+    std::size_t first{};
+
+    while (first < itemCount)
+    {
+      const std::size_t size = planChunks(itemCount - first, bytesPerItem, options, pool).chunkSize;
+
+      fn(first, first + size);
+
+      first += size;
+    }
+  }
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_MEMORY_HPP */
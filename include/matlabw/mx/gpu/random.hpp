@@ -0,0 +1,140 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_GPU_RANDOM_HPP
+#define MATLABW_MX_GPU_RANDOM_HPP
+
+#include "../detail/include.hpp"
+
+#include "DeviceView.hpp"
+#include "launch.hpp"
+#include "TypedArrayRef.hpp"
+#include "../random.hpp"
+
+namespace matlabw::mx::gpu::algorithm
+{
+#ifdef __CUDACC__
+namespace detail
+{
+  /**
+   * @brief Kernel filling device memory with values of a distribution, each thread computes whole blocks.
+   * @tparam T Value type
+   * @tparam Dist Distribution type
+   * @param out The output
+   * @param range The reserved blocks
+   * @param dist The distribution
+   * @param blocks Number of blocks, the last one may be partial
+   */
+  template<typename T, typename Dist>
+  __global__ void generateKernel(DeviceView<T> out, mx::detail::PhiloxRange range, Dist dist, std::size_t blocks)
+  {
+    forEachIndex(blocks, [&](std::size_t b)
+    {
+      T values[Dist::count];
+
+      dist(range(b), values);
+
+      const std::size_t first = b * Dist::count;
+
+      for (std::size_t k{}; k < Dist::count && first + k < out.size(); ++k)
+      {
+        out[first + k] = values[k];
+      }
+    });
+  }
+
+  /**
+   * @brief Fills device memory with values of a distribution. Value i is computed from the same block as on the CPU,
+   *        so a generator in the same state gives the same values as mx::algorithm on the host, up to the rounding of
+   *        the device math functions. The launch is asynchronous on the stream.
+   * @tparam T Value type
+   * @tparam Dist Distribution type
+   * @param out The output
+   * @param rng The generator, continues after the reserved blocks
+   * @param dist The distribution
+   * @param stream The stream
+   */
+  template<typename T, typename Dist>
+  void generateBlocks(const DeviceView<T>& out, Philox& rng, const Dist& dist, cudaStream_t stream)
+  {
+    const std::size_t blocks = (out.size() + Dist::count - 1) / Dist::count;
+    const auto        range  = rng.reserve(blocks);
+
+    launch(&generateKernel<T, Dist>, blocks, stream, out, range, dist, blocks);
+  }
+} // namespace detail
+
+  /**
+   * @brief Fills a gpu array with uniform values in the open interval (0, 1), as MATLAB rand.
+   * @tparam T Value type, float or double
+   * @param out The output
+   * @param rng The generator
+   * @param stream The stream
+   */
+  template<typename T>
+  void fillUniform(const TypedArrayRef<T>& out, Philox& rng, cudaStream_t stream = nullptr)
+  {
+    detail::generateBlocks(makeDeviceView(out), rng, mx::detail::UniformDistribution<T>{}, stream);
+  }
+
+  /**
+   * @brief Fills a gpu array with normal values, as MATLAB randn for the default mean and standard deviation.
+   * @tparam T Value type, float or double
+   * @param out The output
+   * @param rng The generator
+   * @param mean The mean
+   * @param sigma The standard deviation
+   * @param stream The stream
+   */
+  template<typename T>
+  void fillNormal(const TypedArrayRef<T>& out,
+                  Philox&                 rng,
+                  std::type_identity_t<T> mean   = 0,
+                  std::type_identity_t<T> sigma  = 1,
+                  cudaStream_t            stream = nullptr)
+  {
+    detail::generateBlocks(makeDeviceView(out), rng, mx::detail::NormalDistribution<T>{mean, sigma}, stream);
+  }
+
+  /**
+   * @brief Fills a gpu array with uniform integers from lo to hi, as MATLAB randi([lo, hi], ...).
+   * @tparam T Value type, integer or floating point
+   * @param out The output
+   * @param rng The generator
+   * @param lo The smallest value
+   * @param hi The largest value, at most 2^32 values in total
+   * @param stream The stream
+   */
+  template<typename T>
+  void fillIntegers(const TypedArrayRef<T>& out,
+                    Philox&                 rng,
+                    std::int64_t            lo,
+                    std::int64_t            hi,
+                    cudaStream_t            stream = nullptr)
+  {
+    detail::generateBlocks(makeDeviceView(out), rng, mx::detail::makeIntegerDistribution<T>(lo, hi), stream);
+  }
+#endif /* __CUDACC__ */
+} // namespace matlabw::mx::gpu::algorithm
+
+#endif /* MATLABW_MX_GPU_RANDOM_HPP */
@@ -0,0 +1,596 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_GPU_TRANSFER_HPP
+#define MATLABW_MX_GPU_TRANSFER_HPP
+
+#include "../detail/include.hpp"
+
+#include <cstring>
+
+#include "Array.hpp"
+#include "../ArrayRef.hpp"
+#include "../common.hpp"
+#include "detail/cuda.hpp"
+#include "../Exception.hpp"
+#include "NumericArray.hpp"
+#include "PinnedPool.hpp"
+
+namespace matlabw::mx::gpu
+{
+namespace detail
+{
+  /**
+   * @brief Gets the size of the data of a host array in bytes, the array must be a dense numeric array.
+   * @param id The error identifier.
+   * @param host The host array.
+   * @return The size in bytes.
+   */
+  [[nodiscard]] inline std::size_t getHostDataBytes(const char* id, mx::ArrayCref host)
+  {
+    if (!host.isNumeric() || host.isSparse())
+    {
+      throw Exception{id, "host array must be a dense numeric array"};
+    }
+
+    return host.getSize() * host.getSizeOfElement();
+  }
+
+  /**
+   * @brief Gets the size of a real element of a numeric class.
+   * @param classId The class ID.
+   * @return The size in bytes.
+   */
+  [[nodiscard]] constexpr std::size_t getNumericElementSize(ClassId classId) noexcept
+  {
+    switch (classId)
+    {
+    case ClassId::int8:
+    case ClassId::uint8:
+      return 1;
+    case ClassId::int16:
+    case ClassId::uint16:
+      return 2;
+    case ClassId::single:
+    case ClassId::int32:
+    case ClassId::uint32:
+      return 4;
+    default:
+      return 8;
+    }
+  }
+
+  /**
+   * @brief Checks that a host array and a device array have the same class, complexity and size.
+   * @param id The error identifier.
+   * @param host The host array.
+   * @param classId The class ID of the device array.
+   * @param complex Is the device array complex?
+   * @param size The number of elements of the device array.
+   */
+  inline void checkTransferShape(const char* id, mx::ArrayCref host, ClassId classId, bool complex, std::size_t size)
+  {
+    if (host.getClassId() != classId || host.isComplex() != complex || host.getSize() != size)
+    {
+      throw Exception{id, "host and device arrays must have the same class, complexity and size"};
+    }
+  }
+} // namespace detail
+
+  /// @brief CUDA event, marks the completion of asynchronous work on a stream.
+  class Event
+  {
+    public:
+      /// @brief Constructor, creates an event without timing.
+      Event()
+      {
+        detail::checkCuda(cudaEventCreateWithFlags(&mEvent, cudaEventDisableTiming), "matlabw:mx:gpu:Event:Event");
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      Event(const Event&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other event, left empty.
+       */
+      Event(Event&& other) noexcept
+      : mEvent{std::exchange(other.mEvent, nullptr)}
+      {}
+
+      /// @brief Destructor.
+      ~Event()
+      {
+        if (mEvent != nullptr)
+        {
+          cudaEventDestroy(mEvent);
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Event& operator=(const Event&) = delete;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other event, left empty.
+       * @return Reference to this event.
+       */
+      Event& operator=(Event&& other) noexcept
+      {
+        if (this != &other)
+        {
+          if (mEvent != nullptr)
+          {
+            cudaEventDestroy(mEvent);
+          }
+
+          mEvent = std::exchange(other.mEvent, nullptr);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Records the event at the current end of a stream.
+       * @param stream The stream.
+       */
+      void record(cudaStream_t stream)
+      {
+        detail::checkCuda(cudaEventRecord(mEvent, stream), "matlabw:mx:gpu:Event:record");
+      }
+
+      /**
+       * @brief Checks if the work before the event has completed, does not block.
+       * @return True if the work has completed, false otherwise.
+       */
+      [[nodiscard]] bool isComplete() const
+      {
+        const cudaError_t err = cudaEventQuery(mEvent);
+
+        if (err == cudaErrorNotReady)
+        {
+          return false;
+        }
+
+        detail::checkCuda(err, "matlabw:mx:gpu:Event:isComplete");
+
+        return true;
+      }
+
+      /// @brief Blocks until the work before the event has completed.
+      void synchronize() const
+      {
+        detail::checkCuda(cudaEventSynchronize(mEvent), "matlabw:mx:gpu:Event:synchronize");
+      }
+
+      /**
+       * @brief Makes a stream wait for the event without blocking the host, e.g. a compute stream for an upload.
+       * @param stream The stream.
+       */
+      void enqueueWait(cudaStream_t stream) const
+      {
+        detail::checkCuda(cudaStreamWaitEvent(stream, mEvent, 0), "matlabw:mx:gpu:Event:enqueueWait");
+      }
+
+      /**
+       * @brief Gets the event handle.
+       * @return The event handle.
+       */
+      [[nodiscard]] cudaEvent_t get() const noexcept
+      {
+        return mEvent;
+      }
+    private:
+      cudaEvent_t mEvent{}; ///< The event handle.
+  };
+
+  /**
+   * @brief Page-locked host buffer, the staging memory of asynchronous transfers. The memory is taken from a pinned
+   *        pool if one is given, so buffers of repeated calls do not pay for cudaHostAlloc.
+   */
+  class PinnedBuffer
+  {
+    public:
+      /// @brief Default constructor.
+      PinnedBuffer() = default;
+
+      /**
+       * @brief Constructor.
+       * @param capacity The capacity in bytes.
+       * @param pool The pool, nullptr allocates directly. Must outlive the buffer.
+       */
+      explicit PinnedBuffer(std::size_t capacity, PinnedPool* pool = nullptr)
+      : mPool{pool}
+      {
+        reserve(capacity);
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      PinnedBuffer(const PinnedBuffer&) = delete;
+
+      /**
+       * @brief Move constructor.
+       * @param other The other buffer, left empty.
+       */
+      PinnedBuffer(PinnedBuffer&& other) noexcept
+      : mPool{other.mPool}, mData{std::exchange(other.mData, nullptr)}, mCapacity{std::exchange(other.mCapacity, 0)}
+      {}
+
+      /// @brief Destructor.
+      ~PinnedBuffer()
+      {
+        release();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      PinnedBuffer& operator=(const PinnedBuffer&) = delete;
+
+      /**
+       * @brief Move assignment operator.
+       * @param other The other buffer, left empty.
+       * @return Reference to this buffer.
+       */
+      PinnedBuffer& operator=(PinnedBuffer&& other) noexcept
+      {
+        if (this != &other)
+        {
+          release();
+          mPool     = other.mPool;
+          mData     = std::exchange(other.mData, nullptr);
+          mCapacity = std::exchange(other.mCapacity, 0);
+        }
+
+        return *this;
+      }
+
+      /**
+       * @brief Grows the buffer to hold at least the capacity, the contents are not preserved. Page-locked
+       *        allocations are expensive, so the buffer never shrinks.
+       * @param capacity The capacity in bytes.
+       */
+      void reserve(std::size_t capacity)
+      {
+        if (capacity <= mCapacity)
+        {
+          return;
+        }
+
+        release();
+
+        if (mPool != nullptr)
+        {
+          capacity = PinnedPool::getClassSize(capacity);
+          mData    = mPool->allocate(capacity);
+        }
+        else
+        {
+          detail::checkCuda(cudaHostAlloc(&mData, capacity, cudaHostAllocDefault),
+                            "matlabw:mx:gpu:PinnedBuffer:reserve");
+        }
+
+        mCapacity = capacity;
+      }
+
+      /**
+       * @brief Gets the data.
+       * @return Pointer to the data.
+       */
+      [[nodiscard]] void* getData() const noexcept
+      {
+        return mData;
+      }
+
+      /**
+       * @brief Gets the capacity.
+       * @return The capacity in bytes.
+       */
+      [[nodiscard]] std::size_t getCapacity() const noexcept
+      {
+        return mCapacity;
+      }
+    private:
+      /// @brief Frees the buffer.
+      void release() noexcept
+      {
+        if (mData != nullptr)
+        {
+          if (mPool != nullptr)
+          {
+            mPool->deallocate(mData);
+          }
+          else
+          {
+            cudaFreeHost(mData);
+          }
+
+          mData     = nullptr;
+          mCapacity = 0;
+        }
+      }
+
+      PinnedPool* mPool{};     ///< The pool, nullptr if the memory is allocated directly.
+      void*       mData{};     ///< The data.
+      std::size_t mCapacity{}; ///< The capacity in bytes.
+  };
+
+  /**
+   * @brief Asynchronous transfer slot: a pinned staging buffer and the event that marks the end of its last copy.
+   *        A slot reuses its staging buffer only after the previous copy has completed, so chunked pipelines use two
+   *        or more slots to overlap copies with kernels. Transfers run on user-supplied streams with cudaMemcpyAsync.
+   *        Requires linking the CUDA runtime.
+   */
+  class Transfer
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param capacity The initial capacity of the staging buffer in bytes.
+       * @param pool The pool of the staging buffer, nullptr allocates directly. Must outlive the slot.
+       */
+      explicit Transfer(std::size_t capacity = 0, PinnedPool* pool = nullptr)
+      : mStaging{capacity, pool}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      Transfer(const Transfer&) = delete;
+
+      /**
+       * @brief Move constructor, the other slot must not be used any more.
+       * @param other The other slot.
+       */
+      Transfer(Transfer&& other) noexcept
+      : mStaging{std::move(other.mStaging)},
+        mEvent{std::move(other.mEvent)},
+        mPending{std::exchange(other.mPending, false)},
+        mDownloadBytes{std::exchange(other.mDownloadBytes, 0)}
+      {}
+
+      /// @brief Destructor, waits for the last copy so the staging buffer is not freed while in use.
+      ~Transfer()
+      {
+        if (mPending)
+        {
+          cudaEventSynchronize(mEvent.get());
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      Transfer& operator=(const Transfer&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      Transfer& operator=(Transfer&&) = delete;
+
+      /**
+       * @brief Uploads host data to the device. The data are staged before the function returns, so the host memory
+       *        may be reused immediately.
+       * @param host The host data.
+       * @param device The device memory.
+       * @param bytes The size in bytes.
+       * @param stream The stream.
+       * @return The event marking the end of the copy.
+       */
+      const Event& upload(const void* host, void* device, std::size_t bytes, cudaStream_t stream)
+      {
+        stage(bytes);
+
+        std::memcpy(mStaging.getData(), host, bytes);
+
+        detail::checkCuda(cudaMemcpyAsync(device, mStaging.getData(), bytes, cudaMemcpyHostToDevice, stream),
+                          "matlabw:mx:gpu:Transfer:upload");
+
+        return finish(stream, 0);
+      }
+
+      /**
+       * @brief Uploads host data to the device.
+       * @tparam T The element type.
+       * @param host The host data.
+       * @param device The device memory, holds host.size() elements.
+       * @param stream The stream.
+       * @return The event marking the end of the copy.
+       */
+      template<typename T>
+      const Event& upload(View<T> host, T* device, cudaStream_t stream)
+      {
+        return upload(host.data(), device, host.size_bytes(), stream);
+      }
+
+      /**
+       * @brief Uploads a host array to a device array of the same class, complexity and size.
+       * @param host The host array.
+       * @param device The device array.
+       * @param stream The stream.
+       * @return The event marking the end of the copy.
+       */
+      const Event& upload(mx::ArrayCref host, ArrayRef device, cudaStream_t stream)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:Transfer:upload"};
+
+        const std::size_t bytes = detail::getHostDataBytes(id, host);
+
+        detail::checkTransferShape(id, host, device.getClassId(), device.isComplex(), device.getSize());
+
+        return upload(host.getData(), device.getData(), bytes, stream);
+      }
+
+      /**
+       * @brief Uploads a host array to a new device array. The device array may be used on the stream right away,
+       *        other streams must wait for getEvent().
+       * @param host The host array.
+       * @param stream The stream.
+       * @return The device array.
+       */
+      [[nodiscard]] Array upload(mx::ArrayCref host, cudaStream_t stream)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:Transfer:upload"};
+
+        const std::size_t bytes = detail::getHostDataBytes(id, host);
+
+        auto device = gpu::makeUninitNumericArray(host.getDims(),
+                                                  host.getClassId(),
+                                                  (host.isComplex()) ? Complexity::complex : Complexity::real);
+
+        upload(host.getData(), device.getData(), bytes, stream);
+
+        return device;
+      }
+
+      /**
+       * @brief Downloads device data into the staging buffer. Retrieve them with copyTo().
+       * @param device The device data.
+       * @param bytes The size in bytes.
+       * @param stream The stream.
+       * @return The event marking the end of the copy.
+       */
+      const Event& download(const void* device, std::size_t bytes, cudaStream_t stream)
+      {
+        stage(bytes);
+
+        detail::checkCuda(cudaMemcpyAsync(mStaging.getData(), device, bytes, cudaMemcpyDeviceToHost, stream),
+                          "matlabw:mx:gpu:Transfer:download");
+
+        return finish(stream, bytes);
+      }
+
+      /**
+       * @brief Downloads a device array into the staging buffer. Retrieve it with copyTo().
+       * @param device The device array.
+       * @param stream The stream.
+       * @return The event marking the end of the copy.
+       */
+      const Event& download(ArrayCref device, cudaStream_t stream)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:Transfer:download"};
+
+        if (!device.isNumeric() || device.isSparse())
+        {
+          throw Exception{id, "device array must be a dense numeric array"};
+        }
+
+        const std::size_t elementSize = detail::getNumericElementSize(device.getClassId())
+                                        * ((device.isComplex()) ? 2 : 1);
+
+        return download(device.getData(), device.getSize() * elementSize, stream);
+      }
+
+      /**
+       * @brief Waits for the last download and copies it to host memory.
+       * @param host The host memory.
+       * @param bytes The size in bytes, must equal the size of the last download.
+       */
+      void copyTo(void* host, std::size_t bytes)
+      {
+        static constexpr char id[]{"matlabw:mx:gpu:Transfer:copyTo"};
+
+        if (bytes != mDownloadBytes)
+        {
+          throw Exception{id, "size must match the last download"};
+        }
+
+        wait();
+
+        std::memcpy(host, mStaging.getData(), bytes);
+      }
+
+      /**
+       * @brief Waits for the last download and copies it to host memory.
+       * @tparam T The element type.
+       * @param host The host memory.
+       */
+      template<typename T>
+      void copyTo(Span<T> host)
+      {
+        copyTo(host.data(), host.size_bytes());
+      }
+
+      /**
+       * @brief Waits for the last download and copies it to a host array.
+       * @param host The host array, must match the downloaded device array.
+       */
+      void copyTo(mx::ArrayRef host)
+      {
+        copyTo(host.getData(), detail::getHostDataBytes("matlabw:mx:gpu:Transfer:copyTo", host));
+      }
+
+      /**
+       * @brief Checks if the last copy has completed, does not block.
+       * @return True if the last copy has completed or there was none, false otherwise.
+       */
+      [[nodiscard]] bool isComplete() const
+      {
+        return !mPending || mEvent.isComplete();
+      }
+
+      /// @brief Blocks until the last copy has completed.
+      void wait()
+      {
+        if (mPending)
+        {
+          mEvent.synchronize();
+          mPending = false;
+        }
+      }
+
+      /**
+       * @brief Gets the event marking the end of the last copy.
+       * @return The event.
+       */
+      [[nodiscard]] const Event& getEvent() const noexcept
+      {
+        return mEvent;
+      }
+    private:
+      /**
+       * @brief Waits until the staging buffer is free and grows it.
+       * @param bytes The size in bytes.
+       */
+      void stage(std::size_t bytes)
+      {
+        wait();
+        mStaging.reserve(bytes);
+      }
+
+      /**
+       * @brief Records the end of a copy.
+       * @param stream The stream.
+       * @param downloadBytes The size of the download, 0 for uploads.
+       * @return The event.
+       */
+      const Event& finish(cudaStream_t stream, std::size_t downloadBytes)
+      {
+        mEvent.record(stream);
+        mPending       = true;
+        mDownloadBytes = downloadBytes;
+
+        return mEvent;
+      }
+
+      PinnedBuffer mStaging{};       ///< The staging buffer.
+      Event        mEvent{};         ///< The event of the last copy.
+      bool         mPending{};       ///< Is the last copy possibly in flight?
+      std::size_t  mDownloadBytes{}; ///< The size of the last download.
+  };
+} // namespace matlabw::mx::gpu
+
+#endif /* MATLABW_MX_GPU_TRANSFER_HPP */
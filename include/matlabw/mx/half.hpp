@@ -0,0 +1,260 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_HALF_HPP
+#define MATLABW_MX_HALF_HPP
+
+#include "detail/include.hpp"
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /**
+   * @brief Converts a single to IEEE 754 binary16 bits, rounding to nearest even. Overflow gives infinity and NaN
+   *        gives a quiet NaN.
+   * @param value The single.
+   * @return The binary16 bits.
+   */
+  [[nodiscard]] constexpr std::uint16_t singleToHalfBits(float value) noexcept
+  {
+    constexpr std::uint32_t infinity{0x7f800000u};
+    constexpr std::uint32_t halfMax{(127u + 16u) << 23};          // 2^16, the first value rounding to infinity
+    constexpr std::uint32_t minNormal{113u << 23};                // 2^-14, the smallest normal binary16
+    constexpr std::uint32_t subnormalMagic{((127u - 15u) + (23u - 10u) + 1u) << 23};
+
+    std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+
+    bits &= 0x7fffffffu;
+
+    if (bits >= halfMax)
+    {
+      return sign | ((bits > infinity) ? std::uint16_t{0x7e00u} : std::uint16_t{0x7c00u});
+    }
+
+    if (bits < minNormal)
+    {
+      // Adding the magic value aligns the 10 mantissa bits at the bottom, the FPU rounds to nearest even.
+      const float aligned = std::bit_cast<float>(bits) + std::bit_cast<float>(subnormalMagic);
+
+      return sign | static_cast<std::uint16_t>(std::bit_cast<std::uint32_t>(aligned) - subnormalMagic);
+    }
+
+    const std::uint32_t mantissaOdd = (bits >> 13) & 1u;
+
+    // Rebias the exponent from 127 to 15 and round the 13 dropped bits to nearest even.
+    bits += 0xc8000fffu + mantissaOdd;
+
+    return sign | static_cast<std::uint16_t>(bits >> 13);
+  }
+
+  /**
+   * @brief Converts IEEE 754 binary16 bits to a single, exactly.
+   * @param bits The binary16 bits.
+   * @return The single.
+   */
+  [[nodiscard]] constexpr float halfBitsToSingle(std::uint16_t bits) noexcept
+  {
+    constexpr std::uint32_t shiftedExponent{0x7c00u << 13};
+    constexpr std::uint32_t magic{113u << 23};
+
+    std::uint32_t result = static_cast<std::uint32_t>(bits & 0x7fffu) << 13;
+
+    const std::uint32_t exponent = result & shiftedExponent;
+
+    result += (127u - 15u) << 23;
+
+    if (exponent == shiftedExponent)
+    {
+      // Infinity or NaN
+      result += (128u - 16u) << 23;
+    }
+    else if (exponent == 0)
+    {
+      // Zero or subnormal, renormalize
+      result += 1u << 23;
+      result  = std::bit_cast<std::uint32_t>(std::bit_cast<float>(result) - std::bit_cast<float>(magic));
+    }
+
+    return std::bit_cast<float>(result | (static_cast<std::uint32_t>(bits & 0x8000u) << 16));
+  }
+
+  /**
+   * @brief Converts a single to bfloat16 bits, rounding to nearest even. NaN gives a quiet NaN.
+   * @param value The single.
+   * @return The bfloat16 bits.
+   */
+  [[nodiscard]] constexpr std::uint16_t singleToBfloat16Bits(float value) noexcept
+  {
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+
+    if ((bits & 0x7fffffffu) > 0x7f800000u)
+    {
+      return static_cast<std::uint16_t>((bits >> 16) | 0x0040u);
+    }
+
+    return static_cast<std::uint16_t>((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+  }
+
+  /**
+   * @brief Converts bfloat16 bits to a single, exactly.
+   * @param bits The bfloat16 bits.
+   * @return The single.
+   */
+  [[nodiscard]] constexpr float bfloat16BitsToSingle(std::uint16_t bits) noexcept
+  {
+    return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+  }
+} // namespace detail
+
+  /**
+   * @brief IEEE 754 half precision (binary16) element type. Arrays of it are stored as uint16 mxArrays holding the
+   *        bits, so TypedArray<float16> views a uint16 array without casts. It has no arithmetic, elements convert
+   *        to and from float, in bulk with the conversions of algorithm/half.hpp and gpu/half.hpp.
+   */
+  class float16
+  {
+    public:
+      /// @brief Default constructor, leaves the bits uninitialized like the arithmetic types.
+      float16() = default;
+
+      /**
+       * @brief Constructor from a single, rounds to nearest even.
+       * @param value The single.
+       */
+      constexpr explicit float16(float value) noexcept
+      : mBits{detail::singleToHalfBits(value)}
+      {}
+
+      /**
+       * @brief Creates a value from its bits.
+       * @param bits The binary16 bits.
+       * @return The value.
+       */
+      [[nodiscard]] static constexpr float16 fromBits(std::uint16_t bits) noexcept
+      {
+        float16 result{};
+
+        result.mBits = bits;
+
+        return result;
+      }
+
+      /**
+       * @brief Gets the bits.
+       * @return The binary16 bits.
+       */
+      [[nodiscard]] constexpr std::uint16_t getBits() const noexcept
+      {
+        return mBits;
+      }
+
+      /**
+       * @brief Conversion to a single, exact.
+       * @return The single.
+       */
+      [[nodiscard]] constexpr explicit operator float() const noexcept
+      {
+        return detail::halfBitsToSingle(mBits);
+      }
+    private:
+      std::uint16_t mBits; ///< The binary16 bits.
+  };
+
+  /**
+   * @brief Brain floating point (bfloat16) element type, the upper half of a single. Arrays of it are stored as
+   *        uint16 mxArrays holding the bits, like float16.
+   */
+  class bfloat16
+  {
+    public:
+      /// @brief Default constructor, leaves the bits uninitialized like the arithmetic types.
+      bfloat16() = default;
+
+      /**
+       * @brief Constructor from a single, rounds to nearest even.
+       * @param value The single.
+       */
+      constexpr explicit bfloat16(float value) noexcept
+      : mBits{detail::singleToBfloat16Bits(value)}
+      {}
+
+      /**
+       * @brief Creates a value from its bits.
+       * @param bits The bfloat16 bits.
+       * @return The value.
+       */
+      [[nodiscard]] static constexpr bfloat16 fromBits(std::uint16_t bits) noexcept
+      {
+        bfloat16 result{};
+
+        result.mBits = bits;
+
+        return result;
+      }
+
+      /**
+       * @brief Gets the bits.
+       * @return The bfloat16 bits.
+       */
+      [[nodiscard]] constexpr std::uint16_t getBits() const noexcept
+      {
+        return mBits;
+      }
+
+      /**
+       * @brief Conversion to a single, exact.
+       * @return The single.
+       */
+      [[nodiscard]] constexpr explicit operator float() const noexcept
+      {
+        return detail::bfloat16BitsToSingle(mBits);
+      }
+    private:
+      std::uint16_t mBits; ///< The bfloat16 bits.
+  };
+
+  static_assert(sizeof(float16) == sizeof(std::uint16_t) && std::is_trivially_copyable_v<float16>);
+  static_assert(sizeof(bfloat16) == sizeof(std::uint16_t) && std::is_trivially_copyable_v<bfloat16>);
+
+  /**
+   * @brief Is the type a half precision element type?
+   * @tparam T Type
+   */
+  template<typename T>
+  inline constexpr bool isHalf = std::is_same_v<std::remove_cv_t<T>, float16> ||
+                                 std::is_same_v<std::remove_cv_t<T>, bfloat16>;
+
+  /// @brief Interpretation of uint16 arrays by visit().
+  enum class HalfFormat
+  {
+    none,     ///< uint16 arrays are integers.
+    float16,  ///< uint16 arrays hold float16 bits.
+    bfloat16, ///< uint16 arrays hold bfloat16 bits.
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_HALF_HPP */
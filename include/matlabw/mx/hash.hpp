@@ -0,0 +1,184 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_HASH_HPP
+#define MATLABW_MX_HASH_HPP
+
+#include "detail/include.hpp"
+
+#include "detail/hash.hpp"
+#include "parallel/parallelFor.hpp"
+#include "Array.hpp"
+
+namespace matlabw::mx
+{
+  /// @brief 128-bit hash of an array.
+  using Hash128 = detail::Hash128;
+
+namespace detail
+{
+  /**
+   * @brief Size of the chunks of a payload hashed independently. Payloads above this size are always hashed in
+   *        chunks, so the hash does not depend on the number of threads.
+   */
+  inline constexpr std::size_t hashChunkSize{std::size_t{1} << 22};
+
+  /**
+   * @brief Hashes a payload, large payloads are hashed in parallel chunks whose hashes are hashed in order.
+   * @param data The payload.
+   * @param size The size in bytes.
+   * @param seed The seed.
+   * @return The hash.
+   */
+  [[nodiscard]] inline Hash128 hashPayload(const void* data, std::size_t size, Hash128 seed)
+  {
+    if (size <= hashChunkSize)
+    {
+      return hashBytes128(data, size, seed);
+    }
+
+    const auto*       bytes      = static_cast<const std::byte*>(data);
+    const std::size_t chunkCount = (size + hashChunkSize - 1) / hashChunkSize;
+
+    std::vector<Hash128> chunkHashes(chunkCount);
+
+    parallel::parallelFor(0, chunkCount, 1, [&](std::size_t chunk)
+    {
+      const std::size_t offset = chunk * hashChunkSize;
+
+      chunkHashes[chunk] = hashBytes128(bytes + offset, std::min(hashChunkSize, size - offset), seed);
+    });
+
+    return hashBytes128(chunkHashes.data(), chunkCount * sizeof(Hash128), hashValue128(size, seed));
+  }
+
+  /**
+   * @brief Hashes the class, complexity, dimensions and contents of an array. Sparse arrays hash their structure,
+   *        cells and structs their field names and children recursively.
+   * @param array The array, may be nullptr for an unset cell element or struct field.
+   * @param seed The seed.
+   * @return The hash, std::nullopt if the array contains objects or function handles, whose contents are unknown.
+   */
+  [[nodiscard]] inline std::optional<Hash128> hashArray(const mxArray* array, Hash128 seed)
+  {
+    if (array == nullptr)
+    {
+      return hashValue128(std::uint64_t{}, seed);
+    }
+
+    const std::size_t   count = mxGetNumberOfElements(array);
+    const std::uint64_t kind  = (static_cast<std::uint64_t>(mxGetClassID(array)) << 2) |
+                                (static_cast<std::uint64_t>(mxIsComplex(array)) << 1) |
+                                static_cast<std::uint64_t>(mxIsSparse(array));
+
+    seed = hashValue128(kind + 1, seed);
+    seed = hashBytes128(mxGetDimensions(array), mxGetNumberOfDimensions(array) * sizeof(mwSize), seed);
+
+    if (mxIsSparse(array))
+    {
+      const std::size_t n   = mxGetN(array);
+      const std::size_t nnz = static_cast<std::size_t>(mxGetJc(array)[n]);
+
+      seed = hashPayload(mxGetJc(array), (n + 1) * sizeof(mwIndex), seed);
+      seed = hashPayload(mxGetIr(array), nnz * sizeof(mwIndex), seed);
+
+      return hashPayload(mxGetData(array), nnz * mxGetElementSize(array), seed);
+    }
+
+    if (mxIsNumeric(array) || mxIsChar(array) || mxIsLogical(array))
+    {
+      return hashPayload(mxGetData(array), count * mxGetElementSize(array), seed);
+    }
+
+    if (mxIsCell(array))
+    {
+      for (std::size_t i{}; i < count; ++i)
+      {
+        const auto element = hashArray(mxGetCell(array, i), seed);
+
+        if (!element.has_value())
+        {
+          return std::nullopt;
+        }
+
+        seed = *element;
+      }
+
+      return seed;
+    }
+
+    if (mxIsStruct(array))
+    {
+      const int fieldCount = mxGetNumberOfFields(array);
+
+      for (int k{}; k < fieldCount; ++k)
+      {
+        const char* name = mxGetFieldNameByNumber(array, k);
+
+        seed = hashBytes128(name, std::char_traits<char>::length(name) + 1, seed);
+      }
+
+      for (std::size_t i{}; i < count; ++i)
+      {
+        for (int k{}; k < fieldCount; ++k)
+        {
+          const auto field = hashArray(mxGetFieldByNumber(array, i, k), seed);
+
+          if (!field.has_value())
+          {
+            return std::nullopt;
+          }
+
+          seed = *field;
+        }
+      }
+
+      return seed;
+    }
+
+    return std::nullopt;
+  }
+} // namespace detail
+
+  /**
+   * @brief Hashes an array tree with a fast non-cryptographic 128-bit hash of class, complexity, dimensions and
+   *        contents, e.g. for caching, deduplication or change detection. Payloads above 4 MiB are hashed in parallel
+   *        chunks on the library-managed thread pool. The hash is stable within a build but not a persistent format.
+   * @param array The array.
+   * @return The hash.
+   */
+  [[nodiscard]] inline Hash128 hash(ArrayCref array)
+  {
+    const auto result = detail::hashArray(array.get(), Hash128{});
+
+    if (!result.has_value())
+    {
+      throw Exception{"matlabw:mx:hash", "objects and function handles cannot be hashed"};
+    }
+
+    return *result;
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_HASH_HPP */
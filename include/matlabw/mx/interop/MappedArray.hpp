@@ -0,0 +1,81 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_INTEROP_MAPPED_ARRAY_HPP
+#define MATLABW_MX_INTEROP_MAPPED_ARRAY_HPP
+
+#include "../detail/include.hpp"
+
+#include "../MdSpan.hpp"
+#include "../NumericArray.hpp"
+#include "../typeTraits.hpp"
+
+namespace matlabw::mx::interop
+{
+  /**
+   * @brief New MATLAB array together with a map of a linear algebra library writing into its elements. The map stays
+   *        valid when the array is moved, e.g. into a MEX output.
+   * @tparam T Element type
+   * @tparam Map Map type
+   */
+  template<typename T, typename Map>
+  struct MappedArray
+  {
+    NumericArray<T> array; ///< The array, owns the elements
+    Map             map;   ///< The map of the elements
+  };
+
+namespace detail
+{
+  /**
+   * @brief Is the type an array whose elements can be mapped (TypedArrayRef, TypedArrayCref, TypedArray, ...)?
+   * @tparam A Array type
+   */
+  template<typename A>
+  concept MappableArray = requires (A& a) { a.getData(); a.getDims(); } &&
+                          isNumeric<std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<A&>().getData())>>>;
+
+  /**
+   * @brief Element type of a mapped array, const for read-only arrays such as TypedArrayCref.
+   * @tparam A Array type
+   */
+  template<typename A>
+  using MappedElement = std::remove_pointer_t<decltype(std::declval<A&>().getData())>;
+
+  /**
+   * @brief Gets the column-major view of an array, trailing dimensions are folded into the last one.
+   * @tparam Rank Rank of the view
+   * @tparam A Array type
+   * @param a The array
+   * @return The view
+   */
+  template<std::size_t Rank, typename A>
+  [[nodiscard]] MdSpan<MappedElement<A>, DExtents<Rank>> toView(A& a)
+  {
+    return mx::detail::makeMdspan<MappedElement<A>, DExtents<Rank>>(a.getData(), a.getDims());
+  }
+} // namespace detail
+} // namespace matlabw::mx::interop
+
+#endif /* MATLABW_MX_INTEROP_MAPPED_ARRAY_HPP */
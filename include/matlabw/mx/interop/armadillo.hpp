@@ -0,0 +1,147 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_INTEROP_ARMADILLO_HPP
+#define MATLABW_MX_INTEROP_ARMADILLO_HPP
+
+#include "../detail/include.hpp"
+
+#include <armadillo>
+
+#include "MappedArray.hpp"
+
+namespace matlabw::mx::interop
+{
+namespace detail
+{
+  /**
+   * @brief Armadillo matrix or cube aliasing the elements of an array, const for const elements.
+   * @tparam E Element type
+   * @tparam Container arma::Mat or arma::Cube
+   */
+  template<typename E, template<typename> typename Container>
+  using ArmadilloAlias = std::conditional_t<std::is_const_v<E>,
+                                            const Container<std::remove_const_t<E>>,
+                                            Container<E>>;
+
+  /**
+   * @brief Gets a mutable pointer to the elements for the Armadillo constructors, which have no read-only variant.
+   *        The returned object is const for const elements, so the elements are not written.
+   * @tparam E Element type
+   * @param data The elements
+   * @return The mutable pointer
+   */
+  template<typename E>
+  [[nodiscard]] std::remove_const_t<E>* toArmadilloMemory(E* data) noexcept
+  {
+    static_assert(arma::is_supported_elem_type<std::remove_const_t<E>>::value, "unsupported element type");
+
+    return const_cast<std::remove_const_t<E>*>(data);
+  }
+} // namespace detail
+
+  /**
+   * @brief Aliases the elements of an array as an Armadillo matrix, without copying. Trailing dimensions are folded
+   *        into the columns. The matrix is strict, so it never reallocates away from the array, and read-only arrays
+   *        such as TypedArrayCref give a const matrix.
+   * @tparam A Array type (TypedArrayRef, TypedArrayCref, TypedArray, ...)
+   * @param a The array, must outlive the matrix
+   * @return The matrix
+   */
+  template<detail::MappableArray A>
+  [[nodiscard]] detail::ArmadilloAlias<detail::MappedElement<A>, arma::Mat> toArmadillo(A&& a)
+  {
+    const auto view = detail::toView<2>(a);
+
+    return detail::ArmadilloAlias<detail::MappedElement<A>, arma::Mat>(detail::toArmadilloMemory(view.data_handle()),
+                                                                        static_cast<arma::uword>(view.extent(0)),
+                                                                        static_cast<arma::uword>(view.extent(1)),
+                                                                        false,
+                                                                        true);
+  }
+
+  /**
+   * @brief Aliases the elements of an array as an Armadillo cube, without copying. Missing dimensions are 1 and
+   *        trailing dimensions are folded into the slices.
+   * @tparam A Array type (TypedArrayRef, TypedArrayCref, TypedArray, ...)
+   * @param a The array, must outlive the cube
+   * @return The cube
+   */
+  template<detail::MappableArray A>
+  [[nodiscard]] detail::ArmadilloAlias<detail::MappedElement<A>, arma::Cube> toArmadilloCube(A&& a)
+  {
+    const auto view = detail::toView<3>(a);
+
+    return detail::ArmadilloAlias<detail::MappedElement<A>, arma::Cube>(detail::toArmadilloMemory(view.data_handle()),
+                                                                         static_cast<arma::uword>(view.extent(0)),
+                                                                         static_cast<arma::uword>(view.extent(1)),
+                                                                         static_cast<arma::uword>(view.extent(2)),
+                                                                         false,
+                                                                         true);
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric array and a strict Armadillo matrix aliasing it, so that results are
+   *        computed directly into the MATLAB array. Assign with operator= of the same size, resizing throws.
+   * @tparam T Element type
+   * @param m Number of rows
+   * @param n Number of columns
+   * @return The array and the matrix
+   */
+  template<typename T>
+  [[nodiscard]] MappedArray<T, arma::Mat<T>> makeArmadilloMatrix(std::size_t m, std::size_t n)
+  {
+    NumericArray<T> array = makeUninitNumericArray<T>(m, n);
+    T*              data  = detail::toArmadilloMemory(array.getData());
+
+    return {std::move(array), arma::Mat<T>(data, static_cast<arma::uword>(m), static_cast<arma::uword>(n),
+                                           false, true)};
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric array and a strict Armadillo cube aliasing it.
+   * @tparam T Element type
+   * @param m Number of rows
+   * @param n Number of columns
+   * @param p Number of slices
+   * @return The array and the cube
+   */
+  template<typename T>
+  [[nodiscard]] MappedArray<T, arma::Cube<T>> makeArmadilloCube(std::size_t m, std::size_t n, std::size_t p)
+  {
+    const std::size_t dims[]{m, n, p};
+
+    NumericArray<T> array = makeUninitNumericArray<T>(dims);
+    T*              data  = detail::toArmadilloMemory(array.getData());
+
+    return {std::move(array), arma::Cube<T>(data,
+                                            static_cast<arma::uword>(m),
+                                            static_cast<arma::uword>(n),
+                                            static_cast<arma::uword>(p),
+                                            false,
+                                            true)};
+  }
+} // namespace matlabw::mx::interop
+
+#endif /* MATLABW_MX_INTEROP_ARMADILLO_HPP */
@@ -0,0 +1,629 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_INTEROP_ARROW_HPP
+#define MATLABW_MX_INTEROP_ARROW_HPP
+
+#include "../detail/include.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../algorithm/cells.hpp"
+#include "../Array.hpp"
+#include "../ArrayRef.hpp"
+#include "../Exception.hpp"
+#include "../FieldSchema.hpp"
+#include "../LogicalArray.hpp"
+#include "../NumericArray.hpp"
+#include "../StructArray.hpp"
+
+// Arrow C data interface, https://arrow.apache.org/docs/format/CDataInterface.html. The definitions are the ones of
+// the specification, guarded so that they may be included together with arrow/c/abi.h or nanoarrow.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C"
+{
+  struct ArrowSchema
+  {
+    const char*         format;
+    const char*         name;
+    const char*         metadata;
+    int64_t             flags;
+    int64_t             n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema*  dictionary;
+    void (*release)(struct ArrowSchema*);
+    void*               private_data;
+  };
+
+  struct ArrowArray
+  {
+    int64_t             length;
+    int64_t             null_count;
+    int64_t             offset;
+    int64_t             n_buffers;
+    int64_t             n_children;
+    const void**        buffers;
+    struct ArrowArray** children;
+    struct ArrowArray*  dictionary;
+    void (*release)(struct ArrowArray*);
+    void*               private_data;
+  };
+}
+#endif /* ARROW_C_DATA_INTERFACE */
+
+namespace matlabw::mx::interop
+{
+namespace detail
+{
+  /// @brief Producer data of an exported Arrow schema.
+  struct ArrowSchemaData
+  {
+    std::string               format;        ///< Format string
+    std::string               name;          ///< Field name
+    std::vector<ArrowSchema>  children;      ///< Child schemas
+    std::vector<ArrowSchema*> childPointers; ///< Pointers to the child schemas
+  };
+
+  /// @brief Producer data of an exported Arrow array, owns the converted buffers.
+  struct ArrowArrayData
+  {
+    std::shared_ptr<const Array> owner;         ///< The exported MATLAB array, null if it is borrowed
+    std::vector<const void*>     buffers;       ///< Buffer pointers
+    std::vector<std::uint8_t>    bitmap;        ///< Values of a boolean column
+    std::string                  chars;         ///< Characters of a string column
+    std::vector<std::int32_t>    offsets32;     ///< Offsets of a string column
+    std::vector<std::int64_t>    offsets64;     ///< Offsets of a large string column
+    std::vector<ArrowArray>      children;      ///< Child arrays
+    std::vector<ArrowArray*>     childPointers; ///< Pointers to the child arrays
+  };
+
+  /**
+   * @brief Releases an exported schema and its children which were not moved away by the consumer.
+   * @param schema The schema.
+   */
+  inline void releaseArrowSchema(ArrowSchema* schema)
+  {
+    auto* data = static_cast<ArrowSchemaData*>(schema->private_data);
+
+    for (ArrowSchema* child : data->childPointers)
+    {
+      if (child->release != nullptr)
+      {
+        child->release(child);
+      }
+    }
+
+    delete data;
+
+    schema->release = nullptr;
+  }
+
+  /**
+   * @brief Releases an exported array and its children which were not moved away by the consumer.
+   * @param array The array.
+   */
+  inline void releaseArrowArray(ArrowArray* array)
+  {
+    auto* data = static_cast<ArrowArrayData*>(array->private_data);
+
+    for (ArrowArray* child : data->childPointers)
+    {
+      if (child->release != nullptr)
+      {
+        child->release(child);
+      }
+    }
+
+    delete data;
+
+    array->release = nullptr;
+  }
+
+  /**
+   * @brief Fills an exported schema, which takes over its producer data.
+   * @param schema The schema.
+   * @param data The producer data.
+   */
+  inline void publishArrowSchema(ArrowSchema& schema, std::unique_ptr<ArrowSchemaData> data) noexcept
+  {
+    schema.format       = data->format.c_str();
+    schema.name         = data->name.c_str();
+    schema.metadata     = nullptr;
+    schema.flags        = 0;
+    schema.n_children   = static_cast<int64_t>(data->childPointers.size());
+    schema.children     = data->childPointers.empty() ? nullptr : data->childPointers.data();
+    schema.dictionary   = nullptr;
+    schema.release      = releaseArrowSchema;
+    schema.private_data = data.release();
+  }
+
+  /**
+   * @brief Fills an exported array, which takes over its producer data.
+   * @param array The array.
+   * @param length Number of elements.
+   * @param data The producer data.
+   */
+  inline void publishArrowArray(ArrowArray& array, std::size_t length, std::unique_ptr<ArrowArrayData> data) noexcept
+  {
+    array.length       = static_cast<int64_t>(length);
+    array.null_count   = 0;
+    array.offset       = 0;
+    array.n_buffers    = static_cast<int64_t>(data->buffers.size());
+    array.n_children   = static_cast<int64_t>(data->childPointers.size());
+    array.buffers      = data->buffers.data();
+    array.children     = data->childPointers.empty() ? nullptr : data->childPointers.data();
+    array.dictionary   = nullptr;
+    array.release      = releaseArrowArray;
+    array.private_data = data.release();
+  }
+
+  /**
+   * @brief Gets the Arrow format of a real numeric class.
+   * @param classId Class ID
+   * @return The format string or nullptr if the class has no primitive Arrow type.
+   */
+  [[nodiscard]] inline const char* getArrowFormat(ClassId classId) noexcept
+  {
+    switch (classId)
+    {
+    case ClassId::_double: return "g";
+    case ClassId::single:  return "f";
+    case ClassId::int8:    return "c";
+    case ClassId::uint8:   return "C";
+    case ClassId::int16:   return "s";
+    case ClassId::uint16:  return "S";
+    case ClassId::int32:   return "i";
+    case ClassId::uint32:  return "I";
+    case ClassId::int64:   return "l";
+    case ClassId::uint64:  return "L";
+    default:               return nullptr;
+    }
+  }
+
+  /**
+   * @brief Exports one column. Numeric columns share the MATLAB data, logical columns are packed into a bitmap and
+   *        cellstr columns are transcoded to UTF-8 in one buffer.
+   * @param id Error identifier
+   * @param name Field name
+   * @param column The column, a vector
+   * @param owner The exported MATLAB array, null if it is borrowed
+   * @param schemaData Producer data of the child schema
+   * @param arrayData Producer data of the child array
+   */
+  inline void exportArrowColumn(const char*                         id,
+                                const std::string&                  name,
+                                ArrayCref                           column,
+                                const std::shared_ptr<const Array>& owner,
+                                ArrowSchemaData&                    schemaData,
+                                ArrowArrayData&                     arrayData)
+  {
+    const std::size_t n = column.getSize();
+
+    schemaData.name = name;
+    arrayData.owner = owner;
+
+    if (const char* format = getArrowFormat(column.getClassId()); format != nullptr)
+    {
+      if (column.isComplex())
+      {
+        throw Exception{id, "column '" + name + "' must be real"};
+      }
+
+      schemaData.format = format;
+      arrayData.buffers = {nullptr, column.getData()};
+    }
+    else if (column.getClassId() == ClassId::logical)
+    {
+      const bool* values = static_cast<const bool*>(column.getData());
+
+      arrayData.bitmap.assign((n + 7) / 8, 0);
+
+      for (std::size_t i{}; i < n; ++i)
+      {
+        arrayData.bitmap[i / 8] |= static_cast<std::uint8_t>(static_cast<unsigned>(values[i]) << (i % 8));
+      }
+
+      schemaData.format = "b";
+      arrayData.buffers = {nullptr, arrayData.bitmap.data()};
+    }
+    else if (column.isCell())
+    {
+      algorithm::StringList strings = algorithm::toStringList(column);
+
+      const auto offsets = strings.getOffsets();
+
+      if (offsets.back() <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+      {
+        arrayData.offsets32.assign(offsets.begin(), offsets.end());
+        schemaData.format = "u";
+        arrayData.buffers = {nullptr, arrayData.offsets32.data()};
+      }
+      else
+      {
+        arrayData.offsets64.assign(offsets.begin(), offsets.end());
+        schemaData.format = "U";
+        arrayData.buffers = {nullptr, arrayData.offsets64.data()};
+      }
+
+      arrayData.chars = std::string{strings.getData()};
+      arrayData.buffers.push_back(arrayData.chars.data());
+    }
+    else
+    {
+      throw Exception{id, "column '" + name + "' must be numeric, logical or a cellstr"};
+    }
+  }
+
+  /**
+   * @brief Exports the columns of a scalar struct as an Arrow struct array (a record batch).
+   * @param id Error identifier
+   * @param table The scalar struct of column vectors of equal length
+   * @param fields The columns to export, bound to the struct by the call
+   * @param owner The exported MATLAB array, null if it is borrowed
+   * @param schema Output schema
+   * @param array Output array
+   */
+  inline void exportArrow(const char*                         id,
+                          ArrayCref                           table,
+                          FieldSchema&                        fields,
+                          const std::shared_ptr<const Array>& owner,
+                          ArrowSchema*                        schema,
+                          ArrowArray*                         array)
+  {
+    if (!table.isStruct() || table.getSize() != 1)
+    {
+      throw Exception{id, "table must be a scalar struct"};
+    }
+
+    fields.bind(table);
+
+    const std::size_t count = fields.getFieldCount();
+
+    auto schemaData = std::make_unique<ArrowSchemaData>();
+    auto arrayData  = std::make_unique<ArrowArrayData>();
+
+    schemaData->format = "+s";
+    schemaData->children.resize(count);
+    arrayData->owner = owner;
+    arrayData->buffers = {nullptr};
+    arrayData->children.resize(count);
+
+    std::size_t length{};
+
+    // The children are published one by one, the parents release the published ones if a later column throws.
+    try
+    {
+      for (std::size_t k{}; k < count; ++k)
+      {
+        const std::string&            name   = fields.getFieldName(k);
+        const std::optional<ArrayCref> column = fields.getField(table, 0, k);
+
+        if (!column.has_value())
+        {
+          throw Exception{id, "column '" + name + "' is unset"};
+        }
+
+        if (column->getSize() != 0 && (column->getRank() > 2 || (column->getDimM() != 1 && column->getDimN() != 1)))
+        {
+          throw Exception{id, "column '" + name + "' must be a vector"};
+        }
+
+        if (k == 0)
+        {
+          length = column->getSize();
+        }
+        else if (column->getSize() != length)
+        {
+          throw Exception{id, "column '" + name + "' must have the length of the other columns"};
+        }
+
+        auto childSchema = std::make_unique<ArrowSchemaData>();
+        auto childArray  = std::make_unique<ArrowArrayData>();
+
+        exportArrowColumn(id, name, *column, owner, *childSchema, *childArray);
+
+        publishArrowSchema(schemaData->children[k], std::move(childSchema));
+        schemaData->childPointers.push_back(&schemaData->children[k]);
+        publishArrowArray(arrayData->children[k], length, std::move(childArray));
+        arrayData->childPointers.push_back(&arrayData->children[k]);
+      }
+    }
+    catch (...)
+    {
+      ArrowSchema parentSchema{};
+      ArrowArray  parentArray{};
+
+      publishArrowSchema(parentSchema, std::move(schemaData));
+      publishArrowArray(parentArray, 0, std::move(arrayData));
+      parentSchema.release(&parentSchema);
+      parentArray.release(&parentArray);
+      throw;
+    }
+
+    publishArrowSchema(*schema, std::move(schemaData));
+    publishArrowArray(*array, length, std::move(arrayData));
+  }
+
+  /**
+   * @brief Makes a schema of all fields of a struct, in the order of the struct.
+   * @param table The struct
+   * @return The schema
+   */
+  [[nodiscard]] inline FieldSchema getAllFields(ArrayCref table)
+  {
+    std::vector<std::string> names{};
+
+    if (table.isStruct())
+    {
+      for (int k{}; k < mxGetNumberOfFields(table.get()); ++k)
+      {
+        names.emplace_back(mxGetFieldNameByNumber(table.get(), k));
+      }
+    }
+
+    return FieldSchema{std::move(names)};
+  }
+
+  /**
+   * @brief Checks if an element of an imported array is valid.
+   * @param array The array
+   * @param i Index of the element, without the offset
+   * @return True if the element is not null
+   */
+  [[nodiscard]] inline bool isArrowValid(const ArrowArray& array, std::size_t i) noexcept
+  {
+    if (array.null_count == 0 || array.buffers[0] == nullptr)
+    {
+      return true;
+    }
+
+    const std::size_t bit = static_cast<std::size_t>(array.offset) + i;
+
+    return (static_cast<const std::uint8_t*>(array.buffers[0])[bit / 8] >> (bit % 8)) & 1;
+  }
+
+  /**
+   * @brief Imports a primitive column. Nulls of floating point columns become NaN, integer columns must not have any.
+   * @tparam T Element type
+   * @param id Error identifier
+   * @param name Field name
+   * @param array The column
+   * @return The column vector
+   */
+  template<typename T>
+  [[nodiscard]] Array importArrowPrimitive(const char* id, const char* name, const ArrowArray& array)
+  {
+    const std::size_t n    = static_cast<std::size_t>(array.length);
+    const T*          data = static_cast<const T*>(array.buffers[1]) + array.offset;
+
+    NumericArray<T> column = makeUninitNumericArray<T>(n, 1);
+
+    if (n != 0)
+    {
+      std::memcpy(column.getData(), data, n * sizeof(T));
+    }
+
+    if (array.null_count != 0 && array.buffers[0] != nullptr)
+    {
+      for (std::size_t i{}; i < n; ++i)
+      {
+        if (!isArrowValid(array, i))
+        {
+          if constexpr (std::is_floating_point_v<T>)
+          {
+            column[i] = std::numeric_limits<T>::quiet_NaN();
+          }
+          else
+          {
+            throw Exception{id, std::string{"integer column '"} + name + "' must not contain nulls"};
+          }
+        }
+      }
+    }
+
+    return column;
+  }
+
+  /**
+   * @brief Imports a string column as an n-by-1 cellstr, nulls become empty strings.
+   * @tparam Offset Offset type
+   * @param array The column
+   * @return The cellstr
+   */
+  template<typename Offset>
+  [[nodiscard]] Array importArrowStrings(const ArrowArray& array)
+  {
+    const Offset* offsets = static_cast<const Offset*>(array.buffers[1]) + array.offset;
+    const char*   chars   = static_cast<const char*>(array.buffers[2]);
+
+    return algorithm::detail::makeCellStr(static_cast<std::size_t>(array.length), [&](std::size_t i)
+    {
+      return isArrowValid(array, i)
+        ? std::string_view{chars + offsets[i], static_cast<std::size_t>(offsets[i + 1] - offsets[i])}
+        : std::string_view{};
+    });
+  }
+
+  /**
+   * @brief Imports one column.
+   * @param id Error identifier
+   * @param schema Schema of the column
+   * @param array The column
+   * @return The column vector
+   */
+  [[nodiscard]] inline Array importArrowColumn(const char* id, const ArrowSchema& schema, const ArrowArray& array)
+  {
+    const std::string_view format{schema.format};
+
+    if (format.size() == 1)
+    {
+      switch (format[0])
+      {
+      case 'g': return importArrowPrimitive<double>(id, schema.name, array);
+      case 'f': return importArrowPrimitive<float>(id, schema.name, array);
+      case 'c': return importArrowPrimitive<std::int8_t>(id, schema.name, array);
+      case 'C': return importArrowPrimitive<std::uint8_t>(id, schema.name, array);
+      case 's': return importArrowPrimitive<std::int16_t>(id, schema.name, array);
+      case 'S': return importArrowPrimitive<std::uint16_t>(id, schema.name, array);
+      case 'i': return importArrowPrimitive<std::int32_t>(id, schema.name, array);
+      case 'I': return importArrowPrimitive<std::uint32_t>(id, schema.name, array);
+      case 'l': return importArrowPrimitive<std::int64_t>(id, schema.name, array);
+      case 'L': return importArrowPrimitive<std::uint64_t>(id, schema.name, array);
+      case 'u': return importArrowStrings<std::int32_t>(array);
+      case 'U': return importArrowStrings<std::int64_t>(array);
+      case 'b':
+      {
+        const std::size_t   n      = static_cast<std::size_t>(array.length);
+        const std::uint8_t* values = static_cast<const std::uint8_t*>(array.buffers[1]);
+
+        LogicalArray column = makeLogicalArray(n, 1);
+
+        for (std::size_t i{}; i < n; ++i)
+        {
+          const std::size_t bit = static_cast<std::size_t>(array.offset) + i;
+
+          column[i] = isArrowValid(array, i) && ((values[bit / 8] >> (bit % 8)) & 1);
+        }
+
+        return column;
+      }
+      default:
+        break;
+      }
+    }
+
+    throw Exception{id, "column '" + std::string{schema.name} + "' has the unsupported format '" + std::string{format}
+                        + "'"};
+  }
+} // namespace detail
+
+  /**
+   * @brief Exports columns of a scalar struct as an Arrow record batch through the C data interface. Numeric columns
+   *        share the MATLAB data without a copy, logical columns are packed into bitmaps and cellstr columns are
+   *        transcoded to UTF-8 in one buffer per column. The struct is borrowed, so it must outlive the consumer.
+   *        Release the outputs with their release callbacks, on the MATLAB thread.
+   * @param table The scalar struct of column vectors of equal length.
+   * @param fields The columns to export, in the order of the schema. Bound to the struct by the call.
+   * @param schema Output schema of the batch, a struct type with a child per column.
+   * @param array Output batch.
+   */
+  inline void toArrow(ArrayCref table, FieldSchema& fields, ArrowSchema* schema, ArrowArray* array)
+  {
+    detail::exportArrow("matlabw:mx:interop:toArrow", table, fields, nullptr, schema, array);
+  }
+
+  /**
+   * @brief Exports all fields of a scalar struct as an Arrow record batch, see toArrow(table, fields, schema, array).
+   * @param table The scalar struct of column vectors of equal length.
+   * @param schema Output schema of the batch.
+   * @param array Output batch.
+   */
+  inline void toArrow(ArrayCref table, ArrowSchema* schema, ArrowArray* array)
+  {
+    FieldSchema fields = detail::getAllFields(table);
+
+    toArrow(table, fields, schema, array);
+  }
+
+  /**
+   * @brief Exports all fields of a scalar struct as an Arrow record batch, see toArrow(table, fields, schema, array).
+   *        The batch owns the struct, every column keeps it alive until it is released.
+   * @param table The scalar struct of column vectors of equal length.
+   * @param schema Output schema of the batch.
+   * @param array Output batch.
+   */
+  inline void toArrow(Array&& table, ArrowSchema* schema, ArrowArray* array)
+  {
+    auto        owner  = std::make_shared<const Array>(std::move(table));
+    FieldSchema fields = detail::getAllFields(ArrayCref{*owner});
+
+    detail::exportArrow("matlabw:mx:interop:toArrow", ArrayCref{*owner}, fields, owner, schema, array);
+  }
+
+  /**
+   * @brief Imports an Arrow record batch as a scalar struct of n-by-1 columns. The columns are copied, numeric ones
+   *        with memcpy, string columns become cellstrs and boolean columns logical vectors. Nulls become NaN, false
+   *        or empty strings, integer columns must not contain any. The batch is not released.
+   * @param schema Schema of the batch, a struct type.
+   * @param array The batch.
+   * @return The struct.
+   */
+  [[nodiscard]] inline StructArray fromArrow(const ArrowSchema& schema, const ArrowArray& array)
+  {
+    static constexpr char id[]{"matlabw:mx:interop:fromArrow"};
+
+    if (std::string_view{schema.format} != "+s" || schema.n_children != array.n_children)
+    {
+      throw Exception{id, "batch must be a struct array"};
+    }
+
+    if (array.null_count != 0 && array.buffers[0] != nullptr)
+    {
+      throw Exception{id, "batch must not contain null rows"};
+    }
+
+    const std::size_t count = static_cast<std::size_t>(schema.n_children);
+
+    std::vector<const char*> names(count);
+
+    for (std::size_t k{}; k < count; ++k)
+    {
+      names[k] = schema.children[k]->name;
+
+      if (names[k] == nullptr || *names[k] == '\0')
+      {
+        throw Exception{id, "columns must be named"};
+      }
+    }
+
+    StructArray table = makeStructArray(1, 1, names);
+
+    for (std::size_t k{}; k < count; ++k)
+    {
+      // The children are indexed relative to the offset of the batch.
+      ArrowArray column = *array.children[k];
+
+      column.offset += array.offset;
+      column.length  = array.length;
+
+      table.setField(0, static_cast<FieldIndex>(k), detail::importArrowColumn(id, *schema.children[k], column));
+    }
+
+    return table;
+  }
+} // namespace matlabw::mx::interop
+
+#endif /* MATLABW_MX_INTEROP_ARROW_HPP */
@@ -0,0 +1,392 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_INTEROP_DLPACK_HPP
+#define MATLABW_MX_INTEROP_DLPACK_HPP
+
+#include "../detail/include.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include <dlpack/dlpack.h>
+
+#include "../Array.hpp"
+#include "../ArrayRef.hpp"
+#include "../Exception.hpp"
+#include "../MdSpan.hpp"
+#include "../typeTraits.hpp"
+
+#ifdef MATLABW_ENABLE_GPU
+# include "../gpu/Array.hpp"
+# include "../gpu/detail/cuda.hpp"
+# include "../gpu/DeviceView.hpp"
+#endif
+
+namespace matlabw::mx::interop
+{
+  /// @brief Deleter of a managed tensor, calls the deleter of its producer.
+  struct DlpackDeleter
+  {
+    /**
+     * @brief Releases the managed tensor.
+     * @param tensor The managed tensor.
+     */
+    void operator()(DLManagedTensor* tensor) const noexcept
+    {
+      if (tensor->deleter != nullptr)
+      {
+        tensor->deleter(tensor);
+      }
+    }
+  };
+
+  /// @brief Owning handle of a managed tensor, release() hands it over to a consumer.
+  using DlpackTensor = std::unique_ptr<DLManagedTensor, DlpackDeleter>;
+
+namespace detail
+{
+  /**
+   * @brief Producer context of an exported tensor, owns the shape, the strides and optionally the array.
+   * @tparam Owner Owning array type, std::monostate for borrowed arrays
+   */
+  template<typename Owner>
+  struct DlpackContext
+  {
+    DLManagedTensor      tensor;  ///< The managed tensor, its manager_ctx points to the context
+    Owner                owner;   ///< The array kept alive by the tensor
+    std::vector<int64_t> shape;   ///< Shape of the tensor
+    std::vector<int64_t> strides; ///< Column-major strides of the tensor in elements
+  };
+
+  /**
+   * @brief Gets the DLPack data type of a MATLAB class.
+   * @param id Error identifier
+   * @param classId Class ID
+   * @param complex Whether the elements are complex
+   * @return The data type
+   */
+  [[nodiscard]] inline DLDataType getDlpackType(const char* id, ClassId classId, bool complex)
+  {
+    DLDataType type{};
+
+    switch (classId)
+    {
+    case ClassId::_double: type = {kDLFloat, 64, 1}; break;
+    case ClassId::single:  type = {kDLFloat, 32, 1}; break;
+    case ClassId::int8:    type = {kDLInt, 8, 1};    break;
+    case ClassId::uint8:   type = {kDLUInt, 8, 1};   break;
+    case ClassId::int16:   type = {kDLInt, 16, 1};   break;
+    case ClassId::uint16:  type = {kDLUInt, 16, 1};  break;
+    case ClassId::int32:   type = {kDLInt, 32, 1};   break;
+    case ClassId::uint32:  type = {kDLUInt, 32, 1};  break;
+    case ClassId::int64:   type = {kDLInt, 64, 1};   break;
+    case ClassId::uint64:  type = {kDLUInt, 64, 1};  break;
+    default:
+      throw Exception{id, "array must be numeric"};
+    }
+
+    if (complex)
+    {
+      if (type.code != kDLFloat)
+      {
+        throw Exception{id, "complex integer arrays have no DLPack data type"};
+      }
+
+      type.code  = kDLComplex;
+      type.bits *= 2;
+    }
+
+    return type;
+  }
+
+  /**
+   * @brief Exports array data as a managed tensor with column-major strides.
+   * @tparam Owner Owning array type, std::monostate for borrowed arrays
+   * @param owner The array kept alive until the consumer calls the deleter
+   * @param data Pointer to the data
+   * @param dims Dimensions
+   * @param type Data type
+   * @param device Device of the data
+   * @return The managed tensor
+   */
+  template<typename Owner>
+  [[nodiscard]] DlpackTensor makeDlpack(Owner&&           owner,
+                                        void*             data,
+                                        View<std::size_t> dims,
+                                        DLDataType        type,
+                                        DLDevice          device)
+  {
+    auto context = std::make_unique<DlpackContext<Owner>>(DlpackContext<Owner>{{}, std::move(owner), {}, {}});
+
+    context->shape.resize(dims.size());
+    context->strides.resize(dims.size());
+
+    for (std::size_t r{}, stride{1}; r < dims.size(); ++r)
+    {
+      context->shape[r]    = static_cast<int64_t>(dims[r]);
+      context->strides[r]  = static_cast<int64_t>(stride);
+      stride              *= dims[r];
+    }
+
+    DLManagedTensor& tensor = context->tensor;
+
+    tensor.dl_tensor.data        = data;
+    tensor.dl_tensor.device      = device;
+    tensor.dl_tensor.ndim        = static_cast<int32_t>(dims.size());
+    tensor.dl_tensor.dtype       = type;
+    tensor.dl_tensor.shape       = context->shape.data();
+    tensor.dl_tensor.strides     = context->strides.data();
+    tensor.dl_tensor.byte_offset = 0;
+    tensor.manager_ctx           = context.get();
+    tensor.deleter               = [](DLManagedTensor* self)
+    {
+      delete static_cast<DlpackContext<Owner>*>(self->manager_ctx);
+    };
+
+    return DlpackTensor{&context.release()->tensor};
+  }
+
+  /**
+   * @brief Gets the shape and strides of an imported tensor, checks its data type.
+   * @tparam T Element type
+   * @tparam Rank Rank of the view
+   * @param id Error identifier
+   * @param tensor The tensor
+   * @param extents Extents, missing dimensions are 1
+   * @param strides Strides in elements, compact row-major if the tensor has none
+   */
+  template<typename T, std::size_t Rank>
+  void getDlpackLayout(const char*                    id,
+                       const DLTensor&                tensor,
+                       std::array<std::size_t, Rank>& extents,
+                       std::array<std::size_t, Rank>& strides)
+  {
+    using U = std::remove_cv_t<T>;
+
+    const DLDataType type = getDlpackType(id, TypeProperties<U>::classId, isComplexNumeric<U>);
+
+    if (tensor.dtype.code != type.code || tensor.dtype.bits != type.bits || tensor.dtype.lanes != type.lanes)
+    {
+      throw Exception{id, "tensor data type does not match the element type"};
+    }
+
+    if (tensor.ndim < 0 || static_cast<std::size_t>(tensor.ndim) > Rank)
+    {
+      throw Exception{id, "tensor rank exceeds the rank of the view"};
+    }
+
+    const std::size_t ndim = static_cast<std::size_t>(tensor.ndim);
+
+    extents.fill(1);
+    strides.fill(1);
+
+    for (std::size_t r{}; r < ndim; ++r)
+    {
+      if (tensor.shape[r] < 0 || (tensor.strides != nullptr && tensor.strides[r] < 0))
+      {
+        throw Exception{id, "negative tensor extents and strides are not supported"};
+      }
+
+      extents[r] = static_cast<std::size_t>(tensor.shape[r]);
+    }
+
+    for (std::size_t r{ndim}; r-- > 0;)
+    {
+      if (tensor.strides != nullptr)
+      {
+        strides[r] = static_cast<std::size_t>(tensor.strides[r]);
+      }
+      else if (r + 1 < ndim)
+      {
+        strides[r] = strides[r + 1] * extents[r + 1];
+      }
+    }
+
+    for (std::size_t r{ndim}; r < Rank; ++r)
+    {
+      strides[r] = (r > 0) ? strides[r - 1] * extents[r - 1] : 1;
+    }
+  }
+
+  /**
+   * @brief Gets the data pointer of an imported tensor.
+   * @tparam T Element type
+   * @param tensor The tensor
+   * @return The data pointer
+   */
+  template<typename T>
+  [[nodiscard]] T* getDlpackData(const DLTensor& tensor) noexcept
+  {
+    return reinterpret_cast<T*>(static_cast<std::byte*>(tensor.data) + tensor.byte_offset);
+  }
+} // namespace detail
+
+  /**
+   * @brief Exports a host array as a DLPack tensor with column-major strides, without copying. The tensor borrows the
+   *        data, so the array must outlive every consumer of the tensor, as is the case for MEX function inputs used
+   *        during the call.
+   * @param array The numeric array, complex integer arrays are not supported.
+   * @return The managed tensor
+   */
+  [[nodiscard]] inline DlpackTensor toDlpack(ArrayCref array)
+  {
+    static constexpr char id[]{"matlabw:mx:interop:toDlpack"};
+
+    const DLDataType type = detail::getDlpackType(id, array.getClassId(), array.isComplex());
+
+    return detail::makeDlpack(std::monostate{}, const_cast<void*>(array.getData()), array.getDims(), type, {kDLCPU, 0});
+  }
+
+  /**
+   * @brief Exports a host array as a DLPack tensor with column-major strides, without copying. The tensor owns the
+   *        array and destroys it in its deleter, which must run on the MATLAB thread.
+   * @param array The numeric array, complex integer arrays are not supported.
+   * @return The managed tensor
+   */
+  [[nodiscard]] inline DlpackTensor toDlpack(Array&& array)
+  {
+    static constexpr char id[]{"matlabw:mx:interop:toDlpack"};
+
+    const DLDataType type = detail::getDlpackType(id, array.getClassId(), array.isComplex());
+    void*            data = array.getData();
+
+    // The array is moved into the context before its dimensions are read, so they are copied first.
+    const std::vector<std::size_t> dims(array.getDims().begin(), array.getDims().end());
+
+    return detail::makeDlpack(std::move(array), data, dims, type, {kDLCPU, 0});
+  }
+
+  /**
+   * @brief Imports a host DLPack tensor as a borrowed strided view, without copying. The managed tensor must outlive
+   *        the view and is still released by its owner.
+   * @tparam T Element type, const-qualified for read-only views
+   * @tparam Rank Rank of the view, at least the rank of the tensor
+   * @param tensor The tensor
+   * @return The view
+   */
+  template<typename T, std::size_t Rank>
+  [[nodiscard]] MdSpan<T, DExtents<Rank>, LayoutStride> fromDlpack(const DLTensor& tensor)
+  {
+    static constexpr char id[]{"matlabw:mx:interop:fromDlpack"};
+
+    if (tensor.device.device_type != kDLCPU && tensor.device.device_type != kDLCUDAHost)
+    {
+      throw Exception{id, "tensor must be in host memory"};
+    }
+
+    std::array<std::size_t, Rank> extents{};
+    std::array<std::size_t, Rank> strides{};
+
+    detail::getDlpackLayout<T>(id, tensor, extents, strides);
+
+    return MdSpan<T, DExtents<Rank>, LayoutStride>{detail::getDlpackData<T>(tensor), DExtents<Rank>{extents}, strides};
+  }
+
+#ifdef MATLABW_ENABLE_GPU
+  /**
+   * @brief Exports a gpuArray as a DLPack tensor on the current CUDA device, without copying. The tensor borrows the
+   *        data, so the array must outlive every consumer of the tensor.
+   * @param array The numeric gpuArray, complex integer arrays are not supported.
+   * @return The managed tensor
+   */
+  [[nodiscard]] inline DlpackTensor toDlpack(gpu::ArrayCref array)
+  {
+    static constexpr char id[]{"matlabw:mx:interop:toDlpack"};
+
+    const DLDataType type = detail::getDlpackType(id, array.getClassId(), array.isComplex());
+
+    int device{};
+    gpu::detail::checkCuda(cudaGetDevice(&device), id);
+
+    return detail::makeDlpack(std::monostate{},
+                              const_cast<void*>(array.getData()),
+                              array.getDims(),
+                              type,
+                              {kDLCUDA, static_cast<int32_t>(device)});
+  }
+
+  /**
+   * @brief Exports a gpuArray as a DLPack tensor on the current CUDA device, without copying. The tensor owns the
+   *        array and destroys it in its deleter, which must run on the MATLAB thread.
+   * @param array The numeric gpuArray, complex integer arrays are not supported.
+   * @return The managed tensor
+   */
+  [[nodiscard]] inline DlpackTensor toDlpack(gpu::Array&& array)
+  {
+    static constexpr char id[]{"matlabw:mx:interop:toDlpack"};
+
+    const DLDataType type = detail::getDlpackType(id, array.getClassId(), array.isComplex());
+    void*            data = array.getData();
+
+    const std::vector<std::size_t> dims(array.getDims().begin(), array.getDims().end());
+
+    int device{};
+    gpu::detail::checkCuda(cudaGetDevice(&device), id);
+
+    return detail::makeDlpack(std::move(array), data, dims, type, {kDLCUDA, static_cast<int32_t>(device)});
+  }
+
+  /**
+   * @brief Imports a CUDA DLPack tensor as a borrowed device view, without copying. The device view is column-major,
+   *        so the tensor must be compact in column-major order. The managed tensor must outlive the view.
+   * @tparam T Element type, const-qualified for read-only views
+   * @tparam Rank Rank of the view, at least the rank of the tensor
+   * @param tensor The tensor
+   * @return The device view
+   */
+  template<typename T, std::size_t Rank>
+  [[nodiscard]] gpu::DeviceView<T, Rank> fromDlpackDevice(const DLTensor& tensor)
+  {
+    static constexpr char id[]{"matlabw:mx:interop:fromDlpackDevice"};
+
+    if (tensor.device.device_type != kDLCUDA && tensor.device.device_type != kDLCUDAManaged)
+    {
+      throw Exception{id, "tensor must be in CUDA device memory"};
+    }
+
+    std::array<std::size_t, Rank> extents{};
+    std::array<std::size_t, Rank> strides{};
+
+    detail::getDlpackLayout<T>(id, tensor, extents, strides);
+
+    for (std::size_t r{}, stride{1}; r < Rank; ++r)
+    {
+      if (extents[r] > 1 && strides[r] != stride)
+      {
+        throw Exception{id, "tensor must be compact in column-major order"};
+      }
+
+      stride *= extents[r];
+    }
+
+    return gpu::DeviceView<T, Rank>{detail::getDlpackData<T>(tensor), extents};
+  }
+#endif
+} // namespace matlabw::mx::interop
+
+#endif /* MATLABW_MX_INTEROP_DLPACK_HPP */
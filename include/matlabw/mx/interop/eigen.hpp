@@ -0,0 +1,176 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_INTEROP_EIGEN_HPP
+#define MATLABW_MX_INTEROP_EIGEN_HPP
+
+#include "../detail/include.hpp"
+
+#include <Eigen/Core>
+
+#if __has_include(<unsupported/Eigen/CXX11/Tensor>)
+# include <unsupported/Eigen/CXX11/Tensor>
+# define MATLABW_INTEROP_EIGEN_TENSOR
+#endif
+
+#include "MappedArray.hpp"
+
+namespace matlabw::mx::interop
+{
+namespace detail
+{
+  /**
+   * @brief Dynamic Eigen matrix of an element type, const for const elements.
+   * @tparam E Element type
+   * @tparam Cols Number of columns, 1 for vectors
+   */
+  template<typename E, int Cols = Eigen::Dynamic>
+  using EigenMatrix = std::conditional_t<std::is_const_v<E>,
+                                         const Eigen::Matrix<std::remove_const_t<E>, Eigen::Dynamic, Cols>,
+                                         Eigen::Matrix<E, Eigen::Dynamic, Cols>>;
+
+#ifdef MATLABW_INTEROP_EIGEN_TENSOR
+  /**
+   * @brief Column-major Eigen tensor of an element type, const for const elements.
+   * @tparam E Element type
+   * @tparam Rank Rank of the tensor
+   */
+  template<typename E, std::size_t Rank>
+  using EigenTensor = std::conditional_t<std::is_const_v<E>,
+                                         const Eigen::Tensor<std::remove_const_t<E>, int{Rank}, Eigen::ColMajor>,
+                                         Eigen::Tensor<E, int{Rank}, Eigen::ColMajor>>;
+#endif
+} // namespace detail
+
+  /**
+   * @brief Maps the elements of an array as a column-major Eigen matrix, without copying. Trailing dimensions are
+   *        folded into the columns. Read-only arrays such as TypedArrayCref give a read-only map.
+   * @tparam A Array type (TypedArrayRef, TypedArrayCref, TypedArray, ...)
+   * @param a The array, must outlive the map
+   * @return The map
+   */
+  template<detail::MappableArray A>
+  [[nodiscard]] Eigen::Map<detail::EigenMatrix<detail::MappedElement<A>>> toEigen(A&& a)
+  {
+    const auto view = detail::toView<2>(a);
+
+    return Eigen::Map<detail::EigenMatrix<detail::MappedElement<A>>>{view.data_handle(),
+                                                                     static_cast<Eigen::Index>(view.extent(0)),
+                                                                     static_cast<Eigen::Index>(view.extent(1))};
+  }
+
+  /**
+   * @brief Maps all elements of an array as an Eigen column vector, without copying.
+   * @tparam A Array type (TypedArrayRef, TypedArrayCref, TypedArray, ...)
+   * @param a The array, must outlive the map
+   * @return The map
+   */
+  template<detail::MappableArray A>
+  [[nodiscard]] Eigen::Map<detail::EigenMatrix<detail::MappedElement<A>, 1>> toEigenVector(A&& a)
+  {
+    const auto view = detail::toView<1>(a);
+
+    return Eigen::Map<detail::EigenMatrix<detail::MappedElement<A>, 1>>{view.data_handle(),
+                                                                        static_cast<Eigen::Index>(view.extent(0))};
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric array and an Eigen matrix map writing into it, so that results are
+   *        computed directly into the MATLAB array.
+   * @tparam T Element type
+   * @param m Number of rows
+   * @param n Number of columns
+   * @return The array and the map
+   */
+  template<typename T>
+  [[nodiscard]] MappedArray<T, Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>>
+  makeEigenMatrix(std::size_t m, std::size_t n)
+  {
+    NumericArray<T> array = makeUninitNumericArray<T>(m, n);
+    T*              data  = array.getData();
+
+    return {std::move(array), Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>{
+      data, static_cast<Eigen::Index>(m), static_cast<Eigen::Index>(n)}};
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric column vector and an Eigen vector map writing into it.
+   * @tparam T Element type
+   * @param n Number of elements
+   * @return The array and the map
+   */
+  template<typename T>
+  [[nodiscard]] MappedArray<T, Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>> makeEigenVector(std::size_t n)
+  {
+    NumericArray<T> array = makeUninitNumericArray<T>(n, 1);
+    T*              data  = array.getData();
+
+    return {std::move(array), Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1>>{data, static_cast<Eigen::Index>(n)}};
+  }
+
+#ifdef MATLABW_INTEROP_EIGEN_TENSOR
+  /**
+   * @brief Maps the elements of an array as a column-major Eigen tensor, without copying. Missing dimensions are 1
+   *        and trailing dimensions are folded into the last one.
+   * @tparam Rank Rank of the tensor
+   * @tparam A Array type (TypedArrayRef, TypedArrayCref, TypedArray, ...)
+   * @param a The array, must outlive the map
+   * @return The map
+   */
+  template<std::size_t Rank, detail::MappableArray A>
+  [[nodiscard]] Eigen::TensorMap<detail::EigenTensor<detail::MappedElement<A>, Rank>> toEigenTensor(A&& a)
+  {
+    const auto view = detail::toView<Rank>(a);
+
+    std::array<Eigen::Index, Rank> dims{};
+
+    for (std::size_t r{}; r < Rank; ++r)
+    {
+      dims[r] = static_cast<Eigen::Index>(view.extent(r));
+    }
+
+    return Eigen::TensorMap<detail::EigenTensor<detail::MappedElement<A>, Rank>>{view.data_handle(), dims};
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric array and an Eigen tensor map writing into it.
+   * @tparam T Element type
+   * @tparam Rank Rank of the tensor
+   * @param dims Dimensions
+   * @return The array and the map
+   */
+  template<typename T, std::size_t Rank>
+  [[nodiscard]] MappedArray<T, Eigen::TensorMap<Eigen::Tensor<T, int{Rank}, Eigen::ColMajor>>>
+  makeEigenTensor(const std::array<std::size_t, Rank>& dims)
+  {
+    NumericArray<T> array = makeUninitNumericArray<T>(dims);
+
+    auto map = toEigenTensor<Rank>(array);
+
+    return {std::move(array), map};
+  }
+#endif
+} // namespace matlabw::mx::interop
+
+#endif /* MATLABW_MX_INTEROP_EIGEN_HPP */
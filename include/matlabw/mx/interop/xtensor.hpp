@@ -0,0 +1,117 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_INTEROP_XTENSOR_HPP
+#define MATLABW_MX_INTEROP_XTENSOR_HPP
+
+#include "../detail/include.hpp"
+
+#include <array>
+
+#if __has_include(<xtensor/containers/xadapt.hpp>)
+# include <xtensor/containers/xadapt.hpp>
+#else
+# include <xtensor/xadapt.hpp>
+#endif
+
+#include "MappedArray.hpp"
+
+namespace matlabw::mx::interop
+{
+namespace detail
+{
+  /**
+   * @brief Column-major xtensor adaptor of elements, read-only for const elements.
+   * @tparam E Element type
+   * @tparam Rank Rank of the adaptor
+   */
+  template<typename E, std::size_t Rank>
+  using XtensorAdaptor = decltype(xt::adapt<xt::layout_type::column_major>(
+    std::declval<E*>(), std::size_t{}, xt::no_ownership(), std::declval<const std::array<std::size_t, Rank>&>()));
+
+  /**
+   * @brief Adapts elements as a column-major xtensor.
+   * @tparam E Element type
+   * @tparam Rank Rank of the adaptor
+   * @param data The elements
+   * @param shape The shape
+   * @return The adaptor
+   */
+  template<typename E, std::size_t Rank>
+  [[nodiscard]] XtensorAdaptor<E, Rank> adaptXtensor(E* data, const std::array<std::size_t, Rank>& shape)
+  {
+    std::size_t size{1};
+
+    for (const std::size_t extent : shape)
+    {
+      size *= extent;
+    }
+
+    return xt::adapt<xt::layout_type::column_major>(data, size, xt::no_ownership(), shape);
+  }
+} // namespace detail
+
+  /**
+   * @brief Adapts the elements of an array as a column-major xtensor of a fixed rank, without copying. Missing
+   *        dimensions are 1 and trailing dimensions are folded into the last one. Read-only arrays such as
+   *        TypedArrayCref give a read-only adaptor.
+   * @tparam Rank Rank of the adaptor
+   * @tparam A Array type (TypedArrayRef, TypedArrayCref, TypedArray, ...)
+   * @param a The array, must outlive the adaptor
+   * @return The adaptor
+   */
+  template<std::size_t Rank, detail::MappableArray A>
+  [[nodiscard]] detail::XtensorAdaptor<detail::MappedElement<A>, Rank> toXtensor(A&& a)
+  {
+    const auto view = detail::toView<Rank>(a);
+
+    std::array<std::size_t, Rank> shape{};
+
+    for (std::size_t r{}; r < Rank; ++r)
+    {
+      shape[r] = view.extent(r);
+    }
+
+    return detail::adaptXtensor(view.data_handle(), shape);
+  }
+
+  /**
+   * @brief Creates an uninitialized numeric array and a column-major xtensor adaptor writing into it, so that results
+   *        are computed directly into the MATLAB array. Assign results of the same shape, resizing is not possible.
+   * @tparam T Element type
+   * @tparam Rank Rank of the adaptor
+   * @param dims Dimensions
+   * @return The array and the adaptor
+   */
+  template<typename T, std::size_t Rank>
+  [[nodiscard]] MappedArray<T, detail::XtensorAdaptor<T, Rank>> makeXtensor(const std::array<std::size_t, Rank>& dims)
+  {
+    NumericArray<T> array = makeUninitNumericArray<T>(dims);
+    T*              data  = array.getData();
+
+    return {std::move(array), detail::adaptXtensor(data, dims)};
+  }
+} // namespace matlabw::mx::interop
+
+#endif /* MATLABW_MX_INTEROP_XTENSOR_HPP */
@@ -0,0 +1,896 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_LINALG_HPP
+#define MATLABW_MX_LINALG_HPP
+
+#include "detail/include.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <blas.h>
+#include <lapack.h>
+
+#include "Arena.hpp"
+#include "Exception.hpp"
+#include "NumericArray.hpp"
+#include "TypedArrayRef.hpp"
+
+namespace matlabw::mx::linalg
+{
+  /// @brief Operation applied to a matrix argument.
+  enum class Transpose : char
+  {
+    none      = 'N', ///< The matrix as is.
+    transpose = 'T', ///< The transpose.
+    conjugate = 'C', ///< The conjugate transpose.
+  };
+
+  /// @brief Triangle of a symmetric or Hermitian matrix which is referenced.
+  enum class Uplo : char
+  {
+    upper = 'U', ///< The upper triangle.
+    lower = 'L', ///< The lower triangle.
+  };
+
+namespace detail
+{
+  /// @brief Integer type of MATLAB's BLAS and LAPACK, 64-bit on all supported platforms.
+  using BlasInt = std::ptrdiff_t;
+
+  /// @brief Checks if a type is supported by the BLAS and LAPACK wrappers.
+  template<typename T>
+  inline constexpr bool isBlasType = std::is_same_v<T, float> || std::is_same_v<T, double>
+                                     || std::is_same_v<T, std::complex<float>>
+                                     || std::is_same_v<T, std::complex<double>>;
+
+  /// @brief Gets the real type of an element type.
+  template<typename T>
+  struct RealOf
+  {
+    using Type = T; ///< The real type.
+  };
+
+  /// @brief Gets the real type of a complex element type.
+  template<typename T>
+  struct RealOf<std::complex<T>>
+  {
+    using Type = T; ///< The real type.
+  };
+
+  /// @brief The real type of an element type.
+  template<typename T>
+  using RealType = typename RealOf<T>::Type;
+
+  /**
+   * @brief Reinterprets element data as Fortran data. MATLAB's BLAS and LAPACK take interleaved complex data as
+   *        pointers to the real type and all arguments by non-const pointer.
+   * @tparam T The element type.
+   * @param ptr The data.
+   * @return The Fortran data.
+   */
+  template<typename T>
+  [[nodiscard]] RealType<std::remove_const_t<T>>* toFortran(T* ptr) noexcept
+  {
+    return reinterpret_cast<RealType<std::remove_const_t<T>>*>(const_cast<std::remove_const_t<T>*>(ptr));
+  }
+
+  /**
+   * @brief Converts a size to the BLAS integer type, at least 1 as required for leading dimensions.
+   * @param size The size.
+   * @return The BLAS integer.
+   */
+  [[nodiscard]] inline BlasInt toLeadingDim(std::size_t size) noexcept
+  {
+    return std::max(static_cast<BlasInt>(size), BlasInt{1});
+  }
+
+  /// @brief Calls ?gemm for float.
+  inline void gemm(char ta, char tb, BlasInt m, BlasInt n, BlasInt k, const float* alpha, const float* a,
+                   BlasInt lda, const float* b, BlasInt ldb, const float* beta, float* c, BlasInt ldc)
+  {
+    sgemm(&ta, &tb, &m, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(b), &ldb, toFortran(beta), c, &ldc);
+  }
+
+  /// @brief Calls ?gemm for double.
+  inline void gemm(char ta, char tb, BlasInt m, BlasInt n, BlasInt k, const double* alpha, const double* a,
+                   BlasInt lda, const double* b, BlasInt ldb, const double* beta, double* c, BlasInt ldc)
+  {
+    dgemm(&ta, &tb, &m, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(b), &ldb, toFortran(beta), c, &ldc);
+  }
+
+  /// @brief Calls ?gemm for single complex.
+  inline void gemm(char ta, char tb, BlasInt m, BlasInt n, BlasInt k, const std::complex<float>* alpha,
+                   const std::complex<float>* a, BlasInt lda, const std::complex<float>* b, BlasInt ldb,
+                   const std::complex<float>* beta, std::complex<float>* c, BlasInt ldc)
+  {
+    cgemm(&ta, &tb, &m, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(b), &ldb, toFortran(beta),
+          toFortran(c), &ldc);
+  }
+
+  /// @brief Calls ?gemm for double complex.
+  inline void gemm(char ta, char tb, BlasInt m, BlasInt n, BlasInt k, const std::complex<double>* alpha,
+                   const std::complex<double>* a, BlasInt lda, const std::complex<double>* b, BlasInt ldb,
+                   const std::complex<double>* beta, std::complex<double>* c, BlasInt ldc)
+  {
+    zgemm(&ta, &tb, &m, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(b), &ldb, toFortran(beta),
+          toFortran(c), &ldc);
+  }
+
+  /// @brief Calls ?gemv for float.
+  inline void gemv(char ta, BlasInt m, BlasInt n, const float* alpha, const float* a, BlasInt lda, const float* x,
+                   BlasInt incx, const float* beta, float* y, BlasInt incy)
+  {
+    sgemv(&ta, &m, &n, toFortran(alpha), toFortran(a), &lda, toFortran(x), &incx, toFortran(beta), y, &incy);
+  }
+
+  /// @brief Calls ?gemv for double.
+  inline void gemv(char ta, BlasInt m, BlasInt n, const double* alpha, const double* a, BlasInt lda,
+                   const double* x, BlasInt incx, const double* beta, double* y, BlasInt incy)
+  {
+    dgemv(&ta, &m, &n, toFortran(alpha), toFortran(a), &lda, toFortran(x), &incx, toFortran(beta), y, &incy);
+  }
+
+  /// @brief Calls ?gemv for single complex.
+  inline void gemv(char ta, BlasInt m, BlasInt n, const std::complex<float>* alpha, const std::complex<float>* a,
+                   BlasInt lda, const std::complex<float>* x, BlasInt incx, const std::complex<float>* beta,
+                   std::complex<float>* y, BlasInt incy)
+  {
+    cgemv(&ta, &m, &n, toFortran(alpha), toFortran(a), &lda, toFortran(x), &incx, toFortran(beta), toFortran(y),
+          &incy);
+  }
+
+  /// @brief Calls ?gemv for double complex.
+  inline void gemv(char ta, BlasInt m, BlasInt n, const std::complex<double>* alpha, const std::complex<double>* a,
+                   BlasInt lda, const std::complex<double>* x, BlasInt incx, const std::complex<double>* beta,
+                   std::complex<double>* y, BlasInt incy)
+  {
+    zgemv(&ta, &m, &n, toFortran(alpha), toFortran(a), &lda, toFortran(x), &incx, toFortran(beta), toFortran(y),
+          &incy);
+  }
+
+  /// @brief Calls ?syrk for float.
+  inline void syrk(char uplo, char trans, BlasInt n, BlasInt k, const float* alpha, const float* a, BlasInt lda,
+                   const float* beta, float* c, BlasInt ldc)
+  {
+    ssyrk(&uplo, &trans, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(beta), c, &ldc);
+  }
+
+  /// @brief Calls ?syrk for double.
+  inline void syrk(char uplo, char trans, BlasInt n, BlasInt k, const double* alpha, const double* a, BlasInt lda,
+                   const double* beta, double* c, BlasInt ldc)
+  {
+    dsyrk(&uplo, &trans, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(beta), c, &ldc);
+  }
+
+  /// @brief Calls ?syrk for single complex.
+  inline void syrk(char uplo, char trans, BlasInt n, BlasInt k, const std::complex<float>* alpha,
+                   const std::complex<float>* a, BlasInt lda, const std::complex<float>* beta,
+                   std::complex<float>* c, BlasInt ldc)
+  {
+    csyrk(&uplo, &trans, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(beta), toFortran(c), &ldc);
+  }
+
+  /// @brief Calls ?syrk for double complex.
+  inline void syrk(char uplo, char trans, BlasInt n, BlasInt k, const std::complex<double>* alpha,
+                   const std::complex<double>* a, BlasInt lda, const std::complex<double>* beta,
+                   std::complex<double>* c, BlasInt ldc)
+  {
+    zsyrk(&uplo, &trans, &n, &k, toFortran(alpha), toFortran(a), &lda, toFortran(beta), toFortran(c), &ldc);
+  }
+
+  /// @brief Calls ?gesv for float.
+  inline BlasInt gesv(BlasInt n, BlasInt nrhs, float* a, BlasInt lda, BlasInt* ipiv, float* b, BlasInt ldb)
+  {
+    BlasInt info{};
+    sgesv(&n, &nrhs, a, &lda, ipiv, b, &ldb, &info);
+    return info;
+  }
+
+  /// @brief Calls ?gesv for double.
+  inline BlasInt gesv(BlasInt n, BlasInt nrhs, double* a, BlasInt lda, BlasInt* ipiv, double* b, BlasInt ldb)
+  {
+    BlasInt info{};
+    dgesv(&n, &nrhs, a, &lda, ipiv, b, &ldb, &info);
+    return info;
+  }
+
+  /// @brief Calls ?gesv for single complex.
+  inline BlasInt gesv(BlasInt n, BlasInt nrhs, std::complex<float>* a, BlasInt lda, BlasInt* ipiv,
+                      std::complex<float>* b, BlasInt ldb)
+  {
+    BlasInt info{};
+    cgesv(&n, &nrhs, toFortran(a), &lda, ipiv, toFortran(b), &ldb, &info);
+    return info;
+  }
+
+  /// @brief Calls ?gesv for double complex.
+  inline BlasInt gesv(BlasInt n, BlasInt nrhs, std::complex<double>* a, BlasInt lda, BlasInt* ipiv,
+                      std::complex<double>* b, BlasInt ldb)
+  {
+    BlasInt info{};
+    zgesv(&n, &nrhs, toFortran(a), &lda, ipiv, toFortran(b), &ldb, &info);
+    return info;
+  }
+
+  /// @brief Calls ?potrf for float.
+  inline BlasInt potrf(char uplo, BlasInt n, float* a, BlasInt lda)
+  {
+    BlasInt info{};
+    spotrf(&uplo, &n, a, &lda, &info);
+    return info;
+  }
+
+  /// @brief Calls ?potrf for double.
+  inline BlasInt potrf(char uplo, BlasInt n, double* a, BlasInt lda)
+  {
+    BlasInt info{};
+    dpotrf(&uplo, &n, a, &lda, &info);
+    return info;
+  }
+
+  /// @brief Calls ?potrf for single complex.
+  inline BlasInt potrf(char uplo, BlasInt n, std::complex<float>* a, BlasInt lda)
+  {
+    BlasInt info{};
+    cpotrf(&uplo, &n, toFortran(a), &lda, &info);
+    return info;
+  }
+
+  /// @brief Calls ?potrf for double complex.
+  inline BlasInt potrf(char uplo, BlasInt n, std::complex<double>* a, BlasInt lda)
+  {
+    BlasInt info{};
+    zpotrf(&uplo, &n, toFortran(a), &lda, &info);
+    return info;
+  }
+
+  /// @brief Calls ?syev for float, rwork is not used.
+  inline BlasInt syev(char jobz, char uplo, BlasInt n, float* a, BlasInt lda, float* w, float* work, BlasInt lwork,
+                      float*)
+  {
+    BlasInt info{};
+    ssyev(&jobz, &uplo, &n, a, &lda, w, work, &lwork, &info);
+    return info;
+  }
+
+  /// @brief Calls ?syev for double, rwork is not used.
+  inline BlasInt syev(char jobz, char uplo, BlasInt n, double* a, BlasInt lda, double* w, double* work,
+                      BlasInt lwork, double*)
+  {
+    BlasInt info{};
+    dsyev(&jobz, &uplo, &n, a, &lda, w, work, &lwork, &info);
+    return info;
+  }
+
+  /// @brief Calls ?heev for single complex, rwork must hold max(1, 3 * n - 2) elements.
+  inline BlasInt syev(char jobz, char uplo, BlasInt n, std::complex<float>* a, BlasInt lda, float* w,
+                      std::complex<float>* work, BlasInt lwork, float* rwork)
+  {
+    BlasInt info{};
+    cheev(&jobz, &uplo, &n, toFortran(a), &lda, w, toFortran(work), &lwork, rwork, &info);
+    return info;
+  }
+
+  /// @brief Calls ?heev for double complex, rwork must hold max(1, 3 * n - 2) elements.
+  inline BlasInt syev(char jobz, char uplo, BlasInt n, std::complex<double>* a, BlasInt lda, double* w,
+                      std::complex<double>* work, BlasInt lwork, double* rwork)
+  {
+    BlasInt info{};
+    zheev(&jobz, &uplo, &n, toFortran(a), &lda, w, toFortran(work), &lwork, rwork, &info);
+    return info;
+  }
+
+  /**
+   * @brief Gets the rows and columns of a matrix argument after the operation.
+   * @param id The error identifier.
+   * @param dims The matrix dimensions.
+   * @param op The operation.
+   * @return The rows and columns.
+   */
+  [[nodiscard]] inline std::pair<std::size_t, std::size_t> getOpDims(const char*       id,
+                                                                     View<std::size_t> dims,
+                                                                     Transpose         op)
+  {
+    if (dims.size() > 2)
+    {
+      throw Exception{id, "matrix arguments must be 2-D"};
+    }
+
+    const std::size_t m = dims[0];
+    const std::size_t n = (dims.size() > 1) ? dims[1] : 1;
+
+    return (op == Transpose::none) ? std::pair{m, n} : std::pair{n, m};
+  }
+
+  /**
+   * @brief Gets the order of a square matrix argument.
+   * @param id The error identifier.
+   * @param dims The matrix dimensions.
+   * @return The order.
+   */
+  [[nodiscard]] inline std::size_t getSquareDim(const char* id, View<std::size_t> dims)
+  {
+    const auto [m, n] = getOpDims(id, dims, Transpose::none);
+
+    if (m != n)
+    {
+      throw Exception{id, "matrix must be square"};
+    }
+
+    return m;
+  }
+
+  /**
+   * @brief Throws if a LAPACK routine reported an illegal argument, which is a bug in the wrappers.
+   * @param id The error identifier.
+   * @param info The info value.
+   */
+  inline void checkArgumentInfo(const char* id, BlasInt info)
+  {
+    if (info < 0)
+    {
+      throw Exception{id, "illegal argument passed to LAPACK"};
+    }
+  }
+
+  /**
+   * @brief Gets the optimal ?syev/?heev workspace size. The query is made once per thread for each order, job and
+   *        triangle, repeated decompositions of equally sized matrices skip it.
+   * @tparam T The element type.
+   * @param jobz The job, 'N' for eigenvalues only or 'V' for eigenvectors too.
+   * @param uplo The referenced triangle.
+   * @param n The order.
+   * @return The workspace size in elements.
+   */
+  template<typename T>
+  [[nodiscard]] BlasInt getSyevWorkSize(char jobz, char uplo, BlasInt n)
+  {
+    thread_local std::unordered_map<std::uint64_t, BlasInt> cache{};
+
+    const std::uint64_t key = (static_cast<std::uint64_t>(n) << 16) | (static_cast<std::uint64_t>(jobz) << 8)
+                              | static_cast<std::uint64_t>(uplo);
+
+    if (auto it = cache.find(key); it != cache.end())
+    {
+      return it->second;
+    }
+
+    T           query{};
+    RealType<T> dummy{};
+
+    checkArgumentInfo("matlabw:mx:linalg:syev", syev(jobz, uplo, n, nullptr, std::max(n, BlasInt{1}), nullptr,
+                                                     &query, BlasInt{-1}, &dummy));
+
+    const BlasInt lwork = std::max(static_cast<BlasInt>(std::real(query)), BlasInt{1});
+
+    cache.emplace(key, lwork);
+
+    return lwork;
+  }
+
+  /**
+   * @brief Computes the eigenvalues and optionally the eigenvectors of a symmetric or Hermitian matrix in place.
+   * @tparam T The element type.
+   * @param arena The arena the workspace is allocated from.
+   * @param n The order.
+   * @param a The matrix, overwritten by the eigenvectors or destroyed.
+   * @param w The eigenvalues in ascending order, n elements.
+   * @param vectors Whether to compute the eigenvectors.
+   * @param uplo The referenced triangle.
+   */
+  template<typename T>
+  void decomposeSymmetric(Arena& arena, std::size_t n, T* a, RealType<T>* w, bool vectors, Uplo uplo)
+  {
+    static constexpr char id[]{"matlabw:mx:linalg:syev"};
+
+    const char    jobz  = vectors ? 'V' : 'N';
+    const BlasInt order = static_cast<BlasInt>(n);
+    const BlasInt lwork = getSyevWorkSize<T>(jobz, static_cast<char>(uplo), order);
+
+    T*           work  = arena.allocate<T>(static_cast<std::size_t>(lwork));
+    RealType<T>* rwork = nullptr;
+
+    if constexpr (!std::is_same_v<T, RealType<T>>)
+    {
+      rwork = arena.allocate<RealType<T>>(std::max<std::size_t>(3 * n, 3) - 2);
+    }
+
+    const BlasInt info = syev(jobz, static_cast<char>(uplo), order, a, toLeadingDim(n), w, work, lwork, rwork);
+
+    checkArgumentInfo(id, info);
+
+    if (info > 0)
+    {
+      throw Exception{id, "eigenvalue decomposition did not converge"};
+    }
+  }
+
+  /**
+   * @brief Solves A * X = B in place of B, A is destroyed by its LU factorization.
+   * @tparam T The element type.
+   * @param arena The arena the pivots are allocated from.
+   * @param n The order of A.
+   * @param nrhs The number of right-hand sides.
+   * @param a The matrix A.
+   * @param b The right-hand sides, overwritten by the solution.
+   */
+  template<typename T>
+  void solveGeneral(Arena& arena, std::size_t n, std::size_t nrhs, T* a, T* b)
+  {
+    static constexpr char id[]{"matlabw:mx:linalg:gesv"};
+
+    BlasInt* ipiv = arena.allocate<BlasInt>(n);
+
+    const BlasInt info = gesv(static_cast<BlasInt>(n), static_cast<BlasInt>(nrhs), a, toLeadingDim(n), ipiv, b,
+                              toLeadingDim(n));
+
+    checkArgumentInfo(id, info);
+
+    if (info > 0)
+    {
+      throw Exception{id, "matrix is singular"};
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Computes C = alpha * op(A) * op(B) + beta * C with MATLAB's BLAS.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The matrix A.
+   * @param b The matrix B.
+   * @param c The matrix C, of size rows(op(A)) x columns(op(B)).
+   * @param opA The operation applied to A.
+   * @param opB The operation applied to B.
+   * @param alpha The scalar alpha.
+   * @param beta The scalar beta, C is not read if 0.
+   */
+  template<typename T>
+  void gemm(const TypedArrayCref<T>& a,
+            const TypedArrayCref<T>& b,
+            const TypedArrayRef<T>&  c,
+            Transpose                opA   = Transpose::none,
+            Transpose                opB   = Transpose::none,
+            T                        alpha = T{1},
+            T                        beta  = T{})
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:linalg:gemm"};
+
+    const auto [m, k] = detail::getOpDims(id, a.getDims(), opA);
+    const auto [kb, n] = detail::getOpDims(id, b.getDims(), opB);
+    const auto [mc, nc] = detail::getOpDims(id, c.getDims(), Transpose::none);
+
+    if (k != kb || m != mc || n != nc)
+    {
+      throw Exception{id, "matrix dimensions do not agree"};
+    }
+
+    if (m == 0 || n == 0)
+    {
+      return;
+    }
+
+    detail::gemm(static_cast<char>(opA),
+                 static_cast<char>(opB),
+                 static_cast<detail::BlasInt>(m),
+                 static_cast<detail::BlasInt>(n),
+                 static_cast<detail::BlasInt>(k),
+                 &alpha,
+                 a.getData(),
+                 detail::toLeadingDim(a.getDims()[0]),
+                 b.getData(),
+                 detail::toLeadingDim(b.getDims()[0]),
+                 &beta,
+                 c.getData(),
+                 detail::toLeadingDim(m));
+  }
+
+  /**
+   * @brief Computes op(A) * op(B) with MATLAB's BLAS.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The matrix A.
+   * @param b The matrix B.
+   * @param opA The operation applied to A.
+   * @param opB The operation applied to B.
+   * @return The product, of size rows(op(A)) x columns(op(B)).
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> gemm(const TypedArrayCref<T>& a,
+                                     const TypedArrayCref<T>& b,
+                                     Transpose                opA = Transpose::none,
+                                     Transpose                opB = Transpose::none)
+  {
+    const std::size_t m = detail::getOpDims("matlabw:mx:linalg:gemm", a.getDims(), opA).first;
+    const std::size_t n = detail::getOpDims("matlabw:mx:linalg:gemm", b.getDims(), opB).second;
+
+    auto c = makeUninitNumericArray<T>(m, n);
+
+    gemm(a, b, TypedArrayRef<T>{ArrayRef{c}}, opA, opB);
+
+    return c;
+  }
+
+  /**
+   * @brief Computes y = alpha * op(A) * x + beta * y with MATLAB's BLAS.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The matrix A.
+   * @param x The vector x.
+   * @param y The vector y, of rows(op(A)) elements.
+   * @param opA The operation applied to A.
+   * @param alpha The scalar alpha.
+   * @param beta The scalar beta, y is not read if 0.
+   */
+  template<typename T>
+  void gemv(const TypedArrayCref<T>& a,
+            const TypedArrayCref<T>& x,
+            const TypedArrayRef<T>&  y,
+            Transpose                opA   = Transpose::none,
+            T                        alpha = T{1},
+            T                        beta  = T{})
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:linalg:gemv"};
+
+    const auto [m, n] = detail::getOpDims(id, a.getDims(), Transpose::none);
+    const auto [rows, cols] = detail::getOpDims(id, a.getDims(), opA);
+
+    if (x.getSize() != cols || y.getSize() != rows)
+    {
+      throw Exception{id, "matrix and vector dimensions do not agree"};
+    }
+
+    if (rows == 0)
+    {
+      return;
+    }
+
+    // BLAS returns early for an empty A without scaling y
+    if (cols == 0)
+    {
+      std::transform(y.getData(), y.getData() + rows, y.getData(), [beta](T v)
+      {
+        return (beta == T{}) ? T{} : beta * v;
+      });
+      return;
+    }
+
+    detail::gemv(static_cast<char>(opA),
+                 static_cast<detail::BlasInt>(m),
+                 static_cast<detail::BlasInt>(n),
+                 &alpha,
+                 a.getData(),
+                 detail::toLeadingDim(m),
+                 x.getData(),
+                 1,
+                 &beta,
+                 y.getData(),
+                 1);
+  }
+
+  /**
+   * @brief Computes op(A) * x with MATLAB's BLAS.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The matrix A.
+   * @param x The vector x.
+   * @param opA The operation applied to A.
+   * @return The product, a column vector of rows(op(A)) elements.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> gemv(const TypedArrayCref<T>& a,
+                                     const TypedArrayCref<T>& x,
+                                     Transpose                opA = Transpose::none)
+  {
+    const std::size_t rows = detail::getOpDims("matlabw:mx:linalg:gemv", a.getDims(), opA).first;
+
+    auto y = makeUninitNumericArray<T>(rows, 1);
+
+    gemv(a, x, TypedArrayRef<T>{ArrayRef{y}}, opA);
+
+    return y;
+  }
+
+  /**
+   * @brief Computes the rank-k update C = alpha * op(A) * op(A).' + beta * C of a symmetric matrix with MATLAB's
+   *        BLAS. Only the referenced triangle of C is read and written.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The matrix A.
+   * @param c The symmetric matrix C, of size rows(op(A)) x rows(op(A)).
+   * @param opA The operation applied to A, the conjugate transpose is not supported.
+   * @param uplo The referenced triangle of C.
+   * @param alpha The scalar alpha.
+   * @param beta The scalar beta, C is not read if 0.
+   */
+  template<typename T>
+  void syrk(const TypedArrayCref<T>& a,
+            const TypedArrayRef<T>&  c,
+            Transpose                opA   = Transpose::none,
+            Uplo                     uplo  = Uplo::lower,
+            T                        alpha = T{1},
+            T                        beta  = T{})
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:linalg:syrk"};
+
+    if (opA == Transpose::conjugate)
+    {
+      throw Exception{id, "conjugate transpose is not supported"};
+    }
+
+    const auto [n, k] = detail::getOpDims(id, a.getDims(), opA);
+
+    if (detail::getSquareDim(id, c.getDims()) != n)
+    {
+      throw Exception{id, "matrix dimensions do not agree"};
+    }
+
+    if (n == 0)
+    {
+      return;
+    }
+
+    detail::syrk(static_cast<char>(uplo),
+                 static_cast<char>(opA),
+                 static_cast<detail::BlasInt>(n),
+                 static_cast<detail::BlasInt>(k),
+                 &alpha,
+                 a.getData(),
+                 detail::toLeadingDim(a.getDims()[0]),
+                 &beta,
+                 c.getData(),
+                 detail::toLeadingDim(n));
+  }
+
+  /**
+   * @brief Computes op(A) * op(A).' with MATLAB's BLAS, the computed triangle is mirrored to the full matrix.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The matrix A.
+   * @param opA The operation applied to A, the conjugate transpose is not supported.
+   * @return The symmetric product, of size rows(op(A)) x rows(op(A)).
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> syrk(const TypedArrayCref<T>& a, Transpose opA = Transpose::none)
+  {
+    const std::size_t n = detail::getOpDims("matlabw:mx:linalg:syrk", a.getDims(), opA).first;
+
+    auto c = makeUninitNumericArray<T>(n, n);
+
+    syrk(a, TypedArrayRef<T>{ArrayRef{c}}, opA, Uplo::lower);
+
+    T* data = c.getData();
+
+    for (std::size_t j{}; j < n; ++j)
+    {
+      for (std::size_t i{j + 1}; i < n; ++i)
+      {
+        data[j + i * n] = data[i + j * n];
+      }
+    }
+
+    return c;
+  }
+
+  /**
+   * @brief Solves A * X = B with MATLAB's LAPACK, B is overwritten by the solution. A is copied to the arena and
+   *        left intact, in a MEX function pass mex::getScratchArena().
+   * @tparam T The element type, float, double or their complex types.
+   * @param arena The arena the LU factorization and the pivots are allocated from.
+   * @param a The square matrix A.
+   * @param b The right-hand sides B, with as many rows as A.
+   */
+  template<typename T>
+  void gesv(Arena& arena, const TypedArrayCref<T>& a, const TypedArrayRef<T>& b)
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:linalg:gesv"};
+
+    const std::size_t n = detail::getSquareDim(id, a.getDims());
+    const auto [mb, nrhs] = detail::getOpDims(id, b.getDims(), Transpose::none);
+
+    if (mb != n)
+    {
+      throw Exception{id, "matrix dimensions do not agree"};
+    }
+
+    if (n == 0 || nrhs == 0)
+    {
+      return;
+    }
+
+    T* lu = arena.allocate<T>(n * n);
+
+    std::copy_n(a.getData(), n * n, lu);
+
+    detail::solveGeneral(arena, n, nrhs, lu, b.getData());
+  }
+
+  /**
+   * @brief Solves A * X = B with MATLAB's LAPACK, in a MEX function pass mex::getScratchArena().
+   * @tparam T The element type, float, double or their complex types.
+   * @param arena The arena the LU factorization and the pivots are allocated from.
+   * @param a The square matrix A.
+   * @param b The right-hand sides B, with as many rows as A.
+   * @return The solution X, of the size of B.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> gesv(Arena& arena, const TypedArrayCref<T>& a, const TypedArrayCref<T>& b)
+  {
+    auto x = makeUninitNumericArray<T>(b.getDims());
+
+    std::copy_n(b.getData(), b.getSize(), x.getData());
+
+    gesv(arena, a, TypedArrayRef<T>{ArrayRef{x}});
+
+    return x;
+  }
+
+  /**
+   * @brief Computes the Cholesky factorization of a Hermitian positive definite matrix in place with MATLAB's
+   *        LAPACK. Only the referenced triangle is read and overwritten by the factor, the other is left intact.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The square matrix A.
+   * @param uplo The referenced triangle, A = U' * U for the upper and A = L * L' for the lower.
+   */
+  template<typename T>
+  void potrf(const TypedArrayRef<T>& a, Uplo uplo = Uplo::upper)
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:linalg:potrf"};
+
+    const std::size_t n = detail::getSquareDim(id, a.getDims());
+
+    if (n == 0)
+    {
+      return;
+    }
+
+    const detail::BlasInt info = detail::potrf(static_cast<char>(uplo),
+                                               static_cast<detail::BlasInt>(n),
+                                               a.getData(),
+                                               detail::toLeadingDim(n));
+
+    detail::checkArgumentInfo(id, info);
+
+    if (info > 0)
+    {
+      throw Exception{id, "matrix is not positive definite"};
+    }
+  }
+
+  /**
+   * @brief Computes the Cholesky factor of a Hermitian positive definite matrix with MATLAB's LAPACK, like chol.
+   * @tparam T The element type, float, double or their complex types.
+   * @param a The square matrix A.
+   * @param uplo The computed factor, U with A = U' * U or L with A = L * L'.
+   * @return The triangular factor, the other triangle is zero.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<T> potrf(const TypedArrayCref<T>& a, Uplo uplo = Uplo::upper)
+  {
+    const std::size_t n = detail::getSquareDim("matlabw:mx:linalg:potrf", a.getDims());
+
+    auto r = makeUninitNumericArray<T>(n, n);
+
+    std::copy_n(a.getData(), n * n, r.getData());
+
+    potrf(TypedArrayRef<T>{ArrayRef{r}}, uplo);
+
+    T* data = r.getData();
+
+    for (std::size_t j{}; j < n; ++j)
+    {
+      if (uplo == Uplo::upper)
+      {
+        std::fill(data + j * n + j + 1, data + (j + 1) * n, T{});
+      }
+      else
+      {
+        std::fill(data + j * n, data + j * n + j, T{});
+      }
+    }
+
+    return r;
+  }
+
+  /**
+   * @brief Computes the eigenvalues and optionally the eigenvectors of a symmetric or Hermitian matrix in place with
+   *        MATLAB's LAPACK (?syev or ?heev). The optimal workspace size is queried once per thread and order, the
+   *        workspace is allocated from the arena, in a MEX function pass mex::getScratchArena().
+   * @tparam T The element type, float, double or their complex types.
+   * @param arena The arena the workspace is allocated from.
+   * @param a The square matrix A, overwritten by the orthonormal eigenvectors in columns or destroyed.
+   * @param w The eigenvalues in ascending order, of rows(A) elements.
+   * @param vectors Whether to compute the eigenvectors.
+   * @param uplo The referenced triangle of A.
+   */
+  template<typename T>
+  void syev(Arena&                                    arena,
+            const TypedArrayRef<T>&                   a,
+            const TypedArrayRef<detail::RealType<T>>& w,
+            bool                                      vectors = true,
+            Uplo                                      uplo    = Uplo::lower)
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    static constexpr char id[]{"matlabw:mx:linalg:syev"};
+
+    const std::size_t n = detail::getSquareDim(id, a.getDims());
+
+    if (w.getSize() != n)
+    {
+      throw Exception{id, "matrix and vector dimensions do not agree"};
+    }
+
+    if (n == 0)
+    {
+      return;
+    }
+
+    detail::decomposeSymmetric(arena, n, a.getData(), w.getData(), vectors, uplo);
+  }
+
+  /**
+   * @brief Computes the eigenvalues of a symmetric or Hermitian matrix with MATLAB's LAPACK (?syev or ?heev). A is
+   *        copied to the arena and left intact, in a MEX function pass mex::getScratchArena().
+   * @tparam T The element type, float, double or their complex types.
+   * @param arena The arena the copy of A and the workspace are allocated from.
+   * @param a The square matrix A.
+   * @param uplo The referenced triangle of A.
+   * @return The real eigenvalues in ascending order, a column vector of rows(A) elements.
+   */
+  template<typename T>
+  [[nodiscard]] NumericArray<detail::RealType<T>> syev(Arena&                   arena,
+                                                       const TypedArrayCref<T>& a,
+                                                       Uplo                     uplo = Uplo::lower)
+  {
+    static_assert(detail::isBlasType<T>, "unsupported element type");
+
+    const std::size_t n = detail::getSquareDim("matlabw:mx:linalg:syev", a.getDims());
+
+    auto w = makeUninitNumericArray<detail::RealType<T>>(n, 1);
+
+    if (n != 0)
+    {
+      T* copy = arena.allocate<T>(n * n);
+
+      std::copy_n(a.getData(), n * n, copy);
+
+      detail::decomposeSymmetric(arena, n, copy, w.getData(), false, uplo);
+    }
+
+    return w;
+  }
+} // namespace matlabw::mx::linalg
+
+#endif /* MATLABW_MX_LINALG_HPP */
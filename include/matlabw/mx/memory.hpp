@@ -27,6 +27,12 @@
 
 #include "detail/include.hpp"
 
+#include "AllocStats.hpp"
+
+#ifdef __linux__
+# include <sys/mman.h>
+#endif
+
 namespace matlabw::mx
 {
   /**
@@ -36,7 +42,11 @@ namespace matlabw::mx
    */
   [[nodiscard]] inline void* malloc(std::size_t sizeInBytes)
   {
-    return mxMalloc(sizeInBytes);
+    void* ptr = mxMalloc(sizeInBytes);
+
+    detail::recordAllocation(ptr, sizeInBytes);
+
+    return ptr;
   }
 
   /**
@@ -47,7 +57,11 @@ namespace matlabw::mx
   template<typename T>
   [[nodiscard]] inline T* calloc(std::size_t n)
   {
-    return static_cast<T*>(mxCalloc(n, sizeof(T)));
+    T* ptr = static_cast<T*>(mxCalloc(n, sizeof(T)));
+
+    detail::recordAllocation(ptr, n * sizeof(T));
+
+    return ptr;
   }
 
   /**
@@ -56,6 +70,8 @@ namespace matlabw::mx
    */
   inline void free(void* ptr)
   {
+    detail::recordFree(ptr);
+
     mxFree(ptr);
   }
 
@@ -129,6 +145,182 @@ namespace matlabw::mx
       free(ptr);
     }
   };
+
+  /// @brief Size of a transparent huge page in bytes.
+  inline constexpr std::size_t hugePageSize{2 * 1024 * 1024};
+
+  /**
+   * @brief Checks if a pointer is aligned.
+   * @param ptr The pointer.
+   * @param alignment The alignment, must be a power of two.
+   * @return True if the pointer is aligned, false otherwise.
+   */
+  [[nodiscard]] inline bool isAligned(const void* ptr, std::size_t alignment) noexcept
+  {
+    return (reinterpret_cast<std::uintptr_t>(ptr) & (alignment - 1)) == 0;
+  }
+
+  /**
+   * @brief Allocates aligned memory. The memory must be freed with alignedFree.
+   * @param sizeInBytes The size of the memory to allocate in bytes.
+   * @param alignment The alignment, must be a power of two.
+   * @return A pointer to the allocated memory or nullptr on failure.
+   */
+  [[nodiscard]] inline void* alignedMalloc(std::size_t sizeInBytes, std::size_t alignment)
+  {
+    alignment = std::max(alignment, alignof(void*));
+
+    if (sizeInBytes > std::numeric_limits<std::size_t>::max() - alignment - sizeof(void*))
+    {
+      return nullptr;
+    }
+
+    void* base = malloc(sizeInBytes + alignment + sizeof(void*));
+
+    if (base == nullptr)
+    {
+      return nullptr;
+    }
+
+    // The original pointer is stored right in front of the aligned block.
+    const auto addr    = reinterpret_cast<std::uintptr_t>(base) + sizeof(void*);
+    const auto aligned = (addr + (alignment - 1)) & ~(std::uintptr_t{alignment} - 1);
+
+    reinterpret_cast<void**>(aligned)[-1] = base;
+
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  /**
+   * @brief Frees memory allocated with alignedMalloc.
+   * @param ptr A pointer to the allocated memory. May be nullptr.
+   */
+  inline void alignedFree(void* ptr)
+  {
+    if (ptr != nullptr)
+    {
+      free(static_cast<void**>(ptr)[-1]);
+    }
+  }
+
+  /**
+   * @brief Advises the operating system to back the memory range with transparent huge pages. Only the whole huge
+   *        pages inside the range are affected. Does nothing on platforms without transparent huge pages.
+   * @param ptr A pointer to the memory.
+   * @param sizeInBytes The size of the memory in bytes.
+   */
+  inline void adviseHugePages([[maybe_unused]] void* ptr, [[maybe_unused]] std::size_t sizeInBytes) noexcept
+  {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    const auto begin = (reinterpret_cast<std::uintptr_t>(ptr) + (hugePageSize - 1)) & ~(hugePageSize - 1);
+    const auto end   = (reinterpret_cast<std::uintptr_t>(ptr) + sizeInBytes) & ~(hugePageSize - 1);
+
+    if (begin < end)
+    {
+      // The advice is only a hint, failure is not an error.
+      static_cast<void>(madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE));
+    }
+#endif
+  }
+
+  /**
+   * @brief A deleter for freeing memory allocated with alignedMalloc.
+   */
+  struct AlignedDeleter
+  {
+    /**
+     * @brief Frees the allocated memory.
+     * @tparam T The type of the allocated memory.
+     * @param ptr A pointer to the allocated memory.
+     */
+    template<typename T>
+    void operator()(T* ptr) const
+    {
+      alignedFree((void*)ptr); // use C-style cast to avoid complicated casting as it does not matter here
+    }
+  };
+
+  /**
+   * @brief Aligned allocator for use with std containers. Allocations of at least hugePageSize bytes are advised to
+   *        be backed by transparent huge pages.
+   * @tparam T The type of the allocated memory.
+   * @tparam Align The alignment in bytes, must be a power of two.
+   */
+  template<typename T, std::size_t Align = 64>
+  class AlignedAllocator
+  {
+    static_assert(std::has_single_bit(Align), "Align must be a power of two");
+    static_assert(Align >= alignof(T), "Align must not be smaller than the alignment of T");
+
+    public:
+      using value_type = T; ///< The type of the allocated memory.
+
+      /// @brief Rebinds the allocator to another type.
+      template<typename U>
+      struct rebind
+      {
+        using other = AlignedAllocator<U, Align>; ///< The rebound allocator type.
+      };
+
+      /// @brief Default constructor.
+      AlignedAllocator() noexcept = default;
+
+      /**
+       * @brief Copy constructor.
+       * @tparam U The type of the allocated memory.
+       * @param other The allocator to copy.
+       */
+      template<typename U>
+      AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+      /**
+       * @brief Allocates memory.
+       * @param n The number of elements to allocate.
+       * @return A pointer to the allocated memory.
+       */
+      T* allocate(std::size_t n)
+      {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+          throw std::bad_alloc();
+        }
+
+        T* ptr = static_cast<T*>(alignedMalloc(n * sizeof(T), Align));
+
+        if (!ptr)
+        {
+          throw std::bad_alloc();
+        }
+
+        if (n * sizeof(T) >= hugePageSize)
+        {
+          adviseHugePages(ptr, n * sizeof(T));
+        }
+
+        return ptr;
+      }
+
+      /**
+       * @brief Deallocates memory.
+       * @param ptr A pointer to the allocated memory.
+       * @param n The number of elements to deallocate.
+       */
+      void deallocate(T* ptr, std::size_t) noexcept
+      {
+        alignedFree(ptr);
+      }
+
+      /**
+       * @brief Compares two allocators. All aligned allocators with equal alignment are equal.
+       * @tparam U The type of the other allocator.
+       * @return Always true.
+       */
+      template<typename U>
+      [[nodiscard]] bool operator==(const AlignedAllocator<U, Align>&) const noexcept
+      {
+        return true;
+      }
+  };
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_MEMORY_HPP */
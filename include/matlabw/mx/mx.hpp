@@ -31,33 +31,63 @@
 # error "This library requires MATLAB R2018a or later."
 #endif
 
+#include "AllocStats.hpp"
+#include "Arena.hpp"
 #include "Array.hpp"
+#include "ArrayDesc.hpp"
 #include "ArrayRef.hpp"
+#include "ArraySlice.hpp"
+#include "ArraySnapshot.hpp"
+#include "ArrayTreeSnapshot.hpp"
 #include "CellArray.hpp"
 #include "CellArrayRef.hpp"
 #include "CharArray.hpp"
 #include "CharArrayRef.hpp"
+#include "cleanup.hpp"
+#include "codec.hpp"
 #include "common.hpp"
+#include "cpu.hpp"
+#include "Dims.hpp"
 #include "Exception.hpp"
+#include "FieldSchema.hpp"
+#include "FileBackedArray.hpp"
+#include "hash.hpp"
 #include "limits.hpp"
 #include "LogicalArray.hpp"
+#include "MdSpan.hpp"
 #include "memory.hpp"
 #include "NumericArray.hpp"
 #include "NumericArrayRef.hpp"
 #include "ObjectArray.hpp"
+#include "PerfCounters.hpp"
+#include "Profiler.hpp"
 #include "propery.hpp"
+#include "PropertyTable.hpp"
+#include "random.hpp"
+#include "serialize.hpp"
+#include "SharedArray.hpp"
+#include "SharedMemoryArray.hpp"
+#include "SparseArray.hpp"
+#include "StaticShape.hpp"
 #include "StructArray.hpp"
 #include "StructArrayRef.hpp"
+#include "StructBuilder.hpp"
 #include "TypedArray.hpp"
 #include "TypedArrayRef.hpp"
 #include "typeTraits.hpp"
 #include "visit.hpp"
+#include "Workspace.hpp"
 
 #ifdef MATLABW_ENABLE_GPU
 # include "gpu/Array.hpp"
+# include "gpu/BorrowedArray.hpp"
 # include "gpu/init.hpp"
 # include "gpu/NumericArray.hpp"
 # include "gpu/TypedArray.hpp"
 #endif
 
+#ifdef MATLABW_ENABLE_LAPACK
+# include "linalg.hpp"
+#endif
+
 #endif /* MATLABW_MX_MX_HPP */
@@ -0,0 +1,291 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_PARALLEL_ACCUMULATOR_HPP
+#define MATLABW_MX_PARALLEL_ACCUMULATOR_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+#include <memory>
+
+#include "../algorithm/detail/span.hpp"
+#include "../Exception.hpp"
+#include "parallelFor.hpp"
+#include "ThreadPool.hpp"
+
+namespace matlabw::mx::parallel
+{
+  /// @brief Strategy of a ConcurrentAccumulator.
+  enum class AccumulatorMode
+  {
+    automatic,  ///< Privatized if the copies fit the memory budget and updates are not sparse, sharded otherwise.
+    privatized, ///< Every thread adds to its own copy of the output without synchronization.
+    sharded,    ///< Threads add atomically to a few shared replicas, the output itself being the first one.
+  };
+
+  /// @brief Options of a ConcurrentAccumulator.
+  struct AccumulatorOptions
+  {
+    AccumulatorMode mode{AccumulatorMode::automatic};    ///< The strategy.
+    std::size_t     memoryBudget{std::size_t{64} << 20}; ///< Maximum size of all copies or replicas in bytes.
+    std::size_t     expectedUpdates{};                   ///< Expected number of updates, 0 if unknown.
+  };
+
+  /**
+   * @brief Accumulates scattered updates of parallel loops into an output, like accumarray or a histogram in MATLAB.
+   *        In privatized mode every thread of the pool lazily allocates a zeroed copy of the output on its first
+   *        update, so the copy is first touched by its thread, and adds to it without synchronization. In sharded
+   *        mode the threads add atomically to shared replicas, which costs less memory and merge time when the output
+   *        is large or the updates are sparse, spreading threads over several replicas reduces the contention on hot
+   *        elements. merge() adds the copies to the output with a parallel pairwise tree. Updates can be added from
+   *        the workers of the thread pool and from one other thread.
+   * @tparam T Element type, an arithmetic type other than bool.
+   */
+  template<typename T>
+  class ConcurrentAccumulator
+  {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "T must be an arithmetic type other than bool");
+
+    public:
+      /// @brief The value type.
+      using ValueType = T;
+
+      /**
+       * @brief Constructor. The updates are added to the existing values of the output.
+       * @param output The output, must stay valid until merge() returns.
+       * @param options The options.
+       * @param pool The thread pool whose workers add the updates and which merges the copies.
+       */
+      explicit ConcurrentAccumulator(Span<T>                   output,
+                                     const AccumulatorOptions& options = {},
+                                     ThreadPool&               pool    = getThreadPool())
+      : mOutput{output},
+        mPool{&pool},
+        mSlots(pool.getThreadCount() + 1)
+      {
+        const std::size_t participantCount = mSlots.size();
+        const std::size_t bytes            = std::max<std::size_t>(1, output.size() * sizeof(T));
+        const std::size_t copyBudget       = options.memoryBudget / bytes;
+
+        mMode = options.mode;
+
+        if (mMode == AccumulatorMode::automatic)
+        {
+          const bool fits   = copyBudget >= participantCount;
+          const bool sparse = options.expectedUpdates != 0 && options.expectedUpdates < output.size();
+
+          mMode = (fits && !sparse) ? AccumulatorMode::privatized : AccumulatorMode::sharded;
+        }
+
+        if (mMode == AccumulatorMode::sharded)
+        {
+          // Sparse updates rarely collide, extra replicas would only add merge work.
+          const bool sparse = options.expectedUpdates != 0 && options.expectedUpdates < output.size();
+
+          mReplicaCount = (sparse) ? 1 : std::clamp<std::size_t>(copyBudget, 1, participantCount);
+
+          for (std::size_t r{1}; r < mReplicaCount; ++r)
+          {
+            mSlots[r].data = std::make_unique<T[]>(output.size());
+          }
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      ConcurrentAccumulator(const ConcurrentAccumulator&) = delete;
+
+      /// @brief Default move constructor.
+      ConcurrentAccumulator(ConcurrentAccumulator&&) = default;
+
+      /// @brief Default destructor.
+      ~ConcurrentAccumulator() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ConcurrentAccumulator& operator=(const ConcurrentAccumulator&) = delete;
+
+      /// @brief Default move assignment operator.
+      ConcurrentAccumulator& operator=(ConcurrentAccumulator&&) = default;
+
+      /**
+       * @brief Gets the strategy, never automatic.
+       * @return The strategy.
+       */
+      [[nodiscard]] AccumulatorMode getMode() const noexcept
+      {
+        return mMode;
+      }
+
+      /**
+       * @brief Gets the number of elements of the output.
+       * @return The number of elements.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mOutput.size();
+      }
+
+      /**
+       * @brief Adds a value to an element.
+       * @param i The zero-based index of the element.
+       * @param value The value.
+       */
+      void add(std::size_t i, const T& value)
+      {
+        if (i >= mOutput.size())
+        {
+          throw Exception{"matlabw:mx:ConcurrentAccumulator:add", "index out of range"};
+        }
+
+        const std::size_t slot = mPool->getWorkerIndex().value_or(mSlots.size() - 1);
+
+        if (mMode == AccumulatorMode::privatized)
+        {
+          std::unique_ptr<T[]>& data = mSlots[slot].data;
+
+          if (data == nullptr)
+          {
+            data = std::make_unique<T[]>(mOutput.size());
+          }
+
+          data[i] += value;
+        }
+        else
+        {
+          const std::size_t replica = slot % mReplicaCount;
+          T*                data    = (replica == 0) ? mOutput.data() : mSlots[replica].data.get();
+
+          std::atomic_ref<T>{data[i]}.fetch_add(value, std::memory_order_relaxed);
+        }
+      }
+
+      /**
+       * @brief Adds one to an element, e.g. a bin of a histogram.
+       * @param i The zero-based index of the element.
+       */
+      void increment(std::size_t i)
+      {
+        add(i, T{1});
+      }
+
+      /**
+       * @brief Adds the copies to the output and releases them, the accumulator can be used again afterwards. Must be
+       *        called once no thread adds updates anymore, not from a worker of the pool.
+       */
+      void merge()
+      {
+        std::vector<T*> copies{};
+
+        for (Slot& slot : mSlots)
+        {
+          if (slot.data != nullptr)
+          {
+            copies.push_back(slot.data.get());
+          }
+        }
+
+        const std::size_t size       = mOutput.size();
+        const std::size_t blockCount = (size + mergeBlockSize - 1) / mergeBlockSize;
+
+        const auto addBlock = [&](T* dst, const T* src, std::size_t block)
+        {
+          const std::size_t first = block * mergeBlockSize;
+          const std::size_t last  = std::min(size, first + mergeBlockSize);
+
+          for (std::size_t i{first}; i < last; ++i)
+          {
+            dst[i] += src[i];
+          }
+        };
+
+        // Every round adds copy i + stride to copy i for all pairs at once, block by block.
+        for (std::size_t stride{1}; stride < copies.size(); stride *= 2)
+        {
+          const std::size_t pairCount = (copies.size() - stride + 2 * stride - 1) / (2 * stride);
+
+          parallelFor(0, pairCount * blockCount, 1, [&](std::size_t job)
+          {
+            const std::size_t first = job / blockCount * 2 * stride;
+
+            addBlock(copies[first], copies[first + stride], job % blockCount);
+          }, *mPool);
+        }
+
+        if (!copies.empty())
+        {
+          parallelFor(0, blockCount, 1, [&](std::size_t block)
+          {
+            addBlock(mOutput.data(), copies.front(), block);
+          }, *mPool);
+        }
+
+        // Copies are allocated again on first touch, replicas are kept for the next round.
+        for (Slot& slot : mSlots)
+        {
+          if (mMode == AccumulatorMode::privatized)
+          {
+            slot.data.reset();
+          }
+          else if (slot.data != nullptr)
+          {
+            std::fill_n(slot.data.get(), size, T{});
+          }
+        }
+      }
+    private:
+      /// @brief Number of elements merged by one task.
+      static constexpr std::size_t mergeBlockSize{16384};
+
+      /// @brief Copy or replica of one slot, aligned to a cache line to avoid false sharing.
+      struct alignas(64) Slot
+      {
+        std::unique_ptr<T[]> data{}; ///< The copy, null if not allocated.
+      };
+
+      Span<T>           mOutput{};                          ///< The output.
+      ThreadPool*       mPool{};                            ///< The thread pool.
+      AccumulatorMode   mMode{AccumulatorMode::privatized}; ///< The strategy.
+      std::size_t       mReplicaCount{1};                   ///< Number of replicas in sharded mode.
+      std::vector<Slot> mSlots{};                           ///< Copies of the workers followed by the other thread's.
+  };
+
+  /**
+   * @brief Creates a ConcurrentAccumulator of an array.
+   * @tparam A Array type (TypedArrayRef, TypedArray, span, ...)
+   * @param output The output.
+   * @param options The options.
+   * @param pool The thread pool.
+   * @return The accumulator.
+   */
+  template<typename A>
+  [[nodiscard]] auto makeConcurrentAccumulator(A&&                       output,
+                                               const AccumulatorOptions& options = {},
+                                               ThreadPool&               pool    = getThreadPool())
+  {
+    auto span = algorithm::detail::toSpan(output);
+
+    return ConcurrentAccumulator<typename decltype(span)::element_type>{span, options, pool};
+  }
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_ACCUMULATOR_HPP */
@@ -0,0 +1,130 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_MPSC_QUEUE_HPP
+#define MATLABW_MX_PARALLEL_MPSC_QUEUE_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+
+namespace matlabw::mx::parallel
+{
+  /**
+   * @brief Unbounded lock-free multiple-producer single-consumer queue. Pushing is wait-free (one atomic exchange),
+   *        popping must be done by a single thread at a time. Nodes are allocated with operator new, never with the
+   *        MATLAB allocator, so any thread may push.
+   * @tparam T Element type.
+   */
+  template<typename T>
+  class MpscQueue
+  {
+    public:
+      /// @brief Default constructor.
+      MpscQueue()
+        : mTail{new Node{}}
+      {
+        mHead.store(mTail, std::memory_order_relaxed);
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      MpscQueue(const MpscQueue&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      MpscQueue(MpscQueue&&) = delete;
+
+      /// @brief Destructor. Destroys the remaining elements.
+      ~MpscQueue() noexcept
+      {
+        while (mTail != nullptr)
+        {
+          Node* next = mTail->next.load(std::memory_order_relaxed);
+          delete mTail;
+          mTail = next;
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      MpscQueue& operator=(const MpscQueue&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      MpscQueue& operator=(MpscQueue&&) = delete;
+
+      /**
+       * @brief Pushes an element. May be called from any thread.
+       * @param value The element.
+       */
+      void push(T value)
+      {
+        Node* node = new Node{std::move(value)};
+        Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+
+        prev->next.store(node, std::memory_order_release);
+      }
+
+      /**
+       * @brief Pops the oldest element. Must be called by one thread at a time. An element whose push is still in
+       *        progress may be missed and is returned by a later call.
+       * @return The element or std::nullopt if the queue is empty.
+       */
+      [[nodiscard]] std::optional<T> pop()
+      {
+        Node* next = mTail->next.load(std::memory_order_acquire);
+
+        if (next == nullptr)
+        {
+          return std::nullopt;
+        }
+
+        std::optional<T> value{std::move(next->value)};
+        next->value.reset();
+
+        delete mTail;
+        mTail = next;
+
+        return value;
+      }
+
+      /**
+       * @brief Checks if the queue is empty. Must be called by the consuming thread.
+       * @return True if no element is ready to be popped.
+       */
+      [[nodiscard]] bool isEmpty() const noexcept
+      {
+        return mTail->next.load(std::memory_order_acquire) == nullptr;
+      }
+    private:
+      /// @brief Queue node, the consumer's tail node is always a node whose value was taken.
+      struct Node
+      {
+        std::optional<T>   value{}; ///< The element.
+        std::atomic<Node*> next{};  ///< Next node.
+      };
+
+      std::atomic<Node*> mHead{}; ///< Last pushed node.
+      Node*              mTail{}; ///< Last popped node.
+  };
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_MPSC_QUEUE_HPP */
@@ -0,0 +1,116 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_PARALLEL_RANDOM_STREAMS_HPP
+#define MATLABW_MX_PARALLEL_RANDOM_STREAMS_HPP
+
+#include "../detail/include.hpp"
+
+#include <vector>
+
+#include "../random.hpp"
+#include "ThreadPool.hpp"
+
+namespace matlabw::mx::parallel
+{
+  /**
+   * @brief Random number generators of the threads of a pool, substreams 0 to getThreadCount() - 1 of a parent
+   *        generator for the workers and substream getThreadCount() for the threads outside of the pool. Every thread
+   *        draws from its own generator without locking. The values drawn by a worker depend only on the indices it
+   *        processes, so loops with the static partition, parallelForStatic(), are reproducible. Loops balanced by
+   *        work stealing should draw from parent.getSubstream(i) of the loop index instead.
+   */
+  class RandomStreams
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param parent The parent generator, its state is not changed.
+       * @param pool The thread pool.
+       */
+      explicit RandomStreams(const Philox& parent, ThreadPool& pool = getThreadPool())
+      : mPool{&pool}
+      {
+        mSlots.reserve(pool.getThreadCount() + 1);
+
+        for (std::size_t i{}; i <= pool.getThreadCount(); ++i)
+        {
+          mSlots.push_back(Slot{parent.getSubstream(i)});
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      RandomStreams(const RandomStreams&) = delete;
+
+      /// @brief Default move constructor.
+      RandomStreams(RandomStreams&&) = default;
+
+      /// @brief Default destructor.
+      ~RandomStreams() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      RandomStreams& operator=(const RandomStreams&) = delete;
+
+      /// @brief Default move assignment operator.
+      RandomStreams& operator=(RandomStreams&&) = default;
+
+      /**
+       * @brief Gets the generator of the calling thread.
+       * @return The generator.
+       */
+      [[nodiscard]] Philox& get() noexcept
+      {
+        return mSlots[mPool->getWorkerIndex().value_or(mSlots.size() - 1)].rng;
+      }
+
+      /**
+       * @brief Gets the generator of a slot.
+       * @param index Worker index, getThreadCount() for the threads outside of the pool.
+       * @return The generator.
+       */
+      [[nodiscard]] Philox& get(std::size_t index)
+      {
+        return mSlots.at(index).rng;
+      }
+
+      /**
+       * @brief Gets the number of generators.
+       * @return The number of generators, the number of workers plus one.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSlots.size();
+      }
+    private:
+      /// @brief Generator of a thread, on its own cache line so threads do not share lines.
+      struct alignas(64) Slot
+      {
+        Philox rng; ///< The generator.
+      };
+
+      ThreadPool*       mPool{};  ///< The thread pool.
+      std::vector<Slot> mSlots{}; ///< Generators of the pool workers followed by the one of the other threads.
+  };
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_RANDOM_STREAMS_HPP */
@@ -0,0 +1,156 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_RING_QUEUE_HPP
+#define MATLABW_MX_PARALLEL_RING_QUEUE_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+
+namespace matlabw::mx::parallel
+{
+  /**
+   * @brief Bounded lock-free multiple-producer single-consumer ring queue. Pushing never blocks and never allocates,
+   *        it fails when the queue is full. Each slot carries a sequence number, so producers only contend on one
+   *        atomic counter. Popping must be done by a single thread at a time.
+   * @tparam T Element type, must be trivially copyable.
+   */
+  template<typename T>
+  class RingQueue
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "element type must be trivially copyable");
+
+    public:
+      /**
+       * @brief Constructor.
+       * @param capacity The minimum number of elements, rounded up to a power of two.
+       */
+      explicit RingQueue(std::size_t capacity)
+      : mMask{std::bit_ceil(std::max(capacity, std::size_t{2})) - 1},
+        mSlots{std::make_unique<Slot[]>(mMask + 1)}
+      {
+        for (std::size_t i{}; i <= mMask; ++i)
+        {
+          mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      RingQueue(const RingQueue&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      RingQueue(RingQueue&&) = delete;
+
+      /// @brief Destructor.
+      ~RingQueue() noexcept = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      RingQueue& operator=(const RingQueue&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      RingQueue& operator=(RingQueue&&) = delete;
+
+      /**
+       * @brief Gets the capacity.
+       * @return The maximum number of elements.
+       */
+      [[nodiscard]] std::size_t getCapacity() const noexcept
+      {
+        return mMask + 1;
+      }
+
+      /**
+       * @brief Pushes an element. May be called from any thread.
+       * @param value The element.
+       * @return True if the element was pushed, false if the queue is full.
+       */
+      bool tryPush(const T& value) noexcept
+      {
+        std::size_t pos = mPushPos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+          Slot&             slot     = mSlots[pos & mMask];
+          const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+          const auto        diff     = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+          if (diff == 0)
+          {
+            if (mPushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+              slot.value = value;
+              slot.sequence.store(pos + 1, std::memory_order_release);
+
+              return true;
+            }
+          }
+          else if (diff < 0)
+          {
+            return false;
+          }
+          else
+          {
+            pos = mPushPos.load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+      /**
+       * @brief Pops the oldest element. Must be called by one thread at a time.
+       * @param value The popped element.
+       * @return True if an element was popped, false if no element is ready.
+       */
+      bool tryPop(T& value) noexcept
+      {
+        Slot&             slot     = mSlots[mPopPos & mMask];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence != mPopPos + 1)
+        {
+          return false;
+        }
+
+        value = slot.value;
+        slot.sequence.store(mPopPos + mMask + 1, std::memory_order_release);
+        ++mPopPos;
+
+        return true;
+      }
+    private:
+      /// @brief Slot of the ring, the sequence tells whether it is free or holds an element of the current round.
+      struct Slot
+      {
+        std::atomic<std::size_t> sequence{}; ///< The sequence number.
+        T                        value{};    ///< The element.
+      };
+
+      std::size_t                          mMask;      ///< Capacity minus one.
+      std::unique_ptr<Slot[]>              mSlots;     ///< The slots.
+      alignas(64) std::atomic<std::size_t> mPushPos{}; ///< The next push position.
+      alignas(64) std::size_t              mPopPos{};  ///< The next pop position.
+  };
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_RING_QUEUE_HPP */
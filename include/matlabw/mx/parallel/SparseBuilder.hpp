@@ -0,0 +1,398 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_SPARSE_BUILDER_HPP
+#define MATLABW_MX_PARALLEL_SPARSE_BUILDER_HPP
+
+#include "../detail/include.hpp"
+
+#include <memory>
+
+#include "../Exception.hpp"
+#include "parallelFor.hpp"
+#include "../SparseArray.hpp"
+#include "ThreadPool.hpp"
+
+namespace matlabw::mx::parallel
+{
+  /**
+   * @brief Assembles a sparse matrix from (row, column, value) triplets like sparse(i, j, v, m, n) in MATLAB. Triplets
+   *        can be added concurrently from the workers of a thread pool and from one other thread, each of them appends
+   *        to its own buffer without locking. The CSC matrix is built in parallel, values of duplicate indices are
+   *        summed (logical values are or-ed) and entries that end up zero are not stored, so the result is sized
+   *        exactly.
+   * @tparam T Element type, double, std::complex<double> or bool
+   */
+  template<typename T>
+  class SparseBuilder
+  {
+    static_assert(mx::detail::isSparseType<T>, "T must be double, std::complex<double> or bool");
+
+    public:
+      /**
+       * @brief Constructor.
+       * @param m Number of rows.
+       * @param n Number of columns.
+       * @param pool The thread pool whose workers add the triplets and which builds the matrix.
+       */
+      SparseBuilder(std::size_t m, std::size_t n, ThreadPool& pool = getThreadPool())
+      : mDimM{m}, mDimN{n}, mPool{&pool}, mBuffers(pool.getThreadCount() + 1)
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      SparseBuilder(const SparseBuilder&) = delete;
+
+      /// @brief Default move constructor.
+      SparseBuilder(SparseBuilder&&) = default;
+
+      /// @brief Default destructor.
+      ~SparseBuilder() = default;
+
+      /// @brief Explicitly deleted copy assignment operator.
+      SparseBuilder& operator=(const SparseBuilder&) = delete;
+
+      /// @brief Default move assignment operator.
+      SparseBuilder& operator=(SparseBuilder&&) = default;
+
+      /**
+       * @brief Gets the number of rows.
+       * @return The number of rows.
+       */
+      [[nodiscard]] std::size_t getDimM() const noexcept
+      {
+        return mDimM;
+      }
+
+      /**
+       * @brief Gets the number of columns.
+       * @return The number of columns.
+       */
+      [[nodiscard]] std::size_t getDimN() const noexcept
+      {
+        return mDimN;
+      }
+
+      /**
+       * @brief Gets the number of added triplets. Must not be called while triplets are being added.
+       * @return The number of triplets.
+       */
+      [[nodiscard]] std::size_t getTripletCount() const noexcept
+      {
+        std::size_t count{};
+
+        for (const Buffer& buffer : mBuffers)
+        {
+          count += buffer.triplets.size();
+        }
+
+        return count;
+      }
+
+      /**
+       * @brief Reserves space in the buffer of every thread. Must not be called while triplets are being added.
+       * @param count Number of triplets per thread.
+       */
+      void reserve(std::size_t count)
+      {
+        for (Buffer& buffer : mBuffers)
+        {
+          buffer.triplets.reserve(count);
+        }
+      }
+
+      /**
+       * @brief Adds a triplet to the buffer of the calling thread.
+       * @param row Zero-based row index.
+       * @param col Zero-based column index.
+       * @param value The value.
+       */
+      void add(std::size_t row, std::size_t col, const T& value)
+      {
+        checkIndex(row, col);
+
+        getBuffer().triplets.push_back(Triplet{row, col, value});
+      }
+
+      /**
+       * @brief Adds triplets to the buffer of the calling thread.
+       * @param rows Zero-based row indices.
+       * @param cols Zero-based column indices.
+       * @param values Values.
+       */
+      void add(View<std::size_t> rows, View<std::size_t> cols, View<T> values)
+      {
+        if (rows.size() != values.size() || cols.size() != values.size())
+        {
+          throw Exception{"matlabw:mx:SparseBuilder:add",
+                          "row indices, column indices and values must have the same length"};
+        }
+
+        Buffer& buffer = getBuffer();
+
+        buffer.triplets.reserve(buffer.triplets.size() + values.size());
+
+        for (std::size_t k{}; k < values.size(); ++k)
+        {
+          checkIndex(rows[k], cols[k]);
+
+          buffer.triplets.push_back(Triplet{rows[k], cols[k], values[k]});
+        }
+      }
+
+      /// @brief Removes all triplets and releases the buffers.
+      void clear() noexcept
+      {
+        for (Buffer& buffer : mBuffers)
+        {
+          buffer.triplets = {};
+        }
+      }
+
+      /**
+       * @brief Builds the sparse matrix and clears the builder. Must be called from the MATLAB thread once no thread
+       *        adds triplets anymore. The triplets are bucketed by column blocks, then each block is sorted and
+       *        merged independently and finally copied into the exactly sized matrix, all passes but the allocation
+       *        run on the thread pool.
+       * @return The sparse matrix.
+       */
+      [[nodiscard]] SparseArray<T> build()
+      {
+        const std::size_t bufferCount  = mBuffers.size();
+        const std::size_t tripletCount = getTripletCount();
+
+        if (tripletCount == 0)
+        {
+          clear();
+
+          return makeSparseArray<T>(mDimM, mDimN, 0);
+        }
+
+        // Column blocks are the unit of parallel work, several per thread to balance uneven columns.
+        const std::size_t targetBlockCount = (mPool->getThreadCount() + 1) * 16;
+        const std::size_t blockWidth       = std::max<std::size_t>(1, (mDimN + targetBlockCount - 1) / targetBlockCount);
+        const std::size_t blockCount       = (mDimN + blockWidth - 1) / blockWidth;
+
+        // Count the triplets of each buffer per block, offsets are ordered by block, then by buffer.
+        std::vector<std::size_t> offsets(bufferCount * blockCount);
+
+        parallelFor(0, bufferCount, 1, [&](std::size_t p)
+        {
+          std::size_t* counts = offsets.data() + p * blockCount;
+
+          for (const Triplet& triplet : mBuffers[p].triplets)
+          {
+            ++counts[triplet.col / blockWidth];
+          }
+        }, *mPool);
+
+        std::vector<std::size_t> blockStart(blockCount + 1);
+
+        for (std::size_t b{}, offset{}; b < blockCount; ++b)
+        {
+          blockStart[b] = offset;
+
+          for (std::size_t p{}; p < bufferCount; ++p)
+          {
+            const std::size_t count = offsets[p * blockCount + b];
+
+            offsets[p * blockCount + b]  = offset;
+            offset                      += count;
+          }
+        }
+
+        blockStart[blockCount] = tripletCount;
+
+        // Scatter the triplets into their blocks.
+        auto scratch = std::make_unique_for_overwrite<Triplet[]>(tripletCount);
+
+        parallelFor(0, bufferCount, 1, [&](std::size_t p)
+        {
+          std::size_t* next = offsets.data() + p * blockCount;
+
+          for (const Triplet& triplet : mBuffers[p].triplets)
+          {
+            scratch[next[triplet.col / blockWidth]++] = triplet;
+          }
+        }, *mPool);
+
+        clear();
+
+        // Sort each block by column and row, merge duplicates and compact it at the front of its range.
+        std::vector<std::size_t> colNnz(mDimN);
+        std::vector<std::size_t> blockNnz(blockCount);
+
+        parallelFor(0, blockCount, 1, [&](std::size_t b)
+        {
+          blockNnz[b] = mergeBlock(scratch.get() + blockStart[b],
+                                   blockStart[b + 1] - blockStart[b],
+                                   b * blockWidth,
+                                   std::min(mDimN, (b + 1) * blockWidth),
+                                   colNnz.data());
+        }, *mPool);
+
+        std::vector<std::size_t> blockOut(blockCount + 1);
+
+        std::partial_sum(blockNnz.begin(), blockNnz.end(), blockOut.begin() + 1);
+
+        SparseArray<T> array = makeSparseArray<T>(mDimM, mDimN, blockOut[blockCount]);
+        CscView<T>     csc   = array.getStorage();
+
+        parallelFor(0, blockCount, 1, [&](std::size_t b)
+        {
+          const Triplet* in = scratch.get() + blockStart[b];
+
+          for (std::size_t k{}; k < blockNnz[b]; ++k)
+          {
+            csc.rowIdx[blockOut[b] + k] = in[k].row;
+            csc.values[blockOut[b] + k] = in[k].value;
+          }
+
+          for (std::size_t j = b * blockWidth, k = blockOut[b]; j < std::min(mDimN, (b + 1) * blockWidth); ++j)
+          {
+            csc.colPtr[j]  = k;
+            k             += colNnz[j];
+          }
+        }, *mPool);
+
+        csc.colPtr[mDimN] = blockOut[blockCount];
+
+        return array;
+      }
+    private:
+      /// @brief Triplet of a row index, a column index and a value.
+      struct Triplet
+      {
+        std::size_t row;   ///< Zero-based row index.
+        std::size_t col;   ///< Zero-based column index.
+        T           value; ///< The value.
+      };
+
+      /// @brief Buffer of one thread, aligned to a cache line to avoid false sharing.
+      struct alignas(64) Buffer
+      {
+        std::vector<Triplet> triplets{}; ///< The triplets.
+      };
+
+      /**
+       * @brief Checks that an index lies within the matrix.
+       * @param row Zero-based row index.
+       * @param col Zero-based column index.
+       */
+      void checkIndex(std::size_t row, std::size_t col) const
+      {
+        if (row >= mDimM || col >= mDimN)
+        {
+          throw Exception{"matlabw:mx:SparseBuilder:add", "index out of range"};
+        }
+      }
+
+      /**
+       * @brief Gets the buffer of the calling thread, the last one belongs to the threads outside of the pool.
+       * @return The buffer.
+       */
+      [[nodiscard]] Buffer& getBuffer() noexcept
+      {
+        return mBuffers[mPool->getWorkerIndex().value_or(mBuffers.size() - 1)];
+      }
+
+      /**
+       * @brief Sorts the triplets of a column block, merges duplicates and drops zeros.
+       * @param triplets The triplets of the block, the merged ones are written to the front.
+       * @param count The number of triplets.
+       * @param colBegin First column of the block.
+       * @param colEnd Past the end column of the block.
+       * @param colNnz Number of nonzeros per column of the whole matrix, written for the columns of the block.
+       * @return The number of merged triplets.
+       */
+      static std::size_t mergeBlock(Triplet*     triplets,
+                                    std::size_t  count,
+                                    std::size_t  colBegin,
+                                    std::size_t  colEnd,
+                                    std::size_t* colNnz)
+      {
+        // Counting sort by column, then sort each column by row.
+        std::vector<std::size_t> colStart(colEnd - colBegin + 1);
+
+        for (std::size_t k{}; k < count; ++k)
+        {
+          ++colStart[triplets[k].col - colBegin + 1];
+        }
+
+        std::partial_sum(colStart.begin(), colStart.end(), colStart.begin());
+
+        std::vector<Triplet>     sorted(count);
+        std::vector<std::size_t> next(colStart.begin(), colStart.end() - 1);
+
+        for (std::size_t k{}; k < count; ++k)
+        {
+          sorted[next[triplets[k].col - colBegin]++] = triplets[k];
+        }
+
+        std::size_t nnz{};
+
+        for (std::size_t j{colBegin}; j < colEnd; ++j)
+        {
+          const auto first = sorted.begin() + static_cast<std::ptrdiff_t>(colStart[j - colBegin]);
+          const auto last  = sorted.begin() + static_cast<std::ptrdiff_t>(colStart[j - colBegin + 1]);
+
+          std::sort(first, last, [](const Triplet& a, const Triplet& b) { return a.row < b.row; });
+
+          const std::size_t colFirst = nnz;
+
+          for (auto it = first; it != last;)
+          {
+            Triplet merged = *it;
+
+            for (++it; it != last && it->row == merged.row; ++it)
+            {
+              if constexpr (std::is_same_v<T, bool>)
+              {
+                merged.value = merged.value || it->value;
+              }
+              else
+              {
+                merged.value += it->value;
+              }
+            }
+
+            if (merged.value != T{})
+            {
+              triplets[nnz++] = merged;
+            }
+          }
+
+          colNnz[j] = nnz - colFirst;
+        }
+
+        return nnz;
+      }
+
+      std::size_t         mDimM{};    ///< Number of rows.
+      std::size_t         mDimN{};    ///< Number of columns.
+      ThreadPool*         mPool{};    ///< The thread pool.
+      std::vector<Buffer> mBuffers{}; ///< Buffers of the pool workers followed by the one of the other threads.
+  };
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_SPARSE_BUILDER_HPP */
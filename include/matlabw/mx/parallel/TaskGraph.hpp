@@ -0,0 +1,779 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_PARALLEL_TASK_GRAPH_HPP
+#define MATLABW_MX_PARALLEL_TASK_GRAPH_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../Exception.hpp"
+#include "cancellation.hpp"
+#include "mainThread.hpp"
+#include "ThreadBudget.hpp"
+#include "ThreadPool.hpp"
+
+namespace matlabw::mx::parallel
+{
+  /// @brief Threads a stage of a task graph may run on.
+  enum class StageAffinity
+  {
+    pool,       ///< Any thread, the workers of the pool or the thread running the graph.
+    mainThread, ///< The main thread only, for stages calling the MATLAB API.
+  };
+
+namespace detail
+{
+  struct TaskGraphState;
+
+  /// @brief Type-erased part of a stream shared with the scheduler.
+  class TaskStreamBase
+  {
+    public:
+      /// @brief Destructor.
+      virtual ~TaskStreamBase() = default;
+
+      /// @brief Marks the end of the stream, called when all producers completed.
+      virtual void close() = 0;
+
+      /// @brief Consumes the queued elements unless another thread is consuming them.
+      virtual void drain() = 0;
+  };
+
+  /// @brief Stage of a task graph.
+  struct TaskNode
+  {
+    std::function<void()>                         fn{};           ///< Function of a serial stage.
+    std::function<void(std::size_t, std::size_t)> body{};         ///< Chunk body of a parallel stage.
+    std::size_t                                   begin{};        ///< First index of a parallel stage.
+    std::size_t                                   end{};          ///< Past the end index of a parallel stage.
+    std::size_t                                   grain{};        ///< Number of indices of a chunk.
+    std::size_t                                   chunkCount{1};  ///< Number of chunks, 1 for serial stages.
+    std::size_t                                   nextChunk{};    ///< Next chunk to take, guarded by the ready mutex.
+    std::atomic<std::size_t>                      chunksDone{};   ///< Number of finished chunks.
+    TaskStreamBase*                               stream{};       ///< Consumed stream of a stream stage.
+    StageAffinity                                 affinity{};     ///< Threads the stage may run on.
+    std::vector<std::size_t>                      dependents{};   ///< Stages waiting for this one.
+    std::atomic<std::size_t>                      pending{};      ///< Number of unfinished dependencies.
+  };
+
+  /**
+   * @brief Shared state of a task graph. Owned jointly by the graph and the tasks posted to the pool and the main
+   *        thread, which may outlive the run when they find no work.
+   */
+  struct TaskGraphState : std::enable_shared_from_this<TaskGraphState>
+  {
+    /**
+     * @brief Constructor.
+     * @param pool The thread pool.
+     */
+    explicit TaskGraphState(ThreadPool& pool) noexcept
+    : pool{&pool}
+    {}
+
+    /**
+     * @brief Makes a stage ready once its dependencies completed. Skipped stages of a failed graph complete at once,
+     *        a stream stage only closes its stream, it consumes the elements as they are pushed.
+     * @param index Index of the stage.
+     */
+    void dispatch(std::size_t index)
+    {
+      TaskNode& node = nodes[index];
+
+      if (node.stream != nullptr)
+      {
+        node.stream->close();
+        return;
+      }
+
+      if (failed.load(std::memory_order_relaxed))
+      {
+        complete(index);
+        return;
+      }
+
+      if (node.affinity == StageAffinity::mainThread)
+      {
+        // Queued even on the main thread, so the stage never runs nested inside the completion of another one.
+        postToMain([state = shared_from_this(), index]{ state->runMain(index); });
+        return;
+      }
+
+      {
+        std::lock_guard lock{readyMutex};
+
+        ready.push_back(index);
+      }
+
+      const std::size_t helpers = std::min(node.chunkCount, pool->getThreadCount());
+
+      for (std::size_t i{}; i < helpers; ++i)
+      {
+        pool->post([state = shared_from_this()]
+        {
+          while (state->runOne()) {}
+        });
+      }
+
+      // Wakes the thread running the graph, it helps with the new work.
+      notifyMainThread();
+    }
+
+    /**
+     * @brief Completes a stage and dispatches the dependents whose last dependency it was.
+     * @param index Index of the stage.
+     */
+    void complete(std::size_t index)
+    {
+      for (std::size_t dependent : nodes[index].dependents)
+      {
+        if (nodes[dependent].pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+          dispatch(dependent);
+        }
+      }
+
+      if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        notifyMainThread();
+      }
+    }
+
+    /**
+     * @brief Runs a serial stage or one chunk of a parallel stage from the ready queue.
+     * @return True if any work was taken.
+     */
+    [[nodiscard]] bool runOne() noexcept
+    {
+      std::size_t index{};
+      std::size_t chunk{};
+
+      {
+        std::lock_guard lock{readyMutex};
+
+        if (ready.empty())
+        {
+          return false;
+        }
+
+        index = ready.front();
+        chunk = nodes[index].nextChunk++;
+
+        // A parallel stage stays at the front until its last chunk is taken.
+        if (nodes[index].nextChunk == nodes[index].chunkCount)
+        {
+          ready.pop_front();
+        }
+      }
+
+      TaskNode& node = nodes[index];
+
+      invoke([&]
+      {
+        if (node.body)
+        {
+          const std::size_t first = node.begin + chunk * node.grain;
+
+          node.body(first, std::min(node.end, first + node.grain));
+        }
+        else
+        {
+          node.fn();
+        }
+      });
+
+      if (node.chunksDone.fetch_add(1, std::memory_order_acq_rel) + 1 == node.chunkCount)
+      {
+        complete(index);
+      }
+
+      return true;
+    }
+
+    /**
+     * @brief Runs a main-thread stage, called by the main thread when it drains its queue.
+     * @param index Index of the stage.
+     */
+    void runMain(std::size_t index) noexcept
+    {
+      invoke([&]{ nodes[index].fn(); });
+      complete(index);
+    }
+
+    /**
+     * @brief Runs a function of a stage under the token of the graph, unless the graph failed.
+     * @tparam Fn Function type.
+     * @param fn The function.
+     */
+    template<typename Fn>
+    void invoke(Fn&& fn) noexcept
+    {
+      const CancellationScope scope{token};
+
+      checkCancellation();
+
+      if (failed.load(std::memory_order_relaxed))
+      {
+        return;
+      }
+
+      try
+      {
+        fn();
+      }
+      catch (...)
+      {
+        fail(std::current_exception());
+      }
+    }
+
+    /**
+     * @brief Queues a closure to the main thread without running it inline.
+     * @param closure The closure.
+     */
+    static void postToMain(std::function<void()> closure)
+    {
+      getMainThreadQueue().push(std::move(closure));
+      notifyMainThread();
+    }
+
+    /**
+     * @brief Records an exception, the stages and chunks not started yet are skipped.
+     * @param e The exception.
+     */
+    void fail(std::exception_ptr e) noexcept
+    {
+      std::lock_guard lock{exceptionMutex};
+
+      if (exception == nullptr)
+      {
+        exception = std::move(e);
+      }
+
+      failed.store(true, std::memory_order_relaxed);
+    }
+
+    /// @brief Fails the graph once the token is cancelled.
+    void checkCancellation() noexcept
+    {
+      if (!failed.load(std::memory_order_relaxed) && token.isCancelled())
+      {
+        fail(std::make_exception_ptr(CancelledException{}));
+      }
+    }
+
+    ThreadPool*                                 pool;             ///< The thread pool.
+    std::deque<TaskNode>                        nodes{};          ///< The stages, a deque keeps them in place.
+    std::vector<std::unique_ptr<TaskStreamBase>> streams{};       ///< The streams.
+    std::mutex                                  readyMutex{};     ///< Mutex guarding the ready queue.
+    std::deque<std::size_t>                     ready{};          ///< Ready stages run by any thread.
+    std::atomic<std::size_t>                    remaining{};      ///< Number of unfinished stages.
+    std::atomic<bool>                           failed{};         ///< Set by the first exception.
+    CancellationToken                           token{};          ///< Token of the thread running the graph.
+    std::mutex                                  exceptionMutex{}; ///< Mutex guarding the exception.
+    std::exception_ptr                          exception{};      ///< The first exception.
+  };
+} // namespace detail
+
+  /**
+   * @brief Bounded queue of elements streamed from producer stages to a consumer stage of a task graph, created by
+   *        TaskGraph::makeStream(). The consumer runs as soon as elements are pushed and consumes them in order, one
+   *        at a time. Pushing to a full stream waits for the consumer, or runs it on the pushing thread if its
+   *        affinity allows that and no other thread is consuming, so a stream never deadlocks a small pool.
+   * @tparam T Element type.
+   */
+  template<typename T>
+  class TaskStream final : public detail::TaskStreamBase
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param state State of the graph.
+       * @param capacity Maximum number of queued elements.
+       */
+      TaskStream(detail::TaskGraphState& state, std::size_t capacity) noexcept
+      : mState{&state}, mCapacity{capacity}
+      {}
+
+      /**
+       * @brief Gets the maximum number of queued elements.
+       * @return The capacity.
+       */
+      [[nodiscard]] std::size_t getCapacity() const noexcept
+      {
+        return mCapacity;
+      }
+
+      /**
+       * @brief Pushes an element, called by the producer stages.
+       * @param value The element.
+       * @throws CancelledException if the graph failed.
+       */
+      void push(T value)
+      {
+        std::unique_lock lock{mMutex};
+
+        while (mQueue.size() >= mCapacity)
+        {
+          if (mState->failed.load(std::memory_order_relaxed))
+          {
+            throw CancelledException{};
+          }
+
+          if (!mActive && (mAffinity == StageAffinity::pool || isMainThread()))
+          {
+            lock.unlock();
+            drain();
+            lock.lock();
+            continue;
+          }
+
+          // The main thread keeps running the closures posted to it, the consumer may be one of them.
+          if (isMainThread())
+          {
+            lock.unlock();
+            static_cast<void>(drainMainThreadQueue());
+            lock.lock();
+          }
+
+          mNotFull.wait_for(lock, detail::interruptPollInterval);
+        }
+
+        mQueue.push_back(std::move(value));
+
+        if (!mActive && !mScheduled)
+        {
+          mScheduled = true;
+          lock.unlock();
+          schedule();
+        }
+      }
+
+      /// @brief Marks the end of the stream, the consumer stage completes once the queue is drained.
+      void close() override
+      {
+        std::unique_lock lock{mMutex};
+
+        mClosed = true;
+
+        if (finish())
+        {
+          lock.unlock();
+          mState->complete(mNode);
+        }
+      }
+
+      /// @brief Consumes the queued elements unless another thread is consuming them.
+      void drain() override
+      {
+        std::unique_lock lock{mMutex};
+
+        mScheduled = false;
+
+        if (mActive)
+        {
+          return;
+        }
+
+        mActive = true;
+
+        while (!mQueue.empty())
+        {
+          T value = std::move(mQueue.front());
+          mQueue.pop_front();
+
+          lock.unlock();
+          mNotFull.notify_one();
+
+          // Elements of a failed graph are discarded.
+          mState->invoke([&]{ mConsumer(std::move(value)); });
+
+          lock.lock();
+        }
+
+        mActive = false;
+
+        if (finish())
+        {
+          lock.unlock();
+          mState->complete(mNode);
+        }
+      }
+    private:
+      friend class TaskGraph;
+
+      /**
+       * @brief Checks if the consumer stage completes now, must be called with the mutex locked.
+       * @return True exactly once, when the stream is closed and drained.
+       */
+      [[nodiscard]] bool finish() noexcept
+      {
+        if (mClosed && !mActive && mQueue.empty() && !mCompleted)
+        {
+          mCompleted = true;
+          return true;
+        }
+
+        return false;
+      }
+
+      /// @brief Schedules the consumer on a thread of its affinity.
+      void schedule()
+      {
+        auto task = [state = mState->shared_from_this(), this]{ drain(); };
+
+        if (mAffinity == StageAffinity::mainThread)
+        {
+          detail::TaskGraphState::postToMain(std::move(task));
+        }
+        else
+        {
+          mState->pool->post(std::move(task));
+        }
+      }
+
+      detail::TaskGraphState*    mState;        ///< State of the graph.
+      std::size_t                mCapacity;     ///< Maximum number of queued elements.
+      std::function<void(T&&)>   mConsumer{};   ///< The consumer.
+      StageAffinity              mAffinity{};   ///< Threads the consumer may run on.
+      std::size_t                mNode{};       ///< Index of the consumer stage.
+      std::deque<T>              mQueue{};      ///< Queued elements.
+      bool                       mActive{};     ///< Set while a thread runs the consumer.
+      bool                       mScheduled{};  ///< Set while a consumer task is queued.
+      bool                       mClosed{};     ///< Set when all producers completed.
+      bool                       mCompleted{};  ///< Set when the consumer stage completed.
+      std::mutex                 mMutex{};      ///< Mutex guarding the queue.
+      std::condition_variable    mNotFull{};    ///< Signalled when an element is popped.
+  };
+
+  /**
+   * @brief Graph of stages run on a thread pool, e.g. load, convert, per-column compute, reduce and pack the outputs
+   *        of a MEX function. A stage starts once all its dependencies completed, so independent branches run
+   *        concurrently. Parallel stages are split into chunks taken by the workers and the thread running the graph.
+   *        Stages calling the MATLAB API are declared with StageAffinity::mainThread and always run on the main
+   *        thread, other stages must not call the MATLAB API. Elements can be streamed between stages through
+   *        bounded TaskStream queues. The first exception skips the stages not started yet and is rethrown by run().
+   *
+   *          parallel::TaskGraph graph{};
+   *          auto load = graph.addStage([&]{ ... }, {}, parallel::StageAffinity::mainThread);
+   *          auto work = graph.addParallelStage(0, n, 0, [&](std::size_t i){ ... }, {load});
+   *          graph.addStage([&]{ ... }, {work}, parallel::StageAffinity::mainThread);
+   *          graph.run();
+   */
+  class TaskGraph
+  {
+    public:
+      /// @brief Handle of a stage.
+      class Stage
+      {
+        public:
+          /// @brief Default constructor. Creates an invalid handle.
+          Stage() noexcept = default;
+        private:
+          friend class TaskGraph;
+
+          /**
+           * @brief Constructor.
+           * @param index Index of the stage.
+           */
+          explicit Stage(std::size_t index) noexcept
+          : mIndex{index}
+          {}
+
+          std::size_t mIndex{std::numeric_limits<std::size_t>::max()}; ///< Index of the stage.
+      };
+
+      /**
+       * @brief Constructor.
+       * @param pool The thread pool.
+       */
+      explicit TaskGraph(ThreadPool& pool = getThreadPool())
+      : mState{std::make_shared<detail::TaskGraphState>(pool)}
+      {}
+
+      /**
+       * @brief Gets the number of stages.
+       * @return The number of stages.
+       */
+      [[nodiscard]] std::size_t getStageCount() const noexcept
+      {
+        return mState->nodes.size();
+      }
+
+      /**
+       * @brief Adds a serial stage.
+       * @param fn The function of the stage.
+       * @param dependencies Stages that must complete before the stage starts.
+       * @param affinity Threads the stage may run on.
+       * @return Handle of the stage.
+       */
+      Stage addStage(std::function<void()>         fn,
+                     std::initializer_list<Stage>  dependencies = {},
+                     StageAffinity                 affinity     = StageAffinity::pool)
+      {
+        detail::TaskNode& node = addNode(dependencies);
+
+        node.fn       = std::move(fn);
+        node.affinity = affinity;
+
+        return Stage{mState->nodes.size() - 1};
+      }
+
+      /**
+       * @brief Adds a data-parallel stage over a range of indices, split into chunks run concurrently. It must not
+       *        call the MATLAB API.
+       * @tparam Fn Body type, called as fn(i) for each index or as fn(chunkBegin, chunkEnd) for chunks.
+       * @param begin First index.
+       * @param end Past the end index.
+       * @param grain Number of indices of a chunk, 0 selects a grain giving each thread about 16 chunks.
+       * @param fn The body.
+       * @param dependencies Stages that must complete before the stage starts.
+       * @return Handle of the stage.
+       */
+      template<typename Fn>
+      Stage addParallelStage(std::size_t                  begin,
+                             std::size_t                  end,
+                             std::size_t                  grain,
+                             Fn                           fn,
+                             std::initializer_list<Stage> dependencies = {})
+      {
+        const std::size_t size = (end > begin) ? end - begin : 0;
+
+        if (grain == 0)
+        {
+          grain = std::max(std::size_t{1}, size / ((mState->pool->getThreadCount() + 1) * 16));
+        }
+
+        detail::TaskNode& node = addNode(dependencies);
+
+        node.begin      = begin;
+        node.end        = begin + size;
+        node.grain      = grain;
+        node.chunkCount = std::max(std::size_t{1}, (size + grain - 1) / grain);
+        node.body       = [fn = std::move(fn)](std::size_t chunkBegin, std::size_t chunkEnd) mutable
+        {
+          if constexpr (std::is_invocable_v<Fn&, std::size_t, std::size_t>)
+          {
+            fn(chunkBegin, chunkEnd);
+          }
+          else
+          {
+            for (std::size_t i{chunkBegin}; i < chunkEnd; ++i)
+            {
+              fn(i);
+            }
+          }
+        };
+
+        return Stage{mState->nodes.size() - 1};
+      }
+
+      /**
+       * @brief Creates a stream between stages, owned by the graph.
+       * @tparam T Element type.
+       * @param capacity Maximum number of queued elements, at least 1.
+       * @return The stream.
+       */
+      template<typename T>
+      [[nodiscard]] TaskStream<T>& makeStream(std::size_t capacity)
+      {
+        if (capacity == 0)
+        {
+          throw Exception{"matlabw:mx:parallel:TaskGraph:makeStream", "capacity must be positive"};
+        }
+
+        auto  stream = std::make_unique<TaskStream<T>>(*mState, capacity);
+        auto& ref    = *stream;
+
+        mState->streams.push_back(std::move(stream));
+
+        return ref;
+      }
+
+      /**
+       * @brief Adds the consumer stage of a stream. It consumes the elements as the producers push them and completes
+       *        once all producers completed and the stream is drained.
+       * @tparam T Element type.
+       * @param stream The stream, created by this graph.
+       * @param consumer The consumer, called as consumer(T&&) for each element in order.
+       * @param producers Stages pushing to the stream.
+       * @param affinity Threads the consumer may run on.
+       * @return Handle of the stage.
+       */
+      template<typename T>
+      Stage addStreamStage(TaskStream<T>&                stream,
+                           std::function<void(T&&)>      consumer,
+                           std::initializer_list<Stage>  producers,
+                           StageAffinity                 affinity = StageAffinity::pool)
+      {
+        if (stream.mState != mState.get() || stream.mConsumer)
+        {
+          throw Exception{"matlabw:mx:parallel:TaskGraph:addStreamStage", "stream has a consumer or another graph"};
+        }
+
+        detail::TaskNode& node = addNode(producers);
+
+        node.stream      = &stream;
+        node.affinity    = affinity;
+        stream.mConsumer = std::move(consumer);
+        stream.mAffinity = affinity;
+        stream.mNode     = mState->nodes.size() - 1;
+
+        return Stage{stream.mNode};
+      }
+
+      /**
+       * @brief Runs the graph and waits for all stages. The calling thread runs stages and chunks too and, on the
+       *        main thread, the main-thread stages and the closures posted to it. If called from another thread, the
+       *        main thread must drain its queue for the main-thread stages to run. A graph can be run once.
+       * @throws The first exception thrown by a stage, or CancelledException if the token of the calling thread is
+       *         cancelled.
+       */
+      void run()
+      {
+        detail::TaskGraphState& state = *mState;
+
+        if (mRun)
+        {
+          throw Exception{"matlabw:mx:parallel:TaskGraph:run", "graph can be run once"};
+        }
+
+        if (state.pool->isWorkerThread())
+        {
+          throw Exception{"matlabw:mx:parallel:TaskGraph:run", "cannot be run from a worker thread"};
+        }
+
+        mRun = true;
+
+        const ThreadBudget budget{};
+
+        state.token     = getCancellationToken();
+        state.remaining = state.nodes.size();
+
+        // Roots are collected first, stages dispatched later may already be ready when the loop reaches them.
+        std::vector<std::size_t> roots{};
+
+        for (std::size_t i{}; i < state.nodes.size(); ++i)
+        {
+          if (state.nodes[i].pending.load(std::memory_order_relaxed) == 0)
+          {
+            roots.push_back(i);
+          }
+        }
+
+        for (std::size_t root : roots)
+        {
+          state.dispatch(root);
+        }
+
+        auto& signal = detail::getMainThreadSignal();
+
+        auto drain = [&state]
+        {
+          try
+          {
+            while (drainMainThreadQueue() > 0) {}
+          }
+          catch (...)
+          {
+            state.fail(std::current_exception());
+          }
+        };
+
+        for (std::uint32_t value = signal.value.load(std::memory_order_acquire);;
+             value = signal.value.load(std::memory_order_acquire))
+        {
+          drain();
+
+          if (state.remaining.load(std::memory_order_acquire) == 0)
+          {
+            break;
+          }
+
+          if (state.runOne())
+          {
+            continue;
+          }
+
+          state.checkCancellation();
+          detail::waitMainThreadSignal(value, detail::interruptPollInterval);
+        }
+
+        drain();
+
+        if (state.exception != nullptr)
+        {
+          std::rethrow_exception(state.exception);
+        }
+      }
+    private:
+      /**
+       * @brief Adds a stage and links it to its dependencies.
+       * @param dependencies Stages that must complete before the stage starts.
+       * @return The stage.
+       */
+      detail::TaskNode& addNode(std::initializer_list<Stage> dependencies)
+      {
+        detail::TaskGraphState& state = *mState;
+
+        if (mRun)
+        {
+          throw Exception{"matlabw:mx:parallel:TaskGraph", "cannot add stages to a graph that was run"};
+        }
+
+        for (Stage dependency : dependencies)
+        {
+          if (dependency.mIndex >= state.nodes.size())
+          {
+            throw Exception{"matlabw:mx:parallel:TaskGraph", "invalid dependency"};
+          }
+        }
+
+        // Dependencies always precede their dependents, so the graph is acyclic by construction.
+        detail::TaskNode& node = state.nodes.emplace_back();
+
+        for (Stage dependency : dependencies)
+        {
+          state.nodes[dependency.mIndex].dependents.push_back(state.nodes.size() - 1);
+        }
+
+        node.pending.store(dependencies.size(), std::memory_order_relaxed);
+
+        return node;
+      }
+
+      std::shared_ptr<detail::TaskGraphState> mState; ///< The shared state.
+      bool                                    mRun{}; ///< Set once the graph was run.
+  };
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_TASK_GRAPH_HPP */
@@ -0,0 +1,287 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_THREAD_BUDGET_HPP
+#define MATLABW_MX_PARALLEL_THREAD_BUDGET_HPP
+
+#include "../detail/include.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <dlfcn.h>
+#elif defined(_WIN32)
+# ifndef NOMINMAX
+#   define NOMINMAX
+# endif
+# include <windows.h>
+#endif
+
+namespace matlabw::mx::parallel
+{
+  /// @brief Function that gets the number of worker threads of the library-managed thread pool, 0 if unknown.
+  using ThreadCountProvider = std::size_t (*)() noexcept;
+
+namespace detail
+{
+  /**
+   * @brief Gets the installed thread count provider.
+   * @return The thread count provider, nullptr if none is installed.
+   */
+  [[nodiscard]] inline ThreadCountProvider& getThreadCountProvider() noexcept
+  {
+    static ThreadCountProvider provider{};
+
+    return provider;
+  }
+
+  /// @brief Thread count controls of the BLAS library loaded in the process, resolved at run time.
+  struct BlasThreadControl
+  {
+    int  (*setLocal)(int){};  ///< Sets the count of the calling thread and returns the previous one, MKL only.
+    void (*setGlobal)(int){}; ///< Sets the count of all threads.
+    int  (*getGlobal)(){};    ///< Gets the count of all threads.
+  };
+
+  /**
+   * @brief Looks a symbol up in the modules loaded in the process.
+   * @tparam Fn The function pointer type.
+   * @param name The symbol name.
+   * @return The function, nullptr if not found.
+   */
+  template<typename Fn>
+  [[nodiscard]] Fn findSymbol(const char* name) noexcept
+  {
+#if defined(__unix__) || defined(__APPLE__)
+    return reinterpret_cast<Fn>(dlsym(RTLD_DEFAULT, name));
+#elif defined(_WIN32)
+    for (const char* module : {"mkl.dll", "mkl_rt.dll", "libopenblas.dll"})
+    {
+      if (HMODULE handle = GetModuleHandleA(module); handle != nullptr)
+      {
+        if (FARPROC proc = GetProcAddress(handle, name); proc != nullptr)
+        {
+          return reinterpret_cast<Fn>(proc);
+        }
+      }
+    }
+
+    return nullptr;
+#else
+    static_cast<void>(name);
+
+    return nullptr;
+#endif
+  }
+
+  /**
+   * @brief Gets the thread count controls of the BLAS library, MATLAB's MKL or OpenBLAS. Resolved once, all
+   *        controls are nullptr if neither is loaded.
+   * @return The thread count controls.
+   */
+  [[nodiscard]] inline const BlasThreadControl& getBlasThreadControl() noexcept
+  {
+    static const BlasThreadControl control = []() noexcept
+    {
+      BlasThreadControl mkl{findSymbol<int (*)(int)>("MKL_Set_Num_Threads_Local"),
+                            findSymbol<void (*)(int)>("MKL_Set_Num_Threads"),
+                            findSymbol<int (*)()>("MKL_Get_Max_Threads")};
+
+      if (mkl.setGlobal != nullptr && mkl.getGlobal != nullptr)
+      {
+        return mkl;
+      }
+
+      return BlasThreadControl{nullptr,
+                               findSymbol<void (*)(int)>("openblas_set_num_threads"),
+                               findSymbol<int (*)()>("openblas_get_num_threads")};
+    }();
+
+    return control;
+  }
+
+  /**
+   * @brief Converts a thread count to the int taken by the BLAS library.
+   * @param count The thread count.
+   * @return The thread count, at least 1.
+   */
+  [[nodiscard]] inline int toBlasThreadCount(std::size_t count) noexcept
+  {
+    constexpr auto maxCount = static_cast<std::size_t>(std::numeric_limits<int>::max());
+
+    return static_cast<int>(std::clamp(count, std::size_t{1}, maxCount));
+  }
+
+  /// @brief Makes BLAS calls of the calling worker thread single-threaded, requires MKL.
+  inline void limitWorkerBlasThreads() noexcept
+  {
+    if (const auto setLocal = getBlasThreadControl().setLocal; setLocal != nullptr)
+    {
+      setLocal(1);
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Installs the provider of the default thread pool size. MEX files install one on every call which sizes
+   *        the pool after MATLAB's maxNumCompThreads.
+   * @param provider The thread count provider, nullptr to uninstall.
+   */
+  inline void setThreadCountProvider(ThreadCountProvider provider) noexcept
+  {
+    detail::getThreadCountProvider() = provider;
+  }
+
+  /**
+   * @brief Gets the number of threads used by BLAS calls from the calling thread.
+   * @return The number of threads, 0 if no supported BLAS library (MKL or OpenBLAS) is loaded.
+   */
+  [[nodiscard]] inline std::size_t getBlasThreadCount() noexcept
+  {
+    const auto& control = detail::getBlasThreadControl();
+
+    if (control.getGlobal == nullptr)
+    {
+      return 0;
+    }
+
+    if (control.setLocal != nullptr)
+    {
+      // Setting 0 clears the count of the calling thread and returns it.
+      if (const int local = control.setLocal(0); local != 0)
+      {
+        control.setLocal(local);
+
+        return static_cast<std::size_t>(local);
+      }
+    }
+
+    return static_cast<std::size_t>(control.getGlobal());
+  }
+
+  /**
+   * @brief Sets the number of threads used by BLAS calls of all threads. Note that MATLAB sets its own count again
+   *        when maxNumCompThreads changes.
+   * @param count The number of threads, at least 1.
+   * @return True if set, false if no supported BLAS library is loaded.
+   */
+  inline bool setBlasThreadCount(std::size_t count) noexcept
+  {
+    const auto& control = detail::getBlasThreadControl();
+
+    if (control.setGlobal == nullptr)
+    {
+      return false;
+    }
+
+    control.setGlobal(detail::toBlasThreadCount(count));
+
+    return true;
+  }
+
+  /**
+   * @brief Scoped limit of the threads used by BLAS calls while the library's own threads are busy, so that the pool
+   *        and MATLAB's multithreaded BLAS do not oversubscribe the cores. With MKL only the calling thread is
+   *        limited (workers of the thread pool always run BLAS single-threaded), with OpenBLAS the limit applies
+   *        process-wide. Guards may nest but must be destroyed in reverse order on the thread that created them.
+   *        Without a supported BLAS library loaded the guard does nothing. Parallel loops construct one
+   *        automatically.
+   */
+  class ThreadBudget
+  {
+    public:
+      /**
+       * @brief Constructor. Limits the BLAS threads.
+       * @param blasThreadCount The number of threads BLAS calls may use, at least 1.
+       */
+      explicit ThreadBudget(std::size_t blasThreadCount = 1) noexcept
+      {
+        const auto& control = detail::getBlasThreadControl();
+        const int   count   = detail::toBlasThreadCount(blasThreadCount);
+
+        if (control.setLocal != nullptr)
+        {
+          mPrevious = control.setLocal(count);
+          mState    = State::local;
+        }
+        else if (control.setGlobal != nullptr && control.getGlobal != nullptr)
+        {
+          mPrevious = control.getGlobal();
+          mState    = State::global;
+
+          control.setGlobal(count);
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      ThreadBudget(const ThreadBudget&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ThreadBudget(ThreadBudget&&) = delete;
+
+      /// @brief Destructor. Restores the previous BLAS thread count.
+      ~ThreadBudget() noexcept
+      {
+        const auto& control = detail::getBlasThreadControl();
+
+        switch (mState)
+        {
+          case State::local:
+            control.setLocal(mPrevious);
+            break;
+          case State::global:
+            control.setGlobal(mPrevious);
+            break;
+          case State::none:
+            break;
+        }
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ThreadBudget& operator=(const ThreadBudget&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ThreadBudget& operator=(ThreadBudget&&) = delete;
+
+      /**
+       * @brief Checks if the guard limits the BLAS threads.
+       * @return True if a supported BLAS library is loaded and the limit is applied.
+       */
+      [[nodiscard]] bool isActive() const noexcept
+      {
+        return mState != State::none;
+      }
+    private:
+      /// @brief How the limit was applied.
+      enum class State
+      {
+        none,   ///< Not applied.
+        local,  ///< Applied to the calling thread.
+        global, ///< Applied process-wide.
+      };
+
+      int   mPrevious{};         ///< Previous thread count, 0 if none was set for the calling thread.
+      State mState{State::none}; ///< How the limit was applied.
+  };
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_THREAD_BUDGET_HPP */
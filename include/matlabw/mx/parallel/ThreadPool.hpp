@@ -0,0 +1,446 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_THREAD_POOL_HPP
+#define MATLABW_MX_PARALLEL_THREAD_POOL_HPP
+
+#include "../detail/include.hpp"
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+#include "../cleanup.hpp"
+#include "../common.hpp"
+#include "../Exception.hpp"
+#include "numa.hpp"
+#include "ThreadBudget.hpp"
+
+namespace matlabw::mx::parallel
+{
+  /// @brief Options of a thread pool.
+  struct ThreadPoolOptions
+  {
+    std::size_t              threadCount{}; ///< Number of worker threads, 0 selects getDefaultThreadCount().
+    std::vector<std::size_t> cpus{};        ///< Worker i is pinned to cpus[i % cpus.size()], empty disables pinning.
+    bool                     numaPinning{}; ///< Pin worker i to the CPUs of NUMA node i * nodeCount / threadCount,
+                                            ///< ignored if cpus are specified or the machine has a single node.
+  };
+
+  /**
+   * @brief Gets the default number of worker threads, read from the MATLABW_NUM_THREADS environment variable, the
+   *        installed thread count provider (in MEX files one less than maxNumCompThreads, the calling thread
+   *        participates in parallel loops) or the number of hardware threads.
+   * @return The default number of worker threads, at least 1.
+   */
+  [[nodiscard]] inline std::size_t getDefaultThreadCount() noexcept
+  {
+    if (const char* env = std::getenv("MATLABW_NUM_THREADS"); env != nullptr)
+    {
+      char*               end{};
+      const unsigned long value = std::strtoul(env, &end, 10);
+
+      if (end != env && value > 0)
+      {
+        return static_cast<std::size_t>(value);
+      }
+    }
+
+    if (ThreadCountProvider provider = detail::getThreadCountProvider(); provider != nullptr)
+    {
+      if (const std::size_t count = provider(); count > 0)
+      {
+        return count;
+      }
+    }
+
+    return std::max(std::size_t{1}, static_cast<std::size_t>(std::thread::hardware_concurrency()));
+  }
+
+  /**
+   * @brief Pool of persistent worker threads executing tasks from a shared queue. Tasks run outside of the MATLAB
+   *        thread, so they must not call the MATLAB API (mx, mex, mat and engine functions are not thread-safe),
+   *        including mx::malloc.
+   */
+  class ThreadPool
+  {
+    public:
+      /**
+       * @brief Constructor. Starts the worker threads.
+       * @param options Options of the thread pool.
+       */
+      explicit ThreadPool(const ThreadPoolOptions& options = {})
+      {
+        const std::size_t threadCount = (options.threadCount > 0) ? options.threadCount : getDefaultThreadCount();
+
+        mThreads.reserve(threadCount);
+
+        mNumaPinned = options.cpus.empty() && options.numaPinning && getNumaNodes().size() > 1;
+
+        try
+        {
+          for (std::size_t i{}; i < threadCount; ++i)
+          {
+            mThreads.emplace_back([this, i]{ run(i); });
+
+            if (!options.cpus.empty())
+            {
+              pin(mThreads.back(), {&options.cpus[i % options.cpus.size()], 1});
+            }
+            else if (mNumaPinned)
+            {
+              pin(mThreads.back(), getNumaNodes()[i * getNumaNodes().size() / threadCount].cpus);
+            }
+          }
+        }
+        catch (...)
+        {
+          stop();
+          throw;
+        }
+      }
+
+      /// @brief Explicitly deleted copy constructor.
+      ThreadPool(const ThreadPool&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      ThreadPool(ThreadPool&&) = delete;
+
+      /// @brief Destructor. Finishes the queued tasks and joins the worker threads.
+      ~ThreadPool() noexcept
+      {
+        stop();
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      ThreadPool& operator=(const ThreadPool&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      ThreadPool& operator=(ThreadPool&&) = delete;
+
+      /**
+       * @brief Gets the number of worker threads.
+       * @return The number of worker threads.
+       */
+      [[nodiscard]] std::size_t getThreadCount() const noexcept
+      {
+        return mThreads.size();
+      }
+
+      /**
+       * @brief Checks if the workers are pinned to NUMA nodes. Loops over large arrays then use the static partition
+       *        of parallelForStatic(), so that each block of an array is always processed on the node it was first
+       *        touched on.
+       * @return True if the workers are pinned to NUMA nodes.
+       */
+      [[nodiscard]] bool isNumaPinned() const noexcept
+      {
+        return mNumaPinned;
+      }
+
+      /**
+       * @brief Gets the index of the calling worker thread.
+       * @return The index in [0, getThreadCount()) if called from a worker of this pool, std::nullopt otherwise.
+       */
+      [[nodiscard]] std::optional<std::size_t> getWorkerIndex() const noexcept
+      {
+        const WorkerInfo& info = getWorkerInfo();
+
+        return (info.pool == this) ? std::optional<std::size_t>{info.index} : std::nullopt;
+      }
+
+      /**
+       * @brief Checks if the calling thread is a worker of this pool. Waiting for tasks of the pool from its own
+       *        workers may deadlock.
+       * @return True if called from a worker of this pool.
+       */
+      [[nodiscard]] bool isWorkerThread() const noexcept
+      {
+        return getWorkerInfo().pool == this;
+      }
+
+      /**
+       * @brief Queues a task without a result. The task must not throw, exceptions escaping it are discarded.
+       * @param task The task.
+       */
+      void post(std::function<void()> task)
+      {
+        {
+          std::lock_guard lock{mMutex};
+
+          mTasks.push_back(std::move(task));
+        }
+
+        mCondition.notify_one();
+      }
+
+      /**
+       * @brief Queues a task and returns a future of its result. Exceptions are stored in the future.
+       * @tparam Fn Callable type.
+       * @param fn The callable.
+       * @return The future of the result.
+       */
+      template<typename Fn>
+      [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<Fn>>> submit(Fn&& fn)
+      {
+        using Result = std::invoke_result_t<std::decay_t<Fn>>;
+
+        auto task   = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+        auto future = task->get_future();
+
+        post([task]{ (*task)(); });
+
+        return future;
+      }
+    private:
+      /// @brief Identification of a worker thread.
+      struct WorkerInfo
+      {
+        const ThreadPool* pool{};  ///< Pool of the worker, nullptr for other threads.
+        std::size_t       index{}; ///< Index of the worker.
+      };
+
+      /**
+       * @brief Gets the identification of the calling thread.
+       * @return The identification.
+       */
+      [[nodiscard]] static WorkerInfo& getWorkerInfo() noexcept
+      {
+        thread_local WorkerInfo info{};
+
+        return info;
+      }
+
+      /**
+       * @brief Pins a thread to a set of CPUs. Supported on Linux only, ignored elsewhere.
+       * @param thread The thread.
+       * @param cpus The CPU indices.
+       */
+      static void pin([[maybe_unused]] std::thread& thread, [[maybe_unused]] View<std::size_t> cpus)
+      {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        for (std::size_t cpu : cpus)
+        {
+          if (cpu >= CPU_SETSIZE)
+          {
+            throw Exception{"matlabw:mx:parallel:ThreadPool:pin", "CPU index out of range"};
+          }
+
+          CPU_SET(cpu, &set);
+        }
+
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0)
+        {
+          throw Exception{"matlabw:mx:parallel:ThreadPool:pin", "failed to set thread affinity"};
+        }
+#endif
+      }
+
+      /**
+       * @brief Worker thread loop.
+       * @param index Index of the worker.
+       */
+      void run(std::size_t index) noexcept
+      {
+        getWorkerInfo() = WorkerInfo{this, index};
+
+        // BLAS called from tasks runs single-threaded, the pool already occupies the cores.
+        detail::limitWorkerBlasThreads();
+
+        while (true)
+        {
+          std::function<void()> task{};
+
+          {
+            std::unique_lock lock{mMutex};
+
+            mCondition.wait(lock, [this]{ return mStopping || !mTasks.empty(); });
+
+            if (mTasks.empty())
+            {
+              return;
+            }
+
+            task = std::move(mTasks.front());
+            mTasks.pop_front();
+          }
+
+          try
+          {
+            task();
+          }
+          catch (...)
+          {
+            // Exceptions may not escape the worker thread.
+          }
+        }
+      }
+
+      /// @brief Stops the worker threads once the queue is empty and joins them.
+      void stop() noexcept
+      {
+        {
+          std::lock_guard lock{mMutex};
+
+          mStopping = true;
+        }
+
+        mCondition.notify_all();
+
+        for (auto& thread : mThreads)
+        {
+          if (thread.joinable())
+          {
+            thread.join();
+          }
+        }
+
+        mThreads.clear();
+      }
+
+      std::vector<std::thread>          mThreads{};    ///< Worker threads.
+      std::deque<std::function<void()>> mTasks{};      ///< Queued tasks.
+      std::mutex                        mMutex{};      ///< Mutex guarding the queue.
+      std::condition_variable           mCondition{};  ///< Signals queued tasks and stopping.
+      bool                              mStopping{};   ///< True once the pool is stopping.
+      bool                              mNumaPinned{}; ///< True if the workers are pinned to NUMA nodes.
+  };
+
+namespace detail
+{
+  /// @brief State of the library-managed thread pool.
+  struct ThreadPoolState
+  {
+    std::mutex                  mutex{};             ///< Mutex guarding the state.
+    std::unique_ptr<ThreadPool> pool{};              ///< The pool, created lazily.
+    ThreadPoolOptions           options{};           ///< Options of the pool.
+    bool                        cleanupRegistered{}; ///< True once the shutdown is registered as a cleanup handler.
+  };
+
+  /**
+   * @brief Gets the state of the library-managed thread pool.
+   * @return The state.
+   */
+  [[nodiscard]] inline ThreadPoolState& getThreadPoolState() noexcept
+  {
+    static ThreadPoolState state{};
+
+    return state;
+  }
+} // namespace detail
+
+  /**
+   * @brief Shuts the library-managed thread pool down, finishing the queued tasks and joining the workers. The pool is
+   *        recreated by the next getThreadPool(). In MEX files this is run by the exit handler, so that clear mex never
+   *        unloads the code the workers are executing.
+   */
+  inline void shutdownThreadPool() noexcept
+  {
+    auto& state = detail::getThreadPoolState();
+
+    std::unique_ptr<ThreadPool> pool{};
+
+    {
+      std::lock_guard lock{state.mutex};
+
+      pool = std::move(state.pool);
+    }
+
+    // Joined outside of the lock, the finishing tasks may still access the pool state.
+    pool.reset();
+  }
+
+  /**
+   * @brief Gets the library-managed thread pool. The pool is created on first use and persists between MEX function
+   *        calls.
+   * @return The thread pool.
+   */
+  [[nodiscard]] inline ThreadPool& getThreadPool()
+  {
+    auto& state = detail::getThreadPoolState();
+
+    std::lock_guard lock{state.mutex};
+
+    if (state.pool == nullptr)
+    {
+      state.pool = std::make_unique<ThreadPool>(state.options);
+
+      if (!state.cleanupRegistered)
+      {
+        state.cleanupRegistered = registerCleanup(shutdownThreadPool);
+      }
+    }
+
+    return *state.pool;
+  }
+
+  /**
+   * @brief Gets the options of the library-managed thread pool.
+   * @return The options.
+   */
+  [[nodiscard]] inline ThreadPoolOptions getThreadPoolOptions()
+  {
+    auto& state = detail::getThreadPoolState();
+
+    std::lock_guard lock{state.mutex};
+
+    return state.options;
+  }
+
+  /**
+   * @brief Configures the library-managed thread pool. A running pool is shut down and recreated with the new options
+   *        on next use. Must not be called from a worker thread.
+   * @param options The options.
+   */
+  inline void configureThreadPool(const ThreadPoolOptions& options)
+  {
+    auto& state = detail::getThreadPoolState();
+
+    {
+      std::lock_guard lock{state.mutex};
+
+      if (state.pool != nullptr && state.pool->isWorkerThread())
+      {
+        throw Exception{"matlabw:mx:parallel:configureThreadPool", "cannot be called from a worker thread"};
+      }
+
+      state.options = options;
+    }
+
+    shutdownThreadPool();
+  }
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_THREAD_POOL_HPP */
@@ -0,0 +1,248 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_CANCELLATION_HPP
+#define MATLABW_MX_PARALLEL_CANCELLATION_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+#include <chrono>
+
+#include "mainThread.hpp"
+#include "../Exception.hpp"
+
+namespace matlabw::mx::parallel
+{
+  /// @brief Function that checks if the user asked to interrupt the running operation, called on the main thread only.
+  using InterruptPoller = bool (*)() noexcept;
+
+  /// @brief Thrown when a cancellation token is cancelled, e.g. by Ctrl-C in a MEX file.
+  class CancelledException : public Exception
+  {
+    public:
+      /// @brief Default constructor.
+      CancelledException()
+      : Exception{"matlabw:mx:parallel:cancelled", "operation was cancelled"}
+      {}
+  };
+
+namespace detail
+{
+  /// @brief Minimum interval between two polls of the interrupt poller.
+  inline constexpr std::chrono::milliseconds interruptPollInterval{2};
+
+  /// @brief State of the interrupt of the main thread.
+  struct InterruptState
+  {
+    std::atomic<InterruptPoller>                poller{};   ///< The installed poller, nullptr if none.
+    std::atomic<bool>                           flag{};     ///< Set once an interrupt was polled or requested.
+    std::atomic<std::chrono::steady_clock::rep> lastPoll{}; ///< Time of the last poll.
+  };
+
+  /**
+   * @brief Gets the interrupt state of the main thread.
+   * @return The state.
+   */
+  [[nodiscard]] inline InterruptState& getInterruptState() noexcept
+  {
+    static InterruptState state{};
+
+    return state;
+  }
+
+  /**
+   * @brief Gets the flag of the cancellation token installed on the calling thread.
+   * @return The flag, nullptr if none is installed.
+   */
+  [[nodiscard]] inline const std::atomic<bool>*& getThreadCancelFlag() noexcept
+  {
+    thread_local const std::atomic<bool>* flag{};
+
+    return flag;
+  }
+} // namespace detail
+
+  /**
+   * @brief Installs the interrupt poller. MEX files install one on every call which checks for Ctrl-C.
+   * @param poller The interrupt poller, nullptr to uninstall.
+   */
+  inline void setInterruptPoller(InterruptPoller poller) noexcept
+  {
+    detail::getInterruptState().poller.store(poller, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Polls the interrupt poller, at most once per detail::interruptPollInterval. Does nothing on other threads
+   *        than the main thread.
+   * @return True if an interrupt is pending.
+   */
+  inline bool pollInterrupt() noexcept
+  {
+    auto& state = detail::getInterruptState();
+
+    if (state.flag.load(std::memory_order_relaxed))
+    {
+      return true;
+    }
+
+    const InterruptPoller poller = state.poller.load(std::memory_order_relaxed);
+
+    if (poller == nullptr || !isMainThread())
+    {
+      return false;
+    }
+
+    const auto now      = std::chrono::steady_clock::now().time_since_epoch();
+    const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(detail::interruptPollInterval);
+
+    if (now.count() - state.lastPoll.load(std::memory_order_relaxed) < interval.count())
+    {
+      return false;
+    }
+
+    state.lastPoll.store(now.count(), std::memory_order_relaxed);
+
+    if (poller())
+    {
+      state.flag.store(true, std::memory_order_relaxed);
+    }
+
+    return state.flag.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Requests the interrupt of the main thread, as if it was polled.
+  inline void requestInterrupt() noexcept
+  {
+    detail::getInterruptState().flag.store(true, std::memory_order_relaxed);
+  }
+
+  /// @brief Clears the interrupt of the main thread. MEX files clear it on every call.
+  inline void resetInterrupt() noexcept
+  {
+    detail::getInterruptState().flag.store(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Cheap copyable view of a cancellation flag. The token of the main thread is cancelled by its interrupt, so
+   *        checking it on the main thread polls the interrupt poller. Parallel loops stop at the token of the thread
+   *        that started them, so long loop bodies may check the token of the loop to stop within a chunk.
+   */
+  class CancellationToken
+  {
+    public:
+      /// @brief Default constructor. The token is never cancelled.
+      CancellationToken() noexcept = default;
+
+      /**
+       * @brief Constructor.
+       * @param flag The cancellation flag, must outlive the token.
+       */
+      explicit CancellationToken(const std::atomic<bool>& flag) noexcept
+      : mFlag{&flag}
+      {}
+
+      /**
+       * @brief Checks if the token is cancelled. Thread-safe.
+       * @return True if cancelled.
+       */
+      [[nodiscard]] bool isCancelled() const noexcept
+      {
+        if (mFlag == &detail::getInterruptState().flag)
+        {
+          return pollInterrupt();
+        }
+
+        return mFlag != nullptr && mFlag->load(std::memory_order_relaxed);
+      }
+
+      /// @brief Throws CancelledException if the token is cancelled.
+      void throwIfCancelled() const
+      {
+        if (isCancelled())
+        {
+          throw CancelledException{};
+        }
+      }
+    private:
+      friend class CancellationScope;
+
+      const std::atomic<bool>* mFlag{}; ///< The cancellation flag, nullptr if never cancelled.
+  };
+
+  /**
+   * @brief Gets the cancellation token of the calling thread: the one installed by a CancellationScope, otherwise the
+   *        interrupt token on the main thread and a token that is never cancelled elsewhere.
+   * @return The token.
+   */
+  /// @brief Installs a cancellation token as the token of the calling thread for the lifetime of the scope.
+  class CancellationScope
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param token The cancellation token, its flag must outlive the scope.
+       */
+      explicit CancellationScope(CancellationToken token) noexcept
+      : mPrevious{std::exchange(detail::getThreadCancelFlag(), token.mFlag)}
+      {}
+
+      /// @brief Explicitly deleted copy constructor.
+      CancellationScope(const CancellationScope&) = delete;
+
+      /// @brief Explicitly deleted move constructor.
+      CancellationScope(CancellationScope&&) = delete;
+
+      /// @brief Destructor. Restores the previous token.
+      ~CancellationScope() noexcept
+      {
+        detail::getThreadCancelFlag() = mPrevious;
+      }
+
+      /// @brief Explicitly deleted copy assignment operator.
+      CancellationScope& operator=(const CancellationScope&) = delete;
+
+      /// @brief Explicitly deleted move assignment operator.
+      CancellationScope& operator=(CancellationScope&&) = delete;
+    private:
+      const std::atomic<bool>* mPrevious; ///< The previous flag of the thread.
+  };
+
+  /**
+   * @brief Gets the cancellation token of the calling thread: the one installed by a CancellationScope, otherwise the
+   *        interrupt token on the main thread and a token that is never cancelled elsewhere.
+   * @return The token.
+   */
+  [[nodiscard]] inline CancellationToken getCancellationToken() noexcept
+  {
+    if (const std::atomic<bool>* flag = detail::getThreadCancelFlag(); flag != nullptr)
+    {
+      return CancellationToken{*flag};
+    }
+
+    return isMainThread() ? CancellationToken{detail::getInterruptState().flag} : CancellationToken{};
+  }
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_CANCELLATION_HPP */
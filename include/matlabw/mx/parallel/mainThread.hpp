@@ -0,0 +1,201 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_MAIN_THREAD_HPP
+#define MATLABW_MX_PARALLEL_MAIN_THREAD_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "MpscQueue.hpp"
+
+namespace matlabw::mx::parallel
+{
+namespace detail
+{
+  /**
+   * @brief Gets the identifier of the main (MATLAB) thread.
+   * @return The identifier, default constructed if not set.
+   */
+  [[nodiscard]] inline std::atomic<std::thread::id>& getMainThreadId() noexcept
+  {
+    static std::atomic<std::thread::id> id{};
+
+    return id;
+  }
+
+  /**
+   * @brief Gets the queue of closures to be run on the main thread.
+   * @return The queue.
+   */
+  [[nodiscard]] inline MpscQueue<std::function<void()>>& getMainThreadQueue()
+  {
+    static MpscQueue<std::function<void()>> queue{};
+
+    return queue;
+  }
+
+  /// @brief Wake-up signal of threads blocked in the main thread wait loops.
+  struct MainThreadSignal
+  {
+    std::atomic<std::uint32_t> value{};     ///< Incremented on every notification.
+    std::mutex                 mutex{};     ///< Mutex of the condition.
+    std::condition_variable    condition{}; ///< Notified on every notification.
+  };
+
+  /**
+   * @brief Gets the wake-up signal of threads blocked in the main thread wait loops. Notified when a closure is posted
+   *        or a parallel loop finishes.
+   * @return The signal.
+   */
+  [[nodiscard]] inline MainThreadSignal& getMainThreadSignal() noexcept
+  {
+    static MainThreadSignal signal{};
+
+    return signal;
+  }
+
+  /// @brief Wakes the threads blocked in the main thread wait loops.
+  inline void notifyMainThread() noexcept
+  {
+    auto& signal = getMainThreadSignal();
+
+    {
+      // Changed under the mutex, so that a waiter can not miss it between its check and its wait.
+      std::lock_guard lock{signal.mutex};
+
+      signal.value.fetch_add(1, std::memory_order_release);
+    }
+
+    signal.condition.notify_all();
+  }
+
+  /**
+   * @brief Blocks until the signal changes from a value or a timeout expires, so that waiters can poll for
+   *        cancellation meanwhile.
+   * @param value The value last seen by the waiter.
+   * @param timeout The timeout.
+   */
+  inline void waitMainThreadSignal(std::uint32_t value, std::chrono::milliseconds timeout) noexcept
+  {
+    auto& signal = getMainThreadSignal();
+
+    std::unique_lock lock{signal.mutex};
+
+    signal.condition.wait_for(lock, timeout, [&]{ return signal.value.load(std::memory_order_acquire) != value; });
+  }
+} // namespace detail
+
+  /**
+   * @brief Sets the calling thread as the main thread, the only one allowed to call the MATLAB API. MEX files set it
+   *        on every call, other applications should call it once from the thread that uses the engine or MAT API.
+   */
+  inline void setMainThread() noexcept
+  {
+    detail::getMainThreadId().store(std::this_thread::get_id(), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Checks if the calling thread is the main thread.
+   * @return True if the calling thread is the main thread, or if no main thread is set.
+   */
+  [[nodiscard]] inline bool isMainThread() noexcept
+  {
+    const std::thread::id id = detail::getMainThreadId().load(std::memory_order_relaxed);
+
+    return id == std::thread::id{} || id == std::this_thread::get_id();
+  }
+
+  /**
+   * @brief Runs the closures posted to the main thread. Called by the main thread while it waits in parallelFor(),
+   *        and by MEX files before returning to MATLAB. Does nothing on other threads.
+   * @return Number of closures run.
+   * @throws The first exception thrown by a closure, the remaining closures stay queued.
+   */
+  inline std::size_t drainMainThreadQueue()
+  {
+    if (!isMainThread())
+    {
+      return 0;
+    }
+
+    auto& queue = detail::getMainThreadQueue();
+
+    std::size_t count{};
+
+    while (auto closure = queue.pop())
+    {
+      ++count;
+      (*closure)();
+    }
+
+    return count;
+  }
+
+  /**
+   * @brief Posts a closure to be run on the main thread, e.g. a progress print or a warning from a worker thread. Runs
+   *        the closure immediately if called from the main thread. The closure runs when the main thread drains the
+   *        queue, at the latest when the MEX function returns.
+   * @param closure The closure.
+   */
+  inline void postToMainThread(std::function<void()> closure)
+  {
+    if (isMainThread())
+    {
+      closure();
+      return;
+    }
+
+    detail::getMainThreadQueue().push(std::move(closure));
+    detail::notifyMainThread();
+  }
+
+  /**
+   * @brief Runs a callable on the main thread and returns a future of its result. Exceptions are stored in the future.
+   *        Waiting for the future from a worker blocks it until the main thread drains the queue.
+   * @tparam Fn Callable type.
+   * @param fn The callable.
+   * @return The future of the result.
+   */
+  template<typename Fn>
+  [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<Fn>>> invokeOnMainThread(Fn&& fn)
+  {
+    using Result = std::invoke_result_t<std::decay_t<Fn>>;
+
+    auto task   = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+    auto future = task->get_future();
+
+    postToMainThread([task]{ (*task)(); });
+
+    return future;
+  }
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_MAIN_THREAD_HPP */
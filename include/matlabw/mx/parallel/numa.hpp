@@ -0,0 +1,148 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_NUMA_HPP
+#define MATLABW_MX_PARALLEL_NUMA_HPP
+
+#include "../detail/include.hpp"
+
+#include <fstream>
+#include <thread>
+
+namespace matlabw::mx::parallel
+{
+  /// @brief NUMA node of the machine.
+  struct NumaNode
+  {
+    std::size_t              index{}; ///< Index of the node assigned by the operating system.
+    std::vector<std::size_t> cpus{};  ///< CPUs of the node.
+  };
+
+namespace detail
+{
+  /**
+   * @brief Parses a Linux CPU or node list, e.g. "0-3,8-11".
+   * @param list The list.
+   * @return The indices.
+   */
+  [[nodiscard]] inline std::vector<std::size_t> parseCpuList(std::string_view list)
+  {
+    std::vector<std::size_t> cpus{};
+
+    while (!list.empty())
+    {
+      const std::size_t      comma = list.find(',');
+      const std::string_view item  = list.substr(0, comma);
+      const std::size_t      dash  = item.find('-');
+
+      auto toNumber = [](std::string_view str)
+      {
+        std::size_t value{};
+
+        for (char c : str)
+        {
+          if (c >= '0' && c <= '9')
+          {
+            value = value * 10 + static_cast<std::size_t>(c - '0');
+          }
+        }
+
+        return value;
+      };
+
+      if (item.find_first_of("0123456789") != std::string_view::npos)
+      {
+        const std::size_t first = toNumber(item.substr(0, dash));
+        const std::size_t last  = (dash != std::string_view::npos) ? toNumber(item.substr(dash + 1)) : first;
+
+        for (std::size_t cpu{first}; cpu <= last; ++cpu)
+        {
+          cpus.push_back(cpu);
+        }
+      }
+
+      list.remove_prefix((comma != std::string_view::npos) ? comma + 1 : list.size());
+    }
+
+    return cpus;
+  }
+
+  /**
+   * @brief Detects the NUMA nodes from sysfs on Linux.
+   * @return The nodes with at least one CPU, a single node with all CPUs if the topology is unknown.
+   */
+  [[nodiscard]] inline std::vector<NumaNode> detectNumaNodes()
+  {
+    std::vector<NumaNode> nodes{};
+
+#ifdef __linux__
+    auto readLine = [](const std::string& path)
+    {
+      std::ifstream file{path};
+      std::string   line{};
+
+      std::getline(file, line);
+
+      return line;
+    };
+
+    // Node indices may have gaps, e.g. on machines with memory-only nodes, the online list skips them.
+    for (std::size_t index : parseCpuList(readLine("/sys/devices/system/node/online")))
+    {
+      auto cpus = parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(index) + "/cpulist"));
+
+      if (!cpus.empty())
+      {
+        nodes.push_back(NumaNode{index, std::move(cpus)});
+      }
+    }
+#endif
+
+    if (nodes.empty())
+    {
+      NumaNode node{};
+
+      node.cpus.resize(std::max(1u, std::thread::hardware_concurrency()));
+      std::iota(node.cpus.begin(), node.cpus.end(), std::size_t{});
+
+      nodes.push_back(std::move(node));
+    }
+
+    return nodes;
+  }
+} // namespace detail
+
+  /**
+   * @brief Gets the NUMA nodes of the machine. Detected once.
+   * @return The nodes with at least one CPU, ordered by index.
+   */
+  [[nodiscard]] inline const std::vector<NumaNode>& getNumaNodes()
+  {
+    static const std::vector<NumaNode> nodes = detail::detectNumaNodes();
+
+    return nodes;
+  }
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_NUMA_HPP */
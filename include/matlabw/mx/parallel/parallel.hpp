@@ -0,0 +1,40 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_PARALLEL_HPP
+#define MATLABW_MX_PARALLEL_PARALLEL_HPP
+
+#include "Accumulator.hpp"
+#include "cancellation.hpp"
+#include "mainThread.hpp"
+#include "MpscQueue.hpp"
+#include "parallelFor.hpp"
+#include "RandomStreams.hpp"
+#include "RingQueue.hpp"
+#include "SparseBuilder.hpp"
+#include "TaskGraph.hpp"
+#include "ThreadBudget.hpp"
+#include "ThreadPool.hpp"
+
+#endif /* MATLABW_MX_PARALLEL_PARALLEL_HPP */
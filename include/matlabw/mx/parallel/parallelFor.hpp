@@ -0,0 +1,507 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_PARALLEL_PARALLEL_FOR_HPP
+#define MATLABW_MX_PARALLEL_PARALLEL_FOR_HPP
+
+#include "../detail/include.hpp"
+
+#include <atomic>
+#include <mutex>
+
+#include "../algorithm/detail/span.hpp"
+#include "cancellation.hpp"
+#include "mainThread.hpp"
+#include "ThreadPool.hpp"
+
+namespace matlabw::mx::parallel
+{
+namespace detail
+{
+  /**
+   * @brief Range of indices owned by one participant of a parallel loop. The owner takes chunks from the front,
+   *        thieves steal the back half.
+   */
+  struct alignas(64) StealRange
+  {
+    std::mutex  mutex{}; ///< Mutex guarding the range.
+    std::size_t begin{}; ///< First index.
+    std::size_t end{};   ///< Past the end index.
+  };
+
+  /**
+   * @brief Shared state of a parallel loop. Owned jointly by the caller and the helper tasks. The loop is cancelled by
+   *        the cancellation token of the calling thread, which is also the token of the participants.
+   */
+  struct ParallelForState
+  {
+    /**
+     * @brief Constructor. Splits the range evenly between the participants at multiples of the grain.
+     * @param begin First index.
+     * @param end Past the end index.
+     * @param grain Number of indices taken at once.
+     * @param participantCount Number of participants.
+     * @param body Loop body, called with [begin, end) chunks.
+     */
+    ParallelForState(std::size_t                                     begin,
+                     std::size_t                                     end,
+                     std::size_t                                     grain,
+                     std::size_t                                     participantCount,
+                     const std::function<void(std::size_t, std::size_t)>& body)
+      : ranges{std::make_unique<StealRange[]>(participantCount)},
+        count{participantCount},
+        grain{grain},
+        remaining{end - begin},
+        token{getCancellationToken()},
+        body{body}
+    {
+      const std::size_t chunkCount = (end - begin + grain - 1) / grain;
+
+      for (std::size_t i{}; i < participantCount; ++i)
+      {
+        ranges[i].begin = std::min(end, begin + chunkCount * i / participantCount * grain);
+        ranges[i].end   = std::min(end, begin + chunkCount * (i + 1) / participantCount * grain);
+      }
+    }
+
+    /**
+     * @brief Takes the next chunk of a participant's own range.
+     * @param self Index of the participant.
+     * @param chunkBegin First index of the chunk.
+     * @param chunkEnd Past the end index of the chunk.
+     * @return True if a chunk was taken.
+     */
+    [[nodiscard]] bool take(std::size_t self, std::size_t& chunkBegin, std::size_t& chunkEnd)
+    {
+      StealRange&     range = ranges[self];
+      std::lock_guard lock{range.mutex};
+
+      if (range.begin == range.end)
+      {
+        return false;
+      }
+
+      // A cancelled loop skips the rest of the range at once.
+      chunkBegin  = range.begin;
+      chunkEnd    = cancelled.load(std::memory_order_relaxed) ? range.end : std::min(range.end, range.begin + grain);
+      range.begin = chunkEnd;
+
+      return true;
+    }
+
+    /**
+     * @brief Steals the back half of another participant's range into the own range.
+     * @param self Index of the participant.
+     * @return True if any indices were stolen.
+     */
+    [[nodiscard]] bool steal(std::size_t self)
+    {
+      for (std::size_t offset{1}; offset < count; ++offset)
+      {
+        StealRange& victim = ranges[(self + offset) % count];
+
+        std::size_t stolenBegin{};
+        std::size_t stolenEnd{};
+
+        {
+          std::lock_guard lock{victim.mutex};
+
+          const std::size_t size = victim.end - victim.begin;
+
+          if (size == 0)
+          {
+            continue;
+          }
+
+          // Steal the whole range if it is too small to be split.
+          stolenBegin  = (size >= 2 * grain) ? victim.end - size / 2 : victim.begin;
+          stolenEnd    = victim.end;
+          victim.end   = stolenBegin;
+        }
+
+        StealRange&     range = ranges[self];
+        std::lock_guard lock{range.mutex};
+
+        range.begin = stolenBegin;
+        range.end   = stolenEnd;
+
+        return true;
+      }
+
+      return false;
+    }
+
+    /**
+     * @brief Runs a participant until no work is left to take or steal.
+     * @param self Index of the participant.
+     * @param stealing Whether to steal from other participants once the own range is done.
+     */
+    void run(std::size_t self, bool stealing = true) noexcept
+    {
+      const CancellationScope scope{token};
+
+      std::size_t chunkBegin{};
+      std::size_t chunkEnd{};
+
+      while (take(self, chunkBegin, chunkEnd) || (stealing && steal(self) && take(self, chunkBegin, chunkEnd)))
+      {
+        checkCancellation();
+
+        if (!cancelled.load(std::memory_order_relaxed))
+        {
+          try
+          {
+            body(chunkBegin, chunkEnd);
+          }
+          catch (...)
+          {
+            fail(std::current_exception());
+          }
+        }
+
+        const std::size_t done = chunkEnd - chunkBegin;
+
+        if (remaining.fetch_sub(done, std::memory_order_acq_rel) == done)
+        {
+          notifyMainThread();
+        }
+      }
+    }
+
+    /**
+     * @brief Records an exception and cancels the remaining chunks.
+     * @param e The exception.
+     */
+    void fail(std::exception_ptr e) noexcept
+    {
+      std::lock_guard lock{exceptionMutex};
+
+      if (exception == nullptr)
+      {
+        exception = std::move(e);
+      }
+
+      cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    /// @brief Cancels the remaining chunks once the token is cancelled.
+    void checkCancellation() noexcept
+    {
+      if (!cancelled.load(std::memory_order_relaxed) && token.isCancelled())
+      {
+        fail(std::make_exception_ptr(CancelledException{}));
+      }
+    }
+
+    /**
+     * @brief Waits until all indices are processed. The main thread runs the closures posted to it meanwhile. The
+     *        waiter wakes up periodically to check the token, so Ctrl-C reaches loops whose chunks are all taken.
+     */
+    void wait() noexcept
+    {
+      auto& signal = getMainThreadSignal();
+
+      auto drain = [this]
+      {
+        try
+        {
+          while (drainMainThreadQueue() > 0) {}
+        }
+        catch (...)
+        {
+          fail(std::current_exception());
+        }
+      };
+
+      for (std::uint32_t value = signal.value.load(std::memory_order_acquire);;
+           value = signal.value.load(std::memory_order_acquire))
+      {
+        drain();
+
+        if (remaining.load(std::memory_order_acquire) == 0)
+        {
+          break;
+        }
+
+        checkCancellation();
+        waitMainThreadSignal(value, interruptPollInterval);
+      }
+
+      // Closures posted just before the last chunk finished.
+      drain();
+    }
+
+    std::unique_ptr<StealRange[]>                        ranges;           ///< Ranges of the participants.
+    std::size_t                                          count;            ///< Number of participants.
+    std::size_t                                          grain;            ///< Number of indices taken at once.
+    std::atomic<std::size_t>                             remaining;        ///< Number of unprocessed indices.
+    std::atomic<bool>                                    cancelled{};      ///< Set by the first exception.
+    CancellationToken                                    token;            ///< Token of the calling thread.
+    std::mutex                                           exceptionMutex{}; ///< Mutex guarding the exception.
+    std::exception_ptr                                   exception{};      ///< The first exception.
+    const std::function<void(std::size_t, std::size_t)>& body;             ///< Loop body.
+  };
+
+  /**
+   * @brief Shared state of a loop with a static partition. Each range is processed by a single participant without
+   *        stealing.
+   */
+  struct StaticForState : ParallelForState
+  {
+    /**
+     * @brief Constructor. Splits the range evenly between the participants at multiples of the grain.
+     * @param begin First index.
+     * @param end Past the end index.
+     * @param grain Number of indices taken at once.
+     * @param participantCount Number of participants.
+     * @param body Loop body, called with [begin, end) chunks.
+     */
+    StaticForState(std::size_t                                          begin,
+                   std::size_t                                          end,
+                   std::size_t                                          grain,
+                   std::size_t                                          participantCount,
+                   const std::function<void(std::size_t, std::size_t)>& body)
+      : ParallelForState{begin, end, grain, participantCount, body},
+        claimed{std::make_unique<std::atomic<bool>[]>(participantCount)}
+    {}
+
+    /**
+     * @brief Claims a range, the preferred one if it is still free. Each call claims a different range, so as many
+     *        calls as participants claim all of them.
+     * @param preferred Index of the preferred range.
+     * @return Index of the claimed range.
+     */
+    [[nodiscard]] std::size_t claim(std::size_t preferred) noexcept
+    {
+      if (preferred < count && !claimed[preferred].exchange(true, std::memory_order_relaxed))
+      {
+        return preferred;
+      }
+
+      std::size_t self{};
+
+      while (claimed[self].exchange(true, std::memory_order_relaxed))
+      {
+        ++self;
+      }
+
+      return self;
+    }
+
+    std::unique_ptr<std::atomic<bool>[]> claimed; ///< Whether the ranges are claimed.
+  };
+
+  /**
+   * @brief Wraps a loop body called per index or per chunk as a chunked loop body.
+   * @tparam Fn Loop body type, called as fn(i) for each index or as fn(chunkBegin, chunkEnd) for chunks.
+   * @param fn The loop body, must outlive the returned function.
+   * @return The chunked loop body.
+   */
+  template<typename Fn>
+  [[nodiscard]] std::function<void(std::size_t, std::size_t)> makeChunkBody(Fn& fn)
+  {
+    return [&fn](std::size_t chunkBegin, std::size_t chunkEnd)
+    {
+      if constexpr (std::is_invocable_v<Fn&, std::size_t, std::size_t>)
+      {
+        fn(chunkBegin, chunkEnd);
+      }
+      else
+      {
+        for (std::size_t i{chunkBegin}; i < chunkEnd; ++i)
+        {
+          fn(i);
+        }
+      }
+    };
+  }
+
+  /**
+   * @brief Runs a chunked loop body on the threads of a pool.
+   * @param begin First index.
+   * @param end Past the end index.
+   * @param grain Number of indices taken at once.
+   * @param body Loop body, called with [begin, end) chunks.
+   * @param pool The thread pool.
+   */
+  inline void parallelForChunks(std::size_t                                          begin,
+                                std::size_t                                          end,
+                                std::size_t                                          grain,
+                                const std::function<void(std::size_t, std::size_t)>& body,
+                                ThreadPool&                                          pool)
+  {
+    const std::size_t size       = end - begin;
+    const std::size_t chunkCount = (size + grain - 1) / grain;
+
+    // Nested loops run serially, waiting for the pool from its own worker could deadlock.
+    if (chunkCount <= 1 || pool.getThreadCount() == 0 || pool.isWorkerThread())
+    {
+      body(begin, end);
+      return;
+    }
+
+    // The calling thread runs chunks too, its BLAS calls must not spawn threads competing with the workers.
+    const ThreadBudget budget{};
+
+    const std::size_t participantCount = std::min(pool.getThreadCount() + 1, chunkCount);
+
+    auto state = std::make_shared<ParallelForState>(begin, end, grain, participantCount, body);
+
+    // Helpers that start after the loop finished find no work and never touch the body.
+    for (std::size_t i{1}; i < participantCount; ++i)
+    {
+      pool.post([state, i]{ state->run(i); });
+    }
+
+    state->run(0);
+    state->wait();
+
+    if (state->exception != nullptr)
+    {
+      std::rethrow_exception(state->exception);
+    }
+  }
+} // namespace detail
+
+  /**
+   * @brief Runs a loop in parallel on the library-managed thread pool with work stealing: every thread starts with an
+   *        equal share of the range and threads that run out steal half of the remaining work of another thread. The
+   *        calling thread participates. The body must not call the MATLAB API, use postToMainThread() instead. While
+   *        waiting, the main thread runs the posted closures. The first exception thrown by the body or by a posted
+   *        closure cancels the remaining chunks and is rethrown on the calling thread once all threads stopped.
+   * @tparam Fn Loop body type, called as fn(i) for each index or as fn(chunkBegin, chunkEnd) for chunks.
+   * @param begin First index.
+   * @param end Past the end index.
+   * @param grain Number of indices taken at once, 0 selects a grain giving each thread about 16 chunks.
+   * @param fn The loop body.
+   * @param pool The thread pool.
+   */
+  template<typename Fn>
+  void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn&& fn, ThreadPool& pool = getThreadPool())
+  {
+    if (end <= begin)
+    {
+      return;
+    }
+
+    if (grain == 0)
+    {
+      grain = std::max(std::size_t{1}, (end - begin) / ((pool.getThreadCount() + 1) * 16));
+    }
+
+    detail::parallelForChunks(begin, end, grain, detail::makeChunkBody(fn), pool);
+  }
+
+  /**
+   * @brief Runs a loop in parallel on a thread pool with a static partition: the range is split evenly at multiples of
+   *        the grain into one block per worker and worker i processes block i, unless another worker took it first
+   *        because worker i was busy. The calling thread only waits. Repeated loops over the same range so process
+   *        each block on the same worker, which together with ThreadPoolOptions::numaPinning keeps the accesses local
+   *        to the NUMA node on which the block was first touched. Otherwise it behaves like parallelFor().
+   * @tparam Fn Loop body type, called as fn(i) for each index or as fn(chunkBegin, chunkEnd) for chunks.
+   * @param begin First index.
+   * @param end Past the end index.
+   * @param grain Number of indices taken at once and granularity of the blocks, should cover whole pages.
+   * @param fn The loop body.
+   * @param pool The thread pool.
+   */
+  template<typename Fn>
+  void parallelForStatic(std::size_t begin,
+                         std::size_t end,
+                         std::size_t grain,
+                         Fn&&        fn,
+                         ThreadPool& pool = getThreadPool())
+  {
+    if (end <= begin)
+    {
+      return;
+    }
+
+    grain = std::max(std::size_t{1}, grain);
+
+    const std::function<void(std::size_t, std::size_t)> body = detail::makeChunkBody(fn);
+
+    const std::size_t chunkCount = (end - begin + grain - 1) / grain;
+
+    // Nested loops run serially, waiting for the pool from its own worker could deadlock.
+    if (chunkCount <= 1 || pool.getThreadCount() == 0 || pool.isWorkerThread())
+    {
+      body(begin, end);
+      return;
+    }
+
+    const ThreadBudget budget{};
+
+    const std::size_t blockCount = std::min(pool.getThreadCount(), chunkCount);
+
+    auto state = std::make_shared<detail::StaticForState>(begin, end, grain, blockCount, body);
+
+    // Every task claims one block, so the loop cannot finish before all tasks have started.
+    for (std::size_t i{}; i < blockCount; ++i)
+    {
+      pool.post([state, &pool]
+      {
+        state->run(state->claim(pool.getWorkerIndex().value_or(state->count)), false);
+      });
+    }
+
+    state->wait();
+
+    if (state->exception != nullptr)
+    {
+      std::rethrow_exception(state->exception);
+    }
+  }
+
+  /**
+   * @brief Calls a function for each element of an array in parallel, see parallelFor().
+   * @tparam A Array type (TypedArrayRef, TypedArray, span, ...)
+   * @tparam Fn Function type, called as fn(element) or fn(element, index).
+   * @param array The array.
+   * @param fn The function.
+   * @param grain Number of elements taken at once, 0 selects it automatically.
+   * @param pool The thread pool.
+   */
+  template<typename A, typename Fn>
+  void forEach(A&& array, Fn&& fn, std::size_t grain = 0, ThreadPool& pool = getThreadPool())
+  {
+    auto span = algorithm::detail::toSpan(array);
+
+    using Element = typename decltype(span)::element_type;
+
+    parallelFor(0, span.size(), grain, [&](std::size_t i)
+    {
+      if constexpr (std::is_invocable_v<Fn&, Element&, std::size_t>)
+      {
+        fn(span[i], i);
+      }
+      else
+      {
+        fn(span[i]);
+      }
+    }, pool);
+  }
+} // namespace matlabw::mx::parallel
+
+#endif /* MATLABW_MX_PARALLEL_PARALLEL_FOR_HPP */
@@ -157,6 +157,33 @@ namespace matlabw::mx
   {
     setProperty(array, 0, propName.data(), value);
   }
+
+  /**
+   * @brief Sets a property of all elements of the object array
+   * @param array Array
+   * @param propName Property name
+   * @param values Property values, one per element or a single value set to all elements
+   */
+  inline void setProperties(const ArrayRef                  array,
+                            const std::string_view          propName,
+                            const std::span<const ArrayCref> values)
+  {
+    static constexpr char id[]{"matlabw:mx:setProperties"};
+
+    const std::size_t size = array.getSize();
+
+    if (values.size() != size && values.size() != 1)
+    {
+      throw Exception{id, "number of values must match the number of elements or be 1"};
+    }
+
+    const std::string name{propName};
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+      mxSetProperty(array.get(), i, name.c_str(), values[(values.size() == 1) ? 0 : i].get());
+    }
+  }
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_PROPERTY_HPP */
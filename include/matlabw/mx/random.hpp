@@ -0,0 +1,474 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+#ifndef MATLABW_MX_RANDOM_HPP
+#define MATLABW_MX_RANDOM_HPP
+
+#include "detail/include.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+#include <utility>
+
+#include "Exception.hpp"
+
+/// @brief Marks functions callable from both host and device code when compiled by nvcc.
+#ifndef MATLABW_GPU_HOST_DEVICE
+# ifdef __CUDACC__
+#  define MATLABW_GPU_HOST_DEVICE __host__ __device__
+# else
+#  define MATLABW_GPU_HOST_DEVICE
+# endif
+#endif
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /// @brief Multipliers of the Philox4x32 rounds.
+  inline constexpr std::uint32_t philoxMultiplier0{0xD2511F53};
+  inline constexpr std::uint32_t philoxMultiplier1{0xCD9E8D57};
+
+  /// @brief Weyl increments of the Philox4x32 key schedule.
+  inline constexpr std::uint32_t philoxWeyl0{0x9E3779B9};
+  inline constexpr std::uint32_t philoxWeyl1{0xBB67AE85};
+
+  /// @brief Number of rounds, 10 is the smallest number passing BigCrush with a safety margin.
+  inline constexpr int philoxRounds{10};
+
+  /// @brief Key of the substream derivation, keeps the substream keys apart from the counters of the parent.
+  inline constexpr std::uint32_t philoxSubstreamTag{0x7F4A7C15};
+
+  /// @brief Counter or output of the Philox4x32 generator, four 32-bit words.
+  struct PhiloxBlock
+  {
+    std::uint32_t v[4]; ///< The words
+  };
+
+  /**
+   * @brief One round of the Philox4x32 bijection.
+   * @param ctr The counter, updated in place
+   * @param k0 First word of the round key
+   * @param k1 Second word of the round key
+   */
+  MATLABW_GPU_HOST_DEVICE inline void philoxRound(PhiloxBlock& ctr, std::uint32_t k0, std::uint32_t k1) noexcept
+  {
+    const std::uint64_t p0 = std::uint64_t{philoxMultiplier0} * ctr.v[0];
+    const std::uint64_t p1 = std::uint64_t{philoxMultiplier1} * ctr.v[2];
+
+    ctr = PhiloxBlock{{static_cast<std::uint32_t>(p1 >> 32) ^ ctr.v[1] ^ k0,
+                       static_cast<std::uint32_t>(p1),
+                       static_cast<std::uint32_t>(p0 >> 32) ^ ctr.v[3] ^ k1,
+                       static_cast<std::uint32_t>(p0)}};
+  }
+
+  /**
+   * @brief Philox4x32-10 bijection of Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC 2011. Maps a
+   *        counter to four random words, only multiplies and xors, so loops over counters vectorize.
+   * @param ctr The counter
+   * @param k0 First word of the key
+   * @param k1 Second word of the key
+   * @return The random words
+   */
+  [[nodiscard]] MATLABW_GPU_HOST_DEVICE inline PhiloxBlock philox(PhiloxBlock   ctr,
+                                                                  std::uint32_t k0,
+                                                                  std::uint32_t k1) noexcept
+  {
+    for (int r{}; r < philoxRounds; ++r)
+    {
+      philoxRound(ctr, k0, k1);
+
+      k0 += philoxWeyl0;
+      k1 += philoxWeyl1;
+    }
+
+    return ctr;
+  }
+
+  /**
+   * @brief Range of consecutive counters reserved from a generator. Trivially copyable, so it is passed by value to
+   *        worker threads and __global__ functions, which compute block b of the range independently.
+   */
+  struct PhiloxRange
+  {
+    std::uint64_t first{};  ///< Counter of the first block
+    std::uint64_t stream{}; ///< Stream of the generator, the upper half of the counter
+    std::uint32_t k0{};     ///< First word of the key
+    std::uint32_t k1{};     ///< Second word of the key
+
+    /**
+     * @brief Computes a block of the range.
+     * @param b Index of the block
+     * @return The random words
+     */
+    [[nodiscard]] MATLABW_GPU_HOST_DEVICE PhiloxBlock operator()(std::uint64_t b) const noexcept
+    {
+      const std::uint64_t c = first + b;
+
+      return philox(PhiloxBlock{{static_cast<std::uint32_t>(c), static_cast<std::uint32_t>(c >> 32),
+                                 static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)}},
+                    k0, k1);
+    }
+  };
+
+  /**
+   * @brief Converts 53 random bits to a uniform double in the open interval (0, 1), as MATLAB rand.
+   * @param hi Upper random word
+   * @param lo Lower random word
+   * @return The value
+   */
+  [[nodiscard]] MATLABW_GPU_HOST_DEVICE inline double toUniform53(std::uint32_t hi, std::uint32_t lo) noexcept
+  {
+    const std::uint64_t bits = ((std::uint64_t{hi} << 32) | lo) >> 11;
+
+    return (static_cast<double>(bits) + 0.5) * 0x1p-53;
+  }
+
+  /**
+   * @brief Converts 24 random bits to a uniform float in the open interval (0, 1).
+   * @param word Random word
+   * @return The value
+   */
+  [[nodiscard]] MATLABW_GPU_HOST_DEVICE inline float toUniform24(std::uint32_t word) noexcept
+  {
+    return (static_cast<float>(word >> 8) + 0.5f) * 0x1p-24f;
+  }
+
+  /**
+   * @brief Uniform distribution on (0, 1), values of a block are written at once.
+   * @tparam T Value type, float or double
+   */
+  template<typename T>
+  struct UniformDistribution
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "uniform values must be float or double");
+
+    /// @brief Number of values generated from one block.
+    static constexpr std::size_t count = std::is_same_v<T, float> ? 4 : 2;
+
+    /**
+     * @brief Generates the values of a block.
+     * @param block The random words
+     * @param out Output of count values
+     */
+    MATLABW_GPU_HOST_DEVICE void operator()(const PhiloxBlock& block, T* out) const noexcept
+    {
+      if constexpr (std::is_same_v<T, float>)
+      {
+        for (std::size_t k{}; k < 4; ++k)
+        {
+          out[k] = toUniform24(block.v[k]);
+        }
+      }
+      else
+      {
+        out[0] = toUniform53(block.v[0], block.v[1]);
+        out[1] = toUniform53(block.v[2], block.v[3]);
+      }
+    }
+  };
+
+  /**
+   * @brief Normal distribution, pairs of uniform values are transformed by the Box-Muller method.
+   * @tparam T Value type, float or double
+   */
+  template<typename T>
+  struct NormalDistribution
+  {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "normal values must be float or double");
+
+    /// @brief Number of values generated from one block.
+    static constexpr std::size_t count = std::is_same_v<T, float> ? 4 : 2;
+
+    T mean{};  ///< The mean
+    T sigma{}; ///< The standard deviation
+
+    /**
+     * @brief Transforms a pair of uniform values to a pair of normal values.
+     * @param u1 First uniform value in (0, 1)
+     * @param u2 Second uniform value in (0, 1)
+     * @param out Output of two values
+     */
+    MATLABW_GPU_HOST_DEVICE void transform(T u1, T u2, T* out) const noexcept
+    {
+      const T radius = sigma * std::sqrt(T{-2} * std::log(u1));
+      const T angle  = T{2} * std::numbers::pi_v<T> * u2;
+
+      out[0] = mean + radius * std::cos(angle);
+      out[1] = mean + radius * std::sin(angle);
+    }
+
+    /**
+     * @brief Generates the values of a block.
+     * @param block The random words
+     * @param out Output of count values
+     */
+    MATLABW_GPU_HOST_DEVICE void operator()(const PhiloxBlock& block, T* out) const noexcept
+    {
+      if constexpr (std::is_same_v<T, float>)
+      {
+        transform(toUniform24(block.v[0]), toUniform24(block.v[1]), out);
+        transform(toUniform24(block.v[2]), toUniform24(block.v[3]), out + 2);
+      }
+      else
+      {
+        transform(toUniform53(block.v[0], block.v[1]), toUniform53(block.v[2], block.v[3]), out);
+      }
+    }
+  };
+
+  /**
+   * @brief Uniform distribution of the integers lo to hi, as MATLAB randi. A 64-bit random value is scaled to the
+   *        width by a multiply, which keeps the counters of the values fixed at a bias below 2^-32.
+   * @tparam T Value type, integral or floating point
+   */
+  template<typename T>
+  struct IntegerDistribution
+  {
+    /// @brief Number of values generated from one block.
+    static constexpr std::size_t count = 2;
+
+    std::int64_t  lo{};    ///< The smallest value
+    std::uint64_t width{}; ///< Number of values, at most 2^32
+
+    /**
+     * @brief Scales a 64-bit random value to the range.
+     * @param hi Upper random word
+     * @param lo Lower random word
+     * @return The value
+     */
+    [[nodiscard]] MATLABW_GPU_HOST_DEVICE T scale(std::uint32_t hi, std::uint32_t lo) const noexcept
+    {
+      // floor(r * width / 2^64) of r = hi * 2^32 + lo, exact for widths up to 2^32.
+      const std::uint64_t offset = (std::uint64_t{hi} * width + ((std::uint64_t{lo} * width) >> 32)) >> 32;
+
+      return static_cast<T>(this->lo + static_cast<std::int64_t>(offset));
+    }
+
+    /**
+     * @brief Generates the values of a block.
+     * @param block The random words
+     * @param out Output of count values
+     */
+    MATLABW_GPU_HOST_DEVICE void operator()(const PhiloxBlock& block, T* out) const noexcept
+    {
+      out[0] = scale(block.v[0], block.v[1]);
+      out[1] = scale(block.v[2], block.v[3]);
+    }
+  };
+
+  /**
+   * @brief Makes the distribution of integers lo to hi, checked to be representable by the value type.
+   * @tparam T Value type
+   * @param lo The smallest value
+   * @param hi The largest value
+   * @return The distribution
+   */
+  template<typename T>
+  [[nodiscard]] IntegerDistribution<T> makeIntegerDistribution(std::int64_t lo, std::int64_t hi)
+  {
+    static constexpr char id[]{"matlabw:mx:makeIntegerDistribution"};
+
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "integers must be numeric");
+
+    if (hi < lo)
+    {
+      throw Exception{id, "upper bound must not be less than lower bound"};
+    }
+
+    const std::uint64_t width = static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo) + 1;
+
+    if (width == 0 || width > (std::uint64_t{1} << 32))
+    {
+      throw Exception{id, "range must not exceed 2^32 values"};
+    }
+
+    if constexpr (std::is_integral_v<T>)
+    {
+      if (std::cmp_less(lo, std::numeric_limits<T>::min()) || std::cmp_greater(hi, std::numeric_limits<T>::max()))
+      {
+        throw Exception{id, "range exceeds the output type"};
+      }
+    }
+    else
+    {
+      constexpr auto maxExact = std::int64_t{1} << std::numeric_limits<T>::digits;
+
+      if (lo < -maxExact || hi > maxExact)
+      {
+        throw Exception{id, "range exceeds the integers exactly representable by the output type"};
+      }
+    }
+
+    return IntegerDistribution<T>{lo, width};
+  }
+} // namespace detail
+
+  /**
+   * @brief Counter-based Philox4x32-10 random number generator. Block c of the sequence is a pure function of the
+   *        seed, the stream and c, so any part of the sequence is computed independently: large arrays are filled
+   *        in parallel with the same values for any number of threads, and on the GPU with the same values as on the
+   *        CPU. Also a UniformRandomBitGenerator for the standard distributions, which is the slow path.
+   *
+   *          mx::Philox rng{seed};
+   *          mx::algorithm::fillNormal(out, rng);
+   */
+  class Philox
+  {
+    public:
+      using result_type = std::uint32_t; ///< Type of the random words
+
+      /// @brief Number of random words of a block.
+      static constexpr std::size_t blockSize{4};
+
+      /**
+       * @brief Constructor.
+       * @param seed The seed, the key of the generator
+       * @param stream The stream, generators with the same seed and different streams are independent
+       */
+      explicit Philox(std::uint64_t seed = 0, std::uint64_t stream = 0) noexcept
+      : mSeed{seed}, mStream{stream}
+      {}
+
+      /**
+       * @brief Gets the smallest random word.
+       * @return 0
+       */
+      [[nodiscard]] static constexpr result_type min() noexcept
+      {
+        return 0;
+      }
+
+      /**
+       * @brief Gets the largest random word.
+       * @return 2^32 - 1
+       */
+      [[nodiscard]] static constexpr result_type max() noexcept
+      {
+        return std::numeric_limits<result_type>::max();
+      }
+
+      /**
+       * @brief Gets the seed.
+       * @return The seed
+       */
+      [[nodiscard]] std::uint64_t getSeed() const noexcept
+      {
+        return mSeed;
+      }
+
+      /**
+       * @brief Gets the stream.
+       * @return The stream
+       */
+      [[nodiscard]] std::uint64_t getStream() const noexcept
+      {
+        return mStream;
+      }
+
+      /**
+       * @brief Gets the counter of the next block, the position in the sequence.
+       * @return The counter
+       */
+      [[nodiscard]] std::uint64_t getCounter() const noexcept
+      {
+        return mCounter;
+      }
+
+      /**
+       * @brief Sets the position in the sequence, discarding the buffered words.
+       * @param counter Counter of the next block
+       */
+      void setCounter(std::uint64_t counter) noexcept
+      {
+        mCounter     = counter;
+        mBufferIndex = blockSize;
+      }
+
+      /**
+       * @brief Skips blocks of the sequence in constant time, discarding the buffered words.
+       * @param blocks Number of blocks to skip
+       */
+      void discard(std::uint64_t blocks) noexcept
+      {
+        setCounter(mCounter + blocks);
+      }
+
+      /**
+       * @brief Gets the next random word.
+       * @return The word
+       */
+      result_type operator()() noexcept
+      {
+        if (mBufferIndex == blockSize)
+        {
+          mBuffer      = reserve(1)(0);
+          mBufferIndex = 0;
+        }
+
+        return mBuffer.v[mBufferIndex++];
+      }
+
+      /**
+       * @brief Reserves consecutive blocks of the sequence, the generator continues after them.
+       * @param blocks Number of blocks
+       * @return The range of the blocks
+       */
+      [[nodiscard]] detail::PhiloxRange reserve(std::uint64_t blocks) noexcept
+      {
+        const detail::PhiloxRange range{mCounter, mStream, static_cast<std::uint32_t>(mSeed),
+                                        static_cast<std::uint32_t>(mSeed >> 32)};
+
+        mCounter += blocks;
+
+        return range;
+      }
+
+      /**
+       * @brief Gets an independent substream, e.g. for a task or a thread. The key of the substream is derived from
+       *        the key, the stream and the index, so the substreams form a reproducible tree.
+       * @param index Index of the substream
+       * @return The generator of the substream, at its start
+       */
+      [[nodiscard]] Philox getSubstream(std::uint64_t index) const noexcept
+      {
+        const detail::PhiloxBlock key = detail::philox(
+          detail::PhiloxBlock{{static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+                               static_cast<std::uint32_t>(mStream), static_cast<std::uint32_t>(mStream >> 32)}},
+          static_cast<std::uint32_t>(mSeed) ^ detail::philoxSubstreamTag, static_cast<std::uint32_t>(mSeed >> 32));
+
+        return Philox{(std::uint64_t{key.v[1]} << 32) | key.v[0], (std::uint64_t{key.v[3]} << 32) | key.v[2]};
+      }
+    private:
+      std::uint64_t       mSeed{};                 ///< The seed
+      std::uint64_t       mStream{};               ///< The stream
+      std::uint64_t       mCounter{};              ///< Counter of the next block
+      detail::PhiloxBlock mBuffer{};               ///< Words of the last block of operator()
+      std::size_t         mBufferIndex{blockSize}; ///< Index of the next buffered word
+  };
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_RANDOM_HPP */
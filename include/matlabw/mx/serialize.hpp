@@ -0,0 +1,908 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MX_SERIALIZE_HPP
+#define MATLABW_MX_SERIALIZE_HPP
+
+#include "detail/include.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+# define MATLABW_SERIALIZE_POSIX
+# include <fcntl.h>
+# include <limits.h>
+# include <sys/uio.h>
+# include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+#include "Array.hpp"
+#include "codec.hpp"
+#include "visit.hpp"
+
+namespace matlabw::mx
+{
+namespace detail
+{
+  /// @brief Identifies a serialized array stream.
+  inline constexpr std::uint32_t serialMagic{0x4253574d};
+
+  /// @brief Version of the serialized format.
+  inline constexpr std::uint16_t serialVersion{1};
+
+  /// @brief Version of the serialized format with encoded payloads, written only if payloads may be encoded.
+  inline constexpr std::uint16_t serialEncodedVersion{2};
+
+  /// @brief Written in native byte order, detects streams of a foreign byte order.
+  inline constexpr std::uint16_t serialByteOrderMark{0x0102};
+
+  /// @brief Alignment of payloads from the start of the stream.
+  inline constexpr std::size_t serialPayloadAlignment{64};
+
+  /// @brief Alignment of records from the start of the stream.
+  inline constexpr std::size_t serialRecordAlignment{8};
+
+  /// @brief Maximum nesting depth of cells and structs accepted by the deserializer.
+  inline constexpr std::size_t serialMaxDepth{256};
+
+  /// @brief Flags of a serialized node.
+  enum SerialFlags : std::uint8_t
+  {
+    serialComplex = 1, ///< The array is complex.
+    serialSparse  = 2, ///< The array is sparse.
+    serialNull    = 4, ///< Unset cell element or struct field.
+  };
+
+  /// @brief Header of a serialized node, followed by the dimensions.
+  struct SerialNodeHeader
+  {
+    std::uint8_t  classId;  ///< The class ID.
+    std::uint8_t  flags;    ///< The SerialFlags.
+    std::uint16_t codec;    ///< The Codec of the payload of a dense leaf, zero (raw) in version 1.
+    std::uint32_t rank;     ///< The number of dimensions.
+  };
+
+  static_assert(sizeof(SerialNodeHeader) == serialRecordAlignment);
+
+  /**
+   * @brief Gets the padding to an alignment.
+   * @param offset The offset.
+   * @param alignment The alignment, a power of two.
+   * @return The padding in bytes.
+   */
+  [[nodiscard]] constexpr std::size_t getSerialPadding(std::size_t offset, std::size_t alignment) noexcept
+  {
+    return (alignment - (offset & (alignment - 1))) & (alignment - 1);
+  }
+
+  /**
+   * @brief Checks if a class is stored as a dense or sparse leaf.
+   * @param classId The class ID.
+   * @return True for numeric, logical and char arrays.
+   */
+  [[nodiscard]] constexpr bool isSerialLeaf(ClassId classId) noexcept
+  {
+    return classId == ClassId::logical || classId == ClassId::_char ||
+           (classId >= ClassId::_double && classId <= ClassId::uint64);
+  }
+
+  /// @brief Deserialization source reading from memory.
+  class SerialBufferSource
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param bytes The serialized bytes.
+       */
+      explicit SerialBufferSource(View<std::byte> bytes) noexcept
+      : mBytes{bytes}
+      {}
+
+      /**
+       * @brief Reads bytes.
+       * @param data The destination.
+       * @param size The number of bytes.
+       */
+      void read(void* data, std::size_t size)
+      {
+        check(size);
+
+        if (size > 0)
+        {
+          std::memcpy(data, mBytes.data() + mOffset, size);
+        }
+
+        mOffset += size;
+      }
+
+      /**
+       * @brief Skips bytes.
+       * @param size The number of bytes.
+       */
+      void skip(std::size_t size)
+      {
+        check(size);
+        mOffset += size;
+      }
+
+      /**
+       * @brief Gets the offset from the start of the stream.
+       * @return The offset in bytes.
+       */
+      [[nodiscard]] std::size_t getOffset() const noexcept
+      {
+        return mOffset;
+      }
+
+    private:
+      /**
+       * @brief Checks that enough bytes remain.
+       * @param size The number of bytes.
+       */
+      void check(std::size_t size) const
+      {
+        if (size > mBytes.size() - mOffset)
+        {
+          throw Exception{"matlabw:mx:deserialize", "serialized data are truncated"};
+        }
+      }
+
+      View<std::byte> mBytes;    ///< The serialized bytes.
+      std::size_t     mOffset{}; ///< The offset of the next byte.
+  };
+
+  /// @brief Deserialization source reading from a file, payloads are read directly into the arrays.
+  class SerialFileSource
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param file The file, positioned at the start of the stream.
+       */
+      explicit SerialFileSource(std::FILE* file) noexcept
+      : mFile{file}
+      {}
+
+      /**
+       * @brief Reads bytes.
+       * @param data The destination.
+       * @param size The number of bytes.
+       */
+      void read(void* data, std::size_t size)
+      {
+        if (std::fread(data, 1, size, mFile) != size)
+        {
+          throw Exception{"matlabw:mx:loadSerialized", "serialized file is truncated"};
+        }
+
+        mOffset += size;
+      }
+
+      /**
+       * @brief Skips bytes.
+       * @param size The number of bytes, at most the payload alignment.
+       */
+      void skip(std::size_t size)
+      {
+        std::byte padding[serialPayloadAlignment];
+
+        read(padding, size);
+      }
+
+      /**
+       * @brief Gets the offset from the start of the stream.
+       * @return The offset in bytes.
+       */
+      [[nodiscard]] std::size_t getOffset() const noexcept
+      {
+        return mOffset;
+      }
+
+    private:
+      std::FILE*  mFile;     ///< The file.
+      std::size_t mOffset{}; ///< The offset of the next byte.
+  };
+
+  /**
+   * @brief Reads a value.
+   * @tparam T The type of the value.
+   * @tparam Source The source type.
+   * @param source The source.
+   * @return The value.
+   */
+  template<typename T, typename Source>
+  [[nodiscard]] T readSerialValue(Source& source)
+  {
+    T value{};
+    source.read(&value, sizeof(T));
+
+    return value;
+  }
+
+  /**
+   * @brief Reads a payload aligned to the payload alignment, followed by padding to the record alignment.
+   * @tparam Source The source type.
+   * @param source The source.
+   * @param data The destination.
+   * @param size The size in bytes.
+   */
+  template<typename Source>
+  void readSerialPayload(Source& source, void* data, std::size_t size)
+  {
+    source.skip(getSerialPadding(source.getOffset(), serialPayloadAlignment));
+    source.read(data, size);
+    source.skip(getSerialPadding(source.getOffset(), serialRecordAlignment));
+  }
+
+  /**
+   * @brief Multiplies sizes, throwing on overflow.
+   * @param a The first size.
+   * @param b The second size.
+   * @return The product.
+   */
+  [[nodiscard]] inline std::size_t multiplySerialSizes(std::size_t a, std::size_t b)
+  {
+    if (b != 0 && a > std::numeric_limits<std::size_t>::max() / b)
+    {
+      throw Exception{"matlabw:mx:deserialize", "serialized array is too large"};
+    }
+
+    return a * b;
+  }
+
+  /**
+   * @brief Reads a node, each leaf is allocated once and its payload read directly into it.
+   * @tparam Source The source type.
+   * @param source The source.
+   * @param depth The nesting depth.
+   * @return The array, invalid for a null node.
+   */
+  template<typename Source>
+  [[nodiscard]] Array readSerialNode(Source& source, std::size_t depth)
+  {
+    static constexpr char id[]{"matlabw:mx:deserialize"};
+
+    if (depth > serialMaxDepth)
+    {
+      throw Exception{id, "serialized array is nested too deeply"};
+    }
+
+    const auto header = readSerialValue<SerialNodeHeader>(source);
+
+    if (header.flags & serialNull)
+    {
+      return Array{};
+    }
+
+    if (header.rank < 2 || header.rank > 64)
+    {
+      throw Exception{id, "invalid rank of serialized array"};
+    }
+
+    std::size_t dims[64]{};
+    std::size_t count{1};
+
+    source.read(dims, header.rank * sizeof(std::size_t));
+
+    for (std::size_t r{}; r < header.rank; ++r)
+    {
+      count = multiplySerialSizes(count, dims[r]);
+    }
+
+    const auto classId = static_cast<ClassId>(header.classId);
+    const auto flag    = (header.flags & serialComplex) ? mxCOMPLEX : mxREAL;
+
+    if (header.flags & serialSparse)
+    {
+      if (header.rank != 2 || (classId != ClassId::_double && classId != ClassId::logical))
+      {
+        throw Exception{id, "invalid serialized sparse array"};
+      }
+
+      const auto nnz = readSerialValue<std::size_t>(source);
+
+      Array array{(classId == ClassId::logical)
+                    ? mxCreateSparseLogicalMatrix(dims[0], dims[1], std::max<std::size_t>(nnz, 1))
+                    : mxCreateSparse(dims[0], dims[1], std::max<std::size_t>(nnz, 1), flag)};
+
+      readSerialPayload(source, mxGetJc(array.get()), multiplySerialSizes(dims[1] + 1, sizeof(mwIndex)));
+      readSerialPayload(source, mxGetIr(array.get()), multiplySerialSizes(nnz, sizeof(mwIndex)));
+      readSerialPayload(source, mxGetData(array.get()), multiplySerialSizes(nnz, mxGetElementSize(array.get())));
+
+      if (mxGetJc(array.get())[dims[1]] != nnz)
+      {
+        throw Exception{id, "invalid serialized sparse array"};
+      }
+
+      return array;
+    }
+
+    switch (classId)
+    {
+      case ClassId::cell:
+      {
+        Array array{mxCreateCellArray(header.rank, dims)};
+
+        for (std::size_t i{}; i < count; ++i)
+        {
+          if (Array element = readSerialNode(source, depth + 1); element.isValid())
+          {
+            mxSetCell(array.get(), i, element.release());
+          }
+        }
+
+        return array;
+      }
+      case ClassId::_struct:
+      {
+        const auto fieldCount = readSerialValue<std::uint64_t>(source);
+
+        if (fieldCount > 65535)
+        {
+          throw Exception{id, "invalid field count of serialized struct"};
+        }
+
+        std::vector<std::string> names(fieldCount);
+        std::vector<const char*> namePtrs(fieldCount);
+
+        for (std::size_t k{}; k < fieldCount; ++k)
+        {
+          const auto length = readSerialValue<std::uint64_t>(source);
+
+          if (length == 0 || length > mxMAXNAM)
+          {
+            throw Exception{id, "invalid field name of serialized struct"};
+          }
+
+          names[k].resize(length);
+          source.read(names[k].data(), length);
+          source.skip(getSerialPadding(source.getOffset(), serialRecordAlignment));
+          namePtrs[k] = names[k].c_str();
+        }
+
+        Array array{mxCreateStructArray(header.rank, dims, static_cast<int>(fieldCount), namePtrs.data())};
+
+        for (std::size_t i{}; i < count; ++i)
+        {
+          for (std::size_t k{}; k < fieldCount; ++k)
+          {
+            if (Array field = readSerialNode(source, depth + 1); field.isValid())
+            {
+              mxSetFieldByNumber(array.get(), i, static_cast<int>(k), field.release());
+            }
+          }
+        }
+
+        return array;
+      }
+      default:
+      {
+        if (!isSerialLeaf(classId))
+        {
+          throw Exception{id, "invalid class of serialized array"};
+        }
+
+        const auto bytes = readSerialValue<std::uint64_t>(source);
+
+        Array array{(classId == ClassId::logical) ? mxCreateLogicalArray(header.rank, dims)
+                  : (classId == ClassId::_char)   ? mxCreateCharArray(header.rank, dims)
+                  : mxCreateUninitNumericArray(header.rank, dims, static_cast<mxClassID>(classId), flag)};
+
+        if (bytes != multiplySerialSizes(count, mxGetElementSize(array.get())))
+        {
+          throw Exception{id, "invalid payload size of serialized array"};
+        }
+
+        if (header.codec != static_cast<std::uint16_t>(Codec::raw))
+        {
+          if (header.codec > static_cast<std::uint16_t>(Codec::bitPack))
+          {
+            throw Exception{id, "invalid codec of serialized array"};
+          }
+
+          const auto encodedBytes = readSerialValue<std::uint64_t>(source);
+
+          // Run lengths of single byte elements take at most five bytes per element
+          if (encodedBytes > multiplySerialSizes(bytes, 5) + sizeof(std::uint64_t))
+          {
+            throw Exception{id, "invalid payload size of serialized array"};
+          }
+
+          std::vector<std::byte> encoded(encodedBytes);
+
+          readSerialPayload(source, encoded.data(), encoded.size());
+          decode(View<std::byte>{encoded.data(), encoded.size()}, static_cast<Codec>(header.codec), array);
+
+          return array;
+        }
+
+        readSerialPayload(source, mxGetData(array.get()), bytes);
+
+        return array;
+      }
+    }
+  }
+
+  /**
+   * @brief Reads a stream.
+   * @tparam Source The source type.
+   * @param source The source.
+   * @return The array.
+   */
+  template<typename Source>
+  [[nodiscard]] Array readSerialStream(Source& source)
+  {
+    static constexpr char id[]{"matlabw:mx:deserialize"};
+
+    const auto magic     = readSerialValue<std::uint32_t>(source);
+    const auto version   = readSerialValue<std::uint16_t>(source);
+    const auto byteOrder = readSerialValue<std::uint16_t>(source);
+
+    if (magic != serialMagic || byteOrder != serialByteOrderMark)
+    {
+      throw Exception{id, "data are not a serialized array of this byte order"};
+    }
+
+    if (version != serialVersion && version != serialEncodedVersion)
+    {
+      throw Exception{id, "unsupported version of serialized array"};
+    }
+
+    Array array = readSerialNode(source, 0);
+
+    if (!array.isValid())
+    {
+      throw Exception{id, "serialized array is empty"};
+    }
+
+    return array;
+  }
+} // namespace detail
+
+  /**
+   * @brief Serialized form of an array tree of numeric, logical, char, sparse, cell and struct arrays, built without
+   *        copying the payloads. The format is length-prefixed with payloads aligned to 64 bytes and is meant for
+   *        caches and transport between processes of the same byte order. The segments reference the data of the
+   *        array, which must not be modified or destroyed while they are used.
+   */
+  class SerializedArray
+  {
+    public:
+      /**
+       * @brief Constructor, walks the array tree.
+       * @param array The array.
+       */
+      explicit SerializedArray(ArrayCref array)
+      {
+        putValue(detail::serialMagic);
+        putValue(detail::serialVersion);
+        putValue(detail::serialByteOrderMark);
+        putNode(array.get());
+        flushMeta();
+      }
+
+      /**
+       * @brief Constructor, walks the array tree and encodes the compressible dense payloads, see compress(). The
+       *        encoded payloads are owned by this object, the others reference the array data.
+       * @param array The array.
+       * @param options The codec options.
+       */
+      SerializedArray(ArrayCref array, const CodecOptions& options)
+      : mCodecOptions{options}
+      {
+        putValue(detail::serialMagic);
+        putValue(detail::serialEncodedVersion);
+        putValue(detail::serialByteOrderMark);
+        putNode(array.get());
+        flushMeta();
+      }
+
+      /**
+       * @brief Gets the segments of the stream, written in order they form the serialized data.
+       * @return The segments.
+       */
+      [[nodiscard]] View<View<std::byte>> getSegments() const noexcept
+      {
+        return mSegments;
+      }
+
+      /**
+       * @brief Gets the size of the serialized data.
+       * @return The size in bytes.
+       */
+      [[nodiscard]] std::size_t getSize() const noexcept
+      {
+        return mSize;
+      }
+
+      /**
+       * @brief Copies the serialized data to contiguous memory.
+       * @return The serialized data.
+       */
+      [[nodiscard]] std::vector<std::byte> toBytes() const
+      {
+        std::vector<std::byte> bytes(mSize);
+        std::byte*             out = bytes.data();
+
+        for (const auto& segment : mSegments)
+        {
+          out = std::copy(segment.begin(), segment.end(), out);
+        }
+
+        return bytes;
+      }
+
+      /**
+       * @brief Writes the serialized data to a file, with gather writes where available.
+       * @param filename The filename.
+       */
+      void save(const char* filename) const
+      {
+        static constexpr char id[]{"matlabw:mx:SerializedArray:save"};
+
+#     ifdef MATLABW_SERIALIZE_POSIX
+        const int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd < 0)
+        {
+          throw Exception{id, "failed to open file"};
+        }
+
+        std::vector<iovec> iov(mSegments.size());
+
+        std::transform(mSegments.begin(), mSegments.end(), iov.begin(), [](View<std::byte> segment)
+        {
+          return iovec{const_cast<std::byte*>(segment.data()), segment.size()};
+        });
+
+        std::size_t first{};
+
+        while (first < iov.size())
+        {
+          const int     count   = static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+          const ssize_t written = ::writev(fd, iov.data() + first, count);
+
+          if (written < 0)
+          {
+            ::close(fd);
+            throw Exception{id, "failed to write file"};
+          }
+
+          // Skips the fully written segments and advances into a partially written one.
+          auto remaining = static_cast<std::size_t>(written);
+
+          while (first < iov.size() && remaining >= iov[first].iov_len)
+          {
+            remaining -= iov[first++].iov_len;
+          }
+
+          if (first < iov.size())
+          {
+            iov[first].iov_base  = static_cast<std::byte*>(iov[first].iov_base) + remaining;
+            iov[first].iov_len  -= remaining;
+          }
+        }
+
+        if (::close(fd) != 0)
+        {
+          throw Exception{id, "failed to write file"};
+        }
+#     else
+        std::FILE* file = std::fopen(filename, "wb");
+
+        if (file == nullptr)
+        {
+          throw Exception{id, "failed to open file"};
+        }
+
+        for (const auto& segment : mSegments)
+        {
+          if (std::fwrite(segment.data(), 1, segment.size(), file) != segment.size())
+          {
+            std::fclose(file);
+            throw Exception{id, "failed to write file"};
+          }
+        }
+
+        if (std::fclose(file) != 0)
+        {
+          throw Exception{id, "failed to write file"};
+        }
+#     endif
+      }
+
+    private:
+      /// @brief Zero bytes used for padding.
+      static constexpr std::byte padding[detail::serialPayloadAlignment]{};
+
+      /**
+       * @brief Appends a value to the metadata.
+       * @tparam T The type of the value.
+       * @param value The value.
+       */
+      template<typename T>
+      void putValue(const T& value)
+      {
+        putBytes(&value, sizeof(T));
+      }
+
+      /**
+       * @brief Appends bytes to the metadata.
+       * @param data The bytes.
+       * @param size The number of bytes.
+       */
+      void putBytes(const void* data, std::size_t size)
+      {
+        const auto* bytes = static_cast<const std::byte*>(data);
+
+        mMeta.back().insert(mMeta.back().end(), bytes, bytes + size);
+        mSize += size;
+      }
+
+      /**
+       * @brief Appends padding to an alignment to the metadata.
+       * @param alignment The alignment.
+       */
+      void putPadding(std::size_t alignment)
+      {
+        putBytes(padding, detail::getSerialPadding(mSize, alignment));
+      }
+
+      /// @brief Ends the current metadata block, so that a payload can follow.
+      void flushMeta()
+      {
+        if (!mMeta.back().empty())
+        {
+          mSegments.emplace_back(mMeta.back().data(), mMeta.back().size());
+          mMeta.emplace_back();
+        }
+      }
+
+      /**
+       * @brief Appends a payload aligned to the payload alignment, followed by padding to the record alignment.
+       * @param data The payload.
+       * @param size The size in bytes.
+       */
+      void putPayload(const void* data, std::size_t size)
+      {
+        putPadding(detail::serialPayloadAlignment);
+        flushMeta();
+
+        if (size > 0)
+        {
+          mSegments.emplace_back(static_cast<const std::byte*>(data), size);
+          mSize += size;
+        }
+
+        putPadding(detail::serialRecordAlignment);
+      }
+
+      /**
+       * @brief Appends the header of a node.
+       * @param array The array.
+       * @param flags The flags.
+       * @param codec The codec of the payload.
+       */
+      void putHeader(ArrayCref array, std::uint8_t flags, Codec codec = Codec::raw)
+      {
+        putValue(detail::SerialNodeHeader{static_cast<std::uint8_t>(array.getClassId()),
+                                          static_cast<std::uint8_t>(flags | (array.isComplex() ? detail::serialComplex
+                                                                                                : 0)),
+                                          static_cast<std::uint16_t>(codec),
+                                          static_cast<std::uint32_t>(array.getRank())});
+        putBytes(array.getDims().data(), array.getRank() * sizeof(std::size_t));
+      }
+
+      /**
+       * @brief Appends a node, or a null node for a missing element.
+       * @param array The array, nullptr for a missing element.
+       */
+      void putNode(const mxArray* array)
+      {
+        if (array == nullptr)
+        {
+          putValue(detail::SerialNodeHeader{0, detail::serialNull, 0, 0});
+          return;
+        }
+
+        visit(ArrayCref{array}, Visitor
+        {
+          [this](CellArrayCref cell)
+          {
+            putHeader(cell, 0);
+
+            for (std::size_t i{}; i < cell.getSize(); ++i)
+            {
+              putNode(mxGetCell(cell.get(), i));
+            }
+          },
+          [this](StructArrayCref structure)
+          {
+            const auto fieldCount = static_cast<std::size_t>(mxGetNumberOfFields(structure.get()));
+
+            putHeader(structure, 0);
+            putValue(static_cast<std::uint64_t>(fieldCount));
+
+            for (std::size_t k{}; k < fieldCount; ++k)
+            {
+              const char* name = mxGetFieldNameByNumber(structure.get(), static_cast<int>(k));
+
+              putValue(static_cast<std::uint64_t>(std::strlen(name)));
+              putBytes(name, std::strlen(name));
+              putPadding(detail::serialRecordAlignment);
+            }
+
+            for (std::size_t i{}; i < structure.getSize(); ++i)
+            {
+              for (std::size_t k{}; k < fieldCount; ++k)
+              {
+                putNode(mxGetFieldByNumber(structure.get(), i, static_cast<int>(k)));
+              }
+            }
+          },
+          [this](ArrayCref leaf)
+          {
+            putLeaf(leaf);
+          }
+        });
+      }
+
+      /**
+       * @brief Appends a numeric, logical or char node.
+       * @param leaf The array.
+       */
+      void putLeaf(ArrayCref leaf)
+      {
+        const std::size_t elementSize = leaf.getSizeOfElement();
+
+        if (leaf.isSparse())
+        {
+          const std::size_t n   = leaf.getDimN();
+          const mwIndex*    jc  = mxGetJc(leaf.get());
+          const std::size_t nnz = jc[n];
+
+          putHeader(leaf, detail::serialSparse);
+          putValue(static_cast<std::uint64_t>(nnz));
+          putPayload(jc, (n + 1) * sizeof(mwIndex));
+          putPayload(mxGetIr(leaf.get()), nnz * sizeof(mwIndex));
+          putPayload(leaf.getData(), nnz * elementSize);
+        }
+        else
+        {
+          const std::size_t bytes = leaf.getSize() * elementSize;
+
+          EncodedPayload encoded = (mCodecOptions) ? compress(leaf, *mCodecOptions) : EncodedPayload{};
+
+          putHeader(leaf, 0, encoded.codec);
+          putValue(static_cast<std::uint64_t>(bytes));
+
+          if (encoded.codec == Codec::raw)
+          {
+            putPayload(leaf.getData(), bytes);
+            return;
+          }
+
+          putValue(static_cast<std::uint64_t>(encoded.bytes.size()));
+
+          const auto& payload = mEncoded.emplace_back(std::move(encoded.bytes));
+
+          putPayload(payload.data(), payload.size());
+        }
+      }
+
+      std::vector<std::vector<std::byte>> mMeta{1};        ///< Metadata blocks between the payloads.
+      std::vector<View<std::byte>>        mSegments{};     ///< The segments of the stream.
+      std::size_t                         mSize{};         ///< The size of the stream in bytes.
+      std::optional<CodecOptions>         mCodecOptions{}; ///< The codec options, payloads are raw if not set.
+      std::vector<std::vector<std::byte>> mEncoded{};      ///< The encoded payloads, moving keeps their buffers.
+  };
+
+  /**
+   * @brief Serializes an array tree to contiguous memory.
+   * @param array The array.
+   * @return The serialized data.
+   */
+  [[nodiscard]] inline std::vector<std::byte> serialize(ArrayCref array)
+  {
+    return SerializedArray{array}.toBytes();
+  }
+
+  /**
+   * @brief Serializes an array tree to contiguous memory, encoding the compressible dense payloads.
+   * @param array The array.
+   * @param options The codec options.
+   * @return The serialized data.
+   */
+  [[nodiscard]] inline std::vector<std::byte> serialize(ArrayCref array, const CodecOptions& options)
+  {
+    return SerializedArray{array, options}.toBytes();
+  }
+
+  /**
+   * @brief Deserializes an array tree, each array is allocated once.
+   * @param bytes The serialized data.
+   * @return The array.
+   */
+  [[nodiscard]] inline Array deserialize(View<std::byte> bytes)
+  {
+    detail::SerialBufferSource source{bytes};
+
+    return detail::readSerialStream(source);
+  }
+
+  /**
+   * @brief Writes an array tree to a file with gather writes, the payloads are not copied.
+   * @param filename The filename.
+   * @param array The array.
+   */
+  inline void saveSerialized(const char* filename, ArrayCref array)
+  {
+    SerializedArray{array}.save(filename);
+  }
+
+  /**
+   * @brief Writes an array tree to a file with gather writes, encoding the compressible dense payloads.
+   * @param filename The filename.
+   * @param array The array.
+   * @param options The codec options.
+   */
+  inline void saveSerialized(const char* filename, ArrayCref array, const CodecOptions& options)
+  {
+    SerializedArray{array, options}.save(filename);
+  }
+
+  /**
+   * @brief Reads an array tree from a file, payloads are read directly into the arrays.
+   * @param filename The filename.
+   * @return The array.
+   */
+  [[nodiscard]] inline Array loadSerialized(const char* filename)
+  {
+    std::FILE* file = std::fopen(filename, "rb");
+
+    if (file == nullptr)
+    {
+      throw Exception{"matlabw:mx:loadSerialized", "failed to open file"};
+    }
+
+    try
+    {
+      detail::SerialFileSource source{file};
+
+      Array array = detail::readSerialStream(source);
+
+      std::fclose(file);
+
+      return array;
+    }
+    catch (...)
+    {
+      std::fclose(file);
+      throw;
+    }
+  }
+} // namespace matlabw::mx
+
+#endif /* MATLABW_MX_SERIALIZE_HPP */
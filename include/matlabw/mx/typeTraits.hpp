@@ -28,6 +28,7 @@
 #include "detail/include.hpp"
 
 #include "common.hpp"
+#include "half.hpp"
 
 namespace matlabw::mx
 {
@@ -57,6 +58,14 @@ namespace matlabw::mx
   struct detail::IsNumericHelper<std::complex<T>>
     : std::bool_constant<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>> {};
 
+  /// @brief Specialization of IsNumericHelper for float16, stored as uint16.
+  template<>
+  struct detail::IsNumericHelper<float16> : std::true_type {};
+
+  /// @brief Specialization of IsNumericHelper for bfloat16, stored as uint16.
+  template<>
+  struct detail::IsNumericHelper<bfloat16> : std::true_type {};
+
   /**
    * @brief IsNumeric trait.
    * @tparam T Type.
@@ -273,6 +282,16 @@ namespace matlabw::mx
   struct detail::TypePropertiesHelper<std::complex<std::uint64_t>>
     : ClassIdConstant<ClassId::uint64>, ComplexityConstant<Complexity::complex> {};
 
+  /// @brief Specialization of TypePropertiesHelper for float16, the bits are stored in a uint16 array.
+  template<>
+  struct detail::TypePropertiesHelper<float16>
+    : ClassIdConstant<ClassId::uint16>, ComplexityConstant<Complexity::real> {};
+
+  /// @brief Specialization of TypePropertiesHelper for bfloat16, the bits are stored in a uint16 array.
+  template<>
+  struct detail::TypePropertiesHelper<bfloat16>
+    : ClassIdConstant<ClassId::uint16>, ComplexityConstant<Complexity::real> {};
+
   /// @brief Specialization of TypePropertiesHelper for Index.
   template<>
   struct detail::TypePropertiesHelper<Index>
@@ -289,6 +308,84 @@ namespace matlabw::mx
    */
   template<typename T>
   struct TypeProperties : detail::TypePropertiesHelper<std::remove_cv_t<T>> {};
+
+  /**
+   * @brief List of types.
+   * @tparam Ts Types.
+   */
+  template<typename... Ts>
+  struct TypeList
+  {
+    static constexpr std::size_t size = sizeof...(Ts);
+  };
+
+  namespace detail
+  {
+    /**
+     * @brief Helper for concatenation of type lists.
+     * @tparam Lists Type lists.
+     */
+    template<typename... Lists>
+    struct ConcatTypeListsHelper;
+
+    /// @brief Specialization of ConcatTypeListsHelper for no lists.
+    template<>
+    struct ConcatTypeListsHelper<>
+    {
+      using Type = TypeList<>;
+    };
+
+    /// @brief Specialization of ConcatTypeListsHelper for one or more lists.
+    template<typename... Ts, typename... Lists>
+    struct ConcatTypeListsHelper<TypeList<Ts...>, Lists...>
+    {
+      template<typename Rest>
+      struct Prepend;
+
+      template<typename... Us>
+      struct Prepend<TypeList<Us...>>
+      {
+        using Type = TypeList<Ts..., Us...>;
+      };
+
+      using Type = typename Prepend<typename ConcatTypeListsHelper<Lists...>::Type>::Type;
+    };
+  } // namespace detail
+
+  /**
+   * @brief Concatenation of type lists.
+   * @tparam Lists Type lists.
+   */
+  template<typename... Lists>
+  using ConcatTypeLists = typename detail::ConcatTypeListsHelper<Lists...>::Type;
+
+  /// @brief Real floating point types.
+  using FloatTypes = TypeList<double, float>;
+
+  /// @brief Complex floating point types.
+  using ComplexFloatTypes = TypeList<std::complex<double>, std::complex<float>>;
+
+  /// @brief Real integer types.
+  using IntegerTypes = TypeList<std::int8_t, std::uint8_t, std::int16_t, std::uint16_t,
+                                std::int32_t, std::uint32_t, std::int64_t, std::uint64_t>;
+
+  /// @brief Complex integer types.
+  using ComplexIntegerTypes = TypeList<std::complex<std::int8_t>,  std::complex<std::uint8_t>,
+                                       std::complex<std::int16_t>, std::complex<std::uint16_t>,
+                                       std::complex<std::int32_t>, std::complex<std::uint32_t>,
+                                       std::complex<std::int64_t>, std::complex<std::uint64_t>>;
+
+  /// @brief Half precision types, stored as uint16 and therefore part of neither NumericTypes nor restricted visits.
+  using HalfTypes = TypeList<float16, bfloat16>;
+
+  /// @brief Real numeric types.
+  using RealNumericTypes = ConcatTypeLists<FloatTypes, IntegerTypes>;
+
+  /// @brief Complex numeric types.
+  using ComplexNumericTypes = ConcatTypeLists<ComplexFloatTypes, ComplexIntegerTypes>;
+
+  /// @brief Numeric types.
+  using NumericTypes = ConcatTypeLists<RealNumericTypes, ComplexNumericTypes>;
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_TYPE_TRAITS_HPP */
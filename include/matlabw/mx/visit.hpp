@@ -201,6 +201,421 @@ namespace detail
       throw Exception{"matlabw:mx:visit", "unknown class ID"};
     }
   }
+
+  /**
+   * @brief Visit the array ref with the specified callable, uint16 arrays are passed as half precision arrays.
+   * @tparam Fn The callable type.
+   * @param arrayRef The array ref.
+   * @param fn The callable.
+   * @param format The interpretation of real uint16 arrays, complex uint16 arrays are rejected unless none.
+   * @return The result of the callable.
+   */
+  template<typename Fn>
+  decltype(auto) visit(ArrayRef arrayRef, Fn&& fn, HalfFormat format)
+  {
+    if (format != HalfFormat::none && arrayRef.getClassId() == ClassId::uint16)
+    {
+      if (arrayRef.isComplex())
+      {
+        throw Exception{"matlabw:mx:visit", "complex half precision arrays are not supported"};
+      }
+
+      if (format == HalfFormat::float16)
+      {
+        return detail::visitorHelper(NumericArrayRef<float16>{arrayRef}, std::forward<Fn>(fn));
+      }
+
+      return detail::visitorHelper(NumericArrayRef<bfloat16>{arrayRef}, std::forward<Fn>(fn));
+    }
+
+    return visit(arrayRef, std::forward<Fn>(fn));
+  }
+
+  /**
+   * @brief Visit the array cref with the specified callable, uint16 arrays are passed as half precision arrays.
+   * @tparam Fn The callable type.
+   * @param arrayCref The array cref.
+   * @param fn The callable.
+   * @param format The interpretation of real uint16 arrays, complex uint16 arrays are rejected unless none.
+   * @return The result of the callable.
+   */
+  template<typename Fn>
+  decltype(auto) visit(ArrayCref arrayCref, Fn&& fn, HalfFormat format)
+  {
+    if (format != HalfFormat::none && arrayCref.getClassId() == ClassId::uint16)
+    {
+      if (arrayCref.isComplex())
+      {
+        throw Exception{"matlabw:mx:visit", "complex half precision arrays are not supported"};
+      }
+
+      if (format == HalfFormat::float16)
+      {
+        return detail::visitorHelper(NumericArrayCref<float16>{arrayCref}, std::forward<Fn>(fn));
+      }
+
+      return detail::visitorHelper(NumericArrayCref<bfloat16>{arrayCref}, std::forward<Fn>(fn));
+    }
+
+    return visit(arrayCref, std::forward<Fn>(fn));
+  }
+
+namespace detail
+{
+  /**
+   * @brief Typed reference passed to the visitor of a restricted visit.
+   * @tparam T Element type.
+   * @tparam ArrayRefT ArrayRef or ArrayCref.
+   */
+  template<typename T, typename ArrayRefT>
+  using TypedVisitRef = std::conditional_t<std::is_same_v<ArrayRefT, ArrayRef>,
+                                           std::conditional_t<std::is_same_v<T, char16_t>, CharArrayRef, TypedArrayRef<T>>,
+                                           std::conditional_t<std::is_same_v<T, char16_t>, CharArrayCref, TypedArrayCref<T>>>;
+
+  /**
+   * @brief Gets the jump table key of a type.
+   * @tparam T Element type.
+   * @return The key.
+   */
+  template<typename T>
+  [[nodiscard]] constexpr std::size_t getVisitKey() noexcept
+  {
+    return static_cast<std::size_t>(TypeProperties<T>::classId) * 2
+         + static_cast<std::size_t>(TypeProperties<T>::complexity == Complexity::complex);
+  }
+
+  /**
+   * @brief Gets the jump table key of an array.
+   * @param array The array.
+   * @return The key.
+   */
+  [[nodiscard]] inline std::size_t getVisitKey(ArrayCref array)
+  {
+    return static_cast<std::size_t>(array.getClassId()) * 2 + static_cast<std::size_t>(array.isComplex());
+  }
+
+  /// @brief Jump table of a restricted visit.
+  template<typename List, typename ArrayRefT, typename Fn>
+  struct VisitTable;
+
+  /**
+   * @brief Jump table of a restricted visit over the types of a list.
+   * @tparam Ts Element types.
+   * @tparam ArrayRefT ArrayRef or ArrayCref.
+   * @tparam Fn The callable type.
+   */
+  template<typename... Ts, typename ArrayRefT, typename Fn>
+  struct VisitTable<TypeList<Ts...>, ArrayRefT, Fn>
+  {
+    static_assert(sizeof...(Ts) > 0, "type list must not be empty");
+
+    /// @brief Result type, the same for all types.
+    using Result = std::invoke_result_t<Fn&, TypedVisitRef<std::tuple_element_t<0, std::tuple<Ts...>>, ArrayRefT>>;
+
+    static_assert((std::is_same_v<Result, std::invoke_result_t<Fn&, TypedVisitRef<Ts, ArrayRefT>>> && ...),
+                  "callable must return the same type for all visited types");
+
+    /// @brief Table entry.
+    using Entry = Result (*)(ArrayRefT, Fn&);
+
+    /// @brief Table size.
+    static constexpr std::size_t size = std::max({getVisitKey<Ts>()...}) + 1;
+
+    /**
+     * @brief Calls the callable with the typed reference.
+     * @tparam T Element type.
+     * @param array The array.
+     * @param fn The callable.
+     * @return The result of the callable.
+     */
+    template<typename T>
+    static Result invoke(ArrayRefT array, Fn& fn)
+    {
+      return std::invoke(fn, TypedVisitRef<T, ArrayRefT>{array});
+    }
+
+    /// @brief The table, unlisted types have no entry.
+    static constexpr std::array<Entry, size> table = []
+    {
+      std::array<Entry, size> entries{};
+
+      ((entries[getVisitKey<Ts>()] = &invoke<Ts>), ...);
+
+      return entries;
+    }();
+  };
+
+  /// @brief Jump table of a restricted visit of two arrays.
+  template<typename ListA, typename ListB, typename ArrayRefA, typename ArrayRefB, typename Fn>
+  struct Visit2Table;
+
+  /**
+   * @brief Jump table of a restricted visit of two arrays over the pairs of types of two lists.
+   * @tparam Ts Element types of the first array.
+   * @tparam Us Element types of the second array.
+   * @tparam ArrayRefA ArrayRef or ArrayCref of the first array.
+   * @tparam ArrayRefB ArrayRef or ArrayCref of the second array.
+   * @tparam Fn The callable type.
+   */
+  template<typename... Ts, typename... Us, typename ArrayRefA, typename ArrayRefB, typename Fn>
+  struct Visit2Table<TypeList<Ts...>, TypeList<Us...>, ArrayRefA, ArrayRefB, Fn>
+  {
+    static_assert(sizeof...(Ts) > 0 && sizeof...(Us) > 0, "type lists must not be empty");
+
+    /// @brief Result type, the same for all pairs of types.
+    using Result = std::invoke_result_t<Fn&,
+                                        TypedVisitRef<std::tuple_element_t<0, std::tuple<Ts...>>, ArrayRefA>,
+                                        TypedVisitRef<std::tuple_element_t<0, std::tuple<Us...>>, ArrayRefB>>;
+
+    /// @brief Table entry.
+    using Entry = Result (*)(ArrayRefA, ArrayRefB, Fn&);
+
+    /// @brief Number of keys of the second array.
+    static constexpr std::size_t sizeB = std::max({getVisitKey<Us>()...}) + 1;
+
+    /// @brief Table size.
+    static constexpr std::size_t size = (std::max({getVisitKey<Ts>()...}) + 1) * sizeB;
+
+    /**
+     * @brief Calls the callable with the typed references.
+     * @tparam T Element type of the first array.
+     * @tparam U Element type of the second array.
+     * @param a The first array.
+     * @param b The second array.
+     * @param fn The callable.
+     * @return The result of the callable.
+     */
+    template<typename T, typename U>
+    static Result invoke(ArrayRefA a, ArrayRefB b, Fn& fn)
+    {
+      static_assert(std::is_same_v<Result, std::invoke_result_t<Fn&, TypedVisitRef<T, ArrayRefA>, TypedVisitRef<U, ArrayRefB>>>,
+                    "callable must return the same type for all visited types");
+
+      return std::invoke(fn, TypedVisitRef<T, ArrayRefA>{a}, TypedVisitRef<U, ArrayRefB>{b});
+    }
+
+    /**
+     * @brief Fills the table row of a type of the first array.
+     * @tparam T Element type of the first array.
+     * @param entries The table.
+     */
+    template<typename T>
+    static constexpr void fillRow(std::array<Entry, size>& entries) noexcept
+    {
+      ((entries[getVisitKey<T>() * sizeB + getVisitKey<Us>()] = &invoke<T, Us>), ...);
+    }
+
+    /// @brief The table, unlisted pairs of types have no entry.
+    static constexpr std::array<Entry, size> table = []
+    {
+      std::array<Entry, size> entries{};
+
+      (fillRow<Ts>(entries), ...);
+
+      return entries;
+    }();
+  };
+
+  /**
+   * @brief Calls the fallback of a restricted visit. A fallback returning void must not return if the callable returns
+   *        a value, e.g. it throws an exception.
+   * @tparam Result Result type of the visit.
+   * @tparam Fallback The fallback type.
+   * @tparam Args The argument types.
+   * @param fallback The fallback.
+   * @param args The arguments.
+   * @return The result of the fallback.
+   */
+  template<typename Result, typename Fallback, typename... Args>
+  Result invokeFallback(Fallback& fallback, Args... args)
+  {
+    if constexpr (std::is_void_v<std::invoke_result_t<Fallback&, Args...>> && !std::is_void_v<Result>)
+    {
+      std::invoke(fallback, args...);
+
+      throw Exception{"matlabw:mx:visit", "fallback returned without a value"};
+    }
+    else
+    {
+      return static_cast<Result>(std::invoke(fallback, args...));
+    }
+  }
+
+  /**
+   * @brief Restricted visit through a jump table.
+   * @tparam List Type list.
+   * @tparam ArrayRefT ArrayRef or ArrayCref.
+   * @tparam Fn The callable type.
+   * @tparam Fallback The fallback type.
+   * @param array The array.
+   * @param fn The callable.
+   * @param fallback The fallback.
+   * @return The result of the callable or the fallback.
+   */
+  template<typename List, typename ArrayRefT, typename Fn, typename Fallback>
+  decltype(auto) visitTable(ArrayRefT array, Fn& fn, Fallback& fallback)
+  {
+    using Table = VisitTable<List, ArrayRefT, Fn>;
+
+    const std::size_t key = getVisitKey(array);
+
+    if (key < Table::size && Table::table[key] != nullptr)
+    {
+      return Table::table[key](array, fn);
+    }
+
+    return invokeFallback<typename Table::Result>(fallback, array);
+  }
+
+  /**
+   * @brief Restricted visit of two arrays through a jump table.
+   * @tparam ListA Type list of the first array.
+   * @tparam ListB Type list of the second array.
+   * @tparam ArrayRefA ArrayRef or ArrayCref of the first array.
+   * @tparam ArrayRefB ArrayRef or ArrayCref of the second array.
+   * @tparam Fn The callable type.
+   * @tparam Fallback The fallback type.
+   * @param a The first array.
+   * @param b The second array.
+   * @param fn The callable.
+   * @param fallback The fallback.
+   * @return The result of the callable or the fallback.
+   */
+  template<typename ListA, typename ListB, typename ArrayRefA, typename ArrayRefB, typename Fn, typename Fallback>
+  decltype(auto) visit2Table(ArrayRefA a, ArrayRefB b, Fn& fn, Fallback& fallback)
+  {
+    using Table = Visit2Table<ListA, ListB, ArrayRefA, ArrayRefB, Fn>;
+
+    const std::size_t keyA = getVisitKey(a);
+    const std::size_t keyB = getVisitKey(b);
+
+    if (keyB < Table::sizeB && keyA * Table::sizeB + keyB < Table::size)
+    {
+      if (auto entry = Table::table[keyA * Table::sizeB + keyB]; entry != nullptr)
+      {
+        return entry(a, b, fn);
+      }
+    }
+
+    return invokeFallback<typename Table::Result>(fallback, a, b);
+  }
+
+  /// @brief Default fallback of the restricted visits, throws an exception.
+  struct VisitFallback
+  {
+    template<typename... Args>
+    [[noreturn]] void operator()(const Args&...) const
+    {
+      throw Exception{"matlabw:mx:visit", "unsupported array type"};
+    }
+  };
+} // namespace detail
+
+  /**
+   * @brief Visit the array ref with the specified callable, instantiated only for the types of the list. Dispatches
+   *        through a constexpr jump table indexed by the class ID and complexity.
+   * @tparam List The type list of element types, e.g. FloatTypes or TypeList<double, std::complex<double>>.
+   * @tparam Fn The callable type, called with TypedArrayRef<T> (CharArrayRef for char16_t).
+   * @tparam Fallback The fallback type, called with the ArrayRef for other types.
+   * @param arrayRef The array ref.
+   * @param fn The callable.
+   * @param fallback The fallback.
+   * @return The result of the callable or the fallback.
+   */
+  template<typename List, typename Fn, typename Fallback>
+  decltype(auto) visit(ArrayRef arrayRef, Fn&& fn, Fallback&& fallback)
+  {
+    return detail::visitTable<List>(arrayRef, fn, fallback);
+  }
+
+  /**
+   * @brief Visit the array ref with the specified callable, instantiated only for the types of the list. Throws an
+   *        exception for other types.
+   * @tparam List The type list of element types.
+   * @tparam Fn The callable type, called with TypedArrayRef<T> (CharArrayRef for char16_t).
+   * @param arrayRef The array ref.
+   * @param fn The callable.
+   * @return The result of the callable.
+   */
+  template<typename List, typename Fn>
+  decltype(auto) visit(ArrayRef arrayRef, Fn&& fn)
+  {
+    detail::VisitFallback fallback{};
+
+    return detail::visitTable<List>(arrayRef, fn, fallback);
+  }
+
+  /**
+   * @brief Visit the array cref with the specified callable, instantiated only for the types of the list. Dispatches
+   *        through a constexpr jump table indexed by the class ID and complexity.
+   * @tparam List The type list of element types, e.g. FloatTypes or TypeList<double, std::complex<double>>.
+   * @tparam Fn The callable type, called with TypedArrayCref<T> (CharArrayCref for char16_t).
+   * @tparam Fallback The fallback type, called with the ArrayCref for other types.
+   * @param arrayCref The array cref.
+   * @param fn The callable.
+   * @param fallback The fallback.
+   * @return The result of the callable or the fallback.
+   */
+  template<typename List, typename Fn, typename Fallback>
+  decltype(auto) visit(ArrayCref arrayCref, Fn&& fn, Fallback&& fallback)
+  {
+    return detail::visitTable<List>(arrayCref, fn, fallback);
+  }
+
+  /**
+   * @brief Visit the array cref with the specified callable, instantiated only for the types of the list. Throws an
+   *        exception for other types.
+   * @tparam List The type list of element types.
+   * @tparam Fn The callable type, called with TypedArrayCref<T> (CharArrayCref for char16_t).
+   * @param arrayCref The array cref.
+   * @param fn The callable.
+   * @return The result of the callable.
+   */
+  template<typename List, typename Fn>
+  decltype(auto) visit(ArrayCref arrayCref, Fn&& fn)
+  {
+    detail::VisitFallback fallback{};
+
+    return detail::visitTable<List>(arrayCref, fn, fallback);
+  }
+
+  /**
+   * @brief Visit two array crefs with the specified callable, instantiated for each pair of types of the lists and
+   *        dispatched through a single jump table.
+   * @tparam ListA The type list of the first array.
+   * @tparam ListB The type list of the second array.
+   * @tparam Fn The callable type, called with two typed array crefs.
+   * @tparam Fallback The fallback type, called with both array crefs for other pairs of types.
+   * @param a The first array cref.
+   * @param b The second array cref.
+   * @param fn The callable.
+   * @param fallback The fallback.
+   * @return The result of the callable or the fallback.
+   */
+  template<typename ListA, typename ListB = ListA, typename Fn, typename Fallback = detail::VisitFallback>
+  decltype(auto) visit2(ArrayCref a, ArrayCref b, Fn&& fn, Fallback&& fallback = {})
+  {
+    return detail::visit2Table<ListA, ListB>(a, b, fn, fallback);
+  }
+
+  /**
+   * @brief Visit an array ref (e.g. the output) and an array cref with the specified callable, instantiated for each
+   *        pair of types of the lists and dispatched through a single jump table.
+   * @tparam ListA The type list of the first array.
+   * @tparam ListB The type list of the second array.
+   * @tparam Fn The callable type, called with a typed array ref and a typed array cref.
+   * @tparam Fallback The fallback type, called with both arrays for other pairs of types.
+   * @param a The first array ref.
+   * @param b The second array cref.
+   * @param fn The callable.
+   * @param fallback The fallback.
+   * @return The result of the callable or the fallback.
+   */
+  template<typename ListA, typename ListB = ListA, typename Fn, typename Fallback = detail::VisitFallback>
+  decltype(auto) visit2(ArrayRef a, ArrayCref b, Fn&& fn, Fallback&& fallback = {})
+  {
+    return detail::visit2Table<ListA, ListB>(a, b, fn, fallback);
+  }
 } // namespace matlabw::mx
 
 #endif /* MATLABW_MX_VISIT_HPP */
@@ -0,0 +1,59 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Mock of the subset of the MAT-file API used by matlabw, see mock/src/mat.cpp.
+ */
+
+#ifndef MATLABW_MOCK_MAT_H
+#define MATLABW_MOCK_MAT_H
+
+#include <stdio.h>
+
+#include "matrix.h"
+
+typedef struct MatFile_tag MATFile;
+typedef int                matError;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+MATFile* matOpen(const char* filename, const char* mode);
+matError matClose(MATFile* mfp);
+FILE*    matGetFp(MATFile* mfp);
+matError matPutVariable(MATFile* mfp, const char* name, const mxArray* pa);
+matError matPutVariableAsGlobal(MATFile* mfp, const char* name, const mxArray* pa);
+mxArray* matGetVariable(MATFile* mfp, const char* name);
+mxArray* matGetVariableInfo(MATFile* mfp, const char* name);
+mxArray* matGetNextVariable(MATFile* mfp, const char** name);
+mxArray* matGetNextVariableInfo(MATFile* mfp, const char** name);
+matError matDeleteVariable(MATFile* mfp, const char* name);
+char**   matGetDir(MATFile* mfp, int* num);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MATLABW_MOCK_MAT_H */
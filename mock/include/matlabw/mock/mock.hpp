@@ -0,0 +1,108 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MOCK_MOCK_HPP
+#define MATLABW_MOCK_MOCK_HPP
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include <mex.h>
+
+namespace matlabw::mock
+{
+  /// @brief Error raised by mexErrMsgIdAndTxt and mexErrMsgTxt, MATLAB would return to the prompt instead.
+  class MexError : public std::runtime_error
+  {
+    public:
+      /**
+       * @brief Constructor.
+       * @param id The error identifier, may be empty.
+       * @param message The error message.
+       */
+      MexError(std::string id, const std::string& message)
+      : std::runtime_error{message},
+        mId{std::move(id)}
+      {}
+
+      /**
+       * @brief Gets the error identifier.
+       * @return The error identifier, empty if none was given.
+       */
+      [[nodiscard]] const std::string& getId() const noexcept
+      {
+        return mId;
+      }
+
+    private:
+      std::string mId; ///< The error identifier.
+  };
+
+  /**
+   * @brief MATLAB function provided to mexCallMATLAB. Throwing MexError reports an error with its identifier, the
+   *        outputs must be created with the mx functions.
+   */
+  using Function = std::function<void(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[])>;
+
+  /**
+   * @brief Registers a function callable by mexCallMATLAB, by feval with a handle from makeFunctionHandle() and by
+   *        mexEvalString with its name as the command. Replaces a function of the same name.
+   * @param name The name of the function.
+   * @param function The function.
+   */
+  void registerFunction(const std::string& name, Function function);
+
+  /**
+   * @brief Unregisters a function.
+   * @param name The name of the function.
+   */
+  void unregisterFunction(const std::string& name);
+
+  /**
+   * @brief Creates a function handle to a registered function.
+   * @param name The name of the function.
+   * @return The function handle, owned by the caller.
+   */
+  [[nodiscard]] mxArray* makeFunctionHandle(const std::string& name);
+
+  /**
+   * @brief Creates an MException object with the identifier and message properties.
+   * @param id The error identifier.
+   * @param message The error message.
+   * @return The MException, owned by the caller.
+   */
+  [[nodiscard]] mxArray* makeMException(const std::string& id, const std::string& message);
+
+  /// @brief Simulates clear mex, runs the function registered by mexAtExit unless the MEX file is locked.
+  void clearMex();
+
+  /// @brief Destroys the variables of all workspaces.
+  void clearWorkspaces();
+
+  /// @brief Forgets all MAT-files, which the mock keeps in memory by file name.
+  void clearMatFiles();
+} // namespace matlabw::mock
+
+#endif /* MATLABW_MOCK_MOCK_HPP */
@@ -0,0 +1,223 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Mock of the subset of the MATLAB Matrix API used by matlabw, see mock/src/matrix.cpp. Declarations follow the
+ * R2018a interleaved complex API.
+ */
+
+#ifndef MATLABW_MOCK_MATRIX_H
+#define MATLABW_MOCK_MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef __cplusplus
+# include <uchar.h>
+#endif
+
+#define R2017b 700
+#define R2018a 800
+
+#ifndef MATLAB_TARGET_API_VERSION
+# define MATLAB_TARGET_API_VERSION R2018a
+#endif
+
+#define MX_HAS_INTERLEAVED_COMPLEX 1
+
+#define mxMAXNAM 64
+
+#define MWSIZE_MAX   281474976710655UL
+#define MWSIZE_MIN   0UL
+#define MWINDEX_MAX  281474976710655UL
+#define MWINDEX_MIN  0UL
+#define MWSINDEX_MAX 281474976710655L
+#define MWSINDEX_MIN -281474976710655L
+
+typedef size_t    mwSize;
+typedef size_t    mwIndex;
+typedef ptrdiff_t mwSignedIndex;
+
+typedef char16_t mxChar;
+typedef bool     mxLogical;
+
+typedef double             mxDouble;
+typedef float              mxSingle;
+typedef signed char        mxInt8;
+typedef unsigned char      mxUint8;
+typedef short              mxInt16;
+typedef unsigned short     mxUint16;
+typedef int                mxInt32;
+typedef unsigned int       mxUint32;
+typedef long long          mxInt64;
+typedef unsigned long long mxUint64;
+
+typedef struct { mxDouble real, imag; } mxComplexDouble;
+typedef struct { mxSingle real, imag; } mxComplexSingle;
+
+typedef struct mxArray_tag mxArray;
+
+typedef enum
+{
+  mxUNKNOWN_CLASS = 0,
+  mxCELL_CLASS,
+  mxSTRUCT_CLASS,
+  mxLOGICAL_CLASS,
+  mxCHAR_CLASS,
+  mxVOID_CLASS,
+  mxDOUBLE_CLASS,
+  mxSINGLE_CLASS,
+  mxINT8_CLASS,
+  mxUINT8_CLASS,
+  mxINT16_CLASS,
+  mxUINT16_CLASS,
+  mxINT32_CLASS,
+  mxUINT32_CLASS,
+  mxINT64_CLASS,
+  mxUINT64_CLASS,
+  mxFUNCTION_CLASS,
+  mxOPAQUE_CLASS,
+  mxOBJECT_CLASS,
+  mxINDEX_CLASS = mxUINT64_CLASS
+} mxClassID;
+
+typedef enum
+{
+  mxREAL,
+  mxCOMPLEX
+} mxComplexity;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Memory */
+void* mxMalloc(size_t n);
+void* mxCalloc(size_t n, size_t size);
+void* mxRealloc(void* ptr, size_t size);
+void  mxFree(void* ptr);
+
+/* Creation and destruction */
+mxArray* mxCreateNumericArray(mwSize ndim, const mwSize* dims, mxClassID classid, mxComplexity flag);
+mxArray* mxCreateUninitNumericArray(size_t ndim, size_t* dims, mxClassID classid, mxComplexity flag);
+mxArray* mxCreateNumericMatrix(mwSize m, mwSize n, mxClassID classid, mxComplexity flag);
+mxArray* mxCreateDoubleScalar(double value);
+mxArray* mxCreateLogicalArray(mwSize ndim, const mwSize* dims);
+mxArray* mxCreateLogicalScalar(bool value);
+mxArray* mxCreateCharArray(mwSize ndim, const mwSize* dims);
+mxArray* mxCreateString(const char* str);
+mxArray* mxCreateStringFromNChars(const char* str, mwSize n);
+mxArray* mxCreateCellArray(mwSize ndim, const mwSize* dims);
+mxArray* mxCreateStructArray(mwSize ndim, const mwSize* dims, int nfields, const char** fieldnames);
+mxArray* mxCreateSparse(mwSize m, mwSize n, mwSize nzmax, mxComplexity flag);
+mxArray* mxCreateSparseLogicalMatrix(mwSize m, mwSize n, mwSize nzmax);
+mxArray* mxDuplicateArray(const mxArray* pa);
+void     mxDestroyArray(mxArray* pa);
+
+/* Class and shape */
+mxClassID     mxGetClassID(const mxArray* pa);
+const char*   mxGetClassName(const mxArray* pa);
+int           mxSetClassName(mxArray* pa, const char* classname);
+size_t        mxGetElementSize(const mxArray* pa);
+mwSize        mxGetNumberOfDimensions(const mxArray* pa);
+const mwSize* mxGetDimensions(const mxArray* pa);
+int           mxSetDimensions(mxArray* pa, const mwSize* dims, mwSize ndim);
+size_t        mxGetM(const mxArray* pa);
+size_t        mxGetN(const mxArray* pa);
+void          mxSetM(mxArray* pa, mwSize m);
+void          mxSetN(mxArray* pa, mwSize n);
+size_t        mxGetNumberOfElements(const mxArray* pa);
+mwIndex       mxCalcSingleSubscript(const mxArray* pa, mwSize nsubs, const mwIndex* subs);
+
+/* Data */
+void* mxGetData(const mxArray* pa);
+void  mxSetData(mxArray* pa, void* data);
+
+/* Sparse */
+mwIndex* mxGetIr(const mxArray* pa);
+mwIndex* mxGetJc(const mxArray* pa);
+void     mxSetIr(mxArray* pa, mwIndex* ir);
+void     mxSetJc(mxArray* pa, mwIndex* jc);
+mwSize   mxGetNzmax(const mxArray* pa);
+void     mxSetNzmax(mxArray* pa, mwSize nzmax);
+
+/* Cells, structs and objects */
+mxArray*    mxGetCell(const mxArray* pa, mwIndex i);
+void        mxSetCell(mxArray* pa, mwIndex i, mxArray* value);
+int         mxGetNumberOfFields(const mxArray* pa);
+const char* mxGetFieldNameByNumber(const mxArray* pa, int n);
+int         mxGetFieldNumber(const mxArray* pa, const char* name);
+mxArray*    mxGetFieldByNumber(const mxArray* pa, mwIndex i, int fieldnum);
+void        mxSetFieldByNumber(mxArray* pa, mwIndex i, int fieldnum, mxArray* value);
+mxArray*    mxGetField(const mxArray* pa, mwIndex i, const char* fieldname);
+void        mxSetField(mxArray* pa, mwIndex i, const char* fieldname, mxArray* value);
+int         mxAddField(mxArray* pa, const char* fieldname);
+void        mxRemoveField(mxArray* pa, int fieldnum);
+mxArray*    mxGetProperty(const mxArray* pa, mwIndex i, const char* propname);
+void        mxSetProperty(mxArray* pa, mwIndex i, const char* propname, const mxArray* value);
+
+/* Strings */
+int   mxGetString(const mxArray* pa, char* buf, mwSize buflen);
+char* mxArrayToString(const mxArray* pa);
+char* mxArrayToUTF8String(const mxArray* pa);
+
+/* Predicates */
+bool mxIsCell(const mxArray* pa);
+bool mxIsChar(const mxArray* pa);
+bool mxIsClass(const mxArray* pa, const char* name);
+bool mxIsComplex(const mxArray* pa);
+bool mxIsDouble(const mxArray* pa);
+bool mxIsEmpty(const mxArray* pa);
+bool mxIsFromGlobalWS(const mxArray* pa);
+bool mxIsGPUArray(const mxArray* pa);
+bool mxIsInt8(const mxArray* pa);
+bool mxIsInt16(const mxArray* pa);
+bool mxIsInt32(const mxArray* pa);
+bool mxIsInt64(const mxArray* pa);
+bool mxIsLogical(const mxArray* pa);
+bool mxIsLogicalScalar(const mxArray* pa);
+bool mxIsLogicalScalarTrue(const mxArray* pa);
+bool mxIsNumeric(const mxArray* pa);
+bool mxIsScalar(const mxArray* pa);
+bool mxIsSingle(const mxArray* pa);
+bool mxIsSparse(const mxArray* pa);
+bool mxIsStruct(const mxArray* pa);
+bool mxIsUint8(const mxArray* pa);
+bool mxIsUint16(const mxArray* pa);
+bool mxIsUint32(const mxArray* pa);
+bool mxIsUint64(const mxArray* pa);
+
+/* Floating point */
+double mxGetEps(void);
+double mxGetInf(void);
+double mxGetNaN(void);
+bool   mxIsFinite(double x);
+bool   mxIsInf(double x);
+bool   mxIsNaN(double x);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* MATLABW_MOCK_MATRIX_H */
@@ -0,0 +1,76 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Mock of the subset of the MEX API used by matlabw, see mock/src/mex.cpp.
+ */
+
+#ifndef MATLABW_MOCK_MEX_H
+#define MATLABW_MOCK_MEX_H
+
+#include <stdio.h>
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Entry point, defined by the MEX file */
+void mexFunction(int nlhs, mxArray* plhs[], int nrhs, const mxArray* prhs[]);
+
+/* Output and errors */
+int  mexPrintf(const char* format, ...);
+void mexErrMsgTxt(const char* msg);
+void mexErrMsgIdAndTxt(const char* id, const char* format, ...);
+void mexWarnMsgTxt(const char* msg);
+void mexWarnMsgIdAndTxt(const char* id, const char* format, ...);
+
+/* Calling MATLAB */
+int      mexCallMATLAB(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name);
+mxArray* mexCallMATLABWithTrap(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name);
+int      mexEvalString(const char* command);
+mxArray* mexEvalStringWithTrap(const char* command);
+
+/* Workspaces */
+mxArray*       mexGetVariable(const char* workspace, const char* name);
+const mxArray* mexGetVariablePtr(const char* workspace, const char* name);
+int            mexPutVariable(const char* workspace, const char* name, const mxArray* pa);
+
+/* MEX file state */
+const char* mexFunctionName(void);
+int         mexAtExit(void (*exitFcn)(void));
+void        mexLock(void);
+void        mexUnlock(void);
+bool        mexIsLocked(void);
+void        mexMakeArrayPersistent(mxArray* pa);
+void        mexMakeMemoryPersistent(void* ptr);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#define printf mexPrintf
+
+#endif /* MATLABW_MOCK_MEX_H */
@@ -0,0 +1,76 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Entry point running a MEX function as a standalone program, e.g. under a profiler. Each command line argument
+ * becomes an input, a double scalar if it parses as a number, a char array otherwise. Outputs are discarded.
+ *
+ * Usage: program [args...]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <matlabw/mock/mock.hpp>
+
+int main(int argc, char* argv[])
+{
+  std::vector<const mxArray*> inputs{};
+
+  for (int i{1}; i < argc; ++i)
+  {
+    char*        end{};
+    const double value = std::strtod(argv[i], &end);
+
+    inputs.push_back((*argv[i] != '\0' && *end == '\0') ? mxCreateDoubleScalar(value) : mxCreateString(argv[i]));
+  }
+
+  mxArray* output{};
+  int      status{EXIT_SUCCESS};
+
+  try
+  {
+    mexFunction(0, &output, static_cast<int>(inputs.size()), inputs.data());
+  }
+  catch (const matlabw::mock::MexError& e)
+  {
+    std::fprintf(stderr, "Error: %s [%s]\n", e.what(), e.getId().c_str());
+    status = EXIT_FAILURE;
+  }
+
+  mxDestroyArray(output);
+
+  for (const mxArray* input : inputs)
+  {
+    mxDestroyArray(const_cast<mxArray*>(input));
+  }
+
+  matlabw::mock::clearMex();
+  matlabw::mock::clearWorkspaces();
+  matlabw::mock::clearMatFiles();
+
+  return status;
+}
@@ -0,0 +1,298 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Mock implementation of the MAT-file API. MAT-files are kept in memory by file name for the lifetime of the process,
+ * nothing is read from or written to disk and matGetFp returns nullptr. Variable info is a full copy of the variable.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mat.h>
+
+#include <matlabw/mock/mock.hpp>
+
+#include "mxArray.hpp"
+
+/// @brief Open mock MAT-file.
+struct MatFile_tag
+{
+  std::string path;     ///< The file name.
+  bool        writable; ///< True if the file was opened for writing.
+  std::size_t next;     ///< Index of the next variable read by matGetNextVariable.
+  std::string nextName; ///< Name of the last variable read by matGetNextVariable.
+};
+
+namespace matlabw::mock
+{
+namespace
+{
+  /// @brief Variables of a file in the order they were written.
+  using FileContents = std::vector<std::pair<std::string, mxArray*>>;
+
+  /// @brief Files kept in memory.
+  struct FileSystem
+  {
+    std::mutex                          mutex{}; ///< Guards the files.
+    std::map<std::string, FileContents> files{}; ///< The files by name.
+  };
+
+  /**
+   * @brief Gets the files.
+   * @return The files.
+   */
+  FileSystem& getFileSystem()
+  {
+    static FileSystem fileSystem{};
+
+    return fileSystem;
+  }
+
+  /**
+   * @brief Destroys the variables of a file.
+   * @param contents The contents of the file.
+   */
+  void clearContents(FileContents& contents)
+  {
+    for (auto& [name, array] : contents)
+    {
+      mxDestroyArray(array);
+    }
+
+    contents.clear();
+  }
+
+  /**
+   * @brief Finds a variable of a file.
+   * @param contents The contents of the file.
+   * @param name The name of the variable.
+   * @return Iterator to the variable, end if not found.
+   */
+  FileContents::iterator findVariable(FileContents& contents, const char* name)
+  {
+    return std::find_if(contents.begin(), contents.end(), [name](const auto& variable)
+    {
+      return variable.first == name;
+    });
+  }
+
+  /**
+   * @brief Reads the next variable of a file.
+   * @param mfp The file.
+   * @param name The name of the variable, valid until the next read.
+   * @return A copy of the variable, nullptr at the end of the file.
+   */
+  mxArray* readNext(MATFile* mfp, const char** name)
+  {
+    std::lock_guard lock{getFileSystem().mutex};
+
+    FileContents& contents = getFileSystem().files[mfp->path];
+
+    if (mfp->next >= contents.size())
+    {
+      return nullptr;
+    }
+
+    const auto& [variableName, array] = contents[mfp->next++];
+
+    mfp->nextName = variableName;
+
+    if (name != nullptr)
+    {
+      *name = mfp->nextName.c_str();
+    }
+
+    return mxDuplicateArray(array);
+  }
+} // namespace
+
+  void clearMatFiles()
+  {
+    std::lock_guard lock{getFileSystem().mutex};
+
+    for (auto& [path, contents] : getFileSystem().files)
+    {
+      clearContents(contents);
+    }
+
+    getFileSystem().files.clear();
+  }
+} // namespace matlabw::mock
+
+using namespace matlabw::mock;
+
+extern "C"
+{
+MATFile* matOpen(const char* filename, const char* mode)
+{
+  std::lock_guard lock{getFileSystem().mutex};
+
+  auto&      files = getFileSystem().files;
+  const char kind  = (mode != nullptr) ? mode[0] : '\0';
+  const auto it    = files.find(filename);
+
+  switch (kind)
+  {
+    case 'r':
+    case 'u':
+      if (it == files.end())
+      {
+        return nullptr;
+      }
+      break;
+    case 'w':
+      clearContents(files[filename]);
+      break;
+    default:
+      return nullptr;
+  }
+
+  return new MATFile{filename, kind != 'r', 0, {}};
+}
+
+matError matClose(MATFile* mfp)
+{
+  delete mfp;
+
+  return 0;
+}
+
+FILE* matGetFp(MATFile*)
+{
+  return nullptr;
+}
+
+matError matPutVariable(MATFile* mfp, const char* name, const mxArray* pa)
+{
+  if (!mfp->writable || name == nullptr || pa == nullptr)
+  {
+    return 1;
+  }
+
+  std::lock_guard lock{getFileSystem().mutex};
+
+  FileContents& contents = getFileSystem().files[mfp->path];
+
+  if (const auto it = findVariable(contents, name); it != contents.end())
+  {
+    mxDestroyArray(it->second);
+    it->second = mxDuplicateArray(pa);
+  }
+  else
+  {
+    contents.emplace_back(name, mxDuplicateArray(pa));
+  }
+
+  return 0;
+}
+
+matError matPutVariableAsGlobal(MATFile* mfp, const char* name, const mxArray* pa)
+{
+  return matPutVariable(mfp, name, pa);
+}
+
+mxArray* matGetVariable(MATFile* mfp, const char* name)
+{
+  std::lock_guard lock{getFileSystem().mutex};
+
+  FileContents& contents = getFileSystem().files[mfp->path];
+
+  const auto it = findVariable(contents, name);
+
+  return (it != contents.end()) ? mxDuplicateArray(it->second) : nullptr;
+}
+
+mxArray* matGetVariableInfo(MATFile* mfp, const char* name)
+{
+  return matGetVariable(mfp, name);
+}
+
+mxArray* matGetNextVariable(MATFile* mfp, const char** name)
+{
+  return readNext(mfp, name);
+}
+
+mxArray* matGetNextVariableInfo(MATFile* mfp, const char** name)
+{
+  return readNext(mfp, name);
+}
+
+matError matDeleteVariable(MATFile* mfp, const char* name)
+{
+  if (!mfp->writable)
+  {
+    return 1;
+  }
+
+  std::lock_guard lock{getFileSystem().mutex};
+
+  FileContents& contents = getFileSystem().files[mfp->path];
+
+  const auto it = findVariable(contents, name);
+
+  if (it == contents.end())
+  {
+    return 1;
+  }
+
+  mxDestroyArray(it->second);
+  contents.erase(it);
+
+  return 0;
+}
+
+char** matGetDir(MATFile* mfp, int* num)
+{
+  std::lock_guard lock{getFileSystem().mutex};
+
+  const FileContents& contents = getFileSystem().files[mfp->path];
+
+  // Like MATLAB, the pointers and the names are a single allocation freed by one mxFree.
+  std::size_t bytes = contents.size() * sizeof(char*);
+
+  for (const auto& [name, array] : contents)
+  {
+    bytes += name.size() + 1;
+  }
+
+  auto** names = static_cast<char**>(mxMalloc(bytes));
+  char*  chars = reinterpret_cast<char*>(names + contents.size());
+
+  for (std::size_t i{}; i < contents.size(); ++i)
+  {
+    names[i] = static_cast<char*>(std::memcpy(chars, contents[i].first.c_str(), contents[i].first.size() + 1));
+    chars   += contents[i].first.size() + 1;
+  }
+
+  *num = static_cast<int>(contents.size());
+
+  return names;
+}
+} // extern "C"
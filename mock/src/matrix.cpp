@@ -0,0 +1,901 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Mock implementation of the MATLAB Matrix API. Memory from mxMalloc is never freed automatically, the mock behaves
+ * as if all memory and arrays were persistent. Arrays are not thread-safe, same as in MATLAB.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+
+#include "mxArray.hpp"
+
+namespace matlabw::mock::detail
+{
+namespace
+{
+  /**
+   * @brief Normalizes dimensions, there are at least 2 of them and no trailing singletons.
+   * @param ndim The number of dimensions.
+   * @param dims The dimensions.
+   * @return The normalized dimensions.
+   */
+  std::vector<mwSize> normalizeDims(mwSize ndim, const mwSize* dims)
+  {
+    std::vector<mwSize> result(dims, dims + ndim);
+
+    while (result.size() > 2 && result.back() == 1)
+    {
+      result.pop_back();
+    }
+
+    result.resize(std::max<std::size_t>(result.size(), 2), 1);
+
+    return result;
+  }
+
+  /**
+   * @brief Gets the number of elements of dimensions.
+   * @param dims The dimensions.
+   * @return The number of elements.
+   */
+  std::size_t getCount(const std::vector<mwSize>& dims) noexcept
+  {
+    return std::accumulate(dims.begin(), dims.end(), std::size_t{1}, std::multiplies<>{});
+  }
+
+  /**
+   * @brief Checks if a class stores its elements in arrays.
+   * @param classId The class.
+   * @return True for cells, structs and objects.
+   */
+  bool hasArrays(mxClassID classId) noexcept
+  {
+    return classId == mxCELL_CLASS || classId == mxSTRUCT_CLASS || classId == mxOBJECT_CLASS;
+  }
+
+  /**
+   * @brief Allocates zeroed data for the elements of an array.
+   * @param array The array.
+   * @param count The number of elements.
+   */
+  void allocateData(mxArray* array, std::size_t count)
+  {
+    array->data = mxCalloc(std::max<std::size_t>(count, 1), getElementSize(array->classId, array->complex));
+  }
+
+  /**
+   * @brief Creates a numeric array.
+   * @param ndim The number of dimensions.
+   * @param dims The dimensions.
+   * @param classId The class.
+   * @param flag The complexity.
+   * @return The array, nullptr if the class is not numeric.
+   */
+  mxArray* makeNumericArray(mwSize ndim, const mwSize* dims, mxClassID classId, mxComplexity flag)
+  {
+    if (classId < mxDOUBLE_CLASS || classId > mxUINT64_CLASS)
+    {
+      return nullptr;
+    }
+
+    mxArray* array = makeArray(classId, ndim, dims);
+    array->complex = (flag == mxCOMPLEX);
+    allocateData(array, getCount(array->dims));
+
+    return array;
+  }
+
+  /**
+   * @brief Creates a sparse array.
+   * @param m The number of rows.
+   * @param n The number of columns.
+   * @param nzmax The capacity of nonzeros.
+   * @param classId The class.
+   * @param complex True if complex.
+   * @return The array.
+   */
+  mxArray* makeSparse(mwSize m, mwSize n, mwSize nzmax, mxClassID classId, bool complex)
+  {
+    const mwSize dims[]{m, n};
+
+    mxArray* array = makeArray(classId, 2, dims);
+    array->complex = complex;
+    array->sparse  = true;
+    array->nzmax   = std::max<mwSize>(nzmax, 1);
+    array->ir      = static_cast<mwIndex*>(mxCalloc(array->nzmax, sizeof(mwIndex)));
+    array->jc      = static_cast<mwIndex*>(mxCalloc(n + 1, sizeof(mwIndex)));
+    allocateData(array, array->nzmax);
+
+    return array;
+  }
+
+  /**
+   * @brief Gets the number of struct elements of an array with fields.
+   * @param array The array.
+   * @return The number of elements.
+   */
+  std::size_t getStructCount(const mxArray* array) noexcept
+  {
+    return (array->fieldNames.empty()) ? getCount(array->dims) : array->arrays.size() / array->fieldNames.size();
+  }
+} // namespace
+
+  std::size_t getElementSize(mxClassID classId, bool complex) noexcept
+  {
+    std::size_t size{};
+
+    switch (classId)
+    {
+      case mxCELL_CLASS:
+      case mxSTRUCT_CLASS:
+      case mxOBJECT_CLASS:
+      case mxFUNCTION_CLASS:
+        return sizeof(mxArray*);
+      case mxLOGICAL_CLASS:
+        return sizeof(mxLogical);
+      case mxCHAR_CLASS:
+        return sizeof(mxChar);
+      case mxDOUBLE_CLASS:
+      case mxINT64_CLASS:
+      case mxUINT64_CLASS:
+        size = 8;
+        break;
+      case mxSINGLE_CLASS:
+      case mxINT32_CLASS:
+      case mxUINT32_CLASS:
+        size = 4;
+        break;
+      case mxINT16_CLASS:
+      case mxUINT16_CLASS:
+        size = 2;
+        break;
+      case mxINT8_CLASS:
+      case mxUINT8_CLASS:
+        size = 1;
+        break;
+      default:
+        return 0;
+    }
+
+    return (complex) ? 2 * size : size;
+  }
+
+  mxArray* makeArray(mxClassID classId, mwSize ndim, const mwSize* dims)
+  {
+    auto* array    = new mxArray{};
+    array->classId = classId;
+    array->dims    = normalizeDims(ndim, dims);
+
+    return array;
+  }
+} // namespace matlabw::mock::detail
+
+using namespace matlabw::mock::detail;
+
+extern "C"
+{
+void* mxMalloc(size_t n)
+{
+  return std::malloc(std::max<size_t>(n, 1));
+}
+
+void* mxCalloc(size_t n, size_t size)
+{
+  return std::calloc(std::max<size_t>(n, 1), std::max<size_t>(size, 1));
+}
+
+void* mxRealloc(void* ptr, size_t size)
+{
+  return std::realloc(ptr, std::max<size_t>(size, 1));
+}
+
+void mxFree(void* ptr)
+{
+  std::free(ptr);
+}
+
+mxArray* mxCreateNumericArray(mwSize ndim, const mwSize* dims, mxClassID classid, mxComplexity flag)
+{
+  return makeNumericArray(ndim, dims, classid, flag);
+}
+
+mxArray* mxCreateUninitNumericArray(size_t ndim, size_t* dims, mxClassID classid, mxComplexity flag)
+{
+  return makeNumericArray(ndim, dims, classid, flag);
+}
+
+mxArray* mxCreateNumericMatrix(mwSize m, mwSize n, mxClassID classid, mxComplexity flag)
+{
+  const mwSize dims[]{m, n};
+
+  return makeNumericArray(2, dims, classid, flag);
+}
+
+mxArray* mxCreateDoubleScalar(double value)
+{
+  mxArray* array = mxCreateNumericMatrix(1, 1, mxDOUBLE_CLASS, mxREAL);
+  *static_cast<double*>(array->data) = value;
+
+  return array;
+}
+
+mxArray* mxCreateLogicalArray(mwSize ndim, const mwSize* dims)
+{
+  mxArray* array = makeArray(mxLOGICAL_CLASS, ndim, dims);
+  allocateData(array, getCount(array->dims));
+
+  return array;
+}
+
+mxArray* mxCreateLogicalScalar(bool value)
+{
+  const mwSize dims[]{1, 1};
+
+  mxArray* array = mxCreateLogicalArray(2, dims);
+  *static_cast<mxLogical*>(array->data) = value;
+
+  return array;
+}
+
+mxArray* mxCreateCharArray(mwSize ndim, const mwSize* dims)
+{
+  mxArray* array = makeArray(mxCHAR_CLASS, ndim, dims);
+  allocateData(array, getCount(array->dims));
+
+  return array;
+}
+
+mxArray* mxCreateStringFromNChars(const char* str, mwSize n)
+{
+  const mwSize length = static_cast<mwSize>(std::find(str, str + n, '\0') - str);
+  const mwSize dims[]{(length > 0) ? mwSize{1} : mwSize{0}, length};
+
+  mxArray* array = mxCreateCharArray(2, dims);
+  auto*    chars = static_cast<mxChar*>(array->data);
+
+  std::transform(str, str + length, chars, [](char c) { return static_cast<mxChar>(static_cast<unsigned char>(c)); });
+
+  return array;
+}
+
+mxArray* mxCreateString(const char* str)
+{
+  return mxCreateStringFromNChars(str, std::strlen(str));
+}
+
+mxArray* mxCreateCellArray(mwSize ndim, const mwSize* dims)
+{
+  mxArray* array = makeArray(mxCELL_CLASS, ndim, dims);
+  array->arrays.resize(getCount(array->dims), nullptr);
+
+  return array;
+}
+
+mxArray* mxCreateStructArray(mwSize ndim, const mwSize* dims, int nfields, const char** fieldnames)
+{
+  mxArray* array = makeArray(mxSTRUCT_CLASS, ndim, dims);
+  array->fieldNames.assign(fieldnames, fieldnames + nfields);
+  array->arrays.resize(getCount(array->dims) * static_cast<std::size_t>(nfields), nullptr);
+
+  return array;
+}
+
+mxArray* mxCreateSparse(mwSize m, mwSize n, mwSize nzmax, mxComplexity flag)
+{
+  return makeSparse(m, n, nzmax, mxDOUBLE_CLASS, flag == mxCOMPLEX);
+}
+
+mxArray* mxCreateSparseLogicalMatrix(mwSize m, mwSize n, mwSize nzmax)
+{
+  return makeSparse(m, n, nzmax, mxLOGICAL_CLASS, false);
+}
+
+mxArray* mxDuplicateArray(const mxArray* pa)
+{
+  if (pa == nullptr)
+  {
+    return nullptr;
+  }
+
+  auto* array = new mxArray{*pa};
+
+  std::transform(pa->arrays.begin(), pa->arrays.end(), array->arrays.begin(), mxDuplicateArray);
+
+  if (pa->data != nullptr)
+  {
+    const std::size_t count = (pa->sparse) ? pa->nzmax : mxGetNumberOfElements(pa);
+    const std::size_t bytes = count * getElementSize(pa->classId, pa->complex);
+
+    array->data = std::memcpy(mxMalloc(bytes), pa->data, bytes);
+  }
+
+  if (pa->sparse)
+  {
+    array->ir = static_cast<mwIndex*>(std::memcpy(mxMalloc(pa->nzmax * sizeof(mwIndex)),
+                                                  pa->ir,
+                                                  pa->nzmax * sizeof(mwIndex)));
+    array->jc = static_cast<mwIndex*>(std::memcpy(mxMalloc((pa->dims[1] + 1) * sizeof(mwIndex)),
+                                                  pa->jc,
+                                                  (pa->dims[1] + 1) * sizeof(mwIndex)));
+  }
+
+  return array;
+}
+
+void mxDestroyArray(mxArray* pa)
+{
+  if (pa == nullptr)
+  {
+    return;
+  }
+
+  std::for_each(pa->arrays.begin(), pa->arrays.end(), mxDestroyArray);
+
+  mxFree(pa->data);
+  mxFree(pa->ir);
+  mxFree(pa->jc);
+
+  delete pa;
+}
+
+mxClassID mxGetClassID(const mxArray* pa)
+{
+  return pa->classId;
+}
+
+const char* mxGetClassName(const mxArray* pa)
+{
+  static constexpr const char* names[]{"unknown", "cell", "struct", "logical", "char", "void", "double", "single",
+                                       "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64", "uint64",
+                                       "function_handle", "opaque"};
+
+  if (pa->classId == mxOBJECT_CLASS)
+  {
+    return pa->className.c_str();
+  }
+
+  return names[std::min<std::size_t>(pa->classId, std::size(names) - 1)];
+}
+
+int mxSetClassName(mxArray* pa, const char* classname)
+{
+  if (pa->classId != mxSTRUCT_CLASS && pa->classId != mxOBJECT_CLASS)
+  {
+    return 1;
+  }
+
+  pa->classId   = mxOBJECT_CLASS;
+  pa->className = classname;
+
+  return 0;
+}
+
+size_t mxGetElementSize(const mxArray* pa)
+{
+  return getElementSize(pa->classId, pa->complex);
+}
+
+mwSize mxGetNumberOfDimensions(const mxArray* pa)
+{
+  return pa->dims.size();
+}
+
+const mwSize* mxGetDimensions(const mxArray* pa)
+{
+  return pa->dims.data();
+}
+
+int mxSetDimensions(mxArray* pa, const mwSize* dims, mwSize ndim)
+{
+  pa->dims = normalizeDims(ndim, dims);
+
+  // Cells and structs follow the number of elements, numeric data keep their allocation like in MATLAB.
+  if (pa->classId == mxCELL_CLASS)
+  {
+    pa->arrays.resize(getCount(pa->dims), nullptr);
+  }
+  else if (pa->classId == mxSTRUCT_CLASS || pa->classId == mxOBJECT_CLASS)
+  {
+    pa->arrays.resize(getCount(pa->dims) * pa->fieldNames.size(), nullptr);
+  }
+
+  return 0;
+}
+
+size_t mxGetM(const mxArray* pa)
+{
+  return pa->dims[0];
+}
+
+size_t mxGetN(const mxArray* pa)
+{
+  return std::accumulate(pa->dims.begin() + 1, pa->dims.end(), std::size_t{1}, std::multiplies<>{});
+}
+
+void mxSetM(mxArray* pa, mwSize m)
+{
+  const mwSize dims[]{m, mxGetN(pa)};
+
+  mxSetDimensions(pa, dims, 2);
+}
+
+void mxSetN(mxArray* pa, mwSize n)
+{
+  const mwSize dims[]{pa->dims[0], n};
+
+  mxSetDimensions(pa, dims, 2);
+}
+
+size_t mxGetNumberOfElements(const mxArray* pa)
+{
+  return getCount(pa->dims);
+}
+
+mwIndex mxCalcSingleSubscript(const mxArray* pa, mwSize nsubs, const mwIndex* subs)
+{
+  mwIndex index{};
+  mwIndex stride{1};
+
+  for (mwSize k{}; k < nsubs; ++k)
+  {
+    index  += subs[k] * stride;
+    stride *= (k < pa->dims.size()) ? pa->dims[k] : 1;
+  }
+
+  return index;
+}
+
+void* mxGetData(const mxArray* pa)
+{
+  return (hasArrays(pa->classId)) ? const_cast<mxArray**>(pa->arrays.data()) : pa->data;
+}
+
+void mxSetData(mxArray* pa, void* data)
+{
+  pa->data = data;
+}
+
+mwIndex* mxGetIr(const mxArray* pa)
+{
+  return pa->ir;
+}
+
+mwIndex* mxGetJc(const mxArray* pa)
+{
+  return pa->jc;
+}
+
+void mxSetIr(mxArray* pa, mwIndex* ir)
+{
+  pa->ir = ir;
+}
+
+void mxSetJc(mxArray* pa, mwIndex* jc)
+{
+  pa->jc = jc;
+}
+
+mwSize mxGetNzmax(const mxArray* pa)
+{
+  return pa->nzmax;
+}
+
+void mxSetNzmax(mxArray* pa, mwSize nzmax)
+{
+  if (!pa->sparse)
+  {
+    return;
+  }
+
+  pa->nzmax = std::max<mwSize>(nzmax, 1);
+  pa->data  = mxRealloc(pa->data, pa->nzmax * getElementSize(pa->classId, pa->complex));
+  pa->ir    = static_cast<mwIndex*>(mxRealloc(pa->ir, pa->nzmax * sizeof(mwIndex)));
+}
+
+mxArray* mxGetCell(const mxArray* pa, mwIndex i)
+{
+  return (pa->classId == mxCELL_CLASS && i < pa->arrays.size()) ? pa->arrays[i] : nullptr;
+}
+
+void mxSetCell(mxArray* pa, mwIndex i, mxArray* value)
+{
+  if (pa->classId == mxCELL_CLASS && i < pa->arrays.size())
+  {
+    pa->arrays[i] = value;
+  }
+}
+
+int mxGetNumberOfFields(const mxArray* pa)
+{
+  return static_cast<int>(pa->fieldNames.size());
+}
+
+const char* mxGetFieldNameByNumber(const mxArray* pa, int n)
+{
+  return (n >= 0 && static_cast<std::size_t>(n) < pa->fieldNames.size()) ? pa->fieldNames[n].c_str() : nullptr;
+}
+
+int mxGetFieldNumber(const mxArray* pa, const char* name)
+{
+  const auto it = std::find(pa->fieldNames.begin(), pa->fieldNames.end(), name);
+
+  return (it != pa->fieldNames.end()) ? static_cast<int>(it - pa->fieldNames.begin()) : -1;
+}
+
+mxArray* mxGetFieldByNumber(const mxArray* pa, mwIndex i, int fieldnum)
+{
+  const std::size_t fieldCount = pa->fieldNames.size();
+
+  if (fieldnum < 0 || static_cast<std::size_t>(fieldnum) >= fieldCount || i >= getStructCount(pa))
+  {
+    return nullptr;
+  }
+
+  return pa->arrays[i * fieldCount + static_cast<std::size_t>(fieldnum)];
+}
+
+void mxSetFieldByNumber(mxArray* pa, mwIndex i, int fieldnum, mxArray* value)
+{
+  const std::size_t fieldCount = pa->fieldNames.size();
+
+  if (fieldnum >= 0 && static_cast<std::size_t>(fieldnum) < fieldCount && i < getStructCount(pa))
+  {
+    pa->arrays[i * fieldCount + static_cast<std::size_t>(fieldnum)] = value;
+  }
+}
+
+mxArray* mxGetField(const mxArray* pa, mwIndex i, const char* fieldname)
+{
+  return mxGetFieldByNumber(pa, i, mxGetFieldNumber(pa, fieldname));
+}
+
+void mxSetField(mxArray* pa, mwIndex i, const char* fieldname, mxArray* value)
+{
+  mxSetFieldByNumber(pa, i, mxGetFieldNumber(pa, fieldname), value);
+}
+
+int mxAddField(mxArray* pa, const char* fieldname)
+{
+  if ((pa->classId != mxSTRUCT_CLASS && pa->classId != mxOBJECT_CLASS) || fieldname == nullptr)
+  {
+    return -1;
+  }
+
+  if (const int existing = mxGetFieldNumber(pa, fieldname); existing >= 0)
+  {
+    return existing;
+  }
+
+  const std::size_t count      = getStructCount(pa);
+  const std::size_t fieldCount = pa->fieldNames.size();
+
+  std::vector<mxArray*> arrays(count * (fieldCount + 1), nullptr);
+
+  for (std::size_t i{}; i < count; ++i)
+  {
+    std::copy_n(pa->arrays.begin() + static_cast<std::ptrdiff_t>(i * fieldCount),
+                fieldCount,
+                arrays.begin() + static_cast<std::ptrdiff_t>(i * (fieldCount + 1)));
+  }
+
+  pa->arrays = std::move(arrays);
+  pa->fieldNames.emplace_back(fieldname);
+
+  return static_cast<int>(fieldCount);
+}
+
+void mxRemoveField(mxArray* pa, int fieldnum)
+{
+  const std::size_t fieldCount = pa->fieldNames.size();
+
+  if (fieldnum < 0 || static_cast<std::size_t>(fieldnum) >= fieldCount)
+  {
+    return;
+  }
+
+  const std::size_t count = getStructCount(pa);
+
+  std::vector<mxArray*> arrays{};
+  arrays.reserve(count * (fieldCount - 1));
+
+  // Like MATLAB, the values of the removed field are not destroyed.
+  for (std::size_t j{}; j < pa->arrays.size(); ++j)
+  {
+    if (j % fieldCount != static_cast<std::size_t>(fieldnum))
+    {
+      arrays.push_back(pa->arrays[j]);
+    }
+  }
+
+  pa->arrays = std::move(arrays);
+  pa->fieldNames.erase(pa->fieldNames.begin() + fieldnum);
+}
+
+mxArray* mxGetProperty(const mxArray* pa, mwIndex i, const char* propname)
+{
+  if (pa->classId != mxOBJECT_CLASS)
+  {
+    return nullptr;
+  }
+
+  return mxDuplicateArray(mxGetField(pa, i, propname));
+}
+
+void mxSetProperty(mxArray* pa, mwIndex i, const char* propname, const mxArray* value)
+{
+  if (pa->classId != mxOBJECT_CLASS || i >= getStructCount(pa))
+  {
+    return;
+  }
+
+  const int fieldnum = mxAddField(pa, propname);
+  mxArray*& field    = pa->arrays[i * pa->fieldNames.size() + static_cast<std::size_t>(fieldnum)];
+
+  mxDestroyArray(field);
+  field = mxDuplicateArray(value);
+}
+
+int mxGetString(const mxArray* pa, char* buf, mwSize buflen)
+{
+  if (pa->classId != mxCHAR_CLASS || buflen == 0)
+  {
+    return 1;
+  }
+
+  const std::size_t count  = mxGetNumberOfElements(pa);
+  const std::size_t length = std::min<std::size_t>(count, buflen - 1);
+  const auto*       chars  = static_cast<const mxChar*>(pa->data);
+
+  std::transform(chars, chars + length, buf, [](mxChar c) { return static_cast<char>(c); });
+  buf[length] = '\0';
+
+  return (length < count) ? 1 : 0;
+}
+
+char* mxArrayToString(const mxArray* pa)
+{
+  if (pa->classId != mxCHAR_CLASS)
+  {
+    return nullptr;
+  }
+
+  const std::size_t count = mxGetNumberOfElements(pa);
+  auto*             str   = static_cast<char*>(mxMalloc(count + 1));
+
+  mxGetString(pa, str, count + 1);
+
+  return str;
+}
+
+char* mxArrayToUTF8String(const mxArray* pa)
+{
+  if (pa->classId != mxCHAR_CLASS)
+  {
+    return nullptr;
+  }
+
+  const std::size_t count = mxGetNumberOfElements(pa);
+  const auto*       chars = static_cast<const mxChar*>(pa->data);
+
+  std::string str{};
+  str.reserve(count);
+
+  for (std::size_t i{}; i < count; ++i)
+  {
+    char32_t c = chars[i];
+
+    if (c >= 0xd800 && c < 0xdc00 && i + 1 < count && chars[i + 1] >= 0xdc00 && chars[i + 1] < 0xe000)
+    {
+      c = 0x10000 + ((c - 0xd800) << 10) + (chars[++i] - 0xdc00);
+    }
+    else if (c >= 0xd800 && c < 0xe000)
+    {
+      c = 0xfffd;
+    }
+
+    if (c < 0x80)
+    {
+      str += static_cast<char>(c);
+    }
+    else if (c < 0x800)
+    {
+      str += static_cast<char>(0xc0 | (c >> 6));
+      str += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    else if (c < 0x10000)
+    {
+      str += static_cast<char>(0xe0 | (c >> 12));
+      str += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      str += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    else
+    {
+      str += static_cast<char>(0xf0 | (c >> 18));
+      str += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+      str += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      str += static_cast<char>(0x80 | (c & 0x3f));
+    }
+  }
+
+  return static_cast<char*>(std::memcpy(mxMalloc(str.size() + 1), str.c_str(), str.size() + 1));
+}
+
+bool mxIsCell(const mxArray* pa)
+{
+  return pa->classId == mxCELL_CLASS;
+}
+
+bool mxIsChar(const mxArray* pa)
+{
+  return pa->classId == mxCHAR_CLASS;
+}
+
+bool mxIsClass(const mxArray* pa, const char* name)
+{
+  return std::strcmp(mxGetClassName(pa), name) == 0;
+}
+
+bool mxIsComplex(const mxArray* pa)
+{
+  return pa->complex;
+}
+
+bool mxIsDouble(const mxArray* pa)
+{
+  return pa->classId == mxDOUBLE_CLASS;
+}
+
+bool mxIsEmpty(const mxArray* pa)
+{
+  return mxGetNumberOfElements(pa) == 0;
+}
+
+bool mxIsFromGlobalWS(const mxArray*)
+{
+  return false;
+}
+
+bool mxIsGPUArray(const mxArray*)
+{
+  return false;
+}
+
+bool mxIsInt8(const mxArray* pa)
+{
+  return pa->classId == mxINT8_CLASS;
+}
+
+bool mxIsInt16(const mxArray* pa)
+{
+  return pa->classId == mxINT16_CLASS;
+}
+
+bool mxIsInt32(const mxArray* pa)
+{
+  return pa->classId == mxINT32_CLASS;
+}
+
+bool mxIsInt64(const mxArray* pa)
+{
+  return pa->classId == mxINT64_CLASS;
+}
+
+bool mxIsLogical(const mxArray* pa)
+{
+  return pa->classId == mxLOGICAL_CLASS;
+}
+
+bool mxIsLogicalScalar(const mxArray* pa)
+{
+  return mxIsLogical(pa) && mxGetNumberOfElements(pa) == 1;
+}
+
+bool mxIsLogicalScalarTrue(const mxArray* pa)
+{
+  return mxIsLogicalScalar(pa) && *static_cast<const mxLogical*>(pa->data);
+}
+
+bool mxIsNumeric(const mxArray* pa)
+{
+  return pa->classId >= mxDOUBLE_CLASS && pa->classId <= mxUINT64_CLASS;
+}
+
+bool mxIsScalar(const mxArray* pa)
+{
+  return mxGetNumberOfElements(pa) == 1;
+}
+
+bool mxIsSingle(const mxArray* pa)
+{
+  return pa->classId == mxSINGLE_CLASS;
+}
+
+bool mxIsSparse(const mxArray* pa)
+{
+  return pa->sparse;
+}
+
+bool mxIsStruct(const mxArray* pa)
+{
+  return pa->classId == mxSTRUCT_CLASS;
+}
+
+bool mxIsUint8(const mxArray* pa)
+{
+  return pa->classId == mxUINT8_CLASS;
+}
+
+bool mxIsUint16(const mxArray* pa)
+{
+  return pa->classId == mxUINT16_CLASS;
+}
+
+bool mxIsUint32(const mxArray* pa)
+{
+  return pa->classId == mxUINT32_CLASS;
+}
+
+bool mxIsUint64(const mxArray* pa)
+{
+  return pa->classId == mxUINT64_CLASS;
+}
+
+double mxGetEps(void)
+{
+  return DBL_EPSILON;
+}
+
+double mxGetInf(void)
+{
+  return HUGE_VAL;
+}
+
+double mxGetNaN(void)
+{
+  return std::nan("");
+}
+
+bool mxIsFinite(double x)
+{
+  return std::isfinite(x);
+}
+
+bool mxIsInf(double x)
+{
+  return std::isinf(x);
+}
+
+bool mxIsNaN(double x)
+{
+  return std::isnan(x);
+}
+} // extern "C"
@@ -0,0 +1,406 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Mock implementation of the MEX API. Output goes to stdout and stderr, errors are thrown as
+ * matlabw::mock::MexError and MATLAB functions are the ones registered by matlabw::mock::registerFunction.
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <matlabw/mock/mock.hpp>
+
+#include "mxArray.hpp"
+
+namespace matlabw::mock
+{
+namespace
+{
+  /// @brief Function registered by mexAtExit.
+  using ExitFunction = void(*)();
+
+  /// @brief State of the mocked MATLAB session.
+  struct Session
+  {
+    std::recursive_mutex                                   mutex{};      ///< Guards the session.
+    std::map<std::string, Function>                        functions{};  ///< The registered functions.
+    std::map<std::string, std::map<std::string, mxArray*>> workspaces{}; ///< The variables of each workspace.
+    ExitFunction                                           atExit{};     ///< The function registered by mexAtExit.
+    int                                                    lockCount{};  ///< The number of mexLock calls.
+  };
+
+  /**
+   * @brief Gets the session.
+   * @return The session.
+   */
+  Session& getSession()
+  {
+    static Session session{};
+
+    return session;
+  }
+
+  /**
+   * @brief Formats a message like vsnprintf.
+   * @param format The format.
+   * @param args The arguments.
+   * @return The message.
+   */
+  std::string formatMessage(const char* format, std::va_list args)
+  {
+    std::va_list copy;
+    va_copy(copy, args);
+
+    const int length = std::vsnprintf(nullptr, 0, format, copy);
+
+    va_end(copy);
+
+    std::string message(static_cast<std::size_t>(std::max(length, 0)), '\0');
+
+    std::vsnprintf(message.data(), message.size() + 1, format, args);
+
+    return message;
+  }
+
+  /**
+   * @brief Gets the workspace of a name, the caller workspace is the base one as there is no calling function.
+   * @param workspace The name of the workspace.
+   * @return The workspace, nullptr if the name is invalid.
+   */
+  std::map<std::string, mxArray*>* getWorkspace(const char* workspace)
+  {
+    const std::string name{workspace};
+
+    if (name != "base" && name != "caller" && name != "global")
+    {
+      return nullptr;
+    }
+
+    return &getSession().workspaces[(name == "global") ? name : "base"];
+  }
+
+  /**
+   * @brief Calls a registered function, feval with a function handle calls the function of the handle.
+   * @param nlhs The number of outputs.
+   * @param plhs The outputs.
+   * @param nrhs The number of inputs.
+   * @param prhs The inputs.
+   * @param name The name of the function.
+   */
+  void call(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const std::string& name)
+  {
+    if (name == "feval" && nrhs > 0 && (mxGetClassID(prhs[0]) == mxFUNCTION_CLASS || mxIsChar(prhs[0])))
+    {
+      std::string target = prhs[0]->className;
+
+      if (mxIsChar(prhs[0]))
+      {
+        target.resize(mxGetNumberOfElements(prhs[0]) + 1);
+        mxGetString(prhs[0], target.data(), target.size());
+        target.pop_back();
+      }
+
+      call(nlhs, plhs, nrhs - 1, prhs + 1, target);
+
+      return;
+    }
+
+    Function function{};
+
+    {
+      std::lock_guard lock{getSession().mutex};
+
+      const auto it = getSession().functions.find(name);
+
+      if (it == getSession().functions.end())
+      {
+        throw MexError{"MATLAB:UndefinedFunction", "Undefined function '" + name + "'."};
+      }
+
+      function = it->second;
+    }
+
+    function(nlhs, plhs, nrhs, prhs);
+  }
+
+  /**
+   * @brief Runs a call and converts its error to an MException.
+   * @tparam Fn The callable type.
+   * @param fn The callable.
+   * @return The MException, nullptr on success.
+   */
+  template<typename Fn>
+  mxArray* trap(Fn&& fn)
+  {
+    try
+    {
+      fn();
+    }
+    catch (const MexError& e)
+    {
+      return makeMException(e.getId(), e.what());
+    }
+    catch (const std::exception& e)
+    {
+      return makeMException("matlabw:mock:error", e.what());
+    }
+
+    return nullptr;
+  }
+} // namespace
+
+  void registerFunction(const std::string& name, Function function)
+  {
+    std::lock_guard lock{getSession().mutex};
+
+    getSession().functions[name] = std::move(function);
+  }
+
+  void unregisterFunction(const std::string& name)
+  {
+    std::lock_guard lock{getSession().mutex};
+
+    getSession().functions.erase(name);
+  }
+
+  mxArray* makeFunctionHandle(const std::string& name)
+  {
+    const mwSize dims[]{1, 1};
+
+    mxArray* array   = detail::makeArray(mxFUNCTION_CLASS, 2, dims);
+    array->className = name;
+
+    return array;
+  }
+
+  mxArray* makeMException(const std::string& id, const std::string& message)
+  {
+    const mwSize dims[]{1, 1};
+
+    mxArray* array = mxCreateStructArray(2, dims, 0, nullptr);
+
+    mxSetClassName(array, "MException");
+
+    mxArray* identifier = mxCreateString(id.c_str());
+    mxArray* text       = mxCreateString(message.c_str());
+
+    mxSetProperty(array, 0, "identifier", identifier);
+    mxSetProperty(array, 0, "message", text);
+
+    mxDestroyArray(identifier);
+    mxDestroyArray(text);
+
+    return array;
+  }
+
+  void clearMex()
+  {
+    std::lock_guard lock{getSession().mutex};
+
+    if (getSession().lockCount == 0 && getSession().atExit != nullptr)
+    {
+      std::exchange(getSession().atExit, nullptr)();
+    }
+  }
+
+  void clearWorkspaces()
+  {
+    std::lock_guard lock{getSession().mutex};
+
+    for (auto& [workspaceName, variables] : getSession().workspaces)
+    {
+      for (auto& [name, array] : variables)
+      {
+        mxDestroyArray(array);
+      }
+    }
+
+    getSession().workspaces.clear();
+  }
+} // namespace matlabw::mock
+
+using namespace matlabw::mock;
+
+extern "C"
+{
+int mexPrintf(const char* format, ...)
+{
+  std::va_list args;
+  va_start(args, format);
+
+  const int result = std::vprintf(format, args);
+
+  va_end(args);
+
+  return result;
+}
+
+void mexErrMsgTxt(const char* msg)
+{
+  throw MexError{"", msg};
+}
+
+void mexErrMsgIdAndTxt(const char* id, const char* format, ...)
+{
+  std::va_list args;
+  va_start(args, format);
+
+  std::string message = formatMessage(format, args);
+
+  va_end(args);
+
+  throw MexError{id, message};
+}
+
+void mexWarnMsgTxt(const char* msg)
+{
+  std::fprintf(stderr, "Warning: %s\n", msg);
+}
+
+void mexWarnMsgIdAndTxt(const char* id, const char* format, ...)
+{
+  std::va_list args;
+  va_start(args, format);
+
+  const std::string message = formatMessage(format, args);
+
+  va_end(args);
+
+  std::fprintf(stderr, "Warning: %s [%s]\n", message.c_str(), id);
+}
+
+int mexCallMATLAB(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name)
+{
+  call(nlhs, plhs, nrhs, prhs, name);
+
+  return 0;
+}
+
+mxArray* mexCallMATLABWithTrap(int nlhs, mxArray* plhs[], int nrhs, mxArray* prhs[], const char* name)
+{
+  return trap([&]{ call(nlhs, plhs, nrhs, prhs, name); });
+}
+
+int mexEvalString(const char* command)
+{
+  call(0, nullptr, 0, nullptr, command);
+
+  return 0;
+}
+
+mxArray* mexEvalStringWithTrap(const char* command)
+{
+  return trap([&]{ call(0, nullptr, 0, nullptr, command); });
+}
+
+mxArray* mexGetVariable(const char* workspace, const char* name)
+{
+  return mxDuplicateArray(mexGetVariablePtr(workspace, name));
+}
+
+const mxArray* mexGetVariablePtr(const char* workspace, const char* name)
+{
+  std::lock_guard lock{getSession().mutex};
+
+  auto* variables = getWorkspace(workspace);
+
+  if (variables == nullptr)
+  {
+    return nullptr;
+  }
+
+  const auto it = variables->find(name);
+
+  return (it != variables->end()) ? it->second : nullptr;
+}
+
+int mexPutVariable(const char* workspace, const char* name, const mxArray* pa)
+{
+  std::lock_guard lock{getSession().mutex};
+
+  auto* variables = getWorkspace(workspace);
+
+  if (variables == nullptr || pa == nullptr)
+  {
+    return 1;
+  }
+
+  mxArray*& variable = (*variables)[name];
+
+  mxDestroyArray(variable);
+  variable = mxDuplicateArray(pa);
+
+  return 0;
+}
+
+const char* mexFunctionName(void)
+{
+  return "mock";
+}
+
+int mexAtExit(void (*exitFcn)(void))
+{
+  std::lock_guard lock{getSession().mutex};
+
+  getSession().atExit = exitFcn;
+
+  return 0;
+}
+
+void mexLock(void)
+{
+  std::lock_guard lock{getSession().mutex};
+
+  ++getSession().lockCount;
+}
+
+void mexUnlock(void)
+{
+  std::lock_guard lock{getSession().mutex};
+
+  if (getSession().lockCount > 0)
+  {
+    --getSession().lockCount;
+  }
+}
+
+bool mexIsLocked(void)
+{
+  std::lock_guard lock{getSession().mutex};
+
+  return getSession().lockCount > 0;
+}
+
+void mexMakeArrayPersistent(mxArray*)
+{}
+
+void mexMakeMemoryPersistent(void*)
+{}
+} // extern "C"
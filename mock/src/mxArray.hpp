@@ -0,0 +1,72 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#ifndef MATLABW_MOCK_SRC_MX_ARRAY_HPP
+#define MATLABW_MOCK_SRC_MX_ARRAY_HPP
+
+#include <string>
+#include <vector>
+
+#include <matrix.h>
+
+/**
+ * @brief Mock array. Numeric, logical and char elements are stored in mxMalloc memory, interleaved for complex
+ *        arrays. Cells store their elements and structs and objects their fields element by element in arrays.
+ */
+struct mxArray_tag
+{
+  mxClassID                classId{mxUNKNOWN_CLASS}; ///< The class.
+  bool                     complex{};                ///< True if the numeric array is complex.
+  bool                     sparse{};                 ///< True if the array is sparse.
+  std::vector<mwSize>      dims{0, 0};               ///< The dimensions, at least 2 without trailing singletons.
+  void*                    data{};                   ///< The elements, nonzeros of sparse arrays.
+  mwIndex*                 ir{};                     ///< Row indices of the nonzeros of sparse arrays.
+  mwIndex*                 jc{};                     ///< Column starts of sparse arrays.
+  mwSize                   nzmax{};                  ///< Capacity of the nonzeros of sparse arrays.
+  std::vector<mxArray*>    arrays{};                 ///< Cell elements, or fields of each struct element.
+  std::vector<std::string> fieldNames{};             ///< Field names of structs and objects.
+  std::string              className{};              ///< Class name of objects, function name of function handles.
+};
+
+namespace matlabw::mock::detail
+{
+  /**
+   * @brief Gets the size of an element of a class.
+   * @param classId The class.
+   * @param complex True if complex.
+   * @return The size in bytes.
+   */
+  [[nodiscard]] std::size_t getElementSize(mxClassID classId, bool complex) noexcept;
+
+  /**
+   * @brief Creates an array with normalized dimensions and no data.
+   * @param classId The class.
+   * @param ndim The number of dimensions.
+   * @param dims The dimensions.
+   * @return The array.
+   */
+  [[nodiscard]] mxArray* makeArray(mxClassID classId, mwSize ndim, const mwSize* dims);
+} // namespace matlabw::mock::detail
+
+#endif /* MATLABW_MOCK_SRC_MX_ARRAY_HPP */
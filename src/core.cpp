@@ -0,0 +1,44 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Explicit instantiations of the typed array templates for the standard element types. Targets linking matlabw-core
+ * see them as extern templates and do not instantiate them again in every translation unit.
+ */
+
+#ifndef MATLABW_BUILDING_CORE
+# define MATLABW_BUILDING_CORE
+#endif
+
+#include <matlabw/mx/mx.hpp>
+
+namespace matlabw::mx
+{
+#define MATLABW_MX_DETAIL_INSTANTIATE_TYPED_ARRAY(T) \
+  template class TypedArray<T>;                      \
+  template class TypedArrayRef<T>;                   \
+  template class TypedArrayCref<T>;
+  MATLABW_MX_DETAIL_FOR_EACH_CORE_TYPE(MATLABW_MX_DETAIL_INSTANTIATE_TYPED_ARRAY)
+#undef MATLABW_MX_DETAIL_INSTANTIATE_TYPED_ARRAY
+} // namespace matlabw::mx
@@ -0,0 +1,406 @@
+/*
+  This file is part of matlab-cpp-wrapper library.
+
+  Copyright (c) 2024 David Bayer
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+ * Converts MAT files between formats. Inputs are files or directories of .mat files, the outputs are written to the
+ * output directory with the same relative paths. Files are loaded on a pool of I/O threads and written as they
+ * arrive, with one thread the variables are streamed one at a time.
+ *
+ * Usage: matlabw-matconv -o <dir> [-f v6|v7|v7.3|serial] [-v <name>]... [-j <threads>] [-r] [-q] <input>...
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <matlabw/mat/ParallelLoader.hpp>
+#include <matlabw/mx/serialize.hpp>
+
+namespace fs = std::filesystem;
+
+using namespace matlabw;
+
+namespace
+{
+  /// @brief Output format.
+  enum class OutputFormat
+  {
+    mat,    ///< MAT file in the format of the write options.
+    serial, ///< Serialized scalar struct with a field per variable, see mx::saveSerialized().
+  };
+
+  /// @brief Command line options.
+  struct Options
+  {
+    fs::path                 output{};                      ///< Output directory.
+    OutputFormat             format{OutputFormat::mat};     ///< Output format.
+    mat::WriteOptions        writeOptions{mat::Format::v7}; ///< MAT format of the outputs.
+    std::vector<std::string> variables{};                   ///< Variables to convert, all if empty.
+    std::size_t              threadCount{4};                ///< Number of I/O threads.
+    bool                     recursive{};                   ///< Search input directories recursively.
+    bool                     quiet{};                       ///< Do not report progress.
+    std::vector<fs::path>    inputs{};                      ///< Input files and directories.
+  };
+
+  /// @brief File to convert.
+  struct Job
+  {
+    fs::path input;  ///< Input path.
+    fs::path output; ///< Output path.
+  };
+
+  /// @brief Prints the usage.
+  void printUsage()
+  {
+    std::fprintf(stderr,
+                 "Usage: matlabw-matconv -o <dir> [-f v6|v7|v7.3|serial] [-v <name>]... [-j <threads>] [-r] [-q] "
+                 "<input>...\n"
+                 "  -o <dir>      output directory\n"
+                 "  -f <format>   output format, v7 by default\n"
+                 "  -v <name>     convert only the variable, may be repeated\n"
+                 "  -j <threads>  number of I/O threads, 4 by default, 1 streams the variables one at a time\n"
+                 "  -r            search input directories recursively\n"
+                 "  -q            do not report progress\n");
+  }
+
+  /**
+   * @brief Parses the command line.
+   * @param argc Number of arguments.
+   * @param argv Arguments.
+   * @return The options, std::nullopt if the command line is invalid.
+   */
+  [[nodiscard]] std::optional<Options> parseOptions(int argc, char* argv[])
+  {
+    Options options{};
+
+    for (int i{1}; i < argc; ++i)
+    {
+      const std::string_view arg{argv[i]};
+
+      auto value = [&]() -> const char*
+      {
+        return (i + 1 < argc) ? argv[++i] : nullptr;
+      };
+
+      if (arg == "-o" || arg == "-f" || arg == "-v" || arg == "-j")
+      {
+        const char* param = value();
+
+        if (param == nullptr)
+        {
+          return std::nullopt;
+        }
+
+        if (arg == "-o")
+        {
+          options.output = param;
+        }
+        else if (arg == "-v")
+        {
+          options.variables.emplace_back(param);
+        }
+        else if (arg == "-j")
+        {
+          options.threadCount = std::max(std::strtoul(param, nullptr, 10), 1ul);
+        }
+        else if (const std::string_view format{param}; format == "serial")
+        {
+          options.format = OutputFormat::serial;
+        }
+        else if (format == "v6" || format == "v7" || format == "v7.3")
+        {
+          options.writeOptions.format = (format == "v6") ? mat::Format::v6
+                                      : (format == "v7") ? mat::Format::v7 : mat::Format::v7_3;
+        }
+        else
+        {
+          return std::nullopt;
+        }
+      }
+      else if (arg == "-r")
+      {
+        options.recursive = true;
+      }
+      else if (arg == "-q")
+      {
+        options.quiet = true;
+      }
+      else if (!arg.empty() && arg.front() == '-')
+      {
+        return std::nullopt;
+      }
+      else
+      {
+        options.inputs.emplace_back(arg);
+      }
+    }
+
+    if (options.output.empty() || options.inputs.empty())
+    {
+      return std::nullopt;
+    }
+
+    return options;
+  }
+
+  /**
+   * @brief Collects the files to convert.
+   * @param options The options.
+   * @return The jobs.
+   */
+  [[nodiscard]] std::vector<Job> collectJobs(const Options& options)
+  {
+    const fs::path extension = (options.format == OutputFormat::serial) ? ".mwser" : ".mat";
+
+    std::vector<Job> jobs{};
+
+    auto add = [&](const fs::path& input, const fs::path& relative)
+    {
+      jobs.push_back(Job{input, (options.output / relative).replace_extension(extension)});
+    };
+
+    for (const fs::path& input : options.inputs)
+    {
+      if (!fs::is_directory(input))
+      {
+        add(input, input.filename());
+        continue;
+      }
+
+      auto visit = [&](const fs::directory_entry& entry)
+      {
+        if (entry.is_regular_file() && entry.path().extension() == ".mat")
+        {
+          add(entry.path(), fs::relative(entry.path(), input));
+        }
+      };
+
+      if (options.recursive)
+      {
+        std::for_each(fs::recursive_directory_iterator{input}, fs::recursive_directory_iterator{}, visit);
+      }
+      else
+      {
+        std::for_each(fs::directory_iterator{input}, fs::directory_iterator{}, visit);
+      }
+    }
+
+    return jobs;
+  }
+
+  /**
+   * @brief Writes the variables of a file.
+   * @param options The options.
+   * @param path The output path.
+   * @param variables The variables.
+   */
+  void writeFile(const Options& options, const fs::path& path, std::vector<mat::Variable>& variables)
+  {
+    fs::create_directories(path.parent_path());
+
+    if (options.format == OutputFormat::serial)
+    {
+      std::vector<const char*> names(variables.size());
+
+      std::transform(variables.begin(), variables.end(), names.begin(), [](const mat::Variable& variable)
+      {
+        return variable.name.c_str();
+      });
+
+      const std::size_t dims[]{1, 1};
+
+      mx::Array record{mxCreateStructArray(2, dims, static_cast<int>(names.size()), names.data())};
+
+      for (std::size_t k{}; k < variables.size(); ++k)
+      {
+        mxSetFieldByNumber(record.get(), 0, static_cast<int>(k), variables[k].array.release());
+      }
+
+      mx::saveSerialized(path.string().c_str(), record);
+      return;
+    }
+
+    std::size_t largestBytes{};
+
+    for (const mat::Variable& variable : variables)
+    {
+      largestBytes = std::max(largestBytes, mat::detail::getArrayBytes(variable.array.get()));
+    }
+
+    mat::File file{path.string().c_str(), mat::getWriteMode(options.writeOptions, largestBytes)};
+
+    for (const mat::Variable& variable : variables)
+    {
+      file.putVariable(variable.name.c_str(), variable.array);
+    }
+
+    file.close();
+  }
+
+  /**
+   * @brief Converts a file streaming one variable at a time, used with a single thread. The v7.3 format can not be
+   *        selected automatically since the variable sizes are not known up front.
+   * @param options The options.
+   * @param job The job.
+   */
+  void streamFile(const Options& options, const Job& job)
+  {
+    mat::File input{job.input.string().c_str(), mat::Mode::r};
+
+    auto isSelected = [&](const std::string& name)
+    {
+      return options.variables.empty()
+          || std::find(options.variables.begin(), options.variables.end(), name) != options.variables.end();
+    };
+
+    if (options.format == OutputFormat::serial)
+    {
+      std::vector<mat::Variable> variables{};
+
+      for (mat::Variable& variable : input.variables())
+      {
+        if (isSelected(variable.name))
+        {
+          variables.push_back(std::move(variable));
+        }
+      }
+
+      writeFile(options, job.output, variables);
+      return;
+    }
+
+    fs::create_directories(job.output.parent_path());
+
+    mat::File output{job.output.string().c_str(), mat::getWriteMode(options.writeOptions)};
+
+    for (const mat::Variable& variable : input.variables())
+    {
+      if (isSelected(variable.name))
+      {
+        output.putVariable(variable.name.c_str(), variable.array);
+      }
+    }
+
+    output.close();
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  const std::optional<Options> options = parseOptions(argc, argv);
+
+  if (!options.has_value())
+  {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Job> jobs{};
+
+  try
+  {
+    jobs = collectJobs(*options);
+  }
+  catch (const std::exception& e)
+  {
+    std::fprintf(stderr, "Error: %s\n", e.what());
+    return EXIT_FAILURE;
+  }
+
+  std::size_t done{};
+  std::size_t failed{};
+
+  auto report = [&](const Job& job, const char* error)
+  {
+    ++done;
+
+    if (error != nullptr)
+    {
+      ++failed;
+      std::fprintf(stderr, "[%zu/%zu] %s: %s\n", done, jobs.size(), job.input.string().c_str(), error);
+    }
+    else if (!options->quiet)
+    {
+      std::fprintf(stderr, "[%zu/%zu] %s\n", done, jobs.size(), job.input.string().c_str());
+    }
+  };
+
+  if (options->threadCount == 1)
+  {
+    for (const Job& job : jobs)
+    {
+      try
+      {
+        streamFile(*options, job);
+        report(job, nullptr);
+      }
+      catch (const std::exception& e)
+      {
+        report(job, e.what());
+      }
+    }
+  }
+  else
+  {
+    std::vector<std::string> paths(jobs.size());
+
+    std::transform(jobs.begin(), jobs.end(), paths.begin(), [](const Job& job) { return job.input.string(); });
+
+    mat::LoaderOptions loaderOptions{};
+    loaderOptions.threadCount = options->threadCount;
+    loaderOptions.order       = mat::LoadOrder::completion;
+
+    mat::ParallelLoader loader{std::move(paths), options->variables, loaderOptions};
+
+    while (std::optional<mat::LoadResult> result = loader.next())
+    {
+      const Job& job = jobs[result->index];
+
+      try
+      {
+        if (result->error != nullptr)
+        {
+          std::rethrow_exception(result->error);
+        }
+
+        writeFile(*options, job.output, result->variables);
+        report(job, nullptr);
+      }
+      catch (const std::exception& e)
+      {
+        report(job, e.what());
+      }
+    }
+  }
+
+  if (!options->quiet)
+  {
+    std::fprintf(stderr, "Converted %zu of %zu files\n", done - failed, jobs.size());
+  }
+
+  return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}